@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+
+"""
+Compare google benchmark results against a baseline.
+
+The results of each benchmark binary (benchmark-*.json, written with
+--benchmark_out) are compared to the file with the same name in the baseline
+directory. Benchmarks whose CPU time increased by more than the threshold are
+reported as regressions and make the script fail.
+
+Missing baseline files are created from the current results, --update
+replaces the whole baseline.
+"""
+
+from __future__ import print_function
+import json
+import os
+import shutil
+import sys
+from argparse import ArgumentParser
+
+TIME_UNITS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def load_results(filename):
+    """ CPU time in ns per benchmark name """
+    with open(filename) as f:
+        data = json.load(f)
+
+    results = {}
+
+    for benchmark in data.get('benchmarks', []):
+        # skip aggregates (mean, median, stddev) of repeated runs
+        if benchmark.get('run_type', 'iteration') != 'iteration':
+            continue
+
+        results[benchmark['name']] = benchmark['cpu_time'] * TIME_UNITS[benchmark.get('time_unit', 'ns')]
+
+    return results
+
+
+def main():
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument('--results', required=True, help='directory with the benchmark results')
+    parser.add_argument('--baseline', required=True, help='directory with the baseline results')
+    parser.add_argument('--threshold', type=float, default=10,
+                        help='slowdown in percent reported as regression (default: 10)')
+    parser.add_argument('--update', action='store_true', help='replace the baseline with the results')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.results):
+        print('no benchmark results in ' + args.results)
+        return 1
+
+    if not os.path.isdir(args.baseline):
+        os.makedirs(args.baseline)
+
+    regressions = 0
+
+    for filename in sorted(os.listdir(args.results)):
+        if not filename.endswith('.json'):
+            continue
+
+        result_file = os.path.join(args.results, filename)
+        baseline_file = os.path.join(args.baseline, filename)
+
+        if args.update or not os.path.exists(baseline_file):
+            shutil.copyfile(result_file, baseline_file)
+            print('{}: baseline written'.format(filename))
+            continue
+
+        results = load_results(result_file)
+        baseline = load_results(baseline_file)
+
+        print(filename)
+
+        for name, cpu_time in sorted(results.items()):
+            if name not in baseline:
+                print('  {:<60} {:>12.1f} ns  (new)'.format(name, cpu_time))
+                continue
+
+            change = 100.0 * (cpu_time - baseline[name]) / baseline[name] if baseline[name] > 0 else 0.0
+            regression = change > args.threshold
+
+            if regression:
+                regressions += 1
+
+            print('  {:<60} {:>12.1f} ns  {:+6.1f}%{}'.format(name, cpu_time, change,
+                                                             '  REGRESSION' if regression else ''))
+
+    if regressions > 0:
+        print('{} benchmark(s) slower than the baseline by more than {}%'.format(regressions, args.threshold))
+        return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
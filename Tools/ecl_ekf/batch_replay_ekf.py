@@ -0,0 +1,190 @@
+#! /usr/bin/env python3
+"""
+Runs the EKF2 replay (replay_mode=ekf2) on all .ulg files in the supplied directory, using multiple isolated px4
+instances in parallel, and writes a summary of the replayed estimator output to a .csv file.
+
+Each log is replayed by a separate px4 process in its own working directory (<output>/<log name>/), so that the
+parameter overrides (replay_params.txt), the replayed log and the console output of each replay are kept apart.
+The px4 binary must be built for replay, e.g. with:
+    replay=dummy.ulg make px4_sitl_default
+"""
+# -*- coding: utf-8 -*-
+
+import argparse
+import csv
+import glob
+import os
+import shutil
+import subprocess
+import time
+from concurrent.futures import ThreadPoolExecutor
+from typing import Dict, List
+
+import numpy as np
+from pyulog import ULog
+
+TEST_RATIOS = ['mag_test_ratio', 'vel_test_ratio', 'pos_test_ratio', 'hgt_test_ratio', 'tas_test_ratio',
+               'hagl_test_ratio', 'beta_test_ratio']
+FLAGS = ['filter_fault_flags', 'innovation_check_flags', 'gps_check_fail_flags']
+
+
+def get_arguments():
+    file_dir = os.path.dirname(os.path.realpath(__file__))
+    src_path = os.path.realpath(os.path.join(file_dir, '..', '..'))
+    parser = argparse.ArgumentParser(description='Replay the .ulg files in the specified directory with ekf2 and '
+                                                 'summarize the estimator results')
+    parser.add_argument("directory_path")
+    parser.add_argument('-p', '--params', type=str, default=None,
+                        help='Parameter override file (format of replay_params.txt: <name> <value> per line).')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                        help='Number of replays to run in parallel.')
+    parser.add_argument('-o', '--output', type=str, default='replay_batch',
+                        help='Output directory for the replayed logs and the summary.')
+    parser.add_argument('--px4', type=str,
+                        default=os.path.join(src_path, 'build', 'px4_sitl_default_replay', 'bin', 'px4'),
+                        help='px4 binary to use.')
+    parser.add_argument('--timeout', type=float, default=600,
+                        help='Maximum time for the replay of a single log [s].')
+    parser.add_argument('--analyse', action='store_true',
+                        help='Also run the checks of process_logdata_ekf.py on the replayed logs (needs airtime).')
+    parser.add_argument('--rootfs', type=str, default=os.path.join(src_path, 'ROMFS', 'px4fmu_common'),
+                        help=argparse.SUPPRESS)
+    return parser.parse_args()
+
+
+def replay_log(args, ulog_file: str, instance: int) -> Dict[str, str]:
+    """
+    replays a single log file in its own working directory
+    :return: summary row
+    """
+    # logs in subdirectories may have the same name
+    name = os.path.splitext(os.path.relpath(ulog_file, args.directory_path))[0].replace(os.sep, '_')
+    working_dir = os.path.join(args.output, name)
+    if os.path.exists(working_dir):
+        shutil.rmtree(working_dir)
+    os.makedirs(working_dir)
+
+    if args.params is not None:
+        shutil.copy(args.params, os.path.join(working_dir, 'replay_params.txt'))
+
+    env = os.environ.copy()
+    env['replay'] = os.path.realpath(ulog_file)
+    env['replay_mode'] = 'ekf2'
+
+    result = {'log': ulog_file, 'status': 'ok'}
+    start_time = time.time()
+
+    with open(os.path.join(working_dir, 'out.log'), 'w') as out:
+        try:
+            subprocess.run([os.path.realpath(args.px4), '-i', str(instance), '-d', os.path.realpath(args.rootfs),
+                            '-s', 'etc/init.d-posix/rcS'], cwd=working_dir, env=env, stdout=out,
+                           stderr=subprocess.STDOUT, stdin=subprocess.DEVNULL, timeout=args.timeout)
+        except subprocess.TimeoutExpired:
+            result['status'] = 'timeout'
+
+    result['replay_time'] = '{:.1f}'.format(time.time() - start_time)
+
+    replayed_logs = glob.glob(os.path.join(working_dir, 'log', '**', '*_replayed.ulg'), recursive=True)
+
+    if not replayed_logs:
+        result['status'] = 'no replayed log'
+        return result
+
+    result['replayed_log'] = replayed_logs[0]
+
+    try:
+        result.update(summarize(replayed_logs[0]))
+    except Exception as e:
+        result['status'] = 'failed to read replayed log: {}'.format(e)
+        return result
+
+    if args.analyse:
+        result.update(analyse(replayed_logs[0]))
+
+    return result
+
+
+def summarize(replayed_log: str) -> Dict[str, str]:
+    """
+    innovation test ratio statistics and accumulated status flags of the estimator_status topic
+    """
+    ulog = ULog(replayed_log, ['estimator_status'])
+    estimator_status = ulog.get_dataset('estimator_status').data
+    summary = {}
+    timestamps = estimator_status['timestamp']
+    summary['duration'] = '{:.1f}'.format((timestamps[-1] - timestamps[0]) / 1e6 if len(timestamps) > 0 else 0)
+
+    for ratio in TEST_RATIOS:
+        if ratio in estimator_status:
+            values = estimator_status[ratio]
+            summary[ratio + '_max'] = '{:.3f}'.format(np.amax(values))
+            summary[ratio + '_mean'] = '{:.3f}'.format(np.mean(values))
+            summary[ratio + '_fail_pct'] = '{:.2f}'.format(100.0 * np.mean(values > 1.0))
+
+    for flag in FLAGS:
+        if flag in estimator_status:
+            summary[flag] = '0x{:x}'.format(int(np.bitwise_or.reduce(estimator_status[flag].astype(np.uint64))))
+
+    return summary
+
+
+def analyse(replayed_log: str) -> Dict[str, str]:
+    """
+    run the checks of process_logdata_ekf.py (writes <log>.mdat.csv)
+    """
+    from process_logdata_ekf import process_logdata_ekf
+    file_dir = os.path.dirname(os.path.realpath(__file__))
+    try:
+        test_results = process_logdata_ekf(
+            replayed_log, os.path.join(file_dir, 'check_level_dict.csv'), os.path.join(file_dir, 'check_table.csv'),
+            plot=False)
+        return {'master_status': str(test_results['master_status'][0])}
+    except Exception as e:
+        return {'master_status': 'not analysed: {}'.format(e)}
+
+
+def main() -> None:
+
+    args = get_arguments()
+
+    if not os.path.isfile(args.px4):
+        print('px4 binary {:s} not found'.format(args.px4))
+        return
+
+    ulog_files = sorted(glob.glob(os.path.join(args.directory_path, '**/*.ulg'), recursive=True))
+    ulog_files = [ulog_file for ulog_file in ulog_files if not ulog_file.endswith('_replayed.ulg')]
+    print("found {:d} .ulg files in {:s}".format(len(ulog_files), args.directory_path))
+    os.makedirs(args.output, exist_ok=True)
+
+    jobs = max(1, args.jobs)
+    # every worker uses its own px4 instance id, so that the px4 servers do not interfere
+    free_instances: List[int] = list(range(jobs))
+
+    def worker(ulog_file: str) -> Dict[str, str]:
+        instance = free_instances.pop()
+        try:
+            result = replay_log(args, ulog_file, instance)
+        finally:
+            free_instances.append(instance)
+        print('{:s}: {:s} ({:s} s)'.format(ulog_file, result['status'], result['replay_time']))
+        return result
+
+    with ThreadPoolExecutor(max_workers=jobs) as executor:
+        results = list(executor.map(worker, ulog_files))
+
+    keys: List[str] = []
+    for result in results:
+        keys.extend(key for key in result.keys() if key not in keys)
+
+    summary_file = os.path.join(args.output, 'summary.csv')
+    with open(summary_file, 'w') as file:
+        writer = csv.DictWriter(file, fieldnames=keys)
+        writer.writeheader()
+        writer.writerows(results)
+
+    n_failed = sum(1 for result in results if result['status'] != 'ok')
+    print('{:d} logs replayed, {:d} failed. Summary written to {:s}'.format(len(results), n_failed, summary_file))
+
+
+if __name__ == '__main__':
+    main()
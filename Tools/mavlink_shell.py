@@ -79,11 +79,14 @@ class MavlinkSerialPort():
         m = self.mav.recv_match(condition='SERIAL_CONTROL.count!=0',
                                 type='SERIAL_CONTROL', blocking=True,
                                 timeout=0.03)
-        if m is not None:
+        while m is not None:
             if self._debug > 2:
                 print(m)
             data = m.data[:m.count]
             self.buf += ''.join(str(chr(x)) for x in data)
+            # the output comes in bursts of several messages, take all that already arrived
+            m = self.mav.recv_match(condition='SERIAL_CONTROL.count!=0',
+                                    type='SERIAL_CONTROL', blocking=False)
 
     def read(self, n):
         '''read some bytes'''
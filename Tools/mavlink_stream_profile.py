@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+
+"""
+Create a binary MAVLink stream profile from a text file.
+
+The text file contains one stream per line: '<STREAM_NAME> <rate>', with the rate in Hz
+(-1: unlimited, 0: disabled). Lines starting with '#' are ignored.
+Put the output to ROMFS as etc/mavlink/<mode>.profile (e.g. onboard.profile) to replace
+the built-in defaults of that mode, see src/modules/mavlink/mavlink_stream_profiles.h.
+"""
+
+from __future__ import print_function
+import struct
+import sys
+from argparse import ArgumentParser
+
+PROFILE_MAGIC = b'MSPF'
+PROFILE_VERSION = 1
+
+
+def stream_hash(name):
+    """ 32 bit FNV-1a, same as mavlink_stream_hash() """
+    h = 2166136261
+    for c in bytearray(name.encode('ascii')):
+        h = ((h ^ c) * 16777619) & 0xffffffff
+    return h
+
+
+def main():
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument('input', help='text file with one "<STREAM_NAME> <rate>" per line')
+    parser.add_argument('output', help='binary profile')
+    args = parser.parse_args()
+
+    entries = []
+    with open(args.input, 'r') as f:
+        for line_nr, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            try:
+                name, rate = line.split()
+                entries.append((stream_hash(name), float(rate)))
+            except ValueError:
+                print('{:}:{:}: invalid line'.format(args.input, line_nr))
+                sys.exit(1)
+
+    with open(args.output, 'wb') as f:
+        f.write(struct.pack('<4sHH', PROFILE_MAGIC, PROFILE_VERSION, len(entries)))
+        for h, rate in entries:
+            f.write(struct.pack('<If', h, rate))
+
+
+if __name__ == '__main__':
+    main()
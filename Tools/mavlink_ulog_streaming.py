@@ -25,6 +25,46 @@ except ImportError as e:
     sys.exit(1)
 
 
+# set in the version byte of the ULog file header if the stream is compressed
+ULOG_STREAM_COMPRESSED_FLAG = 1 << 7
+BLOCK_FLAG = 1 << 15
+
+
+def lz4_decompress_block(data, raw_length):
+    ''' decompress a block in LZ4 block format '''
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        token = data[i]
+        i += 1
+        literals = token >> 4
+        if literals == 15:
+            while True:
+                b = data[i]
+                i += 1
+                literals += b
+                if b != 255: break
+        out.extend(data[i:i+literals])
+        i += literals
+        if i >= len(data): # last sequence has no match
+            break
+        offset = data[i] | (data[i+1] << 8)
+        i += 2
+        match_length = (token & 0xf) + 4
+        if (token & 0xf) == 15:
+            while True:
+                b = data[i]
+                i += 1
+                match_length += b
+                if b != 255: break
+        start = len(out) - offset
+        for k in range(match_length): # may overlap
+            out.append(out[start + k])
+    if len(out) != raw_length:
+        raise Exception('decompressed block length mismatch')
+    return out
+
+
 class MavlinkLogStreaming():
     '''Streams log data via MAVLink.
        Assumptions:
@@ -49,6 +89,9 @@ class MavlinkLogStreaming():
         self.logging_started = False
         self.num_dropouts = 0
         self.target_component = 1
+        self.compressed = False
+        self.block_buf = bytearray()
+        self.block_synced = True
 
     def debug(self, s, level=1):
         '''write some debug text'''
@@ -172,9 +215,19 @@ class MavlinkLogStreaming():
         if not self.got_ulog_header: # the first 16 bytes need special treatment
             if len(data) < 16: # that's never the case anyway
                 raise Exception('first received message too short')
-            self.file.write(bytearray(data[0:16]))
+            header = bytearray(data[0:16])
+            if header[7] & ULOG_STREAM_COMPRESSED_FLAG:
+                header[7] &= ~ULOG_STREAM_COMPRESSED_FLAG
+                self.compressed = True
+                print('Stream is compressed')
+            self.file.write(header)
             data = data[16:]
             self.got_ulog_header = True
+            if self.compressed:
+                first_msg_start = 0 # the first block follows the header
+
+        if self.compressed:
+            data, first_msg_start = self.decompress_blocks(data, first_msg_start, num_drops)
 
         if self.got_header_section and num_drops > 0:
             if num_drops > 25: num_drops = 25
@@ -202,6 +255,40 @@ class MavlinkLogStreaming():
         self.ulog_message = data # store the rest for the next message
 
 
+    def decompress_blocks(self, data, first_msg_start, num_drops):
+        ''' reassemble and decompress the blocks of a compressed stream. returns
+        the uncompressed data and the offset of the first ULog message in it '''
+        if num_drops > 0:
+            self.block_buf = bytearray()
+            self.block_synced = False
+        if not self.block_synced:
+            if first_msg_start == 255:
+                return [], 255
+            data = data[first_msg_start:]
+            self.block_synced = True
+        self.block_buf.extend(data)
+
+        raw = bytearray()
+        raw_first_msg_start = 255
+        while len(self.block_buf) >= 4:
+            raw_length = self.block_buf[0] | (self.block_buf[1] << 8)
+            data_length = self.block_buf[2] | (self.block_buf[3] << 8)
+            stored = data_length & BLOCK_FLAG
+            data_length &= ~BLOCK_FLAG
+            continuation = raw_length & BLOCK_FLAG
+            raw_length &= ~BLOCK_FLAG
+            if len(self.block_buf) < 4 + data_length:
+                break
+            block = self.block_buf[4:4+data_length]
+            del self.block_buf[:4+data_length]
+            if not continuation and raw_first_msg_start == 255:
+                raw_first_msg_start = len(raw)
+            if stored:
+                raw.extend(block)
+            else:
+                raw.extend(lz4_decompress_block(block, raw_length))
+        return list(raw), raw_first_msg_start
+
     def write_ulog_messages(self, data):
         ''' write ulog data w/o integrity checking, assuming data starts with a
         valid ulog message. returns the remaining data at the end. '''
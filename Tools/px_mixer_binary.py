@@ -0,0 +1,194 @@
+#!/usr/bin/env python
+############################################################################
+#
+#   Copyright (C) 2020 PX4 Development Team. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in
+#    the documentation and/or other materials provided with the
+#    distribution.
+# 3. Neither the name PX4 nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+# OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+# AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+############################################################################
+
+"""
+px_mixer_binary.py:
+Convert text mixer files (.mix) to the precompiled binary mixer format.
+
+The binary format is defined in src/lib/mixer/Mixer/MixerBinary.hpp and can
+be loaded by the firmware without text parsing (mixer load detects the format).
+The parser follows the text parsers of the mixer classes: lines not starting
+with an upper case tag and a colon are ignored.
+"""
+
+from __future__ import print_function
+import argparse
+import struct
+import sys
+
+MIXER_BINARY_MAGIC = 0x424d5850  # "PXMB"
+MIXER_BINARY_VERSION = 1
+
+HEADER_FORMAT = '<IHHI'     # magic, version, mixer_count, size
+RECORD_FORMAT = '<BBH'      # type, count, size
+SCALER_FORMAT = '5h'        # negative scale, positive scale, offset, min output, max output
+CONTROL_FORMAT = '<BB' + SCALER_FORMAT
+MULTIROTOR_FORMAT = '<8s4h'  # geometry, roll scale, pitch scale, yaw scale, idle speed
+HELICOPTER_FORMAT = '<5H5h'  # throttle curve, pitch curve
+HELI_SERVO_FORMAT = '<2H4h'  # angle, arm length, scale, offset, min output, max output
+
+DEFAULT_OUTPUT_SCALER = [10000, 10000, 0, -10000, 10000]
+
+
+class MixerParseError(Exception):
+    pass
+
+
+def _tagged_lines(text):
+    """ yields (line number, tag, values) of all mixer definition lines """
+    for number, line in enumerate(text.splitlines(), 1):
+        if len(line) < 2 or not line[0].isupper() or line[1] != ':':
+            continue
+        yield number, line[0], line[2:].split()
+
+
+def _ints(number, values, count):
+    if len(values) < count:
+        raise MixerParseError('line {}: expected {} values, got {}'.format(number, count, len(values)))
+    try:
+        return [int(v) for v in values[:count]]
+    except ValueError:
+        raise MixerParseError('line {}: invalid number in {}'.format(number, ' '.join(values)))
+
+
+def _record(mixer_type, count, payload):
+    size = struct.calcsize(RECORD_FORMAT) + len(payload)
+    padding = (4 - size % 4) % 4
+    return struct.pack(RECORD_FORMAT, ord(mixer_type), count, size + padding) + payload + b'\0' * padding
+
+
+def _pack(number, fmt, *values):
+    try:
+        return struct.pack(fmt, *values)
+    except struct.error as e:
+        raise MixerParseError('line {}: value out of range ({})'.format(number, e))
+
+
+def mixer_text_to_binary(text):
+    """
+    convert the content of a text mixer file
+    :return: binary mixer blob (bytes)
+    """
+    lines = list(_tagged_lines(text))
+    records = []
+    i = 0
+
+    def expect(tag):
+        if i >= len(lines) or lines[i][1] != tag:
+            where = 'line {}'.format(lines[i][0]) if i < len(lines) else 'end of file'
+            raise MixerParseError('{}: expected {}: line'.format(where, tag))
+        return lines[i]
+
+    while i < len(lines):
+        number, tag, values = lines[i]
+        i += 1
+
+        if tag == 'Z':
+            records.append(_record('Z', 0, b''))
+
+        elif tag == 'M':
+            inputs = _ints(number, values, 1)[0]
+            if inputs < 1 or inputs > 255:
+                raise MixerParseError('line {}: invalid input count {}'.format(number, inputs))
+
+            output_scaler = DEFAULT_OUTPUT_SCALER
+            if i < len(lines) and lines[i][1] == 'O':
+                output_scaler = _ints(lines[i][0], lines[i][2], 5)
+                i += 1
+
+            payload = _pack(number, '<' + SCALER_FORMAT, *output_scaler)
+
+            for _ in range(inputs):
+                control_number, _, control_values = expect('S')
+                payload += _pack(control_number, CONTROL_FORMAT, *_ints(control_number, control_values, 7))
+                i += 1
+
+            records.append(_record('M', inputs, payload))
+
+        elif tag == 'R':
+            if len(values) < 5 or len(values[0]) > 7:
+                raise MixerParseError('line {}: invalid multirotor mixer'.format(number))
+            geometry = values[0].encode('ascii')
+            payload = _pack(number, MULTIROTOR_FORMAT, geometry, *_ints(number, values[1:], 4))
+            records.append(_record('R', 0, payload))
+
+        elif tag == 'H':
+            servo_count = _ints(number, values, 1)[0]
+            if servo_count < 3 or servo_count > 4:
+                raise MixerParseError('line {}: only swash plates with 3 or 4 servos are supported'.format(number))
+
+            throttle_number, _, throttle_values = expect('T')
+            i += 1
+            pitch_number, _, pitch_values = expect('P')
+            i += 1
+            payload = _pack(number, HELICOPTER_FORMAT, *(_ints(throttle_number, throttle_values, 5) +
+                                                         _ints(pitch_number, pitch_values, 5)))
+
+            for _ in range(servo_count):
+                servo_number, _, servo_values = expect('S')
+                payload += _pack(servo_number, HELI_SERVO_FORMAT, *_ints(servo_number, servo_values, 6))
+                i += 1
+
+            records.append(_record('H', servo_count, payload))
+
+        else:
+            raise MixerParseError('line {}: unexpected {}: line'.format(number, tag))
+
+    body = b''.join(records)
+    size = struct.calcsize(HEADER_FORMAT) + len(body)
+    return struct.pack(HEADER_FORMAT, MIXER_BINARY_MAGIC, MIXER_BINARY_VERSION, len(records), size) + body
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert text mixer files to the binary mixer format.')
+    parser.add_argument('input', help='text mixer file')
+    parser.add_argument('-o', '--output', default=None,
+                        help='binary mixer file (default: replace the input file)')
+    args = parser.parse_args()
+
+    with open(args.input, 'r') as f:
+        text = f.read()
+
+    try:
+        blob = mixer_text_to_binary(text)
+    except MixerParseError as e:
+        print('{}: {}'.format(args.input, e), file=sys.stderr)
+        sys.exit(1)
+
+    with open(args.output if args.output else args.input, 'wb') as f:
+        f.write(blob)
+
+
+if __name__ == '__main__':
+    main()
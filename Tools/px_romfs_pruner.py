@@ -40,7 +40,8 @@ Try to keep size of the ROMFS minimal.
 This script goes through the temporarily copied ROMFS data and deletes all
 comments, empty lines and unnecessary whitespace.
 It also deletes hidden files such as auto-saved backups that a text editor
-might have left in the tree.
+might have left in the tree. With --mixer-binary, mixer files are converted
+to the precompiled binary mixer format (see px_mixer_binary.py).
 
 @author: Julian Oes <julian@oes.ch>
 """
@@ -51,6 +52,8 @@ import re
 import os
 import io
 
+from px_mixer_binary import mixer_text_to_binary
+
 
 def main():
     # Parse commandline arguments
@@ -59,6 +62,8 @@ def main():
                         help="ROMFS scratch folder.")
     parser.add_argument('--board', action="store",
                         help="Board architecture for this run")
+    parser.add_argument('--mixer-binary', action="store_true",
+                        help="Convert the mixer files to the binary format")
     args = parser.parse_args()
 
     # go through temp folder
@@ -111,7 +116,10 @@ def main():
                 # overwrite old scratch file
                 with open(file_path, "wb") as f:
                     pruned_content = re.sub("\r\n", "\n", pruned_content)
-                    f.write(pruned_content.encode("ascii", errors='strict'))
+                    if args.mixer_binary and file_path.endswith(".mix"):
+                        f.write(mixer_text_to_binary(pruned_content))
+                    else:
+                        f.write(pruned_content.encode("ascii", errors='strict'))
             else:
                 os.remove(file_path)
 
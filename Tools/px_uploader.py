@@ -181,8 +181,11 @@ class uploader(object):
     INFO_BOARD_ID   = b'\x02'        # board type
     INFO_BOARD_REV  = b'\x03'        # board revision
     INFO_FLASH_SIZE = b'\x04'        # max firmware size in bytes
+    INFO_CAPS       = b'\x06'        # capability flags, not supported by older bootloaders
+    CAP_WINDOWED_USB = 0x1           # no replies lost when streaming commands over USB
 
     PROG_MULTI_MAX  = 252            # protocol max is 255, must be multiple of 4
+    STREAM_WINDOW   = 32             # PROG_MULTI commands in flight when streaming over USB
     READ_MULTI_MAX  = 252            # protocol max is 255
 
     NSH_INIT        = bytearray(b'\x0d\x0d\x0d')
@@ -205,6 +208,7 @@ class uploader(object):
         self.window_max = 256
         self.window_per = 2  # Sync,<result>
         self.ackWindowedMode = False  # Assume Non Widowed mode for all USB CDC
+        self.ackStreamingMode = False  # USB CDC with CAP_WINDOWED_USB: don't wait for each ack
         self.port = serial.Serial(portname, baudrate_bootloader, timeout=0.5, write_timeout=0)
         self.otp = b''
         self.sn = b''
@@ -353,6 +357,15 @@ class uploader(object):
         self.__getSync()
         return value
 
+    # capability flags, 0 for bootloaders not supporting them
+    def __getCapabilities(self):
+        try:
+            return self.__getInfo(uploader.INFO_CAPS)
+        except (RuntimeError, struct.error):
+            # older bootloaders reply INSYNC/INVALID
+            self.__sync()
+            return 0
+
     # send the GET_OTP command and wait for an info parameter
     def __getOTP(self, param):
         t = struct.pack("I", param)  # int param as 32bit ( 4 byte ) char array.
@@ -397,6 +410,7 @@ class uploader(object):
     # send the CHIP_ERASE command and wait for the bootloader to become ready
     def __erase(self, label):
         print("Windowed mode: %s" % self.ackWindowedMode)
+        print("Streaming mode: %s" % self.ackStreamingMode)
         print("\n", end='')
         self.__send(uploader.CHIP_ERASE +
                     uploader.EOC)
@@ -434,6 +448,9 @@ class uploader(object):
         self.__send(uploader.EOC)
         if (not windowMode):
             self.__getSync(False)
+        elif self.ackStreamingMode:
+            # the link is flow controlled, the acks are collected in __program
+            pass
         else:
             # The following is done to have minimum delay on the transmission
             # of the ne fw. The per block cost of __getSync was about 16 mS per.
@@ -488,11 +505,16 @@ class uploader(object):
         self.__drawProgressBar(label, 0, len(groups))
         uploadProgress = 0
         for bytes in groups:
-            self.__program_multi(bytes, self.ackWindowedMode)
+            self.__program_multi(bytes, self.ackWindowedMode or self.ackStreamingMode)
             # If in Window mode, extend the window size for the __ackSyncWindow
-            if self.ackWindowedMode:
+            if self.ackWindowedMode or self.ackStreamingMode:
                 self.window += self.window_per
 
+            # In streaming mode keep a limited number of commands in flight
+            if self.ackStreamingMode and self.window > uploader.STREAM_WINDOW * self.window_per:
+                self.__ackSyncWindow(self.window_per)
+                self.window -= self.window_per
+
             # Print upload progress (throttled, so it does not delay upload progress)
             uploadProgress += 1
             if uploadProgress % 256 == 0:
@@ -558,6 +580,10 @@ class uploader(object):
             print("Unsupported bootloader protocol %d" % uploader.INFO_BL_REV)
             raise RuntimeError("Bootloader protocol mismatch")
 
+        # on USB we don't need to wait for each reply if the bootloader doesn't lose them
+        if not self.ackWindowedMode:
+            self.ackStreamingMode = (self.__getCapabilities() & uploader.CAP_WINDOWED_USB) != 0
+
         self.board_type = self.__getInfo(uploader.INFO_BOARD_ID)
         self.board_rev = self.__getInfo(uploader.INFO_BOARD_REV)
         self.fw_maxsize = self.__getInfo(uploader.INFO_FLASH_SIZE)
@@ -0,0 +1,294 @@
+#!/usr/bin/env python3
+
+"""
+Headless SITL benchmark.
+
+Boots SITL with SIH driving the lockstep clock (no external simulator), flies a
+scripted takeoff/hold/land sequence for a given simulated duration and reports
+as JSON:
+- CPU time per simulated second of the process and of each thread
+- work queue utilization and per work item run times (thread CPU time in lockstep)
+- perf counters (PC_ELAPSED counters use thread CPU time in lockstep)
+- uORB publication counts
+- memory high-water mark of the process
+
+Usually run with 'make px4_sitl bench', the duration can be set with the
+PX4_BENCH_MINUTES environment variable (simulated minutes).
+"""
+
+from __future__ import print_function
+import json
+import os
+import re
+import shutil
+import signal
+import socket
+import subprocess
+import sys
+import time
+from argparse import ArgumentParser
+
+
+class Px4Instance(object):
+    def __init__(self, px4_binary, src_dir, build_dir, model):
+        self.bin_dir = os.path.join(build_dir, 'bin')
+        self.rootfs = os.path.join(build_dir, 'tmp', 'rootfs_bench')
+        shutil.rmtree(self.rootfs, ignore_errors=True)
+        os.makedirs(self.rootfs)
+
+        env = os.environ.copy()
+        env['PX4_SIM_MODEL'] = model
+        env['PX4_SIM_SIH'] = '1'
+
+        self.log = open(os.path.join(self.rootfs, 'px4.log'), 'w')
+        self.process = subprocess.Popen(
+            [px4_binary, '-d', os.path.join(src_dir, 'ROMFS', 'px4fmu_common'),
+             '-s', 'etc/init.d-posix/rcS', '-t', os.path.join(src_dir, 'test_data')],
+            cwd=self.rootfs, env=env, stdout=self.log, stderr=subprocess.STDOUT)
+        self.wall_start = time.time()
+        self.sock = None
+
+    def command(self, *args):
+        """ run a command on the px4 instance over a persistent connection and return its output """
+        if self.sock is None:
+            self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            self.sock.settimeout(60)
+
+            try:
+                self.sock.connect('/tmp/px4-sock-0')
+            except OSError:
+                # the daemon is not running yet
+                self.sock.close()
+                self.sock = None
+                return ''
+
+        # the command ends with the flags byte (0x02: keep the connection open),
+        # the response ends with {0, return value}
+        self.sock.sendall(' '.join(args).encode() + b'\x02')
+        response = b''
+
+        while len(response) < 2 or response[-2] != 0:
+            data = self.sock.recv(4096)
+
+            if not data:
+                self.sock.close()
+                self.sock = None
+                break
+
+            response += data
+
+        return response[:-2].decode(errors='replace')
+
+    def run_client(self, *args):
+        """ run a command using a px4-* client process """
+        cmd = [os.path.join(self.bin_dir, 'px4-' + args[0])] + list(args[1:])
+        result = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                universal_newlines=True, timeout=60)
+        return result.stdout
+
+    def topic_field(self, topic, field):
+        output = self.command('listener', topic, '-n', '1')
+        match = re.search(r'\b' + field + r': (-?[\d.]+)', output)
+
+        if match:
+            return float(match.group(1))
+
+        return None
+
+    def sim_time(self):
+        """ simulated time in seconds """
+        timestamp = self.topic_field('sensor_accel', 'timestamp')
+
+        if timestamp is None:
+            return 0.0
+
+        return timestamp / 1e6
+
+    def wait_sim_time(self, sim_time):
+        while self.sim_time() < sim_time:
+            self.check_running()
+            time.sleep(0.05)
+
+    def check_running(self):
+        if self.process.poll() is not None:
+            raise RuntimeError('px4 exited (see ' + self.log.name + ')')
+
+    def stop(self):
+        if self.process.poll() is None:
+            try:
+                if self.sock is not None:
+                    self.sock.close()
+
+                self.run_client('shutdown')
+                self.process.wait(timeout=10)
+            except (subprocess.TimeoutExpired, OSError):
+                self.process.send_signal(signal.SIGKILL)
+                self.process.wait()
+
+        self.log.close()
+
+
+def fly(px4, duration_s):
+    """ scripted flight: takeoff, hold (auto loiter) until the end, then land """
+    print('waiting for the vehicle to be ready')
+
+    while px4.topic_field('vehicle_status', 'arming_state') != 2:
+        px4.check_running()
+        px4.command('commander', 'takeoff')
+        px4.wait_sim_time(px4.sim_time() + 2)
+
+    start = px4.sim_time()
+    print('took off at {:.1f}s simulated time'.format(start))
+
+    px4.wait_sim_time(start + 20)
+    px4.command('commander', 'mode', 'auto:loiter')
+
+    px4.wait_sim_time(start + max(duration_s - 30, 20))
+    px4.command('commander', 'land')
+
+    px4.wait_sim_time(start + duration_s)
+
+
+def parse_threads(pid, sim_time):
+    """ CPU time of all threads from /proc (Linux only) """
+    threads = []
+    clock_ticks = os.sysconf('SC_CLK_TCK')
+    task_dir = '/proc/{}/task'.format(pid)
+
+    for tid in os.listdir(task_dir):
+        try:
+            with open(os.path.join(task_dir, tid, 'stat')) as f:
+                stat = f.read()
+        except IOError:
+            continue
+
+        # the name can contain spaces, it's enclosed in parentheses
+        name = stat[stat.index('(') + 1:stat.rindex(')')]
+        fields = stat[stat.rindex(')') + 2:].split()
+        cpu_time = (int(fields[11]) + int(fields[12])) / float(clock_ticks)  # utime + stime
+        threads.append({'name': name, 'cpu_time_s': cpu_time, 'cpu_per_sim_s': cpu_time / sim_time})
+
+    return sorted(threads, key=lambda t: t['cpu_time_s'], reverse=True)
+
+
+def parse_memory(pid):
+    memory = {}
+
+    with open('/proc/{}/status'.format(pid)) as f:
+        for line in f:
+            key, _, value = line.partition(':')
+
+            if key in ('VmHWM', 'VmPeak', 'VmRSS'):
+                memory[key] = int(value.split()[0])  # kB
+
+    return memory
+
+
+def parse_work_queues(output):
+    work_queues = []
+    wq_re = re.compile(r'(\S+)\s+([\d.]+)%')
+    item_re = re.compile(r'\d+\)\s+(\S+)\s+([\d.]+) Hz\s+([\d.]+) us\s+(\d+)\s+([\d.]+)\s+(\d+) us\s+(\d+)')
+
+    for line in output.splitlines():
+        item = item_re.search(line)
+
+        if item and work_queues:
+            rate = float(item.group(2))
+            run_mean = float(item.group(5))
+            work_queues[-1]['items'].append({
+                'name': item.group(1), 'rate_hz': rate, 'run_min_us': int(item.group(4)),
+                'run_mean_us': run_mean, 'run_max_us': int(item.group(6)),
+                'deadline_misses': int(item.group(7)), 'cpu_per_sim_s': rate * run_mean / 1e6})
+            continue
+
+        wq = wq_re.search(line)
+
+        if wq:
+            work_queues.append({'name': wq.group(1), 'cpu_per_sim_s': float(wq.group(2)) / 100, 'items': []})
+
+    return work_queues
+
+
+def parse_perf(output, sim_time):
+    counters = []
+    elapsed_re = re.compile(r'(\S.*): (\d+) events, (\d+)us elapsed, ([\d.]+)us avg, min (\d+)us max (\d+)us')
+
+    for line in output.splitlines():
+        match = elapsed_re.search(line)
+
+        if match:
+            elapsed = int(match.group(3))
+            counters.append({
+                'name': match.group(1), 'events': int(match.group(2)), 'elapsed_us': elapsed,
+                'avg_us': float(match.group(4)), 'max_us': int(match.group(6)),
+                'cpu_per_sim_s': elapsed / 1e6 / sim_time})
+
+    return sorted(counters, key=lambda c: c['elapsed_us'], reverse=True)
+
+
+def parse_uorb(output):
+    topics = []
+    topic_re = re.compile(r'^\s*([a-z_0-9]+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s*$')
+
+    for line in output.splitlines():
+        # strip terminal control sequences
+        match = topic_re.match(re.sub(r'\x1b\[[0-9;]*[A-Za-z]', '', line))
+
+        if match:
+            topics.append({'topic': match.group(1), 'instance': int(match.group(2)),
+                           'published': int(match.group(4)), 'lost': int(match.group(5))})
+
+    return sorted(topics, key=lambda t: t['published'], reverse=True)
+
+
+def main():
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument('--px4-binary', required=True, help='px4 SITL binary')
+    parser.add_argument('--src-dir', required=True, help='PX4 source directory')
+    parser.add_argument('--build-dir', required=True, help='PX4 build directory')
+    parser.add_argument('--model', default='iris', help='vehicle model (default: iris)')
+    parser.add_argument('--minutes', type=float, default=float(os.environ.get('PX4_BENCH_MINUTES', 5)),
+                        help='simulated flight duration in minutes (default: $PX4_BENCH_MINUTES or 5)')
+    parser.add_argument('--output', default='bench.json', help='JSON output file')
+    args = parser.parse_args()
+
+    px4 = Px4Instance(args.px4_binary, args.src_dir, args.build_dir, args.model)
+
+    try:
+        px4.wait_sim_time(1)
+        fly(px4, args.minutes * 60)
+
+        sim_time = px4.sim_time()
+        wall_time = time.time() - px4.wall_start
+        threads = parse_threads(px4.process.pid, sim_time)
+        cpu_time = sum(t['cpu_time_s'] for t in threads)
+
+        report = {
+            'model': args.model,
+            'sim_time_s': sim_time,
+            'wall_time_s': wall_time,
+            'real_time_factor': sim_time / wall_time,
+            'process': {'cpu_time_s': cpu_time, 'cpu_per_sim_s': cpu_time / sim_time,
+                        'memory_kb': parse_memory(px4.process.pid)},
+            'threads': threads,
+            'work_queues': parse_work_queues(px4.command('work_queue', 'status')),
+            'perf': parse_perf(px4.command('perf'), sim_time),
+            'uorb': parse_uorb(px4.command('uorb', 'top', '-1', '-a', '-c')),
+        }
+
+    finally:
+        px4.stop()
+
+    with open(args.output, 'w') as f:
+        json.dump(report, f, indent=2)
+
+    print('{:.0f}s simulated in {:.0f}s ({:.1f}x real time), {:.3f} CPU s per simulated s'.format(
+        report['sim_time_s'], report['wall_time_s'], report['real_time_factor'],
+        report['process']['cpu_per_sim_s']))
+    print('report written to ' + args.output)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+
+"""
+Decompress a ULog file written with SDLOG_COMPRESS into a plain ULog file.
+
+The file starts with the ULog header (with the compressed flag set in the version
+byte), followed by a sequence of blocks with a 4 byte header:
+  uint16 raw length (bit 15: block does not start at a ULog message boundary)
+  uint16 data length (bit 15: data is stored uncompressed)
+and the data in LZ4 block format unless stored.
+"""
+
+from __future__ import print_function
+import sys
+from argparse import ArgumentParser
+
+
+ULOG_COMPRESSED_FLAG = 1 << 7
+BLOCK_FLAG = 1 << 15
+
+
+def lz4_decompress_block(data, raw_length):
+    ''' decompress a block in LZ4 block format '''
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        token = data[i]
+        i += 1
+        literals = token >> 4
+        if literals == 15:
+            while True:
+                b = data[i]
+                i += 1
+                literals += b
+                if b != 255: break
+        out.extend(data[i:i+literals])
+        i += literals
+        if i >= len(data): # last sequence has no match
+            break
+        offset = data[i] | (data[i+1] << 8)
+        i += 2
+        match_length = (token & 0xf) + 4
+        if (token & 0xf) == 15:
+            while True:
+                b = data[i]
+                i += 1
+                match_length += b
+                if b != 255: break
+        start = len(out) - offset
+        for k in range(match_length): # may overlap
+            out.append(out[start + k])
+    if len(out) != raw_length:
+        raise Exception('decompressed block length mismatch')
+    return out
+
+
+def decompress(data):
+    ''' returns the decompressed ULog data '''
+    if len(data) < 16 or data[0:4] != b'ULog':
+        raise Exception('not a ULog file')
+    header = bytearray(data[0:16])
+    if not header[7] & ULOG_COMPRESSED_FLAG:
+        raise Exception('file is not compressed')
+    header[7] &= ~ULOG_COMPRESSED_FLAG
+    out = bytearray(header)
+    i = 16
+    while i + 4 <= len(data):
+        raw_length = (data[i] | (data[i+1] << 8)) & ~BLOCK_FLAG
+        data_length = data[i+2] | (data[i+3] << 8)
+        stored = data_length & BLOCK_FLAG
+        data_length &= ~BLOCK_FLAG
+        i += 4
+        if i + data_length > len(data):
+            print('Warning: truncated block at the end of the file', file=sys.stderr)
+            break
+        block = data[i:i+data_length]
+        i += data_length
+        if stored:
+            out.extend(block)
+        else:
+            out.extend(lz4_decompress_block(block, raw_length))
+    return out
+
+
+def main():
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument('input', metavar='INPUT', help='compressed ULog file')
+    parser.add_argument('output', metavar='OUTPUT', help='output ULog file')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    with open(args.output, 'wb') as f:
+        f.write(decompress(data))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+
+"""
+Read the seek index from a ULog file written with SDLOG_INDEX.
+
+The last message of the file is a fixed size INFO message 'uint64_t index_start'
+with the file offset of the index. The index consists of INFO_MULTIPLE messages:
+  uint64_t[n] index_timestamp     timestamps of the sync messages [us]
+  uint64_t[n] index_offset        file offsets of the sync messages
+  uint64_t[n] index_topic_offset  file offset of the ADD_LOGGED_MSG per msg_id
+                                  (UINT64_MAX if not subscribed)
+Offsets refer to the uncompressed file (@see ulog_decompress.py).
+"""
+
+from __future__ import print_function
+import struct
+import sys
+from argparse import ArgumentParser
+
+
+TRAILER_KEY = b'uint64_t index_start'
+TRAILER_LEN = 3 + 1 + len(TRAILER_KEY) + 8
+INFO = ord('I')
+INFO_MULTIPLE = ord('M')
+
+
+def read_index(data):
+    ''' returns (timestamps, offsets, topic_offsets) '''
+    trailer = data[-TRAILER_LEN:]
+    msg_size, msg_type, key_len = struct.unpack('<HBB', trailer[0:4])
+    if msg_type != INFO or trailer[4:4+key_len] != TRAILER_KEY:
+        raise Exception('file has no index')
+    index_start, = struct.unpack('<Q', trailer[-8:])
+
+    arrays = {}
+    i = index_start
+    while i < len(data) - TRAILER_LEN:
+        msg_size, msg_type = struct.unpack('<HB', data[i:i+3])
+        if msg_type != INFO_MULTIPLE:
+            raise Exception('unexpected message in index at offset {}'.format(i))
+        key_len = data[i+4]
+        key = data[i+5:i+5+key_len].decode()
+        name = key.split(' ')[1]
+        value = data[i+5+key_len:i+3+msg_size]
+        arrays.setdefault(name, []).extend(struct.unpack('<{}Q'.format(len(value) // 8), value))
+        i += 3 + msg_size
+
+    return (arrays.get('index_timestamp', []), arrays.get('index_offset', []),
+            arrays.get('index_topic_offset', []))
+
+
+def main():
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument('input', metavar='INPUT', help='ULog file')
+    parser.add_argument('-s', '--seek', type=float, default=None,
+                        help='print the offset to start reading from for a given time [s]')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    timestamps, offsets, topic_offsets = read_index(data)
+
+    if args.seek is not None:
+        seek_us = args.seek * 1e6
+        offset = 0
+        for timestamp, o in zip(timestamps, offsets):
+            if timestamp > seek_us:
+                break
+            offset = o
+        print(offset)
+        return
+
+    print('{} index entries'.format(len(timestamps)))
+    for timestamp, offset in zip(timestamps, offsets):
+        print('{:12.3f} s  {:10d}'.format(timestamp / 1e6, offset))
+    print('topics:')
+    for msg_id, offset in enumerate(topic_offsets):
+        if offset != 0xffffffffffffffff:
+            print('msg_id {:3d}  {:10d}'.format(msg_id, offset))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+
+"""
+Receive a ULog stream sent by the logger over UDP (logger start -u <ip>:<port>)
+and write it to ULog files, one per log.
+
+Datagrams are reordered, a lost datagram is recovered from the parity datagrams
+if forward error correction is enabled (SDLOG_UDP_FEC). Otherwise the stream is
+resynced on the next ULog message and a dropout message is inserted.
+"""
+
+from __future__ import print_function
+import datetime
+import os
+import socket
+import struct
+import sys
+from argparse import ArgumentParser
+
+HEADER = struct.Struct('<HBBIIHH')
+MAGIC = 0x4c55
+VERSION = 1
+FLAG_LOG_START = 1 << 0
+FLAG_PARITY = 1 << 1
+NO_MESSAGE_START = 0xffff
+PARITY_FIELDS = struct.Struct('<IHH')
+
+# number of datagrams to wait for a missing one before giving up on it
+REORDER_WINDOW = 64
+
+
+class LogStream(object):
+    def __init__(self, file_name):
+        self.file = open(file_name, 'wb')
+        self.file_name = file_name
+        self.next_sequence = 0  # next datagram to write
+        self.datagrams = {}  # sequence: (stream_offset, first_message_offset, payload), also recently written ones
+        self.parities = {}  # first sequence of the group: (group size, parity)
+        self.in_sync = True
+        self.received = 0
+        self.recovered = 0
+        self.lost = 0
+
+    def add(self, flags, sequence, stream_offset, first_message_offset, payload):
+        if flags & FLAG_PARITY:
+            self.parities[sequence] = (first_message_offset, payload)
+            self.recover(sequence)
+
+        elif sequence >= self.next_sequence and sequence not in self.datagrams:
+            self.datagrams[sequence] = (stream_offset, first_message_offset, payload)
+            self.received += 1
+
+            for start, (size, _) in list(self.parities.items()):
+                if start <= sequence < start + size:
+                    self.recover(start)
+
+        self.write_available()
+
+    def recover(self, start):
+        """ recover a single missing datagram of the group starting at start """
+        size, parity = self.parities[start]
+        missing = [s for s in range(start, start + size) if s not in self.datagrams]
+
+        if len(missing) != 1 or missing[0] < self.next_sequence:
+            return
+
+        data = bytearray(parity)
+
+        for s in range(start, start + size):
+            if s == missing[0]:
+                continue
+
+            stream_offset, first_message_offset, payload = self.datagrams[s]
+            fields = PARITY_FIELDS.pack(stream_offset, first_message_offset, len(payload)) + payload
+
+            for i, b in enumerate(fields):
+                data[i] ^= b
+
+        stream_offset, first_message_offset, length = PARITY_FIELDS.unpack_from(data)
+        payload = bytes(data[PARITY_FIELDS.size:PARITY_FIELDS.size + length])
+        self.datagrams[missing[0]] = (stream_offset, first_message_offset, payload)
+        self.recovered += 1
+        del self.parities[start]
+
+    def write_available(self, flush=False):
+        while self.datagrams and self.next_sequence <= max(self.datagrams):
+            if self.next_sequence in self.datagrams:
+                _, first_message_offset, payload = self.datagrams[self.next_sequence]
+
+                if not self.in_sync:
+                    if first_message_offset == NO_MESSAGE_START:
+                        payload = b''
+
+                    else:
+                        # resync on the next message, and mark the gap with a dropout message
+                        payload = payload[first_message_offset:]
+                        self.file.write(struct.pack('<HcH', 2, b'O', 0))
+                        self.in_sync = True
+
+                self.file.write(payload)
+
+            elif flush or max(self.datagrams) - self.next_sequence > REORDER_WINDOW:
+                self.lost += 1
+                self.in_sync = False
+
+            else:
+                break
+
+            self.next_sequence += 1
+
+        # keep the written datagrams as long as they might be needed for a recovery
+        for s in [s for s in self.datagrams if s < self.next_sequence - REORDER_WINDOW]:
+            del self.datagrams[s]
+
+        for start in [s for s, (size, _) in self.parities.items() if s + size <= self.next_sequence]:
+            del self.parities[start]
+
+    def close(self):
+        self.write_available(flush=True)
+        self.file.close()
+        print('{}: {} datagrams received, {} recovered, {} lost'.format(
+            self.file_name, self.received, self.recovered, self.lost))
+
+
+def main():
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument('--port', type=int, default=14590, help='UDP port to listen on (default: 14590)')
+    parser.add_argument('--output', default='.', help='output directory')
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 * 1024 * 1024)
+    sock.bind(('', args.port))
+    print('listening on port {}'.format(args.port))
+
+    stream = None
+
+    try:
+        while True:
+            data = sock.recv(65535)
+
+            if len(data) < HEADER.size:
+                continue
+
+            magic, version, flags, sequence, stream_offset, first_message_offset, length = \
+                HEADER.unpack_from(data)
+
+            if magic != MAGIC or version != VERSION:
+                continue
+
+            payload = data[HEADER.size:HEADER.size + length]
+
+            # the start datagram is sent twice: a new log starts unless this is the duplicate
+            if flags & FLAG_LOG_START and not flags & FLAG_PARITY and (stream is None or stream.next_sequence > 1):
+                if stream is not None:
+                    stream.close()
+
+                file_name = os.path.join(args.output, datetime.datetime.now().strftime(
+                    'log_udp_%Y-%m-%d_%H-%M-%S.ulg'))
+                stream = LogStream(file_name)
+                print('new log: ' + file_name)
+
+            if stream is None:
+                # joined in the middle of a log, wait for the next one
+                continue
+
+            stream.add(flags, sequence, stream_offset, first_message_offset, payload)
+
+    except KeyboardInterrupt:
+        pass
+
+    if stream is not None:
+        stream.close()
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
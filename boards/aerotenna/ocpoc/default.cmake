@@ -45,6 +45,7 @@ px4_add_board(
 		events
 		fw_att_control
 		fw_pos_control_l1
+		gps_blending
 		land_detector
 		landing_target_estimator
 		#load_mon
@@ -65,6 +66,7 @@ px4_add_board(
 		vmount
 		vtol_att_control
 	SYSTEMCMDS
+		boot_profile
 		esc_calib
 		led_control
 		mixer
@@ -66,6 +66,7 @@ px4_add_board(
 		events
 		fw_att_control
 		fw_pos_control_l1
+		gps_blending
 		land_detector
 		landing_target_estimator
 		#load_mon
@@ -77,6 +78,7 @@ px4_add_board(
 		mc_rate_control
 		#micrortps_bridge
 		muorb/krait
+		muorb/shm
 		muorb/test
 		navigator
 		rc_update
@@ -88,6 +90,7 @@ px4_add_board(
 		vtol_att_control
 	SYSTEMCMDS
 		#bl_update
+		boot_profile
 		#config
 		#dumpfile
 		esc_calib
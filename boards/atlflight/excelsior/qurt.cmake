@@ -58,6 +58,7 @@ px4_add_board(
 		ekf2
 		fw_att_control
 		fw_pos_control_l1
+		gps_blending
 		land_detector
 		landing_target_estimator
 		local_position_estimator
@@ -72,6 +73,7 @@ px4_add_board(
 		vmount
 		vtol_att_control
 	SYSTEMCMDS
+		boot_profile
 		led_control
 		mixer
 		#motor_ramp
@@ -37,6 +37,7 @@ px4_add_board(
 		events
 		fw_att_control
 		fw_pos_control_l1
+		gps_blending
 		land_detector
 		landing_target_estimator
 		#load_mon
@@ -57,6 +58,7 @@ px4_add_board(
 		vmount
 		vtol_att_control
 	SYSTEMCMDS
+		boot_profile
 		dyn
 		esc_calib
 		led_control
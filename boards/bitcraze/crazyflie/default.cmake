@@ -20,6 +20,7 @@ px4_add_board(
 		dataman
 		ekf2
 		events
+		gps_blending
 		land_detector
 		landing_target_estimator
 		load_mon
@@ -35,6 +36,7 @@ px4_add_board(
 		#temperature_compensation
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		config
 		dmesg
 		dumpfile
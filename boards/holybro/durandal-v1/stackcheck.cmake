@@ -68,6 +68,7 @@ px4_add_board(
 		events
 		fw_att_control
 		fw_pos_control_l1
+		gps_blending
 		land_detector
 		#landing_target_estimator
 		load_mon
@@ -87,6 +88,7 @@ px4_add_board(
 		vtol_att_control
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		config
 		dmesg
 		dumpfile
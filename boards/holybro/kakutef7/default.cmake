@@ -49,6 +49,7 @@ px4_add_board(
 		#temperature_compensation
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		config
 		dmesg
 		dumpfile
@@ -48,6 +48,7 @@ px4_add_board(
 	MODULES
 
 	SYSTEMCMDS
+		boot_profile
 		config
 		reboot
 		top
@@ -19,6 +19,8 @@ px4_add_board(
 		TEL2:/dev/ttyS2
 		TEL4:/dev/ttyS6
 
+	FLIGHT_TASKS_REMOVE
+		Transition # no VTOL support
 	DRIVERS
 		adc
 		#barometer # all available barometer drivers
@@ -88,6 +90,7 @@ px4_add_board(
 
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		#config
 		#dumpfile
 		#esc_calib
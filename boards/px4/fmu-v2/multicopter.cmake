@@ -15,6 +15,8 @@ px4_add_board(
 		TEL1:/dev/ttyS1
 		TEL2:/dev/ttyS2
 		TEL4:/dev/ttyS6
+	FLIGHT_TASKS_REMOVE
+		Transition # no VTOL support
 	DRIVERS
 		adc
 		barometer/ms5611
@@ -42,6 +44,7 @@ px4_add_board(
 		dataman
 		ekf2
 		#events
+		gps_blending
 		land_detector
 		landing_target_estimator
 		load_mon
@@ -59,6 +62,7 @@ px4_add_board(
 		vmount
 	SYSTEMCMDS
 		#bl_update
+		boot_profile
 		#config
 		#dumpfile
 		#esc_calib
@@ -41,6 +41,7 @@ px4_add_board(
 		dataman
 		ekf2
 		events
+		gps_blending
 		rover_pos_control
 		land_detector
 		load_mon
@@ -55,6 +56,7 @@ px4_add_board(
 
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		#config
 		#dumpfile
 		#esc_calib
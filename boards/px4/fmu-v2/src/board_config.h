@@ -466,6 +466,9 @@
 /* This board provides a DMA pool and APIs */
 #define BOARD_DMA_ALLOC_POOL_SIZE 5120
 
+/* Message buffers of the uORB topics, allocated at boot (usage: uorb status) */
+#define BOARD_UORB_ARENA_SIZE 8192
+
 #define BOARD_HAS_ON_RESET 1
 
 #define BOARD_DSHOT_MOTOR_ASSIGNMENT {3, 2, 1, 0, 4, 5};
@@ -91,6 +91,7 @@ px4_add_board(
 		#vtol_att_control
 	SYSTEMCMDS
 		#bl_update
+		boot_profile
 		#config
 		#dmesg
 		#dumpfile
@@ -66,6 +66,7 @@ px4_add_board(
 		events
 		fw_att_control
 		fw_pos_control_l1
+		gps_blending
 		rover_pos_control
 		land_detector
 		landing_target_estimator
@@ -88,6 +89,7 @@ px4_add_board(
 
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		config
 		dumpfile
 		esc_calib
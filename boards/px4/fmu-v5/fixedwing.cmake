@@ -52,6 +52,7 @@ px4_add_board(
 		events
 		fw_att_control
 		fw_pos_control_l1
+		gps_blending
 		land_detector
 		load_mon
 		logger
@@ -63,6 +64,7 @@ px4_add_board(
 		vmount
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		config
 		dmesg
 		dumpfile
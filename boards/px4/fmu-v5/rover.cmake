@@ -51,6 +51,7 @@ px4_add_board(
 		dataman
 		ekf2
 		events
+		gps_blending
 		land_detector
 		load_mon
 		logger
@@ -63,6 +64,7 @@ px4_add_board(
 		vmount
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		config
 		dmesg
 		dumpfile
@@ -619,6 +619,10 @@
 
 #define BOARD_DMA_ALLOC_POOL_SIZE 5120
 
+/* This board provides a fast memory pool in DTCM (work queue stacks) */
+
+#define BOARD_FAST_ALLOC_POOL_SIZE (16 * 1024)
+
 /* This board provides the board_on_reset interface */
 
 #define BOARD_HAS_ON_RESET 1
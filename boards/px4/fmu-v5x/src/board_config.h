@@ -338,9 +338,12 @@
 #define HW_INFO_INIT_REV       4 /* Offset in above string of the REV */
 
 /* HEATER
- * PWM in future
+ * Hardware PWM on TIM2 CH3 (the io_timer channel of TIM2 is not used), GPIO_HEATER_OUTPUT is the off state.
  */
 #define GPIO_HEATER_OUTPUT   /* PB10  T2CH3 */ (GPIO_OUTPUT|GPIO_PUSHPULL|GPIO_SPEED_2MHz|GPIO_OUTPUT_CLEAR|GPIO_PORTB|GPIO_PIN10)
+#define HEATER_PWM_TIMER        2  /* Timer 2 */
+#define HEATER_PWM_CHANNEL      3  /* PB10 GPIO_TIM2_CH3OUT_2 */
+#define GPIO_HEATER_PWM_OUTPUT  GPIO_TIM2_CH3OUT_2
 
 /* PWM Capture
  *
@@ -612,6 +615,10 @@
 
 #define BOARD_DMA_ALLOC_POOL_SIZE 5120+4096
 
+/* This board provides a fast memory pool in DTCM (work queue stacks) */
+
+#define BOARD_FAST_ALLOC_POOL_SIZE (16 * 1024)
+
 /* This board provides the board_on_reset interface */
 
 #define BOARD_HAS_ON_RESET 1
@@ -72,6 +72,7 @@
 #include <px4_platform/gpio.h>
 #include <px4_platform/board_determine_hw_info.h>
 #include <px4_platform/board_dma_alloc.h>
+#include <px4_platform/board_fast_alloc.h>
 
 /****************************************************************************
  * Pre-Processor Definitions
@@ -244,6 +245,12 @@ __EXPORT int board_app_initialize(uintptr_t arg)
 		syslog(LOG_ERR, "[boot] DMA alloc FAILED\n");
 	}
 
+	/* configure the fast memory allocator */
+
+	if (board_fast_alloc_init() < 0) {
+		syslog(LOG_ERR, "[boot] fast alloc FAILED\n");
+	}
+
 	/* set up the serial DMA polling */
 	static struct hrt_call serial_dma_call;
 	struct timespec ts;
@@ -29,6 +29,8 @@ px4_add_board(
 		events
 		fw_att_control
 		fw_pos_control_l1
+		gps_blending
+		gyro_fft
 		land_detector
 		landing_target_estimator
 		#load_mon
@@ -43,12 +45,13 @@ px4_add_board(
 		replay
 		rover_pos_control
 		sensors
-		#sih
+		sih
 		simulator
 		temperature_compensation
 		vmount
 		vtol_att_control
 	SYSTEMCMDS
+		boot_profile
 		#config
 		#dumpfile
 		dyn
@@ -68,6 +71,7 @@ px4_add_board(
 		tests # tests and test runner
 		#top
 		topic_listener
+		trace
 		tune_control
 		ver
 		work_queue
@@ -9,6 +9,7 @@ px4_add_board(
 		logger
 		replay
 	SYSTEMCMDS
+		boot_profile
 		param
 		perf
 		reboot
@@ -44,6 +44,7 @@ px4_add_board(
 		dataman
 		ekf2
 		events
+		gps_blending
 		land_detector
 		landing_target_estimator
 		load_mon
@@ -61,6 +62,7 @@ px4_add_board(
 		vmount
 	SYSTEMCMDS
 		bl_update
+		boot_profile
 		config
 		dmesg
 		dumpfile
@@ -0,0 +1,56 @@
+############################################################################
+#
+# Copyright (c) 2020 PX4 Development Team. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in
+#    the documentation and/or other materials provided with the
+#    distribution.
+# 3. Neither the name PX4 nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+# OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+# AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+############################################################################
+
+# Download and unpack google benchmark at configure time
+configure_file(${CMAKE_CURRENT_LIST_DIR}/CMakeLists.txt.in benchmark-download/CMakeLists.txt)
+execute_process(COMMAND ${CMAKE_COMMAND} -G "${CMAKE_GENERATOR}" . RESULT_VARIABLE result1 WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/benchmark-download)
+execute_process(COMMAND ${CMAKE_COMMAND} --build . RESULT_VARIABLE result2 WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/benchmark-download)
+if(result1 OR result2)
+	message(FATAL_ERROR "Preparing google benchmark failed: ${result1} ${result2}")
+endif()
+
+# only the library is needed, it's tested upstream
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+
+# Add google benchmark, defines benchmark and benchmark_main targets
+add_subdirectory(${CMAKE_CURRENT_BINARY_DIR}/benchmark-src ${CMAKE_CURRENT_BINARY_DIR}/benchmark-build EXCLUDE_FROM_ALL)
+
+# Remove visibility.h from the compile flags for benchmark because of poisoned exit()
+get_target_property(BENCHMARK_COMPILE_FLAGS benchmark COMPILE_OPTIONS)
+if(BENCHMARK_COMPILE_FLAGS)
+	list(REMOVE_ITEM BENCHMARK_COMPILE_FLAGS "-include")
+	list(REMOVE_ITEM BENCHMARK_COMPILE_FLAGS "visibility.h")
+	set_target_properties(benchmark PROPERTIES COMPILE_OPTIONS "${BENCHMARK_COMPILE_FLAGS}")
+endif()
@@ -0,0 +1,102 @@
+############################################################################
+#
+# Copyright (c) 2020 PX4 Development Team. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in
+#    the documentation and/or other materials provided with the
+#    distribution.
+# 3. Neither the name PX4 nor the names of its contributors may be
+#    used to endorse or promote products derived from this software
+#    without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+# OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+# AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+############################################################################
+
+#=============================================================================
+#
+#	px4_add_benchmark
+#
+#	Adds a google benchmark to the benchmark_results target.
+#
+#	Usage:
+#		px4_add_benchmark(SRC <file> [LINKLIBS <libraries>] [FUNCTIONAL])
+#
+#	Input:
+#		SRC		: benchmark source file, the name of the benchmark is
+#				  inferred from it (FooBenchmark.cpp -> benchmark-Foo)
+#		LINKLIBS	: libraries to link
+#		FUNCTIONAL	: run with uORB and the parameters initialized
+#
+#	The results are written as JSON to benchmarks/<name>.json in the build
+#	directory and compared against the baseline by the benchmark_results target.
+#
+function(px4_add_benchmark)
+	# skip if unit testing is not configured
+	if(BUILD_TESTING)
+		px4_parse_function_args(
+			NAME px4_add_benchmark
+			OPTIONS FUNCTIONAL
+			ONE_VALUE SRC
+			MULTI_VALUE LINKLIBS
+			REQUIRED SRC
+			ARGN ${ARGN})
+
+		# infer benchmark name from source filename
+		get_filename_component(BENCHNAME ${SRC} NAME_WE)
+		string(REPLACE Benchmark "" BENCHNAME ${BENCHNAME})
+		set(BENCHNAME benchmark-${BENCHNAME})
+
+		add_executable(${BENCHNAME} EXCLUDE_FROM_ALL ${SRC})
+
+		if(FUNCTIONAL)
+			target_link_libraries(${BENCHNAME} ${LINKLIBS} benchmark_functional_main
+			                                               px4_daemon
+			                                               px4_platform
+			                                               modules__uORB
+			                                               px4_layer
+			                                               systemlib
+			                                               cdev
+			                                               px4_work_queue
+			                                               px4_daemon
+			                                               work_queue
+			                                               parameters
+			                                               perf
+			                                               tinybson
+			                                               uorb_msgs
+			                                               test_stubs)  #put test_stubs last
+		else()
+			target_link_libraries(${BENCHNAME} ${LINKLIBS} benchmark_main)
+		endif()
+
+		# run it as part of benchmark_results, in the console pool so that
+		# benchmarks don't run concurrently and disturb each other
+		add_custom_target(run-${BENCHNAME}
+			COMMAND ${CMAKE_COMMAND} -E make_directory ${PX4_BINARY_DIR}/benchmarks
+			COMMAND ${BENCHNAME} --benchmark_out=${PX4_BINARY_DIR}/benchmarks/${BENCHNAME}.json
+			                     --benchmark_out_format=json
+			DEPENDS ${BENCHNAME}
+			WORKING_DIRECTORY ${PX4_BINARY_DIR}
+			USES_TERMINAL)
+
+		add_dependencies(benchmark_results run-${BENCHNAME})
+	endif()
+endfunction()
@@ -55,8 +55,10 @@
 #			[ SYSTEMCMDS <list> ]
 #			[ EXAMPLES <list> ]
 #			[ SERIAL_PORTS <list> ]
+#			[ FLIGHT_TASKS_REMOVE <list> ]
 #			[ CONSTRAINED_FLASH ]
 #			[ TESTING ]
+#			[ MIXER_BINARY ]
 #			)
 #
 #	Input:
@@ -76,8 +78,10 @@
 #		SYSTEMCMDS		: list of system commands to build for this board (relative to src/systemcmds)
 #		EXAMPLES		: list of example modules to build for this board (relative to src/examples)
 #		SERIAL_PORTS		: mapping of user configurable serial ports and param facing name
+#		FLIGHT_TASKS_REMOVE	: list of multicopter flight tasks not to build, no other task may derive from them (eg Transition, Orbit)
 #		CONSTRAINED_FLASH	: flag to enable constrained flash options (eg limit init script status text)
 #		TESTING			: flag to enable automatic inclusion of PX4 testing modules
+#		MIXER_BINARY		: flag to store the ROMFS mixers in the precompiled binary format (not supported by IO)
 #
 #
 #	Example:
@@ -146,10 +150,12 @@ function(px4_add_board)
 			SYSTEMCMDS
 			EXAMPLES
 			SERIAL_PORTS
+			FLIGHT_TASKS_REMOVE
 		OPTIONS
 			BUILD_BOOTLOADER
 			CONSTRAINED_FLASH
 			TESTING
+			MIXER_BINARY
 		REQUIRED
 			PLATFORM
 			VENDOR
@@ -214,6 +220,10 @@ function(px4_add_board)
 		endif()
 	endif()
 
+	if(FLIGHT_TASKS_REMOVE)
+		set(config_flight_tasks_to_remove ${FLIGHT_TASKS_REMOVE} CACHE INTERNAL "flight tasks removed" FORCE)
+	endif()
+
 	if(UAVCAN_INTERFACES)
 		set(config_uavcan_num_ifaces ${UAVCAN_INTERFACES} CACHE INTERNAL "UAVCAN interfaces" FORCE)
 	endif()
@@ -229,6 +239,13 @@ function(px4_add_board)
 		set(PX4_TESTING "1" CACHE INTERNAL "testing enabled" FORCE)
 	endif()
 
+	if(MIXER_BINARY)
+		if(IO)
+			message(FATAL_ERROR "MIXER_BINARY is not supported by the IO board (${IO})")
+		endif()
+		set(px4_mixer_binary_build "1" CACHE INTERNAL "binary ROMFS mixers" FORCE)
+	endif()
+
 	include(px4_impl_os)
 	px4_os_prebuild_targets(OUT prebuild_targets BOARD ${PX4_BOARD})
 
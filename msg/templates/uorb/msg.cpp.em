@@ -67,6 +67,7 @@ topic_fields = ["%s %s" % (convert_type(field.type), field.name) for field in so
 }@
 
 #include <inttypes.h>
+#include <stddef.h>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/defines.h>
 #include <uORB/topics/@(topic_name).h>
@@ -77,8 +78,15 @@ topic_fields = ["%s %s" % (convert_type(field.type), field.name) for field in so
 @# This is used for the logger
 constexpr char __orb_@(topic_name)_fields[] = "@( ";".join(topic_fields) );";
 
+@# field descriptors in the same order as the fields above, without padding
+static constexpr orb_field __orb_@(topic_name)_field_list[] = {
+@[for field in sorted_fields]@
+@( print_field_descriptor(field, uorb_struct) )@
+@[end for]@
+};
+
 @[for multi_topic in topics]@
-ORB_DEFINE(@multi_topic, struct @uorb_struct, @(struct_size-padding_end_size), __orb_@(topic_name)_fields);
+ORB_DEFINE_WITH_FIELD_LIST(@multi_topic, struct @uorb_struct, @(struct_size-padding_end_size), __orb_@(topic_name)_fields, __orb_@(topic_name)_field_list, @(all_topics.index(multi_topic)));
 @[end for]
 
 void print_message(const @uorb_struct& message)
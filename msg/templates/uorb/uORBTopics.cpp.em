@@ -49,7 +49,7 @@
 @{
 msg_names = [mn.replace(".msg", "") for mn in msgs]
 msgs_count = len(msg_names)
-msg_names_all = list(set(msg_names + multi_topics)) # set() filters duplicates
+msg_names_all = sorted(set(msg_names + multi_topics)) # set() filters duplicates, the index is the topic ID (o_id)
 msgs_count_all = len(msg_names_all)
 }@
 @[for msg_name in msg_names]@
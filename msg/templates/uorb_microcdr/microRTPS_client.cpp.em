@@ -67,10 +67,13 @@ receive_base_types = [s.short_name for idx, s in enumerate(spec) if scope[idx] =
 
 #include <ucdr/microcdr.h>
 #include <px4_time.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/sem.h>
 #include <uORB/uORB.h>
 
 #include <uORB/Publication.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 @[for topic in list(set(topic_names))]@
 #include <uORB/topics/@(topic).h>
 #include <uORB_microcdr/topics/@(topic).h>
@@ -79,6 +82,33 @@ receive_base_types = [s.short_name for idx, s in enumerate(spec) if scope[idx] =
 void* send(void *data);
 
 @[if send_topics]@
+static px4_sem_t _send_sem;
+
+// Subscription marking the topic to be sent and waking up the send thread on every publication
+class SendSubscription : public uORB::SubscriptionCallback
+{
+public:
+    explicit SendSubscription(const orb_metadata *meta) : uORB::SubscriptionCallback(meta) {}
+
+    void call() override
+    {
+        _dirty.store(true);
+        px4_sem_post(&_send_sem);
+    }
+
+    /** true if there was a publication since the last call */
+    bool take_dirty() { return _dirty.exchange(false); }
+
+private:
+    px4::atomic_bool _dirty{false};
+};
+
+static void send_sem_drain()
+{
+    // all pending publications are handled by the next pass over the dirty topics
+    while (px4_sem_trywait(&_send_sem) == 0) {}
+}
+
 void* send(void* /*unused*/)
 {
     char data_buffer[BUFFER_SIZE] = {};
@@ -86,10 +116,12 @@ void* send(void* /*unused*/)
     int loop = 0, read = 0;
     uint32_t length = 0;
     size_t header_length = 0;
+    const bool batch = (_options.batch_ms > 0);
 
-    /* subscribe to topics */
+    /* subscribe to topics, sent as soon as they are published */
 @[for idx, topic in enumerate(send_topics)]@
-    uORB::Subscription @(topic)_sub{ORB_ID(@(topic))};
+    SendSubscription @(topic)_sub{ORB_ID(@(topic))};
+    @(topic)_sub.registerCallback();
 @[end for]@
 
     // ucdrBuffer to serialize using the user defined buffer
@@ -102,22 +134,46 @@ void* send(void* /*unused*/)
 
     while (!_should_exit_task)
     {
+        px4_sem_wait(&_send_sem);
+        send_sem_drain();
+
+        if (batch) {
+            // coalesce the topics published within the batching window into one write
+            px4_usleep(_options.batch_ms * 1000);
+            send_sem_drain();
+        }
+
 @[for idx, topic in enumerate(send_topics)]@
-        @(send_base_types[idx])_s @(topic)_data;
-        if (@(topic)_sub.update(&@(topic)_data)) {
+        if (@(topic)_sub.take_dirty()) {
+            @(send_base_types[idx])_s @(topic)_data;
+            if (@(topic)_sub.update(&@(topic)_data)) {
                 // copy raw data into local buffer. Payload is shifted by header length to make room for header
                 serialize_@(send_base_types[idx])(&writer, &@(topic)_data, &data_buffer[header_length], &length);
-                if (0 < (read = transport_node->write(static_cast<char>(@(rtps_message_id(ids, topic))), data_buffer, length)))
+                if (batch) {
+                    if (0 < transport_node->queue(static_cast<char>(@(rtps_message_id(ids, topic))), data_buffer, length))
+                    {
+                        ++sent;
+                    }
+                } else if (0 < (read = transport_node->write(static_cast<char>(@(rtps_message_id(ids, topic))), data_buffer, length)))
                 {
                     total_sent += read;
                     ++sent;
                 }
+            }
         }
 @[end for]@
-        px4_usleep(_options.sleep_ms * 1000);
+
+        if (batch && 0 < (read = transport_node->flush())) {
+            total_sent += read;
+        }
+
         ++loop;
     }
 
+@[for idx, topic in enumerate(send_topics)]@
+    @(topic)_sub.unregisterCallback();
+@[end for]@
+
     struct timespec end;
     px4_clock_gettime(CLOCK_REALTIME, &end);
     double elapsed_secs = end.tv_sec - begin.tv_sec + (end.tv_nsec - begin.tv_nsec) / 1e9;
@@ -129,6 +185,10 @@ void* send(void* /*unused*/)
 
 static int launch_send_thread(pthread_t &sender_thread)
 {
+    px4_sem_init(&_send_sem, 0, 0);
+    /* _send_sem use case is a signal */
+    px4_sem_setprotocol(&_send_sem, SEM_PRIO_NONE);
+
     pthread_attr_t sender_thread_attr;
     pthread_attr_init(&sender_thread_attr);
     pthread_attr_setstacksize(&sender_thread_attr, PX4_STACK_ADJUSTED(4000));
@@ -203,6 +263,8 @@ void micrortps_start_topics(struct timespec &begin, uint64_t &total_read, uint64
     }
 @[if send_topics]@
     _should_exit_task = true;
+    px4_sem_post(&_send_sem);
     pthread_join(sender_thread, nullptr);
+    px4_sem_destroy(&_send_sem);
 @[end if]@
 }
@@ -61,6 +61,8 @@ uorb_struct = '%s_s'%spec.short_name
 topic_name = spec.short_name
 }@
 
+#include <stddef.h>
+
 #include <px4_platform_common/px4_config.h>
 #include <ucdr/microcdr.h>
 #include <uORB/topics/@(topic_name).h>
@@ -94,47 +96,65 @@ def get_serialization_type_name(type_name):
     else:
         raise Exception("Type {0} not supported, add to type_serialize_map!".format(type_name))
 
-def add_serialize_functions(fields, scope_name):
+def collect_leaf_fields(fields, scope_name, leaves):
+    """
+    Flatten the fields into (serialization type, member name, array length or 0) in serialization order
+    """
     for field in fields:
         if (not field.is_header):
             if (field.is_builtin):
                 if (not field.is_array):
-                    print("    ucdr_serialize_" + str(get_serialization_type_name(field.type)) + "(writer, input->" + scope_name+str(field.name) + ");")
+                    leaves.append((get_serialization_type_name(field.type), scope_name + str(field.name), 0))
                 else:
-                    print("    ucdr_serialize_array_" + str(get_serialization_type_name(field.base_type)) + "(writer, input->" + scope_name+str(field.name) + ", " + str(field.array_len) + ");")
+                    leaves.append((get_serialization_type_name(field.base_type), scope_name + str(field.name), field.array_len))
             else:
                 name = field.name
                 children_fields = get_children_fields(field.base_type, search_path)
                 if (scope_name):  name = scope_name + name
                 if (not field.is_array):
-                    add_serialize_functions(children_fields, name + '.')
+                    collect_leaf_fields(children_fields, name + '.', leaves)
                 else:
                     for i in range(field.array_len):
-                        add_serialize_functions(children_fields, name + ('[%d].' %i))
-
-def add_deserialize_functions(fields, scope_name):
-    for field in fields:
-        if (not field.is_header):
-            if (field.is_builtin):
-                if (not field.is_array):
-                    print("    ucdr_deserialize_" + str(get_serialization_type_name(field.type)) + "(reader, &output->" + scope_name+str(field.name) + ");")
-                else:
-                    print("    ucdr_deserialize_array_" + str(get_serialization_type_name(field.base_type)) + "(reader, output->" + scope_name+str(field.name) + ", " + str(field.array_len) + ");")
+                        collect_leaf_fields(children_fields, name + ('[%d].' %i), leaves)
+
+def group_leaf_fields(leaves):
+    """
+    Group consecutive fields of the same type. The uORB structs are sorted by field size (stable sort) and only padded
+    before embedded types, so such runs are contiguous in memory and their CDR encoding is the same as of one array.
+    """
+    groups = []
+    for leaf in leaves:
+        if groups and groups[-1][0][0] == leaf[0]:
+            groups[-1].append(leaf)
+        else:
+            groups.append([leaf])
+    return groups
+
+def add_bulk_functions(direction, buffer_name, struct_name):
+    leaves = []
+    collect_leaf_fields(spec.parsed_fields(), "", leaves)
+    reference = '&' if direction == 'deserialize' else ''
+    for group in group_leaf_fields(leaves):
+        type_name, name, array_len = group[0]
+        if len(group) == 1:
+            if array_len == 0:
+                print("    ucdr_" + direction + "_" + type_name + "(" + buffer_name + ", " + reference + struct_name + "->" + name + ");")
             else:
-                name = field.name
-                children_fields = get_children_fields(field.base_type, search_path)
-                if (scope_name):  name = scope_name + name
-                if (not field.is_array):
-                    add_deserialize_functions(children_fields, name + '.')
-                else:
-                    for i in range(field.array_len):
-                        add_deserialize_functions(children_fields, name + ('[%d].' %i))
+                print("    ucdr_" + direction + "_array_" + type_name + "(" + buffer_name + ", " + struct_name + "->" + name + ", " + str(array_len) + ");")
+        else:
+            # one bulk copy of the whole run, the layout assumption is checked at compile time
+            for previous, current in zip(group[:-1], group[1:]):
+                print("    static_assert(offsetof(" + uorb_struct + ", " + current[1] + ") == offsetof(" + uorb_struct + ", " + previous[1] +
+                      ") + sizeof(" + struct_name + "->" + previous[1] + "), \"" + current[1] + " not contiguous\");")
+            count = sum(max(leaf[2], 1) for leaf in group)
+            first = struct_name + "->" + name if array_len > 0 else "&" + struct_name + "->" + name
+            print("    ucdr_" + direction + "_array_" + type_name + "(" + buffer_name + ", " + first + ", " + str(count) + ");")
 
 def add_code_to_serialize():
-    add_serialize_functions(spec.parsed_fields(), "")
+    add_bulk_functions('serialize', 'writer', 'input')
 
 def add_code_to_deserialize():
-    add_deserialize_functions(spec.parsed_fields(), "")
+    add_bulk_functions('deserialize', 'reader', 'output')
 }@
 
 void serialize_@(topic_name)(ucdrBuffer *writer, const struct @(uorb_struct) *input, char *output, uint32_t *length)
@@ -155,6 +155,16 @@ static int parse_options(int argc, char **argv)
     return 0;
 }
 
+void print_transport_stats()
+{
+    const Transport_node::Stats &stats = transport_node->get_stats();
+    printf("TRANSPORT: sent %lu messages in %lu writes - %llu bytes - %lu errors; "
+           "received %lu messages - %llu bytes - %lu CRC errors - %lu bytes dropped\n\n",
+           (unsigned long)stats.tx_messages, (unsigned long)stats.tx_writes, (unsigned long long)stats.tx_bytes,
+           (unsigned long)stats.tx_errors, (unsigned long)stats.rx_messages, (unsigned long long)stats.rx_bytes,
+           (unsigned long)stats.rx_crc_errors, (unsigned long)stats.rx_dropped_bytes);
+}
+
 void signal_handler(int signum)
 {
    printf("Interrupt signal (%d) received.\n", signum);
@@ -283,8 +293,9 @@ int main(int argc, char** argv)
             std::chrono::duration<double>  elapsed_secs = end - start;
             printf("\nSENT:     %lu messages - %lu bytes\n",
                     (unsigned long)sent, (unsigned long)total_sent);
-            printf("RECEIVED: %d messages - %d bytes; %d LOOPS - %.03f seconds - %.02fKB/s\n\n",
+            printf("RECEIVED: %d messages - %d bytes; %d LOOPS - %.03f seconds - %.02fKB/s\n",
                     received, total_read, loop, elapsed_secs.count(), (double)total_read/(1000*elapsed_secs.count()));
+            print_transport_stats();
             received = sent = total_read = total_sent = 0;
             receiving = false;
         }
@@ -297,6 +308,7 @@ int main(int argc, char** argv)
     t_send_queue_cv.notify_one();
     sender_thread.join();
 @[end if]@
+    print_transport_stats();
     delete transport_node;
     transport_node = nullptr;
 
@@ -97,9 +97,11 @@ uint16_t Transport_node::crc16_byte(uint16_t crc, const uint8_t data)
 uint16_t Transport_node::crc16(uint8_t const *buffer, size_t len)
 {
 	uint16_t crc = 0;
+	const uint8_t *end = buffer + len;
 
-	while (len--) {
-		crc = crc16_byte(crc, *buffer++);
+	// table lookup per byte without call overhead, this runs over every byte sent and received
+	while (buffer != end) {
+		crc = (crc >> 8) ^ crc16_table[(crc ^ *buffer++) & 0xff];
 	}
 
 	return crc;
@@ -113,7 +115,14 @@ ssize_t Transport_node::read(uint8_t *topic_ID, char out_buffer[], size_t buffer
 
 	*topic_ID = 255;
 
-	ssize_t len = node_read((void *)(rx_buffer + rx_buff_pos), sizeof(rx_buffer) - rx_buff_pos);
+	// several messages can arrive at once (batched writes, one UDP datagram), return those already received first
+	ssize_t len = parse(topic_ID, out_buffer, buffer_len);
+
+	if (len != 0) {
+		return len;
+	}
+
+	len = node_read((void *)(rx_buffer + rx_buff_pos), sizeof(rx_buffer) - rx_buff_pos);
 
 	if (len <= 0) {
 		int errsv = errno;
@@ -130,11 +139,17 @@ ssize_t Transport_node::read(uint8_t *topic_ID, char out_buffer[], size_t buffer
 	}
 
 	rx_buff_pos += len;
+	stats.rx_bytes += len;
+
+	return parse(topic_ID, out_buffer, buffer_len);
+}
 
-	// We read some
+ssize_t Transport_node::parse(uint8_t *topic_ID, char out_buffer[], size_t buffer_len)
+{
+	ssize_t len = 0;
 	size_t header_size = sizeof(struct Header);
 
-	// but not enough
+	// not enough data for a header
 	if (rx_buff_pos < header_size) {
 		return 0;
 	}
@@ -156,6 +171,7 @@ ssize_t Transport_node::read(uint8_t *topic_ID, char out_buffer[], size_t buffer
 #endif /* PX4_INFO */
 
 		// All we've checked so far is garbage, drop it - but save unchecked bytes
+		stats.rx_dropped_bytes += msg_start_pos;
 		memmove(rx_buffer, rx_buffer + msg_start_pos, rx_buff_pos - msg_start_pos);
 		rx_buff_pos = rx_buff_pos - msg_start_pos;
 		return -1;
@@ -181,6 +197,7 @@ ssize_t Transport_node::read(uint8_t *topic_ID, char out_buffer[], size_t buffer
 #endif /* PX4_INFO */
 			memmove(rx_buffer, rx_buffer + msg_start_pos, rx_buff_pos - msg_start_pos);
 			rx_buff_pos -= msg_start_pos;
+			stats.rx_dropped_bytes += msg_start_pos;
 		}
 
 		return 0;
@@ -198,16 +215,20 @@ ssize_t Transport_node::read(uint8_t *topic_ID, char out_buffer[], size_t buffer
 		PX4_ERR("                                 (↓ %lu)", (unsigned long)(header_size + payload_len));
 #endif /* PX4_ERR */
 		len = -1;
+		++stats.rx_crc_errors;
 
 	} else {
 		// copy message to outbuffer and set other return values
 		memmove(out_buffer, rx_buffer + msg_start_pos + header_size, payload_len);
 		*topic_ID = header->topic_ID;
 		len = payload_len + header_size;
+		++stats.rx_messages;
 	}
 
+	stats.rx_dropped_bytes += msg_start_pos;
+
 	// discard message from rx_buffer
-	rx_buff_pos -= header_size + payload_len;
+	rx_buff_pos -= msg_start_pos + header_size + payload_len;
 	memmove(rx_buffer, rx_buffer + msg_start_pos + header_size + payload_len, rx_buff_pos);
 
 	return len;
@@ -224,6 +245,63 @@ ssize_t Transport_node::write(const uint8_t topic_ID, char buffer[], size_t leng
 		return -1;
 	}
 
+	fill_header(topic_ID, buffer, length);
+
+	ssize_t len = node_write(buffer, length + sizeof(struct Header));
+	++stats.tx_writes;
+	if (len != ssize_t(length + sizeof(struct Header))) {
+		++stats.tx_errors;
+		return len;
+	}
+	++stats.tx_messages;
+	stats.tx_bytes += len;
+	return len + sizeof(struct Header);
+}
+
+ssize_t Transport_node::queue(const uint8_t topic_ID, char buffer[], size_t length)
+{
+	const size_t total_length = length + sizeof(struct Header);
+
+	if (!fds_OK() || total_length > sizeof(tx_buffer)) {
+		return -1;
+	}
+
+	if (tx_buff_pos + total_length > sizeof(tx_buffer) && flush() < 0) {
+		return -1;
+	}
+
+	fill_header(topic_ID, buffer, length);
+	memcpy(tx_buffer + tx_buff_pos, buffer, total_length);
+	tx_buff_pos += total_length;
+	++stats.tx_messages;
+
+	return total_length;
+}
+
+ssize_t Transport_node::flush()
+{
+	if (tx_buff_pos == 0) {
+		return 0;
+	}
+
+	ssize_t len = node_write(tx_buffer, tx_buff_pos);
+	++stats.tx_writes;
+
+	if (len == ssize_t(tx_buff_pos)) {
+		stats.tx_bytes += len;
+
+	} else {
+		++stats.tx_errors;
+	}
+
+	// drop the queue on error as well, the messages are outdated on the next try
+	tx_buff_pos = 0;
+
+	return len;
+}
+
+void Transport_node::fill_header(const uint8_t topic_ID, char buffer[], size_t length)
+{
 	static struct Header header = {{'>', '>', '>'}, 0u, 0u, 0u, 0u, 0u, 0u};
 	static uint8_t seq = 0;
 
@@ -240,11 +318,6 @@ ssize_t Transport_node::write(const uint8_t topic_ID, char buffer[], size_t leng
 	/* Headroom for header is created in client */
 	/* Fill in the header in the same payload buffer to call a single node_write */
 	memcpy(buffer, &header, sizeof(header));
-	ssize_t len = node_write(buffer, length + sizeof(header));
-	if (len != ssize_t(length + sizeof(header))) {
-		return len;
-	}
-	return len + sizeof(header);
 }
 
 UART_node::UART_node(const char *_uart_name, uint32_t _baudrate, uint32_t _poll_ms):
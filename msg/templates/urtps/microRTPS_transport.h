@@ -41,6 +41,17 @@
 class Transport_node
 {
 public:
+	struct Stats {
+		uint64_t tx_bytes{0};		///< bytes written including headers
+		uint32_t tx_messages{0};	///< messages written or queued
+		uint32_t tx_writes{0};		///< node writes, less than tx_messages with batching
+		uint32_t tx_errors{0};		///< failed node writes
+		uint64_t rx_bytes{0};		///< bytes read including headers and garbage
+		uint32_t rx_messages{0};	///< messages parsed successfully
+		uint32_t rx_crc_errors{0};	///< messages dropped due to a CRC mismatch
+		uint32_t rx_dropped_bytes{0};	///< bytes dropped while searching for a message start
+	};
+
 	Transport_node();
 	virtual ~Transport_node();
 
@@ -62,9 +73,25 @@ public:
 	 */
 	ssize_t write(const uint8_t topic_ID, char buffer[], size_t length);
 
+	/**
+	 * queue a buffer to be written together with other messages by flush(), see write() for the buffer layout.
+	 * The queue is flushed first if the message does not fit anymore.
+	 * @return length on success, <0 on error
+	 */
+	ssize_t queue(const uint8_t topic_ID, char buffer[], size_t length);
+
+	/**
+	 * write all queued messages with a single node_write()
+	 * @return number of bytes written, <0 on error
+	 */
+	ssize_t flush();
+
 	/** Get the Length of struct Header to make headroom for the size of struct Header along with payload */
 	size_t get_header_length();
 
+	/** Transport statistics since the start */
+	const Stats &get_stats() const { return stats; }
+
 protected:
 	virtual ssize_t node_read(void *buffer, size_t len) = 0;
 	virtual ssize_t node_write(void *buffer, size_t len) = 0;
@@ -72,11 +99,21 @@ protected:
 	uint16_t crc16_byte(uint16_t crc, const uint8_t data);
 	uint16_t crc16(uint8_t const *buffer, size_t len);
 
+	/** parse the next complete message from rx_buffer, returns 0 if there is none yet */
+	ssize_t parse(uint8_t *topic_ID, char out_buffer[], size_t buffer_len);
+
 protected:
 	uint32_t rx_buff_pos;
 	char rx_buffer[1024] = {};
 
+	uint32_t tx_buff_pos{0};
+	char tx_buffer[1024] = {};
+
+	Stats stats{};
+
 private:
+	void fill_header(const uint8_t topic_ID, char buffer[], size_t length);
+
 	struct __attribute__((packed)) Header {
 		char marker[3];
 		uint8_t topic_ID;
@@ -109,6 +109,18 @@ def get_multi_topics(filename):
     return result
 
 
+def get_all_topics(msg_files):
+    """
+    Sorted list of all topic names (message names and additional TOPICS), the index in
+    this list is the topic ID (orb_metadata::o_id) and the position in orb_get_topics()
+    """
+    topics = [os.path.basename(fn).replace(".msg", "") for fn in msg_files if fn.endswith(".msg")]
+    for fn in msg_files:
+        if fn.endswith(".msg"):
+            topics.extend(get_multi_topics(fn))
+    return sorted(set(topics))
+
+
 def get_msgs_list(msgdir):
     """
     Makes list of msg files in the given directory
@@ -116,7 +128,7 @@ def get_msgs_list(msgdir):
     return [fn for fn in os.listdir(msgdir) if fn.endswith(".msg")]
 
 
-def generate_output_from_file(format_idx, filename, outputdir, package, templatedir, includepath):
+def generate_output_from_file(format_idx, filename, outputdir, package, templatedir, includepath, all_topics):
     """
     Converts a single .msg file to an uorb header/source file
     """
@@ -158,6 +170,7 @@ def generate_output_from_file(format_idx, filename, outputdir, package, template
         "msg_context": msg_context,
         "spec": spec,
         "topics": topics,
+        "all_topics": all_topics,
         "constrained_flash": CONSTRAINED_FLASH
     }
 
@@ -379,6 +392,7 @@ def convert_dir(format_idx, inputdir, outputdir, package, templatedir):
         return False
 
     includepath = INCL_DEFAULT + [':'.join([package, inputdir])]
+    all_topics = get_all_topics([os.path.join(inputdir, f) for f in get_msgs_list(inputdir)])
     for f in os.listdir(inputdir):
         # Ignore hidden files
         if f.startswith("."):
@@ -393,7 +407,7 @@ def convert_dir(format_idx, inputdir, outputdir, package, templatedir):
             continue
 
         generate_output_from_file(
-            format_idx, fn, outputdir, package, templatedir, includepath)
+            format_idx, fn, outputdir, package, templatedir, includepath, all_topics)
     return True
 
 
@@ -522,9 +536,10 @@ if __name__ == "__main__":
         print('Error: either --headers or --sources must be specified')
         exit(-1)
     if args.file is not None:
+        all_topics = get_all_topics(args.file)
         for f in args.file:
             generate_output_from_file(
-                generate_idx, f, args.temporarydir, args.package, args.templatedir, INCL_DEFAULT)
+                generate_idx, f, args.temporarydir, args.package, args.templatedir, INCL_DEFAULT, all_topics)
         if generate_idx == 1:
             generate_topics_list_file_from_files(
                 args.file, args.outputdir, args.templatedir)
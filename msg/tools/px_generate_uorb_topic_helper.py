@@ -310,6 +310,47 @@ def print_field(field):
               c_type + "\\n\", " + field_name + ");"))
 
 
+field_type_enum_map = {
+    'int8': 'ORB_FIELD_TYPE_INT8',
+    'int16': 'ORB_FIELD_TYPE_INT16',
+    'int32': 'ORB_FIELD_TYPE_INT32',
+    'int64': 'ORB_FIELD_TYPE_INT64',
+    'uint8': 'ORB_FIELD_TYPE_UINT8',
+    'uint16': 'ORB_FIELD_TYPE_UINT16',
+    'uint32': 'ORB_FIELD_TYPE_UINT32',
+    'uint64': 'ORB_FIELD_TYPE_UINT64',
+    'float32': 'ORB_FIELD_TYPE_FLOAT',
+    'float64': 'ORB_FIELD_TYPE_DOUBLE',
+    'bool': 'ORB_FIELD_TYPE_BOOL',
+    'char': 'ORB_FIELD_TYPE_CHAR',
+}
+
+
+def print_field_descriptor(field, uorb_struct):
+    """
+    Print the struct orb_field initializer of a field (padding is skipped)
+    """
+    if field.name.startswith('_padding'):
+        return
+
+    bare_type = field.type
+    if '/' in field.type:
+        # removing prefix
+        bare_type = (bare_type.split('/'))[1]
+
+    msg_type, is_array, array_length = genmsg.msgs.parse_type(bare_type)
+
+    if msg_type in field_type_enum_map:
+        nested_type = 'nullptr'
+        type_enum = field_type_enum_map[msg_type]
+    else:
+        nested_type = '"%s"' % msg_type
+        type_enum = 'ORB_FIELD_TYPE_NESTED'
+
+    print('\t{"%s", %s, offsetof(struct %s, %s), %d, %s},' % (field.name, nested_type, uorb_struct,
+                                                         field.name, array_length if is_array else 0, type_enum))
+
+
 def print_field_def(field):
     """
     Print the C type from a field
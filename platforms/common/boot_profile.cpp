@@ -0,0 +1,170 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file boot_profile.cpp
+ * Implementation of the API declared in boot_profile.h.
+ */
+
+#ifndef MODULE_NAME
+#define MODULE_NAME "boot_profile"
+#endif
+
+#include <px4_platform_common/boot_profile.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+#include <drivers/drv_hrt.h>
+
+#include <pthread.h>
+#include <string.h>
+
+static constexpr int BOOT_PROFILE_MAX_ENTRIES = 64;
+static constexpr uint32_t DURATION_MARK = UINT32_MAX; ///< duration of an entry recorded with px4_boot_profile_mark()
+
+struct boot_profile_entry_s {
+	const char *name;
+	uint32_t start_us;
+	uint32_t duration_us;
+};
+
+static pthread_mutex_t boot_profile_mutex = PTHREAD_MUTEX_INITIALIZER; // protects access to boot_profile_entries
+static boot_profile_entry_s boot_profile_entries[BOOT_PROFILE_MAX_ENTRIES];
+static int boot_profile_num_entries = 0;
+static bool boot_profile_overflow = false;
+
+static px4::atomic_bool parallel_start_active{false};
+static px4::atomic_int parallel_start_pending{0};
+
+static void boot_profile_add(const char *name, uint64_t start_us, uint32_t duration_us, bool once)
+{
+	pthread_mutex_lock(&boot_profile_mutex);
+
+	bool found = false;
+
+	if (once) {
+		for (int i = 0; i < boot_profile_num_entries; ++i) {
+			if (boot_profile_entries[i].name == name || strcmp(boot_profile_entries[i].name, name) == 0) {
+				found = true;
+				break;
+			}
+		}
+	}
+
+	if (!found) {
+		if (boot_profile_num_entries < BOOT_PROFILE_MAX_ENTRIES) {
+			boot_profile_entry_s &entry = boot_profile_entries[boot_profile_num_entries++];
+			entry.name = name;
+			entry.start_us = (uint32_t)start_us;
+			entry.duration_us = duration_us;
+
+		} else {
+			boot_profile_overflow = true;
+		}
+	}
+
+	pthread_mutex_unlock(&boot_profile_mutex);
+}
+
+void px4_boot_profile_record(const char *name, uint64_t start_us, uint64_t duration_us)
+{
+	boot_profile_add(name, start_us, duration_us < DURATION_MARK ? (uint32_t)duration_us : DURATION_MARK - 1, false);
+}
+
+void px4_boot_profile_mark(const char *name)
+{
+	boot_profile_add(name, hrt_absolute_time(), DURATION_MARK, true);
+}
+
+void px4_boot_profile_print()
+{
+	pthread_mutex_lock(&boot_profile_mutex);
+
+	PX4_INFO_RAW("    start [ms]  duration [ms]  name\n");
+
+	for (int i = 0; i < boot_profile_num_entries; ++i) {
+		const boot_profile_entry_s &entry = boot_profile_entries[i];
+
+		if (entry.duration_us == DURATION_MARK) {
+			PX4_INFO_RAW("%13.1f  %13s  %s\n", (double)(entry.start_us / 1e3f), "-", entry.name);
+
+		} else {
+			PX4_INFO_RAW("%13.1f  %13.1f  %s\n", (double)(entry.start_us / 1e3f), (double)(entry.duration_us / 1e3f),
+				     entry.name);
+		}
+	}
+
+	if (boot_profile_overflow) {
+		PX4_WARN("boot profile full, later entries are not recorded");
+	}
+
+	pthread_mutex_unlock(&boot_profile_mutex);
+}
+
+void px4_parallel_start_begin()
+{
+	parallel_start_active.store(true);
+}
+
+int px4_parallel_start_end()
+{
+	parallel_start_active.store(false);
+
+	// wait up to 10 s for all module starts of the group to return
+	for (int i = 0; i < 1000 && parallel_start_pending.load() > 0; ++i) {
+		px4_usleep(10000);
+	}
+
+	if (parallel_start_pending.load() > 0) {
+		PX4_ERR("timeout waiting for %i module start(s)", parallel_start_pending.load());
+		return -1;
+	}
+
+	return 0;
+}
+
+bool px4_parallel_start_active()
+{
+	return parallel_start_active.load();
+}
+
+void px4_parallel_start_add()
+{
+	parallel_start_pending.fetch_add(1);
+}
+
+void px4_parallel_start_done()
+{
+	parallel_start_pending.fetch_sub(1);
+}
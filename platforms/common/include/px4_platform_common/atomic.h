@@ -73,6 +73,7 @@ public:
 #endif
 
 
+	atomic() : _value{} {}
 	explicit atomic(T value) : _value(value) {}
 
 	/**
@@ -99,6 +100,23 @@ public:
 #endif
 	}
 
+	/**
+	 * Atomically replace the value and return the previous value
+	 */
+	inline T exchange(T value)
+	{
+#ifdef __PX4_QURT
+		// no __atomic_exchange_n on Qurt, use a compare and exchange loop instead
+		T prev = _value;
+
+		while (!compare_exchange(&prev, value)) {}
+
+		return prev;
+#else
+		return __atomic_exchange_n(&_value, value, __ATOMIC_SEQ_CST);
+#endif
+	}
+
 	/**
 	 * Atomically add a number and return the previous value.
 	 * @return value prior to the addition
@@ -168,7 +186,7 @@ public:
 	 */
 	inline bool compare_exchange(T *expected, T num)
 	{
-		return __atomic_compare_exchange(&_value, expected, num, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+		return __atomic_compare_exchange_n(&_value, expected, num, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
 	}
 
 private:
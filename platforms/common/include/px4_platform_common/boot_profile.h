@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file boot_profile.h
+ * Boot time profiling and parallel module start.
+ *
+ * ModuleBase records the duration of every 'start' command, together with marks like
+ * the time the system became ready to arm, this gives the boot profile printed with
+ * 'boot_profile status'.
+ *
+ * Between 'boot_profile begin_parallel' and 'boot_profile end_parallel' the start
+ * commands of ModuleBase modules return immediately and the modules start concurrently,
+ * end_parallel waits until all of them are started. This must only be used for modules
+ * that do not depend on each other, and whose start result is not checked.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+__BEGIN_DECLS
+
+/**
+ * Record the start of a module.
+ * @param name module name, must be a string with static storage (e.g. MODULE_NAME)
+ * @param start_us start time (hrt_absolute_time())
+ * @param duration_us duration of the start
+ */
+__EXPORT void px4_boot_profile_record(const char *name, uint64_t start_us, uint64_t duration_us);
+
+/**
+ * Record a boot event at the current time, only the first call per name is recorded.
+ * @param name event name, must be a string with static storage
+ */
+__EXPORT void px4_boot_profile_mark(const char *name);
+
+/**
+ * Print the boot profile.
+ */
+__EXPORT void px4_boot_profile_print(void);
+
+/**
+ * Begin a group of modules that are started concurrently.
+ */
+__EXPORT void px4_parallel_start_begin(void);
+
+/**
+ * End the group of concurrently started modules and wait until all of them are started.
+ * @return 0 on success, <0 on timeout
+ */
+__EXPORT int px4_parallel_start_end(void);
+
+/**
+ * @return true if module starts should be run concurrently
+ */
+__EXPORT bool px4_parallel_start_active(void);
+
+/**
+ * Called by a module start before (px4_parallel_start_add()) and after (px4_parallel_start_done())
+ * it runs concurrently.
+ */
+__EXPORT void px4_parallel_start_add(void);
+__EXPORT void px4_parallel_start_done(void);
+
+__END_DECLS
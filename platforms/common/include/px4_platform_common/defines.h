@@ -63,6 +63,17 @@ constexpr bool PX4_ISFINITE(double x) { return __builtin_isfinite(x); }
 #define PX4_STORAGEDIR PX4_ROOTFSDIR "/fs/microsd"
 #define _PX4_IOC(x,y) _IOC(x,y)
 
+#include <nuttx/config.h>
+
+/* Hot path code executed from tightly coupled instruction memory (ITCM RAM on STM32F7/H7), which runs with zero
+ * wait states and does not depend on the flash accelerator or the instruction cache. The section is copied to RAM
+ * at boot by NuttX and requires support in the board linker script (see boards/px4/fmu-v5). */
+#if defined(CONFIG_ARCH_RAMFUNCS)
+#  define PX4_HOT __attribute__((section(".ramfunc"), long_call, noinline))
+#else
+#  define PX4_HOT
+#endif
+
 // mode for open with O_CREAT
 #define PX4_O_MODE_777 0777
 #define PX4_O_MODE_666 0666
@@ -124,6 +135,8 @@ __END_DECLS
 #define ERROR -1
 #define MAX_RAND 32767
 
+#define PX4_HOT
+
 #endif // defined(__PX4_POSIX)
 
 /* Math macro's for float literals. Do not use M_PI et al as they aren't
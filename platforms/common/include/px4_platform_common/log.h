@@ -132,6 +132,13 @@ __attribute__((format(printf, 3, 4)));
 __EXPORT void px4_log_raw(int level, const char *fmt, ...)
 __attribute__((format(printf, 2, 3)));
 
+/**
+ * Defer the console output and log_message publication of info and warning messages of the calling thread to a
+ * low priority output thread. Used by the work queue threads so that a burst of messages does not delay the other
+ * work items. Errors are always printed immediately.
+ */
+__EXPORT void px4_log_set_async(bool async);
+
 #if __GNUC__
 // Allow empty format strings.
 #pragma GCC diagnostic ignored "-Wformat-zero-length"
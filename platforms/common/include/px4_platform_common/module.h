@@ -42,23 +42,17 @@
 #include <stdbool.h>
 
 #include <px4_platform_common/atomic.h>
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/time.h>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/tasks.h>
 #include <systemlib/px4_macros.h>
+#include <drivers/drv_hrt.h>
 
 #ifdef __cplusplus
 
 #include <cstring>
 
-/**
- * @brief This mutex protects against race conditions during startup & shutdown of modules.
- *        There could be one mutex per module instantiation, but to reduce the memory footprint
- *        there is only a single global mutex. This sounds bad, but we actually don't expect
- *        contention here, as module startup is sequential.
- */
-extern pthread_mutex_t px4_modules_mutex;
-
 /**
  * @class ModuleBase
  *      Base class for modules, implementing common functionality,
@@ -200,6 +194,19 @@ public:
 	 */
 	static int start_command_base(int argc, char *argv[])
 	{
+		if (px4_parallel_start_active()) {
+			// Run the start in a separate task, the caller only waits for it at 'boot_profile end_parallel'.
+			px4_parallel_start_add();
+
+			if (px4_task_spawn_cmd("parallel_start", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, PX4_STACK_ADJUSTED(2500),
+					       (px4_main_t)&start_parallel_trampoline, (char *const *)argv) >= 0) {
+				return 0;
+			}
+
+			px4_parallel_start_done();
+		}
+
+		const hrt_abstime start_time = hrt_absolute_time();
 		int ret = 0;
 		lock_module();
 
@@ -216,6 +223,28 @@ public:
 		}
 
 		unlock_module();
+
+		px4_boot_profile_record(MODULE_NAME, start_time, hrt_elapsed_time(&start_time));
+
+		return ret;
+	}
+
+	/**
+	 * @brief Entry point of the task running the module start within a parallel start group.
+	 * @param argc The task argument count.
+	 * @param argc Pointer to the task argument variable array.
+	 * @return Returns 0 iff successful, -1 otherwise.
+	 */
+	static int start_parallel_trampoline(int argc, char *argv[])
+	{
+#ifdef __PX4_NUTTX
+		// On NuttX task_create() adds the task name as first argument.
+		argc -= 1;
+		argv += 1;
+#endif
+
+		int ret = start_command_base(argc, argv);
+		px4_parallel_start_done();
 		return ret;
 	}
 
@@ -406,7 +435,7 @@ private:
 	 */
 	static void lock_module()
 	{
-		pthread_mutex_lock(&px4_modules_mutex);
+		pthread_mutex_lock(&_module_mutex);
 	}
 
 	/**
@@ -414,9 +443,15 @@ private:
 	 */
 	static void unlock_module()
 	{
-		pthread_mutex_unlock(&px4_modules_mutex);
+		pthread_mutex_unlock(&_module_mutex);
 	}
 
+	/**
+	 * @var _module_mutex Protects against race conditions during startup & shutdown of the module.
+	 * @note There is one mutex per module type, so that modules can be started concurrently.
+	 */
+	static pthread_mutex_t _module_mutex;
+
 	/** @var _task_should_exit Boolean flag to indicate if the task should exit. */
 	px4::atomic_bool _task_should_exit{false};
 };
@@ -427,6 +462,9 @@ px4::atomic<T *> ModuleBase<T>::_object{nullptr};
 template<class T>
 int ModuleBase<T>::_task_id = -1;
 
+template<class T>
+pthread_mutex_t ModuleBase<T>::_module_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 
 #endif /* __cplusplus */
 
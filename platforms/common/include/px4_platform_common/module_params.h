@@ -75,22 +75,59 @@ protected:
 	/**
 	 * @brief Call this method whenever the module gets a parameter change notification.
 	 *        It will automatically call updateParams() for all children, which then call updateParamsImpl().
+	 *
+	 *        Parameters are read without locking. The values are re-read if a parameter was written
+	 *        in the meantime, and not read at all if nothing changed since the last update.
 	 */
 	virtual void updateParams()
 	{
+		_params_updated = false;
+
 		for (const auto &child : _children) {
 			child->updateParams();
+			_params_updated |= child->_params_updated;
 		}
 
-		updateParamsImpl();
+		for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+			const uint32_t generation = param_generation();
+
+			if (generation == _param_generation) {
+				break;
+			}
+
+			updateParamsImpl();
+
+			if (param_generation() == generation) {
+				// consistent snapshot, only remember it if no write was in progress
+				if ((generation & 1) == 0) {
+					_param_generation = generation;
+				}
+
+				break;
+			}
+		}
 	}
 
+	/**
+	 * @brief Check whether the last updateParams() call changed the value of any parameter
+	 *        of this class or its children. Use it to skip re-deriving state from the parameters.
+	 */
+	bool updatedParams() const { return _params_updated; }
+
 	/**
 	 * @brief The implementation for this is generated with the macro DEFINE_PARAMETERS()
 	 */
 	virtual void updateParamsImpl() {}
 
+	/** set by updateParamsImpl() if a parameter value changed */
+	bool _params_updated{false};
+
 private:
+	static constexpr int MAX_READ_ATTEMPTS{3};
+
 	/** @list _children The module parameter list of inheriting classes. */
 	List<ModuleParams *> _children;
+
+	/** parameter generation of the last consistent read, odd means never read */
+	uint32_t _param_generation{UINT32_MAX};
 };
@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file namespace.h
+ *
+ * Namespace of the calling thread. A namespace isolates the uORB topics of one vehicle, so that several
+ * vehicles can share a process and its work queues (SITL). Work items keep the namespace of the thread
+ * that created them, the work queues switch to it before running an item, and tasks started with
+ * px4_task_spawn_cmd() inherit the namespace of the spawning thread. Threads created directly with
+ * pthread_create() start in namespace 0.
+ * Namespaces are only available on POSIX, everything else always runs in namespace 0.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace px4
+{
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+// inline (not static) so that all translation units share the same thread local storage
+inline uint8_t &thread_namespace()
+{
+	static thread_local uint8_t ns{0};
+	return ns;
+}
+
+inline uint8_t get_namespace() { return thread_namespace(); }
+inline void set_namespace(uint8_t ns) { thread_namespace() = ns; }
+
+#else
+
+inline uint8_t get_namespace() { return 0; }
+inline void set_namespace(uint8_t) {}
+
+#endif // __PX4_POSIX && !__PX4_QURT
+
+} // namespace px4
@@ -58,13 +58,20 @@ inline static param_t param_handle(px4::params p)
 	do_not_explicitly_use_this_namespace::PAIR(x);
 
 #define _CALL_UPDATE(x) \
-	STRIP(x).update();
+	{ \
+		const auto previous = STRIP(x).get(); \
+		STRIP(x).update(values); \
+		_params_updated |= (previous != STRIP(x).get()); \
+	}
 
 // define the parameter update method, which will update all parameters.
+// The values are loaded directly from the current values of the parameter storage (param_get_values()),
+// indexed by the compile-time parameter handles, so there is no param_get() call per parameter.
 // It is marked as 'final', so that wrong usages lead to a compile error (see below)
 #define _DEFINE_PARAMETER_UPDATE_METHOD(...) \
 	protected: \
 	void updateParamsImpl() final { \
+		const param_value_u *values = param_get_values(); \
 		APPLY_ALL(_CALL_UPDATE, __VA_ARGS__) \
 	} \
 	private:
@@ -84,6 +91,7 @@ inline static param_t param_handle(px4::params p)
 	protected: \
 	void updateParamsImpl() override { \
 		parent_class::updateParamsImpl(); \
+		const param_value_u *values = param_get_values(); \
 		APPLY_ALL(_CALL_UPDATE, __VA_ARGS__) \
 	} \
 	private:
@@ -134,6 +142,17 @@ public:
 
 	bool update() { return param_get(handle(), &_val) == 0; }
 
+	/// Update from the values of param_get_values(), with param_get() as fallback if there are none
+	bool update(const param_value_u *values)
+	{
+		if (values) {
+			_val = values[(int)p].f;
+			return true;
+		}
+
+		return update();
+	}
+
 	param_t handle() const { return param_handle(p); }
 private:
 	float _val;
@@ -168,6 +187,17 @@ public:
 
 	bool update() { return param_get(handle(), &_val) == 0; }
 
+	/// Update from the values of param_get_values(), with param_get() as fallback if there are none
+	bool update(const param_value_u *values)
+	{
+		if (values) {
+			_val = values[(int)p].f;
+			return true;
+		}
+
+		return update();
+	}
+
 	param_t handle() const { return param_handle(p); }
 private:
 	float &_val;
@@ -200,6 +230,17 @@ public:
 
 	bool update() { return param_get(handle(), &_val) == 0; }
 
+	/// Update from the values of param_get_values(), with param_get() as fallback if there are none
+	bool update(const param_value_u *values)
+	{
+		if (values) {
+			_val = values[(int)p].i;
+			return true;
+		}
+
+		return update();
+	}
+
 	param_t handle() const { return param_handle(p); }
 private:
 	int32_t _val;
@@ -234,6 +275,17 @@ public:
 
 	bool update() { return param_get(handle(), &_val) == 0; }
 
+	/// Update from the values of param_get_values(), with param_get() as fallback if there are none
+	bool update(const param_value_u *values)
+	{
+		if (values) {
+			_val = values[(int)p].i;
+			return true;
+		}
+
+		return update();
+	}
+
 	param_t handle() const { return param_handle(p); }
 private:
 	int32_t &_val;
@@ -285,6 +337,17 @@ public:
 		return false;
 	}
 
+	/// Update from the values of param_get_values(), with param_get() as fallback if there are none
+	bool update(const param_value_u *values)
+	{
+		if (values) {
+			_val = values[(int)p].i != 0;
+			return true;
+		}
+
+		return update();
+	}
+
 	param_t handle() const { return param_handle(p); }
 private:
 	bool _val;
@@ -128,4 +128,47 @@ __BEGIN_DECLS
 
 __EXPORT void		px4_show_files(void);
 
+#define PX4_WAITSET_MAX_FDS	8
+
+/**
+ * Persistent set of file descriptors to wait on.
+ *
+ * Unlike px4_poll(), the fds are registered with the drivers once in px4_waitset_add()
+ * and stay registered until px4_waitset_destroy(), so waiting in a loop does not set up
+ * and tear down the poll on every call.
+ * The wait set must not be moved or copied while fds are registered, and it must be
+ * destroyed before the fds are closed.
+ */
+typedef struct {
+	px4_pollfd_struct_t	fds[PX4_WAITSET_MAX_FDS];	/* revents is valid after px4_waitset_wait() */
+	unsigned int		nfds;
+#ifdef __PX4_POSIX
+	px4_sem_t		sem;
+#endif
+} px4_waitset_t;
+
+/**
+ * Initialize an empty wait set.
+ * @return 0 on success
+ */
+__EXPORT int		px4_waitset_create(px4_waitset_t *ws);
+
+/**
+ * Add a file descriptor to a wait set.
+ * @return index of the fd in ws->fds, or < 0 on error
+ */
+__EXPORT int		px4_waitset_add(px4_waitset_t *ws, int fd, px4_pollevent_t events);
+
+/**
+ * Wait until at least one fd of the set has events.
+ * @param timeout timeout in ms, 0 to check without waiting, < 0 to wait forever
+ * @return number of fds with events (see ws->fds[i].revents), 0 on timeout, < 0 on error
+ */
+__EXPORT int		px4_waitset_wait(px4_waitset_t *ws, int timeout);
+
+/**
+ * Unregister all fds of a wait set.
+ */
+__EXPORT void		px4_waitset_destroy(px4_waitset_t *ws);
+
 __END_DECLS
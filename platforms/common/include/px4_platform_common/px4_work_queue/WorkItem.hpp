@@ -38,6 +38,7 @@
 
 #include <containers/IntrusiveQueue.hpp>
 #include <px4_platform_common/defines.h>
+#include <px4_platform_common/namespace.h>
 #include <drivers/drv_hrt.h>
 
 #include <lib/perf/perf_counter.h>
@@ -66,6 +67,8 @@ public:
 
 	virtual void print_run_status() const;
 
+	const char *ItemName() const { return _item_name; }
+
 	/**
 	 * Switch to a different WorkQueue.
 	 * NOTE: Caller is responsible for synchronization.
@@ -84,8 +87,9 @@ protected:
 protected:
 
 	void RunPreamble() { _run_count++; }
+	void RunPostamble(hrt_abstime run_time);
 
-	friend void WorkQueue::Run();
+	friend class WorkQueue;
 	virtual void Run() = 0;
 
 	/**
@@ -103,11 +107,29 @@ protected:
 	float average_rate() const;
 	float average_interval() const;
 
+	uint32_t run_time_max() const { return _run_time_max; }
+	float run_time_mean() const;
+	uint32_t deadline_misses() const { return _deadline_misses; }
+
+	/**
+	 * Print the run time columns (min/mean/max, deadline misses) shared by all print_run_status() variants.
+	 */
+	void print_run_time_status() const;
 
 	hrt_abstime	_start_time{0};
 	unsigned	_run_count{0};
 	const char 	*_item_name;
 
+	uint32_t	_run_time_min{UINT32_MAX};	///< shortest Run() duration (us)
+	uint32_t	_run_time_max{0};		///< longest Run() duration (us)
+	uint64_t	_run_time_total{0};		///< accumulated Run() duration (us)
+	uint32_t	_deadline_misses{0};		///< scheduled again while the previous Run() was still executing
+	px4::atomic_bool _queued{false};		///< queued for the worker (lock-free add)
+	WorkItem	*_pending_next{nullptr};	///< link in the WorkQueue lock-free pending stack
+	bool		_pool_queued{false};		///< pool work queue: queued in one of the worker deques
+	bool		_pool_rerun{false};		///< pool work queue: run again once the current run finished
+	const uint8_t	_namespace{px4::get_namespace()};	///< namespace of the creating thread, active while running
+
 private:
 
 	WorkQueue	*_wq{nullptr};
@@ -42,6 +42,7 @@
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/sem.h>
 #include <px4_platform_common/tasks.h>
+#include <drivers/drv_hrt.h>
 
 namespace px4
 {
@@ -51,6 +52,11 @@ class WorkItem;
 class WorkQueue : public ListNode<WorkQueue *>
 {
 public:
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+	static constexpr uint8_t MAX_THREADS = 8; ///< maximum number of pool worker threads
+#else
+	static constexpr uint8_t MAX_THREADS = 1;
+#endif /* __PX4_POSIX && !__PX4_QURT */
 	explicit WorkQueue(const wq_config_t &wq_config);
 	WorkQueue() = delete;
 
@@ -66,18 +72,54 @@ public:
 
 	void Clear();
 
-	void Run();
+	/**
+	 * Process queued work until requested to stop.
+	 * Pool work queues call this once from each worker thread.
+	 *
+	 * @param worker The pool worker index [0, threads()).
+	 */
+	void Run(uint8_t worker = 0);
+
+	/**
+	 * Number of worker threads, 1 for a regular (ordered) work queue.
+	 */
+	uint8_t threads() const { return _threads; }
+
+	/**
+	 * Set the CPU affinity mask of all worker threads (Linux only).
+	 *
+	 * @param affinity CPU affinity mask (bit n allows core n), 0 for any core.
+	 */
+	void set_affinity(uint32_t affinity);
+	uint32_t affinity() const { return _affinity; }
 
 	void request_stop() { _should_exit.store(true); }
 
 	void print_status(bool last = false);
 
+	/**
+	 * Fill run time statistics aggregated over all attached WorkItems.
+	 */
+	void get_status(wq_status_t &status);
+
+	/**
+	 * Fraction of time [0, 1] spent running WorkItems since the queue started.
+	 */
+	float utilization() const;
+
 private:
 
 	bool should_exit() const { return _should_exit.load(); }
 
 	inline void signal_worker_thread();
 
+	void queue_pool_item(WorkItem *item);
+	WorkItem *pop_item(uint8_t worker);
+
+	void apply_affinity(uint8_t worker);
+
+	void drain_pending();
+
 #ifdef __PX4_NUTTX
 	// In NuttX work can be enqueued from an ISR
 	void work_lock() { _flags = enter_critical_section(); }
@@ -89,12 +131,28 @@ private:
 	px4_sem_t _qlock;
 #endif
 
-	IntrusiveQueue<WorkItem *>	_q;
+	IntrusiveQueue<WorkItem *>	_q[MAX_THREADS];	///< one deque per worker thread
+
+	// single thread work queues: lock-free multi-producer stack, drained into _q by the worker
+	px4::atomic<WorkItem *>		_pending{nullptr};
+	px4::atomic_bool		_wakeup_pending{false};
 	px4_sem_t			_process_lock;
 	const wq_config_t		&_config;
 	BlockingList<WorkItem *>	_work_items;
 	px4::atomic_bool		_should_exit{false};
 
+	WorkItem			*_current_item[MAX_THREADS] {};	///< WorkItem currently running per worker (protected by work_lock)
+	uint8_t				_threads{1};
+	uint8_t				_next_worker{0};
+
+	uint32_t			_affinity{0};
+#if defined(__PX4_LINUX)
+	pthread_t			_thread_ids[MAX_THREADS] {};
+	bool				_thread_running[MAX_THREADS] {};
+#endif /* __PX4_LINUX */
+	hrt_abstime			_start_time{0};
+	hrt_abstime			_busy_time{0};		///< accumulated time spent in WorkItem::Run()
+
 };
 
 } // namespace px4
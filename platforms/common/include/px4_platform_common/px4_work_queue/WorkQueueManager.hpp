@@ -44,46 +44,90 @@ struct wq_config_t {
 	const char *name;
 	uint16_t stacksize;
 	int8_t relative_priority; // relative to max
+	uint8_t threads; // pool worker threads (POSIX only), 0 or 1 for a single ordered thread
+	uint32_t affinity; // CPU affinity mask, bit n allows core n (Linux only), 0 for any core
+	bool fast_stack; // stack in tightly coupled memory (CCM/DTCM) if provided by the board (NuttX only)
+};
+
+struct wq_status_t {
+	const char *name;
+	uint16_t num_items;
+	uint32_t run_count;
+	uint32_t deadline_misses;
+	uint32_t run_time_max; // longest WorkItem run (us)
+	float utilization; // fraction of time running WorkItems since start
+	uint32_t affinity; // CPU affinity mask applied to the work queue threads, 0 for any core
 };
 
 namespace wq_configurations
 {
-static constexpr wq_config_t rate_ctrl{"wq:rate_ctrl", 1600, 0}; // PX4 inner loop highest priority
-
-static constexpr wq_config_t SPI0{"wq:SPI0", 1900, -1};
-static constexpr wq_config_t SPI1{"wq:SPI1", 1900, -2};
-static constexpr wq_config_t SPI2{"wq:SPI2", 1900, -3};
-static constexpr wq_config_t SPI3{"wq:SPI3", 1900, -4};
-static constexpr wq_config_t SPI4{"wq:SPI4", 1900, -5};
-static constexpr wq_config_t SPI5{"wq:SPI5", 1900, -6};
-static constexpr wq_config_t SPI6{"wq:SPI6", 1900, -7};
-
-static constexpr wq_config_t I2C0{"wq:I2C0", 1400, -8};
-static constexpr wq_config_t I2C1{"wq:I2C1", 1400, -9};
-static constexpr wq_config_t I2C2{"wq:I2C2", 1400, -10};
-static constexpr wq_config_t I2C3{"wq:I2C3", 1400, -11};
-static constexpr wq_config_t I2C4{"wq:I2C4", 1400, -12};
-
-static constexpr wq_config_t att_pos_ctrl{"wq:att_pos_ctrl", 6600, -13}; // PX4 att/pos controllers, highest priority after sensors
-
-static constexpr wq_config_t hp_default{"wq:hp_default", 1900, -14};
-
-static constexpr wq_config_t uavcan{"wq:uavcan", 2400, -15};
-
-static constexpr wq_config_t UART0{"wq:UART0", 1400, -16};
-static constexpr wq_config_t UART1{"wq:UART1", 1400, -17};
-static constexpr wq_config_t UART2{"wq:UART2", 1400, -18};
-static constexpr wq_config_t UART3{"wq:UART3", 1400, -19};
-static constexpr wq_config_t UART4{"wq:UART4", 1400, -20};
-static constexpr wq_config_t UART5{"wq:UART5", 1400, -21};
-static constexpr wq_config_t UART6{"wq:UART6", 1400, -22};
-static constexpr wq_config_t UART7{"wq:UART7", 1400, -23};
-static constexpr wq_config_t UART8{"wq:UART8", 1400, -24};
-
-static constexpr wq_config_t lp_default{"wq:lp_default", 1700, -50};
-
-static constexpr wq_config_t test1{"wq:test1", 800, 0};
-static constexpr wq_config_t test2{"wq:test2", 800, 0};
+static constexpr wq_config_t rate_ctrl{"wq:rate_ctrl", 1600, 0, 1, 0, true}; // PX4 inner loop highest priority
+
+static constexpr wq_config_t SPI0{"wq:SPI0", 1900, -1, 1, 0, true};
+static constexpr wq_config_t SPI1{"wq:SPI1", 1900, -2, 1, 0, true};
+static constexpr wq_config_t SPI2{"wq:SPI2", 1900, -3, 1, 0, true};
+static constexpr wq_config_t SPI3{"wq:SPI3", 1900, -4, 1, 0, true};
+static constexpr wq_config_t SPI4{"wq:SPI4", 1900, -5, 1, 0, true};
+static constexpr wq_config_t SPI5{"wq:SPI5", 1900, -6, 1, 0, true};
+static constexpr wq_config_t SPI6{"wq:SPI6", 1900, -7, 1, 0, true};
+
+// asynchronous SPI transfers (device::SPI::transferAsync()), same priority as the bus work queue
+static constexpr wq_config_t SPI0_transfer{"wq:SPI0_xfer", 1200, -1, 1, 0, false};
+static constexpr wq_config_t SPI1_transfer{"wq:SPI1_xfer", 1200, -2, 1, 0, false};
+static constexpr wq_config_t SPI2_transfer{"wq:SPI2_xfer", 1200, -3, 1, 0, false};
+static constexpr wq_config_t SPI3_transfer{"wq:SPI3_xfer", 1200, -4, 1, 0, false};
+static constexpr wq_config_t SPI4_transfer{"wq:SPI4_xfer", 1200, -5, 1, 0, false};
+static constexpr wq_config_t SPI5_transfer{"wq:SPI5_xfer", 1200, -6, 1, 0, false};
+static constexpr wq_config_t SPI6_transfer{"wq:SPI6_xfer", 1200, -7, 1, 0, false};
+
+static constexpr wq_config_t I2C0{"wq:I2C0", 1400, -8, 1, 0, false};
+static constexpr wq_config_t I2C1{"wq:I2C1", 1400, -9, 1, 0, false};
+static constexpr wq_config_t I2C2{"wq:I2C2", 1400, -10, 1, 0, false};
+static constexpr wq_config_t I2C3{"wq:I2C3", 1400, -11, 1, 0, false};
+static constexpr wq_config_t I2C4{"wq:I2C4", 1400, -12, 1, 0, false};
+
+// asynchronous I2C transfers (device::I2C::transferAsync()), same priority as the bus work queue
+static constexpr wq_config_t I2C0_transfer{"wq:I2C0_xfer", 1200, -8, 1, 0, false};
+static constexpr wq_config_t I2C1_transfer{"wq:I2C1_xfer", 1200, -9, 1, 0, false};
+static constexpr wq_config_t I2C2_transfer{"wq:I2C2_xfer", 1200, -10, 1, 0, false};
+static constexpr wq_config_t I2C3_transfer{"wq:I2C3_xfer", 1200, -11, 1, 0, false};
+static constexpr wq_config_t I2C4_transfer{"wq:I2C4_xfer", 1200, -12, 1, 0, false};
+
+static constexpr wq_config_t att_pos_ctrl{"wq:att_pos_ctrl", 6600, -13, 1, 0, false}; // PX4 att/pos controllers, highest priority after sensors
+
+static constexpr wq_config_t hp_default{"wq:hp_default", 1900, -14, 1, 0, false};
+
+// ekf2 bank, one queue per estimator instance so that the instances can run in parallel on multi-core boards
+static constexpr wq_config_t INS0{"wq:INS0", 6600, -14, 1, 0, false};
+static constexpr wq_config_t INS1{"wq:INS1", 6600, -14, 1, 0, false};
+static constexpr wq_config_t INS2{"wq:INS2", 6600, -14, 1, 0, false};
+
+static constexpr wq_config_t uavcan{"wq:uavcan", 2400, -15, 1, 0, false};
+
+static constexpr wq_config_t UART0{"wq:UART0", 1400, -16, 1, 0, false};
+static constexpr wq_config_t UART1{"wq:UART1", 1400, -17, 1, 0, false};
+static constexpr wq_config_t UART2{"wq:UART2", 1400, -18, 1, 0, false};
+static constexpr wq_config_t UART3{"wq:UART3", 1400, -19, 1, 0, false};
+static constexpr wq_config_t UART4{"wq:UART4", 1400, -20, 1, 0, false};
+static constexpr wq_config_t UART5{"wq:UART5", 1400, -21, 1, 0, false};
+static constexpr wq_config_t UART6{"wq:UART6", 1400, -22, 1, 0, false};
+static constexpr wq_config_t UART7{"wq:UART7", 1400, -23, 1, 0, false};
+static constexpr wq_config_t UART8{"wq:UART8", 1400, -24, 1, 0, false};
+
+// commander has its own queue, as it can block for a while (e.g. sleeps while arming or rebooting)
+static constexpr wq_config_t commander{"wq:commander", 3250, -50, 1, 0, false};
+
+// navigator does blocking dataman (file) I/O, so it does not share a queue with other items
+static constexpr wq_config_t navigator{"wq:navigator", 1800, -50, 1, 0, false};
+
+static constexpr wq_config_t lp_default{"wq:lp_default", 1700, -50, 1, 0, false};
+
+// multi-threaded pool for WorkItems that are safe to run concurrently with other WorkItems
+//  (no ordering guarantees between items, a single item never runs concurrently with itself)
+static constexpr wq_config_t lp_pool{"wq:lp_pool", 1700, -50, 4, 0, false};
+
+static constexpr wq_config_t test1{"wq:test1", 800, 0, 1, 0, false};
+static constexpr wq_config_t test2{"wq:test2", 800, 0, 1, 0, false};
 
 } // namespace wq_configurations
 
@@ -102,6 +146,25 @@ int WorkQueueManagerStop();
  */
 int WorkQueueManagerStatus();
 
+/**
+ * Get run time statistics of all running work queues.
+ *
+ * @param status		Array to fill.
+ * @param max_count		Size of the status array.
+ * @return		Number of entries filled.
+ */
+int WorkQueueManagerGetStatus(wq_status_t *status, int max_count);
+
+/**
+ * Override the CPU affinity of a work queue. Applied immediately if the work queue is
+ * already running, otherwise when it's created. Only supported on Linux.
+ *
+ * @param name		The work queue name (eg wq:rate_ctrl).
+ * @param affinity		CPU affinity mask (bit n allows core n), 0 to restore the configured default.
+ * @return		PX4_OK on success.
+ */
+int WorkQueueSetAffinity(const char *name, uint32_t affinity);
+
 /**
  * Create (or find) a work queue with a particular configuration.
  *
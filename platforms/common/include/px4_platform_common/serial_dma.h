@@ -0,0 +1,111 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file serial_dma.h
+ * Frame based reception from a serial port.
+ *
+ * The UARTs used for GPS, RC and telemetry are configured with circular RX DMA
+ * (CONFIG_<uart>_RXDMA), so the serial driver buffers the incoming bytes without a
+ * wakeup per character. SerialDMA wakes up on the first byte, then waits until the
+ * line is idle for a few character times (the end of a frame or of a burst of frames)
+ * and hands out everything received with a single read().
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace px4
+{
+
+class SerialDMA
+{
+public:
+	SerialDMA() = default;
+	~SerialDMA() = default;
+
+	/**
+	 * Set the serial port (opened non-blocking or with VMIN=0) and its baudrate.
+	 */
+	void setDevice(int fd, unsigned baudrate);
+
+	/**
+	 * Update the baudrate used for the idle line detection, e.g. after a baudrate change.
+	 */
+	void setBaudrate(unsigned baudrate);
+
+	/**
+	 * Number of line idle character times that mark the end of a frame.
+	 */
+	void setIdleCharacters(unsigned idle_characters) { _idle_characters = idle_characters; }
+
+	/**
+	 * Wait for data, then for the end of the frame, and read it.
+	 * @param buf buffer for the received data
+	 * @param buf_length size of buf, reception stops early once that many bytes are buffered
+	 * @param timeout_ms maximum time to wait for the first byte [ms]
+	 * @return number of bytes read, 0 on timeout, <0 on error
+	 */
+	int readFrame(uint8_t *buf, size_t buf_length, int timeout_ms);
+
+	/**
+	 * Wait for the end of the frame, given that the port is already readable (e.g. after poll()).
+	 * @param max_bytes return early once that many bytes are buffered
+	 * @return number of bytes buffered in the driver, <0 if unknown
+	 */
+	int waitForFrameEnd(size_t max_bytes);
+
+	/**
+	 * Number of bytes buffered in the driver, <0 if unknown
+	 */
+	int bytesAvailable() const;
+
+	int fd() const { return _fd; }
+
+private:
+	/* the RX DMA buffer is drained at least once per 1ms, a shorter idle time would split frames */
+	static constexpr unsigned MIN_IDLE_TIME_US = 1000;
+
+	/* give up waiting for the line to become idle on a continuous stream after this */
+	static constexpr unsigned MAX_FRAME_WAIT_US = 20000;
+
+	unsigned idleTimeUs() const;
+
+	int _fd{-1};
+	unsigned _baudrate{115200};
+	unsigned _idle_characters{3};
+};
+
+} // namespace px4
@@ -33,22 +33,43 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <parameters/param.h>
 
 #define MAX_SHMEM_PARAMS 2000 //MAP_SIZE - (LOCK_SIZE - sizeof(struct shmem_info))
 
-#define PARAM_BUFFER_SIZE (MAX_SHMEM_PARAMS / 8 + 1)
+#define PARAM_JOURNAL_SIZE 64		///< number of changes a journal holds, power of 2
+#define PARAM_JOURNAL_READ_MAX 32	///< number of changes krait reads per RPC call
 
-struct shmem_info {
-	union param_value_u params_val[MAX_SHMEM_PARAMS];
-	unsigned char krait_changed_index[MAX_SHMEM_PARAMS / 8 + 1]; /*bit map of all params changed by krait*/
-	unsigned char adsp_changed_index[MAX_SHMEM_PARAMS / 8 + 1]; /*bit map of all params changed by adsp*/
+/**
+ * A parameter change in the journal.
+ */
+struct param_journal_entry_s {
+	uint32_t seq;			///< sequence number of the change, not valid while the entry is written
+	uint32_t param;
+	union param_value_u val;
+};
 
-#ifdef __PX4_NUTTX
+/**
+ * Ring of the parameter changes of one processor. The other processor keeps the sequence number
+ * of the last change it has applied and only applies the changes after it, so neither side has to
+ * lock or scan the whole table. Several writers reserve their entry by incrementing the head.
+ * A reader that fell behind by more than PARAM_JOURNAL_SIZE changes resyncs from params_val.
+ */
+struct param_journal_s {
+	uint32_t head;			///< sequence number of the last reserved entry
+	struct param_journal_entry_s entries[PARAM_JOURNAL_SIZE];
 };
-#else
-} __attribute__((packed));
-#endif
+
+struct shmem_info {
+	union param_value_u params_val[MAX_SHMEM_PARAMS];	///< current values, used to resync after a journal overflow
+	struct param_journal_s krait_journal;			///< changes made by krait, applied by adsp
+	struct param_journal_s adsp_journal;			///< changes made by adsp, applied by krait
+};
+
+/** RPC buffer size of the journal reads from krait, also used for the values read on a resync */
+#define PARAM_BUFFER_SIZE (PARAM_JOURNAL_READ_MAX * sizeof(struct param_journal_entry_s))
 
 #if (defined(__PX4_POSIX_EXCELSIOR) || defined(__PX4_QURT_EXCELSIOR))
 #define MAP_ADDRESS    0x861FC000
@@ -58,25 +79,43 @@ struct shmem_info {
 #define MAP_SIZE 	16384
 #define MAP_MASK 	(MAP_SIZE - 1)
 
-#define LOCK_OFFSET	0
-#define LOCK_SIZE	4
-#define LOCK_MEM        1
-#define UNLOCK_MEM      2
-
 #define TYPE_MASK 	0x1
 
 extern bool handle_in_range(param_t);
 
+/**
+ * Applies a parameter change of the other processor to the local parameter store.
+ */
+typedef void (*param_apply_func_t)(param_t param, union param_value_u value);
+
 #ifdef __PX4_QURT
 extern struct shmem_info *shmem_info_p;
 
-int get_shmem_lock(const char *caller_file_name, int caller_line_number);
-void release_shmem_lock(const char *caller_file_name, int caller_line_number);
 void init_shared_memory(void);
 
 void copy_params_to_shmem(const param_info_s *param_info_base);
+
+/**
+ * Add a change to a journal and to the values table, lock-free.
+ */
+void param_journal_append(struct param_journal_s *journal, param_t param, union param_value_u value);
+
+/**
+ * Read the changes of a journal after *read_seq, lock-free.
+ * @param read_seq sequence number of the last change read, updated
+ * @return number of changes read, or -1 if changes were lost and the reader needs to resync
+ */
+int param_journal_read(const struct param_journal_s *journal, uint32_t *read_seq,
+		       struct param_journal_entry_s *entries, int max_entries);
 #endif
 
+/**
+ * Publish a change of this processor to the other one.
+ */
 void update_to_shmem(param_t param, union param_value_u value);
-int update_from_shmem(param_t param, union param_value_u *value);
-void update_index_from_shmem(void);
+
+/**
+ * Apply the changes of the other processor since the last call.
+ * Krait polls the adsp at most once per second, unless force is set.
+ */
+void update_from_shmem(param_apply_func_t apply, bool force);
@@ -146,6 +146,9 @@ typedef struct {
 // The navigation system needs to execute regularly but has no realtime needs
 #define SCHED_PRIORITY_NAVIGATION		(SCHED_PRIORITY_DEFAULT + 5)
 //      SCHED_PRIORITY_DEFAULT
+
+// Deferred console output of the work queue threads (px4_log_set_async())
+#define SCHED_PRIORITY_LOG_OUTPUT		(SCHED_PRIORITY_DEFAULT - 5)
 #define SCHED_PRIORITY_LOG_WRITER		(SCHED_PRIORITY_DEFAULT - 10)
 #define SCHED_PRIORITY_PARAMS			(SCHED_PRIORITY_DEFAULT - 15)
 //      SCHED_PRIORITY_IDLE
@@ -44,8 +44,6 @@
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/log.h>
 
-pthread_mutex_t px4_modules_mutex = PTHREAD_MUTEX_INITIALIZER;
-
 #ifndef __PX4_NUTTX
 
 void PRINT_MODULE_DESCRIPTION(const char *description)
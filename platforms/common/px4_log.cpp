@@ -35,6 +35,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #ifndef MODULE_NAME
 #define MODULE_NAME "log"
@@ -49,12 +50,225 @@
 #include <uORB/topics/log_message.h>
 #include <drivers/drv_hrt.h>
 
+#if !defined(CONSTRAINED_FLASH)
+// info and warning messages of work queue threads are printed by a low priority output thread
+#define PX4_LOG_ASYNC
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/posix.h>
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/sem.h>
+#include <px4_platform_common/tasks.h>
+#endif
+
 static orb_advert_t orb_log_message_pub = nullptr;
 
 __EXPORT const char *__px4_log_level_str[_PX4_LOG_LEVEL_PANIC + 1] = { "DEBUG", "INFO", "WARN", "ERROR", "PANIC" };
 __EXPORT const char *__px4_log_level_color[_PX4_LOG_LEVEL_PANIC + 1] =
 { PX4_ANSI_COLOR_GREEN, PX4_ANSI_COLOR_RESET, PX4_ANSI_COLOR_YELLOW, PX4_ANSI_COLOR_RED, PX4_ANSI_COLOR_RED };
 
+#if defined(PX4_LOG_ASYNC)
+
+#if defined(__PX4_NUTTX)
+static constexpr unsigned LOG_QUEUE_LENGTH = 8;
+#else
+static constexpr unsigned LOG_QUEUE_LENGTH = 32;
+#endif
+
+static_assert((LOG_QUEUE_LENGTH & (LOG_QUEUE_LENGTH - 1)) == 0, "LOG_QUEUE_LENGTH must be a power of 2");
+
+/**
+ * Bounded multi-producer queue of formatted messages. An entry is free for the producer at
+ * position pos if its sequence equals pos, and ready for the output thread if it equals pos + 1.
+ */
+struct log_queue_entry_s {
+	px4::atomic<uint32_t> sequence{0};
+	hrt_abstime timestamp;
+	const char *module_name; // MODULE_NAME string literal
+	int level;
+	char text[sizeof(log_message_s::text)];
+};
+
+static log_queue_entry_s log_queue[LOG_QUEUE_LENGTH];
+static px4::atomic<uint32_t> log_queue_head{0};
+static uint32_t log_queue_tail{0}; // only used by the output thread
+static px4::atomic<uint32_t> log_queue_dropped{0};
+static px4::atomic_bool log_output_running{false};
+static px4_sem_t log_output_sem;
+
+#if defined(__PX4_NUTTX)
+// No thread local storage, but the pid of a running thread is unique modulo CONFIG_MAX_TASKS.
+// The slot stores the pid that enabled async output (0: none), so that a task exiting without
+// clearing it (e.g. deleted) does not pass the flag on to a new task reusing the slot.
+static pid_t log_async_task[CONFIG_MAX_TASKS] {};
+
+static inline bool log_async_thread()
+{
+	const pid_t pid = getpid();
+	return log_async_task[pid & (CONFIG_MAX_TASKS - 1)] == pid;
+}
+
+static inline void log_async_thread_set(bool async)
+{
+	const pid_t pid = getpid();
+	log_async_task[pid & (CONFIG_MAX_TASKS - 1)] = async ? pid : 0;
+}
+#else
+static thread_local bool log_async{false};
+
+static inline bool log_async_thread() { return log_async; }
+static inline void log_async_thread_set(bool async) { log_async = async; }
+#endif
+
+#endif // PX4_LOG_ASYNC
+
+static void log_console(int level, const char *module_name, const char *fmt, va_list argptr)
+{
+	FILE *out = stdout;
+	bool use_color = true;
+
+#ifdef __PX4_POSIX
+	out = get_stdout(&use_color);
+#endif
+
+#ifndef PX4_LOG_COLORIZED_OUTPUT
+	use_color = false;
+#endif
+
+	if (use_color) { fputs(__px4_log_level_color[level], out); }
+
+	fprintf(out, __px4__log_level_fmt __px4__log_level_arg(level));
+
+	if (use_color) { fputs(PX4_ANSI_COLOR_GRAY, out); }
+
+	fprintf(out, __px4__log_modulename_pfmt, module_name);
+
+	if (use_color) { fputs(__px4_log_level_color[level], out); }
+
+	vfprintf(out, fmt, argptr);
+
+	if (use_color) { fputs(PX4_ANSI_COLOR_RESET, out); }
+
+	fputc('\n', out);
+}
+
+static void log_publish(int level, hrt_abstime timestamp, const char *module_name, const char *fmt, va_list argptr)
+{
+	struct log_message_s log_message;
+	const unsigned max_length_pub = sizeof(log_message.text);
+	log_message.timestamp = timestamp;
+
+	const uint8_t log_level_table[] = {
+		7, /* _PX4_LOG_LEVEL_DEBUG */
+		6, /* _PX4_LOG_LEVEL_INFO */
+		4, /* _PX4_LOG_LEVEL_WARN */
+		3, /* _PX4_LOG_LEVEL_ERROR */
+		0  /* _PX4_LOG_LEVEL_PANIC */
+	};
+	log_message.severity = log_level_table[level];
+
+	unsigned pos = 0;
+
+	pos += snprintf((char *)log_message.text + pos, max_length_pub - pos, __px4__log_modulename_pfmt, module_name);
+	pos += vsnprintf((char *)log_message.text + pos, max_length_pub - pos, fmt, argptr);
+	log_message.text[max_length_pub - 1] = 0; //ensure 0-termination
+
+#if !defined(PARAM_NO_ORB)
+	orb_publish(ORB_ID(log_message), orb_log_message_pub, &log_message);
+#endif /* !PARAM_NO_ORB */
+}
+
+#if defined(PX4_LOG_ASYNC)
+
+static void log_output(int level, hrt_abstime timestamp, const char *module_name, const char *fmt, ...)
+{
+	va_list argptr;
+	va_start(argptr, fmt);
+	log_console(level, module_name, fmt, argptr);
+	va_end(argptr);
+
+	va_start(argptr, fmt);
+	log_publish(level, timestamp, module_name, fmt, argptr);
+	va_end(argptr);
+}
+
+static int log_output_thread(int argc, char *argv[])
+{
+	while (true) {
+		px4_sem_wait(&log_output_sem);
+
+		while (true) {
+			log_queue_entry_s &entry = log_queue[log_queue_tail % LOG_QUEUE_LENGTH];
+
+			if (entry.sequence.load() != log_queue_tail + 1) {
+				break;
+			}
+
+			log_output(entry.level, entry.timestamp, entry.module_name, "%s", entry.text);
+
+			// hand the entry back to the producers
+			entry.sequence.store(log_queue_tail + LOG_QUEUE_LENGTH);
+			log_queue_tail++;
+		}
+
+		const uint32_t dropped = log_queue_dropped.exchange(0);
+
+		if (dropped > 0) {
+			log_output(_PX4_LOG_LEVEL_WARN, hrt_absolute_time(), MODULE_NAME, "%u messages dropped", (unsigned)dropped);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Format a message into the queue, the console output and orb publication is done by the output thread.
+ */
+static void log_enqueue(int level, const char *module_name, const char *fmt, va_list argptr)
+{
+	uint32_t pos = log_queue_head.load();
+	log_queue_entry_s *entry;
+
+	while (true) {
+		entry = &log_queue[pos % LOG_QUEUE_LENGTH];
+		const int32_t diff = (int32_t)(entry->sequence.load() - pos);
+
+		if (diff == 0) {
+			// claim the entry, on failure pos is updated to the current head
+			if (log_queue_head.compare_exchange(&pos, pos + 1)) {
+				break;
+			}
+
+		} else if (diff < 0) {
+			// full, don't block the caller
+			log_queue_dropped.fetch_add(1);
+			return;
+
+		} else {
+			pos = log_queue_head.load();
+		}
+	}
+
+	entry->timestamp = hrt_absolute_time();
+	entry->module_name = module_name;
+	entry->level = level;
+	vsnprintf(entry->text, sizeof(entry->text), fmt, argptr);
+
+	entry->sequence.store(pos + 1);
+	px4_sem_post(&log_output_sem);
+}
+
+void px4_log_set_async(bool async)
+{
+	log_async_thread_set(async);
+}
+
+#else
+
+void px4_log_set_async(bool)
+{
+}
+
+#endif // PX4_LOG_ASYNC
 
 void px4_log_initialize(void)
 {
@@ -73,72 +287,57 @@ void px4_log_initialize(void)
 	if (!orb_log_message_pub) {
 		PX4_ERR("failed to advertise log_message");
 	}
-}
 
+#if defined(PX4_LOG_ASYNC)
 
-__EXPORT void px4_log_modulename(int level, const char *moduleName, const char *fmt, ...)
-{
-	FILE *out = stdout;
-	bool use_color = true;
+	for (unsigned i = 0; i < LOG_QUEUE_LENGTH; i++) {
+		log_queue[i].sequence.store(i);
+	}
 
-#ifdef __PX4_POSIX
-	out = get_stdout(&use_color);
-#endif
+	px4_sem_init(&log_output_sem, 0, 0);
+	px4_sem_setprotocol(&log_output_sem, SEM_PRIO_NONE);
 
-#ifndef PX4_LOG_COLORIZED_OUTPUT
-	use_color = false;
-#endif
+	if (px4_task_spawn_cmd("log_output", SCHED_DEFAULT, SCHED_PRIORITY_LOG_OUTPUT, PX4_STACK_ADJUSTED(1400),
+			       log_output_thread, nullptr) >= 0) {
+		log_output_running.store(true);
 
-	if (level >= _PX4_LOG_LEVEL_INFO) {
-		if (use_color) { fputs(__px4_log_level_color[level], out); }
+	} else {
+		PX4_ERR("log output thread start failed");
+	}
+
+#endif // PX4_LOG_ASYNC
+}
 
-		fprintf(out, __px4__log_level_fmt __px4__log_level_arg(level));
 
-		if (use_color) { fputs(PX4_ANSI_COLOR_GRAY, out); }
+__EXPORT void px4_log_modulename(int level, const char *moduleName, const char *fmt, ...)
+{
+	va_list argptr;
 
-		fprintf(out, __px4__log_modulename_pfmt, moduleName);
+#if defined(PX4_LOG_ASYNC)
 
-		if (use_color) { fputs(__px4_log_level_color[level], out); }
+	// errors and panics are printed immediately, the system might not survive them
+	if ((level == _PX4_LOG_LEVEL_INFO || level == _PX4_LOG_LEVEL_WARN)
+	    && orb_log_message_pub && log_output_running.load() && log_async_thread()) {
 
-		va_list argptr;
 		va_start(argptr, fmt);
-		vfprintf(out, fmt, argptr);
+		log_enqueue(level, moduleName, fmt, argptr);
 		va_end(argptr);
+		return;
+	}
 
-		if (use_color) { fputs(PX4_ANSI_COLOR_RESET, out); }
+#endif // PX4_LOG_ASYNC
 
-		fputc('\n', out);
+	if (level >= _PX4_LOG_LEVEL_INFO) {
+		va_start(argptr, fmt);
+		log_console(level, moduleName, fmt, argptr);
+		va_end(argptr);
 	}
 
 	/* publish an orb log message */
 	if (level >= _PX4_LOG_LEVEL_INFO && orb_log_message_pub) { //publish all messages
-
-		struct log_message_s log_message;
-		const unsigned max_length_pub = sizeof(log_message.text);
-		log_message.timestamp = hrt_absolute_time();
-
-		const uint8_t log_level_table[] = {
-			7, /* _PX4_LOG_LEVEL_DEBUG */
-			6, /* _PX4_LOG_LEVEL_INFO */
-			4, /* _PX4_LOG_LEVEL_WARN */
-			3, /* _PX4_LOG_LEVEL_ERROR */
-			0  /* _PX4_LOG_LEVEL_PANIC */
-		};
-		log_message.severity = log_level_table[level];
-
-		unsigned pos = 0;
-
-		va_list argptr;
-
-		pos += snprintf((char *)log_message.text + pos, max_length_pub - pos, __px4__log_modulename_pfmt, moduleName);
 		va_start(argptr, fmt);
-		pos += vsnprintf((char *)log_message.text + pos, max_length_pub - pos, fmt, argptr);
+		log_publish(level, hrt_absolute_time(), moduleName, fmt, argptr);
 		va_end(argptr);
-		log_message.text[max_length_pub - 1] = 0; //ensure 0-termination
-
-#if !defined(PARAM_NO_ORB)
-		orb_publish(ORB_ID(log_message), orb_log_message_pub, &log_message);
-#endif /* !PARAM_NO_ORB */
 	}
 }
 
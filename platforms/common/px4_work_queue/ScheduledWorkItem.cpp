@@ -73,8 +73,9 @@ void
 ScheduledWorkItem::print_run_status() const
 {
 	if (_call.period > 0) {
-		PX4_INFO_RAW("%-24s %8.1f Hz %12.1f us (%" PRId64 " us)\n", _item_name, (double)average_rate(),
-			     (double)average_interval(), _call.period);
+		PX4_INFO_RAW("%-24s %8.1f Hz %12.1f us", _item_name, (double)average_rate(), (double)average_interval());
+		print_run_time_status();
+		PX4_INFO_RAW(" (%" PRId64 " us)\n", _call.period);
 
 	} else {
 		WorkItem::print_run_status();
@@ -39,6 +39,8 @@
 #include <px4_platform_common/log.h>
 #include <drivers/drv_hrt.h>
 
+#include <inttypes.h>
+
 namespace px4
 {
 
@@ -120,10 +122,47 @@ WorkItem::average_interval() const
 	return 0.0f;
 }
 
+void
+WorkItem::RunPostamble(hrt_abstime run_time)
+{
+	const uint32_t dt = (run_time > UINT32_MAX) ? UINT32_MAX : (uint32_t)run_time;
+
+	if (dt < _run_time_min) {
+		_run_time_min = dt;
+	}
+
+	if (dt > _run_time_max) {
+		_run_time_max = dt;
+	}
+
+	_run_time_total += dt;
+}
+
+float
+WorkItem::run_time_mean() const
+{
+	if (_run_count > 0) {
+		return (float)_run_time_total / _run_count;
+	}
+
+	return 0.0f;
+}
+
+void
+WorkItem::print_run_time_status() const
+{
+	const uint32_t run_time_min = (_run_count > 0) ? _run_time_min : 0;
+
+	PX4_INFO_RAW(" %8" PRIu32 " %8.1f %8" PRIu32 " us %6" PRIu32, run_time_min, (double)run_time_mean(), _run_time_max,
+		     _deadline_misses);
+}
+
 void
 WorkItem::print_run_status() const
 {
-	PX4_INFO_RAW("%-24s %8.1f Hz %12.1f us\n", _item_name, (double)average_rate(), (double)average_interval());
+	PX4_INFO_RAW("%-24s %8.1f Hz %12.1f us", _item_name, (double)average_rate(), (double)average_interval());
+	print_run_time_status();
+	PX4_INFO_RAW("\n");
 }
 
 } // namespace px4
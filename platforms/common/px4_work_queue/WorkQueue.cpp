@@ -34,15 +34,37 @@
 #include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
 #include <px4_platform_common/px4_work_queue/WorkItem.hpp>
 
+#include <inttypes.h>
 #include <string.h>
 
 #include <px4_platform_common/tasks.h>
 #include <px4_platform_common/time.h>
 #include <drivers/drv_hrt.h>
+#include <lib/trace/trace.h>
+#include <systemlib/cpuload.h>
 
 namespace px4
 {
 
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+// pool worker of the calling thread (used to keep rescheduled work local)
+static thread_local WorkQueue *pool_worker_wq{nullptr};
+static thread_local uint8_t pool_worker_index{0};
+#endif /* __PX4_POSIX && !__PX4_QURT */
+
+// time source of the Run() accounting, the thread CPU time with the lockstep scheduler (where the simulated time
+// does not advance during Run()), so the utilization is the CPU time per simulated time
+static inline hrt_abstime run_time_now()
+{
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	struct timespec ts;
+	system_clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (hrt_abstime)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+	return hrt_absolute_time();
+#endif
+}
+
 WorkQueue::WorkQueue(const wq_config_t &config) :
 	_config(config)
 {
@@ -53,12 +75,27 @@ WorkQueue::WorkQueue(const wq_config_t &config) :
 	pthread_setname_np(pthread_self(), _config.name);
 #endif
 
+	cpuload_register_thread(_config.name);
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+	if (_config.threads > MAX_THREADS) {
+		_threads = MAX_THREADS;
+
+	} else if (_config.threads > 1) {
+		_threads = _config.threads;
+	}
+
+#endif /* __PX4_POSIX && !__PX4_QURT */
+
 #ifndef __PX4_NUTTX
 	px4_sem_init(&_qlock, 0, 1);
 #endif /* __PX4_NUTTX */
 
 	px4_sem_init(&_process_lock, 0, 0);
 	px4_sem_setprotocol(&_process_lock, SEM_PRIO_NONE);
+
+	_start_time = hrt_absolute_time();
 }
 
 WorkQueue::~WorkQueue()
@@ -94,12 +131,22 @@ WorkQueue::Detach(WorkItem *item)
 
 	_work_items.remove(item);
 
+	for (uint8_t i = 0; i < _threads; i++) {
+		if (_current_item[i] == item) {
+			_current_item[i] = nullptr;
+		}
+	}
+
 	if (_work_items.size() == 0) {
 		// shutdown, no active WorkItems
 		PX4_DEBUG("stopping: %s, last active WorkItem closing", _config.name);
 
 		request_stop();
-		signal_worker_thread();
+
+		// wake every worker so they all see the exit request
+		for (uint8_t i = 0; i < _threads; i++) {
+			px4_sem_post(&_process_lock);
+		}
 	}
 
 	work_unlock();
@@ -108,11 +155,131 @@ WorkQueue::Detach(WorkItem *item)
 void
 WorkQueue::Add(WorkItem *item)
 {
-	work_lock();
-	_q.push(item);
-	work_unlock();
+	if (_threads > 1) {
+		work_lock();
+		queue_pool_item(item);
+		work_unlock();
+
+		signal_worker_thread();
+		return;
+	}
+
+	// the current item is only compared for statistics, no lock needed
+	if (item == _current_item[0]) {
+		// scheduled again before the previous run finished
+		item->_deadline_misses++;
+	}
+
+	bool queued = false;
+
+	if (!item->_queued.compare_exchange(&queued, true)) {
+		// already queued
+		return;
+	}
+
+	// lock-free push (any thread or ISR), the worker thread is the only consumer
+	WorkItem *head = _pending.load();
+
+	do {
+		item->_pending_next = head;
+	} while (!_pending.compare_exchange(&head, item));
+
+	// only the first add after the worker woke up needs to signal
+	bool wakeup_pending = false;
+
+	if (_wakeup_pending.compare_exchange(&wakeup_pending, true)) {
+		px4_sem_post(&_process_lock);
+	}
+}
+
+void
+WorkQueue::drain_pending()
+{
+	WorkItem *head = _pending.exchange(nullptr);
 
-	signal_worker_thread();
+	// the pending stack is LIFO, reverse to maintain scheduling order
+	WorkItem *reversed = nullptr;
+
+	while (head != nullptr) {
+		WorkItem *next = head->_pending_next;
+		head->_pending_next = reversed;
+		reversed = head;
+		head = next;
+	}
+
+	while (reversed != nullptr) {
+		WorkItem *next = reversed->_pending_next;
+		reversed->_pending_next = nullptr;
+		_q[0].push(reversed);
+		reversed = next;
+	}
+}
+
+void
+WorkQueue::queue_pool_item(WorkItem *item)
+{
+	for (uint8_t i = 0; i < _threads; i++) {
+		if (_current_item[i] == item) {
+			// currently running on another worker, the worker requeues it once finished
+			//  (a WorkItem never runs concurrently with itself)
+			item->_deadline_misses++;
+			item->_pool_rerun = true;
+			return;
+		}
+	}
+
+	if (item->_pool_queued) {
+		return;
+	}
+
+	uint8_t worker = 0;
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+	if (pool_worker_wq == this) {
+		// scheduled from one of our own workers, keep it local
+		worker = pool_worker_index;
+
+	} else {
+		worker = _next_worker;
+		_next_worker = (_next_worker + 1) % _threads;
+	}
+
+#endif /* __PX4_POSIX && !__PX4_QURT */
+
+	item->_pool_queued = true;
+	_q[worker].push(item);
+}
+
+WorkItem *
+WorkQueue::pop_item(uint8_t worker)
+{
+	if (_threads == 1) {
+		if (_q[0].empty()) {
+			drain_pending();
+		}
+
+		if (!_q[0].empty()) {
+			WorkItem *item = _q[0].pop();
+			item->_queued.store(false); // adds from now on requeue the item
+			return item;
+		}
+
+		return nullptr;
+	}
+
+	// own deque first, then steal from the other workers
+	for (uint8_t i = 0; i < _threads; i++) {
+		IntrusiveQueue<WorkItem *> &q = _q[(worker + i) % _threads];
+
+		if (!q.empty()) {
+			WorkItem *item = q.pop();
+			item->_pool_queued = false;
+			return item;
+		}
+	}
+
+	return nullptr;
 }
 
 void
@@ -120,7 +287,7 @@ WorkQueue::signal_worker_thread()
 {
 	int sem_val;
 
-	if (px4_sem_getvalue(&_process_lock, &sem_val) == 0 && sem_val <= 0) {
+	if (px4_sem_getvalue(&_process_lock, &sem_val) == 0 && sem_val < _threads) {
 		px4_sem_post(&_process_lock);
 	}
 }
@@ -129,7 +296,17 @@ void
 WorkQueue::Remove(WorkItem *item)
 {
 	work_lock();
-	_q.remove(item);
+
+	drain_pending();
+
+	for (uint8_t i = 0; i < _threads; i++) {
+		_q[i].remove(item);
+	}
+
+	item->_queued.store(false);
+	item->_pool_queued = false;
+	item->_pool_rerun = false;
+
 	work_unlock();
 }
 
@@ -138,42 +315,197 @@ WorkQueue::Clear()
 {
 	work_lock();
 
-	while (!_q.empty()) {
-		_q.pop();
+	drain_pending();
+
+	for (uint8_t i = 0; i < _threads; i++) {
+		while (!_q[i].empty()) {
+			WorkItem *item = _q[i].pop();
+			item->_queued.store(false);
+			item->_pool_queued = false;
+		}
 	}
 
 	work_unlock();
 }
 
 void
-WorkQueue::Run()
+WorkQueue::Run(uint8_t worker)
 {
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+	pool_worker_wq = this;
+	pool_worker_index = worker;
+#endif /* __PX4_POSIX && !__PX4_QURT */
+
+#if !defined(__PX4_QURT)
+	// don't let a burst of messages from one item delay the others
+	px4_log_set_async(true);
+#endif /* !__PX4_QURT */
+
+#if defined(__PX4_LINUX)
+	work_lock();
+	_thread_ids[worker] = pthread_self();
+	_thread_running[worker] = true;
+	apply_affinity(worker);
+	work_unlock();
+#endif /* __PX4_LINUX */
+
 	while (!should_exit()) {
+		trace_record(TRACE_SEM_WAIT_START, _config.name);
 		px4_sem_wait(&_process_lock);
+		trace_record(TRACE_SEM_WAIT_END, _config.name);
+
+		// any add from now on signals again
+		_wakeup_pending.store(false);
 
 		work_lock();
 
 		// process queued work
-		while (!_q.empty()) {
-			WorkItem *work = _q.pop();
+		WorkItem *work = pop_item(worker);
+
+		while (work != nullptr) {
+			_current_item[worker] = work;
 
 			work_unlock(); // unlock work queue to run (item may requeue itself)
+			const hrt_abstime run_start = run_time_now();
+			const char *item_name = work->_item_name; // the item might be freed within Run()
+			trace_record(TRACE_WORKITEM_START, item_name);
+			px4::set_namespace(work->_namespace);
 			work->RunPreamble();
 			work->Run();
+			const hrt_abstime run_time = run_time_now() - run_start;
+			trace_record(TRACE_WORKITEM_END, item_name);
 			work_lock(); // re-lock
+
+			// the item might have detached itself (and been freed) from within Run()
+			if (_current_item[worker] == work) {
+				work->RunPostamble(run_time);
+				_current_item[worker] = nullptr;
+
+				if (work->_pool_rerun) {
+					work->_pool_rerun = false;
+					work->_pool_queued = true;
+					_q[worker].push(work);
+				}
+			}
+
+			_busy_time += run_time;
+
+			work = pop_item(worker);
 		}
 
 		work_unlock();
 	}
 
-	PX4_DEBUG("%s: exiting", _config.name);
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+	pool_worker_wq = nullptr;
+#endif /* __PX4_POSIX && !__PX4_QURT */
+
+#if !defined(__PX4_QURT)
+	px4_log_set_async(false);
+#endif /* !__PX4_QURT */
+
+#if defined(__PX4_LINUX)
+	work_lock();
+	_thread_running[worker] = false;
+	work_unlock();
+#endif /* __PX4_LINUX */
+
+	PX4_DEBUG("%s: exiting worker %d", _config.name, worker);
+}
+
+void
+WorkQueue::set_affinity(uint32_t affinity)
+{
+	work_lock();
+	_affinity = affinity;
+
+	for (uint8_t i = 0; i < _threads; i++) {
+		apply_affinity(i);
+	}
+
+	work_unlock();
+}
+
+void
+WorkQueue::apply_affinity(uint8_t worker)
+{
+#if defined(__PX4_LINUX)
+
+	if (!_thread_running[worker]) {
+		return;
+	}
+
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+
+	for (unsigned cpu = 0; cpu < 32; cpu++) {
+		if ((_affinity == 0) || (_affinity & (1u << cpu))) {
+			CPU_SET(cpu, &cpuset);
+		}
+	}
+
+	int ret = pthread_setaffinity_np(_thread_ids[worker], sizeof(cpuset), &cpuset);
+
+	if (ret != 0) {
+		PX4_ERR("%s: setting affinity 0x%" PRIx32 " failed (%i)", _config.name, _affinity, ret);
+	}
+
+#else
+	(void)worker;
+#endif /* __PX4_LINUX */
+}
+
+float
+WorkQueue::utilization() const
+{
+	const hrt_abstime elapsed = hrt_elapsed_time(&_start_time);
+
+	if (elapsed > 0) {
+		return (float)_busy_time / (elapsed * _threads);
+	}
+
+	return 0.0f;
+}
+
+void
+WorkQueue::get_status(wq_status_t &status)
+{
+	status.name = get_name();
+	status.num_items = 0;
+	status.run_count = 0;
+	status.deadline_misses = 0;
+	status.run_time_max = 0;
+	status.utilization = utilization();
+	status.affinity = _affinity;
+
+	LockGuard lg{_work_items.mutex()};
+
+	for (WorkItem *item : _work_items) {
+		status.num_items++;
+		status.run_count += item->_run_count;
+		status.deadline_misses += item->deadline_misses();
+
+		if (item->run_time_max() > status.run_time_max) {
+			status.run_time_max = item->run_time_max();
+		}
+	}
 }
 
 void
 WorkQueue::print_status(bool last)
 {
 	const size_t num_items = _work_items.size();
-	PX4_INFO_RAW("%-16s\n", get_name());
+	PX4_INFO_RAW("%-16s %5.1f%%", get_name(), (double)(utilization() * 100.f));
+
+	if (_threads > 1) {
+		PX4_INFO_RAW(" (%d threads)", _threads);
+	}
+
+	if (_affinity != 0) {
+		PX4_INFO_RAW(" cpus: 0x%" PRIx32, _affinity);
+	}
+
+	PX4_INFO_RAW("\n");
 	size_t i = 0;
 
 	for (WorkItem *item : _work_items) {
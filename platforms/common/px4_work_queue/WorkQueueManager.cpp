@@ -44,10 +44,15 @@
 #include <containers/BlockingQueue.hpp>
 #include <lib/drivers/device/Device.hpp>
 #include <lib/mathlib/mathlib.h>
+#include <systemlib/cpuload.h>
 
 #include <limits.h>
 #include <string.h>
 
+#if defined(__PX4_NUTTX)
+#include <px4_platform/board_fast_alloc.h>
+#endif
+
 using namespace time_literals;
 
 namespace px4
@@ -61,6 +66,16 @@ static BlockingQueue<const wq_config_t *, 1> *_wq_manager_create_queue{nullptr};
 
 static px4::atomic_bool _wq_manager_should_exit{true};
 
+// runtime CPU affinity overrides (work_queue affinity), applied on work queue creation
+struct WorkQueueAffinityOverride {
+	const char *name;
+	uint32_t affinity;
+};
+
+static constexpr int MAX_AFFINITY_OVERRIDES = 16;
+static WorkQueueAffinityOverride _wq_affinity_overrides[MAX_AFFINITY_OVERRIDES] {};
+static pthread_mutex_t _wq_affinity_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 
 static WorkQueue *
 FindWorkQueueByName(const char *name)
@@ -118,6 +133,67 @@ WorkQueueFindOrCreate(const wq_config_t &new_wq)
 	return wq;
 }
 
+static uint32_t
+WorkQueueAffinity(const wq_config_t &config)
+{
+	LockGuard lg{_wq_affinity_mutex};
+
+	for (const WorkQueueAffinityOverride &entry : _wq_affinity_overrides) {
+		if ((entry.name != nullptr) && (strcmp(entry.name, config.name) == 0)) {
+			return entry.affinity;
+		}
+	}
+
+	return config.affinity;
+}
+
+int
+WorkQueueSetAffinity(const char *name, uint32_t affinity)
+{
+#if defined(__PX4_LINUX)
+	{
+		LockGuard lg{_wq_affinity_mutex};
+		WorkQueueAffinityOverride *override_entry = nullptr;
+
+		for (WorkQueueAffinityOverride &entry : _wq_affinity_overrides) {
+			if ((entry.name != nullptr) && (strcmp(entry.name, name) == 0)) {
+				override_entry = &entry;
+				break;
+
+			} else if ((entry.name == nullptr) && (override_entry == nullptr)) {
+				override_entry = &entry;
+			}
+		}
+
+		if (override_entry == nullptr) {
+			PX4_ERR("too many affinity overrides");
+			return PX4_ERROR;
+		}
+
+		if (override_entry->name == nullptr) {
+			override_entry->name = strdup(name);
+		}
+
+		override_entry->affinity = affinity;
+	}
+
+	if (_wq_manager_wqs_list != nullptr) {
+		LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+		for (WorkQueue *wq : *_wq_manager_wqs_list) {
+			if (strcmp(wq->get_name(), name) == 0) {
+				wq->set_affinity(affinity);
+			}
+		}
+	}
+
+	return PX4_OK;
+#else
+	PX4_ERR("CPU affinity not supported");
+	return PX4_ERROR;
+#endif /* __PX4_LINUX */
+}
+
 const wq_config_t &
 device_bus_to_wq(uint32_t device_id_int)
 {
@@ -201,17 +277,161 @@ serial_port_to_wq(const char *serial)
 	return wq_configurations::hp_default;
 }
 
+static int
+WorkQueueThreadCreate(const wq_config_t *wq, void *(*start_routine)(void *), void *arg, pthread_t *thread)
+{
+	pthread_attr_t attr;
+	int ret_attr_init = pthread_attr_init(&attr);
+
+	if (ret_attr_init != 0) {
+		PX4_ERR("attr init for %s failed (%i)", wq->name, ret_attr_init);
+	}
+
+	sched_param param;
+	int ret_getschedparam = pthread_attr_getschedparam(&attr, &param);
+
+	if (ret_getschedparam != 0) {
+		PX4_ERR("getting sched param for %s failed (%i)", wq->name, ret_getschedparam);
+	}
+
+	// stack size
+#if defined(__PX4_QURT)
+	const size_t stacksize = math::max(8 * 1024, PX4_STACK_ADJUSTED(wq->stacksize));
+#elif defined(__PX4_NUTTX)
+	const size_t stacksize = math::max((uint16_t)PTHREAD_STACK_MIN, wq->stacksize);
+#elif defined(__PX4_POSIX)
+	// On posix system , the desired stacksize round to the nearest multiplier of the system pagesize
+	// It is a requirement of the  pthread_attr_setstacksize* function
+	const unsigned int page_size = sysconf(_SC_PAGESIZE);
+	const size_t stacksize_adj = math::max(PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(wq->stacksize));
+	const size_t stacksize = (stacksize_adj + page_size - (stacksize_adj % page_size));
+#endif
+	int ret_setstacksize = pthread_attr_setstacksize(&attr, stacksize);
+
+	if (ret_setstacksize != 0) {
+		PX4_ERR("setting stack size for %s failed (%i)", wq->name, ret_setstacksize);
+	}
+
+#if defined(__PX4_NUTTX)
+
+	// stack in tightly coupled memory, not shared with DMA on the bus matrix (falls back to the heap).
+	// Work queues only exit at shutdown, the stack is never freed.
+	if (wq->fast_stack) {
+		void *stack = board_fast_alloc(stacksize);
+
+		if (stack != nullptr) {
+			int ret_setstack = pthread_attr_setstack(&attr, stack, stacksize);
+
+			if (ret_setstack != 0) {
+				PX4_ERR("setting fast stack for %s failed (%i)", wq->name, ret_setstack);
+				board_fast_free(stack, stacksize);
+			}
+		}
+	}
+
+#endif // __PX4_NUTTX
+
+#ifndef __PX4_QURT
+
+	// schedule policy FIFO
+	int ret_setschedpolicy = pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+
+	if (ret_setschedpolicy != 0) {
+		PX4_ERR("failed to set sched policy SCHED_FIFO (%i)", ret_setschedpolicy);
+	}
+
+#endif // ! QuRT
+
+	// priority
+	param.sched_priority = sched_get_priority_max(SCHED_FIFO) + wq->relative_priority;
+	int ret_setschedparam = pthread_attr_setschedparam(&attr, &param);
+
+	if (ret_setschedparam != 0) {
+		PX4_ERR("setting sched params for %s failed (%i)", wq->name, ret_setschedparam);
+	}
+
+	// create thread
+	int ret_create = pthread_create(thread, &attr, start_routine, arg);
+
+	if (ret_create == 0) {
+		PX4_DEBUG("starting: %s, priority: %d, stack: %zu bytes", wq->name, param.sched_priority, stacksize);
+
+	} else {
+		PX4_ERR("failed to create thread for %s (%i): %s", wq->name, ret_create, strerror(ret_create));
+	}
+
+	// destroy thread attributes
+	int ret_destroy = pthread_attr_destroy(&attr);
+
+	if (ret_destroy != 0) {
+		PX4_ERR("failed to destroy thread attributes for %s (%i)", wq->name, ret_create);
+	}
+
+	return ret_create;
+}
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+struct WorkQueuePoolWorker {
+	WorkQueue *wq;
+	uint8_t index;
+};
+
+static void *
+WorkQueuePoolWorkerRunner(void *context)
+{
+	WorkQueuePoolWorker *worker = static_cast<WorkQueuePoolWorker *>(context);
+
+#ifdef __PX4_DARWIN
+	pthread_setname_np(worker->wq->get_name());
+#else
+	pthread_setname_np(pthread_self(), worker->wq->get_name());
+#endif
+
+	cpuload_register_thread(worker->wq->get_name());
+
+	worker->wq->Run(worker->index);
+
+	return nullptr;
+}
+#endif /* __PX4_POSIX && !__PX4_QURT */
+
 static void *
 WorkQueueRunner(void *context)
 {
 	wq_config_t *config = static_cast<wq_config_t *>(context);
 	WorkQueue wq(*config);
 
+	wq.set_affinity(WorkQueueAffinity(*config));
+
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+	// pool work queue: this thread is worker 0, start the remaining workers
+	WorkQueuePoolWorker workers[WorkQueue::MAX_THREADS] {};
+	pthread_t worker_threads[WorkQueue::MAX_THREADS] {};
+	bool worker_started[WorkQueue::MAX_THREADS] {};
+
+	for (uint8_t i = 1; i < wq.threads(); i++) {
+		workers[i].wq = &wq;
+		workers[i].index = i;
+		worker_started[i] = (WorkQueueThreadCreate(config, WorkQueuePoolWorkerRunner, &workers[i], &worker_threads[i]) == 0);
+	}
+
+#endif /* __PX4_POSIX && !__PX4_QURT */
+
 	// add to work queue list
 	_wq_manager_wqs_list->add(&wq);
 
 	wq.Run();
 
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+
+	for (uint8_t i = 1; i < wq.threads(); i++) {
+		if (worker_started[i]) {
+			pthread_join(worker_threads[i], nullptr);
+		}
+	}
+
+#endif /* __PX4_POSIX && !__PX4_QURT */
+
 	// remove from work queue list
 	_wq_manager_wqs_list->remove(&wq);
 
@@ -230,75 +450,8 @@ WorkQueueManagerRun(int, char **)
 
 		if (wq != nullptr) {
 			// create new work queue
-
-			pthread_attr_t attr;
-			int ret_attr_init = pthread_attr_init(&attr);
-
-			if (ret_attr_init != 0) {
-				PX4_ERR("attr init for %s failed (%i)", wq->name, ret_attr_init);
-			}
-
-			sched_param param;
-			int ret_getschedparam = pthread_attr_getschedparam(&attr, &param);
-
-			if (ret_getschedparam != 0) {
-				PX4_ERR("getting sched param for %s failed (%i)", wq->name, ret_getschedparam);
-			}
-
-			// stack size
-#if defined(__PX4_QURT)
-			const size_t stacksize = math::max(8 * 1024, PX4_STACK_ADJUSTED(wq->stacksize));
-#elif defined(__PX4_NUTTX)
-			const size_t stacksize = math::max((uint16_t)PTHREAD_STACK_MIN, wq->stacksize);
-#elif defined(__PX4_POSIX)
-			// On posix system , the desired stacksize round to the nearest multiplier of the system pagesize
-			// It is a requirement of the  pthread_attr_setstacksize* function
-			const unsigned int page_size = sysconf(_SC_PAGESIZE);
-			const size_t stacksize_adj = math::max(PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(wq->stacksize));
-			const size_t stacksize = (stacksize_adj + page_size - (stacksize_adj % page_size));
-#endif
-			int ret_setstacksize = pthread_attr_setstacksize(&attr, stacksize);
-
-			if (ret_setstacksize != 0) {
-				PX4_ERR("setting stack size for %s failed (%i)", wq->name, ret_setstacksize);
-			}
-
-#ifndef __PX4_QURT
-
-			// schedule policy FIFO
-			int ret_setschedpolicy = pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
-
-			if (ret_setschedpolicy != 0) {
-				PX4_ERR("failed to set sched policy SCHED_FIFO (%i)", ret_setschedpolicy);
-			}
-
-#endif // ! QuRT
-
-			// priority
-			param.sched_priority = sched_get_priority_max(SCHED_FIFO) + wq->relative_priority;
-			int ret_setschedparam = pthread_attr_setschedparam(&attr, &param);
-
-			if (ret_setschedparam != 0) {
-				PX4_ERR("setting sched params for %s failed (%i)", wq->name, ret_setschedparam);
-			}
-
-			// create thread
 			pthread_t thread;
-			int ret_create = pthread_create(&thread, &attr, WorkQueueRunner, (void *)wq);
-
-			if (ret_create == 0) {
-				PX4_DEBUG("starting: %s, priority: %d, stack: %zu bytes", wq->name, param.sched_priority, stacksize);
-
-			} else {
-				PX4_ERR("failed to create thread for %s (%i): %s", wq->name, ret_create, strerror(ret_create));
-			}
-
-			// destroy thread attributes
-			int ret_destroy = pthread_attr_destroy(&attr);
-
-			if (ret_destroy != 0) {
-				PX4_ERR("failed to destroy thread attributes for %s (%i)", wq->name, ret_create);
-			}
+			WorkQueueThreadCreate(wq, WorkQueueRunner, (void *)wq, &thread);
 		}
 	}
 
@@ -390,7 +543,7 @@ WorkQueueManagerStatus()
 	if (!_wq_manager_should_exit.load() && (_wq_manager_wqs_list != nullptr)) {
 
 		const size_t num_wqs = _wq_manager_wqs_list->size();
-		PX4_INFO_RAW("\nWork Queue: %-1zu threads                      RATE        INTERVAL\n", num_wqs);
+		PX4_INFO_RAW("\nWork Queue: %-1zu threads                      RATE        INTERVAL      RUN MIN/MEAN/MAX     MISSED\n", num_wqs);
 
 		LockGuard lg{_wq_manager_wqs_list->mutex()};
 		size_t i = 0;
@@ -417,4 +570,26 @@ WorkQueueManagerStatus()
 	return PX4_OK;
 }
 
+int
+WorkQueueManagerGetStatus(wq_status_t *status, int max_count)
+{
+	if (_wq_manager_should_exit.load() || (_wq_manager_wqs_list == nullptr)) {
+		return 0;
+	}
+
+	LockGuard lg{_wq_manager_wqs_list->mutex()};
+	int count = 0;
+
+	for (WorkQueue *wq : *_wq_manager_wqs_list) {
+		if (count >= max_count) {
+			break;
+		}
+
+		wq->get_status(status[count]);
+		count++;
+	}
+
+	return count;
+}
+
 } // namespace px4
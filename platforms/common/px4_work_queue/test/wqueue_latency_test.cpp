@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "wqueue_latency_test.h"
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+#include <inttypes.h>
+
+using namespace px4;
+
+AppState WQueueLatencyTest::appState;
+
+void WQueueLatencyTest::Run()
+{
+	const hrt_abstime latency = hrt_elapsed_time(&_schedule_time);
+
+	if (latency < _latency_min) {
+		_latency_min = latency;
+	}
+
+	if (latency > _latency_max) {
+		_latency_max = latency;
+	}
+
+	_latency_total += latency;
+
+	_done.store(true);
+}
+
+int WQueueLatencyTest::main()
+{
+	appState.setRunning(true);
+
+	int iterations = 0;
+
+	for (; (iterations < ITERATIONS) && !appState.exitRequested(); iterations++) {
+		_done.store(false);
+
+		// schedule from a different thread, like a uORB publisher or ISR would
+		_schedule_time = hrt_absolute_time();
+		ScheduleNow();
+
+		while (!_done.load()) {
+			px4_usleep(100);
+		}
+	}
+
+	if (iterations > 0) {
+		PX4_INFO("WQueueLatencyTest: %d iterations, latency min: %" PRIu64 " us, mean: %.1f us, max: %" PRIu64 " us",
+			 iterations, _latency_min, (double)_latency_total / iterations, _latency_max);
+	}
+
+	PX4_INFO("WQueueLatencyTest finished");
+
+	return 0;
+}
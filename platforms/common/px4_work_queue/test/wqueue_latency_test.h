@@ -1,6 +1,6 @@
 /****************************************************************************
  *
- *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions
@@ -33,43 +33,37 @@
 
 #pragma once
 
-#include "common.h"
+#include <px4_platform_common/app.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+#include <drivers/drv_hrt.h>
 
-namespace linux_pwm_out
-{
+using namespace px4;
 
 /**
- ** class OcpocMmapPWMOut
- * PWM output class for Aerotenna OcPoC via mmap
+ * Measures the scheduling latency from ScheduleNow() to the start of Run()
+ * (WorkQueue::Add() and the worker wakeup).
  */
-class OcpocMmapPWMOut : public PWMOutBase
+class WQueueLatencyTest : public px4::WorkItem
 {
 public:
-	OcpocMmapPWMOut(int max_num_outputs);
-	virtual ~OcpocMmapPWMOut();
+	WQueueLatencyTest() : px4::WorkItem("WQueueLatencyTest", px4::wq_configurations::test1) {}
+	~WQueueLatencyTest() = default;
 
-	int init() override;
+	int main();
 
-	int send_output_pwm(const uint16_t *pwm, int num_outputs) override;
+	static px4::AppState appState; /* track requests to terminate app */
 
 private:
-	static unsigned long freq2tick(uint16_t freq_hz);
 
-	static constexpr int MAX_ZYNQ_PWMS = 8;	/**< maximum number of pwm channels */
+	static constexpr int ITERATIONS = 10000;
 
-	// Period|Hi 32 bits each
-	struct s_period_hi {
-		uint32_t period;
-		uint32_t hi;
-	};
+	void Run() override;
 
-	struct pwm_cmd {
-		struct s_period_hi periodhi[MAX_ZYNQ_PWMS];
-	};
+	hrt_abstime _schedule_time{0};
+	px4::atomic_bool _done{false};
 
-	volatile struct pwm_cmd *_shared_mem_cmd = nullptr;
-	static constexpr const char *_device = "/dev/mem";
-	int _num_outputs;
+	hrt_abstime _latency_min{UINT64_MAX};
+	hrt_abstime _latency_max{0};
+	uint64_t _latency_total{0};
 };
-
-}
@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file serial_dma.cpp
+ * Implementation of the API declared in serial_dma.h.
+ */
+
+#include <px4_platform_common/serial_dma.h>
+#include <px4_platform_common/posix.h>
+#include <px4_platform_common/time.h>
+
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace px4
+{
+
+void SerialDMA::setDevice(int fd, unsigned baudrate)
+{
+	_fd = fd;
+	setBaudrate(baudrate);
+}
+
+void SerialDMA::setBaudrate(unsigned baudrate)
+{
+	_baudrate = (baudrate == 0) ? 115200 : baudrate;
+}
+
+unsigned SerialDMA::idleTimeUs() const
+{
+	// 10 bits per character (start, 8 data, stop)
+	const unsigned idle_time_us = _idle_characters * 10 * 1000000 / _baudrate;
+	return (idle_time_us > MIN_IDLE_TIME_US) ? idle_time_us : MIN_IDLE_TIME_US;
+}
+
+int SerialDMA::bytesAvailable() const
+{
+	int bytes_available = 0;
+
+	if (::ioctl(_fd, FIONREAD, (unsigned long)&bytes_available) != 0) {
+		return -1;
+	}
+
+	return bytes_available;
+}
+
+int SerialDMA::waitForFrameEnd(size_t max_bytes)
+{
+	const unsigned idle_time_us = idleTimeUs();
+	int bytes_available = bytesAvailable();
+
+	if (bytes_available < 0) {
+		// no FIONREAD support, wait a single idle time
+		px4_usleep(idle_time_us);
+		return -1;
+	}
+
+	for (unsigned waited_us = 0; (size_t)bytes_available < max_bytes && waited_us < MAX_FRAME_WAIT_US;
+	     waited_us += idle_time_us) {
+
+		px4_usleep(idle_time_us);
+
+		const int bytes_now = bytesAvailable();
+
+		if (bytes_now <= bytes_available) {
+			// nothing arrived during the idle time: end of frame
+			break;
+		}
+
+		bytes_available = bytes_now;
+	}
+
+	return bytes_available;
+}
+
+int SerialDMA::readFrame(uint8_t *buf, size_t buf_length, int timeout_ms)
+{
+	pollfd fds[1];
+	fds[0].fd = _fd;
+	fds[0].events = POLLIN;
+
+	int ret = ::poll(fds, 1, timeout_ms);
+
+	if (ret <= 0) {
+		return ret;
+	}
+
+	if (!(fds[0].revents & POLLIN)) {
+		return -1;
+	}
+
+	waitForFrameEnd(buf_length);
+
+	return ::read(_fd, buf, buf_length);
+}
+
+} // namespace px4
@@ -72,6 +72,9 @@
 // GET_CRC    verify CRC of entire flashable area
 // RESET    finalise flash programming, reset chip and starts application
 //
+// Bootloaders reporting PROTO_CAP_WINDOWED_USB don't lose replies when the host sends
+// several PROG_MULTI commands over USB before collecting their replies (windowed acks).
+//
 
 #define BL_PROTOCOL_VERSION     5   // The revision of the bootloader protocol
 //* Next revision needs to update
@@ -117,6 +120,10 @@
 #define PROTO_DEVICE_BOARD_REV  3 // board revision
 #define PROTO_DEVICE_FW_SIZE  4 // size of flashable area
 #define PROTO_DEVICE_VEC_AREA 5 // contents of reserved vectors 7-10
+#define PROTO_DEVICE_CAPS 6 // capability flags, INSYNC/INVALID on older bootloaders
+
+/* capability flags returned for PROTO_DEVICE_CAPS */
+#define PROTO_CAP_WINDOWED_USB  (1 << 0)  // replies are not lost if commands are streamed over USB
 
 #define STATE_PROTO_OK          0x10    // INSYNC/OK      - 'ok' response
 #define STATE_PROTO_FAILED        0x11    // INSYNC/FAILED  - 'fail' response
@@ -599,6 +606,7 @@ bootloader(unsigned timeout)
 		// BOARD_REV reply: <board rev:4>/INSYNC/EOC
 		// FW_SIZE reply: <firmware size:4>/INSYNC/EOC
 		// VEC_AREA reply <vectors 7-10:16>/INSYNC/EOC
+		// CAPS reply: <capability flags:4>/INSYNC/EOC
 		// bad arg reply: INSYNC/INVALID
 		//
 		case PROTO_GET_DEVICE:
@@ -639,6 +647,10 @@ bootloader(unsigned timeout)
 
 				break;
 
+			case PROTO_DEVICE_CAPS:
+				cout_word(PROTO_CAP_WINDOWED_USB);
+				break;
+
 			default:
 				goto cmd_bad;
 			}
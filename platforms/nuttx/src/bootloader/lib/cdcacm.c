@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include "cdcacm.h"
+#include <errno.h>
 #include <string.h>
 #include<stdio.h>
 #include<fcntl.h>
@@ -104,21 +105,44 @@ int usb_cin(void)
 		free(g_init);
 	}
 
-	char b;
+	/* read whatever is available at once instead of a read() per byte */
+	static uint8_t rx_buffer[64];
+	static int rx_count = 0;
+	static int rx_index = 0;
 
-	if (read(g_usb_df, &b, 1) == 1) {
-		c = b;
+	if (rx_index >= rx_count) {
+		rx_index = 0;
+		rx_count = read(g_usb_df, rx_buffer, sizeof(rx_buffer));
+
+		if (rx_count <= 0) {
+			rx_count = 0;
+			return c;
+		}
+	}
+
+	uint8_t b = rx_buffer[rx_index++];
+	c = b;
 #if defined(SERIAL_TRACE)
-		in_trace[in++] = b;
-		TRACE_WRAP(in);
+	in_trace[in++] = b;
+	TRACE_WRAP(in);
 #endif
-	}
 
 	return c;
 }
 void usb_cout(uint8_t *buf, unsigned len)
 {
-	write(g_usb_df, buf, len);
+	/* the host may stream commands and collect the replies later, don't drop them if the tx buffer is full */
+	for (unsigned sent = 0; sent < len;) {
+		ssize_t n = write(g_usb_df, &buf[sent], len - sent);
+
+		if (n > 0) {
+			sent += n;
+
+		} else if (n < 0 && errno != EAGAIN) {
+			break;
+		}
+	}
+
 #if defined(SERIAL_TRACE)
 
 	if (len > TRACE_SIZE) {
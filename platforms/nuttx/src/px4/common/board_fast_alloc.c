@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file board_fast_alloc.c
+ *
+ * Provide the board fast (tightly coupled) memory allocator interface.
+ */
+
+#include <px4_platform_common/px4_config.h>
+#include "board_config.h"
+
+#include <stdint.h>
+#include <errno.h>
+#include <nuttx/mm/gran.h>
+#include <nuttx/mm/mm.h>
+
+#if defined(BOARD_FAST_ALLOC_POOL_SIZE)
+
+#if defined(CONFIG_GRAN)
+
+static GRAN_HANDLE fast_allocator;
+
+/* the pool is placed at the start of the fast memory region by the linker script,
+ * _efast_ram marks the end of the region */
+static uint8_t g_fast_heap[BOARD_FAST_ALLOC_POOL_SIZE] __attribute__((section(".fast_ram"), aligned(64)));
+extern uint8_t _efast_ram[];
+
+static uint16_t fast_heap_inuse;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+__EXPORT int
+board_fast_alloc_init(void)
+{
+	fast_allocator = gran_initialize(g_fast_heap,
+					 sizeof(g_fast_heap),
+					 6,  /* 64B granule */
+					 3); /* 8B alignment (stacks) */
+
+	if (fast_allocator == NULL) {
+		return -ENOMEM;
+	}
+
+	fast_heap_inuse = 0;
+
+	/* give the rest of the region back to the heap */
+	uint8_t *remaining = &g_fast_heap[sizeof(g_fast_heap)];
+
+	if (_efast_ram > remaining) {
+		umm_addregion(remaining, _efast_ram - remaining);
+	}
+
+	return OK;
+}
+
+__EXPORT int
+board_get_fast_usage(uint16_t *fast_total, uint16_t *fast_used)
+{
+	*fast_total = sizeof(g_fast_heap);
+	*fast_used = fast_heap_inuse;
+
+	return OK;
+}
+
+__EXPORT void *
+board_fast_alloc(size_t size)
+{
+	if (fast_allocator == NULL) {
+		return NULL;
+	}
+
+	void *rv = gran_alloc(fast_allocator, size);
+
+	if (rv != NULL) {
+		fast_heap_inuse += size;
+	}
+
+	return rv;
+}
+
+__EXPORT void
+board_fast_free(FAR void *memory, size_t size)
+{
+	gran_free(fast_allocator, memory, size);
+	fast_heap_inuse -= size;
+}
+
+#endif /* CONFIG_GRAN */
+#endif /* BOARD_FAST_ALLOC_POOL_SIZE */
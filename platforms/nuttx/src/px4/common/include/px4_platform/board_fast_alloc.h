@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file board_fast_alloc.h
+ *
+ * Provide an allocation interface for tightly coupled data memory (CCM on STM32F4, DTCM on STM32F7/H7)
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <board_config.h>
+
+__BEGIN_DECLS
+
+/************************************************************************************
+ * Name: board_fast_alloc_init
+ *
+ * Description:
+ *   All boards may optionally provide this API to instantiate a pool of
+ *   tightly coupled data memory, used for the stacks of the high priority
+ *   work queues. The memory is accessed by the CPU without going through
+ *   the bus matrix, so it does not contend with DMA transfers.
+ *
+ *   Provision is controlled by declaring BOARD_FAST_ALLOC_POOL_SIZE in board_config.h.
+ *   The memory must be excluded from the NuttX heap (e.g. CONFIG_STM32F7_DTCMEXCLUDE)
+ *   and the board linker script must provide a .fast_ram section in it, delimited
+ *   by _sfast_ram and _efast_ram (end of the region). The part of the region not used
+ *   by the pool is given back to the heap.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on failure
+ *   EPERM - board does not support function
+ *   ENOMEM - There is not enough memory to satisfy allocation.
+ *
+ ************************************************************************************/
+#if defined(BOARD_FAST_ALLOC_POOL_SIZE)
+__EXPORT int board_fast_alloc_init(void);
+#else
+#define board_fast_alloc_init() (-EPERM)
+#endif
+
+/************************************************************************************
+ * Name: board_get_fast_usage
+ *
+ * Description:
+ *   Instrumentation of the fast memory pool.
+ *
+ * Input Parameters:
+ *   fast_total     -  A pointer to receive the size of the pool.
+ *   fast_used      -  A pointer to receive the current allocation in use.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success;
+ *
+ ************************************************************************************/
+#if defined(BOARD_FAST_ALLOC_POOL_SIZE)
+__EXPORT int board_get_fast_usage(uint16_t *fast_total, uint16_t *fast_used);
+#else
+#define board_get_fast_usage(fast_total, fast_used) (-ENOMEM)
+#endif
+
+/************************************************************************************
+ * Name: board_fast_alloc
+ *
+ * Description:
+ *   Allocate from the fast memory pool.
+ *
+ * Input Parameters:
+ *   size     -  Size of the allocation in bytes
+ *
+ * Returned Value:
+ *   A pointer to the memory, NULL if the pool is exhausted or not provided by the board
+ *   (the caller is expected to fall back to the regular heap).
+ *
+ ************************************************************************************/
+#if defined(BOARD_FAST_ALLOC_POOL_SIZE)
+__EXPORT void *board_fast_alloc(size_t size);
+#else
+#define board_fast_alloc(size) (NULL)
+#endif
+
+/************************************************************************************
+ * Name: board_fast_free
+ *
+ * Description:
+ *   Free memory allocated with board_fast_alloc.
+ *
+ * Input Parameters:
+ *   memory    -  A pointer to previously allocated fast memory
+ *   size      -  Size of the previously allocated fast memory
+ *
+ ************************************************************************************/
+#if defined(BOARD_FAST_ALLOC_POOL_SIZE)
+__EXPORT void board_fast_free(FAR void *memory, size_t size);
+#else
+#define board_fast_free(memory, size)
+#endif
+
+__END_DECLS
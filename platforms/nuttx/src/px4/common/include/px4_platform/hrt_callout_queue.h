@@ -0,0 +1,254 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file hrt_callout_queue.h
+ *
+ * Callout queue of the NuttX high-resolution timer drivers.
+ *
+ * The pending calls are kept in a binary min-heap ordered by deadline, so entering,
+ * cancelling and popping a call is O(log n) instead of the O(n) ordered list insertion
+ * done for every periodic rearm before. Each call stores its heap position so it can be
+ * removed without searching. If more than HRT_CALLOUT_HEAP_SIZE calls are pending at the
+ * same time the remaining ones are kept in a sorted list, which is moved into the heap as
+ * soon as there is space again. Calls with equal deadlines are run in the order they were
+ * entered, like with the ordered list.
+ *
+ * All functions must be called with interrupts disabled.
+ */
+
+#pragma once
+
+#include <queue.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <board_config.h>
+#include <drivers/drv_hrt.h>
+
+/* maximum number of calls in the heap, boards can override this in board_config.h */
+#ifndef HRT_CALLOUT_HEAP_SIZE
+# define HRT_CALLOUT_HEAP_SIZE 64
+#endif
+
+static struct hrt_call	*hrt_callout_heap[HRT_CALLOUT_HEAP_SIZE];
+static uint16_t		hrt_callout_heap_count;
+
+/* calls that did not fit into the heap, sorted by deadline */
+static struct sq_queue_s	hrt_callout_overflow;
+
+/* insertion counter, breaks ties between equal deadlines */
+static uint32_t		hrt_callout_sequence;
+
+/* statistics: heap high-water mark and number of calls that went to the overflow list */
+static uint16_t		hrt_callout_heap_count_max;
+static uint32_t		hrt_callout_overflow_count;
+
+/**
+ * Return true if call a has to run before call b (earlier deadline, or entered first).
+ */
+static inline bool
+hrt_callout_before(const struct hrt_call *a, const struct hrt_call *b)
+{
+	if (a->deadline != b->deadline) {
+		return a->deadline < b->deadline;
+	}
+
+	return (int32_t)(a->sequence - b->sequence) < 0;
+}
+
+static inline void
+hrt_callout_heap_set(uint16_t index, struct hrt_call *entry)
+{
+	hrt_callout_heap[index] = entry;
+	entry->heap_index = index;
+}
+
+static void
+hrt_callout_heap_sift_up(uint16_t index)
+{
+	struct hrt_call *entry = hrt_callout_heap[index];
+
+	while (index > 0) {
+		uint16_t parent = (index - 1) / 2;
+
+		if (!hrt_callout_before(entry, hrt_callout_heap[parent])) {
+			break;
+		}
+
+		hrt_callout_heap_set(index, hrt_callout_heap[parent]);
+		index = parent;
+	}
+
+	hrt_callout_heap_set(index, entry);
+}
+
+static void
+hrt_callout_heap_sift_down(uint16_t index)
+{
+	struct hrt_call *entry = hrt_callout_heap[index];
+
+	while (true) {
+		uint16_t child = 2 * index + 1;
+
+		if (child >= hrt_callout_heap_count) {
+			break;
+		}
+
+		if ((child + 1 < hrt_callout_heap_count)
+		    && hrt_callout_before(hrt_callout_heap[child + 1], hrt_callout_heap[child])) {
+			child++;
+		}
+
+		if (!hrt_callout_before(hrt_callout_heap[child], entry)) {
+			break;
+		}
+
+		hrt_callout_heap_set(index, hrt_callout_heap[child]);
+		index = child;
+	}
+
+	hrt_callout_heap_set(index, entry);
+}
+
+static void
+hrt_callout_heap_push(struct hrt_call *entry)
+{
+	hrt_callout_heap[hrt_callout_heap_count] = entry;
+	hrt_callout_heap_sift_up(hrt_callout_heap_count++);
+}
+
+static void
+hrt_callout_overflow_enter(struct hrt_call *entry)
+{
+	struct hrt_call	*call = (struct hrt_call *)sq_peek(&hrt_callout_overflow);
+
+	if ((call == NULL) || (entry->deadline < call->deadline)) {
+		sq_addfirst(&entry->link, &hrt_callout_overflow);
+		return;
+	}
+
+	struct hrt_call *next;
+
+	while (((next = (struct hrt_call *)sq_next(&call->link)) != NULL) && (next->deadline <= entry->deadline)) {
+		call = next;
+	}
+
+	sq_addafter(&call->link, &entry->link, &hrt_callout_overflow);
+}
+
+static inline void
+hrt_callout_queue_init(void)
+{
+	hrt_callout_heap_count = 0;
+	sq_init(&hrt_callout_overflow);
+}
+
+/**
+ * Return the call with the earliest deadline, or NULL if the queue is empty.
+ */
+static inline struct hrt_call *
+hrt_callout_queue_peek(void)
+{
+	struct hrt_call *call = (hrt_callout_heap_count > 0) ? hrt_callout_heap[0] : NULL;
+	struct hrt_call *overflow = (struct hrt_call *)sq_peek(&hrt_callout_overflow);
+
+	if ((overflow != NULL) && ((call == NULL) || hrt_callout_before(overflow, call))) {
+		return overflow;
+	}
+
+	return call;
+}
+
+/**
+ * Add a call that is not queued.
+ *
+ * @return true if the call is now the earliest in the queue
+ */
+static bool
+hrt_callout_queue_enter(struct hrt_call *entry)
+{
+	entry->sequence = hrt_callout_sequence++;
+
+	if (hrt_callout_heap_count < HRT_CALLOUT_HEAP_SIZE) {
+		hrt_callout_heap_push(entry);
+
+		if (hrt_callout_heap_count > hrt_callout_heap_count_max) {
+			hrt_callout_heap_count_max = hrt_callout_heap_count;
+		}
+
+	} else {
+		hrt_callout_overflow_enter(entry);
+		hrt_callout_overflow_count++;
+	}
+
+	return hrt_callout_queue_peek() == entry;
+}
+
+/**
+ * Remove a call from the queue.
+ *
+ * The entry may be uninitialised or not queued: its heap position is only trusted if
+ * the heap slot actually refers to it, and sq_rem() doesn't dereference the passed
+ * node unless it is found in the list.
+ */
+static void
+hrt_callout_queue_remove(struct hrt_call *entry)
+{
+	uint16_t index = entry->heap_index;
+
+	if ((index < hrt_callout_heap_count) && (hrt_callout_heap[index] == entry)) {
+		struct hrt_call *last = hrt_callout_heap[--hrt_callout_heap_count];
+
+		if (index < hrt_callout_heap_count) {
+			hrt_callout_heap_set(index, last);
+
+			if ((index > 0) && hrt_callout_before(last, hrt_callout_heap[(index - 1) / 2])) {
+				hrt_callout_heap_sift_up(index);
+
+			} else {
+				hrt_callout_heap_sift_down(index);
+			}
+		}
+
+		/* there is space in the heap again */
+		struct hrt_call *overflow = (struct hrt_call *)sq_remfirst(&hrt_callout_overflow);
+
+		if (overflow != NULL) {
+			hrt_callout_heap_push(overflow);
+		}
+
+	} else if (!sq_empty(&hrt_callout_overflow)) {
+		sq_rem(&entry->link, &hrt_callout_overflow);
+	}
+}
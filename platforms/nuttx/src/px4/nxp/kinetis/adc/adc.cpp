@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include <board_config.h>
+#include <errno.h>
 #include <drivers/drv_adc.h>
 #include <drivers/drv_hrt.h>
 #include <px4_arch/adc.h>
@@ -176,6 +177,16 @@ uint32_t px4_arch_adc_sample(uint32_t base_address, unsigned channel)
 	return result;
 }
 
+int px4_arch_adc_scan_start(uint32_t base_address, uint32_t channels)
+{
+	return -ENOTSUP;
+}
+
+unsigned px4_arch_adc_scan_read(uint32_t base_address, uint32_t values[], unsigned max_values)
+{
+	return 0;
+}
+
 uint32_t px4_arch_adc_temp_sensor_mask()
 {
 	return 1 << (ADC_SC1_ADCH_TEMP >> ADC_SC1_ADCH_SHIFT);
@@ -33,13 +33,20 @@
 
 #include <board_config.h>
 #include <stdint.h>
+#include <string.h>
+#include <errno.h>
 #include <drivers/drv_adc.h>
 #include <drivers/drv_hrt.h>
 #include <px4_arch/adc.h>
+#include <px4_platform_common/micro_hal.h>
 
 #include <stm32_adc.h>
 #include <stm32_gpio.h>
 
+#if defined(BOARD_ADC_DMAMAP)
+#  include <stm32_dma.h>
+#endif
+
 /*
  * Register accessors.
  * For now, no reason not to just use ADC1.
@@ -90,6 +97,51 @@
 #endif
 
 
+#if defined(BOARD_ADC_DMAMAP)
+/*
+ * Background scan (opt-in by the board defining BOARD_ADC_DMAMAP): all channels are in the regular
+ * sequence, converted continuously and written by a circular DMA into a buffer holding the last
+ * ADC_SCAN_OVERSAMPLING sequences, which get averaged on read.
+ */
+#define ADC_SCAN_MAX_CHANNELS	16	/* maximum length of the regular sequence */
+#define ADC_SCAN_OVERSAMPLING	16	/* sequences averaged per read */
+
+#define DMA_BUFFER_MASK		(PX4_ARCH_DCACHE_LINESIZE - 1)
+#define DMA_ALIGN_UP(n)		(((n) + DMA_BUFFER_MASK) & ~DMA_BUFFER_MASK)
+
+static uint16_t scan_buffer[DMA_ALIGN_UP(ADC_SCAN_OVERSAMPLING * ADC_SCAN_MAX_CHANNELS * sizeof(uint16_t)) / sizeof(uint16_t)]
+__attribute__((aligned(PX4_ARCH_DCACHE_LINESIZE))); // DMA buffer
+static DMA_HANDLE scan_dma = nullptr;
+static uint32_t scan_base_address = 0;
+static unsigned scan_channel_count = 0;
+
+static void scan_dma_start(uint32_t base_address)
+{
+	/* stop conversions, the sequence has to restart at the beginning of the buffer */
+	rCR2(base_address) &= ~(ADC_CR2_CONT | ADC_CR2_DMA | ADC_CR2_DDS);
+	stm32_dmastop(scan_dma);
+
+	stm32_dmasetup(
+		scan_dma,
+		base_address + STM32_ADC_DR_OFFSET,
+		reinterpret_cast<uint32_t>(scan_buffer),
+		scan_channel_count * ADC_SCAN_OVERSAMPLING,
+		DMA_SCR_CIRC		|
+		DMA_SCR_DIR_P2M		|
+		DMA_SCR_MINC		|
+		DMA_SCR_PSIZE_16BITS	|
+		DMA_SCR_MSIZE_16BITS	|
+		DMA_SCR_PRILO		|
+		DMA_SCR_PBURST_SINGLE	|
+		DMA_SCR_MBURST_SINGLE);
+	stm32_dmastart(scan_dma, nullptr, nullptr, false);
+
+	rSR(base_address) &= ~(ADC_SR_OVR | ADC_SR_EOC);
+	rCR2(base_address) |= ADC_CR2_CONT | ADC_CR2_DMA | ADC_CR2_DDS;
+	rCR2(base_address) |= ADC_CR2_SWSTART;
+}
+#endif
+
 int px4_arch_adc_init(uint32_t base_address)
 {
 	/* Perform ADC init once per ADC */
@@ -188,11 +240,131 @@ int px4_arch_adc_init(uint32_t base_address)
 
 void px4_arch_adc_uninit(uint32_t base_address)
 {
-	// nothing to do
+#if defined(BOARD_ADC_DMAMAP)
+
+	if ((scan_dma != nullptr) && (base_address == scan_base_address)) {
+		rCR2(base_address) &= ~(ADC_CR2_CONT | ADC_CR2_DMA | ADC_CR2_DDS);
+		rCR1(base_address) &= ~ADC_CR1_SCAN;
+		stm32_dmastop(scan_dma);
+		stm32_dmafree(scan_dma);
+		scan_dma = nullptr;
+
+		/* back to a single-channel sequence */
+		rSQR1(base_address) = 0;
+		rSQR2(base_address) = 0;
+		rSQR3(base_address) = 0;
+	}
+
+#endif
+}
+
+int px4_arch_adc_scan_start(uint32_t base_address, uint32_t channels)
+{
+#if defined(BOARD_ADC_DMAMAP)
+
+	if (scan_dma != nullptr) {
+		return -EBUSY;
+	}
+
+	/* regular sequence: SQ1-6 in SQR3, SQ7-12 in SQR2, SQ13-16 in SQR1 */
+	uint32_t sqr[3] {};
+	unsigned count = 0;
+
+	for (unsigned channel = 0; channel < 32; channel++) {
+		if (channels & (1 << channel)) {
+			if (count >= ADC_SCAN_MAX_CHANNELS) {
+				return -E2BIG;
+			}
+
+			sqr[count / 6] |= channel << ((count % 6) * 5);
+			count++;
+		}
+	}
+
+	if (count == 0) {
+		return -EINVAL;
+	}
+
+	scan_dma = stm32_dmachannel(BOARD_ADC_DMAMAP);
+
+	if (scan_dma == nullptr) {
+		return -EBUSY;
+	}
+
+	memset(scan_buffer, 0, sizeof(scan_buffer));
+	up_clean_dcache((uintptr_t)scan_buffer, (uintptr_t)scan_buffer + sizeof(scan_buffer));
+
+	scan_base_address = base_address;
+	scan_channel_count = count;
+
+	irqstate_t flags = px4_enter_critical_section();
+
+	/* the longest sample time (480 cycles) for all channels, for low noise and a moderate conversion rate */
+	rSMPR1(base_address) = 0b00000111111111111111111111111111;
+	rSMPR2(base_address) = 0b00111111111111111111111111111111;
+
+	rSQR3(base_address) = sqr[0];
+	rSQR2(base_address) = sqr[1];
+	rSQR1(base_address) = sqr[2] | ((count - 1) << ADC_SQR1_L_SHIFT);
+	rCR1(base_address) |= ADC_CR1_SCAN;
+
+	scan_dma_start(base_address);
+
+	px4_leave_critical_section(flags);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+unsigned px4_arch_adc_scan_read(uint32_t base_address, uint32_t values[], unsigned max_values)
+{
+#if defined(BOARD_ADC_DMAMAP)
+
+	if ((scan_dma == nullptr) || (base_address != scan_base_address)) {
+		return 0;
+	}
+
+	if (rSR(base_address) & ADC_SR_OVR) {
+		/* the DMA fell behind and the ADC stopped the DMA requests, restart in sync with the sequence */
+		irqstate_t flags = px4_enter_critical_section();
+		scan_dma_start(base_address);
+		px4_leave_critical_section(flags);
+	}
+
+	/* get fresh data from RAM */
+	up_invalidate_dcache((uintptr_t)scan_buffer, (uintptr_t)scan_buffer + sizeof(scan_buffer));
+
+	const unsigned count = (scan_channel_count < max_values) ? scan_channel_count : max_values;
+
+	for (unsigned i = 0; i < count; i++) {
+		uint32_t sum = 0;
+
+		for (unsigned j = 0; j < ADC_SCAN_OVERSAMPLING; j++) {
+			sum += scan_buffer[j * scan_channel_count + i];
+		}
+
+		values[i] = sum / ADC_SCAN_OVERSAMPLING;
+	}
+
+	return count;
+#else
+	return 0;
+#endif
 }
 
 uint32_t px4_arch_adc_sample(uint32_t base_address, unsigned channel)
 {
+#if defined(BOARD_ADC_DMAMAP)
+
+	if ((scan_dma != nullptr) && (base_address == scan_base_address)) {
+		/* the ADC is busy with the background scan */
+		return UINT32_MAX;
+	}
+
+#endif
+
 	irqstate_t flags = px4_enter_critical_section();
 
 	/* clear any previous EOC */
@@ -38,12 +38,15 @@
 #else
 
 #include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/defines.h>
 #include <px4_platform_common/micro_hal.h>
 #include <stm32_dma.h>
+#include <stm32_gpio.h>
 #include <stm32_tim.h>
 #include <px4_arch/dshot.h>
 #include <px4_arch/io_timer.h>
 #include <drivers/drv_pwm_output.h>
+#include <stdio.h>
 
 
 #define MOTOR_PWM_BIT_1				14u
@@ -63,18 +66,64 @@
 #define DSHOT_DMA_SCR (DMA_SCR_PRIHI | DMA_SCR_MSIZE_32BITS | DMA_SCR_PSIZE_32BITS | DMA_SCR_MINC | \
 		       DMA_SCR_DIR_M2P | DMA_SCR_TCIE | DMA_SCR_HTIE | DMA_SCR_TEIE | DMA_SCR_DMEIE)
 
+/*
+ * Bidirectional DShot: the output is inverted (idle high) and after each frame the ESC replies with its
+ * eRPM on the same line. The reply is 21 bits GCR at 5/4 of the DShot bit rate. It is captured by
+ * sampling the GPIO input register of the timer's pins with the timer update DMA at BDSHOT_OVERSAMPLING
+ * times the reply bit rate, so all channels of a timer are captured with the existing DMA stream.
+ */
+#define DSHOT_BIDIRECTIONAL_DMA_SCR (DMA_SCR_PRIHI | DMA_SCR_MSIZE_32BITS | DMA_SCR_PSIZE_32BITS | DMA_SCR_MINC | \
+				     DMA_SCR_DIR_M2P | DMA_SCR_TCIE | DMA_SCR_TEIE | DMA_SCR_DMEIE)
+#define BDSHOT_CAPTURE_DMA_SCR (DMA_SCR_PRIHI | DMA_SCR_MSIZE_16BITS | DMA_SCR_PSIZE_16BITS | DMA_SCR_MINC | \
+				DMA_SCR_DIR_P2M | DMA_SCR_TCIE | DMA_SCR_TEIE | DMA_SCR_DMEIE)
+
+#define BDSHOT_OVERSAMPLING		3u
+#define BDSHOT_REPLY_BITS		21u
+#define BDSHOT_TURNAROUND_US		40u	///< frame end to end of the reply start, including margin
+#define BDSHOT_CAPTURE_SAMPLES		256u	///< enough for DShot1200
+#define BDSHOT_CAPTURE_TIMERS		2u	///< timers which can capture at the same time
+
+/* the DMA controller needs to reach the GPIO port (DMA1 can only access APB1 on F4/F7) */
+#if defined(CONFIG_ARCH_CHIP_STM32H7)
+#  define BDSHOT_DMA_SUPPORTED(dma_base)	(true)
+#else
+#  define BDSHOT_DMA_SUPPORTED(dma_base)	((dma_base) == STM32_DMA2_BASE)
+#endif
+
 typedef struct dshot_handler_t {
 	bool			init;
 	DMA_HANDLE		dma_handle;
 	uint32_t		dma_size;
+	bool			bidirectional;	///< eRPM is captured after each frame
+	volatile bool		capturing;
+	uint16_t		*capture_buffer;
+	uint32_t		gpio_idr;	///< GPIO input register of the timer's pins
+	uint32_t		gpio_in[MAX_NUM_CHANNELS_PER_TIMER];	///< pins as input with pull-up while capturing
+	uint32_t		gpio_out[MAX_NUM_CHANNELS_PER_TIMER];
 } dshot_handler_t;
 
+typedef struct bdshot_channel_t {
+	int8_t			timer;		///< -1 if not captured
+	uint16_t		pin_mask;	///< bit of the channel in the GPIO input register
+	volatile bool		erpm_ready;
+	int			erpm;
+	uint32_t		read_ok;
+	uint32_t		read_fail;
+	uint32_t		read_no_reply;
+} bdshot_channel_t;
+
 #define DMA_BUFFER_MASK    (PX4_ARCH_DCACHE_LINESIZE - 1)
 #define DMA_ALIGN_UP(n)    (((n) + DMA_BUFFER_MASK) & ~DMA_BUFFER_MASK)
 #define DSHOT_BURST_BUFFER_SIZE(motors_number) (DMA_ALIGN_UP(sizeof(uint32_t)*ONE_MOTOR_BUFF_SIZE*motors_number))
 
 static dshot_handler_t dshot_handler[DSHOT_TIMERS] = {};
 static uint16_t *motor_buffer = NULL;
+static bool bidirectional_dshot = false;
+static unsigned dshot_frequency = 0;
+static unsigned bdshot_capture_samples = 0;
+static bdshot_channel_t bdshot_channels[MOTORS_NUMBER] = {};
+static uint16_t bdshot_capture_buffer_array[BDSHOT_CAPTURE_TIMERS][BDSHOT_CAPTURE_SAMPLES]
+__attribute__((aligned(PX4_ARCH_DCACHE_LINESIZE))); // DMA buffer
 static uint8_t dshot_burst_buffer_array[DSHOT_TIMERS * DSHOT_BURST_BUFFER_SIZE(MAX_NUM_CHANNELS_PER_TIMER)]
 __attribute__((aligned(PX4_ARCH_DCACHE_LINESIZE))); // DMA buffer
 static uint32_t *dshot_burst_buffer[DSHOT_TIMERS] = {};
@@ -84,8 +133,9 @@ static const uint8_t motor_assignment[MOTORS_NUMBER] = BOARD_DSHOT_MOTOR_ASSIGNM
 #endif /* BOARD_DSHOT_MOTOR_ASSIGNMENT */
 
 void dshot_dmar_data_prepare(uint8_t timer, uint8_t first_motor, uint8_t motors_number);
+static int bdshot_init(void);
 
-int up_dshot_init(uint32_t channel_mask, unsigned dshot_pwm_freq)
+int up_dshot_init(uint32_t channel_mask, unsigned dshot_pwm_freq, bool enable_bidirectional_dshot)
 {
 	// Alloc buffers if they do not exist. We don't use channel_mask so that potential future re-init calls can
 	// use the same buffer.
@@ -154,10 +204,306 @@ int up_dshot_init(uint32_t channel_mask, unsigned dshot_pwm_freq)
 		}
 	}
 
+	dshot_frequency = dshot_pwm_freq;
+	bidirectional_dshot = enable_bidirectional_dshot;
+
+	if (OK == ret_val && bidirectional_dshot) {
+		ret_val = bdshot_init();
+	}
+
 	return ret_val;
 }
 
-void up_dshot_trigger(void)
+/* timer and timer channel (1-4) driven by the burst buffer slot of a motor */
+static int dshot_slot_timer_channel(unsigned slot, uint8_t *timer_channel)
+{
+	unsigned first_motor = 0;
+
+	for (uint8_t timer = 0; timer < DSHOT_TIMERS; timer++) {
+		if (dshot_handler[timer].init) {
+			const uint8_t motors_number = io_timers[timer].dshot.channels_number;
+
+			if (slot < first_motor + motors_number) {
+				*timer_channel = slot - first_motor + 1;
+				return timer;
+			}
+
+			first_motor += motors_number;
+		}
+	}
+
+	return -1;
+}
+
+static int bdshot_init(void)
+{
+	unsigned capture_timers = 0;
+
+	for (uint8_t timer = 0; timer < DSHOT_TIMERS; timer++) {
+		dshot_handler_t *handler = &dshot_handler[timer];
+		handler->bidirectional = false;
+
+		if (!handler->init || !BDSHOT_DMA_SUPPORTED(io_timers[timer].dshot.dma_base)
+		    || capture_timers >= BDSHOT_CAPTURE_TIMERS) {
+			continue;
+		}
+
+		// all pins of the timer must be on the same GPIO port to be sampled at once
+		bool same_port = true;
+		bool first_pin = true;
+		uint32_t port = 0;
+		handler->bidirectional = true;
+
+		for (unsigned channel = 0; channel < MAX_TIMER_IO_CHANNELS; channel++) {
+			if (timer_io_channels[channel].timer_index != timer || timer_io_channels[channel].timer_channel == 0
+			    || timer_io_channels[channel].timer_channel > io_timers[timer].dshot.channels_number) {
+				continue;
+			}
+
+			const uint32_t gpio_out = timer_io_channels[channel].gpio_out;
+			const uint8_t index = timer_io_channels[channel].timer_channel - 1;
+
+			if (first_pin) {
+				port = gpio_out & GPIO_PORT_MASK;
+				first_pin = false;
+
+			} else if ((gpio_out & GPIO_PORT_MASK) != port) {
+				same_port = false;
+			}
+
+			handler->gpio_out[index] = gpio_out;
+			handler->gpio_in[index] = (gpio_out & (GPIO_PORT_MASK | GPIO_PIN_MASK)) | GPIO_INPUT | GPIO_PULLUP;
+		}
+
+		if (!same_port) {
+			handler->bidirectional = false;
+			continue;
+		}
+
+		// invert the outputs, the line idles high
+		for (unsigned channel = 0; channel < MAX_TIMER_IO_CHANNELS; channel++) {
+			if (timer_io_channels[channel].timer_index == timer && timer_io_channels[channel].timer_channel != 0) {
+				io_timer_set_pwm_output_inverted(channel, true);
+			}
+		}
+
+		handler->gpio_idr = g_gpiobase[port >> GPIO_PORT_SHIFT] + STM32_GPIO_IDR_OFFSET;
+		handler->capture_buffer = bdshot_capture_buffer_array[capture_timers++];
+	}
+
+	const unsigned sample_freq = dshot_frequency * 5 / 4 * BDSHOT_OVERSAMPLING;
+	bdshot_capture_samples = BDSHOT_OVERSAMPLING * (BDSHOT_REPLY_BITS + 4)
+				 + (uint64_t)BDSHOT_TURNAROUND_US * sample_freq / 1000000;
+
+	if (bdshot_capture_samples > BDSHOT_CAPTURE_SAMPLES) {
+		bdshot_capture_samples = BDSHOT_CAPTURE_SAMPLES;
+	}
+
+	for (unsigned motor = 0; motor < MOTORS_NUMBER; motor++) {
+		unsigned slot = motor;
+#ifdef BOARD_DSHOT_MOTOR_ASSIGNMENT
+		slot = motor_assignment[motor];
+#endif /* BOARD_DSHOT_MOTOR_ASSIGNMENT */
+
+		uint8_t timer_channel = 0;
+		const int timer = dshot_slot_timer_channel(slot, &timer_channel);
+
+		bdshot_channels[motor].timer = -1;
+
+		if (timer >= 0 && dshot_handler[timer].bidirectional) {
+			const uint32_t gpio = dshot_handler[timer].gpio_out[timer_channel - 1];
+			bdshot_channels[motor].timer = timer;
+			bdshot_channels[motor].pin_mask = 1 << ((gpio & GPIO_PIN_MASK) >> GPIO_PIN_SHIFT);
+		}
+	}
+
+	return OK;
+}
+
+/**
+ * Decode the eRPM reply of one channel from the GPIO samples.
+ *
+ * Each level change is a GCR bit of value 1, followed by a 0 for each additional bit period
+ * without a change (cf. https://brushlesswhoop.com/dshot-and-bidirectional-dshot/).
+ *
+ * @return eRPM, 0 if the motor is stopped, -1 if there is no reply or it is invalid
+ */
+static PX4_HOT int bdshot_decode(const uint16_t *samples, unsigned count, uint16_t pin_mask, bool *no_reply)
+{
+	static const uint8_t gcr_decode[32] = {
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0x9, 0xa, 0xb, 0xff, 0xd, 0xe, 0xf,
+		0xff, 0xff, 0x2, 0x3, 0xff, 0x5, 0x6, 0x7,
+		0xff, 0x0, 0x8, 0x1, 0xff, 0x4, 0xc, 0xff,
+	};
+
+	*no_reply = false;
+
+	// the reply starts with a falling edge
+	unsigned start = 0;
+
+	while (start < count && (samples[start] & pin_mask)) {
+		start++;
+	}
+
+	if (start == count) {
+		*no_reply = true;
+		return -1;
+	}
+
+	uint32_t value = 0;
+	unsigned bits = 0;
+	unsigned edge = start;
+	bool level = false;
+
+	for (unsigned i = start + 1; i < count && bits < BDSHOT_REPLY_BITS; i++) {
+		const bool sample = samples[i] & pin_mask;
+
+		if (sample != level) {
+			unsigned len = (i - edge + BDSHOT_OVERSAMPLING / 2) / BDSHOT_OVERSAMPLING;
+
+			if (len == 0) {
+				len = 1;
+			}
+
+			bits += len;
+			value = (value << len) | (1u << (len - 1));
+			edge = i;
+			level = sample;
+		}
+	}
+
+	// the line stays high after the last transition
+	if (bits < 18 || bits >= BDSHOT_REPLY_BITS) {
+		return -1;
+	}
+
+	const unsigned remaining = BDSHOT_REPLY_BITS - bits;
+	value = (value << remaining) | (1u << (remaining - 1));
+
+	// the first transition is the start bit, followed by 20 bit GCR, decoded as 5 bit GCR to 4 bit nibbles
+	uint32_t gcr = value & 0xfffff;
+	uint32_t data = 0;
+
+	for (unsigned nibble = 0; nibble < 4; nibble++) {
+		const uint8_t decoded = gcr_decode[gcr & 0x1f];
+
+		if (decoded == 0xff) {
+			return -1;
+		}
+
+		data |= decoded << (4 * nibble);
+		gcr >>= 5;
+	}
+
+	uint32_t checksum = data ^ (data >> 8);
+	checksum ^= checksum >> 4;
+
+	if ((checksum & 0xf) != 0xf) {
+		return -1;
+	}
+
+	// eeem mmmm mmmm: period in us = m << e
+	const uint32_t payload = data >> 4;
+
+	if (payload == 0x0fff) {
+		return 0;
+	}
+
+	const uint32_t period_us = (payload & 0x1ff) << (payload >> 9);
+
+	if (period_us == 0) {
+		return -1;
+	}
+
+	return (60 * 1000000 + period_us / 2) / period_us;
+}
+
+static void bdshot_restore_output(uint8_t timer)
+{
+	dshot_handler_t *handler = &dshot_handler[timer];
+
+	io_timer_update_dma_req(timer, false);
+
+	for (unsigned i = 0; i < MAX_NUM_CHANNELS_PER_TIMER; i++) {
+		if (handler->gpio_out[i] != 0) {
+			px4_arch_configgpio(handler->gpio_out[i]);
+		}
+	}
+
+	io_timer_set_dshot_mode(timer, dshot_frequency, io_timers[timer].dshot.channels_number);
+	handler->capturing = false;
+}
+
+static void bdshot_capture_complete(DMA_HANDLE handle, uint8_t status, void *arg)
+{
+	const uint8_t timer = (uint8_t)(uintptr_t)arg;
+	dshot_handler_t *handler = &dshot_handler[timer];
+
+	if ((status & DMA_STATUS_TCIF) == 0) {
+		return;
+	}
+
+	bdshot_restore_output(timer);
+
+	up_invalidate_dcache((uintptr_t)handler->capture_buffer,
+			     (uintptr_t)handler->capture_buffer + sizeof(bdshot_capture_buffer_array[0]));
+
+	for (unsigned motor = 0; motor < MOTORS_NUMBER; motor++) {
+		bdshot_channel_t *channel = &bdshot_channels[motor];
+
+		if (channel->timer != timer) {
+			continue;
+		}
+
+		bool no_reply;
+		const int erpm = bdshot_decode(handler->capture_buffer, bdshot_capture_samples, channel->pin_mask, &no_reply);
+
+		if (erpm >= 0) {
+			channel->erpm = erpm;
+			channel->erpm_ready = true;
+			channel->read_ok++;
+
+		} else if (no_reply) {
+			channel->read_no_reply++;
+
+		} else {
+			channel->read_fail++;
+		}
+	}
+}
+
+static void bdshot_start_capture(DMA_HANDLE handle, uint8_t status, void *arg)
+{
+	const uint8_t timer = (uint8_t)(uintptr_t)arg;
+	dshot_handler_t *handler = &dshot_handler[timer];
+
+	if ((status & DMA_STATUS_TCIF) == 0) {
+		return;
+	}
+
+	// release the line for the ESC reply
+	for (unsigned i = 0; i < MAX_NUM_CHANNELS_PER_TIMER; i++) {
+		if (handler->gpio_in[i] != 0) {
+			px4_arch_configgpio(handler->gpio_in[i]);
+		}
+	}
+
+	io_timer_update_dma_req(timer, false);
+	io_timer_set_dshot_capture_mode(timer, dshot_frequency * 5 / 4 * BDSHOT_OVERSAMPLING);
+
+	px4_stm32_dmasetup(handler->dma_handle,
+			   handler->gpio_idr,
+			   (uint32_t)(handler->capture_buffer),
+			   bdshot_capture_samples,
+			   BDSHOT_CAPTURE_DMA_SCR);
+
+	handler->capturing = true;
+	stm32_dmastart(handler->dma_handle, bdshot_capture_complete, arg, false);
+	io_timer_update_dma_req(timer, true);
+}
+
+PX4_HOT void up_dshot_trigger(void)
 {
 	uint8_t first_motor = 0;
 
@@ -165,6 +511,12 @@ void up_dshot_trigger(void)
 
 		if (true == dshot_handler[timer].init) {
 
+			if (dshot_handler[timer].capturing) {
+				// the reply did not complete before the next frame
+				stm32_dmastop(dshot_handler[timer].dma_handle);
+				bdshot_restore_output(timer);
+			}
+
 			uint8_t motors_number = io_timers[timer].dshot.channels_number;
 			dshot_dmar_data_prepare(timer, first_motor, motors_number);
 
@@ -174,16 +526,19 @@ void up_dshot_trigger(void)
 
 			first_motor += motors_number;
 
+			const bool bidirectional = dshot_handler[timer].bidirectional;
+
 			px4_stm32_dmasetup(dshot_handler[timer].dma_handle,
 					   io_timers[timer].base + STM32_GTIM_DMAR_OFFSET,
 					   (uint32_t)(dshot_burst_buffer[timer]),
 					   dshot_handler[timer].dma_size,
-					   DSHOT_DMA_SCR);
+					   bidirectional ? DSHOT_BIDIRECTIONAL_DMA_SCR : DSHOT_DMA_SCR);
 
 			// Clean UDE flag before DMA is started
 			io_timer_update_dma_req(timer, false);
-			// Trigger DMA (DShot Outputs)
-			stm32_dmastart(dshot_handler[timer].dma_handle, NULL, NULL, false);
+			// Trigger DMA (DShot Outputs), switching to capture of the reply when done
+			stm32_dmastart(dshot_handler[timer].dma_handle, bidirectional ? bdshot_start_capture : NULL,
+				       (void *)(uintptr_t)timer, false);
 			io_timer_update_dma_req(timer, true);
 
 		}
@@ -193,12 +548,13 @@ void up_dshot_trigger(void)
 /**
 * bits 	1-11	- throttle value (0-47 are reserved, 48-2047 give 2000 steps of throttle resolution)
 * bit 	12		- dshot telemetry enable/disable
-* bits 	13-16	- XOR checksum
+* bits 	13-16	- XOR checksum (inverted for bidirectional DShot)
 **/
-static void dshot_motor_data_set(uint32_t motor_number, uint16_t throttle, bool telemetry)
+static PX4_HOT void dshot_motor_data_set(uint32_t motor_number, uint16_t throttle, bool telemetry)
 {
 	uint16_t packet = 0;
 	uint16_t checksum = 0;
+	const bool bidirectional = bidirectional_dshot && bdshot_channels[motor_number].timer >= 0;
 
 #ifdef BOARD_DSHOT_MOTOR_ASSIGNMENT
 	motor_number = motor_assignment[motor_number];
@@ -218,6 +574,10 @@ static void dshot_motor_data_set(uint32_t motor_number, uint16_t throttle, bool
 		csum_data >>= NIBBLES_SIZE;
 	}
 
+	if (bidirectional) {
+		checksum = ~checksum;
+	}
+
 	packet |= (checksum & 0x0F);
 
 	for (i = 0; i < ONE_MOTOR_DATA_SIZE; i++) {
@@ -239,7 +599,7 @@ void up_dshot_motor_command(unsigned channel, uint16_t command, bool telemetry)
 	dshot_motor_data_set(channel, command, telemetry);
 }
 
-void dshot_dmar_data_prepare(uint8_t timer, uint8_t first_motor, uint8_t motors_number)
+PX4_HOT void dshot_dmar_data_prepare(uint8_t timer, uint8_t first_motor, uint8_t motors_number)
 {
 	uint32_t *buffer = dshot_burst_buffer[timer];
 
@@ -256,4 +616,34 @@ int up_dshot_arm(bool armed)
 	return io_timer_set_enable(armed, IOTimerChanMode_Dshot, IO_TIMER_ALL_MODES_CHANNELS);
 }
 
+int up_bdshot_get_erpm(uint8_t channel, int *erpm)
+{
+	if (!bidirectional_dshot || channel >= MOTORS_NUMBER || bdshot_channels[channel].timer < 0
+	    || !bdshot_channels[channel].erpm_ready) {
+		return -1;
+	}
+
+	*erpm = bdshot_channels[channel].erpm;
+	bdshot_channels[channel].erpm_ready = false;
+	return 0;
+}
+
+void up_bdshot_status(void)
+{
+	if (!bidirectional_dshot) {
+		return;
+	}
+
+	printf("bidirectional DShot, %u samples per reply\n", bdshot_capture_samples);
+
+	for (unsigned channel = 0; channel < MOTORS_NUMBER; channel++) {
+		const bdshot_channel_t *c = &bdshot_channels[channel];
+
+		if (c->timer >= 0) {
+			printf("channel %u: ok %u, invalid %u, no reply %u\n", channel, (unsigned)c->read_ok, (unsigned)c->read_fail,
+			       (unsigned)c->read_no_reply);
+		}
+	}
+}
+
 #endif
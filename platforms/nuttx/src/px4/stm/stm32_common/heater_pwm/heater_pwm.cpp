@@ -0,0 +1,221 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file heater_pwm.cpp
+ *
+ * Hardware PWM output of the IMU heater, the duty cycle is held by the timer compare register
+ * so that the heater driver only needs to run when it computes a new duty cycle.
+ *
+ * The board defines HEATER_PWM_TIMER, HEATER_PWM_CHANNEL and GPIO_HEATER_PWM_OUTPUT (the timer
+ * alternate function of the heater pin), GPIO_HEATER_OUTPUT is the off state.
+ */
+
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/micro_hal.h>
+
+#include <board_config.h>
+
+#include <math.h>
+
+#if defined(HEATER_PWM_TIMER)
+
+/* Check that the heater and HRT timers are different */
+#if defined(HRT_TIMER)
+# if HEATER_PWM_TIMER == HRT_TIMER
+#   error HEATER_PWM_TIMER and HRT_TIMER must use different timers.
+# endif
+#endif
+
+/* PWM rate of the heater output, the period must fit the 16 bit timers at 1 MHz */
+#ifndef HEATER_PWM_RATE
+#define HEATER_PWM_RATE 100
+#endif
+
+#define HEATER_PWM_PERIOD (1000000 / HEATER_PWM_RATE)
+
+#if   HEATER_PWM_TIMER == 1
+# define HEATER_PWM_BASE                STM32_TIM1_BASE
+# define HEATER_PWM_CLOCK               STM32_APB2_TIM1_CLKIN
+# define HEATER_PWM_CLOCK_ENABLE        RCC_APB2ENR_TIM1EN
+# define HEATER_PWM_CLOCK_POWER_REG     STM32_RCC_APB2ENR
+#elif HEATER_PWM_TIMER == 2
+# define HEATER_PWM_BASE                STM32_TIM2_BASE
+# define HEATER_PWM_CLOCK               STM32_APB1_TIM2_CLKIN
+# define HEATER_PWM_CLOCK_ENABLE        RCC_APB1ENR_TIM2EN
+# define HEATER_PWM_CLOCK_POWER_REG     STM32_RCC_APB1ENR
+#elif HEATER_PWM_TIMER == 3
+# define HEATER_PWM_BASE                STM32_TIM3_BASE
+# define HEATER_PWM_CLOCK               STM32_APB1_TIM3_CLKIN
+# define HEATER_PWM_CLOCK_ENABLE        RCC_APB1ENR_TIM3EN
+# define HEATER_PWM_CLOCK_POWER_REG     STM32_RCC_APB1ENR
+#elif HEATER_PWM_TIMER == 4
+# define HEATER_PWM_BASE                STM32_TIM4_BASE
+# define HEATER_PWM_CLOCK               STM32_APB1_TIM4_CLKIN
+# define HEATER_PWM_CLOCK_ENABLE        RCC_APB1ENR_TIM4EN
+# define HEATER_PWM_CLOCK_POWER_REG     STM32_RCC_APB1ENR
+#elif HEATER_PWM_TIMER == 5
+# define HEATER_PWM_BASE                STM32_TIM5_BASE
+# define HEATER_PWM_CLOCK               STM32_APB1_TIM5_CLKIN
+# define HEATER_PWM_CLOCK_ENABLE        RCC_APB1ENR_TIM5EN
+# define HEATER_PWM_CLOCK_POWER_REG     STM32_RCC_APB1ENR
+#elif HEATER_PWM_TIMER == 8
+# define HEATER_PWM_BASE                STM32_TIM8_BASE
+# define HEATER_PWM_CLOCK               STM32_APB2_TIM8_CLKIN
+# define HEATER_PWM_CLOCK_ENABLE        RCC_APB2ENR_TIM8EN
+# define HEATER_PWM_CLOCK_POWER_REG     STM32_RCC_APB2ENR
+#elif HEATER_PWM_TIMER == 12
+# define HEATER_PWM_BASE                STM32_TIM12_BASE
+# define HEATER_PWM_CLOCK               STM32_APB1_TIM12_CLKIN
+# define HEATER_PWM_CLOCK_ENABLE        RCC_APB1ENR_TIM12EN
+# define HEATER_PWM_CLOCK_POWER_REG     STM32_RCC_APB1ENR
+#elif HEATER_PWM_TIMER == 14
+# define HEATER_PWM_BASE                STM32_TIM14_BASE
+# define HEATER_PWM_CLOCK               STM32_APB1_TIM14_CLKIN
+# define HEATER_PWM_CLOCK_ENABLE        RCC_APB1ENR_TIM14EN
+# define HEATER_PWM_CLOCK_POWER_REG     STM32_RCC_APB1ENR
+#else
+# error HEATER_PWM_TIMER must be one of the timers 1, 2, 3, 4, 5, 8, 12 or 14.
+#endif // HEATER_PWM_TIMER
+
+#if HEATER_PWM_CHANNEL == 1
+# define HEATER_PWM_CCER      (1 << 0)
+# define HEATER_PWM_CCMR1     ((6 << 4) | (1 << 3))
+# define HEATER_PWM_CCMR2     0
+# define HEATER_PWM_rCCR      rCCR1
+#elif HEATER_PWM_CHANNEL == 2
+# define HEATER_PWM_CCER      (1 << 4)
+# define HEATER_PWM_CCMR1     ((6 << 12) | (1 << 11))
+# define HEATER_PWM_CCMR2     0
+# define HEATER_PWM_rCCR      rCCR2
+#elif HEATER_PWM_CHANNEL == 3
+# define HEATER_PWM_CCER      (1 << 8)
+# define HEATER_PWM_CCMR1     0
+# define HEATER_PWM_CCMR2     ((6 << 4) | (1 << 3))
+# define HEATER_PWM_rCCR      rCCR3
+#elif HEATER_PWM_CHANNEL == 4
+# define HEATER_PWM_CCER      (1 << 12)
+# define HEATER_PWM_CCMR1     0
+# define HEATER_PWM_CCMR2     ((6 << 12) | (1 << 11))
+# define HEATER_PWM_rCCR      rCCR4
+#else
+# error HEATER_PWM_CHANNEL must be a value between 1 and 4.
+#endif // HEATER_PWM_CHANNEL
+
+/* Timer register accessors, the offsets used here are the same for the general and advanced timers. */
+#define REG(_reg)       (*(volatile uint32_t *)(HEATER_PWM_BASE + _reg))
+
+#define rARR            REG(STM32_GTIM_ARR_OFFSET)
+#define rCCER           REG(STM32_GTIM_CCER_OFFSET)
+#define rCCMR1          REG(STM32_GTIM_CCMR1_OFFSET)
+#define rCCMR2          REG(STM32_GTIM_CCMR2_OFFSET)
+#define rCCR1           REG(STM32_GTIM_CCR1_OFFSET)
+#define rCCR2           REG(STM32_GTIM_CCR2_OFFSET)
+#define rCCR3           REG(STM32_GTIM_CCR3_OFFSET)
+#define rCCR4           REG(STM32_GTIM_CCR4_OFFSET)
+#define rCR1            REG(STM32_GTIM_CR1_OFFSET)
+#define rCR2            REG(STM32_GTIM_CR2_OFFSET)
+#define rDIER           REG(STM32_GTIM_DIER_OFFSET)
+#define rEGR            REG(STM32_GTIM_EGR_OFFSET)
+#define rPSC            REG(STM32_GTIM_PSC_OFFSET)
+#define rSMCR           REG(STM32_GTIM_SMCR_OFFSET)
+#if HEATER_PWM_TIMER == 1 || HEATER_PWM_TIMER == 8
+# define rBDTR          REG(STM32_ATIM_BDTR_OFFSET)
+#endif
+
+int heater_pwm_init(void);
+void heater_pwm_deinit(void);
+void heater_pwm_set(float duty);
+
+int heater_pwm_init(void)
+{
+	irqstate_t flags = px4_enter_critical_section();
+
+	/* enable the timer clock before we try to talk to it */
+	modifyreg32(HEATER_PWM_CLOCK_POWER_REG, 0, HEATER_PWM_CLOCK_ENABLE);
+
+	/* disable and configure the timer, free-running at 1 MHz */
+	rCR1 = 0;
+	rCR2 = 0;
+	rSMCR = 0;
+	rDIER = 0;
+	rCCER = 0;
+	rCCMR1 = HEATER_PWM_CCMR1;
+	rCCMR2 = HEATER_PWM_CCMR2;
+	HEATER_PWM_rCCR = 0;
+	rPSC = (HEATER_PWM_CLOCK / 1000000) - 1;
+	rARR = HEATER_PWM_PERIOD - 1;
+
+#if defined(rBDTR)
+	/* master output enable = on */
+	rBDTR = ATIM_BDTR_MOE;
+#endif
+
+	rCCER = HEATER_PWM_CCER;
+
+	/* generate an update event; reloads the counter and all registers */
+	rEGR = GTIM_EGR_UG;
+	rCR1 = GTIM_CR1_CEN | GTIM_CR1_ARPE;
+
+	px4_leave_critical_section(flags);
+
+	px4_arch_configgpio(GPIO_HEATER_PWM_OUTPUT);
+
+	return OK;
+}
+
+void heater_pwm_deinit(void)
+{
+	/* heater off */
+	px4_arch_configgpio(GPIO_HEATER_OUTPUT);
+
+	rCR1 = 0;
+	rCCER = 0;
+}
+
+void heater_pwm_set(float duty)
+{
+	if (!(duty > 0.f)) {
+		HEATER_PWM_rCCR = 0;
+
+	} else if (duty >= 1.f) {
+		/* compare value beyond the period, always on */
+		HEATER_PWM_rCCR = HEATER_PWM_PERIOD;
+
+	} else {
+		HEATER_PWM_rCCR = (uint32_t)(duty * HEATER_PWM_PERIOD);
+	}
+}
+
+#endif // HEATER_PWM_TIMER
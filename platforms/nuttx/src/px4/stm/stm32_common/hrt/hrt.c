@@ -62,6 +62,7 @@
 #include <board_config.h>
 #include <drivers/drv_hrt.h>
 #include <lib/perf/perf_counter.h>
+#include <px4_platform/hrt_callout_queue.h>
 
 
 #include "stm32_gpio.h"
@@ -245,11 +246,6 @@
 # error HRT_TIMER_CHANNEL must be a value between 1 and 4
 #endif
 
-/*
- * Queue of callout entries.
- */
-static struct sq_queue_s	callout_queue;
-
 /* latency baseline (last compare value applied) */
 static uint16_t			latency_baseline;
 
@@ -260,6 +256,7 @@ static uint16_t			latency_actual;
 static void		hrt_tim_init(void);
 static int		hrt_tim_isr(int irq, void *context, void *arg);
 static void		hrt_latency_update(void);
+static void		hrt_isr_stats_update(unsigned callouts);
 
 /* callout list manipulation */
 static void		hrt_call_internal(struct hrt_call *entry,
@@ -269,7 +266,7 @@ static void		hrt_call_internal(struct hrt_call *entry,
 		void *arg);
 static void		hrt_call_enter(struct hrt_call *entry);
 static void		hrt_call_reschedule(void);
-static void		hrt_call_invoke(void);
+static unsigned		hrt_call_invoke(void);
 
 /*
  * Specific registers and bits used by PPM sub-functions
@@ -633,10 +630,13 @@ hrt_tim_isr(int irq, void *context, void *arg)
 		hrt_latency_update();
 
 		/* run any callouts that have met their deadline */
-		hrt_call_invoke();
+		unsigned callouts = hrt_call_invoke();
 
 		/* and schedule the next interrupt */
 		hrt_call_reschedule();
+
+		/* account the time spent in the interrupt */
+		hrt_isr_stats_update(callouts);
 	}
 
 	return OK;
@@ -751,7 +751,7 @@ hrt_store_absolute_time(volatile hrt_abstime *now)
 void
 hrt_init(void)
 {
-	sq_init(&callout_queue);
+	hrt_callout_queue_init();
 	hrt_tim_init();
 
 #ifdef HRT_PPM_CHANNEL
@@ -801,15 +801,13 @@ hrt_call_internal(struct hrt_call *entry, hrt_abstime deadline, hrt_abstime inte
 	irqstate_t flags = px4_enter_critical_section();
 
 	/* if the entry is currently queued, remove it */
-	/* note that we are using a potentially uninitialised
-	   entry->link here, but it is safe as sq_rem() doesn't
-	   dereference the passed node unless it is found in the
-	   list. So we potentially waste a bit of time searching the
-	   queue for the uninitialised entry->link but we don't do
-	   anything actually unsafe.
+	/* note that the entry is potentially uninitialised here, but
+	   hrt_callout_queue_remove() only trusts its heap position if
+	   the heap actually refers to it, so we don't do anything
+	   actually unsafe.
 	*/
 	if (entry->deadline != 0) {
-		sq_rem(&entry->link, &callout_queue);
+		hrt_callout_queue_remove(entry);
 	}
 
 	entry->deadline = deadline;
@@ -841,7 +839,7 @@ hrt_cancel(struct hrt_call *entry)
 {
 	irqstate_t flags = px4_enter_critical_section();
 
-	sq_rem(&entry->link, &callout_queue);
+	hrt_callout_queue_remove(entry);
 	entry->deadline = 0;
 
 	/* if this is a periodic call being removed by the callout, prevent it from
@@ -855,42 +853,27 @@ hrt_cancel(struct hrt_call *entry)
 static void
 hrt_call_enter(struct hrt_call *entry)
 {
-	struct hrt_call	*call, *next;
-
-	call = (struct hrt_call *)sq_peek(&callout_queue);
-
-	if ((call == NULL) || (entry->deadline < call->deadline)) {
-		sq_addfirst(&entry->link, &callout_queue);
+	if (hrt_callout_queue_enter(entry)) {
 		hrtinfo("call enter at head, reschedule\n");
 		/* we changed the next deadline, reschedule the timer event */
 		hrt_call_reschedule();
-
-	} else {
-		do {
-			next = (struct hrt_call *)sq_next(&call->link);
-
-			if ((next == NULL) || (entry->deadline < next->deadline)) {
-				hrtinfo("call enter after head\n");
-				sq_addafter(&call->link, &entry->link, &callout_queue);
-				break;
-			}
-		} while ((call = next) != NULL);
 	}
 
 	hrtinfo("scheduled\n");
 }
 
-static void
+static unsigned
 hrt_call_invoke(void)
 {
 	struct hrt_call	*call;
 	hrt_abstime deadline;
+	unsigned callouts = 0;
 
 	while (true) {
 		/* get the current time */
 		hrt_abstime now = hrt_absolute_time();
 
-		call = (struct hrt_call *)sq_peek(&callout_queue);
+		call = hrt_callout_queue_peek();
 
 		if (call == NULL) {
 			break;
@@ -900,7 +883,7 @@ hrt_call_invoke(void)
 			break;
 		}
 
-		sq_rem(&call->link, &callout_queue);
+		hrt_callout_queue_remove(call);
 		hrtinfo("call pop\n");
 
 		/* save the intended deadline for periodic calls */
@@ -913,6 +896,7 @@ hrt_call_invoke(void)
 		if (call->callout) {
 			hrtinfo("call %p: %p(%p)\n", call, call->callout, call->arg);
 			call->callout(call->arg);
+			callouts++;
 		}
 
 		/* if the callout has a non-zero period, it has to be re-entered */
@@ -927,6 +911,8 @@ hrt_call_invoke(void)
 			hrt_call_enter(call);
 		}
 	}
+
+	return callouts;
 }
 
 /**
@@ -938,7 +924,7 @@ static void
 hrt_call_reschedule()
 {
 	hrt_abstime	now = hrt_absolute_time();
-	struct hrt_call	*next = (struct hrt_call *)sq_peek(&callout_queue);
+	struct hrt_call	*next = hrt_callout_queue_peek();
 	hrt_abstime	deadline = now + HRT_INTERVAL_MAX;
 
 	/*
@@ -991,6 +977,28 @@ hrt_latency_update(void)
 	latency_counters[index]++;
 }
 
+static void
+hrt_isr_stats_update(unsigned callouts)
+{
+	/* the timer counts microseconds, the interrupt is always shorter than a counter period */
+	uint16_t isr_time = rCNT - latency_actual;
+
+	hrt_isr_stats.count++;
+	hrt_isr_stats.callouts += callouts;
+	hrt_isr_stats.time_total += isr_time;
+
+	if (isr_time > hrt_isr_stats.time_max) {
+		hrt_isr_stats.time_max = isr_time;
+	}
+
+	if (callouts > hrt_isr_stats.callouts_max) {
+		hrt_isr_stats.callouts_max = callouts;
+	}
+
+	hrt_isr_stats.queue_max = hrt_callout_heap_count_max;
+	hrt_isr_stats.queue_overflows = hrt_callout_overflow_count;
+}
+
 void
 hrt_call_init(struct hrt_call *entry)
 {
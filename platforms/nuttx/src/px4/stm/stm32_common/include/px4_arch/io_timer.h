@@ -147,4 +147,15 @@ __EXPORT void io_timer_update_dma_req(uint8_t timer, bool enable);
 
 __EXPORT extern int io_timer_set_dshot_mode(uint8_t timer, unsigned dshot_pwm_rate, uint8_t dma_burst_length);
 
+/**
+ * Run the timer at sample_freq to pace the DMA sampling of the bidirectional DShot reply.
+ * io_timer_set_dshot_mode() restores the output timing.
+ */
+__EXPORT extern void io_timer_set_dshot_capture_mode(uint8_t timer, unsigned sample_freq);
+
+/**
+ * Invert the output of a PWM or DShot channel (PWM mode 2), so that the line idles high.
+ */
+__EXPORT extern int io_timer_set_pwm_output_inverted(unsigned channel, bool inverted);
+
 __END_DECLS
@@ -71,6 +71,11 @@ protected:
 	 */
 	virtual int	_bus_exchange(IOPacket *_packet) = 0;
 
+	/**
+	 * Transfer a batch of transactions (PKT_CODE_BATCH) in place, for reads of PX4IO_PAGE_BATCH.
+	 */
+	int		transfer_batch(uint16_t *regs, unsigned count);
+
 	/**
 	 * Performance counters.
 	 */
@@ -86,13 +91,13 @@ private:
 	/*
 	 * XXX tune this value
 	 *
-	 * At 1.5Mbps each register takes 13.3µs, and we always transfer a full packet.
+	 * At 1.5Mbps each register takes 13.3µs, and only the registers of a packet are transferred.
 	 * Packet overhead is 26µs for the four-byte header.
 	 *
 	 * 32 registers = 451µs
 	 *
-	 * Maybe we can just send smaller packets (e.g. 8 regs) and loop for larger (less common)
-	 * transfers? Could cause issues with any regs expecting to be written atomically...
+	 * The per-cycle transactions are batched (PKT_CODE_BATCH) into a single packet each way,
+	 * so the header and turnaround overhead is paid once per cycle.
 	 */
 	IOPacket		*_io_buffer_ptr;
 
@@ -533,6 +533,38 @@ int io_timer_set_dshot_mode(uint8_t timer, unsigned dshot_pwm_freq, uint8_t dma_
 	return ret_val;
 }
 
+void io_timer_set_dshot_capture_mode(uint8_t timer, unsigned sample_freq)
+{
+	rARR(timer) = (io_timers[timer].clock_freq / sample_freq) - 1;
+	rPSC(timer) = 0;
+	rEGR(timer) = ATIM_EGR_UG;
+}
+
+int io_timer_set_pwm_output_inverted(unsigned channel, bool inverted)
+{
+	int rv = io_timer_validate_channel_index(channel);
+
+	if (rv == 0) {
+		irqstate_t flags = px4_enter_critical_section();
+
+		uint32_t shifts = timer_io_channels[channel].timer_channel - 1;
+		uint32_t timer = channels_timer(channel);
+		uint32_t ccmr_offset = STM32_GTIM_CCMR1_OFFSET + ((shifts >> 1) * sizeof(uint32_t));
+		uint32_t ccmr = REG(timer, ccmr_offset);
+
+		/* PWM mode 2 is active while the counter is above the compare value */
+
+		ccmr &= ~(GTIM_CCMR1_OC1M_MASK << ((shifts & 1) * CCMR_C1_NUM_BITS));
+		ccmr |= ((inverted ? GTIM_CCMR_MODE_PWM2 : GTIM_CCMR_MODE_PWM1) << GTIM_CCMR1_OC1M_SHIFT)
+			<< ((shifts & 1) * CCMR_C1_NUM_BITS);
+		REG(timer, ccmr_offset) = ccmr;
+
+		px4_leave_critical_section(flags);
+	}
+
+	return rv;
+}
+
 static inline void io_timer_set_PWM_mode(unsigned timer)
 {
 	rPSC(timer) = (io_timers[timer].clock_freq / BOARD_PWM_FREQ) - 1;
@@ -23,6 +23,19 @@ add_custom_target(run_config
 		DEPENDS px4 logs_symlink
 		)
 
+# headless benchmark: SIH in lockstep, scripted flight, per-module CPU/uORB/memory report as JSON
+# usage: make px4_sitl bench (PX4_BENCH_MINUTES sets the simulated duration)
+add_custom_target(bench
+		COMMAND ${PYTHON_EXECUTABLE} ${PX4_SOURCE_DIR}/Tools/sitl_bench.py
+			--px4-binary $<TARGET_FILE:px4>
+			--src-dir ${PX4_SOURCE_DIR}
+			--build-dir ${PX4_BINARY_DIR}
+			--output ${PX4_BINARY_DIR}/bench.json
+		WORKING_DIRECTORY ${SITL_WORKING_DIR}
+		USES_TERMINAL
+		DEPENDS px4 logs_symlink
+		)
+
 px4_add_git_submodule(TARGET git_gazebo PATH "${PX4_SOURCE_DIR}/Tools/sitl_gazebo")
 px4_add_git_submodule(TARGET git_jmavsim PATH "${PX4_SOURCE_DIR}/Tools/jMAVSim")
 
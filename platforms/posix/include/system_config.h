@@ -63,4 +63,4 @@
 #define CONFIG_SCHED_WORKPERIOD 50000
 
 #define CONFIG_SCHED_INSTRUMENTATION 1
-#define CONFIG_MAX_TASKS 32
+#define CONFIG_MAX_TASKS 64
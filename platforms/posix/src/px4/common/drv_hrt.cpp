@@ -47,6 +47,7 @@
 
 #include <semaphore.h>
 #include <time.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include "hrt_work.h"
@@ -55,10 +56,27 @@
 #include <lockstep_scheduler/lockstep_scheduler.h>
 #endif
 
+#if defined(__PX4_LINUX) && !defined(ENABLE_LOCKSTEP_SCHEDULER)
+// On Linux the callouts are run by a dedicated SCHED_FIFO thread waiting on an absolute timerfd
+// instead of the hrt work queue, which sleeps for relative intervals and can't be woken up early.
+// With lockstep the simulated time has to go through the lockstep scheduler, so the work queue is used.
+#define HRT_TIMER_THREAD
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
 // Intervals in usec
 static constexpr unsigned HRT_INTERVAL_MIN = 50;
 static constexpr unsigned HRT_INTERVAL_MAX = 50000000;
 
+#if defined(HRT_TIMER_THREAD)
+// calls due within this window are run together with the ones already due instead of rearming the timer
+static constexpr unsigned HRT_COALESCE_WINDOW = 20;
+
+static int _hrt_timer_fd = -1;
+#endif
+
 /*
  * Queue of callout entries.
  */
@@ -71,7 +89,9 @@ static uint64_t			latency_baseline;
 static uint64_t			latency_actual;
 
 static px4_sem_t 	_hrt_lock;
+#if !defined(HRT_TIMER_THREAD)
 static struct work_s	_hrt_work;
+#endif
 
 static hrt_abstime px4_timestart_monotonic = 0;
 
@@ -82,7 +102,7 @@ static LockstepScheduler *lockstep_scheduler = new LockstepScheduler();
 static void hrt_latency_update();
 
 static void hrt_call_reschedule();
-static void hrt_call_invoke();
+static unsigned hrt_call_invoke();
 
 hrt_abstime hrt_absolute_time_offset()
 {
@@ -133,6 +153,11 @@ hrt_abstime hrt_absolute_time()
 	// optimized case (avoid ts_to_abstime) if lockstep scheduler is used
 	const uint64_t abstime = lockstep_scheduler->get_absolute_time();
 	return abstime - px4_timestart_monotonic;
+#elif defined(__PX4_LINUX)
+	// go straight to the vDSO clock_gettime()
+	struct timespec ts;
+	system_clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts_to_abstime(&ts);
 #else // defined(ENABLE_LOCKSTEP_SCHEDULER)
 	struct timespec ts;
 	px4_clock_gettime(CLOCK_MONOTONIC, &ts);
@@ -224,6 +249,25 @@ static void hrt_latency_update()
 	latency_counters[index]++;
 }
 
+static void hrt_isr_stats_update(hrt_abstime isr_time, unsigned callouts)
+{
+	if (isr_time > UINT16_MAX) {
+		isr_time = UINT16_MAX;
+	}
+
+	hrt_isr_stats.count++;
+	hrt_isr_stats.callouts += callouts;
+	hrt_isr_stats.time_total += isr_time;
+
+	if (isr_time > hrt_isr_stats.time_max) {
+		hrt_isr_stats.time_max = isr_time;
+	}
+
+	if (callouts > hrt_isr_stats.callouts_max) {
+		hrt_isr_stats.callouts_max = callouts;
+	}
+}
+
 /*
  * initialise a hrt_call structure
  */
@@ -244,6 +288,33 @@ void	hrt_call_delay(struct hrt_call *entry, hrt_abstime delay)
 	entry->deadline = hrt_absolute_time() + delay;
 }
 
+#if defined(HRT_TIMER_THREAD)
+static void hrt_tim_isr(void *p);
+
+/*
+ * Timer thread, runs the callouts every time the timer expires.
+ */
+static int hrt_timer_thread(int argc, char *argv[])
+{
+	// the default timer slack of 50 us applies if the thread could not get a real-time policy
+	prctl(PR_SET_TIMERSLACK, 1UL);
+
+	while (true) {
+		uint64_t expirations;
+
+		if (read(_hrt_timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+			hrt_tim_isr(nullptr);
+
+		} else if (errno != EINTR) {
+			PX4_ERR("hrt timer read failed: %s", strerror(errno));
+			return PX4_ERROR;
+		}
+	}
+
+	return PX4_OK;
+}
+#endif // HRT_TIMER_THREAD
+
 /*
  * Initialise the HRT.
  */
@@ -257,7 +328,23 @@ void	hrt_init()
 		PX4_ERR("SEM INIT FAIL: %s", strerror(errno));
 	}
 
+#if defined(HRT_TIMER_THREAD)
+	// hrt_absolute_time() is CLOCK_MONOTONIC, so the deadlines can be used as absolute timer values
+	_hrt_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+
+	if (_hrt_timer_fd < 0) {
+		PX4_ERR("timerfd_create failed: %s", strerror(errno));
+		return;
+	}
+
+	// px4_task_spawn_cmd() falls back to the default policy if not permitted to run real-time threads
+	if (px4_task_spawn_cmd("hrt", SCHED_FIFO, SCHED_PRIORITY_MAX, 2000, hrt_timer_thread, nullptr) < 0) {
+		PX4_ERR("hrt timer thread start failed");
+	}
+
+#else
 	memset(&_hrt_work, 0, sizeof(_hrt_work));
+#endif // HRT_TIMER_THREAD
 }
 
 static void
@@ -301,13 +388,15 @@ hrt_tim_isr(void *p)
 	hrt_latency_update();
 
 	/* run any callouts that have met their deadline */
-	hrt_call_invoke();
+	unsigned callouts = hrt_call_invoke();
 
 	hrt_lock();
 
 	/* and schedule the next interrupt */
 	hrt_call_reschedule();
 
+	hrt_isr_stats_update(hrt_absolute_time() - latency_actual, callouts);
+
 	hrt_unlock();
 }
 
@@ -352,6 +441,16 @@ hrt_call_reschedule()
 	/* set the new compare value and remember it for latency tracking */
 	latency_baseline = now + delay;
 
+#if defined(HRT_TIMER_THREAD)
+	// arm the timer thread at the absolute deadline, this replaces a pending expiry
+	struct itimerspec timer_value {};
+	abstime_to_ts(&timer_value.it_value, latency_baseline);
+
+	if (timerfd_settime(_hrt_timer_fd, TFD_TIMER_ABSTIME, &timer_value, nullptr) != 0) {
+		PX4_ERR("timerfd_settime failed: %s", strerror(errno));
+	}
+
+#else
 	// There is no timer ISR, so simulate one by putting an event on the
 	// high priority work queue
 
@@ -359,6 +458,7 @@ hrt_call_reschedule()
 	hrt_work_cancel(&_hrt_work);
 
 	hrt_work_queue(&_hrt_work, (worker_t)&hrt_tim_isr, nullptr, delay);
+#endif // HRT_TIMER_THREAD
 }
 
 static void
@@ -437,11 +537,12 @@ void	hrt_call_at(struct hrt_call *entry, hrt_abstime calltime, hrt_callout callo
 	hrt_call_internal(entry, calltime, 0, callout, arg);
 }
 
-static void
+static unsigned
 hrt_call_invoke()
 {
 	struct hrt_call	*call;
 	hrt_abstime deadline;
+	unsigned callouts = 0;
 
 	hrt_lock();
 
@@ -455,10 +556,21 @@ hrt_call_invoke()
 			break;
 		}
 
+#if defined(HRT_TIMER_THREAD)
+
+		// coalesce calls that are almost due, waking the thread again would take longer
+		if (call->deadline > now + HRT_COALESCE_WINDOW) {
+			break;
+		}
+
+#else
+
 		if (call->deadline > now) {
 			break;
 		}
 
+#endif // HRT_TIMER_THREAD
+
 		sq_rem(&call->link, &callout_queue);
 		//PX4_INFO("call pop");
 
@@ -475,6 +587,7 @@ hrt_call_invoke()
 
 			//PX4_INFO("call %p: %p(%p)", call, call->callout, call->arg);
 			call->callout(call->arg);
+			callouts++;
 
 			hrt_lock();
 		}
@@ -494,6 +607,8 @@ hrt_call_invoke()
 	}
 
 	hrt_unlock();
+
+	return callouts;
 }
 
 void abstime_to_ts(struct timespec *ts, hrt_abstime abstime)
@@ -536,9 +651,28 @@ int px4_clock_settime(clockid_t clk_id, const struct timespec *ts)
 
 		if (px4_timestart_monotonic == 0) {
 			px4_timestart_monotonic = time_us;
+
+			// optionally report the achieved real-time factor, PX4_LOCKSTEP_RTF is the measurement interval in seconds
+			const char *rtf_interval = getenv("PX4_LOCKSTEP_RTF");
+
+			if (rtf_interval) {
+				const float interval_s = atof(rtf_interval);
+
+				if (interval_s > 0.f) {
+					lockstep_scheduler->set_measurement_interval((uint64_t)(interval_s * 1e6f));
+				}
+			}
 		}
 
 		lockstep_scheduler->set_absolute_time(time_us);
+
+		static unsigned measurement_count = 0;
+
+		if (lockstep_scheduler->measurement_count() != measurement_count) {
+			measurement_count = lockstep_scheduler->measurement_count();
+			PX4_INFO("lockstep real-time factor: %.2f", (double)lockstep_scheduler->real_time_factor());
+		}
+
 		return 0;
 	}
 }
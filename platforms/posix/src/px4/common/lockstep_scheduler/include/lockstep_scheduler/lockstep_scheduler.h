@@ -5,6 +5,7 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <chrono>
 #include <pthread.h>
 
 class LockstepScheduler
@@ -17,6 +18,22 @@ public:
 	int cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *lock, uint64_t time_us);
 	int usleep_until(uint64_t timed_us);
 
+	/**
+	 * Enable measuring the achieved real-time factor (simulated time / wall clock time).
+	 * @param interval_us wall clock time over which the factor is measured, 0 to disable
+	 */
+	void set_measurement_interval(uint64_t interval_us) { _measurement_interval_us = interval_us; }
+
+	/**
+	 * @return real-time factor of the last completed measurement interval (0 if there is none)
+	 */
+	float real_time_factor() const { return _real_time_factor; }
+
+	/**
+	 * @return number of completed measurement intervals, can be used to detect a new measurement
+	 */
+	unsigned measurement_count() const { return _measurement_count; }
+
 private:
 	struct TimedWait {
 		~TimedWait()
@@ -37,26 +54,51 @@ private:
 			}
 
 			// If a thread quickly exits after a cond_timedwait(), the
-			// thread_local object can still be in the linked list. In that case
-			// we need to wait until it's removed.
-			while (!removed) {
-				system_usleep(5000);
+			// thread_local object can still be in the heap (a signaled wait
+			// is only removed once its time passed), so remove it now.
+			if (!removed && scheduler) {
+				scheduler->remove_timed_wait(this);
 			}
 		}
 
+		LockstepScheduler *scheduler{nullptr};
+
 		pthread_cond_t *passed_cond{nullptr};
 		pthread_mutex_t *passed_lock{nullptr};
 		uint64_t time_us{0};
+		uint64_t sequence{0}; ///< insertion order, wakes up waiters with the same time deterministically
 		bool timeout{false};
 		std::atomic<bool> done{false};
 		std::atomic<bool> removed{true};
 
-		TimedWait *next{nullptr}; ///< linked list
+		size_t heap_index{0}; ///< position in _timed_waits, valid if not removed
 	};
 
+	static bool wakes_up_before(const TimedWait *a, const TimedWait *b)
+	{
+		return (a->time_us < b->time_us) || (a->time_us == b->time_us && a->sequence < b->sequence);
+	}
+
+	// min-heap operations on _timed_waits, the caller needs to hold _timed_waits_mutex
+	void heap_sift_up(size_t index);
+	void heap_sift_down(size_t index);
+	void heap_update(TimedWait *timed_wait);
+	TimedWait *heap_pop();
+
+	void remove_timed_wait(TimedWait *timed_wait);
+
+	void update_measurement(uint64_t time_us);
+
 	std::atomic<uint64_t> _time_us{0};
 
-	TimedWait *_timed_waits{nullptr}; ///< head of linked list
+	std::vector<TimedWait *> _timed_waits{}; ///< min-heap of the waiting threads, ordered by wakeup time
+	uint64_t _sequence{0};
 	std::mutex _timed_waits_mutex;
 	std::atomic<bool> _setting_time{false}; ///< true if set_absolute_time() is currently being executed
+
+	uint64_t _measurement_interval_us{0};
+	uint64_t _measurement_start_time_us{0};
+	std::chrono::steady_clock::time_point _measurement_start{};
+	std::atomic<float> _real_time_factor{0.f};
+	std::atomic<unsigned> _measurement_count{0};
 };
@@ -2,14 +2,14 @@
 
 LockstepScheduler::~LockstepScheduler()
 {
-	// cleanup the linked list
+	// cleanup the heap
 	std::unique_lock<std::mutex> lock_timed_waits(_timed_waits_mutex);
 
-	while (_timed_waits) {
-		TimedWait *tmp = _timed_waits;
-		_timed_waits = _timed_waits->next;
-		tmp->removed = true;
+	for (TimedWait *timed_wait : _timed_waits) {
+		timed_wait->removed = true;
 	}
+
+	_timed_waits.clear();
 }
 
 void LockstepScheduler::set_absolute_time(uint64_t time_us)
@@ -20,28 +20,12 @@ void LockstepScheduler::set_absolute_time(uint64_t time_us)
 		std::unique_lock<std::mutex> lock_timed_waits(_timed_waits_mutex);
 		_setting_time = true;
 
-		TimedWait *timed_wait = _timed_waits;
-		TimedWait *timed_wait_prev = nullptr;
-
-		while (timed_wait) {
-			// Clean up the ones that are already done from last iteration.
-			if (timed_wait->done) {
-				// Erase from the linked list
-				if (timed_wait_prev) {
-					timed_wait_prev->next = timed_wait->next;
-
-				} else {
-					_timed_waits = timed_wait->next;
-				}
-
-				TimedWait *tmp = timed_wait;
-				timed_wait = timed_wait->next;
-				tmp->removed = true;
-				continue;
-			}
+		// Only the waits that are due are visited, in the order of their wakeup time. Waits that are done already
+		// (the condition got signaled before the timeout) are removed once their time has passed.
+		while (!_timed_waits.empty() && _timed_waits.front()->time_us <= time_us) {
+			TimedWait *timed_wait = heap_pop();
 
-			if (timed_wait->time_us <= time_us &&
-			    !timed_wait->timeout) {
+			if (!timed_wait->done && !timed_wait->timeout) {
 				// We are abusing the condition here to signal that the time
 				// has passed.
 				pthread_mutex_lock(timed_wait->passed_lock);
@@ -50,12 +34,13 @@ void LockstepScheduler::set_absolute_time(uint64_t time_us)
 				pthread_mutex_unlock(timed_wait->passed_lock);
 			}
 
-			timed_wait_prev = timed_wait;
-			timed_wait = timed_wait->next;
+			timed_wait->removed = true;
 		}
 
 		_setting_time = false;
 	}
+
+	update_measurement(time_us);
 }
 
 int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *lock, uint64_t time_us)
@@ -71,18 +56,16 @@ int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *loc
 			return ETIMEDOUT;
 		}
 
+		timed_wait.scheduler = this;
 		timed_wait.time_us = time_us;
+		timed_wait.sequence = _sequence++;
 		timed_wait.passed_cond = cond;
 		timed_wait.passed_lock = lock;
 		timed_wait.timeout = false;
 		timed_wait.done = false;
 
-		// Add to linked list if not removed yet (otherwise just re-use the object)
-		if (timed_wait.removed) {
-			timed_wait.removed = false;
-			timed_wait.next = _timed_waits;
-			_timed_waits = &timed_wait;
-		}
+		// Add to the heap if removed already (otherwise just move the object to its new position)
+		heap_update(&timed_wait);
 	}
 
 	int result = pthread_cond_wait(cond, lock);
@@ -132,3 +115,128 @@ int LockstepScheduler::usleep_until(uint64_t time_us)
 
 	return result;
 }
+
+void LockstepScheduler::heap_sift_up(size_t index)
+{
+	TimedWait *timed_wait = _timed_waits[index];
+
+	while (index > 0) {
+		const size_t parent = (index - 1) / 2;
+
+		if (!wakes_up_before(timed_wait, _timed_waits[parent])) {
+			break;
+		}
+
+		_timed_waits[index] = _timed_waits[parent];
+		_timed_waits[index]->heap_index = index;
+		index = parent;
+	}
+
+	_timed_waits[index] = timed_wait;
+	timed_wait->heap_index = index;
+}
+
+void LockstepScheduler::heap_sift_down(size_t index)
+{
+	const size_t size = _timed_waits.size();
+	TimedWait *timed_wait = _timed_waits[index];
+
+	while (true) {
+		size_t child = 2 * index + 1;
+
+		if (child >= size) {
+			break;
+		}
+
+		if (child + 1 < size && wakes_up_before(_timed_waits[child + 1], _timed_waits[child])) {
+			child++;
+		}
+
+		if (!wakes_up_before(_timed_waits[child], timed_wait)) {
+			break;
+		}
+
+		_timed_waits[index] = _timed_waits[child];
+		_timed_waits[index]->heap_index = index;
+		index = child;
+	}
+
+	_timed_waits[index] = timed_wait;
+	timed_wait->heap_index = index;
+}
+
+void LockstepScheduler::heap_update(TimedWait *timed_wait)
+{
+	if (timed_wait->removed) {
+		timed_wait->removed = false;
+		_timed_waits.push_back(timed_wait);
+		heap_sift_up(_timed_waits.size() - 1);
+
+	} else {
+		// the wakeup time can have moved in either direction
+		heap_sift_up(timed_wait->heap_index);
+		heap_sift_down(timed_wait->heap_index);
+	}
+}
+
+LockstepScheduler::TimedWait *LockstepScheduler::heap_pop()
+{
+	TimedWait *top = _timed_waits.front();
+	TimedWait *last = _timed_waits.back();
+	_timed_waits.pop_back();
+
+	if (!_timed_waits.empty()) {
+		_timed_waits[0] = last;
+		heap_sift_down(0);
+	}
+
+	return top;
+}
+
+void LockstepScheduler::remove_timed_wait(TimedWait *timed_wait)
+{
+	std::lock_guard<std::mutex> lock_timed_waits(_timed_waits_mutex);
+
+	// the destructor of the scheduler might have cleared the heap in the meantime
+	if (timed_wait->removed) {
+		return;
+	}
+
+	const size_t index = timed_wait->heap_index;
+	TimedWait *last = _timed_waits.back();
+	_timed_waits.pop_back();
+
+	if (last != timed_wait) {
+		_timed_waits[index] = last;
+		last->heap_index = index;
+		heap_sift_up(index);
+		heap_sift_down(last->heap_index);
+	}
+
+	timed_wait->removed = true;
+}
+
+void LockstepScheduler::update_measurement(uint64_t time_us)
+{
+	if (_measurement_interval_us == 0) {
+		return;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+
+	if (_measurement_start.time_since_epoch().count() == 0 || time_us < _measurement_start_time_us) {
+		_measurement_start = now;
+		_measurement_start_time_us = time_us;
+		return;
+	}
+
+	const uint64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(now - _measurement_start).count();
+
+	if (elapsed_us >= _measurement_interval_us) {
+		_real_time_factor = (float)(time_us - _measurement_start_time_us) / (float)elapsed_us;
+		_measurement_count++;
+
+		_measurement_start = now;
+		_measurement_start_time_us = time_us;
+	}
+}
@@ -307,6 +307,47 @@ void test_usleep()
 	thread.join(ls);
 }
 
+void test_only_due_waits_woken()
+{
+	LockstepScheduler ls;
+	ls.set_absolute_time(some_time_us);
+
+	// waits are added out of order, and two of them have the same wakeup time
+	const unsigned wakeup_times[] = {400, 100, 300, 200, 300};
+	constexpr int num_waits = sizeof(wakeup_times) / sizeof(wakeup_times[0]);
+
+	std::atomic<int> num_woken{0};
+	std::atomic<int> num_started{0};
+	std::vector<std::shared_ptr<TestThread>> threads{};
+
+	for (unsigned wakeup_time : wakeup_times) {
+		threads.push_back(std::make_shared<TestThread>([&ls, &num_woken, &num_started, wakeup_time]() {
+			++num_started;
+			EXPECT_EQ(ls.usleep_until(some_time_us + wakeup_time), 0);
+			EXPECT_GE(ls.get_absolute_time(), some_time_us + wakeup_time);
+			++num_woken;
+		}));
+	}
+
+	WAIT_FOR(num_started == num_waits);
+
+	// give the threads some time to enter the wait
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	const int expected_woken[] = {0, 1, 2, 4, 5};
+
+	for (int i = 0; i < 5; ++i) {
+		ls.set_absolute_time(some_time_us + i * 100 + 50);
+		WAIT_FOR(num_woken >= expected_woken[i]);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		EXPECT_EQ(num_woken, expected_woken[i]);
+	}
+
+	for (auto &thread : threads) {
+		thread->join(ls);
+	}
+}
+
 TEST(LockstepScheduler, All)
 {
 	for (unsigned iteration = 1; iteration <= 100; ++iteration) {
@@ -316,5 +357,6 @@ TEST(LockstepScheduler, All)
 		test_locked_semaphore_getting_unlocked();
 		test_usleep();
 		test_multiple_semaphores_waiting();
+		test_only_due_waits_woken();
 	}
 }
@@ -172,6 +172,11 @@ int main(int argc, char **argv)
 		argv[0] += path_length + strlen(prefix);
 
 		px4_daemon::Client client(instance);
+
+		if (argc == 2 && strcmp(argv[1], "--batch") == 0) {
+			return client.process_stdin();
+		}
+
 		return client.process_args(argc, (const char **)argv);
 
 	} else {
@@ -572,6 +577,8 @@ void print_usage()
 	printf("\n");
 	printf("    px4-MODULE [--instance <instance>] command using symlink.\n");
 	printf("        e.g.: px4-commander status\n");
+	printf("    px4-MODULE [--instance <instance>] --batch\n");
+	printf("        run the commands read line by line from stdin over a single connection\n");
 }
 
 bool is_server_running(int instance, bool server)
@@ -40,6 +40,7 @@
 
 #include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <string.h>
 #include <sys/types.h>
@@ -62,7 +63,7 @@ Client::Client(int instance_id) :
 {}
 
 int
-Client::process_args(const int argc, const char **argv)
+Client::_connect()
 {
 	std::string sock_path = get_socket_path(_instance_id);
 
@@ -82,6 +83,16 @@ Client::process_args(const int argc, const char **argv)
 		return -1;
 	}
 
+	return 0;
+}
+
+int
+Client::process_args(const int argc, const char **argv)
+{
+	if (_connect() != 0) {
+		return -1;
+	}
+
 	int ret = _send_cmds(argc, argv);
 
 	if (ret != 0) {
@@ -92,6 +103,54 @@ Client::process_args(const int argc, const char **argv)
 	return _listen();
 }
 
+int
+Client::process_stdin()
+{
+	if (_connect() != 0) {
+		return -1;
+	}
+
+	const uint8_t flags = CMD_FLAG_KEEP_OPEN | (isatty(STDOUT_FILENO) ? CMD_FLAG_ISATTY : 0);
+	int retval = 0;
+	char *line = nullptr;
+	size_t line_size = 0;
+	ssize_t line_length;
+
+	while ((line_length = getline(&line, &line_size, stdin)) >= 0) {
+		std::string cmd(line, line_length);
+
+		while (!cmd.empty() && (cmd.back() == '\n' || cmd.back() == '\r')) {
+			cmd.pop_back();
+		}
+
+		if (cmd.empty()) {
+			continue;
+		}
+
+		if (_send(cmd, flags) != 0) {
+			PX4_ERR("Could not send commands");
+			retval = -3;
+			break;
+		}
+
+		int ret = _listen(true);
+
+		if (ret < 0) {
+			retval = ret;
+			break;
+		}
+
+		if (ret != 0) {
+			retval = ret;
+		}
+
+		fflush(stdout);
+	}
+
+	free(line);
+	return retval;
+}
+
 int
 Client::_send_cmds(const int argc, const char **argv)
 {
@@ -107,11 +166,17 @@ Client::_send_cmds(const int argc, const char **argv)
 		}
 	}
 
-	// Last byte is 'isatty'.
-	cmd_buf.push_back(isatty(STDOUT_FILENO));
+	return _send(cmd_buf, isatty(STDOUT_FILENO) ? CMD_FLAG_ISATTY : 0);
+}
 
-	size_t n = cmd_buf.size();
-	const char *buf = cmd_buf.data();
+int
+Client::_send(std::string cmd, uint8_t flags)
+{
+	// Last byte are the flags.
+	cmd.push_back(flags);
+
+	size_t n = cmd.size();
+	const char *buf = cmd.data();
 
 	while (n > 0) {
 		int n_sent = write(_fd, buf, n);
@@ -129,7 +194,7 @@ Client::_send_cmds(const int argc, const char **argv)
 }
 
 int
-Client::_listen()
+Client::_listen(bool keep_open)
 {
 	char buffer[1024];
 	int n_buffer_used = 0;
@@ -159,6 +224,12 @@ Client::_listen()
 			if (n_read >= 2 && buffer[n_read - 2] == 0) {
 				// If the buffer ends in {0, retval}, keep it.
 				fwrite(buffer, n_read - 2, 1, stdout);
+
+				if (keep_open) {
+					// The server waits for the next command, there is no end of stream.
+					return buffer[n_read - 1];
+				}
+
 				buffer[0] = 0;
 				buffer[1] = buffer[n_read - 1];
 				n_buffer_used = 2;
@@ -36,6 +36,7 @@
  * The client can connect and write a command to the socket that is supplied by
  * the server. It will then close its half of the connection, and read back the
  * stdout stream of the process that it started, followed by its return value.
+ * In batch mode it keeps the connection open and sends one command after the other.
  *
  * It the client dies, the connection gets closed automatically and the corresponding
  * thread in the server gets cancelled.
@@ -47,6 +48,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <string>
 
 #include "sock_protocol.h"
 
@@ -76,9 +78,24 @@ public:
 	 */
 	int process_args(const int argc, const char **argv);
 
+	/**
+	 * Batch mode: read commands line by line from stdin and run them one after
+	 * the other over a single connection.
+	 *
+	 * @return 0 if all commands succeeded, otherwise the return value of the last failed command
+	 */
+	int process_stdin();
+
 private:
+	int _connect();
 	int _send_cmds(const int argc, const char **argv);
-	int _listen();
+	int _send(std::string cmd, uint8_t flags);
+
+	/**
+	 * Read the response of a command and write it to stdout.
+	 * @param keep_open true if the connection stays open after the response
+	 */
+	int _listen(bool keep_open = false);
 
 	int _fd;
 	int _instance_id; ///< instance ID for running multiple instances of the px4 server
@@ -44,6 +44,9 @@
 #include <sstream>
 #include <vector>
 #include <stdio.h>
+#include <stdlib.h>
+
+#include <px4_platform_common/namespace.h>
 
 #include "pxh.h"
 
@@ -117,6 +120,17 @@ int Pxh::process_line(const std::string &line, bool silently_fail)
 		list_builtins(_apps);
 		return 0;
 
+	} else if (command == "ns" && words.size() > 2) {
+		// run a command in the uORB namespace of another vehicle: ns <namespace> <command> [args]
+		const uint8_t ns_prev = px4::get_namespace();
+		px4::set_namespace(static_cast<uint8_t>(atoi(words[1].c_str())));
+
+		const size_t command_start = line.find(words[2], line.find(words[1]) + words[1].length());
+		const int retval = process_line(line.substr(command_start), silently_fail);
+
+		px4::set_namespace(ns_prev);
+		return retval;
+
 	} else if (command.length() == 0 || command[0] == '#') {
 		// Do nothing
 		return 0;
@@ -44,6 +44,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <string>
+#include <algorithm>
 #include <pthread.h>
 #include <poll.h>
 #include <sys/stat.h>
@@ -64,6 +65,7 @@ Server *Server::_instance = nullptr;
 
 Server::Server(int instance_id)
 	: _mutex(PTHREAD_MUTEX_INITIALIZER),
+	  _worker_cond(PTHREAD_COND_INITIALIZER),
 	  _instance_id(instance_id)
 {
 	_instance = this;
@@ -177,19 +179,10 @@ Server::_server_main()
 				// Set stream to line buffered.
 				setvbuf(thread_stdout, nullptr, _IOLBF, BUFSIZ);
 
-				// Start a new thread to handle the client.
-				pthread_t *thread = &_fd_to_thread[client];
-				ret = pthread_create(thread, nullptr, Server::_handle_client, thread_stdout);
-
-				if (ret != 0) {
-					PX4_ERR("could not start pthread (%i)", ret);
-					_fd_to_thread.erase(client);
+				if (_dispatch(thread_stdout) != 0) {
 					fclose(thread_stdout);
 
 				} else {
-					// We won't join the thread, so detach to automatically release resources at its end
-					pthread_detach(*thread);
-
 					// Start listening for the client hanging up.
 					poll_fds.push_back(pollfd {client, POLLHUP, 0});
 
@@ -210,6 +203,14 @@ Server::_server_main()
 					// TODO: use a more graceful exit method to avoid resource leaks
 					pthread_cancel(thread->second);
 					_fd_to_thread.erase(thread);
+
+				} else {
+					// The connection might not be picked up by an idle worker yet.
+					auto pending = std::find(_pending.begin(), _pending.end(), stdouts[i - 1]);
+
+					if (pending != _pending.end()) {
+						_pending.erase(pending);
+					}
 				}
 
 				fclose(stdouts[i - 1]);
@@ -227,77 +228,183 @@ Server::_server_main()
 	close(_fd);
 }
 
+int
+Server::_dispatch(FILE *client_stdout)
+{
+	if (_idle_workers > (int)_pending.size()) {
+		_pending.push_back(client_stdout);
+		pthread_cond_signal(&_worker_cond);
+		return 0;
+	}
+
+	// Start a new thread to handle the client.
+	pthread_t thread;
+	int ret = pthread_create(&thread, nullptr, Server::_worker, client_stdout);
+
+	if (ret != 0) {
+		PX4_ERR("could not start pthread (%i)", ret);
+		return ret;
+	}
+
+	_fd_to_thread[fileno(client_stdout)] = thread;
+
+	// We won't join the thread, so detach to automatically release resources at its end
+	pthread_detach(thread);
+
+	return 0;
+}
+
+FILE *
+Server::_wait_for_client()
+{
+	_lock();
+
+	if (_idle_workers >= MAX_IDLE_WORKERS) {
+		_unlock();
+		return nullptr;
+	}
+
+	++_idle_workers;
+
+	while (_pending.empty()) {
+		pthread_cond_wait(&_worker_cond, &_mutex);
+	}
+
+	--_idle_workers;
+
+	FILE *out = _pending.front();
+	_pending.pop_front();
+	_fd_to_thread[fileno(out)] = pthread_self();
+
+	_unlock();
+	return out;
+}
+
 void
-*Server::_handle_client(void *arg)
+*Server::_worker(void *arg)
 {
 	FILE *out = (FILE *)arg;
-	int fd = fileno(out);
 
-	// Read until the end of the incoming stream.
-	std::string cmd;
+	while (out) {
+		const int fd = fileno(out);
 
-	while (true) {
-		size_t n = cmd.size();
-		cmd.resize(n + 1024);
-		ssize_t n_read = read(fd, &cmd[n], cmd.size() - n);
+		pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, nullptr);
+		_handle_client(out);
 
-		if (n_read <= 0) {
-			_cleanup(fd);
-			return nullptr;
-		}
-
-		cmd.resize(n + n_read);
+		// The thread can only be cancelled while it handles a client, not while it
+		// holds the lock or waits as idle worker.
+		pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, nullptr);
 
-		// Command ends in 0x00 (no tty) or 0x01 (tty).
-		if (!cmd.empty() && cmd.back() < 2) {
+		if (!_cleanup(fd)) {
+			// The client hung up and a cancellation is pending, don't reuse this thread.
 			break;
 		}
+
+		out = _instance->_wait_for_client();
 	}
 
-	if (cmd.size() < 2) {
-		_cleanup(fd);
-		return nullptr;
+	return nullptr;
+}
+
+/**
+ * Find the end of the first command in the received data.
+ * @return position of the flags byte, or std::string::npos if the command is incomplete
+ */
+static size_t find_cmd_end(const std::string &buffer)
+{
+	for (size_t i = 0; i < buffer.size(); ++i) {
+		if ((uint8_t)buffer[i] <= CMD_FLAGS_MAX) {
+			return i;
+		}
 	}
 
-	// Last byte is 'isatty'.
-	uint8_t isatty = cmd.back();
-	cmd.pop_back();
+	return std::string::npos;
+}
+
+void
+Server::_handle_client(FILE *out)
+{
+	int fd = fileno(out);
 
 	// We register thread specific data. This is used for PX4_INFO (etc.) log calls.
 	CmdThreadSpecificData *thread_data_ptr;
 
 	if ((thread_data_ptr = (CmdThreadSpecificData *)pthread_getspecific(_instance->_key)) == nullptr) {
 		thread_data_ptr = new CmdThreadSpecificData;
-		thread_data_ptr->thread_stdout = out;
-		thread_data_ptr->is_atty = isatty;
-
 		(void)pthread_setspecific(_instance->_key, (void *)thread_data_ptr);
 	}
 
-	// Run the actual command.
-	int retval = Pxh::process_line(cmd, true);
+	thread_data_ptr->thread_stdout = out;
+	thread_data_ptr->is_atty = false;
 
-	// Report return value.
-	char buf[2] = {0, (char)retval};
+	// Received data, it can already contain (part of) the next command.
+	std::string buffer;
+	bool keep_open = true;
 
-	if (fwrite(buf, sizeof buf, 1, out) != 1) {
-		// Don't care it went wrong, as we're cleaning up anyway.
-	}
+	while (keep_open) {
+		size_t cmd_end;
 
-	// Flush the FILE*'s buffer before we shut down the connection.
-	fflush(out);
+		// Read until the end of the command.
+		while ((cmd_end = find_cmd_end(buffer)) == std::string::npos) {
+			size_t n = buffer.size();
+			buffer.resize(n + 1024);
+			ssize_t n_read = read(fd, &buffer[n], buffer.size() - n);
 
-	_cleanup(fd);
-	return nullptr;
+			if (n_read <= 0) {
+				thread_data_ptr->thread_stdout = nullptr;
+				return;
+			}
+
+			buffer.resize(n + n_read);
+		}
+
+		if (cmd_end == 0) {
+			// empty command
+			break;
+		}
+
+		const uint8_t flags = buffer[cmd_end];
+		std::string cmd = buffer.substr(0, cmd_end);
+		buffer.erase(0, cmd_end + 1);
+
+		thread_data_ptr->is_atty = flags & CMD_FLAG_ISATTY;
+		keep_open = flags & CMD_FLAG_KEEP_OPEN;
+
+		// Run the actual command.
+		int retval = Pxh::process_line(cmd, true);
+
+		// Report return value.
+		char buf[2] = {0, (char)retval};
+
+		if (fwrite(buf, sizeof buf, 1, out) != 1) {
+			// Don't care it went wrong, as we're cleaning up anyway.
+		}
+
+		// Flush the FILE*'s buffer before we shut down the connection or wait for the next command.
+		fflush(out);
+	}
+
+	thread_data_ptr->thread_stdout = nullptr;
 }
 
-void
+bool
 Server::_cleanup(int fd)
 {
 	_instance->_lock();
-	_instance->_fd_to_thread.erase(fd);
+	auto thread = _instance->_fd_to_thread.find(fd);
+	const bool registered = thread != _instance->_fd_to_thread.end() && pthread_equal(thread->second, pthread_self());
+
+	if (registered) {
+		_instance->_fd_to_thread.erase(thread);
+	}
+
 	_instance->_unlock();
 
+	if (!registered) {
+		// The main thread already closed the connection (and reuses of the fd are possible).
+		return false;
+	}
+
 	// We can't close() the fd here, since the main thread is probably
 	// polling for it: close()ing it causes a race condition.
 	// So, we only call shutdown(), which causes the main thread to register a
@@ -305,6 +412,7 @@ Server::_cleanup(int fd)
 	// We already removed this thread from _fd_to_thread, so there is no risk
 	// of the main thread trying to cancel this thread after it already exited.
 	shutdown(fd, SHUT_RDWR);
+	return true;
 }
 
 } //namespace px4_daemon
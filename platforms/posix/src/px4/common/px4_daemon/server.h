@@ -37,7 +37,12 @@
  *
  * Once a client connects it will send a command and close its side of the connection.
  * The server will return the stdout of the executing command, as well as the return
- * value to the client.
+ * value to the client. A client can also keep the connection open and send further
+ * commands after each response (see CMD_FLAG_KEEP_OPEN).
+ *
+ * Connections are handled by worker threads. Up to MAX_IDLE_WORKERS threads are kept
+ * waiting for new connections after they finished, so that most commands do not need
+ * a new thread.
  *
  * There should only every be one server running, therefore the static instance.
  * The Singleton implementation is not complete, but it should be obvious not
@@ -53,6 +58,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include <deque>
 #include <map>
 
 #include "sock_protocol.h"
@@ -90,9 +96,24 @@ public:
 		return _instance->_key;
 	}
 private:
+	static constexpr int MAX_IDLE_WORKERS = 4;
+
 	static void *_server_main_trampoline(void *arg);
 	void _server_main();
 
+	/**
+	 * Hand a new connection to an idle worker, or start a new worker.
+	 * Must be called with the lock held.
+	 * @return 0 on success
+	 */
+	int _dispatch(FILE *client_stdout);
+
+	/**
+	 * Wait as idle worker for a connection handed over by _dispatch().
+	 * @return the connection, or nullptr if there are enough idle workers already
+	 */
+	FILE *_wait_for_client();
+
 	void _lock()
 	{
 		pthread_mutex_lock(&_mutex);
@@ -103,13 +124,22 @@ private:
 		pthread_mutex_unlock(&_mutex);
 	}
 
-	static void *_handle_client(void *arg);
-	static void _cleanup(int fd);
+	static void *_worker(void *arg);
+	static void _handle_client(FILE *out);
+
+	/**
+	 * Release a connection after it was handled.
+	 * @return false if the client hung up and this thread is requested to be cancelled
+	 */
+	static bool _cleanup(int fd);
 
 	pthread_t _server_main_pthread;
 
 	std::map<int, pthread_t> _fd_to_thread;
-	pthread_mutex_t _mutex; ///< Protects _fd_to_thread.
+	std::deque<FILE *> _pending; ///< Connections handed to idle workers, but not picked up yet.
+	int _idle_workers{0};
+	pthread_mutex_t _mutex; ///< Protects _fd_to_thread, _pending and _idle_workers.
+	pthread_cond_t _worker_cond;
 
 	pthread_key_t _key;
 
@@ -37,6 +37,7 @@
  */
 #pragma once
 
+#include <stdint.h>
 #include <string>
 
 namespace px4_daemon
@@ -44,5 +45,13 @@ namespace px4_daemon
 
 std::string get_socket_path(int instance_id);
 
+/*
+ * A command is sent as text followed by a flags byte (any byte <= CMD_FLAGS_MAX ends the command).
+ * The response is the stdout of the command followed by {0, retval}.
+ */
+static constexpr uint8_t CMD_FLAG_ISATTY = 0x01;	///< stdout of the client is a terminal
+static constexpr uint8_t CMD_FLAG_KEEP_OPEN = 0x02;	///< the connection stays open for further commands after the response
+static constexpr uint8_t CMD_FLAGS_MAX = CMD_FLAG_ISATTY | CMD_FLAG_KEEP_OPEN;
+
 } // namespace px4_daemon
 
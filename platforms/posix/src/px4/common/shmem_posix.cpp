@@ -55,16 +55,14 @@
 
 //#define SHMEM_DEBUG
 
-static uint64_t update_from_shmem_prev_time = 0, update_from_shmem_current_time = 0;
-extern unsigned char *adsp_changed_index;
+using namespace time_literals;
 
-struct param_wbuf_s {
-	union param_value_u val;
-	param_t param;
-	bool unsaved;
-};
+static hrt_abstime update_from_shmem_prev_time = 0;
+static uint32_t adsp_read_seq = 0;	///< last change of the adsp applied here
+static bool adsp_applying = false;	///< a thread is applying the adsp changes
+extern unsigned char *param_journal_buffer;
 
-/*update value and param's change bit in shared memory*/
+/* add the change to the krait journal */
 void update_to_shmem(param_t param, union param_value_u value)
 {
 	if (px4muorb_param_update_to_shmem(param, (unsigned char *) &value, sizeof(value))) {
@@ -72,54 +70,73 @@ void update_to_shmem(param_t param, union param_value_u value)
 	}
 }
 
-void update_index_from_shmem(void)
+/* changes were lost, apply all the current values of the adsp (only differing values are set) */
+static void resync_from_shmem(param_apply_func_t apply)
 {
-	if (!adsp_changed_index) {
-		PX4_ERR("%s no param buffer", __FUNCTION__);
-		return;
-	}
+	const unsigned values_per_read = PARAM_BUFFER_SIZE / sizeof(union param_value_u);
+	const unsigned count = (param_count() < MAX_SHMEM_PARAMS) ? param_count() : MAX_SHMEM_PARAMS;
 
-	px4muorb_param_update_index_from_shmem(adsp_changed_index, PARAM_BUFFER_SIZE);
-}
+	PX4_WARN("param journal overflow, resync");
 
-static void update_value_from_shmem(param_t param, union param_value_u *value)
-{
-	if (px4muorb_param_update_value_from_shmem(param, (unsigned char *) value, sizeof(union param_value_u))) {
-		PX4_ERR("%s get param failed", __FUNCTION__);
+	for (unsigned first = 0; first < count; first += values_per_read) {
+		if (px4muorb_param_read_values(first, param_journal_buffer, PARAM_BUFFER_SIZE)) {
+			PX4_ERR("%s get params failed", __FUNCTION__);
+			return;
+		}
+
+		const union param_value_u *values = (const union param_value_u *) param_journal_buffer;
+
+		for (unsigned i = 0; i < values_per_read && first + i < count; i++) {
+			apply(first + i, values[i]);
+		}
 	}
 }
 
-int update_from_shmem(param_t param, union param_value_u *value)
+void update_from_shmem(param_apply_func_t apply, bool force)
 {
-	unsigned int byte_changed, bit_changed;
-	unsigned int retval = 0;
-
-	if (!adsp_changed_index) {
+	if (!param_journal_buffer) {
 		PX4_ERR("%s no param buffer", __FUNCTION__);
-		return 0;
+		return;
 	}
 
-	update_from_shmem_current_time = hrt_absolute_time();
+	// every poll is an RPC call
+	const hrt_abstime now = hrt_absolute_time();
 
-	if ((update_from_shmem_current_time - update_from_shmem_prev_time)
-	    > 1000000) { //update every 1 second
-		update_from_shmem_prev_time = update_from_shmem_current_time;
-		update_index_from_shmem();
+	if (!force && (now - update_from_shmem_prev_time < 1_s)) {
+		return;
 	}
 
-	byte_changed = param / 8;
-	bit_changed = 1 << param % 8;
-
-	if (adsp_changed_index[byte_changed] & bit_changed) {
-		update_value_from_shmem(param, value);
-		adsp_changed_index[byte_changed] &= ~bit_changed; //clear the bit
-		retval = 1;
+	if (__atomic_exchange_n(&adsp_applying, true, __ATOMIC_ACQUIRE)) {
+		// another thread is applying them right now
+		return;
 	}
 
-	//else {PX4_INFO("no change to param %s", param_name(param));}
+	update_from_shmem_prev_time = now;
+
+	int entry_count = 0;
+
+	do {
+		uint32_t next_seq = adsp_read_seq;
+
+		if (px4muorb_param_journal_read(adsp_read_seq, param_journal_buffer, PARAM_BUFFER_SIZE, &entry_count, &next_seq)) {
+			PX4_ERR("%s journal read failed", __FUNCTION__);
+			break;
+		}
+
+		adsp_read_seq = next_seq;
+
+		if (entry_count < 0) {
+			resync_from_shmem(apply);
+			continue;
+		}
+
+		const struct param_journal_entry_s *entries = (const struct param_journal_entry_s *) param_journal_buffer;
+
+		for (int i = 0; i < entry_count; i++) {
+			apply(entries[i].param, entries[i].val);
+		}
 
-	PX4_DEBUG("%s %d bit on adsp index[%d]",
-		  (retval) ? "cleared" : "unchanged", bit_changed, byte_changed);
+	} while (entry_count != 0);
 
-	return retval;
+	__atomic_store_n(&adsp_applying, false, __ATOMIC_RELEASE);
 }
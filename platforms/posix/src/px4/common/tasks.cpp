@@ -39,6 +39,7 @@
 
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/defines.h>
+#include <px4_platform_common/namespace.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -58,6 +59,7 @@
 
 #include <px4_platform_common/tasks.h>
 #include <px4_platform_common/posix.h>
+#include <systemlib/cpuload.h>
 #include <systemlib/err.h>
 
 #define MAX_CMD_LEN 100
@@ -80,6 +82,7 @@ static task_entry taskmap[PX4_MAX_TASKS] = {};
 typedef struct {
 	px4_main_t entry;
 	char name[16]; //pthread_setname_np is restricted to 16 chars
+	uint8_t ns; // namespace of the spawning thread
 	int argc;
 	char *argv[];
 	// strings are allocated after the struct data
@@ -102,6 +105,11 @@ static void *entry_adapter(void *ptr)
 		PX4_ERR("px4_task_spawn_cmd: failed to set name of thread %d %d\n", rv, errno);
 	}
 
+	cpuload_register_thread(data->name);
+
+	// tasks started from within a namespace (e.g. 'ns 1 ekf2 start') stay in it
+	px4::set_namespace(data->ns);
+
 	data->entry(data->argc, data->argv);
 	free(ptr);
 	PX4_DEBUG("Before px4_task_exit");
@@ -155,6 +163,7 @@ px4_task_t px4_task_spawn_cmd(const char *name, int scheduler, int priority, int
 	strncpy(taskdata->name, name, 16);
 	taskdata->name[15] = 0;
 	taskdata->entry = entry;
+	taskdata->ns = px4::get_namespace();
 	taskdata->argc = argc;
 
 	for (i = 0; i < argc; i++) {
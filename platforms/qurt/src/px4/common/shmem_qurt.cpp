@@ -32,43 +32,25 @@
  ****************************************************************************/
 
 #include <px4_platform_common/defines.h>
+#include <px4_platform_common/log.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <errno.h>
-#include <sys/stat.h>
-#include <atomic_ops.h>
 
 #include <parameters/param.h>
 
 #include <px4_platform_common/shmem.h>
-#include <drivers/drv_hrt.h>
 
 //#define SHMEM_DEBUG
-//#define PARAM_LOCK_DEBUG
 
-static atomic_word_t mem_lock;
+static_assert(sizeof(struct shmem_info) <= MAP_SIZE, "shmem_info too large");
 
 static unsigned char *map_base, *virt_addr;
-static uint64_t update_from_shmem_prev_time = 0, update_from_shmem_current_time = 0;
-static unsigned char krait_changed_index[MAX_SHMEM_PARAMS / 8 + 1];
+static uint32_t krait_read_seq = 0;	///< last change of krait applied here
+static bool krait_applying = false;	///< a thread is applying the krait changes
 
 struct shmem_info *shmem_info_p;
 
-// Small helper to get log2 for ints
-static unsigned log2_for_int(unsigned v)
-{
-	unsigned r = 0;
-
-	while (v >>= 1) {
-		++r;
-	}
-
-	return r;
-}
-
 struct param_wbuf_s {
 	union param_value_u val;
 	param_t param;
@@ -76,54 +58,8 @@ struct param_wbuf_s {
 };
 extern struct param_wbuf_s *param_find_changed(param_t param);
 
-int get_shmem_lock(const char *caller_file_name, int caller_line_number)
-{
-	unsigned int i = 0;
-
-#ifdef PARAM_LOCK_DEBUG
-	PX4_INFO("lock value %d before get from %s, line: %d\n", mem_lock.value, strrchr(caller_file_name, '/'),
-		 caller_line_number);
-#endif
-
-	while (!atomic_compare_and_set(&mem_lock, 1, 0)) {
-		i++;
-		usleep(1000);
-
-		if (i > 100) {
-			break;
-		}
-	}
-
-	if (i > 100) {
-		PX4_INFO("Could not get lock, file name: %s, line number: %d.\n",
-			 strrchr(caller_file_name, '/'), caller_line_number);
-		return -1;
-
-	} else {
-		PX4_DEBUG("Lock acquired, file name: %s, line number: %d\n",
-			  caller_file_name, caller_line_number);
-	}
-
-	return 0; //got the lock
-
-}
-
-void release_shmem_lock(const char *caller_file_name, int caller_line_number)
-{
-	atomic_set(&mem_lock, 1);
-
-#ifdef PARAM_LOCK_DEBUG
-	PX4_INFO("release lock, file name: %s, line number: %d.\n",
-		 strrchr(caller_file_name, '/'), caller_line_number);
-#endif
-
-	return;
-}
-
 void init_shared_memory(void)
 {
-	int i;
-
 	if (shmem_info_p) {
 		return;
 	}
@@ -139,29 +75,14 @@ void init_shared_memory(void)
 	virt_addr = map_base;
 	shmem_info_p = (struct shmem_info *) virt_addr;
 
-	atomic_init(&mem_lock, 1);
-
-	for (i = 0; i < MAX_SHMEM_PARAMS / 8 + 1; i++) {
-		shmem_info_p->krait_changed_index[i] = 0;
-	}
-
 	PX4_INFO("adsp memory mapped\n");
 }
 
 void copy_params_to_shmem(const param_info_s *param_info_base)
 {
 	param_t param;
-	unsigned int i;
-
-	if (get_shmem_lock(__FILE__, __LINE__) != 0) {
-		PX4_INFO("Could not get shmem lock\n");
-		return;
-	}
 
-	//else PX4_INFO("Got lock\n");
-
-	for (param = 0; param < param_count(); param++) {
-		//{PX4_INFO("writing to offset %d\n", (unsigned char*)(shmem_info_p->adsp_params[param].name)-(unsigned char*)shmem_info_p);}
+	for (param = 0; param < param_count() && param < MAX_SHMEM_PARAMS; param++) {
 		struct param_wbuf_s *s = param_find_changed(param);
 
 		if (s == NULL) {
@@ -183,162 +104,123 @@ void copy_params_to_shmem(const param_info_s *param_info_base)
 
 #endif
 	}
-
-	for (i = 0; i < MAX_SHMEM_PARAMS / 8 + 1; i++) {
-		shmem_info_p->adsp_changed_index[i] = 0;
-		krait_changed_index[i] = 0;
-	}
-
-	release_shmem_lock(__FILE__, __LINE__);
-	//PX4_INFO("Released lock\n");
-
 }
 
-/*update value and param's change bit in shared memory*/
-void update_to_shmem(param_t param, union param_value_u value)
+void param_journal_append(struct param_journal_s *journal, param_t param, union param_value_u value)
 {
-	unsigned int byte_changed, bit_changed;
-
-	if (!handle_in_range(param)) {
-		return;
-	}
-
-	if (get_shmem_lock(__FILE__, __LINE__) != 0) {
-		PX4_ERR("Could not get shmem lock\n");
-		return;
-	}
-
 	shmem_info_p->params_val[param] = value;
 
-	byte_changed = param / 8;
-	bit_changed = 1 << param % 8;
-	shmem_info_p->adsp_changed_index[byte_changed] |= bit_changed;
-
-	//PX4_INFO("set %d bit on adsp index[%d] to %d\n", bit_changed, byte_changed, shmem_info_p->adsp_changed_index[byte_changed]);
-
-#ifdef SHMEM_DEBUG
-
-	if (param_type(param) == PARAM_TYPE_INT32) {
-		PX4_INFO("Set value %d for param %s to shmem, set adsp index %d:%d\n", value.i, param_name(param), byte_changed,
-			 bit_changed);
-	}
-
-	else if (param_type(param) == PARAM_TYPE_FLOAT) {
-		PX4_INFO("Set value %f for param %s to shmem, set adsp index %d:%d\n", value.f, param_name(param), byte_changed,
-			 bit_changed);
-	}
+	// reserve the entry, readers stop at it until its sequence number is written
+	const uint32_t seq = __atomic_add_fetch(&journal->head, 1, __ATOMIC_ACQ_REL);
+	struct param_journal_entry_s *entry = &journal->entries[seq % PARAM_JOURNAL_SIZE];
 
-#endif
+	__atomic_store_n(&entry->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
 
-	release_shmem_lock(__FILE__, __LINE__);
+	entry->param = param;
+	entry->val = value;
 
+	__atomic_store_n(&entry->seq, seq, __ATOMIC_RELEASE);
 }
 
-void update_index_from_shmem(void)
+int param_journal_read(const struct param_journal_s *journal, uint32_t *read_seq,
+		       struct param_journal_entry_s *entries, int max_entries)
 {
-	unsigned int i;
-	param_t params[MAX_SHMEM_PARAMS / 8 + 1];
+	const uint32_t head = __atomic_load_n(&journal->head, __ATOMIC_ACQUIRE);
 
-	if (get_shmem_lock(__FILE__, __LINE__) != 0) {
-		PX4_ERR("Could not get shmem lock\n");
-		return;
+	if (head - *read_seq > PARAM_JOURNAL_SIZE) {
+		// the oldest changes are overwritten already
+		*read_seq = head;
+		return -1;
 	}
 
-	for (i = 0; i < MAX_SHMEM_PARAMS / 8 + 1; i++) {
-		// Check if any param has been changed.
-		if (krait_changed_index[i] != shmem_info_p->krait_changed_index[i]) {
+	int count = 0;
 
-			// If a param has changed, we need to find out which one.
-			// From the byte and bit that is different, we can resolve the param number.
-			unsigned bit = log2_for_int(
-					       krait_changed_index[i]
-					       ^ shmem_info_p->krait_changed_index[i]);
-			param_t param_to_get = i * 8 + bit;
+	while (*read_seq != head && count < max_entries) {
+		const uint32_t seq = *read_seq + 1;
+		const struct param_journal_entry_s *entry = &journal->entries[seq % PARAM_JOURNAL_SIZE];
 
-			// Update our krait_changed_index as well.
-			krait_changed_index[i] = shmem_info_p->krait_changed_index[i];
-			params[i] = param_to_get;
-
-		} else {
-			params[i] = 0xFFFF;
+		if (__atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE) != seq) {
+			// still being written, read it the next time
+			break;
 		}
-	}
 
-	release_shmem_lock(__FILE__, __LINE__);
+		entries[count].seq = seq;
+		entries[count].param = entry->param;
+		entries[count].val = entry->val;
 
-	// FIXME: this is a hack but it gets the param so that it gets added
-	// to the local list param_values in param_shmem.c.
-	for (i = 0; i < MAX_SHMEM_PARAMS / 8 + 1; i++) {
-		if (params[i] != 0xFFFF) {
-			int32_t dummy;
-			param_get(params[i], &dummy);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		if (__atomic_load_n(&entry->seq, __ATOMIC_RELAXED) != seq) {
+			// overwritten while it was copied
+			*read_seq = head;
+			return -1;
 		}
+
+		*read_seq = seq;
+		count++;
 	}
+
+	return count;
 }
 
-static void update_value_from_shmem(param_t param, union param_value_u *value)
+/* update value and add the change to the adsp journal */
+void update_to_shmem(param_t param, union param_value_u value)
 {
-	unsigned int byte_changed, bit_changed;
-
-	if (get_shmem_lock(__FILE__, __LINE__) != 0) {
-		PX4_ERR("Could not get shmem lock\n");
+	if (!handle_in_range(param) || param >= MAX_SHMEM_PARAMS || !shmem_info_p) {
 		return;
 	}
 
-	*value = shmem_info_p->params_val[param];
-
-	/*also clear the index since we are holding the lock*/
-	byte_changed = param / 8;
-	bit_changed = 1 << param % 8;
-	shmem_info_p->krait_changed_index[byte_changed] &= ~bit_changed;
-
-	release_shmem_lock(__FILE__, __LINE__);
+	param_journal_append(&shmem_info_p->adsp_journal, param, value);
 
 #ifdef SHMEM_DEBUG
 
 	if (param_type(param) == PARAM_TYPE_INT32) {
-		PX4_INFO("Got value %d for param %s from shmem, cleared krait index %d:%d\n", value->i, param_name(param), byte_changed,
-			 bit_changed);
+		PX4_INFO("Set value %d for param %s to shmem\n", value.i, param_name(param));
 	}
 
 	else if (param_type(param) == PARAM_TYPE_FLOAT) {
-		PX4_INFO("Got value %f for param %s from shmem, cleared krait index %d:%d\n", value->f, param_name(param), byte_changed,
-			 bit_changed);
+		PX4_INFO("Set value %f for param %s to shmem\n", value.f, param_name(param));
 	}
 
 #endif
 }
 
-int update_from_shmem(param_t param, union param_value_u *value)
+void update_from_shmem(param_apply_func_t apply, bool force)
 {
-	unsigned int byte_changed, bit_changed;
-	unsigned int retval = 0;
+	// the journal is local memory, reading it is cheap enough to do on every call
+	(void)force;
 
-	if (!handle_in_range(param) || value == NULL) {
-		return retval;
+	if (!shmem_info_p || __atomic_load_n(&shmem_info_p->krait_journal.head, __ATOMIC_ACQUIRE) == krait_read_seq) {
+		return;
 	}
 
-	update_from_shmem_current_time = hrt_absolute_time();
-
-	if ((update_from_shmem_current_time - update_from_shmem_prev_time)
-	    > 1000000) { //update every 1 second
-		update_from_shmem_prev_time = update_from_shmem_current_time;
-		update_index_from_shmem();
+	if (__atomic_exchange_n(&krait_applying, true, __ATOMIC_ACQUIRE)) {
+		// another thread is applying them right now
+		return;
 	}
 
-	byte_changed = param / 8;
-	bit_changed = 1 << param % 8;
+	struct param_journal_entry_s entries[PARAM_JOURNAL_READ_MAX];
+	int count;
 
-	if (krait_changed_index[byte_changed] & bit_changed) {
-		update_value_from_shmem(param, value);
-		krait_changed_index[byte_changed] &= ~bit_changed;
-		retval = 1;
-	}
+	while ((count = param_journal_read(&shmem_info_p->krait_journal, &krait_read_seq, entries,
+					   PARAM_JOURNAL_READ_MAX)) != 0) {
+
+		if (count < 0) {
+			// changes were lost, apply the whole table (only differing values are set)
+			PX4_WARN("param journal overflow, resync");
 
-	//else {PX4_INFO("no change to param %s\n", param_name(param));}
+			for (param_t param = 0; param < param_count() && param < MAX_SHMEM_PARAMS; param++) {
+				apply(param, shmem_info_p->params_val[param]);
+			}
 
-	PX4_DEBUG("%s %d bit on krait changed index[%d]\n",
-		  (retval) ? "cleared" : "unchanged", bit_changed, byte_changed);
+			continue;
+		}
+
+		for (int i = 0; i < count; i++) {
+			apply(entries[i].param, entries[i].val);
+		}
+	}
 
-	return retval;
+	__atomic_store_n(&krait_applying, false, __ATOMIC_RELEASE);
 }
@@ -98,6 +98,15 @@ int ADC::init()
 		return ret_cdev;
 	}
 
+	/* sample in the background if supported, otherwise every channel is converted in Run() */
+	uint32_t channels = 0;
+
+	for (unsigned i = 0; i < _channel_count; i++) {
+		channels |= 1 << _samples[i].am_channel;
+	}
+
+	_scan = (px4_arch_adc_scan_start(_base_address, channels) == 0);
+
 	// schedule regular updates
 	ScheduleOnInterval(kINTERVAL, kINTERVAL);
 
@@ -125,9 +134,23 @@ void ADC::Run()
 	lock();
 	hrt_abstime now = hrt_absolute_time();
 
-	/* scan the channel set and sample each */
-	for (unsigned i = 0; i < _channel_count; i++) {
-		_samples[i].am_data = sample(_samples[i].am_channel);
+	if (_scan) {
+		/* averaged values of the background scan, in ascending channel order like _samples */
+		uint32_t values[ADC_TOTAL_CHANNELS];
+
+		perf_begin(_sample_perf);
+		const unsigned count = px4_arch_adc_scan_read(_base_address, values, _channel_count);
+		perf_end(_sample_perf);
+
+		for (unsigned i = 0; i < count; i++) {
+			_samples[i].am_data = values[i];
+		}
+
+	} else {
+		/* scan the channel set and sample each */
+		for (unsigned i = 0; i < _channel_count; i++) {
+			_samples[i].am_data = sample(_samples[i].am_channel);
+		}
 	}
 
 	update_adc_report(now);
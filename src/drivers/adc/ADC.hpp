@@ -104,6 +104,7 @@ private:
 	unsigned			_channel_count{0};
 	const uint32_t			_base_address;
 	px4_adc_msg_t			*_samples{nullptr};	/**< sample buffer */
+	bool				_scan{false};		/**< channels are sampled in the background by the arch */
 
 	uORB::Publication<adc_report_s>		_to_adc_report{ORB_ID(adc_report)};
 	uORB::Publication<system_power_s>	_to_system_power{ORB_ID(system_power)};
@@ -77,10 +77,12 @@ CameraCapture::~CameraCapture()
 void
 CameraCapture::capture_callback(uint32_t chan_index, hrt_abstime edge_time, uint32_t edge_state, uint32_t overflow)
 {
-	_trigger.chan_index = chan_index;
-	_trigger.edge_time = edge_time;
-	_trigger.edge_state = edge_state;
-	_trigger.overflow = overflow;
+	// edge_time is latched by the timer input capture, buffer the event so that none get lost at high rates
+	const _trig_s trig{chan_index, edge_time, edge_state, overflow};
+
+	if (_trig_buffer == nullptr || !_trig_buffer->put(&trig, sizeof(trig))) {
+		_trigger_buffer_overflows++;
+	}
 
 	work_queue(HPWORK, &_work_publisher, (worker_t)&CameraCapture::publish_trigger_trampoline, this, 0);
 }
@@ -90,10 +92,11 @@ CameraCapture::gpio_interrupt_routine(int irq, void *context, void *arg)
 {
 	CameraCapture *dev = static_cast<CameraCapture *>(arg);
 
-	dev->_trigger.chan_index = 0;
-	dev->_trigger.edge_time = hrt_absolute_time();
-	dev->_trigger.edge_state = 0;
-	dev->_trigger.overflow = 0;
+	const _trig_s trig{0, hrt_absolute_time(), 0, 0};
+
+	if (dev->_trig_buffer == nullptr || !dev->_trig_buffer->put(&trig, sizeof(trig))) {
+		dev->_trigger_buffer_overflows++;
+	}
 
 	work_queue(HPWORK, &_work_publisher, (worker_t)&CameraCapture::publish_trigger_trampoline, dev, 0);
 
@@ -110,6 +113,16 @@ CameraCapture::publish_trigger_trampoline(void *arg)
 
 void
 CameraCapture::publish_trigger()
+{
+	_trig_s trig;
+
+	while (_trig_buffer != nullptr && _trig_buffer->get(&trig, sizeof(trig))) {
+		process_trigger(trig);
+	}
+}
+
+void
+CameraCapture::process_trigger(const _trig_s &trig)
 {
 	bool publish = false;
 
@@ -117,32 +130,32 @@ CameraCapture::publish_trigger()
 
 	// MODES 1 and 2 are not fully tested
 	if (_camera_capture_mode == 0 || _gpio_capture) {
-		trigger.timestamp = _trigger.edge_time - uint64_t(1000 * _strobe_delay);
+		trigger.timestamp = trig.edge_time - uint64_t(1000 * _strobe_delay);
 		trigger.seq = _capture_seq++;
 		_last_trig_time = trigger.timestamp;
 		publish = true;
 
 	} else if (_camera_capture_mode == 1) { // Get timestamp of mid-exposure (active high)
-		if (_trigger.edge_state == 1) {
-			_last_trig_begin_time = _trigger.edge_time - uint64_t(1000 * _strobe_delay);
+		if (trig.edge_state == 1) {
+			_last_trig_begin_time = trig.edge_time - uint64_t(1000 * _strobe_delay);
 
-		} else if (_trigger.edge_state == 0 && _last_trig_begin_time > 0) {
-			trigger.timestamp = _trigger.edge_time - ((_trigger.edge_time - _last_trig_begin_time) / 2);
+		} else if (trig.edge_state == 0 && _last_trig_begin_time > 0) {
+			trigger.timestamp = trig.edge_time - ((trig.edge_time - _last_trig_begin_time) / 2);
 			trigger.seq = _capture_seq++;
-			_last_exposure_time = _trigger.edge_time - _last_trig_begin_time;
+			_last_exposure_time = trig.edge_time - _last_trig_begin_time;
 			_last_trig_time = trigger.timestamp;
 			publish = true;
 			_capture_seq++;
 		}
 
 	} else { // Get timestamp of mid-exposure (active low)
-		if (_trigger.edge_state == 0) {
-			_last_trig_begin_time = _trigger.edge_time - uint64_t(1000 * _strobe_delay);
+		if (trig.edge_state == 0) {
+			_last_trig_begin_time = trig.edge_time - uint64_t(1000 * _strobe_delay);
 
-		} else if (_trigger.edge_state == 1 && _last_trig_begin_time > 0) {
-			trigger.timestamp = _trigger.edge_time - ((_trigger.edge_time - _last_trig_begin_time) / 2);
+		} else if (trig.edge_state == 1 && _last_trig_begin_time > 0) {
+			trigger.timestamp = trig.edge_time - ((trig.edge_time - _last_trig_begin_time) / 2);
 			trigger.seq = _capture_seq++;
-			_last_exposure_time = _trigger.edge_time - _last_trig_begin_time;
+			_last_exposure_time = trig.edge_time - _last_trig_begin_time;
 			_last_trig_time = trigger.timestamp;
 			publish = true;
 		}
@@ -150,7 +163,7 @@ CameraCapture::publish_trigger()
 	}
 
 	trigger.feedback = true;
-	_capture_overflows = _trigger.overflow;
+	_capture_overflows = trig.overflow;
 
 	if (!publish) {
 		return;
@@ -291,13 +304,14 @@ CameraCapture::reset_statistics(bool reset_seq)
 	_last_exposure_time = 0;
 	_last_trig_time = 0;
 	_capture_overflows = 0;
+	_trigger_buffer_overflows = 0;
 }
 
 int
 CameraCapture::start()
 {
 	/* allocate basic report buffers */
-	_trig_buffer = new ringbuffer::RingBuffer(2, sizeof(_trig_s));
+	_trig_buffer = new ringbuffer::RingBuffer(TRIGGER_BUFFER_SIZE, sizeof(_trig_s));
 
 	if (_trig_buffer == nullptr) {
 		return PX4_ERROR;
@@ -333,6 +347,7 @@ CameraCapture::status()
 	}
 
 	PX4_INFO("Number of overflows : %u", _capture_overflows);
+	PX4_INFO("Number of dropped events : %u", _trigger_buffer_overflows);
 }
 
 static int usage()
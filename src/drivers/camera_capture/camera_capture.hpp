@@ -106,18 +106,20 @@ private:
 
 	// Publishers
 	uORB::PublicationQueued<vehicle_command_ack_s>	_command_ack_pub{ORB_ID(vehicle_command_ack)};
-	uORB::Publication<camera_trigger_s>		_trigger_pub{ORB_ID(camera_trigger)};
+	uORB::PublicationQueued<camera_trigger_s>	_trigger_pub{ORB_ID(camera_trigger)};
 
 	// Subscribers
 	uORB::Subscription				_command_sub{ORB_ID(vehicle_command)};
 
-	// Trigger Buffer
+	// Trigger Buffer, filled from the capture interrupt and drained by publish_trigger()
+	static constexpr unsigned TRIGGER_BUFFER_SIZE = 16;
+
 	struct _trig_s {
 		uint32_t chan_index;
 		hrt_abstime edge_time;
 		uint32_t edge_state;
 		uint32_t overflow;
-	} _trigger{};
+	};
 
 	ringbuffer::RingBuffer	*_trig_buffer{nullptr};
 
@@ -138,10 +140,14 @@ private:
 	hrt_abstime		_last_exposure_time{0};
 	hrt_abstime		_last_trig_time{0};
 	uint32_t 		_capture_overflows{0};
+	uint32_t		_trigger_buffer_overflows{0};
 
 	// Signal capture callback
 	void			capture_callback(uint32_t chan_index, hrt_abstime edge_time, uint32_t edge_state, uint32_t overflow);
 
+	// Process a single buffered capture event
+	void			process_trigger(const _trig_s &trig);
+
 	// GPIO interrupt routine (for AV_X board)
 	static int		gpio_interrupt_routine(int irq, void *context, void *arg);
 
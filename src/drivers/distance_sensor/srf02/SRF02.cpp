@@ -35,7 +35,6 @@
 
 SRF02::SRF02(int bus, int address, uint8_t rotation) :
 	I2C("SRF02", nullptr, bus, address, 100000),
-	ScheduledWorkItem(MODULE_NAME, px4::device_bus_to_wq(get_device_id())),
 	_px4_rangefinder(0 /* device id not yet used */, ORB_PRIO_DEFAULT, rotation)
 {
 	_px4_rangefinder.set_max_distance(SRF02_MAX_DISTANCE);
@@ -44,26 +43,14 @@ SRF02::SRF02(int bus, int address, uint8_t rotation) :
 
 SRF02::~SRF02()
 {
-	stop();
+	if (_array_member) {
+		RangefinderArray::remove(this);
+	}
 
 	perf_free(_sample_perf);
 	perf_free(_comms_errors);
 }
 
-void SRF02::start()
-{
-	// Reset the report ring and state machine.
-	_collect_phase = false;
-
-	// Schedule a cycle to start things.
-	ScheduleDelayed(5);
-}
-
-void SRF02::stop()
-{
-	ScheduleClear();
-}
-
 int SRF02::init()
 {
 	// I2C init (and probe) first.
@@ -80,7 +67,13 @@ int SRF02::init()
 		return ret;
 	}
 
-	start();
+	// measurements are triggered and collected together with the other rangefinders on the bus
+	if (RangefinderArray::add(this, px4::device_bus_to_wq(get_device_id())) != PX4_OK) {
+		PX4_ERR("too many rangefinders on the bus");
+		return PX4_ERROR;
+	}
+
+	_array_member = true;
 
 	return PX4_OK;
 }
@@ -130,33 +123,6 @@ int SRF02::measure()
 	return PX4_OK;
 }
 
-void SRF02::Run()
-{
-	if (_collect_phase) {
-		// Perform collection.
-		if (OK != collect()) {
-			PX4_DEBUG("collection error");
-			// If error restart the measurement state machine.
-			start();
-			return;
-		}
-
-		// Next phase is measurement.
-		_collect_phase = false;
-	}
-
-	// Perform measurement.
-	if (OK != measure()) {
-		PX4_DEBUG("measure error sonar adress");
-	}
-
-	// Next phase is collection.
-	_collect_phase = true;
-
-	// Schedule a fresh cycle call when the measurement is done.
-	ScheduleDelayed(_interval);
-}
-
 void SRF02::print_info()
 {
 	perf_print_counter(_sample_perf);
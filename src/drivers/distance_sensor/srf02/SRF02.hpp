@@ -40,8 +40,8 @@
 #pragma once
 
 #include <px4_platform_common/px4_config.h>
-#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
 #include <lib/drivers/rangefinder/PX4Rangefinder.hpp>
+#include <lib/drivers/rangefinder/RangefinderArray.hpp>
 #include <drivers/device/i2c.h>
 #include <drivers/drv_hrt.h>
 #include <lib/perf/perf_counter.h>
@@ -62,7 +62,7 @@
 #define SRF02_CONVERSION_INTERVAL 		100000	// 60ms for one sonar.
 #define SRF02_INTERVAL_BETWEEN_SUCCESIVE_FIRES 	100000	// 30ms between each sonar measurement (watch out for interference!).
 
-class SRF02 : public device::I2C, public px4::ScheduledWorkItem
+class SRF02 : public device::I2C, public RangefinderArrayMember
 {
 public:
 	SRF02(int bus, int address = SRF02_BASEADDR, uint8_t rotation = distance_sensor_s::ROTATION_DOWNWARD_FACING);
@@ -73,11 +73,11 @@ public:
 
 private:
 
-	void Run() override;
-	void start();
-	void stop();
-	int collect();
-	int measure();
+	// RangefinderArrayMember
+	int collect() override;
+	int measure() override;
+	uint32_t conversion_time() const override { return SRF02_CONVERSION_INTERVAL; }
+	const distance_sensor_s &sample() override { return _px4_rangefinder.get(); }
 
 	/**
 	 * Test whether the device supported by the driver is present at a
@@ -89,9 +89,7 @@ private:
 
 	PX4Rangefinder _px4_rangefinder;
 
-	int _interval{SRF02_CONVERSION_INTERVAL};
-
-	bool _collect_phase{false};
+	bool _array_member{false};
 
 	perf_counter_t _comms_errors{perf_alloc(PC_COUNT, MODULE_NAME": com_err")};
 	perf_counter_t _sample_perf{perf_alloc(PC_ELAPSED,  MODULE_NAME": read")};
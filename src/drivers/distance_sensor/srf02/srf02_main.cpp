@@ -39,42 +39,53 @@
 namespace srf02
 {
 
-SRF02 *g_dev{nullptr};
+// several sensors on different addresses can be started, they share the measurement cycle of their bus
+SRF02 *g_dev[RANGE_FINDER_MAX_SENSORS] {};
 
-static int start_bus(uint8_t rotation, int i2c_bus)
+static int start_bus(uint8_t rotation, int i2c_bus, int address)
 {
-	if (g_dev != nullptr) {
-		PX4_ERR("already started");
+	int index = -1;
+
+	for (int i = 0; i < RANGE_FINDER_MAX_SENSORS; i++) {
+		if (g_dev[i] == nullptr) {
+			if (index < 0) {
+				index = i;
+			}
+
+		} else if (g_dev[i]->get_device_bus() == i2c_bus && g_dev[i]->get_device_address() == address) {
+			PX4_ERR("already started");
+			return PX4_ERROR;
+		}
+	}
+
+	if (index < 0) {
+		PX4_ERR("too many instances");
 		return PX4_ERROR;
 	}
 
 	// Create the driver.
-	g_dev = new SRF02(rotation, i2c_bus);
+	SRF02 *dev = new SRF02(i2c_bus, address, rotation);
 
-	if (g_dev == nullptr) {
+	if (dev == nullptr) {
 		PX4_ERR("failed to instantiate the device");
 		return PX4_ERROR;
 	}
 
-	if (OK != g_dev->init()) {
+	if (OK != dev->init()) {
 		PX4_ERR("failed to initialize the device");
-		delete g_dev;
-		g_dev = nullptr;
+		delete dev;
 		return -1;
 	}
 
+	g_dev[index] = dev;
+
 	return 0;
 }
 
-static int start(uint8_t rotation)
+static int start(uint8_t rotation, int address)
 {
-	if (g_dev != nullptr) {
-		PX4_WARN("already started");
-		return -1;
-	}
-
 	for (unsigned i = 0; i < NUM_I2C_BUS_OPTIONS; i++) {
-		if (start_bus(rotation, i2c_bus_options[i]) == PX4_OK) {
+		if (start_bus(rotation, i2c_bus_options[i], address) == PX4_OK) {
 			return PX4_OK;
 		}
 	}
@@ -84,26 +95,36 @@ static int start(uint8_t rotation)
 
 static int stop()
 {
-	if (g_dev != nullptr) {
-		delete g_dev;
-		g_dev = nullptr;
+	bool running = false;
 
-	} else {
-		return -1;
+	for (int i = 0; i < RANGE_FINDER_MAX_SENSORS; i++) {
+		if (g_dev[i] != nullptr) {
+			delete g_dev[i];
+			g_dev[i] = nullptr;
+			running = true;
+		}
 	}
 
-	return 0;
+	return running ? 0 : -1;
 }
 
 static int status()
 {
-	if (g_dev == nullptr) {
+	bool running = false;
+
+	for (int i = 0; i < RANGE_FINDER_MAX_SENSORS; i++) {
+		if (g_dev[i] != nullptr) {
+			PX4_INFO("bus %d, address 0x%02x", g_dev[i]->get_device_bus(), g_dev[i]->get_device_address());
+			g_dev[i]->print_info();
+			running = true;
+		}
+	}
+
+	if (!running) {
 		PX4_ERR("driver not running");
 		return -1;
 	}
 
-	g_dev->print_info();
-
 	return 0;
 }
 
@@ -113,9 +134,10 @@ static int usage()
 	PX4_INFO("options:");
 	PX4_INFO("\t-b --bus i2cbus (%d)", PX4_I2C_BUS_EXPANSION);
 	PX4_INFO("\t-a --all");
+	PX4_INFO("\t-A --address i2c address (0x%02x), start once per sensor", SRF02_BASEADDR);
 	PX4_INFO("\t-R --rotation (%d)", distance_sensor_s::ROTATION_DOWNWARD_FACING);
 	PX4_INFO("command:");
-	PX4_INFO("\tstart|stop|test|reset|info");
+	PX4_INFO("\tstart|stop|status");
 	return PX4_OK;
 }
 
@@ -125,12 +147,13 @@ extern "C" __EXPORT int srf02_main(int argc, char *argv[])
 {
 	uint8_t rotation = distance_sensor_s::ROTATION_DOWNWARD_FACING;
 	int i2c_bus = PX4_I2C_BUS_EXPANSION;
+	int address = SRF02_BASEADDR;
 	bool start_all = false;
 	int ch;
 	int myoptind = 1;
 	const char *myoptarg = nullptr;
 
-	while ((ch = px4_getopt(argc, argv, "R:ab:", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "R:aA:b:", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'R':
 			rotation = (uint8_t)atoi(myoptarg);
@@ -144,6 +167,10 @@ extern "C" __EXPORT int srf02_main(int argc, char *argv[])
 			start_all = true;
 			break;
 
+		case 'A':
+			address = strtol(myoptarg, nullptr, 0);
+			break;
+
 		default:
 			srf02::usage();
 			return -1;
@@ -157,10 +184,10 @@ extern "C" __EXPORT int srf02_main(int argc, char *argv[])
 
 	if (!strcmp(argv[myoptind], "start")) {
 		if (start_all) {
-			return srf02::start(rotation);
+			return srf02::start(rotation, address);
 
 		} else {
-			return srf02::start_bus(rotation, i2c_bus);
+			return srf02::start_bus(rotation, i2c_bus, address);
 		}
 
 	} else if (!strcmp(argv[myoptind], "stop")) {
@@ -75,7 +75,6 @@ static uint8_t crc8(uint8_t *p, uint8_t len)
 
 TERARANGER::TERARANGER(const int bus, const int address, const uint8_t rotation) :
 	I2C("TERARANGER", nullptr, bus, address, 100000),
-	ScheduledWorkItem(MODULE_NAME, px4::device_bus_to_wq(get_device_id())),
 	_px4_rangefinder(0 /* device id not yet used */, ORB_PRIO_DEFAULT, rotation)
 {
 	// up the retries since the device misses the first measure attempts
@@ -84,7 +83,9 @@ TERARANGER::TERARANGER(const int bus, const int address, const uint8_t rotation)
 
 TERARANGER::~TERARANGER()
 {
-	stop();
+	if (_array_member) {
+		RangefinderArray::remove(this);
+	}
 
 	perf_free(_sample_perf);
 	perf_free(_comms_errors);
@@ -211,7 +212,13 @@ int TERARANGER::init()
 		return PX4_ERROR;
 	}
 
-	start();
+	// measurements are triggered and collected together with the other rangefinders on the bus
+	if (RangefinderArray::add(this, px4::device_bus_to_wq(get_device_id())) != PX4_OK) {
+		PX4_ERR("too many rangefinders on the bus");
+		return PX4_ERROR;
+	}
+
+	_array_member = true;
 
 	return PX4_OK;
 }
@@ -253,25 +260,6 @@ int TERARANGER::probe()
 	return -EIO;
 }
 
-void TERARANGER::Run()
-{
-	// Perform data collection.
-	collect();
-}
-
-void TERARANGER::start()
-{
-	_collect_phase = false;
-
-	// Schedule the driver to run on a set interval
-	ScheduleOnInterval(TERARANGER_MEASUREMENT_INTERVAL);
-}
-
-void TERARANGER::stop()
-{
-	ScheduleClear();
-}
-
 void TERARANGER::print_info()
 {
 	perf_print_counter(_sample_perf);
@@ -42,8 +42,8 @@
 
 #include <drivers/device/i2c.h>
 #include <px4_platform_common/px4_config.h>
-#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
 #include <lib/drivers/rangefinder/PX4Rangefinder.hpp>
+#include <lib/drivers/rangefinder/RangefinderArray.hpp>
 #include <lib/perf/perf_counter.h>
 
 using namespace time_literals;
@@ -72,7 +72,7 @@ using namespace time_literals;
 
 #define TERARANGER_MEASUREMENT_INTERVAL         10_ms
 
-class TERARANGER : public device::I2C, public px4::ScheduledWorkItem
+class TERARANGER : public device::I2C, public RangefinderArrayMember
 {
 public:
 	TERARANGER(const int bus, const int address = TERARANGER_ONE_BASEADDR,
@@ -88,10 +88,11 @@ protected:
 
 private:
 
-	void start();
-	void stop();
-	int collect();
-	int measure();
+	// RangefinderArrayMember
+	int collect() override;
+	int measure() override;
+	uint32_t conversion_time() const override { return TERARANGER_MEASUREMENT_INTERVAL; }
+	const distance_sensor_s &sample() override { return _px4_rangefinder.get(); }
 
 	/**
 	* Test whether the device supported by the driver is present at a
@@ -102,10 +103,9 @@ private:
 	*/
 	int probe_address(const uint8_t address);
 
-	void Run() override;
-
 	PX4Rangefinder _px4_rangefinder;
 
+	bool _array_member{false};
 	bool _collect_phase{false};
 
 	perf_counter_t _comms_errors{perf_alloc(PC_COUNT, MODULE_NAME": comm_err")};
@@ -82,6 +82,24 @@ void px4_arch_adc_uninit(uint32_t base_address);
  */
 uint32_t px4_arch_adc_sample(uint32_t base_address, unsigned channel);
 
+/**
+ * Start sampling a set of channels continuously in the background (e.g. DMA driven scan).
+ * While running, px4_arch_adc_sample() must not be used on the same ADC.
+ * @param base_address architecture-specific address to specify the ADC
+ * @param channels bitmask of the channels to sample
+ * @return 0 on success, <0 error otherwise (-ENOTSUP if not supported by the architecture or board)
+ */
+int px4_arch_adc_scan_start(uint32_t base_address, uint32_t channels);
+
+/**
+ * Read the latest values of a background scan, each averaged over several conversions
+ * @param base_address architecture-specific address to specify the ADC
+ * @param values output values, in ascending channel order
+ * @param max_values size of values
+ * @return number of values written, 0 if no scan is running
+ */
+unsigned px4_arch_adc_scan_read(uint32_t base_address, uint32_t values[], unsigned max_values);
+
 /**
  * Get the temperature sensor channel bitmask
  */
@@ -76,6 +76,9 @@ typedef struct hrt_call {
 	hrt_abstime		period;
 	hrt_callout		callout;
 	void			*arg;
+
+	uint16_t		heap_index;	/**< position in the callout heap (NuttX), only valid while queued */
+	uint32_t		sequence;	/**< insertion order of calls with equal deadlines (NuttX) */
 } *hrt_call_t;
 
 /**
@@ -78,6 +78,12 @@
  */
 #define MIXERIOCLOADBUF		_MIXERIOC(5)
 
+/**
+ * Add mixer(s) from the precompiled binary mixer blob in (const void *)arg,
+ * see lib/mixer/Mixer/MixerBinary.hpp
+ */
+#define MIXERIOCLOADBIN		_MIXERIOC(6)
+
 /*
  * XXX Thoughts for additional operations:
  *
@@ -427,9 +427,10 @@ __EXPORT extern servo_position_t up_pwm_servo_get(unsigned channel);
  *			This allows some of the channels to remain configured
  *			as GPIOs or as another function.
  * @param	dshot_pwm_freq is frequency of DSHOT signal. Usually DSHOT1200, DSHOT600, DSHOT300 or DSHOT150
+ * @param	enable_bidirectional_dshot	Invert the outputs and capture the eRPM reply of the ESCs after each frame.
  * @return	OK on success.
  */
-__EXPORT extern int up_dshot_init(uint32_t channel_mask, unsigned dshot_pwm_freq);
+__EXPORT extern int up_dshot_init(uint32_t channel_mask, unsigned dshot_pwm_freq, bool enable_bidirectional_dshot);
 
 /**
  * Set the current dshot throttle value for a channel (motor).
@@ -464,4 +465,18 @@ __EXPORT extern void up_dshot_trigger(void);
  */
 __EXPORT extern int up_dshot_arm(bool armed);
 
+/**
+ * Get the eRPM of a channel (motor) captured after the last bidirectional DShot frame.
+ *
+ * @param channel	The channel to read.
+ * @param erpm		Electrical RPM (RPM * motor pole pairs)
+ * @return		0 if a new value was captured, -1 otherwise
+ */
+__EXPORT extern int up_bdshot_get_erpm(uint8_t channel, int *erpm);
+
+/**
+ * Print the bidirectional DShot capture statistics.
+ */
+__EXPORT extern void up_bdshot_status(void);
+
 __END_DECLS
@@ -160,7 +160,7 @@ public:
 
 	void retrieveAndPrintESCInfoThreadSafe(int motor_index);
 
-	bool telemetryEnabled() const { return _telemetry != nullptr; }
+	bool telemetryEnabled() const { return _telemetry.enabled(); }
 
 private:
 
@@ -185,27 +185,19 @@ private:
 		void clear() { num_repetitions = 0; }
 	};
 
-	struct Telemetry {
-		DShotTelemetry handler;
-		uORB::PublicationData<esc_status_s> esc_status_pub{ORB_ID(esc_status)};
-		int last_motor_index{-1};
-	};
-
 	void updateTelemetryNumMotors();
-	void initTelemetry(const char *device);
-	void handleNewTelemetryData(int motor_index, const DShotTelemetry::EscData &data);
 
-	int requestESCInfo();
+	/** store the per-motor RPM captured with bidirectional DShot (the reply to the previous frame) */
+	void captureBidirectionalRpm();
 
 	MixingOutput _mixing_output{DIRECT_PWM_OUTPUT_CHANNELS, *this, MixingOutput::SchedulingPolicy::Auto, false, false};
 
-	Telemetry *_telemetry{nullptr};
+	DShotTelemetryWorker _telemetry;
+	DShotTelemetryWorker::OutputState _telemetry_output_state{};
+	bool _bidirectional_dshot_enabled{false};
 	static char _telemetry_device[20];
 	static px4::atomic_bool _request_telemetry_init;
 
-	px4::atomic<DShotTelemetry::OutputBuffer *> _request_esc_info{nullptr};
-	bool _waiting_for_esc_info{false};
-
 	Mode		_mode{MODE_NONE};
 
 	uORB::Subscription _param_sub{ORB_ID(parameter_update)};
@@ -237,7 +229,8 @@ private:
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::DSHOT_CONFIG>) _param_dshot_config,
 		(ParamFloat<px4::params::DSHOT_MIN>) _param_dshot_min,
-		(ParamInt<px4::params::MOT_POLE_COUNT>) _param_mot_pole_count
+		(ParamInt<px4::params::MOT_POLE_COUNT>) _param_mot_pole_count,
+		(ParamBool<px4::params::DSHOT_BIDIR_EN>) _param_dshot_bidir_en
 	)
 };
 
@@ -263,8 +256,9 @@ DShotOutput::~DShotOutput()
 	/* clean up the alternate device node */
 	unregister_class_devname(PWM_OUTPUT_BASE_DEVICE_PATH, _class_instance);
 
+	_telemetry.ScheduleClear();
+
 	perf_free(_cycle_perf);
-	delete _telemetry;
 }
 
 int
@@ -530,13 +524,14 @@ DShotOutput::update_dshot_out_state(bool on)
 			break;
 		}
 
-		int ret = up_dshot_init(_output_mask, dshot_frequency);
+		int ret = up_dshot_init(_output_mask, dshot_frequency, _param_dshot_bidir_en.get());
 
 		if (ret != 0) {
 			PX4_ERR("up_dshot_init failed (%i)", ret);
 			return;
 		}
 
+		_bidirectional_dshot_enabled = _param_dshot_bidir_en.get();
 		_outputs_initialized = true;
 	}
 
@@ -548,71 +543,33 @@ DShotOutput::update_dshot_out_state(bool on)
 
 void DShotOutput::updateTelemetryNumMotors()
 {
-	if (!_telemetry) {
-		return;
-	}
-
 	int motor_count = 0;
 
 	if (_mixing_output.mixers()) {
 		motor_count = _mixing_output.mixers()->get_multirotor_count();
 	}
 
-	_telemetry->handler.setNumMotors(motor_count);
+	_telemetry_output_state.num_motors = motor_count;
 }
 
-void DShotOutput::initTelemetry(const char *device)
+void DShotOutput::captureBidirectionalRpm()
 {
-	if (!_telemetry) {
-		_telemetry = new Telemetry{};
-
-		if (!_telemetry) {
-			PX4_ERR("alloc failed");
-			return;
-		}
-	}
+	const int pole_pairs = math::max(_param_mot_pole_count.get() / 2, 1);
+	const int motor_count = math::min(_telemetry_output_state.num_motors, (int)esc_status_s::CONNECTED_ESC_MAX);
 
-	int ret = _telemetry->handler.init(device);
+	_telemetry_output_state.bidirectional = true;
+	_telemetry_output_state.rpm_timestamp = hrt_absolute_time();
+	_telemetry_output_state.rpm_valid_mask = 0;
 
-	if (ret != 0) {
-		PX4_ERR("telemetry init failed (%i)", ret);
-	}
+	for (int motor_index = 0; motor_index < motor_count; motor_index++) {
+		int erpm;
 
-	updateTelemetryNumMotors();
-}
-
-void DShotOutput::handleNewTelemetryData(int motor_index, const DShotTelemetry::EscData &data)
-{
-	// fill in new motor data
-	esc_status_s &esc_status = _telemetry->esc_status_pub.get();
-
-	if (motor_index < esc_status_s::CONNECTED_ESC_MAX) {
-		esc_status.esc_online_flags |= 1 << motor_index;
-		esc_status.esc[motor_index].timestamp = data.time;
-		esc_status.esc[motor_index].esc_rpm = ((int)data.erpm * 100) / (_param_mot_pole_count.get() / 2);
-		esc_status.esc[motor_index].esc_voltage = (float)data.voltage * 0.01f;
-		esc_status.esc[motor_index].esc_current = (float)data.current * 0.01f;
-		esc_status.esc[motor_index].esc_temperature = data.temperature;
-		// TODO: accumulate consumption and use for battery estimation
-	}
-
-	// publish when motor index wraps (which is robust against motor timeouts)
-	if (motor_index <= _telemetry->last_motor_index) {
-		esc_status.timestamp = hrt_absolute_time();
-		esc_status.esc_connectiontype = esc_status_s::ESC_CONNECTION_TYPE_DSHOT;
-		esc_status.esc_count = _telemetry->handler.numMotors();
-		++esc_status.counter;
-		// FIXME: mark all ESC's as online, otherwise commander complains even for a single dropout
-		esc_status.esc_online_flags = (1 << esc_status.esc_count) - 1;
-
-		_telemetry->esc_status_pub.update();
-
-		// reset esc data (in case a motor times out, so we won't send stale data)
-		memset(&esc_status.esc, 0, sizeof(_telemetry->esc_status_pub.get().esc));
-		esc_status.esc_online_flags = 0;
+		// the reply to the previous frame
+		if (up_bdshot_get_erpm(_mixing_output.reorderedMotorIndex(motor_index), &erpm) == 0) {
+			_telemetry_output_state.rpm[motor_index] = erpm / pole_pairs;
+			_telemetry_output_state.rpm_valid_mask |= 1 << motor_index;
+		}
 	}
-
-	_telemetry->last_motor_index = motor_index;
 }
 
 int DShotOutput::sendCommandThreadSafe(dshot_command_t command, int num_repetitions, int motor_index)
@@ -640,26 +597,10 @@ int DShotOutput::sendCommandThreadSafe(dshot_command_t command, int num_repetiti
 
 void DShotOutput::retrieveAndPrintESCInfoThreadSafe(int motor_index)
 {
-	if (_request_esc_info.load() != nullptr) {
-		// already in progress (not expected to ever happen)
-		return;
-	}
-
 	DShotTelemetry::OutputBuffer output_buffer;
 	output_buffer.motor_index = motor_index;
-	// start the request
-	_request_esc_info.store(&output_buffer);
-
-	// wait until processed
-	int max_time = 1000;
-
-	while (_request_esc_info.load() != nullptr && max_time-- > 0) {
-		px4_usleep(1000);
-	}
 
-	_request_esc_info.store(nullptr); // just in case we time out...
-
-	if (output_buffer.buf_pos == 0) {
+	if (!_telemetry.retrieveEscInfo(output_buffer)) {
 		PX4_ERR("No data received. If telemetry is setup correctly, try again");
 		return;
 	}
@@ -667,18 +608,6 @@ void DShotOutput::retrieveAndPrintESCInfoThreadSafe(int motor_index)
 	DShotTelemetry::decodeAndPrintEscInfoPacket(output_buffer);
 }
 
-int DShotOutput::requestESCInfo()
-{
-	_telemetry->handler.redirectOutput(*_request_esc_info.load());
-	_waiting_for_esc_info = true;
-	int motor_index = _mixing_output.reorderedMotorIndex(_request_esc_info.load()->motor_index);
-	_current_command.motor_mask = 1 << motor_index;
-	_current_command.num_repetitions = 1;
-	_current_command.command = DShot_cmd_esc_info;
-	PX4_DEBUG("Requesting ESC info for motor %i", motor_index);
-	return motor_index;
-}
-
 void DShotOutput::mixerChanged()
 {
 	updateTelemetryNumMotors();
@@ -693,14 +622,19 @@ bool DShotOutput::updateOutputs(bool stop_motors, uint16_t outputs[MAX_ACTUATORS
 
 	int requested_telemetry_index = -1;
 
-	if (_telemetry) {
-		// check for an ESC info request. We only process it when we're not expecting other telemetry data
-		if (_request_esc_info.load() != nullptr && !_waiting_for_esc_info && stop_motors
-		    && !_telemetry->handler.expectingData() && !_current_command.valid()) {
-			requested_telemetry_index = requestESCInfo();
+	if (_telemetry.enabled()) {
+		// ESC info requests are only sent while the motors are stopped, otherwise they time out in the telemetry worker
+		const int esc_info_index = (stop_motors && !_current_command.valid()) ? _telemetry.takeEscInfoRequest() : -1;
+
+		if (esc_info_index >= 0) {
+			requested_telemetry_index = _mixing_output.reorderedMotorIndex(esc_info_index);
+			_current_command.motor_mask = 1 << requested_telemetry_index;
+			_current_command.num_repetitions = 1;
+			_current_command.command = DShot_cmd_esc_info;
+			PX4_DEBUG("Requesting ESC info for motor %i", requested_telemetry_index);
 
 		} else {
-			requested_telemetry_index = _mixing_output.reorderedMotorIndex(_telemetry->handler.getRequestMotorIndex());
+			requested_telemetry_index = _mixing_output.reorderedMotorIndex(_telemetry.takeRequestMotorIndex());
 		}
 	}
 
@@ -736,6 +670,10 @@ bool DShotOutput::updateOutputs(bool stop_motors, uint16_t outputs[MAX_ACTUATORS
 	}
 
 	if (stop_motors || num_control_groups_updated > 0) {
+		if (_bidirectional_dshot_enabled) {
+			captureBidirectionalRpm();
+		}
+
 		up_dshot_trigger();
 	}
 
@@ -764,19 +702,12 @@ DShotOutput::Run()
 		update_dshot_out_state(outputs_on);
 	}
 
-	if (_telemetry) {
-		int telem_update = _telemetry->handler.update();
-
-		// Are we waiting for ESC info?
-		if (_waiting_for_esc_info) {
-			if (telem_update != -1) {
-				_request_esc_info.store(nullptr);
-				_waiting_for_esc_info = false;
-			}
-
-		} else if (telem_update >= 0) {
-			handleNewTelemetryData(telem_update, _telemetry->handler.latestESCData());
-		}
+	// hand over to the telemetry worker, the UART is read and decoded on its own (lower priority) work queue
+	if (_bidirectional_dshot_enabled || _telemetry.enabled()) {
+		_telemetry_output_state.pole_pairs = math::max(_param_mot_pole_count.get() / 2, 1);
+		_telemetry.publishOutputState(_telemetry_output_state);
+		_telemetry_output_state.bidirectional = false;
+		_telemetry_output_state.rpm_valid_mask = 0;
 	}
 
 	if (_param_sub.updated()) {
@@ -785,7 +716,8 @@ DShotOutput::Run()
 
 	// telemetry device update request?
 	if (_request_telemetry_init.load()) {
-		initTelemetry(_telemetry_device);
+		updateTelemetryNumMotors();
+		_telemetry.requestInit(_telemetry_device);
 		_request_telemetry_init.store(false);
 	}
 
@@ -1072,6 +1004,11 @@ DShotOutput::pwm_ioctl(file *filp, int cmd, unsigned long arg)
 			break;
 		}
 
+	case MIXERIOCLOADBIN:
+		ret = _mixing_output.loadMixerBinaryThreadSafe((const void *)arg);
+
+		break;
+
 	default:
 		ret = -ENOTTY;
 		break;
@@ -1588,10 +1525,9 @@ int DShotOutput::print_status()
 	perf_print_counter(_cycle_perf);
 	_mixing_output.printStatus();
 
-	if (_telemetry) {
-		PX4_INFO("telemetry on: %s", _telemetry_device);
-		_telemetry->handler.printStatus();
-	}
+	_telemetry.printStatus();
+
+	up_bdshot_status();
 
 	return 0;
 }
@@ -1611,6 +1547,8 @@ to use DShot as ESC communication protocol instead of PWM.
 It supports:
 - DShot150, DShot300, DShot600, DShot1200
 - telemetry via separate UART and publishing as esc_status message
+- bidirectional DShot (DSHOT_BIDIR_EN): the eRPM of each motor is captured after every frame and published as
+  esc_status message at the output rate
 - sending DShot commands via CLI
 
 ### Examples
@@ -33,12 +33,15 @@
 
 #include "telemetry.h"
 
+#include <lib/mathlib/mathlib.h>
 #include <px4_platform_common/log.h>
+#include <px4_platform_common/posix.h>
 
 #include <unistd.h>
 #include <fcntl.h>
 #include <termios.h>
 #include <errno.h>
+#include <string.h>
 
 using namespace time_literals;
 
@@ -473,3 +476,197 @@ int DShotTelemetry::setBaudrate(unsigned baud)
 	return 0;
 }
 
+
+DShotTelemetryWorker::DShotTelemetryWorker() :
+	ScheduledWorkItem("dshot_telemetry", px4::wq_configurations::lp_default)
+{
+}
+
+void DShotTelemetryWorker::requestInit(const char *uart_device)
+{
+	strncpy(_device, uart_device, sizeof(_device) - 1);
+	_device[sizeof(_device) - 1] = '\0';
+	_request_init.store(true);
+	ScheduleNow();
+}
+
+bool DShotTelemetryWorker::retrieveEscInfo(DShotTelemetry::OutputBuffer &buffer)
+{
+	DShotTelemetry::OutputBuffer *expected = nullptr;
+
+	if (!_esc_info_request.compare_exchange(&expected, &buffer)) {
+		// already in progress (not expected to ever happen)
+		return false;
+	}
+
+	ScheduleNow();
+
+	// wait until processed
+	int max_time = 1000;
+
+	while (_esc_info_request.load() != nullptr && max_time-- > 0) {
+		px4_usleep(1000);
+	}
+
+	_esc_info_request.store(nullptr); // just in case we time out...
+
+	return buffer.buf_pos > 0;
+}
+
+void DShotTelemetryWorker::Run()
+{
+	if (_output_state.update()) {
+		const OutputState &state = _output_state.front();
+
+		if (state.num_motors != _num_motors) {
+			_num_motors = state.num_motors;
+			_handler.setNumMotors(_num_motors);
+		}
+
+		if (state.bidirectional) {
+			publishBidirectionalRpm(state);
+		}
+	}
+
+	if (_enabled.load() && _num_motors > 0) {
+		const int telem_update = _handler.update();
+
+		if (_esc_info_active) {
+			// the ESC info is complete when the buffer is full or on timeout
+			if (telem_update != -1) {
+				_esc_info_motor_index.store(-1);
+				_esc_info_active = false;
+				_esc_info_request.store(nullptr);
+			}
+
+		} else {
+			if (telem_update == -2) {
+				// timeout: withdraw the request if the output driver did not send it yet
+				int expected = _requested_motor_index;
+				_request_motor_index.compare_exchange(&expected, -1);
+
+			} else if (telem_update >= 0) {
+				handleNewTelemetryData(telem_update, _handler.latestESCData());
+			}
+
+			DShotTelemetry::OutputBuffer *esc_info = _esc_info_request.load();
+
+			if (esc_info != nullptr && !_handler.expectingData()) {
+				// the response to the ESC info command is stored into the buffer of the requester
+				if (_handler.redirectOutput(*esc_info) == 0) {
+					_esc_info_active = true;
+					_esc_info_motor_index.store(esc_info->motor_index);
+				}
+
+			} else {
+				const int motor_index = _handler.getRequestMotorIndex();
+
+				if (motor_index >= 0) {
+					_requested_motor_index = motor_index;
+					_request_motor_index.store(motor_index);
+				}
+			}
+		}
+	}
+
+	if (_request_init.load()) {
+		_enabled.store(false);
+		_request_motor_index.store(-1);
+
+		int ret = _handler.init(_device);
+
+		if (ret != 0) {
+			PX4_ERR("telemetry init failed (%i)", ret);
+
+		} else {
+			_handler.setNumMotors(_num_motors);
+			_enabled.store(true);
+		}
+
+		_request_init.store(false);
+
+		// continue on the work queue of the serial port (at the end of the cycle)
+		ChangeWorkQeue(px4::serial_port_to_wq(_device));
+	}
+}
+
+void DShotTelemetryWorker::handleNewTelemetryData(int motor_index, const DShotTelemetry::EscData &data)
+{
+	const OutputState &state = _output_state.front();
+
+	// fill in new motor data
+	esc_status_s &esc_status = _esc_status_pub.get();
+
+	if (state.bidirectional) {
+		// the RPM is captured with every frame and published by publishBidirectionalRpm()
+		if (motor_index < esc_status_s::CONNECTED_ESC_MAX) {
+			esc_status.esc[motor_index].esc_voltage = (float)data.voltage * 0.01f;
+			esc_status.esc[motor_index].esc_current = (float)data.current * 0.01f;
+			esc_status.esc[motor_index].esc_temperature = data.temperature;
+		}
+
+		return;
+	}
+
+	if (motor_index < esc_status_s::CONNECTED_ESC_MAX) {
+		esc_status.esc_online_flags |= 1 << motor_index;
+		esc_status.esc[motor_index].timestamp = data.time;
+		esc_status.esc[motor_index].esc_rpm = ((int)data.erpm * 100) / state.pole_pairs;
+		esc_status.esc[motor_index].esc_voltage = (float)data.voltage * 0.01f;
+		esc_status.esc[motor_index].esc_current = (float)data.current * 0.01f;
+		esc_status.esc[motor_index].esc_temperature = data.temperature;
+		// TODO: accumulate consumption and use for battery estimation
+	}
+
+	// publish when motor index wraps (which is robust against motor timeouts)
+	if (motor_index <= _last_motor_index) {
+		esc_status.timestamp = hrt_absolute_time();
+		esc_status.esc_connectiontype = esc_status_s::ESC_CONNECTION_TYPE_DSHOT;
+		esc_status.esc_count = _handler.numMotors();
+		++esc_status.counter;
+		// FIXME: mark all ESC's as online, otherwise commander complains even for a single dropout
+		esc_status.esc_online_flags = (1 << esc_status.esc_count) - 1;
+
+		_esc_status_pub.update();
+
+		// reset esc data (in case a motor times out, so we won't send stale data)
+		memset(&esc_status.esc, 0, sizeof(_esc_status_pub.get().esc));
+		esc_status.esc_online_flags = 0;
+	}
+
+	_last_motor_index = motor_index;
+}
+
+void DShotTelemetryWorker::publishBidirectionalRpm(const OutputState &state)
+{
+	esc_status_s &esc_status = _esc_status_pub.get();
+	const int motor_count = math::min(state.num_motors, (int)esc_status_s::CONNECTED_ESC_MAX);
+
+	esc_status.esc_online_flags = 0;
+
+	for (int motor_index = 0; motor_index < motor_count; motor_index++) {
+		if (state.rpm_valid_mask & (1 << motor_index)) {
+			esc_status.esc[motor_index].timestamp = state.rpm_timestamp;
+			esc_status.esc[motor_index].esc_rpm = state.rpm[motor_index];
+		}
+
+		if (state.rpm_timestamp - esc_status.esc[motor_index].timestamp < 100_ms) {
+			esc_status.esc_online_flags |= 1 << motor_index;
+		}
+	}
+
+	esc_status.timestamp = hrt_absolute_time();
+	esc_status.esc_connectiontype = esc_status_s::ESC_CONNECTION_TYPE_DSHOT;
+	esc_status.esc_count = motor_count;
+	++esc_status.counter;
+
+	_esc_status_pub.update();
+}
+
+void DShotTelemetryWorker::printStatus() const
+{
+	if (_enabled.load()) {
+		PX4_INFO("telemetry on: %s", _device);
+		_handler.printStatus();
+	}
+}
@@ -33,7 +33,12 @@
 
 #pragma once
 
+#include <containers/TripleBuffer.hpp>
 #include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/topics/esc_status.h>
 
 class DShotTelemetry
 {
@@ -141,3 +146,90 @@ private:
 	int _num_timeouts{0};
 	int _num_successful_responses{0};
 };
+
+/**
+ * ESC telemetry work item.
+ *
+ * Reads and decodes the telemetry UART and publishes esc_status on a lower priority work queue
+ * than the output driver. The output driver only exchanges data with it through lock-free
+ * single-writer slots, so telemetry bursts cannot delay the motor updates:
+ * - output driver -> telemetry: OutputState (motor count, bidirectional DShot RPM), once per cycle
+ * - telemetry -> output driver: the motor to set the telemetry request bit for, ESC info requests
+ */
+class DShotTelemetryWorker : public px4::ScheduledWorkItem
+{
+public:
+	struct OutputState {
+		int num_motors{0};
+		int pole_pairs{1};
+		bool bidirectional{false};
+		hrt_abstime rpm_timestamp{0};
+		uint8_t rpm_valid_mask{0};			///< motors with a new bidirectional DShot RPM
+		int32_t rpm[esc_status_s::CONNECTED_ESC_MAX] {};
+	};
+
+	DShotTelemetryWorker();
+	~DShotTelemetryWorker() override = default;
+
+	/**
+	 * Open the telemetry UART (done asynchronously by the work item). Any thread.
+	 */
+	void requestInit(const char *uart_device);
+
+	bool enabled() const { return _enabled.load(); }
+
+	/**
+	 * Output driver: hand over the output state and wake up the work item. Never blocks.
+	 */
+	void publishOutputState(const OutputState &state)
+	{
+		_output_state.back() = state;
+		_output_state.publish();
+		ScheduleNow();
+	}
+
+	/**
+	 * Output driver: motor to request telemetry from with the next frame.
+	 * @return motor index (before reordering), -1 for none
+	 */
+	int takeRequestMotorIndex() { return _request_motor_index.exchange(-1); }
+
+	/**
+	 * Output driver: motor to send the ESC info command to (only while the motors are stopped).
+	 * @return motor index (before reordering), -1 for none
+	 */
+	int takeEscInfoRequest() { return _esc_info_motor_index.exchange(-1); }
+
+	/**
+	 * Request the ESC info of a motor and wait for it. Any thread except the work queues involved.
+	 * @return true if data was received into buffer
+	 */
+	bool retrieveEscInfo(DShotTelemetry::OutputBuffer &buffer);
+
+	void printStatus() const;
+
+private:
+	void Run() override;
+
+	void handleNewTelemetryData(int motor_index, const DShotTelemetry::EscData &data);
+	void publishBidirectionalRpm(const OutputState &state);
+
+	DShotTelemetry _handler;
+	int _last_motor_index{-1};
+
+	TripleBuffer<OutputState> _output_state;
+	int _num_motors{0};
+
+	char _device[20] {};
+	px4::atomic_bool _request_init{false};
+	px4::atomic_bool _enabled{false};
+
+	px4::atomic<int> _request_motor_index{-1};	///< written by the work item, taken by the output driver
+	int _requested_motor_index{-1};
+
+	px4::atomic<DShotTelemetry::OutputBuffer *> _esc_info_request{nullptr};
+	px4::atomic<int> _esc_info_motor_index{-1};	///< written by the work item, taken by the output driver
+	bool _esc_info_active{false};
+
+	uORB::PublicationData<esc_status_s> _esc_status_pub{ORB_ID(esc_status)};
+};
@@ -53,12 +53,15 @@
 #include <px4_platform_common/cli.h>
 #include <px4_platform_common/getopt.h>
 #include <px4_platform_common/module.h>
+#include <px4_platform_common/serial_dma.h>
 #include <uORB/PublicationQueued.hpp>
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/topics/gps_dump.h>
 #include <uORB/topics/gps_inject_data.h>
 
+using namespace time_literals;
+
 #include "devices/src/ashtech.h"
 #include "devices/src/emlid_reach.h"
 #include "devices/src/mtk.h"
@@ -145,6 +148,9 @@ public:
 
 private:
 	int				_serial_fd{-1};					///< serial interface to GPS
+#if !defined(__PX4_QURT)
+	px4::SerialDMA			_serial_rx;					///< frame based reception from _serial_fd
+#endif
 	unsigned			_baudrate{0};					///< current baudrate
 	const unsigned			_configured_baudrate{0};			///< configured baudrate (0=auto-detect)
 	char				_port[20] {};					///< device / serial port path
@@ -168,12 +174,17 @@ private:
 	float				_rate{0.0f};					///< position update rate
 	float				_rate_rtcm_injection{0.0f};			///< RTCM message injection rate
 	unsigned			_last_rate_rtcm_injection_count{0}; 		///< counter for number of RTCM messages
+	unsigned			_rtcm_injection_lost_count{0};			///< RTCM messages lost in the queue
+	unsigned			_rtcm_injection_late_count{0};			///< RTCM messages injected later than RTCM_INJECTION_LATE
 
 	const bool			_fake_gps;					///< fake gps output
 
 	const Instance 			_instance;
 
 	uORB::Subscription		_orb_inject_data_sub{ORB_ID(gps_inject_data)};
+	gps_inject_data_s		_inject_data{};					///< not on the stack, it's large
+	uint8_t				_inject_buffer[1024] {};				///< injection data collected for a single write
+	size_t				_inject_buffer_len{0};
 	uORB::PublicationQueued<gps_dump_s>	_dump_communication_pub{ORB_ID(gps_dump)};
 	gps_dump_s			*_dump_to_device{nullptr};
 	gps_dump_s			*_dump_from_device{nullptr};
@@ -220,6 +231,11 @@ private:
 	 */
 	inline bool injectData(uint8_t *data, size_t len);
 
+	/**
+	 * write the collected injection data to the device
+	 */
+	void flushInjectBuffer();
+
 	/**
 	 * set the Baudrate
 	 * @param baud
@@ -363,47 +379,10 @@ int GPS::pollOrRead(uint8_t *buf, size_t buf_length, int timeout)
 	//FIXME: add a unified poll() API
 	const int max_timeout = 50;
 
-	pollfd fds[1];
-	fds[0].fd = _serial_fd;
-	fds[0].events = POLLIN;
-
-	int ret = poll(fds, sizeof(fds) / sizeof(fds[0]), math::min(max_timeout, timeout));
-
-	if (ret > 0) {
-		/* if we have new data from GPS, go handle it */
-		if (fds[0].revents & POLLIN) {
-			/*
-			 * We are here because poll says there is some data, so this
-			 * won't block even on a blocking device. But don't read immediately
-			 * by 1-2 bytes, wait for some more data to save expensive read() calls.
-			 * If we have all requested data available, read it without waiting.
-			 * If more bytes are available, we'll go back to poll() again.
-			 */
-			const unsigned character_count = 32; // minimum bytes that we want to read
-			unsigned baudrate = _baudrate == 0 ? 115200 : _baudrate;
-			const unsigned sleeptime = character_count * 1000000 / (baudrate / 10);
-
-#ifdef __PX4_NUTTX
-			int err = 0;
-			int bytes_available = 0;
-			err = ioctl(_serial_fd, FIONREAD, (unsigned long)&bytes_available);
-
-			if (err != 0 || bytes_available < (int)character_count) {
-				px4_usleep(sleeptime);
-			}
-
-#else
-			px4_usleep(sleeptime);
-#endif
-
-			ret = ::read(_serial_fd, buf, buf_length);
-
-		} else {
-			ret = -1;
-		}
-	}
-
-	return ret;
+	// Wake up on the first byte, then wait for the end of the received burst (line idle) and
+	// read it at once. This saves expensive read() calls on 1-2 bytes.
+	_serial_rx.setDevice(_serial_fd, _baudrate);
+	return _serial_rx.readFrame(buf, buf_length, math::min(max_timeout, timeout));
 
 #else
 	/* For QURT, just use read for now, since this doesn't block, we need to slow it down
@@ -415,32 +394,49 @@ int GPS::pollOrRead(uint8_t *buf, size_t buf_length, int timeout)
 
 void GPS::handleInjectDataTopic()
 {
-	bool updated = false;
-
-	// Limit maximum number of GPS injections to 6 since usually
-	// GPS injections should consist of 1-4 packets (GPS, Glonass, BeiDou, Galileo).
-	// Looking at 6 packets thus guarantees, that at least a full injection
-	// data set is evaluated.
-	const size_t max_num_injections = 6;
-	size_t num_injections = 0;
-
-	do {
-		num_injections++;
-		updated = _orb_inject_data_sub.updated();
-
-		if (updated) {
-			gps_inject_data_s msg;
-			_orb_inject_data_sub.copy(&msg);
-
-			/* Write the message to the gps device. Note that the message could be fragmented.
-			 * But as we don't write anywhere else to the device during operation, we don't
-			 * need to assemble the message first.
-			 */
-			injectData(msg.data, msg.len);
-
-			++_last_rate_rtcm_injection_count;
+	// messages older than this have been waiting too long in the queue
+	static constexpr hrt_abstime RTCM_INJECTION_LATE = 500_ms;
+
+	// Drain the whole queue (a full injection data set consists of several messages, e.g. one per
+	// constellation), but don't loop forever if it is refilled faster than we read.
+	for (unsigned i = 0; i < gps_inject_data_s::ORB_QUEUE_LENGTH; i++) {
+		if (!_orb_inject_data_sub.updated()) {
+			break;
+		}
+
+		uint32_t lost_messages = 0;
+		_orb_inject_data_sub.copy(&_inject_data, lost_messages);
+		_rtcm_injection_lost_count += lost_messages;
+
+		if (hrt_elapsed_time(&_inject_data.timestamp) > RTCM_INJECTION_LATE) {
+			++_rtcm_injection_late_count;
+		}
+
+		const size_t len = math::min((size_t)_inject_data.len, sizeof(_inject_data.data));
+
+		if (_inject_buffer_len + len > sizeof(_inject_buffer)) {
+			flushInjectBuffer();
 		}
-	} while (updated && num_injections < max_num_injections);
+
+		/* Collect the messages and write them to the gps device at once. Note that a message could still be
+		 * fragmented. But as we don't write anywhere else to the device during operation, we don't
+		 * need to assemble the message first.
+		 */
+		memcpy(&_inject_buffer[_inject_buffer_len], _inject_data.data, len);
+		_inject_buffer_len += len;
+
+		++_last_rate_rtcm_injection_count;
+	}
+
+	flushInjectBuffer();
+}
+
+void GPS::flushInjectBuffer()
+{
+	if (_inject_buffer_len > 0) {
+		injectData(_inject_buffer, _inject_buffer_len);
+		_inject_buffer_len = 0;
+	}
 }
 
 bool GPS::injectData(uint8_t *data, size_t len)
@@ -893,6 +889,7 @@ GPS::print_status()
 		if (!_fake_gps) {
 			PX4_INFO("rate publication:\t\t%6.2f Hz", (double)_rate);
 			PX4_INFO("rate RTCM injection:\t%6.2f Hz", (double)_rate_rtcm_injection);
+			PX4_INFO("RTCM injection lost: %u, late: %u", _rtcm_injection_lost_count, _rtcm_injection_late_count);
 		}
 
 		print_message(_report_gps_pos);
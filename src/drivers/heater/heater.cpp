@@ -50,6 +50,13 @@
 #error "To use the heater driver, the board_config.h must define and initialize GPIO_HEATER_OUTPUT"
 #endif
 
+#if defined(HEATER_PWM_TIMER)
+// hardware PWM output, see platforms/nuttx/src/px4/stm/stm32_common/heater_pwm
+extern int heater_pwm_init(void);
+extern void heater_pwm_deinit(void);
+extern void heater_pwm_set(float duty);
+#endif
+
 Heater::Heater() :
 	ModuleParams(nullptr),
 	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::lp_default)
@@ -61,7 +68,11 @@ Heater::Heater() :
 Heater::~Heater()
 {
 	// Reset heater to off state
+#if defined(HEATER_PWM_TIMER)
+	heater_pwm_deinit();
+#else
 	px4_arch_configgpio(GPIO_HEATER_OUTPUT);
+#endif
 }
 
 int Heater::custom_command(int argc, char *argv[])
@@ -78,20 +89,17 @@ int Heater::custom_command(int argc, char *argv[])
 void Heater::Run()
 {
 	if (should_exit()) {
+		if (_sensor_accel_index >= 0) {
+			_sensor_accel_sub[_sensor_accel_index].unregisterCallback();
+		}
+
 		exit_and_cleanup();
 		return;
 	}
 
-	if (_heater_on) {
-		// Turn the heater off.
-		px4_arch_gpiowrite(GPIO_HEATER_OUTPUT, 0);
-		_heater_on = false;
-
-	} else {
+	if ((_sensor_accel_index >= 0) && _sensor_accel_sub[_sensor_accel_index].update(&_sensor_accel)) {
 		update_params(false);
 
-		_sensor_accel_sub.update(&_sensor_accel);
-
 		// Obtain the current IMU sensor temperature.
 		_sensor_temperature = _sensor_accel.temperature;
 
@@ -113,43 +121,61 @@ void Heater::Run()
 		// Constrain the heater time within the allowable duty cycle.
 		_controller_time_on_usec = math::constrain(_controller_time_on_usec, 0, _controller_period_usec);
 
-		// Turn the heater on.
-		_heater_on = true;
-		px4_arch_gpiowrite(GPIO_HEATER_OUTPUT, 1);
+		set_output(_controller_time_on_usec);
+
+	} else {
+		// End of the heater on time or timeout of the sensor data.
+		set_output(0);
 	}
+}
+
+void Heater::set_output(int time_on_usec)
+{
+	_heater_on = (time_on_usec > 0);
+
+#if defined(HEATER_PWM_TIMER)
+	// The timer keeps the duty cycle, only turn the heater off if the sensor data stops.
+	heater_pwm_set((float)time_on_usec / (float)_controller_period_usec);
 
-	// Schedule the next cycle.
 	if (_heater_on) {
-		ScheduleDelayed(_controller_time_on_usec);
+		ScheduleDelayed(SENSOR_TIMEOUT);
+	}
 
-	} else {
-		ScheduleDelayed(_controller_period_usec - _controller_time_on_usec);
+#else
+	px4_arch_gpiowrite(GPIO_HEATER_OUTPUT, _heater_on);
+
+	// Turn the heater off again after the on time.
+	if (_heater_on) {
+		ScheduleDelayed(time_on_usec);
 	}
+
+#endif
 }
 
 void Heater::initialize_topics()
 {
-	// Get the total number of accelerometer instances.
-	uint8_t number_of_imus = orb_group_count(ORB_ID(sensor_accel));
-
 	// Check each instance for the correct ID.
-	for (uint8_t x = 0; x < number_of_imus; x++) {
-		_sensor_accel_sub = uORB::Subscription{ORB_ID(sensor_accel), x};
-
-		if (!_sensor_accel_sub.advertised()) {
+	for (int x = 0; x < ORB_MULTI_MAX_INSTANCES; x++) {
+		if (!_sensor_accel_sub[x].advertised()) {
 			continue;
 		}
 
-		_sensor_accel_sub.copy(&_sensor_accel);
+		_sensor_accel_sub[x].copy(&_sensor_accel);
 
-		// If the correct ID is found, exit the for-loop with _sensor_accel_sub pointing to the correct instance.
+		// If the correct ID is found, run on the updates of this instance at the controller rate.
 		if (_sensor_accel.device_id == (uint32_t)_param_sens_temp_id.get()) {
+			_sensor_accel_sub[x].set_interval_us(_controller_period_usec);
+
+			if (_sensor_accel_sub[x].registerCallback()) {
+				_sensor_accel_index = x;
+			}
+
 			break;
 		}
 	}
 
 	// Exit the driver if the sensor ID does not match the desired sensor.
-	if (_sensor_accel.device_id != (uint32_t)_param_sens_temp_id.get()) {
+	if (_sensor_accel_index < 0) {
 		request_stop();
 		PX4_ERR("Could not identify IMU sensor.");
 	}
@@ -169,6 +195,11 @@ int Heater::print_status()
 int Heater::start()
 {
 	update_params(true);
+
+#if defined(HEATER_PWM_TIMER)
+	heater_pwm_init();
+#endif
+
 	initialize_topics();
 
 	ScheduleNow();
@@ -215,7 +246,11 @@ int Heater::print_usage(const char *reason)
 	PRINT_MODULE_DESCRIPTION(
 		R"DESCR_STR(
 ### Description
-Background process running periodically on the LP work queue to regulate IMU temperature at a setpoint.
+Background process running on the LP work queue to regulate IMU temperature at a setpoint.
+
+The duty cycle is updated with the temperature of the selected IMU at 10 Hz. On boards with a hardware
+PWM heater output (HEATER_PWM_TIMER) the timer keeps the duty cycle, otherwise the heater GPIO is toggled
+in software.
 
 This task can be started at boot from the startup scripts by setting SENS_EN_THERMAL or via CLI.
 )DESCR_STR");
@@ -47,6 +47,7 @@
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/sensor_accel.h>
 
@@ -54,6 +55,9 @@
 
 #define CONTROLLER_PERIOD_DEFAULT 100000
 
+/** Time without sensor data after which the heater is turned off. */
+#define SENSOR_TIMEOUT 1000000
+
 /**
  * @brief IMU Heater Controller driver used to maintain consistent
  *        temparature at the IMU.
@@ -151,12 +155,18 @@ protected:
 private:
 
 	/**
-	 * @brief Calculates the heater element on/off time, carries out
-	 *        closed loop feedback and feedforward temperature control,
-	 *        and schedules the next cycle.
+	 * @brief Runs on new temperature data of the selected IMU, calculates the heater
+	 *        duty cycle with closed loop feedback and feedforward temperature control.
+	 *        Without a hardware PWM output the heater GPIO is turned off again after the on time.
 	 */
 	void Run() override;
 
+	/**
+	 * @brief Sets the heater output.
+	 * @param time_on_usec The heater on time per controller period.
+	 */
+	void set_output(int time_on_usec);
+
 	/**
 	 * @brief Updates and checks for updated uORB parameters.
 	 * @param force Boolean to determine if an update check should be forced.
@@ -178,7 +188,14 @@ private:
 
 	float _proportional_value = 0.0f;
 
-	uORB::Subscription _sensor_accel_sub{ORB_ID(sensor_accel)};
+	/** Only the instance of the SENS_TEMP_ID sensor is registered. */
+	uORB::SubscriptionCallbackWorkItem _sensor_accel_sub[ORB_MULTI_MAX_INSTANCES] {
+		{this, ORB_ID(sensor_accel), 0},
+		{this, ORB_ID(sensor_accel), 1},
+		{this, ORB_ID(sensor_accel), 2},
+		{this, ORB_ID(sensor_accel), 3}
+	};
+	int _sensor_accel_index = -1;
 	sensor_accel_s _sensor_accel{};
 
 	float _sensor_temperature = 0.0f;
@@ -49,8 +49,7 @@ static constexpr uint32_t FIFO_GYRO_SAMPLES{FIFO_INTERVAL / (1000000 / GYRO_RATE
 static constexpr uint32_t FIFO_ACCEL_SAMPLES{FIFO_INTERVAL / (1000000 / ACCEL_RATE)};
 
 ICM20602::ICM20602(int bus, uint32_t device, enum Rotation rotation) :
-	SPI(MODULE_NAME, nullptr, bus, device, SPIDEV_MODE3, SPI_SPEED),
-	ScheduledWorkItem(MODULE_NAME, px4::device_bus_to_wq(get_device_id())),
+	FifoImuDriver(MODULE_NAME, bus, device, SPIDEV_MODE3, SPI_SPEED),
 	_px4_accel(get_device_id(), ORB_PRIO_VERY_HIGH, rotation),
 	_px4_gyro(get_device_id(), ORB_PRIO_VERY_HIGH, rotation)
 {
@@ -62,23 +61,30 @@ ICM20602::ICM20602(int bus, uint32_t device, enum Rotation rotation) :
 
 	_px4_accel.set_update_rate(1000000 / FIFO_INTERVAL);
 	_px4_gyro.set_update_rate(1000000 / FIFO_INTERVAL);
+
+	// read the FIFO every 8 samples (accel only every other sample)
+	ConfigureFIFO(FIFO_INTERVAL, FIFO_GYRO_SAMPLES, 16, 2);
+
+	// TODO: cleanup horrible DRDY define mess
+#if defined(GPIO_DRDY_PORTC_PIN14)
+	SetDataReadyGPIO(GPIO_DRDY_PORTC_PIN14);
+#elif defined(GPIO_SPI1_DRDY1_ICM20602)
+	SetDataReadyGPIO(GPIO_SPI1_DRDY1_ICM20602);
+#elif defined(GPIO_SPI1_DRDY4_ICM20602)
+	SetDataReadyGPIO(GPIO_SPI1_DRDY4_ICM20602);
+#elif defined(GPIO_DRDY_ICM_2060X)
+	SetDataReadyGPIO(GPIO_DRDY_ICM_2060X);
+#endif
 }
 
 ICM20602::~ICM20602()
 {
+	// waits for a FIFO read still in progress
 	Stop();
 
 	if (_dma_data_buffer != nullptr) {
 		board_dma_free(_dma_data_buffer, FIFO::SIZE);
 	}
-
-	perf_free(_interval_perf);
-	perf_free(_transfer_perf);
-	perf_free(_fifo_empty_perf);
-	perf_free(_fifo_overflow_perf);
-	perf_free(_fifo_reset_perf);
-	perf_free(_drdy_count_perf);
-	perf_free(_drdy_interval_perf);
 }
 
 int ICM20602::probe()
@@ -149,8 +155,6 @@ bool ICM20602::Reset()
 
 void ICM20602::ResetFIFO()
 {
-	perf_count(_fifo_reset_perf);
-
 	// ACCEL_CONFIG2: Accel DLPF disabled for full rate (4 kHz)
 	RegisterSetBits(Register::ACCEL_CONFIG2, ACCEL_CONFIG2_BIT::ACCEL_FCHOICE_B_BYPASS_DLPF);
 
@@ -172,7 +176,6 @@ void ICM20602::ResetFIFO()
 	RegisterSetBits(Register::CONFIG, CONFIG_BIT::DLPF_CFG_BYPASS_DLPF_8KHZ);
 
 	// FIFO_EN: enable both gyro and accel
-	_data_ready_count = 0;
 	RegisterWrite(Register::FIFO_EN, FIFO_EN_BIT::GYRO_FIFO_EN | FIFO_EN_BIT::ACCEL_FIFO_EN);
 	up_udelay(10);
 }
@@ -211,158 +214,58 @@ void ICM20602::RegisterClearBits(Register reg, uint8_t clearbits)
 	}
 }
 
-int ICM20602::DataReadyInterruptCallback(int irq, void *context, void *arg)
+void ICM20602::DataReadyInterruptEnable(bool enable)
 {
-	ICM20602 *dev = reinterpret_cast<ICM20602 *>(arg);
-	dev->DataReady();
-	return 0;
-}
-
-void ICM20602::DataReady()
-{
-	perf_count(_drdy_count_perf);
-	perf_count(_drdy_interval_perf);
-
-	_data_ready_count++;
+	if (enable) {
+		RegisterSetBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
 
-	if (_data_ready_count >= 8) {
-		_time_data_ready = hrt_absolute_time();
-
-		_data_ready_count = 0;
-
-		// make another measurement
-		ScheduleNow();
+	} else {
+		RegisterClearBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
 	}
 }
 
-void ICM20602::Start()
-{
-	Stop();
-
-	ResetFIFO();
-
-	// TODO: cleanup horrible DRDY define mess
-#if defined(GPIO_DRDY_PORTC_PIN14)
-	// Setup data ready on rising edge
-	px4_arch_gpiosetevent(GPIO_DRDY_PORTC_PIN14, true, false, true, &ICM20602::DataReadyInterruptCallback, this);
-	RegisterSetBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#elif defined(GPIO_SPI1_DRDY1_ICM20602)
-	// Setup data ready on rising edge
-	px4_arch_gpiosetevent(GPIO_SPI1_DRDY1_ICM20602, true, false, true, &ICM20602::DataReadyInterruptCallback, this);
-	RegisterSetBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#elif defined(GPIO_SPI1_DRDY4_ICM20602)
-	// Setup data ready on rising edge
-	px4_arch_gpiosetevent(GPIO_SPI1_DRDY4_ICM20602, true, false, true, &ICM20602::DataReadyInterruptCallback, this);
-	RegisterSetBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#elif defined(GPIO_SPI1_DRDY1_ICM20602)
-	// Setup data ready on rising edge
-	px4_arch_gpiosetevent(GPIO_SPI1_DRDY1_ICM20602, true, false, true, &ICM20602::DataReadyInterruptCallback, this);
-	RegisterSetBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#elif defined(GPIO_DRDY_ICM_2060X)
-	// Setup data ready on rising edge
-	px4_arch_gpiosetevent(GPIO_DRDY_ICM_2060X, true, false, true, &ICM20602::DataReadyInterruptCallback, this);
-	RegisterSetBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#else
-	ScheduleOnInterval(FIFO_INTERVAL, FIFO_INTERVAL);
-#endif
-}
-
-void ICM20602::Stop()
-{
-	// TODO: cleanup horrible DRDY define mess
-#if defined(GPIO_DRDY_PORTC_PIN14)
-	// Disable data ready callback
-	px4_arch_gpiosetevent(GPIO_DRDY_PORTC_PIN14, false, false, false, nullptr, nullptr);
-	RegisterClearBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#elif defined(GPIO_SPI1_DRDY1_ICM20602)
-	// Disable data ready callback
-	px4_arch_gpiosetevent(GPIO_SPI1_DRDY1_ICM20602, false, false, false, nullptr, nullptr);
-	RegisterClearBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#elif defined(GPIO_SPI1_DRDY4_ICM20602)
-	// Disable data ready callback
-	px4_arch_gpiosetevent(GPIO_SPI1_DRDY4_ICM20602, false, false, false, nullptr, nullptr);
-	RegisterClearBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#elif defined(GPIO_SPI1_DRDY1_ICM20602)
-	// Disable data ready callback
-	px4_arch_gpiosetevent(GPIO_SPI1_DRDY1_ICM20602, false, false, false, nullptr, nullptr);
-	RegisterClearBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#elif defined(GPIO_DRDY_ICM_2060X)
-	// Disable data ready callback
-	px4_arch_gpiosetevent(GPIO_DRDY_ICM_2060X, false, false, false, nullptr, nullptr);
-	RegisterClearBits(Register::INT_ENABLE, INT_ENABLE_BIT::DATA_RDY_INT_EN);
-#else
-	ScheduleClear();
-#endif
-}
-
-void ICM20602::Run()
+int ICM20602::FIFOReadCount()
 {
-	perf_count(_interval_perf);
-
-	// use timestamp from the data ready interrupt if available,
-	//  otherwise use the time now roughly corresponding with the last sample we'll pull from the FIFO
-	const hrt_abstime timestamp_sample = (hrt_elapsed_time(&_time_data_ready) < FIFO_INTERVAL) ? _time_data_ready :
-					     hrt_absolute_time();
-
 	// read FIFO count
 	uint8_t fifo_count_buf[3] {};
 	fifo_count_buf[0] = static_cast<uint8_t>(Register::FIFO_COUNTH) | DIR_READ;
-	//const hrt_abstime timestamp_fifo_check = hrt_absolute_time();
 
 	if (transfer(fifo_count_buf, fifo_count_buf, sizeof(fifo_count_buf)) != PX4_OK) {
-		return;
-	}
-
-	const size_t fifo_count = combine(fifo_count_buf[1], fifo_count_buf[2]);
-	const int samples = (fifo_count / sizeof(FIFO::DATA) / 2) * 2; // round down to nearest 2
-
-	if (samples < 2) {
-		perf_count(_fifo_empty_perf);
-		return;
-
-	} else if (samples > 16) {
-		// not technically an overflow, but more samples than we expected
-		perf_count(_fifo_overflow_perf);
-		ResetFIFO();
-		return;
+		return -EIO;
 	}
 
 	// check for FIFO overflow
 	if (RegisterRead(Register::INT_STATUS) & INT_STATUS_BIT::FIFO_OFLOW_INT) {
-		perf_count(_fifo_overflow_perf);
-		ResetFIFO();
-		return;
+		return -EOVERFLOW;
 	}
 
-	// Transfer data
-	struct TransferBuffer {
-		uint8_t cmd;
-		FIFO::DATA f[16]; // max 16 samples
-	};
-	static_assert(sizeof(TransferBuffer) == (sizeof(uint8_t) + 16 * sizeof(FIFO::DATA))); // ensure no struct padding
+	const size_t fifo_count = combine(fifo_count_buf[1], fifo_count_buf[2]);
 
+	return fifo_count / sizeof(FIFO::DATA);
+}
+
+uint8_t *ICM20602::FIFOTransferBuffer(int samples, size_t &transfer_size)
+{
 	TransferBuffer *report = (TransferBuffer *)_dma_data_buffer;
-	const size_t transfer_size = math::min(samples * sizeof(FIFO::DATA) + 1, FIFO::SIZE);
+	transfer_size = math::min(samples * sizeof(FIFO::DATA) + 1, FIFO::SIZE);
 	memset(report, 0, transfer_size);
 	report->cmd = static_cast<uint8_t>(Register::FIFO_R_W) | DIR_READ;
 
-	perf_begin(_transfer_perf);
-
-	if (transfer(_dma_data_buffer, _dma_data_buffer, transfer_size) != PX4_OK) {
-		perf_end(_transfer_perf);
-		return;
-	}
+	return _dma_data_buffer;
+}
 
-	perf_end(_transfer_perf);
+void ICM20602::FIFOProcess(const hrt_abstime &timestamp_sample, int samples)
+{
+	const TransferBuffer *report = (const TransferBuffer *)_dma_data_buffer;
 
 	PX4Accelerometer::FIFOSample accel;
 	accel.timestamp_sample = timestamp_sample;
-	accel.dt = FIFO_INTERVAL / FIFO_ACCEL_SAMPLES;
+	accel.dt = SampleInterval() * (FIFO_GYRO_SAMPLES / FIFO_ACCEL_SAMPLES); // accel every other FIFO sample
 
 	PX4Gyroscope::FIFOSample gyro;
 	gyro.timestamp_sample = timestamp_sample;
 	gyro.samples = samples;
-	gyro.dt = FIFO_INTERVAL / FIFO_GYRO_SAMPLES;
+	gyro.dt = SampleInterval();
 
 	int accel_samples = 0;
 	int16_t temperature[samples] {};
@@ -418,13 +321,7 @@ void ICM20602::Run()
 
 void ICM20602::PrintInfo()
 {
-	perf_print_counter(_interval_perf);
-	perf_print_counter(_transfer_perf);
-	perf_print_counter(_fifo_empty_perf);
-	perf_print_counter(_fifo_overflow_perf);
-	perf_print_counter(_fifo_reset_perf);
-	perf_print_counter(_drdy_count_perf);
-	perf_print_counter(_drdy_interval_perf);
+	FifoImuDriver::PrintInfo();
 
 	_px4_accel.print_status();
 	_px4_gyro.print_status();
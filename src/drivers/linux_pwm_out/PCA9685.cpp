@@ -70,12 +70,52 @@ int PCA9685::init(int bus, int address)
 
 int PCA9685::send_output_pwm(const uint16_t *pwm, int num_outputs)
 {
-	if (num_outputs > 16) {
-		num_outputs = 16;
+	if (num_outputs > CHANNEL_COUNT) {
+		num_outputs = CHANNEL_COUNT;
 	}
 
+	if (_fd == -1) {
+		return -1;
+	}
+
+	// write the range between the first and the last changed channel in one transaction (register auto-increment)
+	int first = -1;
+	int last = -1;
+
 	for (int i = 0; i < num_outputs; ++i) {
-		setPWM(i, pwm[i]);
+		if (pwm[i] != _last_value[i]) {
+			if (first < 0) {
+				first = i;
+			}
+
+			last = i;
+		}
+	}
+
+	if (first < 0) {
+		return 0;
+	}
+
+	uint8_t buf[1 + CHANNEL_COUNT * LED_MULTIPLYER];
+	buf[0] = LED0_ON_L + LED_MULTIPLYER * first;
+
+	for (int i = first; i <= last; ++i) {
+		uint8_t *led = &buf[1 + (i - first) * LED_MULTIPLYER];
+		led[0] = 0;
+		led[1] = 0;
+		led[2] = pwm[i] & 0xFF;
+		led[3] = pwm[i] >> 8;
+	}
+
+	const ssize_t len = 1 + (last - first + 1) * LED_MULTIPLYER;
+
+	if (write(_fd, buf, len) != len) {
+		PX4_ERR("Write failed (%i)", errno);
+		return -1;
+	}
+
+	for (int i = first; i <= last; ++i) {
+		_last_value[i] = pwm[i];
 	}
 
 	return 0;
@@ -103,9 +143,13 @@ PCA9685::~PCA9685()
 void PCA9685::reset()
 {
 	if (_fd != -1) {
-		write_byte(_fd, MODE1, 0x00); //Normal mode
+		write_byte(_fd, MODE1, MODE1_AI); //Normal mode, register auto-increment
 		write_byte(_fd, MODE2, 0x04); //Normal mode
 	}
+
+	for (int i = 0; i < CHANNEL_COUNT; ++i) {
+		_last_value[i] = UINT16_MAX;
+	}
 }
 
 void PCA9685::setPWMFreq(int freq)
@@ -133,14 +177,20 @@ void PCA9685::setPWM(uint8_t led, int value)
 
 void PCA9685::setPWM(uint8_t led, int on_value, int off_value)
 {
-	if (_fd != -1) {
-		write_byte(_fd, LED0_ON_L + LED_MULTIPLYER * led, on_value & 0xFF);
-
-		write_byte(_fd, LED0_ON_H + LED_MULTIPLYER * led, on_value >> 8);
-
-		write_byte(_fd, LED0_OFF_L + LED_MULTIPLYER * led, off_value & 0xFF);
-
-		write_byte(_fd, LED0_OFF_H + LED_MULTIPLYER * led, off_value >> 8);
+	if (_fd != -1 && led < CHANNEL_COUNT) {
+		uint8_t buf[1 + LED_MULTIPLYER];
+		buf[0] = LED0_ON_L + LED_MULTIPLYER * led;
+		buf[1] = on_value & 0xFF;
+		buf[2] = on_value >> 8;
+		buf[3] = off_value & 0xFF;
+		buf[4] = off_value >> 8;
+
+		if (write(_fd, buf, sizeof(buf)) != sizeof(buf)) {
+			PX4_ERR("Write failed (%i)", errno);
+		}
+
+		// force a rewrite by the next send_output_pwm
+		_last_value[led] = UINT16_MAX;
 	}
 
 }
@@ -63,6 +63,7 @@ namespace linux_pwm_out
 #define ALLLED_OFF_L 0xFC	//load all the LEDn_OFF registers, byte 0 (turn 0-7 channels off)
 #define ALLLED_OFF_H 0xFD	//load all the LEDn_OFF registers, byte 1 (turn 8-15 channels off)
 #define PRE_SCALE 0xFE		//prescaler for output frequency
+#define MODE1_AI 0x20		//MODE1 register auto-increment
 #define MAX_PWM_RES 4096        //Resolution 4096=12bit 分辨率，按2的阶乘计算，12bit为4096
 #define CLOCK_FREQ 25000000.0 //25MHz default osc clock
 #define PCA9685_DEFAULT_I2C_ADDR 0x40  // default i2c address for pca9685 默认i2c地址为0x40
@@ -115,8 +116,12 @@ public:
 	void setPWM(uint8_t channel, int value);
 
 private:
+	static constexpr int CHANNEL_COUNT = 16;
+
 	int _fd = -1; ///< I2C device file descriptor
 
+	uint16_t _last_value[CHANNEL_COUNT] {}; ///< last value written per channel by send_output_pwm
+
 	/**
 	 * Read a single byte from PCA9685
 	 * @param fd file descriptor for I/O
@@ -60,7 +60,7 @@
 #include "common.h"
 #include "navio_sysfs.h"
 #include "PCA9685.h"
-#include "ocpoc_mmap.h"
+#include "mmap_pwm.h"
 #include "bbblue_pwm_rc.h"
 
 namespace linux_pwm_out
@@ -83,6 +83,7 @@ orb_advert_t    _outputs_pub = nullptr;
 orb_advert_t    _rc_pub = nullptr;
 
 perf_counter_t	_perf_control_latency = nullptr;
+perf_counter_t	_perf_output = nullptr;
 
 // topic structures
 actuator_controls_s _controls[actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS];
@@ -91,8 +92,7 @@ actuator_outputs_s  _outputs;
 actuator_armed_s    _armed;
 
 // polling
-uint8_t _poll_fds_num = 0;
-px4_pollfd_struct_t _poll_fds[actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS];
+px4_waitset_t _waitset;
 
 // control groups related
 uint32_t	_groups_required = 0;
@@ -184,7 +184,7 @@ int initialize_mixer(const char *mixer_filename)
 void subscribe()
 {
 	memset(_controls, 0, sizeof(_controls));
-	memset(_poll_fds, 0, sizeof(_poll_fds));
+	px4_waitset_create(&_waitset);
 
 	/* set up ORB topic names */
 	_controls_topics[0] = ORB_ID(actuator_controls_0);
@@ -203,9 +203,7 @@ void subscribe()
 		}
 
 		if (_controls_subs[i] >= 0) {
-			_poll_fds[_poll_fds_num].fd = _controls_subs[i];
-			_poll_fds[_poll_fds_num].events = POLLIN;
-			_poll_fds_num++;
+			px4_waitset_add(&_waitset, _controls_subs[i], POLLIN);
 		}
 
 		_armed_sub = orb_subscribe(ORB_ID(actuator_armed));
@@ -218,6 +216,7 @@ void task_main(int argc, char *argv[])
 	_is_running = true;
 
 	_perf_control_latency = perf_alloc(PC_ELAPSED, "linux_pwm_out control latency");
+	_perf_output = perf_alloc(PC_ELAPSED, "linux_pwm_out output");
 
 	// Set up mixer
 	if (initialize_mixer(_mixer_filename) < 0) {
@@ -233,7 +232,7 @@ void task_main(int argc, char *argv[])
 
 	} else if (strcmp(_protocol, "ocpoc_mmap") == 0) {
 		PX4_INFO("Starting PWM output in ocpoc_mmap mode");
-		pwm_out = new OcpocMmapPWMOut(_max_num_outputs);
+		pwm_out = new MmapPWMOut(MmapPWMOut::OCPOC_LAYOUT, _max_num_outputs);
 
 #ifdef CONFIG_ARCH_BOARD_BEAGLEBONE_BLUE
 
@@ -283,7 +282,7 @@ void task_main(int argc, char *argv[])
 			_mixer_group->set_airmode(airmode);
 		}
 
-		int pret = px4_poll(_poll_fds, _poll_fds_num, 10);
+		int pret = px4_waitset_wait(&_waitset, 10);
 
 		/* Timed out, do a periodic check for _task_should_exit. */
 		if (pret == 0 && !_armed.in_esc_calibration_mode) {
@@ -303,7 +302,7 @@ void task_main(int argc, char *argv[])
 
 		for (uint8_t i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
 			if (_controls_subs[i] >= 0) {
-				if (_poll_fds[poll_id].revents & POLLIN) {
+				if (_waitset.fds[poll_id].revents & POLLIN) {
 					orb_copy(_controls_topics[i], _controls_subs[i], &_controls[i]);
 				}
 
@@ -369,6 +368,8 @@ void task_main(int argc, char *argv[])
 					  pwm,
 					  &_pwm_limit);
 
+			perf_begin(_perf_output);
+
 			if (_armed.lockdown || _armed.manual_lockdown) {
 				pwm_out->send_output_pwm(disarmed_pwm, _outputs.noutputs);
 
@@ -393,6 +394,8 @@ void task_main(int argc, char *argv[])
 				pwm_out->send_output_pwm(pwm, _outputs.noutputs);
 			}
 
+			perf_end(_perf_output);
+
 			_outputs.timestamp = hrt_absolute_time();
 
 			if (_outputs_pub != nullptr) {
@@ -431,6 +434,8 @@ void task_main(int argc, char *argv[])
 
 	delete pwm_out;
 
+	px4_waitset_destroy(&_waitset);
+
 	for (uint8_t i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
 		if (_controls_subs[i] >= 0) {
 			orb_unsubscribe(_controls_subs[i]);
@@ -447,6 +452,7 @@ void task_main(int argc, char *argv[])
 	}
 
 	perf_free(_perf_control_latency);
+	perf_free(_perf_output);
 
 	_is_running = false;
 
@@ -583,6 +589,13 @@ int linux_pwm_out_main(int argc, char *argv[])
 
 	else if (!strcmp(verb, "status")) {
 		PX4_WARN("pwm_out is %s", linux_pwm_out::_is_running ? "running" : "not running");
+
+		if (linux_pwm_out::_is_running) {
+			PX4_INFO("protocol: %s, outputs: %i", linux_pwm_out::_protocol, linux_pwm_out::_max_num_outputs);
+			perf_print_counter(linux_pwm_out::_perf_control_latency);
+			perf_print_counter(linux_pwm_out::_perf_output);
+		}
+
 		return 0;
 
 	} else {
@@ -1,6 +1,6 @@
 /****************************************************************************
  *
- *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions
@@ -31,79 +31,86 @@
  *
  ****************************************************************************/
 
-#include "ocpoc_mmap.h"
+#include "mmap_pwm.h"
 
 #include <px4_platform_common/log.h>
 
+#include <errno.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
 using namespace linux_pwm_out;
 
-#define RCOUT_ZYNQ_PWM_BASE	    0x43c00000
-static const int TICK_PER_US   =  50;
-static const int FREQUENCY_PWM = 400;
-static const int TICK_PER_S  = 50000000;
+constexpr MmapPWMOut::RegisterLayout MmapPWMOut::OCPOC_LAYOUT;
 
-OcpocMmapPWMOut::OcpocMmapPWMOut(int max_num_outputs)
+MmapPWMOut::MmapPWMOut(const RegisterLayout &layout, int max_num_outputs) :
+	_layout(layout)
 {
 	_num_outputs = max_num_outputs;
 
-	if (_num_outputs > MAX_ZYNQ_PWMS) {
-		PX4_WARN("number of outputs too large. Setting to %i", MAX_ZYNQ_PWMS);
-		_num_outputs = MAX_ZYNQ_PWMS;
+	if (_num_outputs > _layout.max_channels) {
+		PX4_WARN("number of outputs too large. Setting to %i", _layout.max_channels);
+		_num_outputs = _layout.max_channels;
 	}
 }
 
-OcpocMmapPWMOut::~OcpocMmapPWMOut()
+MmapPWMOut::~MmapPWMOut()
 {
-	if (_shared_mem_cmd) {
-		munmap((void *)_shared_mem_cmd, 0x1000);
+	if (_regs) {
+		munmap((void *)_regs, MAP_SIZE);
 	}
 }
 
-unsigned long OcpocMmapPWMOut::freq2tick(uint16_t freq_hz)
+int MmapPWMOut::init()
 {
-	unsigned long duty = TICK_PER_S / (unsigned long)freq_hz;
-	return duty;
-}
+	if ((size_t)(_layout.channel_stride * _layout.max_channels) * sizeof(uint32_t) > MAP_SIZE) {
+		PX4_ERR("register layout exceeds the mapping");
+		return -1;
+	}
 
-int OcpocMmapPWMOut::init()
-{
-	uint32_t mem_fd = open(_device, O_RDWR | O_SYNC);
-	_shared_mem_cmd = (struct pwm_cmd *) mmap(0, 0x1000, PROT_READ | PROT_WRITE,
-			  MAP_SHARED, mem_fd, RCOUT_ZYNQ_PWM_BASE);
+	int mem_fd = open(_device, O_RDWR | O_SYNC | O_CLOEXEC);
+
+	if (mem_fd < 0) {
+		PX4_ERR("open %s failed (%i)", _device, errno);
+		return -1;
+	}
+
+	void *map = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, _layout.base);
 	close(mem_fd);
 
-	if (_shared_mem_cmd == nullptr) {
+	if (map == MAP_FAILED) {
 		PX4_ERR("initialize pwm pointer failed.");
 		return -1;
 	}
 
+	_regs = (volatile uint32_t *)map;
+
+	const uint32_t period = _layout.tick_per_us * 1000000 / FREQUENCY_PWM;
+
 	for (int i = 0; i < _num_outputs; ++i) {
-		_shared_mem_cmd->periodhi[i].period   =  freq2tick(FREQUENCY_PWM);
-		_shared_mem_cmd->periodhi[i].hi = freq2tick(FREQUENCY_PWM) / 2;
-		PX4_DEBUG("Output values: %d, %d", _shared_mem_cmd->periodhi[i].period, _shared_mem_cmd->periodhi[i].hi);
+		volatile uint32_t *channel = _regs + i * _layout.channel_stride;
+		channel[_layout.period_offset] = period;
+		channel[_layout.hi_offset] = period / 2;
+		PX4_DEBUG("Output values: %u, %u", channel[_layout.period_offset], channel[_layout.hi_offset]);
 	}
 
 	return 0;
 }
 
-int OcpocMmapPWMOut::send_output_pwm(const uint16_t *pwm, int num_outputs)
+int MmapPWMOut::send_output_pwm(const uint16_t *pwm, int num_outputs)
 {
 	if (num_outputs > _num_outputs) {
 		num_outputs = _num_outputs;
 	}
 
-	//convert this to duty_cycle in ns
+	// a single sequence of stores to the high time registers, one per channel
+	volatile uint32_t *reg = _regs + _layout.hi_offset;
+
 	for (int i = 0; i < num_outputs; ++i) {
-		//n = ::asprintf(&data, "%u", pwm[i] * 1000);
-		//::write(_pwm_fd[i], data, n);
-		_shared_mem_cmd->periodhi[i].hi = TICK_PER_US * pwm[i];
-		//printf("ch:%d, val:%d*%d ", ch, period_us, TICK_PER_US);
+		*reg = _layout.tick_per_us * pwm[i];
+		reg += _layout.channel_stride;
 	}
 
 	return 0;
 }
-
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "common.h"
+
+#include <stddef.h>
+#include <sys/types.h>
+
+namespace linux_pwm_out
+{
+
+/**
+ ** class MmapPWMOut
+ * PWM output class for memory-mapped PWM register blocks (e.g. the Aerotenna OcPoC FPGA PWM).
+ * All channels are updated with a single sequence of register stores, without any system call.
+ */
+class MmapPWMOut : public PWMOutBase
+{
+public:
+	/**
+	 * Register layout of a PWM block: each channel has a period and a high time register,
+	 * both in timer ticks.
+	 */
+	struct RegisterLayout {
+		off_t base;			///< physical base address of the register block
+		uint32_t tick_per_us;		///< timer ticks per microsecond
+		uint16_t channel_stride;	///< distance between two channels in 32 bit words
+		uint16_t period_offset;		///< offset of the period register within a channel in 32 bit words
+		uint16_t hi_offset;		///< offset of the high time register within a channel in 32 bit words
+		uint8_t max_channels;		///< number of channels of the block
+	};
+
+	/// register layout of the OcPoC (Zynq) PWM block
+	static constexpr RegisterLayout OCPOC_LAYOUT{0x43c00000, 50, 2, 0, 1, 8};
+
+	MmapPWMOut(const RegisterLayout &layout, int max_num_outputs);
+	virtual ~MmapPWMOut();
+
+	int init() override;
+
+	int send_output_pwm(const uint16_t *pwm, int num_outputs) override;
+
+private:
+	static constexpr int FREQUENCY_PWM = 400;
+	static constexpr size_t MAP_SIZE = 0x1000;
+	static constexpr const char *_device = "/dev/mem";
+
+	const RegisterLayout _layout;
+
+	volatile uint32_t *_regs{nullptr};
+	int _num_outputs;
+};
+
+}
@@ -50,6 +50,7 @@ NavioSysfsPWMOut::NavioSysfsPWMOut(const char *device, int max_num_outputs)
 
 	for (int i = 0; i < MAX_NUM_PWM; ++i) {
 		_pwm_fd[i] = -1;
+		_pwm_last[i] = 0;
 	}
 
 	_pwm_num = max_num_outputs;
@@ -118,17 +119,42 @@ int NavioSysfsPWMOut::send_output_pwm(const uint16_t *pwm, int num_outputs)
 
 	//convert this to duty_cycle in ns
 	for (int i = 0; i < num_outputs; ++i) {
-		int n = ::snprintf(data, sizeof(data), "%u", pwm[i] * 1000);
+		// every write is a system call, skip the channels that did not change
+		if (pwm[i] == _pwm_last[i]) {
+			continue;
+		}
+
+		int n = format_uint(data, pwm[i] * 1000);
 		int write_ret = ::write(_pwm_fd[i], data, n);
 
 		if (n != write_ret) {
 			ret = -1;
+
+		} else {
+			_pwm_last[i] = pwm[i];
 		}
 	}
 
 	return ret;
 }
 
+int NavioSysfsPWMOut::format_uint(char *buf, uint32_t value)
+{
+	char digits[10];
+	int n = 0;
+
+	do {
+		digits[n++] = '0' + value % 10;
+		value /= 10;
+	} while (value > 0);
+
+	for (int i = 0; i < n; ++i) {
+		buf[i] = digits[n - 1 - i];
+	}
+
+	return n;
+}
+
 int NavioSysfsPWMOut::pwm_write_sysfs(char *path, int value)
 {
 	int fd = ::open(path, O_WRONLY | O_CLOEXEC);
@@ -55,10 +55,14 @@ public:
 private:
 	int pwm_write_sysfs(char *path, int value);
 
+	/** decimal formatting of value into buf (no terminating zero), returns the length */
+	static int format_uint(char *buf, uint32_t value);
+
 	static const int MAX_NUM_PWM = 14;
 	static const int FREQUENCY_PWM = 400;
 
 	int _pwm_fd[MAX_NUM_PWM];
+	uint16_t _pwm_last[MAX_NUM_PWM];	///< last written value per channel
 	int _pwm_num;
 
 	const char *_device;
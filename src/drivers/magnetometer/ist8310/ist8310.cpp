@@ -212,6 +212,18 @@ private:
 	float				_range_scale{0.003f}; /* default range scale from counts to gauss */
 
 	bool        _collect_phase{false};
+
+#pragma pack(push, 1)
+	struct { /* data as read back from the device */
+		uint8_t     x[2];
+		uint8_t     y[2];
+		uint8_t     z[2];
+	} _report_buffer{};
+#pragma pack(pop)
+
+	uint8_t     _read_cmd{ADDR_DATA_OUT_X_LSB};
+	bool        _read_pending{false};		/**< asynchronous data read in progress */
+	hrt_abstime _read_timestamp{0};
 	int         _class_instance{-1};
 	int         _orb_class_instance{-1};
 
@@ -335,6 +347,19 @@ private:
 	 */
 	int         collect();
 
+	/**
+	 * Start reading the result of the most recent measurement without blocking,
+	 * Run() is scheduled again once the read completed.
+	 */
+	int         collect_start();
+
+	/**
+	 * Publish the measurement in _report_buffer.
+	 *
+	 * @param timestamp	time of the data read
+	 */
+	int         process(hrt_abstime timestamp);
+
 	/**
 	 * Convert a big-endian signed 16-bit value to a float.
 	 *
@@ -656,6 +681,7 @@ IST8310::start()
 {
 	/* reset the report ring and state machine */
 	_collect_phase = false;
+	_read_pending = false;
 	_reports->flush();
 
 	/* schedule a cycle to start things */
@@ -665,6 +691,11 @@ IST8310::start()
 void
 IST8310::stop()
 {
+	/* the completion of a pending read schedules the next cycle */
+	while (transferAsyncPending()) {
+		px4_usleep(100);
+	}
+
 	ScheduleClear();
 }
 
@@ -713,8 +744,26 @@ IST8310::Run()
 	/* collection phase? */
 	if (_collect_phase) {
 
+		if (!_read_pending) {
+			/* read the data without blocking the bus work queue, we get scheduled again once it's done */
+			if (OK != collect_start()) {
+				start();
+			}
+
+			return;
+		}
+
+		_read_pending = false;
+
+		if (OK != transferAsyncResult()) {
+			perf_count(_comms_errors);
+			DEVICE_DEBUG("I2C read error");
+			start();
+			return;
+		}
+
 		/* perform collection */
-		if (OK != collect()) {
+		if (OK != process(_read_timestamp)) {
 			DEVICE_DEBUG("collection error");
 			/* restart the measurement state machine */
 			start();
@@ -766,13 +815,49 @@ IST8310::measure()
 int
 IST8310::collect()
 {
-#pragma pack(push, 1)
-	struct { /* status register and data as read back from the device */
-		uint8_t     x[2];
-		uint8_t     y[2];
-		uint8_t     z[2];
-	} report_buffer;
-#pragma pack(pop)
+	/* this should be fairly close to the end of the measurement, so the best approximation of the time */
+	const hrt_abstime timestamp = hrt_absolute_time();
+
+	/*
+	 * @note  We could read the status register here, which could tell us that
+	 *        we were too early and that the output registers are still being
+	 *        written.  In the common case that would just slow us down, and
+	 *        we're better off just never being early.
+	 */
+
+	/* get measurements from the device */
+	int ret = read(ADDR_DATA_OUT_X_LSB, (uint8_t *)&_report_buffer, sizeof(_report_buffer));
+
+	if (ret != OK) {
+		perf_count(_comms_errors);
+		DEVICE_DEBUG("I2C read error");
+		return ret;
+	}
+
+	return process(timestamp);
+}
+
+int
+IST8310::collect_start()
+{
+	_read_timestamp = hrt_absolute_time();
+
+	int ret = transferAsync(&_read_cmd, 1, (uint8_t *)&_report_buffer, sizeof(_report_buffer), this);
+
+	if (ret != OK) {
+		perf_count(_comms_errors);
+		DEVICE_DEBUG("I2C read error");
+		return ret;
+	}
+
+	_read_pending = true;
+
+	return OK;
+}
+
+int
+IST8310::process(hrt_abstime timestamp)
+{
 	struct {
 		int16_t     x, y, z;
 	} report;
@@ -788,33 +873,16 @@ IST8310::collect()
 	float yraw_f;
 	float zraw_f;
 
-	/* this should be fairly close to the end of the measurement, so the best approximation of the time */
-	new_report.timestamp = hrt_absolute_time();
+	new_report.timestamp = timestamp;
 	new_report.is_external = sensor_is_external;
 	new_report.error_count = perf_event_count(_comms_errors);
 	new_report.scaling = _range_scale;
 	new_report.device_id = _device_id.devid;
 
-	/*
-	 * @note  We could read the status register here, which could tell us that
-	 *        we were too early and that the output registers are still being
-	 *        written.  In the common case that would just slow us down, and
-	 *        we're better off just never being early.
-	 */
-
-	/* get measurements from the device */
-	ret = read(ADDR_DATA_OUT_X_LSB, (uint8_t *)&report_buffer, sizeof(report_buffer));
-
-	if (ret != OK) {
-		perf_count(_comms_errors);
-		DEVICE_DEBUG("I2C read error");
-		goto out;
-	}
-
 	/* swap the data we just received */
-	report.x = (((int16_t)report_buffer.x[1]) << 8) | (int16_t)report_buffer.x[0];
-	report.y = (((int16_t)report_buffer.y[1]) << 8) | (int16_t)report_buffer.y[0];
-	report.z = (((int16_t)report_buffer.z[1]) << 8) | (int16_t)report_buffer.z[0];
+	report.x = (((int16_t)_report_buffer.x[1]) << 8) | (int16_t)_report_buffer.x[0];
+	report.y = (((int16_t)_report_buffer.y[1]) << 8) | (int16_t)_report_buffer.y[0];
+	report.z = (((int16_t)_report_buffer.z[1]) << 8) | (int16_t)_report_buffer.z[0];
 
 
 	/*
@@ -116,16 +116,17 @@ OSDatxxxx::init()
 		return ret;
 	}
 
-	// clear the screen
-	int num_rows = (_param_osd_atxxxx_cfg.get() == 1 ? OSD_NUM_ROWS_NTSC : OSD_NUM_ROWS_PAL);
+	// clear the screen: the display memory content is unknown, send all rows
+	_num_rows = (_param_osd_atxxxx_cfg.get() == 1 ? OSD_NUM_ROWS_NTSC : OSD_NUM_ROWS_PAL);
 
-	for (int i = 0; i < OSD_CHARS_PER_ROW; i++) {
-		for (int j = 0; j < num_rows; j++) {
-			add_character_to_screen(' ', i, j);
-		}
+	for (int j = 0; j < _num_rows; j++) {
+		memset(_screen[j], ' ', OSD_CHARS_PER_ROW);
+		_dirty[j].first = 0;
+		_dirty[j].last = OSD_CHARS_PER_ROW - 1;
+		_dirty_rows |= 1 << j;
 	}
 
-	return ret;
+	return flush_screen();
 }
 
 int
@@ -210,30 +211,79 @@ OSDatxxxx::writeRegister(unsigned reg, uint8_t data)
 int
 OSDatxxxx::add_character_to_screen(char c, uint8_t pos_x, uint8_t pos_y)
 {
-	uint16_t position = (OSD_CHARS_PER_ROW * pos_y) + pos_x;
-	uint8_t position_lsb = 0;
-	int ret = PX4_ERROR;
-
-	if (position > 0xFF) {
-		position_lsb = static_cast<uint8_t>(position) - 0xFF;
-		ret = writeRegister(0x05, 0x01); //DMAH
-
-	} else {
-		position_lsb = static_cast<uint8_t>(position);
-		ret = writeRegister(0x05, 0x00); //DMAH
+	if (pos_x >= OSD_CHARS_PER_ROW || pos_y >= _num_rows) {
+		return PX4_ERROR;
 	}
 
-	if (ret != 0) {
-		return ret;
+	// 0xFF terminates the auto-increment mode, it cannot be written as a character
+	if (static_cast<uint8_t>(c) == 0xFF) {
+		c = ' ';
 	}
 
-	ret = writeRegister(0x06, position_lsb); //DMAL
+	if (_screen[pos_y][pos_x] != c) {
+		_screen[pos_y][pos_x] = c;
 
-	if (ret != 0) {
-		return ret;
+		DirtyRange &dirty = _dirty[pos_y];
+
+		if (!(_dirty_rows & (1 << pos_y))) {
+			dirty.first = pos_x;
+			dirty.last = pos_x;
+			_dirty_rows |= 1 << pos_y;
+
+		} else if (pos_x < dirty.first) {
+			dirty.first = pos_x;
+
+		} else if (pos_x > dirty.last) {
+			dirty.last = pos_x;
+		}
 	}
 
-	ret = writeRegister(0x07, c);
+	return PX4_OK;
+}
+
+int
+OSDatxxxx::flush_screen()
+{
+	int ret = PX4_OK;
+
+	for (int j = 0; j < _num_rows && _dirty_rows != 0; j++) {
+		if (!(_dirty_rows & (1 << j))) {
+			continue;
+		}
+
+		// set the start address, enable auto-increment, write the characters and leave the mode with 0xFF.
+		// Each row is a separate transfer so that other devices on the bus are not blocked for the whole screen.
+		const DirtyRange &dirty = _dirty[j];
+		const uint16_t position = (OSD_CHARS_PER_ROW * j) + dirty.first;
+		uint8_t cmd[2 * (OSD_CHARS_PER_ROW + 4)];
+		unsigned len = 0;
+
+		cmd[len++] = DIR_WRITE(0x05); // DMAH
+		cmd[len++] = (position >> 8) & 0x01;
+		cmd[len++] = DIR_WRITE(0x06); // DMAL
+		cmd[len++] = position & 0xFF;
+		cmd[len++] = DIR_WRITE(0x04); // DMM
+		cmd[len++] = 0x01; // auto-increment
+
+		for (int i = dirty.first; i <= dirty.last; i++) {
+			cmd[len++] = DIR_WRITE(0x07); // DMDI
+			cmd[len++] = _screen[j][i];
+		}
+
+		cmd[len++] = DIR_WRITE(0x07);
+		cmd[len++] = 0xFF;
+
+		const int transfer_ret = transfer(&cmd[0], nullptr, len);
+
+		if (transfer_ret != PX4_OK) {
+			// keep the row dirty and retry with the next update
+			DEVICE_LOG("spi::transfer returned %d", transfer_ret);
+			ret = transfer_ret;
+
+		} else {
+			_dirty_rows &= ~(1 << j);
+		}
+	}
 
 	return ret;
 }
@@ -531,6 +581,8 @@ OSDatxxxx::Run()
 	update_topics();
 
 	update_screen();
+
+	flush_screen();
 }
 
 int
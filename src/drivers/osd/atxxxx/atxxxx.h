@@ -117,6 +117,9 @@ private:
 	int readRegister(unsigned reg, uint8_t *data, unsigned count);
 	int writeRegister(unsigned reg, uint8_t data);
 
+	/**
+	 * Write a character to the screen buffer, it is sent to the chip by the next flush_screen().
+	 */
 	int add_character_to_screen(char c, uint8_t pos_x, uint8_t pos_y);
 	void add_string_to_screen_centered(const char *str, uint8_t pos_y, int max_length);
 	void clear_line(uint8_t pos_x, uint8_t pos_y, int length);
@@ -133,6 +136,23 @@ private:
 	int update_topics();
 	int update_screen();
 
+	/**
+	 * Send the changed part of each row to the display memory, using one SPI transfer per row
+	 * (auto-increment mode) instead of 3 register writes per character.
+	 */
+	int flush_screen();
+
+	// screen buffer and the range of columns of each row that differs from the display memory
+	struct DirtyRange {
+		uint8_t first;
+		uint8_t last;
+	};
+
+	char _screen[OSD_NUM_ROWS_PAL][OSD_CHARS_PER_ROW] {};
+	DirtyRange _dirty[OSD_NUM_ROWS_PAL] {};
+	uint16_t _dirty_rows{0};	///< bitmask of the rows with a dirty range
+	uint8_t _num_rows{OSD_NUM_ROWS_PAL};
+
 	uORB::Subscription _battery_sub{ORB_ID(battery_status)};
 	uORB::Subscription _local_position_sub{ORB_ID(vehicle_local_position)};
 	uORB::Subscription _vehicle_status_sub{ORB_ID(vehicle_status)};
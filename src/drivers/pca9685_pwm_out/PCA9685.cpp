@@ -40,7 +40,7 @@ using namespace drv_pca9685_pwm;
 PCA9685::PCA9685(int bus, int addr):
 	I2C("PCA9685", PWM_OUTPUT0_DEVICE_PATH, bus, addr, 400000)
 {
-
+	invalidateOutputs();
 }
 
 int PCA9685::Start()
@@ -163,13 +163,18 @@ void PCA9685::setPWM(uint8_t channel, const uint16_t &value)
 
 	if (OK != ret) {
 		PX4_DEBUG("i2c::transfer returned %d", ret);
+		_last_value[channel] = UINT16_MAX;
+
+	} else {
+		_last_value[channel] = value;
 	}
 }
 
 void PCA9685::setPWM(uint8_t channel_count, const uint16_t *value)
 {
-	uint8_t buf[PCA9685_PWM_CHANNEL_COUNT * PCA9685_REG_LED_INCREMENT + 1] = {};
-	buf[0] = PCA9685_REG_LED0;
+	// only the range between the first and the last changed channel is written, relying on register auto-increment
+	int first = -1;
+	int last = -1;
 
 	for (int i = 0; i < channel_count; ++i) {
 		if (value[i] >= 4096) {
@@ -177,22 +182,46 @@ void PCA9685::setPWM(uint8_t channel_count, const uint16_t *value)
 			return;
 		}
 
-		buf[1 + i * PCA9685_REG_LED_INCREMENT] = 0x00;
-		buf[2 + i * PCA9685_REG_LED_INCREMENT] = 0x00;
-		buf[3 + i * PCA9685_REG_LED_INCREMENT] = (uint8_t)(value[i] & (uint8_t)0xFF);
-		buf[4 + i * PCA9685_REG_LED_INCREMENT] = value[i] != 0 ? ((uint8_t)(value[i] >> (uint8_t)8)) :
-				PCA9685_LED_ON_FULL_ON_OFF_MASK;
+		if (value[i] != _last_value[i]) {
+			if (first < 0) {
+				first = i;
+			}
+
+			last = i;
+		}
+	}
+
+	if (first < 0) {
+		return;
 	}
 
-	int ret = transfer(buf, channel_count * PCA9685_REG_LED_INCREMENT + 1, nullptr, 0);
+	uint8_t buf[PCA9685_PWM_CHANNEL_COUNT * PCA9685_REG_LED_INCREMENT + 1] = {};
+	buf[0] = PCA9685_REG_LED0 + first * PCA9685_REG_LED_INCREMENT;
+
+	for (int i = first; i <= last; ++i) {
+		uint8_t *led = &buf[1 + (i - first) * PCA9685_REG_LED_INCREMENT];
+		led[0] = 0x00;
+		led[1] = 0x00;
+		led[2] = (uint8_t)(value[i] & (uint8_t)0xFF);
+		led[3] = value[i] != 0 ? ((uint8_t)(value[i] >> (uint8_t)8)) : PCA9685_LED_ON_FULL_ON_OFF_MASK;
+	}
+
+	int ret = transfer(buf, (last - first + 1) * PCA9685_REG_LED_INCREMENT + 1, nullptr, 0);
 
 	if (OK != ret) {
 		PX4_DEBUG("i2c::transfer returned %d", ret);
+		return;
+	}
+
+	for (int i = first; i <= last; ++i) {
+		_last_value[i] = value[i];
 	}
 }
 
 void PCA9685::disableAllOutput()
 {
+	invalidateOutputs();
+
 	uint8_t buf[5] = {};
 	buf[0] = PCA9685_REG_ALLLED_ON_L;
 	buf[1] = 0x00;
@@ -207,6 +236,13 @@ void PCA9685::disableAllOutput()
 	}
 }
 
+void PCA9685::invalidateOutputs()
+{
+	for (auto &last_value : _last_value) {
+		last_value = UINT16_MAX;
+	}
+}
+
 void PCA9685::setDivider(uint8_t value)
 {
 	disableAllOutput();
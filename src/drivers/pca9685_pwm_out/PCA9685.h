@@ -131,7 +131,7 @@ protected:
 	void setPWM(uint8_t channel, const uint16_t &value);
 
 	/**
-	 * set all PWMs in a single I2C transmission.
+	 * set all PWMs in a single I2C transmission, only the range of channels that changed is written.
 	 * value should be range of 0-4095
 	 */
 	void setPWM(uint8_t channel_count, const uint16_t *value);
@@ -141,6 +141,11 @@ protected:
 	 */
 	void disableAllOutput();
 
+	/*
+	 * forget the last written values, the next update writes all channels
+	 */
+	void invalidateOutputs();
+
 	/*
 	 * set clock divider
 	 * this func has Super Cow Powers
@@ -157,7 +162,7 @@ protected:
 	 */
 	void restartOscillator();
 private:
-
+	uint16_t _last_value[PCA9685_PWM_CHANNEL_COUNT]; ///< last value written per channel
 };
 
 }
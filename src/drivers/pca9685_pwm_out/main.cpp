@@ -480,6 +480,11 @@ int PWMDriverWrapper::ioctl(cdev::file_t *filep, int cmd, unsigned long arg)
 			break;
 		}
 
+	case MIXERIOCLOADBIN:
+		ret = _mixing_output.loadMixerBinaryThreadSafe((const void *)arg);
+
+		break;
+
 	default:
 		ret = -ENOTTY;
 		break;
@@ -221,6 +221,10 @@ PWMSim::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 			break;
 		}
 
+	case MIXERIOCLOADBIN:
+		ret = _mixing_output.loadMixerBinaryThreadSafe((const void *)arg);
+		break;
+
 
 	default:
 		ret = -ENOTTY;
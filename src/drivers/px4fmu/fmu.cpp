@@ -1480,6 +1480,12 @@ PX4FMU::pwm_ioctl(file *filp, int cmd, unsigned long arg)
 			break;
 		}
 
+	case MIXERIOCLOADBIN:
+		ret = _mixing_output.loadMixerBinaryThreadSafe((const void *)arg);
+		update_pwm_trims();
+
+		break;
+
 	default:
 		ret = -ENOTTY;
 		break;
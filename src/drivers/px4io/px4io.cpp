@@ -300,6 +300,34 @@ private:
 	MotorTest _motor_test;
 	bool                    _hitl_mode;     ///< Hardware-in-the-loop simulation mode - don't publish actuator_outputs
 
+	/**
+	 * The transactions of one update cycle, transferred with a single packet each way (PKT_CODE_BATCH).
+	 */
+	struct IOBatch {
+		uint16_t regs[PKT_MAX_REGS];
+		unsigned count{0};
+		bool transferred{false};
+
+		/**
+		 * Queue a read.
+		 *
+		 * @return		The registers the values are read into, or nullptr if the batch is full.
+		 */
+		uint16_t *read(uint8_t page, uint8_t offset, unsigned num_values);
+
+		/**
+		 * Queue a write.
+		 *
+		 * @return		false if the batch is full.
+		 */
+		bool write(uint8_t page, uint8_t offset, const uint16_t *values, unsigned num_values);
+
+		/**
+		 * @return		The values of a read, or nullptr if it was not transferred or IO failed it.
+		 */
+		const uint16_t *result(const uint16_t *values) const;
+	};
+
 	/**
 	 * Trampoline to the worker task
 	 */
@@ -312,13 +340,20 @@ private:
 
 	/**
 	 * Send controls for one group to IO
+	 *
+	 * @param batch		Queue the write in this batch if it fits, instead of writing directly.
 	 */
-	int			io_set_control_state(unsigned group);
+	int			io_set_control_state(unsigned group, IOBatch *batch = nullptr);
 
 	/**
 	 * Send all controls to IO
 	 */
-	int			io_set_control_groups();
+	int			io_set_control_groups(IOBatch *batch = nullptr);
+
+	/**
+	 * Transfer the queued transactions of a batch.
+	 */
+	int			io_batch_transfer(IOBatch &batch);
 
 	/**
 	 * Update IO's arming-related state
@@ -334,8 +369,10 @@ private:
 	 * Fetch status and alarms from IO
 	 *
 	 * Also publishes battery voltage/current.
+	 *
+	 * @param status	STATUS_FLAGS..STATUS_MIXER already read with a batch, or nullptr to read them.
 	 */
-	int			io_get_status();
+	int			io_get_status(const uint16_t *status = nullptr);
 
 	/**
 	 * Disable RC input handling
@@ -346,19 +383,25 @@ private:
 	 * Fetch RC inputs from IO.
 	 *
 	 * @param input_rc	Input structure to populate.
+	 * @param raw_rc	RAW_RC_COUNT.. already read with a batch, or nullptr to read them.
+	 * @param raw_rc_channels The number of channels in raw_rc.
 	 * @return		OK if data was returned.
 	 */
-	int			io_get_raw_rc_input(input_rc_s &input_rc);
+	int			io_get_raw_rc_input(input_rc_s &input_rc, const uint16_t *raw_rc = nullptr,
+			unsigned raw_rc_channels = 0);
 
 	/**
 	 * Fetch and publish raw RC input data.
 	 */
-	int			io_publish_raw_rc();
+	int			io_publish_raw_rc(const uint16_t *raw_rc = nullptr, unsigned raw_rc_channels = 0);
 
 	/**
 	 * Fetch and publish the PWM servo outputs.
+	 *
+	 * @param servos	The servo outputs already read with a batch, or nullptr to read them.
+	 * @param mixer_status	STATUS_MIXER already read with a batch, or nullptr to read it.
 	 */
-	int			io_publish_pwm_outputs();
+	int			io_publish_pwm_outputs(const uint16_t *servos = nullptr, const uint16_t *mixer_status = nullptr);
 
 	/**
 	 * write register(s)
@@ -958,12 +1001,15 @@ PX4IO::task_main()
 		perf_begin(_perf_update);
 		hrt_abstime now = hrt_absolute_time();
 
+		/* the controls and the polled registers are transferred with one packet each way */
+		IOBatch batch;
+
 		/* if we have new control data from the ORB, handle it */
 		if (fds[0].revents & POLLIN) {
 
 			/* we're not nice to the lower-priority control groups and only check them
 			   when the primary group updated (which is now). */
-			(void)io_set_control_groups();
+			(void)io_set_control_groups(&batch);
 		}
 
 		if (!_armed && !_lockdown_override) {
@@ -977,14 +1023,29 @@ PX4IO::task_main()
 			/* run at 50-250Hz */
 			poll_last = now;
 
+			/* status and alarms, R/C input with at least the first 9 channels, and the PWM outputs */
+			const unsigned raw_rc_channels = math::max(_rc_chan_count, 9u);
+			const uint16_t *status = batch.read(PX4IO_PAGE_STATUS, PX4IO_P_STATUS_FLAGS,
+							    PX4IO_P_STATUS_MIXER - PX4IO_P_STATUS_FLAGS + 1);
+			const uint16_t *raw_rc = batch.read(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_COUNT,
+							    PX4IO_P_RAW_RC_BASE - PX4IO_P_RAW_RC_COUNT + raw_rc_channels);
+			const uint16_t *servos = _hitl_mode ? nullptr : batch.read(PX4IO_PAGE_SERVOS, 0, _max_actuators);
+
+			(void)io_batch_transfer(batch);
+
+			/* anything that did not fit or failed is read on its own */
+			status = batch.result(status);
+			raw_rc = batch.result(raw_rc);
+			servos = batch.result(servos);
+
 			/* pull status and alarms from IO */
-			io_get_status();
+			io_get_status(status);
 
 			/* get raw R/C input from IO */
-			io_publish_raw_rc();
+			io_publish_raw_rc(raw_rc, raw_rc ? raw_rc_channels : 0);
 
 			/* fetch PWM outputs from IO */
-			io_publish_pwm_outputs();
+			io_publish_pwm_outputs(servos, status ? &status[PX4IO_P_STATUS_MIXER - PX4IO_P_STATUS_FLAGS] : nullptr);
 
 			/* check updates on uORB topics and handle it */
 			bool updated = false;
@@ -999,6 +1060,9 @@ PX4IO::task_main()
 			if (updated) {
 				io_set_arming_state();
 			}
+
+		} else {
+			(void)io_batch_transfer(batch);
 		}
 
 		if (!_armed && (now >= orb_check_last + ORB_CHECK_INTERVAL)) {
@@ -1251,20 +1315,20 @@ out:
 }
 
 int
-PX4IO::io_set_control_groups()
+PX4IO::io_set_control_groups(IOBatch *batch)
 {
-	int ret = io_set_control_state(0);
+	int ret = io_set_control_state(0, batch);
 
 	/* send auxiliary control groups */
-	(void)io_set_control_state(1);
-	(void)io_set_control_state(2);
-	(void)io_set_control_state(3);
+	(void)io_set_control_state(1, batch);
+	(void)io_set_control_state(2, batch);
+	(void)io_set_control_state(3, batch);
 
 	return ret;
 }
 
 int
-PX4IO::io_set_control_state(unsigned group)
+PX4IO::io_set_control_state(unsigned group, IOBatch *batch)
 {
 	actuator_controls_s	controls{};	///< actuator outputs
 
@@ -1323,6 +1387,10 @@ PX4IO::io_set_control_state(unsigned group)
 	}
 
 	if (!_test_fmu_fail && !_motor_test.in_test_mode) {
+		if (batch && batch->write(PX4IO_PAGE_CONTROLS, group * PX4IO_PROTOCOL_MAX_CONTROL_COUNT, regs, _max_controls)) {
+			return OK;
+		}
+
 		/* copy values to registers in IO */
 		return io_reg_set(PX4IO_PAGE_CONTROLS, group * PX4IO_PROTOCOL_MAX_CONTROL_COUNT, regs, _max_controls);
 
@@ -1758,19 +1826,25 @@ PX4IO::io_handle_vservo(uint16_t vservo, uint16_t vrssi)
 }
 
 int
-PX4IO::io_get_status()
+PX4IO::io_get_status(const uint16_t *status)
 {
-	uint16_t	regs[6];
-	int		ret;
+	uint16_t	status_regs[6];
+	int		ret = OK;
+	const uint16_t	*regs = status;
+
+	if (regs == nullptr) {
+		/* get
+		 * STATUS_FLAGS, STATUS_ALARMS, STATUS_VBATT, STATUS_IBATT,
+		 * STATUS_VSERVO, STATUS_VRSSI, STATUS_PRSSI
+		 * in that order */
+		ret = io_reg_get(PX4IO_PAGE_STATUS, PX4IO_P_STATUS_FLAGS, &status_regs[0],
+				 sizeof(status_regs) / sizeof(status_regs[0]));
 
-	/* get
-	 * STATUS_FLAGS, STATUS_ALARMS, STATUS_VBATT, STATUS_IBATT,
-	 * STATUS_VSERVO, STATUS_VRSSI, STATUS_PRSSI
-	 * in that order */
-	ret = io_reg_get(PX4IO_PAGE_STATUS, PX4IO_P_STATUS_FLAGS, &regs[0], sizeof(regs) / sizeof(regs[0]));
+		if (ret != OK) {
+			return ret;
+		}
 
-	if (ret != OK) {
-		return ret;
+		regs = status_regs;
 	}
 
 	io_handle_status(regs[0]);
@@ -1782,7 +1856,7 @@ PX4IO::io_get_status()
 }
 
 int
-PX4IO::io_get_raw_rc_input(input_rc_s &input_rc)
+PX4IO::io_get_raw_rc_input(input_rc_s &input_rc, const uint16_t *raw_rc, unsigned raw_rc_channels)
 {
 	uint32_t channel_count;
 	int	ret;
@@ -1793,15 +1867,25 @@ PX4IO::io_get_raw_rc_input(input_rc_s &input_rc)
 	const unsigned prolog = (PX4IO_P_RAW_RC_BASE - PX4IO_P_RAW_RC_COUNT);
 	uint16_t regs[input_rc_s::RC_INPUT_MAX_CHANNELS + prolog];
 
-	/*
-	 * Read the channel count and the first 9 channels.
-	 *
-	 * This should be the common case (9 channel R/C control being a reasonable upper bound).
-	 */
-	ret = io_reg_get(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_COUNT, &regs[0], prolog + 9);
+	unsigned read_channels = 9;
 
-	if (ret != OK) {
-		return ret;
+	if (raw_rc != nullptr) {
+		/* the channel count and the channels already read with the batch */
+		read_channels = math::min(raw_rc_channels, (unsigned)input_rc_s::RC_INPUT_MAX_CHANNELS);
+		memcpy(&regs[0], raw_rc, (prolog + read_channels) * sizeof(regs[0]));
+		ret = OK;
+
+	} else {
+		/*
+		 * Read the channel count and the first 9 channels.
+		 *
+		 * This should be the common case (9 channel R/C control being a reasonable upper bound).
+		 */
+		ret = io_reg_get(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_COUNT, &regs[0], prolog + 9);
+
+		if (ret != OK) {
+			return ret;
+		}
 	}
 
 	/*
@@ -1854,8 +1938,9 @@ PX4IO::io_get_raw_rc_input(input_rc_s &input_rc)
 	/* FIELDS NOT SET HERE */
 	/* input_rc.input_source is set after this call XXX we might want to mirror the flags in the RC struct */
 
-	if (channel_count > 9) {
-		ret = io_reg_get(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_BASE + 9, &regs[prolog + 9], channel_count - 9);
+	if (channel_count > read_channels) {
+		ret = io_reg_get(PX4IO_PAGE_RAW_RC_INPUT, PX4IO_P_RAW_RC_BASE + read_channels, &regs[prolog + read_channels],
+				 channel_count - read_channels);
 
 		if (ret != OK) {
 			return ret;
@@ -1885,7 +1970,7 @@ PX4IO::io_get_raw_rc_input(input_rc_s &input_rc)
 }
 
 int
-PX4IO::io_publish_raw_rc()
+PX4IO::io_publish_raw_rc(const uint16_t *raw_rc, unsigned raw_rc_channels)
 {
 
 	/* fetch values from IO */
@@ -1894,7 +1979,7 @@ PX4IO::io_publish_raw_rc()
 	/* set the RC status flag ORDER MATTERS! */
 	rc_val.rc_lost = !(_status & PX4IO_P_STATUS_FLAGS_RC_OK);
 
-	int ret = io_get_raw_rc_input(rc_val);
+	int ret = io_get_raw_rc_input(rc_val, raw_rc, raw_rc_channels);
 
 	if (ret != OK) {
 		return ret;
@@ -1929,18 +2014,25 @@ PX4IO::io_publish_raw_rc()
 }
 
 int
-PX4IO::io_publish_pwm_outputs()
+PX4IO::io_publish_pwm_outputs(const uint16_t *servos, const uint16_t *mixer_status)
 {
 	if (_hitl_mode) {
 		return OK;
 	}
 
 	/* get servo values from IO */
-	uint16_t ctl[_max_actuators];
-	int ret = io_reg_get(PX4IO_PAGE_SERVOS, 0, ctl, _max_actuators);
+	uint16_t servo_regs[_max_actuators];
+	const uint16_t *ctl = servos;
+	int ret = OK;
 
-	if (ret != OK) {
-		return ret;
+	if (ctl == nullptr) {
+		ret = io_reg_get(PX4IO_PAGE_SERVOS, 0, servo_regs, _max_actuators);
+
+		if (ret != OK) {
+			return ret;
+		}
+
+		ctl = servo_regs;
 	}
 
 	actuator_outputs_s outputs = {};
@@ -1956,10 +2048,16 @@ PX4IO::io_publish_pwm_outputs()
 
 	/* get mixer status flags from IO */
 	MultirotorMixer::saturation_status saturation_status;
-	ret = io_reg_get(PX4IO_PAGE_STATUS, PX4IO_P_STATUS_MIXER, &saturation_status.value, 1);
 
-	if (ret != OK) {
-		return ret;
+	if (mixer_status != nullptr) {
+		saturation_status.value = *mixer_status;
+
+	} else {
+		ret = io_reg_get(PX4IO_PAGE_STATUS, PX4IO_P_STATUS_MIXER, &saturation_status.value, 1);
+
+		if (ret != OK) {
+			return ret;
+		}
 	}
 
 	/* publish mixer status */
@@ -1974,6 +2072,67 @@ PX4IO::io_publish_pwm_outputs()
 	return OK;
 }
 
+uint16_t *
+PX4IO::IOBatch::read(uint8_t page, uint8_t offset, unsigned num_values)
+{
+	if (count + PKT_BATCH_HEADER_SIZE + num_values > PKT_MAX_REGS) {
+		return nullptr;
+	}
+
+	regs[count++] = PKT_BATCH_ADDRESS(page, offset);
+	regs[count++] = num_values;
+	uint16_t *values = &regs[count];
+	count += num_values;
+
+	return values;
+}
+
+bool
+PX4IO::IOBatch::write(uint8_t page, uint8_t offset, const uint16_t *values, unsigned num_values)
+{
+	if (count + PKT_BATCH_HEADER_SIZE + num_values > PKT_MAX_REGS) {
+		return false;
+	}
+
+	regs[count++] = PKT_BATCH_ADDRESS(page, offset);
+	regs[count++] = num_values | PKT_BATCH_WRITE;
+	memcpy(&regs[count], values, num_values * sizeof(regs[0]));
+	count += num_values;
+
+	return true;
+}
+
+const uint16_t *
+PX4IO::IOBatch::result(const uint16_t *values) const
+{
+	/* the flags of a transaction precede its values */
+	if (values == nullptr || !transferred || (values[-1] & PKT_BATCH_ERROR)) {
+		return nullptr;
+	}
+
+	return values;
+}
+
+int
+PX4IO::io_batch_transfer(IOBatch &batch)
+{
+	if (batch.count == 0) {
+		return OK;
+	}
+
+	int ret = _interface->read(PX4IO_PAGE_BATCH << 8, reinterpret_cast<void *>(batch.regs), batch.count);
+
+	if (ret != (int)batch.count) {
+		PX4_DEBUG("io_batch_transfer(%u): error %d", batch.count, ret);
+		return -1;
+	}
+
+	batch.transferred = true;
+
+	/* a failed write of the batch is not retried, the same as io_reg_set() */
+	return OK;
+}
+
 int
 PX4IO::io_reg_set(uint8_t page, uint8_t offset, const uint16_t *values, unsigned num_values)
 {
@@ -3096,9 +3255,9 @@ checkcrc(int argc, char *argv[])
 	const uint32_t app_size_max = 0xf000;
 	uint32_t fw_crc = 0;
 	uint32_t nbytes = 0;
+	uint8_t buf[64];
 
 	while (true) {
-		uint8_t buf[16];
 		int n = read(fd, buf, sizeof(buf));
 
 		if (n <= 0) { break; }
@@ -3109,10 +3268,13 @@ checkcrc(int argc, char *argv[])
 
 	close(fd);
 
+	/* the rest of the flash is blank */
+	memset(buf, 0xff, sizeof(buf));
+
 	while (nbytes < app_size_max) {
-		uint8_t b = 0xff;
-		fw_crc = crc32part(&b, 1, fw_crc);
-		nbytes++;
+		const uint32_t n = math::min(app_size_max - nbytes, (uint32_t)sizeof(buf));
+		fw_crc = crc32part(buf, n, fw_crc);
+		nbytes += n;
 	}
 
 	int ret = g_dev->ioctl(nullptr, PX4IO_CHECK_CRC, fw_crc);
@@ -172,6 +172,10 @@ PX4IO_serial::read(unsigned address, void *data, unsigned count)
 		return -EINVAL;
 	}
 
+	if (page == PX4IO_PAGE_BATCH) {
+		return transfer_batch(values, count);
+	}
+
 	px4_sem_wait(&_bus_semaphore);
 
 	int result;
@@ -228,3 +232,54 @@ PX4IO_serial::read(unsigned address, void *data, unsigned count)
 
 	return result;
 }
+
+int
+PX4IO_serial::transfer_batch(uint16_t *regs, unsigned count)
+{
+	px4_sem_wait(&_bus_semaphore);
+
+	int result;
+
+	for (unsigned retries = 0; retries < 3; retries++) {
+
+		_io_buffer_ptr->count_code = count | PKT_CODE_BATCH;
+		_io_buffer_ptr->page = 0;
+		_io_buffer_ptr->offset = 0;
+		memcpy((void *)&_io_buffer_ptr->regs[0], (void *)regs, (2 * count));
+
+		_io_buffer_ptr->crc = 0;
+		_io_buffer_ptr->crc = crc_packet(_io_buffer_ptr);
+
+		/* start the transaction and wait for it to complete */
+		result = _bus_exchange(_io_buffer_ptr);
+
+		/* successful transaction? */
+		if (result == OK) {
+
+			/* check result in packet */
+			if (PKT_CODE(*_io_buffer_ptr) != PKT_CODE_SUCCESS || PKT_COUNT(*_io_buffer_ptr) != count) {
+
+				/* IO did not understand the batch - no point retrying */
+				result = -EIO;
+				perf_count(_pc_protoerrs);
+
+			} else {
+
+				/* copy back the result, including the per transaction error flags */
+				memcpy(regs, &_io_buffer_ptr->regs[0], (2 * count));
+			}
+
+			break;
+		}
+
+		perf_count(_pc_retries);
+	}
+
+	px4_sem_post(&_bus_semaphore);
+
+	if (result == OK) {
+		result = count;
+	}
+
+	return result;
+}
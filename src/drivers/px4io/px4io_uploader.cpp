@@ -191,6 +191,19 @@ PX4IO_Uploader::upload(const char *filenames[])
 			}
 		}
 
+		/* skip the update if IO already has the firmware (e.g. it only got stuck in the bootloader) */
+		if (bl_rev >= 3 && crc_matches(fw_size)) {
+			log("firmware up to date, skipping update");
+
+			ret = reboot();
+
+			if (ret != OK) {
+				log("reboot failed");
+			}
+
+			break;
+		}
+
 		ret = erase();
 
 		if (ret != OK) {
@@ -328,17 +341,23 @@ PX4IO_Uploader::send(uint8_t c)
 int
 PX4IO_Uploader::send(uint8_t *p, unsigned count)
 {
-	int ret;
+#ifdef UDEBUG
+	log("send %u bytes", count);
+#endif
 
-	while (count--) {
-		ret = send(*p++);
+	/* write everything at once instead of a syscall per byte */
+	while (count > 0) {
+		ssize_t n = write(_io_fd, p, count);
 
-		if (ret != OK) {
-			break;
+		if (n <= 0) {
+			return -errno;
 		}
+
+		p += n;
+		count -= n;
 	}
 
-	return ret;
+	return OK;
 }
 
 int
@@ -373,8 +392,10 @@ PX4IO_Uploader::sync()
 	drain();
 
 	/* complete any pending program operation */
-	for (unsigned i = 0; i < (PROG_MULTI_MAX + 6); i++) {
-		send(0);
+	uint8_t zeros[16] {};
+
+	for (unsigned i = 0; i < (PROG_MULTI_MAX + 6); i += sizeof(zeros)) {
+		send(zeros, sizeof(zeros));
 	}
 
 	send(PROTO_GET_SYNC);
@@ -431,14 +452,15 @@ static int read_with_retry(int fd, void *buf, size_t n)
 int
 PX4IO_Uploader::program(size_t fw_size)
 {
-	uint8_t	*file_buf;
+	uint8_t	*packet;
 	ssize_t count;
 	int ret;
 	size_t sent = 0;
 
-	file_buf = new uint8_t[PROG_MULTI_MAX];
+	/* a packet is sent with a single write: command, length, data and EOC */
+	packet = new uint8_t[PROG_MULTI_MAX + 3];
 
-	if (!file_buf) {
+	if (!packet) {
 		log("Can't allocate program buffer");
 		return -ENOMEM;
 	}
@@ -458,7 +480,7 @@ PX4IO_Uploader::program(size_t fw_size)
 			n = PROG_MULTI_MAX;
 		}
 
-		count = read_with_retry(_fw_fd, file_buf, n);
+		count = read_with_retry(_fw_fd, &packet[2], n);
 
 		if (count != (ssize_t)n) {
 			log("firmware read of %u bytes at %u failed -> %d errno %d",
@@ -472,10 +494,15 @@ PX4IO_Uploader::program(size_t fw_size)
 
 		sent += count;
 
-		send(PROTO_PROG_MULTI);
-		send(count);
-		send(file_buf, count);
-		send(PROTO_EOC);
+		packet[0] = PROTO_PROG_MULTI;
+		packet[1] = count;
+		packet[count + 2] = PROTO_EOC;
+
+		ret = send(packet, count + 3);
+
+		if (ret != OK) {
+			break;
+		}
 
 		ret = get_sync(1000);
 
@@ -484,7 +511,7 @@ PX4IO_Uploader::program(size_t fw_size)
 		}
 	}
 
-	delete [] file_buf;
+	delete [] packet;
 	return ret;
 }
 
@@ -569,29 +596,33 @@ PX4IO_Uploader::verify_rev2(size_t fw_size)
 }
 
 int
-PX4IO_Uploader::verify_rev3(size_t fw_size_local)
+PX4IO_Uploader::get_crc(uint32_t &crc)
 {
 	int ret;
-	uint8_t	file_buf[4];
-	ssize_t count;
-	uint32_t sum = 0;
-	uint32_t bytes_read = 0;
-	uint32_t crc = 0;
-	uint32_t fw_size_remote;
-	uint8_t fill_blank = 0xff;
 
-	log("verify...");
-	lseek(_fw_fd, 0, SEEK_SET);
-
-	ret = get_info(INFO_FLASH_SIZE, fw_size_remote);
+	send(PROTO_GET_CRC);
 	send(PROTO_EOC);
 
+	ret = recv_bytes((uint8_t *)(&crc), sizeof(crc));
+
 	if (ret != OK) {
-		log("could not read firmware size");
 		return ret;
 	}
 
-	/* read through the firmware file again and calculate the checksum*/
+	return get_sync();
+}
+
+int
+PX4IO_Uploader::firmware_crc(size_t fw_size_local, uint32_t fw_size_remote, uint32_t &crc)
+{
+	uint8_t	file_buf[64];
+	ssize_t count;
+	uint32_t bytes_read = 0;
+
+	crc = 0;
+	lseek(_fw_fd, 0, SEEK_SET);
+
+	/* read through the firmware file and calculate the checksum */
 	while (bytes_read < fw_size_local) {
 		size_t n = fw_size_local - bytes_read;
 
@@ -620,29 +651,76 @@ PX4IO_Uploader::verify_rev3(size_t fw_size_local)
 		}
 
 		/* calculate crc32 sum */
-		sum = crc32part((uint8_t *)&file_buf, sizeof(file_buf), sum);
+		crc = crc32part(file_buf, count, crc);
 
 		bytes_read += count;
 	}
 
 	/* fill the rest with 0xff */
+	memset(file_buf, 0xff, sizeof(file_buf));
+
 	while (bytes_read < fw_size_remote) {
-		sum = crc32part(&fill_blank, sizeof(fill_blank), sum);
-		bytes_read += sizeof(fill_blank);
+		size_t n = fw_size_remote - bytes_read;
+
+		if (n > sizeof(file_buf)) {
+			n = sizeof(file_buf);
+		}
+
+		crc = crc32part(file_buf, n, crc);
+		bytes_read += n;
 	}
 
-	/* request CRC from IO */
-	send(PROTO_GET_CRC);
+	return OK;
+}
+
+bool
+PX4IO_Uploader::crc_matches(size_t fw_size)
+{
+	uint32_t fw_size_remote;
+	uint32_t sum;
+	uint32_t crc;
+
+	if (get_info(INFO_FLASH_SIZE, fw_size_remote) != OK) {
+		return false;
+	}
+
+	if (firmware_crc(fw_size, fw_size_remote, sum) != OK) {
+		return false;
+	}
+
+	if (get_crc(crc) != OK) {
+		return false;
+	}
+
+	return sum == crc;
+}
+
+int
+PX4IO_Uploader::verify_rev3(size_t fw_size_local)
+{
+	int ret;
+	uint32_t sum = 0;
+	uint32_t crc = 0;
+	uint32_t fw_size_remote;
+
+	log("verify...");
+
+	ret = get_info(INFO_FLASH_SIZE, fw_size_remote);
 	send(PROTO_EOC);
 
-	ret = recv_bytes((uint8_t *)(&crc), sizeof(crc));
+	if (ret != OK) {
+		log("could not read firmware size");
+		return ret;
+	}
+
+	ret = firmware_crc(fw_size_local, fw_size_remote, sum);
 
 	if (ret != OK) {
-		log("did not receive CRC checksum");
 		return ret;
 	}
 
-	ret = get_sync();
+	/* request CRC from IO */
+	ret = get_crc(crc);
 
 	if (ret != OK) {
 		log("did not receive CRC checksum");
@@ -100,6 +100,9 @@ private:
 	int			get_sync(unsigned timeout = 40);
 	int			sync();
 	int			get_info(int param, uint32_t &val);
+	int			get_crc(uint32_t &crc);
+	int			firmware_crc(size_t fw_size_local, uint32_t fw_size_remote, uint32_t &crc);
+	bool			crc_matches(size_t fw_size);
 	int			erase();
 	int			program(size_t fw_size);
 	int			verify_rev2(size_t fw_size);
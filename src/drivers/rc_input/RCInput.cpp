@@ -228,6 +228,93 @@ RCInput::fill_rc_in(uint16_t raw_rc_count_local,
 	_rc_in.rc_total_frame_count = 0;
 }
 
+bool RCInput::decode_dsm(hrt_abstime now, int newBytes)
+{
+	bool dsm_11_bit;
+	unsigned frame_drops;
+	int8_t dsm_rssi;
+
+	if (dsm_parse(now, &_rcs_buf[0], newBytes, &_raw_rc_values[0], &_raw_rc_count,
+		      &dsm_11_bit, &frame_drops, &dsm_rssi, input_rc_s::RC_INPUT_MAX_CHANNELS)) {
+		// we have a new DSM frame. Publish it.
+		_rc_in.input_source = input_rc_s::RC_INPUT_SOURCE_PX4FMU_DSM;
+		fill_rc_in(_raw_rc_count, _raw_rc_values, now, false, false, frame_drops, dsm_rssi);
+		_rc_scan_locked = true;
+		return true;
+	}
+
+	return false;
+}
+
+bool RCInput::decode_st24(hrt_abstime now, int newBytes)
+{
+	bool rc_updated = false;
+	uint8_t st24_rssi = RC_INPUT_RSSI_MAX;
+	uint8_t lost_count = 0;
+
+	for (int i = 0; i < newBytes; i++) {
+		/* set updated flag if one complete packet was parsed */
+		uint8_t rssi = RC_INPUT_RSSI_MAX;
+		uint8_t lost = 0;
+
+		if (OK == st24_decode(_rcs_buf[i], &rssi, &lost, &_raw_rc_count, _raw_rc_values,
+				      input_rc_s::RC_INPUT_MAX_CHANNELS)) {
+			rc_updated = true;
+			st24_rssi = rssi;
+			lost_count = lost;
+		}
+	}
+
+	if (!rc_updated) {
+		return false;
+	}
+
+	// The st24 will keep outputting RC channels and RSSI even if RC has been lost.
+	// The only way to detect RC loss is therefore to look at the lost_count.
+	if (lost_count == 0) {
+		// we have a new ST24 frame. Publish it.
+		_rc_in.input_source = input_rc_s::RC_INPUT_SOURCE_PX4FMU_ST24;
+		fill_rc_in(_raw_rc_count, _raw_rc_values, now, false, false, 0, st24_rssi);
+		_rc_scan_locked = true;
+
+	} else {
+		// if the lost count > 0 means that there is an RC loss
+		_rc_in.rc_lost = true;
+	}
+
+	return true;
+}
+
+bool RCInput::decode_sumd(hrt_abstime now, int newBytes)
+{
+	bool rc_updated = false;
+	uint8_t sumd_rssi = RC_INPUT_RSSI_MAX;
+	bool sumd_failsafe = false;
+
+	for (int i = 0; i < newBytes; i++) {
+		/* set updated flag if one complete packet was parsed */
+		uint8_t rssi = RC_INPUT_RSSI_MAX;
+		uint8_t rx_count;
+		bool failsafe;
+
+		if (OK == sumd_decode(_rcs_buf[i], &rssi, &rx_count, &_raw_rc_count, _raw_rc_values,
+				      input_rc_s::RC_INPUT_MAX_CHANNELS, &failsafe)) {
+			rc_updated = true;
+			sumd_rssi = rssi;
+			sumd_failsafe = failsafe;
+		}
+	}
+
+	if (rc_updated) {
+		// we have a new SUMD frame. Publish it.
+		_rc_in.input_source = input_rc_s::RC_INPUT_SOURCE_PX4FMU_SUMD;
+		fill_rc_in(_raw_rc_count, _raw_rc_values, now, false, sumd_failsafe, 0, sumd_rssi);
+		_rc_scan_locked = true;
+	}
+
+	return rc_updated;
+}
+
 void RCInput::set_rc_scan_state(RC_SCAN newState)
 {
 	PX4_DEBUG("RCscan: %s failed, trying %s", RCInput::RC_SCAN_STRING[_rc_scan_state], RCInput::RC_SCAN_STRING[newState]);
@@ -337,7 +424,6 @@ void RCInput::Run()
 
 		bool sbus_failsafe, sbus_frame_drop;
 		unsigned frame_drops;
-		bool dsm_11_bit;
 
 		if (_report_lock && _rc_scan_locked) {
 			_report_lock = false;
@@ -387,39 +473,10 @@ void RCInput::Run()
 			break;
 
 		case RC_SCAN_DSM:
-			if (_rc_scan_begin == 0) {
-				_rc_scan_begin = cycle_timestamp;
-				//			// Configure serial port for DSM
-				dsm_config(_rcs_fd);
-				rc_io_invert(false);
-
-			} else if (_rc_scan_locked
-				   || cycle_timestamp - _rc_scan_begin < rc_scan_max) {
-
-				if (newBytes > 0) {
-					int8_t dsm_rssi;
-
-					// parse new data
-					rc_updated = dsm_parse(cycle_timestamp, &_rcs_buf[0], newBytes, &_raw_rc_values[0], &_raw_rc_count,
-							       &dsm_11_bit, &frame_drops, &dsm_rssi, input_rc_s::RC_INPUT_MAX_CHANNELS);
-
-					if (rc_updated) {
-						// we have a new DSM frame. Publish it.
-						_rc_in.input_source = input_rc_s::RC_INPUT_SOURCE_PX4FMU_DSM;
-						fill_rc_in(_raw_rc_count, _raw_rc_values, cycle_timestamp,
-							   false, false, frame_drops, dsm_rssi);
-						_rc_scan_locked = true;
-					}
-				}
-
-			} else {
-				// Scan the next protocol
-				set_rc_scan_state(RC_SCAN_ST24);
-			}
-
-			break;
-
 		case RC_SCAN_ST24:
+		case RC_SCAN_SUMD:
+			// DSM, ST24 and SUMD share the same UART configuration (115200 8N1), while scanning the bytes are fed to
+			// all three decoders in parallel and the scan locks onto the first one that decodes a valid frame
 			if (_rc_scan_begin == 0) {
 				_rc_scan_begin = cycle_timestamp;
 				// Configure serial port for DSM
@@ -430,73 +487,30 @@ void RCInput::Run()
 				   || cycle_timestamp - _rc_scan_begin < rc_scan_max) {
 
 				if (newBytes > 0) {
-					// parse new data
-					uint8_t st24_rssi, lost_count;
+					if (_rc_scan_locked) {
+						// only the locked decoder
+						if (_rc_scan_state == RC_SCAN_ST24) {
+							rc_updated = decode_st24(cycle_timestamp, newBytes);
 
-					rc_updated = false;
-
-					for (unsigned i = 0; i < (unsigned)newBytes; i++) {
-						/* set updated flag if one complete packet was parsed */
-						st24_rssi = RC_INPUT_RSSI_MAX;
-						rc_updated = (OK == st24_decode(_rcs_buf[i], &st24_rssi, &lost_count,
-										&_raw_rc_count, _raw_rc_values, input_rc_s::RC_INPUT_MAX_CHANNELS));
-					}
-
-					// The st24 will keep outputting RC channels and RSSI even if RC has been lost.
-					// The only way to detect RC loss is therefore to look at the lost_count.
-
-					if (rc_updated) {
-						if (lost_count == 0) {
-							// we have a new ST24 frame. Publish it.
-							_rc_in.input_source = input_rc_s::RC_INPUT_SOURCE_PX4FMU_ST24;
-							fill_rc_in(_raw_rc_count, _raw_rc_values, cycle_timestamp,
-								   false, false, frame_drops, st24_rssi);
-							_rc_scan_locked = true;
+						} else if (_rc_scan_state == RC_SCAN_SUMD) {
+							rc_updated = decode_sumd(cycle_timestamp, newBytes);
 
 						} else {
-							// if the lost count > 0 means that there is an RC loss
-							_rc_in.rc_lost = true;
+							rc_updated = decode_dsm(cycle_timestamp, newBytes);
 						}
-					}
-				}
 
-			} else {
-				// Scan the next protocol
-				set_rc_scan_state(RC_SCAN_SUMD);
-			}
+					} else if (decode_st24(cycle_timestamp, newBytes)) {
+						// the CRC protected protocols first, the DSM framing is only checked for plausibility
+						rc_updated = true;
+						_rc_scan_state = RC_SCAN_ST24;
 
-			break;
-
-		case RC_SCAN_SUMD:
-			if (_rc_scan_begin == 0) {
-				_rc_scan_begin = cycle_timestamp;
-				// Configure serial port for DSM
-				dsm_config(_rcs_fd);
-				rc_io_invert(false);
+					} else if (decode_sumd(cycle_timestamp, newBytes)) {
+						rc_updated = true;
+						_rc_scan_state = RC_SCAN_SUMD;
 
-			} else if (_rc_scan_locked
-				   || cycle_timestamp - _rc_scan_begin < rc_scan_max) {
-
-				if (newBytes > 0) {
-					// parse new data
-					uint8_t sumd_rssi, rx_count;
-					bool sumd_failsafe;
-
-					rc_updated = false;
-
-					for (unsigned i = 0; i < (unsigned)newBytes; i++) {
-						/* set updated flag if one complete packet was parsed */
-						sumd_rssi = RC_INPUT_RSSI_MAX;
-						rc_updated = (OK == sumd_decode(_rcs_buf[i], &sumd_rssi, &rx_count,
-										&_raw_rc_count, _raw_rc_values, input_rc_s::RC_INPUT_MAX_CHANNELS, &sumd_failsafe));
-					}
-
-					if (rc_updated) {
-						// we have a new SUMD frame. Publish it.
-						_rc_in.input_source = input_rc_s::RC_INPUT_SOURCE_PX4FMU_SUMD;
-						fill_rc_in(_raw_rc_count, _raw_rc_values, cycle_timestamp,
-							   false, sumd_failsafe, frame_drops, sumd_rssi);
-						_rc_scan_locked = true;
+					} else if (decode_dsm(cycle_timestamp, newBytes)) {
+						rc_updated = true;
+						_rc_scan_state = RC_SCAN_DSM;
 					}
 				}
 
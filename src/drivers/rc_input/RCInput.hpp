@@ -140,6 +140,14 @@ private:
 			hrt_abstime now, bool frame_drop, bool failsafe,
 			unsigned frame_drops, int rssi);
 
+	/**
+	 * Feed the newly read bytes to a decoder, publishing a decoded frame fills _rc_in and locks the scan.
+	 * @return true if a frame was decoded
+	 */
+	bool decode_dsm(hrt_abstime now, int newBytes);
+	bool decode_st24(hrt_abstime now, int newBytes);
+	bool decode_sumd(hrt_abstime now, int newBytes);
+
 	void set_rc_scan_state(RC_SCAN _rc_scan_state);
 
 	void rc_io_invert(bool invert);
@@ -38,6 +38,8 @@
 #include <px4_platform_common/tasks.h>
 #include <px4_platform_common/getopt.h>
 #include <px4_platform_common/posix.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
 #include <errno.h>
 
 #include <math.h>	// NAN
@@ -47,6 +49,7 @@
 #include <lib/cdev/CDev.hpp>
 #include <perf/perf_counter.h>
 #include <px4_platform_common/module_params.h>
+#include <uORB/Publication.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/topics/actuator_controls.h>
 #include <uORB/topics/actuator_outputs.h>
@@ -78,6 +81,77 @@
 #  define TAP_ESC_CTRL_UORB_UPDATE_INTERVAL 2  // [ms] min: 2, max: 100
 #endif
 
+// interval at which the ESC feedback is read and esc_status is published
+#if !defined(TAP_ESC_FEEDBACK_INTERVAL)
+#  define TAP_ESC_FEEDBACK_INTERVAL 5  // [ms]
+#endif
+
+/*
+ * Reads and decodes the ESC feedback on the work queue of the UART and publishes it aggregated as esc_status,
+ * so the output task only writes to the UART and is never delayed by the feedback.
+ */
+class TapEscFeedback : public px4::ScheduledWorkItem
+{
+public:
+	explicit TapEscFeedback(const char *device) :
+		ScheduledWorkItem(MODULE_NAME"_feedback", px4::serial_port_to_wq(device))
+	{}
+
+	~TapEscFeedback() override { ScheduleClear(); }
+
+	void start(int uart_fd)
+	{
+		_uart_fd = uart_fd;
+		ScheduleOnInterval(TAP_ESC_FEEDBACK_INTERVAL * 1000);
+	}
+
+	/** called from the output task */
+	void set_num_outputs(uint8_t num_outputs) { _num_outputs.store(num_outputs); }
+
+private:
+	void Run() override;
+
+	int		_uart_fd{-1};
+	px4::atomic<uint8_t> _num_outputs{0};
+
+	ESC_UART_BUF	_uartbuf{};
+	EscPacket	_packet{};
+
+	uORB::PublicationData<esc_status_s> _esc_status_pub{ORB_ID(esc_status)};
+};
+
+void TapEscFeedback::Run()
+{
+	tap_esc_common::read_data_from_uart(_uart_fd, &_uartbuf);
+
+	bool updated = false;
+
+	// drain all the complete packets
+	while (tap_esc_common::parse_tap_esc_feedback(&_uartbuf, &_packet) == 0) {
+		if (_packet.msg_id == ESCBUS_MSG_ID_RUN_INFO) {
+			RunInfoRepsonse &feed_back_data = _packet.d.rspRunInfo;
+
+			if (feed_back_data.channelID < esc_status_s::CONNECTED_ESC_MAX) {
+				esc_status_s &esc_status = _esc_status_pub.get();
+				esc_status.esc[feed_back_data.channelID].timestamp = hrt_absolute_time();
+				esc_status.esc[feed_back_data.channelID].esc_rpm = feed_back_data.speed;
+				esc_status.esc[feed_back_data.channelID].esc_state = feed_back_data.ESCStatus;
+				updated = true;
+			}
+		}
+	}
+
+	if (updated) {
+		esc_status_s &esc_status = _esc_status_pub.get();
+		esc_status.esc_connectiontype = esc_status_s::ESC_CONNECTION_TYPE_SERIAL;
+		esc_status.esc_count = _num_outputs.load();
+		esc_status.counter++;
+		esc_status.timestamp = hrt_absolute_time();
+
+		_esc_status_pub.update();
+	}
+}
+
 /*
  * This driver connects to TAP ESCs via serial.
  */
@@ -109,6 +183,7 @@ public:
 private:
 	char 			_device[DEVICE_ARGUMENT_MAX_LENGTH];
 	int 			_uart_fd = -1;
+	TapEscFeedback		_feedback;
 	static const uint8_t 	_device_mux_map[TAP_ESC_MAX_MOTOR_NUM];
 	static const uint8_t 	_device_dir_map[TAP_ESC_MAX_MOTOR_NUM];
 	bool 			_is_armed = false;
@@ -129,17 +204,13 @@ private:
 	px4_pollfd_struct_t	_poll_fds[actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS];
 	unsigned		_poll_fds_num = 0;
 
-	orb_advert_t      _esc_feedback_pub = nullptr;
 	orb_advert_t      _to_mixer_status = nullptr; 	///< mixer status flags
-	esc_status_s      _esc_feedback = {};
 	uint8_t    	  _channels_count = 0; 		///< nnumber of ESC channels
 	uint8_t 	  _responding_esc = 0;
 
 	MixerGroup	*_mixers = nullptr;
 	uint32_t	_groups_required = 0;
 	uint32_t	_groups_subscribed = 0;
-	ESC_UART_BUF 	_uartbuf = {};
-	EscPacket 	_packet = {};
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::MC_AIRMODE>) _param_mc_airmode   ///< multicopter air-mode
@@ -158,6 +229,7 @@ const uint8_t TAP_ESC::_device_dir_map[TAP_ESC_MAX_MOTOR_NUM] = ESC_DIR;
 TAP_ESC::TAP_ESC(char const *const device, uint8_t channels_count):
 	CDev(TAP_ESC_DEVICE_PATH),
 	ModuleParams(nullptr),
+	_feedback(device),
 	_perf_control_latency(perf_alloc(PC_ELAPSED, "tap_esc control latency")),
 	_channels_count(channels_count)
 {
@@ -195,7 +267,6 @@ TAP_ESC::~TAP_ESC()
 	orb_unsubscribe(_test_motor_sub);
 
 	orb_unadvertise(_outputs_pub);
-	orb_unadvertise(_esc_feedback_pub);
 	orb_unadvertise(_to_mixer_status);
 
 	tap_esc_common::deinitialise_uart(_uart_fd);
@@ -326,12 +397,14 @@ int TAP_ESC::init()
 		usleep(2000);
 	}
 
+	/* the feedback is read on the work queue of the UART from now on */
+	_feedback.start(_uart_fd);
+
 	/* do regular cdev init */
 	ret = CDev::init();
 
 	/* advertise the mixed control outputs, insist on the first group output */
 	_outputs_pub = orb_advertise(ORB_ID(actuator_outputs), &_outputs);
-	_esc_feedback_pub = orb_advertise(ORB_ID(esc_status), &_esc_feedback);
 	multirotor_motor_limits_s multirotor_motor_limits = {};
 	_to_mixer_status = orb_advertise(ORB_ID(multirotor_motor_limits), &multirotor_motor_limits);
 
@@ -561,25 +634,7 @@ void TAP_ESC::cycle()
 		_outputs.timestamp = hrt_absolute_time();
 
 		send_esc_outputs(motor_out, num_outputs);
-		tap_esc_common::read_data_from_uart(_uart_fd, &_uartbuf);
-
-		if (!tap_esc_common::parse_tap_esc_feedback(&_uartbuf, &_packet)) {
-			if (_packet.msg_id == ESCBUS_MSG_ID_RUN_INFO) {
-				RunInfoRepsonse &feed_back_data = _packet.d.rspRunInfo;
-
-				if (feed_back_data.channelID < esc_status_s::CONNECTED_ESC_MAX) {
-					_esc_feedback.esc[feed_back_data.channelID].esc_rpm = feed_back_data.speed;
-					_esc_feedback.esc[feed_back_data.channelID].esc_state = feed_back_data.ESCStatus;
-					_esc_feedback.esc_connectiontype = esc_status_s::ESC_CONNECTION_TYPE_SERIAL;
-					_esc_feedback.counter++;
-					_esc_feedback.esc_count = num_outputs;
-
-					_esc_feedback.timestamp = hrt_absolute_time();
-
-					orb_publish(ORB_ID(esc_status), _esc_feedback_pub, &_esc_feedback);
-				}
-			}
-		}
+		_feedback.set_num_outputs(num_outputs);
 
 		/* and publish for anyone that cares to see */
 		orb_publish(ORB_ID(actuator_outputs), _outputs_pub, &_outputs);
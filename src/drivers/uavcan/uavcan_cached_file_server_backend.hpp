@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uavcan_cached_file_server_backend.hpp
+ *
+ * File server backend with a read-ahead cache.
+ *
+ * Nodes read their firmware in requests of at most 256 bytes, each of them used to be a separate
+ * access to the SD card. When several nodes of the same type are updated at once they read the same
+ * image at similar offsets. Here larger blocks are read from the file and shared by all the requests
+ * falling into them.
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <uavcan_posix/basic_file_server_backend.hpp>
+
+class UavcanCachedFileServerBackend : public uavcan_posix::BasicFileServerBackend
+{
+public:
+	explicit UavcanCachedFileServerBackend(uavcan::INode &node) : uavcan_posix::BasicFileServerBackend(node) {}
+
+	/**
+	 * Nodes get the file info before they start reading, drop the cached blocks in case the file has changed.
+	 */
+	int16_t getInfo(const Path &path, uint64_t &out_size, EntryType &out_type) override
+	{
+		for (Block &block : _blocks) {
+			if (block.valid && block.path == path) {
+				block.valid = false;
+			}
+		}
+
+		return uavcan_posix::BasicFileServerBackend::getInfo(path, out_size, out_type);
+	}
+
+	int16_t read(const Path &path, const uint64_t offset, uint8_t *out_buffer, uint16_t &inout_size) override
+	{
+		uint16_t size = 0;
+
+		// a request can span two blocks, a short response means end of file to the client
+		while (size < inout_size) {
+			const uint64_t position = offset + size;
+			const unsigned block_position = position % BlockSize;
+
+			const Block *block = nullptr;
+			const int16_t ret = getBlock(path, position - block_position, block);
+
+			if (ret != 0) {
+				return ret;
+			}
+
+			if (block_position >= block->size) {
+				// end of file
+				break;
+			}
+
+			uint16_t n = block->size - block_position;
+
+			if (n > inout_size - size) {
+				n = inout_size - size;
+			}
+
+			memcpy(&out_buffer[size], &block->data[block_position], n);
+			size += n;
+		}
+
+		inout_size = size;
+		return 0;
+	}
+
+private:
+	static constexpr unsigned BlockSize = 1024;
+	static constexpr unsigned NumBlocks = 8;	///< one per node updating at once
+
+	struct Block {
+		Path path;
+		uint64_t offset{0};
+		uint32_t last_used{0};
+		uint16_t size{0};
+		bool valid{false};
+		uint8_t data[BlockSize];
+	};
+
+	/**
+	 * Find the block at offset (a multiple of BlockSize) or read it, replacing the least recently used one.
+	 * @return 0 or errno
+	 */
+	int16_t getBlock(const Path &path, uint64_t offset, const Block *&out_block)
+	{
+		Block *oldest = &_blocks[0];
+
+		for (Block &block : _blocks) {
+			if (block.valid && block.offset == offset && block.path == path) {
+				block.last_used = ++_use_counter;
+				out_block = &block;
+				return 0;
+			}
+
+			if (!block.valid || (oldest->valid && block.last_used < oldest->last_used)) {
+				oldest = &block;
+			}
+		}
+
+		oldest->valid = false;
+
+		const int fd = ::open(path.c_str(), O_RDONLY);
+
+		if (fd < 0) {
+			return errno;
+		}
+
+		ssize_t len = -1;
+
+		if (::lseek(fd, offset, SEEK_SET) >= 0) {
+			len = ::read(fd, oldest->data, BlockSize);
+		}
+
+		const int16_t ret = (len < 0) ? errno : 0;
+		::close(fd);
+
+		if (ret != 0) {
+			return ret;
+		}
+
+		oldest->path = path;
+		oldest->offset = offset;
+		oldest->size = len;
+		oldest->last_used = ++_use_counter;
+		oldest->valid = true;
+
+		out_block = oldest;
+		return 0;
+	}
+
+	Block _blocks[NumBlocks] {};
+	uint32_t _use_counter{0};
+};
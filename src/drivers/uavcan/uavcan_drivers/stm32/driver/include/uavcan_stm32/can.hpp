@@ -45,33 +45,84 @@ struct CanRxItem {
  */
 class CanIface : public uavcan::ICanIface, uavcan::Noncopyable
 {
+public:
+	/**
+	 * Bus usage, updated by the ISRs.
+	 */
+	struct Statistics {
+		uavcan::uint64_t bus_bits;              ///< Bits of the received and transmitted frames, without bit stuffing
+		uavcan::uint64_t rx_latency_sum_usec;   ///< RX ISR to receive() by the library
+		uavcan::uint32_t rx_latency_max_usec;
+		uavcan::uint32_t rx_latency_count;
+
+		Statistics()
+			: bus_bits(0)
+			, rx_latency_sum_usec(0)
+			, rx_latency_max_usec(0)
+			, rx_latency_count(0)
+		{ }
+	};
+
+private:
+	/**
+	 * Single producer, single consumer frame ring.
+	 * The ISRs (producer) write the frames straight into the ring slots and only publish the write index,
+	 * the consumer only advances the read index, so neither side needs a critical section.
+	 * The RX and TX ISRs share the producer side, they run at the same priority and do not preempt each other.
+	 * The indexes run over twice the capacity, so a full ring can be told apart from an empty one.
+	 * New frames are dropped when the ring is full.
+	 */
 	class RxQueue
 	{
 		CanRxItem *const buf_;
 		const uavcan::uint8_t capacity_;
-		uavcan::uint8_t in_;
-		uavcan::uint8_t out_;
-		uavcan::uint8_t len_;
+		uavcan::uint16_t in_;           ///< written by the producer only
+		uavcan::uint16_t out_;          ///< written by the consumer only
 		uavcan::uint32_t overflow_cnt_;
 
 		void registerOverflow();
 
+		uavcan::uint16_t next(uavcan::uint16_t index) const
+		{
+			return (index + 1U >= 2U * capacity_) ? 0 : uavcan::uint16_t(index + 1U);
+		}
+
 	public:
 		RxQueue(CanRxItem *buf, uavcan::uint8_t capacity)
 			: buf_(buf)
 			, capacity_(capacity)
 			, in_(0)
 			, out_(0)
-			, len_(0)
 			, overflow_cnt_(0)
 		{ }
 
+		/**
+		 * Producer side: the slot of the next frame, or null if the ring is full (the overflow is counted).
+		 * The frame becomes visible to the consumer with commit().
+		 */
+		CanRxItem *prepare();
+		void commit();
+
 		void push(const uavcan::CanFrame &frame, const uint64_t &utc_usec, uavcan::CanIOFlags flags);
-		void pop(uavcan::CanFrame &out_frame, uavcan::uint64_t &out_utc_usec, uavcan::CanIOFlags &out_flags);
 
+		/**
+		 * Consumer side: the oldest frame, or null if the ring is empty.
+		 * The slot is not reused by the producer before release().
+		 */
+		const CanRxItem *peek() const;
+		void release();
+
+		/**
+		 * Only while the producer is disabled.
+		 */
 		void reset();
 
-		unsigned getLength() const { return len_; }
+		unsigned getLength() const
+		{
+			const unsigned in = __atomic_load_n(&in_, __ATOMIC_ACQUIRE);
+			const unsigned out = __atomic_load_n(&out_, __ATOMIC_ACQUIRE);
+			return (in >= out) ? (in - out) : (in + 2U * capacity_ - out);
+		}
 
 		uavcan::uint32_t getOverflowCount() const { return overflow_cnt_; }
 	};
@@ -118,6 +169,10 @@ class CanIface : public uavcan::ICanIface, uavcan::Noncopyable
 	uavcan::uint8_t peak_tx_mailbox_index_;
 	const uavcan::uint8_t self_index_;
 	bool had_activity_;
+	uavcan::uint32_t bitrate_;
+	Statistics stats_;
+
+	static uavcan::uint32_t getFrameBits(const uavcan::CanFrame &frame);
 
 	int computeTimings(uavcan::uint32_t target_bitrate, Timings &out_timings);
 
@@ -154,6 +209,7 @@ public:
 		, peak_tx_mailbox_index_(0)
 		, self_index_(self_index)
 		, had_activity_(false)
+		, bitrate_(0)
 	{
 		UAVCAN_ASSERT(self_index_ < UAVCAN_STM32_NUM_IFACES);
 	}
@@ -221,6 +277,14 @@ public:
 	 * Value of 3 suggests that priority inversion could be taking place.
 	 */
 	uavcan::uint8_t getPeakNumTxMailboxesUsed() const { return uavcan::uint8_t(peak_tx_mailbox_index_ + 1); }
+
+	/**
+	 * Bus usage since initialization, to be related to the bit rate for the bus load.
+	 * This is intended for debug use only.
+	 */
+	Statistics getStatistics() const;
+
+	uavcan::uint32_t getBitRate() const { return bitrate_; }
 };
 
 /**
@@ -98,52 +98,52 @@ void CanIface::RxQueue::registerOverflow()
 	}
 }
 
-void CanIface::RxQueue::push(const uavcan::CanFrame &frame, const uint64_t &utc_usec, uavcan::CanIOFlags flags)
+CanRxItem *CanIface::RxQueue::prepare()
 {
-	buf_[in_].frame    = frame;
-	buf_[in_].utc_usec = utc_usec;
-	buf_[in_].flags    = flags;
-	in_++;
-
-	if (in_ >= capacity_) {
-		in_ = 0;
+	if (getLength() >= capacity_) {
+		registerOverflow();
+		return UAVCAN_NULLPTR;
 	}
 
-	len_++;
+	return &buf_[in_ % capacity_];
+}
 
-	if (len_ > capacity_) {
-		len_ = capacity_;
-		registerOverflow();
-		out_++;
+void CanIface::RxQueue::commit()
+{
+	__atomic_store_n(&in_, next(in_), __ATOMIC_RELEASE);
+}
 
-		if (out_ >= capacity_) {
-			out_ = 0;
-		}
+void CanIface::RxQueue::push(const uavcan::CanFrame &frame, const uint64_t &utc_usec, uavcan::CanIOFlags flags)
+{
+	CanRxItem *const item = prepare();
+
+	if (item != UAVCAN_NULLPTR) {
+		item->frame    = frame;
+		item->utc_usec = utc_usec;
+		item->flags    = flags;
+		commit();
 	}
 }
 
-void CanIface::RxQueue::pop(uavcan::CanFrame &out_frame, uavcan::uint64_t &out_utc_usec, uavcan::CanIOFlags &out_flags)
+const CanRxItem *CanIface::RxQueue::peek() const
 {
-	if (len_ > 0) {
-		out_frame    = buf_[out_].frame;
-		out_utc_usec = buf_[out_].utc_usec;
-		out_flags    = buf_[out_].flags;
-		out_++;
-
-		if (out_ >= capacity_) {
-			out_ = 0;
-		}
+	if (getLength() == 0) {
+		return UAVCAN_NULLPTR;
+	}
 
-		len_--;
+	return &buf_[out_ % capacity_];
+}
 
-	} else { UAVCAN_ASSERT(0); }
+void CanIface::RxQueue::release()
+{
+	UAVCAN_ASSERT(getLength() > 0);
+	__atomic_store_n(&out_, next(out_), __ATOMIC_RELEASE);
 }
 
 void CanIface::RxQueue::reset()
 {
 	in_ = 0;
 	out_ = 0;
-	len_ = 0;
 	overflow_cnt_ = 0;
 }
 
@@ -383,17 +383,29 @@ uavcan::int16_t CanIface::receive(uavcan::CanFrame &out_frame, uavcan::Monotonic
 				  uavcan::UtcTime &out_ts_utc, uavcan::CanIOFlags &out_flags)
 {
 	out_ts_monotonic = clock::getMonotonic();  // High precision is not required for monotonic timestamps
-	uavcan::uint64_t utc_usec = 0;
-	{
-		CriticalSectionLocker lock;
+	const CanRxItem *const item = rx_queue_.peek();
 
-		if (rx_queue_.getLength() == 0) {
-			return 0;
-		}
+	if (item == UAVCAN_NULLPTR) {
+		return 0;
+	}
 
-		rx_queue_.pop(out_frame, utc_usec, out_flags);
+	// The library needs its own copy, the ring slot is handed back right after
+	out_frame = item->frame;
+	out_flags = item->flags;
+	out_ts_utc = uavcan::UtcTime::fromUSec(item->utc_usec);
+	rx_queue_.release();
+
+	if ((out_flags & uavcan::CanIOFlagLoopback) == 0) {
+		const uavcan::uint64_t now_usec = clock::getUtc().toUSec();
+		const uavcan::uint32_t latency_usec = (now_usec > out_ts_utc.toUSec()) ?
+						      uavcan::uint32_t(now_usec - out_ts_utc.toUSec()) : 0;
+
+		CriticalSectionLocker lock;
+		stats_.rx_latency_sum_usec += latency_usec;
+		stats_.rx_latency_max_usec = uavcan::max(stats_.rx_latency_max_usec, latency_usec);
+		stats_.rx_latency_count++;
 	}
-	out_ts_utc = uavcan::UtcTime::fromUSec(utc_usec);
+
 	return 1;
 }
 
@@ -522,6 +534,8 @@ int CanIface::init(const uavcan::uint32_t bitrate, const OperatingMode mode)
 	uavcan::fill_n(pending_tx_, NumTxMailboxes, TxItem());
 	peak_tx_mailbox_index_ = 0;
 	had_activity_ = false;
+	bitrate_ = bitrate;
+	stats_ = Statistics();
 
 	/*
 	 * CAN timings for this bitrate
@@ -600,6 +614,10 @@ void CanIface::handleTxMailboxInterrupt(uavcan::uint8_t mailbox_index, bool txok
 
 	TxItem &txi = pending_tx_[mailbox_index];
 
+	if (txok && txi.pending) {
+		stats_.bus_bits += getFrameBits(txi.frame);
+	}
+
 	if (txi.loopback && txok && txi.pending) {
 		rx_queue_.push(txi.frame, utc_usec, uavcan::CanIOFlagLoopback);
 	}
@@ -653,9 +671,19 @@ void CanIface::handleRxInterrupt(uavcan::uint8_t fifo_index, uavcan::uint64_t ut
 	}
 
 	/*
-	 * Read the frame contents
+	 * Read the frame contents straight into the RX ring, or drop it if the ring is full
 	 */
-	uavcan::CanFrame frame;
+	CanRxItem *const item = rx_queue_.prepare();
+
+	if (item == UAVCAN_NULLPTR) {
+		*rfr_reg = bxcan::RFR_RFOM | bxcan::RFR_FOVR | bxcan::RFR_FULL;
+		update_event_.signalFromInterrupt();
+		pollErrorFlagsFromISR();
+		return;
+	}
+
+	uavcan::CanFrame &frame = item->frame;
+	frame = uavcan::CanFrame();
 	const bxcan::RxMailboxType &rf = can_->RxMailbox[fifo_index];
 
 	if ((rf.RIR & bxcan::RIR_IDE) == 0) {
@@ -684,9 +712,12 @@ void CanIface::handleRxInterrupt(uavcan::uint8_t fifo_index, uavcan::uint64_t ut
 	*rfr_reg = bxcan::RFR_RFOM | bxcan::RFR_FOVR | bxcan::RFR_FULL;  // Release FIFO entry we just read
 
 	/*
-	 * Store with timeout into the FIFO buffer and signal update event
+	 * Publish the frame and signal update event
 	 */
-	rx_queue_.push(frame, utc_usec, 0);
+	item->utc_usec = utc_usec;
+	item->flags = 0;
+	rx_queue_.commit();
+	stats_.bus_bits += getFrameBits(frame);
 	had_activity_ = true;
 	update_event_.signalFromInterrupt();
 
@@ -766,7 +797,6 @@ bool CanIface::canAcceptNewTxFrame(const uavcan::CanFrame &frame) const
 
 bool CanIface::isRxBufferEmpty() const
 {
-	CriticalSectionLocker lock;
 	return rx_queue_.getLength() == 0;
 }
 
@@ -778,10 +808,22 @@ uavcan::uint64_t CanIface::getErrorCount() const
 
 unsigned CanIface::getRxQueueLength() const
 {
-	CriticalSectionLocker lock;
 	return rx_queue_.getLength();
 }
 
+uavcan::uint32_t CanIface::getFrameBits(const uavcan::CanFrame &frame)
+{
+	// SOF, arbitration, control, CRC, ACK, EOF and interframe space
+	const uavcan::uint32_t overhead = frame.isExtended() ? 67 : 47;
+	return overhead + (frame.isRemoteTransmissionRequest() ? 0 : 8U * frame.dlc);
+}
+
+CanIface::Statistics CanIface::getStatistics() const
+{
+	CriticalSectionLocker lock;
+	return stats_;
+}
+
 bool CanIface::hadActivity()
 {
 	CriticalSectionLocker lock;
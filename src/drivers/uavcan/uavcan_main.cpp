@@ -59,6 +59,7 @@
 #include <drivers/drv_hrt.h>
 #include <drivers/drv_mixer.h>
 #include <drivers/drv_pwm_output.h>
+#include <lib/mathlib/mathlib.h>
 
 #include "uavcan_module.hpp"
 #include "uavcan_main.hpp"
@@ -552,7 +553,8 @@ UavcanNode::start(uavcan::NodeID node_id, uint32_t bitrate)
 		return node_init_res;
 	}
 
-	_instance->ScheduleOnInterval(ScheduleIntervalMs * 1000);
+	// from here on the CAN interrupts and the libuavcan timer deadlines schedule the node
+	_instance->ScheduleNow();
 
 	return OK;
 }
@@ -670,6 +672,16 @@ UavcanNode::node_spin_once()
 	}
 }
 
+void
+UavcanNode::schedule_next_spin()
+{
+	const uavcan::MonotonicTime deadline = _node.getScheduler().getDeadlineScheduler().getEarliestDeadline();
+	const int64_t sleep_us = (deadline - _node.getMonotonicTime()).toUSec();
+
+	// received frames and TX completion wake the node up earlier (busevent_signal_trampoline)
+	ScheduleDelayed(math::constrain(sleep_us, (int64_t)MinSpinIntervalUs, (int64_t)MaxSpinIntervalUs));
+}
+
 void
 UavcanNode::handle_time_sync(const uavcan::TimerEvent &)
 {
@@ -783,6 +795,8 @@ UavcanNode::Run()
 		break;
 	}
 
+	schedule_next_spin();
+
 	perf_end(_cycle_perf);
 
 	pthread_mutex_unlock(&_node_mutex);
@@ -840,6 +854,10 @@ UavcanNode::ioctl(file *filp, int cmd, unsigned long arg)
 		}
 		break;
 
+	case MIXERIOCLOADBIN:
+		ret = _mixing_interface.mixingOutput().loadMixerBinaryThreadSafe((const void *)arg);
+		break;
+
 
 	case UAVCAN_IOCS_HARDPOINT_SET: {
 			const auto &hp_cmd = *reinterpret_cast<uavcan::equipment::hardpoint::Command *>(arg);
@@ -932,6 +950,8 @@ UavcanNode::print_info()
 	printf("\n");
 
 	// CAN driver status
+	const hrt_abstime now = hrt_absolute_time();
+
 	for (unsigned i = 0; i < _node.getDispatcher().getCanIOManager().getCanDriver().getNumIfaces(); i++) {
 		printf("CAN%u status:\n", unsigned(i + 1));
 
@@ -942,8 +962,33 @@ UavcanNode::print_info()
 		printf("\tIO errors: %llu\n", iface_perf_cnt.errors);
 		printf("\tRX frames: %llu\n", iface_perf_cnt.frames_rx);
 		printf("\tTX frames: %llu\n", iface_perf_cnt.frames_tx);
+
+#if defined(UAVCAN_STM32_NUTTX)
+		// bus load since the previous status print and RX latency since initialization
+		auto &driver = static_cast<UAVCAN_DRIVER::CanDriver &>(_node.getDispatcher().getCanIOManager().getCanDriver());
+		const UAVCAN_DRIVER::CanIface *stm32_iface = driver.getIface(i);
+		const UAVCAN_DRIVER::CanIface::Statistics stats = stm32_iface->getStatistics();
+
+		if (_status_time != 0 && now > _status_time && stm32_iface->getBitRate() > 0) {
+			const float bus_load = (stats.bus_bits - _status_bus_bits[i]) * 1e6f / (now - _status_time)
+					       / stm32_iface->getBitRate();
+			printf("\tBus load: %.1f %%\n", (double)(bus_load * 100.f));
+		}
+
+		_status_bus_bits[i] = stats.bus_bits;
+
+		if (stats.rx_latency_count > 0) {
+			printf("\tRX latency: %llu us avg, %u us max\n", stats.rx_latency_sum_usec / stats.rx_latency_count,
+			       (unsigned)stats.rx_latency_max_usec);
+		}
+
+		printf("\tRX queue: %u, overflows: %u\n", stm32_iface->getRxQueueLength(),
+		       (unsigned)stm32_iface->getRxQueueOverflowCount());
+#endif
 	}
 
+	_status_time = now;
+
 	printf("\n");
 
 	// ESC mixer status
@@ -113,6 +113,13 @@ class UavcanNode : public cdev::CDev, public px4::ScheduledWorkItem, public Modu
 
 	static constexpr unsigned ScheduleIntervalMs		= 3;
 
+	/*
+	 * The node is woken up by the CAN RX/TX interrupts and otherwise sleeps until the next
+	 * libuavcan timer deadline, within these bounds.
+	 */
+	static constexpr unsigned MinSpinIntervalUs		= 1000;
+	static constexpr unsigned MaxSpinIntervalUs		= 50000;
+
 
 	/*
 	 * This memory is reserved for uavcan to use for queuing CAN frames.
@@ -169,6 +176,9 @@ private:
 	int		init(uavcan::NodeID node_id, UAVCAN_DRIVER::BusEvent &bus_events);
 	void		node_spin_once();
 
+	/** schedule the next spin for the earliest libuavcan timer deadline */
+	void		schedule_next_spin();
+
 	int		start_fw_server();
 	int		stop_fw_server();
 	int		request_fw_check();
@@ -216,6 +226,9 @@ private:
 	perf_counter_t			_cycle_perf;
 	perf_counter_t			_interval_perf;
 
+	uint64_t			_status_bus_bits[uavcan::MaxCanIfaces] {};	///< bus bits at the previous status print
+	hrt_abstime			_status_time{0};				///< time of the previous status print
+
 	void handle_time_sync(const uavcan::TimerEvent &);
 
 	typedef uavcan::MethodBinder<UavcanNode *, void (UavcanNode::*)(const uavcan::TimerEvent &)> TimerCallback;
@@ -60,6 +60,7 @@
 #include <uavcan/protocol/enumeration/Begin.hpp>
 #include <uavcan/protocol/enumeration/Indication.hpp>
 
+#include "uavcan_cached_file_server_backend.hpp"
 #include "uavcan_module.hpp"
 #include "uavcan_virtual_can_driver.hpp"
 
@@ -131,7 +132,7 @@ private:
 	uavcan_posix::dynamic_node_id_server::FileStorageBackend _storage_backend;
 	uavcan_posix::FirmwareVersionChecker _fw_version_checker;
 	uavcan::dynamic_node_id_server::CentralizedServer _server_instance;  ///< server singleton pointer
-	uavcan_posix::BasicFileServerBackend  _fileserver_backend;
+	UavcanCachedFileServerBackend  _fileserver_backend;
 	uavcan::NodeInfoRetriever   _node_info_retriever;
 	uavcan::FirmwareUpdateTrigger   _fw_upgrade_trigger;
 	uavcan::BasicFileServer         _fw_server;
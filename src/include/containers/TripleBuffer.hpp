@@ -0,0 +1,92 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <px4_platform_common/atomic.h>
+
+/**
+ * Lock-free handoff of the latest value from one writer thread to one reader thread.
+ *
+ * The writer fills the back buffer and publishes it by swapping it with the middle one, the
+ * reader takes the middle one if it was published since its last update(). Neither side ever
+ * waits, the reader always sees a complete value and intermediate values may be skipped.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+	/**
+	 * Writer: buffer to fill before publish(), it contains an older value.
+	 */
+	T &back() { return _buffers[_back]; }
+
+	/**
+	 * Writer: make the back buffer the latest value.
+	 */
+	void publish()
+	{
+		_back = _middle.exchange(_back | NEW_VALUE) & INDEX_MASK;
+	}
+
+	/**
+	 * Reader: take the latest value if there is a new one.
+	 * @return true if front() changed
+	 */
+	bool update()
+	{
+		if ((_middle.load() & NEW_VALUE) == 0) {
+			return false;
+		}
+
+		_front = _middle.exchange(_front) & INDEX_MASK;
+		return true;
+	}
+
+	/**
+	 * Reader: the value taken by the last update().
+	 */
+	const T &front() const { return _buffers[_front]; }
+
+private:
+	static constexpr uint8_t INDEX_MASK = 0x3;
+	static constexpr uint8_t NEW_VALUE = 0x4;
+
+	T _buffers[3] {};
+
+	uint8_t _back{0};			///< only accessed by the writer
+	px4::atomic<uint8_t> _middle{1};	///< index of the exchanged buffer and new value flag
+	uint8_t _front{2};			///< only accessed by the reader
+};
@@ -78,6 +78,11 @@ public:
 
 	void update_airspeed_validator(const airspeed_validator_update_data &input_data);
 
+	/**
+	 * Update the valid status without a new airspeed sample, only the data missing and stopped checks can change.
+	 */
+	void update_without_new_data(uint64_t timestamp) { update_airspeed_valid_status(timestamp); }
+
 	float get_IAS() { return _IAS; }
 	float get_EAS() { return _EAS; }
 	float get_TAS() { return _TAS; }
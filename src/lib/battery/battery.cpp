@@ -124,25 +124,49 @@ Battery::updateBatteryStatus(hrt_abstime timestamp, float voltage_v, float curre
 			     bool connected, bool selected_source, int priority,
 			     float throttle_normalized, bool should_publish)
 {
-	reset();
-	_battery_status.timestamp = timestamp;
+	addSample(timestamp, voltage_v, current_a);
+	updateBatteryStatusFromSamples(timestamp, connected, selected_source, priority, throttle_normalized, should_publish);
+}
+
+void
+Battery::addSample(hrt_abstime timestamp, float voltage_v, float current_a)
+{
 	filterVoltage(voltage_v);
-	filterThrottle(throttle_normalized);
 	filterCurrent(current_a);
 	sumDischarged(timestamp, current_a);
-	estimateRemaining(_voltage_filtered_v, _current_filtered_a, _throttle_filtered);
+
+	_voltage_v = voltage_v;
+	_current_a = current_a;
+	_sample_count++;
+}
+
+void
+Battery::updateBatteryStatusFromSamples(hrt_abstime timestamp, bool connected, bool selected_source, int priority,
+				       float throttle_normalized, bool should_publish)
+{
+	if (_sample_count == 0) {
+		return;
+	}
+
+	reset();
+	_battery_status.timestamp = timestamp;
+	filterThrottle(throttle_normalized, _sample_count);
+	estimateRemaining(_voltage_filtered_v, _current_filtered_a, _throttle_filtered, _sample_count);
 	computeScale();
 
+	_discharged_mah_loop = 0.f;
+	_sample_count = 0;
+
 	if (_battery_initialized) {
 		determineWarning(connected);
 	}
 
 	if (_voltage_filtered_v > 2.1f) {
 		_battery_initialized = true;
-		_battery_status.voltage_v = voltage_v;
+		_battery_status.voltage_v = _voltage_v;
 		_battery_status.voltage_filtered_v = _voltage_filtered_v;
 		_battery_status.scale = _scale;
-		_battery_status.current_a = current_a;
+		_battery_status.current_a = _current_a;
 		_battery_status.current_filtered_a = _current_filtered_a;
 		_battery_status.discharged_mah = _discharged_mah;
 		_battery_status.warning = _warning;
@@ -203,13 +227,15 @@ Battery::filterCurrent(float current_a)
 	}
 }
 
-void Battery::filterThrottle(float throttle)
+void Battery::filterThrottle(float throttle, int sample_count)
 {
 	if (!_battery_initialized) {
 		_throttle_filtered = throttle;
 	}
 
-	const float filtered_next = _throttle_filtered * 0.99f + throttle * 0.01f;
+	// same time constant as the voltage filter, independent of the update rate
+	const float alpha = math::min(0.01f * sample_count, 1.f);
+	const float filtered_next = _throttle_filtered * (1.f - alpha) + throttle * alpha;
 
 	if (PX4_ISFINITE(filtered_next)) {
 		_throttle_filtered = filtered_next;
@@ -230,16 +256,19 @@ Battery::sumDischarged(hrt_abstime timestamp, float current_a)
 	// Ignore first update because we don't know dt.
 	if (_last_timestamp != 0) {
 		const float dt = (timestamp - _last_timestamp) / 1e6;
-		// mAh since last loop: (current[A] * 1000 = [mA]) * (dt[s] / 3600 = [h])
-		_discharged_mah_loop = (current_a * 1e3f) * (dt / 3600.f);
-		_discharged_mah += _discharged_mah_loop;
+		// trapezoidal integration over the interval between two samples
+		const float current_mean_a = (_current_a >= 0.f) ? 0.5f * (current_a + _current_a) : current_a;
+		// mAh since last sample: (current[A] * 1000 = [mA]) * (dt[s] / 3600 = [h])
+		const float discharged_mah = (current_mean_a * 1e3f) * (dt / 3600.f);
+		_discharged_mah_loop += discharged_mah;
+		_discharged_mah += discharged_mah;
 	}
 
 	_last_timestamp = timestamp;
 }
 
 void
-Battery::estimateRemaining(float voltage_v, float current_a, float throttle)
+Battery::estimateRemaining(float voltage_v, float current_a, float throttle, int sample_count)
 {
 	// remaining battery capacity based on voltage
 	float cell_voltage = voltage_v / _params.n_cells;
@@ -264,7 +293,8 @@ Battery::estimateRemaining(float voltage_v, float current_a, float throttle)
 
 		} else {
 			// The lower the voltage the more adjust the estimate with it to avoid deep discharge
-			const float weight_v = 3e-4f * (1 - _remaining_voltage);
+			// (weight per sample, the samples since the last update are fused at once)
+			const float weight_v = math::min(3e-4f * (1 - _remaining_voltage) * sample_count, 1.f);
 			_remaining = (1 - weight_v) * _remaining + weight_v * _remaining_voltage;
 			// directly apply current capacity slope calculated using current
 			_remaining -= _discharged_mah_loop / _params.capacity;
@@ -103,6 +103,28 @@ public:
 	void updateBatteryStatus(hrt_abstime timestamp, float voltage_v, float current_a, bool connected,
 				 bool selected_source, int priority, float throttle_normalized, bool should_publish);
 
+	/**
+	 * Filter a measurement and integrate the discharged capacity, to be called at the full measurement rate.
+	 * The remaining capacity and the warning are estimated by the next updateBatteryStatusFromSamples().
+	 *
+	 * @param timestamp: Time at which the measurement was taken
+	 * @param voltage_v: Battery voltage, in Volts
+	 * @param current_a: Battery current, in Amps
+	 */
+	void addSample(hrt_abstime timestamp, float voltage_v, float current_a);
+
+	/**
+	 * Update current battery status message from the samples added since the last update.
+	 *
+	 * @param timestamp: Time of the update
+	 * @param selected_source: This battery is on the brick that the selected source for selected_source
+	 * @param priority: The brick number -1. The term priority refers to the Vn connection on the LTC4417
+	 * @param throttle_normalized: Throttle of the vehicle, between 0 and 1
+	 * @param should_publish If True, this function published a battery_status uORB message.
+	 */
+	void updateBatteryStatusFromSamples(hrt_abstime timestamp, bool connected, bool selected_source, int priority,
+					    float throttle_normalized, bool should_publish);
+
 	/**
 	 * Publishes the uORB battery_status message with the most recently-updated data.
 	 */
@@ -225,10 +247,10 @@ protected:
 
 private:
 	void filterVoltage(float voltage_v);
-	void filterThrottle(float throttle);
+	void filterThrottle(float throttle, int sample_count);
 	void filterCurrent(float current_a);
 	void sumDischarged(hrt_abstime timestamp, float current_a);
-	void estimateRemaining(float voltage_v, float current_a, float throttle);
+	void estimateRemaining(float voltage_v, float current_a, float throttle, int sample_count);
 	void determineWarning(bool connected);
 	void computeScale();
 
@@ -237,7 +259,10 @@ private:
 	float _throttle_filtered = -1.f;
 	float _current_filtered_a = -1.f;
 	float _discharged_mah = 0.f;
-	float _discharged_mah_loop = 0.f;
+	float _discharged_mah_loop = 0.f;		///< discharged capacity since the last update
+	float _voltage_v = 0.f;				///< last sample
+	float _current_a = -1.f;			///< last sample
+	int _sample_count = 0;				///< samples since the last update
 	float _remaining_voltage = -1.f;		///< normalized battery charge level remaining based on voltage
 	float _remaining = -1.f;			///< normalized battery charge level, selected based on config param
 	float _scale = 1.f;
@@ -67,8 +67,8 @@ CDev::~CDev()
 		unregister_driver(_devname);
 	}
 
-	if (_pollset) {
-		delete[](_pollset);
+	if (_pollset_overflow) {
+		delete[](_pollset_overflow);
 	}
 
 	px4_sem_destroy(&_lock);
@@ -203,7 +203,7 @@ CDev::poll(file_t *filep, px4_pollfd_struct_t *fds, bool setup)
 		PX4_DEBUG("CDev::poll: fds->priv = %p", filep);
 
 		/*
-		 * Lock against poll_notify() and possibly other callers (protect _pollset).
+		 * Lock against poll_notify() and possibly other callers (protect the pollset).
 		 */
 		ATOMIC_ENTER;
 
@@ -212,15 +212,16 @@ CDev::poll(file_t *filep, px4_pollfd_struct_t *fds, bool setup)
 		 */
 		while ((ret = store_poll_waiter(fds)) == -ENFILE) {
 
-			// No free slot found. Resize the pollset. This is expensive, but it's only needed initially.
+			// No free slot found. Resize the overflow pollset. This is expensive, but it's only needed
+			// if there are more poll waiters than inline slots.
 
-			if (_max_pollwaiters >= 256 / 2) { //_max_pollwaiters is uint8_t
+			if (_max_pollwaiters_overflow >= 256 / 2) { //_max_pollwaiters_overflow is uint8_t
 				ret = -ENOMEM;
 				break;
 			}
 
-			const uint8_t new_count = _max_pollwaiters > 0 ? _max_pollwaiters * 2 : 1;
-			px4_pollfd_struct_t **prev_pollset = _pollset;
+			const uint8_t new_count = _max_pollwaiters_overflow > 0 ? _max_pollwaiters_overflow * 2 : POLLSET_INLINE_SIZE;
+			px4_pollfd_struct_t **prev_pollset = _pollset_overflow;
 
 #ifdef __PX4_NUTTX
 			// malloc uses a semaphore, we need to call it enabled IRQ's
@@ -232,23 +233,26 @@ CDev::poll(file_t *filep, px4_pollfd_struct_t *fds, bool setup)
 			flags = px4_enter_critical_section();
 #endif
 
-			if (prev_pollset == _pollset) {
-				// no one else updated the _pollset meanwhile, so we're good to go
+			if (prev_pollset == _pollset_overflow) {
+				// no one else updated the _pollset_overflow meanwhile, so we're good to go
 				if (!new_pollset) {
 					ret = -ENOMEM;
 					break;
 				}
 
-				if (_max_pollwaiters > 0) {
-					memset(new_pollset + _max_pollwaiters, 0, sizeof(px4_pollfd_struct_t *) * (new_count - _max_pollwaiters));
-					memcpy(new_pollset, _pollset, sizeof(px4_pollfd_struct_t *) * _max_pollwaiters);
+				memset(new_pollset + _max_pollwaiters_overflow, 0,
+				       sizeof(px4_pollfd_struct_t *) * (new_count - _max_pollwaiters_overflow));
+
+				if (_max_pollwaiters_overflow > 0) {
+					memcpy(new_pollset, _pollset_overflow, sizeof(px4_pollfd_struct_t *) * _max_pollwaiters_overflow);
 				}
 
-				_pollset = new_pollset;
-				_pollset[_max_pollwaiters] = fds;
-				_max_pollwaiters = new_count;
+				_pollset_overflow = new_pollset;
+				_pollset_overflow[_max_pollwaiters_overflow] = fds;
+				_max_pollwaiters_overflow = new_count;
+				_num_pollwaiters.fetch_add(1);
 
-				// free the previous _pollset (we need to unlock here which is fine because we don't access _pollset anymore)
+				// free the previous _pollset_overflow (we need to unlock here which is fine because we don't access _pollset_overflow anymore)
 #ifdef __PX4_NUTTX
 				px4_leave_critical_section(flags);
 #endif
@@ -305,17 +309,42 @@ CDev::poll(file_t *filep, px4_pollfd_struct_t *fds, bool setup)
 	return ret;
 }
 
+void
+CDev::poll_refresh(px4_pollfd_struct_t *fds)
+{
+	/* lock against poll_notify() */
+	ATOMIC_ENTER;
+
+	fds->revents = fds->events & poll_state((file_t *)fds->priv);
+
+	ATOMIC_LEAVE;
+}
+
 void
 CDev::poll_notify(px4_pollevent_t events)
 {
 	PX4_DEBUG("CDev::poll_notify events = %0x", events);
 
+	/*
+	 * Fast path without locking: a waiter stored concurrently checks poll_state()
+	 * after it is stored, so it does not miss these events.
+	 */
+	if (_num_pollwaiters.load() == 0) {
+		return;
+	}
+
 	/* lock against poll() as well as other wakeups */
 	ATOMIC_ENTER;
 
-	for (unsigned i = 0; i < _max_pollwaiters; i++) {
-		if (nullptr != _pollset[i]) {
-			poll_notify_one(_pollset[i], events);
+	for (unsigned i = 0; i < POLLSET_INLINE_SIZE; i++) {
+		if (nullptr != _pollset_inline[i]) {
+			poll_notify_one(_pollset_inline[i], events);
+		}
+	}
+
+	for (unsigned i = 0; i < _max_pollwaiters_overflow; i++) {
+		if (nullptr != _pollset_overflow[i]) {
+			poll_notify_one(_pollset_overflow[i], events);
 		}
 	}
 
@@ -343,11 +372,23 @@ CDev::store_poll_waiter(px4_pollfd_struct_t *fds)
 	// Look for a free slot.
 	PX4_DEBUG("CDev::store_poll_waiter");
 
-	for (unsigned i = 0; i < _max_pollwaiters; i++) {
-		if (nullptr == _pollset[i]) {
+	for (unsigned i = 0; i < POLLSET_INLINE_SIZE; i++) {
+		if (nullptr == _pollset_inline[i]) {
 
 			/* save the pollfd */
-			_pollset[i] = fds;
+			_pollset_inline[i] = fds;
+			_num_pollwaiters.fetch_add(1);
+
+			return PX4_OK;
+		}
+	}
+
+	for (unsigned i = 0; i < _max_pollwaiters_overflow; i++) {
+		if (nullptr == _pollset_overflow[i]) {
+
+			/* save the pollfd */
+			_pollset_overflow[i] = fds;
+			_num_pollwaiters.fetch_add(1);
 
 			return PX4_OK;
 		}
@@ -361,10 +402,21 @@ CDev::remove_poll_waiter(px4_pollfd_struct_t *fds)
 {
 	PX4_DEBUG("CDev::remove_poll_waiter");
 
-	for (unsigned i = 0; i < _max_pollwaiters; i++) {
-		if (fds == _pollset[i]) {
+	for (unsigned i = 0; i < POLLSET_INLINE_SIZE; i++) {
+		if (fds == _pollset_inline[i]) {
+
+			_pollset_inline[i] = nullptr;
+			_num_pollwaiters.fetch_sub(1);
+			return PX4_OK;
+
+		}
+	}
+
+	for (unsigned i = 0; i < _max_pollwaiters_overflow; i++) {
+		if (fds == _pollset_overflow[i]) {
 
-			_pollset[i] = nullptr;
+			_pollset_overflow[i] = nullptr;
+			_num_pollwaiters.fetch_sub(1);
 			return PX4_OK;
 
 		}
@@ -41,6 +41,7 @@
 #define _CDEV_HPP
 
 #include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/posix.h>
 
 #ifdef __PX4_NUTTX
@@ -161,6 +162,15 @@ public:
 	 */
 	virtual int	poll(file_t *filep, px4_pollfd_struct_t *fds, bool setup);
 
+	/**
+	 * Re-evaluate the reported events of a poll descriptor that is set up.
+	 *
+	 * Used by persistent wait sets, which keep the poll set up between waits.
+	 *
+	 * @param fds		Poll descriptor set up with poll(.., true).
+	 */
+	void		poll_refresh(px4_pollfd_struct_t *fds);
+
 	/**
 	 * Get the device name.
 	 *
@@ -284,19 +294,23 @@ protected:
 private:
 	const char	*_devname{nullptr};		/**< device node name */
 
-	px4_pollfd_struct_t	**_pollset{nullptr};
+	static constexpr uint8_t POLLSET_INLINE_SIZE = 2;	/**< waiters stored without allocation */
+
+	px4_pollfd_struct_t	*_pollset_inline[POLLSET_INLINE_SIZE] {};
+	px4_pollfd_struct_t	**_pollset_overflow{nullptr};	/**< allocated when more waiters than inline slots are needed */
 
 	bool		_registered{false};		/**< true if device name was registered */
 
-	uint8_t		_max_pollwaiters{0};		/**< size of the _pollset array */
+	uint8_t		_max_pollwaiters_overflow{0};	/**< size of the _pollset_overflow array */
+	px4::atomic<uint8_t> _num_pollwaiters{0};	/**< number of stored poll waiters */
 	uint16_t	_open_count{0};			/**< number of successful opens */
 
 	/**
 	 * Store a pollwaiter in a slot where we can find it later.
 	 *
-	 * Expands the pollset as required.  Must be called with the driver locked.
+	 * Must be called with the driver locked.
 	 *
-	 * @return		OK, or -errno on error.
+	 * @return		OK, -ENFILE if the overflow pollset needs to be expanded, or -errno on error.
 	 */
 	inline int	store_poll_waiter(px4_pollfd_struct_t *fds);
 
@@ -141,3 +141,41 @@ cdev_poll(file_t *filp, px4_pollfd_struct_t *fds, bool setup)
 }
 
 } // namespace cdev
+
+/*
+ * poll() is a system call on NuttX, the wait set keeps the pollfd array and
+ * leaves the setup and teardown to the kernel.
+ */
+extern "C" {
+
+	int px4_waitset_create(px4_waitset_t *ws)
+	{
+		ws->nfds = 0;
+		return 0;
+	}
+
+	int px4_waitset_add(px4_waitset_t *ws, int fd, px4_pollevent_t events)
+	{
+		if (ws->nfds >= PX4_WAITSET_MAX_FDS) {
+			return -ENOMEM;
+		}
+
+		px4_pollfd_struct_t &pollfd = ws->fds[ws->nfds];
+		pollfd.fd      = fd;
+		pollfd.events  = events;
+		pollfd.revents = 0;
+
+		return ws->nfds++;
+	}
+
+	int px4_waitset_wait(px4_waitset_t *ws, int timeout)
+	{
+		return poll(ws->fds, ws->nfds, timeout);
+	}
+
+	void px4_waitset_destroy(px4_waitset_t *ws)
+	{
+		ws->nfds = 0;
+	}
+
+} // extern "C"
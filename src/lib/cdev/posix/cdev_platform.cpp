@@ -294,6 +294,58 @@ extern "C" {
 		return ret;
 	}
 
+	static void poll_thread_name(char *thread_name, size_t len)
+	{
+#ifndef __PX4_QURT
+		int nret = pthread_getname_np(pthread_self(), thread_name, len);
+
+		if (nret || thread_name[0] == 0) {
+			PX4_WARN("failed getting thread name");
+		}
+
+#endif
+	}
+
+	static void poll_sem_init(px4_sem_t *sem)
+	{
+		px4_sem_init(sem, 0, 0);
+
+		// sem use case is a signal
+		px4_sem_setprotocol(sem, SEM_PRIO_NONE);
+	}
+
+	/**
+	 * Wait for a poll notification on sem.
+	 * @param timeout timeout in ms, 0 returns immediately, < 0 waits forever
+	 */
+	static void poll_sem_wait(px4_sem_t *sem, int timeout, const char *thread_name)
+	{
+		if (timeout > 0) {
+
+			// Get the current time
+			struct timespec ts;
+			// Note, we can't actually use CLOCK_MONOTONIC on macOS
+			// but that's hidden and implemented in px4_clock_gettime.
+			px4_clock_gettime(CLOCK_MONOTONIC, &ts);
+
+			// Calculate an absolute time in the future
+			const unsigned billion = (1000 * 1000 * 1000);
+			uint64_t nsecs = ts.tv_nsec + ((uint64_t)timeout * 1000 * 1000);
+			ts.tv_sec += nsecs / billion;
+			nsecs -= (nsecs / billion) * billion;
+			ts.tv_nsec = nsecs;
+
+			int ret = px4_sem_timedwait(sem, &ts);
+
+			if (ret && errno != ETIMEDOUT) {
+				PX4_WARN("%s: px4_poll() sem error: %s", thread_name, strerror(errno));
+			}
+
+		} else if (timeout < 0) {
+			px4_sem_wait(sem);
+		}
+	}
+
 	int px4_poll(px4_pollfd_struct_t *fds, unsigned int nfds, int timeout)
 	{
 		if (nfds == 0) {
@@ -307,22 +359,11 @@ extern "C" {
 
 		const unsigned NAMELEN = 32;
 		char thread_name[NAMELEN] = {};
-
-#ifndef __PX4_QURT
-		int nret = pthread_getname_np(pthread_self(), thread_name, NAMELEN);
-
-		if (nret || thread_name[0] == 0) {
-			PX4_WARN("failed getting thread name");
-		}
-
-#endif
+		poll_thread_name(thread_name, NAMELEN);
 
 		PX4_DEBUG("Called px4_poll timeout = %d", timeout);
 
-		px4_sem_init(&sem, 0, 0);
-
-		// sem use case is a signal
-		px4_sem_setprotocol(&sem, SEM_PRIO_NONE);
+		poll_sem_init(&sem);
 
 		// Go through all fds and check them for a pollable state
 		bool fd_pollable = false;
@@ -354,30 +395,7 @@ extern "C" {
 		// If any FD can be polled, lock the semaphore and
 		// check for new data
 		if (fd_pollable) {
-			if (timeout > 0) {
-
-				// Get the current time
-				struct timespec ts;
-				// Note, we can't actually use CLOCK_MONOTONIC on macOS
-				// but that's hidden and implemented in px4_clock_gettime.
-				px4_clock_gettime(CLOCK_MONOTONIC, &ts);
-
-				// Calculate an absolute time in the future
-				const unsigned billion = (1000 * 1000 * 1000);
-				uint64_t nsecs = ts.tv_nsec + ((uint64_t)timeout * 1000 * 1000);
-				ts.tv_sec += nsecs / billion;
-				nsecs -= (nsecs / billion) * billion;
-				ts.tv_nsec = nsecs;
-
-				ret = px4_sem_timedwait(&sem, &ts);
-
-				if (ret && errno != ETIMEDOUT) {
-					PX4_WARN("%s: px4_poll() sem error: %s", thread_name, strerror(errno));
-				}
-
-			} else if (timeout < 0) {
-				px4_sem_wait(&sem);
-			}
+			poll_sem_wait(&sem, timeout, thread_name);
 
 			// We have waited now (or not, depending on timeout),
 			// go through all fds and count how many have data
@@ -409,6 +427,97 @@ extern "C" {
 		return (count) ? count : ret;
 	}
 
+	int px4_waitset_create(px4_waitset_t *ws)
+	{
+		ws->nfds = 0;
+		poll_sem_init(&ws->sem);
+		return 0;
+	}
+
+	int px4_waitset_add(px4_waitset_t *ws, int fd, px4_pollevent_t events)
+	{
+		if (ws->nfds >= PX4_WAITSET_MAX_FDS) {
+			PX4_ERR("px4_waitset_add: too many fds");
+			return -ENOMEM;
+		}
+
+		cdev::CDev *dev = get_vdev(fd);
+
+		if (!dev) {
+			return -EBADF;
+		}
+
+		px4_pollfd_struct_t &pollfd = ws->fds[ws->nfds];
+		pollfd.fd      = fd;
+		pollfd.events  = events;
+		pollfd.revents = 0;
+		pollfd.sem     = &ws->sem;
+		pollfd.priv    = nullptr;
+
+		int ret = dev->poll(&filemap[fd], &pollfd, true);
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		return ws->nfds++;
+	}
+
+	int px4_waitset_wait(px4_waitset_t *ws, int timeout)
+	{
+		if (ws->nfds == 0) {
+			PX4_WARN("px4_waitset_wait with no fds");
+			return -1;
+		}
+
+		// Discard notifications that arrived since the last wait, the current state is
+		// evaluated below. A notification after this point posts the semaphore again.
+		while (px4_sem_trywait(&ws->sem) == 0) {}
+
+		int count = 0;
+
+		for (unsigned int i = 0; i < ws->nfds; ++i) {
+			cdev::CDev *dev = get_vdev(ws->fds[i].fd);
+
+			if (dev) {
+				dev->poll_refresh(&ws->fds[i]);
+
+			} else {
+				ws->fds[i].revents = 0;
+			}
+
+			if (ws->fds[i].revents) {
+				count += 1;
+			}
+		}
+
+		if (count == 0 && timeout != 0) {
+			poll_sem_wait(&ws->sem, timeout, "px4_waitset_wait");
+
+			for (unsigned int i = 0; i < ws->nfds; ++i) {
+				if (ws->fds[i].revents) {
+					count += 1;
+				}
+			}
+		}
+
+		return count;
+	}
+
+	void px4_waitset_destroy(px4_waitset_t *ws)
+	{
+		for (unsigned int i = 0; i < ws->nfds; ++i) {
+			cdev::CDev *dev = get_vdev(ws->fds[i].fd);
+
+			if (dev) {
+				dev->poll(&filemap[ws->fds[i].fd], &ws->fds[i], false);
+			}
+		}
+
+		ws->nfds = 0;
+		px4_sem_destroy(&ws->sem);
+	}
+
 	int px4_access(const char *pathname, int mode)
 	{
 		if (mode != F_OK) {
@@ -63,6 +63,26 @@ static int wrap_bin(int i)
 	return i;
 }
 
+/**
+ * Unit direction of each bin of the internal map in body frame (the internal map has no angle offset),
+ * computed once instead of evaluating the trigonometric functions for every bin on every update.
+ */
+struct BinDirections {
+	BinDirections()
+	{
+		for (int i = 0; i < INTERNAL_MAP_USED_BINS; i++) {
+			const float angle = math::radians((float)i * INTERNAL_MAP_INCREMENT_DEG);
+			cos_angle[i] = cosf(angle);
+			sin_angle[i] = sinf(angle);
+		}
+	}
+
+	float cos_angle[INTERNAL_MAP_USED_BINS];
+	float sin_angle[INTERNAL_MAP_USED_BINS];
+};
+
+static const BinDirections bin_directions{};
+
 } // namespace
 
 CollisionPrevention::CollisionPrevention(ModuleParams *parent) :
@@ -195,6 +215,25 @@ CollisionPrevention::_updateObstacleMap()
 {
 	_sub_vehicle_attitude.update();
 
+	// the 3D map is kept around the vehicle position, it is cleared on position resets
+	if (_sub_vehicle_local_position.update()) {
+		const vehicle_local_position_s &local_position = _sub_vehicle_local_position.get();
+
+		if (local_position.xy_reset_counter != _xy_reset_counter || local_position.z_reset_counter != _z_reset_counter) {
+			_occupancy_map.reset();
+			_xy_reset_counter = local_position.xy_reset_counter;
+			_z_reset_counter = local_position.z_reset_counter;
+		}
+	}
+
+	const vehicle_local_position_s &local_position = _sub_vehicle_local_position.get();
+	_occupancy_map_active = local_position.xy_valid && local_position.z_valid
+				&& getElapsedTime(&local_position.timestamp) < RANGE_STREAM_TIMEOUT_US;
+
+	if (_occupancy_map_active) {
+		_occupancy_map.setCenter(Vector3f(local_position.x, local_position.y, local_position.z));
+	}
+
 	// add distance sensor data
 	for (unsigned i = 0; i < ORB_MULTI_MAX_INSTANCES; i++) {
 
@@ -203,6 +242,11 @@ CollisionPrevention::_updateObstacleMap()
 			distance_sensor_s distance_sensor {};
 			_sub_distance_sensor[i].copy(&distance_sensor);
 
+			// the 3D map also takes the upward and downward facing sensors
+			if (_occupancy_map_active && (getElapsedTime(&distance_sensor.timestamp) < RANGE_STREAM_TIMEOUT_US)) {
+				_addDistanceSensorDataToOccupancyMap(distance_sensor, Quatf(_sub_vehicle_attitude.get().q));
+			}
+
 			// consider only instances with valid data and orientations useful for collision prevention
 			if ((getElapsedTime(&distance_sensor.timestamp) < RANGE_STREAM_TIMEOUT_US) &&
 			    (distance_sensor.orientation != distance_sensor_s::ROTATION_DOWNWARD_FACING) &&
@@ -222,17 +266,26 @@ CollisionPrevention::_updateObstacleMap()
 
 	// add obstacle distance data
 	if (_sub_obstacle_distance.update()) {
-		const obstacle_distance_s &obstacle_distance = _sub_obstacle_distance.get();
-
-		// Update map with obstacle data if the data is not stale
-		if (getElapsedTime(&obstacle_distance.timestamp) < RANGE_STREAM_TIMEOUT_US && obstacle_distance.increment > 0.f) {
-			//update message description
-			_obstacle_map_body_frame.timestamp = math::max(_obstacle_map_body_frame.timestamp, obstacle_distance.timestamp);
-			_obstacle_map_body_frame.max_distance = math::max(_obstacle_map_body_frame.max_distance,
-								obstacle_distance.max_distance);
-			_obstacle_map_body_frame.min_distance = math::min(_obstacle_map_body_frame.min_distance,
-								obstacle_distance.min_distance);
-			_addObstacleSensorData(obstacle_distance, Quatf(_sub_vehicle_attitude.get().q));
+		_addObstacleDistance(_sub_obstacle_distance.get());
+	}
+
+	// add the merged data of rangefinder arrays (all their sensors, beyond the distance_sensor instances)
+	for (unsigned i = 0; i < ORB_MULTI_MAX_INSTANCES; i++) {
+		obstacle_distance_s obstacle_distance;
+
+		if (_sub_obstacle_distance_rangefinder[i].update(&obstacle_distance)) {
+			_addObstacleDistance(obstacle_distance);
+		}
+	}
+
+	// add compressed 3D occupancy data
+	if (_sub_obstacle_occupancy.updated()) {
+		obstacle_occupancy_s obstacle_occupancy{};
+		_sub_obstacle_occupancy.copy(&obstacle_occupancy);
+
+		if (_occupancy_map_active && getElapsedTime(&obstacle_occupancy.timestamp) < RANGE_STREAM_TIMEOUT_US
+		    && obstacle_occupancy.resolution > 0.f) {
+			_addObstacleOccupancyData(obstacle_occupancy);
 		}
 	}
 
@@ -240,6 +293,25 @@ CollisionPrevention::_updateObstacleMap()
 	_obstacle_distance_pub.publish(_obstacle_map_body_frame);
 }
 
+void
+CollisionPrevention::_addObstacleDistance(const obstacle_distance_s &obstacle_distance)
+{
+	// Update map with obstacle data if the data is not stale
+	if (getElapsedTime(&obstacle_distance.timestamp) < RANGE_STREAM_TIMEOUT_US && obstacle_distance.increment > 0.f) {
+		//update message description
+		_obstacle_map_body_frame.timestamp = math::max(_obstacle_map_body_frame.timestamp, obstacle_distance.timestamp);
+		_obstacle_map_body_frame.max_distance = math::max(_obstacle_map_body_frame.max_distance,
+							obstacle_distance.max_distance);
+		_obstacle_map_body_frame.min_distance = math::min(_obstacle_map_body_frame.min_distance,
+							obstacle_distance.min_distance);
+		_addObstacleSensorData(obstacle_distance, Quatf(_sub_vehicle_attitude.get().q));
+
+		if (_occupancy_map_active) {
+			_addObstacleSensorDataToOccupancyMap(obstacle_distance, Quatf(_sub_vehicle_attitude.get().q));
+		}
+	}
+}
+
 void
 CollisionPrevention::_addDistanceSensorData(distance_sensor_s &distance_sensor, const matrix::Quatf &vehicle_attitude)
 {
@@ -286,6 +358,155 @@ CollisionPrevention::_addDistanceSensorData(distance_sensor_s &distance_sensor,
 	}
 }
 
+void
+CollisionPrevention::_addDistanceSensorDataToOccupancyMap(const distance_sensor_s &distance_sensor,
+		const matrix::Quatf &vehicle_attitude)
+{
+	// discard values below min range
+	if (distance_sensor.current_distance <= distance_sensor.min_distance) {
+		return;
+	}
+
+	Vector3f sensor_dir_body;
+
+	switch (distance_sensor.orientation) {
+	case distance_sensor_s::ROTATION_DOWNWARD_FACING:
+		sensor_dir_body = Vector3f(0.f, 0.f, 1.f);
+		break;
+
+	case distance_sensor_s::ROTATION_UPWARD_FACING:
+		sensor_dir_body = Vector3f(0.f, 0.f, -1.f);
+		break;
+
+	case distance_sensor_s::ROTATION_CUSTOM:
+		sensor_dir_body = Quatf(distance_sensor.q).conjugate(Vector3f(1.f, 0.f, 0.f));
+		break;
+
+	default: {
+			const float sensor_yaw_body_rad = _sensorOrientationToYawOffset(distance_sensor, 0.f);
+			sensor_dir_body = Vector3f(cosf(sensor_yaw_body_rad), sinf(sensor_yaw_body_rad), 0.f);
+			break;
+		}
+	}
+
+	const vehicle_local_position_s &local_position = _sub_vehicle_local_position.get();
+	const Vector3f origin(local_position.x, local_position.y, local_position.z);
+	const bool hit = distance_sensor.current_distance < distance_sensor.max_distance;
+	const float length = math::min(distance_sensor.current_distance, distance_sensor.max_distance);
+
+	_occupancy_map.insertRay(origin, origin + vehicle_attitude.conjugate(sensor_dir_body) * length, hit);
+	_occupancy_map_timestamp = math::max(_occupancy_map_timestamp, distance_sensor.timestamp);
+}
+
+void
+CollisionPrevention::_addObstacleSensorDataToOccupancyMap(const obstacle_distance_s &obstacle,
+		const matrix::Quatf &vehicle_attitude)
+{
+	float yaw_offset_deg = obstacle.angle_offset;
+
+	if (obstacle.frame == obstacle.MAV_FRAME_BODY_FRD) {
+		yaw_offset_deg += math::degrees(Eulerf(vehicle_attitude).psi());
+
+	} else if (obstacle.frame != obstacle.MAV_FRAME_GLOBAL && obstacle.frame != obstacle.MAV_FRAME_LOCAL_NED) {
+		return;
+	}
+
+	const vehicle_local_position_s &local_position = _sub_vehicle_local_position.get();
+	const Vector3f origin(local_position.x, local_position.y, local_position.z);
+	const int msg_bins = math::min((int)(360.f / obstacle.increment),
+				       (int)(sizeof(obstacle.distances) / sizeof(obstacle.distances[0])));
+
+	for (int i = 0; i < msg_bins; i++) {
+		const uint16_t distance_cm = obstacle.distances[i];
+
+		if (distance_cm == UINT16_MAX || distance_cm <= obstacle.min_distance) {
+			continue;
+		}
+
+		const float angle = math::radians(yaw_offset_deg + (float)i * obstacle.increment);
+		const float length = math::min(distance_cm, obstacle.max_distance) * 0.01f;
+		const Vector3f end = origin + Vector3f(cosf(angle), sinf(angle), 0.f) * length;
+
+		_occupancy_map.insertRay(origin, end, distance_cm < obstacle.max_distance);
+	}
+
+	_occupancy_map_timestamp = math::max(_occupancy_map_timestamp, obstacle.timestamp);
+}
+
+void
+CollisionPrevention::_addObstacleOccupancyData(const obstacle_occupancy_s &occupancy)
+{
+	const int block_size = obstacle_occupancy_s::BLOCK_SIZE;
+	const int voxels_per_block = block_size * block_size * block_size;
+	const int block_count = math::min((int)occupancy.block_count, (int)obstacle_occupancy_s::MAX_BLOCKS);
+	const Vector3f origin(occupancy.origin);
+
+	// free voxels first, such that occupied voxels win if the message resolution is finer than the one of the map
+	for (int pass = 0; pass < 2; pass++) {
+		const bool occupied = (pass == 1);
+
+		for (int b = 0; b < block_count; b++) {
+			const Vector3f block_corner(occupancy.block_x[b] * block_size, occupancy.block_y[b] * block_size,
+						    occupancy.block_z[b] * block_size);
+
+			for (int v = 0; v < voxels_per_block; v++) {
+				if (((occupancy.occupancy[b] >> v) & 1) != (uint64_t)occupied) {
+					continue;
+				}
+
+				const Vector3f voxel(v % block_size, (v / block_size) % block_size, v / (block_size * block_size));
+				const Vector3f voxel_center = block_corner + voxel + Vector3f(0.5f, 0.5f, 0.5f);
+				_occupancy_map.setVoxel(origin + voxel_center * occupancy.resolution, occupied);
+			}
+		}
+	}
+
+	_occupancy_map_timestamp = math::max(_occupancy_map_timestamp, occupancy.timestamp);
+}
+
+float
+CollisionPrevention::_occupancyMapSpeedLimit(const Vector2f &setpoint_dir, const Vector2f &curr_vel,
+		float min_dist_to_keep, float vel_max)
+{
+	const float col_prev_dly = _param_cp_delay.get();
+	const float xy_p = _param_mpc_xy_p.get();
+	const float max_jerk = _param_mpc_jerk_max.get();
+	const float max_accel = _param_mpc_acc_hor.get();
+	const float max_range = OccupancyMap::SIZE_XY * OccupancyMap::RESOLUTION / 2.f;
+
+	const vehicle_local_position_s &local_position = _sub_vehicle_local_position.get();
+
+	// rays along the setpoint and one bin to each side, at the vehicle altitude and one voxel above
+	static constexpr float ray_heights[] {0.f, -OccupancyMap::RESOLUTION};
+	static constexpr int ray_angles_deg[] {-INTERNAL_MAP_INCREMENT_DEG, 0, INTERNAL_MAP_INCREMENT_DEG};
+
+	for (const float height : ray_heights) {
+		const Vector3f origin(local_position.x, local_position.y, local_position.z + height);
+
+		for (const int angle_deg : ray_angles_deg) {
+			const float cos_angle = cosf(math::radians((float)angle_deg));
+			const float sin_angle = sinf(math::radians((float)angle_deg));
+			const Vector2f ray_dir{cos_angle * setpoint_dir(0) - sin_angle * setpoint_dir(1),
+					       sin_angle * setpoint_dir(0) + cos_angle * setpoint_dir(1)};
+
+			const float distance = _occupancy_map.rayDistance(origin, Vector3f(ray_dir(0), ray_dir(1), 0.f), max_range);
+
+			if (distance < max_range) {
+				// same P-controller and jerk limited stopping as for the bins of the 2D map
+				const float curr_vel_parallel = math::max(0.f, curr_vel.dot(ray_dir));
+				const float stop_distance = math::max(0.f, distance - min_dist_to_keep - curr_vel_parallel * col_prev_dly);
+				const float vel_max_posctrl = xy_p * stop_distance;
+				const float vel_max_smooth = math::trajectory::computeMaxSpeedFromDistance(max_jerk, max_accel, stop_distance, 0.f);
+
+				// the projection of a ray onto the setpoint direction is cos_angle > 0
+				vel_max = math::min(vel_max, math::min(vel_max_posctrl, vel_max_smooth) / cos_angle);
+			}
+		}
+	}
+
+	return vel_max;
+}
+
 void
 CollisionPrevention::_adaptSetpointDirection(Vector2f &setpoint_dir, int &setpoint_index, float vehicle_yaw_angle_rad)
 {
@@ -325,9 +546,12 @@ CollisionPrevention::_adaptSetpointDirection(Vector2f &setpoint_dir, int &setpoi
 
 	//only change setpoint direction if it was moved to a different bin
 	if (new_sp_index != setpoint_index) {
-		float angle = math::radians((float)new_sp_index * INTERNAL_MAP_INCREMENT_DEG + _obstacle_map_body_frame.angle_offset);
-		angle = wrap_2pi(vehicle_yaw_angle_rad + angle);
-		setpoint_dir = {cosf(angle), sinf(angle)};
+		// rotate the body frame bin direction into the local frame
+		const float cos_yaw = cosf(vehicle_yaw_angle_rad);
+		const float sin_yaw = sinf(vehicle_yaw_angle_rad);
+		const float cos_bin = bin_directions.cos_angle[new_sp_index];
+		const float sin_bin = bin_directions.sin_angle[new_sp_index];
+		setpoint_dir = {cos_yaw * cos_bin - sin_yaw * sin_bin, sin_yaw * cos_bin + cos_yaw * sin_bin};
 		setpoint_index = new_sp_index;
 	}
 }
@@ -413,6 +637,15 @@ CollisionPrevention::_calculateConstrainedSetpoint(Vector2f &setpoint, const Vec
 			// change setpoint direction slightly (max by _param_cp_guide_ang degrees) to help guide through narrow gaps
 			_adaptSetpointDirection(setpoint_dir, sp_index, vehicle_yaw_angle_rad);
 
+			// the projections onto the bin directions are evaluated in body frame with the precomputed bin directions,
+			// rotate the setpoint direction and the velocity into body frame once instead of every bin into local frame
+			const float cos_yaw = cosf(vehicle_yaw_angle_rad);
+			const float sin_yaw = sinf(vehicle_yaw_angle_rad);
+			const Vector2f setpoint_dir_body{cos_yaw * setpoint_dir(0) + sin_yaw * setpoint_dir(1),
+							 -sin_yaw * setpoint_dir(0) + cos_yaw * setpoint_dir(1)};
+			const Vector2f curr_vel_body{cos_yaw * curr_vel(0) + sin_yaw * curr_vel(1),
+						     -sin_yaw * curr_vel(0) + cos_yaw * curr_vel(1)};
+
 			// limit speed for safe flight
 			for (int i = 0; i < INTERNAL_MAP_USED_BINS; i++) { // disregard unused bins at the end of the message
 
@@ -425,20 +658,16 @@ CollisionPrevention::_calculateConstrainedSetpoint(Vector2f &setpoint, const Vec
 
 				const float distance = _obstacle_map_body_frame.distances[i] * 0.01f; // convert to meters
 				const float max_range = _data_maxranges[i] * 0.01f; // convert to meters
-				float angle = math::radians((float)i * INTERNAL_MAP_INCREMENT_DEG + _obstacle_map_body_frame.angle_offset);
-
-				// convert from body to local frame in the range [0, 2*pi]
-				angle = wrap_2pi(vehicle_yaw_angle_rad + angle);
 
 				// get direction of current bin
-				const Vector2f bin_direction = {cosf(angle), sinf(angle)};
+				const Vector2f bin_direction{bin_directions.cos_angle[i], bin_directions.sin_angle[i]};
 
 				if (_obstacle_map_body_frame.distances[i] > _obstacle_map_body_frame.min_distance
 				    && _obstacle_map_body_frame.distances[i] < UINT16_MAX) {
 
-					if (setpoint_dir.dot(bin_direction) > 0) {
+					if (setpoint_dir_body.dot(bin_direction) > 0) {
 						// calculate max allowed velocity with a P-controller (same gain as in the position controller)
-						const float curr_vel_parallel = math::max(0.f, curr_vel.dot(bin_direction));
+						const float curr_vel_parallel = math::max(0.f, curr_vel_body.dot(bin_direction));
 						float delay_distance = curr_vel_parallel * col_prev_dly;
 
 						if (distance < max_range) {
@@ -449,7 +678,7 @@ CollisionPrevention::_calculateConstrainedSetpoint(Vector2f &setpoint, const Vec
 						const float vel_max_posctrl = xy_p * stop_distance;
 
 						const float vel_max_smooth = math::trajectory::computeMaxSpeedFromDistance(max_jerk, max_accel, stop_distance, 0.f);
-						const float projection = bin_direction.dot(setpoint_dir);
+						const float projection = bin_direction.dot(setpoint_dir_body);
 						float vel_max_bin = vel_max;
 
 						if (projection > 0.01f) {
@@ -467,6 +696,11 @@ CollisionPrevention::_calculateConstrainedSetpoint(Vector2f &setpoint, const Vec
 				}
 			}
 
+			// obstacles above the sensor plane and from the companion 3D data
+			if (_occupancy_map_active && (constrain_time - _occupancy_map_timestamp) < RANGE_STREAM_TIMEOUT_US) {
+				vel_max = _occupancyMapSpeedLimit(setpoint_dir, curr_vel, min_dist_to_keep, vel_max);
+			}
+
 			setpoint = setpoint_dir * vel_max;
 		}
 
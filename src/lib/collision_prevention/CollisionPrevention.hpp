@@ -43,6 +43,8 @@
 
 #include <float.h>
 
+#include "OccupancyMap.hpp"
+
 #include <commander/px4_custom_mode.h>
 #include <drivers/drv_hrt.h>
 #include <mathlib/mathlib.h>
@@ -56,8 +58,10 @@
 #include <uORB/topics/distance_sensor.h>
 #include <uORB/topics/mavlink_log.h>
 #include <uORB/topics/obstacle_distance.h>
+#include <uORB/topics/obstacle_occupancy.h>
 #include <uORB/topics/vehicle_attitude.h>
 #include <uORB/topics/vehicle_command.h>
+#include <uORB/topics/vehicle_local_position.h>
 
 using namespace time_literals;
 
@@ -89,14 +93,51 @@ protected:
 	uint16_t _data_maxranges[sizeof(_obstacle_map_body_frame.distances) / sizeof(
 										    _obstacle_map_body_frame.distances[0])]; /**< in cm */
 
+	OccupancyMap _occupancy_map{};		/**< 3D map around the vehicle, used in addition to the 2D map if the position is valid */
+	hrt_abstime _occupancy_map_timestamp{0};	/**< time of the latest data inserted into the 3D map */
+	bool _occupancy_map_active{false};	/**< the vehicle position is valid and the 3D map is centered around it */
+
 	void _addDistanceSensorData(distance_sensor_s &distance_sensor, const matrix::Quatf &vehicle_attitude);
 
+	/**
+	 * Inserts a distance sensor measurement of any orientation into the 3D occupancy map
+	 */
+	void _addDistanceSensorDataToOccupancyMap(const distance_sensor_s &distance_sensor,
+			const matrix::Quatf &vehicle_attitude);
+
+	/**
+	 * Inserts all valid rays of an obstacle_distance message at the vehicle altitude into the 3D occupancy map
+	 */
+	void _addObstacleSensorDataToOccupancyMap(const obstacle_distance_s &obstacle, const matrix::Quatf &vehicle_attitude);
+
+	/**
+	 * Inserts the observed blocks of a compressed occupancy message into the 3D occupancy map
+	 */
+	void _addObstacleOccupancyData(const obstacle_occupancy_s &occupancy);
+
+	/**
+	 * Computes the maximum speed along the setpoint direction allowed by the 3D occupancy map, considering rays at
+	 * the vehicle altitude and one voxel above (the voxels below are left out to not stop on the ground)
+	 * @param setpoint_dir, unit setpoint direction in local frame
+	 * @param curr_vel, current vehicle velocity
+	 * @param min_dist_to_keep, minimum distance to obstacles in meters
+	 * @param vel_max, maximum speed without the 3D map
+	 */
+	float _occupancyMapSpeedLimit(const matrix::Vector2f &setpoint_dir, const matrix::Vector2f &curr_vel,
+				      float min_dist_to_keep, float vel_max);
+
 	/**
 	 * Updates obstacle distance message with measurement from offboard
 	 * @param obstacle, obstacle_distance message to be updated
 	 */
 	void _addObstacleSensorData(const obstacle_distance_s &obstacle, const matrix::Quatf &vehicle_attitude);
 
+	/**
+	 * Adds an obstacle distance message to the obstacle maps if it is not stale
+	 * @param obstacle_distance, offboard or rangefinder array obstacle distances
+	 */
+	void _addObstacleDistance(const obstacle_distance_s &obstacle_distance);
+
 	/**
 	 * Computes an adaption to the setpoint direction to guide towards free space
 	 * @param setpoint_dir, setpoint direction before collision prevention intervention
@@ -131,8 +172,14 @@ private:
 	uORB::PublicationQueued<vehicle_command_s>	_vehicle_command_pub{ORB_ID(vehicle_command)};			/**< vehicle command do publication */
 
 	uORB::SubscriptionData<obstacle_distance_s> _sub_obstacle_distance{ORB_ID(obstacle_distance)}; /**< obstacle distances received form a range sensor */
+	uORB::Subscription _sub_obstacle_distance_rangefinder[ORB_MULTI_MAX_INSTANCES] {{ORB_ID(obstacle_distance_rangefinder), 0}, {ORB_ID(obstacle_distance_rangefinder), 1}, {ORB_ID(obstacle_distance_rangefinder), 2}, {ORB_ID(obstacle_distance_rangefinder), 3}}; /**< obstacle distances merged from onboard rangefinder arrays */
 	uORB::Subscription _sub_distance_sensor[ORB_MULTI_MAX_INSTANCES] {{ORB_ID(distance_sensor), 0}, {ORB_ID(distance_sensor), 1}, {ORB_ID(distance_sensor), 2}, {ORB_ID(distance_sensor), 3}}; /**< distance data received from onboard rangefinders */
 	uORB::SubscriptionData<vehicle_attitude_s> _sub_vehicle_attitude{ORB_ID(vehicle_attitude)};
+	uORB::SubscriptionData<vehicle_local_position_s> _sub_vehicle_local_position{ORB_ID(vehicle_local_position)};
+	uORB::Subscription _sub_obstacle_occupancy{ORB_ID(obstacle_occupancy)}; /**< compressed 3D occupancy received from offboard */
+
+	uint8_t _xy_reset_counter{0};
+	uint8_t _z_reset_counter{0};
 
 	static constexpr uint64_t RANGE_STREAM_TIMEOUT_US{500_ms};
 	static constexpr uint64_t TIMEOUT_HOLD_US{5_s};
@@ -52,6 +52,7 @@ public:
 	TestCollisionPrevention() : CollisionPrevention(nullptr) {}
 	void paramsChanged() {CollisionPrevention::updateParamsImpl();}
 	obstacle_distance_s &getObstacleMap() {return _obstacle_map_body_frame;}
+	OccupancyMap &getOccupancyMap() {return _occupancy_map;}
 	void test_addDistanceSensorData(distance_sensor_s &distance_sensor, const matrix::Quatf &attitude)
 	{
 		_addDistanceSensorData(distance_sensor, attitude);
@@ -1161,3 +1162,174 @@ TEST_F(CollisionPreventionTest, enterData)
 	EXPECT_TRUE(cp.test_enterData(8, 30.f, 1.5f)); //longer range, reading in range
 	EXPECT_TRUE(cp.test_enterData(8, 30.f, 31.f)); //longer range, reading out of range
 }
+
+TEST_F(CollisionPreventionTest, constrainedSetpointYawInvariance)
+{
+	// GIVEN: a simple setup condition, with the time ahead of any obstacle data published by other tests
+	TestTimingCollisionPrevention cp;
+	mocked_time = hrt_absolute_time() + 10_s;
+	float max_speed = 3.f;
+	matrix::Vector2f curr_pos(0, 0);
+
+	param_t param = param_handle(px4::params::CP_DIST);
+	float value = 2.f;
+	param_set(param, &value);
+	cp.paramsChanged();
+
+	// AND: obstacles in body frame, closest in front
+	obstacle_distance_s message {};
+	message.frame = message.MAV_FRAME_BODY_FRD;
+	message.min_distance = 20;
+	message.max_distance = 2000;
+	message.increment = 5.f;
+
+	for (int i = 0; i < 72; i++) {
+		message.distances[i] = (i < 18 || i > 54) ? 400 + 20 * abs(i - 36) : UINT16_MAX;
+	}
+
+	float speed_yaw_0 = 0.f;
+
+	// WHEN: the vehicle is yawed and the setpoint and the velocity are rotated with it
+	for (float yaw_deg = 0.f; yaw_deg < 360.f; yaw_deg += 37.f) {
+		const float yaw = math::radians(yaw_deg);
+		const matrix::Quatf attitude(matrix::Eulerf(0.f, 0.f, yaw));
+		const matrix::Vector2f setpoint_dir(cosf(yaw + 0.1f), sinf(yaw + 0.1f));
+
+		cp.getObstacleMap().timestamp = mocked_time;
+		message.timestamp = mocked_time;
+		cp.test_addObstacleSensorData(message, attitude);
+
+		vehicle_attitude_s vehicle_attitude {};
+		vehicle_attitude.timestamp = hrt_absolute_time();
+		attitude.copyTo(vehicle_attitude.q);
+		orb_advert_t vehicle_attitude_pub = orb_advertise(ORB_ID(vehicle_attitude), &vehicle_attitude);
+
+		matrix::Vector2f modified_setpoint = setpoint_dir * 3.f;
+		cp.modifySetpoint(modified_setpoint, max_speed, curr_pos, setpoint_dir * 1.f);
+		orb_unadvertise(vehicle_attitude_pub);
+
+		// THEN: the speed limit only depends on the body frame geometry
+		if (yaw_deg < 1.f) {
+			speed_yaw_0 = modified_setpoint.norm();
+			EXPECT_LT(speed_yaw_0, 3.f);
+			EXPECT_GT(speed_yaw_0, 0.f);
+
+		} else {
+			EXPECT_NEAR(modified_setpoint.norm(), speed_yaw_0, 1e-4f) << "yaw " << yaw_deg;
+		}
+	}
+}
+
+TEST_F(CollisionPreventionTest, benchmarkConstrainedSetpoint)
+{
+	// GIVEN: a full obstacle map, as with a high resolution LIDAR
+	TestTimingCollisionPrevention cp;
+	mocked_time = hrt_absolute_time() + 10_s;
+	float max_speed = 3.f;
+	matrix::Vector2f curr_pos(0, 0);
+	matrix::Vector2f curr_vel(1, 1);
+
+	param_t param = param_handle(px4::params::CP_DIST);
+	float value = 2.f;
+	param_set(param, &value);
+	cp.paramsChanged();
+
+	obstacle_distance_s message {};
+	message.frame = message.MAV_FRAME_BODY_FRD;
+	message.min_distance = 20;
+	message.max_distance = 2000;
+	message.increment = 5.f;
+
+	for (int i = 0; i < 72; i++) {
+		message.distances[i] = 500 + 10 * i;
+	}
+
+	const matrix::Quatf attitude(matrix::Eulerf(0.f, 0.f, 0.5f));
+
+	// WHEN: the constrained setpoint is computed many times
+	static constexpr int iterations = 10000;
+	const hrt_abstime start = hrt_absolute_time();
+	matrix::Vector2f modified_setpoint;
+
+	for (int i = 0; i < iterations; i++) {
+		cp.getObstacleMap().timestamp = mocked_time;
+		message.timestamp = mocked_time;
+		cp.test_addObstacleSensorData(message, attitude);
+
+		modified_setpoint = matrix::Vector2f(3.f, 0.f);
+		cp.modifySetpoint(modified_setpoint, max_speed, curr_pos, curr_vel);
+	}
+
+	const hrt_abstime elapsed = hrt_elapsed_time(&start);
+	printf("map update and constrained setpoint: %.3f us per iteration\n", (double)elapsed / iterations);
+
+	// THEN: the setpoint is limited
+	EXPECT_LT(modified_setpoint.norm(), 3.f);
+}
+
+TEST_F(CollisionPreventionTest, occupancyMapObstacleAbove)
+{
+	// GIVEN: a vehicle with a valid position and no obstacles in the plane of the 2D sensor
+	TestTimingCollisionPrevention cp;
+	mocked_time = hrt_absolute_time() + 10_s;
+	float max_speed = 3.f;
+	matrix::Vector2f curr_pos(0, 0);
+	matrix::Vector2f curr_vel(1, 0);
+
+	param_t param = param_handle(px4::params::CP_DIST);
+	float value = 1.f;
+	param_set(param, &value);
+	cp.paramsChanged();
+
+	vehicle_local_position_s local_position {};
+	local_position.timestamp = mocked_time;
+	local_position.xy_valid = true;
+	local_position.z_valid = true;
+	local_position.z = -5.f;
+	orb_advert_t local_position_pub = orb_advertise(ORB_ID(vehicle_local_position), &local_position);
+
+	obstacle_distance_s message {};
+	message.frame = message.MAV_FRAME_GLOBAL;
+	message.timestamp = mocked_time;
+	message.min_distance = 20;
+	message.max_distance = 2000;
+	message.increment = 5.f;
+
+	for (int i = 0; i < 72; i++) {
+		message.distances[i] = 2001;
+	}
+
+	cp.getObstacleMap().timestamp = mocked_time;
+	cp.test_addObstacleSensorData(message, matrix::Quatf());
+
+	// AND: a block of occupied voxels 4m ahead, entirely above the vehicle
+	obstacle_occupancy_s occupancy {};
+	occupancy.timestamp = mocked_time;
+	occupancy.resolution = 0.5f;
+	occupancy.origin[0] = 4.f;
+	occupancy.origin[1] = -1.f;
+	occupancy.origin[2] = -7.f;
+	occupancy.block_count = 1;
+	occupancy.occupancy[0] = UINT64_MAX;
+	orb_advert_t occupancy_pub = orb_advertise(ORB_ID(obstacle_occupancy), &occupancy);
+
+	// WHEN: the setpoint is modified
+	matrix::Vector2f modified_setpoint(3.f, 0.f);
+	cp.modifySetpoint(modified_setpoint, max_speed, curr_pos, curr_vel);
+
+	// THEN: the obstacle is in the 3D map only above the vehicle and limits the speed towards it
+	EXPECT_TRUE(cp.getOccupancyMap().isOccupied(matrix::Vector3f(4.25f, 0.f, -5.25f)));
+	EXPECT_FALSE(cp.getOccupancyMap().isOccupied(matrix::Vector3f(4.25f, 0.f, -4.75f)));
+	EXPECT_LT(modified_setpoint.norm(), 3.f);
+	EXPECT_GT(modified_setpoint.norm(), 0.f);
+
+	// AND: the setpoint away from it is not limited
+	matrix::Vector2f modified_setpoint_away(-3.f, 0.f);
+	cp.modifySetpoint(modified_setpoint_away, max_speed, curr_pos, -curr_vel);
+	EXPECT_FLOAT_EQ(modified_setpoint_away.norm(), 3.f);
+
+	local_position.xy_valid = false;
+	orb_publish(ORB_ID(vehicle_local_position), local_position_pub, &local_position);
+	orb_unadvertise(local_position_pub);
+	orb_unadvertise(occupancy_pub);
+}
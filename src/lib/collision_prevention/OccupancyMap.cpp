@@ -0,0 +1,249 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file OccupancyMap.cpp
+ */
+
+#include "OccupancyMap.hpp"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace matrix;
+
+void OccupancyMap::reset()
+{
+	memset(_rows, 0, sizeof(_rows));
+	_placed = false;
+}
+
+OccupancyMap::Cell OccupancyMap::cellOf(const Vector3f &position)
+{
+	return Cell{(int)floorf(position(0) / RESOLUTION), (int)floorf(position(1) / RESOLUTION), (int)floorf(position(2) / RESOLUTION)};
+}
+
+bool OccupancyMap::inWindow(const Cell &c) const
+{
+	return _placed
+	       && c.x >= _min.x && c.x < _min.x + SIZE_XY
+	       && c.y >= _min.y && c.y < _min.y + SIZE_XY
+	       && c.z >= _min.z && c.z < _min.z + SIZE_Z;
+}
+
+void OccupancyMap::set(const Cell &c, bool occupied)
+{
+	uint32_t &row = _rows[wrap(c.z, SIZE_Z)][wrap(c.y, SIZE_XY)];
+	const uint32_t bit = 1u << wrap(c.x, SIZE_XY);
+
+	if (occupied) {
+		row |= bit;
+
+	} else {
+		row &= ~bit;
+	}
+}
+
+void OccupancyMap::setCenter(const Vector3f &position)
+{
+	const Cell center = cellOf(position);
+	const Cell min{center.x - SIZE_XY / 2, center.y - SIZE_XY / 2, center.z - SIZE_Z / 2};
+
+	if (!_placed) {
+		memset(_rows, 0, sizeof(_rows));
+		_min = min;
+		_placed = true;
+		return;
+	}
+
+	// north: clear the columns entering the window in all rows
+	if (min.x != _min.x) {
+		uint32_t clear_mask = 0xffffffffu;
+
+		if (abs(min.x - _min.x) < SIZE_XY) {
+			const int first = (min.x > _min.x) ? _min.x + SIZE_XY : min.x;
+			const int last = (min.x > _min.x) ? min.x + SIZE_XY : _min.x;
+			clear_mask = 0;
+
+			for (int x = first; x < last; x++) {
+				clear_mask |= 1u << wrap(x, SIZE_XY);
+			}
+		}
+
+		for (int z = 0; z < SIZE_Z; z++) {
+			for (int y = 0; y < SIZE_XY; y++) {
+				_rows[z][y] &= ~clear_mask;
+			}
+		}
+	}
+
+	// east: clear the rows entering the window in all layers
+	if (min.y != _min.y) {
+		const bool all = abs(min.y - _min.y) >= SIZE_XY;
+		const int first = all ? 0 : ((min.y > _min.y) ? _min.y + SIZE_XY : min.y);
+		const int last = all ? SIZE_XY : ((min.y > _min.y) ? min.y + SIZE_XY : _min.y);
+
+		for (int y = first; y < last; y++) {
+			for (int z = 0; z < SIZE_Z; z++) {
+				_rows[z][wrap(y, SIZE_XY)] = 0;
+			}
+		}
+	}
+
+	// down: clear the layers entering the window
+	if (min.z != _min.z) {
+		const bool all = abs(min.z - _min.z) >= SIZE_Z;
+		const int first = all ? 0 : ((min.z > _min.z) ? _min.z + SIZE_Z : min.z);
+		const int last = all ? SIZE_Z : ((min.z > _min.z) ? min.z + SIZE_Z : _min.z);
+
+		for (int z = first; z < last; z++) {
+			memset(_rows[wrap(z, SIZE_Z)], 0, sizeof(_rows[0]));
+		}
+	}
+
+	_min = min;
+}
+
+template<typename Visitor>
+void OccupancyMap::traverse(const Vector3f &origin, const Vector3f &direction, float length, Visitor visit) const
+{
+	Cell cell = cellOf(origin);
+	int step[3];
+	float t_max[3];
+	float t_delta[3];
+	int *index[3] {&cell.x, &cell.y, &cell.z};
+
+	for (int i = 0; i < 3; i++) {
+		if (direction(i) > FLT_EPSILON) {
+			step[i] = 1;
+			t_max[i] = ((*index[i] + 1) * RESOLUTION - origin(i)) / direction(i);
+			t_delta[i] = RESOLUTION / direction(i);
+
+		} else if (direction(i) < -FLT_EPSILON) {
+			step[i] = -1;
+			t_max[i] = (*index[i] * RESOLUTION - origin(i)) / direction(i);
+			t_delta[i] = -RESOLUTION / direction(i);
+
+		} else {
+			step[i] = 0;
+			t_max[i] = FLT_MAX;
+			t_delta[i] = FLT_MAX;
+		}
+	}
+
+	float t = 0.f;
+
+	while (t <= length && inWindow(cell) && visit(cell, t)) {
+		// step into the neighbor the ray enters first
+		int axis = (t_max[0] < t_max[1]) ? 0 : 1;
+		axis = (t_max[2] < t_max[axis]) ? 2 : axis;
+
+		if (step[axis] == 0) {
+			break;
+		}
+
+		*index[axis] += step[axis];
+		t = t_max[axis];
+		t_max[axis] += t_delta[axis];
+	}
+}
+
+void OccupancyMap::insertRay(const Vector3f &origin, const Vector3f &end, bool hit)
+{
+	const Vector3f ray = end - origin;
+	const float length = ray.norm();
+	const Cell end_cell = cellOf(end);
+
+	if (length > FLT_EPSILON) {
+		// free space up to the cell of the measured point
+		traverse(origin, ray / length, length, [this, &end_cell](const Cell & c, float) {
+			if (c.x == end_cell.x && c.y == end_cell.y && c.z == end_cell.z) {
+				return false;
+			}
+
+			set(c, false);
+			return true;
+		});
+	}
+
+	if (inWindow(end_cell)) {
+		set(end_cell, hit);
+	}
+}
+
+void OccupancyMap::setVoxel(const Vector3f &position, bool occupied)
+{
+	const Cell c = cellOf(position);
+
+	if (inWindow(c)) {
+		set(c, occupied);
+	}
+}
+
+bool OccupancyMap::isOccupied(const Vector3f &position) const
+{
+	const Cell c = cellOf(position);
+	return inWindow(c) && occupied(c);
+}
+
+float OccupancyMap::rayDistance(const Vector3f &origin, const Vector3f &direction, float max_range) const
+{
+	float distance = max_range;
+
+	traverse(origin, direction, max_range, [this, &distance](const Cell & c, float t) {
+		if (occupied(c)) {
+			distance = t;
+			return false;
+		}
+
+		return true;
+	});
+
+	return distance;
+}
+
+int OccupancyMap::occupiedCount() const
+{
+	int count = 0;
+
+	for (int z = 0; z < SIZE_Z; z++) {
+		for (int y = 0; y < SIZE_XY; y++) {
+			count += __builtin_popcount(_rows[z][y]);
+		}
+	}
+
+	return count;
+}
@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file OccupancyMap.hpp
+ *
+ * Compact 3D occupancy map around the vehicle for collision prevention.
+ *
+ * The map is a bitset of SIZE_XY x SIZE_XY x SIZE_Z voxels of RESOLUTION edge length stored as a ring buffer
+ * in all three axes: the window follows the vehicle and only the slices that move into the window are cleared,
+ * the rest of the map is kept in place. Voxels outside the window are unknown.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <matrix/matrix/math.hpp>
+
+class OccupancyMap
+{
+public:
+	static constexpr int SIZE_XY = 32;		///< voxels in north and east direction
+	static constexpr int SIZE_Z = 16;		///< voxels in down direction
+	static constexpr float RESOLUTION = 0.5f;	///< voxel edge length [m]
+
+	OccupancyMap() = default;
+	~OccupancyMap() = default;
+
+	/**
+	 * Clears the map, the next call to setCenter() places the window.
+	 */
+	void reset();
+
+	/**
+	 * Moves the window such that it is centered around the position, voxels moving into the window are cleared.
+	 * @param position, local NED position [m]
+	 */
+	void setCenter(const matrix::Vector3f &position);
+
+	/**
+	 * Marks the voxels along a measurement ray as free and the voxel at the end as occupied if it is a hit.
+	 * @param origin, local NED position of the sensor [m]
+	 * @param end, local NED position of the measured point [m]
+	 * @param hit, true if the measurement ended on an obstacle, false if it is out of range
+	 */
+	void insertRay(const matrix::Vector3f &origin, const matrix::Vector3f &end, bool hit);
+
+	/**
+	 * Sets the state of the voxel containing the position, positions outside of the window are ignored.
+	 */
+	void setVoxel(const matrix::Vector3f &position, bool occupied);
+
+	bool isOccupied(const matrix::Vector3f &position) const;
+
+	/**
+	 * Distance along a ray to the first occupied voxel.
+	 * @param origin, local NED start of the ray [m]
+	 * @param direction, unit direction of the ray
+	 * @param max_range, maximum distance to search [m]
+	 * @return distance to the boundary of the first occupied voxel, max_range if there is none within max_range
+	 * or before the ray leaves the window
+	 */
+	float rayDistance(const matrix::Vector3f &origin, const matrix::Vector3f &direction, float max_range) const;
+
+	int occupiedCount() const;
+
+private:
+	static_assert(SIZE_XY == 32, "a row of voxels is stored in a uint32_t");
+
+	struct Cell {
+		int x;
+		int y;
+		int z;
+	};
+
+	static Cell cellOf(const matrix::Vector3f &position);
+	static int wrap(int i, int size) { return ((i % size) + size) % size; }
+
+	bool inWindow(const Cell &c) const;
+	bool occupied(const Cell &c) const { return _rows[wrap(c.z, SIZE_Z)][wrap(c.y, SIZE_XY)] & (1u << wrap(c.x, SIZE_XY)); }
+	void set(const Cell &c, bool occupied);
+
+	/**
+	 * Visits the voxels along a ray in order (3D DDA) until the visitor returns false, the length is reached or
+	 * the ray leaves the window. The visitor gets the cell and the distance at which the ray enters it.
+	 */
+	template<typename Visitor>
+	void traverse(const matrix::Vector3f &origin, const matrix::Vector3f &direction, float length, Visitor visit) const;
+
+	uint32_t _rows[SIZE_Z][SIZE_XY] {};	///< bit x of _rows[z][y] is the voxel (x, y, z), indices wrapped
+
+	Cell _min{};				///< cell of the minimum corner of the window
+	bool _placed{false};			///< the window has been placed by setCenter()
+};
@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file BlockChain.hpp
+ *
+ * Statically declared chains of filter blocks.
+ *
+ * Unlike the Block tree, a chain has no parent/child lists, no virtual calls and no own
+ * parameter handles: the type of the chain is the list of its stages, its update()
+ * compiles into a single inlined function and the stages read their parameters through
+ * references to the owner's DEFINE_PARAMETERS values, which are updated in one go with
+ * ModuleParams::updateParams().
+ *
+ * Example, the numerical derivative of a signal followed by a low pass filter:
+ *
+ *	control::BlockChain<control::chain::Derivative, control::chain::LowPass> _deriv{
+ *		control::chain::Derivative{}, control::chain::LowPass{_param_cutoff.reference()}};
+ *	...
+ *	const float derivative = _deriv.update(input, dt);
+ */
+
+#pragma once
+
+#include <float.h>
+#include <math.h>
+
+#include <px4_platform_common/defines.h>
+
+namespace control
+{
+
+namespace chain
+{
+
+/**
+ * A first order low pass filter, the first input initializes the state.
+ */
+class LowPass
+{
+public:
+	explicit LowPass(const float &cutoff_freq) : _cutoff_freq(cutoff_freq) {}
+
+	float update(float input, float dt)
+	{
+		if (!PX4_ISFINITE(_state)) {
+			_state = input;
+		}
+
+		const float b = 2.f * float(M_PI) * _cutoff_freq * dt;
+		const float a = b / (1.f + b);
+		_state = a * input + (1.f - a) * _state;
+		return _state;
+	}
+
+	void reset() { _state = NAN; }
+
+	float getState() const { return _state; }
+
+private:
+	const float &_cutoff_freq;	///< [Hz]
+	float _state{NAN};
+};
+
+/**
+ * A first order high pass filter.
+ */
+class HighPass
+{
+public:
+	explicit HighPass(const float &cutoff_freq) : _cutoff_freq(cutoff_freq) {}
+
+	float update(float input, float dt)
+	{
+		const float b = 2.f * float(M_PI) * _cutoff_freq * dt;
+		const float a = 1.f / (1.f + b);
+		_y = a * (_y + input - _u);
+		_u = input;
+		return _y;
+	}
+
+	void reset() { _u = 0.f; _y = 0.f; }
+
+private:
+	const float &_cutoff_freq;	///< [Hz]
+	float _u{0.f};			///< previous input
+	float _y{0.f};			///< previous output
+};
+
+/**
+ * Difference of the current and previous input over dt, 0 on the first update after a reset.
+ */
+class Derivative
+{
+public:
+	float update(float input, float dt)
+	{
+		float output = 0.f;
+
+		if (_initialized && (dt > FLT_EPSILON)) {
+			output = (input - _u) / dt;
+		}
+
+		_u = input;
+		_initialized = true;
+		return output;
+	}
+
+	void reset() { _initialized = false; }
+
+private:
+	float _u{0.f};			///< previous input
+	bool _initialized{false};
+};
+
+/**
+ * Limit to [min, max].
+ */
+class Limit
+{
+public:
+	Limit(const float &min, const float &max) : _min(min), _max(max) {}
+
+	float update(float input, float dt)
+	{
+		return (input < _min) ? _min : ((input > _max) ? _max : input);
+	}
+
+	void reset() {}
+
+private:
+	const float &_min;
+	const float &_max;
+};
+
+/**
+ * Constant gain.
+ */
+class Gain
+{
+public:
+	explicit Gain(const float &gain) : _gain(gain) {}
+
+	float update(float input, float dt) { return _gain * input; }
+
+	void reset() {}
+
+private:
+	const float &_gain;
+};
+
+} // namespace chain
+
+/**
+ * A chain of stages, the output of each stage is the input of the next one.
+ */
+template<typename... Stages>
+class BlockChain;
+
+template<>
+class BlockChain<>
+{
+public:
+	float update(float input, float dt) { return input; }
+	void reset() {}
+};
+
+template<typename First, typename... Rest>
+class BlockChain<First, Rest...>
+{
+public:
+	BlockChain(const First &first, const Rest &... rest) : _first(first), _rest(rest...) {}
+
+	float update(float input, float dt) { return _rest.update(_first.update(input, dt), dt); }
+
+	/**
+	 * Reset the state of all stages.
+	 */
+	void reset()
+	{
+		_first.reset();
+		_rest.reset();
+	}
+
+	First &first() { return _first; }
+	BlockChain<Rest...> &rest() { return _rest; }
+
+private:
+	First _first;
+	BlockChain<Rest...> _rest;
+};
+
+} // namespace control
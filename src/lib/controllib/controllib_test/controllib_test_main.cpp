@@ -43,6 +43,7 @@
 #include <float.h>
 
 #include <controllib/blocks.hpp>
+#include <controllib/BlockChain.hpp>
 
 using namespace control;
 
@@ -66,6 +67,7 @@ int blockRandUniformTest();
 int blockRandGaussTest();
 int blockStatsTest();
 int blockDelayTest();
+int blockChainTest();
 
 int basicBlocksTest()
 {
@@ -87,6 +89,7 @@ int basicBlocksTest()
 	failed = failed || blockRandGaussTest() < 0;
 	failed = failed || blockStatsTest() < 0;
 	failed = failed || blockDelayTest() < 0;
+	failed = failed || blockChainTest() < 0;
 	return failed ? -1 : 0;
 }
 
@@ -527,6 +530,28 @@ int blockDelayTest()
 	return 0;
 }
 
+int blockChainTest()
+{
+	printf("Test BlockChain\t\t\t: ");
+	const float cutoff = 10.0f;
+	const float min = -5.0f;
+	const float max = 5.0f;
+	BlockChain<chain::Derivative, chain::LowPass, chain::Limit> derivative(chain::Derivative{}, chain::LowPass{cutoff},
+			chain::Limit{min, max});
+	// same response as BlockDerivative, first update initializes
+	ASSERT_CL(equal(0.0f, derivative.update(1.0f, 0.1f)));
+	ASSERT_CL(equal(8.6269744f, derivative.rest().first().update(10.0f, 0.1f)));
+	derivative.reset();
+	ASSERT_CL(equal(0.0f, derivative.update(1.0f, 0.1f)));
+	// limited output
+	ASSERT_CL(equal(5.0f, derivative.update(2.0f, 0.1f)));
+	// empty chain
+	BlockChain<> identity;
+	ASSERT_CL(equal(3.0f, identity.update(3.0f, 0.1f)));
+	printf("PASS\n");
+	return 0;
+}
+
 extern "C" __EXPORT int controllib_test_main(int argc, char *argv[]);
 
 int controllib_test_main(int argc, char *argv[])
@@ -35,6 +35,7 @@
 #include "PX4Accelerometer.hpp"
 
 #include <lib/drivers/device/Device.hpp>
+#include <lib/mathlib/mathlib.h>
 
 using namespace time_literals;
 using matrix::Vector3f;
@@ -79,6 +80,11 @@ PX4Accelerometer::PX4Accelerometer(uint32_t device_id, uint8_t priority, enum Ro
 	// set software low pass filter for controllers
 	updateParams();
 	ConfigureFilter(_param_imu_accel_cutoff.get());
+
+	// integrate over the IMU period of the estimators
+	_integration_interval = 1000000 / math::constrain(_param_imu_integ_rate.get(), (int32_t)100, (int32_t)1000);
+	_integrator.set_autoreset_interval(_integration_interval);
+	set_update_rate(_update_rate);
 }
 
 PX4Accelerometer::~PX4Accelerometer()
@@ -132,8 +138,10 @@ void PX4Accelerometer::set_sample_rate(uint16_t rate)
 
 void PX4Accelerometer::set_update_rate(uint16_t rate)
 {
+	_update_rate = rate;
+
 	const uint32_t update_interval = 1000000 / rate;
-	_integrator_reset_samples = 4000 / update_interval;
+	_integrator_reset_samples = math::max(_integration_interval / update_interval, (uint32_t)1);
 }
 
 void PX4Accelerometer::update(hrt_abstime timestamp_sample, float x, float y, float z)
@@ -245,20 +253,14 @@ void PX4Accelerometer::updateFIFO(const FIFOSample &sample)
 			ResetIntegrator();
 		}
 
-		// integrate
-		_integrator_samples += 1;
-		_integrator_fifo_samples += N;
-
-		// trapezoidal integration (equally spaced, scaled by dt later)
-		_integration_raw(0) += (0.5f * (_last_sample[0] + sample.x[N - 1]) + sum(sample.x, N - 1));
-		_integration_raw(1) += (0.5f * (_last_sample[1] + sample.y[N - 1]) + sum(sample.y, N - 1));
-		_integration_raw(2) += (0.5f * (_last_sample[2] + sample.z[N - 1]) + sum(sample.z, N - 1));
-		_last_sample[0] = sample.x[N - 1];
-		_last_sample[1] = sample.y[N - 1];
-		_last_sample[2] = sample.z[N - 1];
+		// calibration offset in the sensor frame (raw units)
+		const Vector3f offset_raw{_rotation_dcm.transpose() * _calibration_offset / _scale};
 
+		// integrate (equally spaced, scaled by dt later)
+		_integrator_samples += 1;
+		_integrator_fifo.put(sample.x, sample.y, sample.z, N, offset_raw);
 
-		if (_integrator_fifo_samples > 0 && (_integrator_samples >= _integrator_reset_samples)) {
+		if (_integrator_fifo.samples() > 0 && (_integrator_samples >= _integrator_reset_samples)) {
 
 			// publish control data (filtered)
 			{
@@ -275,15 +277,8 @@ void PX4Accelerometer::updateFIFO(const FIFOSample &sample)
 				_sensor_pub.publish(report);
 			}
 
-			// Apply rotation and scale
-			// integrated in microseconds, convert to seconds
-			const Vector3f delta_velocity_uncalibrated{_rotation_dcm *_integration_raw * _scale};
-
-			// scale calibration offset to number of samples
-			const Vector3f offset{_calibration_offset * _integrator_fifo_samples};
-
-			// Apply calibration and scale to seconds
-			Vector3f delta_velocity{((delta_velocity_uncalibrated - offset).emult(_calibration_scale))};
+			// Apply rotation, scale and calibration (dt in microseconds, convert to seconds)
+			Vector3f delta_velocity{(_rotation_dcm * _integrator_fifo.integral() * _scale).emult(_calibration_scale)};
 			delta_velocity *= 1e-6f * dt;
 
 			// fill sensor_accel_integrated and publish
@@ -293,8 +288,8 @@ void PX4Accelerometer::updateFIFO(const FIFOSample &sample)
 			report.error_count = _error_count;
 			report.device_id = _device_id;
 			delta_velocity.copyTo(report.delta_velocity);
-			report.dt = _integrator_fifo_samples * dt; // time span in microseconds
-			report.samples = _integrator_fifo_samples;
+			report.dt = _integrator_fifo.samples() * dt; // time span in microseconds
+			report.samples = _integrator_fifo.samples();
 			report.clip_count = _integrator_clipping;
 
 			report.timestamp = hrt_absolute_time();
@@ -317,6 +312,7 @@ void PX4Accelerometer::updateFIFO(const FIFOSample &sample)
 	fifo.timestamp_sample = sample.timestamp_sample;
 	fifo.dt = dt;
 	fifo.scale = _scale;
+	fifo.rotation = _rotation;
 	fifo.samples = N;
 
 	memcpy(fifo.x, sample.x, sizeof(sample.x[0]) * N);
@@ -357,8 +353,7 @@ void PX4Accelerometer::PublishStatus()
 void PX4Accelerometer::ResetIntegrator()
 {
 	_integrator_samples = 0;
-	_integrator_fifo_samples = 0;
-	_integration_raw.zero();
+	_integrator_fifo.reset();
 	_integrator_clipping = 0;
 
 	_timestamp_sample_prev = 0;
@@ -40,8 +40,10 @@
 #include <lib/drivers/device/integrator.h>
 #include <lib/ecl/geo/geo.h>
 #include <lib/mathlib/math/filter/LowPassFilter2pArray.hpp>
+#include <lib/mathlib/math/filter/LowPassFilter2pArrayFixed.hpp>
 #include <lib/mathlib/math/filter/LowPassFilter2pVector3f.hpp>
 #include <px4_platform_common/module_params.h>
+#include <px4_platform_common/px4_config.h>
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/topics/sensor_accel.h>
 #include <uORB/topics/sensor_accel_fifo.h>
@@ -103,9 +105,16 @@ private:
 
 	hrt_abstime	_status_last_publish{0};
 
-	math::LowPassFilter2pArray _filterArrayX{4000, 100};
-	math::LowPassFilter2pArray _filterArrayY{4000, 100};
-	math::LowPassFilter2pArray _filterArrayZ{4000, 100};
+#if defined(CONFIG_ARCH_CORTEXM4)
+	// fixed-point FIFO filter on the slower Cortex-M4 boards
+	using FIFOFilter = math::LowPassFilter2pArrayFixed;
+#else
+	using FIFOFilter = math::LowPassFilter2pArray;
+#endif
+
+	FIFOFilter _filterArrayX{4000, 100};
+	FIFOFilter _filterArrayY{4000, 100};
+	FIFOFilter _filterArrayZ{4000, 100};
 
 	Integrator		_integrator{4000, false};
 
@@ -136,14 +145,14 @@ private:
 
 	// integrator
 	hrt_abstime		_timestamp_sample_prev{0};
-	matrix::Vector3f	_integration_raw{};
-	int16_t			_last_sample[3] {};
+	IntegratorFIFO		_integrator_fifo{false};
+	uint32_t		_integration_interval{4000};	///< IMU_INTEG_RATE [us]
 	uint8_t			_integrator_reset_samples{4};
 	uint8_t			_integrator_samples{0};
-	uint8_t			_integrator_fifo_samples{0};
 	uint8_t			_integrator_clipping{0};
 
 	DEFINE_PARAMETERS(
-		(ParamFloat<px4::params::IMU_ACCEL_CUTOFF>) _param_imu_accel_cutoff
+		(ParamFloat<px4::params::IMU_ACCEL_CUTOFF>) _param_imu_accel_cutoff,
+		(ParamInt<px4::params::IMU_INTEG_RATE>) _param_imu_integ_rate
 	)
 };
@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Benchmarks of the sensor integrators and the ring buffer
+ * Run with make benchmarks
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "integrator.h"
+#include "ringbuffer.h"
+
+static void Integrator_put(benchmark::State &state)
+{
+	Integrator integrator{4000, state.range(0) != 0};
+	matrix::Vector3f integral{};
+	uint32_t integral_dt = 0;
+	uint64_t timestamp = 0;
+	matrix::Vector3f val{0.1f, -0.2f, 9.81f};
+
+	for (auto _ : state) {
+		// 1 kHz samples
+		timestamp += 1000;
+		val(0) += 0.001f;
+		benchmark::DoNotOptimize(integrator.put(timestamp, val, integral, integral_dt));
+	}
+}
+BENCHMARK(Integrator_put)->Arg(0)->Arg(1);
+
+/**
+ * Argument: samples per FIFO block
+ */
+static void IntegratorFIFO_put(benchmark::State &state)
+{
+	const uint8_t N = state.range(0);
+	IntegratorFIFO integrator{true};
+	int16_t x[32], y[32], z[32];
+
+	for (int i = 0; i < N; i++) {
+		x[i] = 100 + i;
+		y[i] = -200 + i;
+		z[i] = 4096 - i;
+	}
+
+	const matrix::Vector3f offset{1.f, -2.f, 3.f};
+
+	for (auto _ : state) {
+		integrator.put(x, y, z, N, offset);
+		benchmark::DoNotOptimize(integrator.integral());
+		integrator.reset();
+	}
+
+	state.SetItemsProcessed(state.iterations() * N);
+}
+BENCHMARK(IntegratorFIFO_put)->Arg(8)->Arg(32);
+
+/**
+ * Argument: item size
+ */
+static void RingBuffer_put_get(benchmark::State &state)
+{
+	const size_t item_size = state.range(0);
+	ringbuffer::RingBuffer buffer{16, item_size};
+	uint8_t item[256] {};
+
+	for (auto _ : state) {
+		item[0]++;
+		buffer.put(item, item_size);
+		buffer.get(item, item_size);
+		benchmark::DoNotOptimize(item);
+	}
+
+	state.SetBytesProcessed(state.iterations() * item_size);
+}
+BENCHMARK(RingBuffer_put_get)->Arg(4)->Arg(64)->Arg(256);
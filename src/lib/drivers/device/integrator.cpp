@@ -125,3 +125,82 @@ Integrator::_reset(uint32_t &integral_dt)
 
 	_last_reset_time = _last_integration_time;
 }
+
+void
+IntegratorFIFO::put(const int16_t x[], const int16_t y[], const int16_t z[], uint8_t N, const matrix::Vector3f &offset)
+{
+	// work on scalar copies of the state so the block loop stays in registers
+	float alpha_x = _alpha(0);
+	float alpha_y = _alpha(1);
+	float alpha_z = _alpha(2);
+
+	float beta_x = _beta(0);
+	float beta_y = _beta(1);
+	float beta_z = _beta(2);
+
+	float last_delta_x = _last_delta_alpha(0);
+	float last_delta_y = _last_delta_alpha(1);
+	float last_delta_z = _last_delta_alpha(2);
+
+	float last_x = _last_sample[0];
+	float last_y = _last_sample[1];
+	float last_z = _last_sample[2];
+
+	const float offset_x = offset(0);
+	const float offset_y = offset(1);
+	const float offset_z = offset(2);
+
+	for (int n = 0; n < N; n++) {
+		const float sample_x = x[n];
+		const float sample_y = y[n];
+		const float sample_z = z[n];
+
+		// trapezoidal integration of the sampling interval
+		const float delta_x = 0.5f * (last_x + sample_x) - offset_x;
+		const float delta_y = 0.5f * (last_y + sample_y) - offset_y;
+		const float delta_z = 0.5f * (last_z + sample_z) - offset_z;
+
+		if (_coning_comp_on) {
+			// Coning compensation, see Savage (1998) Strapdown Inertial Navigation Integration
+			// Algorithm Design Part 1: Attitude Algorithms, equation 26
+			const float a_x = alpha_x + last_delta_x * (1.f / 6.f);
+			const float a_y = alpha_y + last_delta_y * (1.f / 6.f);
+			const float a_z = alpha_z + last_delta_z * (1.f / 6.f);
+
+			beta_x += 0.5f * (a_y * delta_z - a_z * delta_y);
+			beta_y += 0.5f * (a_z * delta_x - a_x * delta_z);
+			beta_z += 0.5f * (a_x * delta_y - a_y * delta_x);
+
+			last_delta_x = delta_x;
+			last_delta_y = delta_y;
+			last_delta_z = delta_z;
+		}
+
+		// accumulate delta integrals
+		alpha_x += delta_x;
+		alpha_y += delta_y;
+		alpha_z += delta_z;
+
+		last_x = sample_x;
+		last_y = sample_y;
+		last_z = sample_z;
+	}
+
+	_alpha = matrix::Vector3f{alpha_x, alpha_y, alpha_z};
+	_beta = matrix::Vector3f{beta_x, beta_y, beta_z};
+	_last_delta_alpha = matrix::Vector3f{last_delta_x, last_delta_y, last_delta_z};
+
+	_last_sample[0] = last_x;
+	_last_sample[1] = last_y;
+	_last_sample[2] = last_z;
+
+	_samples += N;
+}
+
+void
+IntegratorFIFO::reset()
+{
+	_alpha.zero();
+	_beta.zero();
+	_samples = 0;
+}
@@ -91,3 +91,53 @@ private:
 	 */
 	void _reset(uint32_t &integral_dt);
 };
+
+/**
+ * Integrator for blocks of equally spaced raw FIFO samples.
+ *
+ * The whole block is integrated in one pass (trapezoidal, in raw units times the sample
+ * interval), optionally with coning corrections. The integral is in the sensor frame,
+ * the caller applies rotation and scale.
+ */
+class IntegratorFIFO
+{
+public:
+	IntegratorFIFO(bool coning_compensation = false) : _coning_comp_on(coning_compensation) {}
+	~IntegratorFIFO() = default;
+
+	/**
+	 * Put a block of samples into the integral.
+	 *
+	 * @param x		Raw samples of the x axis.
+	 * @param y		Raw samples of the y axis.
+	 * @param z		Raw samples of the z axis.
+	 * @param N		Number of samples.
+	 * @param offset	Sensor frame offset (raw units) removed from each sample.
+	 */
+	void put(const int16_t x[], const int16_t y[], const int16_t z[], uint8_t N, const matrix::Vector3f &offset);
+
+	/**
+	 * Reset the integral and the coning corrections. The last sample is kept, the next
+	 * block continues the trapezoidal integration.
+	 */
+	void reset();
+
+	// integral of the offset corrected samples (raw units * samples)
+	const matrix::Vector3f &integral() const { return _alpha; }
+
+	// accumulated coning corrections ((raw units * samples)^2)
+	const matrix::Vector3f &coning_corrections() const { return _beta; }
+
+	// number of samples since the last reset
+	uint16_t samples() const { return _samples; }
+
+private:
+	matrix::Vector3f _alpha{0.f, 0.f, 0.f};			/**< integrated value before coning corrections are applied */
+	matrix::Vector3f _beta{0.f, 0.f, 0.f};			/**< accumulated coning corrections */
+	matrix::Vector3f _last_delta_alpha{0.f, 0.f, 0.f};	/**< integral of the previous sampling interval */
+	float _last_sample[3] {};				/**< previous raw input */
+
+	uint16_t _samples{0};
+
+	bool _coning_comp_on{false};				/**< true to turn on coning corrections */
+};
@@ -68,6 +68,11 @@ I2C::I2C(const char *name, const char *devname, const int bus, const uint16_t ad
 
 I2C::~I2C()
 {
+	// the pending transfer references this device
+	while (transferAsyncPending()) {
+		px4_usleep(100);
+	}
+
 	if (_dev) {
 		px4_i2cbus_uninitialize(_dev);
 		_dev = nullptr;
@@ -229,4 +234,37 @@ I2C::transfer(const uint8_t *send, const unsigned send_len, uint8_t *recv, const
 	return ret;
 }
 
+int
+I2C::transferAsync(const uint8_t *send, const unsigned send_len, uint8_t *recv, const unsigned recv_len,
+		   px4::WorkItem *work_item)
+{
+	if (((send_len == 0) && (recv_len == 0)) || (work_item == nullptr)) {
+		return -EINVAL;
+	}
+
+	if (_bus_transfer == nullptr) {
+		_bus_transfer = I2CBusTransfer::instance(get_device_bus());
+
+		if (_bus_transfer == nullptr) {
+			return -ENOMEM;
+		}
+	}
+
+	if (_async_transfer.busy.load()) {
+		return -EBUSY;
+	}
+
+	_async_transfer.dev = this;
+	_async_transfer.send = send;
+	_async_transfer.send_len = send_len;
+	_async_transfer.recv = recv;
+	_async_transfer.recv_len = recv_len;
+	_async_transfer.work_item = work_item;
+	_async_transfer.busy.store(true);
+
+	_bus_transfer->queue(&_async_transfer);
+
+	return PX4_OK;
+}
+
 } // namespace device
@@ -41,6 +41,7 @@
 #define _DEVICE_I2C_H
 
 #include "../CDev.hpp"
+#include "I2CBusTransfer.hpp"
 
 #include <nuttx/i2c/i2c_master.h>
 
@@ -109,12 +110,45 @@ protected:
 	 */
 	int		transfer(const uint8_t *send, const unsigned send_len, uint8_t *recv, const unsigned recv_len);
 
+	/**
+	 * Queue an I2C transaction and return immediately.
+	 *
+	 * The transaction is done on the transfer work queue of the bus, and work_item is scheduled
+	 * once it completed. Get the result with transferAsyncResult(). Only one transfer per
+	 * device can be pending, and the buffers must stay valid until it completed.
+	 *
+	 * @param send		Pointer to bytes to send (e.g. the start register of a multi-register read).
+	 * @param send_len	Number of bytes to send.
+	 * @param recv		Pointer to buffer for bytes received.
+	 * @param recv_len	Number of bytes to receive.
+	 * @param work_item	WorkItem scheduled on completion.
+	 * @return		OK if the transfer was queued, -EBUSY if a transfer
+	 *			is still pending, -errno otherwise.
+	 */
+	int		transferAsync(const uint8_t *send, const unsigned send_len, uint8_t *recv, const unsigned recv_len,
+				      px4::WorkItem *work_item);
+
+	/**
+	 * @return true while an asynchronous transfer is queued or in progress
+	 */
+	bool		transferAsyncPending() const { return _async_transfer.busy.load(); }
+
+	/**
+	 * @return the result of the last completed asynchronous transfer, -EBUSY if still pending
+	 */
+	int		transferAsyncResult() const { return transferAsyncPending() ? -EBUSY : _async_transfer.result; }
+
 	virtual bool	external() const override { return px4_i2c_bus_external(_device_id.devid_s.bus); }
 
 private:
 	uint32_t		_frequency{0};
 	i2c_master_s		*_dev{nullptr};
 
+	I2CBusTransfer		*_bus_transfer{nullptr};
+	I2CBusTransfer::Transfer _async_transfer{};
+
+	friend class I2CBusTransfer;
+
 };
 
 } // namespace device
@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file I2CBusTransfer.cpp
+ */
+
+#include "I2CBusTransfer.hpp"
+#include "I2C.hpp"
+
+#include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
+
+namespace device
+{
+
+static constexpr int I2C_BUS_TRANSFER_MAX = 5;
+
+static px4::atomic<I2CBusTransfer *> i2c_bus_transfers[I2C_BUS_TRANSFER_MAX] {};
+
+static const px4::wq_config_t *bus_to_transfer_wq(int bus)
+{
+	switch (bus) {
+	case 0: return &px4::wq_configurations::I2C0_transfer;
+
+	case 1: return &px4::wq_configurations::I2C1_transfer;
+
+	case 2: return &px4::wq_configurations::I2C2_transfer;
+
+	case 3: return &px4::wq_configurations::I2C3_transfer;
+
+	case 4: return &px4::wq_configurations::I2C4_transfer;
+	}
+
+	return nullptr;
+}
+
+I2CBusTransfer::I2CBusTransfer(const px4::wq_config_t &config) :
+	px4::WorkItem(config.name, config)
+{
+}
+
+I2CBusTransfer *I2CBusTransfer::instance(int bus)
+{
+	const px4::wq_config_t *config = bus_to_transfer_wq(bus);
+
+	if (config == nullptr) {
+		return nullptr;
+	}
+
+	I2CBusTransfer *bus_transfer = i2c_bus_transfers[bus].load();
+
+	if (bus_transfer == nullptr) {
+		I2CBusTransfer *new_bus_transfer = new I2CBusTransfer(*config);
+
+		if (new_bus_transfer == nullptr) {
+			return nullptr;
+		}
+
+		// another device on the same bus might have been faster
+		if (i2c_bus_transfers[bus].compare_exchange(&bus_transfer, new_bus_transfer)) {
+			bus_transfer = new_bus_transfer;
+
+		} else {
+			delete new_bus_transfer;
+		}
+	}
+
+	return bus_transfer;
+}
+
+void I2CBusTransfer::queue(Transfer *transfer)
+{
+	irqstate_t flags = px4_enter_critical_section();
+	_queue.push(transfer);
+	px4_leave_critical_section(flags);
+
+	ScheduleNow();
+}
+
+void I2CBusTransfer::Run()
+{
+	while (true) {
+		irqstate_t flags = px4_enter_critical_section();
+		Transfer *transfer = _queue.pop();
+		px4_leave_critical_section(flags);
+
+		if (transfer == nullptr) {
+			break;
+		}
+
+		// blocking (including the retries of the device), but only for this work queue
+		transfer->result = transfer->dev->transfer(transfer->send, transfer->send_len, transfer->recv, transfer->recv_len);
+		transfer->busy.store(false);
+
+		transfer->work_item->ScheduleNow();
+	}
+}
+
+} // namespace device
@@ -48,6 +48,7 @@
 #include "SPI.hpp"
 
 #include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/time.h>
 #include <nuttx/arch.h>
 
 #ifndef CONFIG_SPI_EXCHANGE
@@ -74,6 +75,11 @@ SPI::SPI(const char *name, const char *devname, int bus, uint32_t device, enum s
 
 SPI::~SPI()
 {
+	// the pending transfer references this device
+	while (transferAsyncPending()) {
+		px4_usleep(100);
+	}
+
 	// XXX no way to let go of the bus...
 }
 
@@ -156,6 +162,37 @@ SPI::transfer(uint8_t *send, uint8_t *recv, unsigned len)
 	return result;
 }
 
+int
+SPI::transferAsync(uint8_t *send, uint8_t *recv, unsigned len, px4::WorkItem *work_item)
+{
+	if (((send == nullptr) && (recv == nullptr)) || (work_item == nullptr)) {
+		return -EINVAL;
+	}
+
+	if (_bus_transfer == nullptr) {
+		_bus_transfer = SPIBusTransfer::instance(get_device_bus());
+
+		if (_bus_transfer == nullptr) {
+			return -ENOMEM;
+		}
+	}
+
+	if (_async_transfer.busy.load()) {
+		return -EBUSY;
+	}
+
+	_async_transfer.dev = this;
+	_async_transfer.send = send;
+	_async_transfer.recv = recv;
+	_async_transfer.len = len;
+	_async_transfer.work_item = work_item;
+	_async_transfer.busy.store(true);
+
+	_bus_transfer->queue(&_async_transfer);
+
+	return PX4_OK;
+}
+
 int
 SPI::_transfer(uint8_t *send, uint8_t *recv, unsigned len)
 {
@@ -41,6 +41,7 @@
 #define _DEVICE_SPI_H
 
 #include "../CDev.hpp"
+#include "SPIBusTransfer.hpp"
 
 #include <nuttx/spi/spi.h>
 
@@ -82,6 +83,14 @@ protected:
 		LOCK_NONE		/**< perform no locking, only safe if the bus is entirely private */
 	};
 
+	/**
+	 * Order of the asynchronous transfers of the devices on a bus.
+	 */
+	enum TransferPriority : uint8_t {
+		PRIORITY_LOW = 0,	/**< the default, polled devices */
+		PRIORITY_HIGH = 1	/**< data ready driven devices with a deadline (IMU FIFO reads) */
+	};
+
 	virtual int	init() override;
 
 	/**
@@ -110,6 +119,42 @@ protected:
 	 */
 	int		transfer(uint8_t *send, uint8_t *recv, unsigned len);
 
+	/**
+	 * Queue a SPI transfer and return immediately.
+	 *
+	 * The transfer is done on the transfer work queue of the bus, and work_item is scheduled
+	 * once it completed. Get the result with transferAsyncResult(). Only one transfer per
+	 * device can be pending, and the buffers must stay valid until it completed.
+	 *
+	 * @param send		Bytes to send to the device, or nullptr if
+	 *			no data is to be sent.
+	 * @param recv		Buffer for receiving bytes from the device,
+	 *			or nullptr if no bytes are to be received.
+	 * @param len		Number of bytes to transfer.
+	 * @param work_item	WorkItem scheduled on completion.
+	 * @return		OK if the transfer was queued, -EBUSY if a transfer
+	 *			is still pending, -errno otherwise.
+	 */
+	int		transferAsync(uint8_t *send, uint8_t *recv, unsigned len, px4::WorkItem *work_item);
+
+	/**
+	 * @return true while an asynchronous transfer is queued or in progress
+	 */
+	bool		transferAsyncPending() const { return _async_transfer.busy.load(); }
+
+	/**
+	 * @return the result of the last completed asynchronous transfer, -EBUSY if still pending
+	 */
+	int		transferAsyncResult() const { return transferAsyncPending() ? -EBUSY : _async_transfer.result; }
+
+	/**
+	 * Set the scheduling priority of the asynchronous transfers of this device on the bus.
+	 *
+	 * @param priority	PRIORITY_HIGH for data ready driven devices with a deadline,
+	 *			polled devices keep the default PRIORITY_LOW
+	 */
+	void		set_transfer_priority(TransferPriority priority) { _async_transfer.priority = priority; }
+
 	/**
 	 * Perform a SPI 16 bit transfer.
 	 *
@@ -161,6 +206,11 @@ private:
 
 	LockMode		_locking_mode{LOCK_THREADS};	/**< selected locking mode */
 
+	SPIBusTransfer		*_bus_transfer{nullptr};
+	SPIBusTransfer::Transfer _async_transfer{};
+
+	friend class SPIBusTransfer;
+
 protected:
 	int	_transfer(uint8_t *send, uint8_t *recv, unsigned len);
 
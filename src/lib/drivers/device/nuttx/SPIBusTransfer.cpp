@@ -0,0 +1,181 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file SPIBusTransfer.cpp
+ */
+
+#include "SPIBusTransfer.hpp"
+#include "SPI.hpp"
+
+#include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
+
+namespace device
+{
+
+static constexpr int SPI_BUS_TRANSFER_MAX = 7;
+
+static px4::atomic<SPIBusTransfer *> spi_bus_transfers[SPI_BUS_TRANSFER_MAX] {};
+
+static const px4::wq_config_t *bus_to_transfer_wq(int bus)
+{
+	switch (bus) {
+	case 0: return &px4::wq_configurations::SPI0_transfer;
+
+	case 1: return &px4::wq_configurations::SPI1_transfer;
+
+	case 2: return &px4::wq_configurations::SPI2_transfer;
+
+	case 3: return &px4::wq_configurations::SPI3_transfer;
+
+	case 4: return &px4::wq_configurations::SPI4_transfer;
+
+	case 5: return &px4::wq_configurations::SPI5_transfer;
+
+	case 6: return &px4::wq_configurations::SPI6_transfer;
+	}
+
+	return nullptr;
+}
+
+SPIBusTransfer::SPIBusTransfer(const px4::wq_config_t &config) :
+	px4::WorkItem(config.name, config)
+{
+}
+
+SPIBusTransfer *SPIBusTransfer::instance(int bus)
+{
+	const px4::wq_config_t *config = bus_to_transfer_wq(bus);
+
+	if (config == nullptr) {
+		return nullptr;
+	}
+
+	SPIBusTransfer *bus_transfer = spi_bus_transfers[bus].load();
+
+	if (bus_transfer == nullptr) {
+		SPIBusTransfer *new_bus_transfer = new SPIBusTransfer(*config);
+
+		if (new_bus_transfer == nullptr) {
+			return nullptr;
+		}
+
+		// another device on the same bus might have been faster
+		if (spi_bus_transfers[bus].compare_exchange(&bus_transfer, new_bus_transfer)) {
+			bus_transfer = new_bus_transfer;
+
+		} else {
+			delete new_bus_transfer;
+		}
+	}
+
+	return bus_transfer;
+}
+
+void SPIBusTransfer::queue(Transfer *transfer)
+{
+	transfer->next = nullptr;
+
+	irqstate_t flags = px4_enter_critical_section();
+
+	// insert sorted by priority, FIFO within the same priority
+	Transfer **node = &_head;
+
+	while ((*node != nullptr) && ((*node)->priority >= transfer->priority)) {
+		node = &(*node)->next;
+	}
+
+	transfer->next = *node;
+	*node = transfer;
+
+	px4_leave_critical_section(flags);
+
+	ScheduleNow();
+}
+
+SPIBusTransfer::Transfer *SPIBusTransfer::pop()
+{
+	irqstate_t flags = px4_enter_critical_section();
+
+	Transfer *transfer = _head;
+
+	if (transfer != nullptr) {
+		_head = transfer->next;
+		transfer->next = nullptr;
+	}
+
+	px4_leave_critical_section(flags);
+
+	return transfer;
+}
+
+void SPIBusTransfer::Run()
+{
+	Transfer *transfer = pop();
+
+	while (transfer != nullptr) {
+		SPI *dev = transfer->dev;
+
+		if (dev->_locking_mode != SPI::LOCK_THREADS) {
+			// blocking, but only for this work queue
+			transfer->result = dev->transfer(transfer->send, transfer->recv, transfer->len);
+			transfer->busy.store(false);
+			transfer->work_item->ScheduleNow();
+
+			transfer = pop();
+			continue;
+		}
+
+		// batch: back to back transfers (re-checking the priority order after each) with a single bus lock
+		struct spi_dev_s *bus = dev->_dev;
+		SPI_LOCK(bus, true);
+
+		for (int i = 0; (i < BATCH_MAX) && (transfer != nullptr); i++) {
+			transfer->result = transfer->dev->_transfer(transfer->send, transfer->recv, transfer->len);
+			transfer->busy.store(false);
+
+			// the driver can process the data while the next transfer is running
+			transfer->work_item->ScheduleNow();
+
+			transfer = pop();
+
+			if ((transfer != nullptr) && (transfer->dev->_locking_mode != SPI::LOCK_THREADS)) {
+				break;
+			}
+		}
+
+		SPI_LOCK(bus, false);
+	}
+}
+
+} // namespace device
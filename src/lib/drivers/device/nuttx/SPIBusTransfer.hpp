@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file SPIBusTransfer.hpp
+ *
+ * Asynchronous transfers of the devices on a SPI bus (see SPI::transferAsync()).
+ */
+
+#pragma once
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
+namespace device
+{
+
+class SPI;
+
+/**
+ * Scheduler of the asynchronous transfers on one SPI bus.
+ *
+ * The transfers run on a separate work queue per bus (wq:SPIn_xfer), which waits for the (DMA)
+ * exchange to complete. Meanwhile the driver work queue (wq:SPIn) is free to process the data of
+ * the other devices on the bus. The WorkItem of the device is scheduled on completion.
+ *
+ * Pending transfers are ordered by the priority of the device (data ready driven sensors first,
+ * polled sensors in the gaps) and run back to back while holding the bus lock once.
+ */
+class SPIBusTransfer : public px4::WorkItem
+{
+public:
+
+	struct Transfer {
+		Transfer *next{nullptr};	/**< next pending transfer (lower or equal priority) */
+
+		SPI *dev{nullptr};
+		uint8_t *send{nullptr};
+		uint8_t *recv{nullptr};
+		unsigned len{0};
+		px4::WorkItem *work_item{nullptr};	/**< scheduled once the transfer completed */
+		uint8_t priority{0};			/**< SPI::TransferPriority of the device */
+
+		int result{PX4_OK};
+		px4::atomic_bool busy{false};		/**< queued or in progress */
+	};
+
+	/**
+	 * Get the transfer queue of a bus, it's created on first use.
+	 * @return nullptr if the bus is invalid or out of memory
+	 */
+	static SPIBusTransfer *instance(int bus);
+
+	/**
+	 * Queue a transfer behind all pending transfers of the same or higher priority.
+	 * The busy flag must be set by the caller.
+	 */
+	void queue(Transfer *transfer);
+
+private:
+	explicit SPIBusTransfer(const px4::wq_config_t &config);
+	~SPIBusTransfer() override = default;
+
+	void Run() override;
+
+	Transfer *pop();
+
+	/**
+	 * Maximum number of transfers done back to back without releasing the bus lock,
+	 * so that blocking transfers of the other devices still get the bus.
+	 */
+	static constexpr int BATCH_MAX = 4;
+
+	Transfer *_head{nullptr};		/**< pending transfers, highest priority first */
+};
+
+} // namespace device
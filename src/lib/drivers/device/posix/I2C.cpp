@@ -173,6 +173,21 @@ I2C::transfer(const uint8_t *send, const unsigned send_len, uint8_t *recv, const
 	return ret;
 }
 
+int
+I2C::transferAsync(const uint8_t *send, const unsigned send_len, uint8_t *recv, const unsigned recv_len,
+		   px4::WorkItem *work_item)
+{
+	if (((send_len == 0) && (recv_len == 0)) || (work_item == nullptr)) {
+		return -EINVAL;
+	}
+
+	_async_transfer_result = transfer(send, send_len, recv, recv_len);
+
+	work_item->ScheduleNow();
+
+	return PX4_OK;
+}
+
 } // namespace device
 
 #endif // __PX4_LINUX
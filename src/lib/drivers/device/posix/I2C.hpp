@@ -42,6 +42,8 @@
 
 #include "../CDev.hpp"
 
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
 namespace device __EXPORT
 {
 
@@ -99,11 +101,33 @@ protected:
 	 */
 	int		transfer(const uint8_t *send, const unsigned send_len, uint8_t *recv, const unsigned recv_len);
 
+	/**
+	 * Perform an I2C transaction to the device and schedule work_item.
+	 *
+	 * Same interface as the asynchronous transfer on NuttX, but the transfer is done
+	 * immediately.
+	 *
+	 * @param send		Pointer to bytes to send.
+	 * @param send_len	Number of bytes to send.
+	 * @param recv		Pointer to buffer for bytes received.
+	 * @param recv_len	Number of bytes to receive.
+	 * @param work_item	WorkItem scheduled on completion.
+	 * @return		OK if the transfer was done, -errno otherwise.
+	 */
+	int		transferAsync(const uint8_t *send, const unsigned send_len, uint8_t *recv, const unsigned recv_len,
+				      px4::WorkItem *work_item);
+
+	bool		transferAsyncPending() const { return false; }
+
+	int		transferAsyncResult() const { return _async_transfer_result; }
+
 	virtual bool	external() const override { return px4_i2c_bus_external(_device_id.devid_s.bus); }
 
 private:
 	int			_fd{-1};
 
+	int			_async_transfer_result{PX4_OK};
+
 };
 
 } // namespace device
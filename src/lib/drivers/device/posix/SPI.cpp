@@ -146,6 +146,20 @@ SPI::transfer(uint8_t *send, uint8_t *recv, unsigned len)
 	return PX4_OK;
 }
 
+int
+SPI::transferAsync(uint8_t *send, uint8_t *recv, unsigned len, px4::WorkItem *work_item)
+{
+	if (((send == nullptr) && (recv == nullptr)) || (work_item == nullptr)) {
+		return -EINVAL;
+	}
+
+	_async_transfer_result = transfer(send, recv, len);
+
+	work_item->ScheduleNow();
+
+	return PX4_OK;
+}
+
 int
 SPI::transferhword(uint16_t *send, uint16_t *recv, unsigned len)
 {
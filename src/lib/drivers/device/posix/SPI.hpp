@@ -42,6 +42,8 @@
 
 #include "../CDev.hpp"
 
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
 #ifdef __PX4_LINUX
 
 #include <fcntl.h>
@@ -95,6 +97,14 @@ protected:
 		LOCK_NONE		/**< perform no locking, only safe if the bus is entirely private */
 	};
 
+	/**
+	 * Order of the asynchronous transfers of the devices on a bus.
+	 */
+	enum TransferPriority : uint8_t {
+		PRIORITY_LOW = 0,	/**< the default, polled devices */
+		PRIORITY_HIGH = 1	/**< data ready driven devices with a deadline (IMU FIFO reads) */
+	};
+
 	virtual int	init() override;
 
 	/**
@@ -123,6 +133,28 @@ protected:
 	 */
 	int		transfer(uint8_t *send, uint8_t *recv, unsigned len);
 
+	/**
+	 * Perform a SPI transfer and schedule work_item afterwards.
+	 *
+	 * Same interface as the asynchronous transfer on NuttX, but the transfer is done
+	 * immediately.
+	 *
+	 * @param send		Bytes to send to the device, or nullptr if
+	 *			no data is to be sent.
+	 * @param recv		Buffer for receiving bytes from the device,
+	 *			or nullptr if no bytes are to be received.
+	 * @param len		Number of bytes to transfer.
+	 * @param work_item	WorkItem scheduled on completion.
+	 * @return		OK if the transfer was done, -errno otherwise.
+	 */
+	int		transferAsync(uint8_t *send, uint8_t *recv, unsigned len, px4::WorkItem *work_item);
+
+	bool		transferAsyncPending() const { return false; }
+
+	int		transferAsyncResult() const { return _async_transfer_result; }
+
+	void		set_transfer_priority(TransferPriority priority) {}
+
 	/**
 	 * Perform a SPI 16 bit transfer.
 	 *
@@ -174,6 +206,8 @@ private:
 
 	LockMode		_locking_mode{LOCK_THREADS};	/**< selected locking mode */
 
+	int			_async_transfer_result{PX4_OK};
+
 protected:
 	int	_transfer(uint8_t *send, uint8_t *recv, unsigned len);
 
@@ -35,6 +35,8 @@
 #include "PX4Gyroscope.hpp"
 
 #include <lib/drivers/device/Device.hpp>
+#include <lib/mathlib/mathlib.h>
+#include <lib/parameters/param.h>
 
 using namespace time_literals;
 using matrix::Vector3f;
@@ -74,6 +76,13 @@ PX4Gyroscope::PX4Gyroscope(uint32_t device_id, uint8_t priority, enum Rotation r
 	_rotation_dcm{get_rot_matrix(rotation)}
 {
 	_class_device_instance = register_class_devname(GYRO_BASE_DEVICE_PATH);
+
+	// integrate over the IMU period of the estimators
+	int32_t imu_integ_rate = 250;
+	param_get(param_find("IMU_INTEG_RATE"), &imu_integ_rate);
+	_integration_interval = 1000000 / math::constrain(imu_integ_rate, (int32_t)100, (int32_t)1000);
+	_integrator.set_autoreset_interval(_integration_interval);
+	set_update_rate(_update_rate);
 }
 
 PX4Gyroscope::~PX4Gyroscope()
@@ -119,8 +128,10 @@ void PX4Gyroscope::set_device_type(uint8_t devtype)
 
 void PX4Gyroscope::set_update_rate(uint16_t rate)
 {
+	_update_rate = rate;
+
 	const uint32_t update_interval = 1000000 / rate;
-	_integrator_reset_samples = 4000 / update_interval;
+	_integrator_reset_samples = math::max(_integration_interval / update_interval, (uint32_t)1);
 }
 
 void PX4Gyroscope::update(hrt_abstime timestamp_sample, float x, float y, float z)
@@ -241,31 +252,21 @@ void PX4Gyroscope::updateFIFO(const FIFOSample &sample)
 			ResetIntegrator();
 		}
 
-		// integrate
-		_integrator_samples += 1;
-		_integrator_fifo_samples += N;
-
-		// trapezoidal integration (equally spaced, scaled by dt later)
-		_integration_raw(0) += (0.5f * (_last_sample[0] + sample.x[N - 1]) + sum(sample.x, N - 1));
-		_integration_raw(1) += (0.5f * (_last_sample[1] + sample.y[N - 1]) + sum(sample.y, N - 1));
-		_integration_raw(2) += (0.5f * (_last_sample[2] + sample.z[N - 1]) + sum(sample.z, N - 1));
-		_last_sample[0] = sample.x[N - 1];
-		_last_sample[1] = sample.y[N - 1];
-		_last_sample[2] = sample.z[N - 1];
-
+		// calibration offset in the sensor frame (raw units)
+		const Vector3f offset_raw{_rotation_dcm.transpose() * _calibration_offset / _scale};
 
-		if (_integrator_fifo_samples > 0 && (_integrator_samples >= _integrator_reset_samples)) {
+		// integrate (equally spaced, scaled by dt later)
+		_integrator_samples += 1;
+		_integrator_fifo.put(sample.x, sample.y, sample.z, N, offset_raw);
 
-			// Apply rotation and scale
-			// integrated in microseconds, convert to seconds
-			const Vector3f delta_angle_uncalibrated{_rotation_dcm *_integration_raw * _scale};
+		if (_integrator_fifo.samples() > 0 && (_integrator_samples >= _integrator_reset_samples)) {
 
-			// scale calibration offset to number of samples
-			const Vector3f offset{_calibration_offset * _integrator_fifo_samples};
+			// Apply rotation and scale (dt in microseconds, convert to seconds)
+			const float scale = _scale * 1e-6f * dt;
+			Vector3f delta_angle{_rotation_dcm * _integrator_fifo.integral() * scale};
 
-			// Apply calibration and scale to seconds
-			Vector3f delta_angle{delta_angle_uncalibrated - offset};
-			delta_angle *= 1e-6f * dt;
+			// the coning corrections are cross products of the integral, they scale quadratically
+			delta_angle += _rotation_dcm * _integrator_fifo.coning_corrections() * (scale * scale);
 
 			// fill sensor_gyro_integrated and publish
 			sensor_gyro_integrated_s report{};
@@ -274,8 +275,8 @@ void PX4Gyroscope::updateFIFO(const FIFOSample &sample)
 			report.error_count = _error_count;
 			report.device_id = _device_id;
 			delta_angle.copyTo(report.delta_angle);
-			report.dt = _integrator_fifo_samples * dt; // time span in microseconds
-			report.samples = _integrator_fifo_samples;
+			report.dt = _integrator_fifo.samples() * dt; // time span in microseconds
+			report.samples = _integrator_fifo.samples();
 			report.clip_count = _integrator_clipping;
 
 			report.timestamp = hrt_absolute_time();
@@ -298,6 +299,8 @@ void PX4Gyroscope::updateFIFO(const FIFOSample &sample)
 	fifo.timestamp_sample = sample.timestamp_sample;
 	fifo.dt = dt;
 	fifo.scale = _scale;
+	fifo.rotation = _rotation;
+	_calibration_offset.copyTo(fifo.calibration_offset);
 	fifo.samples = N;
 
 	memcpy(fifo.x, sample.x, sizeof(sample.x[0]) * N);
@@ -338,8 +341,7 @@ void PX4Gyroscope::PublishStatus()
 void PX4Gyroscope::ResetIntegrator()
 {
 	_integrator_samples = 0;
-	_integrator_fifo_samples = 0;
-	_integration_raw.zero();
+	_integrator_fifo.reset();
 	_integrator_clipping = 0;
 
 	_timestamp_sample_prev = 0;
@@ -123,11 +123,10 @@ private:
 
 	// integrator
 	hrt_abstime		_timestamp_sample_prev{0};
-	matrix::Vector3f	_integration_raw{};
-	int16_t			_last_sample[3] {};
+	IntegratorFIFO		_integrator_fifo{true};
+	uint32_t		_integration_interval{4000};	///< IMU_INTEG_RATE [us]
 	uint8_t			_integrator_reset_samples{4};
 	uint8_t			_integrator_samples{0};
-	uint8_t			_integrator_fifo_samples{0};
 	uint8_t			_integrator_clipping{0};
 
 };
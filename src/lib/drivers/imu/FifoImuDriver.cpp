@@ -0,0 +1,268 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "FifoImuDriver.hpp"
+
+#include <px4_platform_common/px4_config.h>
+
+FifoImuDriver::FifoImuDriver(const char *name, int bus, uint32_t device, enum spi_mode_e mode, uint32_t frequency) :
+	SPI(name, nullptr, bus, device, mode, frequency),
+	ScheduledWorkItem(name, px4::device_bus_to_wq(get_device_id()))
+{
+	// the FIFO reads (data ready driven) go first on a shared bus
+	set_transfer_priority(PRIORITY_HIGH);
+}
+
+FifoImuDriver::~FifoImuDriver()
+{
+	perf_free(_interval_perf);
+	perf_free(_transfer_perf);
+	perf_free(_bad_transfer_perf);
+	perf_free(_fifo_empty_perf);
+	perf_free(_fifo_overflow_perf);
+	perf_free(_fifo_reset_perf);
+	perf_free(_drdy_count_perf);
+	perf_free(_drdy_interval_perf);
+}
+
+void FifoImuDriver::ConfigureFIFO(uint32_t fifo_interval, int watermark, int samples_max, int samples_multiple)
+{
+	_fifo_interval = fifo_interval;
+	_drdy_watermark = math::max(watermark, 1);
+	_samples_multiple = math::max(samples_multiple, 1);
+	_samples_max = math::max(samples_max, _samples_multiple);
+}
+
+void FifoImuDriver::ConfigureTimestampModel()
+{
+	// the data ready capture times only jitter by the interrupt latency, the FIFO level reads by the
+	//  scheduling and bus latency
+	_timestamp_model.configure((float)_fifo_interval / _drdy_watermark, _data_ready_interrupt ? 0.05f : 0.01f);
+}
+
+void FifoImuDriver::FIFOReset()
+{
+	perf_count(_fifo_reset_perf);
+
+	const irqstate_t flags = px4_enter_critical_section();
+	_data_ready_count = 0;
+	_data_ready_samples = 0;
+	px4_leave_critical_section(flags);
+
+	_data_ready_samples_last = 0;
+	_samples_read = 0;
+	_timestamp_model.reset();
+
+	ResetFIFO();
+}
+
+int FifoImuDriver::DataReadyInterruptCallback(int irq, void *context, void *arg)
+{
+	FifoImuDriver *dev = reinterpret_cast<FifoImuDriver *>(arg);
+	dev->DataReady();
+	return 0;
+}
+
+void FifoImuDriver::DataReady()
+{
+	// capture time of the newest sample in the FIFO
+	_time_data_ready = hrt_absolute_time();
+	_data_ready_samples++;
+
+	perf_count(_drdy_count_perf);
+	perf_count(_drdy_interval_perf);
+
+	_data_ready_count++;
+
+	if (_data_ready_count >= _drdy_watermark) {
+		_data_ready_count = 0;
+
+		// make another measurement
+		ScheduleNow();
+	}
+}
+
+void FifoImuDriver::Start()
+{
+	Stop();
+
+#if defined(__PX4_NUTTX)
+	_data_ready_interrupt = (_drdy_gpio != 0);
+#endif // __PX4_NUTTX
+
+	ConfigureTimestampModel();
+
+	FIFOReset();
+
+#if defined(__PX4_NUTTX)
+
+	if (_data_ready_interrupt) {
+		// Setup data ready on rising edge
+		px4_arch_gpiosetevent(_drdy_gpio, true, false, true, &FifoImuDriver::DataReadyInterruptCallback, this);
+		DataReadyInterruptEnable(true);
+		return;
+	}
+
+#endif // __PX4_NUTTX
+
+	ScheduleOnInterval(_fifo_interval, _fifo_interval);
+}
+
+void FifoImuDriver::Stop()
+{
+#if defined(__PX4_NUTTX)
+
+	if (_data_ready_interrupt) {
+		// Disable data ready callback
+		px4_arch_gpiosetevent(_drdy_gpio, false, false, false, nullptr, nullptr);
+		DataReadyInterruptEnable(false);
+	}
+
+	_data_ready_interrupt = false;
+
+#endif // __PX4_NUTTX
+
+	ScheduleClear();
+
+	// the FIFO read might still be in progress
+	while (transferAsyncPending()) {
+		px4_usleep(100);
+	}
+}
+
+void FifoImuDriver::Run()
+{
+	if (_fifo_read_pending) {
+		// scheduled by the data ready interrupt while the FIFO read is still in progress
+		if (transferAsyncPending()) {
+			return;
+		}
+
+		_fifo_read_pending = false;
+		perf_end(_transfer_perf);
+
+		if (transferAsyncResult() == PX4_OK) {
+			_samples_read += _fifo_read_samples;
+			FIFOProcess(_fifo_read_timestamp_sample, _fifo_read_samples);
+
+		} else {
+			// unknown how much of the FIFO was read, resynchronize the sample count
+			perf_count(_bad_transfer_perf);
+			FIFOReset();
+		}
+
+		return;
+	}
+
+	perf_count(_interval_perf);
+
+	// latest data ready capture
+	const irqstate_t flags = px4_enter_critical_section();
+	const hrt_abstime time_data_ready = _time_data_ready;
+	const uint32_t data_ready_samples = _data_ready_samples;
+	px4_leave_critical_section(flags);
+
+	const hrt_abstime time_fifo_count = hrt_absolute_time();
+
+	const int fifo_samples = FIFOReadCount();
+
+	if (fifo_samples == -EOVERFLOW) {
+		perf_count(_fifo_overflow_perf);
+		FIFOReset();
+		return;
+
+	} else if (fifo_samples < 0) {
+		perf_count(_bad_transfer_perf);
+		return;
+	}
+
+	// fit the sample clock
+	if (_data_ready_interrupt) {
+		if ((data_ready_samples != _data_ready_samples_last) && (data_ready_samples > _samples_read)) {
+			_timestamp_model.update(time_data_ready, data_ready_samples);
+			_data_ready_samples_last = data_ready_samples;
+		}
+
+	} else if (fifo_samples > 0) {
+		// the newest sample in the FIFO was sampled shortly before the FIFO level read
+		_timestamp_model.update(time_fifo_count, _samples_read + fifo_samples);
+	}
+
+	const int samples = (fifo_samples / _samples_multiple) * _samples_multiple;
+
+	if (samples <= 0) {
+		perf_count(_fifo_empty_perf);
+		return;
+
+	} else if (samples > _samples_max) {
+		// not technically an overflow, but more samples than we expected
+		perf_count(_fifo_overflow_perf);
+		FIFOReset();
+		return;
+	}
+
+	// timestamp of the newest sample we'll pull from the FIFO
+	const hrt_abstime timestamp_sample = _timestamp_model.valid() ? _timestamp_model.timestamp(_samples_read + samples) :
+					     time_fifo_count;
+
+	size_t transfer_size = 0;
+	uint8_t *buffer = FIFOTransferBuffer(samples, transfer_size);
+
+	// Transfer data, the bus transfer work queue waits for the DMA and schedules us again on completion
+	perf_begin(_transfer_perf);
+
+	if (transferAsync(buffer, buffer, transfer_size, this) != PX4_OK) {
+		perf_end(_transfer_perf);
+		perf_count(_bad_transfer_perf);
+		return;
+	}
+
+	_fifo_read_pending = true;
+	_fifo_read_timestamp_sample = timestamp_sample;
+	_fifo_read_samples = samples;
+}
+
+void FifoImuDriver::PrintInfo()
+{
+	perf_print_counter(_interval_perf);
+	perf_print_counter(_transfer_perf);
+	perf_print_counter(_bad_transfer_perf);
+	perf_print_counter(_fifo_empty_perf);
+	perf_print_counter(_fifo_overflow_perf);
+	perf_print_counter(_fifo_reset_perf);
+	perf_print_counter(_drdy_count_perf);
+	perf_print_counter(_drdy_interval_perf);
+
+	PX4_INFO("sample interval: %.3f us (drift %.0f ppm, %u outliers)", (double)_timestamp_model.interval(),
+		 (double)_timestamp_model.drift_ppm(), _timestamp_model.outliers());
+}
@@ -0,0 +1,172 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file FifoImuDriver.hpp
+ *
+ * Common scheduling of the SPI IMU drivers reading the sensor FIFO.
+ */
+
+#pragma once
+
+#include "FifoTimestampModel.hpp"
+
+#include <drivers/drv_hrt.h>
+#include <lib/drivers/device/spi.h>
+#include <lib/mathlib/mathlib.h>
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+
+/**
+ * Base of the SPI IMU drivers reading the sensor FIFO.
+ *
+ * Handles the scheduling (data ready interrupts counted up to the FIFO watermark, or a fixed
+ * interval if the board has no data ready line), the FIFO level check with overflow handling,
+ * the asynchronous burst read sized to the FIFO level and the sample timestamps. The timestamps
+ * come from a model of the sensor sample clock (FifoTimestampModel), fitted to the data ready
+ * capture times (or the FIFO level read times) and the sample counts.
+ * The driver implements the register level hooks and publishes the samples in FIFOProcess()
+ * (PX4Gyroscope::updateFIFO() and PX4Accelerometer::updateFIFO()).
+ */
+class FifoImuDriver : public device::SPI, public px4::ScheduledWorkItem
+{
+public:
+	FifoImuDriver(const char *name, int bus, uint32_t device, enum spi_mode_e mode, uint32_t frequency);
+	~FifoImuDriver() override;
+
+	void Start();
+	void Stop();
+
+	void PrintInfo();
+
+protected:
+	/**
+	 * Configure the FIFO reads, before Start().
+	 *
+	 * @param fifo_interval		nominal interval of the FIFO reads [us]
+	 * @param watermark		number of data ready interrupts per FIFO read
+	 * @param samples_max		maximum number of samples per read (size of the transfer buffer)
+	 * @param samples_multiple	only read a multiple of this number of samples,
+	 *				e.g. 2 if the accel runs at half the gyro rate
+	 */
+	void ConfigureFIFO(uint32_t fifo_interval, int watermark, int samples_max, int samples_multiple = 1);
+
+	/**
+	 * Set the data ready GPIO of the board (0: none, the FIFO is read on the fixed interval).
+	 */
+	void SetDataReadyGPIO(uint32_t gpio) { _drdy_gpio = gpio; }
+
+	/**
+	 * Reset and re-enable the sensor FIFO.
+	 */
+	void FIFOReset();
+
+	/**
+	 * @return estimated interval of the FIFO samples [us], including the sensor clock drift
+	 */
+	float SampleInterval() const { return _timestamp_model.interval(); }
+
+	/**
+	 * Sensor FIFO reset and configuration (register level).
+	 */
+	virtual void ResetFIFO() = 0;
+
+	/**
+	 * Enable or disable the data ready interrupt output of the sensor.
+	 */
+	virtual void DataReadyInterruptEnable(bool enable) = 0;
+
+	/**
+	 * Read the FIFO level and status.
+	 *
+	 * @return number of samples in the FIFO, -EOVERFLOW if the FIFO overflowed, -errno on a transfer error
+	 */
+	virtual int FIFOReadCount() = 0;
+
+	/**
+	 * Prepare the (DMA capable) buffer of a FIFO burst read.
+	 *
+	 * @param samples		number of samples to read
+	 * @param transfer_size		[out] size of the full transfer, including the command
+	 * @return the transfer buffer, which must stay valid until FIFOProcess()
+	 */
+	virtual uint8_t *FIFOTransferBuffer(int samples, size_t &transfer_size) = 0;
+
+	/**
+	 * Publish the samples of a completed FIFO read.
+	 *
+	 * @param timestamp_sample	time of the newest sample
+	 * @param samples		number of samples read
+	 */
+	virtual void FIFOProcess(const hrt_abstime &timestamp_sample, int samples) = 0;
+
+private:
+	static int DataReadyInterruptCallback(int irq, void *context, void *arg);
+	void DataReady();
+
+	void ConfigureTimestampModel();
+
+	void Run() override;
+
+	uint32_t _fifo_interval{1000};
+	int _drdy_watermark{1};
+	int _samples_max{1};
+	int _samples_multiple{1};
+
+	uint32_t _drdy_gpio{0};
+	bool _data_ready_interrupt{false};
+
+	// updated by the data ready interrupt
+	hrt_abstime _time_data_ready{0};
+	uint32_t _data_ready_samples{0};	// samples since the FIFO reset
+	int _data_ready_count{0};
+
+	uint32_t _data_ready_samples_last{0};	// last capture used by the timestamp model
+	uint32_t _samples_read{0};		// samples read out of the FIFO since the reset
+
+	FifoTimestampModel _timestamp_model{};
+
+	// asynchronous FIFO read in progress
+	bool _fifo_read_pending{false};
+	hrt_abstime _fifo_read_timestamp_sample{0};
+	int _fifo_read_samples{0};
+
+	perf_counter_t _interval_perf{perf_alloc(PC_INTERVAL, "imu_fifo: run interval")};
+	perf_counter_t _transfer_perf{perf_alloc(PC_ELAPSED, "imu_fifo: transfer")};
+	perf_counter_t _bad_transfer_perf{perf_alloc(PC_COUNT, "imu_fifo: bad transfer")};
+	perf_counter_t _fifo_empty_perf{perf_alloc(PC_COUNT, "imu_fifo: fifo empty")};
+	perf_counter_t _fifo_overflow_perf{perf_alloc(PC_COUNT, "imu_fifo: fifo overflow")};
+	perf_counter_t _fifo_reset_perf{perf_alloc(PC_COUNT, "imu_fifo: fifo reset")};
+	perf_counter_t _drdy_count_perf{perf_alloc(PC_COUNT, "imu_fifo: drdy count")};
+	perf_counter_t _drdy_interval_perf{perf_alloc(PC_INTERVAL, "imu_fifo: drdy interval")};
+};
@@ -0,0 +1,182 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file FifoTimestampModel.hpp
+ *
+ * Sample clock model of an IMU FIFO.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <lib/mathlib/mathlib.h>
+
+/**
+ * Maps the index of a FIFO sample (counted since the FIFO reset) to its timestamp.
+ *
+ * The sample clock of the sensor is modelled as t(n) = t_ref + (n - n_ref) * interval. Each
+ * measurement is a capture time of a known sample index: the data ready interrupt time of the
+ * newest sample or, without interrupt, the time of a FIFO level read. The model is corrected with
+ * an alpha-beta filter, so the interval converges to the actual sample clock of the sensor
+ * (drift of the internal oscillator against hrt), while the capture jitter (interrupt latency,
+ * bus contention) is filtered out of the timestamps. The capture latency is never negative, so
+ * captures earlier than predicted are weighted higher and single late outliers are ignored.
+ */
+class FifoTimestampModel
+{
+public:
+	FifoTimestampModel() = default;
+	~FifoTimestampModel() = default;
+
+	/**
+	 * @param interval	nominal sample interval [us]
+	 * @param gain		phase correction gain, lower for noisier capture times
+	 */
+	void configure(float interval, float gain)
+	{
+		_interval_nominal = interval;
+		_interval = interval;
+		_alpha = math::constrain(gain, 0.001f, 1.f);
+		// well damped second order loop
+		_beta = _alpha * _alpha / 8.f;
+		_valid = false;
+		_outliers_consecutive = 0;
+	}
+
+	/**
+	 * Restart the sample count (FIFO reset), the estimated interval is kept.
+	 */
+	void reset()
+	{
+		_valid = false;
+		_outliers_consecutive = 0;
+	}
+
+	/**
+	 * Add a capture time of a sample.
+	 *
+	 * @param time		capture time of the sample
+	 * @param index		sample index
+	 */
+	void update(const hrt_abstime &time, uint32_t index)
+	{
+		if (!_valid || (index <= _index_ref)) {
+			restart(time, index);
+			_valid = true;
+			return;
+		}
+
+		const uint32_t samples = index - _index_ref;
+
+		// prediction relative to _time_ref, keeping the fraction of a microsecond
+		const float offset = _time_ref_frac + samples * _interval;
+		const float error = (float)((int64_t)(time - _time_ref)) - offset;
+
+		if (fabsf(error) > math::max(OUTLIER_INTERVALS * _interval, (float)OUTLIER_MIN)) {
+			_outliers++;
+
+			if (++_outliers_consecutive >= OUTLIER_RESTART) {
+				// lost samples or a clock jump, restart from this capture
+				restart(time, index);
+			}
+
+			return;
+		}
+
+		_outliers_consecutive = 0;
+
+		// early captures are the closest to the actual sample time, phase and interval use the same
+		//  weighting so that the interval stays unbiased
+		const float weight = (error < 0.f) ? math::min(EARLY_GAIN, 1.f / _alpha) : 1.f;
+		const float alpha = weight * _alpha;
+
+		const float offset_corrected = offset + alpha * error;
+		const float offset_us = floorf(offset_corrected);
+		_time_ref += (int64_t)offset_us;
+		_time_ref_frac = offset_corrected - offset_us;
+		_index_ref = index;
+
+		_interval = math::constrain(_interval + weight * _beta * error / samples,
+					    _interval_nominal * (1.f - INTERVAL_TOLERANCE), _interval_nominal * (1.f + INTERVAL_TOLERANCE));
+	}
+
+	/**
+	 * @return timestamp of a sample, only valid once the model got a capture
+	 */
+	hrt_abstime timestamp(uint32_t index) const
+	{
+		const float offset = _time_ref_frac + ((int64_t)index - (int64_t)_index_ref) * _interval;
+		return _time_ref + (int64_t)roundf(offset);
+	}
+
+	bool valid() const { return _valid; }
+
+	/** @return estimated sample interval [us] */
+	float interval() const { return _interval; }
+
+	/** @return estimated clock drift of the sensor relative to the nominal interval [ppm] */
+	float drift_ppm() const { return (_interval / _interval_nominal - 1.f) * 1e6f; }
+
+	uint32_t outliers() const { return _outliers; }
+
+private:
+	void restart(const hrt_abstime &time, uint32_t index)
+	{
+		_time_ref = time;
+		_time_ref_frac = 0.f;
+		_index_ref = index;
+		_outliers_consecutive = 0;
+	}
+
+	static constexpr float INTERVAL_TOLERANCE{0.05f};	// +-5% oscillator tolerance
+	static constexpr float OUTLIER_INTERVALS{8.f};
+	static constexpr uint32_t OUTLIER_MIN{500};		// [us]
+	static constexpr uint8_t OUTLIER_RESTART{3};		// consecutive outliers
+	static constexpr float EARLY_GAIN{4.f};
+
+	hrt_abstime _time_ref{0};
+	float _time_ref_frac{0.f};		// [us] fraction of _time_ref, in [0, 1)
+	uint32_t _index_ref{0};
+
+	float _interval_nominal{1000.f};
+	float _interval{1000.f};
+
+	float _alpha{0.1f};
+	float _beta{0.0025f};
+
+	uint32_t _outliers{0};
+	uint8_t _outliers_consecutive{0};
+
+	bool _valid{false};
+};
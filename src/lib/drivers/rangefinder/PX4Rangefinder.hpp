@@ -68,6 +68,8 @@ public:
 
 	void update(const hrt_abstime timestamp, const float distance, const int8_t quality = -1);
 
+	const distance_sensor_s &get() { return _distance_sensor_pub.get(); }
+
 private:
 
 	uORB::PublicationMultiData<distance_sensor_s> _distance_sensor_pub;
@@ -0,0 +1,233 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "RangefinderArray.hpp"
+
+#include <float.h>
+#include <math.h>
+
+#include <lib/mathlib/mathlib.h>
+#include <lib/matrix/matrix/math.hpp>
+
+RangefinderArray *RangefinderArray::_arrays[MAX_ARRAYS] {};
+pthread_mutex_t RangefinderArray::_arrays_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+RangefinderArray::RangefinderArray(const px4::wq_config_t &config, uint32_t conversion_time) :
+	ScheduledWorkItem("rangefinder_array", config),
+	_config(config),
+	_conversion_time(conversion_time)
+{
+	pthread_mutex_init(&_mutex, nullptr);
+}
+
+RangefinderArray::~RangefinderArray()
+{
+	ScheduleClear();
+	pthread_mutex_destroy(&_mutex);
+	perf_free(_cycle_perf);
+}
+
+int
+RangefinderArray::add(RangefinderArrayMember *member, const px4::wq_config_t &config)
+{
+	pthread_mutex_lock(&_arrays_mutex);
+
+	// members with the same conversion time on the same bus share a cycle
+	RangefinderArray *array = nullptr;
+	int free_index = -1;
+
+	for (int i = 0; i < MAX_ARRAYS; i++) {
+		if (_arrays[i] == nullptr) {
+			if (free_index < 0) {
+				free_index = i;
+			}
+
+		} else if (&_arrays[i]->_config == &config && _arrays[i]->_conversion_time == member->conversion_time()) {
+			array = _arrays[i];
+			break;
+		}
+	}
+
+	if (array == nullptr && free_index >= 0) {
+		array = new RangefinderArray(config, member->conversion_time());
+		_arrays[free_index] = array;
+	}
+
+	int ret = PX4_ERROR;
+
+	if (array != nullptr) {
+		pthread_mutex_lock(&array->_mutex);
+
+		if (array->_num_members < MAX_MEMBERS) {
+			array->_members[array->_num_members++] = member;
+			ret = PX4_OK;
+
+			if (array->_num_members == 1) {
+				array->_collect_phase = false;
+				array->ScheduleNow();
+			}
+		}
+
+		pthread_mutex_unlock(&array->_mutex);
+	}
+
+	pthread_mutex_unlock(&_arrays_mutex);
+
+	return ret;
+}
+
+void
+RangefinderArray::remove(RangefinderArrayMember *member)
+{
+	pthread_mutex_lock(&_arrays_mutex);
+
+	for (int i = 0; i < MAX_ARRAYS; i++) {
+		RangefinderArray *array = _arrays[i];
+
+		if (array == nullptr) {
+			continue;
+		}
+
+		pthread_mutex_lock(&array->_mutex);
+
+		for (int j = 0; j < array->_num_members; j++) {
+			if (array->_members[j] == member) {
+				array->_members[j] = array->_members[--array->_num_members];
+				array->_members[array->_num_members] = nullptr;
+				break;
+			}
+		}
+
+		const bool empty = (array->_num_members == 0);
+		pthread_mutex_unlock(&array->_mutex);
+
+		if (empty) {
+			delete array;
+			_arrays[i] = nullptr;
+		}
+	}
+
+	pthread_mutex_unlock(&_arrays_mutex);
+}
+
+bool
+RangefinderArray::merge(const distance_sensor_s &sample, obstacle_distance_s &obstacle)
+{
+	float yaw_deg = 0.f;
+
+	if (sample.orientation <= distance_sensor_s::ROTATION_YAW_315) {
+		yaw_deg = sample.orientation * 45.f;
+
+	} else if (sample.orientation == distance_sensor_s::ROTATION_CUSTOM) {
+		yaw_deg = math::degrees(matrix::Eulerf(matrix::Quatf(sample.q)).psi());
+
+	} else {
+		// upward and downward facing
+		return false;
+	}
+
+	if (sample.current_distance < sample.min_distance) {
+		return false;
+	}
+
+	// beyond the maximum distance: no obstacle up to the range of this sensor
+	const float distance = math::min(sample.current_distance, sample.max_distance + 0.01f);
+	const uint16_t distance_cm = static_cast<uint16_t>(distance * 100.f + 0.5f);
+
+	const float half_fov_deg = math::degrees(sample.h_fov) / 2.f;
+	const int first_bin = static_cast<int>(ceilf((yaw_deg - half_fov_deg) / obstacle.increment));
+	const int last_bin = math::max(static_cast<int>(floorf((yaw_deg + half_fov_deg) / obstacle.increment)), first_bin);
+
+	for (int bin = first_bin; bin <= last_bin; bin++) {
+		const int i = (bin % OBSTACLE_BINS + OBSTACLE_BINS) % OBSTACLE_BINS;
+
+		if (obstacle.distances[i] == UINT16_MAX || distance_cm < obstacle.distances[i]) {
+			obstacle.distances[i] = distance_cm;
+		}
+	}
+
+	obstacle.sensor_type = sample.type;
+	obstacle.min_distance = math::min(obstacle.min_distance, static_cast<uint16_t>(sample.min_distance * 100.f));
+	obstacle.max_distance = math::max(obstacle.max_distance, static_cast<uint16_t>(sample.max_distance * 100.f));
+
+	return true;
+}
+
+void
+RangefinderArray::Run()
+{
+	pthread_mutex_lock(&_mutex);
+	perf_begin(_cycle_perf);
+
+	if (_collect_phase) {
+		obstacle_distance_s obstacle{};
+		obstacle.frame = obstacle_distance_s::MAV_FRAME_BODY_FRD;
+		obstacle.increment = 360.f / OBSTACLE_BINS;
+		obstacle.min_distance = UINT16_MAX;
+
+		for (int i = 0; i < OBSTACLE_BINS; i++) {
+			obstacle.distances[i] = UINT16_MAX;
+		}
+
+		bool merged = false;
+
+		for (int i = 0; i < _num_members; i++) {
+			// a failed read keeps the previous sample, which is not merged
+			if (_members[i]->collect() == PX4_OK && _members[i]->sample().timestamp >= _measure_timestamp) {
+				merged |= merge(_members[i]->sample(), obstacle);
+			}
+		}
+
+		if (merged) {
+			obstacle.timestamp = hrt_absolute_time();
+			_obstacle_distance_pub.publish(obstacle);
+		}
+	}
+
+	// trigger all the members, then wait once for their results
+	_measure_timestamp = hrt_absolute_time();
+
+	for (int i = 0; i < _num_members; i++) {
+		_members[i]->measure();
+	}
+
+	_collect_phase = true;
+
+	if (_num_members > 0) {
+		ScheduleDelayed(_conversion_time);
+	}
+
+	perf_end(_cycle_perf);
+	pthread_mutex_unlock(&_mutex);
+}
@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file RangefinderArray.hpp
+ *
+ * Shared measurement cycle of the rangefinders on one bus.
+ *
+ * Instead of each driver scheduling its own trigger and read, all the members with the same
+ * conversion time on a bus are triggered at once, read in sequence after a single wait and
+ * the horizontally facing ones are merged into one obstacle_distance_rangefinder publication
+ * (body frame), which collision prevention uses for arrays of more sensors than distance_sensor
+ * instances.
+ *
+ * Members are triggered simultaneously: ultrasonic sensors should face different directions
+ * to avoid crosstalk.
+ */
+
+#pragma once
+
+#include <pthread.h>
+
+#include <drivers/drv_hrt.h>
+#include <drivers/drv_range_finder.h>
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <uORB/PublicationMulti.hpp>
+#include <uORB/topics/distance_sensor.h>
+#include <uORB/topics/obstacle_distance.h>
+
+class RangefinderArrayMember
+{
+public:
+	virtual ~RangefinderArrayMember() = default;
+
+	/**
+	 * Start a measurement.
+	 */
+	virtual int measure() = 0;
+
+	/**
+	 * Read the result of the last measurement and publish it.
+	 */
+	virtual int collect() = 0;
+
+	/**
+	 * Time from measure() until the result can be collected [us].
+	 */
+	virtual uint32_t conversion_time() const = 0;
+
+	/**
+	 * Last published sample, merged into the obstacle distances of the array.
+	 */
+	virtual const distance_sensor_s &sample() = 0;
+};
+
+class RangefinderArray : public px4::ScheduledWorkItem
+{
+public:
+	/**
+	 * Add a member to the array of its bus and start the cycle.
+	 * @param config work queue of the bus (px4::device_bus_to_wq())
+	 * @return PX4_OK or PX4_ERROR if the array is full
+	 */
+	static int add(RangefinderArrayMember *member, const px4::wq_config_t &config);
+
+	/**
+	 * Remove a member, the array is deleted with its last member.
+	 */
+	static void remove(RangefinderArrayMember *member);
+
+private:
+	static constexpr int MAX_ARRAYS = 4;
+	static constexpr int MAX_MEMBERS = RANGE_FINDER_MAX_SENSORS;
+	static constexpr int OBSTACLE_BINS = sizeof(obstacle_distance_s::distances) / sizeof(obstacle_distance_s::distances[0]);
+
+	RangefinderArray(const px4::wq_config_t &config, uint32_t conversion_time);
+	~RangefinderArray() override;
+
+	void Run() override;
+
+	/**
+	 * Add a sample to the obstacle distances.
+	 * @return true if the sample is horizontal and valid
+	 */
+	bool merge(const distance_sensor_s &sample, obstacle_distance_s &obstacle);
+
+	static RangefinderArray *_arrays[MAX_ARRAYS];
+	static pthread_mutex_t _arrays_mutex;
+
+	const px4::wq_config_t &_config;
+	const uint32_t _conversion_time;
+
+	pthread_mutex_t _mutex;	///< protects the members against add/remove during a cycle
+	RangefinderArrayMember *_members[MAX_MEMBERS] {};
+	int _num_members{0};
+
+	bool _collect_phase{false};
+	hrt_abstime _measure_timestamp{0};
+
+	uORB::PublicationMulti<obstacle_distance_s> _obstacle_distance_pub{ORB_ID(obstacle_distance_rangefinder)};
+
+	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, "rangefinder_array: cycle")};
+};
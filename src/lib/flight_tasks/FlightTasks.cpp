@@ -20,7 +20,7 @@ bool FlightTasks::update()
 	_updateCommand();
 
 	if (isAnyTaskActive()) {
-		return _current_task.task->updateInitialize() && _current_task.task->update() && _current_task.task->updateFinalize();
+		return _updateTask();
 	}
 
 	return false;
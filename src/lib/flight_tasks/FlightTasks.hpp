@@ -193,4 +193,10 @@ private:
 	uORB::PublicationQueued<vehicle_command_ack_s>	_pub_vehicle_command_ack{ORB_ID(vehicle_command_ack)};
 
 	int _initTask(FlightTaskIndex task_index);
+
+	/**
+	 * Run one update of the active task (generated, dispatches on the task index without virtual calls)
+	 * @return true on success, false on error
+	 */
+	bool _updateTask();
 };
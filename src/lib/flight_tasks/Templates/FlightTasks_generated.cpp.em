@@ -79,6 +79,29 @@ firstLowercase = lambda s: s[:1].lower() + s[1:] if s else ''
 	return 0;
 }
 
+bool FlightTasks::_updateTask()
+{
+	// the type of the active task is known from its index: call the task methods directly instead of
+	// through the virtual interface of FlightTask
+	switch (_current_task.index) {
+@[if tasks]@
+@[for task in tasks]@
+@{
+firstLowercase = lambda s: s[:1].lower() + s[1:] if s else ''
+}@
+	case FlightTaskIndex::@(task): {
+			FlightTask@(task) &task = _task_union.@(firstLowercase(task));
+			return task.FlightTask@(task)::updateInitialize() && task.FlightTask@(task)::update()
+			       && task.FlightTask@(task)::updateFinalize();
+		}
+
+@[end for]@
+@[end if]@
+	default:
+		return false;
+	}
+}
+
 FlightTaskIndex FlightTasks::switchVehicleCommand(const int command)
 {
     switch (command) {
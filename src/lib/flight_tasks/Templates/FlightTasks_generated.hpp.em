@@ -59,7 +59,14 @@ enum class FlightTaskIndex : int {
 @[end for]@
 @[end if]@
 
-    Count // number of tasks
+    Count, // number of tasks
+
+@# tasks removed from the build keep an index, switching to them fails
+@[if tasks_removed]@
+@[for task in tasks_removed]@
+    @(task),
+@[end for]@
+@[end if]@
 };
 
 union TaskUnion {
@@ -37,8 +37,6 @@
 
 #include "FlightTaskAutoLineSmoothVel.hpp"
 
-#include "TrajectoryConstraints.hpp"
-
 using namespace matrix;
 
 bool FlightTaskAutoLineSmoothVel::activate(vehicle_local_position_setpoint_s last_setpoint)
@@ -178,12 +176,8 @@ float FlightTaskAutoLineSmoothVel::_constrainAbs(float val, float max)
 	return math::sign(val) * math::min(fabsf(val), fabsf(max));
 }
 
-float FlightTaskAutoLineSmoothVel::_getMaxXYSpeed() const
+math::trajectory::VehicleDynamicLimits FlightTaskAutoLineSmoothVel::_getDynamicLimits() const
 {
-	Vector3f pos_traj(_trajectory[0].getCurrentPosition(),
-			  _trajectory[1].getCurrentPosition(),
-			  _trajectory[2].getCurrentPosition());
-
 	math::trajectory::VehicleDynamicLimits config;
 	config.z_accept_rad = _param_nav_mc_alt_rad.get();
 	config.xy_accept_rad = _target_acceptance_radius;
@@ -192,21 +186,37 @@ float FlightTaskAutoLineSmoothVel::_getMaxXYSpeed() const
 	config.max_speed_xy = _mc_cruise_speed;
 	config.max_acc_xy_radius_scale = _param_mpc_xy_traj_p.get();
 
+	return config;
+}
+
+void FlightTaskAutoLineSmoothVel::_updateLookahead()
+{
+	const math::trajectory::VehicleDynamicLimits config = _getDynamicLimits();
+
+	if (!math::trajectory::isLookaheadValid(_lookahead, _target, _next_wp, config)) {
+		_lookahead = math::trajectory::computeTargetLookahead(_target, _next_wp, config);
+	}
+}
+
+float FlightTaskAutoLineSmoothVel::_getMaxXYSpeed() const
+{
+	Vector3f pos_traj(_trajectory[0].getCurrentPosition(),
+			  _trajectory[1].getCurrentPosition(),
+			  _trajectory[2].getCurrentPosition());
+
 	// constrain velocity to go to the position setpoint first if the position setpoint has been modified by an external source
 	// (eg. Obstacle Avoidance)
 	bool xy_modified = (_target - _position_setpoint).xy().longerThan(FLT_EPSILON);
 	bool z_valid = PX4_ISFINITE(_position_setpoint(2));
 	bool z_modified =  z_valid && fabs((_target - _position_setpoint)(2)) > FLT_EPSILON;
 
-	Vector3f waypoints[3] = {pos_traj, _target, _next_wp};
-
 	if (xy_modified || z_modified) {
-		waypoints[2] = waypoints[1] = _position_setpoint;
+		Vector3f waypoints[3] = {pos_traj, _position_setpoint, _position_setpoint};
+		return math::trajectory::computeXYSpeedFromWaypoints<3>(waypoints, _getDynamicLimits());
 	}
 
-	float max_xy_speed = math::trajectory::computeXYSpeedFromWaypoints<3>(waypoints, config);
-
-	return max_xy_speed;
+	// target and next waypoint only change with the triplet, their part of the speed limit is cached
+	return math::trajectory::computeXYSpeedFromLookahead(pos_traj, _lookahead);
 }
 
 float FlightTaskAutoLineSmoothVel::_getMaxZSpeed() const
@@ -251,6 +261,10 @@ void FlightTaskAutoLineSmoothVel::_prepareSetpoints()
 		const bool xy_pos_setpoint_valid = PX4_ISFINITE(_position_setpoint(0)) && PX4_ISFINITE(_position_setpoint(1));
 		const bool z_pos_setpoint_valid = PX4_ISFINITE(_position_setpoint(2));
 
+		if (xy_pos_setpoint_valid) {
+			_updateLookahead();
+		}
+
 		if (xy_pos_setpoint_valid && z_pos_setpoint_valid) {
 			// Use 3D position setpoint to generate a 3D velocity setpoint
 			Vector3f pos_traj(_trajectory[0].getCurrentPosition(),
@@ -41,6 +41,7 @@
 #pragma once
 
 #include "FlightTaskAutoMapper.hpp"
+#include "TrajectoryConstraints.hpp"
 #include "VelocitySmoothing.hpp"
 
 class FlightTaskAutoLineSmoothVel : public FlightTaskAutoMapper
@@ -71,6 +72,8 @@ protected:
 
 	static float _constrainAbs(float val, float max); /** Constrain the value -max <= val <= max */
 
+	math::trajectory::VehicleDynamicLimits _getDynamicLimits() const;
+	void _updateLookahead(); /**< Recompute the waypoint dependent part of the XY speed limit if the waypoints or limits changed. */
 	float _getMaxXYSpeed() const;
 	float _getMaxZSpeed() const;
 
@@ -84,6 +87,8 @@ protected:
 
 	VelocitySmoothing _trajectory[3]; ///< Trajectories in x, y and z directions
 
+	math::trajectory::TargetLookahead _lookahead{}; ///< cached speed constraints of the target and the next waypoint
+
 	DEFINE_PARAMETERS_CUSTOM_PARENT(FlightTaskAutoMapper,
 					(ParamFloat<px4::params::MIS_YAW_ERR>) _param_mis_yaw_err, // yaw-error threshold
 					(ParamFloat<px4::params::MPC_ACC_HOR>) _param_mpc_acc_hor, // acceleration in flight
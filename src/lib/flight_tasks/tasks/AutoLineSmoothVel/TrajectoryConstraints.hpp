@@ -126,6 +126,83 @@ float computeXYSpeedFromWaypoints(const Vector3f waypoints[N], const VehicleDyna
 	return max_speed;
 }
 
+/*
+ * Part of computeXYSpeedFromWaypoints<3>() that only depends on the target and the next waypoint.
+ * It is computed once when the waypoints or the limits change (computeTargetLookahead()), the remaining
+ * evaluation from the current position in computeXYSpeedFromLookahead() is a few multiplications and square roots.
+ */
+struct TargetLookahead {
+	Vector3f target;
+	Vector3f next_target;
+	VehicleDynamicLimits config;
+
+	Vector2f u_next_to_target;	///< unit vector from the next waypoint to the target
+	float exit_speed;		///< maximum speed at the target to still stop at the next waypoint
+	bool turn_possible;		///< the vehicle can fly through the target into the next line
+};
+
+inline bool operator==(const VehicleDynamicLimits &a, const VehicleDynamicLimits &b)
+{
+	return a.z_accept_rad == b.z_accept_rad && a.xy_accept_rad == b.xy_accept_rad && a.max_acc_xy == b.max_acc_xy
+	       && a.max_jerk == b.max_jerk && a.max_speed_xy == b.max_speed_xy
+	       && a.max_acc_xy_radius_scale == b.max_acc_xy_radius_scale;
+}
+
+inline bool isLookaheadValid(const TargetLookahead &lookahead, const Vector3f &target, const Vector3f &next_target,
+			     const VehicleDynamicLimits &config)
+{
+	return lookahead.target == target && lookahead.next_target == next_target && lookahead.config == config;
+}
+
+inline TargetLookahead computeTargetLookahead(const Vector3f &target, const Vector3f &next_target,
+		const VehicleDynamicLimits &config)
+{
+	TargetLookahead lookahead{};
+	lookahead.target = target;
+	lookahead.next_target = next_target;
+	lookahead.config = config;
+
+	const float distance_target_next = (target - next_target).xy().norm();
+	lookahead.u_next_to_target = Vector2f((target - next_target).xy()).unit_or_zero();
+	lookahead.turn_possible = distance_target_next > 0.001f
+				  && distance_target_next >= config.xy_accept_rad
+				  && fabsf(next_target(2) - target(2)) < config.z_accept_rad;
+
+	// the vehicle stops at the next waypoint
+	lookahead.exit_speed = min(config.max_speed_xy, computeMaxSpeedFromDistance(config.max_jerk, config.max_acc_xy,
+				   distance_target_next, 0.f));
+
+	return lookahead;
+}
+
+/*
+ * Same result as computeXYSpeedFromWaypoints<3>({start_position, target, next_target}) with the lookahead of
+ * target and next_target. The turn speed uses tan(alpha / 2) = sqrt((1 - cos(alpha)) / (1 + cos(alpha))) instead of
+ * evaluating the angle.
+ */
+inline float computeXYSpeedFromLookahead(const Vector3f &start_position, const TargetLookahead &lookahead)
+{
+	const VehicleDynamicLimits &config = lookahead.config;
+	float speed_at_target = 0.0f;
+
+	if (lookahead.turn_possible && fabsf(lookahead.target(2) - start_position(2)) < config.z_accept_rad) {
+		const float cos_alpha = Vector2f((lookahead.target - start_position).xy()).unit_or_zero().dot(
+						lookahead.u_next_to_target);
+		// a straight line (alpha = pi) gives an unbounded turn speed, it is limited by the exit speed
+		const float safe_cos_alpha = constrain(cos_alpha, -1.f, 1.f);
+		const float tan_half_alpha = sqrtf((1.f - safe_cos_alpha) / max(1.f + safe_cos_alpha, FLT_EPSILON));
+		const float accel_tmp = config.max_acc_xy_radius_scale * config.max_acc_xy;
+		const float max_speed_in_turn = sqrtf(accel_tmp * config.xy_accept_rad * tan_half_alpha);
+		speed_at_target = min(min(max_speed_in_turn, lookahead.exit_speed), config.max_speed_xy);
+	}
+
+	const float start_to_target = (start_position - lookahead.target).xy().norm();
+	const float max_speed = computeMaxSpeedFromDistance(config.max_jerk, config.max_acc_xy, start_to_target,
+				speed_at_target);
+
+	return min(config.max_speed_xy, max_speed);
+}
+
 inline bool clampToXYNorm(Vector3f &target, float max_xy_norm)
 {
 	const float xynorm = target.xy().norm();
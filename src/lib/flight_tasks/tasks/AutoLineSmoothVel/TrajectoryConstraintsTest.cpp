@@ -218,6 +218,34 @@ TEST_F(TrajectoryConstraintsTest, test10AngleCloseNext)
 	EXPECT_LT(close_speed, normal_speed);
 }
 
+TEST_F(TrajectoryConstraintsTest, testLookaheadSameAsWaypoints)
+{
+	// GIVEN: next waypoints at different angles and distances, including a reversal and an overlap
+	const Vector3f next_targets[] = {
+		Vector3f(20, 20, 5), Vector3f(25, 15, 5), Vector3f(30, 11.7, 5), Vector3f(22, 10.4, 5),
+		Vector3f(40, 10, 5), Vector3f(0, 10, 5), Vector3f(20.5, 10, 5), Vector3f(20, 20, 10)
+	};
+
+	for (const Vector3f &next : next_targets) {
+		// WHEN: the lookahead of target and next waypoint is computed once
+		const TargetLookahead lookahead = computeTargetLookahead(target, next, config);
+		EXPECT_TRUE(isLookaheadValid(lookahead, target, next, config));
+
+		// THEN: the speed from any position is the same as from the waypoints
+		for (float x = 0.f; x < 20.f; x += 1.5f) {
+			const Vector3f position(x, 10.f + 0.2f * x, 5.f);
+			Vector3f waypoints[3] = {position, target, next};
+			EXPECT_NEAR(computeXYSpeedFromLookahead(position, lookahead), computeXYSpeedFromWaypoints<3>(waypoints, config),
+				    1e-3f) << "next " << next(0) << "," << next(1) << " position " << x;
+		}
+	}
+
+	// AND: a change of the limits invalidates the lookahead
+	const TargetLookahead lookahead = computeTargetLookahead(target, next_target, config);
+	config.max_speed_xy = 5.f;
+	EXPECT_FALSE(isLookaheadValid(lookahead, target, next_target, config));
+}
+
 TEST(TrajectoryConstraintsClamp, clampToXYNormNoEffectLarge)
 {
 	// GIVEN: a short vector
@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file GainSchedule.hpp
+ *
+ * Precomputed lookup table of a scalar schedule y = f(x) over [x_min, x_max], e.g. an airspeed dependent scaling.
+ * The table is generated when the parameters it depends on change and linearly interpolated at runtime,
+ * which replaces divisions and transcendental functions in the control loop by a multiply-add.
+ */
+
+#pragma once
+
+namespace math
+{
+
+template<int POINTS>
+class GainSchedule
+{
+	static_assert(POINTS >= 2, "at least two table points required");
+public:
+	GainSchedule() = default;
+	~GainSchedule() = default;
+
+	/**
+	 * (Re)generate the table by sampling a function at equally spaced points
+	 * @param x_min start of the input range, inputs below are clamped
+	 * @param x_max end of the input range, inputs above are clamped
+	 * @param f callable float(float), only called here and never at runtime
+	 */
+	template<typename F>
+	void generate(float x_min, float x_max, F f)
+	{
+		if (!(x_max > x_min)) {
+			// degenerate range, constant table
+			x_max = x_min;
+		}
+
+		_x_min = x_min;
+		_x_max = x_max;
+		_inv_dx = (x_max > x_min) ? (POINTS - 1) / (x_max - x_min) : 0.f;
+
+		for (int i = 0; i < POINTS; i++) {
+			_y[i] = f(x_min + (x_max - x_min) * i / (POINTS - 1));
+		}
+	}
+
+	/**
+	 * Interpolate the table, the input is clamped to the range of the table
+	 */
+	float interpolate(float x) const
+	{
+		if (!(x > _x_min)) {
+			// also catches NaN
+			return _y[0];
+
+		} else if (x >= _x_max) {
+			return _y[POINTS - 1];
+		}
+
+		const float position = (x - _x_min) * _inv_dx;
+		int index = static_cast<int>(position);
+
+		if (index > POINTS - 2) {
+			index = POINTS - 2;
+		}
+
+		const float fraction = position - index;
+		return _y[index] + fraction * (_y[index + 1] - _y[index]);
+	}
+
+	float x_min() const { return _x_min; }
+	float x_max() const { return _x_max; }
+
+private:
+	float _x_min{0.f};
+	float _x_max{0.f};
+	float _inv_dx{0.f};
+	float _y[POINTS] {};
+};
+
+} // namespace math
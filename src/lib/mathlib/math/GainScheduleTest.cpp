@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "GainSchedule.hpp"
+
+using namespace math;
+
+TEST(GainScheduleTest, Linear)
+{
+	// a linear function is reproduced exactly
+	GainSchedule<5> schedule;
+	schedule.generate(10.f, 20.f, [](float x) { return 2.f * x + 1.f; });
+
+	EXPECT_FLOAT_EQ(schedule.interpolate(10.f), 21.f);
+	EXPECT_FLOAT_EQ(schedule.interpolate(12.5f), 26.f);
+	EXPECT_FLOAT_EQ(schedule.interpolate(13.f), 27.f);
+	EXPECT_FLOAT_EQ(schedule.interpolate(19.99f), 40.98f);
+	EXPECT_FLOAT_EQ(schedule.interpolate(20.f), 41.f);
+}
+
+TEST(GainScheduleTest, Clamped)
+{
+	GainSchedule<5> schedule;
+	schedule.generate(10.f, 20.f, [](float x) { return 2.f * x + 1.f; });
+
+	EXPECT_FLOAT_EQ(schedule.interpolate(0.f), 21.f);
+	EXPECT_FLOAT_EQ(schedule.interpolate(100.f), 41.f);
+	EXPECT_FLOAT_EQ(schedule.interpolate(NAN), 21.f);
+	EXPECT_FLOAT_EQ(schedule.interpolate(INFINITY), 41.f);
+}
+
+TEST(GainScheduleTest, DegenerateRange)
+{
+	GainSchedule<5> schedule;
+	schedule.generate(15.f, 10.f, [](float x) { return 1.f / x; });
+
+	EXPECT_FLOAT_EQ(schedule.interpolate(10.f), 1.f / 15.f);
+	EXPECT_FLOAT_EQ(schedule.interpolate(15.f), 1.f / 15.f);
+	EXPECT_FLOAT_EQ(schedule.interpolate(20.f), 1.f / 15.f);
+}
+
+TEST(GainScheduleTest, AirspeedScaling)
+{
+	// trim airspeed / airspeed as used by fw_att_control
+	const float trim = 15.f;
+	GainSchedule<17> schedule;
+	schedule.generate(10.f, 20.f, [trim](float airspeed) { return trim / airspeed; });
+
+	for (float airspeed = 10.f; airspeed <= 20.f; airspeed += 0.1f) {
+		EXPECT_NEAR(schedule.interpolate(airspeed), trim / airspeed, 2e-3f) << airspeed;
+	}
+}
@@ -0,0 +1,326 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/*
+ * @file BiquadFilterBank.hpp
+ *
+ * @brief Bank of cascaded biquad filters (notch and 2nd order low-pass) for 3 axis data.
+ *
+ * All axes are processed together (one 4 lane vector, the 4th lane is unused), which
+ * maps each biquad stage to a few NEON (or SSE) instructions and keeps the coefficients
+ * in registers. On targets without SIMD (e.g. Cortex-M7) the compiler lowers the vector
+ * operations to scalar FPU code.
+ */
+
+#pragma once
+
+#include <px4_platform_common/defines.h>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <matrix/math.hpp>
+
+namespace math
+{
+
+template<int MAX_STAGES>
+class BiquadFilterBank
+{
+public:
+	static_assert(MAX_STAGES > 0, "at least one stage required");
+
+	BiquadFilterBank()
+	{
+		for (int i = 0; i < MAX_STAGES; i++) {
+			disable(i);
+		}
+	}
+
+	~BiquadFilterBank() = default;
+
+	/**
+	 * Configure a stage as notch filter (same design as NotchFilter)
+	 * A notch frequency <= 0 disables the stage. Retuning a stage that already is a notch
+	 * keeps its state, so that the notch can follow a moving frequency without transients.
+	 */
+	void setNotch(int stage, float sample_freq, float notch_freq, float bandwidth)
+	{
+		if (!valid(stage)) {
+			return;
+		}
+
+		if ((notch_freq <= 0.f) || (sample_freq <= 0.f)) {
+			disable(stage);
+			return;
+		}
+
+		const float alpha = tanf(M_PI_F * bandwidth / sample_freq);
+		const float beta = -cosf(2.f * M_PI_F * notch_freq / sample_freq);
+		const float a0_inv = 1.f / (alpha + 1.f);
+
+		Stage &s = _stages[stage];
+		s.b0 = a0_inv;
+		s.b1 = 2.f * beta * a0_inv;
+		s.b2 = a0_inv;
+		s.a1 = s.b1;
+		s.a2 = (1.f - alpha) * a0_inv;
+		s.freq = notch_freq;
+		s.bandwidth = bandwidth;
+
+		if (s.type != Type::Notch) {
+			s.type = Type::Notch;
+			resetStage(stage);
+			updateActiveStages();
+		}
+	}
+
+	/**
+	 * Configure a stage as 2nd order Butterworth low-pass (same design as LowPassFilter2p)
+	 * A cutoff frequency <= 0 disables the stage.
+	 */
+	void setLowPass(int stage, float sample_freq, float cutoff_freq)
+	{
+		if (!valid(stage)) {
+			return;
+		}
+
+		if ((cutoff_freq <= 0.f) || (sample_freq <= 0.f)) {
+			disable(stage);
+			return;
+		}
+
+		const float fr = sample_freq / cutoff_freq;
+		const float ohm = tanf(M_PI_F / fr);
+		const float c = 1.f + 2.f * cosf(M_PI_F / 4.f) * ohm + ohm * ohm;
+
+		Stage &s = _stages[stage];
+		s.b0 = ohm * ohm / c;
+		s.b1 = 2.f * s.b0;
+		s.b2 = s.b0;
+		s.a1 = 2.f * (ohm * ohm - 1.f) / c;
+		s.a2 = (1.f - 2.f * cosf(M_PI_F / 4.f) * ohm + ohm * ohm) / c;
+		s.type = Type::LowPass;
+		s.freq = cutoff_freq;
+		s.bandwidth = 0.f;
+
+		resetStage(stage);
+		updateActiveStages();
+	}
+
+	/**
+	 * Set a stage to pass-through
+	 */
+	void disable(int stage)
+	{
+		if (!valid(stage)) {
+			return;
+		}
+
+		Stage &s = _stages[stage];
+		s.b0 = 1.f;
+		s.b1 = 0.f;
+		s.b2 = 0.f;
+		s.a1 = 0.f;
+		s.a2 = 0.f;
+		s.type = Type::Disabled;
+		s.freq = 0.f;
+		s.bandwidth = 0.f;
+
+		resetStage(stage);
+		updateActiveStages();
+	}
+
+	bool enabled(int stage) const { return valid(stage) && (_stages[stage].type != Type::Disabled); }
+	float getFrequency(int stage) const { return valid(stage) ? _stages[stage].freq : 0.f; }
+	float getBandwidth(int stage) const { return valid(stage) ? _stages[stage].bandwidth : 0.f; }
+
+	/**
+	 * number of stages that have to be processed (highest enabled stage + 1)
+	 */
+	int activeStages() const { return _active_stages; }
+
+	// Used in unit test only
+	void getCoefficients(int stage, float a[3], float b[3]) const
+	{
+		const Stage &s = _stages[stage];
+		a[0] = 1.f;
+		a[1] = s.a1;
+		a[2] = s.a2;
+		b[0] = s.b0;
+		b[1] = s.b1;
+		b[2] = s.b2;
+	}
+
+	/**
+	 * Add a new raw value to the filter bank
+	 *
+	 * @return retrieve the filtered result
+	 */
+	inline matrix::Vector3f apply(const matrix::Vector3f &sample)
+	{
+		vec4 v = {sample(0), sample(1), sample(2), 0.f};
+
+		for (int i = 0; i < _active_stages; i++) {
+			v = applyStage(_stages[i], _state[i], v);
+		}
+
+		return matrix::Vector3f{v[0], v[1], v[2]};
+	}
+
+	/**
+	 * Filter a block of samples in place (e.g. the samples of a sensor FIFO)
+	 *
+	 * The stage loop is outside the sample loop, so that the coefficients and the
+	 * state of a stage stay in registers for the whole block.
+	 */
+	inline void apply(float x[], float y[], float z[], int num_samples)
+	{
+		for (int i = 0; i < _active_stages; i++) {
+			const Stage &s = _stages[i];
+			State state = _state[i];
+
+			for (int n = 0; n < num_samples; n++) {
+				vec4 v = {x[n], y[n], z[n], 0.f};
+				v = applyStage(s, state, v);
+				x[n] = v[0];
+				y[n] = v[1];
+				z[n] = v[2];
+			}
+
+			_state[i] = state;
+		}
+	}
+
+	/**
+	 * Reset all stages to the steady state of a constant input
+	 *
+	 * @return retrieve the filtered result
+	 */
+	matrix::Vector3f reset(const matrix::Vector3f &sample)
+	{
+		vec4 v = {sample(0), sample(1), sample(2), 0.f};
+
+		for (int i = 0; i < MAX_STAGES; i++) {
+			const Stage &s = _stages[i];
+			const float dc_gain = s.b0 + s.b1 + s.b2;
+			const float den = 1.f + s.a1 + s.a2;
+
+			// steady state delay element for a constant input: w = v / (1 + a1 + a2), output = w * (b0 + b1 + b2)
+			vec4 w = v;
+
+			if (fabsf(den) > FLT_EPSILON) {
+				w = v / den;
+			}
+
+			_state[i].w1 = w;
+			_state[i].w2 = w;
+
+			if (i < _active_stages) {
+				v = w * dc_gain;
+			}
+		}
+
+		return apply(sample);
+	}
+
+private:
+	typedef float vec4 __attribute__((vector_size(16)));
+	typedef int vec4i __attribute__((vector_size(16)));
+
+	enum class Type : uint8_t {
+		Disabled,
+		Notch,
+		LowPass,
+	};
+
+	struct Stage {
+		// All the coefficients are normalized by a0, so a0 becomes 1 here
+		float a1;
+		float a2;
+		float b0;
+		float b1;
+		float b2;
+
+		float freq;
+		float bandwidth;
+		Type type;
+	};
+
+	struct State {
+		vec4 w1;
+		vec4 w2;
+	};
+
+	static inline vec4 applyStage(const Stage &s, State &state, const vec4 &sample)
+	{
+		// Direct Form II implementation
+		vec4 w0 = sample - state.w1 * s.a1 - state.w2 * s.a2;
+
+		// don't allow bad values to propagate via the filter (NaN and inf have all exponent bits set)
+		const vec4i finite = (((vec4i)w0 & 0x7f800000) != 0x7f800000);
+		w0 = (vec4)(((vec4i)w0 & finite) | ((vec4i)sample & ~finite));
+
+		const vec4 output = w0 * s.b0 + state.w1 * s.b1 + state.w2 * s.b2;
+
+		state.w2 = state.w1;
+		state.w1 = w0;
+
+		return output;
+	}
+
+	static constexpr bool valid(int stage) { return (stage >= 0) && (stage < MAX_STAGES); }
+
+	void resetStage(int stage)
+	{
+		_state[stage].w1 = vec4{};
+		_state[stage].w2 = vec4{};
+	}
+
+	void updateActiveStages()
+	{
+		_active_stages = 0;
+
+		for (int i = 0; i < MAX_STAGES; i++) {
+			if (_stages[i].type != Type::Disabled) {
+				_active_stages = i + 1;
+			}
+		}
+	}
+
+	Stage _stages[MAX_STAGES] {};
+	State _state[MAX_STAGES] {};
+
+	int _active_stages{0};
+};
+
+} // namespace math
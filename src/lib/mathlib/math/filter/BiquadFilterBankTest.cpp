@@ -0,0 +1,213 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Test code for the biquad filter bank
+ * Run this test only using make tests TESTFILTER=BiquadFilterBank
+ */
+
+#include <gtest/gtest.h>
+#include <matrix/matrix/math.hpp>
+
+#include "BiquadFilterBank.hpp"
+#include "LowPassFilter2pVector3f.hpp"
+#include "NotchFilter.hpp"
+
+using namespace math;
+using matrix::Vector3f;
+
+class BiquadFilterBankTest : public ::testing::Test
+{
+public:
+	BiquadFilterBank<4> _bank;
+	const float _sample_freq = 8000.f;
+
+	const float _epsilon_near = 1e-5f;
+
+	static Vector3f input(int n)
+	{
+		const float t = n / 8000.f;
+		return Vector3f{sinf(2.f * M_PI_F * 50.f * t) + 0.3f * sinf(2.f * M_PI_F * 700.f * t),
+				0.5f * cosf(2.f * M_PI_F * 120.f * t),
+				1.f + 0.2f * sinf(2.f * M_PI_F * 1500.f * t)};
+	}
+};
+
+TEST_F(BiquadFilterBankTest, coefficients)
+{
+	_bank.setNotch(0, 1000.f, 50.f, 15.f);
+
+	float a[3];
+	float b[3];
+
+	// same coefficients as NotchFilterTest
+	const float b_expected[3] = {0.95496499f, -1.81645136f, 0.95496499f};
+	const float a_expected[3] = {1.f, -1.81645136f, 0.90992999f};
+
+	_bank.getCoefficients(0, a, b);
+
+	for (int i = 0; i < 3; i++) {
+		EXPECT_NEAR(a[i], a_expected[i], 1e-6f);
+		EXPECT_NEAR(b[i], b_expected[i], 1e-6f);
+	}
+
+	EXPECT_EQ(_bank.getFrequency(0), 50.f);
+	EXPECT_EQ(_bank.getBandwidth(0), 15.f);
+	EXPECT_EQ(_bank.activeStages(), 1);
+}
+
+TEST_F(BiquadFilterBankTest, disabledPassThrough)
+{
+	EXPECT_EQ(_bank.activeStages(), 0);
+
+	for (int n = 0; n < 100; n++) {
+		const Vector3f out = _bank.apply(input(n));
+		EXPECT_EQ(out, input(n));
+	}
+}
+
+TEST_F(BiquadFilterBankTest, matchesCascadedFilters)
+{
+	NotchFilter<Vector3f> notch_1;
+	NotchFilter<Vector3f> notch_2;
+	LowPassFilter2pVector3f lpf{_sample_freq, 400.f};
+
+	notch_1.setParameters(_sample_freq, 700.f, 50.f);
+	notch_2.setParameters(_sample_freq, 1500.f, 100.f);
+
+	_bank.setNotch(0, _sample_freq, 700.f, 50.f);
+	_bank.setNotch(2, _sample_freq, 1500.f, 100.f);
+	_bank.setLowPass(3, _sample_freq, 400.f);
+	EXPECT_EQ(_bank.activeStages(), 4);
+
+	for (int n = 0; n < 2000; n++) {
+		const Vector3f expected = lpf.apply(notch_2.apply(notch_1.apply(input(n))));
+		const Vector3f out = _bank.apply(input(n));
+
+		for (int i = 0; i < 3; i++) {
+			EXPECT_NEAR(out(i), expected(i), _epsilon_near);
+		}
+	}
+}
+
+TEST_F(BiquadFilterBankTest, blockMatchesSingle)
+{
+	BiquadFilterBank<4> bank_single;
+
+	for (auto *bank : {&_bank, &bank_single}) {
+		bank->setNotch(0, _sample_freq, 700.f, 50.f);
+		bank->setNotch(1, _sample_freq, 1500.f, 100.f);
+		bank->setLowPass(2, _sample_freq, 400.f);
+	}
+
+	int n = 0;
+
+	for (int block = 0; block < 100; block++) {
+		float x[16];
+		float y[16];
+		float z[16];
+		const int samples = 1 + (block % 16);
+
+		for (int i = 0; i < samples; i++) {
+			const Vector3f v = input(n + i);
+			x[i] = v(0);
+			y[i] = v(1);
+			z[i] = v(2);
+		}
+
+		_bank.apply(x, y, z, samples);
+
+		for (int i = 0; i < samples; i++) {
+			const Vector3f expected = bank_single.apply(input(n++));
+			EXPECT_FLOAT_EQ(x[i], expected(0));
+			EXPECT_FLOAT_EQ(y[i], expected(1));
+			EXPECT_FLOAT_EQ(z[i], expected(2));
+		}
+	}
+}
+
+TEST_F(BiquadFilterBankTest, resetSteadyState)
+{
+	_bank.setNotch(0, _sample_freq, 700.f, 50.f);
+	_bank.setLowPass(1, _sample_freq, 400.f);
+
+	const Vector3f constant{0.1f, -2.f, 5.f};
+	Vector3f out = _bank.reset(constant);
+
+	for (int n = 0; n < 10; n++) {
+		for (int i = 0; i < 3; i++) {
+			EXPECT_NEAR(out(i), constant(i), _epsilon_near);
+		}
+
+		out = _bank.apply(constant);
+	}
+}
+
+TEST_F(BiquadFilterBankTest, nonFiniteInput)
+{
+	_bank.setNotch(0, _sample_freq, 700.f, 50.f);
+	_bank.reset(Vector3f{1.f, 1.f, 1.f});
+
+	_bank.apply(Vector3f{NAN, 1.f, 1.f});
+
+	// NaN must not get stuck in the filter state
+	Vector3f out;
+
+	for (int n = 0; n < 1000; n++) {
+		out = _bank.apply(Vector3f{1.f, 1.f, 1.f});
+	}
+
+	EXPECT_TRUE(PX4_ISFINITE(out(0)));
+	EXPECT_NEAR(out(0), 1.f, 1e-3f);
+	EXPECT_NEAR(out(1), 1.f, _epsilon_near);
+}
+
+TEST_F(BiquadFilterBankTest, retuneNotchKeepsState)
+{
+	_bank.setNotch(0, _sample_freq, 700.f, 50.f);
+
+	const Vector3f constant{1.f, 2.f, 3.f};
+	_bank.reset(constant);
+
+	// moving the notch must not cause a transient on a constant input
+	for (int n = 0; n < 100; n++) {
+		_bank.setNotch(0, _sample_freq, 700.f + n, 50.f);
+		const Vector3f out = _bank.apply(constant);
+
+		for (int i = 0; i < 3; i++) {
+			EXPECT_NEAR(out(i), constant(i), 1e-2f);
+		}
+	}
+
+	EXPECT_EQ(_bank.activeStages(), 1);
+}
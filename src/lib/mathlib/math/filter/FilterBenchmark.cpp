@@ -0,0 +1,97 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Benchmarks of the mathlib filters
+ * Run with make benchmarks
+ */
+
+#include <benchmark/benchmark.h>
+#include <matrix/matrix/math.hpp>
+
+#include "LowPassFilter2p.hpp"
+#include "LowPassFilter2pVector3f.hpp"
+#include "NotchFilter.hpp"
+
+using namespace math;
+using matrix::Vector3f;
+
+static void LowPassFilter2p_apply(benchmark::State &state)
+{
+	LowPassFilter2p filter{800.f, 30.f};
+	float input = 0.f;
+
+	for (auto _ : state) {
+		input += 0.01f;
+		benchmark::DoNotOptimize(filter.apply(input));
+	}
+}
+BENCHMARK(LowPassFilter2p_apply);
+
+static void LowPassFilter2pVector3f_apply(benchmark::State &state)
+{
+	LowPassFilter2pVector3f filter{800.f, 30.f};
+	Vector3f input{};
+
+	for (auto _ : state) {
+		input(0) += 0.01f;
+		benchmark::DoNotOptimize(filter.apply(input));
+	}
+}
+BENCHMARK(LowPassFilter2pVector3f_apply);
+
+static void NotchFilter_apply_float(benchmark::State &state)
+{
+	NotchFilter<float> filter;
+	filter.setParameters(800.f, 50.f, 20.f);
+	float input = 0.f;
+
+	for (auto _ : state) {
+		input += 0.01f;
+		benchmark::DoNotOptimize(filter.apply(input));
+	}
+}
+BENCHMARK(NotchFilter_apply_float);
+
+static void NotchFilter_apply_Vector3f(benchmark::State &state)
+{
+	NotchFilter<Vector3f> filter;
+	filter.setParameters(800.f, 50.f, 20.f);
+	Vector3f input{};
+
+	for (auto _ : state) {
+		input(0) += 0.01f;
+		benchmark::DoNotOptimize(filter.apply(input));
+	}
+}
+BENCHMARK(NotchFilter_apply_Vector3f);
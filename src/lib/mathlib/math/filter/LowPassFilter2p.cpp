@@ -72,7 +72,7 @@ void LowPassFilter2p::set_cutoff_frequency(float sample_freq, float cutoff_freq)
 	_a2 = (1.0f - 2.0f * cosf(M_PI_F / 4.0f) * ohm + ohm * ohm) / c;
 }
 
-float LowPassFilter2p::apply(float sample)
+PX4_HOT float LowPassFilter2p::apply(float sample)
 {
 	// do the filtering
 	float delay_element_0 = sample - _delay_element_1 * _a1 - _delay_element_2 * _a2;
@@ -0,0 +1,181 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/// @file	LowPassFilter2pArrayFixed.hpp
+/// @brief	Second order low pass filter for int16 sample arrays in fixed-point arithmetic
+///
+/// Same filter as LowPassFilter2pArray, for targets where the float filter chain
+/// at FIFO rates is too expensive (e.g. Cortex-M4). Direct Form I with Q2.29
+/// coefficients, states with 16 fractional bits and a 64 bit accumulator, i.e.
+/// 5 multiply-accumulates (SMLAL) per sample. Q15 coefficients (SMLAD) are not
+/// used on purpose: at typical cutoff/sample rate ratios (e.g. 30 Hz at 8 kHz)
+/// b0 is below 1e-4 and would be quantized to a few LSB.
+
+#pragma once
+
+#include "LowPassFilter2p.hpp"
+
+#include <px4_platform_common/defines.h>
+#include <math.h>
+#include <stdint.h>
+
+namespace math
+{
+
+class LowPassFilter2pArrayFixed : public LowPassFilter2p
+{
+public:
+
+	LowPassFilter2pArrayFixed(float sample_freq, float cutoff_freq) : LowPassFilter2p(sample_freq, cutoff_freq)
+	{
+		update_coefficients();
+	}
+
+	// Change filter parameters
+	void set_cutoff_frequency(float sample_freq, float cutoff_freq)
+	{
+		LowPassFilter2p::set_cutoff_frequency(sample_freq, cutoff_freq);
+		update_coefficients();
+	}
+
+	/**
+	 * Add new raw values to the filter
+	 *
+	 * @return retrieve the filtered result of the last sample
+	 */
+	inline float apply(const int16_t samples[], uint8_t num_samples)
+	{
+		for (int n = 0; n < num_samples; n++) {
+			const int32_t x0 = (int32_t)samples[n] * (1 << STATE_FRACTION_BITS);
+
+			// Direct Form I: all products are Q(29 + 16), no overflow for |coefficients| sum < 8
+			int64_t acc = (int64_t)_b0_fixed * x0;
+			acc += (int64_t)_b1_fixed * _x1;
+			acc += (int64_t)_b2_fixed * _x2;
+			acc -= (int64_t)_a1_fixed * _y1;
+			acc -= (int64_t)_a2_fixed * _y2;
+
+			// round and saturate
+			const int32_t y0 = saturate((acc + (1LL << (COEFFICIENT_FRACTION_BITS - 1))) >> COEFFICIENT_FRACTION_BITS);
+
+			_x2 = _x1;
+			_x1 = x0;
+			_y2 = _y1;
+			_y1 = y0;
+		}
+
+		return _y1 * (1.f / (1 << STATE_FRACTION_BITS));
+	}
+
+	// Reset the filter state to the steady state of this value
+	float reset(float sample)
+	{
+		// DC gain of the quantized coefficients (not exactly 1)
+		const int64_t b_sum = (int64_t)_b0_fixed + _b1_fixed + _b2_fixed;
+		const int64_t a_sum = (1LL << COEFFICIENT_FRACTION_BITS) + _a1_fixed + _a2_fixed;
+		const float dc_gain = (a_sum != 0) ? (float)b_sum / (float)a_sum : 1.f;
+
+		const int32_t x_state = saturate((int64_t)roundf(sample * (1 << STATE_FRACTION_BITS)));
+		const int32_t y_state = saturate((int64_t)roundf(sample * dc_gain * (1 << STATE_FRACTION_BITS)));
+
+		_x1 = x_state;
+		_x2 = x_state;
+		_y1 = y_state;
+		_y2 = y_state;
+
+		return _y1 * (1.f / (1 << STATE_FRACTION_BITS));
+	}
+
+	// Used in unit test only
+	void getCoefficients(int32_t a[3], int32_t b[3]) const
+	{
+		a[0] = 1 << COEFFICIENT_FRACTION_BITS;
+		a[1] = _a1_fixed;
+		a[2] = _a2_fixed;
+		b[0] = _b0_fixed;
+		b[1] = _b1_fixed;
+		b[2] = _b2_fixed;
+	}
+
+	static constexpr int COEFFICIENT_FRACTION_BITS = 29;
+	static constexpr int STATE_FRACTION_BITS = 16;
+
+private:
+
+	static inline int32_t saturate(int64_t value)
+	{
+		if (value > INT32_MAX) {
+			return INT32_MAX;
+
+		} else if (value < INT32_MIN) {
+			return INT32_MIN;
+		}
+
+		return (int32_t)value;
+	}
+
+	static inline int32_t quantize(float coefficient)
+	{
+		return (int32_t)roundf(coefficient * (float)(1 << COEFFICIENT_FRACTION_BITS));
+	}
+
+	void update_coefficients()
+	{
+		_b0_fixed = quantize(_b0);
+		_b1_fixed = quantize(_b1);
+		_b2_fixed = quantize(_b2);
+		_a1_fixed = quantize(_a1);
+		_a2_fixed = quantize(_a2);
+
+		// reset delay elements on filter change
+		_x1 = 0;
+		_x2 = 0;
+		_y1 = 0;
+		_y2 = 0;
+	}
+
+	// coefficients (Q2.29)
+	int32_t _b0_fixed{0};
+	int32_t _b1_fixed{0};
+	int32_t _b2_fixed{0};
+	int32_t _a1_fixed{0};
+	int32_t _a2_fixed{0};
+
+	// input and output delay elements (16 fractional bits)
+	int32_t _x1{0};
+	int32_t _x2{0};
+	int32_t _y1{0};
+	int32_t _y2{0};
+};
+
+} // namespace math
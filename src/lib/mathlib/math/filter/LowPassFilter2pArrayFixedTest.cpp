@@ -0,0 +1,219 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Test code for the fixed-point low pass filter
+ * Run this test only using make tests TESTFILTER=LowPassFilter2pArrayFixed
+ */
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "LowPassFilter2pArray.hpp"
+#include "LowPassFilter2pArrayFixed.hpp"
+
+using namespace math;
+
+// Direct Form I in double precision with the (float) coefficients of LowPassFilter2p
+class LowPassFilter2pDouble : public LowPassFilter2p
+{
+public:
+	LowPassFilter2pDouble(float sample_freq, float cutoff_freq) : LowPassFilter2p(sample_freq, cutoff_freq) {}
+
+	double apply(double x0)
+	{
+		const double y0 = (double)_b0 * x0 + (double)_b1 * _x1 + (double)_b2 * _x2 - (double)_a1 * _y1 - (double)_a2 * _y2;
+		_x2 = _x1;
+		_x1 = x0;
+		_y2 = _y1;
+		_y1 = y0;
+		return y0;
+	}
+
+	void getCoefficients(float a[3], float b[3]) const
+	{
+		a[0] = 1.f;
+		a[1] = _a1;
+		a[2] = _a2;
+		b[0] = _b0;
+		b[1] = _b1;
+		b[2] = _b2;
+	}
+
+private:
+	double _x1{0.0};
+	double _x2{0.0};
+	double _y1{0.0};
+	double _y2{0.0};
+};
+
+class LowPassFilter2pArrayFixedTest : public ::testing::Test
+{
+public:
+	void compare(float sample_freq, float cutoff_freq, int block_size)
+	{
+		LowPassFilter2pDouble reference{sample_freq, cutoff_freq};
+		LowPassFilter2pArray reference_float{sample_freq, cutoff_freq};
+		LowPassFilter2pArrayFixed fixed{sample_freq, cutoff_freq};
+
+		for (int n = 0; n + block_size <= NUM_SAMPLES; n += block_size) {
+			double expected = 0.0;
+			float expected_float = 0.f;
+
+			for (int i = 0; i < block_size; i++) {
+				expected = reference.apply(_input[n + i]);
+				expected_float = reference_float.apply(&_input[n + i], 1);
+			}
+
+			const float out = fixed.apply(&_input[n], block_size);
+
+			// within a small fraction of the int16 LSB of the exact result
+			EXPECT_NEAR(out, expected, _max_error_lsb) << "sample " << n;
+
+			// rounded to the int16 resolution the result is bit-exact
+			// (unless the reference is right at a rounding boundary)
+			if (fabs(fabs(expected - floor(expected)) - 0.5) > (double)_max_error_lsb) {
+				EXPECT_EQ(lround(out), lround(expected)) << "sample " << n;
+			}
+
+			// the float filter has rounding errors of its own for low cutoff frequencies
+			EXPECT_NEAR(out, expected_float, 0.5f) << "sample " << n;
+		}
+	}
+
+	static constexpr int NUM_SAMPLES = 8000;
+	int16_t _input[NUM_SAMPLES] {};
+
+	const float _max_error_lsb = 0.05f;
+};
+
+TEST_F(LowPassFilter2pArrayFixedTest, coefficients)
+{
+	for (float cutoff_freq : {30.f, 100.f, 1000.f}) {
+		LowPassFilter2pDouble reference{8000.f, cutoff_freq};
+		LowPassFilter2pArrayFixed fixed{8000.f, cutoff_freq};
+
+		float a_expected[3];
+		float b_expected[3];
+		reference.getCoefficients(a_expected, b_expected);
+
+		int32_t a[3];
+		int32_t b[3];
+		fixed.getCoefficients(a, b);
+
+		// quantized to the nearest LSB
+		const double scale = 1 << LowPassFilter2pArrayFixed::COEFFICIENT_FRACTION_BITS;
+
+		for (int i = 0; i < 3; i++) {
+			EXPECT_LE(fabs(a[i] - (double)a_expected[i] * scale), 0.5);
+			EXPECT_LE(fabs(b[i] - (double)b_expected[i] * scale), 0.5);
+		}
+
+		// b0 must not vanish for low cutoff/sample rate ratios
+		EXPECT_GT(b[0], 50000);
+	}
+}
+
+TEST_F(LowPassFilter2pArrayFixedTest, disabled)
+{
+	LowPassFilter2pArrayFixed fixed{8000.f, 0.f};
+
+	for (int16_t v : {0, 1, -1, 1234, INT16_MAX, INT16_MIN}) {
+		EXPECT_EQ(fixed.apply(&v, 1), v);
+	}
+}
+
+TEST_F(LowPassFilter2pArrayFixedTest, step)
+{
+	for (int n = 0; n < NUM_SAMPLES; n++) {
+		_input[n] = (n < 100) ? 0 : 16000;
+	}
+
+	compare(8000.f, 30.f, 1);
+	compare(1000.f, 80.f, 1);
+}
+
+TEST_F(LowPassFilter2pArrayFixedTest, noise)
+{
+	srand(1);
+
+	for (int n = 0; n < NUM_SAMPLES; n++) {
+		const float t = n / 8000.f;
+		const float signal = 8000.f * sinf(2.f * M_PI_F * 5.f * t) + 4000.f * sinf(2.f * M_PI_F * 800.f * t);
+		_input[n] = (int16_t)(signal + (rand() % 4001) - 2000);
+	}
+
+	compare(8000.f, 30.f, 1);
+	compare(8000.f, 100.f, 8);
+	compare(4000.f, 1000.f, 16);
+}
+
+TEST_F(LowPassFilter2pArrayFixedTest, saturation)
+{
+	LowPassFilter2pArrayFixed fixed{8000.f, 1000.f};
+
+	// full scale square wave: the overshoot must saturate instead of wrapping around
+	int16_t block[8];
+
+	for (int i = 0; i < 200; i++) {
+		for (auto &v : block) {
+			v = (i % 2) ? INT16_MAX : INT16_MIN;
+		}
+
+		const float out = fixed.apply(block, 8);
+
+		if (i % 2) {
+			EXPECT_GT(out, 0.f);
+
+		} else {
+			EXPECT_LT(out, 0.f);
+		}
+	}
+}
+
+TEST_F(LowPassFilter2pArrayFixedTest, reset)
+{
+	LowPassFilter2pArrayFixed fixed{8000.f, 30.f};
+	const float steady_state = fixed.reset(1000.f);
+
+	// the (float) coefficient design itself is not exactly unity gain
+	EXPECT_NEAR(steady_state, 1000.f, 1.f);
+
+	const int16_t constant = 1000;
+
+	for (int i = 0; i < 1000; i++) {
+		EXPECT_NEAR(fixed.apply(&constant, 1), steady_state, _max_error_lsb);
+	}
+}
@@ -46,5 +46,6 @@
 #include "math/matrix_alg.h"
 #include "math/SearchMin.hpp"
 #include "math/TrajMath.hpp"
+#include "math/GainSchedule.hpp"
 
 #endif
@@ -41,6 +41,8 @@
 
 #include <mathlib/mathlib.h>
 #include <cstdio>
+#include <cstring>
+#include <new>
 #include <px4_platform_common/defines.h>
 
 #define debug(fmt, args...)	do { } while(0)
@@ -57,7 +59,8 @@ HelicopterMixer::HelicopterMixer(ControlCallback control_cb, uintptr_t cb_handle
 }
 
 HelicopterMixer *
-HelicopterMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen)
+HelicopterMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen,
+			   MixerArena *arena)
 {
 	mixer_heli_s mixer_info;
 	unsigned swash_plate_servo_count = 0;
@@ -180,7 +183,18 @@ HelicopterMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 
 	debug("remaining in buf: %d, first char: %c", buflen, buf[0]);
 
-	HelicopterMixer *hm = new HelicopterMixer(control_cb, cb_handle, mixer_info);
+	HelicopterMixer *hm = nullptr;
+
+	if (arena != nullptr) {
+		void *mixer_memory = arena->allocate(sizeof(HelicopterMixer));
+
+		if (mixer_memory != nullptr) {
+			hm = new (mixer_memory) HelicopterMixer(control_cb, cb_handle, mixer_info);
+		}
+
+	} else {
+		hm = new HelicopterMixer(control_cb, cb_handle, mixer_info);
+	}
 
 	if (hm != nullptr) {
 		debug("loaded heli mixer with %d swash plate input(s)", mixer_info.control_count);
@@ -192,6 +206,71 @@ HelicopterMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 	return hm;
 }
 
+size_t
+HelicopterMixer::binary_arena_size(const uint8_t *record)
+{
+	mixer_binary_record_s header;
+	memcpy(&header, record, sizeof(header));
+
+	if (header.count < 3 || header.count > 4) {
+		debug("only supporting swash plate with 3 or 4 servos");
+		return 0;
+	}
+
+	if (header.size < sizeof(header) + sizeof(mixer_binary_helicopter_s) + header.count * sizeof(mixer_binary_heli_servo_s)) {
+		debug("helicopter mixer record too short");
+		return 0;
+	}
+
+	return MixerArena::aligned(sizeof(HelicopterMixer));
+}
+
+HelicopterMixer *
+HelicopterMixer::from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *record,
+			     MixerArena &arena)
+{
+	mixer_binary_record_s header;
+	memcpy(&header, record, sizeof(header));
+	const uint8_t *payload = record + sizeof(header);
+
+	mixer_binary_helicopter_s helicopter;
+	memcpy(&helicopter, payload, sizeof(helicopter));
+	payload += sizeof(helicopter);
+
+	mixer_heli_s mixer_info;
+
+	for (unsigned i = 0; i < HELI_CURVES_NR_POINTS; i++) {
+		mixer_info.throttle_curve[i] = ((float) helicopter.throttle_curve[i]) / 10000.0f;
+		mixer_info.pitch_curve[i] = ((float) helicopter.pitch_curve[i]) / 10000.0f;
+	}
+
+	mixer_info.control_count = header.count;
+
+	for (unsigned i = 0; i < mixer_info.control_count; i++) {
+		mixer_binary_heli_servo_s servo;
+		memcpy(&servo, payload, sizeof(servo));
+		payload += sizeof(servo);
+
+		mixer_info.servos[i].angle = ((float) servo.angle) * M_PI_F / 180.0f;
+		mixer_info.servos[i].arm_length = ((float) servo.arm_length) / 10000.0f;
+		mixer_info.servos[i].scale = ((float) servo.scale) / 10000.0f;
+		mixer_info.servos[i].offset = ((float) servo.offset) / 10000.0f;
+		mixer_info.servos[i].min_output = ((float) servo.min_output) / 10000.0f;
+		mixer_info.servos[i].max_output = ((float) servo.max_output) / 10000.0f;
+	}
+
+	void *mixer_memory = arena.allocate(sizeof(HelicopterMixer));
+
+	if (mixer_memory == nullptr) {
+		debug("mixer arena full");
+		return nullptr;
+	}
+
+	debug("loaded binary heli mixer with %d swash plate input(s)", mixer_info.control_count);
+
+	return new (mixer_memory) HelicopterMixer(control_cb, cb_handle, mixer_info);
+}
+
 unsigned
 HelicopterMixer::mix(float *outputs, unsigned space)
 {
@@ -34,6 +34,8 @@
 #pragma once
 
 #include <mixer/Mixer/Mixer.hpp>
+#include <mixer/Mixer/MixerArena.hpp>
+#include <mixer/Mixer/MixerBinary.hpp>
 
 /** helicopter swash servo mixer */
 struct mixer_heli_servo_s {
@@ -93,11 +95,44 @@ public:
 	 *				the mixer.
 	 * @param buflen		Length of the buffer in bytes, adjusted
 	 *				to reflect the bytes consumed.
+	 * @param arena			Optional arena to allocate the mixer from
+	 *				instead of the heap, reserved with
+	 *				text_arena_size().
 	 * @return			A new HelicopterMixer instance, or nullptr
 	 *				if the text format is bad.
 	 */
 	static HelicopterMixer		*from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf,
-			unsigned &buflen);
+			unsigned &buflen, MixerArena *arena = nullptr);
+
+	/**
+	 * Arena size of the mixer described by the text header line 'H:'.
+	 *
+	 * @return			The arena size required by from_text().
+	 */
+	static size_t			text_arena_size(const char *buf) { return MixerArena::aligned(sizeof(HelicopterMixer)); }
+
+	/**
+	 * Factory method for the binary mixer format.
+	 *
+	 * @param control_cb		The callback to invoke when fetching a
+	 *				control value.
+	 * @param cb_handle		Handle passed to the control callback.
+	 * @param record		A binary mixer record of type 'H', validated
+	 *				with binary_arena_size().
+	 * @param arena			The arena to allocate the mixer from.
+	 * @return			A new HelicopterMixer instance, or nullptr
+	 *				if the arena is full.
+	 */
+	static HelicopterMixer		*from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *record,
+			MixerArena &arena);
+
+	/**
+	 * Validate a binary mixer record of type 'H'.
+	 *
+	 * @return			The arena size required by from_binary(),
+	 *				or 0 if the record is invalid.
+	 */
+	static size_t			binary_arena_size(const uint8_t *record);
 
 	unsigned			mix(float *outputs, unsigned space) override;
 
@@ -0,0 +1,136 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file MixerArena.hpp
+ *
+ * Preallocated memory for mixers loaded from a binary mixer blob.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Linear (bump) allocator for mixer objects and their configuration.
+ *
+ * The buffer is allocated once and reused for every subsequent load, so
+ * repeatedly loading and resetting mixers does not fragment the heap.
+ * Memory is only handed back as a whole with clear().
+ */
+class MixerArena
+{
+public:
+	MixerArena() = default;
+
+	~MixerArena()
+	{
+		free(_buffer);
+	}
+
+	// no copy, assignment, move, move assignment
+	MixerArena(const MixerArena &) = delete;
+	MixerArena &operator=(const MixerArena &) = delete;
+	MixerArena(MixerArena &&) = delete;
+	MixerArena &operator=(MixerArena &&) = delete;
+
+	/**
+	 * Ensure the arena can hold at least size bytes. The buffer is only
+	 * reallocated if it is too small and currently unused.
+	 *
+	 * @return true if size bytes are available
+	 */
+	bool reserve(size_t size)
+	{
+		size = aligned(size);
+
+		if (size <= _size - _used) {
+			return true;
+		}
+
+		if (_used != 0) {
+			return false;
+		}
+
+		free(_buffer);
+		_buffer = (uint8_t *)malloc(size);
+		_size = (_buffer != nullptr) ? size : 0;
+
+		return _buffer != nullptr;
+	}
+
+	/**
+	 * Allocate size bytes from the arena.
+	 *
+	 * @return pointer to memory aligned to ALIGNMENT, or nullptr if the arena is full
+	 */
+	void *allocate(size_t size)
+	{
+		size = aligned(size);
+
+		if (size > _size - _used) {
+			return nullptr;
+		}
+
+		void *ptr = &_buffer[_used];
+		_used += size;
+		return ptr;
+	}
+
+	/**
+	 * Release all allocations. Objects placed in the arena must be destroyed before.
+	 */
+	void clear() { _used = 0; }
+
+	bool contains(const void *ptr) const
+	{
+		return ((const uint8_t *)ptr >= _buffer) && ((const uint8_t *)ptr < _buffer + _size);
+	}
+
+	size_t size() const { return _size; }
+	size_t used() const { return _used; }
+
+	/**
+	 * Size that an allocation of size bytes occupies in the arena.
+	 */
+	static constexpr size_t aligned(size_t size) { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+	static constexpr size_t ALIGNMENT = 8;
+
+private:
+	uint8_t *_buffer{nullptr};
+	size_t _size{0};
+	size_t _used{0};
+};
@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file MixerBinary.hpp
+ *
+ * Precompiled binary mixer format.
+ *
+ * The binary format contains the same information as the text format (see
+ * MixerGroup::load_from_buf()), with the numbers already converted
+ * to integers, so that it can be loaded without any text parsing. Blobs are
+ * generated at build time from the text mixer files by Tools/px_mixer_binary.py,
+ * which must be kept in sync with the definitions below.
+ *
+ * A blob starts with a mixer_binary_header_s, followed by mixer_count records.
+ * Each record starts with a mixer_binary_record_s, followed by the payload
+ * of the mixer type. All values are little-endian. Records are padded to a
+ * multiple of 4 bytes.
+ *
+ * Payloads (all scales in units of 1/10000, as in the text format):
+ *  'Z' null mixer:       none
+ *  'M' simple mixer:     mixer_binary_scaler_s output scaler, followed by
+ *                        count x mixer_binary_control_s
+ *  'R' multirotor mixer: mixer_binary_multirotor_s
+ *  'H' helicopter mixer: mixer_binary_helicopter_s, followed by
+ *                        count x mixer_binary_heli_servo_s
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+static constexpr uint32_t MIXER_BINARY_MAGIC = 0x424d5850; ///< "PXMB"
+static constexpr uint16_t MIXER_BINARY_VERSION = 1;
+
+struct mixer_binary_header_s {
+	uint32_t magic;			///< MIXER_BINARY_MAGIC
+	uint16_t version;		///< MIXER_BINARY_VERSION
+	uint16_t mixer_count;		///< number of mixer records
+	uint32_t size;			///< size of the blob in bytes, including this header
+};
+
+struct mixer_binary_record_s {
+	uint8_t type;			///< mixer type, the tag of the text format ('Z', 'M', 'R', 'H')
+	uint8_t count;			///< number of control inputs (M) or swash plate servos (H)
+	uint16_t size;			///< size of the record in bytes, including this header
+};
+
+struct mixer_binary_scaler_s {
+	int16_t negative_scale;
+	int16_t positive_scale;
+	int16_t offset;
+	int16_t min_output;
+	int16_t max_output;
+};
+
+struct mixer_binary_control_s {
+	uint8_t control_group;
+	uint8_t control_index;
+	mixer_binary_scaler_s scaler;
+};
+
+struct mixer_binary_multirotor_s {
+	char geometry[8];		///< geometry name, zero terminated
+	int16_t roll_scale;
+	int16_t pitch_scale;
+	int16_t yaw_scale;
+	int16_t idle_speed;
+};
+
+struct mixer_binary_helicopter_s {
+	uint16_t throttle_curve[5];
+	int16_t pitch_curve[5];
+};
+
+struct mixer_binary_heli_servo_s {
+	uint16_t angle;			///< [deg]
+	uint16_t arm_length;
+	int16_t scale;
+	int16_t offset;
+	int16_t min_output;
+	int16_t max_output;
+};
+
+static_assert(sizeof(mixer_binary_header_s) == 12, "binary mixer header size mismatch");
+static_assert(sizeof(mixer_binary_record_s) == 4, "binary mixer record size mismatch");
+static_assert(sizeof(mixer_binary_control_s) == 12, "binary mixer control size mismatch");
+static_assert(sizeof(mixer_binary_multirotor_s) == 16, "binary mixer multirotor size mismatch");
+static_assert(sizeof(mixer_binary_helicopter_s) == 20, "binary mixer helicopter size mismatch");
+static_assert(sizeof(mixer_binary_heli_servo_s) == 12, "binary mixer helicopter servo size mismatch");
+
+/**
+ * Get the size of a binary mixer blob.
+ *
+ * @param buf		Buffer holding at least a mixer_binary_header_s.
+ * @return		The size of the blob in bytes, or 0 if buf does not
+ *			start with a supported binary mixer header.
+ */
+static inline unsigned mixer_binary_size(const void *buf)
+{
+	mixer_binary_header_s header;
+	memcpy(&header, buf, sizeof(header));
+
+	if (header.magic != MIXER_BINARY_MAGIC || header.version != MIXER_BINARY_VERSION
+	    || header.size < sizeof(header)) {
+		return 0;
+	}
+
+	return header.size;
+}
@@ -39,6 +39,9 @@
 
 #include "MixerGroup.hpp"
 
+#include <errno.h>
+#include <string.h>
+
 #include "HelicopterMixer/HelicopterMixer.hpp"
 #include "MultirotorMixer/MultirotorMixer.hpp"
 #include "NullMixer/NullMixer.hpp"
@@ -49,6 +52,31 @@
 //#include <debug.h>
 //#define debug(fmt, args...)	syslog(fmt "\n", ##args)
 
+void
+MixerGroup::reset()
+{
+	Mixer *mixer = _mixers.getHead();
+
+	while (mixer != nullptr) {
+		_mixers.remove(mixer);
+
+		if (_arena != nullptr && _arena->contains(mixer)) {
+			// constructed in the arena, the memory is released with the arena
+			mixer->~Mixer();
+
+		} else {
+			delete mixer;
+		}
+
+		mixer = _mixers.getHead();
+	}
+
+	if (_arena != nullptr) {
+		_arena->clear();
+		_arena = nullptr;
+	}
+}
+
 unsigned
 MixerGroup::mix(float *outputs, unsigned space)
 {
@@ -171,6 +199,64 @@ MixerGroup::groups_required(uint32_t &groups)
 
 int
 MixerGroup::load_from_buf(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen)
+{
+	return load_from_text(control_cb, cb_handle, buf, buflen, nullptr);
+}
+
+int
+MixerGroup::load_from_buf(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen,
+			  MixerArena &arena)
+{
+	if (_arena != nullptr && _arena != &arena) {
+		debug("group already uses another arena");
+		return -EINVAL;
+	}
+
+	/*
+	 * Sum up the size of all mixers from their header lines. Lines of
+	 * mixers that fail to parse are counted as well, which only
+	 * reserves a bit more than needed.
+	 */
+	size_t arena_size = 0;
+
+	for (unsigned i = 0; i + 1 < buflen; i++) {
+		if ((i > 0 && buf[i - 1] != '\n') || buf[i + 1] != ':') {
+			continue;
+		}
+
+		switch (buf[i]) {
+		case 'Z':
+			arena_size += NullMixer::text_arena_size(&buf[i]);
+			break;
+
+		case 'M':
+			arena_size += SimpleMixer::text_arena_size(&buf[i]);
+			break;
+
+		case 'R':
+			arena_size += MultirotorMixer::text_arena_size(&buf[i]);
+			break;
+
+		case 'H':
+			arena_size += HelicopterMixer::text_arena_size(&buf[i]);
+			break;
+		}
+	}
+
+	if (!arena.reserve(arena_size)) {
+		// e.g. appending to mixers already in the arena, fall back to the heap
+		debug("mixer arena cannot hold %u bytes", (unsigned)arena_size);
+		return load_from_text(control_cb, cb_handle, buf, buflen, nullptr);
+	}
+
+	_arena = &arena;
+
+	return load_from_text(control_cb, cb_handle, buf, buflen, &arena);
+}
+
+int
+MixerGroup::load_from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen,
+			   MixerArena *arena)
 {
 	int ret = -1;
 	const char *end = buf + buflen;
@@ -189,19 +275,19 @@ MixerGroup::load_from_buf(Mixer::ControlCallback control_cb, uintptr_t cb_handle
 		 */
 		switch (*p) {
 		case 'Z':
-			m = NullMixer::from_text(p, resid);
+			m = NullMixer::from_text(p, resid, arena);
 			break;
 
 		case 'M':
-			m = SimpleMixer::from_text(control_cb, cb_handle, p, resid);
+			m = SimpleMixer::from_text(control_cb, cb_handle, p, resid, arena);
 			break;
 
 		case 'R':
-			m = MultirotorMixer::from_text(control_cb, cb_handle, p, resid);
+			m = MultirotorMixer::from_text(control_cb, cb_handle, p, resid, arena);
 			break;
 
 		case 'H':
-			m = HelicopterMixer::from_text(control_cb, cb_handle, p, resid);
+			m = HelicopterMixer::from_text(control_cb, cb_handle, p, resid, arena);
 			break;
 
 		default:
@@ -237,6 +323,122 @@ MixerGroup::load_from_buf(Mixer::ControlCallback control_cb, uintptr_t cb_handle
 	return ret;
 }
 
+int
+MixerGroup::load_from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const void *buf, unsigned buflen,
+			     MixerArena &arena)
+{
+	if (_arena != nullptr && _arena != &arena) {
+		debug("group already uses another arena");
+		return -EINVAL;
+	}
+
+	const unsigned size = (buflen >= sizeof(mixer_binary_header_s)) ? mixer_binary_size(buf) : 0;
+
+	if (size == 0 || size > buflen) {
+		debug("invalid binary mixer header");
+		return -EINVAL;
+	}
+
+	mixer_binary_header_s header;
+	memcpy(&header, buf, sizeof(header));
+
+	const uint8_t *records = (const uint8_t *)buf + sizeof(header);
+	const uint8_t *end = (const uint8_t *)buf + size;
+
+	/*
+	 * Validate all records and sum up the arena size first, so that
+	 * a bad blob does not leave partially loaded mixers behind.
+	 */
+	size_t arena_size = 0;
+	const uint8_t *record = records;
+
+	for (unsigned i = 0; i < header.mixer_count; i++) {
+		mixer_binary_record_s record_header;
+
+		if (end - record < (ptrdiff_t)sizeof(record_header)) {
+			debug("binary mixer truncated");
+			return -EINVAL;
+		}
+
+		memcpy(&record_header, record, sizeof(record_header));
+
+		if (record_header.size < sizeof(record_header) || record_header.size > end - record) {
+			debug("binary mixer record %u has bad size %u", i, record_header.size);
+			return -EINVAL;
+		}
+
+		size_t mixer_size = 0;
+
+		switch (record_header.type) {
+		case 'Z':
+			mixer_size = NullMixer::binary_arena_size(record);
+			break;
+
+		case 'M':
+			mixer_size = SimpleMixer::binary_arena_size(record);
+			break;
+
+		case 'R':
+			mixer_size = MultirotorMixer::binary_arena_size(record);
+			break;
+
+		case 'H':
+			mixer_size = HelicopterMixer::binary_arena_size(record);
+			break;
+		}
+
+		if (mixer_size == 0) {
+			debug("binary mixer record %u of type %c is invalid", i, record_header.type);
+			return -EINVAL;
+		}
+
+		arena_size += mixer_size;
+		record += record_header.size;
+	}
+
+	if (!arena.reserve(arena_size)) {
+		debug("mixer arena cannot hold %u bytes", (unsigned)arena_size);
+		return -ENOMEM;
+	}
+
+	_arena = &arena;
+	record = records;
+
+	for (unsigned i = 0; i < header.mixer_count; i++) {
+		mixer_binary_record_s record_header;
+		memcpy(&record_header, record, sizeof(record_header));
+
+		Mixer *m = nullptr;
+
+		switch (record_header.type) {
+		case 'Z':
+			m = NullMixer::from_binary(record, arena);
+			break;
+
+		case 'M':
+			m = SimpleMixer::from_binary(control_cb, cb_handle, record, arena);
+			break;
+
+		case 'R':
+			m = MultirotorMixer::from_binary(control_cb, cb_handle, record, arena);
+			break;
+
+		case 'H':
+			m = HelicopterMixer::from_binary(control_cb, cb_handle, record, arena);
+			break;
+		}
+
+		if (m == nullptr) {
+			return -ENOMEM;
+		}
+
+		add_mixer(m);
+		record += record_header.size;
+	}
+
+	return 0;
+}
+
 void MixerGroup::set_max_delta_out_once(float delta_out_max)
 {
 	for (auto mixer : _mixers) {
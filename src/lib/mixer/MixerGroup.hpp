@@ -34,6 +34,7 @@
 #pragma once
 
 #include "Mixer/Mixer.hpp"
+#include "Mixer/MixerArena.hpp"
 
 /**
  * Group of mixers, built up from single mixers and processed
@@ -71,7 +72,7 @@ public:
 	/**
 	 * Remove all the mixers from the group.
 	 */
-	void				reset() { _mixers.clear(); }
+	void				reset();
 
 	/**
 	 * Count the mixers in the group.
@@ -135,6 +136,42 @@ public:
 	 */
 	int				load_from_buf(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen);
 
+	/**
+	 * Adds mixers to the group based on a text description in a buffer,
+	 * constructing them in the arena instead of the heap.
+	 *
+	 * The arena is reserved once with the size of all mixers in the buffer,
+	 * so that the mixers and their configuration are contiguous in memory.
+	 * If the arena cannot be reserved (e.g. because it already holds
+	 * mixers), the mixers are allocated on the heap. The arena must outlive
+	 * the group and is cleared by reset().
+	 *
+	 * @param buf			The mixer configuration buffer.
+	 * @param buflen		The length of the buffer, updated to reflect
+	 *				bytes as they are consumed.
+	 * @param arena			Memory for the mixers.
+	 * @return			Zero on successful load, nonzero otherwise.
+	 */
+	int				load_from_buf(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen,
+				      MixerArena &arena);
+
+	/**
+	 * Adds mixers to the group from a precompiled binary mixer blob.
+	 *
+	 * The blob format is described in Mixer/MixerBinary.hpp. The mixers
+	 * are constructed in the arena instead of the heap, which is reserved
+	 * once with the size required by all mixers of the blob. The arena
+	 * must outlive the group and is cleared by reset(). All loads into
+	 * a group need to use the same arena.
+	 *
+	 * @param buf			The binary mixer blob.
+	 * @param buflen		The length of the buffer.
+	 * @param arena			Memory for the mixers.
+	 * @return			Zero on successful load, negative error code otherwise.
+	 */
+	int				load_from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const void *buf,
+			unsigned buflen, MixerArena &arena);
+
 	/**
 	 * @brief      Update slew rate parameter. This tells instances of the class MultirotorMixer
 	 *             the maximum allowed change of the output values per cycle.
@@ -166,5 +203,9 @@ public:
 	unsigned			get_multirotor_count();
 
 private:
+	int				load_from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen,
+				       MixerArena *arena);
+
 	List<Mixer *>			_mixers;	/**< linked list of mixers */
+	MixerArena			*_arena{nullptr};	/**< arena the mixers are allocated from, if any */
 };
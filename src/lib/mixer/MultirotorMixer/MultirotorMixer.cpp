@@ -42,8 +42,10 @@
 #include <float.h>
 #include <cstring>
 #include <cstdio>
+#include <new>
 
 #include <mathlib/mathlib.h>
+#include <px4_platform_common/defines.h>
 
 #ifdef MIXER_MULTIROTOR_USE_MOCK_GEOMETRY
 enum class MultirotorGeometry : MultirotorGeometryUnderlyingType {
@@ -80,8 +82,8 @@ const char *_config_key[] = {"4x"};
 //#define debug(fmt, args...)	syslog(fmt "\n", ##args)
 
 MultirotorMixer::MultirotorMixer(ControlCallback control_cb, uintptr_t cb_handle, MultirotorGeometry geometry,
-				 float roll_scale, float pitch_scale, float yaw_scale, float idle_speed) :
-	MultirotorMixer(control_cb, cb_handle, _config_index[(int)geometry], _config_rotor_count[(int)geometry])
+				 float roll_scale, float pitch_scale, float yaw_scale, float idle_speed, float *storage) :
+	MultirotorMixer(control_cb, cb_handle, _config_index[(int)geometry], _config_rotor_count[(int)geometry], storage)
 {
 	_roll_scale = roll_scale;
 	_pitch_scale = pitch_scale;
@@ -90,28 +92,64 @@ MultirotorMixer::MultirotorMixer(ControlCallback control_cb, uintptr_t cb_handle
 }
 
 MultirotorMixer::MultirotorMixer(ControlCallback control_cb, uintptr_t cb_handle, const Rotor *rotors,
-				 unsigned rotor_count) :
+				 unsigned rotor_count, float *storage) :
 	Mixer(control_cb, cb_handle),
 	_rotor_count(rotor_count),
-	_rotors(rotors),
-	_outputs_prev(new float[_rotor_count]),
-	_tmp_array(new float[_rotor_count])
+	_rotor_scales(storage != nullptr ? storage : new float[STORAGE_SIZE(_rotor_count)]),
+	_owns_storage(storage == nullptr),
+	_outputs_prev(&_rotor_scales[4 * _rotor_count])
 {
+	float *roll_scales = &_rotor_scales[0];
+	float *pitch_scales = &_rotor_scales[_rotor_count];
+	float *yaw_scales = &_rotor_scales[2 * _rotor_count];
+	float *thrust_scales = &_rotor_scales[3 * _rotor_count];
+
 	for (unsigned i = 0; i < _rotor_count; ++i) {
+		roll_scales[i] = rotors[i].roll_scale;
+		pitch_scales[i] = rotors[i].pitch_scale;
+		yaw_scales[i] = rotors[i].yaw_scale;
+		thrust_scales[i] = rotors[i].thrust_scale;
+
 		_outputs_prev[i] = _idle_speed;
 	}
+
+	_roll_scales = roll_scales;
+	_pitch_scales = pitch_scales;
+	_yaw_scales = yaw_scales;
+	_thrust_scales = thrust_scales;
 }
 
 MultirotorMixer::~MultirotorMixer()
 {
-	delete[] _outputs_prev;
-	delete[] _tmp_array;
+	if (_owns_storage) {
+		delete[] _rotor_scales;
+	}
+}
+
+MultirotorGeometry
+MultirotorMixer::geometry_from_name(const char *name)
+{
+	for (MultirotorGeometryUnderlyingType i = 0; i < (MultirotorGeometryUnderlyingType)MultirotorGeometry::MAX_GEOMETRY;
+	     i++) {
+		if (!strcmp(name, _config_key[i])) {
+			return (MultirotorGeometry)i;
+		}
+	}
+
+	return MultirotorGeometry::MAX_GEOMETRY;
+}
+
+size_t
+MultirotorMixer::arena_size(MultirotorGeometry geometry)
+{
+	return MixerArena::aligned(sizeof(MultirotorMixer))
+	       + MixerArena::aligned(STORAGE_SIZE(_config_rotor_count[(int)geometry]) * sizeof(float));
 }
 
 MultirotorMixer *
-MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen)
+MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen,
+			   MixerArena *arena)
 {
-	MultirotorGeometry geometry = MultirotorGeometry::MAX_GEOMETRY;
 	char geomname[8];
 	int s[4];
 	int used;
@@ -140,13 +178,7 @@ MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 
 	debug("remaining in buf: %d, first char: %c", buflen, buf[0]);
 
-	for (MultirotorGeometryUnderlyingType i = 0; i < (MultirotorGeometryUnderlyingType)MultirotorGeometry::MAX_GEOMETRY;
-	     i++) {
-		if (!strcmp(geomname, _config_key[i])) {
-			geometry = (MultirotorGeometry)i;
-			break;
-		}
-	}
+	const MultirotorGeometry geometry = geometry_from_name(geomname);
 
 	if (geometry == MultirotorGeometry::MAX_GEOMETRY) {
 		debug("unrecognised geometry '%s'", geomname);
@@ -155,6 +187,19 @@ MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 
 	debug("adding multirotor mixer '%s'", geomname);
 
+	if (arena != nullptr) {
+		void *mixer_memory = arena->allocate(sizeof(MultirotorMixer));
+		float *storage = (float *)arena->allocate(STORAGE_SIZE(_config_rotor_count[(int)geometry]) * sizeof(float));
+
+		if (mixer_memory == nullptr || storage == nullptr) {
+			debug("mixer arena full");
+			return nullptr;
+		}
+
+		return new (mixer_memory) MultirotorMixer(control_cb, cb_handle, geometry,
+				s[0] / 10000.0f, s[1] / 10000.0f, s[2] / 10000.0f, s[3] / 10000.0f, storage);
+	}
+
 	return new MultirotorMixer(
 		       control_cb,
 		       cb_handle,
@@ -165,174 +210,233 @@ MultirotorMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handl
 		       s[3] / 10000.0f);
 }
 
-float
-MultirotorMixer::compute_desaturation_gain(const float *desaturation_vector, const float *outputs,
-		saturation_status &sat_status, float min_output, float max_output) const
+size_t
+MultirotorMixer::text_arena_size(const char *buf)
 {
-	float k_min = 0.f;
-	float k_max = 0.f;
+	char geomname[8];
 
-	for (unsigned i = 0; i < _rotor_count; i++) {
-		// Avoid division by zero. If desaturation_vector[i] is zero, there's nothing we can do to unsaturate anyway
-		if (fabsf(desaturation_vector[i]) < FLT_EPSILON) {
-			continue;
-		}
+	if (sscanf(buf, "R: %7s", geomname) != 1) {
+		return 0;
+	}
 
-		if (outputs[i] < min_output) {
-			float k = (min_output - outputs[i]) / desaturation_vector[i];
+	const MultirotorGeometry geometry = geometry_from_name(geomname);
 
-			if (k < k_min) { k_min = k; }
+	if (geometry == MultirotorGeometry::MAX_GEOMETRY) {
+		return 0;
+	}
 
-			if (k > k_max) { k_max = k; }
+	return arena_size(geometry);
+}
 
-			sat_status.flags.motor_neg = true;
-		}
+size_t
+MultirotorMixer::binary_arena_size(const uint8_t *record)
+{
+	mixer_binary_record_s header;
+	mixer_binary_multirotor_s multirotor;
+	memcpy(&header, record, sizeof(header));
 
-		if (outputs[i] > max_output) {
-			float k = (max_output - outputs[i]) / desaturation_vector[i];
+	if (header.size < sizeof(header) + sizeof(multirotor)) {
+		debug("multirotor mixer record too short");
+		return 0;
+	}
+
+	memcpy(&multirotor, record + sizeof(header), sizeof(multirotor));
 
-			if (k < k_min) { k_min = k; }
+	if (memchr(multirotor.geometry, '\0', sizeof(multirotor.geometry)) == nullptr) {
+		debug("geometry name not terminated");
+		return 0;
+	}
 
-			if (k > k_max) { k_max = k; }
+	const MultirotorGeometry geometry = geometry_from_name(multirotor.geometry);
 
-			sat_status.flags.motor_pos = true;
-		}
+	if (geometry == MultirotorGeometry::MAX_GEOMETRY) {
+		debug("unrecognised geometry '%s'", multirotor.geometry);
+		return 0;
+	}
+
+	return arena_size(geometry);
+}
+
+MultirotorMixer *
+MultirotorMixer::from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *record,
+			     MixerArena &arena)
+{
+	mixer_binary_multirotor_s multirotor;
+	memcpy(&multirotor, record + sizeof(mixer_binary_record_s), sizeof(multirotor));
+
+	const MultirotorGeometry geometry = geometry_from_name(multirotor.geometry);
+
+	void *mixer_memory = arena.allocate(sizeof(MultirotorMixer));
+	float *storage = (float *)arena.allocate(STORAGE_SIZE(_config_rotor_count[(int)geometry]) * sizeof(float));
+
+	if (mixer_memory == nullptr || storage == nullptr) {
+		debug("mixer arena full");
+		return nullptr;
 	}
 
-	// Reduce the saturation as much as possible
-	return k_min + k_max;
+	debug("adding binary multirotor mixer '%s'", multirotor.geometry);
+
+	return new (mixer_memory) MultirotorMixer(
+		       control_cb,
+		       cb_handle,
+		       geometry,
+		       multirotor.roll_scale / 10000.0f,
+		       multirotor.pitch_scale / 10000.0f,
+		       multirotor.yaw_scale / 10000.0f,
+		       multirotor.idle_speed / 10000.0f,
+		       storage);
 }
 
 void
+MultirotorMixer::update_desaturation_flags(float k, float k_min_pos, float k_max_pos, float k_min_neg, float k_max_neg,
+		saturation_status &sat_status)
+{
+	if (k < k_min_pos || k > k_min_neg) {
+		sat_status.flags.motor_neg = true;
+	}
+
+	if (k > k_max_pos || k < k_max_neg) {
+		sat_status.flags.motor_pos = true;
+	}
+}
+
+PX4_HOT void
 MultirotorMixer::minimize_saturation(const float *desaturation_vector, float *outputs,
 				     saturation_status &sat_status, float min_output, float max_output, bool reduce_only) const
 {
-	float k1 = compute_desaturation_gain(desaturation_vector, outputs, sat_status, min_output, max_output);
+	// Output i stays within [min_output, max_output] when adding k * desaturation_vector[i] for all gains k
+	// in an interval. Only the extremes of these intervals matter, split by the sign of desaturation_vector[i]
+	// to also know which limit an output crosses:
+	float k_min_pos = -FLT_MAX; // outputs with positive desaturation_vector are below min_output for k < k_min_pos
+	float k_max_pos = FLT_MAX;  // outputs with positive desaturation_vector are above max_output for k > k_max_pos
+	float k_min_neg = FLT_MAX;  // outputs with negative desaturation_vector are below min_output for k > k_min_neg
+	float k_max_neg = -FLT_MAX; // outputs with negative desaturation_vector are above max_output for k < k_max_neg
+
+	for (unsigned i = 0; i < _rotor_count; i++) {
+		// Avoid division by zero. If desaturation_vector[i] is zero, there's nothing we can do to unsaturate anyway
+		if (fabsf(desaturation_vector[i]) < FLT_EPSILON) {
+			continue;
+		}
+
+		const float k_min = (min_output - outputs[i]) / desaturation_vector[i];
+		const float k_max = (max_output - outputs[i]) / desaturation_vector[i];
+
+		if (desaturation_vector[i] > 0.f) {
+			k_min_pos = math::max(k_min_pos, k_min);
+			k_max_pos = math::min(k_max_pos, k_max);
+
+		} else {
+			k_min_neg = math::min(k_min_neg, k_min);
+			k_max_neg = math::max(k_max_neg, k_max);
+		}
+	}
+
+	// All outputs are unsaturated for gains within [k_lower, k_upper] (an empty range if k_lower > k_upper)
+	const float k_lower = math::max(k_min_pos, k_max_neg);
+	const float k_upper = math::min(k_max_pos, k_min_neg);
+
+	// Gain that unsaturates the output that has the greatest saturation in each direction
+	const float k1 = math::max(k_lower, 0.f) + math::min(k_upper, 0.f);
+
+	update_desaturation_flags(0.f, k_min_pos, k_max_pos, k_min_neg, k_max_neg, sat_status);
 
 	if (reduce_only && k1 > 0.f) {
 		return;
 	}
 
-	for (unsigned i = 0; i < _rotor_count; i++) {
-		outputs[i] += k1 * desaturation_vector[i];
-	}
+	// The remaining gain after applying k1 is zero in most cases. It won't be if
+	// max(outputs) - min(outputs) > max_output - min_output. In that case adding 0.5 of it will equilibrate saturations.
+	const float k2 = 0.5f * (math::max(k_lower - k1, 0.f) + math::min(k_upper - k1, 0.f));
+
+	update_desaturation_flags(k1, k_min_pos, k_max_pos, k_min_neg, k_max_neg, sat_status);
 
-	// Compute the desaturation gain again based on the updated outputs.
-	// In most cases it will be zero. It won't be if max(outputs) - min(outputs) > max_output - min_output.
-	// In that case adding 0.5 of the gain will equilibrate saturations.
-	float k2 = 0.5f * compute_desaturation_gain(desaturation_vector, outputs, sat_status, min_output, max_output);
+	const float k = k1 + k2;
 
 	for (unsigned i = 0; i < _rotor_count; i++) {
-		outputs[i] += k2 * desaturation_vector[i];
+		outputs[i] += k * desaturation_vector[i];
 	}
 }
 
-void
+PX4_HOT void
 MultirotorMixer::mix_airmode_rp(float roll, float pitch, float yaw, float thrust, float *outputs)
 {
 	// Airmode for roll and pitch, but not yaw
 
 	// Mix without yaw
 	for (unsigned i = 0; i < _rotor_count; i++) {
-		outputs[i] = roll * _rotors[i].roll_scale +
-			     pitch * _rotors[i].pitch_scale +
-			     thrust * _rotors[i].thrust_scale;
-
-		// Thrust will be used to unsaturate if needed
-		_tmp_array[i] = _rotors[i].thrust_scale;
+		outputs[i] = roll * _roll_scales[i] +
+			     pitch * _pitch_scales[i] +
+			     thrust * _thrust_scales[i];
 	}
 
-	minimize_saturation(_tmp_array, outputs, _saturation_status);
+	// Thrust will be used to unsaturate if needed
+	minimize_saturation(_thrust_scales, outputs, _saturation_status);
 
 	// Mix yaw independently
 	mix_yaw(yaw, outputs);
 }
 
-void
+PX4_HOT void
 MultirotorMixer::mix_airmode_rpy(float roll, float pitch, float yaw, float thrust, float *outputs)
 {
 	// Airmode for roll, pitch and yaw
 
 	// Do full mixing
 	for (unsigned i = 0; i < _rotor_count; i++) {
-		outputs[i] = roll * _rotors[i].roll_scale +
-			     pitch * _rotors[i].pitch_scale +
-			     yaw * _rotors[i].yaw_scale +
-			     thrust * _rotors[i].thrust_scale;
-
-		// Thrust will be used to unsaturate if needed
-		_tmp_array[i] = _rotors[i].thrust_scale;
+		outputs[i] = roll * _roll_scales[i] +
+			     pitch * _pitch_scales[i] +
+			     yaw * _yaw_scales[i] +
+			     thrust * _thrust_scales[i];
 	}
 
-	minimize_saturation(_tmp_array, outputs, _saturation_status);
+	// Thrust will be used to unsaturate if needed
+	minimize_saturation(_thrust_scales, outputs, _saturation_status);
 
 	// Unsaturate yaw (in case upper and lower bounds are exceeded)
 	// to prioritize roll/pitch over yaw.
-	for (unsigned i = 0; i < _rotor_count; i++) {
-		_tmp_array[i] = _rotors[i].yaw_scale;
-	}
-
-	minimize_saturation(_tmp_array, outputs, _saturation_status);
+	minimize_saturation(_yaw_scales, outputs, _saturation_status);
 }
 
-void
+PX4_HOT void
 MultirotorMixer::mix_airmode_disabled(float roll, float pitch, float yaw, float thrust, float *outputs)
 {
 	// Airmode disabled: never allow to increase the thrust to unsaturate a motor
 
 	// Mix without yaw
 	for (unsigned i = 0; i < _rotor_count; i++) {
-		outputs[i] = roll * _rotors[i].roll_scale +
-			     pitch * _rotors[i].pitch_scale +
-			     thrust * _rotors[i].thrust_scale;
-
-		// Thrust will be used to unsaturate if needed
-		_tmp_array[i] = _rotors[i].thrust_scale;
+		outputs[i] = roll * _roll_scales[i] +
+			     pitch * _pitch_scales[i] +
+			     thrust * _thrust_scales[i];
 	}
 
-	// only reduce thrust
-	minimize_saturation(_tmp_array, outputs, _saturation_status, 0.f, 1.f, true);
+	// Thrust will be used to unsaturate if needed, only reduce thrust
+	minimize_saturation(_thrust_scales, outputs, _saturation_status, 0.f, 1.f, true);
 
 	// Reduce roll/pitch acceleration if needed to unsaturate
-	for (unsigned i = 0; i < _rotor_count; i++) {
-		_tmp_array[i] = _rotors[i].roll_scale;
-	}
-
-	minimize_saturation(_tmp_array, outputs, _saturation_status);
-
-	for (unsigned i = 0; i < _rotor_count; i++) {
-		_tmp_array[i] = _rotors[i].pitch_scale;
-	}
+	minimize_saturation(_roll_scales, outputs, _saturation_status);
 
-	minimize_saturation(_tmp_array, outputs, _saturation_status);
+	minimize_saturation(_pitch_scales, outputs, _saturation_status);
 
 	// Mix yaw independently
 	mix_yaw(yaw, outputs);
 }
 
-void MultirotorMixer::mix_yaw(float yaw, float *outputs)
+PX4_HOT void MultirotorMixer::mix_yaw(float yaw, float *outputs)
 {
 	// Add yaw to outputs
 	for (unsigned i = 0; i < _rotor_count; i++) {
-		outputs[i] += yaw * _rotors[i].yaw_scale;
-
-		// Yaw will be used to unsaturate if needed
-		_tmp_array[i] = _rotors[i].yaw_scale;
+		outputs[i] += yaw * _yaw_scales[i];
 	}
 
 	// Change yaw acceleration to unsaturate the outputs if needed (do not change roll/pitch),
 	// and allow some yaw response at maximum thrust
-	minimize_saturation(_tmp_array, outputs, _saturation_status, 0.f, 1.15f);
-
-	for (unsigned i = 0; i < _rotor_count; i++) {
-		_tmp_array[i] = _rotors[i].thrust_scale;
-	}
+	minimize_saturation(_yaw_scales, outputs, _saturation_status, 0.f, 1.15f);
 
 	// reduce thrust only
-	minimize_saturation(_tmp_array, outputs, _saturation_status, 0.f, 1.f, true);
+	minimize_saturation(_thrust_scales, outputs, _saturation_status, 0.f, 1.f, true);
 }
 
-unsigned
+PX4_HOT unsigned
 MultirotorMixer::mix(float *outputs, unsigned space)
 {
 	if (space < _rotor_count) {
@@ -441,31 +545,31 @@ MultirotorMixer::update_saturation_status(unsigned index, bool clipping_high, bo
 	// The motor is saturated at the upper limit
 	// check which control axes and which directions are contributing
 	if (clipping_high) {
-		if (_rotors[index].roll_scale > 0.0f) {
+		if (_roll_scales[index] > 0.0f) {
 			// A positive change in roll will increase saturation
 			_saturation_status.flags.roll_pos = true;
 
-		} else if (_rotors[index].roll_scale < 0.0f) {
+		} else if (_roll_scales[index] < 0.0f) {
 			// A negative change in roll will increase saturation
 			_saturation_status.flags.roll_neg = true;
 		}
 
 		// check if the pitch input is saturating
-		if (_rotors[index].pitch_scale > 0.0f) {
+		if (_pitch_scales[index] > 0.0f) {
 			// A positive change in pitch will increase saturation
 			_saturation_status.flags.pitch_pos = true;
 
-		} else if (_rotors[index].pitch_scale < 0.0f) {
+		} else if (_pitch_scales[index] < 0.0f) {
 			// A negative change in pitch will increase saturation
 			_saturation_status.flags.pitch_neg = true;
 		}
 
 		// check if the yaw input is saturating
-		if (_rotors[index].yaw_scale > 0.0f) {
+		if (_yaw_scales[index] > 0.0f) {
 			// A positive change in yaw will increase saturation
 			_saturation_status.flags.yaw_pos = true;
 
-		} else if (_rotors[index].yaw_scale < 0.0f) {
+		} else if (_yaw_scales[index] < 0.0f) {
 			// A negative change in yaw will increase saturation
 			_saturation_status.flags.yaw_neg = true;
 		}
@@ -478,21 +582,21 @@ MultirotorMixer::update_saturation_status(unsigned index, bool clipping_high, bo
 	// check which control axes and which directions are contributing
 	if (clipping_low_roll_pitch) {
 		// check if the roll input is saturating
-		if (_rotors[index].roll_scale > 0.0f) {
+		if (_roll_scales[index] > 0.0f) {
 			// A negative change in roll will increase saturation
 			_saturation_status.flags.roll_neg = true;
 
-		} else if (_rotors[index].roll_scale < 0.0f) {
+		} else if (_roll_scales[index] < 0.0f) {
 			// A positive change in roll will increase saturation
 			_saturation_status.flags.roll_pos = true;
 		}
 
 		// check if the pitch input is saturating
-		if (_rotors[index].pitch_scale > 0.0f) {
+		if (_pitch_scales[index] > 0.0f) {
 			// A negative change in pitch will increase saturation
 			_saturation_status.flags.pitch_neg = true;
 
-		} else if (_rotors[index].pitch_scale < 0.0f) {
+		} else if (_pitch_scales[index] < 0.0f) {
 			// A positive change in pitch will increase saturation
 			_saturation_status.flags.pitch_pos = true;
 		}
@@ -503,11 +607,11 @@ MultirotorMixer::update_saturation_status(unsigned index, bool clipping_high, bo
 
 	if (clipping_low_yaw) {
 		// check if the yaw input is saturating
-		if (_rotors[index].yaw_scale > 0.0f) {
+		if (_yaw_scales[index] > 0.0f) {
 			// A negative change in yaw will increase saturation
 			_saturation_status.flags.yaw_neg = true;
 
-		} else if (_rotors[index].yaw_scale < 0.0f) {
+		} else if (_yaw_scales[index] < 0.0f) {
 			// A positive change in yaw will increase saturation
 			_saturation_status.flags.yaw_pos = true;
 		}
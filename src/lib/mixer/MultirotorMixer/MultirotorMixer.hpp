@@ -34,6 +34,8 @@
 #pragma once
 
 #include <mixer/Mixer/Mixer.hpp>
+#include <mixer/Mixer/MixerArena.hpp>
+#include <mixer/Mixer/MixerBinary.hpp>
 
 /**
  * Supported multirotor geometries.
@@ -78,9 +80,11 @@ public:
 	 * @param idle_speed		Minimum rotor control output value; usually
 	 *				tuned to ensure that rotors never stall at the
 	 * 				low end of their control range.
+	 * @param storage		Memory for STORAGE_SIZE(rotor count) floats,
+	 *				owned by the caller. Allocated if nullptr.
 	 */
 	MultirotorMixer(ControlCallback control_cb, uintptr_t cb_handle, MultirotorGeometry geometry,
-			float roll_scale, float pitch_scale, float yaw_scale, float idle_speed);
+			float roll_scale, float pitch_scale, float yaw_scale, float idle_speed, float *storage = nullptr);
 
 	/**
 	 * Constructor (for testing).
@@ -89,8 +93,11 @@ public:
 	 * @param cb_handle		Passed to control_cb.
 	 * @param rotors		control allocation matrix
 	 * @param rotor_count		length of rotors array (= number of motors)
+	 * @param storage		Memory for STORAGE_SIZE(rotor_count) floats,
+	 *				owned by the caller. Allocated if nullptr.
 	 */
-	MultirotorMixer(ControlCallback control_cb, uintptr_t cb_handle, const Rotor *rotors, unsigned rotor_count);
+	MultirotorMixer(ControlCallback control_cb, uintptr_t cb_handle, const Rotor *rotors, unsigned rotor_count,
+			float *storage = nullptr);
 	virtual ~MultirotorMixer();
 
 	// no copy, assignment, move, move assignment
@@ -112,11 +119,52 @@ public:
 	 *				the mixer.
 	 * @param buflen		Length of the buffer in bytes, adjusted
 	 *				to reflect the bytes consumed.
+	 * @param arena			Optional arena to allocate the mixer from
+	 *				instead of the heap, reserved with
+	 *				text_arena_size().
 	 * @return			A new MultirotorMixer instance, or nullptr
 	 *				if the text format is bad.
 	 */
 	static MultirotorMixer *from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf,
-					  unsigned &buflen);
+					  unsigned &buflen, MixerArena *arena = nullptr);
+
+	/**
+	 * Arena size of the mixer described by the text header line 'R:'.
+	 *
+	 * @return			The arena size required by from_text(),
+	 *				or 0 if the geometry is unknown.
+	 */
+	static size_t text_arena_size(const char *buf);
+
+	/**
+	 * Factory method for the binary mixer format.
+	 *
+	 * Constructs the mixer and its rotor mix in the arena.
+	 *
+	 * @param control_cb		The callback to invoke when fetching a
+	 *				control value.
+	 * @param cb_handle		Handle passed to the control callback.
+	 * @param record		A binary mixer record of type 'R', validated
+	 *				with binary_arena_size().
+	 * @param arena			The arena to allocate the mixer from.
+	 * @return			A new MultirotorMixer instance, or nullptr
+	 *				if the arena is full.
+	 */
+	static MultirotorMixer *from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *record,
+					    MixerArena &arena);
+
+	/**
+	 * Validate a binary mixer record of type 'R'.
+	 *
+	 * @return			The arena size required by from_binary(),
+	 *				or 0 if the record is invalid.
+	 */
+	static size_t binary_arena_size(const uint8_t *record);
+
+	/**
+	 * Number of floats of the rotor mix and output state for rotor_count rotors.
+	 */
+	static constexpr unsigned STORAGE_SIZE(unsigned rotor_count) { return 5 * rotor_count; }
 
 	unsigned		mix(float *outputs, unsigned space) override;
 
@@ -169,14 +217,23 @@ public:
 
 private:
 	/**
-	 * Computes the gain k by which desaturation_vector has to be multiplied
-	 * in order to unsaturate the output that has the greatest saturation.
-	 * @see also minimize_saturation().
+	 * Find a geometry by its name.
 	 *
-	 * @return desaturation gain
+	 * @return the geometry, or MultirotorGeometry::MAX_GEOMETRY if unknown
+	 */
+	static MultirotorGeometry geometry_from_name(const char *name);
+
+	/**
+	 * Arena size of a mixer with the given geometry, including its storage.
 	 */
-	float compute_desaturation_gain(const float *desaturation_vector, const float *outputs, saturation_status &sat_status,
-					float min_output, float max_output) const;
+	static size_t arena_size(MultirotorGeometry geometry);
+
+	/**
+	 * Sets the motor saturation flags for the outputs after adding k times the desaturation vector,
+	 * given the gain bounds computed by minimize_saturation().
+	 */
+	static void update_desaturation_flags(float k, float k_min_pos, float k_max_pos, float k_min_neg, float k_max_neg,
+					      saturation_status &sat_status);
 
 	/**
 	 * Minimize the saturation of the actuators by adding or substracting a fraction of desaturation_vector.
@@ -189,6 +246,9 @@ private:
 	 * Note that as we only slide along the given axis, in extreme cases outputs can still contain values
 	 * outside of [min_output, max_output].
 	 *
+	 * The gain is computed in closed form from the range of gains for which each output is unsaturated,
+	 * so the outputs are only traversed twice, independent of how many of them are saturated.
+	 *
 	 * @param desaturation_vector vector that is added to the outputs, e.g. thrust_scale
 	 * @param outputs output vector that is modified
 	 * @param sat_status saturation status output
@@ -253,8 +313,17 @@ private:
 	saturation_status		_saturation_status{};
 
 	unsigned			_rotor_count;
-	const Rotor			*_rotors;
+
+	/**
+	 * Rotor mix (structure of arrays), each array is contiguous so that the mixing and desaturation
+	 * loops stream through memory, and a column can directly be used as desaturation vector.
+	 */
+	float				*_rotor_scales{nullptr};	/**< storage of the arrays below and _outputs_prev */
+	const bool			_owns_storage;
+	const float			*_roll_scales{nullptr};
+	const float			*_pitch_scales{nullptr};
+	const float			*_yaw_scales{nullptr};
+	const float			*_thrust_scales{nullptr};
 
 	float 				*_outputs_prev{nullptr};
-	float 				*_tmp_array{nullptr};
 };
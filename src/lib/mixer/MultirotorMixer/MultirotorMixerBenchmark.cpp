@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Benchmark of MultirotorMixer::mix()
+ * Run with make benchmarks
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "MultirotorMixer.hpp"
+
+#include <math.h>
+
+static constexpr unsigned output_max = 16;
+static float actuator_controls[output_max] {};
+
+static int mixer_callback(uintptr_t handle, uint8_t control_group, uint8_t control_index, float &control)
+{
+	control = actuator_controls[control_index];
+	return 0;
+}
+
+/**
+ * Arguments: rotor count, airmode
+ */
+static void MultirotorMixer_mix(benchmark::State &state)
+{
+	const unsigned rotor_count = state.range(0);
+
+	// symmetric geometry, alternating rotation direction
+	MultirotorMixer::Rotor rotors[output_max];
+
+	for (unsigned i = 0; i < rotor_count; ++i) {
+		const float angle = 2.f * (float)M_PI * (i + 0.5f) / rotor_count;
+		rotors[i].roll_scale = -sinf(angle);
+		rotors[i].pitch_scale = cosf(angle);
+		rotors[i].yaw_scale = (i % 2) ? 1.f : -1.f;
+		rotors[i].thrust_scale = 1.f;
+	}
+
+	MultirotorMixer mixer(mixer_callback, 0, rotors, rotor_count);
+	mixer.set_airmode((Mixer::Airmode)state.range(1));
+
+	float actuator_outputs[output_max];
+	int k = 0;
+
+	for (auto _ : state) {
+		// sweep through unsaturated and saturated cases
+		const float phase = (k++ % 10000) * 0.001f;
+		actuator_controls[0] = 0.8f * sinf(phase);
+		actuator_controls[1] = 0.8f * cosf(1.3f * phase);
+		actuator_controls[2] = 0.5f * sinf(0.7f * phase);
+		actuator_controls[3] = 0.5f + 0.5f * sinf(0.1f * phase);
+
+		mixer.mix(actuator_outputs, output_max);
+		benchmark::DoNotOptimize(actuator_outputs);
+	}
+}
+BENCHMARK(MultirotorMixer_mix)->ArgsProduct({{4, 6, 8, 12}, {0, 1, 2}});
@@ -34,11 +34,16 @@
 /**
  * testing binary that runs the multirotor mixer through test cases given
  * via file or stdin and compares the mixer output against expected values.
+ *
+ * With --benchmark it instead measures the execution time of the mixer for
+ * symmetric geometries with 4 to 12 rotors in all airmodes.
  */
 
 #include "MultirotorMixer.hpp"
 
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <math.h>
 
 static const unsigned output_max = 16;
@@ -56,8 +61,62 @@ mixer_callback(uintptr_t handle, uint8_t control_group, uint8_t control_index, f
 	return 0;
 }
 
+static int benchmark()
+{
+	static constexpr int iterations = 100000;
+	static constexpr unsigned rotor_counts[] {4, 6, 8, 12};
+	static constexpr const char *airmode_names[] {"disabled", "roll_pitch", "roll_pitch_yaw"};
+
+	for (unsigned rotor_count : rotor_counts) {
+		// symmetric geometry, alternating rotation direction
+		MultirotorMixer::Rotor rotors[output_max];
+
+		for (unsigned i = 0; i < rotor_count; ++i) {
+			const float angle = 2.f * (float)M_PI * (i + 0.5f) / rotor_count;
+			rotors[i].roll_scale = -sinf(angle);
+			rotors[i].pitch_scale = cosf(angle);
+			rotors[i].yaw_scale = (i % 2) ? 1.f : -1.f;
+			rotors[i].thrust_scale = 1.f;
+		}
+
+		for (int airmode = 0; airmode < 3; ++airmode) {
+			MultirotorMixer mixer(mixer_callback, 0, rotors, rotor_count);
+			mixer.set_airmode((Mixer::Airmode)airmode);
+
+			float actuator_outputs[output_max];
+			float output_sum = 0.f;
+
+			const auto start = std::chrono::steady_clock::now();
+
+			for (int k = 0; k < iterations; ++k) {
+				// sweep through unsaturated and saturated cases
+				const float phase = k * 0.001f;
+				actuator_controls[0] = 0.8f * sinf(phase);
+				actuator_controls[1] = 0.8f * cosf(1.3f * phase);
+				actuator_controls[2] = 0.5f * sinf(0.7f * phase);
+				actuator_controls[3] = 0.5f + 0.5f * sinf(0.1f * phase);
+
+				mixer.mix(actuator_outputs, output_max);
+				output_sum += actuator_outputs[0];
+			}
+
+			const auto end = std::chrono::steady_clock::now();
+			const double elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+			printf("%2u rotors, airmode %-14s: %6.1f ns/mix (%.1f)\n", rotor_count, airmode_names[airmode],
+			       elapsed_ns / iterations, (double)output_sum);
+		}
+	}
+
+	return 0;
+}
+
 int main(int argc, char *argv[])
 {
+	if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+		return benchmark();
+	}
+
 	FILE *file_in = stdin;
 
 	if (argc > 1) {
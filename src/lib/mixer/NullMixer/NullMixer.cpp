@@ -36,6 +36,7 @@
 #include <math.h>
 #include <cstring>
 #include <ctype.h>
+#include <new>
 
 unsigned
 NullMixer::mix(float *outputs, unsigned space)
@@ -49,7 +50,7 @@ NullMixer::mix(float *outputs, unsigned space)
 }
 
 NullMixer *
-NullMixer::from_text(const char *buf, unsigned &buflen)
+NullMixer::from_text(const char *buf, unsigned &buflen, MixerArena *arena)
 {
 	NullMixer *nm = nullptr;
 
@@ -59,9 +60,28 @@ NullMixer::from_text(const char *buf, unsigned &buflen)
 	}
 
 	if ((buflen >= 2) && (buf[0] == 'Z') && (buf[1] == ':')) {
-		nm = new NullMixer;
+		if (arena != nullptr) {
+			void *mixer_memory = arena->allocate(sizeof(NullMixer));
+			nm = (mixer_memory != nullptr) ? new (mixer_memory) NullMixer : nullptr;
+
+		} else {
+			nm = new NullMixer;
+		}
+
 		buflen -= 2;
 	}
 
 	return nm;
 }
+
+NullMixer *
+NullMixer::from_binary(const uint8_t *record, MixerArena &arena)
+{
+	void *mixer_memory = arena.allocate(sizeof(NullMixer));
+
+	if (mixer_memory == nullptr) {
+		return nullptr;
+	}
+
+	return new (mixer_memory) NullMixer;
+}
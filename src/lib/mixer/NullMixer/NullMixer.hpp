@@ -34,6 +34,8 @@
 #pragma once
 
 #include <mixer/Mixer/Mixer.hpp>
+#include <mixer/Mixer/MixerArena.hpp>
+#include <mixer/Mixer/MixerBinary.hpp>
 
 /**
  * Null mixer; returns zero.
@@ -62,10 +64,39 @@ public:
 	 *				the mixer.
 	 * @param buflen		Length of the buffer in bytes, adjusted
 	 *				to reflect the bytes consumed.
+	 * @param arena			Optional arena to allocate the mixer from
+	 *				instead of the heap, reserved with
+	 *				text_arena_size().
 	 * @return			A new NullMixer instance, or nullptr
 	 *				if the text format is bad.
 	 */
-	static NullMixer		*from_text(const char *buf, unsigned &buflen);
+	static NullMixer		*from_text(const char *buf, unsigned &buflen, MixerArena *arena = nullptr);
+
+	/**
+	 * Arena size of the mixer described by the text header line 'Z:'.
+	 *
+	 * @return			The arena size required by from_text().
+	 */
+	static size_t			text_arena_size(const char *buf) { return MixerArena::aligned(sizeof(NullMixer)); }
+
+	/**
+	 * Factory method for the binary mixer format.
+	 *
+	 * @param record		A binary mixer record of type 'Z', validated
+	 *				with binary_arena_size().
+	 * @param arena			The arena to allocate the mixer from.
+	 * @return			A new NullMixer instance, or nullptr
+	 *				if the arena is full.
+	 */
+	static NullMixer		*from_binary(const uint8_t *record, MixerArena &arena);
+
+	/**
+	 * Validate a binary mixer record of type 'Z'.
+	 *
+	 * @return			The arena size required by from_binary(),
+	 *				or 0 if the record is invalid.
+	 */
+	static size_t			binary_arena_size(const uint8_t *record) { return MixerArena::aligned(sizeof(NullMixer)); }
 
 	unsigned			mix(float *outputs, unsigned space) override;
 
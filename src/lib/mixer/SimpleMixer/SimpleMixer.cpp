@@ -39,8 +39,10 @@
 
 #include "SimpleMixer.hpp"
 
+#include <new>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define debug(fmt, args...)	do { } while(0)
 //#define debug(fmt, args...)	do { printf("[mixer] " fmt "\n", ##args); } while(0)
@@ -53,7 +55,7 @@ SimpleMixer::SimpleMixer(ControlCallback control_cb, uintptr_t cb_handle, mixer_
 
 SimpleMixer::~SimpleMixer()
 {
-	if (_pinfo != nullptr) {
+	if (_pinfo != nullptr && _owns_pinfo) {
 		free(_pinfo);
 	}
 }
@@ -145,7 +147,8 @@ SimpleMixer::parse_control_scaler(const char *buf, unsigned &buflen, mixer_scale
 }
 
 SimpleMixer *
-SimpleMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen)
+SimpleMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf, unsigned &buflen,
+		       MixerArena *arena)
 {
 	SimpleMixer *sm = nullptr;
 	mixer_simple_s *mixinfo = nullptr;
@@ -178,7 +181,12 @@ SimpleMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, c
 		goto out;
 	}
 
-	mixinfo = (mixer_simple_s *)malloc(MIXER_SIMPLE_SIZE(inputs));
+	if (arena != nullptr) {
+		mixinfo = (mixer_simple_s *)arena->allocate(MIXER_SIMPLE_SIZE(inputs));
+
+	} else {
+		mixinfo = (mixer_simple_s *)malloc(MIXER_SIMPLE_SIZE(inputs));
+	}
 
 	if (mixinfo == nullptr) {
 		debug("could not allocate memory for mixer info");
@@ -218,7 +226,17 @@ SimpleMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, c
 		}
 	}
 
-	sm = new SimpleMixer(control_cb, cb_handle, mixinfo);
+	if (arena != nullptr) {
+		void *mixer_memory = arena->allocate(sizeof(SimpleMixer));
+
+		if (mixer_memory != nullptr) {
+			sm = new (mixer_memory) SimpleMixer(control_cb, cb_handle, mixinfo);
+			sm->_owns_pinfo = false;
+		}
+
+	} else {
+		sm = new SimpleMixer(control_cb, cb_handle, mixinfo);
+	}
 
 	if (sm != nullptr) {
 		mixinfo = nullptr;
@@ -230,13 +248,96 @@ SimpleMixer::from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, c
 
 out:
 
-	if (mixinfo != nullptr) {
+	/* arena memory is only released as a whole */
+	if (mixinfo != nullptr && arena == nullptr) {
 		free(mixinfo);
 	}
 
 	return sm;
 }
 
+size_t
+SimpleMixer::text_arena_size(const char *buf)
+{
+	unsigned inputs;
+
+	if (sscanf(buf, "M: %u", &inputs) != 1 || inputs == 0) {
+		return 0;
+	}
+
+	return MixerArena::aligned(sizeof(SimpleMixer)) + MixerArena::aligned(MIXER_SIMPLE_SIZE(inputs));
+}
+
+void
+SimpleMixer::binary_scaler(const mixer_binary_scaler_s &binary, mixer_scaler_s &scaler)
+{
+	scaler.negative_scale	= binary.negative_scale / 10000.0f;
+	scaler.positive_scale	= binary.positive_scale / 10000.0f;
+	scaler.offset		= binary.offset / 10000.0f;
+	scaler.min_output	= binary.min_output / 10000.0f;
+	scaler.max_output	= binary.max_output / 10000.0f;
+}
+
+size_t
+SimpleMixer::binary_arena_size(const uint8_t *record)
+{
+	mixer_binary_record_s header;
+	memcpy(&header, record, sizeof(header));
+
+	/* at least 1 input is required */
+	if (header.count == 0) {
+		return 0;
+	}
+
+	if (header.size < sizeof(header) + sizeof(mixer_binary_scaler_s) + header.count * sizeof(mixer_binary_control_s)) {
+		debug("simple mixer record too short");
+		return 0;
+	}
+
+	return MixerArena::aligned(sizeof(SimpleMixer)) + MixerArena::aligned(MIXER_SIMPLE_SIZE(header.count));
+}
+
+SimpleMixer *
+SimpleMixer::from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *record,
+			 MixerArena &arena)
+{
+	mixer_binary_record_s header;
+	memcpy(&header, record, sizeof(header));
+	const uint8_t *payload = record + sizeof(header);
+
+	void *mixer_memory = arena.allocate(sizeof(SimpleMixer));
+	mixer_simple_s *mixinfo = (mixer_simple_s *)arena.allocate(MIXER_SIMPLE_SIZE(header.count));
+
+	if (mixer_memory == nullptr || mixinfo == nullptr) {
+		debug("mixer arena full");
+		return nullptr;
+	}
+
+	mixinfo->control_count = header.count;
+
+	mixer_binary_scaler_s output_scaler;
+	memcpy(&output_scaler, payload, sizeof(output_scaler));
+	payload += sizeof(output_scaler);
+	binary_scaler(output_scaler, mixinfo->output_scaler);
+
+	for (unsigned i = 0; i < header.count; i++) {
+		mixer_binary_control_s control;
+		memcpy(&control, payload, sizeof(control));
+		payload += sizeof(control);
+
+		mixinfo->controls[i].control_group = control.control_group;
+		mixinfo->controls[i].control_index = control.control_index;
+		binary_scaler(control.scaler, mixinfo->controls[i].scaler);
+	}
+
+	SimpleMixer *sm = new (mixer_memory) SimpleMixer(control_cb, cb_handle, mixinfo);
+	sm->_owns_pinfo = false;
+
+	debug("loaded binary mixer with %d input(s)", header.count);
+
+	return sm;
+}
+
 unsigned
 SimpleMixer::mix(float *outputs, unsigned space)
 {
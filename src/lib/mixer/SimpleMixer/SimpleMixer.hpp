@@ -34,6 +34,8 @@
 #pragma once
 
 #include <mixer/Mixer/Mixer.hpp>
+#include <mixer/Mixer/MixerArena.hpp>
+#include <mixer/Mixer/MixerBinary.hpp>
 
 /** simple channel scaler */
 struct mixer_scaler_s {
@@ -97,11 +99,47 @@ public:
 	 *				the mixer.
 	 * @param buflen		Length of the buffer in bytes, adjusted
 	 *				to reflect the bytes consumed.
+	 * @param arena			Optional arena to allocate the mixer from
+	 *				instead of the heap, reserved with
+	 *				text_arena_size().
 	 * @return			A new SimpleMixer instance, or nullptr
 	 *				if the text format is bad.
 	 */
 	static SimpleMixer		*from_text(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const char *buf,
-			unsigned &buflen);
+			unsigned &buflen, MixerArena *arena = nullptr);
+
+	/**
+	 * Arena size of the mixer described by the text header line 'M:'.
+	 *
+	 * @return			The arena size required by from_text(),
+	 *				or 0 if the header is invalid.
+	 */
+	static size_t			text_arena_size(const char *buf);
+
+	/**
+	 * Factory method for the binary mixer format.
+	 *
+	 * Constructs the mixer and its configuration in the arena.
+	 *
+	 * @param control_cb		The callback to invoke when fetching a
+	 *				control value.
+	 * @param cb_handle		Handle passed to the control callback.
+	 * @param record		A binary mixer record of type 'M', validated
+	 *				with binary_arena_size().
+	 * @param arena			The arena to allocate the mixer from.
+	 * @return			A new SimpleMixer instance, or nullptr
+	 *				if the arena is full.
+	 */
+	static SimpleMixer		*from_binary(Mixer::ControlCallback control_cb, uintptr_t cb_handle, const uint8_t *record,
+			MixerArena &arena);
+
+	/**
+	 * Validate a binary mixer record of type 'M'.
+	 *
+	 * @return			The arena size required by from_binary(),
+	 *				or 0 if the record is invalid.
+	 */
+	static size_t			binary_arena_size(const uint8_t *record);
 
 	unsigned			mix(float *outputs, unsigned space) override;
 
@@ -140,9 +178,11 @@ private:
 	static int			scale_check(struct mixer_scaler_s &scaler);
 
 	static int parse_output_scaler(const char *buf, unsigned &buflen, mixer_scaler_s &scaler);
+	static void binary_scaler(const mixer_binary_scaler_s &binary, mixer_scaler_s &scaler);
 	static int parse_control_scaler(const char *buf, unsigned &buflen, mixer_scaler_s &scaler, uint8_t &control_group,
 					uint8_t &control_index);
 
 	mixer_simple_s			*_pinfo;
+	bool				_owns_pinfo{true};	///< false if _pinfo is allocated in a MixerArena
 
 };
@@ -42,6 +42,7 @@
 #include <ctype.h>
 
 #include "mixer_load.h"
+#include "Mixer/MixerBinary.hpp"
 
 int load_mixer_file(const char *fname, char *buf, unsigned maxlen)
 {
@@ -96,6 +97,15 @@ int load_mixer_file(const char *fname, char *buf, unsigned maxlen)
 			}
 		}
 
+		/* terminate the last line of a file without a trailing newline, the mixer parsers
+		 * only accept complete lines (the binary mixer converter accepts it as well) */
+		const size_t len = strlen(line);
+
+		if ((line[len - 1] != '\n') && (line[len - 1] != '\r') && (len + 1 < sizeof(line))) {
+			line[len] = '\n';
+			line[len + 1] = '\0';
+		}
+
 		/* if the line is too long to fit in the buffer, bail */
 		if ((strlen(line) + strlen(buf) + 1) >= maxlen) {
 			printf("line too long\n");
@@ -110,3 +120,39 @@ int load_mixer_file(const char *fname, char *buf, unsigned maxlen)
 	fclose(fp);
 	return 0;
 }
+
+int load_mixer_file_binary(const char *fname, uint8_t *buf, unsigned maxlen)
+{
+	FILE *fp = fopen(fname, "rb");
+
+	if (fp == nullptr) {
+		printf("file not found\n");
+		return -1;
+	}
+
+	int ret = 0;
+	const size_t header_size = sizeof(mixer_binary_header_s);
+
+	if ((maxlen >= header_size) && (fread(buf, 1, header_size, fp) == header_size)) {
+		const unsigned size = mixer_binary_size(buf);
+
+		if (size > maxlen) {
+			printf("binary mixer too large\n");
+			ret = -1;
+
+		} else if (size > 0) {
+			const size_t remaining = size - header_size;
+
+			if (fread(buf + header_size, 1, remaining, fp) == remaining) {
+				ret = size;
+
+			} else {
+				printf("binary mixer truncated\n");
+				ret = -1;
+			}
+		}
+	}
+
+	fclose(fp);
+	return ret;
+}
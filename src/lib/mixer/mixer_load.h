@@ -46,6 +46,17 @@ __BEGIN_DECLS
 
 __EXPORT int load_mixer_file(const char *fname, char *buf, unsigned maxlen);
 
+/**
+ * Read a precompiled binary mixer file (see Mixer/MixerBinary.hpp).
+ *
+ * @param fname		The mixer file.
+ * @param buf		Buffer for the binary mixer blob.
+ * @param maxlen	Size of the buffer.
+ * @return		The size of the blob, 0 if the file is not a binary
+ *			mixer file, negative on error.
+ */
+__EXPORT int load_mixer_file_binary(const char *fname, uint8_t *buf, unsigned maxlen);
+
 __END_DECLS
 
 #endif
@@ -33,6 +33,7 @@
 
 #include "mixer_module.hpp"
 
+#include <lib/mixer/Mixer/MixerBinary.hpp>
 #include <lib/mixer/MultirotorMixer/MultirotorMixer.hpp>
 
 #include <uORB/PublicationQueued.hpp>
@@ -88,6 +89,7 @@ void MixingOutput::printStatus() const
 {
 	perf_print_counter(_control_latency_perf);
 	PX4_INFO("Switched to rate_ctrl work queue: %i", (int)_wq_switched);
+	PX4_INFO("Primary control group: %i", (int)_primary_group);
 	PX4_INFO("Mixer loaded: %s", _mixers ? "yes" : "no");
 	PX4_INFO("Driver instance: %i", _driver_instance);
 
@@ -143,13 +145,20 @@ bool MixingOutput::updateSubscriptions(bool allow_wq_switch)
 			}
 		}
 
-		// register callback to all required actuator control groups
+		// register a callback only to the primary (lowest) required actuator control group, the other groups
+		// are sampled whenever the primary group updates, or after SECONDARY_GROUPS_DEADLINE at the latest
+		_primary_group = -1;
+
 		for (unsigned i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
 			if (_groups_required & (1 << i)) {
 				PX4_DEBUG("subscribe to actuator_controls_%d", i);
 
-				if (!_control_subs[i].registerCallback()) {
-					PX4_ERR("actuator_controls_%d register callback failed!", i);
+				if (_primary_group < 0) {
+					_primary_group = (int8_t)i;
+
+					if (!_control_subs[i].registerCallback()) {
+						PX4_ERR("actuator_controls_%d register callback failed!", i);
+					}
 				}
 			}
 		}
@@ -393,12 +402,19 @@ bool MixingOutput::update()
 	/* now return the outputs to the driver */
 	if (_interface.updateOutputs(stop_motors, _current_output_value, mixed_num_outputs, n_updates)) {
 		actuator_outputs_s actuator_outputs{};
+		actuator_outputs.timestamp_sample = controlsTimestampSample();
 		setAndPublishActuatorOutputs(mixed_num_outputs, actuator_outputs);
 
 		publishMixerStatus(actuator_outputs);
 		updateLatencyPerfCounter(actuator_outputs);
 	}
 
+	// secondary groups don't trigger an update, make sure they still get applied if the primary group stops
+	if (_scheduling_policy == SchedulingPolicy::Auto && _primary_group >= 0
+	    && (_groups_subscribed & ~(1u << _primary_group)) != 0) {
+		_interface.ScheduleDelayed(SECONDARY_GROUPS_DEADLINE);
+	}
+
 	handleCommands();
 
 	return true;
@@ -432,8 +448,8 @@ MixingOutput::publishMixerStatus(const actuator_outputs_s &actuator_outputs)
 	}
 }
 
-void
-MixingOutput::updateLatencyPerfCounter(const actuator_outputs_s &actuator_outputs)
+hrt_abstime
+MixingOutput::controlsTimestampSample() const
 {
 	// use first valid timestamp_sample for latency tracking
 	for (int i = 0; i < actuator_controls_s::NUM_ACTUATOR_CONTROL_GROUPS; i++) {
@@ -441,10 +457,19 @@ MixingOutput::updateLatencyPerfCounter(const actuator_outputs_s &actuator_output
 		const hrt_abstime &timestamp_sample = _controls[i].timestamp_sample;
 
 		if (required && (timestamp_sample > 0)) {
-			perf_set_elapsed(_control_latency_perf, actuator_outputs.timestamp - timestamp_sample);
-			break;
+			return timestamp_sample;
 		}
 	}
+
+	return 0;
+}
+
+void
+MixingOutput::updateLatencyPerfCounter(const actuator_outputs_s &actuator_outputs)
+{
+	if (actuator_outputs.timestamp_sample > 0) {
+		perf_set_elapsed(_control_latency_perf, actuator_outputs.timestamp - actuator_outputs.timestamp_sample);
+	}
 }
 
 void
@@ -543,6 +568,16 @@ void MixingOutput::resetMixer()
 }
 
 int MixingOutput::loadMixer(const char *buf, unsigned len)
+{
+	return loadMixers(buf, len, false);
+}
+
+int MixingOutput::loadMixerBinary(const void *buf, unsigned len)
+{
+	return loadMixers(buf, len, true);
+}
+
+int MixingOutput::loadMixers(const void *buf, unsigned len, bool binary)
 {
 	if (_mixers == nullptr) {
 		_mixers = new MixerGroup();
@@ -553,7 +588,14 @@ int MixingOutput::loadMixer(const char *buf, unsigned len)
 		return -ENOMEM;
 	}
 
-	int ret = _mixers->load_from_buf(controlCallback, (uintptr_t)this, buf, len);
+	int ret;
+
+	if (binary) {
+		ret = _mixers->load_from_binary(controlCallback, (uintptr_t)this, buf, len, _mixer_arena);
+
+	} else {
+		ret = _mixers->load_from_buf(controlCallback, (uintptr_t)this, (const char *)buf, len, _mixer_arena);
+	}
 
 	if (ret != 0) {
 		PX4_ERR("mixer load failed with %d", ret);
@@ -564,7 +606,13 @@ int MixingOutput::loadMixer(const char *buf, unsigned len)
 	}
 
 	_mixers->groups_required(_groups_required);
-	PX4_DEBUG("loaded mixers \n%s\n", buf);
+
+	if (binary) {
+		PX4_DEBUG("loaded %u binary mixers (%u bytes)", _mixers->count(), (unsigned)_mixer_arena.used());
+
+	} else {
+		PX4_DEBUG("loaded mixers \n%s\n", (const char *)buf);
+	}
 
 	updateParams();
 	_interface.mixerChanged();
@@ -579,7 +627,11 @@ void MixingOutput::handleCommands()
 
 	switch ((Command::Type)_command.command.load()) {
 	case Command::Type::loadMixer:
-		_command.result = loadMixer(_command.mixer_buf, _command.mixer_buf_length);
+		_command.result = loadMixers(_command.mixer_buf, _command.mixer_buf_length, false);
+		break;
+
+	case Command::Type::loadMixerBinary:
+		_command.result = loadMixers(_command.mixer_buf, _command.mixer_buf_length, true);
 		break;
 
 	case Command::Type::resetMixer:
@@ -620,6 +672,23 @@ void MixingOutput::resetMixerThreadSafe()
 }
 
 int MixingOutput::loadMixerThreadSafe(const char *buf, unsigned len)
+{
+	return loadMixerCommandThreadSafe(Command::Type::loadMixer, buf, len);
+}
+
+int MixingOutput::loadMixerBinaryThreadSafe(const void *buf)
+{
+	const unsigned len = mixer_binary_size(buf);
+
+	if (len == 0) {
+		PX4_ERR("invalid binary mixer");
+		return -EINVAL;
+	}
+
+	return loadMixerCommandThreadSafe(Command::Type::loadMixerBinary, buf, len);
+}
+
+int MixingOutput::loadMixerCommandThreadSafe(Command::Type type, const void *buf, unsigned len)
 {
 	if ((Command::Type)_command.command.load() != Command::Type::None) {
 		// Cannot happen, because we expect only one other thread to call this.
@@ -632,7 +701,7 @@ int MixingOutput::loadMixerThreadSafe(const char *buf, unsigned len)
 
 	_command.mixer_buf = buf;
 	_command.mixer_buf_length = len;
-	_command.command.store((int)Command::Type::loadMixer);
+	_command.command.store((int)type);
 
 	_interface.ScheduleNow();
 
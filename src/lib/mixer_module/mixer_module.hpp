@@ -94,7 +94,7 @@ public:
 
 	enum class SchedulingPolicy {
 		Disabled, ///< Do not drive scheduling (the module needs to call ScheduleOnInterval() for example)
-		Auto ///< Drive scheduling based on subscribed actuator controls topics (via uORB callbacks)
+		Auto ///< Drive scheduling based on the primary (lowest) subscribed actuator controls group (via uORB callbacks)
 	};
 
 	/**
@@ -152,6 +152,15 @@ public:
 
 	int loadMixer(const char *buf, unsigned len);
 
+	/**
+	 * Load (append) mixers from a precompiled binary mixer blob, called from another thread.
+	 * This is thread-safe, as long as only one other thread at a time calls this.
+	 * @return 0 on success, <0 error otherwise
+	 */
+	int loadMixerBinaryThreadSafe(const void *buf);
+
+	int loadMixerBinary(const void *buf, unsigned len);
+
 	const actuator_armed_s &armed() const { return _armed; }
 
 	MixerGroup *mixers() const { return _mixers; }
@@ -195,6 +204,11 @@ private:
 	void publishMixerStatus(const actuator_outputs_s &actuator_outputs);
 	void updateLatencyPerfCounter(const actuator_outputs_s &actuator_outputs);
 
+	/**
+	 * Sensor sample timestamp of the first required control group, 0 if unknown
+	 */
+	hrt_abstime controlsTimestampSample() const;
+
 	static int controlCallback(uintptr_t handle, uint8_t control_group, uint8_t control_index, float &input);
 
 	enum class MotorOrdering : int32_t {
@@ -206,15 +220,19 @@ private:
 		enum class Type : int {
 			None,
 			resetMixer,
-			loadMixer
+			loadMixer,
+			loadMixerBinary
 		};
 		px4::atomic<int> command{(int)Type::None};
-		const char *mixer_buf;
+		const void *mixer_buf;
 		unsigned mixer_buf_length;
 		int result;
 	};
 	Command _command; ///< incoming commands (from another thread)
 
+	int loadMixerCommandThreadSafe(Command::Type type, const void *buf, unsigned len);
+	int loadMixers(const void *buf, unsigned len, bool binary);
+
 	/**
 	 * Reorder outputs according to _param_mot_ordering
 	 * @param values values to reorder
@@ -250,8 +268,12 @@ private:
 	bool _ignore_lockdown{false}; ///< if true, ignore the _armed.lockdown flag (for HIL outputs)
 
 	MixerGroup *_mixers{nullptr};
+	MixerArena _mixer_arena; ///< memory for the loaded mixers, kept across reloads to avoid heap fragmentation
 	uint32_t _groups_required{0};
 	uint32_t _groups_subscribed{1u << 31}; ///< initialize to a different value than _groups_required and outside of (1 << NUM_ACTUATOR_CONTROL_GROUPS)
+	int8_t _primary_group{-1}; ///< control group driving the scheduling (-1 if none)
+
+	static constexpr uint32_t SECONDARY_GROUPS_DEADLINE = 20000; ///< [us] max delay of a secondary group update if the primary group stops
 
 	const SchedulingPolicy _scheduling_policy;
 	const bool _support_esc_calibration;
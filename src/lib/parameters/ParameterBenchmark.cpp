@@ -0,0 +1,72 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Benchmarks of the parameter lookup
+ * Run with make benchmarks
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <lib/parameters/param.h>
+
+/**
+ * Lookup by name, used by modules without generated parameter handles
+ */
+static void param_find_existing(benchmark::State &state)
+{
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(param_find_no_notification("CP_DIST"));
+	}
+}
+BENCHMARK(param_find_existing);
+
+static void param_find_missing(benchmark::State &state)
+{
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(param_find_no_notification("NOT_A_PARAM"));
+	}
+}
+BENCHMARK(param_find_missing);
+
+static void param_get_float(benchmark::State &state)
+{
+	const param_t param = param_find("CP_DIST");
+	float value = 0.f;
+
+	for (auto _ : state) {
+		param_get(param, &value);
+		benchmark::DoNotOptimize(value);
+	}
+}
+BENCHMARK(param_get_float);
@@ -78,6 +78,31 @@ TEST_F(ParameterTest, testParamReadWrite)
 }
 
 
+TEST_F(ParameterTest, testParamGetValues)
+{
+	// GIVEN a parameter handle and the current values
+	param_t param = param_handle(px4::params::CP_DIST);
+	const param_value_u *values = param_get_values();
+	ASSERT_NE(nullptr, values);
+
+	// THEN the current value is the default
+	EXPECT_FLOAT_EQ(-1.f, values[param].f);
+
+	// WHEN: we set the parameter
+	float value = 42.f;
+	EXPECT_EQ(0, param_set(param, &value));
+
+	// THEN: the current value follows
+	EXPECT_FLOAT_EQ(42.f, values[param].f);
+
+	// WHEN: we reset the parameter
+	EXPECT_EQ(0, param_reset(param));
+
+	// THEN: it's back to the default
+	EXPECT_FLOAT_EQ(-1.f, values[param].f);
+}
+
+
 TEST_F(ParameterTest, testUorbSendReceive)
 {
 	// GIVEN: a uOrb message
@@ -105,3 +130,21 @@ TEST_F(ParameterTest, testUorbSendReceive)
 	// AND: all the bytes should be equal
 	EXPECT_EQ(0, memcmp(&message, &obstacle_distance, sizeof(message)));
 }
+
+
+TEST_F(ParameterTest, testParamFind)
+{
+	// GIVEN: all known parameters
+	for (unsigned i = 0; i < param_count(); i++) {
+		param_t param = param_for_index(i);
+		const char *name = param_name(param);
+
+		// WHEN: we look the parameter up by name
+		// THEN: the hash lookup should return the same handle
+		EXPECT_EQ(param, param_find_no_notification(name)) << name;
+	}
+
+	// AND: unknown names should not be found
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification("CP_DIST_X"));
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification(""));
+}
@@ -53,7 +53,6 @@
 
 #include <parameters/param.h>
 
-#include "systemlib/uthash/utarray.h"
 #include <parameters/tinybson/tinybson.h>
 #include "flashparams.h"
 #include "flashfs.h"
@@ -65,19 +64,9 @@
 #endif
 
 
-/**
- * Storage for modified parameters.
- */
-struct param_wbuf_s {
-	union param_value_u     val;
-	param_t                 param;
-	bool                    unsaved;
-};
-
 static int
 param_export_internal(bool only_unsaved)
 {
-	struct param_wbuf_s *s = nullptr;
 	struct bson_encoder_s encoder;
 	int     result = -1;
 
@@ -85,46 +74,45 @@ param_export_internal(bool only_unsaved)
 
 	bson_encoder_init_buf(&encoder, nullptr, 0);
 
-	/* no modified parameters -> we are done */
-	if (param_values == nullptr) {
-		result = 0;
-		goto out;
-	}
-
-	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != nullptr) {
+	for (unsigned index = 0; index < param_count(); index++) {
 
+		const param_t param = param_for_index(index);
 		int32_t i;
 		float   f;
 
+		if (param_value_is_default(param)) {
+			continue;
+		}
+
 		/*
 		 * If we are only saving values changed since last save, and this
 		 * one hasn't, then skip it
 		 */
-		if (only_unsaved && !s->unsaved) {
+		if (only_unsaved && !param_value_unsaved(param)) {
 			continue;
 		}
 
-		s->unsaved = false;
+		param_mark_saved_external(param);
 
 		/* append the appropriate BSON type object */
 
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 
 		case PARAM_TYPE_INT32:
-			i = s->val.i;
+			i = *(const int32_t *)param_get_value_ptr_external(param);
 
-			if (bson_encoder_append_int(&encoder, param_name(s->param), i)) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_int(&encoder, param_name(param), i)) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
 			break;
 
 		case PARAM_TYPE_FLOAT:
-			f = s->val.f;
+			f = *(const float *)param_get_value_ptr_external(param);
 
-			if (bson_encoder_append_double(&encoder, param_name(s->param), f)) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_double(&encoder, param_name(param), f)) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
@@ -132,11 +120,11 @@ param_export_internal(bool only_unsaved)
 
 		case PARAM_TYPE_STRUCT ... PARAM_TYPE_STRUCT_MAX:
 			if (bson_encoder_append_binary(&encoder,
-						       param_name(s->param),
+						       param_name(param),
 						       BSON_BIN_BINARY,
-						       param_size(s->param),
-						       param_get_value_ptr_external(s->param))) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+						       param_size(param),
+						       param_get_value_ptr_external(param))) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
@@ -202,6 +202,17 @@ __EXPORT const char	*param_name(param_t param);
  */
 __EXPORT bool		param_is_volatile(param_t param);
 
+/**
+ * Obtain the parameter store generation.
+ *
+ * The generation is incremented when a parameter write starts and again when
+ * it completes, so it is odd while a write is in progress. Readers can use it
+ * to detect that values changed while they were reading them without locking.
+ *
+ * @return		The current generation.
+ */
+__EXPORT uint32_t	param_generation(void);
+
 /**
  * Test whether a parameter's value has changed from the default.
  *
@@ -378,6 +389,9 @@ __EXPORT const char	*param_get_default_file(void);
  * Note: this method requires a large amount of stack size!
  *
  * This function saves all parameters with non-default values.
+ * When saving to a file, only the parameters changed since the last save are
+ * appended to it, and the file is rewritten once the journal gets too long or
+ * a parameter was reset.
  *
  * @return		Zero on success.
  */
@@ -419,6 +433,16 @@ union param_value_u {
 	float		f;
 };
 
+/**
+ * Get the current values of all INT32 and FLOAT parameters, indexed by parameter handle.
+ *
+ * The values can be read without locking, use param_generation() to detect a concurrent write.
+ * The entries of struct parameters are not valid.
+ *
+ * @return		Pointer to the values, or nullptr if not supported by the parameter storage.
+ */
+__EXPORT const union param_value_u *param_get_values(void);
+
 /**
  * Static parameter definition structure.
  *
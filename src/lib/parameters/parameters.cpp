@@ -51,12 +51,12 @@
 
 #include <drivers/drv_hrt.h>
 #include <lib/perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/sem.h>
 #include <px4_platform_common/shutdown.h>
-#include <systemlib/uthash/utarray.h>
 
 using namespace time_literals;
 
@@ -82,6 +82,18 @@ static const char *param_default_file = PX4_ROOTFSDIR"/eeprom/parameters";
 
 static char *param_user_file = nullptr;
 
+/**
+ * The default parameter file is a journal: a full BSON snapshot followed by
+ * BSON documents holding only the parameters changed since the previous save.
+ * It is rewritten (compacted) after this many appended documents.
+ */
+#ifndef PARAM_JOURNAL_MAX_ENTRIES
+#define PARAM_JOURNAL_MAX_ENTRIES 32
+#endif
+
+/** number of documents appended to the default file since the last full save, -1 forces a full save */
+static int param_journal_entries = -1;
+
 #ifdef __PX4_QURT
 #define PARAM_OPEN	px4_open
 #define PARAM_CLOSE	px4_close
@@ -105,16 +117,6 @@ static bool autosave_disabled = false;
 static const param_info_s *param_info_base = (const param_info_s *) &px4_parameters;
 #define	param_info_count px4_parameters.param_count
 
-/**
- * Storage for modified parameters.
- */
-struct param_wbuf_s {
-	union param_value_u	val;
-	param_t			param;
-	bool			unsaved;
-};
-
-
 uint8_t  *param_changed_storage = nullptr;
 int size_param_changed_storage_bytes = 0;
 const int bits_per_allocation_unit  = (sizeof(*param_changed_storage) * 8);
@@ -140,11 +142,61 @@ get_param_info_count()
 	return param_info_count;
 }
 
-/** flexible array holding modified parameter values */
-UT_array *param_values{nullptr};
+/**
+ * Storage for modified parameters, indexed by parameter handle.
+ *
+ * A value slot is only valid while the parameter's bit in param_modified is set.
+ * Writers update the slot before setting the bit, so param_get() can read
+ * INT32 and FLOAT values without taking the lock.
+ */
+static union param_value_u *param_values{nullptr};
+
+/**
+ * Current INT32 and FLOAT values of all parameters (modified or default), indexed by parameter handle.
+ * Kept in sync with param_values by the writers, read without locking by param_get() and param_get_values().
+ */
+static union param_value_u *param_current{nullptr};
+static px4::atomic<uint32_t> *param_modified{nullptr}; ///< bitset of parameters with a value set
+static px4::atomic<uint32_t> *param_unsaved{nullptr}; ///< bitset of modified parameters not yet saved
+static unsigned param_bitset_words = 0;
+
+/** incremented when a value write starts and again when it completes, odd while a write is in progress */
+static px4::atomic<uint32_t> param_generation_counter{0};
 
-/** array info for the modified parameters array */
-const UT_icd param_icd = {sizeof(param_wbuf_s), nullptr, nullptr, nullptr};
+/** range of parameters changed since the last parameter_update notification, first > last if none */
+static param_t param_changed_first = PARAM_INVALID;
+static param_t param_changed_last = 0;
+
+/** extend the pending notification range, needs the writer lock */
+static void
+param_mark_changed(param_t first, param_t last)
+{
+	if (first < param_changed_first) {
+		param_changed_first = first;
+	}
+
+	if (last > param_changed_last) {
+		param_changed_last = last;
+	}
+}
+
+static inline bool
+param_bit_test(const px4::atomic<uint32_t> *bitset, param_t param)
+{
+	return bitset && (bitset[param / 32].load() & (1u << (param % 32)));
+}
+
+static inline void
+param_bit_set(px4::atomic<uint32_t> *bitset, param_t param)
+{
+	bitset[param / 32].fetch_or(1u << (param % 32));
+}
+
+static inline void
+param_bit_clear(px4::atomic<uint32_t> *bitset, param_t param)
+{
+	bitset[param / 32].fetch_and(~(1u << (param % 32)));
+}
 
 #if !defined(PARAM_NO_ORB)
 /** parameter update topic handle */
@@ -153,13 +205,16 @@ static unsigned int param_instance = 0;
 #endif
 
 static void param_set_used_internal(param_t param);
+static void param_current_reset(param_t param);
 
 static param_t param_find_internal(const char *name, bool notification);
 
+static int param_import_internal(int fd, bool mark_saved, int *documents = nullptr);
+
 // the following implements an RW-lock using 2 semaphores (used as mutexes). It gives
 // priority to readers, meaning a writer could suffer from starvation, but in our use-case
 // we only have short periods of reads and writes are rare.
-static px4_sem_t param_sem; ///< this protects against concurrent access to param_values
+static px4_sem_t param_sem; ///< this serializes writers of param_values (and readers of struct values)
 static int reader_lock_holders = 0;
 static px4_sem_t reader_lock_holders_lock; ///< this protects against concurrent access to reader_lock_holders
 
@@ -237,6 +292,23 @@ param_init()
 	param_find_perf = perf_alloc(PC_ELAPSED, "param_find");
 	param_get_perf = perf_alloc(PC_ELAPSED, "param_get");
 	param_set_perf = perf_alloc(PC_ELAPSED, "param_set");
+
+	/* dense modified value storage, never freed as param_get() reads it without locking */
+	const unsigned count = get_param_info_count();
+	param_bitset_words = (count + 31) / 32;
+	param_values = new param_value_u[count] {};
+	param_current = new param_value_u[count] {};
+	param_modified = new px4::atomic<uint32_t>[param_bitset_words];
+	param_unsaved = new px4::atomic<uint32_t>[param_bitset_words];
+
+	if (param_values == nullptr || param_current == nullptr || param_modified == nullptr || param_unsaved == nullptr) {
+		PX4_ERR("failed to allocate modified values array");
+		return;
+	}
+
+	for (param_t param = 0; param < count; param++) {
+		param_current_reset(param);
+	}
 }
 
 /**
@@ -253,48 +325,26 @@ handle_in_range(param_t param)
 }
 
 /**
- * Compare two modifid parameter structures to determine ordering.
+ * Test whether a parameter has a modified value.
  *
- * This function is suitable for passing to qsort or bsearch.
+ * @param param			The parameter being tested.
+ * @return			True if param_values holds a value for the parameter.
  */
-static int
-param_compare_values(const void *a, const void *b)
+static bool
+param_find_changed(param_t param)
 {
-	struct param_wbuf_s *pa = (struct param_wbuf_s *)a;
-	struct param_wbuf_s *pb = (struct param_wbuf_s *)b;
-
-	if (pa->param < pb->param) {
-		return -1;
-	}
-
-	if (pa->param > pb->param) {
-		return 1;
-	}
-
-	return 0;
+	return handle_in_range(param) && param_bit_test(param_modified, param);
 }
 
 /**
- * Locate the modified parameter structure for a parameter, if it exists.
- *
- * @param param			The parameter being searched.
- * @return			The structure holding the modified value, or
- *				nullptr if the parameter has not been modified.
+ * Set the current value of an INT32 or FLOAT parameter back to its default.
  */
-static param_wbuf_s *
-param_find_changed(param_t param)
+static void
+param_current_reset(param_t param)
 {
-	param_wbuf_s	*s = nullptr;
-
-	param_assert_locked();
-
-	if (param_values != nullptr) {
-		param_wbuf_s key{};
-		key.param = param;
-		s = (param_wbuf_s *)utarray_find(param_values, &key, param_compare_values);
+	if (param_current && (param_type(param) == PARAM_TYPE_INT32 || param_type(param) == PARAM_TYPE_FLOAT)) {
+		param_current[param].i = param_info_base[param].val.i;
 	}
-
-	return s;
 }
 
 static void
@@ -302,8 +352,26 @@ _param_notify_changes()
 {
 #if !defined(PARAM_NO_ORB)
 	parameter_update_s pup = {};
-	pup.timestamp = hrt_absolute_time();
+
+	param_lock_writer();
+
+	if (param_changed_first <= param_changed_last) {
+		pup.changed_first = param_changed_first;
+		pup.changed_last = param_changed_last;
+
+	} else {
+		// explicit notification without a tracked change, report everything
+		pup.changed_first = 0;
+		pup.changed_last = get_param_info_count() - 1;
+	}
+
+	param_changed_first = PARAM_INVALID;
+	param_changed_last = 0;
 	pup.instance = param_instance++;
+	param_unlock_writer();
+
+	pup.generation = param_generation_counter.load();
+	pup.timestamp = hrt_absolute_time();
 
 	/*
 	 * If we don't have a handle to our topic, create one now; otherwise
@@ -330,34 +398,16 @@ param_find_internal(const char *name, bool notification)
 {
 	perf_begin(param_find_perf);
 
-	param_t middle;
-	param_t front = 0;
-	param_t last = get_param_info_count();
-
-	/* perform a binary search of the known parameters */
-
-	while (front <= last) {
-		middle = front + (last - front) / 2;
-		int ret = strcmp(name, param_info_base[middle].name);
-
-		if (ret == 0) {
-			if (notification) {
-				param_set_used_internal(middle);
-			}
-
-			perf_end(param_find_perf);
-			return middle;
+	/* perfect hash lookup, a single compare rejects unknown names */
+	const param_t param = px4_parameters_hash_lookup(name);
 
-		} else if (middle == front) {
-			/* An end point has been hit, but there has been no match */
-			break;
-
-		} else if (ret < 0) {
-			last = middle;
-
-		} else {
-			front = middle;
+	if (handle_in_range(param) && strcmp(name, param_info_base[param].name) == 0) {
+		if (notification) {
+			param_set_used_internal(param);
 		}
+
+		perf_end(param_find_perf);
+		return param;
 	}
 
 	perf_end(param_find_perf);
@@ -494,25 +544,28 @@ param_is_volatile(param_t param)
 	return handle_in_range(param) ? param_info_base[param].volatile_param : false;
 }
 
+uint32_t
+param_generation()
+{
+	return param_generation_counter.load();
+}
+
+const union param_value_u *
+param_get_values()
+{
+	return param_current;
+}
+
 bool
 param_value_is_default(param_t param)
 {
-	struct param_wbuf_s *s;
-	param_lock_reader();
-	s = param_find_changed(param);
-	param_unlock_reader();
-	return s == nullptr;
+	return !param_find_changed(param);
 }
 
 bool
 param_value_unsaved(param_t param)
 {
-	struct param_wbuf_s *s;
-	param_lock_reader();
-	s = param_find_changed(param);
-	bool ret = s && s->unsaved;
-	param_unlock_reader();
-	return ret;
+	return param_find_changed(param) && param_bit_test(param_unsaved, param);
 }
 
 param_type_t
@@ -563,10 +616,8 @@ param_get_value_ptr(param_t param)
 		const union param_value_u *v;
 
 		/* work out whether we're fetching the default or a written value */
-		struct param_wbuf_s *s = param_find_changed(param);
-
-		if (s != nullptr) {
-			v = &s->val;
+		if (param_find_changed(param)) {
+			v = &param_values[param];
 
 		} else {
 			v = &param_info_base[param].val;
@@ -590,7 +641,19 @@ param_get(param_t param, void *val)
 {
 	int result = -1;
 
-	param_lock_reader();
+	// INT32 and FLOAT values are read lock-free from the current values
+	if (val && param_current && (param_type(param) == PARAM_TYPE_INT32 || param_type(param) == PARAM_TYPE_FLOAT)) {
+		memcpy(val, &param_current[param], sizeof(int32_t));
+		return 0;
+	}
+
+	// struct values need the reader lock
+	const bool lock = (param_type(param) >= PARAM_TYPE_STRUCT && param_type(param) <= PARAM_TYPE_STRUCT_MAX);
+
+	if (lock) {
+		param_lock_reader();
+	}
+
 	perf_begin(param_get_perf);
 
 	const void *v = param_get_value_ptr(param);
@@ -601,7 +664,10 @@ param_get(param_t param, void *val)
 	}
 
 	perf_end(param_get_perf);
-	param_unlock_reader();
+
+	if (lock) {
+		param_unlock_reader();
+	}
 
 	return result;
 }
@@ -706,68 +772,56 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 	bool params_changed = false;
 
 	param_lock_writer();
+	param_generation_counter.fetch_add(1);
 	perf_begin(param_set_perf);
 
-	if (param_values == nullptr) {
-		utarray_new(param_values, &param_icd);
-	}
-
-	if (param_values == nullptr) {
+	if (param_values == nullptr || param_current == nullptr || param_modified == nullptr || param_unsaved == nullptr) {
 		PX4_ERR("failed to allocate modified values array");
 		goto out;
 	}
 
 	if (handle_in_range(param)) {
 
-		param_wbuf_s *s = param_find_changed(param);
-
-		if (s == nullptr) {
-
-			/* construct a new parameter */
-			param_wbuf_s buf = {};
-			buf.param = param;
-
-			params_changed = true;
+		/* the slot holds a stale value if the parameter is not modified */
+		union param_value_u *s = &param_values[param];
+		const bool modified = param_find_changed(param);
 
-			/* add it to the array and sort */
-			utarray_push_back(param_values, &buf);
-			utarray_sort(param_values, param_compare_values);
-
-			/* find it after sorting */
-			s = param_find_changed(param);
-		}
+		params_changed = !modified;
 
 		/* update the changed value */
 		switch (param_type(param)) {
 
 		case PARAM_TYPE_INT32:
-			params_changed = params_changed || s->val.i != *(int32_t *)val;
-			s->val.i = *(int32_t *)val;
+			params_changed = params_changed || s->i != *(int32_t *)val;
+			s->i = *(int32_t *)val;
+			param_current[param].i = s->i;
 			break;
 
 		case PARAM_TYPE_FLOAT:
-			params_changed = params_changed || fabsf(s->val.f - * (float *)val) > FLT_EPSILON;
-			s->val.f = *(float *)val;
+			params_changed = params_changed || fabsf(s->f - * (float *)val) > FLT_EPSILON;
+			s->f = *(float *)val;
+			param_current[param].f = s->f;
 			break;
 
 		case PARAM_TYPE_STRUCT ... PARAM_TYPE_STRUCT_MAX:
-			if (s->val.p == nullptr) {
+			/* struct storage is kept across resets and reused */
+			if (s->p == nullptr) {
 				size_t psize = param_size(param);
 
 				if (psize > 0) {
-					s->val.p = malloc(psize);
+					s->p = malloc(psize);
 
 				} else {
-					s->val.p = nullptr;
+					s->p = nullptr;
 				}
 
-				if (s->val.p == nullptr) {
+				if (s->p == nullptr) {
 					PX4_ERR("failed to allocate parameter storage");
 					goto out;
 				}
 			}
 
-			memcpy(s->val.p, val, param_size(param));
+			memcpy(s->p, val, param_size(param));
 			params_changed = true;
 			break;
 
@@ -775,7 +829,22 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 			goto out;
 		}
 
-		s->unsaved = !mark_saved;
+		if (mark_saved) {
+			param_bit_clear(param_unsaved, param);
+
+		} else {
+			param_bit_set(param_unsaved, param);
+		}
+
+		/* publish the slot only after the value has been written */
+		if (!modified) {
+			param_bit_set(param_modified, param);
+		}
+
+		if (params_changed) {
+			param_mark_changed(param, param);
+		}
+
 		result = 0;
 
 		if (!mark_saved) { // this is false when importing parameters
@@ -785,6 +854,7 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 
 out:
 	perf_end(param_set_perf);
+	param_generation_counter.fetch_add(1);
 	param_unlock_writer();
 
 	/*
@@ -808,6 +878,13 @@ const void *param_get_value_ptr_external(param_t param)
 {
 	return param_get_value_ptr(param);
 }
+
+void param_mark_saved_external(param_t param)
+{
+	if (handle_in_range(param) && param_unsaved) {
+		param_bit_clear(param_unsaved, param);
+	}
+}
 #endif
 
 int
@@ -856,20 +933,26 @@ void param_set_used_internal(param_t param)
 int
 param_reset(param_t param)
 {
-	param_wbuf_s *s = nullptr;
+	bool was_modified = false;
 	bool param_found = false;
 
 	param_lock_writer();
+	param_generation_counter.fetch_add(1);
 
 	if (handle_in_range(param)) {
 
-		/* look for a saved value */
-		s = param_find_changed(param);
+		/* look for a saved value and drop it */
+		was_modified = param_find_changed(param);
+
+		if (was_modified) {
+			param_bit_clear(param_modified, param);
+			param_bit_clear(param_unsaved, param);
+			param_current_reset(param);
+
+			// the journal cannot express a reset to default
+			param_journal_entries = -1;
 
-		/* if we found one, erase it */
-		if (s != nullptr) {
-			int pos = utarray_eltidx(param_values, s);
-			utarray_erase(param_values, pos, 1);
+			param_mark_changed(param, param);
 		}
 
 		param_found = true;
@@ -877,9 +960,10 @@ param_reset(param_t param)
 
 	param_autosave();
 
+	param_generation_counter.fetch_add(1);
 	param_unlock_writer();
 
-	if (s != nullptr) {
+	if (was_modified) {
 		_param_notify_changes();
 	}
 
@@ -889,18 +973,34 @@ static void
 param_reset_all_internal(bool auto_save)
 {
 	param_lock_writer();
+	param_generation_counter.fetch_add(1);
 
-	if (param_values != nullptr) {
-		utarray_free(param_values);
+	param_journal_entries = -1;
+
+	if (get_param_info_count() > 0) {
+		param_mark_changed(0, get_param_info_count() - 1);
 	}
 
-	/* mark as reset / deleted */
-	param_values = nullptr;
+	/* mark as reset / deleted, the value storage itself stays allocated */
+	for (unsigned i = 0; i < param_bitset_words; i++) {
+		if (param_modified) {
+			param_modified[i].store(0);
+		}
+
+		if (param_unsaved) {
+			param_unsaved[i].store(0);
+		}
+	}
+
+	for (param_t param = 0; handle_in_range(param); param++) {
+		param_current_reset(param);
+	}
 
 	if (auto_save) {
 		param_autosave();
 	}
 
+	param_generation_counter.fetch_add(1);
 	param_unlock_writer();
 
 	_param_notify_changes();
@@ -959,6 +1059,8 @@ param_set_default_file(const char *filename)
 		param_user_file = strdup(filename);
 	}
 
+	param_journal_entries = -1;
+
 #endif /* FLASH_BASED_PARAMS */
 
 	return 0;
@@ -986,8 +1088,35 @@ param_save_default()
 		return res;
 	}
 
-	/* write parameters to temp file */
-	int fd = PARAM_OPEN(filename, O_WRONLY | O_CREAT, PX4_O_MODE_666);
+	/* append only the changed parameters if the journal is still short enough */
+	if (param_journal_entries >= 0 && param_journal_entries < PARAM_JOURNAL_MAX_ENTRIES) {
+		bool unsaved = false;
+
+		for (param_t param = 0; handle_in_range(param) && !unsaved; param++) {
+			unsaved = param_value_unsaved(param);
+		}
+
+		if (!unsaved) {
+			return PX4_OK;
+		}
+
+		int fd = PARAM_OPEN(filename, O_WRONLY | O_APPEND);
+
+		if (fd >= 0) {
+			res = param_export(fd, true);
+			PARAM_CLOSE(fd);
+
+			if (res == PX4_OK) {
+				param_journal_entries++;
+				return res;
+			}
+
+			PX4_ERR("param journal append failed, rewriting %s", filename);
+		}
+	}
+
+	/* compact: write a full snapshot, discarding the journal */
+	int fd = PARAM_OPEN(filename, O_WRONLY | O_CREAT | O_TRUNC, PX4_O_MODE_666);
 
 	if (fd < 0) {
 		PX4_ERR("failed to open param file: %s", filename);
@@ -1003,11 +1132,16 @@ param_save_default()
 		if (res != PX4_OK) {
 			PX4_ERR("param_export failed, retrying %d", attempts);
 			lseek(fd, 0, SEEK_SET); // jump back to the beginning of the file
+			ftruncate(fd, 0);
 		}
 	}
 
 	if (res != OK) {
 		PX4_ERR("failed to write parameters to file: %s", filename);
+		param_journal_entries = -1;
+
+	} else {
+		param_journal_entries = 0;
 	}
 
 	PARAM_CLOSE(fd);
@@ -1040,7 +1174,9 @@ param_load_default()
 		return 1;
 	}
 
-	int result = param_load(fd_load);
+	int documents = 0;
+	param_reset_all_internal(false);
+	int result = param_import_internal(fd_load, true, &documents);
 	PARAM_CLOSE(fd_load);
 
 	if (result != 0) {
@@ -1048,6 +1184,9 @@ param_load_default()
 		return -2;
 	}
 
+	/* continue appending to the journal, a truncated journal (-1) gets compacted on the next save */
+	param_journal_entries = documents - 1;
+
 	return res;
 }
 
@@ -1066,7 +1205,6 @@ param_export(int fd, bool only_unsaved)
 		return result;
 	}
 
-	param_wbuf_s *s = nullptr;
 	struct bson_encoder_s encoder;
 
 	int shutdown_lock_ret = px4_shutdown_lock();
@@ -1078,38 +1216,43 @@ param_export(int fd, bool only_unsaved)
 	// take the file lock
 	do {} while (px4_sem_wait(&param_sem_save) != 0);
 
+	if (!only_unsaved) {
+		// a full export clears all unsaved bits, but might go to another file than the default one:
+		// the next save to the default file then has to write a full snapshot instead of a journal entry
+		param_journal_entries = -1;
+	}
+
 	param_lock_reader();
 
 	uint8_t bson_buffer[256];
 	bson_encoder_init_buf_file(&encoder, fd, &bson_buffer, sizeof(bson_buffer));
 
-	/* no modified parameters -> we are done */
-	if (param_values == nullptr) {
-		result = 0;
-		goto out;
-	}
+	for (param_t param = 0; handle_in_range(param); param++) {
+		if (!param_find_changed(param)) {
+			continue;
+		}
 
-	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != nullptr) {
 		/*
 		 * If we are only saving values changed since last save, and this
 		 * one hasn't, then skip it
 		 */
-		if (only_unsaved && !s->unsaved) {
+		if (only_unsaved && !param_bit_test(param_unsaved, param)) {
 			continue;
 		}
 
-		s->unsaved = false;
+		param_bit_clear(param_unsaved, param);
 
-		const char *name = param_name(s->param);
-		const size_t size = param_size(s->param);
+		const union param_value_u *s = &param_values[param];
+		const char *name = param_name(param);
+		const size_t size = param_size(param);
 
 		/* append the appropriate BSON type object */
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 
 		case PARAM_TYPE_INT32: {
-				const int32_t i = s->val.i;
+				const int32_t i = s->i;
 
-				PX4_DEBUG("exporting: %s (%d) size: %d val: %d", name, s->param, size, i);
+				PX4_DEBUG("exporting: %s (%d) size: %d val: %d", name, param, size, i);
 
 				if (bson_encoder_append_int(&encoder, name, i)) {
 					PX4_ERR("BSON append failed for '%s'", name);
@@ -1119,9 +1262,9 @@ param_export(int fd, bool only_unsaved)
 			break;
 
 		case PARAM_TYPE_FLOAT: {
-				const double f = (double)s->val.f;
+				const double f = (double)s->f;
 
-				PX4_DEBUG("exporting: %s (%d) size: %d val: %.3f", name, s->param, size, (double)f);
+				PX4_DEBUG("exporting: %s (%d) size: %d val: %.3f", name, param, size, (double)f);
 
 				if (bson_encoder_append_double(&encoder, name, f)) {
 					PX4_ERR("BSON append failed for '%s'", name);
@@ -1131,7 +1274,7 @@ param_export(int fd, bool only_unsaved)
 			break;
 
 		case PARAM_TYPE_STRUCT ... PARAM_TYPE_STRUCT_MAX: {
-				const void *value_ptr = param_get_value_ptr(s->param);
+				const void *value_ptr = param_get_value_ptr(param);
 
 				/* lock as short as possible */
 				if (bson_encoder_append_binary(&encoder,
@@ -1306,26 +1449,93 @@ out:
 	return result;
 }
 
+/**
+ * Check that the BSON document at the current file position is complete,
+ * leaving the file position unchanged.
+ */
+static bool
+param_document_complete(int fd)
+{
+	const off_t start = lseek(fd, 0, SEEK_CUR);
+	const off_t end = lseek(fd, 0, SEEK_END);
+	int32_t length = 0;
+
+	if ((start < 0) || (end < 0) || (lseek(fd, start, SEEK_SET) != start)) {
+		return false;
+	}
+
+	if (end - start < (off_t)sizeof(length)) {
+		// end of file (or a truncated length), handled by the decoder
+		return true;
+	}
+
+	const bool length_read = (read(fd, &length, sizeof(length)) == (ssize_t)sizeof(length));
+	lseek(fd, start, SEEK_SET);
+
+	return length_read && (length > 0) && (length <= end - start);
+}
+
+/**
+ * Import all BSON documents from a file.
+ *
+ * Documents following the first one are journal entries appended by
+ * param_save_default(), later values override earlier ones.
+ *
+ * @param documents	If not null, set to the number of complete documents read,
+ *			or 0 if a journal entry was truncated.
+ */
 static int
-param_import_internal(int fd, bool mark_saved)
+param_import_internal(int fd, bool mark_saved, int *documents)
 {
 	bson_decoder_s decoder;
 	param_import_state state;
 	int result = -1;
-
-	if (bson_decoder_init_file(&decoder, fd, param_import_callback, &state)) {
-		PX4_ERR("decoder init failed");
-		return PX4_ERROR;
-	}
+	int count = 0;
 
 	state.mark_saved = mark_saved;
 
-	do {
-		result = bson_decoder_next(&decoder);
+	for (;;) {
+		if ((count > 0) && !param_document_complete(fd)) {
+			/* an interrupted journal append: don't apply any of its values */
+			PX4_WARN("ignoring truncated parameter journal entry");
+			count = 0;
+			break;
+		}
 
-	} while (result > 0);
+		if (bson_decoder_init_file(&decoder, fd, param_import_callback, &state)) {
+			if (count == 0) {
+				PX4_ERR("decoder init failed");
+				return PX4_ERROR;
+			}
 
-	return result;
+			/* end of file */
+			break;
+		}
+
+		do {
+			result = bson_decoder_next(&decoder);
+
+		} while (result > 0);
+
+		if (result < 0) {
+			if (count == 0) {
+				return result;
+			}
+
+			/* an interrupted journal append, everything before it is valid */
+			PX4_WARN("ignoring truncated parameter journal entry");
+			count = 0;
+			break;
+		}
+
+		count++;
+	}
+
+	if (documents) {
+		*documents = count;
+	}
+
+	return 0;
 }
 
 int
@@ -1357,7 +1567,7 @@ param_foreach(void (*func)(void *arg, param_t param), void *arg, bool only_chang
 	for (param = 0; handle_in_range(param); param++) {
 
 		/* if requested, skip unchanged values */
-		if (only_changed && (param_find_changed(param) == nullptr)) {
+		if (only_changed && !param_find_changed(param)) {
 			continue;
 		}
 
@@ -1406,8 +1616,14 @@ void param_print_status()
 #endif /* FLASH_BASED_PARAMS */
 
 	if (param_values != nullptr) {
-		PX4_INFO("storage array: %d/%d elements (%zu bytes total)",
-			 utarray_len(param_values), param_values->n, param_values->n * sizeof(UT_icd));
+		unsigned modified = 0;
+
+		for (param_t param = 0; handle_in_range(param); param++) {
+			modified += param_find_changed(param) ? 1 : 0;
+		}
+
+		PX4_INFO("storage array: %d/%d elements (%zu bytes total)", modified, param_count(),
+			 param_count() * sizeof(param_value_u) + 2 * param_bitset_words * sizeof(uint32_t));
 	}
 
 #ifndef PARAM_NO_AUTOSAVE
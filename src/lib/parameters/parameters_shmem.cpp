@@ -50,6 +50,7 @@
 #include <math.h>
 
 #include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
@@ -156,6 +157,9 @@ UT_array *param_values{nullptr};
 /** array info for the modified parameters array */
 const UT_icd param_icd = {sizeof(param_wbuf_s), nullptr, nullptr, nullptr};
 
+/** incremented when a value write starts and again when it completes, odd while a write is in progress */
+static px4::atomic<uint32_t> param_generation_counter{0};
+
 #if !defined(PARAM_NO_ORB)
 /** parameter update topic handle */
 static orb_advert_t param_topic = nullptr;
@@ -334,6 +338,11 @@ _param_notify_changes()
 	parameter_update_s pup = {};
 	pup.timestamp = hrt_absolute_time();
 	pup.instance = param_instance++;
+	pup.generation = param_generation_counter.load();
+
+	// changes are not tracked per parameter here, report everything
+	pup.changed_first = 0;
+	pup.changed_last = get_param_info_count() - 1;
 
 	/*
 	 * If we don't have a handle to our topic, create one now; otherwise
@@ -360,18 +369,16 @@ param_find_internal(const char *name, bool notification)
 {
 	perf_begin(param_find_perf);
 
-	param_t param;
-
-	/* perform a linear search of the known parameters */
-	for (param = 0; handle_in_range(param); param++) {
-		if (!strcmp(param_info_base[param].name, name)) {
-			if (notification) {
-				param_set_used_internal(param);
-			}
+	/* perfect hash lookup, a single compare rejects unknown names */
+	const param_t param = px4_parameters_hash_lookup(name);
 
-			perf_end(param_find_perf);
-			return param;
+	if (handle_in_range(param) && strcmp(name, param_info_base[param].name) == 0) {
+		if (notification) {
+			param_set_used_internal(param);
 		}
+
+		perf_end(param_find_perf);
+		return param;
 	}
 
 	perf_end(param_find_perf);
@@ -523,6 +530,19 @@ param_is_volatile(param_t param)
 	return handle_in_range(param) ? param_info_base[param].volatile_param : false;
 }
 
+uint32_t
+param_generation()
+{
+	return param_generation_counter.load();
+}
+
+const union param_value_u *
+param_get_values()
+{
+	// values are synced from the other processor on param_get()
+	return nullptr;
+}
+
 bool
 param_value_is_default(param_t param)
 {
@@ -614,6 +634,29 @@ param_get_value_ptr(param_t param)
 	return result;
 }
 
+/**
+ * Apply a parameter change of the other processor, without sending it back.
+ */
+static void
+param_apply_from_shmem(param_t param, union param_value_u value)
+{
+	if (!handle_in_range(param)) {
+		return;
+	}
+
+	// a resync applies all values, only store the ones that differ
+	const void *v = param_get_value_ptr(param);
+
+	if (v && (param_type(param) == PARAM_TYPE_INT32 || param_type(param) == PARAM_TYPE_FLOAT)
+	    && memcmp(v, &value, param_size(param)) == 0) {
+		return;
+	}
+
+	set_called_from_get = 1;
+	param_set_internal(param, &value, true, false);
+	set_called_from_get = 0;
+}
+
 int
 param_get(param_t param, void *val)
 {
@@ -626,13 +669,7 @@ param_get(param_t param, void *val)
 		return result;
 	}
 
-	union param_value_u value;
-
-	if (update_from_shmem(param, &value)) {
-		set_called_from_get = 1;
-		param_set_internal(param, &value, true, false);
-		set_called_from_get = 0;
-	}
+	update_from_shmem(param_apply_from_shmem, false);
 
 	const void *v = param_get_value_ptr(param);
 
@@ -748,6 +785,7 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 	bool params_changed = false;
 
 	param_lock_writer();
+	param_generation_counter.fetch_add(1);
 	perf_begin(param_set_perf);
 
 	if (param_values == nullptr) {
@@ -827,6 +865,7 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 
 out:
 	perf_end(param_set_perf);
+	param_generation_counter.fetch_add(1);
 	param_unlock_writer();
 
 	/*
@@ -928,6 +967,7 @@ param_reset(param_t param)
 	bool param_found = false;
 
 	param_lock_writer();
+	param_generation_counter.fetch_add(1);
 
 	if (handle_in_range(param)) {
 
@@ -945,6 +985,7 @@ param_reset(param_t param)
 
 	param_autosave();
 
+	param_generation_counter.fetch_add(1);
 	param_unlock_writer();
 
 	if (s != nullptr) {
@@ -957,6 +998,7 @@ static void
 param_reset_all_internal(bool auto_save)
 {
 	param_lock_writer();
+	param_generation_counter.fetch_add(1);
 
 	if (param_values != nullptr) {
 		utarray_free(param_values);
@@ -969,6 +1011,7 @@ param_reset_all_internal(bool auto_save)
 		param_autosave();
 	}
 
+	param_generation_counter.fetch_add(1);
 	param_unlock_writer();
 
 	_param_notify_changes();
@@ -1115,10 +1158,6 @@ param_load_default_no_notify()
 	int fd_load = open(param_get_default_file(), O_RDONLY);
 
 	if (fd_load < 0) {
-#ifdef __PX4_QURT
-		release_shmem_lock(__FILE__, __LINE__);
-#endif
-
 		/* no parameter file is OK, otherwise this is an error */
 		if (errno != ENOENT) {
 			PX4_DEBUG("open '%s' for reading failed", param_get_default_file());
@@ -1171,9 +1210,8 @@ param_export(int fd, bool only_unsaved)
 		goto out;
 	}
 
-	/* First of all, update the index which will call param_get for params
-	 * that have recently been changed. */
-	update_index_from_shmem();
+	/* First of all, apply the recent changes of the other processor. */
+	update_from_shmem(param_apply_from_shmem, true);
 
 	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != nullptr) {
 		/*
@@ -1186,9 +1224,6 @@ param_export(int fd, bool only_unsaved)
 
 		s->unsaved = false;
 
-		/* Make sure to get latest from shmem before saving. */
-		update_from_shmem(s->param, &s->val);
-
 		const char *name = param_name(s->param);
 		const size_t size = param_size(s->param);
 
@@ -1531,10 +1566,10 @@ void init_params()
 
 #ifdef ENABLE_SHMEM_DEBUG
 	PX4_INFO("Offsets:");
-	PX4_INFO("params_val %lu, krait_changed %lu, adsp_changed %lu",
+	PX4_INFO("params_val %lu, krait_journal %lu, adsp_journal %lu",
 		 (unsigned char *)shmem_info_p->params_val - (unsigned char *)shmem_info_p,
-		 (unsigned char *)&shmem_info_p->krait_changed_index - (unsigned char *)shmem_info_p,
-		 (unsigned char *)&shmem_info_p->adsp_changed_index - (unsigned char *)shmem_info_p);
+		 (unsigned char *)&shmem_info_p->krait_journal - (unsigned char *)shmem_info_p,
+		 (unsigned char *)&shmem_info_p->adsp_journal - (unsigned char *)shmem_info_p);
 #endif /* ENABLE_SHMEM_DEBUG */
 
 #endif /* __PX4_QURT */
@@ -20,6 +20,67 @@ except ImportError as e:
 
 import os
 
+FNV_OFFSET_BASIS = 2166136261
+FNV_PRIME = 16777619
+HASH_EMPTY = 0xffff
+
+
+def param_name_hash(name, seed):
+    """
+    Seeded 32 bit FNV-1a hash of a parameter name.
+    Must match px4_parameters_hash() in px4_parameters.h.jinja.
+    """
+    h = (FNV_OFFSET_BASIS ^ seed) & 0xffffffff
+    for c in name.encode('ascii'):
+        h ^= c
+        h = (h * FNV_PRIME) & 0xffffffff
+    return h
+
+
+def generate_perfect_hash(names):
+    """
+    Build a hash-and-displace perfect hash over the (sorted) parameter names.
+
+    Every name is first assigned to a bucket with seed 0. Buckets are then
+    placed from largest to smallest, searching for the first seed that maps
+    all names of the bucket into free slots of the table.
+
+    @return (seeds, table): per bucket seed and slot -> parameter index table
+    """
+    count = len(names)
+    num_buckets = max(1, (count + 3) // 4)
+
+    # power of two table with a load factor of at most 0.8
+    num_slots = 1
+    while num_slots * 4 < count * 5:
+        num_slots *= 2
+
+    buckets = [[] for _ in range(num_buckets)]
+    for index, name in enumerate(names):
+        buckets[param_name_hash(name, 0) % num_buckets].append(index)
+
+    seeds = [0] * num_buckets
+    table = [HASH_EMPTY] * num_slots
+
+    for bucket in sorted(range(num_buckets), key=lambda b: -len(buckets[b])):
+        if not buckets[bucket]:
+            break
+
+        for seed in range(1, 0xffff):
+            slots = [param_name_hash(names[i], seed) & (num_slots - 1) for i in buckets[bucket]]
+
+            if len(set(slots)) == len(slots) and all(table[s] == HASH_EMPTY for s in slots):
+                for slot, index in zip(slots, buckets[bucket]):
+                    table[slot] = index
+
+                seeds[bucket] = seed
+                break
+        else:
+            raise RuntimeError("failed to generate parameter perfect hash")
+
+    return seeds, table
+
+
 def generate(xml_file, dest='.'):
     """
     Generate px4 param source from xml.
@@ -40,6 +101,11 @@ def generate(xml_file, dest='.'):
 
     params = sorted(params, key=lambda name: name.attrib["name"])
 
+    if len(params) >= HASH_EMPTY:
+        raise RuntimeError("too many parameters for the 16 bit hash table")
+
+    hash_seeds, hash_table = generate_perfect_hash([p.attrib["name"] for p in params])
+
     script_path = os.path.dirname(os.path.realpath(__file__))
 
     # for jinja docs see: http://jinja.pocoo.org/docs/2.9/api/
@@ -58,7 +124,8 @@ def generate(xml_file, dest='.'):
         template = env.get_template(template_file)
         with open(os.path.join(
                 dest, template_file.replace('.jinja','')), 'w') as fid:
-            fid.write(template.render(params=params))
+            fid.write(template.render(params=params,
+                hash_seeds=hash_seeds, hash_table=hash_table))
 
 if __name__ == "__main__":
     arg_parser = argparse.ArgumentParser()
@@ -43,15 +43,39 @@
 #include <sys/queue.h>
 #include <drivers/drv_hrt.h>
 #include <math.h>
+#include <new>
 #include <pthread.h>
 #include <systemlib/err.h>
 
 #include "perf_counter.h"
 
+#if defined(__PX4_POSIX) && !defined(__PX4_QURT)
+// multicore POSIX targets: all but PC_INTERVAL counters are updated in per-thread shards
+//  (no shared cache lines or read-modify-write races on the hot path), merged on read
+#define PERF_SHARDED 1
+#include <px4_platform_common/atomic.h>
+#endif
+
+/**
+ * Time source of the PC_ELAPSED/PC_HISTOGRAM counters. With the lockstep scheduler the simulated time does not
+ * advance while code is running, so the CPU time of the calling thread is used instead.
+ */
+static inline hrt_abstime elapsed_time_now()
+{
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	struct timespec ts;
+	system_clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (hrt_abstime)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+	return hrt_absolute_time();
+#endif
+}
+
 /* latency histogram */
 const uint16_t latency_bucket_count = LATENCY_BUCKET_COUNT;
 const uint16_t	latency_buckets[LATENCY_BUCKET_COUNT] = { 1, 2, 5, 10, 20, 50, 100, 1000 };
 __EXPORT uint32_t	latency_counters[LATENCY_BUCKET_COUNT + 1];
+__EXPORT struct hrt_isr_stats_s hrt_isr_stats;
 
 
 #ifdef __PX4_QURT
@@ -66,6 +90,12 @@ struct perf_ctr_header {
 	sq_entry_t		link;	/**< list linkage */
 	enum perf_counter_type	type;	/**< counter type */
 	const char		*name;	/**< counter name */
+#ifdef PERF_SHARDED
+	uint32_t		id{0};				/**< unique id (validates thread local shard caches) */
+	px4::atomic<perf_ctr_header *> shards{nullptr};	/**< per-thread shards (counter only) */
+	perf_ctr_header		*next_shard{nullptr};		/**< shard list linkage (shard only) */
+	pthread_t		owner{};			/**< owning thread (shard only) */
+#endif
 };
 
 /**
@@ -88,6 +118,55 @@ struct perf_ctr_elapsed : public perf_ctr_header {
 	float			M2{0.0f};
 };
 
+/**
+ * PC_HISTOGRAM counter.
+ *
+ * Log-linear histogram of the elapsed time: values below 8 us have their own bucket,
+ * every power of two range above is split into 8 linear sub-buckets (12.5% resolution).
+ */
+static constexpr unsigned PERF_HISTOGRAM_SUB_BITS = 3;
+static constexpr unsigned PERF_HISTOGRAM_SUB_BUCKETS = 1 << PERF_HISTOGRAM_SUB_BITS;
+static constexpr unsigned PERF_HISTOGRAM_MAX_BITS = 24; // values up to ~16 s, everything above goes to the last bucket
+static constexpr unsigned PERF_HISTOGRAM_BUCKETS = PERF_HISTOGRAM_SUB_BUCKETS +
+		(PERF_HISTOGRAM_MAX_BITS - PERF_HISTOGRAM_SUB_BITS) * PERF_HISTOGRAM_SUB_BUCKETS;
+
+struct perf_ctr_histogram : public perf_ctr_elapsed {
+	uint32_t		buckets[PERF_HISTOGRAM_BUCKETS] {};
+};
+
+static unsigned perf_histogram_bucket(uint32_t value)
+{
+	if (value < PERF_HISTOGRAM_SUB_BUCKETS) {
+		return value;
+	}
+
+	const unsigned msb = 31 - __builtin_clz(value);
+
+	if (msb >= PERF_HISTOGRAM_MAX_BITS) {
+		return PERF_HISTOGRAM_BUCKETS - 1;
+	}
+
+	const unsigned sub = (value >> (msb - PERF_HISTOGRAM_SUB_BITS)) & (PERF_HISTOGRAM_SUB_BUCKETS - 1);
+	return PERF_HISTOGRAM_SUB_BUCKETS + (msb - PERF_HISTOGRAM_SUB_BITS) * PERF_HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+/**
+ * Midpoint of a histogram bucket (us).
+ */
+static uint32_t perf_histogram_value(unsigned bucket)
+{
+	if (bucket < PERF_HISTOGRAM_SUB_BUCKETS) {
+		return bucket;
+	}
+
+	const unsigned range = (bucket - PERF_HISTOGRAM_SUB_BUCKETS) / PERF_HISTOGRAM_SUB_BUCKETS;
+	const unsigned sub = (bucket - PERF_HISTOGRAM_SUB_BUCKETS) % PERF_HISTOGRAM_SUB_BUCKETS;
+	const uint32_t width = 1u << range;
+	const uint32_t lower = (PERF_HISTOGRAM_SUB_BUCKETS + sub) << range;
+
+	return lower + width / 2;
+}
+
 /**
  * PC_INTERVAL counter.
  */
@@ -116,7 +195,226 @@ pthread_mutex_t perf_counters_mutex = PTHREAD_MUTEX_INITIALIZER;
 // printed. This can lead to inconsistent output, or completely bogus values
 // (especially the 64bit values which are in general not atomically updated).
 // The same holds for shared perf counters (perf_alloc_once), that can be updated
-// concurrently (this affects the 'ctrl_latency' counter).
+// concurrently (this affects the 'ctrl_latency' counter). On POSIX this only
+// applies to PC_INTERVAL counters, the others are sharded per thread.
+
+#ifdef PERF_SHARDED
+static px4::atomic<uint32_t> perf_next_id{1};
+
+struct perf_shard_cache_entry {
+	perf_counter_t		handle;
+	uint32_t		id;
+	perf_ctr_header		*shard;
+};
+
+static constexpr int PERF_SHARD_CACHE_SIZE = 16; // must be a power of 2
+static constexpr size_t PERF_SHARD_ALIGN = 64; // cache line
+
+static thread_local perf_shard_cache_entry perf_shard_cache[PERF_SHARD_CACHE_SIZE] {};
+
+template<typename T>
+static perf_ctr_header *perf_shard_alloc()
+{
+	void *mem = nullptr;
+
+	// one cache line (or more) per shard to avoid false sharing between threads
+	if (posix_memalign(&mem, PERF_SHARD_ALIGN, sizeof(T)) != 0) {
+		return nullptr;
+	}
+
+	return new (mem) T();
+}
+
+static void perf_shard_free(perf_ctr_header *shard)
+{
+	switch (shard->type) {
+	case PC_COUNT:
+		static_cast<perf_ctr_count *>(shard)->~perf_ctr_count();
+		break;
+
+	case PC_ELAPSED:
+		static_cast<perf_ctr_elapsed *>(shard)->~perf_ctr_elapsed();
+		break;
+
+	case PC_HISTOGRAM:
+		static_cast<perf_ctr_histogram *>(shard)->~perf_ctr_histogram();
+		break;
+
+	default:
+		break;
+	}
+
+	free(shard);
+}
+
+/**
+ * Get the shard of the calling thread, or the counter itself if it's not sharded.
+ */
+static perf_ctr_header *perf_shard(perf_counter_t handle)
+{
+	if (handle->type == PC_INTERVAL) {
+		// intervals are measured between events of all threads
+		return handle;
+	}
+
+	perf_shard_cache_entry &entry = perf_shard_cache[((uintptr_t)handle / sizeof(void *)) & (PERF_SHARD_CACHE_SIZE - 1)];
+
+	if ((entry.handle == handle) && (entry.id == handle->id)) {
+		return entry.shard;
+	}
+
+	// cache miss: find the shard of this thread or create a new one
+	const pthread_t self = pthread_self();
+	perf_ctr_header *shard = handle->shards.load();
+
+	while ((shard != nullptr) && !pthread_equal(shard->owner, self)) {
+		shard = shard->next_shard;
+	}
+
+	if (shard == nullptr) {
+		switch (handle->type) {
+		case PC_COUNT:
+			shard = perf_shard_alloc<perf_ctr_count>();
+			break;
+
+		case PC_HISTOGRAM:
+			shard = perf_shard_alloc<perf_ctr_histogram>();
+			break;
+
+		default:
+			shard = perf_shard_alloc<perf_ctr_elapsed>();
+			break;
+		}
+
+		if (shard == nullptr) {
+			return handle;
+		}
+
+		shard->type = handle->type;
+		shard->name = handle->name;
+		shard->owner = self;
+
+		// lock-free push, shards are only removed in perf_free()
+		perf_ctr_header *head = handle->shards.load();
+
+		do {
+			shard->next_shard = head;
+		} while (!handle->shards.compare_exchange(&head, shard));
+	}
+
+	entry.handle = handle;
+	entry.id = handle->id;
+	entry.shard = shard;
+
+	return shard;
+}
+#else
+static inline perf_ctr_header *perf_shard(perf_counter_t handle) { return handle; }
+#endif /* PERF_SHARDED */
+
+/**
+ * Merge a PC_COUNT counter and all its shards.
+ */
+static uint64_t perf_merge_count(perf_counter_t handle)
+{
+	uint64_t event_count = ((struct perf_ctr_count *)handle)->event_count;
+
+#ifdef PERF_SHARDED
+
+	for (perf_ctr_header *shard = handle->shards.load(); shard != nullptr; shard = shard->next_shard) {
+		event_count += ((struct perf_ctr_count *)shard)->event_count;
+	}
+
+#endif /* PERF_SHARDED */
+
+	return event_count;
+}
+
+/**
+ * Events in one bucket of a PC_HISTOGRAM counter and all its shards.
+ */
+static uint64_t perf_histogram_bucket_count(perf_counter_t handle, unsigned bucket)
+{
+	uint64_t count = ((const struct perf_ctr_histogram *)handle)->buckets[bucket];
+
+#ifdef PERF_SHARDED
+
+	for (perf_ctr_header *shard = handle->shards.load(); shard != nullptr; shard = shard->next_shard) {
+		count += ((const struct perf_ctr_histogram *)shard)->buckets[bucket];
+	}
+
+#endif /* PERF_SHARDED */
+
+	return count;
+}
+
+/**
+ * Compute multiple (ascending) percentiles of a PC_HISTOGRAM counter in a single pass.
+ */
+static void perf_histogram_percentiles(perf_counter_t handle, uint64_t event_count, const float *percentiles,
+				       uint32_t *values, int num)
+{
+	uint64_t cumulative = 0;
+	int p = 0;
+
+	for (unsigned i = 0; (i < PERF_HISTOGRAM_BUCKETS) && (p < num); i++) {
+		cumulative += perf_histogram_bucket_count(handle, i);
+
+		while ((p < num) && (cumulative > 0) && (cumulative >= (uint64_t)ceilf(percentiles[p] * event_count))) {
+			values[p++] = perf_histogram_value(i);
+		}
+	}
+
+	// no events (or histogram overflow)
+	for (; p < num; p++) {
+		values[p] = (event_count == 0) ? 0 : perf_histogram_value(PERF_HISTOGRAM_BUCKETS - 1);
+	}
+}
+
+/**
+ * Merge a PC_ELAPSED (or PC_HISTOGRAM) counter and all its shards.
+ */
+static void perf_merge_elapsed(perf_counter_t handle, struct perf_ctr_elapsed &merged)
+{
+	const struct perf_ctr_elapsed *pce = (const struct perf_ctr_elapsed *)handle;
+	merged.event_count = pce->event_count;
+	merged.time_total = pce->time_total;
+	merged.time_least = pce->time_least;
+	merged.time_most = pce->time_most;
+	merged.mean = pce->mean;
+	merged.M2 = pce->M2;
+
+#ifdef PERF_SHARDED
+
+	for (perf_ctr_header *shard = handle->shards.load(); shard != nullptr; shard = shard->next_shard) {
+		const struct perf_ctr_elapsed *s = (const struct perf_ctr_elapsed *)shard;
+
+		if (s->event_count == 0) {
+			continue;
+		}
+
+		// combine mean and variance of both sets (Chan et al. parallel algorithm)
+		const float n_a = merged.event_count;
+		const float n_b = s->event_count;
+		const float n = n_a + n_b;
+		const float delta = s->mean - merged.mean;
+		merged.mean += delta * n_b / n;
+		merged.M2 += s->M2 + delta * delta * n_a * n_b / n;
+
+		merged.event_count += s->event_count;
+		merged.time_total += s->time_total;
+
+		if ((merged.time_least == 0) || ((s->time_least != 0) && (s->time_least < merged.time_least))) {
+			merged.time_least = s->time_least;
+		}
+
+		if (s->time_most > merged.time_most) {
+			merged.time_most = s->time_most;
+		}
+	}
+
+#endif /* PERF_SHARDED */
+}
 
 
 perf_counter_t
@@ -137,6 +435,10 @@ perf_alloc(enum perf_counter_type type, const char *name)
 		ctr = new perf_ctr_interval();
 		break;
 
+	case PC_HISTOGRAM:
+		ctr = new perf_ctr_histogram();
+		break;
+
 	default:
 		break;
 	}
@@ -144,6 +446,9 @@ perf_alloc(enum perf_counter_type type, const char *name)
 	if (ctr != nullptr) {
 		ctr->type = type;
 		ctr->name = name;
+#ifdef PERF_SHARDED
+		ctr->id = perf_next_id.fetch_add(1);
+#endif
 		pthread_mutex_lock(&perf_counters_mutex);
 		sq_addfirst(&ctr->link, &perf_counters);
 		pthread_mutex_unlock(&perf_counters_mutex);
@@ -192,6 +497,20 @@ perf_free(perf_counter_t handle)
 	sq_rem(&handle->link, &perf_counters);
 	pthread_mutex_unlock(&perf_counters_mutex);
 
+#ifdef PERF_SHARDED
+	// invalidate thread local shard caches
+	handle->id = 0;
+
+	perf_ctr_header *shard = handle->shards.exchange(nullptr);
+
+	while (shard != nullptr) {
+		perf_ctr_header *next = shard->next_shard;
+		perf_shard_free(shard);
+		shard = next;
+	}
+
+#endif /* PERF_SHARDED */
+
 	delete handle;
 }
 
@@ -204,7 +523,7 @@ perf_count(perf_counter_t handle)
 
 	switch (handle->type) {
 	case PC_COUNT:
-		((struct perf_ctr_count *)handle)->event_count++;
+		((struct perf_ctr_count *)perf_shard(handle))->event_count++;
 		break;
 
 	case PC_INTERVAL:
@@ -225,7 +544,8 @@ perf_begin(perf_counter_t handle)
 
 	switch (handle->type) {
 	case PC_ELAPSED:
-		((struct perf_ctr_elapsed *)handle)->time_start = hrt_absolute_time();
+	case PC_HISTOGRAM:
+		((struct perf_ctr_elapsed *)perf_shard(handle))->time_start = elapsed_time_now();
 		break;
 
 	default:
@@ -241,11 +561,12 @@ perf_end(perf_counter_t handle)
 	}
 
 	switch (handle->type) {
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)perf_shard(handle);
 
 			if (pce->time_start != 0) {
-				int64_t elapsed = hrt_absolute_time() - pce->time_start;
+				int64_t elapsed = elapsed_time_now() - pce->time_start;
 
 				if (elapsed >= 0) {
 
@@ -267,6 +588,10 @@ perf_end(perf_counter_t handle)
 					pce->mean += delta_intvl / pce->event_count;
 					pce->M2 += delta_intvl * (dt - pce->mean);
 
+					if (handle->type == PC_HISTOGRAM) {
+						((struct perf_ctr_histogram *)pce)->buckets[perf_histogram_bucket(elapsed)]++;
+					}
+
 					pce->time_start = 0;
 				}
 			}
@@ -286,8 +611,9 @@ perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 	}
 
 	switch (handle->type) {
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)perf_shard(handle);
 
 			if (elapsed >= 0) {
 
@@ -309,6 +635,10 @@ perf_set_elapsed(perf_counter_t handle, int64_t elapsed)
 				pce->mean += delta_intvl / pce->event_count;
 				pce->M2 += delta_intvl * (dt - pce->mean);
 
+				if (handle->type == PC_HISTOGRAM) {
+					((struct perf_ctr_histogram *)pce)->buckets[perf_histogram_bucket(elapsed)]++;
+				}
+
 				pce->time_start = 0;
 			}
 		}
@@ -383,6 +713,14 @@ perf_set_count(perf_counter_t handle, uint64_t count)
 	switch (handle->type) {
 	case PC_COUNT: {
 			((struct perf_ctr_count *)handle)->event_count = count;
+
+#ifdef PERF_SHARDED
+
+			for (perf_ctr_header *shard = handle->shards.load(); shard != nullptr; shard = shard->next_shard) {
+				((struct perf_ctr_count *)shard)->event_count = 0;
+			}
+
+#endif /* PERF_SHARDED */
 		}
 		break;
 
@@ -400,8 +738,9 @@ perf_cancel(perf_counter_t handle)
 	}
 
 	switch (handle->type) {
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)perf_shard(handle);
 
 			pce->time_start = 0;
 		}
@@ -412,25 +751,27 @@ perf_cancel(perf_counter_t handle)
 	}
 }
 
-void
-perf_reset(perf_counter_t handle)
+static void
+perf_reset_single(perf_ctr_header *handle)
 {
-	if (handle == nullptr) {
-		return;
-	}
-
 	switch (handle->type) {
 	case PC_COUNT:
 		((struct perf_ctr_count *)handle)->event_count = 0;
 		break;
 
-	case PC_ELAPSED: {
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
 			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
 			pce->event_count = 0;
 			pce->time_start = 0;
 			pce->time_total = 0;
 			pce->time_least = 0;
 			pce->time_most = 0;
+
+			if (handle->type == PC_HISTOGRAM) {
+				memset(((struct perf_ctr_histogram *)handle)->buckets, 0, sizeof(perf_ctr_histogram::buckets));
+			}
+
 			break;
 		}
 
@@ -447,6 +788,24 @@ perf_reset(perf_counter_t handle)
 	}
 }
 
+void
+perf_reset(perf_counter_t handle)
+{
+	if (handle == nullptr) {
+		return;
+	}
+
+	perf_reset_single(handle);
+
+#ifdef PERF_SHARDED
+
+	for (perf_ctr_header *shard = handle->shards.load(); shard != nullptr; shard = shard->next_shard) {
+		perf_reset_single(shard);
+	}
+
+#endif /* PERF_SHARDED */
+}
+
 void
 perf_print_counter(perf_counter_t handle)
 {
@@ -468,11 +827,13 @@ perf_print_counter_fd(int fd, perf_counter_t handle)
 	case PC_COUNT:
 		dprintf(fd, "%s: %llu events\n",
 			handle->name,
-			(unsigned long long)((struct perf_ctr_count *)handle)->event_count);
+			(unsigned long long)perf_merge_count(handle));
 		break;
 
 	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+			struct perf_ctr_elapsed merged;
+			perf_merge_elapsed(handle, merged);
+			struct perf_ctr_elapsed *pce = &merged;
 			float rms = sqrtf(pce->M2 / (pce->event_count - 1));
 			dprintf(fd, "%s: %llu events, %lluus elapsed, %.2fus avg, min %lluus max %lluus %5.3fus rms\n",
 				handle->name,
@@ -485,6 +846,22 @@ perf_print_counter_fd(int fd, perf_counter_t handle)
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed merged;
+			perf_merge_elapsed(handle, merged);
+			const float percentiles[3] {0.5f, 0.99f, 0.999f};
+			uint32_t values[3];
+			perf_histogram_percentiles(handle, merged.event_count, percentiles, values, 3);
+			dprintf(fd, "%s: %llu events, %.2fus avg, min %lluus max %lluus, p50 %uus p99 %uus p99.9 %uus\n",
+				handle->name,
+				(unsigned long long)merged.event_count,
+				(merged.event_count == 0) ? 0 : (double)merged.time_total / (double)merged.event_count,
+				(unsigned long long)merged.time_least,
+				(unsigned long long)merged.time_most,
+				(unsigned)values[0], (unsigned)values[1], (unsigned)values[2]);
+			break;
+		}
+
 	case PC_INTERVAL: {
 			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
 			float rms = sqrtf(pci->M2 / (pci->event_count - 1));
@@ -518,11 +895,13 @@ perf_print_counter_buffer(char *buffer, int length, perf_counter_t handle)
 	case PC_COUNT:
 		num_written = snprintf(buffer, length, "%s: %llu events",
 				       handle->name,
-				       (unsigned long long)((struct perf_ctr_count *)handle)->event_count);
+				       (unsigned long long)perf_merge_count(handle));
 		break;
 
 	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
+			struct perf_ctr_elapsed merged;
+			perf_merge_elapsed(handle, merged);
+			struct perf_ctr_elapsed *pce = &merged;
 			float rms = sqrtf(pce->M2 / (pce->event_count - 1));
 			num_written = snprintf(buffer, length, "%s: %llu events, %lluus elapsed, %.2fus avg, min %lluus max %lluus %5.3fus rms",
 					       handle->name,
@@ -535,6 +914,22 @@ perf_print_counter_buffer(char *buffer, int length, perf_counter_t handle)
 			break;
 		}
 
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed merged;
+			perf_merge_elapsed(handle, merged);
+			const float percentiles[3] {0.5f, 0.99f, 0.999f};
+			uint32_t values[3];
+			perf_histogram_percentiles(handle, merged.event_count, percentiles, values, 3);
+			num_written = snprintf(buffer, length, "%s: %llu events, %.2fus avg, min %lluus max %lluus, p50 %uus p99 %uus p99.9 %uus",
+					       handle->name,
+					       (unsigned long long)merged.event_count,
+					       (merged.event_count == 0) ? 0 : (double)merged.time_total / (double)merged.event_count,
+					       (unsigned long long)merged.time_least,
+					       (unsigned long long)merged.time_most,
+					       (unsigned)values[0], (unsigned)values[1], (unsigned)values[2]);
+			break;
+		}
+
 	case PC_INTERVAL: {
 			struct perf_ctr_interval *pci = (struct perf_ctr_interval *)handle;
 			float rms = sqrtf(pci->M2 / (pci->event_count - 1));
@@ -566,11 +961,13 @@ perf_event_count(perf_counter_t handle)
 
 	switch (handle->type) {
 	case PC_COUNT:
-		return ((struct perf_ctr_count *)handle)->event_count;
+		return perf_merge_count(handle);
 
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
-			return pce->event_count;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed merged;
+			perf_merge_elapsed(handle, merged);
+			return merged.event_count;
 		}
 
 	case PC_INTERVAL: {
@@ -593,9 +990,11 @@ perf_mean(perf_counter_t handle)
 	}
 
 	switch (handle->type) {
-	case PC_ELAPSED: {
-			struct perf_ctr_elapsed *pce = (struct perf_ctr_elapsed *)handle;
-			return pce->mean;
+	case PC_ELAPSED:
+	case PC_HISTOGRAM: {
+			struct perf_ctr_elapsed merged;
+			perf_merge_elapsed(handle, merged);
+			return merged.mean;
 		}
 
 	case PC_INTERVAL: {
@@ -610,6 +1009,21 @@ perf_mean(perf_counter_t handle)
 	return 0.0f;
 }
 
+uint32_t
+perf_percentile(perf_counter_t handle, float percentile)
+{
+	if ((handle == nullptr) || (handle->type != PC_HISTOGRAM)) {
+		return 0;
+	}
+
+	struct perf_ctr_elapsed merged;
+	perf_merge_elapsed(handle, merged);
+
+	uint32_t value = 0;
+	perf_histogram_percentiles(handle, merged.event_count, &percentile, &value, 1);
+	return value;
+}
+
 void
 perf_iterate_all(perf_callback cb, void *user)
 {
@@ -649,6 +1063,16 @@ perf_print_latency(int fd)
 
 	// print the overflow bucket value
 	dprintf(fd, " >%4i : %i\n", latency_buckets[latency_bucket_count - 1], latency_counters[latency_bucket_count]);
+
+	if (hrt_isr_stats.count > 0) {
+		dprintf(fd, "HRT interrupt: %lu events, %.2fus avg, max %uus\n",
+			(unsigned long)hrt_isr_stats.count, (double)hrt_isr_stats.time_total / hrt_isr_stats.count,
+			(unsigned)hrt_isr_stats.time_max);
+		dprintf(fd, "HRT callouts: %lu invoked, max %u per interrupt\n",
+			(unsigned long)hrt_isr_stats.callouts, (unsigned)hrt_isr_stats.callouts_max);
+		dprintf(fd, "HRT callout queue: max %u queued, %lu overflows\n",
+			(unsigned)hrt_isr_stats.queue_max, (unsigned long)hrt_isr_stats.queue_overflows);
+	}
 }
 
 void
@@ -667,4 +1091,10 @@ perf_reset_all(void)
 	for (int i = 0; i <= latency_bucket_count; i++) {
 		latency_counters[i] = 0;
 	}
+
+	hrt_isr_stats.count = 0;
+	hrt_isr_stats.callouts = 0;
+	hrt_isr_stats.time_total = 0;
+	hrt_isr_stats.time_max = 0;
+	hrt_isr_stats.callouts_max = 0;
 }
@@ -48,13 +48,29 @@ extern const uint16_t latency_bucket_count;
 extern const uint16_t latency_buckets[LATENCY_BUCKET_COUNT];
 extern uint32_t latency_counters[LATENCY_BUCKET_COUNT + 1];
 
+/**
+ * HRT interrupt statistics, only updated by timer drivers that support it.
+ */
+struct hrt_isr_stats_s {
+	uint32_t count;			/**< number of timer interrupts */
+	uint32_t callouts;		/**< number of callouts invoked */
+	uint64_t time_total;		/**< total time spent in the interrupt [us] */
+	uint16_t time_max;		/**< longest interrupt [us] */
+	uint16_t callouts_max;		/**< most callouts invoked in a single interrupt */
+	uint16_t queue_max;		/**< most calls queued at the same time */
+	uint32_t queue_overflows;	/**< calls that did not fit into the callout queue's heap */
+};
+
+extern struct hrt_isr_stats_s hrt_isr_stats;
+
 /**
  * Counter types.
  */
 enum perf_counter_type {
 	PC_COUNT,		/**< count the number of times an event occurs */
 	PC_ELAPSED,		/**< measure the time elapsed performing an event */
-	PC_INTERVAL		/**< measure the interval between instances of an event */
+	PC_INTERVAL,		/**< measure the interval between instances of an event */
+	PC_HISTOGRAM		/**< measure the time elapsed performing an event, with a log-linear histogram for percentiles */
 };
 
 struct perf_ctr_header;
@@ -103,7 +119,7 @@ __EXPORT extern void		perf_count(perf_counter_t handle);
 /**
  * Begin a performance event.
  *
- * This call applies to counters that operate over ranges of time; PC_ELAPSED etc.
+ * This call applies to counters that operate over ranges of time; PC_ELAPSED, PC_HISTOGRAM etc.
  *
  * @param handle		The handle returned from perf_alloc.
  */
@@ -248,6 +264,17 @@ __EXPORT extern uint64_t	perf_event_count(perf_counter_t handle);
  */
 __EXPORT extern float		perf_mean(perf_counter_t handle);
 
+/**
+ * Return a percentile of a PC_HISTOGRAM counter
+ *
+ * The value is accurate to the histogram resolution (1/8 of the power of two range it falls into).
+ *
+ * @param handle		The handle returned from perf_alloc.
+ * @param percentile		The percentile [0, 1], e.g. 0.99
+ * @param return		elapsed time in microseconds, 0 for other counter types or without events
+ */
+__EXPORT extern uint32_t	perf_percentile(perf_counter_t handle, float percentile);
+
 __END_DECLS
 
 #endif
@@ -0,0 +1,168 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "StateHistory.hpp"
+
+#include <lib/matrix/matrix/math.hpp>
+
+namespace state_history
+{
+
+static History<vehicle_attitude_s, ATTITUDE_HISTORY_SIZE> _attitude;
+static History<vehicle_local_position_s, LOCAL_POSITION_HISTORY_SIZE> _local_position;
+static History<vehicle_global_position_s, GLOBAL_POSITION_HISTORY_SIZE> _global_position;
+
+History<vehicle_attitude_s, ATTITUDE_HISTORY_SIZE> &attitude() { return _attitude; }
+History<vehicle_local_position_s, LOCAL_POSITION_HISTORY_SIZE> &local_position() { return _local_position; }
+History<vehicle_global_position_s, GLOBAL_POSITION_HISTORY_SIZE> &global_position() { return _global_position; }
+
+/**
+ * Interpolation factor of t between two samples
+ * @return false if t is not between two different samples
+ */
+template<typename T>
+static bool interpolation_factor(hrt_abstime t, const T &before, const T &after, float &alpha)
+{
+	if (after.timestamp <= before.timestamp) {
+		return false;
+	}
+
+	alpha = (float)(t - before.timestamp) / (float)(after.timestamp - before.timestamp);
+	return true;
+}
+
+bool attitude_at(hrt_abstime t, vehicle_attitude_s &attitude)
+{
+	vehicle_attitude_s after;
+
+	if (!_attitude.get(t, attitude, after)) {
+		return false;
+	}
+
+	float alpha;
+
+	if (interpolation_factor(t, attitude, after, alpha) && (attitude.quat_reset_counter == after.quat_reset_counter)) {
+		// normalized linear interpolation, close enough to slerp for the small rotation between two samples
+		const float dot = attitude.q[0] * after.q[0] + attitude.q[1] * after.q[1]
+				  + attitude.q[2] * after.q[2] + attitude.q[3] * after.q[3];
+		const float beta = (dot < 0.f) ? -alpha : alpha; // take the shorter path
+
+		matrix::Quatf q;
+
+		for (int i = 0; i < 4; i++) {
+			q(i) = attitude.q[i] * (1.f - alpha) + after.q[i] * beta;
+		}
+
+		q.normalize();
+		q.copyTo(attitude.q);
+		attitude.timestamp = t;
+	}
+
+	return true;
+}
+
+bool local_position_at(hrt_abstime t, vehicle_local_position_s &local_position)
+{
+	vehicle_local_position_s &lpos = local_position;
+	vehicle_local_position_s after;
+
+	if (!_local_position.get(t, lpos, after)) {
+		return false;
+	}
+
+	float alpha;
+
+	if (!interpolation_factor(t, lpos, after, alpha)) {
+		return true;
+	}
+
+	if (lpos.xy_reset_counter == after.xy_reset_counter) {
+		lpos.x += (after.x - lpos.x) * alpha;
+		lpos.y += (after.y - lpos.y) * alpha;
+	}
+
+	if (lpos.z_reset_counter == after.z_reset_counter) {
+		lpos.z += (after.z - lpos.z) * alpha;
+	}
+
+	if (lpos.vxy_reset_counter == after.vxy_reset_counter) {
+		lpos.vx += (after.vx - lpos.vx) * alpha;
+		lpos.vy += (after.vy - lpos.vy) * alpha;
+	}
+
+	if (lpos.vz_reset_counter == after.vz_reset_counter) {
+		lpos.vz += (after.vz - lpos.vz) * alpha;
+	}
+
+	if (lpos.dist_bottom_valid && after.dist_bottom_valid) {
+		lpos.dist_bottom += (after.dist_bottom - lpos.dist_bottom) * alpha;
+	}
+
+	lpos.timestamp = t;
+	return true;
+}
+
+bool global_position_at(hrt_abstime t, vehicle_global_position_s &global_position)
+{
+	vehicle_global_position_s &gpos = global_position;
+	vehicle_global_position_s after;
+
+	if (!_global_position.get(t, gpos, after)) {
+		return false;
+	}
+
+	float alpha;
+
+	if (!interpolation_factor(t, gpos, after, alpha)) {
+		return true;
+	}
+
+	if (gpos.lat_lon_reset_counter == after.lat_lon_reset_counter) {
+		gpos.lat += (after.lat - gpos.lat) * (double)alpha;
+		gpos.lon += (after.lon - gpos.lon) * (double)alpha;
+	}
+
+	if (gpos.alt_reset_counter == after.alt_reset_counter) {
+		gpos.alt += (after.alt - gpos.alt) * alpha;
+		gpos.alt_ellipsoid += (after.alt_ellipsoid - gpos.alt_ellipsoid) * alpha;
+	}
+
+	gpos.vel_n += (after.vel_n - gpos.vel_n) * alpha;
+	gpos.vel_e += (after.vel_e - gpos.vel_e) * alpha;
+	gpos.vel_d += (after.vel_d - gpos.vel_d) * alpha;
+
+	gpos.timestamp = t;
+	return true;
+}
+
+} // namespace state_history
@@ -0,0 +1,194 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file StateHistory.hpp
+ *
+ * Recent history of the vehicle state published by the estimator, shared by all the modules that need the
+ * state at the time of an event (camera trigger, sensor measurement) instead of the latest one.
+ *
+ * The estimator pushes every published vehicle_attitude, vehicle_local_position and vehicle_global_position,
+ * readers look them up by timestamp in constant time. The writer never blocks: readers retry if the history
+ * was written while they were reading it.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+#include <uORB/topics/vehicle_attitude.h>
+#include <uORB/topics/vehicle_global_position.h>
+#include <uORB/topics/vehicle_local_position.h>
+
+namespace state_history
+{
+
+/**
+ * Ring of the most recent samples of a topic, single writer, any number of readers.
+ * The samples need to be pushed in the order of their timestamps.
+ */
+template<typename T, uint8_t N>
+class History
+{
+public:
+	History() = default;
+	~History() = default;
+
+	void push(const T &sample)
+	{
+		_sequence.fetch_add(1); // odd while writing
+
+		_head = (_head + 1) % N;
+		_samples[_head] = sample;
+
+		if (_count < N) {
+			_count++;
+		}
+
+		_sequence.fetch_add(1);
+	}
+
+	void reset()
+	{
+		_sequence.fetch_add(1);
+		_count = 0;
+		_sequence.fetch_add(1);
+	}
+
+	/**
+	 * Get the samples around a timestamp.
+	 * @param t timestamp to look up
+	 * @param before latest sample at or before t
+	 * @param after first sample after t, same as before if t is at or after the newest sample
+	 * @return false if the history is empty or t is older than the oldest sample
+	 */
+	bool get(hrt_abstime t, T &before, T &after) const
+	{
+		for (int attempt = 0; attempt < 3; attempt++) {
+			const uint32_t sequence = _sequence.load();
+
+			if (sequence & 1) {
+				continue;
+			}
+
+			const bool found = find(t, before, after);
+
+			if (_sequence.load() == sequence) {
+				return found;
+			}
+		}
+
+		return false;
+	}
+
+private:
+	uint8_t index(uint8_t head, int age) const { return (head + N - age) % N; }
+
+	bool find(hrt_abstime t, T &before, T &after) const
+	{
+		const uint8_t head = _head;
+		const uint8_t count = _count;
+
+		if (count == 0) {
+			return false;
+		}
+
+		const T &newest = _samples[head];
+
+		if (t >= newest.timestamp) {
+			before = newest;
+			after = newest;
+			return true;
+		}
+
+		const T &oldest = _samples[index(head, count - 1)];
+
+		if (t < oldest.timestamp) {
+			return false;
+		}
+
+		// the samples are published at a fairly constant rate, start at the estimated age and correct it
+		const hrt_abstime mean_interval = (newest.timestamp - oldest.timestamp) / (count - 1);
+		int age = (newest.timestamp - t) / mean_interval;
+
+		if (age < 1) {
+			age = 1;
+
+		} else if (age > count - 1) {
+			age = count - 1;
+		}
+
+		while ((age < count - 1) && (_samples[index(head, age)].timestamp > t)) {
+			age++;
+		}
+
+		while ((age > 1) && (_samples[index(head, age - 1)].timestamp <= t)) {
+			age--;
+		}
+
+		before = _samples[index(head, age)];
+		after = _samples[index(head, age - 1)];
+		return true;
+	}
+
+	T _samples[N] {};
+	uint8_t _head{0};
+	uint8_t _count{0};
+
+	px4::atomic<uint32_t> _sequence{0};
+};
+
+static constexpr uint8_t ATTITUDE_HISTORY_SIZE = 64;		///< 256 ms at 250 Hz
+static constexpr uint8_t LOCAL_POSITION_HISTORY_SIZE = 32;	///< 320 ms at 100 Hz
+static constexpr uint8_t GLOBAL_POSITION_HISTORY_SIZE = 32;	///< 320 ms at 100 Hz
+
+/**
+ * The shared histories, only the estimator publishing the vehicle state pushes into them.
+ */
+History<vehicle_attitude_s, ATTITUDE_HISTORY_SIZE> &attitude();
+History<vehicle_local_position_s, LOCAL_POSITION_HISTORY_SIZE> &local_position();
+History<vehicle_global_position_s, GLOBAL_POSITION_HISTORY_SIZE> &global_position();
+
+/**
+ * Vehicle state at a timestamp, interpolated between the two samples around it (unless there was a reset
+ * in between). The timestamp of an interpolated state is t, a timestamp newer than the history returns the
+ * newest sample.
+ * @return false if there is no state for t
+ */
+bool attitude_at(hrt_abstime t, vehicle_attitude_s &attitude);
+bool local_position_at(hrt_abstime t, vehicle_local_position_s &local_position);
+bool global_position_at(hrt_abstime t, vehicle_global_position_s &global_position);
+
+} // namespace state_history
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file StateHistoryTest.cpp
+ * Tests for the lookup of the vehicle state history.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+
+#include "StateHistory.hpp"
+
+using state_history::History;
+
+static vehicle_attitude_s attitude_sample(hrt_abstime timestamp)
+{
+	vehicle_attitude_s attitude{};
+	attitude.timestamp = timestamp;
+	attitude.q[0] = 1.f;
+	return attitude;
+}
+
+TEST(StateHistory, Empty)
+{
+	History<vehicle_attitude_s, 8> history;
+	vehicle_attitude_s before, after;
+	EXPECT_FALSE(history.get(1000, before, after));
+}
+
+TEST(StateHistory, Bracketing)
+{
+	History<vehicle_attitude_s, 8> history;
+
+	// irregular intervals, the estimated position needs to be corrected
+	const hrt_abstime timestamps[] = {1000, 2000, 2500, 4000, 4100, 6000};
+
+	for (hrt_abstime timestamp : timestamps) {
+		history.push(attitude_sample(timestamp));
+	}
+
+	vehicle_attitude_s before, after;
+
+	for (hrt_abstime t = 1000; t < 6000; t += 50) {
+		ASSERT_TRUE(history.get(t, before, after));
+		EXPECT_LE(before.timestamp, t);
+		EXPECT_GT(after.timestamp, t);
+
+		// consecutive samples
+		const hrt_abstime *next = std::find(std::begin(timestamps), std::end(timestamps), before.timestamp) + 1;
+		EXPECT_EQ(after.timestamp, *next);
+	}
+
+	// newer than the newest sample
+	ASSERT_TRUE(history.get(7000, before, after));
+	EXPECT_EQ(before.timestamp, 6000u);
+	EXPECT_EQ(after.timestamp, 6000u);
+
+	// older than the oldest sample
+	EXPECT_FALSE(history.get(999, before, after));
+}
+
+TEST(StateHistory, Wrap)
+{
+	History<vehicle_attitude_s, 8> history;
+
+	for (hrt_abstime timestamp = 1000; timestamp <= 20000; timestamp += 1000) {
+		history.push(attitude_sample(timestamp));
+	}
+
+	vehicle_attitude_s before, after;
+
+	// only the 8 newest samples are kept
+	EXPECT_FALSE(history.get(12999, before, after));
+
+	ASSERT_TRUE(history.get(13000, before, after));
+	EXPECT_EQ(before.timestamp, 13000u);
+	EXPECT_EQ(after.timestamp, 14000u);
+
+	ASSERT_TRUE(history.get(19999, before, after));
+	EXPECT_EQ(before.timestamp, 19000u);
+	EXPECT_EQ(after.timestamp, 20000u);
+
+	history.reset();
+	EXPECT_FALSE(history.get(20000, before, after));
+}
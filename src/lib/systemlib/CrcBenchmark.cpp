@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Benchmarks of the CRC routines
+ * Run with make benchmarks
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <crc32.h>
+
+extern "C" {
+#include "crc.h"
+}
+
+static uint8_t data[4096];
+
+static void init_data()
+{
+	for (size_t i = 0; i < sizeof(data); i++) {
+		data[i] = i * 7 + 3;
+	}
+}
+
+/**
+ * Argument: length in bytes
+ */
+static void crc32_bytes(benchmark::State &state)
+{
+	init_data();
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(crc32part(data, state.range(0), 0));
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(crc32_bytes)->Arg(64)->Arg(4096);
+
+static void crc16_signature_bytes(benchmark::State &state)
+{
+	init_data();
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(crc16_signature(CRC16_INITIAL, state.range(0), data));
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(crc16_signature_bytes)->Arg(64)->Arg(4096);
+
+static void crc64_add_word_bytes(benchmark::State &state)
+{
+	init_data();
+	const uint32_t *words = reinterpret_cast<const uint32_t *>(data);
+
+	for (auto _ : state) {
+		uint64_t crc = CRC64_INITIAL;
+
+		for (int i = 0; i < state.range(0) / 4; i++) {
+			crc = crc64_add_word(crc, words[i]);
+		}
+
+		benchmark::DoNotOptimize(crc);
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(crc64_add_word_bytes)->Arg(64)->Arg(4096);
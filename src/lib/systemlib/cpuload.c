@@ -36,6 +36,9 @@
  *
  * Measurement of CPU load of each individual task.
  *
+ * NuttX accumulates the run time of each task in the context switch hooks, on Linux the CPU time
+ * clocks of the registered threads are read when the load is requested.
+ *
  * @author Lorenz Meier <lorenz@px4.io>
  * @author Petri Tanskanen <petri.tanskanen@inf.ethz.ch>
  */
@@ -44,10 +47,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
-
-//#include <arch/arch.h>
-
-//#include <debug.h>
+#include <string.h>
 
 #include <sys/time.h>
 
@@ -56,9 +56,7 @@
 
 #include "cpuload.h"
 
-#ifdef CONFIG_SCHED_INSTRUMENTATION
-
-#ifdef __PX4_NUTTX
+#if defined(__PX4_NUTTX) && defined(CONFIG_SCHED_INSTRUMENTATION)
 
 # include <nuttx/sched_note.h>
 
@@ -71,6 +69,12 @@ __EXPORT struct system_load_s system_load;
 
 extern FAR struct tcb_s *sched_gettcb(pid_t pid);
 
+/* the pid hash of NuttX, unique among the running tasks */
+static inline struct system_load_taskinfo_s *task_slot(pid_t pid)
+{
+	return &system_load.tasks[pid & (CONFIG_MAX_TASKS - 1)];
+}
+
 void cpuload_initialize_once()
 {
 	system_load.start_time = hrt_absolute_time();
@@ -94,10 +98,10 @@ void cpuload_initialize_once()
 
 	// perform static initialization of "system" threads
 	for (system_load.total_count = 0; system_load.total_count < static_tasks_count; system_load.total_count++) {
+		// it is assumed that these static threads have consecutive PIDs, starting at 0 (slot = pid)
 		system_load.tasks[system_load.total_count].total_runtime = 0;
 		system_load.tasks[system_load.total_count].curr_start_time = 0;
-		system_load.tasks[system_load.total_count].tcb = sched_gettcb(
-					system_load.total_count);	// it is assumed that these static threads have consecutive PIDs
+		system_load.tasks[system_load.total_count].tcb = sched_gettcb(system_load.total_count);
 		system_load.tasks[system_load.total_count].valid = true;
 	}
 
@@ -106,80 +110,242 @@ void cpuload_initialize_once()
 
 void sched_note_start(FAR struct tcb_s *tcb)
 {
-	/* search first free slot */
-	int i;
-
 	if (system_load.initialized) {
-		for (i = 1; i < CONFIG_MAX_TASKS; i++) {
-			if (!system_load.tasks[i].valid) {
-				/* slot is available */
-				system_load.tasks[i].total_runtime = 0;
-				system_load.tasks[i].curr_start_time = 0;
-				system_load.tasks[i].tcb = tcb;
-				system_load.tasks[i].valid = true;
-				system_load.total_count++;
-				break;
-			}
+		struct system_load_taskinfo_s *task = task_slot(tcb->pid);
+
+		task->total_runtime = 0;
+		task->curr_start_time = 0;
+		task->tcb = tcb;
+
+		if (!task->valid) {
+			task->valid = true;
+			system_load.total_count++;
 		}
 	}
 }
 
 void sched_note_stop(FAR struct tcb_s *tcb)
 {
-	int i;
-
 	if (system_load.initialized) {
-		for (i = 1; i < CONFIG_MAX_TASKS; i++) {
-			if (system_load.tasks[i].tcb != 0 && system_load.tasks[i].tcb->pid == tcb->pid) {
-				/* mark slot as fee */
-				system_load.tasks[i].valid = false;
-				system_load.tasks[i].total_runtime = 0;
-				system_load.tasks[i].curr_start_time = 0;
-				system_load.tasks[i].tcb = NULL;
-				system_load.total_count--;
-				break;
-			}
+		struct system_load_taskinfo_s *task = task_slot(tcb->pid);
+
+		if (task->valid && task->tcb == tcb) {
+			/* mark slot as free */
+			task->valid = false;
+			task->total_runtime = 0;
+			task->curr_start_time = 0;
+			task->tcb = NULL;
+			system_load.total_count--;
 		}
 	}
 }
 
 void sched_note_suspend(FAR struct tcb_s *tcb)
 {
-
 	if (system_load.initialized) {
-		uint64_t new_time = hrt_absolute_time();
-
-		for (int i = 0; i < CONFIG_MAX_TASKS; i++) {
-			/* Task ending its current scheduling run */
-			if (system_load.tasks[i].valid && system_load.tasks[i].tcb != 0 && system_load.tasks[i].tcb->pid == tcb->pid) {
-				system_load.tasks[i].total_runtime += new_time - system_load.tasks[i].curr_start_time;
-				break;
-			}
+		struct system_load_taskinfo_s *task = task_slot(tcb->pid);
+
+		/* Task ending its current scheduling run */
+		if (task->valid && task->tcb == tcb) {
+			task->total_runtime += hrt_absolute_time() - task->curr_start_time;
 		}
 	}
 }
 
 void sched_note_resume(FAR struct tcb_s *tcb)
 {
-
 	if (system_load.initialized) {
-		uint64_t new_time = hrt_absolute_time();
-
-		for (int i = 0; i < CONFIG_MAX_TASKS; i++) {
-			if (system_load.tasks[i].valid && system_load.tasks[i].tcb->pid == tcb->pid) {
-				// curr_start_time is accessed from an IRQ handler (in logger), so we need
-				// to make the update atomic
-				irqstate_t irq_state = px4_enter_critical_section();
-				system_load.tasks[i].curr_start_time = new_time;
-				px4_leave_critical_section(irq_state);
-				break;
-			}
+		struct system_load_taskinfo_s *task = task_slot(tcb->pid);
+
+		if (task->valid && task->tcb == tcb) {
+			// curr_start_time is accessed from an IRQ handler (in logger), so we need
+			// to make the update atomic
+			const uint64_t new_time = hrt_absolute_time();
+			irqstate_t irq_state = px4_enter_critical_section();
+			task->curr_start_time = new_time;
+			px4_leave_critical_section(irq_state);
+		}
+	}
+}
+
+int cpuload_get_threads(struct cpuload_thread_s *threads, int max_threads)
+{
+	int count = 0;
+
+	if (!system_load.initialized) {
+		return 0;
+	}
+
+	sched_lock();
+
+	for (int i = 0; i < CONFIG_MAX_TASKS && count < max_threads; i++) {
+		if (system_load.tasks[i].valid && system_load.tasks[i].tcb != NULL) {
+			threads[count].cpu_time_ns = system_load.tasks[i].total_runtime * 1000;
+			threads[count].id = i;
+			threads[count].idle = (system_load.tasks[i].tcb->pid == 0);
+#if CONFIG_TASK_NAME_SIZE > 0
+			strncpy(threads[count].name, system_load.tasks[i].tcb->name, CPULOAD_NAME_LEN - 1);
+			threads[count].name[CPULOAD_NAME_LEN - 1] = '\0';
+#else
+			threads[count].name[0] = '\0';
+#endif
+			count++;
+		}
+	}
+
+	sched_unlock();
+
+	return count;
+}
+
+uint64_t cpuload_busy_time_ns()
+{
+	if (!system_load.initialized) {
+		return 0;
+	}
+
+	// the idle task is not running while this is called
+	const uint64_t elapsed = hrt_absolute_time() - system_load.start_time;
+	const uint64_t idle = system_load.tasks[0].total_runtime;
+
+	return (elapsed > idle) ? (elapsed - idle) * 1000 : 0;
+}
+
+int cpuload_cpu_count()
+{
+	return 1;
+}
+
+void cpuload_register_thread(const char *name)
+{
+	// all tasks are tracked by the scheduler hooks
+}
+
+#elif defined(__PX4_LINUX)
+
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION
+__EXPORT struct system_load_s system_load;
+#endif
+
+static struct {
+	pthread_t thread;
+	char name[CPULOAD_NAME_LEN];
+	bool used;
+} cpuload_registry[CONFIG_MAX_TASKS];
+
+static pthread_mutex_t cpuload_registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t cpuload_thread_key;
+static pthread_once_t cpuload_key_once = PTHREAD_ONCE_INIT;
+
+/* thread specific data destructor, called when a registered thread exits or is cancelled */
+static void cpuload_thread_exit(void *slot)
+{
+	pthread_mutex_lock(&cpuload_registry_mutex);
+	cpuload_registry[(intptr_t)slot - 1].used = false;
+	pthread_mutex_unlock(&cpuload_registry_mutex);
+}
+
+static void cpuload_key_create(void)
+{
+	pthread_key_create(&cpuload_thread_key, cpuload_thread_exit);
+}
+
+void cpuload_register_thread(const char *name)
+{
+	pthread_once(&cpuload_key_once, cpuload_key_create);
+
+	pthread_mutex_lock(&cpuload_registry_mutex);
+
+	intptr_t slot = (intptr_t)pthread_getspecific(cpuload_thread_key);
+
+	for (int i = 0; slot == 0 && i < CONFIG_MAX_TASKS; i++) {
+		if (!cpuload_registry[i].used) {
+			cpuload_registry[i].thread = pthread_self();
+			cpuload_registry[i].used = true;
+			slot = i + 1;
+			pthread_setspecific(cpuload_thread_key, (void *)slot);
 		}
 	}
 
+	if (slot != 0) {
+		strncpy(cpuload_registry[slot - 1].name, name, CPULOAD_NAME_LEN - 1);
+		cpuload_registry[slot - 1].name[CPULOAD_NAME_LEN - 1] = '\0';
+	}
+
+	pthread_mutex_unlock(&cpuload_registry_mutex);
+}
+
+int cpuload_get_threads(struct cpuload_thread_s *threads, int max_threads)
+{
+	int count = 0;
+
+	// holding the lock keeps the threads from completing their exit
+	pthread_mutex_lock(&cpuload_registry_mutex);
+
+	for (int i = 0; i < CONFIG_MAX_TASKS && count < max_threads; i++) {
+		clockid_t clock_id;
+		struct timespec ts;
+
+		if (cpuload_registry[i].used
+		    && pthread_getcpuclockid(cpuload_registry[i].thread, &clock_id) == 0
+		    && system_clock_gettime(clock_id, &ts) == 0) {
+
+			threads[count].cpu_time_ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+			threads[count].id = i;
+			threads[count].idle = false;
+			memcpy(threads[count].name, cpuload_registry[i].name, CPULOAD_NAME_LEN);
+			count++;
+		}
+	}
+
+	pthread_mutex_unlock(&cpuload_registry_mutex);
+
+	return count;
+}
+
+uint64_t cpuload_busy_time_ns()
+{
+	struct timespec ts;
+
+	if (system_clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) {
+		return 0;
+	}
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int cpuload_cpu_count()
+{
+	const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	return (cpus > 0) ? cpus : 1;
 }
 
 #else
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION
 __EXPORT struct system_load_s system_load;
 #endif
-#endif /* CONFIG_SCHED_INSTRUMENTATION */
+
+int cpuload_get_threads(struct cpuload_thread_s *threads, int max_threads)
+{
+	return 0;
+}
+
+uint64_t cpuload_busy_time_ns()
+{
+	return 0;
+}
+
+int cpuload_cpu_count()
+{
+	return 1;
+}
+
+void cpuload_register_thread(const char *name)
+{
+}
+
+#endif
@@ -33,12 +33,15 @@
 
 #pragma once
 
-#ifdef CONFIG_SCHED_INSTRUMENTATION
+#include <px4_platform_common/px4_config.h>
 
-#include <sched.h>
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION
+
+#include <sched.h>
+
 struct system_load_taskinfo_s {
 	uint64_t total_runtime;			///< Runtime since start (start_time - total_runtime)/(start_time - current_time) = load
 	uint64_t curr_start_time;		///< Start time of the current scheduling slot
@@ -48,6 +51,10 @@ struct system_load_taskinfo_s {
 	bool valid;						///< Task is currently active / valid
 };
 
+/**
+ * On NuttX a task is stored in the slot pid & (CONFIG_MAX_TASKS - 1), which is unique among the running tasks,
+ * so the scheduler hooks don't need to search for it.
+ */
 struct system_load_s {
 	uint64_t start_time;			///< Global start time of measurements
 	struct system_load_taskinfo_s tasks[CONFIG_MAX_TASKS];
@@ -57,12 +64,53 @@ struct system_load_s {
 	int sleeping_count;
 };
 
+#endif /* CONFIG_SCHED_INSTRUMENTATION */
+
+#define CPULOAD_NAME_LEN 16
+
+/**
+ * CPU time of a thread.
+ */
+struct cpuload_thread_s {
+	uint64_t cpu_time_ns;			///< CPU time used since the thread started [ns]
+	int id;					///< task slot, stable while the thread runs
+	bool idle;				///< idle task (NuttX)
+	char name[CPULOAD_NAME_LEN];
+};
+
 __BEGIN_DECLS
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION
 __EXPORT extern struct system_load_s system_load;
 
 __EXPORT void cpuload_initialize_once(void);
+#endif /* CONFIG_SCHED_INSTRUMENTATION */
 
-__END_DECLS
+/**
+ * Get the CPU time of all threads.
+ *
+ * NuttX accumulates it in the context switch hooks, Linux reads the CPU time clock of each registered thread
+ * (CLOCK_THREAD_CPUTIME_ID). Nothing is sampled periodically.
+ *
+ * @return number of threads written
+ */
+__EXPORT int cpuload_get_threads(struct cpuload_thread_s *threads, int max_threads);
 
-#endif
+/**
+ * CPU time used since boot by everything but the idle task, summed over all CPUs [ns].
+ * On Linux this is the CPU time of the process.
+ */
+__EXPORT uint64_t cpuload_busy_time_ns(void);
+
+/**
+ * Number of CPUs the busy time is spread over, the load is busy time / (elapsed time * CPU count).
+ */
+__EXPORT int cpuload_cpu_count(void);
+
+/**
+ * Register the calling thread for the CPU time accounting (Linux only, NuttX tracks all tasks).
+ * It's removed automatically when the thread exits.
+ */
+__EXPORT void cpuload_register_thread(const char *name);
+
+__END_DECLS
@@ -63,6 +63,20 @@ extern struct system_load_s system_load;
 
 #define CL "\033[K" // clear line
 
+#if defined(__PX4_LINUX)
+struct print_load_callback_data_s {
+	int fd;
+	char *clear_line;
+	char buffer[140];
+};
+
+static void print_load_callback(void *user)
+{
+	struct print_load_callback_data_s *data = (struct print_load_callback_data_s *)user;
+	dprintf(data->fd, "%s%s\n", data->clear_line, data->buffer);
+}
+#endif
+
 void init_print_load_s(uint64_t t, struct print_load_s *s)
 {
 
@@ -91,8 +105,15 @@ void print_load(uint64_t t, int fd, struct print_load_s *print_state)
 		clear_line = CL;
 	}
 
-#if defined(__PX4_LINUX) || defined(__PX4_CYGWIN) || defined(__PX4_QURT)
-	dprintf(fd, "%sTOP NOT IMPLEMENTED ON LINUX, QURT, WINDOWS (ONLY ON NUTTX, APPLE)\n", clear_line);
+#if defined(__PX4_LINUX)
+	struct print_load_callback_data_s data;
+	data.fd = fd;
+	data.clear_line = clear_line;
+
+	print_load_buffer(t, data.buffer, sizeof(data.buffer), print_load_callback, &data, print_state);
+
+#elif defined(__PX4_CYGWIN) || defined(__PX4_QURT)
+	dprintf(fd, "%sTOP NOT IMPLEMENTED ON QURT, WINDOWS (ONLY ON NUTTX, LINUX, APPLE)\n", clear_line);
 
 #elif defined(__PX4_DARWIN)
 	pid_t pid = getpid();   //-- this is the process id you need info for
@@ -178,6 +199,69 @@ void print_load(uint64_t t, int fd, struct print_load_s *print_state)
 void print_load_buffer(uint64_t t, char *buffer, int buffer_length, print_load_callback_f cb, void *user,
 		       struct print_load_s *print_state)
 {
+#if defined(__PX4_LINUX)
+	struct cpuload_thread_s threads[CONFIG_MAX_TASKS];
+	const int count = cpuload_get_threads(threads, CONFIG_MAX_TASKS);
+
+	print_state->new_time = t;
+	const bool have_interval = print_state->new_time > print_state->interval_start_time;
+
+	if (have_interval) {
+		print_state->interval_time_ms_inv = 1.f / ((float)((print_state->new_time - print_state->interval_start_time) / 1000));
+
+		snprintf(buffer, buffer_length, "%3s %-*s %10s %7s", "ID", CPULOAD_NAME_LEN, "COMMAND", "CPU(ms)", "CPU(%)");
+		cb(user);
+	}
+
+	print_state->running_count = count;
+	print_state->blocked_count = 0;
+	print_state->total_user_time = 0;
+
+	for (int i = 0; i < count; i++) {
+		const uint32_t total_runtime = (uint32_t)(threads[i].cpu_time_ns / 1000000);
+		const int id = threads[i].id;
+
+		const uint32_t interval_runtime = (print_state->last_times[id] > 0 && total_runtime > print_state->last_times[id])
+						  ? (total_runtime - print_state->last_times[id]) : 0;
 
+		print_state->last_times[id] = total_runtime;
+		print_state->total_user_time += interval_runtime;
+
+		if (!have_interval) {
+			continue; // not enough data yet
+		}
+
+		const float current_load = interval_runtime * print_state->interval_time_ms_inv;
+
+		snprintf(buffer, buffer_length, "%3d %-*s %10u %3d.%03d",
+			 id, CPULOAD_NAME_LEN, threads[i].name, total_runtime,
+			 (int)(current_load * 100.0f),
+			 (int)((current_load * 100.0f - (int)(current_load * 100.0f)) * 1000));
+		cb(user);
+	}
+
+	if (!have_interval) {
+		// first run, not enough data yet
+		return;
+	}
+
+	// Print footer
+	buffer[0] = 0;
+	cb(user);
+
+	snprintf(buffer, buffer_length, "Threads: %d registered, CPU usage: %.2f%% of one CPU (%d CPUs)",
+		 count,
+		 (double)((float)print_state->total_user_time * print_state->interval_time_ms_inv * 100.f),
+		 cpuload_cpu_count());
+	cb(user);
+
+	// the process CPU time also includes the threads which are not registered
+	snprintf(buffer, buffer_length, "Uptime: %.3fs total, %.3fs process CPU time",
+		 (double)t / 1000000.0,
+		 (double)cpuload_busy_time_ns() / 1e9);
+	cb(user);
+
+	print_state->interval_start_time = print_state->new_time;
+#endif
 }
 
@@ -0,0 +1,312 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file trace.cpp
+ *
+ * Per-CPU trace ring buffers and Chrome trace event export.
+ */
+
+#include "trace.h"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__PX4_LINUX)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__PX4_POSIX)
+#include <pthread.h>
+#endif
+
+#if defined(__PX4_LINUX)
+static constexpr unsigned TRACE_MAX_CPUS = 8;
+#else
+static constexpr unsigned TRACE_MAX_CPUS = 1;
+#endif
+
+struct trace_cpu_buffer_s {
+	px4::atomic<uint32_t>	head{0};	///< total number of events recorded (index of the next event)
+	trace_event_s		*events{nullptr};
+};
+
+volatile bool trace_enabled = false;
+
+static trace_cpu_buffer_s trace_buffers[TRACE_MAX_CPUS];
+static unsigned trace_num_cpus = 0;
+static uint32_t trace_mask = 0; ///< entries per CPU - 1
+static hrt_abstime trace_start_time = 0;
+
+static inline unsigned trace_current_cpu()
+{
+#if defined(__PX4_LINUX)
+	const int cpu = sched_getcpu();
+	return (cpu > 0) ? (unsigned)cpu % trace_num_cpus : 0;
+#else
+	return 0;
+#endif
+}
+
+static inline uint32_t trace_current_tid()
+{
+#if defined(__PX4_NUTTX)
+	return getpid();
+#elif defined(__PX4_LINUX)
+	// cache the thread id, gettid() is a syscall
+	static thread_local uint32_t tid = 0;
+
+	if (tid == 0) {
+		tid = syscall(SYS_gettid);
+	}
+
+	return tid;
+#else
+	return (uint32_t)(uintptr_t)pthread_self();
+#endif
+}
+
+static void trace_free()
+{
+	for (unsigned cpu = 0; cpu < TRACE_MAX_CPUS; cpu++) {
+		free(trace_buffers[cpu].events);
+		trace_buffers[cpu].events = nullptr;
+		trace_buffers[cpu].head.store(0);
+	}
+
+	trace_num_cpus = 0;
+	trace_mask = 0;
+}
+
+int trace_start(unsigned entries)
+{
+	trace_stop();
+	trace_free();
+
+	unsigned entries_pow2 = 1;
+
+	while (entries_pow2 < entries) {
+		entries_pow2 <<= 1;
+	}
+
+	unsigned num_cpus = 1;
+
+#if defined(__PX4_LINUX)
+	const long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (online > (long)TRACE_MAX_CPUS) {
+		num_cpus = TRACE_MAX_CPUS;
+
+	} else if (online > 1) {
+		num_cpus = online;
+	}
+
+#endif
+
+	for (unsigned cpu = 0; cpu < num_cpus; cpu++) {
+		trace_buffers[cpu].events = (trace_event_s *)calloc(entries_pow2, sizeof(trace_event_s));
+
+		if (trace_buffers[cpu].events == nullptr) {
+			trace_free();
+			return -ENOMEM;
+		}
+	}
+
+	trace_num_cpus = num_cpus;
+	trace_mask = entries_pow2 - 1;
+	trace_start_time = hrt_absolute_time();
+	trace_enabled = true;
+
+	return 0;
+}
+
+void trace_stop()
+{
+	if (trace_enabled) {
+		trace_enabled = false;
+
+		// let writers that already passed the enabled check finish
+		px4_usleep(10000);
+	}
+}
+
+void trace_record_event(uint8_t type, const char *name)
+{
+	if (trace_num_cpus == 0) {
+		return;
+	}
+
+	const unsigned cpu = trace_current_cpu();
+	trace_cpu_buffer_s &buffer = trace_buffers[cpu];
+
+	if (buffer.events == nullptr) {
+		return;
+	}
+
+	// reserve a slot, the oldest events are overwritten once the buffer is full
+	const uint32_t index = buffer.head.fetch_add(1) & trace_mask;
+
+	trace_event_s &event = buffer.events[index];
+	event.timestamp = hrt_absolute_time();
+	event.name = name;
+	event.tid = trace_current_tid();
+	event.type = type;
+	event.cpu = cpu;
+}
+
+/**
+ * Index range [first, end) of the valid events of a CPU buffer.
+ */
+static void trace_range(unsigned cpu, uint32_t &first, uint32_t &end)
+{
+	end = trace_buffers[cpu].head.load();
+	const uint32_t size = trace_mask + 1;
+	first = (end > size) ? (end - size) : 0;
+}
+
+static void trace_write_event(FILE *file, const trace_event_s &event, bool first)
+{
+	const char *separator = first ? "" : ",\n";
+	const char *name = (event.name != nullptr) ? event.name : "?";
+	const uint64_t ts = (event.timestamp > trace_start_time) ? (event.timestamp - trace_start_time) : 0;
+
+	switch (event.type) {
+	case TRACE_WORKITEM_START:
+	case TRACE_WORKITEM_END:
+		fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"work_item\",\"ph\":\"%s\",\"ts\":%" PRIu64 ",\"pid\":0,\"tid\":%" PRIu32
+			",\"args\":{\"cpu\":%d}}", separator, name, (event.type == TRACE_WORKITEM_START) ? "B" : "E", ts, event.tid,
+			event.cpu);
+		break;
+
+	case TRACE_SEM_WAIT_START:
+	case TRACE_SEM_WAIT_END:
+		fprintf(file, "%s{\"name\":\"wait %s\",\"cat\":\"wait\",\"ph\":\"%s\",\"ts\":%" PRIu64 ",\"pid\":0,\"tid\":%" PRIu32
+			"}", separator, name, (event.type == TRACE_SEM_WAIT_START) ? "B" : "E", ts, event.tid);
+		break;
+
+	case TRACE_ORB_PUBLISH:
+		fprintf(file, "%s{\"name\":\"publish %s\",\"cat\":\"uorb\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%" PRIu64
+			",\"pid\":0,\"tid\":%" PRIu32 "}", separator, name, ts, event.tid);
+		break;
+
+	case TRACE_ORB_CALLBACK:
+		fprintf(file, "%s{\"name\":\"wakeup %s\",\"cat\":\"uorb\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%" PRIu64
+			",\"pid\":0,\"tid\":%" PRIu32 "}", separator, name, ts, event.tid);
+		break;
+
+	default:
+		break;
+	}
+}
+
+int trace_dump_json(const char *path)
+{
+	if (trace_enabled) {
+		PX4_WARN("stopping trace");
+		trace_stop();
+	}
+
+	if (trace_num_cpus == 0) {
+		return -ENODATA;
+	}
+
+	FILE *file = fopen(path, "w");
+
+	if (file == nullptr) {
+		return -errno;
+	}
+
+	uint32_t cursor[TRACE_MAX_CPUS] {};
+	uint32_t end[TRACE_MAX_CPUS] {};
+
+	for (unsigned cpu = 0; cpu < trace_num_cpus; cpu++) {
+		trace_range(cpu, cursor[cpu], end[cpu]);
+	}
+
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+	int count = 0;
+
+	// merge the per-CPU buffers in timestamp order
+	for (;;) {
+		int next_cpu = -1;
+		uint64_t next_timestamp = UINT64_MAX;
+
+		for (unsigned cpu = 0; cpu < trace_num_cpus; cpu++) {
+			if (cursor[cpu] != end[cpu]) {
+				const trace_event_s &event = trace_buffers[cpu].events[cursor[cpu] & trace_mask];
+
+				if (event.timestamp < next_timestamp) {
+					next_timestamp = event.timestamp;
+					next_cpu = cpu;
+				}
+			}
+		}
+
+		if (next_cpu < 0) {
+			break;
+		}
+
+		trace_write_event(file, trace_buffers[next_cpu].events[cursor[next_cpu] & trace_mask], count == 0);
+		cursor[next_cpu]++;
+		count++;
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+
+	return count;
+}
+
+void trace_print_status()
+{
+	PX4_INFO("%s, %u CPU buffer(s) of %" PRIu32 " events", trace_enabled ? "running" : "stopped", trace_num_cpus,
+		 (trace_num_cpus > 0) ? (trace_mask + 1) : 0);
+
+	for (unsigned cpu = 0; cpu < trace_num_cpus; cpu++) {
+		uint32_t first = 0;
+		uint32_t end = 0;
+		trace_range(cpu, first, end);
+		PX4_INFO("CPU %u: %" PRIu32 " events recorded, %" PRIu32 " overwritten", cpu, end, first);
+	}
+}
@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file trace.h
+ * Lightweight event tracing (WorkItem runs, uORB publications and wakeups).
+ *
+ * Events are recorded into per-CPU ring buffers of timestamped entries and can
+ * be exported in the Chrome trace event format (chrome://tracing, Perfetto).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <px4_platform_common/defines.h>
+
+/**
+ * Event types.
+ */
+enum trace_event_type {
+	TRACE_WORKITEM_START,	/**< WorkItem::Run() started (name: work item) */
+	TRACE_WORKITEM_END,	/**< WorkItem::Run() finished (name: work item) */
+	TRACE_ORB_PUBLISH,	/**< uORB publication (name: topic) */
+	TRACE_ORB_CALLBACK,	/**< WorkItem scheduled by a uORB callback (name: work item) */
+	TRACE_SEM_WAIT_START,	/**< work queue waits for work (name: work queue) */
+	TRACE_SEM_WAIT_END,	/**< work queue woke up (name: work queue) */
+};
+
+/**
+ * A single trace event.
+ */
+struct trace_event_s {
+	uint64_t	timestamp;	/**< hrt_absolute_time() */
+	const char	*name;		/**< static name (must outlive the trace) */
+	uint32_t	tid;		/**< thread/task id */
+	uint8_t		type;		/**< enum trace_event_type */
+	uint8_t		cpu;		/**< CPU (ring buffer) index */
+};
+
+__BEGIN_DECLS
+
+/**
+ * Set while tracing. Checked inline so that disabled tracing costs a single load.
+ */
+__EXPORT extern volatile bool trace_enabled;
+
+/**
+ * Start tracing (discarding any previous trace).
+ *
+ * @param entries		Ring buffer entries per CPU, rounded up to a power of 2.
+ * @return			0 on success, negative errno otherwise.
+ */
+__EXPORT extern int		trace_start(unsigned entries);
+
+/**
+ * Stop tracing. The recorded events are kept until the next trace_start().
+ */
+__EXPORT extern void		trace_stop(void);
+
+/**
+ * Record an event, use trace_record() instead.
+ */
+__EXPORT extern void		trace_record_event(uint8_t type, const char *name);
+
+/**
+ * Write the recorded events as Chrome trace event JSON.
+ *
+ * @param path			Output file path.
+ * @return			Number of events written, negative errno on failure.
+ */
+__EXPORT extern int		trace_dump_json(const char *path);
+
+/**
+ * Print the trace buffer status.
+ */
+__EXPORT extern void		trace_print_status(void);
+
+__END_DECLS
+
+/**
+ * Record an event if tracing is enabled.
+ *
+ * @param type			enum trace_event_type
+ * @param name			Static name (work item, topic or work queue name).
+ */
+static inline void trace_record(uint8_t type, const char *name)
+{
+	if (trace_enabled) {
+		trace_record_event(type, name);
+	}
+}
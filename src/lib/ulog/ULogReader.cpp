@@ -0,0 +1,277 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ULogReader.hpp"
+
+#include <px4_platform_common/log.h>
+#include <uORB/uORBTopics.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace px4
+{
+namespace ulog
+{
+
+ULogReader::~ULogReader()
+{
+	close();
+}
+
+bool ULogReader::open(const char *file_name)
+{
+	close();
+
+	int fd = ::open(file_name, O_RDONLY);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+
+	if (data == MAP_FAILED) {
+		PX4_WARN("mmap failed (%i)", errno);
+		return false;
+	}
+
+	_data = (const uint8_t *)data;
+	_size = st.st_size;
+	return true;
+}
+
+void ULogReader::close()
+{
+	if (_data) {
+		munmap((void *)_data, _size);
+		_data = nullptr;
+		_size = 0;
+	}
+
+	_data_index.clear();
+	_add_logged_messages.clear();
+	_additional_messages.clear();
+}
+
+bool ULogReader::messageHeader(uint64_t offset, ulog_message_header_s &header) const
+{
+	if (offset + ULOG_MSG_HEADER_LEN > _size) {
+		return false;
+	}
+
+	memcpy(&header, _data + offset, ULOG_MSG_HEADER_LEN);
+	return offset + ULOG_MSG_HEADER_LEN + header.msg_size <= _size;
+}
+
+size_t ULogReader::buildIndex(uint64_t start, uint64_t end)
+{
+	_data_index.clear();
+	_add_logged_messages.clear();
+	_additional_messages.clear();
+
+	if (end > _size) {
+		end = _size;
+	}
+
+	uint64_t pos = start;
+	size_t num_data_messages = 0;
+	ulog_message_header_s header;
+
+	while (messageHeader(pos, header)) {
+		const uint64_t next_pos = pos + ULOG_MSG_HEADER_LEN + header.msg_size;
+
+		if (next_pos > end) {
+			break;
+		}
+
+		switch (header.msg_type) {
+		case (int)ULogMessageType::DATA:
+			if (header.msg_size >= 2) {
+				uint16_t msg_id;
+				memcpy(&msg_id, messagePayload(pos), sizeof(msg_id));
+
+				if (_data_index.size() <= msg_id) {
+					_data_index.resize(msg_id + 1);
+				}
+
+				_data_index[msg_id].push_back(pos);
+				++num_data_messages;
+			}
+
+			break;
+
+		case (int)ULogMessageType::ADD_LOGGED_MSG:
+			_add_logged_messages.push_back(pos);
+			break;
+
+		case (int)ULogMessageType::PARAMETER:
+		case (int)ULogMessageType::DROPOUT:
+			_additional_messages.push_back(pos);
+			break;
+
+		default:
+			break;
+		}
+
+		pos = next_pos;
+	}
+
+	return num_data_messages;
+}
+
+int ULogReader::sizeOfType(const char *type_name, int type_len)
+{
+	static constexpr struct {
+		const char *name;
+		int size;
+	} types[] = {
+		{"int8_t", 1}, {"uint8_t", 1}, {"int16_t", 2}, {"uint16_t", 2}, {"int32_t", 4}, {"uint32_t", 4},
+		{"int64_t", 8}, {"uint64_t", 8}, {"float", 4}, {"double", 8}, {"char", 1}, {"bool", 1},
+	};
+
+	for (const auto &type : types) {
+		if ((int)strlen(type.name) == type_len && strncmp(type.name, type_name, type_len) == 0) {
+			return type.size;
+		}
+	}
+
+	// nested type
+	const orb_metadata *const *topics = orb_get_topics();
+
+	for (size_t i = 0; i < orb_topics_count(); i++) {
+		if ((int)strlen(topics[i]->o_name) == type_len && strncmp(topics[i]->o_name, type_name, type_len) == 0) {
+			return topics[i]->o_size;
+		}
+	}
+
+	return 0;
+}
+
+const char *ULogReader::nextField(const char *format, Field &field, bool &error)
+{
+	// format looks like this for example: "uint64_t timestamp;uint8_t[5] array;"
+	error = false;
+
+	if (!format || !*format) {
+		return nullptr;
+	}
+
+	const char *space = strchr(format, ' ');
+	const char *end = strchr(format, ';');
+
+	if (!end) {
+		end = format + strlen(format);
+	}
+
+	if (!space || space > end) {
+		error = true;
+		return nullptr;
+	}
+
+	const char *array_start = (const char *)memchr(format, '[', space - format);
+	field.type = format;
+	field.array_size = 1;
+
+	if (array_start) {
+		field.type_len = array_start - format;
+		field.array_size = atoi(array_start + 1);
+
+	} else {
+		field.type_len = space - format;
+	}
+
+	field.name = space + 1;
+	field.name_len = end - field.name;
+	field.size = sizeOfType(field.type, field.type_len) * field.array_size;
+
+	if (field.size == 0) {
+		PX4_ERR("unknown type: %.*s", field.type_len, field.type);
+		error = true;
+		return nullptr;
+	}
+
+	return *end ? end + 1 : end;
+}
+
+bool ULogReader::parseFormat(const char *format, std::vector<Field> &fields)
+{
+	fields.clear();
+	Field field;
+	bool error;
+	int offset = 0;
+
+	while ((format = nextField(format, field, error))) {
+		field.offset = offset;
+		offset += field.size;
+		fields.push_back(field);
+	}
+
+	return !error;
+}
+
+bool ULogReader::findFieldOffset(const char *format, const char *field_name, int &offset, int &field_size)
+{
+	const int field_name_len = strlen(field_name);
+	Field field;
+	bool error;
+	offset = 0;
+	field_size = 0;
+
+	while ((format = nextField(format, field, error))) {
+		if (field.name_len == field_name_len && strncmp(field.name, field_name, field_name_len) == 0) {
+			field_size = field.size;
+			return true;
+		}
+
+		offset += field.size;
+	}
+
+	return false;
+}
+
+} // namespace ulog
+} // namespace px4
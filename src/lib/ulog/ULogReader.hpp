@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file ULogReader.hpp
+ *
+ * Memory mapped ULog file reader with an index of the data messages.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include <logger/messages.h>
+
+namespace px4
+{
+namespace ulog
+{
+
+/**
+ * @class ULogReader
+ * Maps a ULog file into memory, so that messages can be accessed in place (without reads or seeks),
+ * and indexes the data messages of every msg_id.
+ */
+class ULogReader
+{
+public:
+	ULogReader() = default;
+	~ULogReader();
+
+	ULogReader(const ULogReader &) = delete;
+	ULogReader &operator=(const ULogReader &) = delete;
+
+	/**
+	 * Map a file into memory
+	 * @return true on success
+	 */
+	bool open(const char *file_name);
+
+	void close();
+
+	bool isOpen() const { return _data != nullptr; }
+
+	const uint8_t *data() const { return _data; }
+	size_t size() const { return _size; }
+
+	/**
+	 * Get the header of the message at a file offset
+	 * @return false if the message is not (completely) within the file
+	 */
+	bool messageHeader(uint64_t offset, ulog_message_header_s &header) const;
+
+	/**
+	 * @return pointer to the payload of the message at offset (after the header)
+	 */
+	const uint8_t *messagePayload(uint64_t offset) const { return _data + offset + ULOG_MSG_HEADER_LEN; }
+
+	/**
+	 * Index all messages in the range [start, end), typically from the first ADD_LOGGED_MSG
+	 * to the end of the file (or the appended data).
+	 * @return number of indexed data messages
+	 */
+	size_t buildIndex(uint64_t start, uint64_t end);
+
+	/**
+	 * @return file offsets of the data messages of msg_id in file order
+	 */
+	const std::vector<uint64_t> &dataMessages(uint16_t msg_id) const
+	{
+		return msg_id < _data_index.size() ? _data_index[msg_id] : _empty;
+	}
+
+	/** file offsets of all ADD_LOGGED_MSG messages */
+	const std::vector<uint64_t> &addLoggedMessages() const { return _add_logged_messages; }
+
+	/** file offsets of all PARAMETER and DROPOUT messages in the data section */
+	const std::vector<uint64_t> &additionalMessages() const { return _additional_messages; }
+
+	struct Field {
+		const char *type; ///< pointer into the format string (not null-terminated)
+		int type_len;
+		const char *name; ///< pointer into the format string (not null-terminated)
+		int name_len;
+		int array_size;
+		int offset; ///< [bytes] from the start of the message data
+		int size; ///< [bytes] including all array elements
+	};
+
+	/**
+	 * Parse a format (the field list, e.g. an orb_metadata::o_fields string) into the field offsets, so that
+	 * the fields can be accessed directly afterwards. Nested types are resolved with the uORB metadata.
+	 * @return false if a type is unknown
+	 */
+	static bool parseFormat(const char *format, std::vector<Field> &fields);
+
+	/**
+	 * Find the offset and size of a field in a format without allocations
+	 * @return true if found
+	 */
+	static bool findFieldOffset(const char *format, const char *field_name, int &offset, int &field_size);
+
+	/**
+	 * @return size of a type (without array), 0 if unknown
+	 */
+	static int sizeOfType(const char *type_name, int type_len);
+
+private:
+	/**
+	 * Parse the next field of a format
+	 * @return pointer to the following field, nullptr at the end or on error
+	 */
+	static const char *nextField(const char *format, Field &field, bool &error);
+
+	const uint8_t *_data{nullptr};
+	size_t _size{0};
+
+	std::vector<std::vector<uint64_t>> _data_index;
+	std::vector<uint64_t> _add_logged_messages;
+	std::vector<uint64_t> _additional_messages;
+	const std::vector<uint64_t> _empty;
+};
+
+} // namespace ulog
+} // namespace px4
@@ -141,6 +141,8 @@ private:
 	float _ground_minus_wind_EAS{0.0f}; /**< equivalent airspeed from groundspeed minus windspeed */
 
 	bool _scale_estimation_previously_on{false}; /**< scale_estimation was on in the last cycle */
+	bool _airspeed_updated[MAX_NUM_AIRSPEED_SENSORS] {}; /**< the validator got a new sample in this cycle */
+	bool _vehicle_local_position_updated{false}; /**< new local position in this cycle */
 
 	perf_counter_t _perf_elapsed{};
 
@@ -312,12 +314,23 @@ AirspeedModule::Run()
 		input_data.vel_test_ratio = _estimator_status.vel_test_ratio;
 		input_data.mag_test_ratio = _estimator_status.mag_test_ratio;
 
-		/* iterate through all airspeed sensors, poll new data from them and update their validators */
+		/* reset takeoff_situation to true when not in air or not in fixed-wing mode */
+		if (!in_air || !fixed_wing) {
+			_in_takeoff_situation = true;
+		}
+
+		/* iterate through all airspeed sensors, only the validators of sensors with new data run the full update */
 		for (int i = 0; i < _number_of_airspeed_sensors; i++) {
 
 			/* poll airspeed data */
-			airspeed_s airspeed_raw = {};
-			_airspeed_sub[i].copy(&airspeed_raw); // poll raw airspeed topic of the i-th sensor
+			airspeed_s airspeed_raw;
+			_airspeed_updated[i] = _airspeed_sub[i].update(&airspeed_raw);
+
+			if (!_airspeed_updated[i]) {
+				_airspeed_validator[i].update_without_new_data(_time_now_usec);
+				continue;
+			}
+
 			input_data.airspeed_indicated_raw = airspeed_raw.indicated_airspeed_m_s;
 			input_data.airspeed_true_raw = airspeed_raw.true_airspeed_m_s;
 			input_data.airspeed_timestamp = airspeed_raw.timestamp;
@@ -325,15 +338,11 @@ AirspeedModule::Run()
 
 			/* update in_fixed_wing_flight for the current airspeed sensor validator */
 			/* takeoff situation is active from start till one of the sensors' IAS or groundspeed_EAS is above stall speed */
-			if (airspeed_raw.indicated_airspeed_m_s > _airspeed_stall.get() || _ground_minus_wind_EAS > _airspeed_stall.get()) {
+			if (in_air && fixed_wing
+			    && (airspeed_raw.indicated_airspeed_m_s > _airspeed_stall.get() || _ground_minus_wind_EAS > _airspeed_stall.get())) {
 				_in_takeoff_situation = false;
 			}
 
-			/* reset takeoff_situation to true when not in air or not in fixed-wing mode */
-			if (!in_air || !fixed_wing) {
-				_in_takeoff_situation = true;
-			}
-
 			input_data.in_fixed_wing_flight = (armed && fixed_wing && in_air && !_in_takeoff_situation);
 
 			/* push input data into airspeed validator */
@@ -426,7 +435,7 @@ void AirspeedModule::poll_topics()
 	_vehicle_land_detected_sub.update(&_vehicle_land_detected);
 	_vehicle_status_sub.update(&_vehicle_status);
 	_vtol_vehicle_status_sub.update(&_vtol_vehicle_status);
-	_vehicle_local_position_sub.update(&_vehicle_local_position);
+	_vehicle_local_position_updated = _vehicle_local_position_sub.update(&_vehicle_local_position);
 
 	_vehicle_local_position_valid = (_time_now_usec - _vehicle_local_position.timestamp < 1_s)
 					&& (_vehicle_local_position.timestamp > 0) && _vehicle_local_position.v_xy_valid;
@@ -439,7 +448,8 @@ void AirspeedModule::update_wind_estimator_sideslip()
 	/* update wind and airspeed estimator */
 	_wind_estimator_sideslip.update(_time_now_usec);
 
-	if (_vehicle_local_position_valid && att_valid) {
+	/* fuse sideslip only with a new velocity sample, the prediction alone is cheap */
+	if (_vehicle_local_position_updated && _vehicle_local_position_valid && att_valid) {
 		Vector3f vI(_vehicle_local_position.vx, _vehicle_local_position.vy, _vehicle_local_position.vz);
 		Quatf q(_vehicle_attitude.q);
 
@@ -566,8 +576,12 @@ void AirspeedModule::select_airspeed_and_publish()
 	/* publish sideslip-only-fusion wind topic */
 	_wind_est_pub[0].publish(_wind_estimate_sideslip);
 
-	/* publish the wind estimator states from all airspeed validators */
+	/* publish the wind estimator states of the airspeed validators that have been updated */
 	for (int i = 0; i < _number_of_airspeed_sensors; i++) {
+		if (!_airspeed_updated[i]) {
+			continue;
+		}
+
 		wind_estimate_s wind_est = _airspeed_validator[i].get_wind_estimator_states(_time_now_usec);
 		_wind_est_pub[i + 1].publish(wind_est);
 	}
@@ -602,7 +616,8 @@ is invalid and if based sensor readings or on groundspeed minus windspeed.
 Supporting the input of multiple "raw" airspeed inputs, this module automatically switches
 to a valid sensor in case of failure detection. For failure detection as well as for
 the estimation of a scale factor from IAS to EAS, it runs several wind estimators
-and also publishes those.
+and also publishes those. The estimator of a sensor only runs when the sensor has
+published new data.
 
 )DESCR_STR");
 
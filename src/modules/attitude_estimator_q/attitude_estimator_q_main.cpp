@@ -58,6 +58,7 @@
 #include <uORB/topics/sensor_combined.h>
 #include <uORB/topics/vehicle_attitude.h>
 #include <uORB/topics/vehicle_global_position.h>
+#include <uORB/topics/vehicle_imu.h>
 #include <uORB/topics/vehicle_magnetometer.h>
 #include <uORB/topics/vehicle_odometry.h>
 
@@ -93,6 +94,8 @@ private:
 
 	void update_parameters(bool force = false);
 
+	bool update_imu_subscription();
+
 	bool init_attq();
 
 	bool update(float dt);
@@ -105,7 +108,16 @@ private:
 	const float _dt_min = 0.00001f;
 	const float _dt_max = 0.02f;
 
+	static constexpr int MAX_SENSOR_COUNT = 3;
+
 	uORB::SubscriptionCallbackWorkItem _sensors_sub{this, ORB_ID(sensor_combined)};
+	uORB::SubscriptionCallbackWorkItem _vehicle_imu_subs[MAX_SENSOR_COUNT] {
+		{this, ORB_ID(vehicle_imu), 0},
+		{this, ORB_ID(vehicle_imu), 1},
+		{this, ORB_ID(vehicle_imu), 2}
+	};
+	int _imu_sub_index{-1};		///< vehicle_imu instance in use (ATT_IMU_ID), -1 for sensor_combined
+	hrt_abstime _imu_sub_last_attempt{0};
 
 	uORB::Subscription		_parameter_update_sub{ORB_ID(parameter_update)};
 	uORB::Subscription		_global_pos_sub{ORB_ID(vehicle_global_position)};
@@ -150,7 +162,8 @@ private:
 		(ParamInt<px4::params::ATT_EXT_HDG_M>) _param_att_ext_hdg_m,
 		(ParamInt<px4::params::ATT_ACC_COMP>) _param_att_acc_comp,
 		(ParamFloat<px4::params::ATT_BIAS_MAX>) _param_att_bias_mas,
-		(ParamInt<px4::params::SYS_HAS_MAG>) _param_sys_has_mag
+		(ParamInt<px4::params::SYS_HAS_MAG>) _param_sys_has_mag,
+		(ParamInt<px4::params::ATT_IMU_ID>) _param_att_imu_id
 	)
 };
 
@@ -191,27 +204,38 @@ AttitudeEstimatorQ::Run()
 {
 	if (should_exit()) {
 		_sensors_sub.unregisterCallback();
+
+		for (auto &sub : _vehicle_imu_subs) {
+			sub.unregisterCallback();
+		}
+
 		exit_and_cleanup();
 		return;
 	}
 
-	sensor_combined_s sensors;
+	if ((_imu_sub_index < 0) && (_param_att_imu_id.get() != 0) && (hrt_elapsed_time(&_imu_sub_last_attempt) > 1_s)) {
+		_imu_sub_last_attempt = hrt_absolute_time();
 
-	if (_sensors_sub.update(&sensors)) {
+		if (update_imu_subscription()) {
+			// the first vehicle_imu sample follows with the next callback
+			return;
+		}
+	}
 
-		update_parameters();
+	bool sensors_updated = false;
+	hrt_abstime timestamp = 0;
+	float imu_dt = 0.f;	// integration period of vehicle_imu, 0 for sensor_combined
 
-		// Feed validator with recent sensor data
-		if (sensors.timestamp > 0) {
-			_gyro(0) = sensors.gyro_rad[0];
-			_gyro(1) = sensors.gyro_rad[1];
-			_gyro(2) = sensors.gyro_rad[2];
-		}
+	if (_imu_sub_index >= 0) {
+		vehicle_imu_s imu;
 
-		if (sensors.accelerometer_timestamp_relative != sensor_combined_s::RELATIVE_TIMESTAMP_INVALID) {
-			_accel(0) = sensors.accelerometer_m_s2[0];
-			_accel(1) = sensors.accelerometer_m_s2[1];
-			_accel(2) = sensors.accelerometer_m_s2[2];
+		if (_vehicle_imu_subs[_imu_sub_index].update(&imu) && (imu.dt > 0)) {
+			// the rates over the integration period, i.e. the average of all samples (no aliasing)
+			imu_dt = imu.dt * 1e-6f;
+			_gyro = Vector3f{imu.delta_angle} / imu_dt;
+			_accel = Vector3f{imu.delta_velocity} / imu_dt;
+			timestamp = imu.timestamp_sample;
+			sensors_updated = true;
 
 			if (_accel.length() < 0.01f) {
 				PX4_ERR("degenerate accel!");
@@ -219,6 +243,37 @@ AttitudeEstimatorQ::Run()
 			}
 		}
 
+	} else {
+		sensor_combined_s sensors;
+
+		if (_sensors_sub.update(&sensors)) {
+			// Feed validator with recent sensor data
+			if (sensors.timestamp > 0) {
+				_gyro(0) = sensors.gyro_rad[0];
+				_gyro(1) = sensors.gyro_rad[1];
+				_gyro(2) = sensors.gyro_rad[2];
+			}
+
+			if (sensors.accelerometer_timestamp_relative != sensor_combined_s::RELATIVE_TIMESTAMP_INVALID) {
+				_accel(0) = sensors.accelerometer_m_s2[0];
+				_accel(1) = sensors.accelerometer_m_s2[1];
+				_accel(2) = sensors.accelerometer_m_s2[2];
+
+				if (_accel.length() < 0.01f) {
+					PX4_ERR("degenerate accel!");
+					return;
+				}
+			}
+
+			timestamp = sensors.timestamp;
+			sensors_updated = true;
+		}
+	}
+
+	if (sensors_updated) {
+
+		update_parameters();
+
 		// Update magnetometer
 		if (_magnetometer_sub.updated()) {
 			vehicle_magnetometer_s magnetometer;
@@ -333,14 +388,14 @@ AttitudeEstimatorQ::Run()
 			}
 		}
 
-		/* time from previous iteration */
+		/* time from previous iteration, vehicle_imu provides the exact integration period */
 		hrt_abstime now = hrt_absolute_time();
-		const float dt = math::constrain((now - _last_time) / 1e6f, _dt_min, _dt_max);
+		const float dt = math::constrain((imu_dt > 0.f) ? imu_dt : (now - _last_time) / 1e6f, _dt_min, _dt_max);
 		_last_time = now;
 
 		if (update(dt)) {
 			vehicle_attitude_s att = {};
-			att.timestamp = sensors.timestamp;
+			att.timestamp = timestamp;
 			_q.copyTo(att.q);
 
 			/* the instance count is not used here */
@@ -349,6 +404,27 @@ AttitudeEstimatorQ::Run()
 	}
 }
 
+bool
+AttitudeEstimatorQ::update_imu_subscription()
+{
+	const uint32_t device_id = _param_att_imu_id.get();
+
+	for (int i = 0; i < MAX_SENSOR_COUNT; i++) {
+		vehicle_imu_s imu{};
+
+		if (_vehicle_imu_subs[i].copy(&imu) && (imu.accel_device_id == device_id)) {
+			if (_vehicle_imu_subs[i].registerCallback()) {
+				PX4_INFO("subscribed to vehicle_imu:%d (%d)", i, device_id);
+				_sensors_sub.unregisterCallback();
+				_imu_sub_index = i;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 void
 AttitudeEstimatorQ::update_parameters(bool force)
 {
@@ -473,7 +549,7 @@ AttitudeEstimatorQ::update(float dt)
 		corr += _q.conjugate_inversed(Vector3f(0.0f, 0.0f, -mag_err)) * _param_att_w_mag.get() * gainMult;
 	}
 
-	_q.normalize();
+	// _q is already normalized (init, end of the previous update or declination rotation)
 
 
 	// Accelerometer correction
@@ -134,3 +134,18 @@ PARAM_DEFINE_INT32(ATT_ACC_COMP, 1);
  * @decimal 3
  */
 PARAM_DEFINE_FLOAT(ATT_BIAS_MAX, 0.05f);
+
+/**
+ * Device id of IMU
+ *
+ * Set to 0 to use system selected (sensor_combined) IMU,
+ * otherwise set to the device id of the desired IMU (vehicle_imu).
+ * With vehicle_imu the filter runs once per integration period on the
+ * averaged rates of all samples of the period.
+ *
+ * @group Attitude Q estimator
+ * @value 0 System Primary
+ * @category Developer
+ * @reboot_required true
+ */
+PARAM_DEFINE_INT32(ATT_IMU_ID, 0);
@@ -43,18 +43,23 @@ AnalogBattery::AnalogBattery(int index, ModuleParams *parent) :
 }
 
 void
-AnalogBattery::updateBatteryStatusRawADC(hrt_abstime timestamp, int32_t voltage_raw, int32_t current_raw,
-		bool selected_source, int priority, float throttle_normalized)
+AnalogBattery::addSampleRawADC(hrt_abstime timestamp, int32_t voltage_raw, int32_t current_raw)
 {
 	float voltage_v = (voltage_raw * _analog_params.cnt_v_volt) * _analog_params.v_div;
 	float current_a = ((current_raw * _analog_params.cnt_v_curr) - _analog_params.v_offs_cur) * _analog_params.a_per_v;
 
-	bool connected = voltage_v > BOARD_ADC_OPEN_CIRCUIT_V &&
-			 (BOARD_ADC_OPEN_CIRCUIT_V <= BOARD_VALID_UV || is_valid());
+	_connected = voltage_v > BOARD_ADC_OPEN_CIRCUIT_V &&
+		     (BOARD_ADC_OPEN_CIRCUIT_V <= BOARD_VALID_UV || is_valid());
 
+	Battery::addSample(timestamp, voltage_v, current_a);
+}
 
-	Battery::updateBatteryStatus(timestamp, voltage_v, current_a, connected,
-				     selected_source, priority, throttle_normalized, _params.source == 0);
+void
+AnalogBattery::updateBatteryStatusADC(hrt_abstime timestamp, bool selected_source, int priority,
+				      float throttle_normalized)
+{
+	Battery::updateBatteryStatusFromSamples(timestamp, _connected, selected_source, priority, throttle_normalized,
+						_params.source == 0);
 }
 
 bool AnalogBattery::is_valid()
@@ -42,17 +42,23 @@ public:
 	AnalogBattery(int index, ModuleParams *parent);
 
 	/**
-	 * Update current battery status message.
+	 * Filter and integrate an ADC sample, to be called at the full ADC rate.
 	 *
+	 * @param timestamp Time at which the ADC was read (use hrt_absolute_time())
 	 * @param voltage_raw Battery voltage read from ADC, in raw ADC counts
 	 * @param current_raw Voltage of current sense resistor, in raw ADC counts
-	 * @param timestamp Time at which the ADC was read (use hrt_absolute_time())
+	 */
+	void addSampleRawADC(hrt_abstime timestamp, int32_t voltage_raw, int32_t current_raw);
+
+	/**
+	 * Update current battery status message from the ADC samples since the last update.
+	 *
+	 * @param timestamp Time of the update (use hrt_absolute_time())
 	 * @param selected_source This battery is on the brick that the selected source for selected_source
 	 * @param priority: The brick number -1. The term priority refers to the Vn connection on the LTC4417
 	 * @param throttle_normalized Throttle of the vehicle, between 0 and 1
 	 */
-	void updateBatteryStatusRawADC(hrt_abstime timestamp, int32_t voltage_raw, int32_t current_raw,
-				       bool selected_source, int priority, float throttle_normalized);
+	void updateBatteryStatusADC(hrt_abstime timestamp, bool selected_source, int priority, float throttle_normalized);
 
 	/**
 	 * Whether the ADC channel for the voltage of this battery is valid.
@@ -99,4 +105,7 @@ protected:
 	} _analog_params;
 
 	virtual void updateParams() override;
+
+private:
+	bool _connected{false};	///< connected state of the last sample
 };
@@ -65,3 +65,16 @@ PARAM_DEFINE_FLOAT(BAT_CNT_V_CURR, -1.0);
  * @decimal 8
  */
 PARAM_DEFINE_FLOAT(BAT_V_OFFS_CURR, 0.0);
+
+/**
+ * Battery status publication rate
+ *
+ * Rate at which battery_status of the analog batteries is published. The discharged
+ * capacity is integrated at the full ADC rate independently of it.
+ *
+ * @group Battery Calibration
+ * @unit Hz
+ * @min 1
+ * @max 100
+ */
+PARAM_DEFINE_INT32(BAT_PUB_RATE, 10);
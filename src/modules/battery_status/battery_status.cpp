@@ -123,6 +123,12 @@ private:
 
 	perf_counter_t	_loop_perf;			/**< loop performance counter */
 
+	hrt_abstime	_last_publish{0};		/**< last battery_status update */
+
+	DEFINE_PARAMETERS(
+		(ParamInt<px4::params::BAT_PUB_RATE>) _param_bat_pub_rate
+	)
+
 	/**
 	 * Check for changes in parameters.
 	 */
@@ -235,19 +241,32 @@ BatteryStatus::adc_poll()
 			}
 		}
 
+		const hrt_abstime now = hrt_absolute_time();
+
+		/* the discharged capacity is integrated at the ADC rate, battery_status is updated at BAT_PUB_RATE */
 		for (int b = 0; b < BOARD_NUMBER_BRICKS; b++) {
 			if (_analogBatteries[b]->source() == 0) {
-				actuator_controls_s ctrl{};
-				_actuator_ctrl_0_sub.copy(&ctrl);
-
-				_analogBatteries[b]->updateBatteryStatusRawADC(
-					hrt_absolute_time(),
-					bat_voltage_adc_readings[b],
-					bat_current_adc_readings[b],
-					selected_source == b,
-					b,
-					ctrl.control[actuator_controls_s::INDEX_THROTTLE]
-				);
+				_analogBatteries[b]->addSampleRawADC(now, bat_voltage_adc_readings[b], bat_current_adc_readings[b]);
+			}
+		}
+
+		const hrt_abstime publish_interval = 1_s / math::constrain((int)_param_bat_pub_rate.get(), 1, 100);
+
+		if (now - _last_publish >= publish_interval) {
+			_last_publish = now;
+
+			actuator_controls_s ctrl{};
+			_actuator_ctrl_0_sub.copy(&ctrl);
+
+			for (int b = 0; b < BOARD_NUMBER_BRICKS; b++) {
+				if (_analogBatteries[b]->source() == 0) {
+					_analogBatteries[b]->updateBatteryStatusADC(
+						now,
+						selected_source == b,
+						b,
+						ctrl.control[actuator_controls_s::INDEX_THROTTLE]
+					);
+				}
 			}
 		}
 	}
@@ -331,6 +350,9 @@ int BatteryStatus::print_usage(const char *reason)
 The provided functionality includes:
 - Read the output from the ADC driver (via ioctl interface) and publish `battery_status`.
 
+The discharged capacity is integrated at the full ADC rate (100 Hz), while `battery_status`
+is published at the lower rate `BAT_PUB_RATE`.
+
 
 ### Implementation
 It runs in its own thread and polls on the currently selected gyro topic.
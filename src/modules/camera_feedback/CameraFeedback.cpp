@@ -61,62 +61,92 @@ CameraFeedback::Run()
 
 	camera_trigger_s trig{};
 
-	if (_trigger_sub.update(&trig)) {
+	while (_trigger_sub.update(&trig)) {
 
-		// update geotagging subscriptions
+		// geotag with the state at the trigger time, or the latest one if the estimator provides no history
 		vehicle_global_position_s gpos{};
-		_gpos_sub.copy(&gpos);
-
+		vehicle_local_position_s lpos{};
 		vehicle_attitude_s att{};
-		_att_sub.copy(&att);
+
+		if (!state_history::global_position_at(trig.timestamp, gpos)) {
+			_gpos_sub.copy(&gpos);
+		}
+
+		if (!state_history::local_position_at(trig.timestamp, lpos)) {
+			_lpos_sub.copy(&lpos);
+		}
+
+		if (!state_history::attitude_at(trig.timestamp, att)) {
+			_att_sub.copy(&att);
+		}
 
 		if (trig.timestamp == 0 ||
 		    gpos.timestamp == 0 ||
 		    att.timestamp == 0) {
 
 			// reject until we have valid data
-			return;
+			continue;
 		}
 
-		camera_capture_s capture{};
+		publish_capture(trig, gpos, lpos, att);
+	}
+}
 
-		// Fill timestamps
-		capture.timestamp = trig.timestamp;
-		capture.timestamp_utc = trig.timestamp_utc;
+void
+CameraFeedback::publish_capture(const camera_trigger_s &trig, const vehicle_global_position_s &gpos,
+				const vehicle_local_position_s &lpos, const vehicle_attitude_s &att)
+{
+	camera_capture_s capture{};
 
-		// Fill image sequence
-		capture.seq = trig.seq;
+	// Fill timestamps
+	capture.timestamp = trig.timestamp;
+	capture.timestamp_utc = trig.timestamp_utc;
 
-		// Fill position data
-		capture.lat = gpos.lat;
-		capture.lon = gpos.lon;
-		capture.alt = gpos.alt;
+	// Fill image sequence
+	capture.seq = trig.seq;
 
-		if (gpos.terrain_alt_valid) {
-			capture.ground_distance = gpos.alt - gpos.terrain_alt;
+	// Fill position data
+	capture.lat = gpos.lat;
+	capture.lon = gpos.lon;
+	capture.alt = gpos.alt;
 
-		} else {
-			capture.ground_distance = -1.0f;
-		}
+	// Unless it was interpolated, the position is sampled at the estimator output rate, move it to the trigger
+	// time with the velocity of the same estimator output (the global and local position are published together)
+	const float dt = ((int64_t)trig.timestamp - (int64_t)gpos.timestamp) * 1e-6f;
 
-		// Fill attitude data
-		// TODO : this needs to be rotated by camera orientation or set to gimbal orientation when available
-		capture.q[0] = att.q[0];
-		capture.q[1] = att.q[1];
-		capture.q[2] = att.q[2];
-		capture.q[3] = att.q[3];
+	if ((lpos.timestamp == gpos.timestamp) && lpos.v_xy_valid && lpos.v_z_valid
+	    && (fabsf(dt) < MAX_COMPENSATION_INTERVAL * 1e-6f)) {
 
-		// Indicate whether capture feedback from camera is available
-		// What is case 0 for capture.result?
-		if (!_param_camera_capture_feedback.get()) {
-			capture.result = 0;
+		map_projection_reference_s ref{};
+		map_projection_init_timestamped(&ref, gpos.lat, gpos.lon, gpos.timestamp);
+		map_projection_reproject(&ref, lpos.vx * dt, lpos.vy * dt, &capture.lat, &capture.lon);
+		capture.alt -= lpos.vz * dt;
+	}
 
-		} else {
-			capture.result = 1;
-		}
+	if (gpos.terrain_alt_valid) {
+		capture.ground_distance = capture.alt - gpos.terrain_alt;
+
+	} else {
+		capture.ground_distance = -1.0f;
+	}
+
+	// Fill attitude data
+	// TODO : this needs to be rotated by camera orientation or set to gimbal orientation when available
+	capture.q[0] = att.q[0];
+	capture.q[1] = att.q[1];
+	capture.q[2] = att.q[2];
+	capture.q[3] = att.q[3];
+
+	// Indicate whether capture feedback from camera is available
+	// What is case 0 for capture.result?
+	if (!_param_camera_capture_feedback.get()) {
+		capture.result = 0;
 
-		_capture_pub.publish(capture);
+	} else {
+		capture.result = 1;
 	}
+
+	_capture_pub.publish(capture);
 }
 
 int
@@ -40,21 +40,27 @@
 
 #pragma once
 
+#include <drivers/drv_hrt.h>
+#include <lib/ecl/geo/geo.h>
 #include <lib/mathlib/mathlib.h>
 #include <lib/parameters/param.h>
+#include <lib/state_history/StateHistory.hpp>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/px4_work_queue/WorkItem.hpp>
-#include <uORB/Publication.hpp>
+#include <uORB/PublicationQueued.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionCallback.hpp>
 #include <uORB/topics/camera_capture.h>
 #include <uORB/topics/camera_trigger.h>
 #include <uORB/topics/vehicle_attitude.h>
 #include <uORB/topics/vehicle_global_position.h>
+#include <uORB/topics/vehicle_local_position.h>
+
+using namespace time_literals;
 
 class CameraFeedback : public ModuleBase<CameraFeedback>, public ModuleParams, public px4::WorkItem
 {
@@ -77,12 +83,18 @@ private:
 
 	void Run() override;
 
+	void publish_capture(const camera_trigger_s &trig, const vehicle_global_position_s &gpos,
+			     const vehicle_local_position_s &lpos, const vehicle_attitude_s &att);
+
+	static constexpr hrt_abstime MAX_COMPENSATION_INTERVAL = 100_ms; ///< max time between trigger and position sample to compensate
+
 	uORB::SubscriptionCallbackWorkItem _trigger_sub{this, ORB_ID(camera_trigger)};
 
 	uORB::Subscription	_gpos_sub{ORB_ID(vehicle_global_position)};
+	uORB::Subscription	_lpos_sub{ORB_ID(vehicle_local_position)};
 	uORB::Subscription	_att_sub{ORB_ID(vehicle_attitude)};
 
-	uORB::Publication<camera_capture_s>	_capture_pub{ORB_ID(camera_capture)};
+	uORB::PublicationQueued<camera_capture_s>	_capture_pub{ORB_ID(camera_capture)};
 
 	DEFINE_PARAMETERS(
 		(ParamBool<px4::params::CAM_CAP_FBACK>) _param_camera_capture_feedback
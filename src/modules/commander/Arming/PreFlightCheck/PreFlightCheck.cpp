@@ -43,6 +43,7 @@
 #include <systemlib/mavlink_log.h>
 #include <uORB/Subscription.hpp>
 #include <uORB/topics/subsystem_info.h>
+#include <string.h>
 
 using namespace time_literals;
 
@@ -55,6 +56,8 @@ static constexpr unsigned max_optional_mag_count = 4;
 static constexpr unsigned max_mandatory_baro_count = 1;
 static constexpr unsigned max_optional_baro_count = 1;
 
+PreFlightCheck::ParamCache PreFlightCheck::_param_cache{};
+
 bool PreFlightCheck::preflightCheck(orb_advert_t *mavlink_log_pub, vehicle_status_s &status,
 				    vehicle_status_flags_s &status_flags, const bool checkGNSS, bool reportFailures, const bool prearm,
 				    const hrt_abstime &time_since_boot)
@@ -340,8 +343,32 @@ bool PreFlightCheck::preflightCheck(orb_advert_t *mavlink_log_pub, vehicle_statu
 	return !failed;
 }
 
+bool PreFlightCheck::updateParamCache()
+{
+	const uint32_t generation = param_generation();
+
+	if (generation != _param_cache.param_generation) {
+		_param_cache.num_calibrations = 0;
+		_param_cache.rc_calibration_valid = false;
+		_param_cache.param_generation = generation;
+	}
+
+	// the generation is odd while a parameter write is in progress
+	return (generation & 1) == 0;
+}
+
 bool PreFlightCheck::check_calibration(const char *param_template, const int32_t device_id)
 {
+	const bool cacheable = updateParamCache();
+
+	for (int i = 0; i < _param_cache.num_calibrations; i++) {
+		const ParamCache::Calibration &calibration = _param_cache.calibrations[i];
+
+		if ((calibration.device_id == device_id) && (strcmp(calibration.param_template, param_template) == 0)) {
+			return calibration.found;
+		}
+	}
+
 	bool calibration_found = false;
 
 	char s[20];
@@ -372,5 +399,9 @@ bool PreFlightCheck::check_calibration(const char *param_template, const int32_t
 		instance++;
 	}
 
+	if (cacheable && (_param_cache.num_calibrations < ParamCache::MAX_CALIBRATIONS)) {
+		_param_cache.calibrations[_param_cache.num_calibrations++] = {param_template, device_id, calibration_found};
+	}
+
 	return calibration_found;
 }
@@ -112,4 +112,34 @@ private:
 	static bool failureDetectorCheck(orb_advert_t *mavlink_log_pub, const vehicle_status_s &status, const bool report_fail,
 					 const bool prearm);
 	static bool check_calibration(const char *param_template, const int32_t device_id);
+
+	/**
+	 * Results of the checks which only depend on parameters, flushed whenever a parameter changes
+	 */
+	struct ParamCache {
+		static constexpr int MAX_CALIBRATIONS = 12;
+
+		struct Calibration {
+			const char *param_template;
+			int32_t device_id;
+			bool found;
+		};
+
+		Calibration calibrations[MAX_CALIBRATIONS];
+		int num_calibrations;
+
+		int rc_calibration_result;
+		bool rc_calibration_valid;
+		bool rc_calibration_vtol;
+
+		uint32_t param_generation;
+	};
+
+	static ParamCache _param_cache;
+
+	/**
+	 * Flush the cache if parameters changed since it was filled
+	 * @return true if results can be added to the cache (no parameter write in progress)
+	 */
+	static bool updateParamCache();
 };
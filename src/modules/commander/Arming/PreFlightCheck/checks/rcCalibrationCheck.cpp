@@ -54,6 +54,13 @@
 
 int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool report_fail, bool isVTOL)
 {
+	const bool cacheable = updateParamCache();
+
+	// only the parameters are checked, reuse the last result unless the failures need to be reported
+	if (!report_fail && _param_cache.rc_calibration_valid && (_param_cache.rc_calibration_vtol == isVTOL)) {
+		return _param_cache.rc_calibration_result;
+	}
+
 	char nbuf[20];
 	param_t _parameter_handles_min, _parameter_handles_trim, _parameter_handles_max,
 		_parameter_handles_rev, _parameter_handles_dz;
@@ -75,7 +82,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC_MAP_TRANS_SW PARAMETER MISSING."); }
 
 			/* give system time to flush error message in case there are more */
-			px4_usleep(100000);
+			if (report_fail) { px4_usleep(100000); }
 			map_fail_count++;
 
 		} else {
@@ -99,7 +106,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC ERROR: PARAM %s MISSING.", rc_map_mandatory[j]); }
 
 			/* give system time to flush error message in case there are more */
-			px4_usleep(100000);
+			if (report_fail) { px4_usleep(100000); }
 			map_fail_count++;
 			j++;
 			continue;
@@ -112,7 +119,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC ERROR: %s >= NUMBER OF CHANNELS.", rc_map_mandatory[j]); }
 
 			/* give system time to flush error message in case there are more */
-			px4_usleep(100000);
+			if (report_fail) { px4_usleep(100000); }
 			map_fail_count++;
 		}
 
@@ -120,7 +127,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC ERROR: mandatory %s is unmapped.", rc_map_mandatory[j]); }
 
 			/* give system time to flush error message in case there are more */
-			px4_usleep(100000);
+			if (report_fail) { px4_usleep(100000); }
 			map_fail_count++;
 		}
 
@@ -173,7 +180,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC ERROR: RC%d_MIN < %u.", i + 1, RC_INPUT_LOWEST_MIN_US); }
 
 			/* give system time to flush error message in case there are more */
-			px4_usleep(100000);
+			if (report_fail) { px4_usleep(100000); }
 		}
 
 		if (param_max > RC_INPUT_HIGHEST_MAX_US) {
@@ -182,7 +189,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC ERROR: RC%d_MAX > %u.", i + 1, RC_INPUT_HIGHEST_MAX_US); }
 
 			/* give system time to flush error message in case there are more */
-			px4_usleep(100000);
+			if (report_fail) { px4_usleep(100000); }
 		}
 
 		if (param_trim < param_min) {
@@ -191,7 +198,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC ERROR: RC%d_TRIM < MIN (%d/%d).", i + 1, (int)param_trim, (int)param_min); }
 
 			/* give system time to flush error message in case there are more */
-			px4_usleep(100000);
+			if (report_fail) { px4_usleep(100000); }
 		}
 
 		if (param_trim > param_max) {
@@ -200,7 +207,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC ERROR: RC%d_TRIM > MAX (%d/%d).", i + 1, (int)param_trim, (int)param_max); }
 
 			/* give system time to flush error message in case there are more */
-			px4_usleep(100000);
+			if (report_fail) { px4_usleep(100000); }
 		}
 
 		/* assert deadzone is sane */
@@ -208,7 +215,7 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 			if (report_fail) { mavlink_log_critical(mavlink_log_pub, "RC ERROR: RC%d_DZ > %u.", i + 1, RC_INPUT_MAX_DEADZONE_US); }
 
 			/* give system time to flush error message in case there are more */
-			px4_usleep(100000);
+			if (report_fail) { px4_usleep(100000); }
 			count++;
 		}
 
@@ -219,17 +226,21 @@ int PreFlightCheck::rcCalibrationCheck(orb_advert_t *mavlink_log_pub, bool repor
 		}
 	}
 
-	if (channels_failed) {
+	if (channels_failed && report_fail) {
 		px4_sleep(2);
 
-		if (report_fail) {
-			mavlink_log_critical(mavlink_log_pub, "%d config error%s for %d RC channel%s.",
-					     total_fail_count,
-					     (total_fail_count > 1) ? "s" : "", channels_failed, (channels_failed > 1) ? "s" : "");
-		}
+		mavlink_log_critical(mavlink_log_pub, "%d config error%s for %d RC channel%s.",
+				     total_fail_count,
+				     (total_fail_count > 1) ? "s" : "", channels_failed, (channels_failed > 1) ? "s" : "");
 
 		px4_usleep(100000);
 	}
 
+	if (cacheable) {
+		_param_cache.rc_calibration_result = total_fail_count + map_fail_count;
+		_param_cache.rc_calibration_vtol = isVTOL;
+		_param_cache.rc_calibration_valid = true;
+	}
+
 	return total_fail_count + map_fail_count;
 }
@@ -68,6 +68,7 @@
 #include <mathlib/mathlib.h>
 #include <navigator/navigation.h>
 #include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/shutdown.h>
@@ -450,7 +451,7 @@ Commander::arm_disarm(bool arm, bool run_preflight_checks, orb_advert_t *mavlink
 
 Commander::Commander() :
 	ModuleParams(nullptr),
-	_failure_detector(this)
+	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::commander)
 {
 	_auto_disarm_landed.set_hysteresis_time_from(false, _param_com_disarm_preflight.get() * 1_s);
 
@@ -477,6 +478,11 @@ Commander::Commander() :
 	_vtol_status.vtol_in_rw_mode = true;
 }
 
+Commander::~Commander()
+{
+	ScheduleClear();
+}
+
 bool
 Commander::handle_command(vehicle_status_s *status_local, const vehicle_command_s &cmd, actuator_armed_s *armed_local,
 			  uORB::PublicationQueued<vehicle_command_ack_s> &command_ack_pub)
@@ -1186,13 +1192,28 @@ Commander::set_home_position_alt_only()
 	return false;
 }
 
-void
-Commander::run()
+bool
+Commander::init()
 {
-	bool sensor_fail_tune_played = false;
+	// react immediately to commands, RC input and detected failures, everything else is checked at the monitoring interval
+	_cmd_sub.registerCallback();
+	_sp_man_sub.registerCallback();
+	_failure_detector_status_sub.registerCallback();
+
+	// the failure detector runs on attitude updates in its own work item
+	_failure_detector.init();
 
-	const param_t param_airmode = param_find("MC_AIRMODE");
-	const param_t param_rc_map_arm_switch = param_find("RC_MAP_ARM_SW");
+	// the initialization runs on the work queue, not on the stack of the starting shell
+	ScheduleOnInterval(COMMANDER_MONITORING_INTERVAL);
+
+	return true;
+}
+
+void
+Commander::initialize()
+{
+	_param_handle_airmode = param_find("MC_AIRMODE");
+	_param_handle_rc_map_arm_switch = param_find("RC_MAP_ARM_SW");
 
 	/* initialize */
 	led_init();
@@ -1219,8 +1240,6 @@ Commander::run()
 	/* init mission state, do it here to allow navigator to use stored mission even if mavlink failed to start */
 	mission_init();
 
-	bool param_init_forced = true;
-
 	control_status_leds(&status, &armed, true, _battery_warning);
 
 	thread_running = true;
@@ -1251,12 +1270,6 @@ Commander::run()
 	_last_gpos_fail_time_us = _boot_timestamp;
 	_last_lvel_fail_time_us = _boot_timestamp;
 
-	// user adjustable duration required to assert arm/disarm via throttle/rudder stick
-	uint32_t rc_arm_hyst = _param_rc_arm_hyst.get() * COMMANDER_MONITORING_LOOPSPERMSEC;
-
-	int32_t airmode = 0;
-	int32_t rc_map_arm_switch = 0;
-
 	/* initialize low priority thread */
 	pthread_attr_t commander_low_prio_attr;
 	pthread_attr_init(&commander_low_prio_attr);
@@ -1271,8 +1284,7 @@ Commander::run()
 	param.sched_priority = SCHED_PRIORITY_DEFAULT - 50;
 	pthread_attr_setschedparam(&commander_low_prio_attr, &param);
 #endif
-	pthread_t commander_low_prio_thread;
-	pthread_create(&commander_low_prio_thread, &commander_low_prio_attr, commander_low_prio_loop, nullptr);
+	pthread_create(&_low_prio_thread, &commander_low_prio_attr, commander_low_prio_loop, nullptr);
 	pthread_attr_destroy(&commander_low_prio_attr);
 
 
@@ -1283,1003 +1295,1068 @@ Commander::run()
 	PreFlightCheck::preflightCheck(&mavlink_log_pub, status, status_flags, _arm_requirements.global_position, false, true,
 				       hrt_elapsed_time(&_boot_timestamp));
 
-	while (!should_exit()) {
+	_initialized = true;
+}
 
-		transition_result_t arming_ret = TRANSITION_NOT_CHANGED;
+void
+Commander::Run()
+{
+	if (should_exit()) {
+		ScheduleClear();
+		_cmd_sub.unregisterCallback();
+		_sp_man_sub.unregisterCallback();
+		_failure_detector_status_sub.unregisterCallback();
+		_failure_detector.stop();
 
-		/* update parameters */
-		bool params_updated = _parameter_update_sub.updated();
+		if (_initialized) {
+			thread_should_exit = true;
 
-		if (params_updated || param_init_forced) {
-			// clear update
-			parameter_update_s update;
-			_parameter_update_sub.copy(&update);
+			/* wait for threads to complete */
+			int ret = pthread_join(_low_prio_thread, nullptr);
 
-			// update parameters from storage
-			updateParams();
+			if (ret) {
+				warn("join failed: %d", ret);
+			}
 
-			/* update parameters */
-			if (!armed.armed) {
-				status.system_type = _param_mav_type.get();
+			rgbled_set_color_and_mode(led_control_s::COLOR_WHITE, led_control_s::MODE_OFF);
 
-				const bool is_rotary = is_rotary_wing(&status) || (is_vtol(&status) && _vtol_status.vtol_in_rw_mode);
-				const bool is_fixed = is_fixed_wing(&status) || (is_vtol(&status) && !_vtol_status.vtol_in_rw_mode);
-				const bool is_ground = is_ground_rover(&status);
+			/* close fds */
+			led_deinit();
+			buzzer_deinit();
+		}
 
-				/* disable manual override for all systems that rely on electronic stabilization */
-				if (is_rotary) {
-					status.vehicle_type = vehicle_status_s::VEHICLE_TYPE_ROTARY_WING;
+		thread_running = false;
 
-				} else if (is_fixed) {
-					status.vehicle_type = vehicle_status_s::VEHICLE_TYPE_FIXED_WING;
+		exit_and_cleanup();
+		return;
+	}
 
-				} else if (is_ground) {
-					status.vehicle_type = vehicle_status_s::VEHICLE_TYPE_ROVER;
-				}
+	if (!_initialized) {
+		initialize();
+	}
 
-				/* set vehicle_status.is_vtol flag */
-				status.is_vtol = is_vtol(&status);
-				status.is_vtol_tailsitter = is_vtol_tailsitter(&status);
+	// runs are triggered by the monitoring interval and additionally by commands and RC input
+	const hrt_abstime run_timestamp = hrt_absolute_time();
+	const hrt_abstime run_interval = math::min(run_timestamp - _last_run_timestamp, COMMANDER_MONITORING_INTERVAL);
+	_last_run_timestamp = run_timestamp;
 
-				/* check and update system / component ID */
-				status.system_id = _param_mav_sys_id.get();
-				status.component_id = _param_mav_comp_id.get();
+	transition_result_t arming_ret = TRANSITION_NOT_CHANGED;
 
-				get_circuit_breaker_params();
+	/* update parameters */
+	bool params_updated = _parameter_update_sub.updated();
 
-				_status_changed = true;
-			}
+	if (params_updated || _param_init_forced) {
+		// clear update
+		parameter_update_s update;
+		_parameter_update_sub.copy(&update);
 
-			status_flags.avoidance_system_required = _param_com_obs_avoid.get();
+		// update parameters from storage
+		updateParams();
 
-			status.rc_input_mode = _param_rc_in_off.get();
+		/* update parameters */
+		if (!armed.armed) {
+			status.system_type = _param_mav_type.get();
 
-			// percentage (* 0.01) needs to be doubled because RC total interval is 2, not 1
-			_min_stick_change = _param_min_stick_change.get() * 0.02f;
+			const bool is_rotary = is_rotary_wing(&status) || (is_vtol(&status) && _vtol_status.vtol_in_rw_mode);
+			const bool is_fixed = is_fixed_wing(&status) || (is_vtol(&status) && !_vtol_status.vtol_in_rw_mode);
+			const bool is_ground = is_ground_rover(&status);
 
-			rc_arm_hyst = _param_rc_arm_hyst.get() * COMMANDER_MONITORING_LOOPSPERMSEC;
+			/* disable manual override for all systems that rely on electronic stabilization */
+			if (is_rotary) {
+				status.vehicle_type = vehicle_status_s::VEHICLE_TYPE_ROTARY_WING;
 
-			_arm_requirements.arm_authorization = _param_arm_auth_required.get();
-			_arm_requirements.esc_check = _param_escs_checks_required.get();
-			_arm_requirements.global_position = !_param_arm_without_gps.get();
-			_arm_requirements.mission = _param_arm_mission_required.get();
+			} else if (is_fixed) {
+				status.vehicle_type = vehicle_status_s::VEHICLE_TYPE_FIXED_WING;
 
-			/* flight mode slots */
-			_flight_mode_slots[0] = _param_fltmode_1.get();
-			_flight_mode_slots[1] = _param_fltmode_2.get();
-			_flight_mode_slots[2] = _param_fltmode_3.get();
-			_flight_mode_slots[3] = _param_fltmode_4.get();
-			_flight_mode_slots[4] = _param_fltmode_5.get();
-			_flight_mode_slots[5] = _param_fltmode_6.get();
+			} else if (is_ground) {
+				status.vehicle_type = vehicle_status_s::VEHICLE_TYPE_ROVER;
+			}
 
-			_auto_disarm_killed.set_hysteresis_time_from(false, _param_com_kill_disarm.get() * 1_s);
+			/* set vehicle_status.is_vtol flag */
+			status.is_vtol = is_vtol(&status);
+			status.is_vtol_tailsitter = is_vtol_tailsitter(&status);
 
-			/* check for unsafe Airmode settings: yaw airmode requires the use of an arming switch */
-			if (param_airmode != PARAM_INVALID && param_rc_map_arm_switch != PARAM_INVALID) {
-				param_get(param_airmode, &airmode);
-				param_get(param_rc_map_arm_switch, &rc_map_arm_switch);
+			/* check and update system / component ID */
+			status.system_id = _param_mav_sys_id.get();
+			status.component_id = _param_mav_comp_id.get();
 
-				if (airmode == 2 && rc_map_arm_switch == 0) {
-					airmode = 1; // change to roll/pitch airmode
-					param_set(param_airmode, &airmode);
-					mavlink_log_critical(&mavlink_log_pub, "Yaw Airmode requires the use of an Arm Switch")
-				}
-			}
+			get_circuit_breaker_params();
 
-			param_init_forced = false;
+			_status_changed = true;
 		}
 
-		/* Update OA parameter */
 		status_flags.avoidance_system_required = _param_com_obs_avoid.get();
 
-		/* handle power button state */
-		if (_power_button_state_sub.updated()) {
-			power_button_state_s button_state;
+		status.rc_input_mode = _param_rc_in_off.get();
 
-			if (_power_button_state_sub.copy(&button_state)) {
-				if (button_state.event == power_button_state_s::PWR_BUTTON_STATE_REQUEST_SHUTDOWN) {
-					px4_shutdown_request(false, false);
-				}
+		// percentage (* 0.01) needs to be doubled because RC total interval is 2, not 1
+		_min_stick_change = _param_min_stick_change.get() * 0.02f;
+
+		_rc_arm_hyst = _param_rc_arm_hyst.get() * 1_ms;
+
+		_arm_requirements.arm_authorization = _param_arm_auth_required.get();
+		_arm_requirements.esc_check = _param_escs_checks_required.get();
+		_arm_requirements.global_position = !_param_arm_without_gps.get();
+		_arm_requirements.mission = _param_arm_mission_required.get();
+
+		/* flight mode slots */
+		_flight_mode_slots[0] = _param_fltmode_1.get();
+		_flight_mode_slots[1] = _param_fltmode_2.get();
+		_flight_mode_slots[2] = _param_fltmode_3.get();
+		_flight_mode_slots[3] = _param_fltmode_4.get();
+		_flight_mode_slots[4] = _param_fltmode_5.get();
+		_flight_mode_slots[5] = _param_fltmode_6.get();
+
+		_auto_disarm_killed.set_hysteresis_time_from(false, _param_com_kill_disarm.get() * 1_s);
+
+		/* check for unsafe Airmode settings: yaw airmode requires the use of an arming switch */
+		if (_param_handle_airmode != PARAM_INVALID && _param_handle_rc_map_arm_switch != PARAM_INVALID) {
+			int32_t airmode = 0;
+			int32_t rc_map_arm_switch = 0;
+			param_get(_param_handle_airmode, &airmode);
+			param_get(_param_handle_rc_map_arm_switch, &rc_map_arm_switch);
+
+			if (airmode == 2 && rc_map_arm_switch == 0) {
+				airmode = 1; // change to roll/pitch airmode
+				param_set(_param_handle_airmode, &airmode);
+				mavlink_log_critical(&mavlink_log_pub, "Yaw Airmode requires the use of an Arm Switch")
+			}
+		}
+
+		_param_init_forced = false;
+	}
+
+	/* Update OA parameter */
+	status_flags.avoidance_system_required = _param_com_obs_avoid.get();
+
+	/* handle power button state */
+	if (_power_button_state_sub.updated()) {
+		power_button_state_s button_state;
+
+		if (_power_button_state_sub.copy(&button_state)) {
+			if (button_state.event == power_button_state_s::PWR_BUTTON_STATE_REQUEST_SHUTDOWN) {
+				px4_shutdown_request(false, false);
 			}
 		}
+	}
 
-		_sp_man_sub.update(&_sp_man);
+	_sp_man_sub.update(&_sp_man);
 
-		offboard_control_update();
+	offboard_control_update();
 
-		if (_system_power_sub.updated()) {
-			system_power_s system_power{};
-			_system_power_sub.copy(&system_power);
+	if (_system_power_sub.updated()) {
+		system_power_s system_power{};
+		_system_power_sub.copy(&system_power);
 
-			if (hrt_elapsed_time(&system_power.timestamp) < 200_ms) {
-				if (system_power.servo_valid &&
-				    !system_power.brick_valid &&
-				    !system_power.usb_connected) {
-					/* flying only on servo rail, this is unsafe */
-					status_flags.condition_power_input_valid = false;
+		if (hrt_elapsed_time(&system_power.timestamp) < 200_ms) {
+			if (system_power.servo_valid &&
+			    !system_power.brick_valid &&
+			    !system_power.usb_connected) {
+				/* flying only on servo rail, this is unsafe */
+				status_flags.condition_power_input_valid = false;
 
-				} else {
-					status_flags.condition_power_input_valid = true;
-				}
+			} else {
+				status_flags.condition_power_input_valid = true;
+			}
 
-				/* if the USB hardware connection went away, reboot */
-				if (status_flags.usb_connected && !system_power.usb_connected && shutdown_if_allowed()) {
-					/*
-					 * apparently the USB cable went away but we are still powered,
-					 * so lets reset to a classic non-usb state.
-					 */
-					mavlink_log_critical(&mavlink_log_pub, "USB disconnected, rebooting.")
-					px4_usleep(400000);
-					px4_shutdown_request(true, false);
-				}
+			/* if the USB hardware connection went away, reboot */
+			if (status_flags.usb_connected && !system_power.usb_connected && shutdown_if_allowed()) {
+				/*
+				 * apparently the USB cable went away but we are still powered,
+				 * so lets reset to a classic non-usb state.
+				 */
+				mavlink_log_critical(&mavlink_log_pub, "USB disconnected, rebooting.")
+				px4_usleep(400000);
+				px4_shutdown_request(true, false);
 			}
 		}
+	}
 
-		/* update safety topic */
-		if (_safety_sub.updated()) {
-			const bool previous_safety_off = _safety.safety_off;
+	/* update safety topic */
+	if (_safety_sub.updated()) {
+		const bool previous_safety_off = _safety.safety_off;
 
-			if (_safety_sub.copy(&_safety)) {
-				// disarm if safety is now on and still armed
-				if (armed.armed && _safety.safety_switch_available && !_safety.safety_off) {
+		if (_safety_sub.copy(&_safety)) {
+			// disarm if safety is now on and still armed
+			if (armed.armed && _safety.safety_switch_available && !_safety.safety_off) {
 
-					bool safety_disarm_allowed = (status.hil_state == vehicle_status_s::HIL_STATE_OFF);
+				bool safety_disarm_allowed = (status.hil_state == vehicle_status_s::HIL_STATE_OFF);
 
-					// if land detector is available then prevent disarming via safety button if not landed
-					if (hrt_elapsed_time(&_land_detector.timestamp) < 1_s) {
+				// if land detector is available then prevent disarming via safety button if not landed
+				if (hrt_elapsed_time(&_land_detector.timestamp) < 1_s) {
 
-						bool maybe_landing = (_land_detector.landed || _land_detector.maybe_landed);
+					bool maybe_landing = (_land_detector.landed || _land_detector.maybe_landed);
 
-						if (!maybe_landing) {
-							safety_disarm_allowed = false;
-						}
+					if (!maybe_landing) {
+						safety_disarm_allowed = false;
 					}
+				}
 
-					if (safety_disarm_allowed) {
-						if (TRANSITION_CHANGED == arm_disarm(false, true, &mavlink_log_pub, "Safety button")) {
-							_status_changed = true;
-						}
+				if (safety_disarm_allowed) {
+					if (TRANSITION_CHANGED == arm_disarm(false, true, &mavlink_log_pub, "Safety button")) {
+						_status_changed = true;
 					}
 				}
+			}
 
-				// Notify the user if the status of the safety switch changes
-				if (_safety.safety_switch_available && previous_safety_off != _safety.safety_off) {
-
-					if (_safety.safety_off) {
-						set_tune(TONE_NOTIFY_POSITIVE_TUNE);
+			// Notify the user if the status of the safety switch changes
+			if (_safety.safety_switch_available && previous_safety_off != _safety.safety_off) {
 
-					} else {
-						tune_neutral(true);
-					}
+				if (_safety.safety_off) {
+					set_tune(TONE_NOTIFY_POSITIVE_TUNE);
 
-					_status_changed = true;
+				} else {
+					tune_neutral(true);
 				}
+
+				_status_changed = true;
 			}
 		}
+	}
 
-		/* update vtol vehicle status*/
-		if (_vtol_vehicle_status_sub.updated()) {
-			/* vtol status changed */
-			_vtol_vehicle_status_sub.copy(&_vtol_status);
-			status.vtol_fw_permanent_stab = _vtol_status.fw_permanent_stab;
+	/* update vtol vehicle status*/
+	if (_vtol_vehicle_status_sub.updated()) {
+		/* vtol status changed */
+		_vtol_vehicle_status_sub.copy(&_vtol_status);
+		status.vtol_fw_permanent_stab = _vtol_status.fw_permanent_stab;
 
-			/* Make sure that this is only adjusted if vehicle really is of type vtol */
-			if (is_vtol(&status)) {
+		/* Make sure that this is only adjusted if vehicle really is of type vtol */
+		if (is_vtol(&status)) {
 
-				// Check if there has been any change while updating the flags
-				const auto new_vehicle_type = _vtol_status.vtol_in_rw_mode ?
-							      vehicle_status_s::VEHICLE_TYPE_ROTARY_WING :
-							      vehicle_status_s::VEHICLE_TYPE_FIXED_WING;
+			// Check if there has been any change while updating the flags
+			const auto new_vehicle_type = _vtol_status.vtol_in_rw_mode ?
+						      vehicle_status_s::VEHICLE_TYPE_ROTARY_WING :
+						      vehicle_status_s::VEHICLE_TYPE_FIXED_WING;
 
-				if (new_vehicle_type != status.vehicle_type) {
-					status.vehicle_type = _vtol_status.vtol_in_rw_mode ?
-							      vehicle_status_s::VEHICLE_TYPE_ROTARY_WING :
-							      vehicle_status_s::VEHICLE_TYPE_FIXED_WING;
-					_status_changed = true;
-				}
+			if (new_vehicle_type != status.vehicle_type) {
+				status.vehicle_type = _vtol_status.vtol_in_rw_mode ?
+						      vehicle_status_s::VEHICLE_TYPE_ROTARY_WING :
+						      vehicle_status_s::VEHICLE_TYPE_FIXED_WING;
+				_status_changed = true;
+			}
 
-				if (status.in_transition_mode != _vtol_status.vtol_in_trans_mode) {
-					status.in_transition_mode = _vtol_status.vtol_in_trans_mode;
-					_status_changed = true;
-				}
+			if (status.in_transition_mode != _vtol_status.vtol_in_trans_mode) {
+				status.in_transition_mode = _vtol_status.vtol_in_trans_mode;
+				_status_changed = true;
+			}
 
-				if (status.in_transition_to_fw != _vtol_status.in_transition_to_fw) {
-					status.in_transition_to_fw = _vtol_status.in_transition_to_fw;
-					_status_changed = true;
-				}
+			if (status.in_transition_to_fw != _vtol_status.in_transition_to_fw) {
+				status.in_transition_to_fw = _vtol_status.in_transition_to_fw;
+				_status_changed = true;
+			}
 
-				if (status_flags.vtol_transition_failure != _vtol_status.vtol_transition_failsafe) {
-					status_flags.vtol_transition_failure = _vtol_status.vtol_transition_failsafe;
-					_status_changed = true;
-				}
+			if (status_flags.vtol_transition_failure != _vtol_status.vtol_transition_failsafe) {
+				status_flags.vtol_transition_failure = _vtol_status.vtol_transition_failsafe;
+				_status_changed = true;
+			}
 
-				const bool should_soft_stop = (status.vehicle_type != vehicle_status_s::VEHICLE_TYPE_ROTARY_WING);
+			const bool should_soft_stop = (status.vehicle_type != vehicle_status_s::VEHICLE_TYPE_ROTARY_WING);
 
-				if (armed.soft_stop != should_soft_stop) {
-					armed.soft_stop = should_soft_stop;
-					_status_changed = true;
-				}
+			if (armed.soft_stop != should_soft_stop) {
+				armed.soft_stop = should_soft_stop;
+				_status_changed = true;
 			}
 		}
+	}
 
-		if (_esc_status_sub.updated()) {
-			/* ESCs status changed */
-			esc_status_s esc_status{};
+	if (_esc_status_sub.updated()) {
+		/* ESCs status changed */
+		esc_status_s esc_status{};
 
-			if (_esc_status_sub.copy(&esc_status)) {
-				esc_status_check(esc_status);
-			}
+		if (_esc_status_sub.copy(&esc_status)) {
+			esc_status_check(esc_status);
 		}
+	}
 
-		estimator_check();
+	estimator_check();
 
-		/* Update land detector */
-		if (_land_detector_sub.updated()) {
-			_land_detector_sub.copy(&_land_detector);
+	/* Update land detector */
+	if (_land_detector_sub.updated()) {
+		_land_detector_sub.copy(&_land_detector);
 
-			// Only take actions if armed
-			if (armed.armed) {
-				if (_was_landed != _land_detector.landed) {
-					if (_land_detector.landed) {
-						mavlink_and_console_log_info(&mavlink_log_pub, "Landing detected");
+		// Only take actions if armed
+		if (armed.armed) {
+			if (_was_landed != _land_detector.landed) {
+				if (_land_detector.landed) {
+					mavlink_and_console_log_info(&mavlink_log_pub, "Landing detected");
 
-					} else {
-						mavlink_and_console_log_info(&mavlink_log_pub, "Takeoff detected");
-						_have_taken_off_since_arming = true;
-
-						// Set all position and velocity test probation durations to takeoff value
-						// This is a larger value to give the vehicle time to complete a failsafe landing
-						// if faulty sensors cause loss of navigation shortly after takeoff.
-						_gpos_probation_time_us = _param_com_pos_fs_prob.get() * 1_s;
-						_lpos_probation_time_us = _param_com_pos_fs_prob.get() * 1_s;
-						_lvel_probation_time_us = _param_com_pos_fs_prob.get() * 1_s;
-					}
+				} else {
+					mavlink_and_console_log_info(&mavlink_log_pub, "Takeoff detected");
+					_have_taken_off_since_arming = true;
+
+					// Set all position and velocity test probation durations to takeoff value
+					// This is a larger value to give the vehicle time to complete a failsafe landing
+					// if faulty sensors cause loss of navigation shortly after takeoff.
+					_gpos_probation_time_us = _param_com_pos_fs_prob.get() * 1_s;
+					_lpos_probation_time_us = _param_com_pos_fs_prob.get() * 1_s;
+					_lvel_probation_time_us = _param_com_pos_fs_prob.get() * 1_s;
 				}
+			}
 
-				if (_was_falling != _land_detector.freefall) {
-					if (_land_detector.freefall) {
-						mavlink_and_console_log_info(&mavlink_log_pub, "Freefall detected");
-					}
+			if (_was_falling != _land_detector.freefall) {
+				if (_land_detector.freefall) {
+					mavlink_and_console_log_info(&mavlink_log_pub, "Freefall detected");
 				}
 			}
-
-			_was_landed = _land_detector.landed;
-			_was_falling = _land_detector.freefall;
 		}
 
+		_was_landed = _land_detector.landed;
+		_was_falling = _land_detector.freefall;
+	}
 
-		// Auto disarm when landed or kill switch engaged
-		if (armed.armed) {
 
-			// Check for auto-disarm on landing or pre-flight
-			if (_param_com_disarm_land.get() > 0 || _param_com_disarm_preflight.get() > 0) {
+	// Auto disarm when landed or kill switch engaged
+	if (armed.armed) {
 
-				if (_param_com_disarm_land.get() > 0 && _have_taken_off_since_arming) {
-					_auto_disarm_landed.set_hysteresis_time_from(false, _param_com_disarm_land.get() * 1_s);
-					_auto_disarm_landed.set_state_and_update(_land_detector.landed, hrt_absolute_time());
+		// Check for auto-disarm on landing or pre-flight
+		if (_param_com_disarm_land.get() > 0 || _param_com_disarm_preflight.get() > 0) {
 
-				} else if (_param_com_disarm_preflight.get() > 0 && !_have_taken_off_since_arming) {
-					_auto_disarm_landed.set_hysteresis_time_from(false, _param_com_disarm_preflight.get() * 1_s);
-					_auto_disarm_landed.set_state_and_update(true, hrt_absolute_time());
-				}
+			if (_param_com_disarm_land.get() > 0 && _have_taken_off_since_arming) {
+				_auto_disarm_landed.set_hysteresis_time_from(false, _param_com_disarm_land.get() * 1_s);
+				_auto_disarm_landed.set_state_and_update(_land_detector.landed, hrt_absolute_time());
 
-				if (_auto_disarm_landed.get_state()) {
-					arm_disarm(false, true, &mavlink_log_pub, "Auto disarm initiated");
-				}
+			} else if (_param_com_disarm_preflight.get() > 0 && !_have_taken_off_since_arming) {
+				_auto_disarm_landed.set_hysteresis_time_from(false, _param_com_disarm_preflight.get() * 1_s);
+				_auto_disarm_landed.set_state_and_update(true, hrt_absolute_time());
 			}
 
-			// Auto disarm after 5 seconds if kill switch is engaged
-			_auto_disarm_killed.set_state_and_update(armed.manual_lockdown, hrt_absolute_time());
-
-			if (_auto_disarm_killed.get_state()) {
-				arm_disarm(false, true, &mavlink_log_pub, "Kill-switch still engaged, disarming");
+			if (_auto_disarm_landed.get_state()) {
+				arm_disarm(false, true, &mavlink_log_pub, "Auto disarm initiated");
 			}
-
-		} else {
-			_auto_disarm_landed.set_state_and_update(false, hrt_absolute_time());
-			_auto_disarm_killed.set_state_and_update(false, hrt_absolute_time());
 		}
 
-		if (_geofence_warning_action_on
-		    && _internal_state.main_state != commander_state_s::MAIN_STATE_AUTO_RTL
-		    && _internal_state.main_state != commander_state_s::MAIN_STATE_AUTO_LOITER
-		    && _internal_state.main_state != commander_state_s::MAIN_STATE_AUTO_LAND) {
+		// Auto disarm after 5 seconds if kill switch is engaged
+		_auto_disarm_killed.set_state_and_update(armed.manual_lockdown, hrt_absolute_time());
 
-			// reset flag again when we switched out of it
-			_geofence_warning_action_on = false;
+		if (_auto_disarm_killed.get_state()) {
+			arm_disarm(false, true, &mavlink_log_pub, "Kill-switch still engaged, disarming");
 		}
 
-		_cpuload_sub.update(&_cpuload);
+	} else {
+		_auto_disarm_landed.set_state_and_update(false, hrt_absolute_time());
+		_auto_disarm_killed.set_state_and_update(false, hrt_absolute_time());
+	}
 
-		battery_status_check();
+	if (_geofence_warning_action_on
+	    && _internal_state.main_state != commander_state_s::MAIN_STATE_AUTO_RTL
+	    && _internal_state.main_state != commander_state_s::MAIN_STATE_AUTO_LOITER
+	    && _internal_state.main_state != commander_state_s::MAIN_STATE_AUTO_LAND) {
 
-		/* update subsystem info which arrives from outside of commander*/
-		subsystem_info_s info;
+		// reset flag again when we switched out of it
+		_geofence_warning_action_on = false;
+	}
 
-		while (_subsys_sub.update(&info))  {
-			set_health_flags(info.subsystem_type, info.present, info.enabled, info.ok, status);
-			_status_changed = true;
-		}
+	_cpuload_sub.update(&_cpuload);
 
-		/* If in INIT state, try to proceed to STANDBY state */
-		if (!status_flags.condition_calibration_enabled && status.arming_state == vehicle_status_s::ARMING_STATE_INIT) {
+	battery_status_check();
 
-			arming_ret = arming_state_transition(&status, _safety, vehicle_status_s::ARMING_STATE_STANDBY, &armed,
-							     true /* fRunPreArmChecks */, &mavlink_log_pub, &status_flags,
-							     _arm_requirements, hrt_elapsed_time(&_boot_timestamp));
+	/* update subsystem info which arrives from outside of commander*/
+	subsystem_info_s info;
 
-			if (arming_ret == TRANSITION_DENIED) {
-				/* do not complain if not allowed into standby */
-				arming_ret = TRANSITION_NOT_CHANGED;
-			}
+	while (_subsys_sub.update(&info))  {
+		set_health_flags(info.subsystem_type, info.present, info.enabled, info.ok, status);
+		_status_changed = true;
+	}
+
+	/* If in INIT state, try to proceed to STANDBY state */
+	if (!status_flags.condition_calibration_enabled && status.arming_state == vehicle_status_s::ARMING_STATE_INIT) {
+
+		arming_ret = arming_state_transition(&status, _safety, vehicle_status_s::ARMING_STATE_STANDBY, &armed,
+						     true /* fRunPreArmChecks */, &mavlink_log_pub, &status_flags,
+						     _arm_requirements, hrt_elapsed_time(&_boot_timestamp));
+
+		if (arming_ret == TRANSITION_DENIED) {
+			/* do not complain if not allowed into standby */
+			arming_ret = TRANSITION_NOT_CHANGED;
 		}
+	}
 
-		/* start mission result check */
-		const auto prev_mission_instance_count = _mission_result_sub.get().instance_count;
+	/* start mission result check */
+	const auto prev_mission_instance_count = _mission_result_sub.get().instance_count;
 
-		if (_mission_result_sub.update()) {
-			const mission_result_s &mission_result = _mission_result_sub.get();
+	if (_mission_result_sub.update()) {
+		const mission_result_s &mission_result = _mission_result_sub.get();
 
-			// if mission_result is valid for the current mission
-			const bool mission_result_ok = (mission_result.timestamp > _boot_timestamp)
-						       && (mission_result.instance_count > 0);
+		// if mission_result is valid for the current mission
+		const bool mission_result_ok = (mission_result.timestamp > _boot_timestamp)
+					       && (mission_result.instance_count > 0);
 
-			status_flags.condition_auto_mission_available = mission_result_ok && mission_result.valid;
+		status_flags.condition_auto_mission_available = mission_result_ok && mission_result.valid;
 
-			if (mission_result_ok) {
+		if (mission_result_ok) {
 
-				if (status.mission_failure != mission_result.failure) {
-					status.mission_failure = mission_result.failure;
-					_status_changed = true;
+			if (status.mission_failure != mission_result.failure) {
+				status.mission_failure = mission_result.failure;
+				_status_changed = true;
 
-					if (status.mission_failure) {
-						mavlink_log_critical(&mavlink_log_pub, "Mission cannot be completed");
-					}
+				if (status.mission_failure) {
+					mavlink_log_critical(&mavlink_log_pub, "Mission cannot be completed");
 				}
+			}
 
-				/* Only evaluate mission state if home is set */
-				if (status_flags.condition_home_position_valid &&
-				    (prev_mission_instance_count != mission_result.instance_count)) {
+			/* Only evaluate mission state if home is set */
+			if (status_flags.condition_home_position_valid &&
+			    (prev_mission_instance_count != mission_result.instance_count)) {
 
-					if (!status_flags.condition_auto_mission_available) {
-						/* the mission is invalid */
-						tune_mission_fail(true);
+				if (!status_flags.condition_auto_mission_available) {
+					/* the mission is invalid */
+					tune_mission_fail(true);
 
-					} else if (mission_result.warning) {
-						/* the mission has a warning */
-						tune_mission_fail(true);
+				} else if (mission_result.warning) {
+					/* the mission has a warning */
+					tune_mission_fail(true);
 
-					} else {
-						/* the mission is valid */
-						tune_mission_ok(true);
-					}
+				} else {
+					/* the mission is valid */
+					tune_mission_ok(true);
 				}
 			}
 		}
+	}
 
-		/* start geofence result check */
-		_geofence_result_sub.update(&_geofence_result);
+	/* start geofence result check */
+	_geofence_result_sub.update(&_geofence_result);
 
-		const bool in_low_battery_failsafe = _battery_warning > battery_status_s::BATTERY_WARNING_LOW;
+	const bool in_low_battery_failsafe = _battery_warning > battery_status_s::BATTERY_WARNING_LOW;
 
-		// Geofence actions
-		const bool geofence_action_enabled = _geofence_result.geofence_action != geofence_result_s::GF_ACTION_NONE;
+	// Geofence actions
+	const bool geofence_action_enabled = _geofence_result.geofence_action != geofence_result_s::GF_ACTION_NONE;
 
-		if (armed.armed
-		    && geofence_action_enabled
-		    && !in_low_battery_failsafe) {
+	if (armed.armed
+	    && geofence_action_enabled
+	    && !in_low_battery_failsafe) {
 
-			// check for geofence violation transition
-			if (_geofence_result.geofence_violated && !_geofence_violated_prev) {
+		// check for geofence violation transition
+		if (_geofence_result.geofence_violated && !_geofence_violated_prev) {
 
-				switch (_geofence_result.geofence_action) {
-				case (geofence_result_s::GF_ACTION_NONE) : {
-						// do nothing
-						break;
-					}
-
-				case (geofence_result_s::GF_ACTION_WARN) : {
-						// do nothing, mavlink critical messages are sent by navigator
-						break;
-					}
+			switch (_geofence_result.geofence_action) {
+			case (geofence_result_s::GF_ACTION_NONE) : {
+					// do nothing
+					break;
+				}
 
-				case (geofence_result_s::GF_ACTION_LOITER) : {
-						if (TRANSITION_CHANGED == main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_LOITER, status_flags,
-								&_internal_state)) {
-							_geofence_loiter_on = true;
-						}
+			case (geofence_result_s::GF_ACTION_WARN) : {
+					// do nothing, mavlink critical messages are sent by navigator
+					break;
+				}
 
-						break;
+			case (geofence_result_s::GF_ACTION_LOITER) : {
+					if (TRANSITION_CHANGED == main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_LOITER, status_flags,
+							&_internal_state)) {
+						_geofence_loiter_on = true;
 					}
 
-				case (geofence_result_s::GF_ACTION_RTL) : {
-						if (TRANSITION_CHANGED == main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_RTL, status_flags,
-								&_internal_state)) {
-							_geofence_rtl_on = true;
-						}
+					break;
+				}
 
-						break;
+			case (geofence_result_s::GF_ACTION_RTL) : {
+					if (TRANSITION_CHANGED == main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_RTL, status_flags,
+							&_internal_state)) {
+						_geofence_rtl_on = true;
 					}
 
-				case (geofence_result_s::GF_ACTION_TERMINATE) : {
-						warnx("Flight termination because of geofence");
-						mavlink_log_critical(&mavlink_log_pub, "Geofence violation! Flight terminated");
-						armed.force_failsafe = true;
-						_status_changed = true;
-						break;
-					}
+					break;
 				}
-			}
-
-			_geofence_violated_prev = _geofence_result.geofence_violated;
-
-			// reset if no longer in LOITER or if manually switched to LOITER
-			const bool in_loiter_mode = _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_LOITER;
-			const bool manual_loiter_switch_on = _sp_man.loiter_switch == manual_control_setpoint_s::SWITCH_POS_ON;
 
-			if (!in_loiter_mode || manual_loiter_switch_on) {
-				_geofence_loiter_on = false;
+			case (geofence_result_s::GF_ACTION_TERMINATE) : {
+					warnx("Flight termination because of geofence");
+					mavlink_log_critical(&mavlink_log_pub, "Geofence violation! Flight terminated");
+					armed.force_failsafe = true;
+					_status_changed = true;
+					break;
+				}
 			}
+		}
 
+		_geofence_violated_prev = _geofence_result.geofence_violated;
 
-			// reset if no longer in RTL or if manually switched to RTL
-			const bool in_rtl_mode = _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_RTL;
-			const bool manual_return_switch_on = _sp_man.return_switch == manual_control_setpoint_s::SWITCH_POS_ON;
-
-			if (!in_rtl_mode || manual_return_switch_on) {
-				_geofence_rtl_on = false;
-			}
-
-			_geofence_warning_action_on = _geofence_warning_action_on || (_geofence_loiter_on || _geofence_rtl_on);
+		// reset if no longer in LOITER or if manually switched to LOITER
+		const bool in_loiter_mode = _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_LOITER;
+		const bool manual_loiter_switch_on = _sp_man.loiter_switch == manual_control_setpoint_s::SWITCH_POS_ON;
 
-		} else {
-			// No geofence checks, reset flags
+		if (!in_loiter_mode || manual_loiter_switch_on) {
 			_geofence_loiter_on = false;
-			_geofence_rtl_on = false;
-			_geofence_warning_action_on = false;
-			_geofence_violated_prev = false;
 		}
 
-		// abort auto mode or geofence reaction if sticks are moved significantly
-		// but only if not in a low battery handling action
-		const bool is_rotary_wing = status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_ROTARY_WING;
 
-		const bool override_auto_mode =
-			(_param_rc_override.get() & OVERRIDE_AUTO_MODE_BIT) &&
-			(_internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_LAND    ||
-			 _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_RTL 	  ||
-			 _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_MISSION ||
-			 _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_LOITER);
+		// reset if no longer in RTL or if manually switched to RTL
+		const bool in_rtl_mode = _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_RTL;
+		const bool manual_return_switch_on = _sp_man.return_switch == manual_control_setpoint_s::SWITCH_POS_ON;
+
+		if (!in_rtl_mode || manual_return_switch_on) {
+			_geofence_rtl_on = false;
+		}
 
-		const bool override_offboard_mode =
-			(_param_rc_override.get() & OVERRIDE_OFFBOARD_MODE_BIT) &&
-			_internal_state.main_state == commander_state_s::MAIN_STATE_OFFBOARD;
+		_geofence_warning_action_on = _geofence_warning_action_on || (_geofence_loiter_on || _geofence_rtl_on);
 
-		if ((override_auto_mode || override_offboard_mode) && is_rotary_wing
-		    && !in_low_battery_failsafe && !_geofence_warning_action_on) {
-			// transition to previous state if sticks are touched
-			if ((_last_sp_man.timestamp != _sp_man.timestamp) &&
-			    ((fabsf(_sp_man.x - _last_sp_man.x) > _min_stick_change) ||
-			     (fabsf(_sp_man.y - _last_sp_man.y) > _min_stick_change) ||
-			     (fabsf(_sp_man.z - _last_sp_man.z) > _min_stick_change) ||
-			     (fabsf(_sp_man.r - _last_sp_man.r) > _min_stick_change))) {
+	} else {
+		// No geofence checks, reset flags
+		_geofence_loiter_on = false;
+		_geofence_rtl_on = false;
+		_geofence_warning_action_on = false;
+		_geofence_violated_prev = false;
+	}
 
-				// revert to position control in any case
-				main_state_transition(status, commander_state_s::MAIN_STATE_POSCTL, status_flags, &_internal_state);
-				mavlink_log_info(&mavlink_log_pub, "Autonomy off! Returned control to pilot");
-			}
+	// abort auto mode or geofence reaction if sticks are moved significantly
+	// but only if not in a low battery handling action
+	const bool is_rotary_wing = status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_ROTARY_WING;
+
+	const bool override_auto_mode =
+		(_param_rc_override.get() & OVERRIDE_AUTO_MODE_BIT) &&
+		(_internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_LAND    ||
+		 _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_RTL 	  ||
+		 _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_MISSION ||
+		 _internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_LOITER);
+
+	const bool override_offboard_mode =
+		(_param_rc_override.get() & OVERRIDE_OFFBOARD_MODE_BIT) &&
+		_internal_state.main_state == commander_state_s::MAIN_STATE_OFFBOARD;
+
+	if ((override_auto_mode || override_offboard_mode) && is_rotary_wing
+	    && !in_low_battery_failsafe && !_geofence_warning_action_on) {
+		// transition to previous state if sticks are touched
+		if ((_last_sp_man.timestamp != _sp_man.timestamp) &&
+		    ((fabsf(_sp_man.x - _last_sp_man.x) > _min_stick_change) ||
+		     (fabsf(_sp_man.y - _last_sp_man.y) > _min_stick_change) ||
+		     (fabsf(_sp_man.z - _last_sp_man.z) > _min_stick_change) ||
+		     (fabsf(_sp_man.r - _last_sp_man.r) > _min_stick_change))) {
+
+			// revert to position control in any case
+			main_state_transition(status, commander_state_s::MAIN_STATE_POSCTL, status_flags, &_internal_state);
+			mavlink_log_info(&mavlink_log_pub, "Autonomy off! Returned control to pilot");
 		}
+	}
 
-		/* Check for mission flight termination */
-		if (armed.armed && _mission_result_sub.get().flight_termination &&
-		    !status_flags.circuit_breaker_flight_termination_disabled) {
+	/* Check for mission flight termination */
+	if (armed.armed && _mission_result_sub.get().flight_termination &&
+	    !status_flags.circuit_breaker_flight_termination_disabled) {
 
-			armed.force_failsafe = true;
-			_status_changed = true;
+		armed.force_failsafe = true;
+		_status_changed = true;
 
-			if (!_flight_termination_printed) {
-				mavlink_log_critical(&mavlink_log_pub, "Geofence violation! Flight terminated");
-				_flight_termination_printed = true;
-			}
+		if (!_flight_termination_printed) {
+			mavlink_log_critical(&mavlink_log_pub, "Geofence violation! Flight terminated");
+			_flight_termination_printed = true;
+		}
 
-			if (_counter % (1000000 / COMMANDER_MONITORING_INTERVAL) == 0) {
-				mavlink_log_critical(&mavlink_log_pub, "Flight termination active");
-			}
+		if (hrt_elapsed_time(&_flight_termination_message_last) >= 1_s) {
+			mavlink_log_critical(&mavlink_log_pub, "Flight termination active");
+			_flight_termination_message_last = hrt_absolute_time();
 		}
+	}
 
-		/* RC input check */
-		if (!status_flags.rc_input_blocked && _sp_man.timestamp != 0 &&
-		    (hrt_elapsed_time(&_sp_man.timestamp) < (_param_com_rc_loss_t.get() * 1_s))) {
+	/* RC input check */
+	if (!status_flags.rc_input_blocked && _sp_man.timestamp != 0 &&
+	    (hrt_elapsed_time(&_sp_man.timestamp) < (_param_com_rc_loss_t.get() * 1_s))) {
 
-			/* handle the case where RC signal was regained */
-			if (!status_flags.rc_signal_found_once) {
-				status_flags.rc_signal_found_once = true;
+		/* handle the case where RC signal was regained */
+		if (!status_flags.rc_signal_found_once) {
+			status_flags.rc_signal_found_once = true;
+			set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_RCRECEIVER, true, true, status_flags.rc_calibration_valid, status);
+			_status_changed = true;
+
+		} else {
+			if (status.rc_signal_lost) {
+				mavlink_log_info(&mavlink_log_pub, "Manual control regained after %llums",
+						 hrt_elapsed_time(&_rc_signal_lost_timestamp) / 1000);
 				set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_RCRECEIVER, true, true, status_flags.rc_calibration_valid, status);
 				_status_changed = true;
-
-			} else {
-				if (status.rc_signal_lost) {
-					mavlink_log_info(&mavlink_log_pub, "Manual control regained after %llums",
-							 hrt_elapsed_time(&_rc_signal_lost_timestamp) / 1000);
-					set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_RCRECEIVER, true, true, status_flags.rc_calibration_valid, status);
-					_status_changed = true;
-				}
 			}
+		}
 
-			status.rc_signal_lost = false;
-
-			const bool in_armed_state = (status.arming_state == vehicle_status_s::ARMING_STATE_ARMED);
-			const bool arm_switch_or_button_mapped = _sp_man.arm_switch != manual_control_setpoint_s::SWITCH_POS_NONE;
-			const bool arm_button_pressed = _param_arm_switch_is_button.get()
-							&& (_sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_ON);
-
-			/* DISARM
-			 * check if left stick is in lower left position or arm button is pushed or arm switch has transition from arm to disarm
-			 * and we are in MANUAL, Rattitude, or AUTO_READY mode or (ASSIST mode and landed)
-			 * do it only for rotary wings in manual mode or fixed wing if landed.
-			 * Disable stick-disarming if arming switch or button is mapped */
-			const bool stick_in_lower_left = _sp_man.r < -STICK_ON_OFF_LIMIT && (_sp_man.z < 0.1f) && !arm_switch_or_button_mapped;
-			const bool arm_switch_to_disarm_transition = !_param_arm_switch_is_button.get() &&
-					(_last_sp_man_arm_switch == manual_control_setpoint_s::SWITCH_POS_ON) &&
-					(_sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_OFF);
-
-			if (in_armed_state &&
-			    (status.rc_input_mode != vehicle_status_s::RC_IN_MODE_OFF) &&
-			    (status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_ROTARY_WING || _land_detector.landed) &&
-			    (stick_in_lower_left || arm_button_pressed || arm_switch_to_disarm_transition)) {
-
-				const bool manual_thrust_mode = _internal_state.main_state == commander_state_s::MAIN_STATE_MANUAL
-								|| _internal_state.main_state == commander_state_s::MAIN_STATE_ACRO
-								|| _internal_state.main_state == commander_state_s::MAIN_STATE_STAB
-								|| _internal_state.main_state == commander_state_s::MAIN_STATE_RATTITUDE;
-				const bool rc_wants_disarm = (_stick_off_counter == rc_arm_hyst && _stick_on_counter < rc_arm_hyst)
-							     || arm_switch_to_disarm_transition;
-
-				if (rc_wants_disarm && (_land_detector.landed || manual_thrust_mode)) {
-					arming_ret = arming_state_transition(&status, _safety, vehicle_status_s::ARMING_STATE_STANDBY, &armed,
-									     true /* fRunPreArmChecks */,
-									     &mavlink_log_pub, &status_flags, _arm_requirements, hrt_elapsed_time(&_boot_timestamp));
-				}
-
-				_stick_off_counter++;
-
-			} else if (!(_param_arm_switch_is_button.get() && _sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_ON)) {
-				/* do not reset the counter when holding the arm button longer than needed */
-				_stick_off_counter = 0;
-			}
-
-			/* ARM
-			 * check if left stick is in lower right position or arm button is pushed or arm switch has transition from disarm to arm
-			 * and we're in MANUAL mode.
-			 * Disable stick-arming if arming switch or button is mapped */
-			const bool stick_in_lower_right = _sp_man.r > STICK_ON_OFF_LIMIT && _sp_man.z < 0.1f
-							  && !arm_switch_or_button_mapped;
-			/* allow a grace period for re-arming: preflight checks don't need to pass during that time,
-			 * for example for accidential in-air disarming */
-			const bool in_arming_grace_period = (_last_disarmed_timestamp != 0)
-							    && (hrt_elapsed_time(&_last_disarmed_timestamp) < 5_s);
-
-			const bool arm_switch_to_arm_transition = !_param_arm_switch_is_button.get() &&
-					(_last_sp_man_arm_switch == manual_control_setpoint_s::SWITCH_POS_OFF) &&
-					(_sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_ON) &&
-					(_sp_man.z < 0.1f || in_arming_grace_period);
-
-			if (!in_armed_state &&
-			    (status.rc_input_mode != vehicle_status_s::RC_IN_MODE_OFF) &&
-			    (stick_in_lower_right || arm_button_pressed || arm_switch_to_arm_transition)) {
-
-				if ((_stick_on_counter == rc_arm_hyst && _stick_off_counter < rc_arm_hyst) || arm_switch_to_arm_transition) {
-
-					/* we check outside of the transition function here because the requirement
-					 * for being in manual mode only applies to manual arming actions.
-					 * the system can be armed in auto if armed via the GCS.
-					 */
-					if ((_internal_state.main_state != commander_state_s::MAIN_STATE_MANUAL)
-					    && (_internal_state.main_state != commander_state_s::MAIN_STATE_ACRO)
-					    && (_internal_state.main_state != commander_state_s::MAIN_STATE_STAB)
-					    && (_internal_state.main_state != commander_state_s::MAIN_STATE_ALTCTL)
-					    && (_internal_state.main_state != commander_state_s::MAIN_STATE_POSCTL)
-					    && (_internal_state.main_state != commander_state_s::MAIN_STATE_RATTITUDE)
-					   ) {
-						print_reject_arm("Not arming: Switch to a manual mode first");
+		status.rc_signal_lost = false;
+
+		const bool in_armed_state = (status.arming_state == vehicle_status_s::ARMING_STATE_ARMED);
+		const bool arm_switch_or_button_mapped = _sp_man.arm_switch != manual_control_setpoint_s::SWITCH_POS_NONE;
+		const bool arm_button_pressed = _param_arm_switch_is_button.get()
+						&& (_sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_ON);
+
+		/* DISARM
+		 * check if left stick is in lower left position or arm button is pushed or arm switch has transition from arm to disarm
+		 * and we are in MANUAL, Rattitude, or AUTO_READY mode or (ASSIST mode and landed)
+		 * do it only for rotary wings in manual mode or fixed wing if landed.
+		 * Disable stick-disarming if arming switch or button is mapped */
+		const bool stick_in_lower_left = _sp_man.r < -STICK_ON_OFF_LIMIT && (_sp_man.z < 0.1f) && !arm_switch_or_button_mapped;
+		const bool arm_switch_to_disarm_transition = !_param_arm_switch_is_button.get() &&
+				(_last_sp_man_arm_switch == manual_control_setpoint_s::SWITCH_POS_ON) &&
+				(_sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_OFF);
+
+		if (in_armed_state &&
+		    (status.rc_input_mode != vehicle_status_s::RC_IN_MODE_OFF) &&
+		    (status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_ROTARY_WING || _land_detector.landed) &&
+		    (stick_in_lower_left || arm_button_pressed || arm_switch_to_disarm_transition)) {
+
+			const bool manual_thrust_mode = _internal_state.main_state == commander_state_s::MAIN_STATE_MANUAL
+							|| _internal_state.main_state == commander_state_s::MAIN_STATE_ACRO
+							|| _internal_state.main_state == commander_state_s::MAIN_STATE_STAB
+							|| _internal_state.main_state == commander_state_s::MAIN_STATE_RATTITUDE;
+			// triggers once when the gesture has been held for the hysteresis time
+			const bool stick_off_hyst_reached = (_stick_off_time <= _rc_arm_hyst)
+							    && (_stick_off_time + run_interval > _rc_arm_hyst);
+			const bool rc_wants_disarm = (stick_off_hyst_reached && _stick_on_time < _rc_arm_hyst)
+						     || arm_switch_to_disarm_transition;
+
+			if (rc_wants_disarm && (_land_detector.landed || manual_thrust_mode)) {
+				arming_ret = arming_state_transition(&status, _safety, vehicle_status_s::ARMING_STATE_STANDBY, &armed,
+								     true /* fRunPreArmChecks */,
+								     &mavlink_log_pub, &status_flags, _arm_requirements, hrt_elapsed_time(&_boot_timestamp));
+			}
 
-					} else if (!status_flags.condition_home_position_valid &&
-						   (_param_geofence_action.get() == geofence_result_s::GF_ACTION_RTL)) {
+			_stick_off_time += run_interval;
 
-						print_reject_arm("Not arming: Geofence RTL requires valid home");
+		} else if (!(_param_arm_switch_is_button.get() && _sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_ON)) {
+			/* do not reset the counter when holding the arm button longer than needed */
+			_stick_off_time = 0;
+		}
 
-					} else if (status.arming_state == vehicle_status_s::ARMING_STATE_STANDBY) {
-						arming_ret = arming_state_transition(&status, _safety, vehicle_status_s::ARMING_STATE_ARMED, &armed,
-										     !in_arming_grace_period /* fRunPreArmChecks */,
-										     &mavlink_log_pub, &status_flags, _arm_requirements, hrt_elapsed_time(&_boot_timestamp));
+		/* ARM
+		 * check if left stick is in lower right position or arm button is pushed or arm switch has transition from disarm to arm
+		 * and we're in MANUAL mode.
+		 * Disable stick-arming if arming switch or button is mapped */
+		const bool stick_in_lower_right = _sp_man.r > STICK_ON_OFF_LIMIT && _sp_man.z < 0.1f
+						  && !arm_switch_or_button_mapped;
+		/* allow a grace period for re-arming: preflight checks don't need to pass during that time,
+		 * for example for accidential in-air disarming */
+		const bool in_arming_grace_period = (_last_disarmed_timestamp != 0)
+						    && (hrt_elapsed_time(&_last_disarmed_timestamp) < 5_s);
+
+		const bool arm_switch_to_arm_transition = !_param_arm_switch_is_button.get() &&
+				(_last_sp_man_arm_switch == manual_control_setpoint_s::SWITCH_POS_OFF) &&
+				(_sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_ON) &&
+				(_sp_man.z < 0.1f || in_arming_grace_period);
+
+		if (!in_armed_state &&
+		    (status.rc_input_mode != vehicle_status_s::RC_IN_MODE_OFF) &&
+		    (stick_in_lower_right || arm_button_pressed || arm_switch_to_arm_transition)) {
+
+			const bool stick_on_hyst_reached = (_stick_on_time <= _rc_arm_hyst)
+							   && (_stick_on_time + run_interval > _rc_arm_hyst);
+
+			if ((stick_on_hyst_reached && _stick_off_time < _rc_arm_hyst) || arm_switch_to_arm_transition) {
+
+				/* we check outside of the transition function here because the requirement
+				 * for being in manual mode only applies to manual arming actions.
+				 * the system can be armed in auto if armed via the GCS.
+				 */
+				if ((_internal_state.main_state != commander_state_s::MAIN_STATE_MANUAL)
+				    && (_internal_state.main_state != commander_state_s::MAIN_STATE_ACRO)
+				    && (_internal_state.main_state != commander_state_s::MAIN_STATE_STAB)
+				    && (_internal_state.main_state != commander_state_s::MAIN_STATE_ALTCTL)
+				    && (_internal_state.main_state != commander_state_s::MAIN_STATE_POSCTL)
+				    && (_internal_state.main_state != commander_state_s::MAIN_STATE_RATTITUDE)
+				   ) {
+					print_reject_arm("Not arming: Switch to a manual mode first");
+
+				} else if (!status_flags.condition_home_position_valid &&
+					   (_param_geofence_action.get() == geofence_result_s::GF_ACTION_RTL)) {
+
+					print_reject_arm("Not arming: Geofence RTL requires valid home");
+
+				} else if (status.arming_state == vehicle_status_s::ARMING_STATE_STANDBY) {
+					arming_ret = arming_state_transition(&status, _safety, vehicle_status_s::ARMING_STATE_ARMED, &armed,
+									     !in_arming_grace_period /* fRunPreArmChecks */,
+									     &mavlink_log_pub, &status_flags, _arm_requirements, hrt_elapsed_time(&_boot_timestamp));
 
-						if (arming_ret != TRANSITION_CHANGED) {
-							px4_usleep(100000);
-							print_reject_arm("Not arming: Preflight checks failed");
-						}
+					if (arming_ret != TRANSITION_CHANGED) {
+						px4_usleep(100000);
+						print_reject_arm("Not arming: Preflight checks failed");
 					}
 				}
-
-				_stick_on_counter++;
-
-			} else if (!(_param_arm_switch_is_button.get() && _sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_ON)) {
-				/* do not reset the counter when holding the arm button longer than needed */
-				_stick_on_counter = 0;
 			}
 
-			_last_sp_man_arm_switch = _sp_man.arm_switch;
+			_stick_on_time += run_interval;
 
-			if (arming_ret == TRANSITION_DENIED) {
-				/*
-				 * the arming transition can be denied to a number of reasons:
-				 *  - pre-flight check failed (sensors not ok or not calibrated)
-				 *  - safety not disabled
-				 *  - system not in manual mode
-				 */
-				tune_negative(true);
-			}
+		} else if (!(_param_arm_switch_is_button.get() && _sp_man.arm_switch == manual_control_setpoint_s::SWITCH_POS_ON)) {
+			/* do not reset the counter when holding the arm button longer than needed */
+			_stick_on_time = 0;
+		}
 
-			/* evaluate the main state machine according to mode switches */
-			bool first_rc_eval = (_last_sp_man.timestamp == 0) && (_sp_man.timestamp > 0);
-			transition_result_t main_res = set_main_state(status, &_status_changed);
+		_last_sp_man_arm_switch = _sp_man.arm_switch;
 
-			/* store last position lock state */
-			_last_condition_local_altitude_valid = status_flags.condition_local_altitude_valid;
-			_last_condition_local_position_valid = status_flags.condition_local_position_valid;
-			_last_condition_global_position_valid = status_flags.condition_global_position_valid;
+		if (arming_ret == TRANSITION_DENIED) {
+			/*
+			 * the arming transition can be denied to a number of reasons:
+			 *  - pre-flight check failed (sensors not ok or not calibrated)
+			 *  - safety not disabled
+			 *  - system not in manual mode
+			 */
+			tune_negative(true);
+		}
 
-			/* play tune on mode change only if armed, blink LED always */
-			if (main_res == TRANSITION_CHANGED || first_rc_eval) {
-				tune_positive(armed.armed);
-				_status_changed = true;
+		/* evaluate the main state machine according to mode switches */
+		bool first_rc_eval = (_last_sp_man.timestamp == 0) && (_sp_man.timestamp > 0);
+		transition_result_t main_res = set_main_state(status, &_status_changed);
 
-			} else if (main_res == TRANSITION_DENIED) {
-				/* DENIED here indicates bug in the commander */
-				mavlink_log_critical(&mavlink_log_pub, "Switching to this mode is currently not possible");
-			}
+		/* store last position lock state */
+		_last_condition_local_altitude_valid = status_flags.condition_local_altitude_valid;
+		_last_condition_local_position_valid = status_flags.condition_local_position_valid;
+		_last_condition_global_position_valid = status_flags.condition_global_position_valid;
 
-			/* check throttle kill switch */
-			if (_sp_man.kill_switch == manual_control_setpoint_s::SWITCH_POS_ON) {
-				/* set lockdown flag */
-				if (!armed.manual_lockdown) {
-					mavlink_log_emergency(&mavlink_log_pub, "Manual kill-switch engaged");
-					_status_changed = true;
-					armed.manual_lockdown = true;
-				}
+		/* play tune on mode change only if armed, blink LED always */
+		if (main_res == TRANSITION_CHANGED || first_rc_eval) {
+			tune_positive(armed.armed);
+			_status_changed = true;
 
-			} else if (_sp_man.kill_switch == manual_control_setpoint_s::SWITCH_POS_OFF) {
-				if (armed.manual_lockdown) {
-					mavlink_log_emergency(&mavlink_log_pub, "Manual kill-switch disengaged");
-					_status_changed = true;
-					armed.manual_lockdown = false;
-				}
-			}
+		} else if (main_res == TRANSITION_DENIED) {
+			/* DENIED here indicates bug in the commander */
+			mavlink_log_critical(&mavlink_log_pub, "Switching to this mode is currently not possible");
+		}
 
-			/* no else case: do not change lockdown flag in unconfigured case */
+		/* check throttle kill switch */
+		if (_sp_man.kill_switch == manual_control_setpoint_s::SWITCH_POS_ON) {
+			/* set lockdown flag */
+			if (!armed.manual_lockdown) {
+				mavlink_log_emergency(&mavlink_log_pub, "Manual kill-switch engaged");
+				_status_changed = true;
+				armed.manual_lockdown = true;
+			}
 
-		} else {
-			if (!status_flags.rc_input_blocked && !status.rc_signal_lost) {
-				mavlink_log_critical(&mavlink_log_pub, "Manual control lost");
-				status.rc_signal_lost = true;
-				_rc_signal_lost_timestamp = _sp_man.timestamp;
-				set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_RCRECEIVER, true, true, false, status);
+		} else if (_sp_man.kill_switch == manual_control_setpoint_s::SWITCH_POS_OFF) {
+			if (armed.manual_lockdown) {
+				mavlink_log_emergency(&mavlink_log_pub, "Manual kill-switch disengaged");
 				_status_changed = true;
+				armed.manual_lockdown = false;
 			}
 		}
 
-		// data link checks which update the status
-		data_link_check();
+		/* no else case: do not change lockdown flag in unconfigured case */
 
-		// engine failure detection
-		// TODO: move out of commander
-		if (_actuator_controls_sub.updated()) {
-			/* Check engine failure
-			 * only for fixed wing for now
-			 */
-			if (!status_flags.circuit_breaker_engaged_enginefailure_check &&
-			    status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_FIXED_WING && !status.is_vtol && armed.armed) {
+	} else {
+		if (!status_flags.rc_input_blocked && !status.rc_signal_lost) {
+			mavlink_log_critical(&mavlink_log_pub, "Manual control lost");
+			status.rc_signal_lost = true;
+			_rc_signal_lost_timestamp = _sp_man.timestamp;
+			set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_RCRECEIVER, true, true, false, status);
+			_status_changed = true;
+		}
+	}
 
-				actuator_controls_s actuator_controls{};
-				_actuator_controls_sub.copy(&actuator_controls);
+	// data link checks which update the status
+	data_link_check();
 
-				const float throttle = actuator_controls.control[actuator_controls_s::INDEX_THROTTLE];
-				const float current2throttle = _battery_current / throttle;
+	// engine failure detection
+	// TODO: move out of commander
+	if (_actuator_controls_sub.updated()) {
+		/* Check engine failure
+		 * only for fixed wing for now
+		 */
+		if (!status_flags.circuit_breaker_engaged_enginefailure_check &&
+		    status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_FIXED_WING && !status.is_vtol && armed.armed) {
 
-				if (((throttle > _param_ef_throttle_thres.get()) && (current2throttle < _param_ef_current2throttle_thres.get()))
-				    || status.engine_failure) {
+			actuator_controls_s actuator_controls{};
+			_actuator_controls_sub.copy(&actuator_controls);
 
-					const float elapsed = hrt_elapsed_time(&_timestamp_engine_healthy) / 1e6f;
+			const float throttle = actuator_controls.control[actuator_controls_s::INDEX_THROTTLE];
+			const float current2throttle = _battery_current / throttle;
 
-					/* potential failure, measure time */
-					if ((_timestamp_engine_healthy > 0) && (elapsed > _param_ef_time_thres.get())
-					    && !status.engine_failure) {
+			if (((throttle > _param_ef_throttle_thres.get()) && (current2throttle < _param_ef_current2throttle_thres.get()))
+			    || status.engine_failure) {
 
-						status.engine_failure = true;
-						_status_changed = true;
+				const float elapsed = hrt_elapsed_time(&_timestamp_engine_healthy) / 1e6f;
 
-						PX4_ERR("Engine Failure");
-						set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_MOTORCONTROL, true, true, false, status);
-					}
-				}
-
-			} else {
-				/* no failure reset flag */
-				_timestamp_engine_healthy = hrt_absolute_time();
+				/* potential failure, measure time */
+				if ((_timestamp_engine_healthy > 0) && (elapsed > _param_ef_time_thres.get())
+				    && !status.engine_failure) {
 
-				if (status.engine_failure) {
-					status.engine_failure = false;
+					status.engine_failure = true;
 					_status_changed = true;
+
+					PX4_ERR("Engine Failure");
+					set_health_flags(subsystem_info_s::SUBSYSTEM_TYPE_MOTORCONTROL, true, true, false, status);
 				}
 			}
+
+		} else {
+			/* no failure reset flag */
+			_timestamp_engine_healthy = hrt_absolute_time();
+
+			if (status.engine_failure) {
+				status.engine_failure = false;
+				_status_changed = true;
+			}
 		}
+	}
 
-		/* Reset main state to loiter or auto-mission after takeoff is completed.
-		 * Sometimes, the mission result topic is outdated and the mission is still signaled
-		 * as finished even though we only just started with the takeoff. Therefore, we also
-		 * check the timestamp of the mission_result topic. */
-		if (_internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_TAKEOFF
-		    && (_mission_result_sub.get().timestamp > _internal_state.timestamp)
-		    && _mission_result_sub.get().finished) {
+	/* Reset main state to loiter or auto-mission after takeoff is completed.
+	 * Sometimes, the mission result topic is outdated and the mission is still signaled
+	 * as finished even though we only just started with the takeoff. Therefore, we also
+	 * check the timestamp of the mission_result topic. */
+	if (_internal_state.main_state == commander_state_s::MAIN_STATE_AUTO_TAKEOFF
+	    && (_mission_result_sub.get().timestamp > _internal_state.timestamp)
+	    && _mission_result_sub.get().finished) {
 
-			const bool mission_available = (_mission_result_sub.get().timestamp > _boot_timestamp)
-						       && (_mission_result_sub.get().instance_count > 0) && _mission_result_sub.get().valid;
+		const bool mission_available = (_mission_result_sub.get().timestamp > _boot_timestamp)
+					       && (_mission_result_sub.get().instance_count > 0) && _mission_result_sub.get().valid;
 
-			if ((_param_takeoff_finished_action.get() == 1) && mission_available) {
-				main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_MISSION, status_flags, &_internal_state);
+		if ((_param_takeoff_finished_action.get() == 1) && mission_available) {
+			main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_MISSION, status_flags, &_internal_state);
 
-			} else {
-				main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_LOITER, status_flags, &_internal_state);
-			}
+		} else {
+			main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_LOITER, status_flags, &_internal_state);
 		}
+	}
 
-		/* check if we are disarmed and there is a better mode to wait in */
-		if (!armed.armed) {
-			/* if there is no radio control but GPS lock the user might want to fly using
-			 * just a tablet. Since the RC will force its mode switch setting on connecting
-			 * we can as well just wait in a hold mode which enables tablet control.
-			 */
-			if (status.rc_signal_lost && (_internal_state.main_state == commander_state_s::MAIN_STATE_MANUAL)
-			    && status_flags.condition_home_position_valid) {
+	/* check if we are disarmed and there is a better mode to wait in */
+	if (!armed.armed) {
+		/* if there is no radio control but GPS lock the user might want to fly using
+		 * just a tablet. Since the RC will force its mode switch setting on connecting
+		 * we can as well just wait in a hold mode which enables tablet control.
+		 */
+		if (status.rc_signal_lost && (_internal_state.main_state == commander_state_s::MAIN_STATE_MANUAL)
+		    && status_flags.condition_home_position_valid) {
 
-				main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_LOITER, status_flags, &_internal_state);
-			}
+			main_state_transition(status, commander_state_s::MAIN_STATE_AUTO_LOITER, status_flags, &_internal_state);
 		}
+	}
 
-		/* handle commands last, as the system needs to be updated to handle them */
-		if (_cmd_sub.updated()) {
-			/* got command */
-			vehicle_command_s cmd;
+	/* handle commands last, as the system needs to be updated to handle them */
+	while (_cmd_sub.updated()) {
+		/* got command */
+		vehicle_command_s cmd;
 
-			if (_cmd_sub.copy(&cmd)) {
-				if (handle_command(&status, cmd, &armed, _command_ack_pub)) {
-					_status_changed = true;
-				}
+		if (_cmd_sub.copy(&cmd)) {
+			if (handle_command(&status, cmd, &armed, _command_ack_pub)) {
+				_status_changed = true;
 			}
 		}
+	}
 
-		/* Check for failure detector status */
-		const bool failure_detector_updated = _failure_detector.update(status);
+	if (_cmd_sub.lost_messages() != _cmd_lost_messages) {
+		PX4_WARN("%u vehicle commands lost", (unsigned)(_cmd_sub.lost_messages() - _cmd_lost_messages));
+		_cmd_lost_messages = _cmd_sub.lost_messages();
+	}
 
-		if (failure_detector_updated) {
+	/* Check for failure detector status */
+	failure_detector_status_s failure_detector_status;
+	const bool failure_detector_updated = _failure_detector_status_sub.update(&failure_detector_status);
 
-			const uint8_t failure_status = _failure_detector.getStatus();
+	if (failure_detector_updated) {
 
-			if (failure_status != status.failure_detector_status) {
-				status.failure_detector_status = failure_status;
-				_status_changed = true;
-			}
+		const uint8_t failure_status = failure_detector_status.failure_status;
+
+		if (failure_status != status.failure_detector_status) {
+			status.failure_detector_status = failure_status;
+			_status_changed = true;
 		}
+	}
 
-		if (armed.armed &&
-		    failure_detector_updated &&
-		    !_flight_termination_triggered &&
-		    !status_flags.circuit_breaker_flight_termination_disabled) {
+	if (armed.armed &&
+	    failure_detector_updated &&
+	    !_flight_termination_triggered &&
+	    !status_flags.circuit_breaker_flight_termination_disabled) {
 
-			if (_failure_detector.isFailure()) {
+		if (failure_detector_status.failure_status != vehicle_status_s::FAILURE_NONE) {
 
-				armed.force_failsafe = true;
-				_status_changed = true;
+			armed.force_failsafe = true;
+			_status_changed = true;
 
-				_flight_termination_triggered = true;
+			_flight_termination_triggered = true;
 
-				mavlink_log_critical(&mavlink_log_pub, "Critical failure detected: terminate flight");
-				set_tune_override(TONE_PARACHUTE_RELEASE_TUNE);
-			}
+			mavlink_log_critical(&mavlink_log_pub, "Critical failure detected: terminate flight");
+			set_tune_override(TONE_PARACHUTE_RELEASE_TUNE);
 		}
+	}
 
-		/* Get current timestamp */
-		const hrt_abstime now = hrt_absolute_time();
-
-		// automatically set or update home position
-		if (!_home_pub.get().manual_home) {
-			const vehicle_local_position_s &local_position = _local_position_sub.get();
+	/* Get current timestamp */
+	const hrt_abstime now = hrt_absolute_time();
 
-			if (armed.armed) {
-				if ((!_was_armed || (_was_landed && !_land_detector.landed)) &&
-				    (hrt_elapsed_time(&_boot_timestamp) > INAIR_RESTART_HOLDOFF_INTERVAL)) {
+	// automatically set or update home position
+	if (!_home_pub.get().manual_home) {
+		const vehicle_local_position_s &local_position = _local_position_sub.get();
 
-					/* update home position on arming if at least 500 ms from commander start spent to avoid setting home on in-air restart */
-					set_home_position();
-				}
+		if (armed.armed) {
+			if ((!_was_armed || (_was_landed && !_land_detector.landed)) &&
+			    (hrt_elapsed_time(&_boot_timestamp) > INAIR_RESTART_HOLDOFF_INTERVAL)) {
 
-			} else {
-				if (status_flags.condition_home_position_valid) {
-					if (_land_detector.landed && local_position.xy_valid && local_position.z_valid) {
-						/* distance from home */
-						float home_dist_xy = -1.0f;
-						float home_dist_z = -1.0f;
-						mavlink_wpm_distance_to_point_local(_home_pub.get().x, _home_pub.get().y, _home_pub.get().z,
-										    local_position.x, local_position.y, local_position.z,
-										    &home_dist_xy, &home_dist_z);
-
-						if ((home_dist_xy > local_position.eph * 2.0f) || (home_dist_z > local_position.epv * 2.0f)) {
-
-							/* update when disarmed, landed and moved away from current home position */
-							set_home_position();
-						}
-					}
+				/* update home position on arming if at least 500 ms from commander start spent to avoid setting home on in-air restart */
+				set_home_position();
+			}
 
-				} else {
-					/* First time home position update - but only if disarmed */
-					set_home_position();
-
-					/* Set home position altitude to EKF origin height if home is not set and the EKF has a global origin.
-					 * This allows home altitude to be used in the calculation of height above takeoff location when GPS
-					 * use has commenced after takeoff. */
-					if (!status_flags.condition_home_position_valid) {
-						set_home_position_alt_only();
+		} else {
+			if (status_flags.condition_home_position_valid) {
+				if (_land_detector.landed && local_position.xy_valid && local_position.z_valid) {
+					/* distance from home */
+					float home_dist_xy = -1.0f;
+					float home_dist_z = -1.0f;
+					mavlink_wpm_distance_to_point_local(_home_pub.get().x, _home_pub.get().y, _home_pub.get().z,
+									    local_position.x, local_position.y, local_position.z,
+									    &home_dist_xy, &home_dist_z);
+
+					if ((home_dist_xy > local_position.eph * 2.0f) || (home_dist_z > local_position.epv * 2.0f)) {
+
+						/* update when disarmed, landed and moved away from current home position */
+						set_home_position();
 					}
 				}
-			}
-		}
-
-		// check for arming state change
-		if (_was_armed != armed.armed) {
-			_status_changed = true;
 
-			if (!armed.armed) { // increase the flight uuid upon disarming
-				const int32_t flight_uuid = _param_flight_uuid.get() + 1;
-				_param_flight_uuid.set(flight_uuid);
-				_param_flight_uuid.commit_no_notification();
-
-				_last_disarmed_timestamp = hrt_absolute_time();
+			} else {
+				/* First time home position update - but only if disarmed */
+				set_home_position();
+
+				/* Set home position altitude to EKF origin height if home is not set and the EKF has a global origin.
+				 * This allows home altitude to be used in the calculation of height above takeoff location when GPS
+				 * use has commenced after takeoff. */
+				if (!status_flags.condition_home_position_valid) {
+					set_home_position_alt_only();
+				}
 			}
 		}
+	}
 
-		_was_armed = armed.armed;
+	// check for arming state change
+	if (_was_armed != armed.armed) {
+		_status_changed = true;
 
-		/* now set navigation state according to failsafe and main state */
-		bool nav_state_changed = set_nav_state(&status,
-						       &armed,
-						       &_internal_state,
-						       &mavlink_log_pub,
-						       (link_loss_actions_t)_param_nav_dll_act.get(),
-						       _mission_result_sub.get().finished,
-						       _mission_result_sub.get().stay_in_failsafe,
-						       status_flags,
-						       _land_detector.landed,
-						       (link_loss_actions_t)_param_nav_rcl_act.get(),
-						       (offboard_loss_actions_t)_param_com_obl_act.get(),
-						       (offboard_loss_rc_actions_t)_param_com_obl_rc_act.get(),
-						       (position_nav_loss_actions_t)_param_com_posctl_navl.get());
+		if (!armed.armed) { // increase the flight uuid upon disarming
+			const int32_t flight_uuid = _param_flight_uuid.get() + 1;
+			_param_flight_uuid.set(flight_uuid);
+			_param_flight_uuid.commit_no_notification();
 
-		if (nav_state_changed) {
-			status.nav_state_timestamp = hrt_absolute_time();
+			_last_disarmed_timestamp = hrt_absolute_time();
 		}
+	}
 
-		if (status.failsafe != _failsafe_old) {
-			_status_changed = true;
+	_was_armed = armed.armed;
+
+	/* now set navigation state according to failsafe and main state */
+	bool nav_state_changed = set_nav_state(&status,
+					       &armed,
+					       &_internal_state,
+					       &mavlink_log_pub,
+					       (link_loss_actions_t)_param_nav_dll_act.get(),
+					       _mission_result_sub.get().finished,
+					       _mission_result_sub.get().stay_in_failsafe,
+					       status_flags,
+					       _land_detector.landed,
+					       (link_loss_actions_t)_param_nav_rcl_act.get(),
+					       (offboard_loss_actions_t)_param_com_obl_act.get(),
+					       (offboard_loss_rc_actions_t)_param_com_obl_rc_act.get(),
+					       (position_nav_loss_actions_t)_param_com_posctl_navl.get());
+
+	if (nav_state_changed) {
+		status.nav_state_timestamp = hrt_absolute_time();
+	}
 
-			if (status.failsafe) {
-				mavlink_log_info(&mavlink_log_pub, "Failsafe mode activated");
+	if (status.failsafe != _failsafe_old) {
+		_status_changed = true;
 
-			} else {
-				mavlink_log_info(&mavlink_log_pub, "Failsafe mode deactivated");
-			}
+		if (status.failsafe) {
+			mavlink_log_info(&mavlink_log_pub, "Failsafe mode activated");
 
-			_failsafe_old = status.failsafe;
+		} else {
+			mavlink_log_info(&mavlink_log_pub, "Failsafe mode deactivated");
 		}
 
-		/* publish states (armed, control_mode, vehicle_status, commander_state, vehicle_status_flags) at 1 Hz or immediately when changed */
-		if (hrt_elapsed_time(&status.timestamp) >= 1_s || _status_changed || nav_state_changed) {
+		_failsafe_old = status.failsafe;
+	}
 
-			update_control_mode();
+	/* publish states (armed, control_mode, vehicle_status, commander_state, vehicle_status_flags) at 1 Hz or immediately when changed */
+	if (hrt_elapsed_time(&status.timestamp) >= 1_s || _status_changed || nav_state_changed) {
 
-			status.timestamp = hrt_absolute_time();
-			_status_pub.publish(status);
+		update_control_mode();
 
-			switch ((PrearmedMode)_param_com_prearm_mode.get()) {
-			case PrearmedMode::DISABLED:
-				/* skip prearmed state  */
-				armed.prearmed = false;
-				break;
+		status.timestamp = hrt_absolute_time();
+		_status_pub.publish(status);
 
-			case PrearmedMode::ALWAYS:
-				/* safety is not present, go into prearmed
-				* (all output drivers should be started / unlocked last in the boot process
-				* when the rest of the system is fully initialized)
-				*/
-				armed.prearmed = (hrt_elapsed_time(&_boot_timestamp) > 5_s);
-				break;
-
-			case PrearmedMode::SAFETY_BUTTON:
-				if (_safety.safety_switch_available) {
-					/* safety switch is present, go into prearmed if safety is off */
-					armed.prearmed = _safety.safety_off;
+		switch ((PrearmedMode)_param_com_prearm_mode.get()) {
+		case PrearmedMode::DISABLED:
+			/* skip prearmed state  */
+			armed.prearmed = false;
+			break;
 
-				} else {
-					/* safety switch is not present, do not go into prearmed */
-					armed.prearmed = false;
-				}
+		case PrearmedMode::ALWAYS:
+			/* safety is not present, go into prearmed
+			* (all output drivers should be started / unlocked last in the boot process
+			* when the rest of the system is fully initialized)
+			*/
+			armed.prearmed = (hrt_elapsed_time(&_boot_timestamp) > 5_s);
+			break;
 
-				break;
+		case PrearmedMode::SAFETY_BUTTON:
+			if (_safety.safety_switch_available) {
+				/* safety switch is present, go into prearmed if safety is off */
+				armed.prearmed = _safety.safety_off;
 
-			default:
+			} else {
+				/* safety switch is not present, do not go into prearmed */
 				armed.prearmed = false;
-				break;
 			}
 
-			armed.timestamp = hrt_absolute_time();
-			_armed_pub.publish(armed);
+			break;
 
-			/* publish internal state for logging purposes */
-			_internal_state.timestamp = hrt_absolute_time();
-			_commander_state_pub.publish(_internal_state);
+		default:
+			armed.prearmed = false;
+			break;
+		}
+
+		armed.timestamp = hrt_absolute_time();
+		_armed_pub.publish(armed);
 
-			/* publish vehicle_status_flags */
-			status_flags.timestamp = hrt_absolute_time();
-			_vehicle_status_flags_pub.publish(status_flags);
+		if (armed.ready_to_arm && !_boot_ready_to_arm_recorded) {
+			px4_boot_profile_mark("ready to arm");
+			_boot_ready_to_arm_recorded = true;
 		}
 
-		/* play arming and battery warning tunes */
-		if (!_arm_tune_played && armed.armed &&
-		    (_safety.safety_switch_available || (_safety.safety_switch_available && _safety.safety_off))) {
+		/* publish internal state for logging purposes */
+		_internal_state.timestamp = hrt_absolute_time();
+		_commander_state_pub.publish(_internal_state);
 
-			/* play tune when armed */
-			set_tune(TONE_ARMING_WARNING_TUNE);
-			_arm_tune_played = true;
+		/* publish vehicle_status_flags */
+		status_flags.timestamp = hrt_absolute_time();
+		_vehicle_status_flags_pub.publish(status_flags);
+	}
 
-		} else if (!status_flags.usb_connected &&
-			   (status.hil_state != vehicle_status_s::HIL_STATE_ON) &&
-			   (_battery_warning == battery_status_s::BATTERY_WARNING_CRITICAL)) {
-			/* play tune on battery critical */
-			set_tune(TONE_BATTERY_WARNING_FAST_TUNE);
+	/* play arming and battery warning tunes */
+	if (!_arm_tune_played && armed.armed &&
+	    (_safety.safety_switch_available || (_safety.safety_switch_available && _safety.safety_off))) {
 
-		} else if ((status.hil_state != vehicle_status_s::HIL_STATE_ON) &&
-			   (_battery_warning == battery_status_s::BATTERY_WARNING_LOW)) {
-			/* play tune on battery warning */
-			set_tune(TONE_BATTERY_WARNING_SLOW_TUNE);
+		/* play tune when armed */
+		set_tune(TONE_ARMING_WARNING_TUNE);
+		_arm_tune_played = true;
 
-		} else if (status.failsafe) {
-			tune_failsafe(true);
+	} else if (!status_flags.usb_connected &&
+		   (status.hil_state != vehicle_status_s::HIL_STATE_ON) &&
+		   (_battery_warning == battery_status_s::BATTERY_WARNING_CRITICAL)) {
+		/* play tune on battery critical */
+		set_tune(TONE_BATTERY_WARNING_FAST_TUNE);
 
-		} else {
-			set_tune(TONE_STOP_TUNE);
-		}
+	} else if ((status.hil_state != vehicle_status_s::HIL_STATE_ON) &&
+		   (_battery_warning == battery_status_s::BATTERY_WARNING_LOW)) {
+		/* play tune on battery warning */
+		set_tune(TONE_BATTERY_WARNING_SLOW_TUNE);
 
-		/* reset arm_tune_played when disarmed */
-		if (!armed.armed || (_safety.safety_switch_available && !_safety.safety_off)) {
+	} else if (status.failsafe) {
+		tune_failsafe(true);
 
-			//Notify the user that it is safe to approach the vehicle
-			if (_arm_tune_played) {
-				tune_neutral(true);
-			}
+	} else {
+		set_tune(TONE_STOP_TUNE);
+	}
 
-			_arm_tune_played = false;
+	/* reset arm_tune_played when disarmed */
+	if (!armed.armed || (_safety.safety_switch_available && !_safety.safety_off)) {
+
+		//Notify the user that it is safe to approach the vehicle
+		if (_arm_tune_played) {
+			tune_neutral(true);
 		}
 
-		/* play sensor failure tunes if we already waited for hotplug sensors to come up and failed */
-		status_flags.condition_system_hotplug_timeout = (hrt_elapsed_time(&_boot_timestamp) > HOTPLUG_SENS_TIMEOUT);
+		_arm_tune_played = false;
+	}
 
-		if (!sensor_fail_tune_played && (!status_flags.condition_system_sensors_initialized
-						 && status_flags.condition_system_hotplug_timeout)) {
+	/* play sensor failure tunes if we already waited for hotplug sensors to come up and failed */
+	status_flags.condition_system_hotplug_timeout = (hrt_elapsed_time(&_boot_timestamp) > HOTPLUG_SENS_TIMEOUT);
 
-			set_tune_override(TONE_GPS_WARNING_TUNE);
-			sensor_fail_tune_played = true;
-			_status_changed = true;
-		}
+	if (!_sensor_fail_tune_played && (!status_flags.condition_system_sensors_initialized
+					 && status_flags.condition_system_hotplug_timeout)) {
+
+		set_tune_override(TONE_GPS_WARNING_TUNE);
+		_sensor_fail_tune_played = true;
+		_status_changed = true;
+	}
 
-		_counter++;
+	// the LED patterns are timed by the monitoring interval, runs triggered in between keep the changed flag
+	if (run_timestamp - _last_leds_update >= COMMANDER_MONITORING_INTERVAL / 2) {
+		_last_leds_update = run_timestamp;
 
 		int blink_state = blink_msg_state();
 
@@ -2296,33 +2373,14 @@ Commander::run()
 		}
 
 		_status_changed = false;
-
-		if (!armed.armed) {
-			/* Reset the flag if disarmed. */
-			_have_taken_off_since_arming = false;
-		}
-
-		arm_auth_update(now, params_updated || param_init_forced);
-
-		px4_usleep(COMMANDER_MONITORING_INTERVAL);
 	}
 
-	thread_should_exit = true;
-
-	/* wait for threads to complete */
-	int ret = pthread_join(commander_low_prio_thread, nullptr);
-
-	if (ret) {
-		warn("join failed: %d", ret);
+	if (!armed.armed) {
+		/* Reset the flag if disarmed. */
+		_have_taken_off_since_arming = false;
 	}
 
-	rgbled_set_color_and_mode(led_control_s::COLOR_WHITE, led_control_s::MODE_OFF);
-
-	/* close fds */
-	led_deinit();
-	buzzer_deinit();
-
-	thread_running = false;
+	arm_auth_update(now, params_updated || _param_init_forced);
 }
 
 void
@@ -3464,33 +3522,30 @@ int Commander::custom_command(int argc, char *argv[])
 }
 
 int Commander::task_spawn(int argc, char *argv[])
-{
-	_task_id = px4_task_spawn_cmd("commander",
-				      SCHED_DEFAULT,
-				      SCHED_PRIORITY_DEFAULT + 40,
-				      3250,
-				      (px4_main_t)&run_trampoline,
-				      (char *const *)argv);
-
-	if (_task_id < 0) {
-		_task_id = -1;
-		return -errno;
-	}
-
-	return 0;
-}
-
-Commander *Commander::instantiate(int argc, char *argv[])
 {
 	Commander *instance = new Commander();
 
 	if (instance) {
+		_object.store(instance);
+		_task_id = task_id_is_work_queue;
+
 		if (argc >= 2 && !strcmp(argv[1], "-h")) {
 			instance->enable_hil();
 		}
+
+		if (instance->init()) {
+			return PX4_OK;
+		}
+
+	} else {
+		PX4_ERR("alloc failed");
 	}
 
-	return instance;
+	delete instance;
+	_object.store(nullptr);
+	_task_id = -1;
+
+	return PX4_ERROR;
 }
 
 void Commander::enable_hil()
@@ -3785,6 +3840,15 @@ void Commander::estimator_check()
 	const vehicle_local_position_s &lpos = _local_position_sub.get();
 	const vehicle_global_position_s &gpos = _global_position_sub.get();
 
+	estimator_selector_status_s estimator_selector_status;
+
+	if (_estimator_selector_status_sub.update(&estimator_selector_status)) {
+		// follow the primary instance of the multi-IMU estimator bank
+		if (estimator_selector_status.primary_instance != _estimator_status_sub.get_instance()) {
+			_estimator_status_sub.set_topic(ORB_ID(estimator_status), estimator_selector_status.primary_instance);
+		}
+	}
+
 	const bool mag_fault_prev = (_estimator_status_sub.get().control_mode_flags & (1 << estimator_status_s::CS_MAG_FAULT));
 
 	if (_estimator_status_sub.update()) {
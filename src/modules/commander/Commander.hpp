@@ -43,6 +43,7 @@
 #include <lib/mathlib/mathlib.h>
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/module_params.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
 
 // publications
 #include <uORB/Publication.hpp>
@@ -57,12 +58,15 @@
 
 // subscriptions
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/topics/actuator_controls.h>
 #include <uORB/topics/airspeed.h>
 #include <uORB/topics/battery_status.h>
 #include <uORB/topics/cpuload.h>
 #include <uORB/topics/esc_status.h>
+#include <uORB/topics/estimator_selector_status.h>
 #include <uORB/topics/estimator_status.h>
+#include <uORB/topics/failure_detector_status.h>
 #include <uORB/topics/geofence_result.h>
 #include <uORB/topics/iridiumsbd_status.h>
 #include <uORB/topics/manual_control_setpoint.h>
@@ -87,25 +91,22 @@ using systemlib::Hysteresis;
 
 using namespace time_literals;
 
-class Commander : public ModuleBase<Commander>, public ModuleParams
+class Commander : public ModuleBase<Commander>, public ModuleParams, public px4::ScheduledWorkItem
 {
 public:
 	Commander();
+	~Commander() override;
 
 	/** @see ModuleBase */
 	static int task_spawn(int argc, char *argv[]);
 
-	/** @see ModuleBase */
-	static Commander *instantiate(int argc, char *argv[]);
-
 	/** @see ModuleBase */
 	static int custom_command(int argc, char *argv[]);
 
 	/** @see ModuleBase */
 	static int print_usage(const char *reason = nullptr);
 
-	/** @see ModuleBase::run() */
-	void run() override;
+	bool init();
 
 	void enable_hil();
 
@@ -113,6 +114,10 @@ public:
 
 private:
 
+	void Run() override;
+
+	void initialize();
+
 	transition_result_t arm_disarm(bool arm, bool run_preflight_checks, orb_advert_t *mavlink_log_pub, const char *armedBy);
 
 	void battery_status_check();
@@ -266,9 +271,8 @@ private:
 		OVERRIDE_OFFBOARD_MODE_BIT = (1 << 1)
 	};
 
-	/* Decouple update interval and hysteresis counters, all depends on intervals */
+	/* Periodic update interval, commands and RC input additionally trigger an update */
 	static constexpr uint64_t COMMANDER_MONITORING_INTERVAL{10_ms};
-	static constexpr float COMMANDER_MONITORING_LOOPSPERMSEC{1 / (COMMANDER_MONITORING_INTERVAL / 1000.0f)};
 
 	static constexpr float STICK_ON_OFF_LIMIT{0.9f};
 
@@ -345,14 +349,23 @@ private:
 	int32_t		_flight_mode_slots[manual_control_setpoint_s::MODE_SLOT_NUM] {};
 	uint8_t		_last_sp_man_arm_switch{0};
 	float		_min_stick_change{};
-	uint32_t	_stick_off_counter{0};
-	uint32_t	_stick_on_counter{0};
+	hrt_abstime	_stick_off_time{0};			///< duration the disarm gesture has been held
+	hrt_abstime	_stick_on_time{0};			///< duration the arm gesture has been held
+	hrt_abstime	_rc_arm_hyst{0};			///< duration required to assert arm/disarm via stick gesture
 
 	hrt_abstime	_boot_timestamp{0};
+	bool		_boot_ready_to_arm_recorded{false};	///< time of the first ready to arm recorded in the boot profile
 	hrt_abstime	_last_disarmed_timestamp{0};
 	hrt_abstime	_timestamp_engine_healthy{0}; ///< absolute time when engine was healty
 
-	uint32_t	_counter{0};
+	hrt_abstime	_last_run_timestamp{0};
+	hrt_abstime	_last_leds_update{0};
+	hrt_abstime	_flight_termination_message_last{0};
+
+	param_t		_param_handle_airmode{PARAM_INVALID};
+	param_t		_param_handle_rc_map_arm_switch{PARAM_INVALID};
+
+	pthread_t	_low_prio_thread{};
 
 	bool		_status_changed{true};
 	bool		_arm_tune_played{false};
@@ -362,6 +375,9 @@ private:
 	bool		_failsafe_old{false};	///< check which state machines for changes, clear "changed" flag
 	bool		_have_taken_off_since_arming{false};
 	bool		_flight_termination_printed{false};
+	bool		_sensor_fail_tune_played{false};
+	bool		_param_init_forced{true};
+	bool		_initialized{false};
 
 	main_state_t	_main_state_pre_offboard{commander_state_s::MAIN_STATE_MANUAL};
 
@@ -375,22 +391,26 @@ private:
 	// Subscriptions
 	uORB::Subscription					_actuator_controls_sub{ORB_ID_VEHICLE_ATTITUDE_CONTROLS};
 	uORB::Subscription					_battery_sub{ORB_ID(battery_status)};
-	uORB::Subscription					_cmd_sub{ORB_ID(vehicle_command)};
 	uORB::Subscription					_cpuload_sub{ORB_ID(cpuload)};
 	uORB::Subscription					_esc_status_sub{ORB_ID(esc_status)};
 	uORB::Subscription					_geofence_result_sub{ORB_ID(geofence_result)};
 	uORB::Subscription					_iridiumsbd_status_sub{ORB_ID(iridiumsbd_status)};
 	uORB::Subscription					_land_detector_sub{ORB_ID(vehicle_land_detected)};
 	uORB::Subscription					_parameter_update_sub{ORB_ID(parameter_update)};
+	uORB::Subscription					_estimator_selector_status_sub{ORB_ID(estimator_selector_status)};
 	uORB::Subscription					_power_button_state_sub{ORB_ID(power_button_state)};
 	uORB::Subscription					_safety_sub{ORB_ID(safety)};
-	uORB::Subscription					_sp_man_sub{ORB_ID(manual_control_setpoint)};
 	uORB::Subscription					_subsys_sub{ORB_ID(subsystem_info)};
 	uORB::Subscription					_system_power_sub{ORB_ID(system_power)};
 	uORB::Subscription					_telemetry_status_sub{ORB_ID(telemetry_status)};
 	uORB::Subscription					_vehicle_acceleration_sub{ORB_ID(vehicle_acceleration)};
 	uORB::Subscription					_vtol_vehicle_status_sub{ORB_ID(vtol_vehicle_status)};
 
+	uORB::SubscriptionCallbackWorkItem			_cmd_sub{this, ORB_ID(vehicle_command)};
+	uint32_t						_cmd_lost_messages{0};	///< vehicle commands lost so far (queue overflow)
+	uORB::SubscriptionCallbackWorkItem			_sp_man_sub{this, ORB_ID(manual_control_setpoint)};
+	uORB::SubscriptionCallbackWorkItem			_failure_detector_status_sub{this, ORB_ID(failure_detector_status)};
+
 	uORB::SubscriptionData<airspeed_s>			_airspeed_sub{ORB_ID(airspeed)};
 	uORB::SubscriptionData<estimator_status_s>		_estimator_status_sub{ORB_ID(estimator_status)};
 	uORB::SubscriptionData<mission_result_s>		_mission_result_sub{ORB_ID(mission_result)};
@@ -147,6 +147,7 @@
 #include <systemlib/mavlink_log.h>
 #include <uORB/topics/vehicle_attitude.h>
 #include <uORB/topics/sensor_correction.h>
+#include <uORB/topics/sensor_accel_fifo.h>
 #include <uORB/Subscription.hpp>
 
 using namespace time_literals;
@@ -161,7 +162,9 @@ static int32_t device_id_primary = 0;
 calibrate_return do_accel_calibration_measurements(orb_advert_t *mavlink_log_pub,
 		float (&accel_offs)[max_accel_sens][3], float (&accel_T)[max_accel_sens][3][3], unsigned *active_sensors);
 calibrate_return read_accelerometer_avg(int sensor_correction_sub, int (&subs)[max_accel_sens],
-					float (&accel_avg)[max_accel_sens][detect_orientation_side_count][3], unsigned orient, unsigned samples_num);
+					int (&fifo_subs)[max_accel_sens],
+					float (&accel_avg)[max_accel_sens][detect_orientation_side_count][3], unsigned orient, unsigned samples_num,
+					unsigned samples_num_fifo);
 int mat_invert3(float src[3][3], float dst[3][3]);
 calibrate_return calculate_calibration_values(unsigned sensor,
 		float (&accel_ref)[max_accel_sens][detect_orientation_side_count][3], float (&accel_T)[max_accel_sens][3][3],
@@ -172,6 +175,7 @@ typedef struct  {
 	orb_advert_t	*mavlink_log_pub;
 	unsigned	done_count;
 	int		subs[max_accel_sens];
+	int		fifo_subs[max_accel_sens];	///< sensor_accel_fifo of the same device, -1 if not available
 	float		accel_ref[max_accel_sens][detect_orientation_side_count][3];
 	int		sensor_correction_sub;
 } accel_worker_data_t;
@@ -458,14 +462,15 @@ int do_accel_calibration(orb_advert_t *mavlink_log_pub)
 
 static calibrate_return accel_calibration_worker(detect_orientation_return orientation, int cancel_sub, void *data)
 {
-	const unsigned samples_num = 750;
+	const unsigned samples_num = 750;		// sensor_accel messages
+	const unsigned samples_num_fifo = 4000;		// raw sensor_accel_fifo samples
 	accel_worker_data_t *worker_data = (accel_worker_data_t *)(data);
 
 	calibration_log_info(worker_data->mavlink_log_pub, "[cal] Hold still, measuring %s side",
 			     detect_orientation_str(orientation));
 
-	read_accelerometer_avg(worker_data->sensor_correction_sub, worker_data->subs, worker_data->accel_ref, orientation,
-			       samples_num);
+	read_accelerometer_avg(worker_data->sensor_correction_sub, worker_data->subs, worker_data->fifo_subs,
+			       worker_data->accel_ref, orientation, samples_num, samples_num_fifo);
 
 	calibration_log_info(worker_data->mavlink_log_pub, "[cal] %s side result: [%8.4f %8.4f %8.4f]",
 			     detect_orientation_str(orientation),
@@ -499,6 +504,7 @@ calibrate_return do_accel_calibration_measurements(orb_advert_t *mavlink_log_pub
 	// Initialize subs to error condition so we know which ones are open and which are not
 	for (size_t i = 0; i < max_accel_sens; i++) {
 		worker_data.subs[i] = -1;
+		worker_data.fifo_subs[i] = -1;
 	}
 
 	uint64_t timestamps[max_accel_sens] = {};
@@ -564,6 +570,23 @@ calibrate_return do_accel_calibration_measurements(orb_advert_t *mavlink_log_pub
 				device_id_primary = device_id[cur_accel];
 			}
 
+			// Use the FIFO data of the same device if the driver publishes it
+			const unsigned orb_accel_fifo_count = orb_group_count(ORB_ID(sensor_accel_fifo));
+
+			for (unsigned i = 0; i < orb_accel_fifo_count && worker_data.fifo_subs[cur_accel] < 0; i++) {
+				int fifo_sub = orb_subscribe_multi(ORB_ID(sensor_accel_fifo), i);
+
+				sensor_accel_fifo_s fifo{};
+
+				if (orb_copy(ORB_ID(sensor_accel_fifo), fifo_sub, &fifo) == PX4_OK
+				    && fifo.device_id == (uint32_t)device_id[cur_accel]) {
+					worker_data.fifo_subs[cur_accel] = fifo_sub;
+
+				} else {
+					orb_unsubscribe(fifo_sub);
+				}
+			}
+
 		} else {
 			calibration_log_critical(mavlink_log_pub, "Accel #%u no device id, abort", cur_accel);
 			result = calibrate_return_error;
@@ -591,6 +614,10 @@ calibrate_return do_accel_calibration_measurements(orb_advert_t *mavlink_log_pub
 
 			px4_close(worker_data.subs[i]);
 		}
+
+		if (worker_data.fifo_subs[i] >= 0) {
+			px4_close(worker_data.fifo_subs[i]);
+		}
 	}
 
 	orb_unsubscribe(worker_data.sensor_correction_sub);
@@ -614,7 +641,9 @@ calibrate_return do_accel_calibration_measurements(orb_advert_t *mavlink_log_pub
  * Read specified number of accelerometer samples, calculate average and dispersion.
  */
 calibrate_return read_accelerometer_avg(int sensor_correction_sub, int (&subs)[max_accel_sens],
-					float (&accel_avg)[max_accel_sens][detect_orientation_side_count][3], unsigned orient, unsigned samples_num)
+					int (&fifo_subs)[max_accel_sens],
+					float (&accel_avg)[max_accel_sens][detect_orientation_side_count][3], unsigned orient, unsigned samples_num,
+					unsigned samples_num_fifo)
 {
 	/* get total sensor board rotation matrix */
 	param_t board_rotation_h = param_find("SENS_BOARD_ROT");
@@ -638,15 +667,18 @@ calibrate_return read_accelerometer_avg(int sensor_correction_sub, int (&subs)[m
 	Dcmf board_rotation = board_rotation_offset * get_rot_matrix((enum Rotation)board_rotation_int);
 
 	px4_pollfd_struct_t fds[max_accel_sens];
+	unsigned samples_target[max_accel_sens];
+	welford_accumulator_s accumulator[max_accel_sens] {};
 
 	for (unsigned i = 0; i < max_accel_sens; i++) {
-		fds[i].fd = subs[i];
+		// an accel with FIFO data is read through its FIFO topic, each message carries a whole batch of samples
+		const bool fifo = (fifo_subs[i] >= 0);
+
+		fds[i].fd = fifo ? fifo_subs[i] : subs[i];
 		fds[i].events = POLLIN;
+		samples_target[i] = fifo ? samples_num_fifo : samples_num;
 	}
 
-	unsigned counts[max_accel_sens] = { 0 };
-	float accel_sum[max_accel_sens][3] {};
-
 	unsigned errcount = 0;
 	struct sensor_correction_s sensor_correction; /**< sensor thermal corrections */
 
@@ -662,44 +694,49 @@ calibrate_return read_accelerometer_avg(int sensor_correction_sub, int (&subs)[m
 		}
 	}
 
+	// thermal offset corrections in sensor/board frame
+	const float *accel_offset[max_accel_sens] {
+		sensor_correction.accel_offset_0,
+		sensor_correction.accel_offset_1,
+		sensor_correction.accel_offset_2,
+	};
+
 	/* use the first sensor to pace the readout, but do per-sensor counts */
-	while (counts[0] < samples_num) {
+	while (accumulator[0].count < samples_target[0]) {
 		int poll_ret = px4_poll(&fds[0], max_accel_sens, 1000);
 
 		if (poll_ret > 0) {
 
 			for (unsigned s = 0; s < max_accel_sens; s++) {
-				bool changed;
-				orb_check(subs[s], &changed);
+				if (fds[s].fd < 0) {
+					continue;
+				}
 
-				if (changed) {
+				bool changed = false;
+				orb_check(fds[s].fd, &changed);
 
-					sensor_accel_s arp;
-					orb_copy(ORB_ID(sensor_accel), subs[s], &arp);
+				if (changed && (fifo_subs[s] >= 0)) {
+					sensor_accel_fifo_s fifo;
+					orb_copy(ORB_ID(sensor_accel_fifo), fifo_subs[s], &fifo);
+
+					// same conversion as in sensor_accel, the calibration offsets and scales are reset at this point
+					const Dcmf rotation{get_rot_matrix((enum Rotation)fifo.rotation)};
+					const int N = math::min((int)fifo.samples, (int)(sizeof(fifo.x) / sizeof(fifo.x[0])));
+
+					for (int n = 0; n < N; n++) {
+						const Vector3f raw{(float)fifo.x[n], (float)fifo.y[n], (float)fifo.z[n]};
+						const Vector3f val{(rotation * raw) * fifo.scale};
 
-					// Apply thermal offset corrections in sensor/board frame
-					if (s == 0) {
-						accel_sum[s][0] += (arp.x - sensor_correction.accel_offset_0[0]);
-						accel_sum[s][1] += (arp.y - sensor_correction.accel_offset_0[1]);
-						accel_sum[s][2] += (arp.z - sensor_correction.accel_offset_0[2]);
-
-					} else if (s == 1) {
-						accel_sum[s][0] += (arp.x - sensor_correction.accel_offset_1[0]);
-						accel_sum[s][1] += (arp.y - sensor_correction.accel_offset_1[1]);
-						accel_sum[s][2] += (arp.z - sensor_correction.accel_offset_1[2]);
-
-					} else if (s == 2) {
-						accel_sum[s][0] += (arp.x - sensor_correction.accel_offset_2[0]);
-						accel_sum[s][1] += (arp.y - sensor_correction.accel_offset_2[1]);
-						accel_sum[s][2] += (arp.z - sensor_correction.accel_offset_2[2]);
-
-					} else {
-						accel_sum[s][0] += arp.x;
-						accel_sum[s][1] += arp.y;
-						accel_sum[s][2] += arp.z;
+						welford_update(&accumulator[s], val(0) - accel_offset[s][0], val(1) - accel_offset[s][1],
+							       val(2) - accel_offset[s][2]);
 					}
 
-					counts[s]++;
+				} else if (changed) {
+					sensor_accel_s arp;
+					orb_copy(ORB_ID(sensor_accel), subs[s], &arp);
+
+					welford_update(&accumulator[s], arp.x - accel_offset[s][0], arp.y - accel_offset[s][1],
+						       arp.z - accel_offset[s][2]);
 				}
 			}
 
@@ -714,18 +751,12 @@ calibrate_return read_accelerometer_avg(int sensor_correction_sub, int (&subs)[m
 	}
 
 	// rotate sensor measurements from sensor to body frame using board rotation matrix
-	for (unsigned i = 0; i < max_accel_sens; i++) {
-		Vector3f accel_sum_vec(&accel_sum[i][0]);
-		accel_sum_vec = board_rotation * accel_sum_vec;
-
-		for (size_t j = 0; j < 3; j++) {
-			accel_sum[i][j] = accel_sum_vec(j);
-		}
-	}
-
 	for (unsigned s = 0; s < max_accel_sens; s++) {
+		const Vector3f accel_mean{(float)accumulator[s].mean[0], (float)accumulator[s].mean[1], (float)accumulator[s].mean[2]};
+		const Vector3f accel_body{board_rotation * accel_mean};
+
 		for (unsigned i = 0; i < 3; i++) {
-			accel_avg[s][orient][i] = accel_sum[s][i] / counts[s];
+			accel_avg[s][orient][i] = accel_body(i);
 		}
 	}
 
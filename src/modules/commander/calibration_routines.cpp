@@ -263,6 +263,291 @@ int ellipsoid_fit_least_squares(const float x[], const float y[], const float z[
 	return 0;
 }
 
+void ellipsoid_fit_accumulate(ellipsoid_fit_accumulator_s *acc, float x, float y, float z)
+{
+	const double px = x;
+	const double py = y;
+	const double pz = z;
+
+	// algebraic sphere: 2*a*x + 2*b*y + 2*c*z + k = x^2 + y^2 + z^2
+	const double sphere_row[4] = {2.0 * px, 2.0 * py, 2.0 * pz, 1.0};
+	const double sphere_rhs = px * px + py * py + pz * pz;
+
+	// algebraic ellipsoid: A*x^2 + B*y^2 + C*z^2 + 2*D*x*y + 2*E*x*z + 2*F*y*z + 2*G*x + 2*H*y + 2*I*z = 1
+	const double ellipsoid_row[9] = {px * px, py * py, pz * pz, 2.0 * px * py, 2.0 * px * pz, 2.0 * py * pz, 2.0 * px, 2.0 * py, 2.0 * pz};
+
+	for (int i = 0; i < 4; i++) {
+		for (int j = i; j < 4; j++) {
+			acc->sphere_ata[i * 4 + j] += sphere_row[i] * sphere_row[j];
+		}
+
+		acc->sphere_atb[i] += sphere_row[i] * sphere_rhs;
+	}
+
+	for (int i = 0; i < 9; i++) {
+		for (int j = i; j < 9; j++) {
+			acc->ellipsoid_ata[i * 9 + j] += ellipsoid_row[i] * ellipsoid_row[j];
+		}
+
+		acc->ellipsoid_atb[i] += ellipsoid_row[i];
+	}
+
+	acc->count++;
+}
+
+/**
+ * Solve the symmetric normal equations A x = b (only the upper triangle of A is set) by Gaussian elimination
+ * with partial pivoting, A and b are overwritten.
+ */
+static bool solve_normal_equations(double *A, double *b, int n)
+{
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < i; j++) {
+			A[i * n + j] = A[j * n + i];
+		}
+	}
+
+	for (int col = 0; col < n; col++) {
+		int pivot = col;
+
+		for (int row = col + 1; row < n; row++) {
+			if (fabs(A[row * n + col]) > fabs(A[pivot * n + col])) {
+				pivot = row;
+			}
+		}
+
+		if (fabs(A[pivot * n + col]) < 1e-30) {
+			return false;
+		}
+
+		if (pivot != col) {
+			for (int k = 0; k < n; k++) {
+				const double tmp = A[col * n + k];
+				A[col * n + k] = A[pivot * n + k];
+				A[pivot * n + k] = tmp;
+			}
+
+			const double tmp = b[col];
+			b[col] = b[pivot];
+			b[pivot] = tmp;
+		}
+
+		for (int row = col + 1; row < n; row++) {
+			const double factor = A[row * n + col] / A[col * n + col];
+
+			for (int k = col; k < n; k++) {
+				A[row * n + k] -= factor * A[col * n + k];
+			}
+
+			b[row] -= factor * b[col];
+		}
+	}
+
+	for (int row = n - 1; row >= 0; row--) {
+		double sum = b[row];
+
+		for (int k = row + 1; k < n; k++) {
+			sum -= A[row * n + k] * b[k];
+		}
+
+		b[row] = sum / A[row * n + row];
+	}
+
+	return true;
+}
+
+/**
+ * Eigen decomposition of a symmetric 3x3 matrix (cyclic Jacobi), S = V * diag(eigenvalues) * V^T.
+ * S is overwritten, its diagonal holds the eigenvalues.
+ */
+static void symmetric_eigen_3x3(double S[3][3], double V[3][3])
+{
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			V[i][j] = (i == j) ? 1.0 : 0.0;
+		}
+	}
+
+	for (int sweep = 0; sweep < 16; sweep++) {
+		const double off_diagonal = fabs(S[0][1]) + fabs(S[0][2]) + fabs(S[1][2]);
+
+		if (off_diagonal < 1e-15) {
+			break;
+		}
+
+		for (int p = 0; p < 2; p++) {
+			for (int q = p + 1; q < 3; q++) {
+				if (fabs(S[p][q]) < 1e-300) {
+					continue;
+				}
+
+				// rotation angle zeroing S[p][q]
+				const double theta = (S[q][q] - S[p][p]) / (2.0 * S[p][q]);
+				const double t = ((theta >= 0.0) ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+				const double c = 1.0 / sqrt(t * t + 1.0);
+				const double s = t * c;
+
+				for (int k = 0; k < 3; k++) {
+					const double skp = S[k][p];
+					const double skq = S[k][q];
+					S[k][p] = c * skp - s * skq;
+					S[k][q] = s * skp + c * skq;
+				}
+
+				for (int k = 0; k < 3; k++) {
+					const double spk = S[p][k];
+					const double sqk = S[q][k];
+					S[p][k] = c * spk - s * sqk;
+					S[q][k] = s * spk + c * sqk;
+				}
+
+				for (int k = 0; k < 3; k++) {
+					const double vkp = V[k][p];
+					const double vkq = V[k][q];
+					V[k][p] = c * vkp - s * vkq;
+					V[k][q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+}
+
+int ellipsoid_fit_solve(const ellipsoid_fit_accumulator_s *acc, float *offset_x, float *offset_y, float *offset_z,
+			float *sphere_radius, float *diag_x, float *diag_y, float *diag_z,
+			float *offdiag_x, float *offdiag_y, float *offdiag_z, bool sphere_fit_only)
+{
+	if (acc->count < 9) {
+		return -1;
+	}
+
+	// sphere fit: center and radius
+	double sphere_ata[4 * 4];
+	double sphere[4];
+	memcpy(sphere_ata, acc->sphere_ata, sizeof(sphere_ata));
+	memcpy(sphere, acc->sphere_atb, sizeof(sphere));
+
+	if (!solve_normal_equations(sphere_ata, sphere, 4)) {
+		return -1;
+	}
+
+	const double radius_sq = sphere[3] + sphere[0] * sphere[0] + sphere[1] * sphere[1] + sphere[2] * sphere[2];
+
+	if (!(radius_sq > 0.0)) {
+		return -1;
+	}
+
+	*offset_x = (float)sphere[0];
+	*offset_y = (float)sphere[1];
+	*offset_z = (float)sphere[2];
+	*sphere_radius = (float)sqrt(radius_sq);
+	*diag_x = 1.f;
+	*diag_y = 1.f;
+	*diag_z = 1.f;
+	*offdiag_x = 0.f;
+	*offdiag_y = 0.f;
+	*offdiag_z = 0.f;
+
+	if (sphere_fit_only) {
+		return 0;
+	}
+
+	// ellipsoid fit: (p - o)^T Q (p - o) = k
+	double ellipsoid_ata[9 * 9];
+	double u[9];
+	memcpy(ellipsoid_ata, acc->ellipsoid_ata, sizeof(ellipsoid_ata));
+	memcpy(u, acc->ellipsoid_atb, sizeof(u));
+
+	if (!solve_normal_equations(ellipsoid_ata, u, 9)) {
+		// keep the sphere fit
+		return 0;
+	}
+
+	double Q[3 * 3] = {u[0], u[3], u[4],
+			   u[3], u[1], u[5],
+			   u[4], u[5], u[2]
+			  };
+
+	// center o = -Q^-1 * v
+	double Q_solve[3 * 3];
+	double center[3] = {-u[6], -u[7], -u[8]};
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = i; j < 3; j++) {
+			Q_solve[i * 3 + j] = Q[i * 3 + j];
+		}
+	}
+
+	if (!solve_normal_equations(Q_solve, center, 3)) {
+		return 0;
+	}
+
+	double k = 1.0;
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			k += center[i] * Q[i * 3 + j] * center[j];
+		}
+	}
+
+	// the calibration matrix M is the symmetric square root of radius^2 * Q / k, so that |M * (p - o)| = radius
+	double S[3][3];
+	double V[3][3];
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			S[i][j] = Q[i * 3 + j] / k;
+		}
+	}
+
+	symmetric_eigen_3x3(S, V);
+
+	double sqrt_eigenvalues[3];
+
+	for (int i = 0; i < 3; i++) {
+		if (!(S[i][i] > 0.0)) {
+			// not an ellipsoid (e.g. not enough rotation coverage), keep the sphere fit
+			return 0;
+		}
+
+		sqrt_eigenvalues[i] = sqrt(S[i][i]) * (double)(*sphere_radius);
+	}
+
+	double M[3][3];
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			M[i][j] = 0.0;
+
+			for (int e = 0; e < 3; e++) {
+				M[i][j] += V[i][e] * sqrt_eigenvalues[e] * V[j][e];
+			}
+		}
+	}
+
+	*offset_x = (float)center[0];
+	*offset_y = (float)center[1];
+	*offset_z = (float)center[2];
+	*diag_x = (float)M[0][0];
+	*diag_y = (float)M[1][1];
+	*diag_z = (float)M[2][2];
+	*offdiag_x = (float)M[0][1];
+	*offdiag_y = (float)M[0][2];
+	*offdiag_z = (float)M[1][2];
+
+	return 0;
+}
+
+void welford_update(welford_accumulator_s *acc, float x, float y, float z)
+{
+	const double sample[3] {x, y, z};
+
+	acc->count++;
+
+	for (int i = 0; i < 3; i++) {
+		acc->mean[i] += (sample[i] - acc->mean[i]) / acc->count;
+	}
+}
+
 int run_lm_sphere_fit(const float x[], const float y[], const float z[], float &_fitness, float &_sphere_lambda,
 		      unsigned int size, float *offset_x, float *offset_y, float *offset_z,
 		      float *sphere_radius, float *diag_x, float *diag_y, float *diag_z, float *offdiag_x, float *offdiag_y, float *offdiag_z)
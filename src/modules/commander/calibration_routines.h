@@ -72,6 +72,49 @@ int run_lm_ellipsoid_fit(const float x[], const float y[], const float z[], floa
 bool inverse4x4(float m[], float invOut[]);
 bool mat_inverse(float *A, float *inv, uint8_t n);
 
+/**
+ * Normal equations of the algebraic sphere and ellipsoid fits, accumulated sample by sample
+ * so that the samples themselves don't need to be stored.
+ */
+struct ellipsoid_fit_accumulator_s {
+	double sphere_ata[4 * 4];	///< upper triangle of A^T A of the sphere fit
+	double sphere_atb[4];
+	double ellipsoid_ata[9 * 9];	///< upper triangle of A^T A of the ellipsoid fit
+	double ellipsoid_atb[9];
+	unsigned count;
+};
+
+/**
+ * Add a point to the ellipsoid fit.
+ */
+void ellipsoid_fit_accumulate(ellipsoid_fit_accumulator_s *acc, float x, float y, float z);
+
+/**
+ * Closed-form fit of an ellipsoid to the accumulated points.
+ *
+ * The radius is the one of the best fitting sphere, the calibration matrix (diag, offdiag) maps
+ * the ellipsoid onto that sphere. If the points don't describe an ellipsoid the sphere fit is returned.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ellipsoid_fit_solve(const ellipsoid_fit_accumulator_s *acc, float *offset_x, float *offset_y, float *offset_z,
+			float *sphere_radius, float *diag_x, float *diag_y, float *diag_z,
+			float *offdiag_x, float *offdiag_y, float *offdiag_z, bool sphere_fit_only);
+
+/**
+ * Running mean of a 3 axis sensor (Welford's algorithm), doesn't lose precision like a float sum
+ * over the large number of samples of a high rate FIFO.
+ */
+struct welford_accumulator_s {
+	double mean[3];
+	unsigned count;
+};
+
+/**
+ * Add a sample to the running mean.
+ */
+void welford_update(welford_accumulator_s *acc, float x, float y, float z);
+
 // FIXME: Change the name
 static const unsigned max_accel_sens = 3;
 
@@ -42,36 +42,99 @@
 
 using namespace time_literals;
 
-FailureDetector::FailureDetector(ModuleParams *parent) :
-	ModuleParams(parent)
+FailureDetector::FailureDetector() :
+	ModuleParams(nullptr),
+	WorkItem("failure_detector", px4::wq_configurations::hp_default)
 {
+	updateParams();
 }
 
-bool FailureDetector::resetStatus()
+FailureDetector::~FailureDetector()
 {
-	bool status_changed = _status != FAILURE_NONE;
-	_status = FAILURE_NONE;
-
-	return status_changed;
+	stop();
+	perf_free(_cycle_perf);
 }
 
 bool
-FailureDetector::update(const vehicle_status_s &vehicle_status)
+FailureDetector::init()
+{
+	if (!_sub_vehicule_attitude.registerCallback()) {
+		PX4_ERR("vehicle_attitude callback registration failed");
+		return false;
+	}
+
+	_sub_pwm_input.registerCallback();
+
+	return true;
+}
+
+void
+FailureDetector::stop()
+{
+	_sub_vehicule_attitude.unregisterCallback();
+	_sub_pwm_input.unregisterCallback();
+}
+
+void
+FailureDetector::updateParams()
 {
-	bool updated(false);
+	ModuleParams::updateParams();
+
+	_roll_failure_hysteresis.set_hysteresis_time_from(false, (hrt_abstime)(1_s * _param_fd_fail_r_ttri.get()));
+	_pitch_failure_hysteresis.set_hysteresis_time_from(false, (hrt_abstime)(1_s * _param_fd_fail_p_ttri.get()));
+	_ext_ats_failure_hysteresis.set_hysteresis_time_from(false, 100_ms); // 5 consecutive pulses at 50hz
+}
+
+void
+FailureDetector::Run()
+{
+	perf_begin(_cycle_perf);
+
+	if (_sub_parameter_update.updated()) {
+		parameter_update_s param_update;
+		_sub_parameter_update.copy(&param_update);
+		updateParams();
+	}
+
+	_sub_vehicle_status.update(&_vehicle_status);
 
-	if (isAttitudeStabilized(vehicle_status)) {
-		updated = updateAttitudeStatus();
+	const uint8_t previous_status = _status;
+
+	if (isAttitudeStabilized(_vehicle_status)) {
+		updateAttitudeStatus();
 
 		if (_param_fd_ext_ats_en.get()) {
-			updated |= updateExternalAtsStatus();
+			updateExternalAtsStatus();
 		}
 
 	} else {
-		updated = resetStatus();
+		resetStatus();
+	}
+
+	publishStatus(_status != previous_status);
+
+	perf_end(_cycle_perf);
+}
+
+void
+FailureDetector::publishStatus(bool force)
+{
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (force || (now - _last_publish >= 1_s)) {
+		failure_detector_status_s failure_detector_status{};
+		failure_detector_status.failure_status = _status;
+		failure_detector_status.timestamp = now;
+		_failure_detector_status_pub.publish(failure_detector_status);
+
+		_last_publish = now;
 	}
+}
 
-	return updated;
+void
+FailureDetector::resetStatus()
+{
+	_status = FAILURE_NONE;
 }
 
 bool
@@ -94,10 +157,9 @@ FailureDetector::isAttitudeStabilized(const vehicle_status_s &vehicle_status)
 	return attitude_is_stabilized;
 }
 
-bool
+void
 FailureDetector::updateAttitudeStatus()
 {
-	bool updated(false);
 	vehicle_attitude_s attitude;
 
 	if (_sub_vehicule_attitude.update(&attitude)) {
@@ -117,8 +179,6 @@ FailureDetector::updateAttitudeStatus()
 		hrt_abstime time_now = hrt_absolute_time();
 
 		// Update hysteresis
-		_roll_failure_hysteresis.set_hysteresis_time_from(false, (hrt_abstime)(1_s * _param_fd_fail_r_ttri.get()));
-		_pitch_failure_hysteresis.set_hysteresis_time_from(false, (hrt_abstime)(1_s * _param_fd_fail_p_ttri.get()));
 		_roll_failure_hysteresis.set_state_and_update(roll_status, time_now);
 		_pitch_failure_hysteresis.set_state_and_update(pitch_status, time_now);
 
@@ -132,20 +192,15 @@ FailureDetector::updateAttitudeStatus()
 		if (_pitch_failure_hysteresis.get_state()) {
 			_status |= FAILURE_PITCH;
 		}
-
-		updated = true;
 	}
-
-	return updated;
 }
 
-bool
+void
 FailureDetector::updateExternalAtsStatus()
 {
 	pwm_input_s pwm_input;
-	bool updated = _sub_pwm_input.update(&pwm_input);
 
-	if (updated) {
+	if (_sub_pwm_input.update(&pwm_input)) {
 
 		uint32_t pulse_width = pwm_input.pulse_width;
 		bool ats_trigger_status = (pulse_width >= (uint32_t)_param_fd_ext_ats_trig.get()) && (pulse_width < 3_ms);
@@ -153,7 +208,6 @@ FailureDetector::updateExternalAtsStatus()
 		hrt_abstime time_now = hrt_absolute_time();
 
 		// Update hysteresis
-		_ext_ats_failure_hysteresis.set_hysteresis_time_from(false, 100_ms); // 5 consecutive pulses at 50hz
 		_ext_ats_failure_hysteresis.set_state_and_update(ats_trigger_status, time_now);
 
 		_status &= ~FAILURE_EXT;
@@ -162,6 +216,4 @@ FailureDetector::updateExternalAtsStatus()
 			_status |= FAILURE_EXT;
 		}
 	}
-
-	return updated;
-}
\ No newline at end of file
+}
@@ -37,6 +37,9 @@
 * Base class for failure detection logic based on vehicle states
 * for failsafe triggering.
 *
+* Runs on every attitude (and external ATS pwm_input) update in a high priority
+* work queue and publishes failure_detector_status, independently of the commander rate.
+*
 * @author Mathieu Bresciani 	<brescianimathieu@gmail.com>
 *
 */
@@ -45,12 +48,18 @@
 
 #include <matrix/matrix/math.hpp>
 #include <mathlib/mathlib.h>
+#include <perf/perf_counter.h>
 #include <px4_platform_common/module_params.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
 #include <hysteresis/hysteresis.h>
 
 
 // subscriptions
+#include <uORB/Publication.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
+#include <uORB/topics/failure_detector_status.h>
+#include <uORB/topics/parameter_update.h>
 #include <uORB/topics/vehicle_attitude_setpoint.h>
 #include <uORB/topics/vehicle_attitude.h>
 #include <uORB/topics/vehicle_status.h>
@@ -66,17 +75,27 @@ typedef enum {
 
 using uORB::SubscriptionData;
 
-class FailureDetector : public ModuleParams
+class FailureDetector : public ModuleParams, public px4::WorkItem
 {
 public:
-	FailureDetector(ModuleParams *parent);
+	FailureDetector();
+	~FailureDetector() override;
 
-	bool update(const vehicle_status_s &vehicle_status);
+	/**
+	 * Start running on attitude and pwm_input updates.
+	 */
+	bool init();
 
-	uint8_t getStatus() const { return _status; }
-	bool isFailure() const { return _status != FAILURE_NONE; }
+	/**
+	 * Stop running, call before the owner is destroyed.
+	 */
+	void stop();
 
 private:
+	void Run() override;
+	void updateParams() override;
+	void publishStatus(bool force);
+
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::FD_FAIL_P>) _param_fd_fail_p,
@@ -88,18 +107,26 @@ private:
 	)
 
 	// Subscriptions
-	uORB::Subscription _sub_vehicule_attitude{ORB_ID(vehicle_attitude)};
-	uORB::Subscription _sub_pwm_input{ORB_ID(pwm_input)};
+	uORB::SubscriptionCallbackWorkItem _sub_vehicule_attitude{this, ORB_ID(vehicle_attitude)};
+	uORB::SubscriptionCallbackWorkItem _sub_pwm_input{this, ORB_ID(pwm_input)};
+	uORB::Subscription _sub_parameter_update{ORB_ID(parameter_update)};
+	uORB::Subscription _sub_vehicle_status{ORB_ID(vehicle_status)};
 
+	uORB::Publication<failure_detector_status_s> _failure_detector_status_pub{ORB_ID(failure_detector_status)};
+
+	vehicle_status_s _vehicle_status{};
 
 	uint8_t _status{FAILURE_NONE};
+	hrt_abstime _last_publish{0};
+
+	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, "failure_detector: cycle")};
 
 	systemlib::Hysteresis _roll_failure_hysteresis{false};
 	systemlib::Hysteresis _pitch_failure_hysteresis{false};
 	systemlib::Hysteresis _ext_ats_failure_hysteresis{false};
 
-	bool resetStatus();
+	void resetStatus();
 	bool isAttitudeStabilized(const vehicle_status_s &vehicle_status);
-	bool updateAttitudeStatus();
-	bool updateExternalAtsStatus();
+	void updateAttitudeStatus();
+	void updateExternalAtsStatus();
 };
@@ -51,10 +51,13 @@
 #include <fcntl.h>
 #include <math.h>
 #include <mathlib/mathlib.h>
+#include <matrix/math.hpp>
+#include <conversion/rotation.h>
 #include <string.h>
 #include <drivers/drv_hrt.h>
 #include <uORB/topics/sensor_combined.h>
 #include <uORB/topics/sensor_correction.h>
+#include <uORB/topics/sensor_gyro_fifo.h>
 #include <drivers/drv_gyro.h>
 #include <systemlib/mavlink_log.h>
 #include <parameters/param.h>
@@ -64,23 +67,47 @@ static const char *sensor_name = "gyro";
 
 static constexpr unsigned max_gyros = 3;
 
+static constexpr unsigned calibration_count = 250;		///< sensor_gyro messages per gyro
+static constexpr unsigned calibration_count_fifo = 4000;	///< raw sensor_gyro_fifo samples per gyro (0.5 s at 8 kHz)
+
 /// Data passed to calibration worker routine
 typedef struct  {
 	orb_advert_t		*mavlink_log_pub;
 	int32_t			device_id[max_gyros];
 	int			gyro_sensor_sub[max_gyros];
+	int			gyro_fifo_sub[max_gyros];	///< sensor_gyro_fifo of the same device, -1 if not available
 	int			sensor_correction_sub;
 	struct gyro_calibration_s	gyro_scale[max_gyros];
+	welford_accumulator_s	accumulator[max_gyros];
 	float last_sample_0[3];
 } gyro_worker_data_t;
 
+// Apply the thermal corrections of a gyro instance
+static void apply_sensor_correction(const sensor_correction_s &sensor_correction, unsigned s, float sample[3])
+{
+	if (s == 0) {
+		sample[0] = (sample[0] - sensor_correction.gyro_offset_0[0]) * sensor_correction.gyro_scale_0[0];
+		sample[1] = (sample[1] - sensor_correction.gyro_offset_0[1]) * sensor_correction.gyro_scale_0[1];
+		sample[2] = (sample[2] - sensor_correction.gyro_offset_0[2]) * sensor_correction.gyro_scale_0[2];
+
+	} else if (s == 1) {
+		sample[0] = (sample[0] - sensor_correction.gyro_offset_1[0]) * sensor_correction.gyro_scale_1[0];
+		sample[1] = (sample[1] - sensor_correction.gyro_offset_1[1]) * sensor_correction.gyro_scale_1[1];
+		sample[2] = (sample[2] - sensor_correction.gyro_offset_1[2]) * sensor_correction.gyro_scale_1[2];
+
+	} else if (s == 2) {
+		sample[0] = (sample[0] - sensor_correction.gyro_offset_2[0]) * sensor_correction.gyro_scale_2[0];
+		sample[1] = (sample[1] - sensor_correction.gyro_offset_2[1]) * sensor_correction.gyro_scale_2[1];
+		sample[2] = (sample[2] - sensor_correction.gyro_offset_2[2]) * sensor_correction.gyro_scale_2[2];
+	}
+}
+
 static calibrate_return gyro_calibration_worker(int cancel_sub, void *data)
 {
 	gyro_worker_data_t	*worker_data = (gyro_worker_data_t *)(data);
-	unsigned		calibration_counter[max_gyros] = { 0 }, slow_count = 0;
-	const unsigned		calibration_count = 250;
-	sensor_gyro_s	gyro_report;
+	unsigned		calibration_target[max_gyros];
 	unsigned		poll_errcount = 0;
+	unsigned		last_progress = 0;
 
 	struct sensor_correction_s sensor_correction {}; /**< sensor thermal corrections */
 
@@ -95,14 +122,22 @@ static calibrate_return gyro_calibration_worker(int cancel_sub, void *data)
 	px4_pollfd_struct_t fds[max_gyros];
 
 	for (unsigned s = 0; s < max_gyros; s++) {
-		fds[s].fd = worker_data->gyro_sensor_sub[s];
+		// a gyro with FIFO data is read through its FIFO topic, each message carries a whole batch of samples
+		const bool fifo = (worker_data->gyro_fifo_sub[s] >= 0);
+
+		fds[s].fd = fifo ? worker_data->gyro_fifo_sub[s] : worker_data->gyro_sensor_sub[s];
 		fds[s].events = POLLIN;
+		calibration_target[s] = fifo ? calibration_count_fifo : calibration_count;
+
+		memset(&worker_data->accumulator[s], 0, sizeof(worker_data->accumulator[s]));
 	}
 
 	memset(&worker_data->last_sample_0, 0, sizeof(worker_data->last_sample_0));
 
 	/* use slowest gyro to pace, but count correctly per-gyro for statistics */
-	while (slow_count < calibration_count) {
+	bool done = false;
+
+	while (!done) {
 		if (calibrate_cancel_check(worker_data->mavlink_log_pub, cancel_sub)) {
 			return calibrate_return_cancelled;
 		}
@@ -118,70 +153,69 @@ static calibrate_return gyro_calibration_worker(int cancel_sub, void *data)
 		int poll_ret = px4_poll(&fds[0], max_gyros, 1000);
 
 		if (poll_ret > 0) {
-			unsigned update_count = calibration_count;
+			unsigned progress = 100;
+			bool any_samples = false;
 
 			for (unsigned s = 0; s < max_gyros; s++) {
-				if (calibration_counter[s] >= calibration_count) {
-					// Skip if instance has enough samples
-					continue;
-				}
-
-				bool changed;
-				orb_check(worker_data->gyro_sensor_sub[s], &changed);
-
-				if (changed) {
-					orb_copy(ORB_ID(sensor_gyro), worker_data->gyro_sensor_sub[s], &gyro_report);
-					float sample[3];
-
-					if (s == 0) {
-						// take a working copy
-						sample[0] = (gyro_report.x - sensor_correction.gyro_offset_0[0]) * sensor_correction.gyro_scale_0[0];
-						sample[1] = (gyro_report.y - sensor_correction.gyro_offset_0[1]) * sensor_correction.gyro_scale_0[1];
-						sample[2] = (gyro_report.z - sensor_correction.gyro_offset_0[2]) * sensor_correction.gyro_scale_0[2];
-
-						for (int i = 0; i < 3; ++i) {
-							worker_data->last_sample_0[i] = sample[i];
+				welford_accumulator_s &accumulator = worker_data->accumulator[s];
+
+				if (fds[s].fd >= 0 && accumulator.count < calibration_target[s]) {
+					bool changed = false;
+					orb_check(fds[s].fd, &changed);
+
+					if (changed && (worker_data->gyro_fifo_sub[s] >= 0)) {
+						sensor_gyro_fifo_s fifo;
+						orb_copy(ORB_ID(sensor_gyro_fifo), worker_data->gyro_fifo_sub[s], &fifo);
+
+						// same conversion as in sensor_gyro: rotate, scale and remove the (reset) calibration offset
+						const matrix::Dcmf rotation{get_rot_matrix((enum Rotation)fifo.rotation)};
+						const matrix::Vector3f calibration_offset{fifo.calibration_offset};
+						const int N = math::min((int)fifo.samples, (int)(sizeof(fifo.x) / sizeof(fifo.x[0])));
+						matrix::Vector3f batch_sum{};
+
+						for (int n = 0; n < N; n++) {
+							const matrix::Vector3f raw{(float)fifo.x[n], (float)fifo.y[n], (float)fifo.z[n]};
+							const matrix::Vector3f val{(rotation * raw) * fifo.scale - calibration_offset};
+							float sample[3];
+
+							val.copyTo(sample);
+							apply_sensor_correction(sensor_correction, s, sample);
+							welford_update(&accumulator, sample[0], sample[1], sample[2]);
+							batch_sum += matrix::Vector3f{sample};
 						}
 
-					} else if (s == 1) {
-						sample[0] = (gyro_report.x - sensor_correction.gyro_offset_1[0]) * sensor_correction.gyro_scale_1[0];
-						sample[1] = (gyro_report.y - sensor_correction.gyro_offset_1[1]) * sensor_correction.gyro_scale_1[1];
-						sample[2] = (gyro_report.z - sensor_correction.gyro_offset_1[2]) * sensor_correction.gyro_scale_1[2];
+						if (s == 0 && N > 0) {
+							// a single raw sample is too noisy for the motion check, use the batch average
+							(batch_sum / (float)N).copyTo(worker_data->last_sample_0);
+						}
 
-					} else if (s == 2) {
-						sample[0] = (gyro_report.x - sensor_correction.gyro_offset_2[0]) * sensor_correction.gyro_scale_2[0];
-						sample[1] = (gyro_report.y - sensor_correction.gyro_offset_2[1]) * sensor_correction.gyro_scale_2[1];
-						sample[2] = (gyro_report.z - sensor_correction.gyro_offset_2[2]) * sensor_correction.gyro_scale_2[2];
+					} else if (changed) {
+						sensor_gyro_s gyro_report;
+						orb_copy(ORB_ID(sensor_gyro), worker_data->gyro_sensor_sub[s], &gyro_report);
 
-					} else {
-						sample[0] = gyro_report.x;
-						sample[1] = gyro_report.y;
-						sample[2] = gyro_report.z;
+						float sample[3] {gyro_report.x, gyro_report.y, gyro_report.z};
+						apply_sensor_correction(sensor_correction, s, sample);
+						welford_update(&accumulator, sample[0], sample[1], sample[2]);
 
+						if (s == 0) {
+							memcpy(worker_data->last_sample_0, sample, sizeof(sample));
+						}
 					}
-
-					worker_data->gyro_scale[s].x_offset += sample[0];
-					worker_data->gyro_scale[s].y_offset += sample[1];
-					worker_data->gyro_scale[s].z_offset += sample[2];
-					calibration_counter[s]++;
-
 				}
 
-				// Maintain the sample count of the slowest sensor
-				if (calibration_counter[s] && calibration_counter[s] < update_count) {
-					update_count = calibration_counter[s];
+				// Maintain the progress of the slowest sensor, ignoring gyros that don't publish
+				if (accumulator.count > 0) {
+					any_samples = true;
+					progress = math::min(progress, math::min(100u, (accumulator.count * 100) / calibration_target[s]));
 				}
-
 			}
 
-			if (update_count % (calibration_count / 20) == 0) {
-				calibration_log_info(worker_data->mavlink_log_pub, CAL_QGC_PROGRESS_MSG, (update_count * 100) / calibration_count);
+			if (any_samples && (progress >= last_progress + 5)) {
+				calibration_log_info(worker_data->mavlink_log_pub, CAL_QGC_PROGRESS_MSG, progress);
+				last_progress = progress;
 			}
 
-			// Propagate out the slowest sensor's count
-			if (slow_count < update_count) {
-				slow_count = update_count;
-			}
+			done = any_samples && (progress >= 100);
 
 		} else {
 			poll_errcount++;
@@ -194,14 +228,16 @@ static calibrate_return gyro_calibration_worker(int cancel_sub, void *data)
 	}
 
 	for (unsigned s = 0; s < max_gyros; s++) {
-		if (worker_data->device_id[s] != 0 && calibration_counter[s] < calibration_count / 2) {
+		const welford_accumulator_s &accumulator = worker_data->accumulator[s];
+
+		if (worker_data->device_id[s] != 0 && accumulator.count < calibration_target[s] / 2) {
 			calibration_log_critical(worker_data->mavlink_log_pub, "ERROR: missing data, sensor %d", s)
 			return calibrate_return_error;
 		}
 
-		worker_data->gyro_scale[s].x_offset /= calibration_counter[s];
-		worker_data->gyro_scale[s].y_offset /= calibration_counter[s];
-		worker_data->gyro_scale[s].z_offset /= calibration_counter[s];
+		worker_data->gyro_scale[s].x_offset = (float)accumulator.mean[0];
+		worker_data->gyro_scale[s].y_offset = (float)accumulator.mean[1];
+		worker_data->gyro_scale[s].z_offset = (float)accumulator.mean[2];
 	}
 
 	return calibrate_return_ok;
@@ -229,6 +265,7 @@ int do_gyro_calibration(orb_advert_t *mavlink_log_pub)
 		worker_data.device_id[s] = 0;
 		// And set default subscriber values.
 		worker_data.gyro_sensor_sub[s] = -1;
+		worker_data.gyro_fifo_sub[s] = -1;
 		(void)sprintf(str, "CAL_GYRO%u_ID", s);
 		res = param_set_no_notification(param_find(str), &(worker_data.device_id[s]));
 
@@ -340,6 +377,23 @@ int do_gyro_calibration(orb_advert_t *mavlink_log_pub)
 				device_id_primary = worker_data.device_id[cur_gyro];
 			}
 
+			// Use the FIFO data of the same device if the driver publishes it
+			const unsigned orb_gyro_fifo_count = orb_group_count(ORB_ID(sensor_gyro_fifo));
+
+			for (unsigned i = 0; i < orb_gyro_fifo_count && worker_data.gyro_fifo_sub[cur_gyro] < 0; i++) {
+				int fifo_sub = orb_subscribe_multi(ORB_ID(sensor_gyro_fifo), i);
+
+				sensor_gyro_fifo_s fifo{};
+
+				if (orb_copy(ORB_ID(sensor_gyro_fifo), fifo_sub, &fifo) == PX4_OK
+				    && fifo.device_id == (uint32_t)worker_data.device_id[cur_gyro]) {
+					worker_data.gyro_fifo_sub[cur_gyro] = fifo_sub;
+
+				} else {
+					orb_unsubscribe(fifo_sub);
+				}
+			}
+
 		} else {
 			calibration_log_critical(mavlink_log_pub, "Gyro #%u no device id, abort", cur_gyro);
 		}
@@ -400,6 +454,10 @@ int do_gyro_calibration(orb_advert_t *mavlink_log_pub)
 
 	for (unsigned s = 0; s < max_gyros; s++) {
 		px4_close(worker_data.gyro_sensor_sub[s]);
+
+		if (worker_data.gyro_fifo_sub[s] >= 0) {
+			px4_close(worker_data.gyro_fifo_sub[s]);
+		}
 	}
 
 	if (res == PX4_OK) {
@@ -67,6 +67,7 @@ static constexpr float mag_sphere_radius = 0.2f;
 static unsigned int calibration_sides = 6;			///< The total number of sides
 static constexpr unsigned int calibration_total_points = 240;		///< The total points per magnetometer
 static constexpr unsigned int calibraton_duration_seconds = 42; 	///< The total duration the routine is allowed to take
+static constexpr unsigned int recent_sample_count = 16;		///< Number of recent samples new samples are checked against
 
 static constexpr float MAG_MAX_OFFSET_LEN =
 	1.3f;	///< The maximum measurement range is ~1.9 Ga, the earth field is ~0.6 Ga, so an offset larger than ~1.3 Ga means the mag will saturate in some directions.
@@ -79,6 +80,12 @@ static unsigned _last_mag_progress = 0;
 
 calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub, int32_t cal_mask);
 
+/// Streaming fit state of a mag, the samples themselves are not stored
+typedef struct {
+	ellipsoid_fit_accumulator_s	fit;
+	float				recent[recent_sample_count][3];	///< ring buffer of the last accepted samples
+} mag_fit_data_t;
+
 /// Data passed to calibration worker routine
 typedef struct  {
 	orb_advert_t	*mavlink_log_pub;
@@ -89,9 +96,7 @@ typedef struct  {
 	uint64_t	calibration_interval_perside_useconds;
 	unsigned int	calibration_counter_total[max_mags];
 	bool		side_data_collected[detect_orientation_side_count];
-	float		*x[max_mags];
-	float		*y[max_mags];
-	float		*z[max_mags];
+	mag_fit_data_t	*fit_data[max_mags];
 } mag_worker_data_t;
 
 
@@ -267,15 +272,20 @@ int do_mag_calibration(orb_advert_t *mavlink_log_pub)
 	return result;
 }
 
-static bool reject_sample(float sx, float sy, float sz, float x[], float y[], float z[], unsigned count,
+static bool reject_sample(float sx, float sy, float sz, const mag_fit_data_t *fit_data, unsigned count,
 			  unsigned max_count)
 {
 	float min_sample_dist = fabsf(5.4f * mag_sphere_radius / sqrtf(max_count)) / 3.0f;
 
+	// only the recent samples are kept, which is what catches a vehicle that is not rotated
+	if (count > recent_sample_count) {
+		count = recent_sample_count;
+	}
+
 	for (size_t i = 0; i < count; i++) {
-		float dx = sx - x[i];
-		float dy = sy - y[i];
-		float dz = sz - z[i];
+		float dx = sx - fit_data->recent[i][0];
+		float dy = sy - fit_data->recent[i][1];
+		float dz = sz - fit_data->recent[i][2];
 		float dist = sqrtf(dx * dx + dy * dy + dz * dz);
 
 		if (dist < min_sample_dist) {
@@ -453,39 +463,36 @@ static calibrate_return mag_calibration_worker(detect_orientation_return orienta
 
 		if (poll_ret > 0) {
 
-			int prev_count[max_mags];
+			sensor_mag_s mag[max_mags] {};
 			bool rejected = false;
 
 			for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-
-				prev_count[cur_mag] = worker_data->calibration_counter_total[cur_mag];
-
 				if (worker_data->sub_mag[cur_mag] >= 0) {
-					sensor_mag_s mag{};
-
-					orb_copy(ORB_ID(sensor_mag), worker_data->sub_mag[cur_mag], &mag);
+					orb_copy(ORB_ID(sensor_mag), worker_data->sub_mag[cur_mag], &mag[cur_mag]);
 
 					// Check if this measurement is good to go in
-					rejected = rejected || reject_sample(mag.x, mag.y, mag.z,
-									     worker_data->x[cur_mag], worker_data->y[cur_mag], worker_data->z[cur_mag],
+					rejected = rejected || reject_sample(mag[cur_mag].x, mag[cur_mag].y, mag[cur_mag].z,
+									     worker_data->fit_data[cur_mag],
 									     worker_data->calibration_counter_total[cur_mag],
 									     calibration_sides * worker_data->calibration_points_perside);
-
-					worker_data->x[cur_mag][worker_data->calibration_counter_total[cur_mag]] = mag.x;
-					worker_data->y[cur_mag][worker_data->calibration_counter_total[cur_mag]] = mag.y;
-					worker_data->z[cur_mag][worker_data->calibration_counter_total[cur_mag]] = mag.z;
-					worker_data->calibration_counter_total[cur_mag]++;
 				}
 			}
 
-			// Keep calibration of all mags in lockstep
-			if (rejected) {
-				// Reset counts, since one of the mags rejected the measurement
+			// Keep calibration of all mags in lockstep: a sample is only used if none of the mags rejected it
+			if (!rejected) {
 				for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-					worker_data->calibration_counter_total[cur_mag] = prev_count[cur_mag];
+					if (worker_data->sub_mag[cur_mag] >= 0) {
+						mag_fit_data_t *fit_data = worker_data->fit_data[cur_mag];
+						float *recent = fit_data->recent[worker_data->calibration_counter_total[cur_mag] % recent_sample_count];
+
+						ellipsoid_fit_accumulate(&fit_data->fit, mag[cur_mag].x, mag[cur_mag].y, mag[cur_mag].z);
+						recent[0] = mag[cur_mag].x;
+						recent[1] = mag[cur_mag].y;
+						recent[2] = mag[cur_mag].z;
+						worker_data->calibration_counter_total[cur_mag]++;
+					}
 				}
 
-			} else {
 				calibration_counter_side++;
 
 				unsigned new_progress = progress_percentage(worker_data) +
@@ -563,14 +570,10 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub, int32_t cal_ma
 		worker_data.sub_mag[cur_mag] = -1;
 
 		// Initialize to no memory allocated
-		worker_data.x[cur_mag] = nullptr;
-		worker_data.y[cur_mag] = nullptr;
-		worker_data.z[cur_mag] = nullptr;
+		worker_data.fit_data[cur_mag] = nullptr;
 		worker_data.calibration_counter_total[cur_mag] = 0;
 	}
 
-	const unsigned int calibration_points_maxcount = calibration_sides * worker_data.calibration_points_perside;
-
 	char str[30];
 
 	// Get actual mag count and alloate only as much memory as needed
@@ -582,11 +585,10 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub, int32_t cal_ma
 	}
 
 	for (size_t cur_mag = 0; cur_mag < orb_mag_count && cur_mag < max_mags; cur_mag++) {
-		worker_data.x[cur_mag] = static_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
-		worker_data.y[cur_mag] = static_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
-		worker_data.z[cur_mag] = static_cast<float *>(malloc(sizeof(float) * calibration_points_maxcount));
+		// constant size, independent of the number of calibration points
+		worker_data.fit_data[cur_mag] = static_cast<mag_fit_data_t *>(calloc(1, sizeof(mag_fit_data_t)));
 
-		if (worker_data.x[cur_mag] == nullptr || worker_data.y[cur_mag] == nullptr || worker_data.z[cur_mag] == nullptr) {
+		if (worker_data.fit_data[cur_mag] == nullptr) {
 			calibration_log_critical(mavlink_log_pub, "ERROR: out of memory");
 			result = calibrate_return_error;
 		}
@@ -725,12 +727,16 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub, int32_t cal_ma
 				// enough to reliably estimate both scales and offsets with 2 sides only (even if the existing calibration
 				// is already close)
 				bool sphere_fit_only = calibration_sides <= 2;
-				ellipsoid_fit_least_squares(worker_data.x[cur_mag], worker_data.y[cur_mag], worker_data.z[cur_mag],
-							    worker_data.calibration_counter_total[cur_mag], 100,
-							    &sphere_x[cur_mag], &sphere_y[cur_mag], &sphere_z[cur_mag],
-							    &sphere_radius[cur_mag],
-							    &diag_x[cur_mag], &diag_y[cur_mag], &diag_z[cur_mag],
-							    &offdiag_x[cur_mag], &offdiag_y[cur_mag], &offdiag_z[cur_mag], sphere_fit_only);
+
+				if (ellipsoid_fit_solve(&worker_data.fit_data[cur_mag]->fit,
+							&sphere_x[cur_mag], &sphere_y[cur_mag], &sphere_z[cur_mag],
+							&sphere_radius[cur_mag],
+							&diag_x[cur_mag], &diag_y[cur_mag], &diag_z[cur_mag],
+							&offdiag_x[cur_mag], &offdiag_y[cur_mag], &offdiag_z[cur_mag], sphere_fit_only) != 0) {
+					calibration_log_critical(mavlink_log_pub, "ERROR: mag %u fit failed", cur_mag);
+					result = calibrate_return_error;
+					break;
+				}
 
 				result = check_calibration_result(sphere_x[cur_mag], sphere_y[cur_mag], sphere_z[cur_mag],
 								  sphere_radius[cur_mag],
@@ -745,56 +751,9 @@ calibrate_return mag_calibrate_all(orb_advert_t *mavlink_log_pub, int32_t cal_ma
 		}
 	}
 
-	// Print uncalibrated data points
-	if (result == calibrate_return_ok) {
-
-		// DO NOT REMOVE! Critical validation data!
-
-		// printf("RAW DATA:\n--------------------\n");
-		// for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-
-		// 	if (worker_data.calibration_counter_total[cur_mag] == 0) {
-		// 		continue;
-		// 	}
-
-		// 	printf("RAW: MAG %u with %u samples:\n", (unsigned)cur_mag, (unsigned)worker_data.calibration_counter_total[cur_mag]);
-
-		// 	for (size_t i = 0; i < worker_data.calibration_counter_total[cur_mag]; i++) {
-		// 		float x = worker_data.x[cur_mag][i];
-		// 		float y = worker_data.y[cur_mag][i];
-		// 		float z = worker_data.z[cur_mag][i];
-		// 		printf("%8.4f, %8.4f, %8.4f\n", (double)x, (double)y, (double)z);
-		// 	}
-
-		// 	printf(">>>>>>>\n");
-		// }
-
-		// printf("CALIBRATED DATA:\n--------------------\n");
-		// for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-
-		// 	if (worker_data.calibration_counter_total[cur_mag] == 0) {
-		// 		continue;
-		// 	}
-
-		// 	printf("Calibrated: MAG %u with %u samples:\n", (unsigned)cur_mag, (unsigned)worker_data.calibration_counter_total[cur_mag]);
-
-		// 	for (size_t i = 0; i < worker_data.calibration_counter_total[cur_mag]; i++) {
-		// 		float x = worker_data.x[cur_mag][i] - sphere_x[cur_mag];
-		// 		float y = worker_data.y[cur_mag][i] - sphere_y[cur_mag];
-		// 		float z = worker_data.z[cur_mag][i] - sphere_z[cur_mag];
-		// 		printf("%8.4f, %8.4f, %8.4f\n", (double)x, (double)y, (double)z);
-		// 	}
-
-		// 	printf("SPHERE RADIUS: %8.4f\n", (double)sphere_radius[cur_mag]);
-		// 	printf(">>>>>>>\n");
-		// }
-	}
-
-	// Data points are no longer needed
+	// Fit data is no longer needed
 	for (size_t cur_mag = 0; cur_mag < max_mags; cur_mag++) {
-		free(worker_data.x[cur_mag]);
-		free(worker_data.y[cur_mag]);
-		free(worker_data.z[cur_mag]);
+		free(worker_data.fit_data[cur_mag]);
 	}
 
 	if (result == calibrate_return_ok) {
@@ -58,6 +58,12 @@
 #include <nuttx/progmem.h>
 #endif
 
+#if defined(__PX4_POSIX)
+#define MMAP_BASED_DATAMAN
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 __BEGIN_DECLS
 __EXPORT int dataman_main(int argc, char *argv[]);
 __END_DECLS
@@ -72,6 +78,7 @@ static int  _file_clear(dm_item_t item);
 static int  _file_restart(dm_reset_reason reason);
 static int _file_initialize(unsigned max_offset);
 static void _file_shutdown();
+static void _file_sync();
 
 /* Private Ram based Operations */
 static ssize_t _ram_write(dm_item_t item, unsigned index, dm_persitence_t persistence, const void *buf,
@@ -96,6 +103,17 @@ static void _ram_flash_shutdown();
 static int _ram_flash_wait(px4_sem_t *sem);
 #endif
 
+#if defined(MMAP_BASED_DATAMAN)
+/* Private memory mapped file based Operations */
+static ssize_t _mmap_write(dm_item_t item, unsigned index, dm_persitence_t persistence, const void *buf,
+			   size_t count);
+static int  _mmap_clear(dm_item_t item);
+static int  _mmap_restart(dm_reset_reason reason);
+static int _mmap_initialize(unsigned max_offset);
+static void _mmap_shutdown();
+static void _mmap_sync();
+#endif
+
 typedef struct dm_operations_t {
 	ssize_t (*write)(dm_item_t item, unsigned index, dm_persitence_t persistence, const void *buf, size_t count);
 	ssize_t (*read)(dm_item_t item, unsigned index, void *buf, size_t count);
@@ -104,6 +122,7 @@ typedef struct dm_operations_t {
 	int (*initialize)(unsigned max_offset);
 	void (*shutdown)();
 	int (*wait)(px4_sem_t *sem);
+	void (*sync)();
 } dm_operations_t;
 
 static constexpr dm_operations_t dm_file_operations = {
@@ -114,6 +133,7 @@ static constexpr dm_operations_t dm_file_operations = {
 	.initialize = _file_initialize,
 	.shutdown = _file_shutdown,
 	.wait = px4_sem_wait,
+	.sync = _file_sync,
 };
 
 static constexpr dm_operations_t dm_ram_operations = {
@@ -124,6 +144,7 @@ static constexpr dm_operations_t dm_ram_operations = {
 	.initialize = _ram_initialize,
 	.shutdown = _ram_shutdown,
 	.wait = px4_sem_wait,
+	.sync = nullptr,
 };
 
 #if defined(FLASH_BASED_DATAMAN)
@@ -135,6 +156,20 @@ static constexpr dm_operations_t dm_ram_flash_operations = {
 	.initialize = _ram_flash_initialize,
 	.shutdown = _ram_flash_shutdown,
 	.wait = _ram_flash_wait,
+	.sync = nullptr,
+};
+#endif
+
+#if defined(MMAP_BASED_DATAMAN)
+static constexpr dm_operations_t dm_mmap_operations = {
+	.write   = _mmap_write,
+	.read    = _ram_read,
+	.clear   = _mmap_clear,
+	.restart = _mmap_restart,
+	.initialize = _mmap_initialize,
+	.shutdown = _mmap_shutdown,
+	.wait = px4_sem_wait,
+	.sync = _mmap_sync,
 };
 #endif
 
@@ -156,9 +191,19 @@ static struct {
 			/* sync above with RAM backend */
 			timespec flush_timeout;
 		} ram_flash;
+#endif
+#if defined(MMAP_BASED_DATAMAN)
+		struct {
+			uint8_t *data;
+			uint8_t *data_end;
+			/* sync above with RAM backend */
+			int fd;
+			size_t size;
+		} mmap;
 #endif
 	};
 	bool running;
+	bool sync_deferred; /**< if true, writes are not synchronized to the media individually */
 } dm_operations_data;
 
 /** Types of function calls supported by the worker task */
@@ -167,6 +212,8 @@ typedef enum {
 	dm_read_func,
 	dm_clear_func,
 	dm_restart_func,
+	dm_read_many_func,
+	dm_write_many_func,
 	dm_number_of_funcs
 } dm_function_t;
 
@@ -177,6 +224,8 @@ typedef struct {
 	unsigned char first;
 	unsigned char func;
 	ssize_t result;
+	dm_completion_cb_t callback;	/**< set for asynchronous requests, nobody waits on wait_sem then */
+	void *callback_arg;
 	union {
 		struct {
 			dm_item_t item;
@@ -197,6 +246,21 @@ typedef struct {
 		struct {
 			dm_reset_reason reason;
 		} restart_params;
+		struct {
+			dm_item_t item;
+			unsigned index;
+			unsigned num_items;
+			void *buf;
+			size_t item_size;
+		} read_many_params;
+		struct {
+			dm_item_t item;
+			unsigned index;
+			unsigned num_items;
+			dm_persitence_t persistence;
+			const void *buf;
+			size_t item_size;
+		} write_many_params;
 	};
 } work_q_item_t;
 
@@ -254,6 +318,9 @@ static enum {
 	BACKEND_RAM,
 #if defined(FLASH_BASED_DATAMAN)
 	BACKEND_RAM_FLASH,
+#endif
+#if defined(MMAP_BASED_DATAMAN)
+	BACKEND_MMAP,
 #endif
 	BACKEND_LAST
 } backend = BACKEND_NONE;
@@ -340,6 +407,9 @@ create_work_item()
 
 	/* If we got one then lock the item*/
 	if (item) {
+		item->callback = nullptr;
+		item->callback_arg = nullptr;
+
 		px4_sem_init(&item->wait_sem, 1, 0);        /* Caller will wait on this... initially locked */
 
 		/* item->wait_sem use case is a signal */
@@ -385,8 +455,8 @@ dequeue_work_item()
 	return work;
 }
 
-static int
-enqueue_work_item_and_wait_for_result(work_q_item_t *item)
+static void
+enqueue_work_item(work_q_item_t *item)
 {
 	/* put the work item at the end of the work queue */
 	lock_queue(&g_work_q);
@@ -401,6 +471,12 @@ enqueue_work_item_and_wait_for_result(work_q_item_t *item)
 
 	/* tell the work thread that work is available */
 	px4_sem_post(&g_work_queued_sema);
+}
+
+static int
+enqueue_work_item_and_wait_for_result(work_q_item_t *item)
+{
+	enqueue_work_item(item);
 
 	/* wait for the result */
 	px4_sem_wait(&item->wait_sem);
@@ -524,13 +600,72 @@ _file_write(dm_item_t item, unsigned index, dm_persitence_t persistence, const v
 		return -1;
 	}
 
-	/* Make sure data is written to physical media */
-	fsync(dm_operations_data.file.fd);
+	/* Make sure data is written to physical media, unless this is part of a batch synchronized at its end */
+	if (!dm_operations_data.sync_deferred) {
+		fsync(dm_operations_data.file.fd);
+	}
 
 	/* All is well... return the number of user data written */
 	return count - DM_SECTOR_HDR_SIZE;
 }
 
+static void
+_file_sync()
+{
+	fsync(dm_operations_data.file.fd);
+}
+
+/* write consecutive items, synchronizing the backend only once at the end */
+static ssize_t
+_write_many(dm_item_t item, unsigned index, unsigned num_items, dm_persitence_t persistence, const void *buf,
+	    size_t item_size)
+{
+	const uint8_t *buffer = (const uint8_t *)buf;
+	ssize_t num_written = 0;
+	ssize_t ret = 0;
+
+	dm_operations_data.sync_deferred = true;
+
+	for (unsigned i = 0; i < num_items; i++) {
+		ret = g_dm_ops->write(item, index + i, persistence, buffer + i * item_size, item_size);
+
+		if (ret != (ssize_t)item_size) {
+			break;
+		}
+
+		num_written++;
+	}
+
+	dm_operations_data.sync_deferred = false;
+
+	if (num_written > 0 && g_dm_ops->sync) {
+		g_dm_ops->sync();
+	}
+
+	return (num_written > 0 || ret >= 0) ? num_written : ret;
+}
+
+/* read consecutive items */
+static ssize_t
+_read_many(dm_item_t item, unsigned index, unsigned num_items, void *buf, size_t item_size)
+{
+	uint8_t *buffer = (uint8_t *)buf;
+	ssize_t num_read = 0;
+	ssize_t ret = 0;
+
+	for (unsigned i = 0; i < num_items; i++) {
+		ret = g_dm_ops->read(item, index + i, buffer + i * item_size, item_size);
+
+		if (ret != (ssize_t)item_size) {
+			break;
+		}
+
+		num_read++;
+	}
+
+	return (num_read > 0 || ret >= 0) ? num_read : ret;
+}
+
 #if defined(FLASH_BASED_DATAMAN)
 static void
 _ram_flash_update_flush_timeout()
@@ -1130,6 +1265,105 @@ dm_read(dm_item_t item, unsigned index, void *buf, size_t count)
 	return ret;
 }
 
+/** Retrieve consecutive items from the data manager file */
+__EXPORT ssize_t
+dm_read_many(dm_item_t item, unsigned index, unsigned num_items, void *buf, size_t item_size)
+{
+	work_q_item_t *work;
+
+	/* Make sure data manager has been started and is not shutting down */
+	if (!is_running() || g_task_should_exit) {
+		return -1;
+	}
+
+	perf_begin(_dm_read_perf);
+
+	/* get a work item and queue up a read request */
+	if ((work = create_work_item()) == nullptr) {
+		perf_end(_dm_read_perf);
+		return -1;
+	}
+
+	work->func = dm_read_many_func;
+	work->read_many_params.item = item;
+	work->read_many_params.index = index;
+	work->read_many_params.num_items = num_items;
+	work->read_many_params.buf = buf;
+	work->read_many_params.item_size = item_size;
+
+	/* Enqueue the item on the work queue and wait for the worker thread to complete processing it */
+	ssize_t ret = (ssize_t)enqueue_work_item_and_wait_for_result(work);
+	perf_end(_dm_read_perf);
+	return ret;
+}
+
+static work_q_item_t *
+create_write_many_work_item(dm_item_t item, unsigned index, unsigned num_items, dm_persitence_t persistence,
+			    const void *buf, size_t item_size)
+{
+	/* Make sure data manager has been started and is not shutting down */
+	if (!is_running() || g_task_should_exit) {
+		return nullptr;
+	}
+
+	work_q_item_t *work = create_work_item();
+
+	if (work) {
+		work->func = dm_write_many_func;
+		work->write_many_params.item = item;
+		work->write_many_params.index = index;
+		work->write_many_params.num_items = num_items;
+		work->write_many_params.persistence = persistence;
+		work->write_many_params.buf = buf;
+		work->write_many_params.item_size = item_size;
+	}
+
+	return work;
+}
+
+/** Write consecutive items to the data manager file */
+__EXPORT ssize_t
+dm_write_many(dm_item_t item, unsigned index, unsigned num_items, dm_persitence_t persistence, const void *buf,
+	      size_t item_size)
+{
+	perf_begin(_dm_write_perf);
+
+	work_q_item_t *work = create_write_many_work_item(item, index, num_items, persistence, buf, item_size);
+
+	if (work == nullptr) {
+		perf_end(_dm_write_perf);
+		return -1;
+	}
+
+	/* Enqueue the item on the work queue and wait for the worker thread to complete processing it */
+	ssize_t ret = (ssize_t)enqueue_work_item_and_wait_for_result(work);
+	perf_end(_dm_write_perf);
+	return ret;
+}
+
+/** Queue writing consecutive items to the data manager file */
+__EXPORT int
+dm_write_many_async(dm_item_t item, unsigned index, unsigned num_items, dm_persitence_t persistence, const void *buf,
+		    size_t item_size, dm_completion_cb_t callback, void *arg)
+{
+	if (callback == nullptr) {
+		return -1;
+	}
+
+	work_q_item_t *work = create_write_many_work_item(item, index, num_items, persistence, buf, item_size);
+
+	if (work == nullptr) {
+		return -1;
+	}
+
+	work->callback = callback;
+	work->callback_arg = arg;
+
+	/* the worker thread calls the callback and releases the work item */
+	enqueue_work_item(work);
+	return 0;
+}
+
 /** Clear a data Item */
 __EXPORT int
 dm_clear(dm_item_t item)
@@ -1247,6 +1481,123 @@ dm_flash_sector_description_set(const dm_sector_descriptor_t *description)
 }
 #endif
 
+#if defined(MMAP_BASED_DATAMAN)
+/* synchronize the pages containing [offset, offset + count) of the mapped file to the media */
+static void
+_mmap_sync_range(size_t offset, size_t count)
+{
+	const size_t page_size = sysconf(_SC_PAGESIZE);
+	const size_t start = offset - (offset % page_size);
+
+	msync(dm_operations_data.mmap.data + start, offset + count - start, MS_SYNC);
+}
+
+static void
+_mmap_sync()
+{
+	msync(dm_operations_data.mmap.data, dm_operations_data.mmap.size, MS_SYNC);
+}
+
+/* write to the mapped file, items are accessed like with the RAM backend */
+static ssize_t
+_mmap_write(dm_item_t item, unsigned index, dm_persitence_t persistence, const void *buf, size_t count)
+{
+	ssize_t ret = dm_ram_operations.write(item, index, persistence, buf, count);
+
+	/* Make sure data is written to physical media, unless this is part of a batch synchronized at its end */
+	if (ret >= 0 && !dm_operations_data.sync_deferred) {
+		_mmap_sync_range(calculate_offset(item, index), g_per_item_size[item]);
+	}
+
+	return ret;
+}
+
+static int
+_mmap_clear(dm_item_t item)
+{
+	int ret = dm_ram_operations.clear(item);
+	_mmap_sync();
+	return ret;
+}
+
+static int
+_mmap_restart(dm_reset_reason reason)
+{
+	int ret = dm_ram_operations.restart(reason);
+	_mmap_sync();
+	return ret;
+}
+
+static int
+_mmap_initialize(unsigned max_offset)
+{
+	/* Open or create the data manager file */
+	dm_operations_data.mmap.fd = open(k_data_manager_device_path, O_RDWR | O_CREAT | O_BINARY, PX4_O_MODE_666);
+
+	if (dm_operations_data.mmap.fd < 0) {
+		PX4_WARN("Could not open data manager file %s", k_data_manager_device_path);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	/* a file of a different size cannot have a compatible layout, start with an empty one */
+	struct stat st {};
+	bool incompat = (fstat(dm_operations_data.mmap.fd, &st) != 0) || ((size_t)st.st_size != max_offset);
+
+	if (incompat && (ftruncate(dm_operations_data.mmap.fd, 0) != 0
+			 || ftruncate(dm_operations_data.mmap.fd, max_offset) != 0)) {
+		close(dm_operations_data.mmap.fd);
+		PX4_WARN("Could not resize data manager file %s", k_data_manager_device_path);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	void *data = mmap(nullptr, max_offset, PROT_READ | PROT_WRITE, MAP_SHARED, dm_operations_data.mmap.fd, 0);
+
+	if (data == MAP_FAILED) {
+		close(dm_operations_data.mmap.fd);
+		PX4_WARN("Could not map data manager file %s", k_data_manager_device_path);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	dm_operations_data.mmap.data = (uint8_t *)data;
+	dm_operations_data.mmap.data_end = &dm_operations_data.mmap.data[max_offset - 1];
+	dm_operations_data.mmap.size = max_offset;
+
+	/* Check the compat info */
+	struct dataman_compat_s compat_state;
+	int ret = g_dm_ops->read(DM_KEY_COMPAT, 0, &compat_state, sizeof(compat_state));
+
+	if (ret != sizeof(compat_state) || compat_state.key != DM_COMPAT_KEY) {
+		/* Not compatible: clear the data and write the current compat info */
+		memset(dm_operations_data.mmap.data, 0, max_offset);
+
+		compat_state.key = DM_COMPAT_KEY;
+		ret = g_dm_ops->write(DM_KEY_COMPAT, 0, DM_PERSIST_POWER_ON_RESET, &compat_state, sizeof(compat_state));
+
+		if (ret != sizeof(compat_state)) {
+			PX4_ERR("Failed writing compat: %d", ret);
+		}
+
+		_mmap_sync();
+	}
+
+	dm_operations_data.running = true;
+
+	return 0;
+}
+
+static void
+_mmap_shutdown()
+{
+	_mmap_sync();
+	munmap(dm_operations_data.mmap.data, dm_operations_data.mmap.size);
+	close(dm_operations_data.mmap.fd);
+	dm_operations_data.running = false;
+}
+#endif
+
 static int
 task_main(int argc, char *argv[])
 {
@@ -1267,6 +1618,13 @@ task_main(int argc, char *argv[])
 		break;
 #endif
 
+#if defined(MMAP_BASED_DATAMAN)
+
+	case BACKEND_MMAP:
+		g_dm_ops = &dm_mmap_operations;
+		break;
+#endif
+
 	default:
 		PX4_WARN("No valid backend set.");
 		return -1;
@@ -1358,6 +1716,17 @@ task_main(int argc, char *argv[])
 		break;
 #endif
 
+#if defined(MMAP_BASED_DATAMAN)
+
+	case BACKEND_MMAP:
+		if (sys_restart_val != DM_INIT_REASON_POWER_ON) {
+			PX4_INFO("%s, data manager mapped file '%s' size is %d bytes",
+				 restart_type_str, k_data_manager_device_path, max_offset);
+		}
+
+		break;
+#endif
+
 	default:
 		break;
 	}
@@ -1403,13 +1772,34 @@ task_main(int argc, char *argv[])
 				work->result = g_dm_ops->restart(work->restart_params.reason);
 				break;
 
+			case dm_read_many_func:
+				g_func_counts[dm_read_many_func]++;
+				work->result = _read_many(work->read_many_params.item, work->read_many_params.index,
+							  work->read_many_params.num_items, work->read_many_params.buf,
+							  work->read_many_params.item_size);
+				break;
+
+			case dm_write_many_func:
+				g_func_counts[dm_write_many_func]++;
+				work->result = _write_many(work->write_many_params.item, work->write_many_params.index,
+							   work->write_many_params.num_items, work->write_many_params.persistence,
+							   work->write_many_params.buf, work->write_many_params.item_size);
+				break;
+
 			default: /* should never happen */
 				work->result = -1;
 				break;
 			}
 
-			/* Inform the caller that work is done */
-			px4_sem_post(&work->wait_sem);
+			if (work->callback) {
+				/* asynchronous request: report the result and release the work item, nobody is waiting for it */
+				work->callback(work->callback_arg, work->result);
+				destroy_work_item(work);
+
+			} else {
+				/* Inform the caller that work is done */
+				px4_sem_post(&work->wait_sem);
+			}
 		}
 
 		/* time to go???? */
@@ -1482,6 +1872,8 @@ status()
 	PX4_INFO("Reads    %d", g_func_counts[dm_read_func]);
 	PX4_INFO("Clears   %d", g_func_counts[dm_clear_func]);
 	PX4_INFO("Restarts %d", g_func_counts[dm_restart_func]);
+	PX4_INFO("Batched reads  %d", g_func_counts[dm_read_many_func]);
+	PX4_INFO("Batched writes %d", g_func_counts[dm_write_many_func]);
 	PX4_INFO("Max Q lengths work %d, free %d", g_work_q.max_size, g_free_q.max_size);
 	perf_print_counter(_dm_read_perf);
 	perf_print_counter(_dm_write_perf);
@@ -1504,6 +1896,8 @@ usage()
 Module to provide persistent storage for the rest of the system in form of a simple database through a C API.
 Multiple backends are supported:
 - a file (eg. on the SD card)
+- a memory mapped file (POSIX only), items are accessed in memory and synchronized to the file after each write
+  or batch of writes
 - FLASH (if the board supports it)
 - FRAM
 - RAM (this is obviously not persistent)
@@ -1527,7 +1921,8 @@ check for geofence violations.
 	PRINT_MODULE_USAGE_PARAM_STRING('f', nullptr, "<file>", "Storage file", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('r', "Use RAM backend (NOT persistent)", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('i', "Use FLASH backend", true);
-	PRINT_MODULE_USAGE_PARAM_COMMENT("The options -f, -r and -i are mutually exclusive. If nothing is specified, a file 'dataman' is used");
+	PRINT_MODULE_USAGE_PARAM_STRING('m', nullptr, "<file>", "Memory mapped storage file (POSIX only)", true);
+	PRINT_MODULE_USAGE_PARAM_COMMENT("The options -f, -r, -i and -m are mutually exclusive. If nothing is specified, a file 'dataman' is used");
 
 	PRINT_MODULE_USAGE_COMMAND_DESCR("poweronrestart", "Restart dataman (on power on)");
 	PRINT_MODULE_USAGE_COMMAND_DESCR("inflightrestart", "Restart dataman (in flight)");
@@ -1537,7 +1932,7 @@ check for geofence violations.
 static int backend_check()
 {
 	if (backend != BACKEND_NONE) {
-		PX4_WARN("-f, -r and -i are mutually exclusive");
+		PX4_WARN("-f, -r, -i and -m are mutually exclusive");
 		usage();
 		return -1;
 	}
@@ -1566,7 +1961,7 @@ dataman_main(int argc, char *argv[])
 
 		/* jump over start and look at options first */
 
-		while ((ch = px4_getopt(argc, argv, "f:ri", &dmoptind, &dmoptarg)) != EOF) {
+		while ((ch = px4_getopt(argc, argv, "f:rim:", &dmoptind, &dmoptarg)) != EOF) {
 			switch (ch) {
 			case 'f':
 				if (backend_check()) {
@@ -1604,6 +1999,21 @@ dataman_main(int argc, char *argv[])
 				return -1;
 #endif
 
+			case 'm':
+#if defined(MMAP_BASED_DATAMAN)
+				if (backend_check()) {
+					return -1;
+				}
+
+				backend = BACKEND_MMAP;
+				k_data_manager_device_path = strdup(dmoptarg);
+				PX4_INFO("dataman mapped file set to: %s", k_data_manager_device_path);
+				break;
+#else
+				PX4_WARN("Memory mapped backend is not available");
+				return -1;
+#endif
+
 			//no break
 			default:
 				usage();
@@ -125,6 +125,57 @@ dm_write(
 	size_t buflen			/* Length in bytes of data to retrieve */
 );
 
+/**
+ * Retrieve consecutive items of a type from the data manager store with a single request.
+ * The items are stored back to back in the buffer, item_size bytes each.
+ * @return number of items read (stops at the first item that cannot be read), or a negative value if the
+ *         first item could not be read
+ */
+__EXPORT ssize_t
+dm_read_many(
+	dm_item_t item,			/* The item type to retrieve */
+	unsigned index,			/* The index of the first item */
+	unsigned num_items,		/* The number of items to retrieve */
+	void *buffer,			/* Pointer to caller data buffer, num_items * item_size bytes */
+	size_t item_size		/* Length in bytes of a single item */
+);
+
+/**
+ * Write consecutive items of a type to the data manager store with a single request.
+ * The backend is synchronized to the physical media once after all items are written.
+ * @return number of items written (stops at the first item that cannot be written), or a negative value if the
+ *         first item could not be written
+ */
+__EXPORT ssize_t
+dm_write_many(
+	dm_item_t item,			/* The item type to store */
+	unsigned index,			/* The index of the first item */
+	unsigned num_items,		/* The number of items to store */
+	dm_persitence_t persistence,	/* The persistence level of the items */
+	const void *buffer,		/* Pointer to caller data buffer, num_items * item_size bytes */
+	size_t item_size		/* Length in bytes of a single item */
+);
+
+/** Completion callback of an asynchronous request, called from the data manager task with the request result */
+typedef void (*dm_completion_cb_t)(void *arg, ssize_t result);
+
+/**
+ * Queue a dm_write_many() request without waiting for it to complete. The buffer must remain valid until the
+ * callback is called.
+ * @return 0 if the request is queued, -1 otherwise (the callback is not called then)
+ */
+__EXPORT int
+dm_write_many_async(
+	dm_item_t item,			/* The item type to store */
+	unsigned index,			/* The index of the first item */
+	unsigned num_items,		/* The number of items to store */
+	dm_persitence_t persistence,	/* The persistence level of the items */
+	const void *buffer,		/* Pointer to caller data buffer, num_items * item_size bytes */
+	size_t item_size,		/* Length in bytes of a single item */
+	dm_completion_cb_t callback,	/* Called when the request is complete */
+	void *arg			/* Argument passed to the callback */
+);
+
 /**
  * Lock all items of a type. Can be used for atomic updates of multiple items (single items are always updated
  * atomically).
@@ -0,0 +1,427 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "EKF2Selector.hpp"
+
+#include <px4_platform_common/log.h>
+
+using namespace time_literals;
+using matrix::Quatf;
+using matrix::Vector2f;
+
+EKF2Selector::EKF2Selector() :
+	ScheduledWorkItem("ekf2_selector", px4::wq_configurations::att_pos_ctrl)
+{
+}
+
+EKF2Selector::~EKF2Selector()
+{
+	for (auto &inst : _instance) {
+		inst.estimator_attitude_sub.unregisterCallback();
+	}
+
+	ScheduleClear();
+
+	perf_free(_cycle_perf);
+}
+
+bool EKF2Selector::Start()
+{
+	for (auto &inst : _instance) {
+		if (!inst.estimator_attitude_sub.registerCallback()) {
+			PX4_ERR("estimator_attitude callback registration failed");
+			return false;
+		}
+	}
+
+	// run at least at 1 Hz to detect timed out instances
+	ScheduleOnInterval(1_s);
+
+	return true;
+}
+
+void EKF2Selector::Stop()
+{
+	_should_stop.store(true);
+	ScheduleNow();
+}
+
+void EKF2Selector::UpdateInstances()
+{
+	const hrt_abstime time_now_us = hrt_absolute_time();
+
+	for (auto &inst : _instance) {
+		vehicle_attitude_s attitude;
+
+		if (inst.estimator_attitude_sub.update(&attitude)) {
+			inst.attitude_timestamp = attitude.timestamp;
+		}
+
+		inst.timed_out = (inst.attitude_timestamp == 0) || (time_now_us > inst.attitude_timestamp + INSTANCE_TIMEOUT);
+
+		estimator_status_s status;
+
+		if (inst.estimator_status_sub.update(&status)) {
+			const bool tilt_align = status.control_mode_flags & (1 << estimator_status_s::CS_TILT_ALIGN);
+
+			inst.combined_test_ratio = fmaxf(0.5f * (status.vel_test_ratio + status.pos_test_ratio), status.hgt_test_ratio);
+			inst.healthy = tilt_align && (status.filter_fault_flags == 0) && (inst.combined_test_ratio < HEALTHY_TEST_RATIO);
+		}
+
+		estimator_sensor_bias_s bias;
+
+		if (inst.estimator_sensor_bias_sub.update(&bias)) {
+			inst.accel_device_id = bias.accel_device_id;
+			inst.gyro_device_id = bias.gyro_device_id;
+		}
+
+		if (inst.timed_out) {
+			inst.healthy = false;
+		}
+	}
+
+	// test ratios relative to the selected instance, filtered to avoid switching on short innovation spikes
+	const float selected_ratio = _instance[_selected_instance].combined_test_ratio;
+
+	for (uint8_t i = 0; i < MAX_INSTANCES; i++) {
+		if (i == _selected_instance || !_instance[i].healthy) {
+			_instance[i].relative_test_ratio = 0.f;
+
+		} else {
+			const float error = _instance[i].combined_test_ratio - selected_ratio;
+			_instance[i].relative_test_ratio += REL_TEST_RATIO_ALPHA * (error - _instance[i].relative_test_ratio);
+		}
+	}
+}
+
+bool EKF2Selector::SelectInstance(uint8_t instance)
+{
+	if (_selected && (instance == _selected_instance)) {
+		return false;
+	}
+
+	if (_selected) {
+		PX4_WARN("primary estimator changed %d -> %d", _selected_instance, instance);
+		_instance_changed_count++;
+		_last_instance_change = hrt_absolute_time();
+
+		// the next publication of each output is treated as a reset
+		_attitude_instance_changed = true;
+		_local_position_instance_changed = true;
+		_global_position_instance_changed = true;
+	}
+
+	_selected_instance = instance;
+	_selected = true;
+
+	// reset the relative test ratios to the new reference
+	for (auto &inst : _instance) {
+		inst.relative_test_ratio = 0.f;
+	}
+
+	return true;
+}
+
+void EKF2Selector::PublishVehicleAttitude()
+{
+	vehicle_attitude_s attitude;
+
+	if (!_instance[_selected_instance].estimator_attitude_sub.copy(&attitude)
+	    || (attitude.timestamp <= _attitude_last.timestamp)) {
+		return;
+	}
+
+	const uint8_t instance_reset_counter = attitude.quat_reset_counter;
+
+	if (_attitude_instance_changed) {
+		if (_attitude_last.timestamp != 0) {
+			// report the jump between the two instances as a reset
+			const Quatf delta_q_reset = Quatf(attitude.q) * Quatf(_attitude_last.q).inversed();
+			delta_q_reset.copyTo(attitude.delta_q_reset);
+			_quat_reset_counter++;
+		}
+
+		_attitude_instance_changed = false;
+
+	} else if (instance_reset_counter != _instance_quat_reset_counter) {
+		// pass through resets of the selected instance
+		_quat_reset_counter++;
+
+	} else {
+		memcpy(attitude.delta_q_reset, _attitude_last.delta_q_reset, sizeof(attitude.delta_q_reset));
+	}
+
+	_instance_quat_reset_counter = instance_reset_counter;
+	attitude.quat_reset_counter = _quat_reset_counter;
+
+	_attitude_last = attitude;
+	_vehicle_attitude_pub.publish(attitude);
+	state_history::attitude().push(attitude);
+}
+
+void EKF2Selector::PublishVehicleLocalPosition()
+{
+	vehicle_local_position_s local_pos;
+
+	if (!_instance[_selected_instance].estimator_local_position_sub.copy(&local_pos)
+	    || (local_pos.timestamp <= _local_position_last.timestamp)) {
+		return;
+	}
+
+	const uint8_t instance_xy_reset_counter = local_pos.xy_reset_counter;
+	const uint8_t instance_z_reset_counter = local_pos.z_reset_counter;
+	const uint8_t instance_vxy_reset_counter = local_pos.vxy_reset_counter;
+	const uint8_t instance_vz_reset_counter = local_pos.vz_reset_counter;
+
+	if (_local_position_instance_changed) {
+		if (_local_position_last.timestamp != 0) {
+			// report the jump between the two instances as a reset of all states
+			const Vector2f delta_xy = Vector2f{local_pos.x, local_pos.y} - Vector2f{_local_position_last.x, _local_position_last.y};
+			delta_xy.copyTo(local_pos.delta_xy);
+			local_pos.delta_z = local_pos.z - _local_position_last.z;
+
+			const Vector2f delta_vxy = Vector2f{local_pos.vx, local_pos.vy} - Vector2f{_local_position_last.vx, _local_position_last.vy};
+			delta_vxy.copyTo(local_pos.delta_vxy);
+			local_pos.delta_vz = local_pos.vz - _local_position_last.vz;
+
+			_xy_reset_counter++;
+			_z_reset_counter++;
+			_vxy_reset_counter++;
+			_vz_reset_counter++;
+		}
+
+		_local_position_instance_changed = false;
+
+	} else {
+		// pass through resets of the selected instance
+		if (instance_xy_reset_counter != _instance_xy_reset_counter) {
+			_xy_reset_counter++;
+
+		} else {
+			memcpy(local_pos.delta_xy, _local_position_last.delta_xy, sizeof(local_pos.delta_xy));
+		}
+
+		if (instance_z_reset_counter != _instance_z_reset_counter) {
+			_z_reset_counter++;
+
+		} else {
+			local_pos.delta_z = _local_position_last.delta_z;
+		}
+
+		if (instance_vxy_reset_counter != _instance_vxy_reset_counter) {
+			_vxy_reset_counter++;
+
+		} else {
+			memcpy(local_pos.delta_vxy, _local_position_last.delta_vxy, sizeof(local_pos.delta_vxy));
+		}
+
+		if (instance_vz_reset_counter != _instance_vz_reset_counter) {
+			_vz_reset_counter++;
+
+		} else {
+			local_pos.delta_vz = _local_position_last.delta_vz;
+		}
+	}
+
+	_instance_xy_reset_counter = instance_xy_reset_counter;
+	_instance_z_reset_counter = instance_z_reset_counter;
+	_instance_vxy_reset_counter = instance_vxy_reset_counter;
+	_instance_vz_reset_counter = instance_vz_reset_counter;
+
+	local_pos.xy_reset_counter = _xy_reset_counter;
+	local_pos.z_reset_counter = _z_reset_counter;
+	local_pos.vxy_reset_counter = _vxy_reset_counter;
+	local_pos.vz_reset_counter = _vz_reset_counter;
+
+	_local_position_last = local_pos;
+	_vehicle_local_position_pub.publish(local_pos);
+	state_history::local_position().push(local_pos);
+}
+
+void EKF2Selector::PublishVehicleGlobalPosition()
+{
+	vehicle_global_position_s global_pos;
+
+	if (!_instance[_selected_instance].estimator_global_position_sub.copy(&global_pos)
+	    || (global_pos.timestamp <= _global_position_last.timestamp)) {
+		return;
+	}
+
+	const uint8_t instance_lat_lon_reset_counter = global_pos.lat_lon_reset_counter;
+	const uint8_t instance_alt_reset_counter = global_pos.alt_reset_counter;
+
+	if (_global_position_instance_changed) {
+		if (_global_position_last.timestamp != 0) {
+			global_pos.delta_alt = global_pos.alt - _global_position_last.alt;
+			_lat_lon_reset_counter++;
+			_alt_reset_counter++;
+		}
+
+		_global_position_instance_changed = false;
+
+	} else {
+		if (instance_lat_lon_reset_counter != _instance_lat_lon_reset_counter) {
+			_lat_lon_reset_counter++;
+		}
+
+		if (instance_alt_reset_counter != _instance_alt_reset_counter) {
+			_alt_reset_counter++;
+
+		} else {
+			global_pos.delta_alt = _global_position_last.delta_alt;
+		}
+	}
+
+	_instance_lat_lon_reset_counter = instance_lat_lon_reset_counter;
+	_instance_alt_reset_counter = instance_alt_reset_counter;
+
+	global_pos.lat_lon_reset_counter = _lat_lon_reset_counter;
+	global_pos.alt_reset_counter = _alt_reset_counter;
+
+	_global_position_last = global_pos;
+	_vehicle_global_position_pub.publish(global_pos);
+	state_history::global_position().push(global_pos);
+}
+
+void EKF2Selector::PublishSelectorStatus()
+{
+	estimator_selector_status_s selector_status{};
+	selector_status.primary_instance = _selected_instance;
+	selector_status.instances_available = 0;
+	selector_status.instance_changed_count = _instance_changed_count;
+	selector_status.last_instance_change = _last_instance_change;
+	selector_status.accel_device_id = _instance[_selected_instance].accel_device_id;
+	selector_status.gyro_device_id = _instance[_selected_instance].gyro_device_id;
+
+	for (int i = 0; i < MAX_INSTANCES; i++) {
+		if (!_instance[i].timed_out) {
+			selector_status.instances_available++;
+		}
+
+		selector_status.combined_test_ratio[i] = _instance[i].combined_test_ratio;
+		selector_status.relative_test_ratio[i] = _instance[i].relative_test_ratio;
+		selector_status.healthy[i] = _instance[i].healthy;
+	}
+
+	selector_status.timestamp = hrt_absolute_time();
+	_estimator_selector_status_pub.publish(selector_status);
+	_last_status_publish = selector_status.timestamp;
+}
+
+void EKF2Selector::Run()
+{
+	if (_should_stop.load()) {
+		for (auto &inst : _instance) {
+			inst.estimator_attitude_sub.unregisterCallback();
+		}
+
+		ScheduleClear();
+		_stopped.store(true);
+		return;
+	}
+
+	perf_begin(_cycle_perf);
+
+	UpdateInstances();
+
+	bool changed = false;
+
+	if (!_selected) {
+		// start with the first healthy instance, instance 0 is preferred
+		for (uint8_t i = 0; i < MAX_INSTANCES; i++) {
+			if (_instance[i].healthy) {
+				changed = SelectInstance(i);
+				break;
+			}
+		}
+
+	} else if (!_instance[_selected_instance].healthy) {
+		// switch immediately to the best healthy instance if the selected one is no longer healthy
+		int best = -1;
+		float best_ratio = INFINITY;
+
+		for (uint8_t i = 0; i < MAX_INSTANCES; i++) {
+			if (_instance[i].healthy && (_instance[i].combined_test_ratio < best_ratio)) {
+				best = i;
+				best_ratio = _instance[i].combined_test_ratio;
+			}
+		}
+
+		if (best >= 0) {
+			changed = SelectInstance(best);
+		}
+
+	} else if (hrt_elapsed_time(&_last_instance_change) > SWITCH_HOLDOFF) {
+		// switch to a healthy instance that has been consistently better than the selected one
+		int best = -1;
+		float best_ratio = -REL_TEST_RATIO_SWITCH;
+
+		for (uint8_t i = 0; i < MAX_INSTANCES; i++) {
+			if (_instance[i].healthy && (_instance[i].relative_test_ratio < best_ratio)) {
+				best = i;
+				best_ratio = _instance[i].relative_test_ratio;
+			}
+		}
+
+		if (best >= 0) {
+			changed = SelectInstance(best);
+		}
+	}
+
+	if (_selected) {
+		PublishVehicleAttitude();
+		PublishVehicleLocalPosition();
+		PublishVehicleGlobalPosition();
+	}
+
+	if (changed || (hrt_elapsed_time(&_last_status_publish) >= 1_s)) {
+		PublishSelectorStatus();
+	}
+
+	perf_end(_cycle_perf);
+}
+
+void EKF2Selector::PrintStatus()
+{
+	PX4_INFO("primary instance: %d, changed %d times", _selected_instance, _instance_changed_count);
+
+	for (int i = 0; i < MAX_INSTANCES; i++) {
+		const EstimatorInstance &inst = _instance[i];
+
+		PX4_INFO("%d: accel: %d, gyro: %d, healthy: %d, timed out: %d, test ratio: %.4f, relative: %.4f", i,
+			 inst.accel_device_id, inst.gyro_device_id, inst.healthy, inst.timed_out,
+			 (double)inst.combined_test_ratio, (double)inst.relative_test_ratio);
+	}
+
+	perf_print_counter(_cycle_perf);
+}
@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file EKF2Selector.hpp
+ *
+ * Selection of the primary instance of the ekf2 bank. The outputs of the primary instance are republished as
+ * vehicle_attitude, vehicle_local_position and vehicle_global_position, a change of the primary instance is
+ * handled like an estimator reset by the consumers.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <lib/mathlib/mathlib.h>
+#include <lib/matrix/matrix/math.hpp>
+#include <lib/perf/perf_counter.h>
+#include <lib/state_history/StateHistory.hpp>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/defines.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
+#include <uORB/topics/estimator_selector_status.h>
+#include <uORB/topics/estimator_sensor_bias.h>
+#include <uORB/topics/estimator_status.h>
+#include <uORB/topics/vehicle_attitude.h>
+#include <uORB/topics/vehicle_global_position.h>
+#include <uORB/topics/vehicle_local_position.h>
+
+using namespace time_literals;
+
+class EKF2Selector : public px4::ScheduledWorkItem
+{
+public:
+	static constexpr int MAX_INSTANCES = 3;
+
+	EKF2Selector();
+	~EKF2Selector() override;
+
+	bool Start();
+
+	/**
+	 * Request the selector to stop, Stopped() returns true once it is safe to delete it.
+	 */
+	void Stop();
+	bool Stopped() const { return _stopped.load(); }
+
+	void PrintStatus();
+
+private:
+	static constexpr float HEALTHY_TEST_RATIO = 1.f;		///< test ratio above which an instance is not healthy
+	static constexpr float REL_TEST_RATIO_SWITCH = 0.5f;		///< relative test ratio at which a better instance is selected
+	static constexpr float REL_TEST_RATIO_ALPHA = 0.05f;		///< filter coefficient of the relative test ratio
+	static constexpr hrt_abstime INSTANCE_TIMEOUT = 50_ms;	///< attitude timeout of an instance
+	static constexpr hrt_abstime SWITCH_HOLDOFF = 10_s;		///< minimum time between switches to a better instance
+
+	void Run() override;
+
+	void UpdateInstances();
+	bool SelectInstance(uint8_t instance);
+	void PublishVehicleAttitude();
+	void PublishVehicleLocalPosition();
+	void PublishVehicleGlobalPosition();
+	void PublishSelectorStatus();
+
+	struct EstimatorInstance {
+		EstimatorInstance(EKF2Selector *selector, uint8_t i) :
+			estimator_attitude_sub{selector, ORB_ID(estimator_attitude), i},
+			estimator_status_sub{ORB_ID(estimator_status), i},
+			estimator_local_position_sub{ORB_ID(estimator_local_position), i},
+			estimator_global_position_sub{ORB_ID(estimator_global_position), i},
+			estimator_sensor_bias_sub{ORB_ID(estimator_sensor_bias), i}
+		{}
+
+		uORB::SubscriptionCallbackWorkItem estimator_attitude_sub;
+		uORB::Subscription estimator_status_sub;
+		uORB::Subscription estimator_local_position_sub;
+		uORB::Subscription estimator_global_position_sub;
+		uORB::Subscription estimator_sensor_bias_sub;
+
+		hrt_abstime attitude_timestamp{0};
+		uint32_t accel_device_id{0};
+		uint32_t gyro_device_id{0};
+
+		float combined_test_ratio{0.f};
+		float relative_test_ratio{0.f};
+
+		bool healthy{false};
+		bool timed_out{true};
+	};
+
+	EstimatorInstance _instance[MAX_INSTANCES] {
+		{this, 0},
+		{this, 1},
+		{this, 2},
+	};
+
+	uint8_t _selected_instance{0};
+	bool _selected{false};				///< an instance has been selected at least once
+	uint32_t _instance_changed_count{0};
+	hrt_abstime _last_instance_change{0};
+	hrt_abstime _last_status_publish{0};
+
+	// last published outputs and own reset counters, continuous across instance changes
+	vehicle_attitude_s _attitude_last{};
+	vehicle_local_position_s _local_position_last{};
+	vehicle_global_position_s _global_position_last{};
+
+	bool _attitude_instance_changed{false};
+	bool _local_position_instance_changed{false};
+	bool _global_position_instance_changed{false};
+
+	uint8_t _quat_reset_counter{0};
+	uint8_t _xy_reset_counter{0};
+	uint8_t _z_reset_counter{0};
+	uint8_t _vxy_reset_counter{0};
+	uint8_t _vz_reset_counter{0};
+	uint8_t _lat_lon_reset_counter{0};
+	uint8_t _alt_reset_counter{0};
+
+	// reset counters of the selected instance at its last publication
+	uint8_t _instance_quat_reset_counter{0};
+	uint8_t _instance_xy_reset_counter{0};
+	uint8_t _instance_z_reset_counter{0};
+	uint8_t _instance_vxy_reset_counter{0};
+	uint8_t _instance_vz_reset_counter{0};
+	uint8_t _instance_lat_lon_reset_counter{0};
+	uint8_t _instance_alt_reset_counter{0};
+
+	px4::atomic<bool> _should_stop{false};
+	px4::atomic<bool> _stopped{false};
+
+	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, "ekf2: selector cycle")};
+
+	uORB::Publication<estimator_selector_status_s> _estimator_selector_status_pub{ORB_ID(estimator_selector_status)};
+	uORB::Publication<vehicle_attitude_s> _vehicle_attitude_pub{ORB_ID(vehicle_attitude)};
+	uORB::Publication<vehicle_global_position_s> _vehicle_global_position_pub{ORB_ID(vehicle_global_position)};
+	uORB::Publication<vehicle_local_position_s> _vehicle_local_position_pub{ORB_ID(vehicle_local_position)};
+};
@@ -44,6 +44,7 @@
 #include <lib/ecl/EKF/ekf.h>
 #include <lib/mathlib/mathlib.h>
 #include <lib/perf/perf_counter.h>
+#include <lib/state_history/StateHistory.hpp>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/module_params.h>
@@ -58,8 +59,8 @@
 #include <uORB/topics/distance_sensor.h>
 #include <uORB/topics/ekf2_timestamps.h>
 #include <uORB/topics/ekf_gps_drift.h>
-#include <uORB/topics/ekf_gps_position.h>
 #include <uORB/topics/estimator_innovations.h>
+#include <uORB/topics/estimator_selector_status.h>
 #include <uORB/topics/estimator_sensor_bias.h>
 #include <uORB/topics/estimator_status.h>
 #include <uORB/topics/landing_target_pose.h>
@@ -79,24 +80,16 @@
 #include <uORB/topics/vehicle_status.h>
 #include <uORB/topics/wind_estimate.h>
 
+#include "EKF2Selector.hpp"
 #include "Utility/PreFlightChecker.hpp"
 
-// defines used to specify the mask position for use of different accuracy metrics in the GPS blending algorithm
-#define BLEND_MASK_USE_SPD_ACC      1
-#define BLEND_MASK_USE_HPOS_ACC     2
-#define BLEND_MASK_USE_VPOS_ACC     4
-
-// define max number of GPS receivers supported and 0 base instance used to access virtual 'blended' GPS solution
-#define GPS_MAX_RECEIVERS 2
-#define GPS_BLENDED_INSTANCE 2
-
 using math::constrain;
 using namespace time_literals;
 
 class Ekf2 final : public ModuleBase<Ekf2>, public ModuleParams, public px4::ScheduledWorkItem
 {
 public:
-	explicit Ekf2(bool replay_mode = false);
+	Ekf2(bool multi_mode, int instance, const px4::wq_config_t &config, bool replay_mode = false);
 	~Ekf2() override;
 
 	/** @see ModuleBase */
@@ -108,13 +101,70 @@ public:
 	/** @see ModuleBase */
 	static int print_usage(const char *reason = nullptr);
 
+	/**
+	 * Start one estimator instance per IMU (EKF2_MULTI_IMU) and the selector of the primary instance.
+	 */
+	static int start_bank(int count);
+
+	/**
+	 * Start one replay instance per parameter set of a sweep file.
+	 */
+	static int start_sweep(const char *sweep_file);
+
 	bool init();
 
 	int print_status() override;
 
 private:
+	static constexpr int MAX_SENSOR_COUNT = 3;
+
 	void Run() override;
 
+	/**
+	 * Stop the secondary instances and the selector of the multi-instance bank.
+	 * @return true once all of them have stopped and are deleted
+	 */
+	bool stop_bank();
+
+	void updateParams() override;
+
+	// parameter sweep in replay: per instance overrides of the filter tuning parameters
+	struct ParamOverride {
+		param_t handle{PARAM_INVALID};
+		float value{0.f};
+	};
+
+	static constexpr int MAX_PARAM_OVERRIDES = 16;
+	ParamOverride _param_overrides[MAX_PARAM_OVERRIDES] {};
+	int _param_override_count{0};
+	bool _sweep_mode{false};
+
+	bool applyParamOverride(const ParamOverride &param_override);
+
+	// innovation test ratio statistics of a replay, used to compare the parameter sets of a sweep
+	struct TestRatioStatistics {
+		float sum{0.f};
+		float sum_sq{0.f};
+		float max{0.f};
+		uint32_t count{0};
+
+		void update(float ratio)
+		{
+			// a ratio of 0 means that the measurement has not been fused
+			if (PX4_ISFINITE(ratio) && (ratio > 0.f)) {
+				sum += ratio;
+				sum_sq += ratio * ratio;
+				max = math::max(max, ratio);
+				count++;
+			}
+		}
+	};
+
+	enum TestRatio { TEST_RATIO_VEL, TEST_RATIO_POS, TEST_RATIO_HGT, TEST_RATIO_MAG, TEST_RATIO_TAS, TEST_RATIO_HAGL, TEST_RATIO_BETA, TEST_RATIO_COUNT };
+	TestRatioStatistics _test_ratio_stats[TEST_RATIO_COUNT] {};
+
+	void print_sweep_statistics();
+
 	int getRangeSubIndex(); ///< get subscription index of first downward-facing range sensor
 	void fillGpsMsgWithVehicleGpsPosData(gps_message &msg, const vehicle_gps_position_s &data);
 
@@ -133,38 +183,6 @@ private:
 	bool publish_attitude(const hrt_abstime &now);
 	bool publish_wind_estimate(const hrt_abstime &timestamp);
 
-	/*
-	 * Update the internal state estimate for a blended GPS solution that is a weighted average of the phsyical
-	 * receiver solutions. This internal state cannot be used directly by estimators because if physical receivers
-	 * have significant position differences, variation in receiver estimated accuracy will cause undesirable
-	 * variation in the position solution.
-	*/
-	bool blend_gps_data();
-
-	/*
-	 * Calculate internal states used to blend GPS data from multiple receivers using weightings calculated
-	 * by calc_blend_weights()
-	 * States are written to _gps_state and _gps_blended_state class variables
-	 */
-	void update_gps_blend_states();
-
-	/*
-	 * The location in _gps_blended_state will move around as the relative accuracy changes.
-	 * To mitigate this effect a low-pass filtered offset from each GPS location to the blended location is
-	 * calculated.
-	*/
-	void update_gps_offsets();
-
-	/*
-	 * Apply the steady state physical receiver offsets calculated by update_gps_offsets().
-	*/
-	void apply_gps_offsets();
-
-	/*
-	 Calculate GPS output that is a blend of the offset corrected physical receiver data
-	*/
-	void calc_gps_blend_output();
-
 	/*
 	 * Calculate filtered WGS84 height from estimated AMSL height
 	 */
@@ -173,6 +191,15 @@ private:
 	inline float sq(float x) { return x * x; };
 
 	const bool 	_replay_mode;			///< true when we use replay data from a log
+	const bool	_multi_mode;			///< true when running as one instance of the multi-IMU bank (EKF2_MULTI_IMU)
+	const int	_instance;			///< instance index within the bank, 0 is the primary task
+
+	bool _primary{true};				///< true if this instance is selected, only the selected instance saves parameters
+	px4::atomic<bool> _stopped{false};		///< set by a secondary instance once it no longer runs
+
+	// the bank is owned by instance 0
+	static Ekf2 *_bank[MAX_SENSOR_COUNT];
+	static EKF2Selector *_selector;
 
 	// time slip monitoring
 	uint64_t _integrated_time_us = 0;	///< integral of gyro delta time from start (uSec)
@@ -181,6 +208,22 @@ private:
 
 	perf_counter_t _ekf_update_perf;
 
+	// execution time of the measurement steps of a cycle, indexed by estimator_status_s::STEP_*
+	static constexpr int MEASUREMENT_STEP_COUNT = 7;
+	perf_counter_t _step_perf[MEASUREMENT_STEP_COUNT] {};
+	float _step_time_us[MEASUREMENT_STEP_COUNT] {};		///< filtered step execution time (uSec)
+	hrt_abstime _step_start{0};
+
+	void step_begin(uint8_t step);
+	void step_end(uint8_t step);
+
+	// cycle budget, low priority measurements (mag, airspeed) are deferred to the next cycle after an overrun
+	uint32_t _cycle_time_us{0};		///< execution time of the last cycle (uSec)
+	uint32_t _update_time_us{0};		///< execution time of the last filter update (uSec)
+	uint32_t _cycle_budget_us{0};		///< cycle execution time budget, 0 if disabled (uSec)
+	uint32_t _deferred_cycles{0};		///< number of cycles with deferred low priority measurements
+	bool _low_priority_deferred{false};	///< true if the low priority measurements were deferred in the last cycle
+
 	// Initialise time stamps used to send sensor data to the EKF and for logging
 	uint8_t _invalid_mag_id_count = 0;	///< number of times an invalid magnetomer device ID has been detected
 
@@ -201,28 +244,11 @@ private:
 	static constexpr float eo_max_std_dev = 100.0f;	///< Maximum permissible standard deviation for estimated orientation
 	//static constexpr float ev_max_std_dev = 100.0f;	///< Maximum permissible standard deviation for estimated velocity
 
-	// GPS blending and switching
-	gps_message _gps_state[GPS_MAX_RECEIVERS] {}; ///< internal state data for the physical GPS
-	gps_message _gps_blended_state{};		///< internal state data for the blended GPS
-	gps_message _gps_output[GPS_MAX_RECEIVERS + 1] {}; ///< output state data for the physical and blended GPS
-	Vector2f _NE_pos_offset_m[GPS_MAX_RECEIVERS] = {}; ///< Filtered North,East position offset from GPS instance to blended solution in _output_state.location (m)
-	float _hgt_offset_mm[GPS_MAX_RECEIVERS] = {};	///< Filtered height offset from GPS instance relative to blended solution in _output_state.location (mm)
-	Vector3f _blended_antenna_offset = {};		///< blended antenna offset
-	float _blend_weights[GPS_MAX_RECEIVERS] = {};	///< blend weight for each GPS. The blend weights must sum to 1.0 across all instances.
-	uint64_t _time_prev_us[GPS_MAX_RECEIVERS] = {};	///< the previous value of time_us for that GPS instance - used to detect new data.
-	uint8_t _gps_best_index = 0;			///< index of the physical receiver with the lowest reported error
-	uint8_t _gps_select_index = 0;			///< 0 = GPS1, 1 = GPS2, 2 = blended
-	uint8_t _gps_time_ref_index =
-		0;		///< index of the receiver that is used as the timing reference for the blending update
-	uint8_t _gps_oldest_index = 0;			///< index of the physical receiver with the oldest data
-	uint8_t _gps_newest_index = 0;			///< index of the physical receiver with the newest data
-	uint8_t _gps_slowest_index = 0;			///< index of the physical receiver with the slowest update rate
-	float _gps_dt[GPS_MAX_RECEIVERS] = {};		///< average time step in seconds.
-	bool  _gps_new_output_data = false;		///< true if there is new output data for the EKF
 	bool _had_valid_terrain = false;		///< true if at any time there was a valid terrain estimate
 
-	int32_t _gps_alttitude_ellipsoid[GPS_MAX_RECEIVERS] {};	///< altitude in 1E-3 meters (millimeters) above ellipsoid
-	uint64_t _gps_alttitude_ellipsoid_previous_timestamp[GPS_MAX_RECEIVERS] {}; ///< storage for previous timestamp to compute dt
+	uint64_t _gps_time_usec{0};				///< timestamp of the latest GPS data
+	int32_t _gps_alttitude_ellipsoid{0};			///< altitude in 1E-3 meters (millimeters) above ellipsoid
+	uint64_t _gps_alttitude_ellipsoid_previous_timestamp{0};	///< storage for previous timestamp to compute dt
 	float   _wgs84_hgt_offset = 0;  ///< height offset between AMSL and WGS84
 
 	bool _imu_bias_reset_request{false};
@@ -233,17 +259,18 @@ private:
 
 	uORB::Subscription _airdata_sub{ORB_ID(vehicle_air_data)};
 	uORB::Subscription _airspeed_sub{ORB_ID(airspeed)};
+	uORB::Subscription _estimator_selector_status_sub{ORB_ID(estimator_selector_status)};
 	uORB::Subscription _ev_odom_sub{ORB_ID(vehicle_visual_odometry)};
 	uORB::Subscription _landing_target_pose_sub{ORB_ID(landing_target_pose)};
 	uORB::Subscription _magnetometer_sub{ORB_ID(vehicle_magnetometer)};
 	uORB::Subscription _optical_flow_sub{ORB_ID(optical_flow)};
 	uORB::Subscription _parameter_update_sub{ORB_ID(parameter_update)};
 	uORB::Subscription _sensor_selection_sub{ORB_ID(sensor_selection)};
+	uORB::Subscription _vehicle_gps_blended_sub{ORB_ID(vehicle_gps_blended)};	///< blended or selected receiver, see gps_blending
 	uORB::Subscription _status_sub{ORB_ID(vehicle_status)};
 	uORB::Subscription _vehicle_land_detected_sub{ORB_ID(vehicle_land_detected)};
 
 	uORB::SubscriptionCallbackWorkItem _sensor_combined_sub{this, ORB_ID(sensor_combined)};
-	static constexpr int MAX_SENSOR_COUNT = 3;
 	uORB::SubscriptionCallbackWorkItem _vehicle_imu_subs[MAX_SENSOR_COUNT] {
 		{this, ORB_ID(vehicle_imu), 0},
 		{this, ORB_ID(vehicle_imu), 1},
@@ -256,28 +283,27 @@ private:
 	uORB::Subscription _range_finder_subs[ORB_MULTI_MAX_INSTANCES] {{ORB_ID(distance_sensor), 0}, {ORB_ID(distance_sensor), 1}, {ORB_ID(distance_sensor), 2}, {ORB_ID(distance_sensor), 3}};
 	int _range_finder_sub_index = -1; // index for downward-facing range finder subscription
 
-	// because we can have multiple GPS instances
-	uORB::Subscription _gps_subs[GPS_MAX_RECEIVERS] {{ORB_ID(vehicle_gps_position), 0}, {ORB_ID(vehicle_gps_position), 1}};
-
 	sensor_selection_s		_sensor_selection{};
 	vehicle_land_detected_s		_vehicle_land_detected{};
 	vehicle_status_s		_vehicle_status{};
 
-	uORB::Publication<ekf2_timestamps_s>			_ekf2_timestamps_pub{ORB_ID(ekf2_timestamps)};
-	uORB::Publication<ekf_gps_drift_s>			_ekf_gps_drift_pub{ORB_ID(ekf_gps_drift)};
-	uORB::Publication<ekf_gps_position_s>			_blended_gps_pub{ORB_ID(ekf_gps_position)};
-	uORB::Publication<estimator_innovations_s>		_estimator_innovation_test_ratios_pub{ORB_ID(estimator_innovation_test_ratios)};
-	uORB::Publication<estimator_innovations_s>		_estimator_innovation_variances_pub{ORB_ID(estimator_innovation_variances)};
-	uORB::Publication<estimator_innovations_s>		_estimator_innovations_pub{ORB_ID(estimator_innovations)};
-	uORB::Publication<estimator_sensor_bias_s>		_estimator_sensor_bias_pub{ORB_ID(estimator_sensor_bias)};
-	uORB::Publication<estimator_status_s>			_estimator_status_pub{ORB_ID(estimator_status)};
-	uORB::Publication<vehicle_attitude_s>			_att_pub{ORB_ID(vehicle_attitude)};
-	uORB::Publication<vehicle_odometry_s>			_vehicle_odometry_pub{ORB_ID(vehicle_odometry)};
-	uORB::PublicationData<vehicle_global_position_s>	_vehicle_global_position_pub{ORB_ID(vehicle_global_position)};
-	uORB::PublicationData<vehicle_local_position_s>		_vehicle_local_position_pub{ORB_ID(vehicle_local_position)};
-	uORB::PublicationData<vehicle_odometry_s>		_vehicle_visual_odometry_aligned_pub{ORB_ID(vehicle_visual_odometry_aligned)};
+	// all outputs are published as multi instance topics, the instance matches the instance of the bank
+	uORB::PublicationMulti<ekf2_timestamps_s>		_ekf2_timestamps_pub{ORB_ID(ekf2_timestamps)};
+	uORB::PublicationMulti<ekf_gps_drift_s>			_ekf_gps_drift_pub{ORB_ID(ekf_gps_drift)};
+	uORB::PublicationMulti<estimator_innovations_s>		_estimator_innovation_test_ratios_pub{ORB_ID(estimator_innovation_test_ratios)};
+	uORB::PublicationMulti<estimator_innovations_s>		_estimator_innovation_variances_pub{ORB_ID(estimator_innovation_variances)};
+	uORB::PublicationMulti<estimator_innovations_s>		_estimator_innovations_pub{ORB_ID(estimator_innovations)};
+	uORB::PublicationMulti<estimator_sensor_bias_s>		_estimator_sensor_bias_pub{ORB_ID(estimator_sensor_bias)};
+	uORB::PublicationMulti<estimator_status_s>		_estimator_status_pub{ORB_ID(estimator_status)};
+	uORB::PublicationMulti<vehicle_odometry_s>		_vehicle_odometry_pub{ORB_ID(vehicle_odometry)};
+	uORB::PublicationMultiData<vehicle_odometry_s>		_vehicle_visual_odometry_aligned_pub{ORB_ID(vehicle_visual_odometry_aligned)};
 	uORB::PublicationMulti<wind_estimate_s>			_wind_pub{ORB_ID(wind_estimate)};
 
+	// vehicle_* in single mode, estimator_* in multi mode (republished by the selector)
+	uORB::PublicationMulti<vehicle_attitude_s>		_att_pub;
+	uORB::PublicationMultiData<vehicle_global_position_s>	_vehicle_global_position_pub;
+	uORB::PublicationMultiData<vehicle_local_position_s>	_vehicle_local_position_pub;
+
 	Ekf _ekf;
 
 	parameters *_params;	///< pointer to ekf parameter struct (located in _ekf class instance)
@@ -428,6 +454,7 @@ private:
 		_param_ekf2_of_gate,	///< optical flow fusion innovation consistency gate size (STD)
 
 		(ParamInt<px4::params::EKF2_IMU_ID>) _param_ekf2_imu_id,
+		(ParamInt<px4::params::EKF2_CYC_BUDGET>) _param_ekf2_cyc_budget,	///< cycle budget in percent of the IMU interval
 
 		// sensor positions in body frame
 		(ParamExtFloat<px4::params::EKF2_IMU_POS_X>) _param_ekf2_imu_pos_x,		///< X position of IMU in body frame (m)
@@ -513,12 +540,6 @@ private:
 		(ParamExtFloat<px4::params::EKF2_PCOEF_Z>)
 		_param_ekf2_pcoef_z,	///< static pressure position error coefficient along the Z body axis
 
-		// GPS blending
-		(ParamInt<px4::params::EKF2_GPS_MASK>)
-		_param_ekf2_gps_mask,	///< mask defining when GPS accuracy metrics are used to calculate the blend ratio
-		(ParamFloat<px4::params::EKF2_GPS_TAU>)
-		_param_ekf2_gps_tau,		///< time constant controlling how rapidly the offset used to bring GPS solutions together is allowed to change (sec)
-
 		// Test used to determine if the vehicle is static or moving
 		(ParamExtFloat<px4::params::EKF2_MOVE_TEST>)
 		_param_ekf2_move_test,	///< scaling applied to IMU data thresholds used to determine if the vehicle is static or moving.
@@ -530,11 +551,19 @@ private:
 
 };
 
-Ekf2::Ekf2(bool replay_mode):
+Ekf2 *Ekf2::_bank[MAX_SENSOR_COUNT] {};
+EKF2Selector *Ekf2::_selector{nullptr};
+
+Ekf2::Ekf2(bool multi_mode, int instance, const px4::wq_config_t &config, bool replay_mode):
 	ModuleParams(nullptr),
-	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::att_pos_ctrl),
+	ScheduledWorkItem(MODULE_NAME, config),
 	_replay_mode(replay_mode),
+	_multi_mode(multi_mode),
+	_instance(instance),
 	_ekf_update_perf(perf_alloc(PC_ELAPSED, MODULE_NAME": update")),
+	_att_pub(multi_mode ? ORB_ID(estimator_attitude) : ORB_ID(vehicle_attitude)),
+	_vehicle_global_position_pub(multi_mode ? ORB_ID(estimator_global_position) : ORB_ID(vehicle_global_position)),
+	_vehicle_local_position_pub(multi_mode ? ORB_ID(estimator_local_position) : ORB_ID(vehicle_local_position)),
 	_params(_ekf.getParamHandle()),
 	_param_ekf2_min_obs_dt(_params->sensor_interval_min_ms),
 	_param_ekf2_mag_delay(_params->mag_delay_ms),
@@ -642,15 +671,87 @@ Ekf2::Ekf2(bool replay_mode):
 	updateParams();
 
 	_ekf.set_min_required_gps_health_time(_param_ekf2_req_gps_h.get() * 1_s);
+
+	_step_perf[estimator_status_s::STEP_MAG] = perf_alloc(PC_ELAPSED, MODULE_NAME": mag");
+	_step_perf[estimator_status_s::STEP_BARO] = perf_alloc(PC_ELAPSED, MODULE_NAME": baro");
+	_step_perf[estimator_status_s::STEP_GPS] = perf_alloc(PC_ELAPSED, MODULE_NAME": gps");
+	_step_perf[estimator_status_s::STEP_AIRSPEED] = perf_alloc(PC_ELAPSED, MODULE_NAME": airspeed");
+	_step_perf[estimator_status_s::STEP_FLOW] = perf_alloc(PC_ELAPSED, MODULE_NAME": flow");
+	_step_perf[estimator_status_s::STEP_RANGE] = perf_alloc(PC_ELAPSED, MODULE_NAME": range");
+	_step_perf[estimator_status_s::STEP_EV] = perf_alloc(PC_ELAPSED, MODULE_NAME": vision");
 }
 
 Ekf2::~Ekf2()
 {
 	perf_free(_ekf_update_perf);
+
+	for (auto &perf : _step_perf) {
+		perf_free(perf);
+	}
+}
+
+void Ekf2::step_begin(uint8_t step)
+{
+	perf_begin(_step_perf[step]);
+	_step_start = hrt_absolute_time();
+}
+
+void Ekf2::step_end(uint8_t step)
+{
+	perf_end(_step_perf[step]);
+
+	// low pass filter the step time to reduce noise in the published values
+	const float elapsed_us = hrt_elapsed_time(&_step_start);
+	_step_time_us[step] = 0.9f * _step_time_us[step] + 0.1f * elapsed_us;
 }
 
 bool Ekf2::init()
 {
+	if (_sweep_mode) {
+		const bool advertised = _att_pub.advertise() && _estimator_status_pub.advertise();
+
+		if (!advertised || (_att_pub.get_instance() != _instance)) {
+			PX4_ERR("%d: estimator output instance mismatch", _instance);
+			return false;
+		}
+
+		// all instances of a sweep run on the replayed sensor_combined
+		if (_sensor_combined_sub.registerCallback()) {
+			_callback_registered = true;
+			return true;
+		}
+
+		PX4_WARN("%d: failed to register callback, retrying in 1 second", _instance);
+		ScheduleDelayed(1_s); // retry in 1 second
+
+		return true;
+	}
+
+	if (_multi_mode) {
+		// claim the output instances up front, consumers (selector, logger) rely on instance == bank index
+		const bool advertised = _att_pub.advertise() && _vehicle_local_position_pub.advertise()
+					&& _vehicle_global_position_pub.advertise() && _estimator_status_pub.advertise()
+					&& _estimator_sensor_bias_pub.advertise();
+
+		if (!advertised || (_att_pub.get_instance() != _instance) || (_estimator_status_pub.get_instance() != _instance)) {
+			PX4_ERR("%d: estimator output instance mismatch", _instance);
+			return false;
+		}
+
+		// every instance of the bank runs on its own vehicle_imu instance
+		if (_vehicle_imu_subs[_instance].registerCallback()) {
+			PX4_INFO("%d: subscribed to vehicle_imu:%d", _instance, _instance);
+			_imu_sub_index = _instance;
+			_callback_registered = true;
+			return true;
+		}
+
+		PX4_WARN("%d: failed to register callback, retrying in 1 second", _instance);
+		ScheduleDelayed(1_s); // retry in 1 second
+
+		return true;
+	}
+
 	const uint32_t device_id = _param_ekf2_imu_id.get();
 
 	// if EKF2_IMU_ID is non-zero we use the corresponding IMU, otherwise the voted primary (sensor_combined)
@@ -687,6 +788,33 @@ bool Ekf2::init()
 
 int Ekf2::print_status()
 {
+	if (_sweep_mode) {
+		for (Ekf2 *inst : _bank) {
+			if (inst != nullptr) {
+				inst->print_sweep_statistics();
+			}
+		}
+
+		return 0;
+	}
+
+	if (_multi_mode) {
+		for (Ekf2 *inst : _bank) {
+			if (inst != nullptr && inst != this) {
+				PX4_INFO("instance %d: local position: %s, global position: %s, time slip: %" PRId64 " us", inst->_instance,
+					 inst->_ekf.local_position_is_valid() ? "valid" : "invalid",
+					 inst->_ekf.global_position_is_valid() ? "valid" : "invalid",
+					 inst->_last_time_slip_us);
+			}
+		}
+
+		if (_selector != nullptr) {
+			_selector->PrintStatus();
+		}
+
+		PX4_INFO("instance %d:", _instance);
+	}
+
 	PX4_INFO("local position: %s", (_ekf.local_position_is_valid()) ? "valid" : "invalid");
 	PX4_INFO("global position: %s", (_ekf.global_position_is_valid()) ? "valid" : "invalid");
 
@@ -694,6 +822,13 @@ int Ekf2::print_status()
 
 	perf_print_counter(_ekf_update_perf);
 
+	for (auto &perf : _step_perf) {
+		perf_print_counter(perf);
+	}
+
+	PX4_INFO("cycle time: %d us, budget: %d us, deferred cycles: %d", _cycle_time_us, _cycle_budget_us,
+		 _deferred_cycles);
+
 	return 0;
 }
 
@@ -731,6 +866,38 @@ bool Ekf2::update_mag_decl(Param &mag_decl_param)
 	return false;
 }
 
+bool Ekf2::stop_bank()
+{
+	bool stopped = true;
+
+	for (Ekf2 *&inst : _bank) {
+		if (inst != nullptr && inst != this) {
+			if (inst->_stopped.load()) {
+				delete inst;
+				inst = nullptr;
+
+			} else {
+				inst->request_stop();
+				inst->ScheduleNow();
+				stopped = false;
+			}
+		}
+	}
+
+	if (_selector != nullptr) {
+		if (_selector->Stopped()) {
+			delete _selector;
+			_selector = nullptr;
+
+		} else {
+			_selector->Stop();
+			stopped = false;
+		}
+	}
+
+	return stopped;
+}
+
 void Ekf2::Run()
 {
 	if (should_exit()) {
@@ -740,6 +907,24 @@ void Ekf2::Run()
 			i.unregisterCallback();
 		}
 
+		if (_sweep_mode) {
+			print_sweep_statistics();
+		}
+
+		if (_multi_mode && (_instance != 0)) {
+			// secondary instances are deleted by instance 0
+			ScheduleClear();
+			_stopped.store(true);
+			return;
+		}
+
+		if (_multi_mode && !stop_bank()) {
+			// wait for the other instances and the selector to finish
+			ScheduleDelayed(10_ms);
+			return;
+		}
+
+		_bank[0] = nullptr;
 		exit_and_cleanup();
 		return;
 	}
@@ -784,6 +969,15 @@ void Ekf2::Run()
 	}
 
 	if (updated) {
+		const hrt_abstime cycle_start = hrt_absolute_time();
+
+		if (_multi_mode) {
+			estimator_selector_status_s selector_status;
+
+			if (_estimator_selector_status_sub.update(&selector_status)) {
+				_primary = (selector_status.primary_instance == _instance);
+			}
+		}
 
 		// check for parameter updates
 		if (_parameter_update_sub.updated()) {
@@ -854,8 +1048,27 @@ void Ekf2::Run()
 		// publish attitude immediately (uses quaternion from output predictor)
 		publish_attitude(now);
 
+		// the budget is a fraction of the IMU interval, deferral is disabled in replay to keep it deterministic
+		if (!_replay_mode && (_param_ekf2_cyc_budget.get() > 0)) {
+			_cycle_budget_us = imu_dt * _param_ekf2_cyc_budget.get() / 100;
+
+		} else {
+			_cycle_budget_us = 0;
+		}
+
+		// after an overrun the low priority measurements are pushed one cycle later, but never twice in a row
+		const bool defer_low_priority = (_cycle_budget_us > 0) && (_cycle_time_us > _cycle_budget_us)
+						&& !_low_priority_deferred;
+		_low_priority_deferred = defer_low_priority;
+
+		if (defer_low_priority) {
+			_deferred_cycles++;
+		}
+
 		// read mag data
-		if (_magnetometer_sub.updated()) {
+		if (!defer_low_priority && _magnetometer_sub.updated()) {
+			step_begin(estimator_status_s::STEP_MAG);
+
 			vehicle_magnetometer_s magnetometer;
 
 			if (_magnetometer_sub.copy(&magnetometer)) {
@@ -876,7 +1089,8 @@ void Ekf2::Run()
 					}
 				}
 
-				if ((_vehicle_status.arming_state != vehicle_status_s::ARMING_STATE_ARMED) && (_invalid_mag_id_count > 100)) {
+				if (_primary && (_vehicle_status.arming_state != vehicle_status_s::ARMING_STATE_ARMED)
+				    && (_invalid_mag_id_count > 100)) {
 					// the sensor ID used for the last saved mag bias is not confirmed to be the same as the current sensor ID
 					// this means we need to reset the learned bias values to zero
 					_param_ekf2_magbias_x.set(0.f);
@@ -903,10 +1117,14 @@ void Ekf2::Run()
 				ekf2_timestamps.vehicle_magnetometer_timestamp_rel = (int16_t)((int64_t)magnetometer.timestamp / 100 -
 						(int64_t)ekf2_timestamps.timestamp / 100);
 			}
+
+			step_end(estimator_status_s::STEP_MAG);
 		}
 
 		// read baro data
 		if (_airdata_sub.updated()) {
+			step_begin(estimator_status_s::STEP_BARO);
+
 			vehicle_air_data_s airdata;
 
 			if (_airdata_sub.copy(&airdata)) {
@@ -916,108 +1134,33 @@ void Ekf2::Run()
 				ekf2_timestamps.vehicle_air_data_timestamp_rel = (int16_t)((int64_t)airdata.timestamp / 100 -
 						(int64_t)ekf2_timestamps.timestamp / 100);
 			}
-		}
-
-		// read gps1 data if available
-		bool gps1_updated = _gps_subs[0].updated();
 
-		if (gps1_updated) {
-			vehicle_gps_position_s gps;
-
-			if (_gps_subs[0].copy(&gps)) {
-				fillGpsMsgWithVehicleGpsPosData(_gps_state[0], gps);
-				_gps_alttitude_ellipsoid[0] = gps.alt_ellipsoid;
-
-				ekf2_timestamps.gps_timestamp_rel = (int16_t)((int64_t)gps.timestamp / 100 - (int64_t)ekf2_timestamps.timestamp / 100);
-			}
+			step_end(estimator_status_s::STEP_BARO);
 		}
 
-		// check for second GPS receiver data
-		bool gps2_updated = _gps_subs[1].updated();
+		// read GPS data, multiple receivers are blended by the gps_blending module
+		if (_vehicle_gps_blended_sub.updated()) {
+			step_begin(estimator_status_s::STEP_GPS);
 
-		if (gps2_updated) {
 			vehicle_gps_position_s gps;
 
-			if (_gps_subs[1].copy(&gps)) {
-				fillGpsMsgWithVehicleGpsPosData(_gps_state[1], gps);
-				_gps_alttitude_ellipsoid[1] = gps.alt_ellipsoid;
-			}
-		}
-
-		if ((_param_ekf2_gps_mask.get() == 0) && gps1_updated) {
-			// When GPS blending is disabled we always use the first receiver instance
-			_ekf.setGpsData(_gps_state[0]);
-
-		} else if ((_param_ekf2_gps_mask.get() > 0) && (gps1_updated || gps2_updated)) {
-			// blend dual receivers if available
-
-			// calculate blending weights
-			if (!blend_gps_data()) {
-				// handle case where the blended states cannot be updated
-				if (_gps_state[0].fix_type > _gps_state[1].fix_type) {
-					// GPS 1 has the best fix status so use that
-					_gps_select_index = 0;
-
-				} else if (_gps_state[1].fix_type > _gps_state[0].fix_type) {
-					// GPS 2 has the best fix status so use that
-					_gps_select_index = 1;
+			if (_vehicle_gps_blended_sub.copy(&gps)) {
+				gps_message gps_msg{};
+				fillGpsMsgWithVehicleGpsPosData(gps_msg, gps);
+				_ekf.setGpsData(gps_msg);
 
-				} else if (_gps_select_index == 2) {
-					// use last receiver we received data from
-					if (gps1_updated) {
-						_gps_select_index = 0;
+				_gps_time_usec = gps.timestamp;
+				_gps_alttitude_ellipsoid = gps.alt_ellipsoid;
 
-					} else if (gps2_updated) {
-						_gps_select_index = 1;
-					}
-				}
-
-				// Only use selected receiver data if it has been updated
-				_gps_new_output_data = (gps1_updated && _gps_select_index == 0) ||
-						       (gps2_updated && _gps_select_index == 1);
+				ekf2_timestamps.gps_timestamp_rel = (int16_t)((int64_t)gps.timestamp / 100 - (int64_t)ekf2_timestamps.timestamp / 100);
 			}
 
-			if (_gps_new_output_data) {
-				// correct the _gps_state data for steady state offsets and write to _gps_output
-				apply_gps_offsets();
-
-				// calculate a blended output from the offset corrected receiver data
-				if (_gps_select_index == 2) {
-					calc_gps_blend_output();
-				}
-
-				// write selected GPS to EKF
-				_ekf.setGpsData(_gps_output[_gps_select_index]);
-
-				// log blended solution as a third GPS instance
-				ekf_gps_position_s gps;
-				gps.timestamp = _gps_output[_gps_select_index].time_usec;
-				gps.lat = _gps_output[_gps_select_index].lat;
-				gps.lon = _gps_output[_gps_select_index].lon;
-				gps.alt = _gps_output[_gps_select_index].alt;
-				gps.fix_type = _gps_output[_gps_select_index].fix_type;
-				gps.eph = _gps_output[_gps_select_index].eph;
-				gps.epv = _gps_output[_gps_select_index].epv;
-				gps.s_variance_m_s = _gps_output[_gps_select_index].sacc;
-				gps.vel_m_s = _gps_output[_gps_select_index].vel_m_s;
-				gps.vel_n_m_s = _gps_output[_gps_select_index].vel_ned(0);
-				gps.vel_e_m_s = _gps_output[_gps_select_index].vel_ned(1);
-				gps.vel_d_m_s = _gps_output[_gps_select_index].vel_ned(2);
-				gps.vel_ned_valid = _gps_output[_gps_select_index].vel_ned_valid;
-				gps.satellites_used = _gps_output[_gps_select_index].nsats;
-				gps.heading = _gps_output[_gps_select_index].yaw;
-				gps.heading_offset = _gps_output[_gps_select_index].yaw_offset;
-				gps.selected = _gps_select_index;
-
-				// Publish to the EKF blended GPS topic
-				_blended_gps_pub.publish(gps);
-
-				// clear flag to avoid re-use of the same data
-				_gps_new_output_data = false;
-			}
+			step_end(estimator_status_s::STEP_GPS);
 		}
 
-		if (_airspeed_sub.updated()) {
+		if (!defer_low_priority && _airspeed_sub.updated()) {
+			step_begin(estimator_status_s::STEP_AIRSPEED);
+
 			airspeed_s airspeed;
 
 			if (_airspeed_sub.copy(&airspeed)) {
@@ -1034,9 +1177,13 @@ void Ekf2::Run()
 				ekf2_timestamps.airspeed_timestamp_rel = (int16_t)((int64_t)airspeed.timestamp / 100 -
 						(int64_t)ekf2_timestamps.timestamp / 100);
 			}
+
+			step_end(estimator_status_s::STEP_AIRSPEED);
 		}
 
 		if (_optical_flow_sub.updated()) {
+			step_begin(estimator_status_s::STEP_FLOW);
+
 			optical_flow_s optical_flow;
 
 			if (_optical_flow_sub.copy(&optical_flow)) {
@@ -1065,11 +1212,15 @@ void Ekf2::Run()
 				ekf2_timestamps.optical_flow_timestamp_rel = (int16_t)((int64_t)optical_flow.timestamp / 100 -
 						(int64_t)ekf2_timestamps.timestamp / 100);
 			}
+
+			step_end(estimator_status_s::STEP_FLOW);
 		}
 
 		if (_range_finder_sub_index >= 0) {
 
 			if (_range_finder_subs[_range_finder_sub_index].updated()) {
+				step_begin(estimator_status_s::STEP_RANGE);
+
 				distance_sensor_s range_finder;
 
 				if (_range_finder_subs[_range_finder_sub_index].copy(&range_finder)) {
@@ -1085,6 +1236,8 @@ void Ekf2::Run()
 					ekf2_timestamps.distance_sensor_timestamp_rel = (int16_t)((int64_t)range_finder.timestamp / 100 -
 							(int64_t)ekf2_timestamps.timestamp / 100);
 				}
+
+				step_end(estimator_status_s::STEP_RANGE);
 			}
 
 		} else {
@@ -1096,6 +1249,8 @@ void Ekf2::Run()
 		new_ev_data_received = false;
 
 		if (_ev_odom_sub.updated()) {
+			step_begin(estimator_status_s::STEP_EV);
+
 			new_ev_data_received = true;
 
 			// copy both attitude & position, we need both to fill a single extVisionSample
@@ -1166,6 +1321,8 @@ void Ekf2::Run()
 
 			ekf2_timestamps.visual_odometry_timestamp_rel = (int16_t)((int64_t)_ev_odom.timestamp / 100 -
 					(int64_t)ekf2_timestamps.timestamp / 100);
+
+			step_end(estimator_status_s::STEP_EV);
 		}
 
 		bool vehicle_land_detected_updated = _vehicle_land_detected_sub.updated();
@@ -1195,7 +1352,9 @@ void Ekf2::Run()
 
 		// run the EKF update and output
 		perf_begin(_ekf_update_perf);
+		const hrt_abstime update_start = hrt_absolute_time();
 		const bool ekf_updated = _ekf.update();
+		_update_time_us = hrt_elapsed_time(&update_start);
 		perf_end(_ekf_update_perf);
 
 		// integrate time to monitor time slippage
@@ -1396,6 +1555,10 @@ void Ekf2::Run()
 				// publish vehicle local position data
 				_vehicle_local_position_pub.update();
 
+				if (!_multi_mode) {
+					state_history::local_position().push(lpos);
+				}
+
 				// publish vehicle odometry data
 				_vehicle_odometry_pub.publish(odom);
 
@@ -1467,6 +1630,10 @@ void Ekf2::Run()
 					global_pos.dead_reckoning = _ekf.inertial_dead_reckoning(); // True if this position is estimated through dead-reckoning
 
 					_vehicle_global_position_pub.update();
+
+					if (!_multi_mode) {
+						state_history::global_position().push(global_pos);
+					}
 				}
 			}
 
@@ -1523,9 +1690,24 @@ void Ekf2::Run()
 			status.pre_flt_fail_innov_vel_vert = _preflt_checker.hasVertVelFailed();
 			status.pre_flt_fail_innov_height = _preflt_checker.hasHeightFailed();
 			status.pre_flt_fail_mag_field_disturbed = control_status.flags.mag_field_disturbed;
+			status.cycle_time_us = _cycle_time_us;
+			status.update_time_us = _update_time_us;
+			status.cycle_budget_us = _cycle_budget_us;
+			status.deferred_cycles = _deferred_cycles;
+			memcpy(status.step_time_us, _step_time_us, sizeof(status.step_time_us));
 
 			_estimator_status_pub.publish(status);
 
+			if (_sweep_mode) {
+				_test_ratio_stats[TEST_RATIO_VEL].update(status.vel_test_ratio);
+				_test_ratio_stats[TEST_RATIO_POS].update(status.pos_test_ratio);
+				_test_ratio_stats[TEST_RATIO_HGT].update(status.hgt_test_ratio);
+				_test_ratio_stats[TEST_RATIO_MAG].update(status.mag_test_ratio);
+				_test_ratio_stats[TEST_RATIO_TAS].update(status.tas_test_ratio);
+				_test_ratio_stats[TEST_RATIO_HAGL].update(status.hagl_test_ratio);
+				_test_ratio_stats[TEST_RATIO_BETA].update(status.beta_test_ratio);
+			}
+
 			// publish GPS drift data only when updated to minimise overhead
 			float gps_drift[3];
 			bool blocked;
@@ -1596,7 +1778,7 @@ void Ekf2::Run()
 				}
 
 				// Check and save the last valid calibration when we are disarmed
-				if ((_vehicle_status.arming_state == vehicle_status_s::ARMING_STATE_STANDBY)
+				if (_primary && (_vehicle_status.arming_state == vehicle_status_s::ARMING_STATE_STANDBY)
 				    && (status.filter_fault_flags == 0)
 				    && (_sensor_selection.mag_device_id == (uint32_t)_param_ekf2_magbias_id.get())) {
 
@@ -1612,7 +1794,7 @@ void Ekf2::Run()
 
 			publish_wind_estimate(now);
 
-			if (!_mag_decl_saved && (_vehicle_status.arming_state == vehicle_status_s::ARMING_STATE_STANDBY)) {
+			if (_primary && !_mag_decl_saved && (_vehicle_status.arming_state == vehicle_status_s::ARMING_STATE_STANDBY)) {
 				_mag_decl_saved = update_mag_decl(_param_ekf2_mag_decl);
 			}
 
@@ -1701,6 +1883,8 @@ void Ekf2::Run()
 
 		// publish ekf2_timestamps
 		_ekf2_timestamps_pub.publish(ekf2_timestamps);
+
+		_cycle_time_us = hrt_elapsed_time(&cycle_start);
 	}
 }
 
@@ -1777,6 +1961,11 @@ bool Ekf2::publish_attitude(const hrt_abstime &now)
 
 		_att_pub.publish(att);
 
+		// in multi mode the selector provides the history of the primary instance
+		if (!_multi_mode) {
+			state_history::attitude().push(att);
+		}
+
 		return true;
 
 	}  else if (_replay_mode) {
@@ -1817,600 +2006,291 @@ bool Ekf2::publish_wind_estimate(const hrt_abstime &timestamp)
 	return false;
 }
 
-bool Ekf2::blend_gps_data()
+float Ekf2::filter_altitude_ellipsoid(float amsl_hgt)
 {
-	// zero the blend weights
-	memset(&_blend_weights, 0, sizeof(_blend_weights));
-
-	/*
-	 * If both receivers have the same update rate, use the oldest non-zero time.
-	 * If two receivers with different update rates are used, use the slowest.
-	 * If time difference is excessive, use newest to prevent a disconnected receiver
-	 * from blocking updates.
-	 */
-
-	// Calculate the time step for each receiver with some filtering to reduce the effects of jitter
-	// Find the largest and smallest time step.
-	float dt_max = 0.0f;
-	float dt_min = 0.3f;
 
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		float raw_dt = 0.001f * (float)(_gps_state[i].time_usec - _time_prev_us[i]);
+	float height_diff = static_cast<float>(_gps_alttitude_ellipsoid) * 1e-3f - amsl_hgt;
 
-		if (raw_dt > 0.0f && raw_dt < 0.3f) {
-			_gps_dt[i] = 0.1f * raw_dt + 0.9f * _gps_dt[i];
-		}
-
-		if (_gps_dt[i] > dt_max) {
-			dt_max = _gps_dt[i];
-			_gps_slowest_index = i;
-		}
+	if (_gps_alttitude_ellipsoid_previous_timestamp == 0) {
 
-		if (_gps_dt[i] < dt_min) {
-			dt_min = _gps_dt[i];
-		}
-	}
-
-	// Find the receiver that is last be updated
-	uint64_t max_us = 0; // newest non-zero system time of arrival of a GPS message
-	uint64_t min_us = -1; // oldest non-zero system time of arrival of a GPS message
-
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		// Find largest and smallest times
-		if (_gps_state[i].time_usec > max_us) {
-			max_us = _gps_state[i].time_usec;
-			_gps_newest_index = i;
-		}
+		_wgs84_hgt_offset = height_diff;
+		_gps_alttitude_ellipsoid_previous_timestamp = _gps_time_usec;
 
-		if ((_gps_state[i].time_usec < min_us) && (_gps_state[i].time_usec > 0)) {
-			min_us = _gps_state[i].time_usec;
-			_gps_oldest_index = i;
-		}
-	}
+	} else if (_gps_time_usec != _gps_alttitude_ellipsoid_previous_timestamp) {
 
-	if ((max_us - min_us) > 300000) {
-		// A receiver has timed out so fall out of blending
-		return false;
+		// apply a 10 second first order low pass filter to baro offset
+		float dt = 1e-6f * static_cast<float>(_gps_time_usec - _gps_alttitude_ellipsoid_previous_timestamp);
+		_gps_alttitude_ellipsoid_previous_timestamp = _gps_time_usec;
+		float offset_rate_correction = 0.1f * (height_diff - _wgs84_hgt_offset);
+		_wgs84_hgt_offset += dt * math::constrain(offset_rate_correction, -0.1f, 0.1f);
 	}
 
-	/*
-	 * If the largest dt is less than 20% greater than the smallest, then we have  receivers
-	 * running at the same rate then we wait until we have two messages with an arrival time
-	 * difference that is less than 50% of the smallest time step and use the time stamp from
-	 * the newest data.
-	 * Else we have two receivers at different update rates and use the slowest receiver
-	 * as the timing reference.
-	 */
-
-	if ((dt_max - dt_min) < 0.2f * dt_min) {
-		// both receivers assumed to be running at the same rate
-		if ((max_us - min_us) < (uint64_t)(5e5f * dt_min)) {
-			// data arrival within a short time window enables the two measurements to be blended
-			_gps_time_ref_index = _gps_newest_index;
-			_gps_new_output_data = true;
-		}
+	return amsl_hgt + _wgs84_hgt_offset;
+}
 
-	} else {
-		// both receivers running at different rates
-		_gps_time_ref_index = _gps_slowest_index;
+void Ekf2::updateParams()
+{
+	ModuleParams::updateParams();
 
-		if (_gps_state[_gps_time_ref_index].time_usec > _time_prev_us[_gps_time_ref_index]) {
-			// blend data at the rate of the slower receiver
-			_gps_new_output_data = true;
-		}
+	// overrides of a parameter sweep take precedence over the parameter storage
+	for (int i = 0; i < _param_override_count; i++) {
+		applyParamOverride(_param_overrides[i]);
 	}
+}
 
-	if (_gps_new_output_data) {
-		_gps_blended_state.time_usec = _gps_state[_gps_time_ref_index].time_usec;
-
-		// calculate the sum squared speed accuracy across all GPS sensors
-		float speed_accuracy_sum_sq = 0.0f;
-
-		if (_param_ekf2_gps_mask.get() & BLEND_MASK_USE_SPD_ACC) {
-			for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-				if (_gps_state[i].fix_type >= 3 && _gps_state[i].sacc > 0.0f) {
-					speed_accuracy_sum_sq += _gps_state[i].sacc * _gps_state[i].sacc;
-
-				} else {
-					// not all receivers support this metric so set it to zero and don't use it
-					speed_accuracy_sum_sq = 0.0f;
-					break;
-				}
-			}
-		}
-
-		// calculate the sum squared horizontal position accuracy across all GPS sensors
-		float horizontal_accuracy_sum_sq = 0.0f;
-
-		if (_param_ekf2_gps_mask.get() & BLEND_MASK_USE_HPOS_ACC) {
-			for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-				if (_gps_state[i].fix_type >= 2 && _gps_state[i].eph > 0.0f) {
-					horizontal_accuracy_sum_sq += _gps_state[i].eph * _gps_state[i].eph;
-
-				} else {
-					// not all receivers support this metric so set it to zero and don't use it
-					horizontal_accuracy_sum_sq = 0.0f;
-					break;
-				}
-			}
-		}
-
-		// calculate the sum squared vertical position accuracy across all GPS sensors
-		float vertical_accuracy_sum_sq = 0.0f;
-
-		if (_param_ekf2_gps_mask.get() & BLEND_MASK_USE_VPOS_ACC) {
-			for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-				if (_gps_state[i].fix_type >= 3 && _gps_state[i].epv > 0.0f) {
-					vertical_accuracy_sum_sq += _gps_state[i].epv * _gps_state[i].epv;
-
-				} else {
-					// not all receivers support this metric so set it to zero and don't use it
-					vertical_accuracy_sum_sq = 0.0f;
-					break;
-				}
-			}
-		}
-
-		// Check if we can do blending using reported accuracy
-		bool can_do_blending = (horizontal_accuracy_sum_sq > 0.0f || vertical_accuracy_sum_sq > 0.0f
-					|| speed_accuracy_sum_sq > 0.0f);
-
-		// if we can't do blending using reported accuracy, return false and hard switch logic will be used instead
-		if (!can_do_blending) {
-			return false;
-		}
-
-		float sum_of_all_weights = 0.0f;
-
-		// calculate a weighting using the reported speed accuracy
-		float spd_blend_weights[GPS_MAX_RECEIVERS] = {};
-
-		if (speed_accuracy_sum_sq > 0.0f && (_param_ekf2_gps_mask.get() & BLEND_MASK_USE_SPD_ACC)) {
-			// calculate the weights using the inverse of the variances
-			float sum_of_spd_weights = 0.0f;
-
-			for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-				if (_gps_state[i].fix_type >= 3 && _gps_state[i].sacc >= 0.001f) {
-					spd_blend_weights[i] = 1.0f / (_gps_state[i].sacc * _gps_state[i].sacc);
-					sum_of_spd_weights += spd_blend_weights[i];
-				}
-			}
-
-			// normalise the weights
-			if (sum_of_spd_weights > 0.0f) {
-				for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-					spd_blend_weights[i] = spd_blend_weights[i] / sum_of_spd_weights;
-				}
-
-				sum_of_all_weights += 1.0f;
-			}
-		}
-
-		// calculate a weighting using the reported horizontal position
-		float hpos_blend_weights[GPS_MAX_RECEIVERS] = {};
-
-		if (horizontal_accuracy_sum_sq > 0.0f && (_param_ekf2_gps_mask.get() & BLEND_MASK_USE_HPOS_ACC)) {
-			// calculate the weights using the inverse of the variances
-			float sum_of_hpos_weights = 0.0f;
-
-			for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-				if (_gps_state[i].fix_type >= 2 && _gps_state[i].eph >= 0.001f) {
-					hpos_blend_weights[i] = horizontal_accuracy_sum_sq / (_gps_state[i].eph * _gps_state[i].eph);
-					sum_of_hpos_weights += hpos_blend_weights[i];
-				}
-			}
-
-			// normalise the weights
-			if (sum_of_hpos_weights > 0.0f) {
-				for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-					hpos_blend_weights[i] = hpos_blend_weights[i] / sum_of_hpos_weights;
-				}
-
-				sum_of_all_weights += 1.0f;
-			}
+bool Ekf2::applyParamOverride(const ParamOverride &param_override)
+{
+	auto apply = [&param_override](auto & param) {
+		if (param.handle() == param_override.handle) {
+			param.set(param_override.value);
+			return true;
 		}
 
-		// calculate a weighting using the reported vertical position accuracy
-		float vpos_blend_weights[GPS_MAX_RECEIVERS] = {};
+		return false;
+	};
 
-		if (vertical_accuracy_sum_sq > 0.0f && (_param_ekf2_gps_mask.get() & BLEND_MASK_USE_VPOS_ACC)) {
-			// calculate the weights using the inverse of the variances
-			float sum_of_vpos_weights = 0.0f;
+	// only the noise and gate parameters can be swept, the others change the buffer layout or the fusion modes
+	return apply(_param_ekf2_gyr_noise) || apply(_param_ekf2_acc_noise)
+	       || apply(_param_ekf2_gyr_b_noise) || apply(_param_ekf2_acc_b_noise)
+	       || apply(_param_ekf2_mag_e_noise) || apply(_param_ekf2_mag_b_noise)
+	       || apply(_param_ekf2_wind_noise) || apply(_param_ekf2_terr_noise)
+	       || apply(_param_ekf2_gps_v_noise) || apply(_param_ekf2_gps_p_noise)
+	       || apply(_param_ekf2_noaid_noise) || apply(_param_ekf2_baro_noise)
+	       || apply(_param_ekf2_head_noise) || apply(_param_ekf2_mag_noise)
+	       || apply(_param_ekf2_eas_noise) || apply(_param_ekf2_beta_noise)
+	       || apply(_param_ekf2_rng_noise) || apply(_param_ekf2_drag_noise)
+	       || apply(_param_ekf2_evp_noise) || apply(_param_ekf2_evv_noise)
+	       || apply(_param_ekf2_eva_noise)
+	       || apply(_param_ekf2_baro_gate) || apply(_param_ekf2_gps_p_gate)
+	       || apply(_param_ekf2_gps_v_gate) || apply(_param_ekf2_tas_gate)
+	       || apply(_param_ekf2_beta_gate) || apply(_param_ekf2_hdg_gate)
+	       || apply(_param_ekf2_mag_gate) || apply(_param_ekf2_rng_gate)
+	       || apply(_param_ekf2_evv_gate) || apply(_param_ekf2_evp_gate)
+	       || apply(_param_ekf2_of_gate);
+}
 
-			for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-				if (_gps_state[i].fix_type >= 3 && _gps_state[i].epv >= 0.001f) {
-					vpos_blend_weights[i] = vertical_accuracy_sum_sq / (_gps_state[i].epv * _gps_state[i].epv);
-					sum_of_vpos_weights += vpos_blend_weights[i];
-				}
-			}
+void Ekf2::print_sweep_statistics()
+{
+	static constexpr const char *names[TEST_RATIO_COUNT] {"vel", "pos", "hgt", "mag", "tas", "hagl", "beta"};
 
-			// normalise the weights
-			if (sum_of_vpos_weights > 0.0f) {
-				for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-					vpos_blend_weights[i] = vpos_blend_weights[i] / sum_of_vpos_weights;
-				}
+	PX4_INFO("set %d: test ratio mean, rms, max (samples)", _instance);
 
-				sum_of_all_weights += 1.0f;
-			};
-		}
+	for (int i = 0; i < TEST_RATIO_COUNT; i++) {
+		const TestRatioStatistics &stats = _test_ratio_stats[i];
 
-		// calculate an overall weight
-		for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-			_blend_weights[i] = (hpos_blend_weights[i] + vpos_blend_weights[i] + spd_blend_weights[i]) / sum_of_all_weights;
+		if (stats.count > 0) {
+			PX4_INFO("set %d: %s: %.3f, %.3f, %.3f (%d)", _instance, names[i], (double)(stats.sum / stats.count),
+				 (double)sqrtf(stats.sum_sq / stats.count), (double)stats.max, stats.count);
 		}
-
-		// With updated weights we can calculate a blended GPS solution and
-		// offsets for each physical receiver
-		update_gps_blend_states();
-		update_gps_offsets();
-		_gps_select_index = 2;
-
 	}
-
-	return true;
 }
 
-/*
- * Update the internal state estimate for a blended GPS solution that is a weighted average of the phsyical receiver solutions
- * with weights are calculated in calc_gps_blend_weights(). This internal state cannot be used directly by estimators
- * because if physical receivers have significant position differences,  variation in receiver estimated accuracy will
- * cause undesirable variation in the position solution.
-*/
-void Ekf2::update_gps_blend_states()
+int Ekf2::custom_command(int argc, char *argv[])
 {
-	// initialise the blended states so we can accumulate the results using the weightings for each GPS receiver.
-	_gps_blended_state.time_usec = 0;
-	_gps_blended_state.lat = 0;
-	_gps_blended_state.lon = 0;
-	_gps_blended_state.alt = 0;
-	_gps_blended_state.fix_type = 0;
-	_gps_blended_state.eph = FLT_MAX;
-	_gps_blended_state.epv = FLT_MAX;
-	_gps_blended_state.sacc = FLT_MAX;
-	_gps_blended_state.vel_m_s = 0.0f;
-	_gps_blended_state.vel_ned.setZero();
-	_gps_blended_state.vel_ned_valid = true;
-	_gps_blended_state.nsats = 0;
-	_gps_blended_state.pdop = FLT_MAX;
-
-	_blended_antenna_offset.zero();
-
-	// combine the the GPS states into a blended solution using the weights calculated in calc_blend_weights()
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		// blend the timing data
-		_gps_blended_state.time_usec += (uint64_t)((double)_gps_state[i].time_usec * (double)_blend_weights[i]);
-
-		// use the highest status
-		if (_gps_state[i].fix_type > _gps_blended_state.fix_type) {
-			_gps_blended_state.fix_type = _gps_state[i].fix_type;
-		}
-
-		// calculate a blended average speed and velocity vector
-		_gps_blended_state.vel_m_s += _gps_state[i].vel_m_s * _blend_weights[i];
-		_gps_blended_state.vel_ned += _gps_state[i].vel_ned * _blend_weights[i];
-
-		// Assume blended error magnitude, DOP and sat count is equal to the best value from contributing receivers
-		// If any receiver contributing has an invalid velocity, then report blended velocity as invalid
-		if (_blend_weights[i] > 0.0f) {
-
-			if (_gps_state[i].eph > 0.0f
-			    && _gps_state[i].eph < _gps_blended_state.eph) {
-				_gps_blended_state.eph = _gps_state[i].eph;
-			}
-
-			if (_gps_state[i].epv > 0.0f
-			    && _gps_state[i].epv < _gps_blended_state.epv) {
-				_gps_blended_state.epv = _gps_state[i].epv;
-			}
-
-			if (_gps_state[i].sacc > 0.0f
-			    && _gps_state[i].sacc < _gps_blended_state.sacc) {
-				_gps_blended_state.sacc = _gps_state[i].sacc;
-			}
-
-			if (_gps_state[i].pdop > 0
-			    && _gps_state[i].pdop < _gps_blended_state.pdop) {
-				_gps_blended_state.pdop = _gps_state[i].pdop;
-			}
+	return print_usage("unknown command");
+}
 
-			if (_gps_state[i].nsats > 0
-			    && _gps_state[i].nsats > _gps_blended_state.nsats) {
-				_gps_blended_state.nsats = _gps_state[i].nsats;
-			}
+int Ekf2::task_spawn(int argc, char *argv[])
+{
+	bool replay_mode = false;
 
-			if (!_gps_state[i].vel_ned_valid) {
-				_gps_blended_state.vel_ned_valid = false;
-			}
+	if (argc > 1 && !strcmp(argv[1], "-r")) {
+		PX4_INFO("replay mode enabled");
+		replay_mode = true;
 
+		if (argc > 3 && !strcmp(argv[2], "-s")) {
+			return start_sweep(argv[3]);
 		}
+	}
 
-		// TODO read parameters for individual GPS antenna positions and blend
-		// Vector3f temp_antenna_offset = _antenna_offset[i];
-		// temp_antenna_offset *= _blend_weights[i];
-		// _blended_antenna_offset += temp_antenna_offset;
+	int32_t multi_imu = 0;
 
+	if (!replay_mode) {
+		param_get(param_find("EKF2_MULTI_IMU"), &multi_imu);
 	}
 
-	/*
-	 * Calculate the instantaneous weighted average location using  available GPS instances and store in  _gps_state.
-	 * This is statistically the most likely location, but may not be stable enough for direct use by the EKF.
-	*/
-
-	// Use the GPS with the highest weighting as the reference position
-	float best_weight = 0.0f;
-
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		if (_blend_weights[i] > best_weight) {
-			best_weight = _blend_weights[i];
-			_gps_best_index = i;
-			_gps_blended_state.lat = _gps_state[i].lat;
-			_gps_blended_state.lon = _gps_state[i].lon;
-			_gps_blended_state.alt = _gps_state[i].alt;
-		}
+	if (multi_imu > 1) {
+		return start_bank(math::min(static_cast<int>(multi_imu), MAX_SENSOR_COUNT));
 	}
 
-	// Convert each GPS position to a local NEU offset relative to the reference position
-	Vector2f blended_NE_offset_m;
-	blended_NE_offset_m.zero();
-	float blended_alt_offset_mm = 0.0f;
-
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		if ((_blend_weights[i] > 0.0f) && (i != _gps_best_index)) {
-			// calculate the horizontal offset
-			Vector2f horiz_offset{};
-			get_vector_to_next_waypoint((_gps_blended_state.lat / 1.0e7),
-						    (_gps_blended_state.lon / 1.0e7), (_gps_state[i].lat / 1.0e7), (_gps_state[i].lon / 1.0e7),
-						    &horiz_offset(0), &horiz_offset(1));
+	Ekf2 *instance = new Ekf2(false, 0, px4::wq_configurations::att_pos_ctrl, replay_mode);
 
-			// sum weighted offsets
-			blended_NE_offset_m += horiz_offset * _blend_weights[i];
-
-			// calculate vertical offset
-			float vert_offset = (float)(_gps_state[i].alt - _gps_blended_state.alt);
+	if (instance) {
+		_object.store(instance);
+		_task_id = task_id_is_work_queue;
 
-			// sum weighted offsets
-			blended_alt_offset_mm += vert_offset * _blend_weights[i];
+		if (instance->init()) {
+			return PX4_OK;
 		}
-	}
 
-	// Add the sum of weighted offsets to the reference position to obtain the blended position
-	double lat_deg_now = (double)_gps_blended_state.lat * 1.0e-7;
-	double lon_deg_now = (double)_gps_blended_state.lon * 1.0e-7;
-	double lat_deg_res, lon_deg_res;
-	add_vector_to_global_position(lat_deg_now, lon_deg_now, blended_NE_offset_m(0), blended_NE_offset_m(1), &lat_deg_res,
-				      &lon_deg_res);
-	_gps_blended_state.lat = (int32_t)(1.0E7 * lat_deg_res);
-	_gps_blended_state.lon = (int32_t)(1.0E7 * lon_deg_res);
-	_gps_blended_state.alt += (int32_t)blended_alt_offset_mm;
-
-	// Take GPS heading from the highest weighted receiver that is publishing a valid .heading value
-	uint8_t gps_best_yaw_index = 0;
-	best_weight = 0.0f;
-
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		if (PX4_ISFINITE(_gps_state[i].yaw) && (_blend_weights[i] > best_weight)) {
-			best_weight = _blend_weights[i];
-			gps_best_yaw_index = i;
-		}
+	} else {
+		PX4_ERR("alloc failed");
 	}
 
-	_gps_blended_state.yaw = _gps_state[gps_best_yaw_index].yaw;
-	_gps_blended_state.yaw_offset = _gps_state[gps_best_yaw_index].yaw_offset;
+	delete instance;
+	_object.store(nullptr);
+	_task_id = -1;
+
+	return PX4_ERROR;
 }
 
-/*
- * The location in _gps_blended_state will move around as the relative accuracy changes.
- * To mitigate this effect a low-pass filtered offset from each GPS location to the blended location is
- * calculated.
-*/
-void Ekf2::update_gps_offsets()
+int Ekf2::start_bank(int count)
 {
+	// one work queue per instance so that the instances can run in parallel
+	const px4::wq_config_t *wq_configs[MAX_SENSOR_COUNT] {
+		&px4::wq_configurations::INS0,
+		&px4::wq_configurations::INS1,
+		&px4::wq_configurations::INS2,
+	};
 
-	// Calculate filter coefficients to be applied to the offsets for each GPS position and height offset
-	// Increase the filter time constant proportional to the inverse of the weighting
-	// A weighting of 1 will make the offset adjust the slowest, a weighting of 0 will make it adjust with zero filtering
-	float alpha[GPS_MAX_RECEIVERS] = {};
-	float omega_lpf = 1.0f / fmaxf(_param_ekf2_gps_tau.get(), 1.0f);
+	PX4_INFO("starting %d instances", count);
 
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		if (_gps_state[i].time_usec - _time_prev_us[i] > 0) {
-			// calculate the filter coefficient that achieves the time constant specified by the user adjustable parameter
-			float min_alpha = constrain(omega_lpf * 1e-6f * (float)(_gps_state[i].time_usec - _time_prev_us[i]),
-						    0.0f, 1.0f);
+	bool success = true;
 
-			// scale the filter coefficient so that time constant is inversely proprtional to weighting
-			if (_blend_weights[i] > min_alpha) {
-				alpha[i] = min_alpha / _blend_weights[i];
+	for (int i = 0; i < count; i++) {
+		_bank[i] = new Ekf2(true, i, *wq_configs[i]);
 
-			} else {
-				alpha[i] = 1.0f;
-			}
+		if (_bank[i] == nullptr) {
+			PX4_ERR("alloc failed");
+			success = false;
+			break;
+		}
 
-			_time_prev_us[i] = _gps_state[i].time_usec;
+		if (i == 0) {
+			_object.store(_bank[0]);
+			_task_id = task_id_is_work_queue;
 		}
-	}
 
-	// Calculate a filtered position delta for each GPS relative to the blended solution state
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		Vector2f offset;
-		get_vector_to_next_waypoint((_gps_state[i].lat / 1.0e7), (_gps_state[i].lon / 1.0e7),
-					    (_gps_blended_state.lat / 1.0e7), (_gps_blended_state.lon / 1.0e7), &offset(0), &offset(1));
-		_NE_pos_offset_m[i] = offset * alpha[i] + _NE_pos_offset_m[i] * (1.0f - alpha[i]);
-		_hgt_offset_mm[i] = (float)(_gps_blended_state.alt - _gps_state[i].alt) *  alpha[i] +
-				    _hgt_offset_mm[i] * (1.0f - alpha[i]);
+		if (!_bank[i]->init()) {
+			success = false;
+			break;
+		}
 	}
 
-	// calculate offset limits from the largest difference between receivers
-	Vector2f max_ne_offset{};
-	float max_alt_offset = 0;
-
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		for (uint8_t j = i; j < GPS_MAX_RECEIVERS; j++) {
-			if (i != j) {
-				Vector2f offset;
-				get_vector_to_next_waypoint((_gps_state[i].lat / 1.0e7), (_gps_state[i].lon / 1.0e7),
-							    (_gps_state[j].lat / 1.0e7), (_gps_state[j].lon / 1.0e7), &offset(0), &offset(1));
-				max_ne_offset(0) = fmaxf(max_ne_offset(0), fabsf(offset(0)));
-				max_ne_offset(1) = fmaxf(max_ne_offset(1), fabsf(offset(1)));
-				max_alt_offset = fmaxf(max_alt_offset, fabsf((float)(_gps_state[i].alt - _gps_state[j].alt)));
-			}
+	if (success) {
+		_selector = new EKF2Selector();
+
+		if ((_selector == nullptr) || !_selector->Start()) {
+			PX4_ERR("selector start failed");
+			success = false;
 		}
 	}
 
-	// apply offset limits
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		_NE_pos_offset_m[i](0) = constrain(_NE_pos_offset_m[i](0), -max_ne_offset(0), max_ne_offset(0));
-		_NE_pos_offset_m[i](1) = constrain(_NE_pos_offset_m[i](1), -max_ne_offset(1), max_ne_offset(1));
-		_hgt_offset_mm[i] = constrain(_hgt_offset_mm[i], -max_alt_offset, max_alt_offset);
+	if (success) {
+		return PX4_OK;
 	}
 
-}
+	// callbacks are removed in the destructors
+	for (Ekf2 *&inst : _bank) {
+		delete inst;
+		inst = nullptr;
+	}
 
+	delete _selector;
+	_selector = nullptr;
 
-/*
- * Apply the steady state physical receiver offsets calculated by update_gps_offsets().
-*/
-void Ekf2::apply_gps_offsets()
-{
-	// calculate offset corrected output for each physical GPS.
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		// Add the sum of weighted offsets to the reference position to obtain the blended position
-		double lat_deg_now = (double)_gps_state[i].lat * 1.0e-7;
-		double lon_deg_now = (double)_gps_state[i].lon * 1.0e-7;
-		double lat_deg_res, lon_deg_res;
-		add_vector_to_global_position(lat_deg_now, lon_deg_now, _NE_pos_offset_m[i](0), _NE_pos_offset_m[i](1), &lat_deg_res,
-					      &lon_deg_res);
-		_gps_output[i].lat = (int32_t)(1.0E7 * lat_deg_res);
-		_gps_output[i].lon = (int32_t)(1.0E7 * lon_deg_res);
-		_gps_output[i].alt = _gps_state[i].alt + (int32_t)_hgt_offset_mm[i];
-
-		// other receiver data is used uncorrected
-		_gps_output[i].time_usec	= _gps_state[i].time_usec;
-		_gps_output[i].fix_type		= _gps_state[i].fix_type;
-		_gps_output[i].vel_m_s		= _gps_state[i].vel_m_s;
-		_gps_output[i].vel_ned		= _gps_state[i].vel_ned;
-		_gps_output[i].eph		= _gps_state[i].eph;
-		_gps_output[i].epv		= _gps_state[i].epv;
-		_gps_output[i].sacc		= _gps_state[i].sacc;
-		_gps_output[i].pdop		= _gps_state[i].pdop;
-		_gps_output[i].nsats		= _gps_state[i].nsats;
-		_gps_output[i].vel_ned_valid	= _gps_state[i].vel_ned_valid;
-		_gps_output[i].yaw		= _gps_state[i].yaw;
-		_gps_output[i].yaw_offset	= _gps_state[i].yaw_offset;
+	_object.store(nullptr);
+	_task_id = -1;
 
-	}
+	return PX4_ERROR;
 }
 
-/*
- Calculate GPS output that is a blend of the offset corrected physical receiver data
-*/
-void Ekf2::calc_gps_blend_output()
+int Ekf2::start_sweep(const char *sweep_file)
 {
-	// Convert each GPS position to a local NEU offset relative to the reference position
-	// which is defined as the positon of the blended solution calculated from non offset corrected data
-	Vector2f blended_NE_offset_m;
-	blended_NE_offset_m.zero();
-	float blended_alt_offset_mm = 0.0f;
-
-	for (uint8_t i = 0; i < GPS_MAX_RECEIVERS; i++) {
-		if (_blend_weights[i] > 0.0f) {
-			// calculate the horizontal offset
-			Vector2f horiz_offset{};
-			get_vector_to_next_waypoint((_gps_blended_state.lat / 1.0e7),
-						    (_gps_blended_state.lon / 1.0e7),
-						    (_gps_output[i].lat / 1.0e7),
-						    (_gps_output[i].lon / 1.0e7),
-						    &horiz_offset(0),
-						    &horiz_offset(1));
-
-			// sum weighted offsets
-			blended_NE_offset_m += horiz_offset * _blend_weights[i];
-
-			// calculate vertical offset
-			float vert_offset = (float)(_gps_output[i].alt - _gps_blended_state.alt);
-
-			// sum weighted offsets
-			blended_alt_offset_mm += vert_offset * _blend_weights[i];
-		}
+	FILE *fp = fopen(sweep_file, "r");
+
+	if (fp == nullptr) {
+		PX4_ERR("failed to open %s", sweep_file);
+		return PX4_ERROR;
 	}
 
-	// Add the sum of weighted offsets to the reference position to obtain the blended position
-	double lat_deg_now = (double)_gps_blended_state.lat * 1.0e-7;
-	double lon_deg_now = (double)_gps_blended_state.lon * 1.0e-7;
-	double lat_deg_res, lon_deg_res;
-	add_vector_to_global_position(lat_deg_now, lon_deg_now, blended_NE_offset_m(0), blended_NE_offset_m(1), &lat_deg_res,
-				      &lon_deg_res);
-	_gps_output[GPS_BLENDED_INSTANCE].lat = (int32_t)(1.0E7 * lat_deg_res);
-	_gps_output[GPS_BLENDED_INSTANCE].lon = (int32_t)(1.0E7 * lon_deg_res);
-	_gps_output[GPS_BLENDED_INSTANCE].alt = _gps_blended_state.alt + (int32_t)blended_alt_offset_mm;
-
-	// Copy remaining data from internal states to output
-	_gps_output[GPS_BLENDED_INSTANCE].time_usec	= _gps_blended_state.time_usec;
-	_gps_output[GPS_BLENDED_INSTANCE].fix_type	= _gps_blended_state.fix_type;
-	_gps_output[GPS_BLENDED_INSTANCE].vel_m_s	= _gps_blended_state.vel_m_s;
-	_gps_output[GPS_BLENDED_INSTANCE].vel_ned	= _gps_blended_state.vel_ned;
-	_gps_output[GPS_BLENDED_INSTANCE].eph		= _gps_blended_state.eph;
-	_gps_output[GPS_BLENDED_INSTANCE].epv		= _gps_blended_state.epv;
-	_gps_output[GPS_BLENDED_INSTANCE].sacc		= _gps_blended_state.sacc;
-	_gps_output[GPS_BLENDED_INSTANCE].pdop		= _gps_blended_state.pdop;
-	_gps_output[GPS_BLENDED_INSTANCE].nsats		= _gps_blended_state.nsats;
-	_gps_output[GPS_BLENDED_INSTANCE].vel_ned_valid	= _gps_blended_state.vel_ned_valid;
-	_gps_output[GPS_BLENDED_INSTANCE].yaw		= _gps_blended_state.yaw;
-	_gps_output[GPS_BLENDED_INSTANCE].yaw_offset	= _gps_blended_state.yaw_offset;
+	const px4::wq_config_t *wq_configs[MAX_SENSOR_COUNT] {
+		&px4::wq_configurations::INS0,
+		&px4::wq_configurations::INS1,
+		&px4::wq_configurations::INS2,
+	};
 
-}
+	bool success = true;
+	int count = 0;
+	char line[80];
 
-float Ekf2::filter_altitude_ellipsoid(float amsl_hgt)
-{
+	// one override per line: <set> <parameter name> <value>
+	while (success && fgets(line, sizeof(line), fp) != nullptr) {
+		int set = -1;
+		char name[17] {};
+		float value = 0.f;
 
-	float height_diff = static_cast<float>(_gps_alttitude_ellipsoid[0]) * 1e-3f - amsl_hgt;
+		if ((line[0] == '#') || (sscanf(line, "%d %16s %f", &set, name, &value) != 3)) {
+			continue;
+		}
 
-	if (_gps_alttitude_ellipsoid_previous_timestamp[0] == 0) {
+		if ((set < 0) || (set >= MAX_SENSOR_COUNT)) {
+			PX4_ERR("set %d out of range, at most %d sets", set, MAX_SENSOR_COUNT);
+			success = false;
+			break;
+		}
 
-		_wgs84_hgt_offset = height_diff;
-		_gps_alttitude_ellipsoid_previous_timestamp[0] = _gps_state[0].time_usec;
+		// create all instances up to this set
+		for (; count <= set; count++) {
+			_bank[count] = new Ekf2(true, count, *wq_configs[count], true);
 
-	} else if (_gps_state[0].time_usec != _gps_alttitude_ellipsoid_previous_timestamp[0]) {
+			if (_bank[count] == nullptr) {
+				PX4_ERR("alloc failed");
+				success = false;
+				break;
+			}
 
-		// apply a 10 second first order low pass filter to baro offset
-		float dt = 1e-6f * static_cast<float>(_gps_state[0].time_usec - _gps_alttitude_ellipsoid_previous_timestamp[0]);
-		_gps_alttitude_ellipsoid_previous_timestamp[0] = _gps_state[0].time_usec;
-		float offset_rate_correction = 0.1f * (height_diff - _wgs84_hgt_offset);
-		_wgs84_hgt_offset += dt * math::constrain(offset_rate_correction, -0.1f, 0.1f);
-	}
+			_bank[count]->_sweep_mode = true;
+			_bank[count]->_primary = false; // the sets must not save learned parameters
+		}
 
-	return amsl_hgt + _wgs84_hgt_offset;
-}
+		if (!success) {
+			break;
+		}
 
-int Ekf2::custom_command(int argc, char *argv[])
-{
-	return print_usage("unknown command");
-}
+		Ekf2 *inst = _bank[set];
+		const ParamOverride param_override{param_find(name), value};
 
-int Ekf2::task_spawn(int argc, char *argv[])
-{
-	bool replay_mode = false;
+		if ((inst->_param_override_count >= MAX_PARAM_OVERRIDES) || !inst->applyParamOverride(param_override)) {
+			PX4_ERR("set %d: %s can not be swept", set, name);
+			success = false;
+			break;
+		}
 
-	if (argc > 1 && !strcmp(argv[1], "-r")) {
-		PX4_INFO("replay mode enabled");
-		replay_mode = true;
+		inst->_param_overrides[inst->_param_override_count++] = param_override;
 	}
 
-	Ekf2 *instance = new Ekf2(replay_mode);
+	fclose(fp);
 
-	if (instance) {
-		_object.store(instance);
+	if (success && (count == 0)) {
+		PX4_ERR("no parameter sets in %s", sweep_file);
+		success = false;
+	}
+
+	if (success) {
+		_object.store(_bank[0]);
 		_task_id = task_id_is_work_queue;
 
-		if (instance->init()) {
-			return PX4_OK;
+		for (int i = 0; i < count; i++) {
+			_bank[i]->updateParams();
+
+			if (!_bank[i]->init()) {
+				success = false;
+				break;
+			}
 		}
+	}
 
-	} else {
-		PX4_ERR("alloc failed");
+	if (success) {
+		PX4_INFO("replaying %d parameter sets", count);
+		return PX4_OK;
+	}
+
+	for (Ekf2 *&inst : _bank) {
+		delete inst;
+		inst = nullptr;
 	}
 
-	delete instance;
 	_object.store(nullptr);
 	_task_id = -1;
 
@@ -2431,13 +2311,22 @@ Attitude and position estimator using an Extended Kalman Filter. It is used for
 The documentation can be found on the [ECL/EKF Overview & Tuning](https://docs.px4.io/en/advanced_config/tuning_the_ecl_ekf.html) page.
 
 ekf2 can be started in replay mode (`-r`): in this mode it does not access the system time, but only uses the
-timestamps from the sensor topics.
+timestamps from the sensor topics. With `-s <file>` the log is replayed through one instance per parameter set
+in parallel, each on its own work queue. Every line of the file overrides a noise or gate parameter of a set
+(`<set> <parameter name> <value>`, up to 3 sets). The sets publish estimator_attitude and estimator_status
+instances and print their innovation test ratio statistics on `ekf2 status` and when stopped.
+
+If EKF2_MULTI_IMU is set to 2 or more, one estimator instance per IMU is started, each on its own work queue.
+The instances publish estimator_attitude, estimator_local_position and estimator_global_position, and a selector
+republishes the outputs of the healthiest instance as vehicle_attitude, vehicle_local_position and
+vehicle_global_position. A change of the selected instance is reported to the consumers as an estimator reset.
 
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("ekf2", "estimator");
 	PRINT_MODULE_USAGE_COMMAND("start");
 	PRINT_MODULE_USAGE_PARAM_FLAG('r', "Enable replay mode", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('s', nullptr, "<file>", "Replay parameter sweep file (requires -r)", true);
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 
 	return 0;
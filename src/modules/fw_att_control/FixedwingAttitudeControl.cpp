@@ -54,6 +54,8 @@ FixedwingAttitudeControl::FixedwingAttitudeControl(bool vtol) :
 		if (param_get(param_find("VT_TYPE"), &vt_type) == PX4_OK) {
 			_is_tailsitter = (static_cast<vtol_type>(vt_type) == vtol_type::TAILSITTER);
 		}
+
+		_vt_elev_mc_lock_handle = param_find("VT_ELEV_MC_LOCK");
 	}
 
 	/* fetch initial parameter values */
@@ -112,6 +114,18 @@ FixedwingAttitudeControl::parameters_update()
 	_wheel_ctrl.set_integrator_max(_param_fw_wr_imax.get());
 	_wheel_ctrl.set_max_rate(radians(_param_fw_w_rmax.get()));
 
+	/* airspeed scaling, the airspeed is constrained to [min, max] by the table */
+	const float airspeed_trim = _param_fw_airspd_trim.get();
+	_airspeed_scaling_schedule.generate(_param_fw_airspd_min.get(), _param_fw_airspd_max.get(),
+	[airspeed_trim](float airspeed) { return airspeed_trim / airspeed; });
+
+	if (_vt_elev_mc_lock_handle != PARAM_INVALID) {
+		int32_t elev_mc_lock = 0;
+		param_get(_vt_elev_mc_lock_handle, &elev_mc_lock);
+		_vt_elev_mc_lock = (elev_mc_lock == 1);
+		vtol_scheduling_update();
+	}
+
 	return PX4_OK;
 }
 
@@ -263,22 +277,50 @@ float FixedwingAttitudeControl::get_airspeed_and_update_scaling()
 	 *
 	 * Forcing the scaling to this value allows reasonable handheld tests.
 	 */
-	const float airspeed_constrained = constrain(airspeed, _param_fw_airspd_min.get(), _param_fw_airspd_max.get());
-	_airspeed_scaling = _param_fw_airspd_trim.get() / airspeed_constrained;
+	_airspeed_scaling = _airspeed_scaling_schedule.interpolate(airspeed);
 
 	return airspeed;
 }
 
+void
+FixedwingAttitudeControl::vtol_scheduling_update()
+{
+	// in hover with locked control surfaces vtol_att_control ignores our outputs, keep running at a low rate
+	// and get woken up by vehicle_status to be at full rate as soon as a transition starts
+	const bool inactive = _vehicle_status.is_vtol && _vt_elev_mc_lock
+			      && _vehicle_status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_ROTARY_WING
+			      && !_vehicle_status.in_transition_mode;
+
+	if (inactive != _vtol_inactive) {
+		if (inactive) {
+			_att_sub.set_interval_ms(VTOL_INACTIVE_INTERVAL_MS);
+			_vehicle_status_sub.registerCallback();
+
+		} else {
+			_att_sub.set_interval_us(0);
+			_vehicle_status_sub.unregisterCallback();
+		}
+
+		_vtol_inactive = inactive;
+	}
+}
+
 void FixedwingAttitudeControl::Run()
 {
 	if (should_exit()) {
 		_att_sub.unregisterCallback();
+		_vehicle_status_sub.unregisterCallback();
 		exit_and_cleanup();
 		return;
 	}
 
 	perf_begin(_loop_perf);
 
+	// vehicle status update must be before the vehicle_control_mode_poll(), otherwise rate sp are not published during whole transition
+	if (_vehicle_status_sub.update(&_vehicle_status)) {
+		vtol_scheduling_update();
+	}
+
 	if (_att_sub.update(&_att)) {
 
 		// only update parameters if they changed
@@ -355,10 +397,6 @@ void FixedwingAttitudeControl::Run()
 		const matrix::Eulerf euler_angles(R);
 
 		vehicle_attitude_setpoint_poll();
-
-		// vehicle status update must be before the vehicle_control_mode_poll(), otherwise rate sp are not published during whole transition
-		_vehicle_status_sub.update(&_vehicle_status);
-
 		vehicle_control_mode_poll();
 		vehicle_manual_poll();
 		_global_pos_sub.update(&_global_pos);
@@ -94,6 +94,7 @@ private:
 	void Run() override;
 
 	uORB::SubscriptionCallbackWorkItem _att_sub{this, ORB_ID(vehicle_attitude)};	/**< vehicle attitude */
+	uORB::SubscriptionCallbackWorkItem _vehicle_status_sub{this, ORB_ID(vehicle_status)};	/**< vehicle status, callback only while inactive */
 
 	uORB::Subscription _att_sp_sub{ORB_ID(vehicle_attitude_setpoint)};		/**< vehicle attitude setpoint */
 	uORB::Subscription _battery_status_sub{ORB_ID(battery_status)};			/**< battery status subscription */
@@ -103,7 +104,6 @@ private:
 	uORB::Subscription _rates_sp_sub{ORB_ID(vehicle_rates_setpoint)};		/**< vehicle rates setpoint */
 	uORB::Subscription _vcontrol_mode_sub{ORB_ID(vehicle_control_mode)};		/**< vehicle status subscription */
 	uORB::Subscription _vehicle_land_detected_sub{ORB_ID(vehicle_land_detected)};	/**< vehicle land detected subscription */
-	uORB::Subscription _vehicle_status_sub{ORB_ID(vehicle_status)};			/**< vehicle status subscription */
 	uORB::Subscription _vehicle_rates_sub{ORB_ID(vehicle_angular_velocity)};
 
 	uORB::SubscriptionData<airspeed_validated_s> _airspeed_validated_sub{ORB_ID(airspeed_validated)};
@@ -130,6 +130,7 @@ private:
 	float _flaperons_applied{0.0f};
 
 	float _airspeed_scaling{1.0f};
+	math::GainSchedule<17> _airspeed_scaling_schedule;	/**< trim / airspeed over [min, max] airspeed */
 
 	bool _landed{true};
 
@@ -139,6 +140,12 @@ private:
 
 	bool _is_tailsitter{false};
 
+	static constexpr uint32_t VTOL_INACTIVE_INTERVAL_MS{100};	/**< attitude update interval while the fixed-wing outputs are unused */
+
+	param_t _vt_elev_mc_lock_handle{PARAM_INVALID};
+	bool _vt_elev_mc_lock{false};	/**< VTOL control surfaces locked in hover, fixed-wing outputs unused */
+	bool _vtol_inactive{false};
+
 	DEFINE_PARAMETERS(
 		(ParamFloat<px4::params::FW_ACRO_X_MAX>) _param_fw_acro_x_max,
 		(ParamFloat<px4::params::FW_ACRO_Y_MAX>) _param_fw_acro_y_max,
@@ -227,5 +234,10 @@ private:
 	void		vehicle_rates_setpoint_poll();
 	void		vehicle_land_detected_poll();
 
+	/**
+	 * Run at a low rate while a VTOL hovers and the fixed-wing outputs are not used.
+	 */
+	void		vtol_scheduling_update();
+
 	float 		get_airspeed_and_update_scaling();
 };
@@ -193,14 +193,25 @@ FixedwingPositionControl::parameters_update()
 		_l1_control.set_l1_period(v);
 	}
 
-	if (param_get(_parameter_handles.roll_limit, &v) == PX4_OK) {
-		_l1_control.set_l1_roll_limit(radians(v));
+	float roll_limit = 0.f;
+
+	if (param_get(_parameter_handles.roll_limit, &roll_limit) == PX4_OK) {
+		_l1_control.set_l1_roll_limit(radians(roll_limit));
 	}
 
 	if (param_get(_parameter_handles.roll_slew_deg_sec, &v) == PX4_OK) {
 		_l1_control.set_roll_slew_rate(radians(v));
 	}
 
+	// minimum airspeed increase with bank angle (see get_demanded_airspeed()), tabulated up to the largest roll setpoint
+	const float airspeed_min = _parameters.airspeed_min;
+	const float airspeed_max = _parameters.airspeed_max;
+
+	_airspeed_min_schedule.generate(0.f, min(max(radians(roll_limit), _parameters.man_roll_max_rad), radians(85.f)),
+	[airspeed_min, airspeed_max](float roll) {
+		return constrain(airspeed_min / sqrtf(cosf(roll)), airspeed_min, airspeed_max);
+	});
+
 	// TECS parameters
 
 	param_get(_parameter_handles.max_climb_rate, &(_parameters.max_climb_rate));
@@ -433,8 +444,7 @@ FixedwingPositionControl::calculate_target_airspeed(float airspeed_demand, const
 
 	if (_airspeed_valid && PX4_ISFINITE(_att_sp.roll_body)) {
 
-		adjusted_min_airspeed = constrain(_parameters.airspeed_min / sqrtf(cosf(_att_sp.roll_body)),
-						  _parameters.airspeed_min, _parameters.airspeed_max);
+		adjusted_min_airspeed = _airspeed_min_schedule.interpolate(fabsf(_att_sp.roll_body));
 	}
 
 	// groundspeed undershoot
@@ -234,6 +234,8 @@ private:
 	float _airspeed{0.0f};
 	float _eas2tas{1.0f};
 
+	math::GainSchedule<17> _airspeed_min_schedule;		///< bank angle dependent minimum airspeed, generated on parameter update
+
 	float _groundspeed_undershoot{0.0f};			///< ground speed error to min. speed in m/s
 
 	Dcmf _R_nb;				///< current attitude
@@ -0,0 +1,668 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "GpsBlending.hpp"
+
+#include <float.h>
+
+#include <mathlib/mathlib.h>
+
+using namespace matrix;
+
+GpsBlending::GpsBlending() :
+	ModuleParams(nullptr),
+	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::lp_default)
+{
+}
+
+GpsBlending::~GpsBlending()
+{
+	perf_free(_cycle_perf);
+}
+
+bool GpsBlending::init()
+{
+	for (auto &sub : _vehicle_gps_position_sub) {
+		if (!sub.registerCallback()) {
+			PX4_ERR("vehicle_gps_position callback registration failed");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void GpsBlending::Run()
+{
+	if (should_exit()) {
+		for (auto &sub : _vehicle_gps_position_sub) {
+			sub.unregisterCallback();
+		}
+
+		exit_and_cleanup();
+		return;
+	}
+
+	// check for parameter updates
+	if (_parameter_update_sub.updated()) {
+		// clear update
+		parameter_update_s param_update;
+		_parameter_update_sub.copy(&param_update);
+
+		updateParams();
+	}
+
+	perf_begin(_cycle_perf);
+
+	bool updated[GPS_MAX_RECEIVERS] {};
+	bool any_updated = false;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		updated[i] = _vehicle_gps_position_sub[i].update(&_gps_state[i]);
+		any_updated |= updated[i];
+	}
+
+	if (_param_ekf2_gps_mask.get() == 0) {
+		// blending disabled, always use the first receiver
+		if (updated[0]) {
+			_gps_select_index = 0;
+			publish(_gps_state[0]);
+		}
+
+	} else if (any_updated) {
+		if (!blend_gps_data()) {
+			select_receiver(updated);
+		}
+
+		if (_gps_new_output_data) {
+			// correct the receivers for their steady state offsets
+			apply_gps_offsets();
+
+			if (_gps_select_index == GPS_BLENDED_INSTANCE) {
+				calc_gps_blend_output();
+			}
+
+			publish(_gps_output[_gps_select_index]);
+
+			// clear flag to avoid re-use of the same data
+			_gps_new_output_data = false;
+		}
+	}
+
+	perf_end(_cycle_perf);
+}
+
+bool GpsBlending::blend_gps_data()
+{
+	_blend_weights.setZero();
+
+	// receivers whose data is too old relative to the newest receiver don't take part in the blend
+	uint64_t max_us = 0;
+	uint8_t newest_index = 0;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		if (_gps_state[i].timestamp > max_us) {
+			max_us = _gps_state[i].timestamp;
+			newest_index = i;
+		}
+	}
+
+	int active_count = 0;
+	uint64_t min_us = UINT64_MAX;
+	float dt_max = 0.f;
+	float dt_min = 0.3f;
+	uint8_t slowest_index = newest_index;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		_receiver_active[i] = (_gps_state[i].timestamp != 0) && (_gps_state[i].timestamp + RECEIVER_TIMEOUT_US > max_us);
+
+		if (!_receiver_active[i]) {
+			continue;
+		}
+
+		active_count++;
+
+		// filter the update interval to reduce the effects of jitter
+		const float raw_dt = 1e-6f * (float)(_gps_state[i].timestamp - _time_prev_us[i]);
+
+		if (raw_dt > 0.f && raw_dt < 0.3f) {
+			_gps_dt(i) = 0.1f * raw_dt + 0.9f * _gps_dt(i);
+		}
+
+		if (_gps_dt(i) > dt_max) {
+			dt_max = _gps_dt(i);
+			slowest_index = i;
+		}
+
+		dt_min = fminf(dt_min, _gps_dt(i));
+		min_us = math::min(min_us, _gps_state[i].timestamp);
+	}
+
+	if (active_count < 2) {
+		return false;
+	}
+
+	/*
+	 * If the update intervals are within 20% of each other the receivers run at the same rate. Wait until all
+	 * of them have published within half an interval and use the newest data as timing reference.
+	 * Otherwise blend at the rate of the slowest receiver.
+	 */
+	if ((dt_max - dt_min) < 0.2f * dt_min) {
+		if ((max_us - min_us) < (uint64_t)(5e5f * dt_min)) {
+			_gps_time_ref_index = newest_index;
+			_gps_new_output_data = true;
+		}
+
+	} else {
+		_gps_time_ref_index = slowest_index;
+
+		if (_gps_state[_gps_time_ref_index].timestamp > _time_prev_us[_gps_time_ref_index]) {
+			_gps_new_output_data = true;
+		}
+	}
+
+	if (!_gps_new_output_data) {
+		return true;
+	}
+
+	WeightVector spd_acc;
+	WeightVector hpos_acc;
+	WeightVector vpos_acc;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		spd_acc(i) = _gps_state[i].s_variance_m_s;
+		hpos_acc(i) = _gps_state[i].eph;
+		vpos_acc(i) = _gps_state[i].epv;
+	}
+
+	const int32_t mask = _param_ekf2_gps_mask.get();
+
+	WeightVector spd_weights;
+	WeightVector hpos_weights;
+	WeightVector vpos_weights;
+	float metric_count = 0.f;
+
+	if ((mask & BLEND_MASK_USE_SPD_ACC) && calc_blend_weights(spd_acc, 3, spd_weights)) {
+		metric_count += 1.f;
+	}
+
+	if ((mask & BLEND_MASK_USE_HPOS_ACC) && calc_blend_weights(hpos_acc, 2, hpos_weights)) {
+		metric_count += 1.f;
+	}
+
+	if ((mask & BLEND_MASK_USE_VPOS_ACC) && calc_blend_weights(vpos_acc, 3, vpos_weights)) {
+		metric_count += 1.f;
+	}
+
+	// if the reported accuracies can't be used, a single receiver has to be selected
+	if (metric_count < 1.f) {
+		return false;
+	}
+
+	_blend_weights = (spd_weights + hpos_weights + vpos_weights) / metric_count;
+
+	// with the updated weights calculate the blended solution and the offsets of each receiver
+	update_gps_blend_states();
+	update_gps_offsets();
+	_gps_select_index = GPS_BLENDED_INSTANCE;
+
+	return true;
+}
+
+bool GpsBlending::calc_blend_weights(const WeightVector &accuracy, uint8_t min_fix_type, WeightVector &weights) const
+{
+	weights.setZero();
+	float sum = 0.f;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		if (!_receiver_active[i]) {
+			continue;
+		}
+
+		if ((_gps_state[i].fix_type < min_fix_type) || !(accuracy(i) > 0.f)) {
+			// not all receivers support this metric so don't use it
+			weights.setZero();
+			return false;
+		}
+
+		if (accuracy(i) >= 0.001f) {
+			weights(i) = 1.f / (accuracy(i) * accuracy(i));
+			sum += weights(i);
+		}
+	}
+
+	if (sum > 0.f) {
+		weights /= sum;
+		return true;
+	}
+
+	return false;
+}
+
+void GpsBlending::update_gps_blend_states()
+{
+	// initialise the blended state so the results of each receiver can be accumulated with its weight
+	_gps_blended_state = {};
+	_gps_blended_state.eph = FLT_MAX;
+	_gps_blended_state.epv = FLT_MAX;
+	_gps_blended_state.s_variance_m_s = FLT_MAX;
+	_gps_blended_state.hdop = FLT_MAX;
+	_gps_blended_state.vdop = FLT_MAX;
+	_gps_blended_state.vel_ned_valid = true;
+	_gps_blended_state.heading = NAN;
+	_gps_blended_state.heading_offset = NAN;
+
+	Vector3f vel_ned{};
+	float alt_ellipsoid_offset_mm = 0.f;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		if (!(_blend_weights(i) > 0.f)) {
+			continue;
+		}
+
+		const vehicle_gps_position_s &gps = _gps_state[i];
+		const float weight = _blend_weights(i);
+
+		_gps_blended_state.timestamp += (uint64_t)((double)gps.timestamp * (double)weight);
+
+		// use the highest status
+		_gps_blended_state.fix_type = math::max(_gps_blended_state.fix_type, gps.fix_type);
+
+		_gps_blended_state.vel_m_s += gps.vel_m_s * weight;
+		vel_ned += Vector3f{gps.vel_n_m_s, gps.vel_e_m_s, gps.vel_d_m_s} * weight;
+
+		alt_ellipsoid_offset_mm += (float)(gps.alt_ellipsoid - gps.alt) * weight;
+
+		// the blended error magnitudes, DOP and satellite count are the best ones of the contributing receivers
+		if (gps.eph > 0.f && gps.eph < _gps_blended_state.eph) {
+			_gps_blended_state.eph = gps.eph;
+		}
+
+		if (gps.epv > 0.f && gps.epv < _gps_blended_state.epv) {
+			_gps_blended_state.epv = gps.epv;
+		}
+
+		if (gps.s_variance_m_s > 0.f && gps.s_variance_m_s < _gps_blended_state.s_variance_m_s) {
+			_gps_blended_state.s_variance_m_s = gps.s_variance_m_s;
+		}
+
+		if (gps.hdop > 0.f && gps.hdop < _gps_blended_state.hdop) {
+			_gps_blended_state.hdop = gps.hdop;
+		}
+
+		if (gps.vdop > 0.f && gps.vdop < _gps_blended_state.vdop) {
+			_gps_blended_state.vdop = gps.vdop;
+		}
+
+		_gps_blended_state.satellites_used = math::max(_gps_blended_state.satellites_used, gps.satellites_used);
+
+		// if any contributing receiver has an invalid velocity, the blended velocity is invalid
+		if (!gps.vel_ned_valid) {
+			_gps_blended_state.vel_ned_valid = false;
+		}
+	}
+
+	_gps_blended_state.vel_n_m_s = vel_ned(0);
+	_gps_blended_state.vel_e_m_s = vel_ned(1);
+	_gps_blended_state.vel_d_m_s = vel_ned(2);
+	_gps_blended_state.cog_rad = atan2f(vel_ned(1), vel_ned(0));
+
+	// remaining receiver metadata is taken from the timing reference
+	const vehicle_gps_position_s &time_ref = _gps_state[_gps_time_ref_index];
+	_gps_blended_state.c_variance_rad = time_ref.c_variance_rad;
+	_gps_blended_state.noise_per_ms = time_ref.noise_per_ms;
+	_gps_blended_state.jamming_indicator = time_ref.jamming_indicator;
+	_gps_blended_state.time_utc_usec = time_ref.time_utc_usec;
+	_gps_blended_state.timestamp_time_relative = (int32_t)((int64_t)(time_ref.timestamp + time_ref.timestamp_time_relative)
+			- (int64_t)_gps_blended_state.timestamp);
+
+	/*
+	 * Calculate the instantaneous weighted average location. This is statistically the most likely location,
+	 * but may not be stable enough for direct use by the estimators.
+	 */
+
+	// use the receiver with the highest weight as the reference position
+	uint8_t best_index = 0;
+
+	for (int i = 1; i < GPS_MAX_RECEIVERS; i++) {
+		if (_blend_weights(i) > _blend_weights(best_index)) {
+			best_index = i;
+		}
+	}
+
+	_gps_blended_state.lat = _gps_state[best_index].lat;
+	_gps_blended_state.lon = _gps_state[best_index].lon;
+	_gps_blended_state.alt = _gps_state[best_index].alt;
+
+	// sum the weighted NEU offsets of the other receivers relative to the reference position
+	Vector2f blended_NE_offset_m{};
+	float blended_alt_offset_mm = 0.f;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		if ((_blend_weights(i) > 0.f) && (i != best_index)) {
+			Vector2f horiz_offset{};
+			get_vector_to_next_waypoint((_gps_blended_state.lat / 1.0e7), (_gps_blended_state.lon / 1.0e7),
+						    (_gps_state[i].lat / 1.0e7), (_gps_state[i].lon / 1.0e7),
+						    &horiz_offset(0), &horiz_offset(1));
+
+			blended_NE_offset_m += horiz_offset * _blend_weights(i);
+			blended_alt_offset_mm += (float)(_gps_state[i].alt - _gps_blended_state.alt) * _blend_weights(i);
+		}
+	}
+
+	double lat_deg_res = 0.0;
+	double lon_deg_res = 0.0;
+	add_vector_to_global_position((double)_gps_blended_state.lat * 1.0e-7, (double)_gps_blended_state.lon * 1.0e-7,
+				      blended_NE_offset_m(0), blended_NE_offset_m(1), &lat_deg_res, &lon_deg_res);
+	_gps_blended_state.lat = (int32_t)(1.0E7 * lat_deg_res);
+	_gps_blended_state.lon = (int32_t)(1.0E7 * lon_deg_res);
+	_gps_blended_state.alt += (int32_t)blended_alt_offset_mm;
+	_gps_blended_state.alt_ellipsoid = _gps_blended_state.alt + (int32_t)alt_ellipsoid_offset_mm;
+
+	// take the heading from the highest weighted receiver that publishes a valid heading
+	float best_weight = 0.f;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		if (PX4_ISFINITE(_gps_state[i].heading) && (_blend_weights(i) > best_weight)) {
+			best_weight = _blend_weights(i);
+			_gps_blended_state.heading = _gps_state[i].heading;
+			_gps_blended_state.heading_offset = _gps_state[i].heading_offset;
+		}
+	}
+}
+
+void GpsBlending::update_gps_offsets()
+{
+	// the time constant of the offset filter is inversely proportional to the weight of the receiver,
+	// a weight of 1 adjusts the offset the slowest, a weight of 0 without filtering
+	WeightVector alpha;
+	const float omega_lpf = 1.f / fmaxf(_param_ekf2_gps_tau.get(), 1.f);
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		if (_gps_state[i].timestamp > _time_prev_us[i]) {
+			const float min_alpha = math::constrain(omega_lpf * 1e-6f * (float)(_gps_state[i].timestamp - _time_prev_us[i]),
+							0.f, 1.f);
+
+			if (_blend_weights(i) > min_alpha) {
+				alpha(i) = min_alpha / _blend_weights(i);
+
+			} else {
+				alpha(i) = 1.f;
+			}
+
+			_time_prev_us[i] = _gps_state[i].timestamp;
+		}
+	}
+
+	// filtered position delta of each receiver relative to the blended solution
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		Vector2f offset{};
+		get_vector_to_next_waypoint((_gps_state[i].lat / 1.0e7), (_gps_state[i].lon / 1.0e7),
+					    (_gps_blended_state.lat / 1.0e7), (_gps_blended_state.lon / 1.0e7), &offset(0), &offset(1));
+
+		_NE_pos_offset_m[i] = offset * alpha(i) + _NE_pos_offset_m[i] * (1.f - alpha(i));
+	}
+
+	WeightVector hgt_offset_mm;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		hgt_offset_mm(i) = (float)(_gps_blended_state.alt - _gps_state[i].alt);
+	}
+
+	_hgt_offset_mm += (hgt_offset_mm - _hgt_offset_mm).emult(alpha);
+
+	// limit the offsets to the largest difference between the active receivers
+	Vector2f max_ne_offset{};
+	float max_alt_offset = 0.f;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		for (int j = i + 1; j < GPS_MAX_RECEIVERS; j++) {
+			if (_receiver_active[i] && _receiver_active[j]) {
+				Vector2f offset{};
+				get_vector_to_next_waypoint((_gps_state[i].lat / 1.0e7), (_gps_state[i].lon / 1.0e7),
+							    (_gps_state[j].lat / 1.0e7), (_gps_state[j].lon / 1.0e7), &offset(0), &offset(1));
+				max_ne_offset(0) = fmaxf(max_ne_offset(0), fabsf(offset(0)));
+				max_ne_offset(1) = fmaxf(max_ne_offset(1), fabsf(offset(1)));
+				max_alt_offset = fmaxf(max_alt_offset, fabsf((float)(_gps_state[i].alt - _gps_state[j].alt)));
+			}
+		}
+	}
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		_NE_pos_offset_m[i](0) = math::constrain(_NE_pos_offset_m[i](0), -max_ne_offset(0), max_ne_offset(0));
+		_NE_pos_offset_m[i](1) = math::constrain(_NE_pos_offset_m[i](1), -max_ne_offset(1), max_ne_offset(1));
+		_hgt_offset_mm(i) = math::constrain(_hgt_offset_mm(i), -max_alt_offset, max_alt_offset);
+	}
+}
+
+void GpsBlending::apply_gps_offsets()
+{
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		// receiver data other than the position is used uncorrected
+		_gps_output[i] = _gps_state[i];
+
+		double lat_deg_res = 0.0;
+		double lon_deg_res = 0.0;
+		add_vector_to_global_position((double)_gps_state[i].lat * 1.0e-7, (double)_gps_state[i].lon * 1.0e-7,
+					      _NE_pos_offset_m[i](0), _NE_pos_offset_m[i](1), &lat_deg_res, &lon_deg_res);
+		_gps_output[i].lat = (int32_t)(1.0E7 * lat_deg_res);
+		_gps_output[i].lon = (int32_t)(1.0E7 * lon_deg_res);
+		_gps_output[i].alt = _gps_state[i].alt + (int32_t)_hgt_offset_mm(i);
+		_gps_output[i].alt_ellipsoid = _gps_state[i].alt_ellipsoid + (int32_t)_hgt_offset_mm(i);
+	}
+}
+
+void GpsBlending::calc_gps_blend_output()
+{
+	// NEU offsets of the offset corrected receivers relative to the uncorrected blended position
+	Vector2f blended_NE_offset_m{};
+	float blended_alt_offset_mm = 0.f;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		if (_blend_weights(i) > 0.f) {
+			Vector2f horiz_offset{};
+			get_vector_to_next_waypoint((_gps_blended_state.lat / 1.0e7), (_gps_blended_state.lon / 1.0e7),
+						    (_gps_output[i].lat / 1.0e7), (_gps_output[i].lon / 1.0e7),
+						    &horiz_offset(0), &horiz_offset(1));
+
+			blended_NE_offset_m += horiz_offset * _blend_weights(i);
+			blended_alt_offset_mm += (float)(_gps_output[i].alt - _gps_blended_state.alt) * _blend_weights(i);
+		}
+	}
+
+	vehicle_gps_position_s &output = _gps_output[GPS_BLENDED_INSTANCE];
+	output = _gps_blended_state;
+
+	double lat_deg_res = 0.0;
+	double lon_deg_res = 0.0;
+	add_vector_to_global_position((double)_gps_blended_state.lat * 1.0e-7, (double)_gps_blended_state.lon * 1.0e-7,
+				      blended_NE_offset_m(0), blended_NE_offset_m(1), &lat_deg_res, &lon_deg_res);
+	output.lat = (int32_t)(1.0E7 * lat_deg_res);
+	output.lon = (int32_t)(1.0E7 * lon_deg_res);
+	output.alt = _gps_blended_state.alt + (int32_t)blended_alt_offset_mm;
+	output.alt_ellipsoid = _gps_blended_state.alt_ellipsoid + (int32_t)blended_alt_offset_mm;
+}
+
+void GpsBlending::select_receiver(const bool updated[GPS_MAX_RECEIVERS])
+{
+	// use the receiver with the best fix
+	uint8_t best_fix_type = 0;
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		if (_receiver_active[i]) {
+			best_fix_type = math::max(best_fix_type, _gps_state[i].fix_type);
+		}
+	}
+
+	// keep the current receiver if none is better, otherwise prefer the receiver we just received data from
+	const bool keep_current = (_gps_select_index < GPS_MAX_RECEIVERS) && _receiver_active[_gps_select_index]
+				  && (_gps_state[_gps_select_index].fix_type == best_fix_type);
+
+	if (!keep_current) {
+		int selected = -1;
+
+		for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+			if (_receiver_active[i] && (_gps_state[i].fix_type == best_fix_type)) {
+				if (updated[i]) {
+					selected = i;
+					break;
+
+				} else if (selected < 0) {
+					selected = i;
+				}
+			}
+		}
+
+		if (selected >= 0) {
+			_gps_select_index = selected;
+		}
+	}
+
+	// only use the selected receiver if it has been updated
+	_gps_new_output_data = (_gps_select_index < GPS_MAX_RECEIVERS) && updated[_gps_select_index];
+}
+
+void GpsBlending::publish(const vehicle_gps_position_s &gps)
+{
+	_vehicle_gps_blended_pub.publish(gps);
+
+	// log the selected or blended solution
+	ekf_gps_position_s ekf_gps{};
+	ekf_gps.timestamp = gps.timestamp;
+	ekf_gps.lat = gps.lat;
+	ekf_gps.lon = gps.lon;
+	ekf_gps.alt = gps.alt;
+	ekf_gps.alt_ellipsoid = gps.alt_ellipsoid;
+	ekf_gps.s_variance_m_s = gps.s_variance_m_s;
+	ekf_gps.fix_type = gps.fix_type;
+	ekf_gps.eph = gps.eph;
+	ekf_gps.epv = gps.epv;
+	ekf_gps.vel_m_s = gps.vel_m_s;
+	ekf_gps.vel_n_m_s = gps.vel_n_m_s;
+	ekf_gps.vel_e_m_s = gps.vel_e_m_s;
+	ekf_gps.vel_d_m_s = gps.vel_d_m_s;
+	ekf_gps.vel_ned_valid = gps.vel_ned_valid;
+	ekf_gps.satellites_used = gps.satellites_used;
+	ekf_gps.heading = gps.heading;
+	ekf_gps.heading_offset = gps.heading_offset;
+	ekf_gps.selected = _gps_select_index;
+
+	_ekf_gps_position_pub.publish(ekf_gps);
+}
+
+int GpsBlending::task_spawn(int argc, char *argv[])
+{
+	GpsBlending *instance = new GpsBlending();
+
+	if (instance) {
+		_object.store(instance);
+		_task_id = task_id_is_work_queue;
+
+		if (instance->init()) {
+			return PX4_OK;
+		}
+
+	} else {
+		PX4_ERR("alloc failed");
+	}
+
+	delete instance;
+	_object.store(nullptr);
+	_task_id = -1;
+
+	return PX4_ERROR;
+}
+
+int GpsBlending::custom_command(int argc, char *argv[])
+{
+	return print_usage("unknown command");
+}
+
+int GpsBlending::print_status()
+{
+	if (_param_ekf2_gps_mask.get() == 0) {
+		PX4_INFO("blending disabled, using receiver 0");
+
+	} else if (_gps_select_index == GPS_BLENDED_INSTANCE) {
+		PX4_INFO("blending, timing reference: %d", _gps_time_ref_index);
+
+	} else {
+		PX4_INFO("selected receiver: %d", _gps_select_index);
+	}
+
+	for (int i = 0; i < GPS_MAX_RECEIVERS; i++) {
+		if (_gps_state[i].timestamp != 0) {
+			PX4_INFO("receiver %d: fix %d, weight %.3f, dt %.3f s, offset N %.2f E %.2f U %.3f m", i,
+				 _gps_state[i].fix_type, (double)_blend_weights(i), (double)_gps_dt(i),
+				 (double)_NE_pos_offset_m[i](0), (double)_NE_pos_offset_m[i](1), (double)(_hgt_offset_mm(i) * 1e-3f));
+		}
+	}
+
+	perf_print_counter(_cycle_perf);
+
+	return 0;
+}
+
+int GpsBlending::print_usage(const char *reason)
+{
+	if (reason) {
+		PX4_WARN("%s\n", reason);
+	}
+
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+Blending of multiple GPS receivers. The solutions of all `vehicle_gps_position` instances are combined into
+a single `vehicle_gps_blended` output, which is the GPS input of the estimators.
+
+The blend weights are the inverse variances of the accuracy metrics selected with EKF2_GPS_MASK. The steady
+state offset of each receiver to the blended solution is removed with a time constant of up to EKF2_GPS_TAU,
+so that changes of the relative accuracy do not move the output. If the receivers can't be blended, the one
+with the best fix is used. With EKF2_GPS_MASK set to 0 the first receiver is forwarded unchanged.
+
+### Implementation
+The module runs on the low priority work queue, scheduled on `vehicle_gps_position` publications.
+
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME("gps_blending", "estimator");
+	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
+
+	return 0;
+}
+
+extern "C" __EXPORT int gps_blending_main(int argc, char *argv[])
+{
+	return GpsBlending::main(argc, argv);
+}
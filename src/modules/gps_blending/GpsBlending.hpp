@@ -0,0 +1,170 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file GpsBlending.hpp
+ *
+ * Blending of the solutions of multiple GPS receivers into a single vehicle_gps_blended output.
+ */
+
+#pragma once
+
+#include <lib/ecl/geo/geo.h>
+#include <lib/matrix/matrix/math.hpp>
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/defines.h>
+#include <px4_platform_common/module.h>
+#include <px4_platform_common/module_params.h>
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
+#include <uORB/topics/ekf_gps_position.h>
+#include <uORB/topics/parameter_update.h>
+#include <uORB/topics/vehicle_gps_position.h>
+
+class GpsBlending : public ModuleBase<GpsBlending>, public ModuleParams, public px4::ScheduledWorkItem
+{
+public:
+	GpsBlending();
+	~GpsBlending() override;
+
+	/** @see ModuleBase */
+	static int task_spawn(int argc, char *argv[]);
+
+	/** @see ModuleBase */
+	static int custom_command(int argc, char *argv[]);
+
+	/** @see ModuleBase */
+	static int print_usage(const char *reason = nullptr);
+
+	/** @see ModuleBase::print_status() */
+	int print_status() override;
+
+	bool init();
+
+private:
+	// number of physical receivers, the blended solution uses the next index
+	static constexpr int GPS_MAX_RECEIVERS = ORB_MULTI_MAX_INSTANCES;
+	static constexpr int GPS_BLENDED_INSTANCE = GPS_MAX_RECEIVERS;
+
+	// mask positions of the accuracy metrics used for the blend weights (EKF2_GPS_MASK)
+	static constexpr int32_t BLEND_MASK_USE_SPD_ACC = 1;
+	static constexpr int32_t BLEND_MASK_USE_HPOS_ACC = 2;
+	static constexpr int32_t BLEND_MASK_USE_VPOS_ACC = 4;
+
+	// receivers with data older than this relative to the newest one stop the blending
+	static constexpr uint64_t RECEIVER_TIMEOUT_US = 300000;
+
+	using WeightVector = matrix::Vector<float, GPS_MAX_RECEIVERS>;
+
+	void Run() override;
+
+	/**
+	 * Update the blend weights and the blended state from the receivers in _gps_state.
+	 * @return false if the receivers can't be blended, in which case a single receiver has to be selected
+	 */
+	bool blend_gps_data();
+
+	/**
+	 * Calculate the blend weights from the inverse variances of one accuracy metric.
+	 * @param accuracy accuracy metric of each receiver
+	 * @param min_fix_type active receivers with a lower fix type disable the metric
+	 * @return false if not all the active receivers report the metric
+	 */
+	bool calc_blend_weights(const WeightVector &accuracy, uint8_t min_fix_type, WeightVector &weights) const;
+
+	/**
+	 * Calculate the weighted average of the receiver solutions into _gps_blended_state.
+	 * The location moves around as the relative accuracy changes, so it can't be used directly.
+	 */
+	void update_gps_blend_states();
+
+	/**
+	 * Low-pass filter the offset from each receiver to the blended location, with a time constant
+	 * inversely proportional to the weight of the receiver.
+	 */
+	void update_gps_offsets();
+
+	/**
+	 * Apply the steady state receiver offsets calculated by update_gps_offsets() to _gps_output.
+	 */
+	void apply_gps_offsets();
+
+	/**
+	 * Calculate the blended output from the offset corrected receiver data.
+	 */
+	void calc_gps_blend_output();
+
+	/**
+	 * Select a single receiver if the receivers can't be blended.
+	 */
+	void select_receiver(const bool updated[GPS_MAX_RECEIVERS]);
+
+	void publish(const vehicle_gps_position_s &gps);
+
+	uORB::SubscriptionCallbackWorkItem _vehicle_gps_position_sub[GPS_MAX_RECEIVERS] {
+		{this, ORB_ID(vehicle_gps_position), 0},
+		{this, ORB_ID(vehicle_gps_position), 1},
+		{this, ORB_ID(vehicle_gps_position), 2},
+		{this, ORB_ID(vehicle_gps_position), 3}
+	};
+
+	uORB::Subscription _parameter_update_sub{ORB_ID(parameter_update)};
+
+	uORB::Publication<vehicle_gps_position_s> _vehicle_gps_blended_pub{ORB_ID(vehicle_gps_blended)};
+	uORB::Publication<ekf_gps_position_s> _ekf_gps_position_pub{ORB_ID(ekf_gps_position)};
+
+	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": cycle")};
+
+	vehicle_gps_position_s _gps_state[GPS_MAX_RECEIVERS] {};	///< latest data of the physical receivers
+	vehicle_gps_position_s _gps_blended_state{};			///< weighted average of the receivers
+	vehicle_gps_position_s _gps_output[GPS_MAX_RECEIVERS + 1] {};	///< offset corrected receivers and blended output
+
+	matrix::Vector2f _NE_pos_offset_m[GPS_MAX_RECEIVERS] {};	///< filtered North,East offset from each receiver to the blended location (m)
+	WeightVector _hgt_offset_mm;					///< filtered height offset from each receiver to the blended solution (mm)
+	WeightVector _blend_weights;					///< blend weight of each receiver, they sum to 1 across the receivers
+	WeightVector _gps_dt;						///< filtered update interval of each receiver (s)
+	uint64_t _time_prev_us[GPS_MAX_RECEIVERS] {};			///< previous timestamp of each receiver to detect new data
+
+	uint8_t _gps_select_index{0};					///< selected receiver, GPS_BLENDED_INSTANCE if blended
+	uint8_t _gps_time_ref_index{0};				///< receiver used as timing reference for the blending
+	bool _gps_new_output_data{false};				///< true if there is new output data
+	bool _receiver_active[GPS_MAX_RECEIVERS] {};			///< receiver has recent data and takes part in the blend
+
+	DEFINE_PARAMETERS(
+		(ParamInt<px4::params::EKF2_GPS_MASK>) _param_ekf2_gps_mask,
+		(ParamFloat<px4::params::EKF2_GPS_TAU>) _param_ekf2_gps_tau
+	)
+};
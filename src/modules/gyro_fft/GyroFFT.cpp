@@ -0,0 +1,415 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "GyroFFT.hpp"
+
+#include <drivers/drv_hrt.h>
+#include <mathlib/mathlib.h>
+
+using namespace time_literals;
+
+GyroFFT::GyroFFT() :
+	ModuleParams(nullptr),
+	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::lp_default)
+{
+}
+
+GyroFFT::~GyroFFT()
+{
+	for (auto &sub : _sensor_gyro_fifo_sub) {
+		sub.unregisterCallback();
+	}
+
+	_sensor_selection_sub.unregisterCallback();
+
+	FreeBuffers();
+
+	perf_free(_cycle_perf);
+	perf_free(_fft_perf);
+	perf_free(_gap_perf);
+}
+
+bool GyroFFT::init()
+{
+	if (!AllocateBuffers()) {
+		PX4_ERR("FFT init failed (length %d)", (int)_param_imu_gyro_fft_len.get());
+		return false;
+	}
+
+	// sensor_selection needed to change the analysed sensor
+	if (!_sensor_selection_sub.registerCallback()) {
+		PX4_ERR("sensor_selection callback registration failed");
+		return false;
+	}
+
+	ScheduleNow();
+	return true;
+}
+
+bool GyroFFT::AllocateBuffers()
+{
+	const int length = _param_imu_gyro_fft_len.get();
+
+	if (((length != 256) && (length != 512) && (length != 1024)) || !_fft.init(length)) {
+		return false;
+	}
+
+	for (auto &buffer : _buffer) {
+		buffer = new int16_t[length];
+	}
+
+	_window = new float[length];
+	_work = new float[length];
+	_power = new float[length / 2 + 1];
+
+	if ((_buffer[0] == nullptr) || (_buffer[1] == nullptr) || (_buffer[2] == nullptr)
+	    || (_window == nullptr) || (_work == nullptr) || (_power == nullptr)) {
+
+		FreeBuffers();
+		return false;
+	}
+
+	// Hann window
+	for (int n = 0; n < length; n++) {
+		_window[n] = 0.5f * (1.f - cosf(2.f * M_PI_F * n / (length - 1)));
+	}
+
+	_fft_length = length;
+	ResetBuffer();
+
+	return true;
+}
+
+void GyroFFT::FreeBuffers()
+{
+	for (auto &buffer : _buffer) {
+		delete[] buffer;
+		buffer = nullptr;
+	}
+
+	delete[] _window;
+	delete[] _work;
+	delete[] _power;
+
+	_window = nullptr;
+	_work = nullptr;
+	_power = nullptr;
+
+	_fft_length = 0;
+}
+
+void GyroFFT::ResetBuffer()
+{
+	_buffer_index = 0;
+	_timestamp_sample_last = 0;
+}
+
+bool GyroFFT::SensorSelectionUpdate(bool force)
+{
+	if (_sensor_selection_sub.updated() || (_selected_sensor_device_id == 0) || force) {
+		sensor_selection_s sensor_selection{};
+		_sensor_selection_sub.copy(&sensor_selection);
+
+		if ((sensor_selection.gyro_device_id != 0) && (_selected_sensor_device_id != sensor_selection.gyro_device_id)) {
+			for (int i = 0; i < MAX_SENSOR_COUNT; i++) {
+				sensor_gyro_fifo_s sensor_gyro_fifo{};
+
+				if (_sensor_gyro_fifo_sub[i].copy(&sensor_gyro_fifo)
+				    && (sensor_gyro_fifo.device_id == sensor_selection.gyro_device_id)) {
+
+					// clear all registered callbacks
+					for (auto &sub : _sensor_gyro_fifo_sub) {
+						sub.unregisterCallback();
+					}
+
+					if (_sensor_gyro_fifo_sub[i].registerCallback()) {
+						PX4_DEBUG("selected sensor changed %d -> %d", _selected_sensor_sub_index, i);
+
+						_selected_sensor_sub_index = i;
+						_selected_sensor_device_id = sensor_selection.gyro_device_id;
+						ResetBuffer();
+						return true;
+					}
+				}
+			}
+
+			// the selected gyro doesn't publish sensor_gyro_fifo (yet), retry later
+			_selected_sensor_device_id = 0;
+			_selected_sensor_sub_index = -1;
+			ScheduleDelayed(1_s);
+		}
+	}
+
+	return false;
+}
+
+void GyroFFT::Analyse(int axis, float peak_frequencies[MAX_PEAKS], float peak_snr[MAX_PEAKS])
+{
+	const int N = _fft_length;
+	const int16_t *buffer = _buffer[axis];
+
+	// remove the mean (gyro bias and slow motion) to avoid leakage of the DC bin
+	int32_t sum = 0;
+
+	for (int n = 0; n < N; n++) {
+		sum += buffer[n];
+	}
+
+	const float mean = (float)sum / N;
+
+	for (int n = 0; n < N; n++) {
+		_work[n] = (buffer[n] - mean) * _window[n];
+	}
+
+	perf_begin(_fft_perf);
+	_fft.powerSpectrum(_work, _power);
+	perf_end(_fft_perf);
+
+	const float resolution_hz = _sensor_gyro_fft.resolution_hz;
+
+	// noise floor: mean power over all bins (except DC and Nyquist)
+	float noise = 0.f;
+
+	for (int k = 1; k < N / 2; k++) {
+		noise += _power[k];
+	}
+
+	noise /= (N / 2 - 1);
+
+	// find the strongest local maxima within the configured frequency range
+	const int bin_min = math::max((int)ceilf(_param_imu_gyro_fft_min.get() / resolution_hz), 1);
+	const int bin_max = math::min((int)(_param_imu_gyro_fft_max.get() / resolution_hz), N / 2 - 1);
+
+	int peak_bin[MAX_PEAKS] {};
+	float peak_power[MAX_PEAKS] {};
+
+	for (int k = bin_min; k <= bin_max; k++) {
+		if ((_power[k] > _power[k - 1]) && (_power[k] >= _power[k + 1]) && (_power[k] > peak_power[MAX_PEAKS - 1])) {
+			// insert sorted (strongest first)
+			int i = MAX_PEAKS - 1;
+
+			for (; (i > 0) && (_power[k] > peak_power[i - 1]); i--) {
+				peak_power[i] = peak_power[i - 1];
+				peak_bin[i] = peak_bin[i - 1];
+			}
+
+			peak_power[i] = _power[k];
+			peak_bin[i] = k;
+		}
+	}
+
+	for (int i = 0; i < MAX_PEAKS; i++) {
+		peak_frequencies[i] = 0.f;
+		peak_snr[i] = 0.f;
+
+		if ((peak_bin[i] > 0) && (noise > 0.f)) {
+			const float snr = 10.f * log10f(peak_power[i] / noise);
+
+			if (snr >= _param_imu_gyro_fft_snr.get()) {
+				// parabolic interpolation of the peak location between the bins
+				const int k = peak_bin[i];
+				const float den = _power[k - 1] - 2.f * _power[k] + _power[k + 1];
+				const float delta = (fabsf(den) > FLT_EPSILON) ? 0.5f * (_power[k - 1] - _power[k + 1]) / den : 0.f;
+
+				peak_frequencies[i] = (k + math::constrain(delta, -0.5f, 0.5f)) * resolution_hz;
+				peak_snr[i] = snr;
+			}
+		}
+	}
+}
+
+void GyroFFT::Run()
+{
+	if (should_exit()) {
+		for (auto &sub : _sensor_gyro_fifo_sub) {
+			sub.unregisterCallback();
+		}
+
+		_sensor_selection_sub.unregisterCallback();
+		exit_and_cleanup();
+		return;
+	}
+
+	// check for parameter updates
+	if (_parameter_update_sub.updated()) {
+		// clear update
+		parameter_update_s param_update;
+		_parameter_update_sub.copy(&param_update);
+
+		updateParams();
+	}
+
+	SensorSelectionUpdate();
+
+	if ((_selected_sensor_sub_index < 0) || (_fft_length == 0)) {
+		return;
+	}
+
+	perf_begin(_cycle_perf);
+
+	sensor_gyro_fifo_s sensor_gyro_fifo;
+
+	if (_sensor_gyro_fifo_sub[_selected_sensor_sub_index].update(&sensor_gyro_fifo)
+	    && (sensor_gyro_fifo.samples > 0) && (sensor_gyro_fifo.dt > 0.f)) {
+
+		// restart the window if the sample interval changed or if FIFO data was missed
+		if (fabsf(sensor_gyro_fifo.dt - _fifo_dt) > 0.01f * _fifo_dt) {
+			_fifo_dt = sensor_gyro_fifo.dt;
+			ResetBuffer();
+
+		} else if ((_timestamp_sample_last != 0)
+			   && ((sensor_gyro_fifo.timestamp_sample - _timestamp_sample_last) > 1.5f * sensor_gyro_fifo.samples * _fifo_dt)) {
+
+			perf_count(_gap_perf);
+			ResetBuffer();
+		}
+
+		_timestamp_sample_last = sensor_gyro_fifo.timestamp_sample;
+
+		const int N = math::min((int)sensor_gyro_fifo.samples, (int)(sizeof(sensor_gyro_fifo.x) / sizeof(sensor_gyro_fifo.x[0])));
+
+		for (int n = 0; n < N; n++) {
+			_buffer[0][_buffer_index] = sensor_gyro_fifo.x[n];
+			_buffer[1][_buffer_index] = sensor_gyro_fifo.y[n];
+			_buffer[2][_buffer_index] = sensor_gyro_fifo.z[n];
+			_buffer_index++;
+
+			if (_buffer_index >= _fft_length) {
+				_sensor_gyro_fft.device_id = sensor_gyro_fifo.device_id;
+				_sensor_gyro_fft.timestamp_sample = sensor_gyro_fifo.timestamp_sample;
+				_sensor_gyro_fft.sensor_sample_rate_hz = 1e6f / _fifo_dt;
+				_sensor_gyro_fft.resolution_hz = _sensor_gyro_fft.sensor_sample_rate_hz / _fft_length;
+
+				Analyse(0, _sensor_gyro_fft.peak_frequencies_x, _sensor_gyro_fft.peak_snr_x);
+				Analyse(1, _sensor_gyro_fft.peak_frequencies_y, _sensor_gyro_fft.peak_snr_y);
+				Analyse(2, _sensor_gyro_fft.peak_frequencies_z, _sensor_gyro_fft.peak_snr_z);
+
+				_sensor_gyro_fft.timestamp = hrt_absolute_time();
+				_sensor_gyro_fft_pub.publish(_sensor_gyro_fft);
+
+				_buffer_index = 0;
+			}
+		}
+	}
+
+	perf_end(_cycle_perf);
+}
+
+int GyroFFT::task_spawn(int argc, char *argv[])
+{
+	GyroFFT *instance = new GyroFFT();
+
+	if (instance) {
+		_object.store(instance);
+		_task_id = task_id_is_work_queue;
+
+		if (instance->init()) {
+			return PX4_OK;
+		}
+
+	} else {
+		PX4_ERR("alloc failed");
+	}
+
+	delete instance;
+	_object.store(nullptr);
+	_task_id = -1;
+
+	return PX4_ERROR;
+}
+
+int GyroFFT::custom_command(int argc, char *argv[])
+{
+	return print_usage("unknown command");
+}
+
+int GyroFFT::print_status()
+{
+	PX4_INFO("selected sensor: %d (%d), FFT length: %d", _selected_sensor_device_id, _selected_sensor_sub_index,
+		 _fft_length);
+
+	if (_sensor_gyro_fft.timestamp != 0) {
+		PX4_INFO("sample rate: %.1f Hz, resolution: %.1f Hz", (double)_sensor_gyro_fft.sensor_sample_rate_hz,
+			 (double)_sensor_gyro_fft.resolution_hz);
+
+		const float *peaks[3] {_sensor_gyro_fft.peak_frequencies_x, _sensor_gyro_fft.peak_frequencies_y, _sensor_gyro_fft.peak_frequencies_z};
+		const float *snr[3] {_sensor_gyro_fft.peak_snr_x, _sensor_gyro_fft.peak_snr_y, _sensor_gyro_fft.peak_snr_z};
+		const char axis_names[3] {'x', 'y', 'z'};
+
+		for (int axis = 0; axis < 3; axis++) {
+			PX4_INFO("%c peaks: %.1f Hz (%.1f dB), %.1f Hz (%.1f dB), %.1f Hz (%.1f dB)", axis_names[axis],
+				 (double)peaks[axis][0], (double)snr[axis][0], (double)peaks[axis][1], (double)snr[axis][1],
+				 (double)peaks[axis][2], (double)snr[axis][2]);
+		}
+	}
+
+	perf_print_counter(_cycle_perf);
+	perf_print_counter(_fft_perf);
+	perf_print_counter(_gap_perf);
+
+	return 0;
+}
+
+int GyroFFT::print_usage(const char *reason)
+{
+	if (reason) {
+		PX4_WARN("%s\n", reason);
+	}
+
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+Spectrum analysis of the selected gyro. The raw samples of `sensor_gyro_fifo` are collected at the full FIFO rate,
+windowed (Hann) and transformed with a real FFT of IMU_GYRO_FFT_LEN points. The strongest peaks per axis within
+IMU_GYRO_FFT_MIN and IMU_GYRO_FFT_MAX are published as `sensor_gyro_fft`, together with their signal to noise ratio.
+
+The output can be used by the dynamic notch filters (IMU_GYRO_DNF_EN) and for vibration analysis without
+high-rate logging.
+
+### Implementation
+The module runs on the low priority work queue, scheduled on `sensor_gyro_fifo` publications of the selected gyro.
+The analysis window is restarted if FIFO data was missed.
+
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME("gyro_fft", "system");
+	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
+
+	return 0;
+}
+
+extern "C" __EXPORT int gyro_fft_main(int argc, char *argv[])
+{
+	return GyroFFT::main(argc, argv);
+}
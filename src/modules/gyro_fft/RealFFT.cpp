@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "RealFFT.hpp"
+
+#include <px4_platform_common/defines.h>
+#include <math.h>
+
+RealFFT::~RealFFT()
+{
+	delete[] _cos;
+	delete[] _sin;
+}
+
+bool RealFFT::init(int length)
+{
+	if ((length < 16) || ((length & (length - 1)) != 0)) {
+		return false;
+	}
+
+	delete[] _cos;
+	delete[] _sin;
+
+	_cos = new float[length / 2];
+	_sin = new float[length / 2];
+
+	if ((_cos == nullptr) || (_sin == nullptr)) {
+		delete[] _cos;
+		delete[] _sin;
+		_cos = nullptr;
+		_sin = nullptr;
+		_length = 0;
+		return false;
+	}
+
+	for (int k = 0; k < length / 2; k++) {
+		_cos[k] = cosf(2.f * M_PI_F * k / length);
+		_sin[k] = sinf(2.f * M_PI_F * k / length);
+	}
+
+	_length = length;
+	return true;
+}
+
+void RealFFT::transform(float data[]) const
+{
+	// complex FFT of M = N/2 points, data holds interleaved re, im pairs
+	const int M = _length / 2;
+
+	// bit reversal permutation
+	for (int i = 1, j = 0; i < M; i++) {
+		int bit = M >> 1;
+
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+
+		j ^= bit;
+
+		if (i < j) {
+			float tmp = data[2 * i];
+			data[2 * i] = data[2 * j];
+			data[2 * j] = tmp;
+
+			tmp = data[2 * i + 1];
+			data[2 * i + 1] = data[2 * j + 1];
+			data[2 * j + 1] = tmp;
+		}
+	}
+
+	// butterflies, twiddle W_M^j = W_N^(2j) = exp(-i 2 pi j N / len / N)
+	for (int len = 2; len <= M; len <<= 1) {
+		const int half = len / 2;
+		const int step = _length / len;
+
+		for (int i = 0; i < M; i += len) {
+			for (int j = 0; j < half; j++) {
+				const float wr = _cos[j * step];
+				const float wi = -_sin[j * step];
+
+				float *u = &data[2 * (i + j)];
+				float *v = &data[2 * (i + j + half)];
+
+				const float vr = v[0] * wr - v[1] * wi;
+				const float vi = v[0] * wi + v[1] * wr;
+
+				v[0] = u[0] - vr;
+				v[1] = u[1] - vi;
+				u[0] += vr;
+				u[1] += vi;
+			}
+		}
+	}
+}
+
+void RealFFT::powerSpectrum(float data[], float power[]) const
+{
+	if (_length == 0) {
+		return;
+	}
+
+	transform(data);
+
+	const int M = _length / 2;
+
+	// DC and Nyquist
+	power[0] = (data[0] + data[1]) * (data[0] + data[1]);
+	power[M] = (data[0] - data[1]) * (data[0] - data[1]);
+
+	// X[k] = E[k] + W_N^k O[k], E = (Z[k] + conj(Z[M-k])) / 2, O = -i (Z[k] - conj(Z[M-k])) / 2
+	for (int k = 1; k < M; k++) {
+		const float ar = data[2 * k];
+		const float ai = data[2 * k + 1];
+		const float br = data[2 * (M - k)];
+		const float bi = -data[2 * (M - k) + 1];
+
+		const float er = 0.5f * (ar + br);
+		const float ei = 0.5f * (ai + bi);
+		const float or_ = 0.5f * (ai - bi);
+		const float oi = -0.5f * (ar - br);
+
+		const float wr = _cos[k];
+		const float wi = -_sin[k];
+
+		const float xr = er + (wr * or_ - wi * oi);
+		const float xi = ei + (wr * oi + wi * or_);
+
+		power[k] = xr * xr + xi * xi;
+	}
+}
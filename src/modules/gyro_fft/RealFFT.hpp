@@ -0,0 +1,75 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file RealFFT.hpp
+ *
+ * Power spectrum of a real signal. The N real samples are packed into N/2 complex
+ * values, transformed with an in-place iterative radix-2 FFT and then split into
+ * the spectrum of the real input.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class RealFFT
+{
+public:
+	RealFFT() = default;
+	~RealFFT();
+
+	/**
+	 * Allocate the twiddle tables
+	 * @param length FFT length, power of 2 (>= 16)
+	 * @return false on invalid length or allocation failure
+	 */
+	bool init(int length);
+
+	int length() const { return _length; }
+
+	/**
+	 * Compute the power spectrum |X[k]|^2, k = 0 ... length/2
+	 * @param data input samples (length), it is used as work buffer and overwritten
+	 * @param power output (length / 2 + 1)
+	 */
+	void powerSpectrum(float data[], float power[]) const;
+
+private:
+	void transform(float data[]) const;
+
+	int _length{0};
+
+	float *_cos{nullptr}; // cos(2 pi k / N), k = 0 ... N/2 - 1
+	float *_sin{nullptr}; // sin(2 pi k / N), k = 0 ... N/2 - 1
+};
@@ -58,11 +58,35 @@ LandDetector::~LandDetector()
 void LandDetector::start()
 {
 	_update_params();
-	ScheduleOnInterval(LAND_DETECTOR_UPDATE_INTERVAL);
+
+	if (!_register_callbacks()) {
+		PX4_ERR("callback registration failed");
+	}
+
+	ScheduleNow();
+}
+
+bool LandDetector::_register_callbacks()
+{
+	// the land state only changes with new inputs: update on a new position estimate, but not faster than the interval
+	_vehicle_local_position_sub.set_interval_us(LAND_DETECTOR_UPDATE_INTERVAL);
+	return _vehicle_local_position_sub.registerCallback();
+}
+
+void LandDetector::_unregister_callbacks()
+{
+	_vehicle_local_position_sub.unregisterCallback();
 }
 
 void LandDetector::Run()
 {
+	if (should_exit()) {
+		_unregister_callbacks();
+		ScheduleClear();
+		exit_and_cleanup();
+		return;
+	}
+
 	perf_begin(_cycle_perf);
 
 	if (_parameter_update_sub.updated()) {
@@ -128,10 +152,8 @@ void LandDetector::Run()
 
 	perf_end(_cycle_perf);
 
-	if (should_exit()) {
-		ScheduleClear();
-		exit_and_cleanup();
-	}
+	// fallback if no callback triggers the next update, rescheduled on every run
+	ScheduleDelayed(LAND_DETECTOR_TIMEOUT);
 }
 
 void LandDetector::_update_params()
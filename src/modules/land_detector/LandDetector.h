@@ -56,6 +56,7 @@
 #include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
 #include <uORB/Publication.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/topics/actuator_armed.h>
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/vehicle_acceleration.h>
@@ -88,7 +89,7 @@ public:
 	int print_status() override;
 
 	/**
-	 * Get the work queue going.
+	 * Register the callbacks and run the first update.
 	 */
 	void start();
 
@@ -106,6 +107,13 @@ protected:
 	 */
 	virtual void _update_topics();
 
+	/**
+	 * Registers the callbacks of the topics that trigger an update, derived classes add their own.
+	 * @return true on success
+	 */
+	virtual bool _register_callbacks();
+	virtual void _unregister_callbacks();
+
 	/**
 	 * @return true if UAV is in a landed state.
 	 */
@@ -136,9 +144,12 @@ protected:
 	 */
 	virtual bool _get_ground_effect_state() { return false; }
 
-	/** Run main land detector loop at this interval. */
+	/** Minimum interval between updates triggered by a topic callback. */
 	static constexpr uint32_t LAND_DETECTOR_UPDATE_INTERVAL = 20_ms;
 
+	/** Update at this interval if no topic triggers an update (no estimator), also keeps the 1 Hz publication. */
+	static constexpr uint32_t LAND_DETECTOR_TIMEOUT = 500_ms;
+
 	systemlib::Hysteresis _freefall_hysteresis{false};
 	systemlib::Hysteresis _landed_hysteresis{true};
 	systemlib::Hysteresis _maybe_landed_hysteresis{true};
@@ -179,7 +190,7 @@ private:
 	uORB::Subscription _actuator_armed_sub{ORB_ID(actuator_armed)};
 	uORB::Subscription _parameter_update_sub{ORB_ID(parameter_update)};
 	uORB::Subscription _vehicle_acceleration_sub{ORB_ID(vehicle_acceleration)};
-	uORB::Subscription _vehicle_local_position_sub{ORB_ID(vehicle_local_position)};
+	uORB::SubscriptionCallbackWorkItem _vehicle_local_position_sub{this, ORB_ID(vehicle_local_position)};
 
 	DEFINE_PARAMETERS_CUSTOM_PARENT(
 		ModuleParams,
@@ -84,6 +84,19 @@ MulticopterLandDetector::MulticopterLandDetector()
 	_maybe_landed_hysteresis.set_hysteresis_time_from(false, MAYBE_LAND_DETECTOR_TRIGGER_TIME_US);
 }
 
+bool MulticopterLandDetector::_register_callbacks()
+{
+	// thrust changes (eg. throttle down on the ground) trigger an update without waiting for the position estimate
+	_actuator_controls_sub.set_interval_us(LAND_DETECTOR_UPDATE_INTERVAL);
+	return LandDetector::_register_callbacks() && _actuator_controls_sub.registerCallback();
+}
+
+void MulticopterLandDetector::_unregister_callbacks()
+{
+	_actuator_controls_sub.unregisterCallback();
+	LandDetector::_unregister_callbacks();
+}
+
 void MulticopterLandDetector::_update_topics()
 {
 	LandDetector::_update_topics();
@@ -135,7 +135,8 @@ position controller sets the thrust setpoint to zero.
 
 **landed**: it requires maybe_landed to be true for time LAND_DETECTOR_TRIGGER_TIME_US.
 
-The module runs periodically on the HP work queue.
+The module runs on the HP work queue, triggered by vehicle_local_position (and actuator_controls_0 on multicopters)
+at up to 50 Hz, with a 2 Hz fallback if these topics are not published.
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("land_detector", "system");
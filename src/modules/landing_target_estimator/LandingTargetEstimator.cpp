@@ -106,6 +106,15 @@ void LandingTargetEstimator::update()
 	// mark this sensor measurement as consumed
 	_new_irlockReport = false;
 
+	// use the vehicle state at the time of the measurement if the estimator provides it
+	if (state_history::attitude_at(_irlockReport.timestamp, _vehicleAttitude)) {
+		_vehicleAttitude_valid = true;
+	}
+
+	if (state_history::local_position_at(_irlockReport.timestamp, _vehicleLocalPosition)) {
+		_vehicleLocalPosition_valid = true;
+	}
+
 	if (!_vehicleAttitude_valid || !_vehicleLocalPosition_valid || !_vehicleLocalPosition.dist_bottom_valid) {
 		// don't have the data needed for an update
 		return;
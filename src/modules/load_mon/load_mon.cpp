@@ -40,6 +40,7 @@
  */
 
 #include <drivers/drv_hrt.h>
+#include <lib/mathlib/mathlib.h>
 #include <lib/perf/perf_counter.h>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/defines.h>
@@ -49,13 +50,20 @@
 #include <systemlib/cpuload.h>
 #include <uORB/Publication.hpp>
 #include <uORB/PublicationQueued.hpp>
+#include <uORB/topics/cpu_profile.h>
 #include <uORB/topics/cpuload.h>
 #include <uORB/topics/task_stack_info.h>
+#include <uORB/topics/work_queue_status.h>
 
 #if defined(__PX4_NUTTX) && !defined(CONFIG_SCHED_INSTRUMENTATION)
 #  error load_mon support requires CONFIG_SCHED_INSTRUMENTATION
 #endif
 
+#if defined(__PX4_NUTTX) && defined(CONFIG_ARCH_ARMV7M)
+#  include <up_internal.h> // CURRENT_REGS
+#  define PROFILE_PC_AVAILABLE
+#endif
+
 #define STACK_LOW_WARNING_THRESHOLD 300 ///< if free stack space falls below this, print a warning
 #define FDS_LOW_WARNING_THRESHOLD 3 ///< if free file descriptors fall below this, print a warning
 
@@ -84,6 +92,9 @@ public:
 	/** @see ModuleBase */
 	static int print_usage(const char *reason = nullptr);
 
+	/** @see ModuleBase::print_status() */
+	int print_status() override;
+
 	void start();
 
 private:
@@ -93,6 +104,9 @@ private:
 	/** Do a calculation of the CPU load and publish it. */
 	void _cpuload();
 
+	/** Publish the run time statistics of all work queues. */
+	void _work_queue_status();
+
 	/** Calculate the memory usage */
 	float _ram_used();
 
@@ -102,16 +116,74 @@ private:
 
 	int _stack_task_index{0};
 	uORB::PublicationQueued<task_stack_info_s> _task_stack_info_pub{ORB_ID(task_stack_info)};
+
+	/*
+	 * Sampling profiler: the HRT interrupt records the running task (and its program counter) at
+	 * SYS_CPU_PROF_HZ, the result is published once per cycle on cpu_profile.
+	 */
+	static constexpr int PROFILE_LOAD_BINS = 11;		///< bin 0: not running in a window, bin n: load in ((n-1)/10, n/10]
+	static constexpr int PROFILE_PC_SAMPLES = 256;		///< number of latest program counter samples kept per cycle
+	static constexpr int PROFILE_WINDOWS_PER_SECOND = 10;	///< 100 ms windows for the load percentiles
+
+	struct profile_task_s {
+		pid_t pid;
+		uint32_t samples;
+		uint16_t window_samples;
+		uint16_t window_max;				///< maximum number of samples in a window
+		uint16_t load_hist[PROFILE_LOAD_BINS];		///< windows per load bin, bin 0 is implicit (windows - sum)
+	};
+
+	struct profile_pc_s {
+		uintptr_t pc;
+		pid_t pid;
+	};
+
+	struct profile_data_s {
+		uint32_t samples;
+		uint32_t windows;
+		uint16_t window_samples;
+		uint16_t window_busy;				///< samples of a task other than idle in the window
+		uint16_t busy_hist[PROFILE_LOAD_BINS];
+		profile_task_s tasks[CONFIG_MAX_TASKS];		///< indexed by pid, which is unique for all living tasks
+		profile_pc_s pc[PROFILE_PC_SAMPLES];
+		uint16_t pc_head;
+		uint16_t pc_count;
+	};
+
+	static void _profile_sample_trampoline(void *arg) { static_cast<LoadMon *>(arg)->_profile_sample(); }
+
+	/** Take a sample, called from the HRT interrupt. */
+	void _profile_sample();
+
+	/** Swap the sample buffers and publish the profile of every task that was running. */
+	void _profile_publish();
+
+	void _profile_bin(uint16_t *hist, uint16_t window_samples);
+	float _profile_percentile(const uint16_t *hist, uint32_t windows, float percentile);
+
+	struct hrt_call _profile_call {};
+	profile_data_s *_profile{nullptr};			///< written by the HRT interrupt
+	profile_data_s *_profile_spare{nullptr};
+	uint16_t _profile_window_len{0};			///< samples per window
+
+	cpu_profile_s _profile_last[cpu_profile_s::ORB_QUEUE_LENGTH] {};
+	int _profile_last_count{0};
+	float _profile_load_p95{NAN};
+
+	uORB::PublicationQueued<cpu_profile_s> _cpu_profile_pub{ORB_ID(cpu_profile)};
 #endif
 
 	DEFINE_PARAMETERS(
-		(ParamBool<px4::params::SYS_STCK_EN>) _param_sys_stck_en
+		(ParamBool<px4::params::SYS_STCK_EN>) _param_sys_stck_en,
+		(ParamBool<px4::params::SYS_WQ_STAT_EN>) _param_sys_wq_stat_en,
+		(ParamInt<px4::params::SYS_CPU_PROF_HZ>) _param_sys_cpu_prof_hz
 	)
 
 	uORB::Publication<cpuload_s>  _cpuload_pub{ORB_ID(cpuload)};
+	uORB::PublicationQueued<work_queue_status_s> _work_queue_status_pub{ORB_ID(work_queue_status)};
 
-	hrt_abstime _last_idle_time{0};
-	hrt_abstime _last_idle_time_sample{0};
+	uint64_t _last_busy_time_ns{0};
+	hrt_abstime _last_busy_time_sample{0};
 
 	perf_counter_t _stack_perf;
 };
@@ -127,6 +199,12 @@ LoadMon::~LoadMon()
 {
 	ScheduleClear();
 
+#ifdef __PX4_NUTTX
+	hrt_cancel(&_profile_call);
+	delete _profile;
+	delete _profile_spare;
+#endif
+
 	perf_free(_stack_perf);
 }
 
@@ -151,11 +229,42 @@ int LoadMon::task_spawn(int argc, char *argv[])
 void
 LoadMon::start()
 {
+#ifdef __PX4_NUTTX
+	const int32_t profile_rate = _param_sys_cpu_prof_hz.get();
+
+	if (profile_rate > 0) {
+		const int32_t rate = math::constrain(profile_rate, (int32_t)100, (int32_t)2000);
+		_profile = new profile_data_s{};
+		_profile_spare = new profile_data_s{};
+
+		if (_profile && _profile_spare) {
+			_profile_window_len = rate / PROFILE_WINDOWS_PER_SECOND;
+			hrt_call_every(&_profile_call, 1000000 / rate, 1000000 / rate, &LoadMon::_profile_sample_trampoline, this);
+
+		} else {
+			PX4_ERR("profiler alloc failed");
+			delete _profile;
+			delete _profile_spare;
+			_profile = nullptr;
+			_profile_spare = nullptr;
+		}
+	}
+
+#endif
+
 	ScheduleOnInterval(LOAD_MON_INTERVAL_US);
 }
 
 void LoadMon::Run()
 {
+#ifdef __PX4_NUTTX
+
+	if (_profile) {
+		_profile_publish();
+	}
+
+#endif
+
 	_cpuload();
 
 #ifdef __PX4_NUTTX
@@ -166,6 +275,10 @@ void LoadMon::Run()
 
 #endif
 
+	if (_param_sys_wq_stat_en.get()) {
+		_work_queue_status();
+	}
+
 	if (should_exit()) {
 		ScheduleClear();
 		exit_and_cleanup();
@@ -174,28 +287,59 @@ void LoadMon::Run()
 
 void LoadMon::_cpuload()
 {
-	if (_last_idle_time == 0) {
+	const uint64_t busy_time_ns = cpuload_busy_time_ns();
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (_last_busy_time_sample == 0) {
 		/* Just get the time in the first iteration */
-		_last_idle_time = system_load.tasks[0].total_runtime;
+		_last_busy_time_ns = busy_time_ns;
+		_last_busy_time_sample = now;
 		return;
 	}
 
-	/* compute system load */
-	const hrt_abstime total_runtime = system_load.tasks[0].total_runtime;
-	const hrt_abstime interval = hrt_elapsed_time(&_last_idle_time_sample);
-	const hrt_abstime interval_idletime = total_runtime - _last_idle_time;
+	/* compute system load: busy time of all CPUs over the interval */
+	const hrt_abstime interval = now - _last_busy_time_sample;
+	const uint64_t interval_busy_time_ns = busy_time_ns - _last_busy_time_ns;
+
+	_last_busy_time_ns = busy_time_ns;
+	_last_busy_time_sample = now;
 
-	_last_idle_time = total_runtime;
-	_last_idle_time_sample = hrt_absolute_time();
+	if (interval == 0) {
+		return;
+	}
 
 	cpuload_s cpuload{};
-	cpuload.load = 1.0f - (float)interval_idletime / (float)interval;
+	cpuload.load = math::constrain((float)interval_busy_time_ns / (1000.f * interval * cpuload_cpu_count()), 0.f, 1.f);
+#ifdef __PX4_NUTTX
+	cpuload.load_p95 = _profile_load_p95;
+#else
+	cpuload.load_p95 = NAN;
+#endif
 	cpuload.ram_usage = _ram_used();
 	cpuload.timestamp = hrt_absolute_time();
 
 	_cpuload_pub.publish(cpuload);
 }
 
+void LoadMon::_work_queue_status()
+{
+	px4::wq_status_t status[work_queue_status_s::ORB_QUEUE_LENGTH];
+	const int count = px4::WorkQueueManagerGetStatus(status, work_queue_status_s::ORB_QUEUE_LENGTH);
+
+	for (int i = 0; i < count; i++) {
+		work_queue_status_s work_queue_status{};
+		strncpy(work_queue_status.name, status[i].name, sizeof(work_queue_status.name) - 1);
+		work_queue_status.num_items = status[i].num_items;
+		work_queue_status.run_count = status[i].run_count;
+		work_queue_status.deadline_misses = status[i].deadline_misses;
+		work_queue_status.run_time_max_us = status[i].run_time_max;
+		work_queue_status.utilization = status[i].utilization;
+		work_queue_status.timestamp = hrt_absolute_time();
+
+		_work_queue_status_pub.publish(work_queue_status);
+	}
+}
+
 float LoadMon::_ram_used()
 {
 #ifdef __PX4_NUTTX
@@ -302,8 +446,213 @@ void LoadMon::_stack_usage()
 	/* Continue after last checked task next cycle. */
 	_stack_task_index = task_index + 1;
 }
+
+void LoadMon::_profile_sample()
+{
+	profile_data_s &p = *_profile;
+	const pid_t pid = sched_self()->pid;
+	profile_task_s &task = p.tasks[pid & (CONFIG_MAX_TASKS - 1)];
+
+	if (task.pid != pid) {
+		// the previous task in this slot exited
+		task = {};
+		task.pid = pid;
+	}
+
+	task.samples++;
+	task.window_samples++;
+	p.samples++;
+
+	if (pid != 0) {
+		p.window_busy++;
+	}
+
+#if defined(PROFILE_PC_AVAILABLE)
+
+	// CURRENT_REGS are the registers of the interrupted task
+	if (CURRENT_REGS) {
+		p.pc[p.pc_head] = {CURRENT_REGS[REG_PC], pid};
+		p.pc_head = (p.pc_head + 1) % PROFILE_PC_SAMPLES;
+
+		if (p.pc_count < PROFILE_PC_SAMPLES) {
+			p.pc_count++;
+		}
+	}
+
 #endif
 
+	if (++p.window_samples >= _profile_window_len) {
+		_profile_bin(p.busy_hist, p.window_busy);
+
+		for (profile_task_s &t : p.tasks) {
+			if (t.window_samples > 0) {
+				_profile_bin(t.load_hist, t.window_samples);
+				t.window_max = math::max(t.window_max, t.window_samples);
+				t.window_samples = 0;
+			}
+		}
+
+		p.window_samples = 0;
+		p.window_busy = 0;
+		p.windows++;
+	}
+}
+
+void LoadMon::_profile_bin(uint16_t *hist, uint16_t window_samples)
+{
+	if (window_samples > 0) {
+		const int bin = 1 + (window_samples - 1) * (PROFILE_LOAD_BINS - 1) / _profile_window_len;
+		hist[math::min(bin, PROFILE_LOAD_BINS - 1)]++;
+	}
+}
+
+float LoadMon::_profile_percentile(const uint16_t *hist, uint32_t windows, float percentile)
+{
+	if (windows == 0) {
+		return NAN;
+	}
+
+	uint32_t running = 0;
+
+	for (int i = 1; i < PROFILE_LOAD_BINS; i++) {
+		running += hist[i];
+	}
+
+	const uint32_t target = ceilf(percentile * windows);
+	uint32_t cumulative = windows - running;
+
+	for (int i = 0; i < PROFILE_LOAD_BINS; i++) {
+		if (i > 0) {
+			cumulative += hist[i];
+		}
+
+		if (cumulative >= target) {
+			return (float)i / (PROFILE_LOAD_BINS - 1);
+		}
+	}
+
+	return 1.f;
+}
+
+void LoadMon::_profile_publish()
+{
+	// restart with a cleared buffer, the partial window is dropped
+	memset(_profile_spare, 0, sizeof(profile_data_s));
+
+	irqstate_t flags = px4_enter_critical_section();
+	profile_data_s *p = _profile;
+	_profile = _profile_spare;
+	_profile_spare = p;
+	px4_leave_critical_section(flags);
+
+	_profile_load_p95 = _profile_percentile(p->busy_hist, p->windows, 0.95f);
+
+	if (p->samples == 0) {
+		return;
+	}
+
+	// keep the tasks with the most samples
+	int order[cpu_profile_s::ORB_QUEUE_LENGTH];
+	int count = 0;
+
+	for (int i = 0; i < CONFIG_MAX_TASKS; i++) {
+		if (p->tasks[i].samples == 0) {
+			continue;
+		}
+
+		int pos = count;
+
+		while (pos > 0 && p->tasks[order[pos - 1]].samples < p->tasks[i].samples) {
+			if (pos < cpu_profile_s::ORB_QUEUE_LENGTH) {
+				order[pos] = order[pos - 1];
+			}
+
+			pos--;
+		}
+
+		if (pos < cpu_profile_s::ORB_QUEUE_LENGTH) {
+			order[pos] = i;
+			count = math::min(count + 1, (int)cpu_profile_s::ORB_QUEUE_LENGTH);
+		}
+	}
+
+	const hrt_abstime now = hrt_absolute_time();
+
+	for (int i = 0; i < count; i++) {
+		const profile_task_s &task = p->tasks[order[i]];
+		cpu_profile_s &profile = _profile_last[i];
+		profile = {};
+
+		profile.samples = task.samples;
+		profile.samples_total = p->samples;
+		profile.pid = task.pid;
+		profile.load = (float)task.samples / p->samples;
+		profile.load_p50 = _profile_percentile(task.load_hist, p->windows, 0.5f);
+		profile.load_p95 = _profile_percentile(task.load_hist, p->windows, 0.95f);
+		profile.load_max = (float)task.window_max / _profile_window_len;
+
+		// latest program counters of the task
+		int num_pc = 0;
+
+		for (int k = 1; k <= p->pc_count && num_pc < (int)(sizeof(profile.pc) / sizeof(profile.pc[0])); k++) {
+			const profile_pc_s &sample = p->pc[(p->pc_head + PROFILE_PC_SAMPLES - k) % PROFILE_PC_SAMPLES];
+
+			if (sample.pid == task.pid) {
+				profile.pc[num_pc++] = sample.pc;
+			}
+		}
+	}
+
+	// the task may have exited in the meantime, which leaves the name empty
+	sched_lock();
+
+	for (int i = 0; i < count; i++) {
+		for (int t = 0; t < CONFIG_MAX_TASKS; t++) {
+			if (system_load.tasks[t].valid && system_load.tasks[t].tcb->pid == _profile_last[i].pid) {
+				static_assert(sizeof(_profile_last[i].task_name) == CONFIG_TASK_NAME_SIZE,
+					      "cpu_profile.task_name must match NuttX CONFIG_TASK_NAME_SIZE");
+				strncpy(_profile_last[i].task_name, system_load.tasks[t].tcb->name, CONFIG_TASK_NAME_SIZE - 1);
+				break;
+			}
+		}
+	}
+
+	sched_unlock();
+
+	for (int i = 0; i < count; i++) {
+		_profile_last[i].timestamp = now;
+		_cpu_profile_pub.publish(_profile_last[i]);
+	}
+
+	_profile_last_count = count;
+}
+#endif
+
+int LoadMon::print_status()
+{
+#ifdef __PX4_NUTTX
+
+	if (_profile) {
+		PX4_INFO("sampling profiler: %.0f Hz, load p95: %.1f%%",
+			 (double)(_profile_window_len * PROFILE_WINDOWS_PER_SECOND), (double)(_profile_load_p95 * 100.f));
+		PX4_INFO_RAW(" PID %-24s  LOAD    P50    P95    MAX   LAST PC\n", "COMMAND");
+
+		for (int i = 0; i < _profile_last_count; i++) {
+			const cpu_profile_s &profile = _profile_last[i];
+			PX4_INFO_RAW("%4d %-24s %5.1f%% %5.0f%% %5.0f%% %5.0f%%  0x%08x\n", (int)profile.pid, profile.task_name,
+				     (double)(profile.load * 100.f), (double)(profile.load_p50 * 100.f), (double)(profile.load_p95 * 100.f),
+				     (double)(profile.load_max * 100.f), (unsigned)profile.pc[0]);
+		}
+
+		return 0;
+	}
+
+#endif
+
+	PX4_INFO("running, sampling profiler disabled");
+	return 0;
+}
+
 int LoadMon::print_usage(const char *reason)
 {
 	if (reason) {
@@ -314,10 +663,18 @@ int LoadMon::print_usage(const char *reason)
 		R"DESCR_STR(
 ### Description
 Background process running periodically with 1 Hz on the LP work queue to calculate the CPU load and RAM
-usage and publish the `cpuload` topic.
+usage and publish the `cpuload` topic. If enabled with SYS_WQ_STAT_EN, the run time statistics of all work
+queues are published as `work_queue_status`.
 
 On NuttX it also checks the stack usage of each process and if it falls below 300 bytes, a warning is output,
 which will also appear in the log file.
+
+If SYS_CPU_PROF_HZ is set (NuttX only), a sampling profiler records the running task and its program counter
+from the HRT interrupt at the given rate. Once per second the tasks with the most samples are published on
+`cpu_profile` with their load, the 50th/95th percentile and maximum of their load in 100 ms windows and the
+latest sampled program counters (which can be resolved offline with addr2line). The 95th percentile of the
+system load is added to `cpuload`. The overhead is one short interrupt callout per sample.
+`load_mon status` shows the latest profile.
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("load_mon", "system");
@@ -38,3 +38,31 @@
  * @group System
  */
 PARAM_DEFINE_INT32(SYS_STCK_EN, 1);
+
+/**
+ * Enable work queue statistics
+ *
+ * If enabled, the run time statistics of every work queue (utilization,
+ * longest run, deadline misses) are published at 1 Hz on the
+ * work_queue_status topic.
+ *
+ * @boolean
+ * @group System
+ */
+PARAM_DEFINE_INT32(SYS_WQ_STAT_EN, 0);
+
+/**
+ * Sampling profiler rate
+ *
+ * Rate at which the HRT interrupt samples the running task and its program counter.
+ * The per-task load and its percentiles over 100 ms windows are published at 1 Hz
+ * on the cpu_profile topic. Set to 0 to disable, lower rates are raised to 100 Hz.
+ * NuttX only.
+ *
+ * @min 0
+ * @max 2000
+ * @unit Hz
+ * @reboot_required true
+ * @group System
+ */
+PARAM_DEFINE_INT32(SYS_CPU_PROF_HZ, 0);
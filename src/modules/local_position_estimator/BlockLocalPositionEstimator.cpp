@@ -141,6 +141,21 @@ BlockLocalPositionEstimator::BlockLocalPositionEstimator() :
 		 (_param_lpe_fusion.get() & FUSE_BARO) != 0);
 }
 
+BlockLocalPositionEstimator::~BlockLocalPositionEstimator()
+{
+	perf_free(_cycle_perf);
+	perf_free(_predict_perf);
+	perf_free(_gps_perf);
+	perf_free(_baro_perf);
+	perf_free(_lidar_perf);
+	perf_free(_sonar_perf);
+	perf_free(_flow_perf);
+	perf_free(_vision_perf);
+	perf_free(_mocap_perf);
+	perf_free(_land_perf);
+	perf_free(_landing_target_perf);
+}
+
 bool
 BlockLocalPositionEstimator::init()
 {
@@ -175,6 +190,8 @@ void BlockLocalPositionEstimator::Run()
 		return;
 	}
 
+	perf_begin(_cycle_perf);
+
 	uint64_t newTimeStamp = hrt_absolute_time();
 	float dt = (newTimeStamp - _timeStamp) / 1.0e6f;
 	_timeStamp = newTimeStamp;
@@ -402,7 +419,9 @@ void BlockLocalPositionEstimator::Run()
 	}
 
 	// do prediction
+	perf_begin(_predict_perf);
 	predict(imu);
+	perf_end(_predict_perf);
 
 	// sensor corrections/ initializations
 	if (_gpsUpdated) {
@@ -410,7 +429,9 @@ void BlockLocalPositionEstimator::Run()
 			gpsInit();
 
 		} else {
+			perf_begin(_gps_perf);
 			gpsCorrect();
+			perf_end(_gps_perf);
 		}
 	}
 
@@ -419,7 +440,9 @@ void BlockLocalPositionEstimator::Run()
 			baroInit();
 
 		} else {
+			perf_begin(_baro_perf);
 			baroCorrect();
+			perf_end(_baro_perf);
 		}
 	}
 
@@ -428,7 +451,9 @@ void BlockLocalPositionEstimator::Run()
 			lidarInit();
 
 		} else {
+			perf_begin(_lidar_perf);
 			lidarCorrect();
+			perf_end(_lidar_perf);
 		}
 	}
 
@@ -437,7 +462,9 @@ void BlockLocalPositionEstimator::Run()
 			sonarInit();
 
 		} else {
+			perf_begin(_sonar_perf);
 			sonarCorrect();
+			perf_end(_sonar_perf);
 		}
 	}
 
@@ -446,7 +473,9 @@ void BlockLocalPositionEstimator::Run()
 			flowInit();
 
 		} else {
+			perf_begin(_flow_perf);
 			flowCorrect();
+			perf_end(_flow_perf);
 		}
 	}
 
@@ -455,7 +484,9 @@ void BlockLocalPositionEstimator::Run()
 			visionInit();
 
 		} else {
+			perf_begin(_vision_perf);
 			visionCorrect();
+			perf_end(_vision_perf);
 		}
 	}
 
@@ -464,7 +495,9 @@ void BlockLocalPositionEstimator::Run()
 			mocapInit();
 
 		} else {
+			perf_begin(_mocap_perf);
 			mocapCorrect();
+			perf_end(_mocap_perf);
 		}
 	}
 
@@ -473,7 +506,9 @@ void BlockLocalPositionEstimator::Run()
 			landInit();
 
 		} else {
+			perf_begin(_land_perf);
 			landCorrect();
+			perf_end(_land_perf);
 		}
 	}
 
@@ -482,7 +517,9 @@ void BlockLocalPositionEstimator::Run()
 			landingTargetInit();
 
 		} else {
+			perf_begin(_landing_target_perf);
 			landingTargetCorrect();
+			perf_end(_landing_target_perf);
 		}
 	}
 
@@ -512,6 +549,8 @@ void BlockLocalPositionEstimator::Run()
 		_xDelay.update(_x);
 		_time_last_hist = _timeStamp;
 	}
+
+	perf_end(_cycle_perf);
 }
 
 void BlockLocalPositionEstimator::checkTimeouts()
@@ -998,6 +1037,23 @@ BlockLocalPositionEstimator::custom_command(int argc, char *argv[])
 	return print_usage("unknown command");
 }
 
+int
+BlockLocalPositionEstimator::print_status()
+{
+	perf_print_counter(_cycle_perf);
+	perf_print_counter(_predict_perf);
+	perf_print_counter(_gps_perf);
+	perf_print_counter(_baro_perf);
+	perf_print_counter(_lidar_perf);
+	perf_print_counter(_sonar_perf);
+	perf_print_counter(_flow_perf);
+	perf_print_counter(_vision_perf);
+	perf_print_counter(_mocap_perf);
+	perf_print_counter(_land_perf);
+	perf_print_counter(_landing_target_perf);
+	return 0;
+}
+
 int
 BlockLocalPositionEstimator::task_spawn(int argc, char *argv[])
 {
@@ -7,6 +7,7 @@
 #include <lib/controllib/blocks.hpp>
 #include <lib/ecl/geo/geo.h>
 #include <lib/mathlib/mathlib.h>
+#include <lib/perf/perf_counter.h>
 #include <matrix/Matrix.hpp>
 
 // uORB Subscriptions
@@ -111,7 +112,7 @@ class BlockLocalPositionEstimator : public ModuleBase<BlockLocalPositionEstimato
 public:
 
 	BlockLocalPositionEstimator();
-	~BlockLocalPositionEstimator() override = default;
+	~BlockLocalPositionEstimator() override;
 
 	/** @see ModuleBase */
 	static int task_spawn(int argc, char *argv[]);
@@ -122,6 +123,9 @@ public:
 	/** @see ModuleBase */
 	static int print_usage(const char *reason = nullptr);
 
+	/** @see ModuleBase::print_status() */
+	int print_status() override;
+
 	bool init();
 
 private:
@@ -241,6 +245,77 @@ private:
 	// timeouts
 	void checkTimeouts();
 
+	// kalman filter correction
+	//
+	// The measurement matrices C only select (at most two) states, so P * C^T is
+	// built from the non-zero entries of C instead of full matrix products.
+
+	// P * C^T
+	template<size_t n_y>
+	Matrix<float, n_x, n_y> covarianceTimesCT(const Matrix<float, n_y, n_x> &C) const
+	{
+		Matrix<float, n_x, n_y> PCt;
+		PCt.setZero();
+
+		for (size_t j = 0; j < n_y; j++) {
+			for (size_t k = 0; k < n_x; k++) {
+				const float c = C(j, k);
+
+				if (c != 0.f) {
+					for (size_t i = 0; i < n_x; i++) {
+						PCt(i, j) += m_P(i, k) * c;
+					}
+				}
+			}
+		}
+
+		return PCt;
+	}
+
+	// residual covariance S = C * P * C^T + R
+	template<size_t n_y>
+	Matrix<float, n_y, n_y> residualCovariance(const Matrix<float, n_y, n_x> &C, const Matrix<float, n_x, n_y> &PCt,
+			const Matrix<float, n_y, n_y> &R) const
+	{
+		Matrix<float, n_y, n_y> S{R};
+
+		for (size_t i = 0; i < n_y; i++) {
+			for (size_t k = 0; k < n_x; k++) {
+				const float c = C(i, k);
+
+				if (c != 0.f) {
+					for (size_t j = 0; j < n_y; j++) {
+						S(i, j) += c * PCt(k, j);
+					}
+				}
+			}
+		}
+
+		return S;
+	}
+
+	// x += K * r, P -= K * C * P with K = P * C^T * S^-1
+	template<size_t n_y>
+	void kalmanCorrect(const Matrix<float, n_x, n_y> &PCt, const Matrix<float, n_y, n_y> &S_I,
+			   const Vector<float, n_y> &r)
+	{
+		const Matrix<float, n_x, n_y> K = PCt * S_I;
+		_x += K * r;
+
+		// C * P = (P * C^T)^T as P is symmetric
+		for (size_t i = 0; i < n_x; i++) {
+			for (size_t j = 0; j < n_x; j++) {
+				float KCP = 0.f;
+
+				for (size_t k = 0; k < n_y; k++) {
+					KCP += K(i, k) * PCt(j, k);
+				}
+
+				m_P(i, j) -= KCP;
+			}
+		}
+	}
+
 	// misc
 	inline float agl()
 	{
@@ -392,6 +467,19 @@ private:
 	Matrix<float, n_u, n_u>  m_R;	// input covariance
 	Matrix<float, n_x, n_x>  m_Q;	// process noise covariance
 
+	// perf counters
+	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": cycle")};
+	perf_counter_t _predict_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": predict")};
+	perf_counter_t _gps_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": gps correct")};
+	perf_counter_t _baro_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": baro correct")};
+	perf_counter_t _lidar_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": lidar correct")};
+	perf_counter_t _sonar_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": sonar correct")};
+	perf_counter_t _flow_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": flow correct")};
+	perf_counter_t _vision_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": vision correct")};
+	perf_counter_t _mocap_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": mocap correct")};
+	perf_counter_t _land_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": land correct")};
+	perf_counter_t _landing_target_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": landing target correct")};
+
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::SYS_AUTOSTART>) _param_sys_autostart,   /**< example parameter */
@@ -67,8 +67,9 @@ void BlockLocalPositionEstimator::baroCorrect()
 	R(0, 0) = _param_lpe_bar_z.get() * _param_lpe_bar_z.get();
 
 	// residual
+	const Matrix<float, n_x, n_y_baro> PCt = covarianceTimesCT(C);
 	Matrix<float, n_y_baro, n_y_baro> S_I =
-		inv<float, n_y_baro>((C * m_P * C.transpose()) + R);
+		inv<float, n_y_baro>(residualCovariance(C, PCt, R));
 	Vector<float, n_y_baro> r = y - (C * _x);
 
 	// fault detection
@@ -87,10 +88,7 @@ void BlockLocalPositionEstimator::baroCorrect()
 	}
 
 	// kalman filter correction always
-	Matrix<float, n_x, n_y_baro> K = m_P * C.transpose() * S_I;
-	Vector<float, n_x> dx = K * r;
-	_x += dx;
-	m_P -= K * C * m_P;
+	kalmanCorrect(PCt, S_I, r);
 }
 
 void BlockLocalPositionEstimator::baroCheckTimeout()
@@ -59,7 +59,8 @@ void BlockLocalPositionEstimator::landCorrect()
 	R(Y_land_agl, Y_land_agl) = _param_lpe_land_z.get() * _param_lpe_land_z.get();
 
 	// residual
-	Matrix<float, n_y_land, n_y_land> S_I = inv<float, n_y_land>((C * m_P * C.transpose()) + R);
+	const Matrix<float, n_x, n_y_land> PCt = covarianceTimesCT(C);
+	Matrix<float, n_y_land, n_y_land> S_I = inv<float, n_y_land>(residualCovariance(C, PCt, R));
 	Vector<float, n_y_land> r = y - C * _x;
 	_pub_innov.get().hagl = r(Y_land_agl);
 	_pub_innov_var.get().hagl = R(Y_land_agl, Y_land_agl);
@@ -85,10 +86,7 @@ void BlockLocalPositionEstimator::landCorrect()
 	}
 
 	// kalman filter correction always for land detector
-	Matrix<float, n_x, n_y_land> K = m_P * C.transpose() * S_I;
-	Vector<float, n_x> dx = K * r;
-	_x += dx;
-	m_P -= K * C * m_P;
+	kalmanCorrect(PCt, S_I, r);
 }
 
 void BlockLocalPositionEstimator::landCheckTimeout()
@@ -157,14 +157,15 @@ void BlockLocalPositionEstimator::visionCorrect()
 	Vector<float, n_x> x0 = _xDelay.get(i_hist);
 
 	// residual
-	Matrix<float, n_y_vision, 1> r = y - C * x0;
+	Vector<float, n_y_vision> r = y - C * x0;
 	// residual covariance
-	Matrix<float, n_y_vision, n_y_vision> S = C * m_P * C.transpose() + R;
+	const Matrix<float, n_x, n_y_vision> PCt = covarianceTimesCT(C);
+	Matrix<float, n_y_vision, n_y_vision> S = residualCovariance(C, PCt, R);
 
 	// publish innovations
-	_pub_innov.get().ev_hpos[0] = r(0, 0);
-	_pub_innov.get().ev_hpos[1] = r(1, 0);
-	_pub_innov.get().ev_vpos    = r(2, 0);
+	_pub_innov.get().ev_hpos[0] = r(0);
+	_pub_innov.get().ev_hpos[1] = r(1);
+	_pub_innov.get().ev_vpos    = r(2);
 	_pub_innov.get().ev_hvel[0] = NAN;
 	_pub_innov.get().ev_hvel[1] = NAN;
 	_pub_innov.get().ev_vvel    = NAN;
@@ -196,10 +197,7 @@ void BlockLocalPositionEstimator::visionCorrect()
 
 	// kalman filter correction if no fault
 	if (!(_sensorFault & SENSOR_VISION)) {
-		Matrix<float, n_x, n_y_vision> K = m_P * C.transpose() * S_I;
-		Vector<float, n_x> dx = K * r;
-		_x += dx;
-		m_P -= K * C * m_P;
+		kalmanCorrect(PCt, S_I, r);
 	}
 }
 
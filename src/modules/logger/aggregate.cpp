@@ -0,0 +1,299 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "aggregate.h"
+
+#include <px4_platform_common/log.h>
+#include <cstdio>
+#include <cstring>
+
+namespace px4
+{
+namespace logger
+{
+
+template<typename T>
+static void aggregate_elements(const uint8_t *data, uint8_t *min, uint8_t *max, double *sum, int count, bool first)
+{
+	// the data is not aligned
+	for (int i = 0; i < count; ++i) {
+		T value, min_value, max_value;
+		memcpy(&value, data + i * sizeof(T), sizeof(T));
+
+		if (first) {
+			min_value = max_value = value;
+			sum[i] = 0.;
+
+		} else {
+			memcpy(&min_value, min + i * sizeof(T), sizeof(T));
+			memcpy(&max_value, max + i * sizeof(T), sizeof(T));
+
+			if (value < min_value) { min_value = value; }
+
+			if (value > max_value) { max_value = value; }
+		}
+
+		memcpy(min + i * sizeof(T), &min_value, sizeof(T));
+		memcpy(max + i * sizeof(T), &max_value, sizeof(T));
+		sum[i] += (double)value;
+	}
+}
+
+template<typename T>
+static void mean_elements(const double *sum, uint32_t samples, uint8_t *dst, int count, bool integer)
+{
+	for (int i = 0; i < count; ++i) {
+		double mean = sum[i] / samples;
+
+		if (integer) {
+			mean += mean >= 0. ? 0.5 : -0.5;
+		}
+
+		T value = (T)mean;
+		memcpy(dst + i * sizeof(T), &value, sizeof(T));
+	}
+}
+
+Aggregate::~Aggregate()
+{
+	delete[](_fields);
+	delete[](_min);
+	delete[](_max);
+	delete[](_last);
+	delete[](_sum);
+}
+
+int Aggregate::type_size(Type type)
+{
+	switch (type) {
+	case Type::Int8:
+	case Type::UInt8: return 1;
+
+	case Type::Int16:
+	case Type::UInt16: return 2;
+
+	case Type::Int32:
+	case Type::UInt32:
+	case Type::Float: return 4;
+
+	case Type::Int64:
+	case Type::UInt64:
+	case Type::Double: return 8;
+	}
+
+	return 0;
+}
+
+bool Aggregate::field_type(uint8_t orb_type, Type &type)
+{
+	switch (orb_type) {
+	case ORB_FIELD_TYPE_INT8: type = Type::Int8; return true;
+
+	case ORB_FIELD_TYPE_UINT8: type = Type::UInt8; return true;
+
+	case ORB_FIELD_TYPE_INT16: type = Type::Int16; return true;
+
+	case ORB_FIELD_TYPE_UINT16: type = Type::UInt16; return true;
+
+	case ORB_FIELD_TYPE_INT32: type = Type::Int32; return true;
+
+	case ORB_FIELD_TYPE_UINT32: type = Type::UInt32; return true;
+
+	case ORB_FIELD_TYPE_INT64: type = Type::Int64; return true;
+
+	case ORB_FIELD_TYPE_UINT64: type = Type::UInt64; return true;
+
+	case ORB_FIELD_TYPE_FLOAT: type = Type::Float; return true;
+
+	case ORB_FIELD_TYPE_DOUBLE: type = Type::Double; return true;
+	}
+
+	return false;
+}
+
+bool Aggregate::init(const orb_metadata *meta)
+{
+	_size = meta->o_size_no_padding;
+
+	if (!meta->o_field_list) {
+		PX4_ERR("%s: no field list", meta->o_name);
+		return false;
+	}
+
+	_fields = new Field[meta->o_num_fields];
+	_min = new uint8_t[_size];
+	_max = new uint8_t[_size];
+	_last = new uint8_t[_size];
+
+	if (!_fields || !_min || !_max || !_last) {
+		return false;
+	}
+
+	for (uint16_t i = 0; i < meta->o_num_fields; ++i) {
+		const orb_field &desc = meta->o_field_list[i];
+
+		if (desc.type == ORB_FIELD_TYPE_NESTED) {
+			// nested type: the rest contains the last sample
+			break;
+		}
+
+		Type type;
+
+		if (!field_type(desc.type, type)) {
+			// bool and char: last sample
+			continue;
+		}
+
+		const int count = desc.array_size > 0 ? desc.array_size : 1;
+
+		if (desc.offset + type_size(type) * count <= _size) {
+			Field &field = _fields[_num_fields++];
+			field.offset = desc.offset;
+			field.count = count;
+			field.type = type;
+			_num_elements += count;
+		}
+	}
+
+	_sum = new double[_num_elements];
+	return _sum != nullptr;
+}
+
+void Aggregate::add(const uint8_t *data)
+{
+	const bool first = _samples == 0;
+	double *sum = _sum;
+
+	for (int i = 0; i < _num_fields; ++i) {
+		const Field &field = _fields[i];
+		const uint8_t *src = data + field.offset;
+		uint8_t *min = _min + field.offset;
+		uint8_t *max = _max + field.offset;
+
+		switch (field.type) {
+		case Type::Int8: aggregate_elements<int8_t>(src, min, max, sum, field.count, first); break;
+
+		case Type::UInt8: aggregate_elements<uint8_t>(src, min, max, sum, field.count, first); break;
+
+		case Type::Int16: aggregate_elements<int16_t>(src, min, max, sum, field.count, first); break;
+
+		case Type::UInt16: aggregate_elements<uint16_t>(src, min, max, sum, field.count, first); break;
+
+		case Type::Int32: aggregate_elements<int32_t>(src, min, max, sum, field.count, first); break;
+
+		case Type::UInt32: aggregate_elements<uint32_t>(src, min, max, sum, field.count, first); break;
+
+		case Type::Int64: aggregate_elements<int64_t>(src, min, max, sum, field.count, first); break;
+
+		case Type::UInt64: aggregate_elements<uint64_t>(src, min, max, sum, field.count, first); break;
+
+		case Type::Float: aggregate_elements<float>(src, min, max, sum, field.count, first); break;
+
+		case Type::Double: aggregate_elements<double>(src, min, max, sum, field.count, first); break;
+		}
+
+		sum += field.count;
+	}
+
+	memcpy(_last, data, _size);
+	++_samples;
+}
+
+void Aggregate::get(uint8_t *dst, uint64_t timestamp)
+{
+	memcpy(dst, &timestamp, sizeof(timestamp));
+	dst += sizeof(timestamp);
+	memcpy(dst, &_samples, sizeof(_samples));
+	dst += sizeof(_samples);
+
+	uint8_t *min = dst;
+	uint8_t *max = dst + _size;
+	uint8_t *mean = dst + 2 * _size;
+	memcpy(min, _last, _size);
+	memcpy(max, _last, _size);
+	memcpy(mean, _last, _size);
+
+	if (_samples > 0) {
+		const double *sum = _sum;
+
+		for (int i = 0; i < _num_fields; ++i) {
+			const Field &field = _fields[i];
+			const size_t len = field.count * type_size(field.type);
+			memcpy(min + field.offset, _min + field.offset, len);
+			memcpy(max + field.offset, _max + field.offset, len);
+			uint8_t *m = mean + field.offset;
+
+			switch (field.type) {
+			case Type::Int8: mean_elements<int8_t>(sum, _samples, m, field.count, true); break;
+
+			case Type::UInt8: mean_elements<uint8_t>(sum, _samples, m, field.count, true); break;
+
+			case Type::Int16: mean_elements<int16_t>(sum, _samples, m, field.count, true); break;
+
+			case Type::UInt16: mean_elements<uint16_t>(sum, _samples, m, field.count, true); break;
+
+			case Type::Int32: mean_elements<int32_t>(sum, _samples, m, field.count, true); break;
+
+			case Type::UInt32: mean_elements<uint32_t>(sum, _samples, m, field.count, true); break;
+
+			case Type::Int64: mean_elements<int64_t>(sum, _samples, m, field.count, true); break;
+
+			case Type::UInt64: mean_elements<uint64_t>(sum, _samples, m, field.count, true); break;
+
+			case Type::Float: mean_elements<float>(sum, _samples, m, field.count, false); break;
+
+			case Type::Double: mean_elements<double>(sum, _samples, m, field.count, false); break;
+			}
+
+			sum += field.count;
+		}
+	}
+
+	_samples = 0;
+}
+
+int Aggregate::format(const orb_metadata *meta, char *buffer, size_t buffer_size)
+{
+	int len = snprintf(buffer, buffer_size, "%s_aggregate:uint64_t timestamp;uint32_t samples;%s min;%s max;%s mean;",
+			   meta->o_name, meta->o_name, meta->o_name, meta->o_name);
+	return len < (int)buffer_size ? len : -1;
+}
+
+int Aggregate::message_name(const orb_metadata *meta, char *buffer, size_t buffer_size)
+{
+	int len = snprintf(buffer, buffer_size, "%s_aggregate", meta->o_name);
+	return len < (int)buffer_size ? len : -1;
+}
+
+} // namespace logger
+} // namespace px4
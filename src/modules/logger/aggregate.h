@@ -0,0 +1,131 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <uORB/uORB.h>
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class Aggregate
+ * Keeps the element-wise minimum, maximum and mean of all samples of a topic over a
+ * logging interval, so that decimated topics still show the peaks.
+ *
+ * The aggregate is logged as a separate message '<topic>_aggregate' with the format
+ * "uint64_t timestamp;uint32_t samples;<topic> min;<topic> max;<topic> mean;".
+ * Only the numeric fields at the start of the topic (up to the first nested type) are
+ * aggregated, all other bytes (padding, bool, char and nested types) contain the last sample.
+ */
+class Aggregate
+{
+public:
+	Aggregate() = default;
+	~Aggregate();
+
+	/**
+	 * Parse the topic format and allocate the buffers
+	 * @return true on success
+	 */
+	bool init(const orb_metadata *meta);
+
+	/**
+	 * Add a sample (of size o_size_no_padding)
+	 */
+	void add(const uint8_t *data);
+
+	uint32_t samples() const { return _samples; }
+
+	/**
+	 * @return size of the logged aggregate data
+	 */
+	size_t data_size() const { return sizeof(uint64_t) + sizeof(uint32_t) + 3 * _size; }
+
+	/**
+	 * Write the aggregate data (data_size() bytes) and start a new interval
+	 * @param timestamp timestamp of the aggregate
+	 */
+	void get(uint8_t *dst, uint64_t timestamp);
+
+	/**
+	 * Get the ULog format definition of the aggregate message
+	 * @return length of the format string, or -1 if too long
+	 */
+	static int format(const orb_metadata *meta, char *buffer, size_t buffer_size);
+
+	/**
+	 * Get the ULog message name of the aggregate message
+	 * @return length of the name, or -1 if too long
+	 */
+	static int message_name(const orb_metadata *meta, char *buffer, size_t buffer_size);
+
+private:
+	enum class Type : uint8_t {
+		Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64, Float, Double
+	};
+
+	struct Field {
+		uint16_t offset;
+		uint16_t count;
+		Type type;
+	};
+
+	static int type_size(Type type);
+
+	/**
+	 * Map an orb_field_type to the aggregated type
+	 * @return false for types that are not aggregated (bool, char, nested)
+	 */
+	static bool field_type(uint8_t orb_type, Type &type);
+
+	Field *_fields{nullptr};
+	int _num_fields{0};
+	int _num_elements{0};
+
+	size_t _size{0};	///< o_size_no_padding
+
+	uint8_t *_min{nullptr};	///< min, max and last sample (_size each)
+	uint8_t *_max{nullptr};
+	uint8_t *_last{nullptr};
+	double *_sum{nullptr};	///< sum of each aggregated element
+	uint32_t _samples{0};
+};
+
+} // namespace logger
+} // namespace px4
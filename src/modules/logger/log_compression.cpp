@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "log_compression.h"
+
+#include <mathlib/mathlib.h>
+#include <cstring>
+
+namespace px4
+{
+namespace logger
+{
+
+int lz4_compress_block(const uint8_t *src, int src_size, uint8_t *dst, int dst_size, uint16_t *hash_table, int hash_log)
+{
+	static constexpr uint16_t EMPTY = 0xffff;
+	static constexpr int MIN_MATCH = 4;
+	static constexpr int LAST_LITERALS = 5;	///< the last 5 bytes are always literals
+	static constexpr int MF_LIMIT = 12;	///< the last match must start at least 12 bytes before the end
+
+	auto read32 = [](const uint8_t * p) {
+		uint32_t v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	};
+
+	auto write_length = [&](int &op, int length) {
+		while (length >= 255) {
+			dst[op++] = 255;
+			length -= 255;
+		}
+
+		dst[op++] = length;
+	};
+
+	for (int i = 0; i < (1 << hash_log); i++) {
+		hash_table[i] = EMPTY;
+	}
+
+	int ip = 0;
+	int anchor = 0;
+	int op = 0;
+
+	while (ip < src_size - MF_LIMIT) {
+		const uint32_t sequence = read32(&src[ip]);
+		const uint32_t hash = (sequence * 2654435761u) >> (32 - hash_log);
+		const int ref = hash_table[hash];
+		hash_table[hash] = ip;
+
+		if (ref == EMPTY || read32(&src[ref]) != sequence) {
+			ip++;
+			continue;
+		}
+
+		int match_length = MIN_MATCH;
+
+		while (ip + match_length < src_size - LAST_LITERALS && src[ref + match_length] == src[ip + match_length]) {
+			match_length++;
+		}
+
+		const int literals = ip - anchor;
+
+		// token + literal length + literals + offset + match length
+		if (op + 1 + literals / 255 + 1 + literals + 2 + match_length / 255 + 1 > dst_size) {
+			return -1;
+		}
+
+		uint8_t *token = &dst[op++];
+		*token = math::min(literals, 15) << 4;
+
+		if (literals >= 15) {
+			write_length(op, literals - 15);
+		}
+
+		memcpy(&dst[op], &src[anchor], literals);
+		op += literals;
+
+		const uint16_t offset = ip - ref;
+		dst[op++] = offset & 0xff;
+		dst[op++] = offset >> 8;
+
+		*token |= math::min(match_length - MIN_MATCH, 15);
+
+		if (match_length - MIN_MATCH >= 15) {
+			write_length(op, match_length - MIN_MATCH - 15);
+		}
+
+		ip += match_length;
+		anchor = ip;
+	}
+
+	// last literals
+	const int literals = src_size - anchor;
+
+	if (op + 1 + literals / 255 + 1 + literals > dst_size) {
+		return -1;
+	}
+
+	dst[op++] = math::min(literals, 15) << 4;
+
+	if (literals >= 15) {
+		write_length(op, literals - 15);
+	}
+
+	memcpy(&dst[op], &src[anchor], literals);
+	op += literals;
+
+	return op;
+}
+
+}
+}
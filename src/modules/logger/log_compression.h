@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * Block framing of compressed ULog data (MAVLink stream and log files).
+ *
+ * The ULog file header is stored as is, but with ULOG_COMPRESSED_FLAG set in the
+ * version byte. All following data is a sequence of blocks, each starting with a 4 byte header:
+ *   uint16 raw length (bit 15: block does not start at a ULog message boundary)
+ *   uint16 data length (bit 15: data is stored uncompressed)
+ * followed by the data, which is in LZ4 block format unless stored.
+ * Blocks are independent of each other.
+ */
+static constexpr uint8_t ULOG_COMPRESSED_FLAG = (1 << 7);	///< set in the version byte of the file header
+static constexpr uint16_t ULOG_BLOCK_FLAG = (1 << 15);		///< stored or continuation flag in the block header
+static constexpr size_t ULOG_BLOCK_HEADER_LEN = 4;
+
+static inline void ulog_block_header(uint8_t header[ULOG_BLOCK_HEADER_LEN], uint16_t raw_len, uint16_t data_len,
+				     bool stored, bool continuation)
+{
+	const uint16_t header_raw_len = continuation ? (raw_len | ULOG_BLOCK_FLAG) : raw_len;
+	const uint16_t header_data_len = stored ? (data_len | ULOG_BLOCK_FLAG) : data_len;
+	header[0] = (uint8_t)(header_raw_len & 0xff);
+	header[1] = (uint8_t)(header_raw_len >> 8);
+	header[2] = (uint8_t)(header_data_len & 0xff);
+	header[3] = (uint8_t)(header_data_len >> 8);
+}
+
+/**
+ * Compress a block into the LZ4 block format (greedy matching, single pass).
+ * @param hash_table 2^hash_log entries (src_size must be < 2^16)
+ * @return compressed size, -1 if it does not fit into dst_size
+ */
+int lz4_compress_block(const uint8_t *src, int src_size, uint8_t *dst, int dst_size, uint16_t *hash_table, int hash_log);
+
+}
+}
@@ -38,7 +38,7 @@ namespace px4
 namespace logger
 {
 
-LogWriter::LogWriter(Backend configured_backend, size_t file_buffer_size)
+LogWriter::LogWriter(Backend configured_backend, size_t file_buffer_size, const char *udp_destination)
 	: _backend(configured_backend)
 {
 	if (configured_backend & BackendFile) {
@@ -56,6 +56,14 @@ LogWriter::LogWriter(Backend configured_backend, size_t file_buffer_size)
 			PX4_ERR("LogWriterMavlink allocation failed");
 		}
 	}
+
+	if (configured_backend & BackendUdp) {
+		_log_writer_udp_for_write = _log_writer_udp = new LogWriterUdp(udp_destination);
+
+		if (!_log_writer_udp) {
+			PX4_ERR("LogWriterUdp allocation failed");
+		}
+	}
 }
 
 bool LogWriter::init()
@@ -81,6 +89,13 @@ bool LogWriter::init()
 		}
 	}
 
+	if (_log_writer_udp) {
+		if (!_log_writer_udp->init()) {
+			PX4_ERR("udp init failed");
+			return false;
+		}
+	}
+
 	return true;
 }
 
@@ -93,6 +108,10 @@ LogWriter::~LogWriter()
 	if (_log_writer_mavlink) {
 		delete (_log_writer_mavlink);
 	}
+
+	if (_log_writer_udp) {
+		delete (_log_writer_udp);
+	}
 }
 
 bool LogWriter::is_started(LogType type) const
@@ -107,6 +126,10 @@ bool LogWriter::is_started(LogType type) const
 		ret = ret || _log_writer_mavlink->is_started();
 	}
 
+	if (_log_writer_udp && type == LogType::Full) {
+		ret = ret || _log_writer_udp->is_started();
+	}
+
 	return ret;
 }
 
@@ -120,6 +143,10 @@ bool LogWriter::is_started(LogType type, Backend query_backend) const
 		return _log_writer_mavlink->is_started();
 	}
 
+	if (query_backend == BackendUdp && _log_writer_udp && type == LogType::Full) {
+		return _log_writer_udp->is_started();
+	}
+
 	return false;
 }
 
@@ -137,10 +164,10 @@ void LogWriter::stop_log_file(LogType type)
 	}
 }
 
-void LogWriter::start_log_mavlink()
+void LogWriter::start_log_mavlink(bool compress)
 {
 	if (_log_writer_mavlink) {
-		_log_writer_mavlink->start_log();
+		_log_writer_mavlink->start_log(compress);
 	}
 }
 
@@ -151,6 +178,20 @@ void LogWriter::stop_log_mavlink()
 	}
 }
 
+void LogWriter::start_log_udp(int fec_group_size)
+{
+	if (_log_writer_udp) {
+		_log_writer_udp->start_log(fec_group_size);
+	}
+}
+
+void LogWriter::stop_log_udp()
+{
+	if (_log_writer_udp) {
+		_log_writer_udp->stop_log();
+	}
+}
+
 void LogWriter::thread_stop()
 {
 	if (_log_writer_file) {
@@ -160,7 +201,7 @@ void LogWriter::thread_stop()
 
 int LogWriter::write_message(LogType type, void *ptr, size_t size, uint64_t dropout_start)
 {
-	int ret_file = 0, ret_mavlink = 0;
+	int ret_file = 0, ret_mavlink = 0, ret_udp = 0;
 
 	if (_log_writer_file_for_write) {
 		ret_file = _log_writer_file_for_write->write_message(type, ptr, size, dropout_start);
@@ -170,12 +211,22 @@ int LogWriter::write_message(LogType type, void *ptr, size_t size, uint64_t drop
 		ret_mavlink = _log_writer_mavlink_for_write->write_message(ptr, size);
 	}
 
+	if (_log_writer_udp_for_write && type == LogType::Full) {
+		// datagrams that could not be sent are lost (there is no retransmission), they are counted by the udp writer
+		ret_udp = _log_writer_udp_for_write->write_message(ptr, size);
+	}
+
 	// file backend errors takes precedence
 	if (ret_file != 0) {
 		return ret_file;
 	}
 
-	return ret_mavlink;
+	if (ret_mavlink != 0) {
+		return ret_mavlink;
+	}
+
+	// -2: a datagram was lost, which is not a buffer dropout
+	return ret_udp;
 }
 
 void LogWriter::select_write_backend(Backend sel_backend)
@@ -193,6 +244,13 @@ void LogWriter::select_write_backend(Backend sel_backend)
 	} else {
 		_log_writer_mavlink_for_write = nullptr;
 	}
+
+	if (sel_backend & BackendUdp) {
+		_log_writer_udp_for_write = _log_writer_udp;
+
+	} else {
+		_log_writer_udp_for_write = nullptr;
+	}
 }
 
 }
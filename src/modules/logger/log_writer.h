@@ -35,6 +35,7 @@
 
 #include "log_writer_file.h"
 #include "log_writer_mavlink.h"
+#include "log_writer_udp.h"
 
 namespace px4
 {
@@ -53,9 +54,13 @@ public:
 	typedef uint8_t Backend;
 	static constexpr Backend BackendFile = 1 << 0;
 	static constexpr Backend BackendMavlink = 1 << 1;
-	static constexpr Backend BackendAll = BackendFile | BackendMavlink;
+	static constexpr Backend BackendUdp = 1 << 2;
+	static constexpr Backend BackendAll = BackendFile | BackendMavlink | BackendUdp;
 
-	LogWriter(Backend configured_backend, size_t file_buffer_size);
+	/**
+	 * @param udp_destination "<ip>[:<port>]" of the logging server for the UDP backend
+	 */
+	LogWriter(Backend configured_backend, size_t file_buffer_size, const char *udp_destination = nullptr);
 	~LogWriter();
 
 	bool init();
@@ -69,10 +74,31 @@ public:
 
 	void stop_log_file(LogType type);
 
-	void start_log_mavlink();
+	void start_log_mavlink(bool compress = false);
 
 	void stop_log_mavlink();
 
+	/**
+	 * @param fec_group_size number of datagrams per parity datagram, 0 to disable FEC
+	 */
+	void start_log_udp(int fec_group_size = 0);
+
+	void stop_log_udp();
+
+	size_t get_total_sent_udp() const
+	{
+		if (_log_writer_udp) { return _log_writer_udp->total_sent(); }
+
+		return 0;
+	}
+
+	uint32_t get_send_errors_udp() const
+	{
+		if (_log_writer_udp) { return _log_writer_udp->send_errors(); }
+
+		return 0;
+	}
+
 	/**
 	 * whether logging is currently active or not (any of the selected backends).
 	 */
@@ -138,6 +164,45 @@ public:
 		return 0;
 	}
 
+	size_t get_stream_position_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_stream_position(type); }
+
+		return 0;
+	}
+
+	/**
+	 * @return true if the file backend is started and currently selected for writing
+	 */
+	bool is_writing_file(LogType type) const
+	{
+		return _log_writer_file_for_write && _log_writer_file_for_write->is_started(type);
+	}
+
+	/** @see LogWriterFile::hold() */
+	void hold_file(LogType type, hrt_abstime window)
+	{
+		if (_log_writer_file) { _log_writer_file->hold(type, window); }
+	}
+
+	/** @see LogWriterFile::release_hold() */
+	void release_hold_file(LogType type)
+	{
+		if (_log_writer_file) { _log_writer_file->release_hold(type); }
+	}
+
+	bool is_held_file(LogType type) const
+	{
+		return _log_writer_file && _log_writer_file->is_held(type);
+	}
+
+	void get_write_times_file(LogType type, uint32_t &write_time, uint32_t &fsync_time) const
+	{
+		write_time = fsync_time = 0;
+
+		if (_log_writer_file) { _log_writer_file->get_write_times(type, write_time, fsync_time); }
+	}
+
 	pthread_t thread_id_file() const
 	{
 		if (_log_writer_file) { return _log_writer_file->thread_id(); }
@@ -155,6 +220,8 @@ public:
 		if (_log_writer_file) { _log_writer_file->set_need_reliable_transfer(need_reliable); }
 
 		if (_log_writer_mavlink) { _log_writer_mavlink->set_need_reliable_transfer(need_reliable); }
+
+		if (_log_writer_udp) { _log_writer_udp->set_need_reliable_transfer(need_reliable); }
 	}
 
 	bool need_reliable_transfer() const
@@ -163,6 +230,8 @@ public:
 
 		if (_log_writer_mavlink) { return _log_writer_mavlink->need_reliable_transfer(); }
 
+		if (_log_writer_udp) { return _log_writer_udp->need_reliable_transfer(); }
+
 		return false;
 	}
 
@@ -170,10 +239,12 @@ private:
 
 	LogWriterFile *_log_writer_file = nullptr;
 	LogWriterMavlink *_log_writer_mavlink = nullptr;
+	LogWriterUdp *_log_writer_udp = nullptr;
 
 	LogWriterFile *_log_writer_file_for_write =
 		nullptr; ///< pointer that is used for writing, to temporarily select write backends
 	LogWriterMavlink *_log_writer_mavlink_for_write = nullptr;
+	LogWriterUdp *_log_writer_udp_for_write = nullptr;
 
 	const Backend _backend;
 };
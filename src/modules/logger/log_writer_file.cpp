@@ -39,6 +39,7 @@
 #include <errno.h>
 
 #include <mathlib/mathlib.h>
+#include <parameters/param.h>
 #include <px4_platform_common/posix.h>
 #ifdef __PX4_NUTTX
 #include <systemlib/hardfault_log.h>
@@ -54,15 +55,21 @@ namespace logger
 constexpr size_t LogWriterFile::_min_write_chunk;
 
 LogWriterFile::LogWriterFile(size_t buffer_size)
-	: _buffers{
 	//We always write larger chunks (orb messages) to the buffer, so the buffer
-	//needs to be larger than the minimum write chunk (300 is somewhat arbitrary)
+	//needs to be larger than the minimum write chunk (300 is somewhat arbitrary).
+	//The size is rounded up to a multiple of the write chunk, so that full log writes
+	//of adjacent chunks stay block aligned.
+	//The pool is shared by both log types: the mission log only draws a few chunks
+	//while it is running (from the end of the pool, so that it does not interleave
+	//with the full log), and the full log can use all the others during bursts.
+	: _pool(align_to_write_chunk(math::max(buffer_size, _min_write_chunk + 300))),
+	  _buffers{
 	{
-		math::max(buffer_size, _min_write_chunk + 300),
+		_pool, _pool.num_chunks(), false,
 		perf_alloc(PC_ELAPSED, "logger_sd_write"), perf_alloc(PC_ELAPSED, "logger_sd_fsync")},
 
 	{
-		300, // buffer size for the mission log (can be kept fairly small)
+		_pool, _mission_max_chunks, true,
 		perf_alloc(PC_ELAPSED, "logger_sd_write_mission"), perf_alloc(PC_ELAPSED, "logger_sd_fsync_mission")}
 }
 {
@@ -72,6 +79,30 @@ LogWriterFile::LogWriterFile(size_t buffer_size)
 
 bool LogWriterFile::init()
 {
+	param_t handle = param_find("SDLOG_FSYNC_INT");
+
+	if (handle != PARAM_INVALID) {
+		int32_t fsync_interval = 0;
+		param_get(handle, &fsync_interval);
+		_fsync_interval = fsync_interval > 0 ? fsync_interval * 1000 : 0;
+	}
+
+	handle = param_find("SDLOG_PREALLOC");
+
+	if (handle != PARAM_INVALID) {
+		int32_t prealloc_mb = 0;
+		param_get(handle, &prealloc_mb);
+		_buffers[(int)LogType::Full].set_preallocate_size(prealloc_mb > 0 ? (size_t)prealloc_mb * 1024 * 1024 : 0);
+	}
+
+	handle = param_find("SDLOG_COMPRESS");
+
+	if (handle != PARAM_INVALID) {
+		int32_t compress = 0;
+		param_get(handle, &compress);
+		_buffers[(int)LogType::Full].set_compression(compress != 0);
+	}
+
 	return true;
 }
 
@@ -147,7 +178,30 @@ int LogWriterFile::hardfault_store_filename(const char *log_file)
 
 void LogWriterFile::stop_log(LogType type)
 {
+	lock();
+
+	if (_buffers[(int)type].held()) {
+		// nothing triggered the black box: the file only contains the header section
+		_buffers[(int)type].set_remove_on_close();
+	}
+
 	_buffers[(int)type]._should_run = false;
+	unlock();
+	notify();
+}
+
+void LogWriterFile::hold(LogType type, hrt_abstime window)
+{
+	lock();
+	_buffers[(int)type].hold(window);
+	unlock();
+}
+
+void LogWriterFile::release_hold(LogType type)
+{
+	lock();
+	_buffers[(int)type].release_hold();
+	unlock();
 	notify();
 }
 
@@ -215,7 +269,6 @@ void LogWriterFile::run()
 			break;
 		}
 
-		int poll_count = 0;
 		int written = 0;
 		hrt_abstime last_fsync = hrt_absolute_time();
 
@@ -225,12 +278,11 @@ void LogWriterFile::run()
 
 			const hrt_abstime now = hrt_absolute_time();
 
-			/* call fsync periodically to minimize potential loss of data */
-			const bool call_fsync = ++poll_count >= 100 || now - last_fsync > 1_s;
+			/* call fsync periodically to minimize potential loss of data (0: only when closing the file) */
+			const bool call_fsync = _fsync_interval > 0 && now - last_fsync > _fsync_interval;
 
 			if (call_fsync) {
 				last_fsync = now;
-				poll_count = 0;
 			}
 
 			constexpr size_t min_available[(int)LogType::Count] = {
@@ -248,10 +300,27 @@ void LogWriterFile::run()
 				size_t available = buffer.get_read_ptr(&read_ptr, &is_part);
 
 				/* if sufficient data available or partial read or terminating, write data */
-				if (available >= min_available[i] || is_part || (!buffer._should_run && available > 0)) {
+				if (available >= min_available[i] || is_part || (!buffer._should_run && available > 0)
+				    || (buffer.held() && available > 0)) {
+					size_t write_size = available;
+
+					/* The full log is written up to an aligned file position (the remainder stays buffered),
+					 * so that the file position stays cluster aligned and the file system can transfer the
+					 * data directly without a read-modify-write of partial sectors.
+					 * The end of the log and parts ending at non-adjacent chunks are written as they are,
+					 * the next write then realigns the file position. */
+					if (i == (int)LogType::Full && buffer._should_run && !is_part && !buffer.held()) {
+						write_size -= (buffer.total_written() + write_size) % _min_write_chunk;
+					}
+
 					pthread_mutex_unlock(&_mtx);
 
-					written = buffer.write_to_file(read_ptr, available, call_fsync);
+					if (buffer.compression_active()) {
+						written = buffer.write_compressed(read_ptr, write_size, !buffer._should_run && !is_part, call_fsync);
+
+					} else {
+						written = buffer.write_to_file(read_ptr, write_size, call_fsync);
+					}
 
 					/* buffer.mark_read() requires _mtx to be locked */
 					pthread_mutex_lock(&_mtx);
@@ -348,14 +417,22 @@ int LogWriterFile::write(LogType type, void *ptr, size_t size, uint64_t dropout_
 		return 0;
 	}
 
-	// Bytes available to write
-	size_t available = _buffers[(int)type].available();
 	size_t dropout_size = 0;
 
 	if (dropout_start) {
 		dropout_size = sizeof(ulog_message_dropout_s);
 	}
 
+	LogFileBuffer &buffer = _buffers[(int)type];
+
+	if (buffer.held()) {
+		// black box: make space by dropping the oldest messages, and drop the ones outside of the window
+		while ((this->available(type) < size + dropout_size || buffer.hold_window_exceeded()) && buffer.drop_oldest()) {}
+	}
+
+	// Bytes available to write
+	size_t available = this->available(type);
+
 	if (size + dropout_size > available) {
 		// buffer overflow
 		return -1;
@@ -372,6 +449,18 @@ int LogWriterFile::write(LogType type, void *ptr, size_t size, uint64_t dropout_
 	return 0;
 }
 
+size_t LogWriterFile::available(LogType type) const
+{
+	int reserved_chunks = 0;
+
+	// keep the chunks of a running mission log available, so that a burst in the full log cannot starve it
+	if (type == LogType::Full && _buffers[(int)LogType::Mission]._should_run) {
+		reserved_chunks = math::max(_mission_max_chunks - _buffers[(int)LogType::Mission].num_chunks(), 0);
+	}
+
+	return _buffers[(int)type].available(reserved_chunks);
+}
+
 const char *log_type_str(LogType type)
 {
 	switch (type) {
@@ -385,9 +474,83 @@ const char *log_type_str(LogType type)
 	return "unknown";
 }
 
-LogWriterFile::LogFileBuffer::LogFileBuffer(size_t log_buffer_size, perf_counter_t perf_write,
-		perf_counter_t perf_fsync)
-	: _buffer_size(log_buffer_size), _perf_write(perf_write), _perf_fsync(perf_fsync)
+LogWriterFile::BufferPool::~BufferPool()
+{
+	delete[] _memory;
+	delete[] _next;
+	delete[] _first_message;
+	delete[] _time;
+}
+
+bool LogWriterFile::BufferPool::allocate()
+{
+	if (_memory) {
+		return true;
+	}
+
+	_memory = new uint8_t[_num_chunks * chunk_size];
+	_next = new int32_t[_num_chunks];
+	_first_message = new uint16_t[_num_chunks];
+	_time = new uint32_t[_num_chunks];
+
+	if (_memory == nullptr || _next == nullptr || _first_message == nullptr || _time == nullptr) {
+		delete[] _memory;
+		delete[] _next;
+		delete[] _first_message;
+		delete[] _time;
+		_memory = nullptr;
+		_next = nullptr;
+		_first_message = nullptr;
+		_time = nullptr;
+		return false;
+	}
+
+	for (int i = 0; i < _num_chunks; ++i) {
+		_next[i] = CHUNK_FREE;
+	}
+
+	_num_free = _num_chunks;
+	return true;
+}
+
+int32_t LogWriterFile::BufferPool::alloc_chunk(bool from_end)
+{
+	if (from_end) {
+		for (int32_t chunk = _num_chunks - 1; chunk >= 0; --chunk) {
+			if (_next[chunk] == CHUNK_FREE) {
+				_next[chunk] = CHUNK_END;
+				--_num_free;
+				return chunk;
+			}
+		}
+
+		return CHUNK_END;
+	}
+
+	for (int i = 0; i < _num_chunks; ++i) {
+		const int32_t chunk = (_next_fit + i) % _num_chunks;
+
+		if (_next[chunk] == CHUNK_FREE) {
+			_next[chunk] = CHUNK_END;
+			_next_fit = (chunk + 1) % _num_chunks;
+			--_num_free;
+			return chunk;
+		}
+	}
+
+	return CHUNK_END;
+}
+
+void LogWriterFile::BufferPool::free_chunk(int32_t chunk)
+{
+	_next[chunk] = CHUNK_FREE;
+	++_num_free;
+}
+
+LogWriterFile::LogFileBuffer::LogFileBuffer(BufferPool &pool, int max_chunks, bool alloc_from_end,
+		perf_counter_t perf_write, perf_counter_t perf_fsync)
+	: _pool(pool), _max_chunks(max_chunks), _alloc_from_end(alloc_from_end), _perf_write(perf_write),
+	  _perf_fsync(perf_fsync)
 {
 }
 
@@ -397,50 +560,202 @@ LogWriterFile::LogFileBuffer::~LogFileBuffer()
 		close(_fd);
 	}
 
-	delete[] _buffer;
+	delete _compression;
+	free(_file_name);
 
 	perf_free(_perf_write);
 	perf_free(_perf_fsync);
+	perf_free(_perf_compress);
 }
 
 void LogWriterFile::LogFileBuffer::write_no_check(void *ptr, size_t size)
 {
-	size_t n = _buffer_size - _head;	// bytes to end of the buffer
+	const uint8_t *data = static_cast<const uint8_t *>(ptr);
+	bool message_start = true; // each call writes one ULog message (or the start of it)
 
-	uint8_t *buffer_c = static_cast<uint8_t *>(ptr);
+	while (size > 0) {
+		if (_tail_chunk == BufferPool::CHUNK_END || _write_offset == BufferPool::chunk_size) {
+			const int32_t chunk = _pool.alloc_chunk(_alloc_from_end);
 
-	if (size > n) {
-		// Message goes over the end of the buffer
-		memcpy(&(_buffer[_head]), buffer_c, n);
-		_head = 0;
+			if (chunk == BufferPool::CHUNK_END) {
+				// cannot happen, as the caller checked available()
+				return;
+			}
 
-	} else {
-		n = 0;
+			if (_tail_chunk == BufferPool::CHUNK_END) {
+				_head_chunk = chunk;
+				_read_offset = 0;
+
+			} else {
+				_pool.next(_tail_chunk) = chunk;
+			}
+
+			_tail_chunk = chunk;
+			_write_offset = 0;
+			++_num_chunks;
+			_pool.first_message(chunk) = BufferPool::NO_MESSAGE_START;
+			_pool.time(chunk) = (uint32_t)(hrt_absolute_time() / 1000);
+		}
+
+		if (message_start) {
+			if (_pool.first_message(_tail_chunk) == BufferPool::NO_MESSAGE_START) {
+				_pool.first_message(_tail_chunk) = _write_offset;
+			}
+
+			message_start = false;
+		}
+
+		const size_t n = math::min(size, BufferPool::chunk_size - _write_offset);
+		memcpy(_pool.chunk(_tail_chunk) + _write_offset, data, n);
+		_write_offset += n;
+		_count += n;
+		data += n;
+		size -= n;
 	}
+}
 
-	// now: n = bytes already written
-	size_t p = size - n;	// number of bytes to write
-	memcpy(&(_buffer[_head]), &(buffer_c[n]), p);
-	_head = (_head + p) % _buffer_size;
-	_count += size;
+size_t LogWriterFile::LogFileBuffer::available(int reserved_chunks) const
+{
+	const int free_chunks = math::min(_pool.num_free() - reserved_chunks, _max_chunks - _num_chunks);
+	size_t available = free_chunks > 0 ? free_chunks * BufferPool::chunk_size : 0;
+
+	if (_tail_chunk != BufferPool::CHUNK_END) {
+		available += BufferPool::chunk_size - _write_offset;
+	}
+
+	return available;
 }
 
 size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 {
-	// bytes available to read
-	int read_ptr = _head - _count;
+	*is_part = false;
 
-	if (read_ptr < 0) {
-		read_ptr += _buffer_size;
-		*ptr = &_buffer[read_ptr];
-		*is_part = true;
-		return _buffer_size - read_ptr;
+	if (_head_chunk == BufferPool::CHUNK_END) {
+		*ptr = nullptr;
+		return 0;
+	}
+
+	int32_t chunk = _head_chunk;
+	*ptr = _pool.chunk(chunk) + _read_offset;
+	size_t size = (chunk == _tail_chunk ? _write_offset : BufferPool::chunk_size) - _read_offset;
+
+	// chunks allocated one after another are usually adjacent: write them at once
+	while (chunk != _tail_chunk && _pool.next(chunk) == chunk + 1) {
+		++chunk;
+		size += chunk == _tail_chunk ? _write_offset : BufferPool::chunk_size;
+	}
+
+	*is_part = chunk != _tail_chunk;
+
+	if (_hold) {
+		// only the data before the hold position is written
+		const size_t read_position = _total_written + _dropped;
+		const size_t limit = _hold_position > read_position ? _hold_position - read_position : 0;
+
+		if (size >= limit) {
+			size = limit;
+			*is_part = false;
+		}
+	}
+
+	return size;
+}
+
+void LogWriterFile::LogFileBuffer::hold(hrt_abstime window)
+{
+	_hold = true;
+	_hold_window = window / 1000;
+	_hold_position = _total_written + _dropped + _count;
+}
+
+bool LogWriterFile::LogFileBuffer::hold_window_exceeded() const
+{
+	if (_head_chunk == BufferPool::CHUNK_END || _head_chunk == _tail_chunk) {
+		return false;
+	}
+
+	// the next chunk is compared, so that the data within the window is kept
+	const uint32_t now = (uint32_t)(hrt_absolute_time() / 1000);
+	return now - _pool.time(_pool.next(_head_chunk)) > _hold_window;
+}
+
+bool LogWriterFile::LogFileBuffer::drop_oldest()
+{
+	// the writer might still read the data before the hold position
+	if (!_hold || _head_chunk == BufferPool::CHUNK_END || _total_written + _dropped < _hold_position) {
+		return false;
+	}
+
+	size_t dropped = 0;
+	int32_t chunk = _head_chunk;
+	size_t offset = _read_offset;
+
+	// drop the head chunk and all following ones without a message start
+	do {
+		const int32_t next = chunk == _tail_chunk ? BufferPool::CHUNK_END : _pool.next(chunk);
+		dropped += (chunk == _tail_chunk ? _write_offset : BufferPool::chunk_size) - offset;
+		_pool.free_chunk(chunk);
+		--_num_chunks;
+		chunk = next;
+		offset = 0;
+	} while (chunk != BufferPool::CHUNK_END && _pool.first_message(chunk) == BufferPool::NO_MESSAGE_START);
+
+	if (chunk == BufferPool::CHUNK_END) {
+		_head_chunk = _tail_chunk = BufferPool::CHUNK_END;
+		_read_offset = 0;
 
 	} else {
-		*ptr = &_buffer[read_ptr];
-		*is_part = false;
-		return _count;
+		// continue at the first complete message
+		_head_chunk = chunk;
+		_read_offset = _pool.first_message(chunk);
+		dropped += _read_offset;
+	}
+
+	_count -= dropped;
+	_dropped += dropped;
+	return true;
+}
+
+void LogWriterFile::LogFileBuffer::mark_read(size_t n)
+{
+	_count -= n;
+	_total_written += n;
+
+	while (n > 0 && _head_chunk != BufferPool::CHUNK_END) {
+		const size_t end = _head_chunk == _tail_chunk ? _write_offset : BufferPool::chunk_size;
+		const size_t read = math::min(n, end - _read_offset);
+		_read_offset += read;
+		n -= read;
+
+		if (_read_offset == end) {
+			// chunk completely read: return it to the pool
+			const int32_t next = _head_chunk == _tail_chunk ? BufferPool::CHUNK_END : _pool.next(_head_chunk);
+			_pool.free_chunk(_head_chunk);
+			--_num_chunks;
+
+			if (next == BufferPool::CHUNK_END) {
+				_tail_chunk = BufferPool::CHUNK_END;
+			}
+
+			_head_chunk = next;
+			_read_offset = 0;
+		}
+	}
+}
+
+void LogWriterFile::LogFileBuffer::release_chunks()
+{
+	while (_head_chunk != BufferPool::CHUNK_END) {
+		const int32_t next = _head_chunk == _tail_chunk ? BufferPool::CHUNK_END : _pool.next(_head_chunk);
+		_pool.free_chunk(_head_chunk);
+		_head_chunk = next;
 	}
+
+	_tail_chunk = BufferPool::CHUNK_END;
+	_read_offset = 0;
+	_write_offset = 0;
+	_num_chunks = 0;
+	_count = 0;
 }
 
 bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
@@ -452,39 +767,86 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 		return false;
 	}
 
-	if (_buffer == nullptr) {
-		_buffer = new uint8_t[_buffer_size];
+	if (!_pool.allocate()) {
+		PX4_ERR("Can't create log buffer");
+		::close(_fd);
+		_fd = -1;
+		return false;
+	}
 
-		if (_buffer == nullptr) {
-			PX4_ERR("Can't create log buffer");
-			::close(_fd);
-			_fd = -1;
-			return false;
+	if (!_alloc_from_end) {
+		// the chunks of the previous log are released: start a contiguous ring at the (aligned) pool start,
+		// so that whole write chunks of the file map to adjacent memory
+		_pool.reset_next_fit();
+	}
+
+	if (_compress && _compression == nullptr) {
+		_compression = new Compression;
+
+		if (_compression == nullptr) {
+			PX4_WARN("no memory for log compression, writing uncompressed");
+
+		} else {
+			_perf_compress = perf_alloc(PC_ELAPSED, "logger_sd_compress");
 		}
 	}
 
-	// Clear buffer and counters
-	_head = 0;
-	_count = 0;
+	if (_compression) {
+		_compression->raw_len = 0;
+		_compression->output_len = 0;
+		_compression->file_size = 0;
+		_compression->header_pending = true;
+		_compression->continuation = false;
+	}
+
+	preallocate();
+
+	free(_file_name);
+	_file_name = strdup(filename);
+
+	// Clear counters (the chunks were released when closing the previous file)
 	_total_written = 0;
+	_dropped = 0;
+	_hold = false;
+	_remove_on_close = false;
 
 	_should_run = true;
 
 	return true;
 }
 
+void LogWriterFile::LogFileBuffer::preallocate() const
+{
+	if (_preallocate_size == 0) {
+		return;
+	}
+
+#if defined(__PX4_LINUX) && defined(FALLOC_FL_KEEP_SIZE)
+	// reserve the blocks without changing the file size, so that a file that is closed
+	// early (or after a crash) does not contain trailing zeros
+	if (fallocate(_fd, FALLOC_FL_KEEP_SIZE, 0, _preallocate_size) != 0) {
+		PX4_WARN("log file preallocation failed (%i)", errno);
+	}
+
+#endif /* __PX4_LINUX */
+}
+
 void LogWriterFile::LogFileBuffer::fsync() const
 {
+	const hrt_abstime start = hrt_absolute_time();
 	perf_begin(_perf_fsync);
 	::fsync(_fd);
 	perf_end(_perf_fsync);
+	_fsync_time.fetch_add((uint32_t)hrt_elapsed_time(&start));
 }
 
 ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync) const
 {
+	const hrt_abstime start = hrt_absolute_time();
 	perf_begin(_perf_write);
 	ssize_t ret = ::write(_fd, buffer, size);
 	perf_end(_perf_write);
+	_write_time.fetch_add((uint32_t)hrt_elapsed_time(&start));
 
 	if (call_fsync) {
 		fsync();
@@ -493,18 +855,135 @@ ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t s
 	return ret;
 }
 
+ssize_t LogWriterFile::LogFileBuffer::write_compressed(const void *buffer, size_t size, bool flush, bool call_fsync)
+{
+	Compression &compression = *_compression;
+	const uint8_t *data = static_cast<const uint8_t *>(buffer);
+	size_t consumed = 0;
+
+	if (compression.header_pending) {
+		if (size < sizeof(ulog_file_header_s) && !flush) {
+			return 0;
+		}
+
+		if (size >= sizeof(ulog_file_header_s)) {
+			// the file header is stored uncompressed, flagging the compression in the version byte
+			memcpy(compression.output, data, sizeof(ulog_file_header_s));
+			compression.output[7] |= ULOG_COMPRESSED_FLAG;
+			compression.output_len = sizeof(ulog_file_header_s);
+			consumed = sizeof(ulog_file_header_s);
+		}
+
+		compression.header_pending = false;
+	}
+
+	while (consumed < size) {
+		const size_t n = math::min(size - consumed, _compression_block_size - compression.raw_len);
+		memcpy(&compression.raw[compression.raw_len], &data[consumed], n);
+		compression.raw_len += n;
+		consumed += n;
+
+		if (compression.raw_len == _compression_block_size) {
+			compress_block();
+
+			if (write_compressed_output(false)) {
+				return -1;
+			}
+		}
+	}
+
+	if (flush) {
+		compress_block();
+
+		if (write_compressed_output(true)) {
+			return -1;
+		}
+	}
+
+	if (call_fsync) {
+		fsync();
+	}
+
+	return consumed;
+}
+
+void LogWriterFile::LogFileBuffer::compress_block()
+{
+	Compression &compression = *_compression;
+
+	if (compression.raw_len == 0) {
+		return;
+	}
+
+	uint8_t *header = &compression.output[compression.output_len];
+	uint8_t *block = header + ULOG_BLOCK_HEADER_LEN;
+
+	// only keep the compressed data if it is smaller
+	perf_begin(_perf_compress);
+	int block_len = lz4_compress_block(compression.raw, compression.raw_len, block, compression.raw_len - 1,
+					   compression.hash_table, _compression_hash_log);
+	perf_end(_perf_compress);
+
+	const bool stored = block_len <= 0;
+
+	if (stored) {
+		memcpy(block, compression.raw, compression.raw_len);
+		block_len = compression.raw_len;
+	}
+
+	// blocks are cut at fixed offsets of the ULog data, so only the first one starts at a message boundary
+	ulog_block_header(header, compression.raw_len, block_len, stored, compression.continuation);
+	compression.continuation = true;
+	compression.output_len += ULOG_BLOCK_HEADER_LEN + block_len;
+	compression.raw_len = 0;
+}
+
+int LogWriterFile::LogFileBuffer::write_compressed_output(bool flush)
+{
+	Compression &compression = *_compression;
+	const size_t write_size = flush ? compression.output_len :
+				  compression.output_len - compression.output_len % _min_write_chunk;
+
+	if (write_size == 0) {
+		return 0;
+	}
+
+	if (write_to_file(compression.output, write_size, false) != static_cast<ssize_t>(write_size)) {
+		return -1;
+	}
+
+	compression.file_size += write_size;
+	compression.output_len -= write_size;
+	memmove(compression.output, &compression.output[write_size], compression.output_len);
+	return 0;
+}
+
 void LogWriterFile::LogFileBuffer::close_file()
 {
-	_head = 0;
-	_count = 0;
+	release_chunks();
 
 	if (_fd >= 0) {
+		if (compression_active()) {
+			// write the remaining data of an incomplete block
+			compress_block();
+			write_compressed_output(true);
+		}
+
 		int res = close(_fd);
 		_fd = -1;
+		_hold = false;
+
+		if (_remove_on_close && _file_name) {
+			_remove_on_close = false;
+			PX4_INFO("removing untriggered log file %s", _file_name);
+			unlink(_file_name);
 
-		if (res) {
+		} else if (res) {
 			PX4_WARN("closing log file failed (%i)", errno);
 
+		} else if (compression_active()) {
+			PX4_INFO("closed logfile, bytes written: %zu (compressed: %zu)", _total_written, _compression->file_size);
+
 		} else {
 			PX4_INFO("closed logfile, bytes written: %zu", _total_written);
 		}
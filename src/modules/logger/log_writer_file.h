@@ -33,12 +33,15 @@
 
 #pragma once
 
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <stdint.h>
 #include <pthread.h>
 #include <drivers/drv_hrt.h>
 #include <perf/perf_counter.h>
 
+#include "log_compression.h"
+
 namespace px4
 {
 namespace logger
@@ -83,6 +86,20 @@ public:
 
 	bool is_started(LogType type) const { return _buffers[(int)type]._should_run; }
 
+	/**
+	 * Keep all data written from now on in RAM (black box): the oldest messages are dropped
+	 * when the buffer is full or when they are older than window. If the log is stopped while
+	 * held, the file is removed.
+	 */
+	void hold(LogType type, hrt_abstime window);
+
+	/**
+	 * Write the held data and everything that follows to the file
+	 */
+	void release_hold(LogType type);
+
+	bool is_held(LogType type) const { return _buffers[(int)type].held(); }
+
 	/** @see LogWriter::write_message() */
 	int write_message(LogType type, void *ptr, size_t size, uint64_t dropout_start = 0);
 
@@ -116,6 +133,23 @@ public:
 		return _buffers[(int)type].count();
 	}
 
+	/**
+	 * @return file offset of the next written message (of the uncompressed data)
+	 */
+	size_t get_stream_position(LogType type) const
+	{
+		return _buffers[(int)type].stream_position();
+	}
+
+	/**
+	 * Get the accumulated time the writer thread spent in write() and fsync() [us] (wraps around)
+	 */
+	void get_write_times(LogType type, uint32_t &write_time, uint32_t &fsync_time) const
+	{
+		write_time = _buffers[(int)type].write_time();
+		fsync_time = _buffers[(int)type].fsync_time();
+	}
+
 	void set_need_reliable_transfer(bool need_reliable)
 	{
 		_need_reliable_transfer = need_reliable;
@@ -149,17 +183,113 @@ private:
 	/* 512 didn't seem to work properly, 4096 should match the FAT cluster size */
 	static constexpr size_t	_min_write_chunk = 4096;
 
+	static constexpr size_t align_to_write_chunk(size_t size)
+	{
+		return (size + _min_write_chunk - 1) / _min_write_chunk * _min_write_chunk;
+	}
+
+	/**
+	 * @class BufferPool
+	 * Memory shared by the log buffers of all log types, handed out in chunks on demand
+	 */
+	class BufferPool
+	{
+	public:
+		static constexpr size_t chunk_size = 1024;
+		static constexpr int32_t CHUNK_END = -1; ///< end of the chunk list of a buffer
+		static constexpr int32_t CHUNK_FREE = -2;
+
+		explicit BufferPool(size_t size) : _num_chunks(size / chunk_size) {}
+
+		~BufferPool();
+
+		/**
+		 * Allocate the memory (if not done yet)
+		 * @return true on success
+		 */
+		bool allocate();
+
+		/**
+		 * @param from_end search downwards from the end of the pool instead of continuing after the
+		 *                 previous allocation, so that the chunks of the other buffer stay contiguous
+		 * @return chunk index, CHUNK_END if none is free
+		 */
+		int32_t alloc_chunk(bool from_end);
+
+		/**
+		 * Start the next (not from_end) allocation at the beginning of the pool
+		 */
+		void reset_next_fit() { _next_fit = 0; }
+
+		void free_chunk(int32_t chunk);
+
+		uint8_t *chunk(int32_t chunk) { return &_memory[chunk * chunk_size]; }
+
+		/** offset of the first ULog message that starts in a chunk (NO_MESSAGE_START if none) */
+		uint16_t &first_message(int32_t chunk) { return _first_message[chunk]; }
+
+		/** allocation time of a chunk [ms] */
+		uint32_t &time(int32_t chunk) { return _time[chunk]; }
+
+		static constexpr uint16_t NO_MESSAGE_START = UINT16_MAX;
+
+		/** the chunks of a buffer are a linked list */
+		int32_t &next(int32_t chunk) { return _next[chunk]; }
+
+		int num_chunks() const { return _num_chunks; }
+		int num_free() const { return _num_free; }
+
+	private:
+		const int _num_chunks;
+		uint8_t *_memory = nullptr;
+		int32_t *_next = nullptr;
+		uint16_t *_first_message = nullptr;
+		uint32_t *_time = nullptr;
+		int _num_free = 0;
+		int _next_fit = 0; ///< search start, so that consecutive allocations are adjacent in memory
+	};
+
+	/* the mission log is written as soon as there is data, so a few chunks are enough */
+	static constexpr int _mission_max_chunks = 2;
+
+	size_t available(LogType type) const;
+
 	class LogFileBuffer
 	{
 	public:
-		LogFileBuffer(size_t log_buffer_size, perf_counter_t perf_write, perf_counter_t perf_fsync);
+		LogFileBuffer(BufferPool &pool, int max_chunks, bool alloc_from_end, perf_counter_t perf_write,
+			      perf_counter_t perf_fsync);
 
 		~LogFileBuffer();
 
 		bool start_log(const char *filename);
 
+		/**
+		 * Enable block compression for the following logs (@see log_compression.h)
+		 */
+		void set_compression(bool compress) { _compress = compress; }
+
+		bool compression_active() const { return _compress && _compression; }
+
+		/**
+		 * Compress data in blocks of _compression_block_size and write the output in whole write chunks.
+		 * @param flush also compress an incomplete block and write all buffered output (end of log)
+		 * @return number of bytes consumed, -1 on write error
+		 */
+		ssize_t write_compressed(const void *buffer, size_t size, bool flush, bool call_fsync);
+
+		/**
+		 * Set the number of bytes to reserve on the storage when opening a log file (0 to disable)
+		 */
+		void set_preallocate_size(size_t size) { _preallocate_size = size; }
+
 		void close_file();
 
+		/**
+		 * Get the next contiguous data to write (can span several chunks if they are adjacent in memory)
+		 * @param is_part set if more data follows in another chunk
+		 * @return number of bytes at ptr
+		 */
 		size_t get_read_ptr(void **ptr, bool *is_part);
 
 		/**
@@ -167,7 +297,34 @@ private:
 		 */
 		inline void write_no_check(void *ptr, size_t size);
 
-		size_t available() const { return _buffer_size - _count; }
+		/**
+		 * @param reserved_chunks number of free pool chunks that must be left for other buffers
+		 * @return number of bytes that can be written
+		 */
+		size_t available(int reserved_chunks) const;
+
+		int num_chunks() const { return _num_chunks; }
+
+		void hold(hrt_abstime window);
+		void release_hold() { _hold = false; }
+		bool held() const { return _hold; }
+
+		/**
+		 * Drop the oldest chunk and the rest of the ULog message it contains, if the data is held
+		 * and the file header section was written already.
+		 * @return true if data was dropped
+		 */
+		bool drop_oldest();
+
+		/**
+		 * @return true if the oldest data is older than the hold window
+		 */
+		bool hold_window_exceeded() const;
+
+		/**
+		 * Remove the file when it is closed (a held log without trigger)
+		 */
+		void set_remove_on_close() { _remove_on_close = true; }
 
 		int fd() const { return _fd; }
 
@@ -175,27 +332,80 @@ private:
 
 		inline void fsync() const;
 
-		void mark_read(size_t n) { _count -= n; _total_written += n; }
+		void preallocate() const;
+
+		void compress_block();
+
+		/**
+		 * Write the compressed output in whole write chunks (or everything if flush is set)
+		 * @return 0 on success, -1 on write error
+		 */
+		int write_compressed_output(bool flush);
+
+		/**
+		 * Mark data as written and return the chunks that are completely read to the pool.
+		 */
+		void mark_read(size_t n);
 
 		size_t total_written() const { return _total_written; }
-		size_t buffer_size() const { return _buffer_size; }
+		size_t stream_position() const { return _total_written + _dropped + _count; }
+		uint32_t write_time() const { return _write_time.load(); }
+		uint32_t fsync_time() const { return _fsync_time.load(); }
+		size_t buffer_size() const { return _max_chunks * BufferPool::chunk_size; }
 		size_t count() const { return _count; }
 
 		bool _should_run = false;
 
 	private:
-		const size_t _buffer_size;
+		void release_chunks();
+
+		BufferPool &_pool;
+		const int _max_chunks;
+		const bool _alloc_from_end; ///< allocate chunks from the end of the pool (@see BufferPool::alloc_chunk())
 		int	_fd = -1;
-		uint8_t *_buffer = nullptr;
-		size_t _head = 0; ///< next position to write to
-		size_t _count = 0; ///< number of bytes in _buffer to be written
+		int32_t _head_chunk = BufferPool::CHUNK_END; ///< chunk to read from
+		int32_t _tail_chunk = BufferPool::CHUNK_END; ///< chunk to write to
+		size_t _read_offset = 0; ///< read position in _head_chunk
+		size_t _write_offset = 0; ///< write position in _tail_chunk
+		int _num_chunks = 0;
+		size_t _count = 0; ///< number of bytes in the buffer to be written
+		size_t _dropped = 0; ///< bytes dropped while held
+		bool _hold = false;
+		size_t _hold_position = 0; ///< data before this position (_total_written + _dropped) is not held
+		uint32_t _hold_window = 0; ///< [ms]
+		bool _remove_on_close = false;
+		char *_file_name = nullptr;
 		size_t _total_written = 0;
+		size_t _preallocate_size = 0;
 		perf_counter_t _perf_write;
 		perf_counter_t _perf_fsync;
+		mutable px4::atomic<uint32_t> _write_time{0}; ///< accumulated time in write() [us]
+		mutable px4::atomic<uint32_t> _fsync_time{0}; ///< accumulated time in fsync() [us]
+
+		static constexpr size_t _compression_block_size = 4096; ///< uncompressed size of a block
+		static constexpr int _compression_hash_log = 11;
+
+		struct Compression {
+			uint8_t raw[_compression_block_size]; ///< uncompressed data of the current block
+			uint8_t output[_min_write_chunk + ULOG_BLOCK_HEADER_LEN + _compression_block_size]; ///< framed blocks to be written
+			uint16_t hash_table[1 << _compression_hash_log];
+			size_t raw_len;
+			size_t output_len;
+			size_t file_size; ///< compressed bytes written to the file
+			bool header_pending; ///< the ULog file header still needs to be written
+			bool continuation;
+		};
+
+		Compression *_compression = nullptr;
+		bool _compress = false;
+		perf_counter_t _perf_compress = nullptr;
 	};
 
+	BufferPool _pool;
 	LogFileBuffer _buffers[(int)LogType::Count];
 
+	hrt_abstime	_fsync_interval{1000000}; ///< fsync interval [us], 0 to only sync when closing the file
+
 	bool 		_exit_thread = false;
 	bool		_need_reliable_transfer = false;
 	pthread_mutex_t		_mtx;
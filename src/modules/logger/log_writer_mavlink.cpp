@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include "log_writer_mavlink.h"
+#include "log_compression.h"
 #include "messages.h"
 
 #include <drivers/drv_hrt.h>
@@ -60,9 +61,13 @@ LogWriterMavlink::~LogWriterMavlink()
 	if (_ulog_stream_ack_sub >= 0) {
 		orb_unsubscribe(_ulog_stream_ack_sub);
 	}
+
+	delete[] _block;
+	delete[] _block_compressed;
+	delete[] _hash_table;
 }
 
-void LogWriterMavlink::start_log()
+void LogWriterMavlink::start_log(bool compress)
 {
 	if (_ulog_stream_ack_sub == -1) {
 		_ulog_stream_ack_sub = orb_subscribe(ORB_ID(ulog_stream_ack));
@@ -76,12 +81,28 @@ void LogWriterMavlink::start_log()
 	_ulog_stream_data.length = 0;
 	_ulog_stream_data.first_message_offset = 0;
 
+	if (compress && _block == nullptr) {
+		_block = new uint8_t[BLOCK_SIZE];
+		_block_compressed = new uint8_t[BLOCK_SIZE];
+		_hash_table = new uint16_t[1 << HASH_LOG];
+	}
+
+	_compress = compress && _block && _block_compressed && _hash_table;
+
+	if (compress && !_compress) {
+		PX4_WARN("no memory for compression, streaming uncompressed");
+	}
+
+	_block_len = 0;
+	_header_pending = _compress;
+
 	_is_started = true;
 }
 
 void LogWriterMavlink::stop_log()
 {
 	_ulog_stream_data.length = 0;
+	_block_len = 0;
 	_is_started = false;
 }
 
@@ -91,10 +112,112 @@ int LogWriterMavlink::write_message(void *ptr, size_t size)
 		return 0;
 	}
 
+	const uint8_t *data = (const uint8_t *)ptr;
+
+	if (!_compress) {
+		return append_data(data, size, true);
+	}
+
+	if (_header_pending && size >= sizeof(ulog_file_header_s)) {
+		// the file header is sent uncompressed, flagging the compression in the version byte
+		ulog_file_header_s header;
+		memcpy(&header, data, sizeof(header));
+		header.magic[7] |= ULOG_COMPRESSED_FLAG;
+		_header_pending = false;
+
+		if (append_data((const uint8_t *)&header, sizeof(header), true)) {
+			return -2;
+		}
+
+		data += sizeof(header);
+		size -= sizeof(header);
+	}
+
+	if (size > BLOCK_SIZE) {
+		// too large for a block: send it as uncompressed blocks
+		if (flush_block()) {
+			return -2;
+		}
+
+		bool continuation = false;
+
+		while (size > 0) {
+			const uint16_t block_len = math::min(size, (size_t)(ULOG_BLOCK_FLAG - 1));
+
+			if (write_block(data, block_len, block_len, true, continuation)) {
+				return -2;
+			}
+
+			data += block_len;
+			size -= block_len;
+			continuation = true;
+		}
+
+		return 0;
+	}
+
+	if (_block_len + size > BLOCK_SIZE) {
+		if (flush_block()) {
+			return -2;
+		}
+	}
+
+	if (_block_len == 0) {
+		_block_start_time = hrt_absolute_time();
+	}
+
+	memcpy(&_block[_block_len], data, size);
+	_block_len += size;
+
+	if (hrt_elapsed_time(&_block_start_time) > BLOCK_MAX_DELAY) {
+		return flush_block();
+	}
+
+	return 0;
+}
+
+int LogWriterMavlink::flush_block()
+{
+	if (_block_len == 0) {
+		return 0;
+	}
+
+	// only keep the compressed data if it is smaller
+	const int compressed_len = lz4_compress_block(_block, _block_len, _block_compressed, _block_len - 1, _hash_table,
+				   HASH_LOG);
+
+	int ret;
+
+	if (compressed_len > 0) {
+		ret = write_block(_block_compressed, _block_len, compressed_len, false, false);
+
+	} else {
+		ret = write_block(_block, _block_len, _block_len, true, false);
+	}
+
+	_block_len = 0;
+	return ret;
+}
+
+int LogWriterMavlink::write_block(const uint8_t *data, uint16_t raw_len, uint16_t data_len, bool stored,
+				  bool continuation)
+{
+	uint8_t header[ULOG_BLOCK_HEADER_LEN];
+	ulog_block_header(header, raw_len, data_len, stored, continuation);
+
+	if (append_data(header, sizeof(header), true)) {
+		return -2;
+	}
+
+	return append_data(data, data_len, false);
+}
+
+int LogWriterMavlink::append_data(const uint8_t *ptr, size_t size, bool message_start)
+{
 	const uint8_t data_len = (uint8_t)sizeof(_ulog_stream_data.data);
-	uint8_t *ptr_data = (uint8_t *)ptr;
+	const uint8_t *ptr_data = ptr;
 
-	if (_ulog_stream_data.first_message_offset == 255) {
+	if (message_start && _ulog_stream_data.first_message_offset == 255) {
 		_ulog_stream_data.first_message_offset = _ulog_stream_data.length;
 	}
 
@@ -118,6 +241,10 @@ int LogWriterMavlink::write_message(void *ptr, size_t size)
 void LogWriterMavlink::set_need_reliable_transfer(bool need_reliable)
 {
 	if (!need_reliable && _need_reliable_transfer) {
+		if (_compress) {
+			flush_block();
+		}
+
 		if (_ulog_stream_data.length > 0) {
 			// make sure to send previous data using reliable transfer
 			publish_message();
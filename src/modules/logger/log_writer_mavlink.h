@@ -34,6 +34,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <drivers/drv_hrt.h>
 #include <uORB/PublicationQueued.hpp>
 #include <uORB/topics/ulog_stream.h>
 #include <uORB/topics/ulog_stream_ack.h>
@@ -46,6 +47,10 @@ namespace logger
 /**
  * @class LogWriterMavlink
  * Writes logging data to uORB, and then sent via mavlink
+ *
+ * With compression enabled, the data is sent in blocks (@see log_compression.h),
+ * and first_message_offset points to the first block header in a message, so a
+ * receiver can resync after drops.
  */
 class LogWriterMavlink
 {
@@ -55,7 +60,10 @@ public:
 
 	bool init();
 
-	void start_log();
+	/**
+	 * @param compress compress the stream (see class description)
+	 */
+	void start_log(bool compress = false);
 
 	void stop_log();
 
@@ -76,6 +84,29 @@ private:
 	/** publish message, wait for ack if needed & reset message */
 	int publish_message();
 
+	/**
+	 * append data to the uORB messages
+	 * @param message_start data starts a ULog message (or block), which is used for resync
+	 */
+	int append_data(const uint8_t *ptr, size_t size, bool message_start);
+
+	/** compress and send the current block */
+	int flush_block();
+
+	int write_block(const uint8_t *data, uint16_t raw_len, uint16_t data_len, bool stored, bool continuation);
+
+	static constexpr size_t BLOCK_SIZE = 2048;			///< uncompressed size of a block
+	static constexpr hrt_abstime BLOCK_MAX_DELAY = 50000;		///< send a block after at most this time [us]
+	static constexpr int HASH_LOG = 10;				///< compression hash table with 2^HASH_LOG entries
+
+	uint8_t *_block{nullptr};			///< uncompressed data of the current block
+	uint8_t *_block_compressed{nullptr};
+	uint16_t *_hash_table{nullptr};
+	size_t _block_len{0};
+	hrt_abstime _block_start_time{0};
+	bool _compress{false};
+	bool _header_pending{false};		///< the file header still needs to be sent
+
 	ulog_stream_s _ulog_stream_data{};
 	uORB::PublicationQueued<ulog_stream_s> _ulog_stream_pub{ORB_ID(ulog_stream)};
 	int _ulog_stream_ack_sub{-1};
@@ -0,0 +1,304 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "log_writer_udp.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mathlib/mathlib.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/posix.h>
+
+#if defined(LOGGER_UDP)
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#endif
+
+namespace px4
+{
+namespace logger
+{
+
+static_assert(sizeof(LogWriterUdp::DatagramHeader) == 16, "unexpected datagram header padding");
+
+LogWriterUdp::LogWriterUdp(const char *destination)
+{
+	if (destination != nullptr) {
+		strncpy(_destination_str, destination, sizeof(_destination_str) - 1);
+	}
+}
+
+LogWriterUdp::~LogWriterUdp()
+{
+	if (_socket >= 0) {
+		::close(_socket);
+	}
+
+	delete[] _parity;
+	perf_free(_send_errors);
+}
+
+bool LogWriterUdp::init()
+{
+#if defined(LOGGER_UDP)
+
+	if (_destination_str[0] == '\0') {
+		PX4_ERR("udp: no destination");
+		return false;
+	}
+
+	char address[sizeof(_destination_str)];
+	memcpy(address, _destination_str, sizeof(address));
+
+	uint16_t port = DEFAULT_PORT;
+	char *port_str = strchr(address, ':');
+
+	if (port_str != nullptr) {
+		*port_str = '\0';
+		port = strtoul(port_str + 1, nullptr, 10);
+	}
+
+	_destination.sin_family = AF_INET;
+	_destination.sin_port = htons(port);
+
+	if (inet_aton(address, &_destination.sin_addr) == 0) {
+		PX4_ERR("udp: invalid address %s", address);
+		return false;
+	}
+
+	_socket = socket(AF_INET, SOCK_DGRAM, 0);
+
+	if (_socket < 0) {
+		PX4_ERR("udp: socket failed (%i)", errno);
+		return false;
+	}
+
+	PX4_INFO("streaming log to %s:%u", address, port);
+	return true;
+
+#else
+	PX4_ERR("udp: not supported (no networking)");
+	return false;
+#endif
+}
+
+void LogWriterUdp::start_log(int fec_group_size)
+{
+	fec_group_size = math::constrain(fec_group_size, 0, MAX_FEC_GROUP_SIZE);
+
+	if (fec_group_size > 0 && _parity == nullptr) {
+		_parity = new uint8_t[DATAGRAM_SIZE];
+	}
+
+	_fec_group_size = (_parity != nullptr) ? fec_group_size : 0;
+
+	if (fec_group_size > 0 && _fec_group_size == 0) {
+		PX4_WARN("udp: no memory for FEC, streaming without");
+	}
+
+	_fec_group_count = 0;
+	_length = 0;
+	_first_message_offset = NO_MESSAGE_START;
+	_sequence = 0;
+	_stream_offset = 0;
+	_num_send_errors = 0;
+	_log_start = true;
+
+	_is_started = true;
+}
+
+void LogWriterUdp::stop_log()
+{
+	if (_is_started && _length > 0) {
+		send_datagram();
+	}
+
+	_is_started = false;
+}
+
+int LogWriterUdp::write_message(void *ptr, size_t size)
+{
+	if (!is_started()) {
+		return 0;
+	}
+
+	const uint8_t *data = (const uint8_t *)ptr;
+
+	if (_first_message_offset == NO_MESSAGE_START) {
+		_first_message_offset = _length;
+	}
+
+	if (_length == 0) {
+		_datagram_start_time = hrt_absolute_time();
+	}
+
+	int ret = 0;
+
+	while (size > 0) {
+		const size_t len = math::min(PAYLOAD_SIZE - _length, size);
+		memcpy(&_datagram[sizeof(DatagramHeader) + _length], data, len);
+		_length += len;
+		data += len;
+		size -= len;
+
+		if (_length == PAYLOAD_SIZE) {
+			ret = send_datagram();
+			_datagram_start_time = hrt_absolute_time();
+		}
+	}
+
+	if (_length > 0 && hrt_elapsed_time(&_datagram_start_time) > MAX_DELAY) {
+		ret = send_datagram();
+	}
+
+	return ret;
+}
+
+void LogWriterUdp::set_need_reliable_transfer(bool need_reliable)
+{
+	if (!need_reliable && _need_reliable_transfer && _is_started && _length > 0) {
+		// the end of the header section is sent reliably as well
+		send_datagram();
+	}
+
+	_need_reliable_transfer = need_reliable;
+}
+
+void LogWriterUdp::update_parity()
+{
+	const DatagramHeader *header = (const DatagramHeader *)_datagram;
+	uint8_t *parity = &_parity[sizeof(DatagramHeader)];
+
+	if (_fec_group_count == 0) {
+		memset(parity, 0, PARITY_FIELDS_SIZE + PAYLOAD_SIZE);
+	}
+
+	// the header fields a receiver cannot infer for a lost datagram, then the payload (zero padded)
+	uint8_t fields[PARITY_FIELDS_SIZE];
+	memcpy(&fields[0], &header->stream_offset, 4);
+	memcpy(&fields[4], &header->first_message_offset, 2);
+	memcpy(&fields[6], &header->length, 2);
+
+	for (size_t i = 0; i < PARITY_FIELDS_SIZE; ++i) {
+		parity[i] ^= fields[i];
+	}
+
+	const uint8_t *payload = &_datagram[sizeof(DatagramHeader)];
+
+	for (size_t i = 0; i < _length; ++i) {
+		parity[PARITY_FIELDS_SIZE + i] ^= payload[i];
+	}
+
+	++_fec_group_count;
+}
+
+int LogWriterUdp::send_datagram()
+{
+	DatagramHeader header{};
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.flags = _log_start ? FLAG_LOG_START : 0;
+	header.sequence = _sequence;
+	header.stream_offset = _stream_offset;
+	header.first_message_offset = _first_message_offset;
+	header.length = _length;
+	memcpy(_datagram, &header, sizeof(header));
+
+	int ret = send(_datagram, sizeof(header) + _length);
+
+	if (_need_reliable_transfer) {
+		// no acks: a duplicate makes the loss of the header section unlikely, receivers drop it by sequence
+		ret = send(_datagram, sizeof(header) + _length);
+	}
+
+	if (_fec_group_size > 0) {
+		update_parity();
+
+		if (_fec_group_count == _fec_group_size) {
+			DatagramHeader parity_header{};
+			parity_header.magic = MAGIC;
+			parity_header.version = VERSION;
+			parity_header.flags = FLAG_PARITY;
+			parity_header.sequence = _sequence + 1 - _fec_group_count;
+			parity_header.first_message_offset = _fec_group_count;
+			parity_header.length = PARITY_FIELDS_SIZE + PAYLOAD_SIZE;
+			memcpy(_parity, &parity_header, sizeof(parity_header));
+
+			send(_parity, DATAGRAM_SIZE);
+			_fec_group_count = 0;
+		}
+	}
+
+	++_sequence;
+	_stream_offset += _length;
+	_length = 0;
+	_first_message_offset = NO_MESSAGE_START;
+	_log_start = false;
+
+	return ret;
+}
+
+int LogWriterUdp::send(const uint8_t *data, size_t size)
+{
+#if defined(LOGGER_UDP)
+	// the logger thread must not block: only retry a full socket buffer for the header section
+	const int max_tries = _need_reliable_transfer ? 10 : 1;
+
+	for (int i = 0; i < max_tries; ++i) {
+		const ssize_t ret = ::sendto(_socket, data, size, MSG_DONTWAIT, (const sockaddr *)&_destination,
+					     sizeof(_destination));
+
+		if (ret == (ssize_t)size) {
+			return 0;
+		}
+
+		if (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+			break;
+		}
+
+		px4_usleep(1000);
+	}
+
+#endif
+
+	++_num_send_errors;
+	perf_count(_send_errors);
+	return -2;
+}
+
+}
+}
@@ -0,0 +1,168 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <drivers/drv_hrt.h>
+#include <perf/perf_counter.h>
+
+#if defined(CONFIG_NET) || defined(__PX4_POSIX)
+# define LOGGER_UDP
+# include <netinet/in.h>
+#endif
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class LogWriterUdp
+ * Streams the ULog data in UDP datagrams directly to a logging server, without MAVLink framing.
+ *
+ * Each datagram starts with a DatagramHeader, followed by up to PAYLOAD_SIZE bytes of the ULog stream.
+ * The stream offset and first_message_offset allow a receiver to detect gaps and resync on the next
+ * ULog message. Optionally, a parity datagram (the XOR of a group of data datagrams, including their
+ * offsets and lengths) is sent after each group, so that the receiver can recover one lost datagram per group.
+ */
+class LogWriterUdp
+{
+public:
+	static constexpr uint16_t DEFAULT_PORT = 14590;
+
+	/**
+	 * @param destination "<ip>[:<port>]" of the logging server
+	 */
+	explicit LogWriterUdp(const char *destination);
+	~LogWriterUdp();
+
+	/**
+	 * Open the socket
+	 * @return true on success
+	 */
+	bool init();
+
+	/**
+	 * @param fec_group_size number of data datagrams per parity datagram, 0 to disable FEC
+	 */
+	void start_log(int fec_group_size = 0);
+
+	void stop_log();
+
+	bool is_started() const { return _is_started; }
+
+	/** @see LogWriter::write_message() */
+	int write_message(void *ptr, size_t size);
+
+	/**
+	 * There are no acks: datagrams of a reliable transfer (the header section) are sent twice,
+	 * and sending is retried if the socket buffer is full.
+	 */
+	void set_need_reliable_transfer(bool need_reliable);
+
+	bool need_reliable_transfer() const { return _need_reliable_transfer; }
+
+	/** total number of ULog bytes sent since the log was started */
+	size_t total_sent() const { return _stream_offset; }
+
+	/** number of datagrams that could not be sent since the log was started */
+	uint32_t send_errors() const { return _num_send_errors; }
+
+	struct DatagramHeader {
+		uint16_t magic;			///< MAGIC
+		uint8_t version;		///< VERSION
+		uint8_t flags;			///< FLAG_*
+		uint32_t sequence;		///< datagram sequence, the one of the first datagram of the group for parity datagrams
+		uint32_t stream_offset;		///< offset of the payload in the ULog stream (wraps around)
+		uint16_t first_message_offset;	///< offset of the first ULog message starting in the payload, NO_MESSAGE_START if none
+						///< (number of datagrams in the group for parity datagrams)
+		uint16_t length;		///< payload length
+	};
+
+	static constexpr uint16_t MAGIC = 0x4c55; ///< "UL"
+	static constexpr uint8_t VERSION = 1;
+	static constexpr uint8_t FLAG_LOG_START = 1 << 0;	///< first datagram of a log (the stream offset is 0)
+	static constexpr uint8_t FLAG_PARITY = 1 << 1;		///< parity datagram of the group starting at sequence
+	static constexpr uint16_t NO_MESSAGE_START = UINT16_MAX;
+
+	/** fits into a single Ethernet frame (1500 bytes MTU without IPv4 and UDP headers) */
+	static constexpr size_t DATAGRAM_SIZE = 1472;
+
+	/** header fields of a data datagram covered by the parity: stream offset, first message offset, length */
+	static constexpr size_t PARITY_FIELDS_SIZE = 8;
+
+	/** the parity datagram (parity fields and payload) has to fit into DATAGRAM_SIZE as well */
+	static constexpr size_t PAYLOAD_SIZE = DATAGRAM_SIZE - sizeof(DatagramHeader) - PARITY_FIELDS_SIZE;
+
+private:
+	/** send the current datagram (and the parity datagram at the end of a group) */
+	int send_datagram();
+
+	int send(const uint8_t *data, size_t size);
+
+	/** add the current datagram to the parity */
+	void update_parity();
+
+	static constexpr hrt_abstime MAX_DELAY = 20000;	///< send a partial datagram after at most this time [us]
+	static constexpr int MAX_FEC_GROUP_SIZE = 32;
+
+	char _destination_str[32] {};
+#if defined(LOGGER_UDP)
+	sockaddr_in _destination {};
+#endif
+	int _socket{-1};
+
+	uint8_t _datagram[DATAGRAM_SIZE] {};
+	size_t _length{0};			///< payload bytes in _datagram
+	uint16_t _first_message_offset{NO_MESSAGE_START};
+	hrt_abstime _datagram_start_time{0};
+	uint32_t _sequence{0};
+	uint32_t _stream_offset{0};		///< stream offset of the current datagram
+	bool _log_start{false};
+
+	uint8_t *_parity{nullptr};		///< parity datagram of the current group (DATAGRAM_SIZE bytes)
+	int _fec_group_size{0};
+	int _fec_group_count{0};		///< data datagrams in the current group
+
+	bool _need_reliable_transfer{false};
+	bool _is_started{false};
+
+	uint32_t _num_send_errors{0};
+	perf_counter_t _send_errors{perf_alloc(PC_COUNT, "logger: udp send errors")};
+};
+
+}
+}
@@ -52,14 +52,13 @@ void LoggedTopics::add_default_topics()
 	add_topic("camera_trigger");
 	add_topic("camera_trigger_secondary");
 	add_topic("cellular_status", 200);
+	add_topic("cpu_profile");
 	add_topic("cpuload");
 	add_topic("ekf_gps_drift");
 	add_topic("esc_status", 250);
-	add_topic("estimator_innovation_test_ratios", 200);
-	add_topic("estimator_innovation_variances", 200);
-	add_topic("estimator_innovations", 200);
-	add_topic("estimator_sensor_bias", 1000);
-	add_topic("estimator_status", 200);
+	add_topic("estimator_selector_status", 200);
+	add_topic("failure_detector_status");
+	add_topic("follow_target_estimator", 200);
 	add_topic("home_position");
 	add_topic("input_rc", 200);
 	add_topic("manual_control_setpoint", 200);
@@ -73,11 +72,13 @@ void LoggedTopics::add_default_topics()
 	add_topic("safety", 1000);
 	add_topic("sensor_combined", 100);
 	add_topic("sensor_correction", 1000);
+	add_topic("sensor_gyro_fft", 100);
 	add_topic("sensor_preflight", 200);
 	add_topic("sensor_selection");
 	add_topic("system_power", 500);
 	add_topic("tecs_status", 200);
 	add_topic("trajectory_setpoint", 200);
+	add_topic("uorb_latency");
 	add_topic("vehicle_air_data", 200);
 	add_topic("vehicle_angular_velocity", 20);
 	add_topic("vehicle_attitude", 50);
@@ -93,9 +94,18 @@ void LoggedTopics::add_default_topics()
 	add_topic("vehicle_status", 200);
 	add_topic("vehicle_status_flags");
 	add_topic("vtol_vehicle_status", 200);
+	add_topic("work_queue_status");
 
 	// multi topics
 	add_topic_multi("actuator_outputs", 100);
+	add_topic_multi("estimator_attitude", 500);
+	add_topic_multi("estimator_global_position", 1000);
+	add_topic_multi("estimator_innovation_test_ratios", 200);
+	add_topic_multi("estimator_innovation_variances", 200);
+	add_topic_multi("estimator_innovations", 200);
+	add_topic_multi("estimator_local_position", 500);
+	add_topic_multi("estimator_sensor_bias", 1000);
+	add_topic_multi("estimator_status", 200);
 	add_topic_multi("multirotor_motor_limits", 1000);
 	add_topic_multi("telemetry_status", 1000);
 	add_topic_multi("wind_estimate", 1000);
@@ -146,6 +156,7 @@ void LoggedTopics::add_debug_topics()
 	add_topic("debug_key_value");
 	add_topic("debug_value");
 	add_topic("debug_vect");
+	add_topic("mavlink_stream_status");
 }
 
 void LoggedTopics::add_estimator_replay_topics()
@@ -160,6 +171,7 @@ void LoggedTopics::add_estimator_replay_topics()
 	add_topic("sensor_combined");
 	add_topic("sensor_selection");
 	add_topic("vehicle_air_data");
+	add_topic("vehicle_gps_blended");
 	add_topic("vehicle_land_detected");
 	add_topic("vehicle_magnetometer");
 	add_topic("vehicle_status");
@@ -229,10 +241,12 @@ int LoggedTopics::add_topics_from_file(const char *fname)
 			continue;
 		}
 
-		// read line with format: <topic_name>[, <interval>]
+		// read line with format: <topic_name>[, <interval>[, aggregate]]
 		char topic_name[80];
 		uint32_t interval_ms = 0;
-		int nfields = sscanf(line, "%s %u", topic_name, &interval_ms);
+		char mode[16];
+		mode[0] = '\0';
+		int nfields = sscanf(line, "%s %u%*[ ,]%15s", topic_name, &interval_ms, mode);
 
 		if (nfields > 0) {
 			int name_len = strlen(topic_name);
@@ -241,8 +255,10 @@ int LoggedTopics::add_topics_from_file(const char *fname)
 				topic_name[name_len - 1] = '\0';
 			}
 
+			const bool aggregate = nfields > 2 && strcmp(mode, "aggregate") == 0;
+
 			/* add topic with specified interval_ms */
-			if (add_topic(topic_name, interval_ms)) {
+			if (add_topic(topic_name, interval_ms, 0, aggregate)) {
 				ntopics++;
 
 			} else {
@@ -275,7 +291,7 @@ void LoggedTopics::add_mission_topic(const char *name, uint16_t interval_ms)
 	}
 }
 
-bool LoggedTopics::add_topic(const orb_metadata *topic, uint16_t interval_ms, uint8_t instance)
+bool LoggedTopics::add_topic(const orb_metadata *topic, uint16_t interval_ms, uint8_t instance, bool aggregate)
 {
 	size_t fields_len = strlen(topic->o_fields) + strlen(topic->o_name) + 1; //1 for ':'
 
@@ -295,10 +311,11 @@ bool LoggedTopics::add_topic(const orb_metadata *topic, uint16_t interval_ms, ui
 	sub.topic = topic;
 	sub.interval_ms = interval_ms;
 	sub.instance = instance;
+	sub.aggregate = aggregate;
 	return true;
 }
 
-bool LoggedTopics::add_topic(const char *name, uint16_t interval_ms, uint8_t instance)
+bool LoggedTopics::add_topic(const char *name, uint16_t interval_ms, uint8_t instance, bool aggregate)
 {
 	const orb_metadata *const *topics = orb_get_topics();
 	bool success = false;
@@ -316,6 +333,7 @@ bool LoggedTopics::add_topic(const char *name, uint16_t interval_ms, uint8_t ins
 						  topics[i]->o_name, instance, interval_ms);
 
 					_subscriptions.sub[j].interval_ms = interval_ms;
+					_subscriptions.sub[j].aggregate = aggregate;
 					success = true;
 					already_added = true;
 					break;
@@ -323,7 +341,7 @@ bool LoggedTopics::add_topic(const char *name, uint16_t interval_ms, uint8_t ins
 			}
 
 			if (!already_added) {
-				success = add_topic(topics[i], interval_ms, instance);
+				success = add_topic(topics[i], interval_ms, instance, aggregate);
 				PX4_DEBUG("logging topic: %s(%d), interval: %i", topics[i]->o_name, instance, interval_ms);
 				break;
 			}
@@ -77,6 +77,7 @@ public:
 		const orb_metadata *topic;
 		uint16_t interval_ms;
 		uint8_t instance;
+		bool aggregate; ///< log the min/max/mean over the interval (@see Aggregate)
 	};
 	struct RequestedSubscriptionArray {
 		RequestedSubscription sub[MAX_TOPICS_NUM];
@@ -104,9 +105,10 @@ private:
 	 * @param name topic name
 	 * @param interval limit in milliseconds if >0, otherwise log as fast as the topic is updated.
 	 * @param instance orb topic instance
+	 * @param aggregate additionally log the min/max/mean over the interval
 	 * @return true on success
 	 */
-	bool add_topic(const char *name, uint16_t interval_ms = 0, uint8_t instance = 0);
+	bool add_topic(const char *name, uint16_t interval_ms = 0, uint8_t instance = 0, bool aggregate = false);
 	bool add_topic_multi(const char *name, uint16_t interval_ms = 0);
 
 	/**
@@ -142,7 +144,7 @@ private:
 	 * add a logged topic (called by add_topic() above).
 	 * @return true on success
 	 */
-	bool add_topic(const orb_metadata *topic, uint16_t interval_ms = 0, uint8_t instance = 0);
+	bool add_topic(const orb_metadata *topic, uint16_t interval_ms = 0, uint8_t instance = 0, bool aggregate = false);
 
 	RequestedSubscriptionArray _subscriptions;
 	int _num_mission_subs{0};
@@ -185,6 +185,10 @@ int Logger::print_status()
 		PX4_INFO("Full File Logging Running:");
 		print_statistics(LogType::Full);
 		is_logging = true;
+
+		if (_black_box_triggers != 0) {
+			PX4_INFO("Black box: %s", _writer.is_held_file(LogType::Full) ? "waiting for trigger" : "triggered");
+		}
 	}
 
 	if (_writer.is_started(LogType::Mission, LogWriter::BackendFile)) {
@@ -198,6 +202,12 @@ int Logger::print_status()
 		is_logging = true;
 	}
 
+	if (_writer.is_started(LogType::Full, LogWriter::BackendUdp)) {
+		PX4_INFO("UDP Logging Running (Full log), sent %.2f MiB, %u send errors",
+			 (double)_writer.get_total_sent_udp() / 1024. / 1024., (unsigned)_writer.get_send_errors_udp());
+		is_logging = true;
+	}
+
 	if (!is_logging) {
 		PX4_INFO("Not logging");
 	}
@@ -243,14 +253,15 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	Logger::LogMode log_mode = Logger::LogMode::while_armed;
 	bool error_flag = false;
 	bool log_name_timestamp = false;
-	LogWriter::Backend backend = LogWriter::BackendAll;
+	LogWriter::Backend backend = LogWriter::BackendFile | LogWriter::BackendMavlink;
 	const char *poll_topic = nullptr;
+	const char *udp_destination = nullptr;
 
 	int myoptind = 1;
 	int ch;
 	const char *myoptarg = nullptr;
 
-	while ((ch = px4_getopt(argc, argv, "r:b:etfm:p:x", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "r:b:etfm:p:u:x", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'r': {
 				unsigned long r = strtoul(myoptarg, nullptr, 10);
@@ -298,8 +309,11 @@ Logger *Logger::instantiate(int argc, char *argv[])
 			} else if (!strcmp(myoptarg, "mavlink")) {
 				backend = LogWriter::BackendMavlink;
 
+			} else if (!strcmp(myoptarg, "udp")) {
+				backend = LogWriter::BackendUdp;
+
 			} else if (!strcmp(myoptarg, "all")) {
-				backend = LogWriter::BackendAll;
+				backend = LogWriter::BackendFile | LogWriter::BackendMavlink;
 
 			} else {
 				PX4_ERR("unknown mode: %s", myoptarg);
@@ -312,6 +326,10 @@ Logger *Logger::instantiate(int argc, char *argv[])
 			poll_topic = myoptarg;
 			break;
 
+		case 'u':
+			udp_destination = myoptarg;
+			break;
+
 		case '?':
 			error_flag = true;
 			break;
@@ -332,11 +350,21 @@ Logger *Logger::instantiate(int argc, char *argv[])
 		}
 	}
 
+	if (udp_destination != nullptr) {
+		// stream in addition to the selected backends
+		backend |= LogWriter::BackendUdp;
+
+	} else if (backend & LogWriter::BackendUdp) {
+		PX4_ERR("udp mode needs a destination (-u)");
+		error_flag = true;
+	}
+
 	if (error_flag) {
 		return nullptr;
 	}
 
-	Logger *logger = new Logger(backend, log_buffer_size, log_interval, poll_topic, log_mode, log_name_timestamp);
+	Logger *logger = new Logger(backend, log_buffer_size, log_interval, poll_topic, log_mode, log_name_timestamp,
+				    udp_destination);
 
 #if defined(DBGPRINT) && defined(__PX4_NUTTX)
 	struct mallinfo alloc_info = mallinfo();
@@ -365,10 +393,10 @@ Logger *Logger::instantiate(int argc, char *argv[])
 
 
 Logger::Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       LogMode log_mode, bool log_name_timestamp) :
+	       LogMode log_mode, bool log_name_timestamp, const char *udp_destination) :
 	_log_mode(log_mode),
 	_log_name_timestamp(log_name_timestamp),
-	_writer(backend, buffer_size),
+	_writer(backend, buffer_size, udp_destination),
 	_log_interval(log_interval)
 {
 	_log_utc_offset = param_find("SDLOG_UTC_OFFSET");
@@ -376,6 +404,16 @@ Logger::Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_inte
 	_sdlog_profile_handle = param_find("SDLOG_PROFILE");
 	_mission_log = param_find("SDLOG_MISSION");
 	_boot_bat_only = param_find("SDLOG_BOOT_BAT");
+	_mavlink_compress = param_find("SDLOG_MAV_COMP");
+	_udp_fec_handle = param_find("SDLOG_UDP_FEC");
+	_queued_logging = param_find("SDLOG_QUEUED");
+	_queue_length = param_find("SDLOG_QUEUE_LEN");
+	_aggregate_handle = param_find("SDLOG_AGGREGATE");
+	_delta_encoding = param_find("SDLOG_DELTA");
+	_index_handle = param_find("SDLOG_INDEX");
+	_black_box_triggers_handle = param_find("SDLOG_BB_TRIG");
+	_black_box_pre_handle = param_find("SDLOG_BB_PRE");
+	_black_box_post_handle = param_find("SDLOG_BB_POST");
 
 	if (poll_topic_name) {
 		const orb_metadata *const *topics = orb_get_topics();
@@ -400,7 +438,20 @@ Logger::~Logger()
 	}
 
 	delete[](_msg_buffer);
+	delete[](_delta_buffer);
+	delete[](_delta_references);
+	delete[](_index_timestamps);
+	delete[](_index_offsets);
+	delete[](_index_topic_offsets);
+	delete[](_aggregate_buffer);
+	delete[](_definitions_cache);
+
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		delete _subscriptions[i].aggregate;
+	}
+
 	delete[](_subscriptions);
+	delete[](_updated_subscriptions);
 }
 
 bool Logger::request_stop_static()
@@ -413,29 +464,324 @@ bool Logger::request_stop_static()
 	return true;
 }
 
-bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
+void Logger::try_to_subscribe(int sub_idx)
 {
 	LoggerSubscription &sub = _subscriptions[sub_idx];
 
-	bool updated = false;
+	if (!sub.valid() && sub.subscribe()) {
+		write_add_logged_msg(LogType::Full, sub);
+
+		if (sub_idx < _num_mission_subs) {
+			write_add_logged_msg(LogType::Mission, sub);
+		}
+	}
+}
+
+size_t Logger::write_subscription_data(int sub_idx, hrt_abstime loop_time)
+{
+	LoggerSubscription &sub = _subscriptions[sub_idx];
+	size_t written = 0;
+
+	// each message consists of a header followed by an orb data object
+	const size_t msg_size = sizeof(ulog_message_data_header_s) + sub.get_topic()->o_size_no_padding;
+	const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+	const uint16_t write_msg_id = sub.msg_id;
+
+	//write one byte after another (necessary because of alignment)
+	_msg_buffer[0] = (uint8_t)write_msg_size;
+	_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+	_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+	_msg_buffer[3] = (uint8_t)write_msg_id;
+	_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+
+	// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+
+	_current_topic = sub.get_topic();
+
+	// full log
+	if (sub.delta_reference) {
+		written = write_data_delta(sub, msg_size);
+
+	} else if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+		written = msg_size;
+	}
+
+	// mission log
+	if (sub_idx < _num_mission_subs) {
+		if (_writer.is_started(LogType::Mission)) {
+			if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
+				unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+
+				if (delta_time > 0) {
+					_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
+				}
+
+				write_message(LogType::Mission, _msg_buffer, msg_size);
+			}
+		}
+	}
+
+	_current_topic = nullptr;
+	return written;
+}
+
+size_t Logger::write_data_delta(LoggerSubscription &sub, size_t msg_size)
+{
+	const uint8_t *data = _msg_buffer + sizeof(ulog_message_data_header_s);
+	const size_t data_size = msg_size - sizeof(ulog_message_data_header_s);
+	size_t delta_size = data_size;
+
+	if (!sub.delta_keyframe_required && sub.delta_samples < DELTA_KEYFRAME_INTERVAL) {
+		delta_size = encode_delta(sub.delta_reference, data, data_size,
+					  _delta_buffer + sizeof(ulog_message_data_delta_header_s));
+	}
+
+	size_t written = 0;
+
+	if (delta_size < data_size) {
+		const size_t delta_msg_size = sizeof(ulog_message_data_delta_header_s) + delta_size;
+		const uint16_t write_msg_size = static_cast<uint16_t>(delta_msg_size - ULOG_MSG_HEADER_LEN);
+
+		_delta_buffer[0] = (uint8_t)write_msg_size;
+		_delta_buffer[1] = (uint8_t)(write_msg_size >> 8);
+		_delta_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+		_delta_buffer[3] = _msg_buffer[3];
+		_delta_buffer[4] = _msg_buffer[4];
+
+		if (write_message(LogType::Full, _delta_buffer, delta_msg_size)) {
+			written = delta_msg_size;
+			++sub.delta_samples;
+		}
+
+	} else if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+		written = msg_size;
+		sub.delta_samples = 0;
+	}
+
+	if (written > 0) {
+		memcpy(sub.delta_reference, data, data_size);
+		sub.delta_keyframe_required = false;
+
+	} else {
+		// the decoder misses this sample, so the next one must not refer to it
+		sub.delta_keyframe_required = true;
+	}
+
+	return written;
+}
+
+size_t Logger::encode_delta(const uint8_t *reference, const uint8_t *data, size_t size, uint8_t *out)
+{
+	size_t out_size = 0;
+	size_t i = 0;
+
+	while (i < size) {
+		const bool unchanged = data[i] == reference[i];
+		size_t run = 1;
+
+		while (i + run < size && run < ULOG_DATA_DELTA_MAX_RUN && (data[i + run] == reference[i + run]) == unchanged) {
+			++run;
+		}
+
+		if (unchanged) {
+			if (i + run == size) {
+				// trailing unchanged bytes are implicit
+				break;
+			}
+
+			out[out_size++] = ULOG_DATA_DELTA_UNCHANGED | (uint8_t)(run - 1);
 
-	if (sub.valid()) {
-		updated = sub.update(buffer);
+		} else {
+			if (out_size + 1 + run >= size) {
+				return size;
+			}
 
-	} else if (try_to_subscribe) {
-		if (sub.subscribe()) {
-			write_add_logged_msg(LogType::Full, sub);
+			out[out_size++] = (uint8_t)(run - 1);
 
-			if (sub_idx < _num_mission_subs) {
-				write_add_logged_msg(LogType::Mission, sub);
+			for (size_t j = i; j < i + run; ++j) {
+				out[out_size++] = data[j] ^ reference[j];
 			}
+		}
+
+		if (out_size >= size) {
+			return size;
+		}
+
+		i += run;
+	}
+
+	return out_size;
+}
+
+bool Logger::initialize_delta_encoding()
+{
+	int32_t delta_encoding = 0;
+
+	if (_delta_encoding != PARAM_INVALID) {
+		param_get(_delta_encoding, &delta_encoding);
+	}
+
+	if (delta_encoding == 0 || _num_subscriptions == 0) {
+		return true;
+	}
+
+	if (_black_box_triggers != 0) {
+		// dropping the oldest data would break the references
+		PX4_WARN("delta encoding is not supported with black box logging");
+		return true;
+	}
+
+	if (_writer.backend() & LogWriter::BackendUdp) {
+		// the udp stream shares the full log data, and a lost datagram would break the references
+		PX4_WARN("delta encoding is not supported with udp logging");
+		return true;
+	}
+
+	size_t references_size = 0;
+
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		references_size += _subscriptions[i].get_topic()->o_size_no_padding;
+	}
+
+	_delta_buffer = new uint8_t[_msg_buffer_len];
+	_delta_references = new uint8_t[references_size];
+
+	if (!_delta_buffer || !_delta_references) {
+		PX4_ERR("failed to alloc delta encoding buffers");
+		return false;
+	}
+
+	uint8_t *reference = _delta_references;
+
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		_subscriptions[i].delta_reference = reference;
+		reference += _subscriptions[i].get_topic()->o_size_no_padding;
+	}
+
+	PX4_INFO("delta encoding enabled (%zu bytes)", references_size);
+	return true;
+}
+
+void Logger::request_delta_keyframes()
+{
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		_subscriptions[i].delta_keyframe_required = true;
+	}
+}
+
+size_t Logger::write_aggregate(LoggerSubscription &sub)
+{
+	if (sub.aggregate_msg_id == MSG_ID_INVALID) {
+		return 0;
+	}
+
+	const size_t msg_size = sizeof(ulog_message_data_header_s) + sub.aggregate->data_size();
+	const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+
+	_aggregate_buffer[0] = (uint8_t)write_msg_size;
+	_aggregate_buffer[1] = (uint8_t)(write_msg_size >> 8);
+	_aggregate_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+	_aggregate_buffer[3] = sub.aggregate_msg_id;
+	_aggregate_buffer[4] = 0;
+
+	// all topics start with the timestamp
+	uint64_t timestamp;
+	memcpy(&timestamp, _msg_buffer + sizeof(ulog_message_data_header_s), sizeof(timestamp));
+	sub.aggregate->get(_aggregate_buffer + sizeof(ulog_message_data_header_s), timestamp);
+
+	if (write_message(LogType::Full, _aggregate_buffer, msg_size)) {
+		return msg_size;
+	}
+
+	return 0;
+}
 
-			// copy first data
-			updated = sub.copy(buffer);
+void Logger::add_index_entry(hrt_abstime timestamp)
+{
+	if (!_index_timestamps || !_writer.is_writing_file(LogType::Full)) {
+		return;
+	}
+
+	if (++_index_skipped < _index_decimation) {
+		return;
+	}
+
+	_index_skipped = 0;
+
+	if (_index_count == MAX_INDEX_ENTRIES) {
+		// keep every other entry and double the interval
+		for (int i = 0; i < MAX_INDEX_ENTRIES / 2; ++i) {
+			_index_timestamps[i] = _index_timestamps[2 * i];
+			_index_offsets[i] = _index_offsets[2 * i];
 		}
+
+		_index_count = MAX_INDEX_ENTRIES / 2;
+		_index_decimation *= 2;
 	}
 
-	return updated;
+	_index_timestamps[_index_count] = timestamp;
+	_index_offsets[_index_count] = _writer.get_stream_position_file(LogType::Full);
+	++_index_count;
+}
+
+void Logger::write_index()
+{
+	_writer.select_write_backend(LogWriter::BackendFile);
+	_writer.lock();
+	const uint64_t index_start = _writer.get_stream_position_file(LogType::Full);
+	write_info_multiple_array(LogType::Full, "uint64_t", "index_timestamp", _index_timestamps, sizeof(uint64_t),
+				  _index_count);
+	write_info_multiple_array(LogType::Full, "uint64_t", "index_offset", _index_offsets, sizeof(uint64_t), _index_count);
+	write_info_multiple_array(LogType::Full, "uint64_t", "index_topic_offset", _index_topic_offsets, sizeof(uint64_t),
+				  _next_topic_id);
+	_writer.unlock();
+
+	// fixed size message at the very end of the file, so that tools find the index without parsing the log
+	write_info_template<uint64_t>(LogType::Full, "index_start", index_start, "uint64_t");
+	_writer.unselect_write_backend();
+}
+
+void Logger::write_info_multiple_array(LogType type, const char *type_str, const char *name, const void *data,
+				       size_t element_size, int count)
+{
+	static constexpr int max_elements = 32;
+	static constexpr size_t max_key_len = 48;
+	uint8_t buffer[sizeof(ulog_message_info_multiple_header_s) - sizeof(ulog_message_info_multiple_header_s::key)
+		       + max_key_len + max_elements * sizeof(uint64_t)];
+	ulog_message_info_multiple_header_s *msg = reinterpret_cast<ulog_message_info_multiple_header_s *>(buffer);
+	const size_t header_size = sizeof(ulog_message_info_multiple_header_s) - sizeof(ulog_message_info_multiple_header_s::key);
+	const uint8_t *elements = static_cast<const uint8_t *>(data);
+
+	if (element_size > sizeof(uint64_t)) {
+		return;
+	}
+
+	for (int i = 0; i < count; i += max_elements) {
+		const int n = math::min(count - i, max_elements);
+		msg->msg_type = static_cast<uint8_t>(ULogMessageType::INFO_MULTIPLE);
+		msg->is_continued = i > 0;
+		msg->key_len = math::min(snprintf(msg->key, max_key_len, "%s[%i] %s", type_str, n, name), (int)max_key_len - 1);
+
+		const size_t msg_size = header_size + msg->key_len + n * element_size;
+		memcpy(&buffer[header_size + msg->key_len], &elements[i * element_size], n * element_size);
+		msg->msg_size = msg_size - ULOG_MSG_HEADER_LEN;
+
+		write_message(type, buffer, msg_size);
+	}
+}
+
+void Logger::write_lost_messages(LogType type)
+{
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		LoggerSubscription &sub = _subscriptions[i];
+
+		if (sub.drain_queue && sub.lost_messages != sub.lost_messages_logged) {
+			char name[64];
+			snprintf(name, sizeof(name), "lost_msgs_%s_%i", sub.get_topic()->o_name, sub.get_instance());
+			write_info(type, name, sub.lost_messages);
+			sub.lost_messages_logged = sub.lost_messages;
+		}
+	}
 }
 
 const char *Logger::configured_backend_mode() const
@@ -445,7 +791,9 @@ const char *Logger::configured_backend_mode() const
 
 	case LogWriter::BackendMavlink: return "mavlink";
 
-	case LogWriter::BackendAll: return "all";
+	case LogWriter::BackendUdp: return "udp";
+
+	case LogWriter::BackendFile | LogWriter::BackendMavlink: return "all";
 
 	default: return "several";
 	}
@@ -495,20 +843,66 @@ bool Logger::initialize_topics(MissionLogType mission_log_mode)
 
 	delete[](_subscriptions);
 	_subscriptions = nullptr;
+	delete[](_updated_subscriptions);
+	_updated_subscriptions = nullptr;
 
 	if (logged_topics.subscriptions().count > 0) {
 		_subscriptions = new LoggerSubscription[logged_topics.subscriptions().count];
+		_updated_subscriptions = new px4::atomic<uint32_t>[(logged_topics.subscriptions().count + 31) / 32];
 
-		if (!_subscriptions) {
+		if (!_subscriptions || !_updated_subscriptions) {
 			PX4_ERR("alloc failed");
 			return false;
 		}
 
+		int32_t queued_logging = 0;
+		int32_t queue_length = 0;
+
+		if (_queued_logging != PARAM_INVALID) {
+			param_get(_queued_logging, &queued_logging);
+		}
+
+		if (_queue_length != PARAM_INVALID) {
+			param_get(_queue_length, &queue_length);
+		}
+
+		int32_t aggregate_all = 0;
+
+		if (_aggregate_handle != PARAM_INVALID) {
+			param_get(_aggregate_handle, &aggregate_all);
+		}
+
 		for (int i = 0; i < logged_topics.subscriptions().count; ++i) {
 			const LoggedTopics::RequestedSubscription &sub = logged_topics.subscriptions().sub[i];
 			// if we poll on a topic, we don't use the interval and let the polled topic define the maximum interval
 			uint16_t interval_ms = _polling_topic_meta ? 0 : sub.interval_ms;
-			_subscriptions[i] = LoggerSubscription(sub.topic, interval_ms, sub.instance);
+
+			if (interval_ms > 0 && (sub.aggregate || aggregate_all != 0)) {
+				// every sample is read and aggregated, the interval is applied when writing
+				Aggregate *aggregate = new Aggregate();
+
+				if (aggregate && aggregate->init(sub.topic) && aggregate->data_size() <= MAX_AGGREGATE_SIZE) {
+					_subscriptions[i] = LoggerSubscription(sub.topic, 0, sub.instance);
+					_subscriptions[i].aggregate = aggregate;
+					_subscriptions[i].aggregate_interval = interval_ms * 1000;
+
+				} else {
+					PX4_WARN("cannot aggregate %s", sub.topic->o_name);
+					delete aggregate;
+					_subscriptions[i] = LoggerSubscription(sub.topic, interval_ms, sub.instance);
+				}
+
+			} else {
+				_subscriptions[i] = LoggerSubscription(sub.topic, interval_ms, sub.instance);
+			}
+
+			_subscriptions[i].set_updated_flag(&_updated_subscriptions[i / 32], 1u << (i % 32));
+
+			// topics logged at full rate: log every queued sample
+			if (queued_logging != 0 && sub.interval_ms == 0) {
+				_subscriptions[i].drain_queue = true;
+				_subscriptions[i].queue_length = math::constrain(queue_length, (int32_t)0, (int32_t)UINT8_MAX);
+			}
 		}
 	}
 
@@ -590,6 +984,69 @@ void Logger::run()
 			PX4_ERR("failed to alloc message buffer");
 			return;
 		}
+
+		size_t max_aggregate_size = 0;
+
+		for (int sub = 0; sub < _num_subscriptions; ++sub) {
+			if (_subscriptions[sub].aggregate && _subscriptions[sub].aggregate->data_size() > max_aggregate_size) {
+				max_aggregate_size = _subscriptions[sub].aggregate->data_size();
+			}
+		}
+
+		if (max_aggregate_size > 0) {
+			_aggregate_buffer = new uint8_t[sizeof(ulog_message_data_header_s) + max_aggregate_size];
+
+			if (!_aggregate_buffer) {
+				PX4_ERR("failed to alloc aggregate buffer");
+				return;
+			}
+		}
+	}
+
+	if (_black_box_triggers_handle != PARAM_INVALID) {
+		param_get(_black_box_triggers_handle, &_black_box_triggers);
+	}
+
+	if (_black_box_triggers != 0) {
+		float pre_window = 10.f;
+		float post_window = 10.f;
+
+		if (_black_box_pre_handle != PARAM_INVALID) {
+			param_get(_black_box_pre_handle, &pre_window);
+		}
+
+		if (_black_box_post_handle != PARAM_INVALID) {
+			param_get(_black_box_post_handle, &post_window);
+		}
+
+		_black_box_pre_window = (hrt_abstime)(math::max(pre_window, 0.f) * 1e6f);
+		_black_box_post_window = (hrt_abstime)(math::max(post_window, 0.f) * 1e6f);
+		PX4_INFO("black box logging enabled (%.1f s / %.1f s)", (double)pre_window, (double)post_window);
+	}
+
+	if (!initialize_delta_encoding()) {
+		return;
+	}
+
+	int32_t log_index = 0;
+
+	if (_index_handle != PARAM_INVALID) {
+		param_get(_index_handle, &log_index);
+	}
+
+	if (log_index != 0 && _black_box_triggers != 0) {
+		// the offsets change when held data is dropped
+		PX4_WARN("log index is not supported with black box logging");
+
+	} else if (log_index != 0) {
+		_index_timestamps = new uint64_t[MAX_INDEX_ENTRIES];
+		_index_offsets = new uint64_t[MAX_INDEX_ENTRIES];
+		_index_topic_offsets = new uint64_t[MSG_ID_INVALID];
+
+		if (!_index_timestamps || !_index_offsets || !_index_topic_offsets) {
+			PX4_ERR("failed to alloc log index");
+			return;
+		}
 	}
 
 
@@ -660,6 +1117,8 @@ void Logger::run()
 		/* check for logging command from MAVLink (start/stop streaming) */
 		handle_vehicle_command_update();
 
+		handle_black_box();
+
 		if (timer_callback_data.watchdog_triggered) {
 			timer_callback_data.watchdog_triggered = false;
 			initialize_load_output(PrintLoadReason::Watchdog);
@@ -696,49 +1155,62 @@ void Logger::run()
 			/* wait for lock on log buffer */
 			_writer.lock();
 
-			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
-				LoggerSubscription &sub = _subscriptions[sub_idx];
-				/* if this topic has been updated, copy the new data into the message buffer
-				 * and write a message to the log
-				 */
-				const bool try_to_subscribe = (sub_idx == next_subscribe_topic_index);
-
-				if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_header_s), try_to_subscribe)) {
-					// each message consists of a header followed by an orb data object
-					const size_t msg_size = sizeof(ulog_message_data_header_s) + sub.get_topic()->o_size_no_padding;
-					const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
-					const uint16_t write_msg_id = sub.msg_id;
+			if (next_subscribe_topic_index != -1) {
+				try_to_subscribe(next_subscribe_topic_index);
+			}
 
-					//write one byte after another (necessary because of alignment)
-					_msg_buffer[0] = (uint8_t)write_msg_size;
-					_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
-					_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
-					_msg_buffer[3] = (uint8_t)write_msg_id;
-					_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+			/* only visit the subscriptions flagged by their publication callback */
+			for (int word = 0; word < (_num_subscriptions + 31) / 32; ++word) {
+				uint32_t updated = _updated_subscriptions[word].fetch_and(0);
 
-					// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+				for (int sub_idx = word * 32; updated != 0; ++sub_idx, updated >>= 1) {
+					if ((updated & 1) == 0) {
+						continue;
+					}
 
-					// full log
-					if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+					LoggerSubscription &sub = _subscriptions[sub_idx];
 
-#ifdef DBGPRINT
-						total_bytes += msg_size;
-#endif /* DBGPRINT */
+					if (!sub.registered()) {
+						// no callback for this topic, poll it on every iteration
+						sub.call();
 					}
 
-					// mission log
-					if (sub_idx < _num_mission_subs) {
-						if (_writer.is_started(LogType::Mission)) {
-							if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
-								unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
-
-								if (delta_time > 0) {
-									_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
-								}
+					if (sub.aggregate) {
+						if (sub.update(_msg_buffer + sizeof(ulog_message_data_header_s))) {
+							sub.aggregate->add(_msg_buffer + sizeof(ulog_message_data_header_s));
 
-								write_message(LogType::Mission, _msg_buffer, msg_size);
+							if (loop_time >= sub.aggregate_next_write) {
+								sub.aggregate_next_write = loop_time + sub.aggregate_interval;
+								total_bytes += write_subscription_data(sub_idx, loop_time);
+								total_bytes += write_aggregate(sub);
 							}
 						}
+
+						continue;
+					}
+
+					if (sub.drain_queue) {
+						// write all queued samples, at most a full queue per iteration
+						for (int i = 0; i < UINT8_MAX && sub.update_queued(_msg_buffer + sizeof(ulog_message_data_header_s)); ++i) {
+							total_bytes += write_subscription_data(sub_idx, loop_time);
+						}
+
+						if (sub.unread()) {
+							sub.call();
+						}
+
+						continue;
+					}
+
+					/* if this topic has been updated, copy the new data into the message buffer
+					 * and write a message to the log
+					 */
+					if (sub.update(_msg_buffer + sizeof(ulog_message_data_header_s))) {
+						total_bytes += write_subscription_data(sub_idx, loop_time);
+
+					} else if (sub.unread()) {
+						// limited by the logging interval, check again on the next iteration
+						sub.call();
 					}
 				}
 			}
@@ -764,8 +1236,10 @@ void Logger::run()
 				}
 			}
 
-			// Add sync magic
+			// Add sync magic (which is also the seek point of the index)
 			if (loop_time - _last_sync_time > 500_ms) {
+				add_index_entry(loop_time);
+
 				uint16_t write_msg_size = static_cast<uint16_t>(sizeof(ulog_message_sync_s) - ULOG_MSG_HEADER_LEN);
 				_msg_buffer[0] = (uint8_t)write_msg_size;
 				_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
@@ -787,6 +1261,10 @@ void Logger::run()
 
 			// update buffer statistics
 			for (int i = 0; i < (int)LogType::Count; ++i) {
+				if (!_statistics[i].dropout_start && loop_time - _statistics[i].window_start > 1_s) {
+					reset_dropout_window((LogType)i, loop_time);
+				}
+
 				if (!_statistics[i].dropout_start && (_writer.get_buffer_fill_count_file((LogType)i) > _statistics[i].high_water)) {
 					_statistics[i].high_water = _writer.get_buffer_fill_count_file((LogType)i);
 				}
@@ -795,6 +1273,11 @@ void Logger::run()
 			/* release the log buffer */
 			_writer.unlock();
 
+			if (loop_time - _last_lost_messages_time > 1_s) {
+				write_lost_messages(LogType::Full);
+				_last_lost_messages_time = loop_time;
+			}
+
 			/* notify the writer thread */
 			_writer.notify();
 
@@ -829,6 +1312,17 @@ void Logger::run()
 			} else if (loop_time > next_subscribe_check) {
 				next_subscribe_topic_index = 0;
 			}
+
+			// prepare the definitions for the next log start once parameter changes have settled
+			if ((_writer.backend() & LogWriter::BackendFile) && !_definitions_cache_disabled && !definitions_cache_valid()) {
+				if (_definitions_invalid_time == 0) {
+					_definitions_invalid_time = loop_time;
+
+				} else if (loop_time - _definitions_invalid_time > 1_s) {
+					update_definitions_cache();
+					_definitions_invalid_time = 0;
+				}
+			}
 		}
 
 		// wait for next loop iteration...
@@ -1009,12 +1503,102 @@ void Logger::handle_vehicle_command_update()
 		} else if (command.command == vehicle_command_s::VEHICLE_CMD_LOGGING_STOP) {
 			stop_log_mavlink();
 			ack_vehicle_command(&command, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
+
+		} else if (command.command == vehicle_command_s::VEHICLE_CMD_USER_1 && (_black_box_triggers & BlackBoxTrigger::Command)) {
+			if (_writer.is_started(LogType::Full, LogWriter::BackendFile)) {
+				trigger_black_box("command");
+				ack_vehicle_command(&command, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
+
+			} else {
+				ack_vehicle_command(&command, vehicle_command_s::VEHICLE_CMD_RESULT_TEMPORARILY_REJECTED);
+			}
+		}
+	}
+}
+
+void Logger::handle_black_box()
+{
+	if (_black_box_triggers == 0) {
+		return;
+	}
+
+	vehicle_status_s vehicle_status;
+
+	if (_black_box_status_sub.update(&vehicle_status)) {
+		// trigger on rising edges only, so that a persisting condition does not log continuously
+		const bool failsafe = vehicle_status.failsafe;
+		const bool failure = vehicle_status.failure_detector_status != 0;
+		const bool logging = _writer.is_started(LogType::Full, LogWriter::BackendFile);
+
+		if (logging && (_black_box_triggers & BlackBoxTrigger::Failsafe) && failsafe && !_black_box_failsafe) {
+			trigger_black_box("failsafe");
 		}
+
+		if (logging && (_black_box_triggers & BlackBoxTrigger::FailureDetector) && failure && !_black_box_failure) {
+			trigger_black_box("failure detector");
+		}
+
+		_black_box_failsafe = failsafe;
+		_black_box_failure = failure;
+	}
+
+	if (_black_box_trigger_time != 0 && hrt_elapsed_time(&_black_box_trigger_time) > _black_box_post_window) {
+		_black_box_trigger_time = 0;
+
+		if (_writer.is_started(LogType::Full, LogWriter::BackendFile) && !_should_stop_file_log) {
+			// end of the post-trigger window: close this log and wait for the next trigger with a new one
+			stop_log_file(LogType::Full);
+			start_log_file(LogType::Full);
+		}
+	}
+}
+
+void Logger::trigger_black_box(const char *reason)
+{
+	if (_black_box_trigger_time == 0) {
+		mavlink_log_info(&_mavlink_log_pub, "[logger] black box triggered (%s)", reason);
+		_writer.release_hold_file(LogType::Full);
 	}
+
+	// a new trigger extends the post-trigger window
+	_black_box_trigger_time = hrt_absolute_time();
 }
 
 bool Logger::write_message(LogType type, void *ptr, size_t size)
 {
+	if (_definitions_capture) {
+		if (_definitions_cache_disabled) {
+			return false;
+		}
+
+		if (_definitions_cache_size + size > _definitions_cache_capacity) {
+			size_t capacity = math::max(_definitions_cache_capacity * 2, (size_t)4096);
+
+			while (capacity < _definitions_cache_size + size) {
+				capacity *= 2;
+			}
+
+			uint8_t *cache = (capacity <= DEFINITIONS_CACHE_MAX_SIZE) ? new uint8_t[capacity] : nullptr;
+
+			if (cache == nullptr) {
+				_definitions_cache_disabled = true;
+				return false;
+			}
+
+			if (_definitions_cache) {
+				memcpy(cache, _definitions_cache, _definitions_cache_size);
+				delete[](_definitions_cache);
+			}
+
+			_definitions_cache = cache;
+			_definitions_cache_capacity = capacity;
+		}
+
+		memcpy(_definitions_cache + _definitions_cache_size, ptr, size);
+		_definitions_cache_size += size;
+		return true;
+	}
+
 	Statistics &stats = _statistics[(int)type];
 
 	if (_writer.write_message(type, ptr, size, stats.dropout_start) != -1) {
@@ -1027,6 +1611,7 @@ bool Logger::write_message(LogType type, void *ptr, size_t size)
 			}
 
 			stats.dropout_start = 0;
+			write_dropout_info(type, dropout_duration);
 		}
 
 		return true;
@@ -1036,11 +1621,56 @@ bool Logger::write_message(LogType type, void *ptr, size_t size)
 		stats.dropout_start = hrt_absolute_time();
 		++stats.write_dropouts;
 		stats.high_water = 0;
+
+		// record the writer state since the start of the measurement window
+		const float dt = (stats.dropout_start - stats.window_start) * 1e-6f;
+		uint32_t write_time, fsync_time;
+		_writer.get_write_times_file(type, write_time, fsync_time);
+		stats.dropout_topic = _current_topic;
+		stats.dropout_buffer_fill = _writer.get_buffer_fill_count_file(type);
+
+		if (stats.window_start > 0 && dt > 0.f) {
+			stats.dropout_write_load = (write_time - stats.window_write_time) * 1e-6f / dt;
+			stats.dropout_fsync_load = (fsync_time - stats.window_fsync_time) * 1e-6f / dt;
+			stats.dropout_write_rate = (_writer.get_total_written_file(type) - stats.window_written) / 1024.f / dt;
+
+		} else {
+			stats.dropout_write_load = stats.dropout_fsync_load = stats.dropout_write_rate = 0.f;
+		}
 	}
 
 	return false;
 }
 
+void Logger::reset_dropout_window(LogType type, hrt_abstime now)
+{
+	Statistics &stats = _statistics[(int)type];
+	stats.window_start = now;
+	_writer.get_write_times_file(type, stats.window_write_time, stats.window_fsync_time);
+	stats.window_written = _writer.get_total_written_file(type);
+}
+
+void Logger::write_dropout_info(LogType type, float dropout_duration)
+{
+	const Statistics &stats = _statistics[(int)type];
+	ulog_message_logging_s msg;
+
+	// low write load with a full buffer means the writer thread did not get enough CPU time,
+	// a high write load with a low rate means the storage is slow
+	int message_len = snprintf(msg.message, sizeof(msg.message),
+				   "dropout %.3f s: buf %zu/%zu B, write %.0f%% fsync %.0f%%, %.1f KiB/s, topic %s",
+				   (double)dropout_duration, stats.dropout_buffer_fill, _writer.get_buffer_size_file(type),
+				   (double)(stats.dropout_write_load * 100.f), (double)(stats.dropout_fsync_load * 100.f),
+				   (double)stats.dropout_write_rate, stats.dropout_topic ? stats.dropout_topic->o_name : "-");
+	message_len = math::min(message_len, (int)sizeof(msg.message) - 1);
+
+	msg.log_level = '4'; // warning
+	msg.timestamp = hrt_absolute_time();
+	msg.msg_size = sizeof(msg) - sizeof(msg.message) - ULOG_MSG_HEADER_LEN + message_len;
+
+	write_message(type, &msg, msg.msg_size + ULOG_MSG_HEADER_LEN);
+}
+
 int Logger::create_log_dir(LogType type, tm *tt, char *log_dir, int log_dir_len)
 {
 	LogFileName &file_name = _file_name[(int)type];
@@ -1180,6 +1810,10 @@ void Logger::setReplayFile(const char *file_name)
 
 void Logger::start_log_file(LogType type)
 {
+	if (type == LogType::Full) {
+		start_log_udp();
+	}
+
 	if (_writer.is_started(type, LogWriter::BackendFile) || (_writer.backend() & LogWriter::BackendFile) == 0) {
 		return;
 	}
@@ -1198,15 +1832,43 @@ void Logger::start_log_file(LogType type)
 		mavlink_log_info(&_mavlink_log_pub, "[logger] file: %s", file_name);
 	}
 
+	if (type == LogType::Full) {
+		request_delta_keyframes();
+	}
+
+	if (type == LogType::Full && _index_timestamps) {
+		_index_count = 0;
+		_index_decimation = 1;
+		_index_skipped = 0;
+		memset(_index_topic_offsets, 0xff, MSG_ID_INVALID * sizeof(uint64_t));
+	}
+
 	_writer.start_log_file(type, file_name);
 	_writer.select_write_backend(LogWriter::BackendFile);
 	_writer.set_need_reliable_transfer(true);
 	write_header(type);
 	write_version(type);
-	write_formats(type);
+
+	if (type == LogType::Full && !_definitions_cache_disabled && !definitions_cache_valid()) {
+		update_definitions_cache();
+	}
+
+	if (type == LogType::Full && definitions_cache_valid()) {
+		// formats and parameters in one write
+		_writer.lock();
+		write_message(type, _definitions_cache, _definitions_cache_size);
+		_writer.unlock();
+		_writer.notify();
+
+	} else {
+		write_formats(type);
+
+		if (type == LogType::Full) {
+			write_parameters(type);
+		}
+	}
 
 	if (type == LogType::Full) {
-		write_parameters(type);
 		write_perf_data(true);
 		write_console_output();
 	}
@@ -1216,6 +1878,12 @@ void Logger::start_log_file(LogType type)
 	_writer.unselect_write_backend();
 	_writer.notify();
 
+	if (type == LogType::Full && _black_box_triggers != 0) {
+		// keep the data in RAM until a trigger fires (the header section is written)
+		_writer.hold_file(LogType::Full, _black_box_pre_window);
+		_black_box_trigger_time = 0;
+	}
+
 	if (type == LogType::Full) {
 		/* reset performance counters to get in-flight min and max values in post flight log */
 		perf_reset_all();
@@ -1229,6 +1897,10 @@ void Logger::start_log_file(LogType type)
 
 void Logger::stop_log_file(LogType type)
 {
+	if (type == LogType::Full) {
+		stop_log_udp();
+	}
+
 	if (!_writer.is_started(type, LogWriter::BackendFile)) {
 		return;
 	}
@@ -1236,6 +1908,11 @@ void Logger::stop_log_file(LogType type)
 	if (type == LogType::Full) {
 		_writer.set_need_reliable_transfer(true);
 		write_perf_data(false);
+
+		if (_index_timestamps) {
+			write_index();
+		}
+
 		_writer.set_need_reliable_transfer(false);
 	}
 
@@ -1250,7 +1927,14 @@ void Logger::start_log_mavlink()
 
 	PX4_INFO("Start mavlink log");
 
-	_writer.start_log_mavlink();
+	int32_t compress = 0;
+
+	if (_mavlink_compress != PARAM_INVALID) {
+		param_get(_mavlink_compress, &compress);
+	}
+
+	request_delta_keyframes();
+	_writer.start_log_mavlink(compress != 0);
 	_writer.select_write_backend(LogWriter::BackendMavlink);
 	_writer.set_need_reliable_transfer(true);
 	write_header(LogType::Full);
@@ -1274,6 +1958,46 @@ void Logger::stop_log_mavlink()
 	_writer.stop_log_mavlink();
 }
 
+void Logger::start_log_udp()
+{
+	if (_writer.is_started(LogType::Full, LogWriter::BackendUdp) || (_writer.backend() & LogWriter::BackendUdp) == 0) {
+		return;
+	}
+
+	PX4_INFO("Start udp log");
+
+	int32_t fec_group_size = 0;
+
+	if (_udp_fec_handle != PARAM_INVALID) {
+		param_get(_udp_fec_handle, &fec_group_size);
+	}
+
+	request_delta_keyframes();
+	_writer.start_log_udp(fec_group_size);
+	_writer.select_write_backend(LogWriter::BackendUdp);
+	_writer.set_need_reliable_transfer(true);
+	write_header(LogType::Full);
+	write_version(LogType::Full);
+	write_formats(LogType::Full);
+	write_parameters(LogType::Full);
+	write_perf_data(true);
+	write_console_output();
+	write_all_add_logged_msg(LogType::Full);
+	_writer.set_need_reliable_transfer(false);
+	_writer.unselect_write_backend();
+	_writer.notify();
+}
+
+void Logger::stop_log_udp()
+{
+	if (!_writer.is_started(LogType::Full, LogWriter::BackendUdp)) {
+		return;
+	}
+
+	PX4_INFO("Stop udp log");
+	_writer.stop_log_udp();
+}
+
 struct perf_callback_data_t {
 	Logger *logger;
 	int counter;
@@ -1439,77 +2163,32 @@ void Logger::write_format(LogType type, const orb_metadata &meta, WrittenFormats
 		PX4_ERR("Array too small");
 	}
 
-	// Now go through the fields and check for nested type usages.
-	// o_fields looks like this for example: "uint64_t timestamp;uint8_t[5] array;"
-	const char *fmt = meta.o_fields;
-
-	while (fmt && *fmt) {
-		// extract the type name
-		char type_name[64];
-		const char *space = strchr(fmt, ' ');
+	// Now go through the fields and check for nested type usages
+	for (uint16_t field = 0; field < meta.o_num_fields; ++field) {
+		const char *nested_type = meta.o_field_list[field].nested_type;
 
-		if (!space) {
-			PX4_ERR("invalid format %s", fmt);
-			break;
+		if (meta.o_field_list[field].type != ORB_FIELD_TYPE_NESTED || !nested_type) {
+			continue;
 		}
 
-		const char *array_start = strchr(fmt, '['); // check for an array
-
-		int type_length;
-
-		if (array_start && array_start < space) {
-			type_length = array_start - fmt;
-
-		} else {
-			type_length = space - fmt;
-		}
-
-		if (type_length >= (int)sizeof(type_name)) {
-			PX4_ERR("buf len too small");
-			break;
-		}
+		// find orb meta for type
+		const orb_metadata *const *topics = orb_get_topics();
+		const orb_metadata *found_topic = nullptr;
 
-		memcpy(type_name, fmt, type_length);
-		type_name[type_length] = '\0';
-
-		// ignore built-in types
-		if (strcmp(type_name, "int8_t") != 0 &&
-		    strcmp(type_name, "uint8_t") != 0 &&
-		    strcmp(type_name, "int16_t") != 0 &&
-		    strcmp(type_name, "uint16_t") != 0 &&
-		    strcmp(type_name, "int16_t") != 0 &&
-		    strcmp(type_name, "uint16_t") != 0 &&
-		    strcmp(type_name, "int32_t") != 0 &&
-		    strcmp(type_name, "uint32_t") != 0 &&
-		    strcmp(type_name, "int64_t") != 0 &&
-		    strcmp(type_name, "uint64_t") != 0 &&
-		    strcmp(type_name, "float") != 0 &&
-		    strcmp(type_name, "double") != 0 &&
-		    strcmp(type_name, "bool") != 0 &&
-		    strcmp(type_name, "char") != 0) {
-
-			// find orb meta for type
-			const orb_metadata *const *topics = orb_get_topics();
-			const orb_metadata *found_topic = nullptr;
-
-			for (size_t i = 0; i < orb_topics_count(); i++) {
-				if (strcmp(topics[i]->o_name, type_name) == 0) {
-					found_topic = topics[i];
-				}
+		for (size_t i = 0; i < orb_topics_count(); i++) {
+			if (strcmp(topics[i]->o_name, nested_type) == 0) {
+				found_topic = topics[i];
+				break;
 			}
+		}
 
-			if (found_topic) {
+		if (found_topic) {
 
-				write_format(type, *found_topic, written_formats, msg, subscription_index, level + 1);
+			write_format(type, *found_topic, written_formats, msg, subscription_index, level + 1);
 
-			} else {
-				PX4_ERR("No definition for topic %s found", fmt);
-			}
+		} else {
+			PX4_ERR("No definition for topic %s found", nested_type);
 		}
-
-		fmt = strchr(fmt, ';');
-
-		if (fmt) { ++fmt; }
 	}
 }
 
@@ -1533,9 +2212,42 @@ void Logger::write_formats(LogType type)
 		write_format(type, *sub.get_topic(), written_formats, msg, i);
 	}
 
+	if (type == LogType::Full && _aggregate_buffer) {
+		write_aggregate_formats(type, msg);
+	}
+
 	_writer.unlock();
 }
 
+void Logger::write_aggregate_formats(LogType type, ulog_message_format_s &msg)
+{
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		const orb_metadata *meta = _subscriptions[i].get_topic();
+		bool written = !_subscriptions[i].aggregate;
+
+		// multiple instances share the format
+		for (int j = 0; j < i && !written; ++j) {
+			written = _subscriptions[j].aggregate && _subscriptions[j].get_topic() == meta;
+		}
+
+		if (written) {
+			continue;
+		}
+
+		int format_len = Aggregate::format(meta, msg.format, sizeof(msg.format));
+
+		if (format_len < 0) {
+			PX4_ERR("aggregate format too long (%s)", meta->o_name);
+			continue;
+		}
+
+		size_t msg_size = sizeof(msg) - sizeof(msg.format) + format_len;
+		msg.msg_size = msg_size - ULOG_MSG_HEADER_LEN;
+
+		write_message(type, &msg, msg_size);
+	}
+}
+
 void Logger::write_all_add_logged_msg(LogType type)
 {
 	_writer.lock();
@@ -1558,25 +2270,42 @@ void Logger::write_all_add_logged_msg(LogType type)
 }
 
 void Logger::write_add_logged_msg(LogType type, LoggerSubscription &subscription)
+{
+	write_add_logged_msg(type, subscription.msg_id, subscription.get_instance(), subscription.get_topic()->o_name);
+
+	if (type == LogType::Full && subscription.aggregate) {
+		char message_name[sizeof(ulog_message_add_logged_s::message_name)];
+
+		if (Aggregate::message_name(subscription.get_topic(), message_name, sizeof(message_name)) > 0) {
+			write_add_logged_msg(type, subscription.aggregate_msg_id, subscription.get_instance(), message_name);
+		}
+	}
+}
+
+void Logger::write_add_logged_msg(LogType type, uint8_t &msg_id, uint8_t multi_id, const char *message_name)
 {
 	ulog_message_add_logged_s msg;
 
-	if (subscription.msg_id == MSG_ID_INVALID) {
+	if (msg_id == MSG_ID_INVALID) {
 		if (_next_topic_id == MSG_ID_INVALID) {
 			// if we land here an uint8 is too small -> switch to uint16
 			PX4_ERR("limit for _next_topic_id reached");
 			return;
 		}
 
-		subscription.msg_id = _next_topic_id++;
+		msg_id = _next_topic_id++;
 	}
 
-	msg.msg_id = subscription.msg_id;
-	msg.multi_id = subscription.get_instance();
+	msg.msg_id = msg_id;
+	msg.multi_id = multi_id;
+
+	if (type == LogType::Full && _index_topic_offsets && _writer.is_writing_file(LogType::Full)) {
+		_index_topic_offsets[msg.msg_id] = _writer.get_stream_position_file(LogType::Full);
+	}
 
-	int message_name_len = strlen(subscription.get_topic()->o_name);
+	int message_name_len = strlen(message_name);
 
-	memcpy(msg.message_name, subscription.get_topic()->o_name, message_name_len);
+	memcpy(msg.message_name, message_name, message_name_len);
 
 	size_t msg_size = sizeof(msg) - sizeof(msg.message_name) + message_name_len;
 	msg.msg_size = msg_size - ULOG_MSG_HEADER_LEN;
@@ -1696,6 +2425,10 @@ void Logger::write_header(LogType type)
 	flag_bits.msg_size = sizeof(flag_bits) - ULOG_MSG_HEADER_LEN;
 	flag_bits.msg_type = static_cast<uint8_t>(ULogMessageType::FLAG_BITS);
 
+	if (type == LogType::Full && _delta_references) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK;
+	}
+
 	write_message(type, &flag_bits, sizeof(flag_bits));
 
 	_writer.unlock();
@@ -1853,6 +2586,50 @@ void Logger::write_parameters(LogType type)
 	_writer.notify();
 }
 
+bool Logger::definitions_cache_valid() const
+{
+	return _definitions_cache_size > 0 && _definitions_param_generation == param_generation()
+	       && _definitions_param_count_used == param_count_used();
+}
+
+void Logger::update_definitions_cache()
+{
+	const uint32_t generation = param_generation();
+	const unsigned count_used = param_count_used();
+
+	// odd while a parameter write is in progress
+	if (generation & 1) {
+		return;
+	}
+
+	_definitions_cache_size = 0;
+	_definitions_capture = true;
+
+	write_formats(LogType::Full);
+	write_parameters(LogType::Full);
+
+	_definitions_capture = false;
+
+	if (_definitions_cache_disabled) {
+		PX4_WARN("definitions cache disabled (> %zu bytes or no memory)", DEFINITIONS_CACHE_MAX_SIZE);
+		delete[](_definitions_cache);
+		_definitions_cache = nullptr;
+		_definitions_cache_size = 0;
+		_definitions_cache_capacity = 0;
+		return;
+	}
+
+	if (param_generation() != generation) {
+		// changed while serializing, rebuilt with the next log start at the latest
+		_definitions_cache_size = 0;
+		return;
+	}
+
+	_definitions_param_generation = generation;
+	_definitions_param_count_used = count_used;
+	PX4_DEBUG("definitions cache updated (%zu bytes)", _definitions_cache_size);
+}
+
 void Logger::write_changed_parameters(LogType type)
 {
 	_writer.lock();
@@ -1950,11 +2727,15 @@ System logger which logs a configurable set of uORB topics and system printf mes
 (`PX4_WARN` and `PX4_ERR`) to ULog files. These can be used for system and flight performance evaluation,
 tuning, replay and crash analysis.
 
-It supports 2 backends:
+It supports 3 backends:
 - Files: write ULog files to the file system (SD card)
 - MAVLink: stream ULog data via MAVLink to a client (the client must support this)
+- UDP: stream ULog data in large UDP datagrams directly to a logging server (on boards with networking,
+  e.g. Ethernet). It is not limited by the SD card or the MAVLink link. The stream starts and stops together
+  with the full file log. Datagrams are not acknowledged, lost ones can optionally be recovered with
+  parity datagrams (SDLOG_UDP_FEC).
 
-Both backends can be enabled and used at the same time.
+All backends can be enabled and used at the same time.
 
 The file backend supports 2 types of log files: full (the normal log) and a mission
 log. The mission log is a reduced ulog file and can be used for example for geotagging or
@@ -1976,11 +2757,15 @@ $ logger start -e -t
 
 Or if already running:
 $ logger on
+
+Stream the log to a logging server in addition to writing files:
+$ logger start -u 192.168.0.10:14590
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("logger", "system");
 	PRINT_MODULE_USAGE_COMMAND("start");
-	PRINT_MODULE_USAGE_PARAM_STRING('m', "all", "file|mavlink|all", "Backend mode", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('m', "all", "file|mavlink|udp|all", "Backend mode", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('u', nullptr, "<ip>[:<port>]", "Stream the log over UDP to a logging server (port 14590 by default)", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('x', "Enable/disable logging via Aux1 RC channel", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('e', "Enable logging right after start until disarm (otherwise only when armed)", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('f', "Log until shutdown (implies -e)", true);
@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include "aggregate.h"
 #include "log_writer.h"
 #include "messages.h"
 #include <containers/Array.hpp>
@@ -44,7 +45,9 @@
 #include <systemlib/printload.h>
 #include <px4_platform_common/module.h>
 
+#include <px4_platform_common/atomic.h>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/SubscriptionInterval.hpp>
 #include <uORB/topics/log_message.h>
 #include <uORB/topics/manual_control_setpoint.h>
@@ -63,15 +66,94 @@ namespace logger
 
 static constexpr uint8_t MSG_ID_INVALID = UINT8_MAX;
 
-struct LoggerSubscription : public uORB::SubscriptionInterval {
+struct LoggerSubscription : public uORB::SubscriptionCallback {
 
 	uint8_t msg_id{MSG_ID_INVALID};
 
-	LoggerSubscription() = default;
+	LoggerSubscription() : uORB::SubscriptionCallback(nullptr) {}
 
 	LoggerSubscription(const orb_metadata *meta, uint32_t interval_ms = 0, uint8_t instance = 0) :
-		uORB::SubscriptionInterval(meta, interval_ms * 1000, instance)
+		uORB::SubscriptionCallback(meta, interval_ms * 1000, instance)
 	{}
+
+	/**
+	 * Set the bit that is raised on new publications.
+	 * @param updated_word word of Logger::_updated_subscriptions
+	 */
+	void set_updated_flag(px4::atomic<uint32_t> *updated_word, uint32_t updated_bit)
+	{
+		_updated_word = updated_word;
+		_updated_bit = updated_bit;
+	}
+
+	/**
+	 * Subscribe and register the publication callback.
+	 * @return true if subscribed
+	 */
+	bool subscribe()
+	{
+		if (!uORB::SubscriptionCallback::subscribe()) {
+			return false;
+		}
+
+		if (queue_length > 0) {
+			_subscription.increase_queue_size(queue_length);
+		}
+
+		registerCallback();
+
+		// publications before the registration are not signalled
+		call();
+		return true;
+	}
+
+	bool registered() const { return _registered; }
+
+	/**
+	 * @return true if there's data that was not copied yet, independent from the interval
+	 */
+	bool unread() { return _subscription.updated(); }
+
+	/**
+	 * Copy the next queued sample (used with drain_queue) and count the lost ones.
+	 * @return true if a sample was copied
+	 */
+	bool update_queued(void *dst)
+	{
+		uint32_t lost = 0;
+
+		if (_subscription.updated() && _subscription.copy(dst, lost)) {
+			lost_messages += lost;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool drain_queue{false};		///< log every queued sample, not only the latest one
+	uint8_t queue_length{0};		///< uORB queue length to request when subscribing (0: unchanged)
+	uint32_t lost_messages{0};		///< queued samples that were overwritten before being logged
+	uint32_t lost_messages_logged{0};	///< lost_messages at the last write_lost_messages()
+
+	uint8_t *delta_reference{nullptr};	///< last sample written to the full log (only with delta encoding)
+	uint8_t delta_samples{0};		///< delta encoded samples since the last full sample
+	bool delta_keyframe_required{true};	///< next sample must be written in full (start of log or dropout)
+
+	Aggregate *aggregate{nullptr};		///< min/max/mean over the interval (subscribed without interval)
+	uint8_t aggregate_msg_id{MSG_ID_INVALID};
+	uint32_t aggregate_interval{0};		///< [us]
+	hrt_abstime aggregate_next_write{0};
+
+	void call() override
+	{
+		if (_updated_word) {
+			_updated_word->fetch_or(_updated_bit);
+		}
+	}
+
+private:
+	px4::atomic<uint32_t> *_updated_word{nullptr};
+	uint32_t _updated_bit{0};
 };
 
 class Logger : public ModuleBase<Logger>
@@ -85,7 +167,7 @@ public:
 	};
 
 	Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       LogMode log_mode, bool log_name_timestamp);
+	       LogMode log_mode, bool log_name_timestamp, const char *udp_destination = nullptr);
 
 	~Logger();
 
@@ -134,6 +216,8 @@ private:
 
 	static constexpr int		MAX_MISSION_TOPICS_NUM = 5; /**< Maximum number of mission topics */
 	static constexpr unsigned	MAX_NO_LOGFILE = 999;	/**< Maximum number of log files */
+	static constexpr uint8_t	DELTA_KEYFRAME_INTERVAL = 100; /**< Write a full sample after that many delta encoded samples */
+	static constexpr size_t		MAX_AGGREGATE_SIZE = 1024; /**< maximum size of an aggregate message (3 samples) */
 	static constexpr const char	*LOG_ROOT[(int)LogType::Count] = {
 		PX4_STORAGEDIR "/log",
 		PX4_STORAGEDIR "/mission_log"
@@ -152,6 +236,17 @@ private:
 		float max_dropout_duration{0.0f};			///< max duration of dropout [s]
 		size_t write_dropouts{0};				///< failed buffer writes due to buffer overflow
 		size_t high_water{0};					///< maximum used write buffer
+
+		// writer state at dropouts, to distinguish a slow storage from a starved writer thread
+		hrt_abstime window_start{0};				///< start of the current measurement window
+		uint32_t window_write_time{0};				///< writer time in write() at window_start [us]
+		uint32_t window_fsync_time{0};				///< writer time in fsync() at window_start [us]
+		size_t window_written{0};				///< bytes written at window_start
+		const orb_metadata *dropout_topic{nullptr};		///< topic that could not be written at the start of the dropout
+		size_t dropout_buffer_fill{0};				///< used write buffer at the start of the dropout
+		float dropout_write_load{0.f};				///< writer time fraction in write() before the dropout
+		float dropout_fsync_load{0.f};				///< writer time fraction in fsync() before the dropout
+		float dropout_write_rate{0.f};				///< storage throughput before the dropout [KiB/s]
 	};
 
 	struct MissionSubscription {
@@ -170,6 +265,8 @@ private:
 	 */
 	void write_add_logged_msg(LogType type, LoggerSubscription &subscription);
 
+	void write_add_logged_msg(LogType type, uint8_t &msg_id, uint8_t multi_id, const char *message_name);
+
 	/**
 	 * Create logging directory
 	 * @param type
@@ -193,6 +290,13 @@ private:
 
 	void stop_log_mavlink();
 
+	/**
+	 * Start/stop streaming the full log over UDP, together with the full file log
+	 */
+	void start_log_udp();
+
+	void stop_log_udp();
+
 	/** check if mavlink logging can be started */
 	bool can_start_mavlink_log() const
 	{
@@ -251,7 +355,95 @@ private:
 
 	void write_changed_parameters(LogType type);
 
-	inline bool copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe);
+	/**
+	 * Serialize the formats and parameters of the full log into _definitions_cache, so that a log start only needs
+	 * to copy them with a single write. The cache is valid until a parameter changes or gets used.
+	 */
+	void update_definitions_cache();
+	bool definitions_cache_valid() const;
+
+	/**
+	 * Subscribe to a topic if not done yet, and write the add logged message on success.
+	 * The data is flagged as updated and written with the next updated subscriptions.
+	 */
+	inline void try_to_subscribe(int sub_idx);
+
+	/**
+	 * Write the current data of a subscription (in _msg_buffer) to the full and mission log.
+	 * @return number of bytes written to the full log
+	 */
+	inline size_t write_subscription_data(int sub_idx, hrt_abstime loop_time);
+
+	/**
+	 * Write the current data of a subscription (in _msg_buffer) to the full log, delta encoded
+	 * against the previous sample if that is smaller.
+	 * @return number of bytes written
+	 */
+	size_t write_data_delta(LoggerSubscription &sub, size_t msg_size);
+
+	/**
+	 * Write the aggregate of a subscription to the full log and reset it.
+	 * The timestamp is taken from the current data in _msg_buffer.
+	 * @return number of bytes written
+	 */
+	size_t write_aggregate(LoggerSubscription &sub);
+
+	/**
+	 * Write the formats of the aggregate messages
+	 */
+	void write_aggregate_formats(LogType type, ulog_message_format_s &msg);
+
+	/**
+	 * XOR/run-length encode data against a reference (@see ulog_message_data_delta_header_s)
+	 * @return encoded size, or size if the encoding is not smaller
+	 */
+	static size_t encode_delta(const uint8_t *reference, const uint8_t *data, size_t size, uint8_t *out);
+
+	/**
+	 * Allocate the reference samples for delta encoding, if enabled with SDLOG_DELTA
+	 */
+	bool initialize_delta_encoding();
+
+	/**
+	 * Make sure the next sample of every subscription is written in full (e.g. when a new log starts)
+	 */
+	void request_delta_keyframes();
+
+	/**
+	 * Write the lost message counters of the queued subscriptions that changed as info messages
+	 */
+	void write_lost_messages(LogType type);
+
+	/**
+	 * Add an entry to the seek index (timestamp -> file offset of the next message)
+	 */
+	void add_index_entry(hrt_abstime timestamp);
+
+	/**
+	 * Write the seek index at the end of the full log file.
+	 * The index is written as INFO_MULTIPLE messages (index_timestamp, index_offset and
+	 * index_topic_offset, the offset of the ADD_LOGGED_MSG of each msg_id), followed by a
+	 * fixed size INFO message with the offset of the index (uint64_t index_start) at the end
+	 * of the file. All offsets refer to the uncompressed file.
+	 */
+	void write_index();
+
+	/**
+	 * Write an array as INFO_MULTIPLE messages (split into continued messages if too long).
+	 * Must be called with _writer.lock() held.
+	 */
+	void write_info_multiple_array(LogType type, const char *type_str, const char *name, const void *data,
+				       size_t element_size, int count);
+
+	/**
+	 * Start a new measurement window for the dropout statistics (@see Statistics)
+	 */
+	void reset_dropout_window(LogType type, hrt_abstime now);
+
+	/**
+	 * Write a logging message with the writer state recorded at the start of the last dropout
+	 */
+	void write_dropout_info(LogType type, float dropout_duration);
 
 	/**
 	 * Write exactly one ulog message to the logger and handle dropouts.
@@ -284,6 +476,13 @@ private:
 	bool start_stop_logging(MissionLogType mission_log_type);
 
 	void handle_vehicle_command_update();
+
+	/**
+	 * Black box logging: check the triggers, and restart the log after the post-trigger window
+	 */
+	void handle_black_box();
+
+	void trigger_black_box(const char *reason);
 	void ack_vehicle_command(vehicle_command_s *cmd, uint32_t result);
 
 	/**
@@ -306,6 +505,37 @@ private:
 
 	uint8_t						*_msg_buffer{nullptr};
 	int						_msg_buffer_len{0};
+	uint8_t						*_delta_buffer{nullptr}; ///< delta encoded message (_msg_buffer_len)
+	uint8_t						*_aggregate_buffer{nullptr}; ///< aggregate message (only with aggregated topics)
+	uint8_t						*_delta_references{nullptr}; ///< reference samples of all subscriptions
+	const orb_metadata				*_current_topic{nullptr}; ///< topic of the data message currently written
+
+#if defined(CONSTRAINED_FLASH)
+	static constexpr size_t				DEFINITIONS_CACHE_MAX_SIZE = 0; ///< not enough RAM
+#else
+	static constexpr size_t				DEFINITIONS_CACHE_MAX_SIZE = 64 * 1024;
+#endif
+	uint8_t						*_definitions_cache{nullptr}; ///< serialized formats & parameters (full log)
+	size_t						_definitions_cache_size{0};
+	size_t						_definitions_cache_capacity{0};
+	bool						_definitions_capture{false}; ///< write_message() appends to the cache
+	bool						_definitions_cache_disabled{DEFINITIONS_CACHE_MAX_SIZE == 0}; ///< set if the cache is too large or could not be allocated
+	uint32_t					_definitions_param_generation{0}; ///< parameter generation the cache was built with
+	unsigned					_definitions_param_count_used{0};
+	hrt_abstime					_definitions_invalid_time{0}; ///< time the cache was found invalid while not logging
+
+	enum BlackBoxTrigger : int32_t {
+		Failsafe = (1 << 0),
+		FailureDetector = (1 << 1),
+		Command = (1 << 2)
+	};
+
+	int32_t						_black_box_triggers{0}; ///< BlackBoxTrigger bitmask (0: black box disabled)
+	hrt_abstime					_black_box_pre_window{0};
+	hrt_abstime					_black_box_post_window{0};
+	hrt_abstime					_black_box_trigger_time{0}; ///< 0 while waiting for a trigger
+	bool						_black_box_failsafe{false};
+	bool						_black_box_failure{false};
 
 	LogFileName					_file_name[(int)LogType::Count];
 
@@ -314,12 +544,22 @@ private:
 
 	Statistics					_statistics[(int)LogType::Count];
 	hrt_abstime					_last_sync_time{0}; ///< last time a sync msg was sent
+	hrt_abstime					_last_lost_messages_time{0}; ///< last time the lost message counters were written
+
+	static constexpr int				MAX_INDEX_ENTRIES = 512; ///< the index is decimated when full
+	uint64_t					*_index_timestamps{nullptr}; ///< seek index (only with SDLOG_INDEX)
+	uint64_t					*_index_offsets{nullptr};
+	uint64_t					*_index_topic_offsets{nullptr}; ///< offset of the ADD_LOGGED_MSG per msg_id
+	int						_index_count{0};
+	int						_index_decimation{1}; ///< add an entry every _index_decimation sync messages
+	int						_index_skipped{0};
 
 	LogMode						_log_mode;
 	const bool					_log_name_timestamp;
 
 	LoggerSubscription	 			*_subscriptions{nullptr}; ///< all subscriptions for full & mission log (in front)
 	int						_num_subscriptions{0};
+	px4::atomic<uint32_t>				*_updated_subscriptions{nullptr}; ///< bitmask of subscriptions with new publications
 	MissionSubscription 				_mission_subscriptions[MAX_MISSION_TOPICS_NUM] {}; ///< additional data for mission subscriptions
 	int						_num_mission_subs{0};
 
@@ -338,6 +578,7 @@ private:
 	uORB::Subscription				_manual_control_sp_sub{ORB_ID(manual_control_setpoint)};
 	uORB::Subscription				_vehicle_command_sub{ORB_ID(vehicle_command)};
 	uORB::Subscription				_vehicle_status_sub{ORB_ID(vehicle_status)};
+	uORB::Subscription				_black_box_status_sub{ORB_ID(vehicle_status)};
 	uORB::SubscriptionInterval			_log_message_sub{ORB_ID(log_message), 20};
 
 	param_t						_sdlog_profile_handle{PARAM_INVALID};
@@ -345,6 +586,16 @@ private:
 	param_t						_log_dirs_max{PARAM_INVALID};
 	param_t						_mission_log{PARAM_INVALID};
 	param_t						_boot_bat_only{PARAM_INVALID};
+	param_t						_mavlink_compress{PARAM_INVALID};
+	param_t						_udp_fec_handle{PARAM_INVALID};
+	param_t						_queued_logging{PARAM_INVALID};
+	param_t						_queue_length{PARAM_INVALID};
+	param_t						_aggregate_handle{PARAM_INVALID};
+	param_t						_delta_encoding{PARAM_INVALID};
+	param_t						_index_handle{PARAM_INVALID};
+	param_t						_black_box_triggers_handle{PARAM_INVALID};
+	param_t						_black_box_pre_handle{PARAM_INVALID};
+	param_t						_black_box_post_handle{PARAM_INVALID};
 };
 
 } //namespace logger
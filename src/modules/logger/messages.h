@@ -46,6 +46,7 @@ enum class ULogMessageType : uint8_t {
 	LOGGING = 'L',
 	LOGGING_TAGGED = 'C',
 	FLAG_BITS = 'B',
+	DATA_DELTA = 'X', ///< data message encoded against the previous sample (@see ulog_message_data_delta_header_s)
 };
 
 
@@ -108,6 +109,27 @@ struct ulog_message_data_header_s {
 	uint16_t msg_id;
 };
 
+/**
+ * Delta encoded data message (DATA_DELTA).
+ *
+ * The payload encodes the XOR of the sample with the previous sample of the same msg_id.
+ * The previous sample is the last decoded sample of a DATA or DATA_DELTA message, so a parser
+ * needs to keep one sample per msg_id. A DATA_DELTA message always follows a DATA message of
+ * the same msg_id. The payload is a sequence of runs, each starting with a control byte c:
+ * - c & ULOG_DATA_DELTA_UNCHANGED: (c & 0x7f) + 1 bytes are unchanged (XOR is 0)
+ * - otherwise: c + 1 bytes follow, which are XORed with the previous sample
+ * Bytes after the last run are unchanged. The file sets ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK.
+ */
+struct ulog_message_data_delta_header_s {
+	uint16_t msg_size; //size of message - ULOG_MSG_HEADER_LEN
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+
+	uint16_t msg_id;
+};
+
+#define ULOG_DATA_DELTA_UNCHANGED 0x80
+#define ULOG_DATA_DELTA_MAX_RUN 128
+
 struct ulog_message_info_header_s {
 	uint16_t msg_size; //size of message - ULOG_MSG_HEADER_LEN
 	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::INFO);
@@ -154,6 +176,7 @@ struct ulog_message_parameter_header_s {
 
 
 #define ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK (1<<0)
+#define ULOG_INCOMPAT_FLAG0_DATA_DELTA_MASK (1<<1) ///< log contains DATA_DELTA messages
 
 struct ulog_message_flag_bits_s {
 	uint16_t msg_size;
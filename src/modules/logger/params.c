@@ -160,6 +160,33 @@ PARAM_DEFINE_INT32(SDLOG_PROFILE, 3);
  */
 PARAM_DEFINE_INT32(SDLOG_DIRS_MAX, 0);
 
+/**
+ * Compress MAVLink log streaming
+ *
+ * If enabled, log data streamed over MAVLink (e.g. with mavlink_ulog_streaming.py)
+ * is compressed in blocks, which reduces the required link bandwidth.
+ * The receiver needs to support it.
+ *
+ * @boolean
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_MAV_COMP, 0);
+
+/**
+ * Forward error correction of the UDP log stream
+ *
+ * Only used if the logger streams over UDP (started with -u).
+ * If set, a parity datagram is sent after each group of this many datagrams,
+ * which allows the receiver to recover one lost datagram per group.
+ * Smaller groups recover more losses but need more bandwidth.
+ *
+ * @min 0
+ * @max 32
+ * @value 0 Disabled
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_UDP_FEC, 0);
+
 /**
  * Log UUID
  *
@@ -169,3 +196,183 @@ PARAM_DEFINE_INT32(SDLOG_DIRS_MAX, 0);
  * @group SD Logging
  */
 PARAM_DEFINE_INT32(SDLOG_UUID, 1);
+
+/**
+ * Log all queued samples of full-rate topics
+ *
+ * By default the logger writes the latest sample of each topic per iteration,
+ * so topics published faster than the logger rate are decimated.
+ * If enabled, all samples still in the uORB queue of topics logged without an interval
+ * are written, and the number of lost samples per topic is logged as info
+ * message (lost_msgs_<topic>_<instance>).
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_QUEUED, 0);
+
+/**
+ * uORB queue length of topics logged with SDLOG_QUEUED
+ *
+ * Increases the uORB queue of the full-rate logged topics to this length,
+ * so that less samples are lost. This only applies to topics that are not published yet
+ * when the logger subscribes. Other subscribers of these topics then also read the
+ * queued samples in order, so this is meant for sample streams such as
+ * sensor_gyro_fifo and should be used with a custom topic list (logger_topics.txt).
+ * Set to 0 to keep the queue length of the publisher.
+ *
+ * @min 0
+ * @max 255
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_QUEUE_LEN, 0);
+
+/**
+ * Log file sync interval
+ *
+ * Interval in which the log file is synced to the storage (fsync).
+ * A longer interval reduces write stalls on slow SD cards, at the cost of
+ * losing more data if the system loses power while logging.
+ * Set to 0 to only sync when the log file is closed.
+ *
+ * @unit ms
+ * @min 0
+ * @max 60000
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_FSYNC_INT, 1000);
+
+/**
+ * Log file preallocation
+ *
+ * Storage space that is reserved when a log file is opened, so that the file
+ * system does not need to allocate new blocks while logging.
+ * The file size is not changed. Only supported on Linux.
+ * Set to 0 to disable.
+ *
+ * @unit MB
+ * @min 0
+ * @max 4096
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_PREALLOC, 0);
+
+/**
+ * Delta encoding of logged data
+ *
+ * If enabled, samples are written to the full log as XOR/run-length encoding against the
+ * previous sample of the same topic (DATA_DELTA message), if that is smaller.
+ * This reduces the log size and SD card bandwidth, in particular for topics where only a
+ * few fields change. A full sample is written regularly and after dropouts.
+ * The log then requires a parser that supports DATA_DELTA messages.
+ * The mission log is not affected. Delta encoding is disabled with black box logging
+ * and with the UDP backend.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_DELTA, 0);
+
+/**
+ * Compress the log file
+ *
+ * If enabled, the full log is compressed in the background in fixed-size LZ4 blocks
+ * before it is written, which reduces SD card I/O and the log download time.
+ * This costs CPU time on the log writer thread and about 16 KB of RAM, so it is meant
+ * for boards with spare resources.
+ * The file needs to be decompressed (e.g. with Tools/ulog_decompress.py) before it can
+ * be parsed by ULog tools.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_COMPRESS, 0);
+
+/**
+ * Black box logging triggers
+ *
+ * If any trigger is selected, the full log is kept in RAM while logging and only
+ * written to the SD card when a trigger fires: the data of the pre-trigger window
+ * (SDLOG_BB_PRE) is written, followed by the data until the end of the post-trigger
+ * window (SDLOG_BB_POST). Then a new log file waits for the next trigger.
+ * Log files without trigger are removed.
+ * The command trigger is MAV_CMD_USER_1.
+ * The pre-trigger window is limited by the logger buffer size (logger -b option),
+ * which needs to be increased accordingly for high-rate profiles.
+ * Set to 0 to write the log continuously.
+ *
+ * @min 0
+ * @max 7
+ * @bit 0 Failsafe
+ * @bit 1 Failure detector
+ * @bit 2 Command (MAV_CMD_USER_1)
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_BB_TRIG, 0);
+
+/**
+ * Black box pre-trigger window
+ *
+ * Logged data from this time before a trigger is written to the log (if it fits into the buffer).
+ *
+ * @unit s
+ * @min 0
+ * @max 600
+ * @decimal 1
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_FLOAT(SDLOG_BB_PRE, 10.0f);
+
+/**
+ * Black box post-trigger window
+ *
+ * Time after the last trigger until the black box log file is closed.
+ *
+ * @unit s
+ * @min 0
+ * @max 3600
+ * @decimal 1
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_FLOAT(SDLOG_BB_POST, 10.0f);
+
+/**
+ * Append a seek index to the log
+ *
+ * If enabled, the full log file ends with an index that maps time to file offsets
+ * (at the sync messages, every 0.5 s, decimated for long logs), and contains the
+ * offset of the ADD_LOGGED_MSG message of each topic, so that tools and log
+ * download by range can seek directly (@see Tools/ulog_index.py).
+ * Not supported with black box logging.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_INDEX, 0);
+
+/**
+ * Aggregate rate limited topics
+ *
+ * If enabled, all samples of topics that are logged with a limited rate are read, and
+ * in addition to the latest sample, the element-wise minimum, maximum and mean over the
+ * logging interval are logged as '<topic>_aggregate' message. This preserves peaks
+ * (e.g. of actuator outputs or vibrations) at low logging rates. It needs additional RAM for
+ * each aggregated topic.
+ * Topics can also be aggregated individually in the topic list file (logger_topics.txt)
+ * with the format '<topic> <interval> aggregate'.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_AGGREGATE, 0);
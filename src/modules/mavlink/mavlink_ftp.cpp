@@ -42,23 +42,31 @@
 #include <errno.h>
 #include <cstring>
 
+#include <mathlib/mathlib.h>
+#include <parameters/param.h>
+
 #include "mavlink_ftp.h"
 #include "mavlink_main.h"
 #include "mavlink_tests/mavlink_ftp_test.h"
 
 constexpr const char MavlinkFTP::_root_dir[];
+constexpr const char MavlinkFTP::_param_pack_path[];
 
 MavlinkFTP::MavlinkFTP(Mavlink *mavlink) :
 	_mavlink(mavlink)
 {
 	// initialize session
 	_session_info.fd = -1;
+
+	snprintf(_param_pack_file, sizeof(_param_pack_file), PX4_STORAGEDIR "/.param%d.pck",
+		 _mavlink ? _mavlink->get_instance_id() : 0);
 }
 
 MavlinkFTP::~MavlinkFTP()
 {
 	delete[] _work_buffer1;
 	delete[] _work_buffer2;
+	delete[] _read_ahead_buffer;
 }
 
 unsigned
@@ -494,6 +502,10 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 		return kErrNoSessionsAvailable;
 	}
 
+	if (oflag == O_RDONLY && strcmp(_data_as_cstring(payload), _param_pack_path) == 0) {
+		return _workOpenParamPack(payload);
+	}
+
 	strncpy(_work_buffer1, _root_dir, _work_buffer1_len);
 	strncpy(_work_buffer1 + _root_dir_len, _data_as_cstring(payload), _work_buffer1_len - _root_dir_len);
 
@@ -526,6 +538,9 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 	_session_info.fd = fd;
 	_session_info.file_size = fileSize;
 	_session_info.stream_download = false;
+	_session_info.param_pack = false;
+	_burst_queue_len = 0;
+	_read_ahead_size = 0;
 
 	payload->session = 0;
 	payload->size = sizeof(uint32_t);
@@ -534,6 +549,95 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 	return kErrNone;
 }
 
+/// @brief Generates the parameter pack file and opens it for reading
+MavlinkFTP::ErrorCode
+MavlinkFTP::_workOpenParamPack(PayloadHeader *payload)
+{
+	int fd = ::open(_param_pack_file, O_CREAT | O_TRUNC | O_RDWR, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		return kErrFailErrno;
+	}
+
+	// entries are staged in _work_buffer2 and written out whenever it could overflow
+	static constexpr int max_entry_size = 3 + 16 + 4;
+	static_assert(_work_buffer2_len >= max_entry_size, "work buffer too small");
+
+	uint8_t *buffer = (uint8_t *)_work_buffer2;
+	int len = 0;
+	uint32_t file_size = 0;
+	bool write_failed = false;
+
+	const uint32_t hash = param_hash_check();
+	const uint16_t count = param_count_used();
+	memcpy(&buffer[len], &hash, sizeof(hash));
+	len += sizeof(hash);
+	memcpy(&buffer[len], &count, sizeof(count));
+	len += sizeof(count);
+
+	const char *previous_name = "";
+
+	for (uint16_t index = 0; index < count && !write_failed; index++) {
+		const param_t param = param_for_used_index(index);
+		const char *name = param_name(param);
+		int32_t value = 0;
+
+		if (name == nullptr || param_get(param, &value) != PX4_OK) {
+			write_failed = true;
+			break;
+		}
+
+		uint8_t shared = 0;
+
+		while (name[shared] != '\0' && name[shared] == previous_name[shared] && shared < 16) {
+			shared++;
+		}
+
+		const uint8_t suffix = strnlen(name + shared, 16 - shared);
+
+		buffer[len++] = (param_type(param) == PARAM_TYPE_INT32) ? MAV_PARAM_TYPE_INT32 : MAV_PARAM_TYPE_REAL32;
+		buffer[len++] = shared;
+		buffer[len++] = suffix;
+		memcpy(&buffer[len], name + shared, suffix);
+		len += suffix;
+		memcpy(&buffer[len], &value, sizeof(value));
+		len += sizeof(value);
+
+		previous_name = name;
+
+		if (len > _work_buffer2_len - max_entry_size || index == count - 1) {
+			write_failed = (::write(fd, buffer, len) != len);
+			file_size += len;
+			len = 0;
+		}
+	}
+
+	if (len > 0 && !write_failed) {
+		// no parameters in use, write the header only
+		write_failed = (::write(fd, buffer, len) != len);
+		file_size += len;
+	}
+
+	if (write_failed || lseek(fd, 0, SEEK_SET) != 0) {
+		::close(fd);
+		unlink(_param_pack_file);
+		return kErrFailErrno;
+	}
+
+	_session_info.fd = fd;
+	_session_info.file_size = file_size;
+	_session_info.stream_download = false;
+	_session_info.param_pack = true;
+	_burst_queue_len = 0;
+	_read_ahead_size = 0;
+
+	payload->session = 0;
+	payload->size = sizeof(uint32_t);
+	std::memcpy(payload->data, &file_size, payload->size);
+
+	return kErrNone;
+}
+
 /// @brief Responds to a Read command
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workRead(PayloadHeader *payload)
@@ -552,12 +656,7 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 		return kErrEOF;
 	}
 
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-		PX4_ERR("seek fail");
-		return kErrFailErrno;
-	}
-
-	int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+	int bytes_read = _readSession(payload->offset, &payload->data[0], kMaxDataLength);
 
 	if (bytes_read < 0) {
 		// Negative return indicates error other than eof
@@ -570,6 +669,57 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 	return kErrNone;
 }
 
+int
+MavlinkFTP::_readSession(uint32_t offset, uint8_t *dst, int len)
+{
+	if (_read_ahead_buffer == nullptr) {
+		_read_ahead_buffer = new uint8_t[_read_ahead_buffer_len];
+		_read_ahead_size = 0;
+	}
+
+	if (_read_ahead_buffer == nullptr) {
+		// no memory for read-ahead, read directly
+		if (lseek(_session_info.fd, offset, SEEK_SET) < 0) {
+			return -1;
+		}
+
+		return ::read(_session_info.fd, dst, len);
+	}
+
+	const bool cached = (_read_ahead_size > 0) && (offset >= _read_ahead_offset)
+			    && (offset + len <= _read_ahead_offset + _read_ahead_size);
+
+	if (!cached) {
+		// refill with one large read starting at an aligned offset
+		const uint32_t start = offset - (offset % _read_ahead_alignment);
+		_read_ahead_size = 0;
+
+		if (lseek(_session_info.fd, start, SEEK_SET) < 0) {
+			return -1;
+		}
+
+		const int bytes_read = ::read(_session_info.fd, _read_ahead_buffer, _read_ahead_buffer_len);
+
+		if (bytes_read < 0) {
+			return -1;
+		}
+
+		_read_ahead_offset = start;
+		_read_ahead_size = bytes_read;
+	}
+
+	// bytes available at offset (less than len at the end of the file)
+	const int available = (int)(_read_ahead_offset + _read_ahead_size) - (int)offset;
+
+	if (available <= 0) {
+		return 0;
+	}
+
+	const int size = math::min(len, available);
+	memcpy(dst, &_read_ahead_buffer[offset - _read_ahead_offset], size);
+	return size;
+}
+
 /// @brief Responds to a Stream command
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t target_component_id)
@@ -578,12 +728,41 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t
 		return kErrInvalidSession;
 	}
 
+	// optional burst length: bursts with a length are pipelined, the GCS can keep several windows in flight
+	// and re-request only the gaps; a burst without length restarts the download as before
+	uint32_t length = 0;
+
+	if (payload->size == sizeof(length)) {
+		memcpy(&length, payload->data, sizeof(length));
+	}
+
 #ifdef MAVLINK_FTP_DEBUG
-	PX4_INFO("FTP: burst offset:%d", payload->offset);
+	PX4_INFO("FTP: burst offset:%d length:%d", payload->offset, length);
 #endif
+
+	if (length > 0 && _session_info.stream_download) {
+		if (_burst_queue_len >= kMaxQueuedBursts) {
+			return kErrFail;
+		}
+
+		BurstRequest &burst = _burst_queue[_burst_queue_len++];
+		burst.offset = payload->offset;
+		burst.length = length;
+		burst.seq_number = payload->seq_number + 1;
+		burst.target_system_id = target_system_id;
+		burst.target_component_id = target_component_id;
+
+		return kErrNone;
+	}
+
+	if (length == 0) {
+		_burst_queue_len = 0;
+	}
+
 	// Setup for streaming sends
 	_session_info.stream_download = true;
 	_session_info.stream_offset = payload->offset;
+	_session_info.stream_end = (length > 0) ? payload->offset + length : 0;
 	_session_info.stream_chunk_transmitted = 0;
 	_session_info.stream_seq_number = payload->seq_number + 1;
 	_session_info.stream_target_system_id = target_system_id;
@@ -592,6 +771,29 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t
 	return kErrNone;
 }
 
+bool
+MavlinkFTP::_startQueuedBurst()
+{
+	if (_burst_queue_len == 0) {
+		return false;
+	}
+
+	const BurstRequest &burst = _burst_queue[0];
+
+	_session_info.stream_download = true;
+	_session_info.stream_offset = burst.offset;
+	_session_info.stream_end = burst.offset + burst.length;
+	_session_info.stream_chunk_transmitted = 0;
+	_session_info.stream_seq_number = burst.seq_number;
+	_session_info.stream_target_system_id = burst.target_system_id;
+	_session_info.stream_target_component_id = burst.target_component_id;
+
+	_burst_queue_len--;
+	memmove(&_burst_queue[0], &_burst_queue[1], _burst_queue_len * sizeof(_burst_queue[0]));
+
+	return true;
+}
+
 /// @brief Responds to a Write command
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workWrite(PayloadHeader *payload)
@@ -606,6 +808,8 @@ MavlinkFTP::_workWrite(PayloadHeader *payload)
 		return kErrFailErrno;
 	}
 
+	_read_ahead_size = 0;
+
 	int bytes_written = ::write(_session_info.fd, &payload->data[0], payload->size);
 
 	if (bytes_written < 0) {
@@ -743,6 +947,13 @@ MavlinkFTP::_workTerminate(PayloadHeader *payload)
 	::close(_session_info.fd);
 	_session_info.fd = -1;
 	_session_info.stream_download = false;
+	_burst_queue_len = 0;
+	_read_ahead_size = 0;
+
+	if (_session_info.param_pack) {
+		unlink(_param_pack_file);
+		_session_info.param_pack = false;
+	}
 
 	payload->size = 0;
 
@@ -757,6 +968,13 @@ MavlinkFTP::_workReset(PayloadHeader *payload)
 		::close(_session_info.fd);
 		_session_info.fd = -1;
 		_session_info.stream_download = false;
+		_burst_queue_len = 0;
+		_read_ahead_size = 0;
+
+		if (_session_info.param_pack) {
+			unlink(_param_pack_file);
+			_session_info.param_pack = false;
+		}
 	}
 
 	payload->size = 0;
@@ -960,6 +1178,12 @@ void MavlinkFTP::send(const hrt_abstime t)
 				delete[] _work_buffer2;
 				_work_buffer2 = nullptr;
 			}
+
+			if (_read_ahead_buffer && !_session_info.stream_download) {
+				delete[] _read_ahead_buffer;
+				_read_ahead_buffer = nullptr;
+				_read_ahead_size = 0;
+			}
 		}
 	}
 
@@ -1012,17 +1236,21 @@ void MavlinkFTP::send(const hrt_abstime t)
 #endif
 		}
 
-		if (error_code == kErrNone) {
-			if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-				error_code = kErrFailErrno;
-#ifdef MAVLINK_FTP_DEBUG
-				PX4_WARN("stream download: seek fail");
-#endif
+		// the last packet of a burst with a length ends at the requested end offset
+		bool burst_end = false;
+		int read_length = kMaxDataLength;
+
+		if (error_code == kErrNone && _session_info.stream_end > 0) {
+			const uint32_t remaining = math::min(_session_info.stream_end, _session_info.file_size) - _session_info.stream_offset;
+
+			if (remaining <= kMaxDataLength) {
+				read_length = remaining;
+				burst_end = true;
 			}
 		}
 
 		if (error_code == kErrNone) {
-			int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+			int bytes_read = _readSession(_session_info.stream_offset, &payload->data[0], read_length);
 
 			if (bytes_read < 0) {
 				// Negative return indicates error other than eof
@@ -1051,6 +1279,22 @@ void MavlinkFTP::send(const hrt_abstime t)
 			}
 
 			_session_info.stream_download = false;
+			_burst_queue_len = 0;
+
+		} else if (burst_end) {
+			// window complete, continue with the next queued window without waiting for a request
+			payload->burst_complete = true;
+			_session_info.stream_download = false;
+			more_data = _startQueuedBurst();
+
+#ifndef MAVLINK_FTP_UNIT_TEST
+			max_bytes_to_send -= get_size();
+
+			if (max_bytes_to_send < (get_size() * 2)) {
+				more_data = false;
+			}
+
+#endif
 
 		} else {
 #ifndef MAVLINK_FTP_UNIT_TEST
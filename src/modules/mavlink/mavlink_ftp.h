@@ -134,6 +134,7 @@ private:
 
 	ErrorCode	_workList(PayloadHeader *payload, bool list_hidden = false);
 	ErrorCode	_workOpen(PayloadHeader *payload, int oflag);
+	ErrorCode	_workOpenParamPack(PayloadHeader *payload);
 	ErrorCode	_workRead(PayloadHeader *payload);
 	ErrorCode	_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t target_component_id);
 	ErrorCode	_workWrite(PayloadHeader *payload);
@@ -146,6 +147,18 @@ private:
 	ErrorCode	_workRename(PayloadHeader *payload);
 	ErrorCode	_workCalcFileCRC32(PayloadHeader *payload);
 
+	/**
+	 * Read from the session file through the read-ahead buffer
+	 * @return number of bytes read, -1 on error (errno set)
+	 */
+	int		_readSession(uint32_t offset, uint8_t *dst, int len);
+
+	/**
+	 * Start the next queued burst
+	 * @return true if a burst was started, false if the queue is empty
+	 */
+	bool		_startQueuedBurst();
+
 	uint8_t _getServerSystemId(void);
 	uint8_t _getServerComponentId(void);
 	uint8_t _getServerChannel(void);
@@ -172,9 +185,24 @@ private:
 		uint8_t		stream_target_system_id;
 		uint8_t         stream_target_component_id;
 		unsigned	stream_chunk_transmitted;
+		uint32_t	stream_end;		///< end offset of the current burst, 0 for an open ended (35K chunked) burst
+		bool		param_pack;		///< session reads the generated parameter pack file
 	};
 	struct SessionInfo _session_info {};	///< Session info, fd=-1 for no active session
 
+	/// @brief Burst with an explicit length, queued while another burst is in flight
+	struct BurstRequest {
+		uint32_t	offset;
+		uint32_t	length;
+		uint16_t	seq_number;
+		uint8_t		target_system_id;
+		uint8_t		target_component_id;
+	};
+
+	static constexpr int kMaxQueuedBursts = 8;
+	BurstRequest	_burst_queue[kMaxQueuedBursts] {};
+	int		_burst_queue_len{0};
+
 	ReceiveMessageFunc_t	_utRcvMsgFunc{};	///< Unit test override for mavlink message sending
 	void			*_worker_data{nullptr};	///< Additional parameter to _utRcvMsgFunc;
 
@@ -191,6 +219,17 @@ private:
 	static constexpr int _work_buffer2_len = 256;
 	hrt_abstime _last_work_buffer_access{0}; ///< timestamp when the buffers were last accessed
 
+	/* read-ahead buffer of the read session, allocated on the first read (aligned large reads instead of one per message) */
+	uint8_t *_read_ahead_buffer{nullptr};
+#ifdef __PX4_NUTTX
+	static constexpr int _read_ahead_buffer_len = 2048;
+#else
+	static constexpr int _read_ahead_buffer_len = 64 * 1024;
+#endif
+	static constexpr uint32_t _read_ahead_alignment = 512;
+	uint32_t _read_ahead_offset{0};	///< file offset of _read_ahead_buffer[0]
+	int _read_ahead_size{0};	///< valid bytes in _read_ahead_buffer, 0 if invalid
+
 	// prepend a root directory to each file/dir access to avoid enumerating the full FS tree (e.g. on Linux).
 	// Note that requests can still fall outside of the root dir by using ../..
 #ifdef MAVLINK_FTP_UNIT_TEST
@@ -200,6 +239,25 @@ private:
 #endif
 	static constexpr const int _root_dir_len = sizeof(_root_dir) - 1;
 
+	/**
+	 * Virtual file containing all used parameters, meant to be fetched with a single burst read.
+	 *
+	 * Layout (little endian):
+	 *   uint32 parameter hash (same as the _HASH_CHECK PARAM_VALUE)
+	 *   uint16 number of entries
+	 *   entries in used index order:
+	 *     uint8  MAV_PARAM_TYPE
+	 *     uint8  number of leading name characters shared with the previous entry
+	 *     uint8  number of following name characters
+	 *     char[] name characters (not null terminated)
+	 *     4 byte value
+	 *
+	 * A ground station with a cached parameter set can read only the first 4 bytes
+	 * and stop if the hash matches.
+	 */
+	static constexpr const char _param_pack_path[] = "@PARAM/param.pck";
+	char _param_pack_file[32] {}; ///< per instance staging file, instances must not share it
+
 	bool _last_reply_valid = false;
 	uint8_t _last_reply[MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL_LEN - MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN
 								      + sizeof(PayloadHeader) + sizeof(uint32_t)];
@@ -105,6 +105,13 @@ MavlinkStreamHighLatency2::MavlinkStreamHighLatency2(Mavlink *mavlink) : Mavlink
 		_batteries[i].subscription = _mavlink->add_orb_subscription(ORB_ID(battery_status), i);
 	}
 
+	// the analyzers are sampled at SAMPLE_INTERVAL, independent of the stream rate
+	_update_data_every_loop = true;
+
+	int32_t send_on_events = 0;
+	param_get(param_find("MAV_HL_EVENTS"), &send_on_events);
+	_send_on_events = (send_on_events != 0);
+
 	reset_last_sent();
 }
 
@@ -209,6 +216,10 @@ bool MavlinkStreamHighLatency2::send(const hrt_abstime t)
 			reset_analysers(t);
 
 			mavlink_msg_high_latency2_send_struct(_mavlink->get_channel(), &msg);
+
+			if (_send_on_events) {
+				_event_state_sent = read_event_state();
+			}
 		}
 
 		return updated;
@@ -491,12 +502,13 @@ void MavlinkStreamHighLatency2::update_data()
 {
 	const hrt_abstime t = hrt_absolute_time();
 
-	if (t > _last_update_time) {
-		// first order low pass filter for the update rate
-		_update_rate_filtered = 0.97f * _update_rate_filtered + 0.03f / ((t - _last_update_time) * 1e-6f);
-		_last_update_time = t;
+	// the analyzers only need samples at a fixed rate, not every mavlink loop iteration
+	if (t < _last_sample_time + SAMPLE_INTERVAL) {
+		return;
 	}
 
+	_last_sample_time = t;
+
 	update_airspeed();
 
 	update_tecs_status();
@@ -510,6 +522,58 @@ void MavlinkStreamHighLatency2::update_data()
 	update_vehicle_status();
 
 	update_wind_estimate();
+
+	if (_send_on_events) {
+		check_events(t);
+	}
+}
+
+MavlinkStreamHighLatency2::EventState MavlinkStreamHighLatency2::read_event_state()
+{
+	EventState state{};
+
+	vehicle_status_s status;
+
+	if (_status_sub->update(&status)) {
+		state.sensors_failed = status.onboard_control_sensors_enabled & ~status.onboard_control_sensors_health;
+		state.arming_state = status.arming_state;
+		state.nav_state = status.nav_state;
+		state.rc_signal_lost = status.rc_signal_lost;
+		state.engine_failure = status.engine_failure;
+		state.mission_failure = status.mission_failure;
+	}
+
+	mission_result_s mission_result;
+
+	if (_mission_result_sub->update(&mission_result)) {
+		state.wp_num = mission_result.seq_current;
+	}
+
+	geofence_result_s geofence;
+
+	if (_geofence_sub->update(&geofence)) {
+		state.geofence_violated = geofence.geofence_violated;
+	}
+
+	battery_status_s battery;
+
+	for (int i = 0; i < ORB_MULTI_MAX_INSTANCES; i++) {
+		if (_batteries[i].subscription->update(&battery) && battery.connected) {
+			state.battery_warning = math::max(state.battery_warning, battery.warning);
+		}
+	}
+
+	return state;
+}
+
+void MavlinkStreamHighLatency2::check_events(const hrt_abstime t)
+{
+	// send the message right away when the mode, arming state, mission item or a failure changes
+	if (_mavlink->should_transmit() && (t > _last_event_time + EVENT_MIN_INTERVAL)
+	    && (read_event_state() != _event_state_sent)) {
+		_last_event_time = t;
+		reset_last_sent();
+	}
 }
 
 void MavlinkStreamHighLatency2::update_airspeed()
@@ -517,8 +581,8 @@ void MavlinkStreamHighLatency2::update_airspeed()
 	airspeed_s airspeed;
 
 	if (_airspeed_sub->update(&airspeed)) {
-		_airspeed.add_value(airspeed.indicated_airspeed_m_s, _update_rate_filtered);
-		_temperature.add_value(airspeed.air_temperature_celsius, _update_rate_filtered);
+		_airspeed.add_value(airspeed.indicated_airspeed_m_s, SAMPLE_RATE);
+		_temperature.add_value(airspeed.air_temperature_celsius, SAMPLE_RATE);
 	}
 }
 
@@ -527,7 +591,7 @@ void MavlinkStreamHighLatency2::update_tecs_status()
 	tecs_status_s tecs_status;
 
 	if (_tecs_status_sub->update(&tecs_status)) {
-		_airspeed_sp.add_value(tecs_status.airspeed_sp, _update_rate_filtered);
+		_airspeed_sp.add_value(tecs_status.airspeed_sp, SAMPLE_RATE);
 	}
 }
 
@@ -538,7 +602,7 @@ void MavlinkStreamHighLatency2::update_battery_status()
 	for (int i = 0; i < ORB_MULTI_MAX_INSTANCES; i++) {
 		if (_batteries[i].subscription->update(&battery)) {
 			_batteries[i].connected = battery.connected;
-			_batteries[i].analyzer.add_value(battery.remaining, _update_rate_filtered);
+			_batteries[i].analyzer.add_value(battery.remaining, SAMPLE_RATE);
 		}
 	}
 }
@@ -548,9 +612,9 @@ void MavlinkStreamHighLatency2::update_global_position()
 	vehicle_global_position_s global_pos;
 
 	if (_global_pos_sub->update(&global_pos)) {
-		_climb_rate.add_value(fabsf(global_pos.vel_d), _update_rate_filtered);
+		_climb_rate.add_value(fabsf(global_pos.vel_d), SAMPLE_RATE);
 		_groundspeed.add_value(sqrtf(global_pos.vel_n * global_pos.vel_n + global_pos.vel_e * global_pos.vel_e),
-				       _update_rate_filtered);
+				       SAMPLE_RATE);
 	}
 }
 
@@ -559,8 +623,8 @@ void MavlinkStreamHighLatency2::update_gps()
 	vehicle_gps_position_s gps;
 
 	if (_gps_sub->update(&gps)) {
-		_eph.add_value(gps.eph, _update_rate_filtered);
-		_epv.add_value(gps.epv, _update_rate_filtered);
+		_eph.add_value(gps.eph, SAMPLE_RATE);
+		_epv.add_value(gps.epv, SAMPLE_RATE);
 	}
 }
 
@@ -574,17 +638,17 @@ void MavlinkStreamHighLatency2::update_vehicle_status()
 
 			if (status.is_vtol && status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_FIXED_WING) {
 				if (_actuator_sub_1->update(&actuator)) {
-					_throttle.add_value(actuator.control[actuator_controls_s::INDEX_THROTTLE], _update_rate_filtered);
+					_throttle.add_value(actuator.control[actuator_controls_s::INDEX_THROTTLE], SAMPLE_RATE);
 				}
 
 			} else {
 				if (_actuator_sub_0->update(&actuator)) {
-					_throttle.add_value(actuator.control[actuator_controls_s::INDEX_THROTTLE], _update_rate_filtered);
+					_throttle.add_value(actuator.control[actuator_controls_s::INDEX_THROTTLE], SAMPLE_RATE);
 				}
 			}
 
 		} else {
-			_throttle.add_value(0.0f, _update_rate_filtered);
+			_throttle.add_value(0.0f, SAMPLE_RATE);
 		}
 	}
 }
@@ -595,7 +659,7 @@ void MavlinkStreamHighLatency2::update_wind_estimate()
 
 	if (_wind_sub->update(&wind)) {
 		_windspeed.add_value(sqrtf(wind.windspeed_north * wind.windspeed_north + wind.windspeed_east * wind.windspeed_east),
-				     _update_rate_filtered);
+				     SAMPLE_RATE);
 	}
 }
 
@@ -84,6 +84,34 @@ public:
 
 private:
 
+	static constexpr hrt_abstime SAMPLE_INTERVAL = 100_ms;		///< the analyzers sample the topics at this interval
+	static constexpr float SAMPLE_RATE = 1e6f / SAMPLE_INTERVAL;
+	static constexpr hrt_abstime EVENT_MIN_INTERVAL = 10_s;	///< minimum time between two messages sent on events
+
+	/**
+	 * State which triggers a message when it changes (MAV_HL_EVENTS)
+	 */
+	struct EventState {
+		uint32_t sensors_failed{0};	///< enabled but unhealthy sensors
+		uint16_t wp_num{0};
+		uint8_t arming_state{0};
+		uint8_t nav_state{0};
+		uint8_t battery_warning{0};
+		bool rc_signal_lost{false};
+		bool engine_failure{false};
+		bool mission_failure{false};
+		bool geofence_violated{false};
+
+		bool operator!=(const EventState &other) const
+		{
+			return sensors_failed != other.sensors_failed || wp_num != other.wp_num
+			       || arming_state != other.arming_state || nav_state != other.nav_state
+			       || battery_warning != other.battery_warning || rc_signal_lost != other.rc_signal_lost
+			       || engine_failure != other.engine_failure || mission_failure != other.mission_failure
+			       || geofence_violated != other.geofence_violated;
+		}
+	};
+
 	struct PerBatteryData {
 		PerBatteryData() {}
 		MavlinkOrbSubscription *subscription{nullptr};
@@ -145,8 +173,11 @@ private:
 	SimpleAnalyzer _windspeed;
 
 	hrt_abstime _last_reset_time = 0;
-	hrt_abstime _last_update_time = 0;
-	float _update_rate_filtered = 0.0f;
+	hrt_abstime _last_sample_time = 0;
+
+	bool _send_on_events{false};
+	EventState _event_state_sent{};
+	hrt_abstime _last_event_time = 0;
 
 	PerBatteryData _batteries[ORB_MULTI_MAX_INSTANCES];
 
@@ -201,5 +232,9 @@ protected:
 
 	void update_wind_estimate();
 
+	EventState read_event_state();
+
+	void check_events(const hrt_abstime t);
+
 	void set_default_values(mavlink_high_latency2_t &msg) const;
 };
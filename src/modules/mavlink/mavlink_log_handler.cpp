@@ -36,9 +36,12 @@
 
 #include "mavlink_log_handler.h"
 #include "mavlink_main.h"
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <time.h>
 
+#include <px4_platform_common/tasks.h>
+
 #define MOUNTPOINT PX4_STORAGEDIR
 
 static const char *kLogRoot    = MOUNTPOINT "/log";
@@ -144,7 +147,14 @@ MavlinkLogHandler::send(const hrt_abstime /*t*/)
 	//-- Log Data
 	while (_pLogHandlerHelper && _pLogHandlerHelper->current_status == LogListHelper::LOG_HANDLER_SENDING_DATA
 	       && _mavlink->get_free_tx_buf() > get_size() && count < MAX_BYTES_SEND) {
-		count += _log_send_data();
+		const size_t sent = _log_send_data();
+
+		if (sent == 0) {
+			// waiting for the read-ahead thread
+			break;
+		}
+
+		count += sent;
 	}
 }
 
@@ -316,7 +326,13 @@ MavlinkLogHandler::_log_send_data()
 		len = sizeof(response.data);
 	}
 
-	size_t read_size = _pLogHandlerHelper->get_log_data(len, response.data);
+	int read_size = _pLogHandlerHelper->get_log_data(len, response.data);
+
+	if (read_size < 0) {
+		// not prefetched yet, retry on the next iteration
+		return 0;
+	}
+
 	response.ofs     = _pLogHandlerHelper->current_log_data_offset;
 	response.id      = _pLogHandlerHelper->current_log_index;
 	response.count   = read_size;
@@ -324,7 +340,7 @@ MavlinkLogHandler::_log_send_data()
 	_pLogHandlerHelper->current_log_data_offset    += read_size;
 	_pLogHandlerHelper->current_log_data_remaining -= read_size;
 
-	if (read_size < sizeof(response.data) || _pLogHandlerHelper->current_log_data_remaining == 0) {
+	if (read_size < (int)sizeof(response.data) || _pLogHandlerHelper->current_log_data_remaining == 0) {
 		_pLogHandlerHelper->current_status = LogListHelper::LOG_HANDLER_IDLE;
 	}
 
@@ -341,14 +357,21 @@ LogListHelper::LogListHelper()
 	, current_log_size(0)
 	, current_log_data_offset(0)
 	, current_log_data_remaining(0)
-	, current_log_filep(nullptr)
+	, current_log_fd(-1)
 {
+	pthread_mutex_init(&_ring_mutex, nullptr);
+	pthread_cond_init(&_ring_cond, nullptr);
 	_init();
 }
 
 //-------------------------------------------------------------------
 LogListHelper::~LogListHelper()
 {
+	close_for_transmit();
+	delete[] _ring;
+	pthread_cond_destroy(&_ring_cond);
+	pthread_mutex_destroy(&_ring_mutex);
+
 	// Remove log data files (if any)
 	unlink(kLogData);
 	unlink(kTmpData);
@@ -397,44 +420,187 @@ LogListHelper::get_entry(int idx, uint32_t &size, uint32_t &date, char *filename
 bool
 LogListHelper::open_for_transmit()
 {
-	if (current_log_filep) {
-		::fclose(current_log_filep);
-		current_log_filep = nullptr;
-	}
+	close_for_transmit();
 
-	current_log_filep = ::fopen(current_log_filename, "rb");
+	current_log_fd = ::open(current_log_filename, O_RDONLY);
 
-	if (!current_log_filep) {
+	if (current_log_fd < 0) {
 		PX4LOG_WARN("MavlinkLogHandler::open_for_transmit Could not open %s\n", current_log_filename);
 		return false;
 	}
 
+	if (_ring == nullptr) {
+		_ring = new uint8_t[kReadAheadSize];
+	}
+
+	if (_ring == nullptr) {
+		close_for_transmit();
+		return false;
+	}
+
+	// start prefetching from the beginning of the file
+	_ring_offset = 0;
+	_ring_fill = 0;
+	_ring_eof = false;
+	_read_ahead_exit = false;
+
+	pthread_attr_t thr_attr;
+	pthread_attr_init(&thr_attr);
+
+	sched_param param;
+	/* low priority, as this is expensive disk I/O */
+	param.sched_priority = SCHED_PRIORITY_DEFAULT - 40;
+	(void)pthread_attr_setschedparam(&thr_attr, &param);
+
+	pthread_attr_setstacksize(&thr_attr, PX4_STACK_ADJUSTED(1024));
+
+	_read_ahead_running = (pthread_create(&_read_ahead_thread, &thr_attr, &LogListHelper::_read_ahead_trampoline,
+					      this) == 0);
+	pthread_attr_destroy(&thr_attr);
+
+	if (!_read_ahead_running) {
+		PX4LOG_WARN("MavlinkLogHandler::open_for_transmit Could not start read-ahead thread\n");
+		close_for_transmit();
+		return false;
+	}
+
 	return true;
 }
 
 //-------------------------------------------------------------------
-size_t
+void
+LogListHelper::close_for_transmit()
+{
+	if (_read_ahead_running) {
+		pthread_mutex_lock(&_ring_mutex);
+		_read_ahead_exit = true;
+		pthread_cond_signal(&_ring_cond);
+		pthread_mutex_unlock(&_ring_mutex);
+
+		pthread_join(_read_ahead_thread, nullptr);
+		_read_ahead_running = false;
+	}
+
+	if (current_log_fd >= 0) {
+		::close(current_log_fd);
+		current_log_fd = -1;
+	}
+}
+
+//-------------------------------------------------------------------
+void *
+LogListHelper::_read_ahead_trampoline(void *arg)
+{
+	px4_prctl(PR_SET_NAME, "mavlink_log_rd", px4_getpid());
+	static_cast<LogListHelper *>(arg)->_read_ahead_run();
+	return nullptr;
+}
+
+//-------------------------------------------------------------------
+void
+LogListHelper::_read_ahead_run()
+{
+	pthread_mutex_lock(&_ring_mutex);
+
+	while (!_read_ahead_exit) {
+		if (_ring_eof || (kReadAheadSize - _ring_fill) < kReadChunk) {
+			pthread_cond_wait(&_ring_cond, &_ring_mutex);
+			continue;
+		}
+
+		// the next chunk starts at an aligned file offset, so it never wraps around the end of the ring
+		const uint32_t file_offset = _ring_offset + _ring_fill;
+		const uint32_t generation = _seek_generation;
+		uint8_t *dst = &_ring[file_offset % kReadAheadSize];
+
+		pthread_mutex_unlock(&_ring_mutex);
+
+		ssize_t bytes_read = -1;
+
+		if (lseek(current_log_fd, file_offset, SEEK_SET) >= 0) {
+			bytes_read = ::read(current_log_fd, dst, kReadChunk);
+		}
+
+		pthread_mutex_lock(&_ring_mutex);
+
+		if (generation != _seek_generation) {
+			// the consumer seeked away in the meantime
+			continue;
+		}
+
+		if (bytes_read > 0) {
+			_ring_fill += bytes_read;
+		}
+
+		if (bytes_read < (ssize_t)kReadChunk) {
+			_ring_eof = true;
+		}
+	}
+
+	pthread_mutex_unlock(&_ring_mutex);
+}
+
+//-------------------------------------------------------------------
+int
 LogListHelper::get_log_data(uint8_t len, uint8_t *buffer)
 {
 	if (!current_log_filename[0]) {
 		return 0;
 	}
 
-	if (!current_log_filep) {
+	if (current_log_fd < 0) {
 		PX4LOG_WARN("MavlinkLogHandler::get_log_data file not open %s\n", current_log_filename);
 		return 0;
 	}
 
-	long int offset = current_log_data_offset - ftell(current_log_filep);
+	const uint32_t offset = current_log_data_offset;
+	int result = -1;
 
-	if (offset && fseek(current_log_filep, offset, SEEK_CUR)) {
-		fclose(current_log_filep);
-		current_log_filep = nullptr;
-		PX4LOG_WARN("MavlinkLogHandler::get_log_data Seek error in %s\n", current_log_filename);
-		return 0;
+	pthread_mutex_lock(&_ring_mutex);
+
+	if (offset < _ring_offset || offset >= _ring_offset + kReadAheadSize) {
+		// outside of the buffered and pending window (re-request after data loss),
+		// restart prefetching at the chunk containing the requested offset
+		_ring_offset = offset - (offset % kReadChunk);
+		_ring_fill = 0;
+		_ring_eof = false;
+		_seek_generation++;
+		pthread_cond_signal(&_ring_cond);
+
+	} else {
+		// release what was already sent (or skipped), the read-ahead thread keeps filling behind it.
+		// An offset beyond the buffered data is a pending seek target, which is reached without re-seeking.
+		uint32_t consumed = offset - _ring_offset;
+
+		if (consumed > _ring_fill) {
+			consumed = _ring_fill;
+		}
+
+		if (consumed > 0) {
+			_ring_offset += consumed;
+			_ring_fill -= consumed;
+			pthread_cond_signal(&_ring_cond);
+		}
+
+		if (offset != _ring_offset) {
+			// not read yet, unless the requested offset is beyond the end of the file
+			if (_ring_eof) {
+				result = 0;
+			}
+
+		} else if (_ring_fill >= len || _ring_eof) {
+			// only send short messages at the end of the file
+			result = (_ring_fill < len) ? _ring_fill : len;
+
+			const uint32_t index = _ring_offset % kReadAheadSize;
+			const uint32_t first = (index + result > kReadAheadSize) ? kReadAheadSize - index : result;
+			memcpy(buffer, &_ring[index], first);
+			memcpy(buffer + first, &_ring[0], result - first);
+		}
 	}
 
-	size_t result = fread(buffer, 1, len, current_log_filep);
+	pthread_mutex_unlock(&_ring_mutex);
+
 	return result;
 }
 
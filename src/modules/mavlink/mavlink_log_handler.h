@@ -37,6 +37,7 @@
 /// @author px4dev, Gus Grubba <mavlink@grubba.com>
 
 #include <dirent.h>
+#include <pthread.h>
 #include <queue.h>
 #include <time.h>
 #include <stdio.h>
@@ -60,7 +61,14 @@ public:
 
 	bool        get_entry(int idx, uint32_t &size, uint32_t &date, char *filename = 0, int filename_len = 0);
 	bool        open_for_transmit();
-	size_t      get_log_data(uint8_t len, uint8_t *buffer);
+	void        close_for_transmit();
+
+	/**
+	 * Copy log data at current_log_data_offset out of the prefetch ring.
+	 * Never blocks: if the offset is outside of the prefetch window the read-ahead thread is pointed at it.
+	 * @return number of bytes copied, 0 at the end of the file, -1 if the data is not available yet
+	 */
+	int         get_log_data(uint8_t len, uint8_t *buffer);
 
 	enum {
 		LOG_HANDLER_IDLE,
@@ -77,11 +85,33 @@ public:
 	uint32_t    current_log_size;
 	uint32_t    current_log_data_offset;
 	uint32_t    current_log_data_remaining;
-	FILE       *current_log_filep;
+	int         current_log_fd;
 	char        current_log_filename[128];
 
 private:
 	void        _init();
+
+	static void *_read_ahead_trampoline(void *arg);
+	void        _read_ahead_run();
+
+	/* prefetch ring filled by the read-ahead thread, ring index = file offset % kReadAheadSize */
+#ifdef __PX4_NUTTX
+	static constexpr uint32_t kReadAheadSize = 4096;
+#else
+	static constexpr uint32_t kReadAheadSize = 64 * 1024;
+#endif
+	static constexpr uint32_t kReadChunk = kReadAheadSize / 4;	///< size of each read, file offsets are aligned to it
+
+	uint8_t    *_ring{nullptr};
+	uint32_t    _ring_offset{0};		///< file offset of the first buffered byte
+	uint32_t    _ring_fill{0};		///< number of buffered bytes
+	uint32_t    _seek_generation{0};	///< incremented on every seek, read results of an older generation are dropped
+	bool        _ring_eof{false};
+	bool        _read_ahead_exit{false};
+	bool        _read_ahead_running{false};
+	pthread_t   _read_ahead_thread{};
+	pthread_mutex_t _ring_mutex{};
+	pthread_cond_t  _ring_cond{};
 	bool        _get_session_date(const char *path, const char *dir, time_t &date);
 	void        _scan_logs(FILE *f, const char *dir, time_t &date);
 	bool        _get_log_time_size(const char *path, const char *file, time_t &date, uint32_t &size);
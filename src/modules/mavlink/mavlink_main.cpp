@@ -40,6 +40,8 @@
  * @author Anton Babushkin <anton.babushkin@me.com>
  */
 
+#include <ctype.h>
+#include <inttypes.h>
 #include <termios.h>
 
 #ifdef CONFIG_NET
@@ -55,6 +57,7 @@
 
 #include "mavlink_receiver.h"
 #include "mavlink_main.h"
+#include "mavlink_stream_profiles.h"
 
 // Guard against MAVLink misconfiguration
 #ifndef MAVLINK_CRC_EXTRA
@@ -106,7 +109,7 @@ void mavlink_start_uart_send(mavlink_channel_t chan, int length)
 	Mavlink *m = Mavlink::get_instance(chan);
 
 	if (m != nullptr) {
-		(void)m->begin_send();
+		m->begin_send(length);
 #ifdef MAVLINK_PRINT_PACKETS
 		printf("START PACKET (%u): ", (unsigned)chan);
 #endif
@@ -118,7 +121,7 @@ void mavlink_end_uart_send(mavlink_channel_t chan, int length)
 	Mavlink *m = Mavlink::get_instance(chan);
 
 	if (m != nullptr) {
-		(void)m->send_packet();
+		m->end_send();
 #ifdef MAVLINK_PRINT_PACKETS
 		printf("\n");
 #endif
@@ -161,6 +164,11 @@ hrt_abstime Mavlink::_first_start_time = {0};
 
 bool Mavlink::_boot_complete = false;
 
+Mavlink::ForwardedFrame *Mavlink::_forward_pool = nullptr;
+int Mavlink::_forwarding_instances = 0;
+Mavlink::Route Mavlink::_routes[Mavlink::MAX_ROUTES] {};
+pthread_mutex_t Mavlink::_forward_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 Mavlink::Mavlink() :
 	ModuleParams(nullptr)
 {
@@ -209,6 +217,8 @@ Mavlink::~Mavlink()
 
 	perf_free(_loop_perf);
 	perf_free(_loop_interval_perf);
+
+	delete[] _user_stream_profile;
 }
 
 void
@@ -445,40 +455,135 @@ Mavlink::serial_instance_exists(const char *device_name, Mavlink *self)
 void
 Mavlink::forward_message(const mavlink_message_t *msg, Mavlink *self)
 {
+	const mavlink_msg_entry_t *meta = mavlink_get_msg_entry(msg->msgid);
+
+	int target_system_id = 0;
+	int target_component_id = 0;
+
+	// might be nullptr if message is unknown
+	if (meta) {
+		// Extract target system and target component if set
+		if (meta->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM) {
+			target_system_id = (_MAV_PAYLOAD(msg))[meta->target_system_ofs];
+		}
+
+		if (meta->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_COMPONENT) {
+			target_component_id = (_MAV_PAYLOAD(msg))[meta->target_component_ofs];
+		}
+	}
+
+	// If it's a message only for us, we keep it, otherwise, we forward it.
+	const bool targeted_only_at_us =
+		(target_system_id == self->get_system_id() &&
+		 target_component_id == self->get_component_id());
+
+	// We don't forward heartbeats unless it's specifically enabled.
+	const bool heartbeat_check_ok =
+		(msg->msgid != MAVLINK_MSG_ID_HEARTBEAT || self->forward_heartbeats_enabled());
+
+	pthread_mutex_lock(&_forward_mutex);
+
+	update_route(msg, self);
+
+	if (targeted_only_at_us || !heartbeat_check_ok || (_forward_pool == nullptr)) {
+		pthread_mutex_unlock(&_forward_mutex);
+		return;
+	}
+
+	// Targeted messages only go to the link(s) their target has been seen on, to all links if unknown
+	bool target_known = false;
+
+	if (target_system_id != 0) {
+		if (has_route(target_system_id, target_component_id, nullptr)) {
+			target_known = true;
+
+		} else if (has_route(target_system_id, 0, nullptr)) {
+			// component not seen yet, route by system
+			target_known = true;
+			target_component_id = 0;
+		}
+	}
+
+	ForwardedFrame *frame = nullptr;
+
 	Mavlink *inst;
 	LL_FOREACH(_mavlink_instances, inst) {
-		if (inst != self) {
-			const mavlink_msg_entry_t *meta = mavlink_get_msg_entry(msg->msgid);
+		if ((inst == self) || !inst->_forward_ready) {
+			continue;
+		}
 
-			int target_system_id = 0;
-			int target_component_id = 0;
+		if (target_known && !has_route(target_system_id, target_component_id, inst)) {
+			continue;
+		}
 
-			// might be nullptr if message is unknown
-			if (meta) {
-				// Extract target system and target component if set
-				if (meta->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM) {
-					target_system_id = (_MAV_PAYLOAD(msg))[meta->target_system_ofs];
+		if (frame == nullptr) {
+			// copy the message once, we hold a reference until it has been passed to all instances
+			for (int i = 0; i < FORWARD_POOL_SIZE; i++) {
+				if (_forward_pool[i].refcount.load() == 0) {
+					frame = &_forward_pool[i];
+					break;
 				}
+			}
 
-				if (meta->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_COMPONENT) {
-					target_component_id = (_MAV_PAYLOAD(msg))[meta->target_component_ofs];
-				}
+			if (frame == nullptr) {
+				// all frames in use, drop the message
+				break;
 			}
 
-			// If it's a message only for us, we keep it, otherwise, we forward it.
-			const bool targeted_only_at_us =
-				(target_system_id == self->get_system_id() &&
-				 target_component_id == self->get_component_id());
+			frame->refcount.store(1);
+			frame->msg = *msg;
+		}
 
-			// We don't forward heartbeats unless it's specifically enabled.
-			const bool heartbeat_check_ok =
-				(msg->msgid != MAVLINK_MSG_ID_HEARTBEAT || self->forward_heartbeats_enabled());
+		inst->pass_message(frame);
+	}
 
-			if (!targeted_only_at_us && heartbeat_check_ok) {
-				inst->pass_message(msg);
+	pthread_mutex_unlock(&_forward_mutex);
+
+	if (frame != nullptr) {
+		frame->refcount.fetch_sub(1);
+	}
+}
+
+void
+Mavlink::update_route(const mavlink_message_t *msg, const Mavlink *inst)
+{
+	int free_index = -1;
+
+	for (int i = 0; i < MAX_ROUTES; i++) {
+		Route &route = _routes[i];
+
+		if (route.inst == nullptr) {
+			if (free_index < 0) {
+				free_index = i;
 			}
+
+		} else if ((route.system_id == msg->sysid) && (route.component_id == msg->compid)) {
+			// the component might have moved to another link
+			route.inst = inst;
+			return;
+		}
+	}
+
+	// if the table is full, messages to this component are sent to all links
+	if (free_index >= 0) {
+		_routes[free_index] = Route{inst, msg->sysid, msg->compid};
+	}
+}
+
+bool
+Mavlink::has_route(int target_system_id, int target_component_id, const Mavlink *inst)
+{
+	for (int i = 0; i < MAX_ROUTES; i++) {
+		const Route &route = _routes[i];
+
+		if ((route.inst != nullptr) && (route.system_id == target_system_id)
+		    && ((target_component_id == 0) || (route.component_id == target_component_id))
+		    && ((inst == nullptr) || (route.inst == inst))) {
+			return true;
 		}
 	}
+
+	return false;
 }
 
 int
@@ -730,12 +835,6 @@ Mavlink::set_hil_enabled(bool hil_enabled)
 unsigned
 Mavlink::get_free_tx_buf()
 {
-	/*
-	 * Check if the OS buffer is full and disable HW
-	 * flow control if it continues to be full
-	 */
-	int buf_free = 0;
-
 #if defined(MAVLINK_UDP)
 
 	// if we are using network sockets, return max length of one packet
@@ -745,72 +844,153 @@ Mavlink::get_free_tx_buf()
 	} else
 #endif // MAVLINK_UDP
 	{
-		// No FIONSPACE on Linux todo:use SIOCOUTQ  and queue size to emulate FIONSPACE
+		// the OS buffer space is only queried once per flush, minus what we buffered since then
+		const int buf_free = _tx_os_buf_free - (int)_tx_buf_len;
+		return (buf_free > 0) ? buf_free : 0;
+	}
+}
+
+void
+Mavlink::update_os_tx_buf_free()
+{
+	/*
+	 * Check if the OS buffer is full and disable HW
+	 * flow control if it continues to be full
+	 */
+	int buf_free = 0;
+
+	// No FIONSPACE on Linux todo:use SIOCOUTQ  and queue size to emulate FIONSPACE
 #if defined(__PX4_LINUX) || defined(__PX4_DARWIN) || defined(__PX4_CYGWIN)
-		//Linux cp210x does not support TIOCOUTQ
-		buf_free = 256;
+	//Linux cp210x does not support TIOCOUTQ
+	buf_free = TX_BUFFER_SIZE;
 #else
-		(void) ioctl(_uart_fd, FIONSPACE, (unsigned long)&buf_free);
+	(void) ioctl(_uart_fd, FIONSPACE, (unsigned long)&buf_free);
 #endif
 
-		if (_flow_control_mode == FLOW_CONTROL_AUTO && buf_free < FLOW_CONTROL_DISABLE_THRESHOLD) {
-			/* Disable hardware flow control in FLOW_CONTROL_AUTO mode:
-			 * if no successful write since a defined time
-			 * and if the last try was not the last successful write
-			 */
-			if (_last_write_try_time != 0 &&
-			    hrt_elapsed_time(&_last_write_success_time) > 500_ms &&
-			    _last_write_success_time != _last_write_try_time) {
+	if (_flow_control_mode == FLOW_CONTROL_AUTO && buf_free < FLOW_CONTROL_DISABLE_THRESHOLD) {
+		/* Disable hardware flow control in FLOW_CONTROL_AUTO mode:
+		 * if no successful write since a defined time
+		 * and if the last try was not the last successful write
+		 */
+		if (_last_write_try_time != 0 &&
+		    hrt_elapsed_time(&_last_write_success_time) > 500_ms &&
+		    _last_write_success_time != _last_write_try_time) {
 
-				enable_flow_control(FLOW_CONTROL_OFF);
-			}
+			enable_flow_control(FLOW_CONTROL_OFF);
 		}
 	}
 
-	return buf_free;
+	_tx_os_buf_free = buf_free;
 }
 
-int
-Mavlink::send_packet()
+void
+Mavlink::begin_send(unsigned frame_len)
 {
-	int ret = -1;
+	pthread_mutex_lock(&_send_mutex);
 
-#if defined(MAVLINK_UDP)
+	// make room for the whole frame, frames are never split across writes
+	if (_tx_buf_len + frame_len > TX_BUFFER_SIZE) {
+		flush_tx_buffer_locked();
+	}
 
-	/* Only send packets if there is something in the buffer. */
-	if (_network_buf_len == 0) {
-		pthread_mutex_unlock(&_send_mutex);
-		return 0;
+	if (get_protocol() == Protocol::SERIAL && get_free_tx_buf() < frame_len) {
+		// the OS buffer space might be outdated, write out pending frames and query it again
+		flush_tx_buffer_locked();
 	}
 
-	if (get_protocol() == Protocol::UDP) {
+	_tx_buf_frame_start = _tx_buf_len;
+	_tx_frame_dropped = (frame_len > TX_BUFFER_SIZE - _tx_buf_len);
+
+	if (get_protocol() == Protocol::SERIAL && !_tx_frame_dropped) {
+		/* check if there is space in the OS buffer, let it overflow else */
+		_tx_frame_dropped = (get_free_tx_buf() < frame_len);
+	}
+
+	if (_tx_frame_dropped) {
+		count_txerrbytes(frame_len);
+
+	} else {
+		/* critical streams and replies may overdraw the budget, but not by more than one burst */
+		_tx_tokens = math::max(_tx_tokens - frame_len, -(float)TX_BUFFER_SIZE);
+	}
+}
+
+int
+Mavlink::flush_tx_buffer()
+{
+	pthread_mutex_lock(&_send_mutex);
+	int ret = flush_tx_buffer_locked();
+	pthread_mutex_unlock(&_send_mutex);
+	return ret;
+}
+
+int
+Mavlink::flush_tx_buffer_locked()
+{
+	int ret = 0;
+
+	if (_tx_buf_len > 0) {
+		ret = -1;
+
+		/* send all buffered frames to the UART */
+		if (get_protocol() == Protocol::SERIAL) {
+			ret = ::write(_uart_fd, _tx_buf, _tx_buf_len);
+		}
+
+#if defined(MAVLINK_UDP)
+
+		else if (get_protocol() == Protocol::UDP) {
+			/* the buffered frames are packed once and fanned out to every destination */
+			const sockaddr_in *destinations[MAX_UDP_DESTINATIONS];
+			int num_destinations = 0;
+			int bcast_index = -1;
 
 #ifdef CONFIG_NET
 
-		if (_src_addr_initialized) {
+			if (_src_addr_initialized) {
 #endif
-			ret = sendto(_socket_fd, _network_buf, _network_buf_len, 0,
-				     (struct sockaddr *)&_src_addr, sizeof(_src_addr));
+				destinations[num_destinations++] = &_src_addr;
 #ifdef CONFIG_NET
-		}
+			}
 
 #endif
 
-		/* resend message via broadcast if no valid connection exists */
-		if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
-		    (!get_client_source_initialized()
-		     || (hrt_elapsed_time(&_tstatus.heartbeat_time) > 3_s))) {
+			for (int i = 0; i < _remote_endpoint_count; i++) {
+				destinations[num_destinations++] = &_remote_endpoints[i];
+			}
 
-			if (!_broadcast_address_found) {
-				find_broadcast_address();
+			/* resend message via broadcast if no valid connection exists */
+			if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
+			    (!get_client_source_initialized()
+			     || (hrt_elapsed_time(&_tstatus.heartbeat_time) > 3_s))) {
+
+				if (!_broadcast_address_found) {
+					find_broadcast_address();
+				}
+
+				if (_broadcast_address_found) {
+					bcast_index = num_destinations;
+					destinations[num_destinations++] = &_bcast_addr;
+				}
 			}
 
-			if (_broadcast_address_found && _network_buf_len > 0) {
+			int results[MAX_UDP_DESTINATIONS];
+			send_udp_fanout(destinations, results, num_destinations);
+
+			/* the write counts as successful if any destination took the whole batch */
+			for (int i = 0; i < num_destinations; i++) {
+				if (results[i] == (int)_tx_buf_len) {
+					ret = results[i];
+					break;
+				}
 
-				int bret = sendto(_socket_fd, _network_buf, _network_buf_len, 0,
-						  (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
+				if (i == 0) {
+					ret = results[i];
+				}
+			}
 
-				if (bret <= 0) {
+			if (bcast_index >= 0) {
+				if (results[bcast_index] <= 0) {
 					if (!_broadcast_failed_warned) {
 						PX4_ERR("sending broadcast failed, errno: %d: %s", errno, strerror(errno));
 						_broadcast_failed_warned = true;
@@ -822,62 +1002,84 @@ Mavlink::send_packet()
 			}
 		}
 
-	}
+#endif // MAVLINK_UDP
 
-	_network_buf_len = 0;
+		if (ret != (int)_tx_buf_len) {
+			count_txerrbytes(_tx_buf_len);
 
-#endif // MAVLINK_UDP
+		} else {
+			_last_write_success_time = _last_write_try_time;
+			count_txbytes(_tx_buf_len);
+		}
+
+		_tx_buf_len = 0;
+	}
+
+	if (get_protocol() == Protocol::SERIAL) {
+		update_os_tx_buf_free();
+	}
 
-	pthread_mutex_unlock(&_send_mutex);
 	return ret;
 }
 
+#if defined(MAVLINK_UDP)
 void
-Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
+Mavlink::send_udp_fanout(const sockaddr_in *const destinations[], int results[], int num_destinations)
 {
-	_last_write_try_time = hrt_absolute_time();
+	int first = 0;
 
-	if (_mavlink_start_time == 0) {
-		_mavlink_start_time = _last_write_try_time;
+#if defined(__PX4_LINUX)
+	/* a single syscall for all destinations */
+	struct iovec iov {_tx_buf, _tx_buf_len};
+	struct mmsghdr msgs[MAX_UDP_DESTINATIONS] {};
+
+	for (int i = 0; i < num_destinations; i++) {
+		msgs[i].msg_hdr.msg_name = (void *)destinations[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+		msgs[i].msg_hdr.msg_iov = &iov;
+		msgs[i].msg_hdr.msg_iovlen = 1;
 	}
 
-	if (get_protocol() == Protocol::SERIAL) {
-		/* check if there is space in the buffer, let it overflow else */
-		unsigned buf_free = get_free_tx_buf();
+	const int sent = (num_destinations > 0) ? sendmmsg(_socket_fd, msgs, num_destinations, 0) : 0;
 
-		if (buf_free < packet_len) {
-			/* not enough space in buffer to send */
-			count_txerrbytes(packet_len);
-			return;
-		}
+	for (; first < sent; first++) {
+		results[first] = msgs[first].msg_len;
 	}
 
-	size_t ret = -1;
+	/* sendmmsg() stops at the first failing destination, send the rest individually */
+#endif
 
-	/* send message to UART */
-	if (get_protocol() == Protocol::SERIAL) {
-		ret = ::write(_uart_fd, buf, packet_len);
+	for (int i = first; i < num_destinations; i++) {
+		results[i] = sendto(_socket_fd, _tx_buf, _tx_buf_len, 0,
+				    (const struct sockaddr *)destinations[i], sizeof(sockaddr_in));
 	}
+}
+#endif // MAVLINK_UDP
 
-#if defined(MAVLINK_UDP)
-
-	else {
-		if (_network_buf_len + packet_len < sizeof(_network_buf) / sizeof(_network_buf[0])) {
-			memcpy(&_network_buf[_network_buf_len], buf, packet_len);
-			_network_buf_len += packet_len;
+void
+Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
+{
+	_last_write_try_time = hrt_absolute_time();
 
-			ret = packet_len;
-		}
+	if (_mavlink_start_time == 0) {
+		_mavlink_start_time = _last_write_try_time;
 	}
 
-#endif // MAVLINK_UDP
+	if (_tx_frame_dropped) {
+		return;
+	}
 
-	if (ret != (size_t) packet_len) {
-		count_txerrbytes(packet_len);
+	if (_tx_buf_len + packet_len <= TX_BUFFER_SIZE) {
+		memcpy(&_tx_buf[_tx_buf_len], buf, packet_len);
+		_tx_buf_len += packet_len;
+		_tx_bytes_queued += packet_len;
 
 	} else {
-		_last_write_success_time = _last_write_try_time;
-		count_txbytes(packet_len);
+		/* larger than announced in begin_send(), drop the partial frame */
+		count_txerrbytes(_tx_buf_len - _tx_buf_frame_start + packet_len);
+		_tx_bytes_queued -= _tx_buf_len - _tx_buf_frame_start;
+		_tx_buf_len = _tx_buf_frame_start;
+		_tx_frame_dropped = true;
 	}
 }
 
@@ -1114,6 +1316,13 @@ Mavlink::init_udp()
 	}
 
 	_src_addr.sin_port = htons(_remote_port);
+
+	/* additional endpoints without an explicit port use the remote port */
+	for (int i = 0; i < _remote_endpoint_count; i++) {
+		if (_remote_endpoints[i].sin_port == 0) {
+			_remote_endpoints[i].sin_port = htons(_remote_port);
+		}
+	}
 }
 #endif // MAVLINK_UDP
 
@@ -1251,8 +1460,8 @@ Mavlink::add_orb_subscription(const orb_id_t topic, int instance, bool disable_s
 		}
 	}
 
-	/* add new subscription */
-	MavlinkOrbSubscription *sub_new = new MavlinkOrbSubscription(topic, instance);
+	/* add new subscription, sharing the topic snapshot with the other instances */
+	MavlinkOrbSubscription *sub_new = new MavlinkOrbSubscription(topic, instance, !disable_sharing);
 
 	_subscriptions.add(sub_new);
 
@@ -1262,7 +1471,26 @@ Mavlink::add_orb_subscription(const orb_id_t topic, int instance, bool disable_s
 int
 Mavlink::configure_stream(const char *stream_name, const float rate)
 {
-	PX4_DEBUG("configure_stream(%s, %.3f)", stream_name, (double)rate);
+	const StreamListItem *stream_item = get_stream_list_item(stream_name);
+
+	if (stream_item != nullptr) {
+		return configure_stream(*stream_item, rate);
+	}
+
+	if (rate > 0.000001f || rate < 0.0f) {
+		/* if we reach here, the stream list does not contain the stream */
+		PX4_WARN("stream %s not found", stream_name);
+		return PX4_ERROR;
+	}
+
+	/* unknown stream is requested to be disabled, do nothing */
+	return OK;
+}
+
+int
+Mavlink::configure_stream(const StreamListItem &stream_item, const float rate)
+{
+	PX4_DEBUG("configure_stream(%s, %.3f)", stream_item.get_name(), (double)rate);
 
 	/* calculate interval in us, -1 means unlimited stream, 0 means disabled */
 	int interval = 0;
@@ -1275,7 +1503,8 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 	}
 
 	for (const auto &stream : _streams) {
-		if (strcmp(stream_name, stream->get_name()) == 0) {
+		/* the ID check avoids the string compare for all but (at most) a few streams */
+		if (stream->get_id() == stream_item.get_id() && strcmp(stream_item.get_name(), stream->get_name()) == 0) {
 			if (interval != 0) {
 				/* set new interval */
 				stream->set_interval(interval);
@@ -1295,21 +1524,16 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 		return OK;
 	}
 
-	// search for stream with specified name in supported streams list
-	// create new instance if found
-	MavlinkStream *stream = create_mavlink_stream(stream_name, this);
-
-	if (stream != nullptr) {
-		stream->set_interval(interval);
-		_streams.add(stream);
+	MavlinkStream *stream = stream_item.new_instance(this);
 
-		return OK;
+	if (stream == nullptr) {
+		return PX4_ERROR;
 	}
 
-	/* if we reach here, the stream list does not contain the stream */
-	PX4_WARN("stream %s not found", stream_name);
+	stream->set_interval(interval);
+	_streams.add(stream);
 
-	return PX4_ERROR;
+	return OK;
 }
 
 void
@@ -1343,117 +1567,104 @@ Mavlink::configure_stream_threadsafe(const char *stream_name, const float rate)
 }
 
 int
-Mavlink::message_buffer_init(int size)
+Mavlink::forward_init()
 {
-	_message_buffer.size = size;
-	_message_buffer.write_ptr = 0;
-	_message_buffer.read_ptr = 0;
-	_message_buffer.data = (char *)malloc(_message_buffer.size);
-
-	int ret;
+	pthread_mutex_init(&_forward_queue_mutex, nullptr);
 
-	if (_message_buffer.data == nullptr) {
-		ret = PX4_ERROR;
-		_message_buffer.size = 0;
+	pthread_mutex_lock(&_forward_mutex);
 
-	} else {
-		ret = OK;
+	if (_forward_pool == nullptr) {
+		_forward_pool = new ForwardedFrame[FORWARD_POOL_SIZE];
 	}
 
-	return ret;
-}
+	if (_forward_pool != nullptr) {
+		_forwarding_instances++;
+		_forward_ready = true;
+	}
 
-void
-Mavlink::message_buffer_destroy()
-{
-	_message_buffer.size = 0;
-	_message_buffer.write_ptr = 0;
-	_message_buffer.read_ptr = 0;
-	free(_message_buffer.data);
-}
+	pthread_mutex_unlock(&_forward_mutex);
 
-int
-Mavlink::message_buffer_count()
-{
-	int n = _message_buffer.write_ptr - _message_buffer.read_ptr;
-
-	if (n < 0) {
-		n += _message_buffer.size;
+	if (!_forward_ready) {
+		pthread_mutex_destroy(&_forward_queue_mutex);
+		return PX4_ERROR;
 	}
 
-	return n;
+	return OK;
 }
 
-bool
-Mavlink::message_buffer_write(const void *ptr, int size)
+void
+Mavlink::forward_deinit()
 {
-	// bytes available to write
-	int available = _message_buffer.read_ptr - _message_buffer.write_ptr - 1;
+	pthread_mutex_lock(&_forward_mutex);
 
-	if (available < 0) {
-		available += _message_buffer.size;
-	}
+	_forward_ready = false;
+
+	// release the frames that haven't been sent
+	pthread_mutex_lock(&_forward_queue_mutex);
 
-	if (size > available) {
-		// buffer overflow
-		return false;
+	while (_forward_queue_tail != _forward_queue_head) {
+		_forward_queue[_forward_queue_tail]->refcount.fetch_sub(1);
+		_forward_queue_tail = (_forward_queue_tail + 1) % FORWARD_QUEUE_SIZE;
 	}
 
-	char *c = (char *) ptr;
-	int n = _message_buffer.size - _message_buffer.write_ptr;	// bytes to end of the buffer
+	pthread_mutex_unlock(&_forward_queue_mutex);
 
-	if (n < size) {
-		// message goes over end of the buffer
-		memcpy(&(_message_buffer.data[_message_buffer.write_ptr]), c, n);
-		_message_buffer.write_ptr = 0;
+	for (int i = 0; i < MAX_ROUTES; i++) {
+		if (_routes[i].inst == this) {
+			_routes[i].inst = nullptr;
+		}
+	}
 
-	} else {
-		n = 0;
+	if (--_forwarding_instances == 0) {
+		delete[] _forward_pool;
+		_forward_pool = nullptr;
 	}
 
-	// now: n = bytes already written
-	int p = size - n;	// number of bytes to write
-	memcpy(&(_message_buffer.data[_message_buffer.write_ptr]), &(c[n]), p);
-	_message_buffer.write_ptr = (_message_buffer.write_ptr + p) % _message_buffer.size;
-	return true;
+	pthread_mutex_unlock(&_forward_mutex);
+
+	pthread_mutex_destroy(&_forward_queue_mutex);
 }
 
-int
-Mavlink::message_buffer_get_ptr(void **ptr, bool *is_part)
+bool
+Mavlink::pass_message(ForwardedFrame *frame)
 {
-	// bytes available to read
-	int available = _message_buffer.write_ptr - _message_buffer.read_ptr;
-
-	if (available == 0) {
-		return 0;	// buffer is empty
-	}
+	pthread_mutex_lock(&_forward_queue_mutex);
 
-	int n = 0;
+	const int next = (_forward_queue_head + 1) % FORWARD_QUEUE_SIZE;
+	const bool queued = (next != _forward_queue_tail);
 
-	if (available > 0) {
-		// read pointer is before write pointer, all available bytes can be read
-		n = available;
-		*is_part = false;
-
-	} else {
-		// read pointer is after write pointer, read bytes from read_ptr to end of the buffer
-		n = _message_buffer.size - _message_buffer.read_ptr;
-		*is_part = _message_buffer.write_ptr > 0;
+	if (queued) {
+		frame->refcount.fetch_add(1);
+		_forward_queue[_forward_queue_head] = frame;
+		_forward_queue_head = next;
 	}
 
-	*ptr = &(_message_buffer.data[_message_buffer.read_ptr]);
-	return n;
+	pthread_mutex_unlock(&_forward_queue_mutex);
+
+	return queued;
 }
 
 void
-Mavlink::pass_message(const mavlink_message_t *msg)
+Mavlink::send_forwarded_messages()
 {
-	if (_forwarding_on) {
-		/* size is 8 bytes plus variable payload */
-		int size = MAVLINK_NUM_NON_PAYLOAD_BYTES + msg->len;
-		pthread_mutex_lock(&_message_buffer_mutex);
-		message_buffer_write(msg, size);
-		pthread_mutex_unlock(&_message_buffer_mutex);
+	while (true) {
+		ForwardedFrame *frame = nullptr;
+
+		pthread_mutex_lock(&_forward_queue_mutex);
+
+		if (_forward_queue_tail != _forward_queue_head) {
+			frame = _forward_queue[_forward_queue_tail];
+			_forward_queue_tail = (_forward_queue_tail + 1) % FORWARD_QUEUE_SIZE;
+		}
+
+		pthread_mutex_unlock(&_forward_queue_mutex);
+
+		if (frame == nullptr) {
+			break;
+		}
+
+		resend_message(&frame->msg);
+		frame->refcount.fetch_sub(1);
 	}
 }
 
@@ -1492,16 +1703,17 @@ Mavlink::close_shell()
 void
 Mavlink::update_rate_mult()
 {
-	float const_rate = 0.0f;
-	float rate = 0.0f;
+	static constexpr int class_count = (int)MavlinkStream::Priority::COUNT;
 
-	/* scale down rates if their theoretical bandwidth is exceeding the link bandwidth */
-	for (const auto &stream : _streams) {
-		if (stream->const_rate()) {
-			const_rate += (stream->get_interval() > 0) ? stream->get_size_avg() * 1000000.0f / stream->get_interval() : 0;
+	/* minimum share of the configured rate each class keeps, so that something is always sent */
+	static constexpr float class_min_mult[class_count] {1.0f, 0.2f, 0.05f};
 
-		} else {
-			rate += (stream->get_interval() > 0) ? stream->get_size_avg() * 1000000.0f / stream->get_interval() : 0;
+	float class_rate[class_count] {};
+
+	/* theoretical bandwidth of each scheduling class */
+	for (const auto &stream : _streams) {
+		if (stream->get_interval() > 0) {
+			class_rate[(int)stream->priority()] += stream->get_size_avg() * 1000000.0f / stream->get_interval();
 		}
 	}
 
@@ -1511,14 +1723,6 @@ Mavlink::update_rate_mult()
 		mavlink_ulog_streaming_rate_inv = 1.0f - _mavlink_ulog->current_data_rate();
 	}
 
-	/* scale up and down as the link permits */
-	float bandwidth_mult = (float)(_datarate * mavlink_ulog_streaming_rate_inv - const_rate) / rate;
-
-	/* if we do not have flow control, limit to the set data rate */
-	if (!get_flow_control_enabled()) {
-		bandwidth_mult = fminf(1.0f, bandwidth_mult);
-	}
-
 	float hardware_mult = 1.0f;
 
 	/* scale down if we have a TX err rate suggesting link congestion */
@@ -1540,11 +1744,48 @@ Mavlink::update_rate_mult()
 		hardware_mult *= _radio_status_mult;
 	}
 
-	/* pick the minimum from bandwidth mult and hardware mult as limit */
-	_rate_mult = fminf(bandwidth_mult, hardware_mult);
+	/* bandwidth the link currently permits [B/s] */
+	const float link_rate = _datarate * mavlink_ulog_streaming_rate_inv * hardware_mult;
+
+	/* hand out the budget by priority: critical streams first, then normal and low priority streams */
+	float budget = link_rate;
+
+	for (int i = 0; i < class_count; i++) {
+		float mult = 1.0f;
+
+		if (i != (int)MavlinkStream::Priority::CRITICAL && class_rate[i] > 0.0f) {
+			mult = budget / class_rate[i];
+
+			/* if we do not have flow control, limit to the set data rate */
+			if (!get_flow_control_enabled()) {
+				mult = fminf(1.0f, mult);
+			}
+
+			mult = math::constrain(mult, class_min_mult[i], 1.0f);
+		}
+
+		_rate_mult_class[i] = mult;
+		budget -= class_rate[i] * mult;
+	}
+
+	_rate_mult = _rate_mult_class[(int)MavlinkStream::Priority::NORMAL];
+
+	/* refill the token bucket, allowing bursts of up to 100 ms or one TX buffer */
+	const hrt_abstime now = hrt_absolute_time();
+
+	pthread_mutex_lock(&_send_mutex);
+
+	_tx_budget_enabled = !get_flow_control_enabled();
+
+	if (_tx_tokens_last_update > 0) {
+		const float dt = (now - _tx_tokens_last_update) * 1e-6f;
+		const float burst = math::max(link_rate * 0.1f, (float)TX_BUFFER_SIZE);
+		_tx_tokens = math::min(_tx_tokens + link_rate * dt, burst);
+	}
+
+	_tx_tokens_last_update = now;
 
-	/* ensure the rate multiplier never drops below 5% so that something is always sent */
-	_rate_mult = math::constrain(_rate_mult, 0.05f, 1.0f);
+	pthread_mutex_unlock(&_send_mutex);
 }
 
 void
@@ -1571,245 +1812,117 @@ Mavlink::update_radio_status(const radio_status_s &radio_status)
 	}
 }
 
-int
-Mavlink::configure_streams_to_default(const char *configure_single_stream)
+void
+Mavlink::load_user_stream_profile()
 {
-	int ret = 0;
-	bool stream_configured = false;
+	delete[] _user_stream_profile;
+	_user_stream_profile = nullptr;
+	_user_stream_profile_count = 0;
+	_user_stream_profile_valid = false;
+	_user_stream_profile_mode = _mode;
 
-	auto configure_stream_local =
-	[&stream_configured, configure_single_stream, &ret, this](const char *stream_name, float rate) {
-		if (!configure_single_stream || strcmp(configure_single_stream, stream_name) == 0) {
-			int ret_local = configure_stream(stream_name, rate);
+	/* e.g. /etc/mavlink/onboard.profile */
+	char mode_name[16] {};
+	strncpy(mode_name, mavlink_mode_str(_mode), sizeof(mode_name) - 1);
 
-			if (ret_local != 0) {
-				ret = ret_local;
-			}
+	for (char *c = mode_name; *c != '\0'; c++) {
+		*c = tolower(*c);
+	}
 
-			stream_configured = true;
-		}
-	};
-
-	const float unlimited_rate = -1.0f;
-
-	switch (_mode) {
-	case MAVLINK_MODE_NORMAL:
-		configure_stream_local("ADSB_VEHICLE", unlimited_rate);
-		configure_stream_local("ALTITUDE", 1.0f);
-		configure_stream_local("ATTITUDE", 15.0f);
-		configure_stream_local("ATTITUDE_TARGET", 2.0f);
-		configure_stream_local("BATTERY_STATUS", 0.5f);
-		configure_stream_local("CAMERA_IMAGE_CAPTURED", unlimited_rate);
-		configure_stream_local("COLLISION", unlimited_rate);
-		configure_stream_local("DEBUG", 1.0f);
-		configure_stream_local("DEBUG_FLOAT_ARRAY", 1.0f);
-		configure_stream_local("DEBUG_VECT", 1.0f);
-		configure_stream_local("DISTANCE_SENSOR", 0.5f);
-		configure_stream_local("ESTIMATOR_STATUS", 0.5f);
-		configure_stream_local("EXTENDED_SYS_STATE", 1.0f);
-		configure_stream_local("GLOBAL_POSITION_INT", 5.0f);
-		configure_stream_local("GPS2_RAW", 1.0f);
-		configure_stream_local("GPS_RAW_INT", 1.0f);
-		configure_stream_local("HOME_POSITION", 0.5f);
-		configure_stream_local("LOCAL_POSITION_NED", 1.0f);
-		configure_stream_local("NAMED_VALUE_FLOAT", 1.0f);
-		configure_stream_local("NAV_CONTROLLER_OUTPUT", 1.0f);
-		configure_stream_local("OBSTACLE_DISTANCE", 1.0f);
-		configure_stream_local("ORBIT_EXECUTION_STATUS", 2.0f);
-		configure_stream_local("PING", 0.1f);
-		configure_stream_local("POSITION_TARGET_GLOBAL_INT", 1.0f);
-		configure_stream_local("POSITION_TARGET_LOCAL_NED", 1.5f);
-		configure_stream_local("RC_CHANNELS", 5.0f);
-		configure_stream_local("SERVO_OUTPUT_RAW_0", 1.0f);
-		configure_stream_local("SYS_STATUS", 1.0f);
-		configure_stream_local("UTM_GLOBAL_POSITION", 0.5f);
-		configure_stream_local("VFR_HUD", 4.0f);
-		configure_stream_local("WIND_COV", 0.5f);
-		break;
+	char path[64];
+	snprintf(path, sizeof(path), PX4_ROOTFSDIR "/etc/mavlink/%s.profile", mode_name);
 
-	case MAVLINK_MODE_ONBOARD:
-		configure_stream_local("ACTUATOR_CONTROL_TARGET0", 10.0f);
-		configure_stream_local("ADSB_VEHICLE", unlimited_rate);
-		configure_stream_local("ALTITUDE", 10.0f);
-		configure_stream_local("ATTITUDE", 100.0f);
-		configure_stream_local("ATTITUDE_QUATERNION", 50.0f);
-		configure_stream_local("ATTITUDE_TARGET", 10.0f);
-		configure_stream_local("BATTERY_STATUS", 0.5f);
-		configure_stream_local("CAMERA_CAPTURE", 2.0f);
-		configure_stream_local("CAMERA_IMAGE_CAPTURED", unlimited_rate);
-		configure_stream_local("CAMERA_TRIGGER", unlimited_rate);
-		configure_stream_local("COLLISION", unlimited_rate);
-		configure_stream_local("DEBUG", 10.0f);
-		configure_stream_local("DEBUG_FLOAT_ARRAY", 10.0f);
-		configure_stream_local("DEBUG_VECT", 10.0f);
-		configure_stream_local("DISTANCE_SENSOR", 10.0f);
-		configure_stream_local("ESTIMATOR_STATUS", 1.0f);
-		configure_stream_local("EXTENDED_SYS_STATE", 5.0f);
-		configure_stream_local("GLOBAL_POSITION_INT", 50.0f);
-		configure_stream_local("GPS2_RAW", unlimited_rate);
-		configure_stream_local("GPS_RAW_INT", unlimited_rate);
-		configure_stream_local("HIGHRES_IMU", 50.0f);
-		configure_stream_local("HOME_POSITION", 0.5f);
-		configure_stream_local("LOCAL_POSITION_NED", 30.0f);
-		configure_stream_local("NAMED_VALUE_FLOAT", 10.0f);
-		configure_stream_local("NAV_CONTROLLER_OUTPUT", 10.0f);
-		configure_stream_local("OBSTACLE_DISTANCE", 10.0f);
-		configure_stream_local("ODOMETRY", 30.0f);
-		configure_stream_local("OPTICAL_FLOW_RAD", 10.0f);
-		configure_stream_local("ORBIT_EXECUTION_STATUS", 5.0f);
-		configure_stream_local("PING", 1.0f);
-		configure_stream_local("POSITION_TARGET_GLOBAL_INT", 10.0f);
-		configure_stream_local("POSITION_TARGET_LOCAL_NED", 10.0f);
-		configure_stream_local("RC_CHANNELS", 20.0f);
-		configure_stream_local("SERVO_OUTPUT_RAW_0", 10.0f);
-		configure_stream_local("SYS_STATUS", 5.0f);
-		configure_stream_local("SYSTEM_TIME", 1.0f);
-		configure_stream_local("TIMESYNC", 10.0f);
-		configure_stream_local("TRAJECTORY_REPRESENTATION_WAYPOINTS", 5.0f);
-		configure_stream_local("UTM_GLOBAL_POSITION", 1.0f);
-		configure_stream_local("VFR_HUD", 10.0f);
-		configure_stream_local("WIND_COV", 10.0f);
-		break;
+	int fd = ::open(path, O_RDONLY);
 
-	case MAVLINK_MODE_EXTVISION:
-		configure_stream_local("HIGHRES_IMU", unlimited_rate);		// for VIO
-		configure_stream_local("TIMESYNC", 10.0f);
-
-	// FALLTHROUGH
-	case MAVLINK_MODE_EXTVISIONMIN:
-		configure_stream_local("ADSB_VEHICLE", unlimited_rate);
-		configure_stream_local("ALTITUDE", 10.0f);
-		configure_stream_local("ATTITUDE", 20.0f);
-		configure_stream_local("ATTITUDE_TARGET", 2.0f);
-		configure_stream_local("BATTERY_STATUS", 0.5f);
-		configure_stream_local("CAMERA_IMAGE_CAPTURED", unlimited_rate);
-		configure_stream_local("CAMERA_TRIGGER", unlimited_rate);
-		configure_stream_local("COLLISION", unlimited_rate);
-		configure_stream_local("DEBUG", 1.0f);
-		configure_stream_local("DEBUG_FLOAT_ARRAY", 1.0f);
-		configure_stream_local("DEBUG_VECT", 1.0f);
-		configure_stream_local("DISTANCE_SENSOR", 10.0f);
-		configure_stream_local("ESTIMATOR_STATUS", 1.0f);
-		configure_stream_local("EXTENDED_SYS_STATE", 1.0f);
-		configure_stream_local("GLOBAL_POSITION_INT", 5.0f);
-		configure_stream_local("GPS2_RAW", 1.0f);
-		configure_stream_local("GPS_RAW_INT", 1.0f);
-		configure_stream_local("HOME_POSITION", 0.5f);
-		configure_stream_local("LOCAL_POSITION_NED", 30.0f);
-		configure_stream_local("NAMED_VALUE_FLOAT", 1.0f);
-		configure_stream_local("NAV_CONTROLLER_OUTPUT", 1.5f);
-		configure_stream_local("ODOMETRY", 30.0f);
-		configure_stream_local("OPTICAL_FLOW_RAD", 1.0f);
-		configure_stream_local("ORBIT_EXECUTION_STATUS", 5.0f);
-		configure_stream_local("PING", 0.1f);
-		configure_stream_local("POSITION_TARGET_GLOBAL_INT", 1.5f);
-		configure_stream_local("POSITION_TARGET_LOCAL_NED", 1.5f);
-		configure_stream_local("RC_CHANNELS", 5.0f);
-		configure_stream_local("SERVO_OUTPUT_RAW_0", 1.0f);
-		configure_stream_local("SYS_STATUS", 5.0f);
-		configure_stream_local("TRAJECTORY_REPRESENTATION_WAYPOINTS", 5.0f);
-		configure_stream_local("UTM_GLOBAL_POSITION", 1.0f);
-		configure_stream_local("VFR_HUD", 4.0f);
-		configure_stream_local("WIND_COV", 1.0f);
-		break;
+	if (fd < 0) {
+		/* no user profile, use the built-in one */
+		return;
+	}
 
+	mavlink_stream_profile_header_s header{};
+	bool valid = ::read(fd, &header, sizeof(header)) == sizeof(header)
+		     && memcmp(header.magic, MAVLINK_STREAM_PROFILE_MAGIC, sizeof(header.magic)) == 0
+		     && header.version == MAVLINK_STREAM_PROFILE_VERSION;
 
-	case MAVLINK_MODE_OSD:
-		configure_stream_local("ALTITUDE", 10.0f);
-		configure_stream_local("ATTITUDE", 25.0f);
-		configure_stream_local("ATTITUDE_TARGET", 10.0f);
-		configure_stream_local("BATTERY_STATUS", 0.5f);
-		configure_stream_local("ESTIMATOR_STATUS", 1.0f);
-		configure_stream_local("EXTENDED_SYS_STATE", 1.0f);
-		configure_stream_local("GLOBAL_POSITION_INT", 10.0f);
-		configure_stream_local("GPS_RAW_INT", 1.0f);
-		configure_stream_local("HOME_POSITION", 0.5f);
-		configure_stream_local("RC_CHANNELS", 5.0f);
-		configure_stream_local("SERVO_OUTPUT_RAW_0", 1.0f);
-		configure_stream_local("SYS_STATUS", 5.0f);
-		configure_stream_local("SYSTEM_TIME", 1.0f);
-		configure_stream_local("VFR_HUD", 25.0f);
-		configure_stream_local("WIND_COV", 2.0f);
-		break;
+	if (valid && header.entry_count > 0) {
+		const ssize_t len = header.entry_count * sizeof(mavlink_stream_profile_entry_s);
+		_user_stream_profile = new mavlink_stream_profile_entry_s[header.entry_count];
+		valid = (_user_stream_profile != nullptr) && ::read(fd, _user_stream_profile, len) == len;
+	}
 
-	case MAVLINK_MODE_MAGIC:
+	::close(fd);
 
-	/* fallthrough */
-	case MAVLINK_MODE_CUSTOM:
-		//stream nothing
-		break;
+	if (!valid) {
+		PX4_ERR("invalid stream profile %s", path);
+		delete[] _user_stream_profile;
+		_user_stream_profile = nullptr;
+		return;
+	}
 
-	case MAVLINK_MODE_CONFIG:
-		// Enable a number of interesting streams we want via USB
-		configure_stream_local("ACTUATOR_CONTROL_TARGET0", 30.0f);
-		configure_stream_local("ADSB_VEHICLE", unlimited_rate);
-		configure_stream_local("ALTITUDE", 10.0f);
-		configure_stream_local("ATTITUDE", 50.0f);
-		configure_stream_local("ATTITUDE_QUATERNION", 50.0f);
-		configure_stream_local("ATTITUDE_TARGET", 8.0f);
-		configure_stream_local("BATTERY_STATUS", 0.5f);
-		configure_stream_local("CAMERA_IMAGE_CAPTURED", unlimited_rate);
-		configure_stream_local("CAMERA_TRIGGER", unlimited_rate);
-		configure_stream_local("COLLISION", unlimited_rate);
-		configure_stream_local("DEBUG", 50.0f);
-		configure_stream_local("DEBUG_FLOAT_ARRAY", 50.0f);
-		configure_stream_local("DEBUG_VECT", 50.0f);
-		configure_stream_local("DISTANCE_SENSOR", 10.0f);
-		configure_stream_local("ESTIMATOR_STATUS", 5.0f);
-		configure_stream_local("EXTENDED_SYS_STATE", 2.0f);
-		configure_stream_local("GLOBAL_POSITION_INT", 10.0f);
-		configure_stream_local("GPS2_RAW", unlimited_rate);
-		configure_stream_local("GPS_RAW_INT", unlimited_rate);
-		configure_stream_local("HIGHRES_IMU", 50.0f);
-		configure_stream_local("HOME_POSITION", 0.5f);
-		configure_stream_local("LOCAL_POSITION_NED", 30.0f);
-		configure_stream_local("MANUAL_CONTROL", 5.0f);
-		configure_stream_local("NAMED_VALUE_FLOAT", 50.0f);
-		configure_stream_local("NAV_CONTROLLER_OUTPUT", 10.0f);
-		configure_stream_local("ODOMETRY", 30.0f);
-		configure_stream_local("OPTICAL_FLOW_RAD", 10.0f);
-		configure_stream_local("ORBIT_EXECUTION_STATUS", 5.0f);
-		configure_stream_local("PING", 1.0f);
-		configure_stream_local("POSITION_TARGET_GLOBAL_INT", 10.0f);
-		configure_stream_local("RC_CHANNELS", 10.0f);
-		configure_stream_local("SCALED_IMU", 25.0f);
-		configure_stream_local("SCALED_IMU2", 25.0f);
-		configure_stream_local("SCALED_IMU3", 25.0f);
-		configure_stream_local("SERVO_OUTPUT_RAW_0", 20.0f);
-		configure_stream_local("SERVO_OUTPUT_RAW_1", 20.0f);
-		configure_stream_local("SYS_STATUS", 1.0f);
-		configure_stream_local("SYSTEM_TIME", 1.0f);
-		configure_stream_local("TIMESYNC", 10.0f);
-		configure_stream_local("UTM_GLOBAL_POSITION", 1.0f);
-		configure_stream_local("VFR_HUD", 20.0f);
-		configure_stream_local("WIND_COV", 10.0f);
-		break;
+	_user_stream_profile_count = header.entry_count;
+	_user_stream_profile_valid = true;
+	PX4_INFO("using stream profile %s", path);
+}
 
-	case MAVLINK_MODE_IRIDIUM:
-		configure_stream_local("HIGH_LATENCY2", 0.015f);
-		break;
+int
+Mavlink::configure_streams_to_default(const char *configure_single_stream)
+{
+	static_assert(sizeof(stream_profiles) / sizeof(stream_profiles[0]) == MAVLINK_MODE_COUNT,
+		      "stream profile for each mode required");
 
-	case MAVLINK_MODE_MINIMAL:
-		configure_stream_local("ALTITUDE", 0.5f);
-		configure_stream_local("ATTITUDE", 10.0f);
-		configure_stream_local("EXTENDED_SYS_STATE", 0.1f);
-		configure_stream_local("GLOBAL_POSITION_INT", 5.0f);
-		configure_stream_local("GPS_RAW_INT", 0.5f);
-		configure_stream_local("HOME_POSITION", 0.1f);
-		configure_stream_local("NAMED_VALUE_FLOAT", 1.0f);
-		configure_stream_local("RC_CHANNELS", 0.5f);
-		configure_stream_local("SYS_STATUS", 0.1f);
-		configure_stream_local("VFR_HUD", 1.0f);
-		break;
+	if (_mode >= MAVLINK_MODE_COUNT) {
+		return -1;
+	}
 
-	default:
-		ret = -1;
-		break;
+	if (_user_stream_profile_mode != _mode) {
+		load_user_stream_profile();
 	}
 
-	if (configure_single_stream && !stream_configured && strcmp(configure_single_stream, "HEARTBEAT") != 0) {
+	const mavlink_stream_profile_entry_s *entries = stream_profiles[_mode].entries;
+	unsigned entry_count = stream_profiles[_mode].entry_count;
+
+	if (_user_stream_profile_valid) {
+		entries = _user_stream_profile;
+		entry_count = _user_stream_profile_count;
+	}
+
+	if (configure_single_stream) {
+		const StreamListItem *stream_item = get_stream_list_item(configure_single_stream);
+
+		if (stream_item == nullptr) {
+			return configure_stream(configure_single_stream, 0.0f);
+		}
+
+		for (unsigned i = 0; i < entry_count; i++) {
+			if (entries[i].stream_hash == stream_item->name_hash) {
+				return configure_stream(*stream_item, entries[i].rate);
+			}
+		}
+
+		if (strcmp(configure_single_stream, "HEARTBEAT") == 0) {
+			return 0;
+		}
+
 		// stream was not found, assume it is disabled by default
-		return configure_stream(configure_single_stream, 0.0f);
+		return configure_stream(*stream_item, 0.0f);
+	}
+
+	int ret = 0;
+
+	for (unsigned i = 0; i < entry_count; i++) {
+		const StreamListItem *stream_item = get_stream_list_item(entries[i].stream_hash);
+
+		if (stream_item == nullptr) {
+			PX4_WARN("stream 0x%08" PRIx32 " not found", entries[i].stream_hash);
+			ret = PX4_ERROR;
+			continue;
+		}
+
+		int ret_local = configure_stream(*stream_item, entries[i].rate);
+
+		if (ret_local != 0) {
+			ret = ret_local;
+		}
 	}
 
 	return ret;
@@ -1847,7 +1960,7 @@ Mavlink::task_main(int argc, char *argv[])
 	int temp_int_arg;
 #endif
 
-	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:fwxz", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:g:c:fwxz", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'b':
 			if (px4_get_parameter_value(myoptarg, _baudrate) != 0) {
@@ -1933,6 +2046,35 @@ Mavlink::task_main(int argc, char *argv[])
 
 			break;
 
+		case 'g': {
+				if (_remote_endpoint_count >= MAX_REMOTE_ENDPOINTS) {
+					PX4_ERR("too many remote endpoints (max %i)", MAX_REMOTE_ENDPOINTS);
+					err_flag = true;
+					break;
+				}
+
+				char addr[INET_ADDRSTRLEN] {};
+				const char *port = strchr(myoptarg, ':');
+				const size_t addr_len = port ? (size_t)(port - myoptarg) : strlen(myoptarg);
+				sockaddr_in &endpoint = _remote_endpoints[_remote_endpoint_count];
+
+				endpoint.sin_family = AF_INET;
+				endpoint.sin_port = port ? htons((unsigned short)strtoul(port + 1, nullptr, 10)) : 0;
+
+				if (addr_len < sizeof(addr)) {
+					memcpy(addr, myoptarg, addr_len);
+				}
+
+				if (addr_len < sizeof(addr) && inet_aton(addr, &endpoint.sin_addr)) {
+					_remote_endpoint_count++;
+
+				} else {
+					PX4_ERR("invalid remote endpoint '%s'", myoptarg);
+					err_flag = true;
+				}
+			}
+			break;
+
 #if defined(CONFIG_NET_IGMP) && defined(CONFIG_NET_ROUTE)
 
 		// multicast
@@ -1960,6 +2102,7 @@ Mavlink::task_main(int argc, char *argv[])
 		case 'u':
 		case 'o':
 		case 't':
+		case 'g':
 			PX4_ERR("UDP options not supported on this platform");
 			err_flag = true;
 			break;
@@ -2108,19 +2251,12 @@ Mavlink::task_main(int argc, char *argv[])
 	/* initialize send mutex */
 	pthread_mutex_init(&_send_mutex, nullptr);
 
-	/* if we are passing on mavlink messages, we need to prepare a buffer for this instance */
+	/* if we are passing on mavlink messages, we need a queue for this instance (and the shared frames) */
 	if (_forwarding_on) {
-		/* initialize message buffer if multiplexing is on.
-		 * make space for two messages plus off-by-one space as we use the empty element
-		 * marker ring buffer approach.
-		 */
-		if (OK != message_buffer_init(2 * sizeof(mavlink_message_t) + 1)) {
+		if (OK != forward_init()) {
 			PX4_ERR("msg buf alloc fail");
 			return 1;
 		}
-
-		/* initialize message buffer mutex */
-		pthread_mutex_init(&_message_buffer_mutex, nullptr);
 	}
 
 	uORB::Subscription parameter_update_sub{ORB_ID(parameter_update)};
@@ -2346,15 +2482,7 @@ Mavlink::task_main(int argc, char *argv[])
 
 		/* check for shell output */
 		if (_mavlink_shell && _mavlink_shell->available() > 0) {
-			if (get_free_tx_buf() >= MAVLINK_MSG_ID_SERIAL_CONTROL_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES) {
-				mavlink_serial_control_t msg;
-				msg.baudrate = 0;
-				msg.flags = SERIAL_CONTROL_FLAG_REPLY;
-				msg.timeout = 0;
-				msg.device = SERIAL_CONTROL_DEV_SHELL;
-				msg.count = _mavlink_shell->read(msg.data, sizeof(msg.data));
-				mavlink_msg_serial_control_send_struct(get_channel(), &msg);
-			}
+			send_shell_output();
 		}
 
 		/* check for ulog streaming messages */
@@ -2386,7 +2514,9 @@ Mavlink::task_main(int argc, char *argv[])
 
 		/* update streams */
 		for (const auto &stream : _streams) {
-			stream->update(t);
+			if (stream->update_required(t)) {
+				stream->update(t);
+			}
 
 			if (!_first_heartbeat_sent) {
 				if (_mode == MAVLINK_MODE_IRIDIUM) {
@@ -2404,52 +2534,12 @@ Mavlink::task_main(int argc, char *argv[])
 
 		/* pass messages from other UARTs */
 		if (_forwarding_on) {
-
-			bool is_part;
-			uint8_t *read_ptr;
-			uint8_t *write_ptr;
-
-			pthread_mutex_lock(&_message_buffer_mutex);
-			int available = message_buffer_get_ptr((void **)&read_ptr, &is_part);
-			pthread_mutex_unlock(&_message_buffer_mutex);
-
-			if (available > 0) {
-				// Reconstruct message from buffer
-
-				mavlink_message_t msg;
-				write_ptr = (uint8_t *)&msg;
-
-				// Pull a single message from the buffer
-				size_t read_count = available;
-
-				if (read_count > sizeof(mavlink_message_t)) {
-					read_count = sizeof(mavlink_message_t);
-				}
-
-				memcpy(write_ptr, read_ptr, read_count);
-
-				// We hold the mutex until after we complete the second part of the buffer. If we don't
-				// we may end up breaking the empty slot overflow detection semantics when we mark the
-				// possibly partial read below.
-				pthread_mutex_lock(&_message_buffer_mutex);
-
-				message_buffer_mark_read(read_count);
-
-				/* write second part of buffer if there is some */
-				if (is_part && read_count < sizeof(mavlink_message_t)) {
-					write_ptr += read_count;
-					available = message_buffer_get_ptr((void **)&read_ptr, &is_part);
-					read_count = sizeof(mavlink_message_t) - read_count;
-					memcpy(write_ptr, read_ptr, read_count);
-					message_buffer_mark_read(available);
-				}
-
-				pthread_mutex_unlock(&_message_buffer_mutex);
-
-				resend_message(&msg);
-			}
+			send_forwarded_messages();
 		}
 
+		/* write out everything sent during this iteration */
+		flush_tx_buffer();
+
 		/* update TX/RX rates*/
 		if (t > _bytes_timestamp + 1000000) {
 			if (_bytes_timestamp != 0) {
@@ -2472,6 +2562,11 @@ Mavlink::task_main(int argc, char *argv[])
 			publish_telemetry_status();
 		}
 
+		if (t - _stream_status_last_publish >= 100_ms) {
+			publish_stream_status();
+			_stream_status_last_publish = t;
+		}
+
 		perf_end(_loop_perf);
 	}
 
@@ -2498,8 +2593,7 @@ Mavlink::task_main(int argc, char *argv[])
 	}
 
 	if (_forwarding_on) {
-		message_buffer_destroy();
-		pthread_mutex_destroy(&_message_buffer_mutex);
+		forward_deinit();
 	}
 
 	if (_mavlink_ulog) {
@@ -2512,6 +2606,33 @@ Mavlink::task_main(int argc, char *argv[])
 	return OK;
 }
 
+void Mavlink::send_shell_output()
+{
+	/* bounds the time spent in one iteration on links without a budget (flow control) */
+	static constexpr int max_messages_per_iteration = 16;
+
+	static constexpr unsigned message_len = MAVLINK_MSG_ID_SERIAL_CONTROL_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+
+	for (int i = 0; i < max_messages_per_iteration; i++) {
+		if (get_free_tx_buf() < message_len || _mavlink_shell->available() == 0) {
+			break;
+		}
+
+		/* the first message is always sent, the rest only if the link has bandwidth left */
+		if (i > 0 && !tx_budget_available(message_len)) {
+			break;
+		}
+
+		mavlink_serial_control_t msg;
+		msg.baudrate = 0;
+		msg.flags = SERIAL_CONTROL_FLAG_REPLY;
+		msg.timeout = 0;
+		msg.device = SERIAL_CONTROL_DEV_SHELL;
+		msg.count = _mavlink_shell->read(msg.data, sizeof(msg.data));
+		mavlink_msg_serial_control_send_struct(get_channel(), &msg);
+	}
+}
+
 void Mavlink::check_requested_subscriptions()
 {
 	if (_subscribe_to_stream != nullptr) {
@@ -2603,6 +2724,44 @@ void Mavlink::publish_telemetry_status()
 	_telem_status_pub.publish(_tstatus);
 }
 
+void Mavlink::publish_stream_status()
+{
+	if (_streams.empty()) {
+		return;
+	}
+
+	if (_stream_status_index >= _streams.size()) {
+		_stream_status_index = 0;
+	}
+
+	unsigned i = 0;
+
+	for (const auto &stream : _streams) {
+		if (i++ == _stream_status_index) {
+			mavlink_stream_status_s status{};
+			strncpy(status.stream_name, stream->get_name(), sizeof(status.stream_name) - 1);
+			status.instance = _instance_id;
+			status.msg_id = stream->get_id();
+
+			const int interval = stream->get_interval();
+			status.rate_configured = (interval > 0) ? 1e6f / interval : -1.0f;
+
+			status.timestamp = hrt_absolute_time();
+			status.rate_achieved = stream->get_rate_achieved(status.timestamp);
+			status.load = stream->get_load();
+			status.tx_rate = stream->get_tx_rate();
+			status.update_count = stream->get_update_count();
+			status.cpu_time_total = stream->get_cpu_time_total();
+			status.tx_bytes_total = stream->get_tx_bytes_total();
+
+			_stream_status_pub.publish(status);
+			break;
+		}
+	}
+
+	_stream_status_index++;
+}
+
 void Mavlink::check_radio_config()
 {
 	/* radio config check */
@@ -2808,6 +2967,12 @@ Mavlink::display_status()
 		}
 
 #endif
+
+		for (int i = 0; i < _remote_endpoint_count; i++) {
+			printf("\tremote endpoint: %s:%i\n", inet_ntoa(_remote_endpoints[i].sin_addr),
+			       ntohs(_remote_endpoints[i].sin_port));
+		}
+
 		break;
 #endif // MAVLINK_UDP
 
@@ -2829,13 +2994,17 @@ Mavlink::display_status()
 void
 Mavlink::display_status_streams()
 {
-	printf("\t%-20s%-16s %s\n", "Name", "Rate Config (current) [Hz]", "Message Size (if active) [B]");
+	static constexpr const char *priority_str[(int)MavlinkStream::Priority::COUNT] {"critical", "normal", "low"};
+
+	printf("\t%-20s%-16s %-16s %-9s %-9s %-9s %s\n", "Name", "Rate Config (current) [Hz]", "Achieved [Hz]", "Priority",
+	       "Load [%]", "TX [B/s]", "Message Size (if active) [B]");
 
-	const float rate_mult = _rate_mult;
+	const hrt_abstime now = hrt_absolute_time();
 
 	for (const auto &stream : _streams) {
 		const int interval = stream->get_interval();
 		const unsigned size = stream->get_size();
+		const MavlinkStream::Priority priority = stream->priority();
 		char rate_str[20];
 
 		if (interval < 0) {
@@ -2845,11 +3014,12 @@ Mavlink::display_status_streams()
 			float rate = 1000000.0f / (float)interval;
 			// Note that the actual current rate can be lower if the associated uORB topic updates at a
 			// lower rate.
-			float rate_current = stream->const_rate() ? rate : rate * rate_mult;
+			float rate_current = rate * get_rate_mult(priority);
 			snprintf(rate_str, sizeof(rate_str), "%6.2f (%.3f)", (double)rate, (double)rate_current);
 		}
 
-		printf("\t%-30s%-16s", stream->get_name(), rate_str);
+		printf("\t%-30s%-16s %13.2f    %-9s %8.3f %9u", stream->get_name(), rate_str, (double)stream->get_rate_achieved(now),
+		       priority_str[(int)priority], (double)(stream->get_load() * 100.0f), (unsigned)stream->get_tx_rate());
 
 		if (size > 0) {
 			printf(" %3i\n", size);
@@ -3046,6 +3216,9 @@ $ mavlink stream -u 14556 -s HIGHRES_IMU -r 50
 	PRINT_MODULE_USAGE_PARAM_INT('o', 14550, 0, 65536, "Select UDP Network Port (remote)", true);
 	PRINT_MODULE_USAGE_PARAM_STRING('t', "127.0.0.1", nullptr,
 					"Partner IP (broadcasting can be enabled via MAV_BROADCAST param)", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('g', nullptr, "<ip>[:<port>]",
+					"Additional remote endpoint (unicast or multicast), the same stream is sent to all of them. "
+					"Can be given up to 4 times, the port defaults to the remote port", true);
 #endif
 	PRINT_MODULE_USAGE_PARAM_STRING('m', "normal", "custom|camera|onboard|osd|magic|config|iridium|minimal|extvsision",
 					"Mode: sets default streams and rates", true);
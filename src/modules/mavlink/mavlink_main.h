@@ -62,6 +62,7 @@
 #include <drivers/device/ringbuffer.h>
 #include <parameters/param.h>
 #include <perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/cli.h>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/defines.h>
@@ -73,6 +74,7 @@
 #include <systemlib/uthash/utlist.h>
 #include <uORB/PublicationQueued.hpp>
 #include <uORB/topics/mavlink_log.h>
+#include <uORB/topics/mavlink_stream_status.h>
 #include <uORB/topics/mission_result.h>
 #include <uORB/topics/radio_status.h>
 #include <uORB/topics/telemetry_status.h>
@@ -102,6 +104,8 @@ enum class Protocol {
 
 using namespace time_literals;
 
+struct mavlink_stream_profile_entry_s;
+
 class Mavlink : public ModuleParams
 {
 
@@ -318,27 +322,33 @@ public:
 
 	/**
 	 * This is the beginning of a MAVLINK_START_UART_SEND/MAVLINK_END_UART_SEND transaction
+	 *
+	 * @param frame_len length of the MAVLink frame that follows
 	 */
-	void 			begin_send() { pthread_mutex_lock(&_send_mutex); }
+	void 			begin_send(unsigned frame_len);
 
 	/**
-	 * Send bytes out on the link.
-	 *
-	 * On a network port these might actually get buffered to form a packet.
+	 * Append bytes of the current frame to the transmit buffer.
 	 */
 	void			send_bytes(const uint8_t *buf, unsigned packet_len);
 
 	/**
-	 * Flush the transmit buffer and send one MAVLink packet
+	 * End of a MAVLINK_START_UART_SEND/MAVLINK_END_UART_SEND transaction.
+	 * The frame stays in the transmit buffer until the next flush_tx_buffer().
+	 */
+	void			end_send() { pthread_mutex_unlock(&_send_mutex); }
+
+	/**
+	 * Write all buffered frames to the link with a single write (serial) or datagram (UDP).
 	 *
 	 * @return the number of bytes sent or -1 in case of error
 	 */
-	int             	send_packet();
+	int			flush_tx_buffer();
 
 	/**
 	 * Resend message as is, don't change sequence number and CRC.
 	 */
-	void			resend_message(mavlink_message_t *msg) { _mavlink_resend_uart(_channel, msg); }
+	void			resend_message(const mavlink_message_t *msg) { _mavlink_resend_uart(_channel, msg); }
 
 	void			handle_message(const mavlink_message_t *msg);
 
@@ -347,7 +357,7 @@ public:
 	 * for a given topic id and instance.
 	 * @param topic orb topic id
 	 * @param instance topic instance
-	 * @param disable_sharing if true, force creating a new instance
+	 * @param disable_sharing if true, force creating a new instance with a private uORB subscription
 	 */
 	MavlinkOrbSubscription *add_orb_subscription(const orb_id_t topic, int instance = 0, bool disable_sharing = false);
 
@@ -412,6 +422,21 @@ public:
 
 	float			get_rate_mult() const { return _rate_mult; }
 
+	/**
+	 * Get the rate multiplier of a stream scheduling class
+	 */
+	float			get_rate_mult(MavlinkStream::Priority priority) const { return _rate_mult_class[(int)priority]; }
+
+	/**
+	 * @return running count of the bytes queued for transmission (wraps around), used for per stream accounting
+	 */
+	uint32_t		get_tx_bytes_queued() const { return _tx_bytes_queued; }
+
+	/**
+	 * Check if the link budget (token bucket) allows to send bytes now
+	 */
+	bool			tx_budget_available(unsigned bytes) const { return !_tx_budget_enabled || _tx_tokens >= bytes; }
+
 	float			get_baudrate() { return _baudrate; }
 
 	/* Functions for waiting to start transmission until message received. */
@@ -421,11 +446,6 @@ public:
 	bool			get_wait_to_transmit() { return _wait_to_transmit; }
 	bool			should_transmit() { return (_transmitting_enabled && _boot_complete && (!_wait_to_transmit || (_wait_to_transmit && _received_messages))); }
 
-	bool			message_buffer_write(const void *ptr, int size);
-
-	void			lockMessageBufferMutex(void) { pthread_mutex_lock(&_message_buffer_mutex); }
-	void			unlockMessageBufferMutex(void) { pthread_mutex_unlock(&_message_buffer_mutex); }
-
 	/**
 	 * Count transmitted bytes
 	 */
@@ -514,6 +534,7 @@ public:
 	bool hash_check_enabled() const { return _param_mav_hash_chk_en.get(); }
 	bool forward_heartbeats_enabled() const { return _param_mav_hb_forw_en.get(); }
 	bool odometry_loopback_enabled() const { return _param_mav_odom_lp.get(); }
+	int mission_upload_window() const { return _param_mav_mis_window.get(); }
 
 	struct ping_statistics_s {
 		uint64_t last_ping_time;
@@ -545,6 +566,10 @@ private:
 	orb_advert_t		_mavlink_log_pub{nullptr};
 
 	uORB::PublicationQueued<telemetry_status_s>	_telem_status_pub{ORB_ID(telemetry_status)};
+	uORB::PublicationQueued<mavlink_stream_status_s>	_stream_status_pub{ORB_ID(mavlink_stream_status)};
+
+	hrt_abstime		_stream_status_last_publish{0};
+	unsigned		_stream_status_index{0};	///< stream to publish next
 
 	bool			_task_running{true};
 	static bool		_boot_complete;
@@ -589,6 +614,12 @@ private:
 	int			_baudrate{57600};
 	int			_datarate{1000};		///< data rate for normal streams (attitude, position, etc.)
 	float			_rate_mult{1.0f};
+	float			_rate_mult_class[(int)MavlinkStream::Priority::COUNT] {1.0f, 1.0f, 1.0f};
+
+	/* token bucket limiting the link to the available bandwidth, refilled once per main loop iteration */
+	float			_tx_tokens{0.0f};		///< bytes that can be sent [B]
+	hrt_abstime		_tx_tokens_last_update{0};
+	bool			_tx_budget_enabled{false};	///< false with flow control, the hardware limits the rate
 
 	bool			_radio_status_available{false};
 	bool			_radio_status_critical{false};
@@ -604,6 +635,11 @@ private:
 	bool			_mavlink_link_termination_allowed{false};
 
 	char			*_subscribe_to_stream{nullptr};
+	mavlink_stream_profile_entry_s	*_user_stream_profile{nullptr};
+	unsigned		_user_stream_profile_count{0};
+	bool			_user_stream_profile_valid{false};
+	MAVLINK_MODE		_user_stream_profile_mode{MAVLINK_MODE_COUNT};	///< mode the user profile was loaded for
+
 	float			_subscribe_to_stream_rate{0.0f};  ///< rate of stream to subscribe to (0=disable, -1=unlimited, -2=default)
 	bool			_udp_initialised{false};
 
@@ -625,12 +661,16 @@ private:
 	sockaddr_in		_src_addr {};
 	sockaddr_in		_bcast_addr {};
 
+	/* additional destinations for the fan-out, -g option */
+	static constexpr int	MAX_REMOTE_ENDPOINTS{4};
+	static constexpr int	MAX_UDP_DESTINATIONS{MAX_REMOTE_ENDPOINTS + 2}; ///< partner + endpoints + broadcast
+	sockaddr_in		_remote_endpoints[MAX_REMOTE_ENDPOINTS] {};
+	int			_remote_endpoint_count{0};
+
 	bool			_src_addr_initialized{false};
 	bool			_broadcast_address_found{false};
 	bool			_broadcast_address_not_found_warned{false};
 	bool			_broadcast_failed_warned{false};
-	uint8_t			_network_buf[MAVLINK_MAX_PACKET_LEN] {};
-	unsigned		_network_buf_len{0};
 
 	unsigned short		_network_port{14556};
 	unsigned short		_remote_port{DEFAULT_REMOTE_PORT_UDP};
@@ -638,6 +678,25 @@ private:
 
 	const char 		*_interface_name{nullptr};
 
+	/* finalized frames are collected here and written once per main loop iteration (fits into one UDP datagram) */
+	static constexpr unsigned TX_BUFFER_SIZE{4 * MAVLINK_MAX_PACKET_LEN};
+	uint8_t			_tx_buf[TX_BUFFER_SIZE] {};
+	unsigned		_tx_buf_len{0};
+	unsigned		_tx_buf_frame_start{0};	///< start of the frame currently being appended
+	uint32_t		_tx_bytes_queued{0};
+	bool			_tx_frame_dropped{false};	///< the current frame does not fit into the OS buffer
+	int			_tx_os_buf_free{0};	///< free space in the OS buffer at the last flush
+
+	void			update_os_tx_buf_free();
+	int			flush_tx_buffer_locked();
+
+#if defined(MAVLINK_UDP)
+	/**
+	 * Send the TX buffer to each destination, results[i] is the sendto() result for destinations[i].
+	 */
+	void			send_udp_fanout(const sockaddr_in *const destinations[], int results[], int num_destinations);
+#endif // MAVLINK_UDP
+
 	int			_socket_fd{-1};
 	Protocol		_protocol{Protocol::SERIAL};
 
@@ -646,16 +705,37 @@ private:
 
 	ping_statistics_s	_ping_stats {};
 
-	struct mavlink_message_buffer {
-		int write_ptr;
-		int read_ptr;
-		int size;
-		char *data;
+	/**
+	 * A forwarded message, copied once and shared by all the instances it is forwarded to
+	 */
+	struct ForwardedFrame {
+		mavlink_message_t msg;
+		px4::atomic<int> refcount{0};
 	};
 
-	mavlink_message_buffer	_message_buffer {};
+	/**
+	 * Component seen on a link, targeted messages are only forwarded to the link of their target
+	 */
+	struct Route {
+		const Mavlink *inst;
+		uint8_t system_id;
+		uint8_t component_id;
+	};
 
-	pthread_mutex_t		_message_buffer_mutex {};
+	static constexpr int FORWARD_POOL_SIZE = 12;
+	static constexpr int FORWARD_QUEUE_SIZE = 8;
+	static constexpr int MAX_ROUTES = 16;
+
+	static ForwardedFrame	*_forward_pool;		///< shared by all instances, allocated while forwarding is on for any
+	static int		_forwarding_instances;
+	static Route		_routes[MAX_ROUTES];
+	static pthread_mutex_t	_forward_mutex;		///< protects the pool allocation and the routes
+
+	ForwardedFrame		*_forward_queue[FORWARD_QUEUE_SIZE] {};	///< frames waiting to be sent on this instance
+	int			_forward_queue_head{0};
+	int			_forward_queue_tail{0};
+	pthread_mutex_t		_forward_queue_mutex {};
+	bool			_forward_ready{false};	///< forwarding initialized, protected by _forward_mutex
 	pthread_mutex_t		_send_mutex {};
 
 	DEFINE_PARAMETERS(
@@ -672,6 +752,7 @@ private:
 		(ParamBool<px4::params::MAV_HASH_CHK_EN>) _param_mav_hash_chk_en,
 		(ParamBool<px4::params::MAV_HB_FORW_EN>) _param_mav_hb_forw_en,
 		(ParamBool<px4::params::MAV_ODOM_LP>) _param_mav_odom_lp,
+		(ParamInt<px4::params::MAV_MIS_WINDOW>) _param_mav_mis_window,
 		(ParamInt<px4::params::SYS_HITL>) _param_sys_hitl
 	)
 
@@ -698,6 +779,19 @@ private:
 	 */
 	int configure_stream(const char *stream_name, const float rate = -1.0f);
 
+	/**
+	 * Configure a single stream of the supported streams list.
+	 * @param rate streaming rate in Hz, -1 = unlimited rate, 0 = disabled
+	 * @return 0 on success, <0 on error
+	 */
+	int configure_stream(const StreamListItem &stream_item, const float rate);
+
+	/**
+	 * Load the user stream profile of the current mode from ROMFS (/etc/mavlink/<mode>.profile),
+	 * it replaces the built-in profile if present.
+	 */
+	void load_user_stream_profile();
+
 	/**
 	 * Configure default streams according to _mode for either all streams or only a single
 	 * stream.
@@ -706,24 +800,47 @@ private:
 	 */
 	int configure_streams_to_default(const char *configure_single_stream = nullptr);
 
-	int message_buffer_init(int size);
-
-	void message_buffer_destroy();
+	int forward_init();
 
-	int message_buffer_count();
+	void forward_deinit();
 
-	int message_buffer_is_empty() const { return (_message_buffer.read_ptr == _message_buffer.write_ptr); }
+	/**
+	 * Learn the link of the sender of a message, call with _forward_mutex held
+	 */
+	static void update_route(const mavlink_message_t *msg, const Mavlink *inst);
 
-	int message_buffer_get_ptr(void **ptr, bool *is_part);
+	/**
+	 * Check if a target has been seen on a link, call with _forward_mutex held
+	 * @param target_component_id 0 for any component of the target system
+	 * @param inst link to check, nullptr for any link
+	 */
+	static bool has_route(int target_system_id, int target_component_id, const Mavlink *inst);
 
-	void message_buffer_mark_read(int n) { _message_buffer.read_ptr = (_message_buffer.read_ptr + n) % _message_buffer.size; }
+	/**
+	 * Queue a forwarded frame for sending on this instance, takes a reference on success
+	 */
+	bool pass_message(ForwardedFrame *frame);
 
-	void pass_message(const mavlink_message_t *msg);
+	/**
+	 * Send all queued forwarded frames and release them
+	 */
+	void send_forwarded_messages();
 
 	void publish_telemetry_status();
 
+	/**
+	 * Publish the statistics of the next stream (round-robin), mavlink_stream_status.
+	 */
+	void publish_stream_status();
+
 	void check_requested_subscriptions();
 
+	/**
+	 * Send the available shell output, in as many SERIAL_CONTROL messages as the link budget
+	 * and the TX buffer allow (at least one per iteration, as long as the TX buffer has space).
+	 */
+	void send_shell_output();
+
 	/**
 	 * Check the configuration of a connected radio
 	 *
@@ -733,7 +850,8 @@ private:
 	void check_radio_config();
 
 	/**
-	 * Update rate mult so total bitrate will be equal to _datarate.
+	 * Update the rate multipliers of the stream scheduling classes and refill the link
+	 * token bucket so the total bitrate will be equal to the available link bandwidth.
 	 */
 	void update_rate_mult();
 
@@ -491,7 +491,8 @@ protected:
 		struct vehicle_command_s cmd;
 		bool sent = false;
 
-		if (_cmd_sub->update_if_changed(&cmd)) {
+		// drain the queue, commands published in a burst would be lost otherwise
+		while (_cmd_sub->update_if_changed(&cmd)) {
 
 			if (!cmd.from_external) {
 				PX4_DEBUG("sending command %d to %d/%d", cmd.command, cmd.target_system, cmd.target_component);
@@ -3923,6 +3924,11 @@ public:
 		return new MavlinkStreamNamedValueFloat(mavlink);
 	}
 
+	Priority priority() override
+	{
+		return Priority::LOW;
+	}
+
 	unsigned get_size() override
 	{
 		return (_debug_time > 0) ? MAVLINK_MSG_ID_NAMED_VALUE_FLOAT_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES : 0;
@@ -3992,6 +3998,11 @@ public:
 		return new MavlinkStreamDebug(mavlink);
 	}
 
+	Priority priority() override
+	{
+		return Priority::LOW;
+	}
+
 	unsigned get_size() override
 	{
 		return (_debug_time > 0) ? MAVLINK_MSG_ID_DEBUG_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES : 0;
@@ -4059,6 +4070,11 @@ public:
 		return new MavlinkStreamDebugVect(mavlink);
 	}
 
+	Priority priority() override
+	{
+		return Priority::LOW;
+	}
+
 	unsigned get_size() override
 	{
 		return (_debug_time > 0) ? MAVLINK_MSG_ID_DEBUG_VECT_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES : 0;
@@ -4130,6 +4146,11 @@ public:
 		return new MavlinkStreamDebugFloatArray(mavlink);
 	}
 
+	Priority priority() override
+	{
+		return Priority::LOW;
+	}
+
 	unsigned get_size() override
 	{
 		return (_debug_time > 0) ? MAVLINK_MSG_ID_DEBUG_FLOAT_ARRAY_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES : 0;
@@ -5198,16 +5219,38 @@ const char *get_stream_name(const uint16_t msg_id)
 	return nullptr;
 }
 
-MavlinkStream *create_mavlink_stream(const char *stream_name, Mavlink *mavlink)
+const StreamListItem *get_stream_list_item(const char *stream_name)
 {
 	// search for stream with specified name in supported streams list
 	if (stream_name != nullptr) {
 		for (const auto &stream : streams_list) {
 			if (strcmp(stream_name, stream.get_name()) == 0) {
-				return stream.new_instance(mavlink);
+				return &stream;
 			}
 		}
 	}
 
 	return nullptr;
 }
+
+const StreamListItem *get_stream_list_item(const uint32_t name_hash)
+{
+	for (const auto &stream : streams_list) {
+		if (name_hash == stream.name_hash) {
+			return &stream;
+		}
+	}
+
+	return nullptr;
+}
+
+MavlinkStream *create_mavlink_stream(const char *stream_name, Mavlink *mavlink)
+{
+	const StreamListItem *stream = get_stream_list_item(stream_name);
+
+	if (stream != nullptr) {
+		return stream->new_instance(mavlink);
+	}
+
+	return nullptr;
+}
@@ -43,6 +43,14 @@
 
 #include "mavlink_stream.h"
 
+/**
+ * 32 bit FNV-1a hash of a stream name, identifies a stream in the stream profiles.
+ */
+constexpr uint32_t mavlink_stream_hash(const char *name, uint32_t hash = 2166136261u)
+{
+	return (*name == '\0') ? hash : mavlink_stream_hash(name + 1, (hash ^ (uint8_t)*name) * 16777619u);
+}
+
 class StreamListItem
 {
 
@@ -50,15 +58,19 @@ public:
 	MavlinkStream *(*new_instance)(Mavlink *mavlink);
 	const char *(*get_name)();
 	uint16_t (*get_id)();
+	uint32_t name_hash;
 
 	StreamListItem(MavlinkStream * (*inst)(Mavlink *mavlink), const char *(*name)(), uint16_t (*id)()) :
 		new_instance(inst),
 		get_name(name),
-		get_id(id) {}
+		get_id(id),
+		name_hash(mavlink_stream_hash(name())) {}
 
 };
 
 const char *get_stream_name(const uint16_t msg_id);
+const StreamListItem *get_stream_list_item(const char *stream_name);
+const StreamListItem *get_stream_list_item(const uint32_t name_hash);
 MavlinkStream *create_mavlink_stream(const char *stream_name, Mavlink *mavlink);
 
 void get_mavlink_navigation_mode(const struct vehicle_status_s *const status, uint8_t *mavlink_base_mode,
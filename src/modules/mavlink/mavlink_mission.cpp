@@ -194,6 +194,73 @@ MavlinkMissionManager::update_active_mission(dm_item_t dataman_id, uint16_t coun
 		return PX4_ERROR;
 	}
 }
+int
+MavlinkMissionManager::advance_transfer_batch()
+{
+	// move over the items received without gap, the batch ends at TRANSFER_BATCH_SIZE items
+	while (_transfer_seq < _transfer_count && (_transfer_seq - _transfer_batch_seq) < (int)TRANSFER_BATCH_SIZE
+	       && (_transfer_batch_received & (1u << (_transfer_seq - _transfer_batch_seq)))) {
+		_transfer_seq++;
+		_transfer_retries = 0;
+	}
+
+	const unsigned num_items = _transfer_seq - _transfer_batch_seq;
+
+	if (num_items == TRANSFER_BATCH_SIZE || (_transfer_seq == _transfer_count && num_items > 0)) {
+		const ssize_t ret = dm_write_many(_transfer_dataman_id, _transfer_batch_seq, num_items,
+						  DM_PERSIST_POWER_ON_RESET, _transfer_batch, sizeof(mission_item_s));
+
+		_transfer_batch_seq = _transfer_seq;
+		_transfer_batch_received = 0;
+
+		if (ret != (ssize_t)num_items) {
+			return PX4_ERROR;
+		}
+	}
+
+	return PX4_OK;
+}
+
+bool
+MavlinkMissionManager::transfer_item_expected(uint16_t seq) const
+{
+	if (seq == _transfer_seq) {
+		return true;
+	}
+
+	// items within the window of a mission upload are accepted in any order
+	return _mission_type == MAV_MISSION_TYPE_MISSION
+	       && seq > _transfer_seq && seq < _transfer_seq + _transfer_window && seq < _transfer_count
+	       && (unsigned)(seq - _transfer_batch_seq) < TRANSFER_BATCH_SIZE
+	       && !(_transfer_batch_received & (1u << (seq - _transfer_batch_seq)));
+}
+
+void
+MavlinkMissionManager::send_transfer_requests()
+{
+	unsigned window_end = math::min((unsigned)_transfer_seq + _transfer_window, (unsigned)_transfer_count);
+
+	if (_mission_type == MAV_MISSION_TYPE_MISSION) {
+		// do not request beyond the batch, it needs to be written first
+		window_end = math::min(window_end, (unsigned)_transfer_batch_seq + TRANSFER_BATCH_SIZE);
+	}
+
+	if (_transfer_request_seq < _transfer_seq) {
+		_transfer_request_seq = _transfer_seq;
+	}
+
+	while (_transfer_request_seq < window_end) {
+		const bool received = (_mission_type == MAV_MISSION_TYPE_MISSION)
+				      && (_transfer_batch_received & (1u << (_transfer_request_seq - _transfer_batch_seq)));
+
+		if (!received) {
+			send_mission_request(_transfer_partner_sysid, _transfer_partner_compid, _transfer_request_seq);
+		}
+
+		_transfer_request_seq++;
+	}
+}
+
 int
 MavlinkMissionManager::update_geofence_count(unsigned count)
 {
@@ -523,8 +590,16 @@ MavlinkMissionManager::send(const hrt_abstime now)
 	if (_state == MAVLINK_WPM_STATE_GETLIST && (_time_last_sent > 0)
 	    && hrt_elapsed_time(&_time_last_sent) > MAVLINK_MISSION_RETRY_TIMEOUT_DEFAULT) {
 
-		// try to request item again after timeout
-		send_mission_request(_transfer_partner_sysid, _transfer_partner_compid, _transfer_seq);
+		// the partner does not seem to answer multiple outstanding requests, fall back towards lock-step.
+		// A single retry is tolerated, as on high latency links it fires before the answers arrive.
+		if (++_transfer_retries > 1 && _transfer_window > 1) {
+			_transfer_window /= 2;
+			PX4_DEBUG("WPM: reducing upload window to %u", _transfer_window);
+		}
+
+		// try to request the missing items again after timeout
+		_transfer_request_seq = _transfer_seq;
+		send_transfer_requests();
 
 	} else if (_state != MAVLINK_WPM_STATE_IDLE && (_time_last_recv > 0)
 		   && hrt_elapsed_time(&_time_last_recv) > MAVLINK_MISSION_PROTOCOL_TIMEOUT_DEFAULT) {
@@ -769,28 +844,19 @@ MavlinkMissionManager::handle_mission_request_both(const mavlink_message_t *msg)
 
 				_time_last_recv = hrt_absolute_time();
 
-				/* _transfer_seq contains sequence of expected request */
-				if (wpr.seq == _transfer_seq && _transfer_seq < _transfer_count) {
+				/* _transfer_seq contains sequence of expected request. A ground station may have multiple requests
+				 * outstanding, so any later item is answered as well. */
+				if (wpr.seq >= _transfer_seq && wpr.seq < _transfer_count) {
 					PX4_DEBUG("WPM: MISSION_ITEM_REQUEST(_INT) seq %u from ID %u", wpr.seq, msg->sysid);
 
-					_transfer_seq++;
+					_transfer_seq = wpr.seq + 1;
 
-				} else if (wpr.seq == _transfer_seq - 1) {
+				} else if (wpr.seq < _transfer_seq) {
 					PX4_DEBUG("WPM: MISSION_ITEM_REQUEST(_INT) seq %u from ID %u (again)", wpr.seq, msg->sysid);
 
 				} else {
-					if (_transfer_seq > 0 && _transfer_seq < _transfer_count) {
-						PX4_DEBUG("WPM: MISSION_ITEM_REQUEST(_INT) ERROR: seq %u from ID %u unexpected, must be %i or %i", wpr.seq, msg->sysid,
-							  _transfer_seq - 1, _transfer_seq);
-
-					} else if (_transfer_seq <= 0) {
-						PX4_DEBUG("WPM: MISSION_ITEM_REQUEST(_INT) ERROR: seq %u from ID %u unexpected, must be %i", wpr.seq, msg->sysid,
-							  _transfer_seq);
-
-					} else {
-						PX4_DEBUG("WPM: MISSION_ITEM_REQUEST(_INT) ERROR: seq %u from ID %u unexpected, must be %i", wpr.seq, msg->sysid,
-							  _transfer_seq - 1);
-					}
+					PX4_DEBUG("WPM: MISSION_ITEM_REQUEST(_INT) ERROR: seq %u from ID %u unexpected, must be below %u", wpr.seq,
+						  msg->sysid, _transfer_count);
 
 					switch_to_idle_state();
 
@@ -905,6 +971,16 @@ MavlinkMissionManager::handle_mission_count(const mavlink_message_t *msg)
 			_transfer_dataman_id = (_dataman_id == DM_KEY_WAYPOINTS_OFFBOARD_0 ? DM_KEY_WAYPOINTS_OFFBOARD_1 :
 						DM_KEY_WAYPOINTS_OFFBOARD_0);	// use inactive storage for transmission
 			_transfer_current_seq = -1;
+			_transfer_batch_seq = 0;
+			_transfer_batch_received = 0;
+			_transfer_retries = 0;
+
+			if (_mission_type == MAV_MISSION_TYPE_MISSION) {
+				_transfer_window = math::constrain(_mavlink->mission_upload_window(), 1, (int)TRANSFER_BATCH_SIZE);
+
+			} else {
+				_transfer_window = 1;
+			}
 
 			if (_mission_type == MAV_MISSION_TYPE_FENCE) {
 				// We're about to write new geofence items, so take the lock. It will be released when
@@ -945,7 +1021,8 @@ MavlinkMissionManager::handle_mission_count(const mavlink_message_t *msg)
 			return;
 		}
 
-		send_mission_request(_transfer_partner_sysid, _transfer_partner_compid, _transfer_seq);
+		_transfer_request_seq = _transfer_seq;
+		send_transfer_requests();
 	}
 }
 
@@ -1008,11 +1085,16 @@ MavlinkMissionManager::handle_mission_item_both(const mavlink_message_t *msg)
 		if (_state == MAVLINK_WPM_STATE_GETLIST) {
 			_time_last_recv = hrt_absolute_time();
 
-			if (wp.seq != _transfer_seq) {
+			if (!transfer_item_expected(wp.seq)) {
 				PX4_DEBUG("WPM: MISSION_ITEM ERROR: seq %u was not the expected %u", wp.seq, _transfer_seq);
 
-				/* request next item again */
-				send_mission_request(_transfer_partner_sysid, _transfer_partner_compid, _transfer_seq);
+				if (_transfer_window == 1) {
+					/* request next item again */
+					send_mission_request(_transfer_partner_sysid, _transfer_partner_compid, _transfer_seq);
+				}
+
+				// with multiple outstanding requests this is a duplicate, the missing items are requested again
+				// on timeout
 				return;
 			}
 
@@ -1070,10 +1152,12 @@ MavlinkMissionManager::handle_mission_item_both(const mavlink_message_t *msg)
 					check_failed = true;
 
 				} else {
-					dm_item_t dm_item = _transfer_dataman_id;
+					// items are written in batches, so that a large mission does not need a dataman request
+					// (and a sync of the storage) per item
+					_transfer_batch[wp.seq - _transfer_batch_seq] = mission_item;
+					_transfer_batch_received |= (1u << (wp.seq - _transfer_batch_seq));
 
-					write_failed = dm_write(dm_item, wp.seq, DM_PERSIST_POWER_ON_RESET, &mission_item,
-								sizeof(struct mission_item_s)) != sizeof(struct mission_item_s);
+					write_failed = advance_transfer_batch() != PX4_OK;
 
 					if (!write_failed) {
 						/* waypoint marked as current */
@@ -1153,7 +1237,9 @@ MavlinkMissionManager::handle_mission_item_both(const mavlink_message_t *msg)
 
 		PX4_DEBUG("WPM: MISSION_ITEM seq %u received", wp.seq);
 
-		_transfer_seq = wp.seq + 1;
+		if (_mission_type != MAV_MISSION_TYPE_MISSION) {
+			_transfer_seq = wp.seq + 1;
+		}
 
 		if (_transfer_seq == _transfer_count) {
 			/* got all new mission items successfully */
@@ -1194,8 +1280,8 @@ MavlinkMissionManager::handle_mission_item_both(const mavlink_message_t *msg)
 			_transfer_in_progress = false;
 
 		} else {
-			/* request next item */
-			send_mission_request(_transfer_partner_sysid, _transfer_partner_compid, _transfer_seq);
+			/* request next items */
+			send_transfer_requests();
 		}
 	}
 }
@@ -121,6 +121,16 @@ private:
 
 	int32_t			_transfer_current_seq{-1};		///< Current item ID for current transmission (-1 means not initialized)
 
+	static constexpr unsigned	TRANSFER_BATCH_SIZE = 16;		///< Mission items written to dataman with a single request
+
+	mission_item_s		_transfer_batch[TRANSFER_BATCH_SIZE] {};	///< Received mission items not yet written to dataman
+	uint16_t		_transfer_batch_seq{0};			///< Sequence of the first item in _transfer_batch
+	uint16_t		_transfer_batch_received{0};		///< Bitmask of the items received in _transfer_batch
+
+	uint16_t		_transfer_request_seq{0};		///< Next item sequence to request in current transmission
+	uint8_t			_transfer_window{1};			///< Number of outstanding item requests in current transmission
+	uint8_t			_transfer_retries{0};			///< Request retries without progress in current transmission
+
 	uint8_t			_transfer_partner_sysid{0};		///< Partner system ID for current transmission
 	uint8_t			_transfer_partner_compid{0};		///< Partner component ID for current transmission
 
@@ -161,6 +171,23 @@ private:
 
 	int update_active_mission(dm_item_t dataman_id, uint16_t count, int32_t seq);
 
+	/**
+	 * advance the current transmission over the received mission items and write them to dataman when a batch
+	 * is complete
+	 * @return PX4_OK on success
+	 */
+	int advance_transfer_batch();
+
+	/**
+	 * check if an item can be accepted in the current transmission
+	 */
+	bool transfer_item_expected(uint16_t seq) const;
+
+	/**
+	 * request the items of the current transmission window which have not been requested yet
+	 */
+	void send_transfer_requests();
+
 	/** store the geofence count to dataman */
 	int update_geofence_count(unsigned count);
 
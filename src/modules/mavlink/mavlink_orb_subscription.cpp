@@ -39,10 +39,206 @@
 
 #include "mavlink_orb_subscription.h"
 
+#include <pthread.h>
+#include <string.h>
+
+/**
+ * Process-wide copy of a topic, shared by all MAVLink instances.
+ */
+class MavlinkOrbSubscription::SharedTopic : public uORB::Subscription, public ListNode<SharedTopic *>
+{
+public:
+	SharedTopic(const orb_id_t topic, int instance) : uORB::Subscription(topic, instance) {}
+	~SharedTopic() { delete[] data; }
+
+	/**
+	 * Copy the latest published message into the snapshot if there is a new one.
+	 */
+	void refresh()
+	{
+		if (updated()) {
+			if (data == nullptr) {
+				data = new uint8_t[_meta->o_size];
+			}
+
+			if (data != nullptr) {
+				uORB::Subscription::update(&timestamp, data);
+				generation++;
+			}
+		}
+	}
+
+	bool queued() const { return (_node != nullptr) && (_node->get_queue_size() > 1); }
+
+	uint8_t		*data{nullptr};
+	uint64_t	timestamp{0};
+	unsigned	generation{0};	///< incremented on every snapshot copy, 0 if no data yet
+	unsigned	refcount{0};
+};
+
+List<MavlinkOrbSubscription::SharedTopic *> MavlinkOrbSubscription::_shared_topics;
+pthread_mutex_t MavlinkOrbSubscription::_shared_topics_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+MavlinkOrbSubscription::MavlinkOrbSubscription(const orb_id_t topic, int instance, bool shared) :
+	_topic(topic),
+	_instance(instance)
+{
+	if (!shared) {
+		_sub = new uORB::Subscription(topic, instance);
+		return;
+	}
+
+	pthread_mutex_lock(&_shared_topics_mutex);
+
+	for (SharedTopic *shared_topic : _shared_topics) {
+		if (shared_topic->get_topic() == topic && shared_topic->get_instance() == instance) {
+			_shared = shared_topic;
+			break;
+		}
+	}
+
+	if (_shared == nullptr) {
+		_shared = new SharedTopic(topic, instance);
+		_shared_topics.add(_shared);
+	}
+
+	_shared->refcount++;
+
+	pthread_mutex_unlock(&_shared_topics_mutex);
+}
+
+MavlinkOrbSubscription::~MavlinkOrbSubscription()
+{
+	delete _sub;
+
+	if (_shared != nullptr) {
+		pthread_mutex_lock(&_shared_topics_mutex);
+
+		if (--_shared->refcount == 0) {
+			_shared_topics.deleteNode(_shared);
+		}
+
+		pthread_mutex_unlock(&_shared_topics_mutex);
+	}
+}
+
+bool
+MavlinkOrbSubscription::refresh_shared()
+{
+	if (_sub != nullptr) {
+		return false;
+	}
+
+	_shared->refresh();
+
+	if (_shared->queued()) {
+		// every instance has to see every queued message, don't share the snapshot
+		_sub = new uORB::Subscription(_topic, _instance);
+		return (_sub == nullptr);
+	}
+
+	return true;
+}
+
+bool
+MavlinkOrbSubscription::update(uint64_t *time, void *data)
+{
+	if (_shared == nullptr) {
+		return _sub->update(time, data);
+	}
+
+	bool updated = false;
+
+	pthread_mutex_lock(&_shared_topics_mutex);
+
+	if (!refresh_shared()) {
+		pthread_mutex_unlock(&_shared_topics_mutex);
+		return _sub->update(time, data);
+	}
+
+	if ((time != nullptr) && (data != nullptr) && (_shared->generation != 0)) {
+		// always copy data regardless of update
+		memcpy(data, _shared->data, _topic->o_size);
+		_shared_generation = _shared->generation;
+
+		if (*time == 0 || *time != _shared->timestamp) {
+			*time = _shared->timestamp;
+			updated = true;
+		}
+	}
+
+	pthread_mutex_unlock(&_shared_topics_mutex);
+
+	return updated;
+}
+
+bool
+MavlinkOrbSubscription::update(void *data)
+{
+	if (_shared == nullptr) {
+		return _sub->copy(data);
+	}
+
+	bool copied = false;
+
+	pthread_mutex_lock(&_shared_topics_mutex);
+
+	if (!refresh_shared()) {
+		pthread_mutex_unlock(&_shared_topics_mutex);
+		return _sub->copy(data);
+	}
+
+	if (_shared->generation != 0) {
+		memcpy(data, _shared->data, _topic->o_size);
+		_shared_generation = _shared->generation;
+		copied = true;
+	}
+
+	pthread_mutex_unlock(&_shared_topics_mutex);
+
+	return copied;
+}
+
+bool
+MavlinkOrbSubscription::update_if_changed(void *data)
+{
+	if (_shared == nullptr) {
+		return _sub->update(data);
+	}
+
+	bool copied = false;
+
+	pthread_mutex_lock(&_shared_topics_mutex);
+
+	if (!refresh_shared()) {
+		pthread_mutex_unlock(&_shared_topics_mutex);
+		return _sub->update(data);
+	}
+
+	if (_shared->generation != _shared_generation) {
+		memcpy(data, _shared->data, _topic->o_size);
+		_shared_generation = _shared->generation;
+		copied = true;
+	}
+
+	pthread_mutex_unlock(&_shared_topics_mutex);
+
+	return copied;
+}
+
 bool
 MavlinkOrbSubscription::is_published()
 {
-	const bool published = _sub.advertised();
+	bool published = false;
+
+	if (_sub != nullptr) {
+		published = _sub->advertised();
+
+	} else {
+		pthread_mutex_lock(&_shared_topics_mutex);
+		published = _shared->advertised();
+		pthread_mutex_unlock(&_shared_topics_mutex);
+	}
 
 	if (published) {
 		return true;
@@ -50,7 +246,14 @@ MavlinkOrbSubscription::is_published()
 	} else if (!published && _subscribe_from_beginning) {
 		// For some topics like vehicle_command_ack, we want to subscribe
 		// from the beginning in order not to miss or delay the first publish respective advertise.
-		return _sub.subscribe();
+		if (_sub != nullptr) {
+			return _sub->subscribe();
+		}
+
+		pthread_mutex_lock(&_shared_topics_mutex);
+		published = _shared->subscribe();
+		pthread_mutex_unlock(&_shared_topics_mutex);
+		return published;
 	}
 
 	return false;
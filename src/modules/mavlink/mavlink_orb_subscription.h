@@ -43,14 +43,30 @@
 
 #include <drivers/drv_hrt.h>
 #include <containers/List.hpp>
+#include <pthread.h>
 #include <uORB/Subscription.hpp>
 
+/**
+ * Subscription to a uORB topic used by the MAVLink streams.
+ *
+ * Unless sharing is disabled, all MAVLink instances read a topic through one
+ * process-wide snapshot: the topic is copied from uORB once per published
+ * generation and every subscriber serializes from that copy. Queued topics
+ * (queue size > 1) fall back to a private subscription so that no instance
+ * misses a queued message.
+ */
 class MavlinkOrbSubscription : public ListNode<MavlinkOrbSubscription *>
 {
 public:
 
-	MavlinkOrbSubscription(const orb_id_t topic, int instance) : _sub(topic, instance) {}
-	~MavlinkOrbSubscription() = default;
+	MavlinkOrbSubscription(const orb_id_t topic, int instance, bool shared = true);
+	~MavlinkOrbSubscription();
+
+	// no copy, assignment, move, move assignment
+	MavlinkOrbSubscription(const MavlinkOrbSubscription &) = delete;
+	MavlinkOrbSubscription &operator=(const MavlinkOrbSubscription &) = delete;
+	MavlinkOrbSubscription(MavlinkOrbSubscription &&) = delete;
+	MavlinkOrbSubscription &operator=(MavlinkOrbSubscription &&) = delete;
 
 	/**
 	 * Check if subscription updated based on timestamp.
@@ -61,14 +77,14 @@ public:
 	 * still copy the data.
 	 * If no data available data buffer will be filled with zeros.
 	 */
-	bool update(uint64_t *time, void *data) { return _sub.update(time, data); }
+	bool update(uint64_t *time, void *data);
 
 	/**
 	 * Copy topic data to given buffer.
 	 *
 	 * @return true only if topic data copied successfully.
 	 */
-	bool update(void *data) { return _sub.copy(data); }
+	bool update(void *data);
 
 	/**
 	 * Check if the subscription has been updated.
@@ -76,7 +92,7 @@ public:
 	 * @return true if there has been an update which has been
 	 * copied successfully.
 	 */
-	bool update_if_changed(void *data) { return _sub.update(data); }
+	bool update_if_changed(void *data);
 
 	/**
 	 * Check if the topic has been published.
@@ -89,12 +105,30 @@ public:
 
 	void subscribe_from_beginning(bool from_beginning) { _subscribe_from_beginning = from_beginning; }
 
-	orb_id_t get_topic() const { return _sub.get_topic(); }
-	int get_instance() const { return _sub.get_instance(); }
+	orb_id_t get_topic() const { return _topic; }
+	int get_instance() const { return _instance; }
 
 private:
 
-	uORB::Subscription	_sub;
+	class SharedTopic;
+
+	static List<SharedTopic *>	_shared_topics;
+	static pthread_mutex_t		_shared_topics_mutex;
+
+	/**
+	 * Refresh the shared snapshot, switching to a private subscription for queued topics.
+	 * Must be called with the shared topics lock held.
+	 * @return true if the shared snapshot is used, false if _sub is used
+	 */
+	bool refresh_shared();
+
+	const orb_id_t		_topic;
+	const int		_instance;
+
+	SharedTopic		*_shared{nullptr};	///< process-wide snapshot, nullptr if not shared
+	uORB::Subscription	*_sub{nullptr};		///< private subscription, if not shared or queued topic
+
+	unsigned		_shared_generation{0};	///< last snapshot generation copied by this subscriber
 
 	bool _subscribe_from_beginning{false}; ///< we need to subscribe from the beginning, e.g. for vehicle_command_acks
 };
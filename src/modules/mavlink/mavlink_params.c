@@ -175,3 +175,29 @@ PARAM_DEFINE_INT32(MAV_HB_FORW_EN, 1);
  * @group MAVLink
  */
 PARAM_DEFINE_INT32(MAV_ODOM_LP, 0);
+
+/**
+ * Mission upload window.
+ *
+ * Number of mission items requested from the ground station at the same time during a mission upload.
+ * Items may arrive in any order within the window, which speeds up uploads over links with a high latency.
+ * The window shrinks automatically if the ground station does not answer multiple outstanding requests,
+ * 1 transfers the items strictly one after the other.
+ *
+ * @min 1
+ * @max 16
+ * @group MAVLink
+ */
+PARAM_DEFINE_INT32(MAV_MIS_WINDOW, 8);
+
+/**
+ * Send HIGH_LATENCY2 on events.
+ *
+ * If set, the HIGH_LATENCY2 message of a high latency link is additionally sent right away
+ * (at most every 10 seconds) when the flight mode, the arming state, the current mission item
+ * or one of the failure flags changes, instead of only at the configured stream rate.
+ *
+ * @boolean
+ * @group MAVLink
+ */
+PARAM_DEFINE_INT32(MAV_HL_EVENTS, 0);
@@ -46,6 +46,7 @@
 #include <drivers/drv_rc_input.h>
 #include <drivers/drv_tone_alarm.h>
 #include <ecl/geo/geo.h>
+#include <px4_platform_common/serial_dma.h>
 #include <systemlib/px4_macros.h>
 
 #include <math.h>
@@ -86,6 +87,8 @@ MavlinkReceiver::~MavlinkReceiver()
 	delete _px4_baro;
 	delete _px4_gyro;
 	delete _px4_mag;
+
+	perf_free(_rtcm_fragments_lost_perf);
 }
 
 MavlinkReceiver::MavlinkReceiver(Mavlink *parent) :
@@ -1752,7 +1755,10 @@ MavlinkReceiver::handle_message_obstacle_distance(mavlink_message_t *msg)
 	mavlink_obstacle_distance_t mavlink_obstacle_distance;
 	mavlink_msg_obstacle_distance_decode(msg, &mavlink_obstacle_distance);
 
-	obstacle_distance_s obstacle_distance{};
+	// fill the message in place in the uORB queue if possible, this avoids a copy of the distances array
+	obstacle_distance_s *loaned = _obstacle_distance_pub.loan();
+	obstacle_distance_s local{};
+	obstacle_distance_s &obstacle_distance = (loaned != nullptr) ? *loaned : local;
 
 	obstacle_distance.timestamp = hrt_absolute_time();
 	obstacle_distance.sensor_type = mavlink_obstacle_distance.sensor_type;
@@ -1770,7 +1776,12 @@ MavlinkReceiver::handle_message_obstacle_distance(mavlink_message_t *msg)
 	obstacle_distance.angle_offset = mavlink_obstacle_distance.angle_offset;
 	obstacle_distance.frame = mavlink_obstacle_distance.frame;
 
-	_obstacle_distance_pub.publish(obstacle_distance);
+	if (loaned != nullptr) {
+		_obstacle_distance_pub.publish_loan();
+
+	} else {
+		_obstacle_distance_pub.publish(obstacle_distance);
+	}
 }
 
 void
@@ -2220,9 +2231,22 @@ MavlinkReceiver::handle_message_follow_target(mavlink_message_t *msg)
 	follow_target_s follow_target_topic{};
 
 	follow_target_topic.timestamp = hrt_absolute_time();
+
+	// the measurement time lets the follow target estimator compensate the link latency
+	if (follow_target_msg.timestamp > 0) {
+		follow_target_topic.timestamp_sample = _mavlink_timesync.sync_stamp(follow_target_msg.timestamp * 1000);
+
+	} else {
+		follow_target_topic.timestamp_sample = follow_target_topic.timestamp;
+	}
+
 	follow_target_topic.lat = follow_target_msg.lat * 1e-7;
 	follow_target_topic.lon = follow_target_msg.lon * 1e-7;
 	follow_target_topic.alt = follow_target_msg.alt;
+	follow_target_topic.vx = follow_target_msg.vel[0];
+	follow_target_topic.vy = follow_target_msg.vel[1];
+	follow_target_topic.vz = follow_target_msg.vel[2];
+	follow_target_topic.est_cap = follow_target_msg.est_capabilities;
 
 	_follow_target_pub.publish(follow_target_topic);
 }
@@ -2412,15 +2436,70 @@ MavlinkReceiver::handle_message_gps_rtcm_data(mavlink_message_t *msg)
 	mavlink_gps_rtcm_data_t gps_rtcm_data_msg;
 	mavlink_msg_gps_rtcm_data_decode(msg, &gps_rtcm_data_msg);
 
-	gps_inject_data_s gps_inject_data_topic{};
+	const uint8_t len = math::min((uint8_t)sizeof(gps_rtcm_data_msg.data), gps_rtcm_data_msg.len);
+	const bool fragmented = gps_rtcm_data_msg.flags & 0x1;
+	const uint8_t fragment_id = (gps_rtcm_data_msg.flags >> 1) & 0x3;
+	const uint8_t sequence_id = (gps_rtcm_data_msg.flags >> 3) & 0x1f;
+
+	if (_rtcm_next_fragment > 0 && (!fragmented || sequence_id != _rtcm_sequence_id || fragment_id != _rtcm_next_fragment)) {
+		// the pending message didn't end with a short fragment: it's either a multiple of the fragment size
+		// (only known for RTCM3, which has a length field), or fragments got lost
+		if (_rtcm_message.len < rtcm3_frame_length()) {
+			perf_count(_rtcm_fragments_lost_perf);
+			_rtcm_next_fragment = 0;
+
+		} else {
+			publish_rtcm_message();
+		}
+	}
+
+	if (!fragmented) {
+		_rtcm_message.len = len;
+		memcpy(_rtcm_message.data, gps_rtcm_data_msg.data, len);
+		publish_rtcm_message();
+		return;
+	}
+
+	if (fragment_id != _rtcm_next_fragment) {
+		// start of the message is missing
+		perf_count(_rtcm_fragments_lost_perf);
+		return;
+	}
+
+	if (fragment_id == 0) {
+		_rtcm_message.len = 0;
+		_rtcm_sequence_id = sequence_id;
+	}
+
+	memcpy(&_rtcm_message.data[_rtcm_message.len], gps_rtcm_data_msg.data, len);
+	_rtcm_message.len += len;
+	_rtcm_next_fragment = fragment_id + 1;
+
+	// the last fragment is either short or the 4th one, RTCM3 has a length field
+	if (len < sizeof(gps_rtcm_data_msg.data) || fragment_id == 3 || _rtcm_message.len == rtcm3_frame_length()) {
+		publish_rtcm_message();
+	}
+}
+
+unsigned
+MavlinkReceiver::rtcm3_frame_length() const
+{
+	// RTCM3 frame: preamble 0xD3, 10 bit length, payload and 24 bit CRC
+	if (_rtcm_message.len >= 3 && _rtcm_message.data[0] == 0xD3) {
+		return ((_rtcm_message.data[1] & 0x3) << 8 | _rtcm_message.data[2]) + 6;
+	}
 
-	gps_inject_data_topic.len = math::min((int)sizeof(gps_rtcm_data_msg.data),
-					      (int)sizeof(uint8_t) * gps_rtcm_data_msg.len);
-	gps_inject_data_topic.flags = gps_rtcm_data_msg.flags;
-	memcpy(gps_inject_data_topic.data, gps_rtcm_data_msg.data,
-	       math::min((int)sizeof(gps_inject_data_topic.data), (int)sizeof(uint8_t) * gps_inject_data_topic.len));
+	return 0;
+}
+
+void
+MavlinkReceiver::publish_rtcm_message()
+{
+	_rtcm_message.timestamp = hrt_absolute_time();
+	_rtcm_message.flags = 0;
+	_gps_inject_data_pub.publish(_rtcm_message);
 
-	_gps_inject_data_pub.publish(gps_inject_data_topic);
+	_rtcm_next_fragment = 0;
 }
 
 void
@@ -2725,18 +2804,21 @@ MavlinkReceiver::Run()
 	/* the serial port buffers internally as well, we just need to fit a small chunk */
 	uint8_t buf[64];
 #endif
-	mavlink_message_t msg;
-
 	struct pollfd fds[1] = {};
 
+	px4::SerialDMA serial_rx;
+
 	if (_mavlink->get_protocol() == Protocol::SERIAL) {
 		fds[0].fd = _mavlink->get_uart_fd();
 		fds[0].events = POLLIN;
+		serial_rx.setDevice(fds[0].fd, (unsigned)_mavlink->get_baudrate());
 	}
 
 #if defined(MAVLINK_UDP)
 	struct sockaddr_in srcaddr = {};
+#if !defined(__PX4_LINUX)
 	socklen_t addrlen = sizeof(srcaddr);
+#endif
 
 	if (_mavlink->get_protocol() == Protocol::UDP) {
 		fds[0].fd = _mavlink->get_socket_fd();
@@ -2762,7 +2844,8 @@ MavlinkReceiver::Run()
 
 		if (poll(&fds[0], 1, timeout) > 0) {
 			if (_mavlink->get_protocol() == Protocol::SERIAL) {
-				/* non-blocking read. read may return negative values */
+				/* wait for the end of the received burst, then non-blocking read. read may return negative values */
+				serial_rx.waitForFrameEnd(sizeof(buf));
 				nread = ::read(fds[0].fd, buf, sizeof(buf));
 			}
 
@@ -2770,7 +2853,38 @@ MavlinkReceiver::Run()
 
 			else if (_mavlink->get_protocol() == Protocol::UDP) {
 				if (fds[0].revents & POLLIN) {
+#if defined(__PX4_LINUX)
+					// fetch all queued datagrams with a single syscall and concatenate them
+					static constexpr int max_datagrams = 5;
+					static constexpr size_t datagram_len = sizeof(buf) / max_datagrams;
+					struct sockaddr_in srcaddrs[max_datagrams];
+					struct iovec iovecs[max_datagrams];
+					struct mmsghdr msgs[max_datagrams] {};
+
+					for (int k = 0; k < max_datagrams; k++) {
+						iovecs[k].iov_base = &buf[k * datagram_len];
+						iovecs[k].iov_len = datagram_len;
+						msgs[k].msg_hdr.msg_iov = &iovecs[k];
+						msgs[k].msg_hdr.msg_iovlen = 1;
+						msgs[k].msg_hdr.msg_name = &srcaddrs[k];
+						msgs[k].msg_hdr.msg_namelen = sizeof(srcaddrs[k]);
+					}
+
+					const int count = recvmmsg(_mavlink->get_socket_fd(), msgs, max_datagrams, MSG_DONTWAIT, nullptr);
+					nread = (count > 0) ? 0 : -1;
+
+					for (int k = 0; k < count; k++) {
+						memmove(&buf[nread], iovecs[k].iov_base, msgs[k].msg_len);
+						nread += msgs[k].msg_len;
+					}
+
+					if (count > 0) {
+						srcaddr = srcaddrs[count - 1];
+					}
+
+#else
 					nread = recvfrom(_mavlink->get_socket_fd(), buf, sizeof(buf), 0, (struct sockaddr *)&srcaddr, &addrlen);
+#endif
 				}
 
 				struct sockaddr_in &srcaddr_last = _mavlink->get_client_source_address();
@@ -2801,41 +2915,8 @@ MavlinkReceiver::Run()
 			if (_mavlink->get_protocol() != Protocol::UDP || _mavlink->get_client_source_initialized()) {
 #endif // MAVLINK_UDP
 
-				/* if read failed, this loop won't execute */
-				for (ssize_t i = 0; i < nread; i++) {
-					if (mavlink_parse_char(_mavlink->get_channel(), buf[i], &msg, &_status)) {
-
-						/* check if we received version 2 and request a switch. */
-						if (!(_mavlink->get_status()->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)) {
-							/* this will only switch to proto version 2 if allowed in settings */
-							_mavlink->set_proto_version(2);
-						}
-
-						/* handle generic messages and commands */
-						handle_message(&msg);
-
-						/* handle packet with mission manager */
-						_mission_manager.handle_message(&msg);
-
-
-						/* handle packet with parameter component */
-						_parameters_manager.handle_message(&msg);
-
-						if (_mavlink->ftp_enabled()) {
-							/* handle packet with ftp component */
-							_mavlink_ftp.handle_message(&msg);
-						}
-
-						/* handle packet with log component */
-						_mavlink_log_handler.handle_message(&msg);
-
-						/* handle packet with timesync component */
-						_mavlink_timesync.handle_message(&msg);
-
-						/* handle packet with parent object */
-						_mavlink->handle_message(&msg);
-					}
-				}
+				/* if read failed, nothing is parsed */
+				parse_buffer(buf, nread);
 
 				/* count received bytes (nread will be -1 on read error) */
 				if (nread > 0) {
@@ -2867,6 +2948,115 @@ MavlinkReceiver::Run()
 	}
 }
 
+void
+MavlinkReceiver::parse_buffer(const uint8_t *buf, ssize_t len)
+{
+	// resolve the channel buffers once instead of per byte in mavlink_parse_char()
+	mavlink_message_t *rxmsg = _mavlink->get_buffer();
+	mavlink_status_t *status = _mavlink->get_status();
+	mavlink_message_t msg;
+
+	for (ssize_t i = 0; i < len; i++) {
+
+		// skip straight to the next start of frame when not inside a frame
+		if ((status->parse_state == MAVLINK_PARSE_STATE_UNINIT || status->parse_state == MAVLINK_PARSE_STATE_IDLE)
+		    && buf[i] != MAVLINK_STX && buf[i] != MAVLINK_STX_MAVLINK1) {
+
+			while (i < len && buf[i] != MAVLINK_STX && buf[i] != MAVLINK_STX_MAVLINK1) {
+				i++;
+			}
+
+			if (i == len) {
+				break;
+			}
+		}
+
+		const uint8_t c = buf[i];
+		const uint8_t result = mavlink_frame_char_buffer(rxmsg, status, c, &msg, &_status);
+
+		if (result == MAVLINK_FRAMING_BAD_CRC || result == MAVLINK_FRAMING_BAD_SIGNATURE) {
+			// same as mavlink_parse_char(): treat as a parse failure and resync
+			_mav_parse_error(status);
+			status->msg_received = MAVLINK_FRAMING_INCOMPLETE;
+			status->parse_state = MAVLINK_PARSE_STATE_IDLE;
+
+			if (c == MAVLINK_STX) {
+				status->parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+				rxmsg->len = 0;
+				mavlink_start_checksum(rxmsg);
+			}
+
+		} else if (result == MAVLINK_FRAMING_OK) {
+			/* check if we received version 2 and request a switch. */
+			if (!(status->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)) {
+				/* this will only switch to proto version 2 if allowed in settings */
+				_mavlink->set_proto_version(2);
+			}
+
+			dispatch_message(&msg);
+		}
+	}
+}
+
+void
+MavlinkReceiver::dispatch_message(mavlink_message_t *msg)
+{
+	/* handle generic messages and commands */
+	handle_message(msg);
+
+	/* the components only handle a few message ids each, don't pass high rate traffic through all of them */
+	switch (msg->msgid) {
+	case MAVLINK_MSG_ID_MISSION_ACK:
+	case MAVLINK_MSG_ID_MISSION_SET_CURRENT:
+	case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+	case MAVLINK_MSG_ID_MISSION_REQUEST:
+	case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+	case MAVLINK_MSG_ID_MISSION_COUNT:
+	case MAVLINK_MSG_ID_MISSION_ITEM:
+	case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+	case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
+		/* handle packet with mission manager */
+		_mission_manager.handle_message(msg);
+		break;
+
+	case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+	case MAVLINK_MSG_ID_PARAM_SET:
+	case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+	case MAVLINK_MSG_ID_PARAM_MAP_RC:
+		/* handle packet with parameter component */
+		_parameters_manager.handle_message(msg);
+		break;
+
+	case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+		if (_mavlink->ftp_enabled()) {
+			/* handle packet with ftp component */
+			_mavlink_ftp.handle_message(msg);
+		}
+
+		break;
+
+	case MAVLINK_MSG_ID_LOG_REQUEST_LIST:
+	case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
+	case MAVLINK_MSG_ID_LOG_ERASE:
+	case MAVLINK_MSG_ID_LOG_REQUEST_END:
+		/* handle packet with log component */
+		_mavlink_log_handler.handle_message(msg);
+		break;
+
+	case MAVLINK_MSG_ID_TIMESYNC:
+	case MAVLINK_MSG_ID_SYSTEM_TIME:
+		/* handle packet with timesync component */
+		_mavlink_timesync.handle_message(msg);
+		break;
+
+	default:
+		break;
+	}
+
+	/* handle packet with parent object */
+	_mavlink->handle_message(msg);
+}
+
 void *
 MavlinkReceiver::start_helper(void *context)
 {
@@ -51,6 +51,7 @@
 #include <lib/drivers/barometer/PX4Barometer.hpp>
 #include <lib/drivers/gyroscope/PX4Gyroscope.hpp>
 #include <lib/drivers/magnetometer/PX4Magnetometer.hpp>
+#include <lib/perf/perf_counter.h>
 #include <px4_platform_common/module_params.h>
 #include <uORB/Publication.hpp>
 #include <uORB/PublicationQueued.hpp>
@@ -128,6 +129,16 @@ private:
 
 	void handle_message(mavlink_message_t *msg);
 
+	/**
+	 * Route a received message to the components handling its message id.
+	 */
+	void dispatch_message(mavlink_message_t *msg);
+
+	/**
+	 * Parse a buffer of received bytes and dispatch all complete messages.
+	 */
+	void parse_buffer(const uint8_t *buf, ssize_t len);
+
 	void handle_message_adsb_vehicle(mavlink_message_t *msg);
 	void handle_message_att_pos_mocap(mavlink_message_t *msg);
 	void handle_message_battery_status(mavlink_message_t *msg);
@@ -143,6 +154,8 @@ private:
 	void handle_message_follow_target(mavlink_message_t *msg);
 	void handle_message_gps_global_origin(mavlink_message_t *msg);
 	void handle_message_gps_rtcm_data(mavlink_message_t *msg);
+	unsigned rtcm3_frame_length() const; ///< length of the pending RTCM3 frame, 0 if unknown
+	void publish_rtcm_message();
 	void handle_message_heartbeat(mavlink_message_t *msg);
 	void handle_message_hil_gps(mavlink_message_t *msg);
 	void handle_message_hil_optical_flow(mavlink_message_t *msg);
@@ -290,6 +303,13 @@ private:
 
 	hrt_abstime			_last_utm_global_pos_com{0};
 
+	// reassembly of fragmented GPS_RTCM_DATA
+	gps_inject_data_s		_rtcm_message{};
+	uint8_t				_rtcm_sequence_id{0};
+	uint8_t				_rtcm_next_fragment{0};		///< 0 if no message is pending
+
+	perf_counter_t			_rtcm_fragments_lost_perf{perf_alloc(PC_COUNT, MODULE_NAME": RTCM fragments lost")};
+
 	DEFINE_PARAMETERS(
 		(ParamFloat<px4::params::BAT_CRIT_THR>)     _param_bat_crit_thr,
 		(ParamFloat<px4::params::BAT_EMERGEN_THR>)  _param_bat_emergen_thr,
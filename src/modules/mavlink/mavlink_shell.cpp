@@ -43,6 +43,7 @@
 
 #include <unistd.h>
 #include <errno.h>
+#include <string.h>
 #include <sys/ioctl.h>
 
 
@@ -165,16 +166,58 @@ size_t MavlinkShell::write(uint8_t *buffer, size_t len)
 
 size_t MavlinkShell::read(uint8_t *buffer, size_t len)
 {
-	return ::read(_from_shell_fd, buffer, len);
+	size_t buffered = _read_buffer_end - _read_buffer_start;
+
+	if (buffered < len) {
+		// top up the buffer with everything that is available in a single read
+		memmove(_read_buffer, &_read_buffer[_read_buffer_start], buffered);
+		_read_buffer_start = 0;
+		_read_buffer_end = buffered;
+
+		size_t read_len = sizeof(_read_buffer) - buffered;
+
+		if (buffered > 0) {
+			// don't block if there is already data to return
+			int pipe_available = 0;
+
+			if (ioctl(_from_shell_fd, FIONREAD, (unsigned long)&pipe_available) != OK || pipe_available < 0) {
+				pipe_available = 0;
+			}
+
+			if (read_len > (size_t)pipe_available) {
+				read_len = pipe_available;
+			}
+		}
+
+		if (read_len > 0) {
+			const ssize_t ret = ::read(_from_shell_fd, &_read_buffer[_read_buffer_end], read_len);
+
+			if (ret > 0) {
+				_read_buffer_end += ret;
+			}
+		}
+
+		buffered = _read_buffer_end - _read_buffer_start;
+	}
+
+	if (len > buffered) {
+		len = buffered;
+	}
+
+	memcpy(buffer, &_read_buffer[_read_buffer_start], len);
+	_read_buffer_start += len;
+
+	return len;
 }
 
 size_t MavlinkShell::available()
 {
+	const size_t buffered = _read_buffer_end - _read_buffer_start;
 	int ret = 0;
 
 	if (ioctl(_from_shell_fd, FIONREAD, (unsigned long)&ret) == OK) {
-		return ret;
+		return buffered + ret;
 	}
 
-	return 0;
+	return buffered;
 }
@@ -67,6 +67,8 @@ public:
 
 	/**
 	 * Read from the shell. This is blocking, if 0 bytes are available, this will block.
+	 * The output is read from the pipe in large chunks, and then handed out from a buffer,
+	 * so that sending it in several small messages does not need a read() for each.
 	 * @param len buffer length
 	 * @return number of bytes read.
 	 */
@@ -78,6 +80,11 @@ public:
 	size_t available();
 
 private:
+	static constexpr size_t READ_BUFFER_SIZE = 512;
+
+	uint8_t _read_buffer[READ_BUFFER_SIZE];
+	size_t _read_buffer_start{0}; /** first unread byte in _read_buffer */
+	size_t _read_buffer_end{0}; /** end of the data in _read_buffer */
 
 	int _to_shell_fd = -1; /** fd to write to the shell */
 	int _from_shell_fd = -1; /** fd to read from the shell */
@@ -50,11 +50,24 @@ MavlinkStream::MavlinkStream(Mavlink *mavlink) :
 	_last_sent = hrt_absolute_time();
 }
 
+int
+MavlinkStream::update(const hrt_abstime &t)
+{
+	const hrt_abstime start = hrt_absolute_time();
+	const uint32_t tx_bytes_start = _mavlink->get_tx_bytes_queued();
+
+	const int ret = update_stream(t);
+
+	count_resources(t, hrt_absolute_time() - start, _mavlink->get_tx_bytes_queued() - tx_bytes_start);
+
+	return ret;
+}
+
 /**
  * Update subscriptions and send message if necessary
  */
 int
-MavlinkStream::update(const hrt_abstime &t)
+MavlinkStream::update_stream(const hrt_abstime &t)
 {
 	update_data();
 
@@ -66,6 +79,7 @@ MavlinkStream::update(const hrt_abstime &t)
 		// on the link scheduling
 		if (send(t)) {
 			_last_sent = hrt_absolute_time();
+			count_sent(t);
 
 			if (!_first_message_sent) {
 				_first_message_sent = true;
@@ -84,10 +98,14 @@ MavlinkStream::update(const hrt_abstime &t)
 	int64_t dt = t - _last_sent;
 	int interval = (_interval > 0) ? _interval : 0;
 
-	if (!const_rate()) {
-		interval /= _mavlink->get_rate_mult();
+	const Priority prio = priority();
+
+	if (prio != Priority::CRITICAL) {
+		interval /= _mavlink->get_rate_mult(prio);
 	}
 
+	const int interval_margin = interval - (_mavlink->get_main_loop_delay() / 10) * 3;
+
 	// Send the message if it is due or
 	// if it will overrun the next scheduled send interval
 	// by 30% of the interval time. This helps to avoid
@@ -98,26 +116,94 @@ MavlinkStream::update(const hrt_abstime &t)
 	// This method is not theoretically optimal but a suitable
 	// stopgap as it hits its deadlines well (0.5 Hz, 50 Hz and 250 Hz)
 
-	if (interval == 0 || (dt > (interval - (_mavlink->get_main_loop_delay() / 10) * 3))) {
+	if (interval == 0 || (dt > interval_margin)) {
 		// interval expired, send message
 
+		// the link is saturated right now, retry on the next iteration
+		if (prio != Priority::CRITICAL && !_mavlink->tx_budget_available(get_size())) {
+			_next_update = 0;
+			return -1;
+		}
+
 		// If the interval is non-zero and dt is smaller than 1.5 times the interval
 		// do not use the actual time but increment at a fixed rate, so that processing delays do not
 		// distort the average rate. The check of the maximum interval is done to ensure that after a
 		// long time not sending anything, sending multiple messages in a short time is avoided.
 		if (send(t)) {
 			_last_sent = ((interval > 0) && ((int64_t)(1.5f * interval) > dt)) ? _last_sent + interval : t;
+			count_sent(t);
 
 			if (!_first_message_sent) {
 				_first_message_sent = true;
 			}
 
+			// nothing to do until the next interval expires
+			_next_update = (interval_margin > 0) ? _last_sent + interval_margin : 0;
+
 			return 0;
 
 		} else {
+			// no new data: poll again after a fraction of the interval instead of every iteration
+			_next_update = (interval > 0) ? t + interval / 8 : 0;
+
 			return -1;
 		}
 	}
 
+	_next_update = (interval_margin > 0) ? _last_sent + interval_margin : 0;
+
 	return -1;
 }
+
+void
+MavlinkStream::count_sent(const hrt_abstime &t)
+{
+	static constexpr hrt_abstime RATE_WINDOW = 1000000;
+
+	_rate_window_count++;
+
+	if (_rate_window_start == 0) {
+		_rate_window_start = t;
+
+	} else if (t - _rate_window_start >= RATE_WINDOW) {
+		_rate_achieved = _rate_window_count * 1e6f / (t - _rate_window_start);
+		_rate_window_start = t;
+		_rate_window_count = 0;
+	}
+}
+
+void
+MavlinkStream::count_resources(const hrt_abstime &t, uint32_t cpu_time, uint32_t tx_bytes)
+{
+	static constexpr hrt_abstime STATS_WINDOW = 1000000;
+
+	_update_count++;
+	_cpu_time_total += cpu_time;
+	_tx_bytes_total += tx_bytes;
+
+	_stats_window_cpu_time += cpu_time;
+	_stats_window_tx_bytes += tx_bytes;
+
+	if (_stats_window_start == 0) {
+		_stats_window_start = t;
+
+	} else if (t - _stats_window_start >= STATS_WINDOW) {
+		const float dt = t - _stats_window_start;
+		_load = _stats_window_cpu_time / dt;
+		_tx_rate = _stats_window_tx_bytes * 1e6f / dt;
+		_stats_window_start = t;
+		_stats_window_cpu_time = 0;
+		_stats_window_tx_bytes = 0;
+	}
+}
+
+float
+MavlinkStream::get_rate_achieved(const hrt_abstime &t) const
+{
+	// the stream stopped sending, don't report the rate of the last window forever
+	if ((_rate_window_start == 0) || (t - _rate_window_start > 2 * 1000000)) {
+		return (_rate_window_start > 0 && t > _rate_window_start) ? _rate_window_count * 1e6f / (t - _rate_window_start) : 0.0f;
+	}
+
+	return _rate_achieved;
+}
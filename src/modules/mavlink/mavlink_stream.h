@@ -52,6 +52,19 @@ class MavlinkStream : public ListNode<MavlinkStream *>
 
 public:
 
+	/**
+	 * Scheduling class of a stream. When the link budget is exceeded, streams are
+	 * scaled down starting with the lowest class, each class keeping a minimum share
+	 * of its configured rate. Critical streams are always sent at the configured rate.
+	 */
+	enum class Priority : uint8_t {
+		CRITICAL = 0,
+		NORMAL,
+		LOW,
+
+		COUNT
+	};
+
 	MavlinkStream(Mavlink *mavlink);
 	virtual ~MavlinkStream() = default;
 
@@ -66,7 +79,7 @@ public:
 	 *
 	 * @param interval the interval in microseconds (us) between messages
 	 */
-	void set_interval(const int interval) { _interval = interval; }
+	void set_interval(const int interval) { _interval = interval; _next_update = 0; }
 
 	/**
 	 * Get the interval
@@ -79,6 +92,12 @@ public:
 	 * @return 0 if updated / sent, -1 if unchanged
 	 */
 	int update(const hrt_abstime &t);
+
+	/**
+	 * @return true if update() needs to be called, false if the stream can be skipped
+	 *         this iteration because its interval did not expire yet
+	 */
+	bool update_required(const hrt_abstime &t) const { return _update_data_every_loop || t >= _next_update; }
 	virtual const char *get_name() const = 0;
 	virtual uint16_t get_id() = 0;
 
@@ -87,6 +106,11 @@ public:
 	 */
 	virtual bool const_rate() { return false; }
 
+	/**
+	 * @return scheduling class of the stream, see Priority
+	 */
+	virtual Priority priority() { return const_rate() ? Priority::CRITICAL : Priority::NORMAL; }
+
 	/**
 	 * Get maximal total messages size on update
 	 */
@@ -118,7 +142,27 @@ public:
 	 * Reset the time of last sent to 0. Can be used if a message over this
 	 * stream needs to be sent immediately.
 	 */
-	void reset_last_sent() { _last_sent = 0; }
+	void reset_last_sent() { _last_sent = 0; _next_update = 0; }
+
+	/**
+	 * @return the measured rate in Hz at which messages of this stream were sent
+	 */
+	float get_rate_achieved(const hrt_abstime &t) const;
+
+	/**
+	 * @return fraction of the time spent in update_data() and send() during the last
+	 *         measurement window (at least one second, longer for slow streams)
+	 */
+	float get_load() const { return _load; }
+
+	/**
+	 * @return bytes sent per second during the last measurement window [B/s]
+	 */
+	uint32_t get_tx_rate() const { return _tx_rate; }
+
+	uint32_t get_update_count() const { return _update_count; }
+	uint64_t get_cpu_time_total() const { return _cpu_time_total; }
+	uint32_t get_tx_bytes_total() const { return _tx_bytes_total; }
 
 protected:
 	Mavlink      *const _mavlink;
@@ -134,8 +178,30 @@ protected:
 	 */
 	virtual void update_data() { }
 
+	/** set by streams overriding update_data() so they are updated at every iteration */
+	bool _update_data_every_loop{false};
+
 private:
 	hrt_abstime _last_sent{0};
+	hrt_abstime _next_update{0};	///< the stream is not visited before this time
+
+	hrt_abstime _rate_window_start{0};	///< start of the current achieved rate measurement window
+	float _rate_achieved{0.0f};		///< achieved rate of the last completed window [Hz]
+	uint16_t _rate_window_count{0};		///< messages sent in the current window
+
+	/* runtime statistics, see 'mavlink status streams' */
+	hrt_abstime _stats_window_start{0};
+	uint32_t _stats_window_cpu_time{0};	///< [us]
+	uint32_t _stats_window_tx_bytes{0};
+	float _load{0.0f};
+	uint32_t _tx_rate{0};
+	uint32_t _update_count{0};
+	uint64_t _cpu_time_total{0};	///< [us]
+	uint32_t _tx_bytes_total{0};
+
+	int update_stream(const hrt_abstime &t);
+	void count_sent(const hrt_abstime &t);
+	void count_resources(const hrt_abstime &t, uint32_t cpu_time, uint32_t tx_bytes);
 	bool _first_message_sent{false};
 };
 
@@ -0,0 +1,291 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_stream_profiles.h
+ * Default stream rates of the MAVLink modes.
+ *
+ * The profiles are tables of (stream name hash, rate) pairs built at compile time. User profiles
+ * use the same binary layout: a mavlink_stream_profile_header_s followed by entry_count entries,
+ * see Tools/mavlink_stream_profile.py.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "mavlink_messages.h"
+
+#define MAVLINK_STREAM_PROFILE_MAGIC "MSPF"
+static constexpr uint16_t MAVLINK_STREAM_PROFILE_VERSION = 1;
+
+/* rate of streams sent on every update */
+static constexpr float STREAM_PROFILE_UNLIMITED_RATE = -1.0f;
+
+struct mavlink_stream_profile_header_s {
+	char magic[4];		///< MAVLINK_STREAM_PROFILE_MAGIC, not null terminated
+	uint16_t version;	///< MAVLINK_STREAM_PROFILE_VERSION
+	uint16_t entry_count;
+};
+
+struct mavlink_stream_profile_entry_s {
+	uint32_t stream_hash;	///< mavlink_stream_hash() of the stream name
+	float rate;		///< [Hz], negative: unlimited, 0: disabled
+};
+
+static_assert(sizeof(mavlink_stream_profile_header_s) == 8, "binary profile layout");
+static_assert(sizeof(mavlink_stream_profile_entry_s) == 8, "binary profile layout");
+
+struct mavlink_stream_profile_s {
+	const mavlink_stream_profile_entry_s *entries;
+	unsigned entry_count;
+};
+
+static constexpr mavlink_stream_profile_entry_s stream_profile_normal[] = {
+	{mavlink_stream_hash("ADSB_VEHICLE"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("ALTITUDE"), 1.0f},
+	{mavlink_stream_hash("ATTITUDE"), 15.0f},
+	{mavlink_stream_hash("ATTITUDE_TARGET"), 2.0f},
+	{mavlink_stream_hash("BATTERY_STATUS"), 0.5f},
+	{mavlink_stream_hash("CAMERA_IMAGE_CAPTURED"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("COLLISION"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("DEBUG"), 1.0f},
+	{mavlink_stream_hash("DEBUG_FLOAT_ARRAY"), 1.0f},
+	{mavlink_stream_hash("DEBUG_VECT"), 1.0f},
+	{mavlink_stream_hash("DISTANCE_SENSOR"), 0.5f},
+	{mavlink_stream_hash("ESTIMATOR_STATUS"), 0.5f},
+	{mavlink_stream_hash("EXTENDED_SYS_STATE"), 1.0f},
+	{mavlink_stream_hash("GLOBAL_POSITION_INT"), 5.0f},
+	{mavlink_stream_hash("GPS2_RAW"), 1.0f},
+	{mavlink_stream_hash("GPS_RAW_INT"), 1.0f},
+	{mavlink_stream_hash("HOME_POSITION"), 0.5f},
+	{mavlink_stream_hash("LOCAL_POSITION_NED"), 1.0f},
+	{mavlink_stream_hash("NAMED_VALUE_FLOAT"), 1.0f},
+	{mavlink_stream_hash("NAV_CONTROLLER_OUTPUT"), 1.0f},
+	{mavlink_stream_hash("OBSTACLE_DISTANCE"), 1.0f},
+	{mavlink_stream_hash("ORBIT_EXECUTION_STATUS"), 2.0f},
+	{mavlink_stream_hash("PING"), 0.1f},
+	{mavlink_stream_hash("POSITION_TARGET_GLOBAL_INT"), 1.0f},
+	{mavlink_stream_hash("POSITION_TARGET_LOCAL_NED"), 1.5f},
+	{mavlink_stream_hash("RC_CHANNELS"), 5.0f},
+	{mavlink_stream_hash("SERVO_OUTPUT_RAW_0"), 1.0f},
+	{mavlink_stream_hash("SYS_STATUS"), 1.0f},
+	{mavlink_stream_hash("UTM_GLOBAL_POSITION"), 0.5f},
+	{mavlink_stream_hash("VFR_HUD"), 4.0f},
+	{mavlink_stream_hash("WIND_COV"), 0.5f},
+};
+
+static constexpr mavlink_stream_profile_entry_s stream_profile_onboard[] = {
+	{mavlink_stream_hash("ACTUATOR_CONTROL_TARGET0"), 10.0f},
+	{mavlink_stream_hash("ADSB_VEHICLE"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("ALTITUDE"), 10.0f},
+	{mavlink_stream_hash("ATTITUDE"), 100.0f},
+	{mavlink_stream_hash("ATTITUDE_QUATERNION"), 50.0f},
+	{mavlink_stream_hash("ATTITUDE_TARGET"), 10.0f},
+	{mavlink_stream_hash("BATTERY_STATUS"), 0.5f},
+	{mavlink_stream_hash("CAMERA_CAPTURE"), 2.0f},
+	{mavlink_stream_hash("CAMERA_IMAGE_CAPTURED"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("CAMERA_TRIGGER"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("COLLISION"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("DEBUG"), 10.0f},
+	{mavlink_stream_hash("DEBUG_FLOAT_ARRAY"), 10.0f},
+	{mavlink_stream_hash("DEBUG_VECT"), 10.0f},
+	{mavlink_stream_hash("DISTANCE_SENSOR"), 10.0f},
+	{mavlink_stream_hash("ESTIMATOR_STATUS"), 1.0f},
+	{mavlink_stream_hash("EXTENDED_SYS_STATE"), 5.0f},
+	{mavlink_stream_hash("GLOBAL_POSITION_INT"), 50.0f},
+	{mavlink_stream_hash("GPS2_RAW"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("GPS_RAW_INT"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("HIGHRES_IMU"), 50.0f},
+	{mavlink_stream_hash("HOME_POSITION"), 0.5f},
+	{mavlink_stream_hash("LOCAL_POSITION_NED"), 30.0f},
+	{mavlink_stream_hash("NAMED_VALUE_FLOAT"), 10.0f},
+	{mavlink_stream_hash("NAV_CONTROLLER_OUTPUT"), 10.0f},
+	{mavlink_stream_hash("OBSTACLE_DISTANCE"), 10.0f},
+	{mavlink_stream_hash("ODOMETRY"), 30.0f},
+	{mavlink_stream_hash("OPTICAL_FLOW_RAD"), 10.0f},
+	{mavlink_stream_hash("ORBIT_EXECUTION_STATUS"), 5.0f},
+	{mavlink_stream_hash("PING"), 1.0f},
+	{mavlink_stream_hash("POSITION_TARGET_GLOBAL_INT"), 10.0f},
+	{mavlink_stream_hash("POSITION_TARGET_LOCAL_NED"), 10.0f},
+	{mavlink_stream_hash("RC_CHANNELS"), 20.0f},
+	{mavlink_stream_hash("SERVO_OUTPUT_RAW_0"), 10.0f},
+	{mavlink_stream_hash("SYS_STATUS"), 5.0f},
+	{mavlink_stream_hash("SYSTEM_TIME"), 1.0f},
+	{mavlink_stream_hash("TIMESYNC"), 10.0f},
+	{mavlink_stream_hash("TRAJECTORY_REPRESENTATION_WAYPOINTS"), 5.0f},
+	{mavlink_stream_hash("UTM_GLOBAL_POSITION"), 1.0f},
+	{mavlink_stream_hash("VFR_HUD"), 10.0f},
+	{mavlink_stream_hash("WIND_COV"), 10.0f},
+};
+
+/* ExtVisionMin is ExtVision without the first two entries */
+static constexpr mavlink_stream_profile_entry_s stream_profile_extvision[] = {
+	{mavlink_stream_hash("HIGHRES_IMU"), STREAM_PROFILE_UNLIMITED_RATE},	// for VIO
+	{mavlink_stream_hash("TIMESYNC"), 10.0f},
+	// ExtVisionMin starts here
+	{mavlink_stream_hash("ADSB_VEHICLE"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("ALTITUDE"), 10.0f},
+	{mavlink_stream_hash("ATTITUDE"), 20.0f},
+	{mavlink_stream_hash("ATTITUDE_TARGET"), 2.0f},
+	{mavlink_stream_hash("BATTERY_STATUS"), 0.5f},
+	{mavlink_stream_hash("CAMERA_IMAGE_CAPTURED"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("CAMERA_TRIGGER"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("COLLISION"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("DEBUG"), 1.0f},
+	{mavlink_stream_hash("DEBUG_FLOAT_ARRAY"), 1.0f},
+	{mavlink_stream_hash("DEBUG_VECT"), 1.0f},
+	{mavlink_stream_hash("DISTANCE_SENSOR"), 10.0f},
+	{mavlink_stream_hash("ESTIMATOR_STATUS"), 1.0f},
+	{mavlink_stream_hash("EXTENDED_SYS_STATE"), 1.0f},
+	{mavlink_stream_hash("GLOBAL_POSITION_INT"), 5.0f},
+	{mavlink_stream_hash("GPS2_RAW"), 1.0f},
+	{mavlink_stream_hash("GPS_RAW_INT"), 1.0f},
+	{mavlink_stream_hash("HOME_POSITION"), 0.5f},
+	{mavlink_stream_hash("LOCAL_POSITION_NED"), 30.0f},
+	{mavlink_stream_hash("NAMED_VALUE_FLOAT"), 1.0f},
+	{mavlink_stream_hash("NAV_CONTROLLER_OUTPUT"), 1.5f},
+	{mavlink_stream_hash("ODOMETRY"), 30.0f},
+	{mavlink_stream_hash("OPTICAL_FLOW_RAD"), 1.0f},
+	{mavlink_stream_hash("ORBIT_EXECUTION_STATUS"), 5.0f},
+	{mavlink_stream_hash("PING"), 0.1f},
+	{mavlink_stream_hash("POSITION_TARGET_GLOBAL_INT"), 1.5f},
+	{mavlink_stream_hash("POSITION_TARGET_LOCAL_NED"), 1.5f},
+	{mavlink_stream_hash("RC_CHANNELS"), 5.0f},
+	{mavlink_stream_hash("SERVO_OUTPUT_RAW_0"), 1.0f},
+	{mavlink_stream_hash("SYS_STATUS"), 5.0f},
+	{mavlink_stream_hash("TRAJECTORY_REPRESENTATION_WAYPOINTS"), 5.0f},
+	{mavlink_stream_hash("UTM_GLOBAL_POSITION"), 1.0f},
+	{mavlink_stream_hash("VFR_HUD"), 4.0f},
+	{mavlink_stream_hash("WIND_COV"), 1.0f},
+};
+
+static constexpr mavlink_stream_profile_entry_s stream_profile_osd[] = {
+	{mavlink_stream_hash("ALTITUDE"), 10.0f},
+	{mavlink_stream_hash("ATTITUDE"), 25.0f},
+	{mavlink_stream_hash("ATTITUDE_TARGET"), 10.0f},
+	{mavlink_stream_hash("BATTERY_STATUS"), 0.5f},
+	{mavlink_stream_hash("ESTIMATOR_STATUS"), 1.0f},
+	{mavlink_stream_hash("EXTENDED_SYS_STATE"), 1.0f},
+	{mavlink_stream_hash("GLOBAL_POSITION_INT"), 10.0f},
+	{mavlink_stream_hash("GPS_RAW_INT"), 1.0f},
+	{mavlink_stream_hash("HOME_POSITION"), 0.5f},
+	{mavlink_stream_hash("RC_CHANNELS"), 5.0f},
+	{mavlink_stream_hash("SERVO_OUTPUT_RAW_0"), 1.0f},
+	{mavlink_stream_hash("SYS_STATUS"), 5.0f},
+	{mavlink_stream_hash("SYSTEM_TIME"), 1.0f},
+	{mavlink_stream_hash("VFR_HUD"), 25.0f},
+	{mavlink_stream_hash("WIND_COV"), 2.0f},
+};
+
+static constexpr mavlink_stream_profile_entry_s stream_profile_config[] = {
+	{mavlink_stream_hash("ACTUATOR_CONTROL_TARGET0"), 30.0f},
+	{mavlink_stream_hash("ADSB_VEHICLE"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("ALTITUDE"), 10.0f},
+	{mavlink_stream_hash("ATTITUDE"), 50.0f},
+	{mavlink_stream_hash("ATTITUDE_QUATERNION"), 50.0f},
+	{mavlink_stream_hash("ATTITUDE_TARGET"), 8.0f},
+	{mavlink_stream_hash("BATTERY_STATUS"), 0.5f},
+	{mavlink_stream_hash("CAMERA_IMAGE_CAPTURED"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("CAMERA_TRIGGER"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("COLLISION"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("DEBUG"), 50.0f},
+	{mavlink_stream_hash("DEBUG_FLOAT_ARRAY"), 50.0f},
+	{mavlink_stream_hash("DEBUG_VECT"), 50.0f},
+	{mavlink_stream_hash("DISTANCE_SENSOR"), 10.0f},
+	{mavlink_stream_hash("ESTIMATOR_STATUS"), 5.0f},
+	{mavlink_stream_hash("EXTENDED_SYS_STATE"), 2.0f},
+	{mavlink_stream_hash("GLOBAL_POSITION_INT"), 10.0f},
+	{mavlink_stream_hash("GPS2_RAW"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("GPS_RAW_INT"), STREAM_PROFILE_UNLIMITED_RATE},
+	{mavlink_stream_hash("HIGHRES_IMU"), 50.0f},
+	{mavlink_stream_hash("HOME_POSITION"), 0.5f},
+	{mavlink_stream_hash("LOCAL_POSITION_NED"), 30.0f},
+	{mavlink_stream_hash("MANUAL_CONTROL"), 5.0f},
+	{mavlink_stream_hash("NAMED_VALUE_FLOAT"), 50.0f},
+	{mavlink_stream_hash("NAV_CONTROLLER_OUTPUT"), 10.0f},
+	{mavlink_stream_hash("ODOMETRY"), 30.0f},
+	{mavlink_stream_hash("OPTICAL_FLOW_RAD"), 10.0f},
+	{mavlink_stream_hash("ORBIT_EXECUTION_STATUS"), 5.0f},
+	{mavlink_stream_hash("PING"), 1.0f},
+	{mavlink_stream_hash("POSITION_TARGET_GLOBAL_INT"), 10.0f},
+	{mavlink_stream_hash("RC_CHANNELS"), 10.0f},
+	{mavlink_stream_hash("SCALED_IMU"), 25.0f},
+	{mavlink_stream_hash("SCALED_IMU2"), 25.0f},
+	{mavlink_stream_hash("SCALED_IMU3"), 25.0f},
+	{mavlink_stream_hash("SERVO_OUTPUT_RAW_0"), 20.0f},
+	{mavlink_stream_hash("SERVO_OUTPUT_RAW_1"), 20.0f},
+	{mavlink_stream_hash("SYS_STATUS"), 1.0f},
+	{mavlink_stream_hash("SYSTEM_TIME"), 1.0f},
+	{mavlink_stream_hash("TIMESYNC"), 10.0f},
+	{mavlink_stream_hash("UTM_GLOBAL_POSITION"), 1.0f},
+	{mavlink_stream_hash("VFR_HUD"), 20.0f},
+	{mavlink_stream_hash("WIND_COV"), 10.0f},
+};
+
+static constexpr mavlink_stream_profile_entry_s stream_profile_iridium[] = {
+	{mavlink_stream_hash("HIGH_LATENCY2"), 0.015f},
+};
+
+static constexpr mavlink_stream_profile_entry_s stream_profile_minimal[] = {
+	{mavlink_stream_hash("ALTITUDE"), 0.5f},
+	{mavlink_stream_hash("ATTITUDE"), 10.0f},
+	{mavlink_stream_hash("EXTENDED_SYS_STATE"), 0.1f},
+	{mavlink_stream_hash("GLOBAL_POSITION_INT"), 5.0f},
+	{mavlink_stream_hash("GPS_RAW_INT"), 0.5f},
+	{mavlink_stream_hash("HOME_POSITION"), 0.1f},
+	{mavlink_stream_hash("NAMED_VALUE_FLOAT"), 1.0f},
+	{mavlink_stream_hash("RC_CHANNELS"), 0.5f},
+	{mavlink_stream_hash("SYS_STATUS"), 0.1f},
+	{mavlink_stream_hash("VFR_HUD"), 1.0f},
+};
+
+#define STREAM_PROFILE(table) {table, sizeof(table) / sizeof(table[0])}
+#define STREAM_PROFILE_EMPTY {nullptr, 0}
+
+/* indexed by Mavlink::MAVLINK_MODE */
+static constexpr mavlink_stream_profile_s stream_profiles[] = {
+	STREAM_PROFILE(stream_profile_normal),		// MAVLINK_MODE_NORMAL
+	STREAM_PROFILE_EMPTY,				// MAVLINK_MODE_CUSTOM
+	STREAM_PROFILE(stream_profile_onboard),		// MAVLINK_MODE_ONBOARD
+	STREAM_PROFILE(stream_profile_osd),		// MAVLINK_MODE_OSD
+	STREAM_PROFILE_EMPTY,				// MAVLINK_MODE_MAGIC
+	STREAM_PROFILE(stream_profile_config),		// MAVLINK_MODE_CONFIG
+	STREAM_PROFILE(stream_profile_iridium),		// MAVLINK_MODE_IRIDIUM
+	STREAM_PROFILE(stream_profile_minimal),		// MAVLINK_MODE_MINIMAL
+	STREAM_PROFILE(stream_profile_extvision),	// MAVLINK_MODE_EXTVISION
+	{&stream_profile_extvision[2], sizeof(stream_profile_extvision) / sizeof(stream_profile_extvision[0]) - 2}, // MAVLINK_MODE_EXTVISIONMIN
+};
+
+#undef STREAM_PROFILE
+#undef STREAM_PROFILE_EMPTY
@@ -596,6 +596,84 @@ bool MavlinkFtpTest::_burst_test()
 	return true;
 }
 
+/// @brief Tests that bursts with a length are queued and sent back to back.
+bool MavlinkFtpTest::_burst_window_test()
+{
+	MavlinkFTP::PayloadHeader		payload;
+	const MavlinkFTP::PayloadHeader		*reply;
+	BurstWindowInfo				window_info{};
+	const DownloadTestCase			*test = &_rgDownloadTestCases[2];
+	const uint32_t full_packet_bytes = MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN - sizeof(MavlinkFTP::PayloadHeader);
+
+	payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+	payload.offset = 0;
+
+	bool success = _send_receive_msg(&payload,		// FTP payload header
+					 strlen(test->file) + 1,	// size in bytes of data
+					 (uint8_t *)test->file,	// Data to start into FTP message payload
+					 &reply);		// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+	const uint8_t session = reply->session;
+
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_burst_window, &window_info);
+
+	// request the second packet first, then the first packet while the first window is still in flight
+	const uint32_t windows[2][2] = { { full_packet_bytes, test->length - full_packet_bytes }, { 0, full_packet_bytes } };
+
+	for (int i = 0; i < 2; i++) {
+		payload.opcode = MavlinkFTP::kCmdBurstReadFile;
+		payload.session = session;
+		payload.offset = windows[i][0];
+
+		mavlink_message_t msg;
+		_setup_ftp_msg(&payload, sizeof(uint32_t), (const uint8_t *)&windows[i][1], &msg);
+		_ftp_server->handle_message(&msg);
+	}
+
+	// both windows go out with a single send
+	hrt_abstime t = 0;
+	_ftp_server->send(t);
+
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_generic, this);
+
+	ut_compare("Incorrect number of messages", window_info.count, 2);
+
+	for (int i = 0; i < 2; i++) {
+		// the requests were sequenced by _setup_ftp_msg, don't use _decode_message() here
+		const MavlinkFTP::PayloadHeader *window_reply =
+			reinterpret_cast<const MavlinkFTP::PayloadHeader *>(window_info.messages[i].payload);
+		ut_compare("Didn't get Ack back", window_reply->opcode, MavlinkFTP::kRspAck);
+		ut_compare("Offset incorrect", window_reply->offset, windows[i][0]);
+		ut_compare("Payload size incorrect", window_reply->size, windows[i][1]);
+		ut_compare("burst_complete incorrect", window_reply->burst_complete, 1);
+	}
+
+	ut_compare("All packets should have been sent", _ftp_server->get_size(), 0);
+
+	// Terminate session
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.session = session;
+	payload.size = 0;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    0,		// size in bytes of data
+				    nullptr,	// Data to start into FTP message payload
+				    &reply);	// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	return true;
+}
+
 /// @brief Tests for correct reponse to a Read command on an invalid session.
 bool MavlinkFtpTest::_read_badsession_test()
 {
@@ -819,6 +897,19 @@ void MavlinkFtpTest::receive_message_handler_burst(const mavlink_file_transfer_p
 	burst_info->ftp_test_class->_receive_message_handler_burst(ftp_req, burst_info);
 }
 
+/// Static method used as callback from MavlinkFTP for windowed burst testing, collects the sent messages.
+void MavlinkFtpTest::receive_message_handler_burst_window(const mavlink_file_transfer_protocol_t *ftp_req,
+		void *worker_data)
+{
+	BurstWindowInfo *window_info = (BurstWindowInfo *)worker_data;
+
+	if (window_info->count < BurstWindowInfo::max_messages) {
+		memcpy(&window_info->messages[window_info->count], ftp_req, sizeof(mavlink_file_transfer_protocol_t));
+	}
+
+	window_info->count++;
+}
+
 bool MavlinkFtpTest::_receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_msg,
 		BurstInfo *burst_info)
 {
@@ -963,6 +1054,7 @@ bool MavlinkFtpTest::run_tests()
 	ut_run_test(_read_test);
 	ut_run_test(_read_badsession_test);
 	ut_run_test(_burst_test);
+	ut_run_test(_burst_window_test);
 	ut_run_test(_removedirectory_test);
 
 	// TODO FIX: Didn't get Nak back - (reply->opcode:128) (MavlinkFTP::kRspNak:129) (../../src/modules/mavlink/mavlink_tests/mavlink_ftp_test.cpp:730)
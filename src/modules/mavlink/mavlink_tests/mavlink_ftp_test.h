@@ -61,6 +61,15 @@ public:
 
 	static void receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
 
+	/// Worker data for windowed burst handler, collects all sent messages
+	struct BurstWindowInfo {
+		static constexpr int max_messages = 4;
+		int					count;
+		mavlink_file_transfer_protocol_t	messages[max_messages];
+	};
+
+	static void receive_message_handler_burst_window(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
+
 	static const uint8_t serverSystemId = 50;	///< System ID for server
 	static const uint8_t serverComponentId = 1;	///< Component ID for server
 	static const uint8_t serverChannel = 0;		///< Channel to send to
@@ -87,6 +96,7 @@ private:
 	bool _read_test(void);
 	bool _read_badsession_test(void);
 	bool _burst_test(void);
+	bool _burst_window_test(void);
 	bool _removedirectory_test(void);
 	bool _createdirectory_test(void);
 	bool _removefile_test(void);
@@ -102,6 +102,11 @@ private:
 	 */
 	void		control_attitude();
 
+	/**
+	 * Run at a low rate while a VTOL is in fixed-wing flight and the multicopter outputs are not used.
+	 */
+	void		vtol_scheduling_update();
+
 	AttitudeControl _attitude_control; ///< class for attitude control calculations
 
 	uORB::Subscription _v_att_sp_sub{ORB_ID(vehicle_attitude_setpoint)};		/**< vehicle attitude setpoint subscription */
@@ -109,10 +114,10 @@ private:
 	uORB::Subscription _v_control_mode_sub{ORB_ID(vehicle_control_mode)};		/**< vehicle control mode subscription */
 	uORB::Subscription _params_sub{ORB_ID(parameter_update)};			/**< parameter updates subscription */
 	uORB::Subscription _manual_control_sp_sub{ORB_ID(manual_control_setpoint)};	/**< manual control setpoint subscription */
-	uORB::Subscription _vehicle_status_sub{ORB_ID(vehicle_status)};			/**< vehicle status subscription */
 	uORB::Subscription _vehicle_land_detected_sub{ORB_ID(vehicle_land_detected)};	/**< vehicle land detected subscription */
 
 	uORB::SubscriptionCallbackWorkItem _vehicle_attitude_sub{this, ORB_ID(vehicle_attitude)};
+	uORB::SubscriptionCallbackWorkItem _vehicle_status_sub{this, ORB_ID(vehicle_status)};	/**< vehicle status, callback only while inactive */
 
 	uORB::Publication<vehicle_rates_setpoint_s>	_v_rates_sp_pub{ORB_ID(vehicle_rates_setpoint)};			/**< rate setpoint publication */
 	uORB::Publication<vehicle_attitude_setpoint_s>	_vehicle_attitude_setpoint_pub;
@@ -135,6 +140,9 @@ private:
 
 	bool _reset_yaw_sp{true};
 
+	static constexpr uint32_t VTOL_INACTIVE_INTERVAL_MS{100};	/**< attitude update interval while the multicopter outputs are unused */
+	bool _vtol_inactive{false};
+
 	DEFINE_PARAMETERS(
 		(ParamFloat<px4::params::MC_ROLL_P>) _param_mc_roll_p,
 		(ParamFloat<px4::params::MC_PITCH_P>) _param_mc_pitch_p,
@@ -250,17 +250,45 @@ MulticopterAttitudeControl::publish_rates_setpoint()
 	_v_rates_sp_pub.publish(v_rates_sp);
 }
 
+void
+MulticopterAttitudeControl::vtol_scheduling_update()
+{
+	// in fixed-wing flight the attitude controller is not run, keep running at a low rate
+	// and get woken up by vehicle_status to be at full rate as soon as a transition starts
+	const bool inactive = _vehicle_status.is_vtol
+			      && _vehicle_status.vehicle_type == vehicle_status_s::VEHICLE_TYPE_FIXED_WING
+			      && !_vehicle_status.in_transition_mode;
+
+	if (inactive != _vtol_inactive) {
+		if (inactive) {
+			_vehicle_attitude_sub.set_interval_ms(VTOL_INACTIVE_INTERVAL_MS);
+			_vehicle_status_sub.registerCallback();
+
+		} else {
+			_vehicle_attitude_sub.set_interval_us(0);
+			_vehicle_status_sub.unregisterCallback();
+		}
+
+		_vtol_inactive = inactive;
+	}
+}
+
 void
 MulticopterAttitudeControl::Run()
 {
 	if (should_exit()) {
 		_vehicle_attitude_sub.unregisterCallback();
+		_vehicle_status_sub.unregisterCallback();
 		exit_and_cleanup();
 		return;
 	}
 
 	perf_begin(_loop_perf);
 
+	if (_vehicle_status_sub.update(&_vehicle_status)) {
+		vtol_scheduling_update();
+	}
+
 	// Check if parameters have changed
 	if (_params_sub.updated()) {
 		// clear update
@@ -292,7 +320,6 @@ MulticopterAttitudeControl::Run()
 		_manual_control_sp_sub.update(&_manual_control_sp);
 		_v_control_mode_sub.update(&_v_control_mode);
 		_vehicle_land_detected_sub.update(&_vehicle_land_detected);
-		_vehicle_status_sub.update(&_vehicle_status);
 
 		/* Check if we are in rattitude mode and the pilot is above the threshold on pitch
 		* or roll (yaw can rotate 360 in normal att control). If both are true don't
@@ -38,7 +38,7 @@
 
 #include <commander/px4_custom_mode.h>
 #include <drivers/drv_hrt.h>
-#include <lib/controllib/blocks.hpp>
+#include <lib/controllib/BlockChain.hpp>
 #include <lib/flight_tasks/FlightTasks.hpp>
 #include <lib/hysteresis/hysteresis.h>
 #include <lib/mathlib/mathlib.h>
@@ -79,8 +79,8 @@ using namespace time_literals;
  */
 extern "C" __EXPORT int mc_pos_control_main(int argc, char *argv[]);
 
-class MulticopterPositionControl : public ModuleBase<MulticopterPositionControl>, public control::SuperBlock,
-	public ModuleParams, public px4::WorkItem
+class MulticopterPositionControl : public ModuleBase<MulticopterPositionControl>, public ModuleParams,
+	public px4::WorkItem
 {
 public:
 	MulticopterPositionControl(bool vtol = false);
@@ -172,12 +172,18 @@ private:
 		(ParamInt<px4::params::MPC_ALT_MODE>) _param_mpc_alt_mode,
 		(ParamFloat<px4::params::MPC_TILTMAX_LND>) _param_mpc_tiltmax_lnd, /**< maximum tilt for landing and smooth takeoff */
 		(ParamFloat<px4::params::MPC_THR_MIN>) _param_mpc_thr_min,
-		(ParamFloat<px4::params::MPC_THR_MAX>) _param_mpc_thr_max
+		(ParamFloat<px4::params::MPC_THR_MAX>) _param_mpc_thr_max,
+		(ParamFloat<px4::params::MPC_VELD_LP>) _param_mpc_veld_lp
 	);
 
-	control::BlockDerivative _vel_x_deriv; /**< velocity derivative in x */
-	control::BlockDerivative _vel_y_deriv; /**< velocity derivative in y */
-	control::BlockDerivative _vel_z_deriv; /**< velocity derivative in z */
+	/** numerical derivative followed by a low pass filter, the cutoff frequency is read from _param_mpc_veld_lp */
+	using VelocityDerivative = control::BlockChain<control::chain::Derivative, control::chain::LowPass>;
+
+	VelocityDerivative _vel_x_deriv; /**< velocity derivative in x */
+	VelocityDerivative _vel_y_deriv; /**< velocity derivative in y */
+	VelocityDerivative _vel_z_deriv; /**< velocity derivative in z */
+
+	float _dt{0.f}; /**< time since the last loop iteration [s] */
 
 	FlightTasks _flight_tasks; /**< class generating position controller setpoints depending on vehicle task */
 	PositionControl _control; /**< class for core PID position control */
@@ -273,13 +279,12 @@ private:
 };
 
 MulticopterPositionControl::MulticopterPositionControl(bool vtol) :
-	SuperBlock(nullptr, "MPC"),
 	ModuleParams(nullptr),
 	WorkItem(MODULE_NAME, px4::wq_configurations::att_pos_ctrl),
 	_vehicle_attitude_setpoint_pub(vtol ? ORB_ID(mc_virtual_attitude_setpoint) : ORB_ID(vehicle_attitude_setpoint)),
-	_vel_x_deriv(this, "VELD"),
-	_vel_y_deriv(this, "VELD"),
-	_vel_z_deriv(this, "VELD"),
+	_vel_x_deriv(control::chain::Derivative{}, control::chain::LowPass{_param_mpc_veld_lp.reference()}),
+	_vel_y_deriv(control::chain::Derivative{}, control::chain::LowPass{_param_mpc_veld_lp.reference()}),
+	_vel_z_deriv(control::chain::Derivative{}, control::chain::LowPass{_param_mpc_veld_lp.reference()}),
 	_cycle_perf(perf_alloc(PC_ELAPSED, MODULE_NAME": cycle time"))
 {
 	if (vtol) {
@@ -338,7 +343,6 @@ MulticopterPositionControl::parameters_update(bool force)
 
 		// update parameters from storage
 		ModuleParams::updateParams();
-		SuperBlock::updateParams();
 
 		_control.setPositionGains(Vector3f(_param_mpc_xy_p.get(), _param_mpc_xy_p.get(), _param_mpc_z_p.get()));
 		_control.setVelocityGains(Vector3f(_param_mpc_xy_vel_p.get(), _param_mpc_xy_vel_p.get(), _param_mpc_z_vel_p.get()),
@@ -450,8 +454,8 @@ MulticopterPositionControl::set_vehicle_states(const float &vel_sp_z)
 	if (PX4_ISFINITE(_local_pos.vx) && PX4_ISFINITE(_local_pos.vy) && _local_pos.v_xy_valid) {
 		_states.velocity(0) = _local_pos.vx;
 		_states.velocity(1) = _local_pos.vy;
-		_states.acceleration(0) = _vel_x_deriv.update(-_states.velocity(0));
-		_states.acceleration(1) = _vel_y_deriv.update(-_states.velocity(1));
+		_states.acceleration(0) = _vel_x_deriv.update(-_states.velocity(0), _dt);
+		_states.acceleration(1) = _vel_y_deriv.update(-_states.velocity(1), _dt);
 
 	} else {
 		_states.velocity(0) = _states.velocity(1) = NAN;
@@ -471,7 +475,7 @@ MulticopterPositionControl::set_vehicle_states(const float &vel_sp_z)
 			_states.velocity(2) = _local_pos.z_deriv * weighting + _local_pos.vz * (1.0f - weighting);
 		}
 
-		_states.acceleration(2) = _vel_z_deriv.update(-_states.velocity(2));
+		_states.acceleration(2) = _vel_z_deriv.update(-_states.velocity(2), _dt);
 
 	} else {
 		_states.velocity(2) = _states.acceleration(2) = NAN;
@@ -511,9 +515,9 @@ MulticopterPositionControl::Run()
 		poll_subscriptions();
 		parameters_update(false);
 
-		// set _dt in controllib Block - the time difference since the last loop iteration in seconds
+		// the time difference since the last loop iteration in seconds
 		const hrt_abstime time_stamp_now = hrt_absolute_time();
-		setDt((time_stamp_now - _time_stamp_last_loop) / 1e6f);
+		_dt = (time_stamp_now - _time_stamp_last_loop) / 1e6f;
 		_time_stamp_last_loop = time_stamp_now;
 
 		const bool was_in_failsafe = _in_failsafe;
@@ -0,0 +1,298 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file RateControlBatch.hpp
+ *
+ * N independent PID 3 axis angular rate controllers updated together, with the same control law as RateControl.
+ *
+ * The controller states are stored as structure of arrays in blocks of 4 controllers per axis (one 4 lane vector),
+ * such that one update of all controllers maps to NEON or SSE instructions. On targets without SIMD the compiler
+ * lowers the vector operations to scalar FPU code.
+ */
+
+#pragma once
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+
+#include <matrix/matrix/math.hpp>
+#include <mathlib/mathlib.h>
+
+#include <lib/mixer/MultirotorMixer/MultirotorMixer.hpp>
+#include <uORB/topics/rate_ctrl_status.h>
+
+template<int N>
+class RateControlBatch
+{
+public:
+	static_assert(N > 0, "at least one controller required");
+
+	RateControlBatch()
+	{
+		for (int i = 0; i < N; i++) {
+			setDTermCutoff(i, 0.f, 0.f, true);
+		}
+	}
+
+	~RateControlBatch() = default;
+
+	static constexpr int size() { return N; }
+
+	/** @see RateControl::setGains() */
+	void setGains(int i, const matrix::Vector3f &P, const matrix::Vector3f &I, const matrix::Vector3f &D)
+	{
+		setLane(_gain_p, i, P);
+		setLane(_gain_i, i, I);
+		setLane(_gain_d, i, D);
+	}
+
+	/** @see RateControl::setIntegratorLimit() */
+	void setIntegratorLimit(int i, const matrix::Vector3f &integrator_limit) { setLane(_lim_int, i, integrator_limit); }
+
+	/** @see RateControl::setFeedForwardGain() */
+	void setFeedForwardGain(int i, const matrix::Vector3f &FF) { setLane(_gain_ff, i, FF); }
+
+	/** @see RateControl::setDTermCutoff() */
+	void setDTermCutoff(int i, const float loop_rate, const float cutoff, const bool force)
+	{
+		// only do expensive filter update if the cutoff changed
+		if (!force && fabsf(_cutoff[i] - cutoff) <= 0.01f) {
+			return;
+		}
+
+		_cutoff[i] = cutoff;
+
+		// same design as LowPassFilter2pVector3f
+		float b0 = 1.f, b1 = 0.f, b2 = 0.f, a1 = 0.f, a2 = 0.f;
+
+		if (cutoff > 0.f) {
+			const float fr = loop_rate / cutoff;
+			const float ohm = tanf(M_PI_F / fr);
+			const float c = 1.f + 2.f * cosf(M_PI_F / 4.f) * ohm + ohm * ohm;
+			b0 = ohm * ohm / c;
+			b1 = 2.f * b0;
+			b2 = b0;
+			a1 = 2.f * (ohm * ohm - 1.f) / c;
+			a2 = (1.f - 2.f * cosf(M_PI_F / 4.f) * ohm + ohm * ohm) / c;
+		}
+
+		const int block = i / LANES;
+		const int lane = i % LANES;
+		_b0[block][lane] = b0;
+		_b1[block][lane] = b1;
+		_b2[block][lane] = b2;
+		_a1[block][lane] = a1;
+		_a2[block][lane] = a2;
+
+		// reset the filter to the previous rates (LowPassFilter2pVector3f::reset() followed by apply())
+		const matrix::Vector3f rate_prev = getLane(_rate_prev, i);
+		matrix::Vector3f dval = rate_prev / (b0 + b1 + b2);
+
+		if (!PX4_ISFINITE(dval(0)) || !PX4_ISFINITE(dval(1)) || !PX4_ISFINITE(dval(2))) {
+			dval = rate_prev;
+		}
+
+		for (int axis = 0; axis < 3; axis++) {
+			const float w0 = rate_prev(axis) - dval(axis) * a1 - dval(axis) * a2;
+			_w2[axis][block][lane] = dval(axis);
+			_w1[axis][block][lane] = w0;
+		}
+	}
+
+	/** @see RateControl::setSaturationStatus() */
+	void setSaturationStatus(int i, const MultirotorMixer::saturation_status &status)
+	{
+		const int block = i / LANES;
+		const int lane = i % LANES;
+		_saturation_positive[0][block][lane] = status.flags.roll_pos ? -1 : 0;
+		_saturation_positive[1][block][lane] = status.flags.pitch_pos ? -1 : 0;
+		_saturation_positive[2][block][lane] = status.flags.yaw_pos ? -1 : 0;
+		_saturation_negative[0][block][lane] = status.flags.roll_neg ? -1 : 0;
+		_saturation_negative[1][block][lane] = status.flags.pitch_neg ? -1 : 0;
+		_saturation_negative[2][block][lane] = status.flags.yaw_neg ? -1 : 0;
+	}
+
+	/** @see RateControl::resetIntegral() */
+	void resetIntegral(int i) { setLane(_rate_int, i, matrix::Vector3f{}); }
+
+	/** @see RateControl::getRateControlStatus() */
+	void getRateControlStatus(int i, rate_ctrl_status_s &rate_ctrl_status) const
+	{
+		const matrix::Vector3f rate_int = getLane(_rate_int, i);
+		rate_ctrl_status.rollspeed_integ = rate_int(0);
+		rate_ctrl_status.pitchspeed_integ = rate_int(1);
+		rate_ctrl_status.yawspeed_integ = rate_int(2);
+	}
+
+	/**
+	 * Run one control loop cycle of all controllers, for each controller the same as RateControl::update()
+	 * @param rate estimation of the current angular rate of each controller
+	 * @param rate_sp desired angular rate setpoint of each controller
+	 * @param dt time since the last update of each controller
+	 * @param landed landed state of each controller, the integral is not updated when landed
+	 * @param torque [-1,1] normalized torque vector of each controller
+	 */
+	void update(const matrix::Vector3f rate[N], const matrix::Vector3f rate_sp[N], const float dt[N],
+		    const bool landed[N], matrix::Vector3f torque[N])
+	{
+		for (int block = 0; block < BLOCKS; block++) {
+			vec4 dt_block{};
+			vec4i integrate{};
+
+			for (int lane = 0; lane < LANES; lane++) {
+				const int i = block * LANES + lane;
+
+				if (i < N) {
+					dt_block[lane] = dt[i];
+					integrate[lane] = landed[i] ? 0 : -1;
+				}
+			}
+
+			const vec4i dt_valid = dt_block > FLT_EPSILON;
+			const vec4 dt_inv = select(dt_valid, 1.f / select(dt_valid, dt_block, vec4{} + 1.f), vec4{});
+
+			for (int axis = 0; axis < 3; axis++) {
+				vec4 r{};
+				vec4 r_sp{};
+
+				for (int lane = 0; lane < LANES; lane++) {
+					const int i = block * LANES + lane;
+
+					if (i < N) {
+						r[lane] = rate[i](axis);
+						r_sp[lane] = rate_sp[i](axis);
+					}
+				}
+
+				// angular rates error
+				vec4 rate_error = r_sp - r;
+
+				// D-term based on low-pass filtered rates (Direct Form II as LowPassFilter2pVector3f)
+				const vec4 w0 = r - _w1[axis][block] * _a1[block] - _w2[axis][block] * _a2[block];
+				const vec4 rate_filtered = w0 * _b0[block] + _w1[axis][block] * _b1[block] + _w2[axis][block] * _b2[block];
+				_w2[axis][block] = _w1[axis][block];
+				_w1[axis][block] = w0;
+
+				const vec4 rate_d = (rate_filtered - _rate_prev_filtered[axis][block]) * dt_inv;
+
+				// PID control with feed forward
+				const vec4 out = _gain_p[axis][block] * rate_error + _rate_int[axis][block] - _gain_d[axis][block] * rate_d
+						 + _gain_ff[axis][block] * r_sp;
+
+				_rate_prev[axis][block] = r;
+				_rate_prev_filtered[axis][block] = rate_filtered;
+
+				// prevent further positive and negative control saturation
+				rate_error = select(_saturation_positive[axis][block], min(rate_error, vec4{}), rate_error);
+				rate_error = select(_saturation_negative[axis][block], max(rate_error, vec4{}), rate_error);
+
+				// I term factor, see RateControl::updateIntegral()
+				vec4 i_factor = rate_error / math::radians(400.f);
+				i_factor = max(vec4{}, 1.f - i_factor * i_factor);
+
+				// Perform the integration using a first order method, only if not landed
+				const vec4 rate_i = _rate_int[axis][block] + i_factor * _gain_i[axis][block] * rate_error * dt_block;
+
+				// do not propagate the result if out of range or invalid
+				const vec4i update_integral = integrate & isFinite(rate_i);
+				_rate_int[axis][block] = select(update_integral, min(max(rate_i, -_lim_int[axis][block]), _lim_int[axis][block]),
+								_rate_int[axis][block]);
+
+				for (int lane = 0; lane < LANES; lane++) {
+					const int i = block * LANES + lane;
+
+					if (i < N) {
+						torque[i](axis) = out[lane];
+					}
+				}
+			}
+		}
+	}
+
+private:
+	typedef float vec4 __attribute__((vector_size(16)));
+	typedef int32_t vec4i __attribute__((vector_size(16)));
+
+	static constexpr int LANES = 4;
+	static constexpr int BLOCKS = (N + LANES - 1) / LANES;
+
+	static inline vec4 select(const vec4i &mask, const vec4 &a, const vec4 &b)
+	{
+		return (vec4)(((vec4i)a & mask) | ((vec4i)b & ~mask));
+	}
+
+	static inline vec4 min(const vec4 &a, const vec4 &b) { return select(a < b, a, b); }
+	static inline vec4 max(const vec4 &a, const vec4 &b) { return select(a > b, a, b); }
+
+	// NaN and inf have all exponent bits set
+	static inline vec4i isFinite(const vec4 &v) { return ((vec4i)v & 0x7f800000) != 0x7f800000; }
+
+	void setLane(vec4 v[3][BLOCKS], int i, const matrix::Vector3f &value)
+	{
+		for (int axis = 0; axis < 3; axis++) {
+			v[axis][i / LANES][i % LANES] = value(axis);
+		}
+	}
+
+	matrix::Vector3f getLane(const vec4 v[3][BLOCKS], int i) const
+	{
+		return matrix::Vector3f{v[0][i / LANES][i % LANES], v[1][i / LANES][i % LANES], v[2][i / LANES][i % LANES]};
+	}
+
+	// Gains, per axis and block of controllers
+	vec4 _gain_p[3][BLOCKS] {};
+	vec4 _gain_i[3][BLOCKS] {};
+	vec4 _gain_d[3][BLOCKS] {};
+	vec4 _lim_int[3][BLOCKS] {};
+	vec4 _gain_ff[3][BLOCKS] {};
+
+	// D-term low-pass filter coefficients, per block of controllers
+	vec4 _b0[BLOCKS] {};
+	vec4 _b1[BLOCKS] {};
+	vec4 _b2[BLOCKS] {};
+	vec4 _a1[BLOCKS] {};
+	vec4 _a2[BLOCKS] {};
+	float _cutoff[N] {};
+
+	// States
+	vec4 _w1[3][BLOCKS] {}; ///< D-term low-pass filter delay elements
+	vec4 _w2[3][BLOCKS] {};
+	vec4 _rate_prev[3][BLOCKS] {};
+	vec4 _rate_prev_filtered[3][BLOCKS] {};
+	vec4 _rate_int[3][BLOCKS] {};
+	vec4i _saturation_positive[3][BLOCKS] {};
+	vec4i _saturation_negative[3][BLOCKS] {};
+};
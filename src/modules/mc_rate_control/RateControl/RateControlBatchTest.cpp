@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2019 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <gtest/gtest.h>
+#include <RateControl.hpp>
+#include <RateControlBatch.hpp>
+
+using namespace matrix;
+
+static constexpr int CONTROLLERS = 6;
+
+class RateControlBatchTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		for (int i = 0; i < CONTROLLERS; i++) {
+			const Vector3f P(0.15f + 0.01f * i, 0.15f, 0.2f);
+			const Vector3f I(0.2f, 0.2f + 0.02f * i, 0.1f);
+			const Vector3f D(0.003f, 0.003f, 0.f);
+			const Vector3f FF(0.f, 0.f, 0.01f * i);
+
+			_rate_control[i].setGains(P, I, D);
+			_rate_control[i].setIntegratorLimit(Vector3f(0.3f, 0.3f, 0.3f));
+			_rate_control[i].setFeedForwardGain(FF);
+
+			_batch.setGains(i, P, I, D);
+			_batch.setIntegratorLimit(i, Vector3f(0.3f, 0.3f, 0.3f));
+			_batch.setFeedForwardGain(i, FF);
+		}
+	}
+
+	// run all controllers with pseudo random inputs and compare the batch against the scalar implementation
+	void runAndCompare(int steps)
+	{
+		for (int step = 0; step < steps; step++) {
+			Vector3f rate[CONTROLLERS];
+			Vector3f rate_sp[CONTROLLERS];
+			Vector3f torque[CONTROLLERS];
+			float dt[CONTROLLERS];
+			bool landed[CONTROLLERS];
+
+			for (int i = 0; i < CONTROLLERS; i++) {
+				for (int axis = 0; axis < 3; axis++) {
+					rate[i](axis) = random();
+					rate_sp[i](axis) = random();
+				}
+
+				// controller 3 sometimes gets no time step, odd controllers are landed for a while
+				dt[i] = (i == 3 && _step % 7 == 0) ? 0.f : 0.004f;
+				landed[i] = (_step % 50 < 5) && (i % 2);
+			}
+
+			_batch.update(rate, rate_sp, dt, landed, torque);
+
+			for (int i = 0; i < CONTROLLERS; i++) {
+				const Vector3f expected = _rate_control[i].update(rate[i], rate_sp[i], dt[i], landed[i]);
+
+				for (int axis = 0; axis < 3; axis++) {
+					EXPECT_NEAR(torque[i](axis), expected(axis), 1e-5f) << "controller " << i << " step " << _step;
+				}
+			}
+
+			_step++;
+		}
+
+		for (int i = 0; i < CONTROLLERS; i++) {
+			rate_ctrl_status_s expected{};
+			rate_ctrl_status_s status{};
+			_rate_control[i].getRateControlStatus(expected);
+			_batch.getRateControlStatus(i, status);
+			EXPECT_NEAR(status.rollspeed_integ, expected.rollspeed_integ, 1e-5f);
+			EXPECT_NEAR(status.pitchspeed_integ, expected.pitchspeed_integ, 1e-5f);
+			EXPECT_NEAR(status.yawspeed_integ, expected.yawspeed_integ, 1e-5f);
+		}
+	}
+
+	// deterministic rate in [-5, 5] rad/s
+	float random()
+	{
+		_seed = _seed * 1664525u + 1013904223u;
+		return (_seed >> 8) / float(1 << 24) * 10.f - 5.f;
+	}
+
+	RateControl _rate_control[CONTROLLERS];
+	RateControlBatch<CONTROLLERS> _batch;
+
+	uint32_t _seed{1};
+	int _step{0};
+};
+
+TEST_F(RateControlBatchTest, AllZeroCase)
+{
+	Vector3f rate[CONTROLLERS];
+	Vector3f torque[CONTROLLERS];
+	const float dt[CONTROLLERS] {};
+	const bool landed[CONTROLLERS] {};
+
+	_batch.update(rate, rate, dt, landed, torque);
+
+	for (int i = 0; i < CONTROLLERS; i++) {
+		EXPECT_EQ(torque[i], Vector3f());
+	}
+}
+
+TEST_F(RateControlBatchTest, SameAsRateControl)
+{
+	runAndCompare(100);
+}
+
+TEST_F(RateControlBatchTest, DTermCutoffSameAsRateControl)
+{
+	runAndCompare(10);
+
+	for (int i = 0; i < CONTROLLERS; i++) {
+		_rate_control[i].setDTermCutoff(250.f, 30.f + i, false);
+		_batch.setDTermCutoff(i, 250.f, 30.f + i, false);
+	}
+
+	runAndCompare(100);
+}
+
+TEST_F(RateControlBatchTest, SaturationSameAsRateControl)
+{
+	for (int i = 0; i < CONTROLLERS; i++) {
+		MultirotorMixer::saturation_status status{};
+		status.flags.roll_pos = i & 1;
+		status.flags.pitch_neg = (i >> 1) & 1;
+		status.flags.yaw_neg = (i >> 2) & 1;
+		_rate_control[i].setSaturationStatus(status);
+		_batch.setSaturationStatus(i, status);
+	}
+
+	runAndCompare(100);
+
+	_rate_control[2].resetIntegral();
+	_batch.resetIntegral(2);
+
+	runAndCompare(100);
+}
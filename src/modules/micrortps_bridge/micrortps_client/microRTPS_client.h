@@ -52,6 +52,7 @@
 #define BUFFER_SIZE 1024
 #define LOOPS -1
 #define SLEEP_MS 1
+#define BATCH_MS 0
 #define BAUDRATE 460800
 #define DEVICE "/dev/ttyACM0"
 #define POLL_MS 1
@@ -78,6 +79,7 @@ struct options {
 	uint16_t recv_port = DEFAULT_RECV_PORT;
 	uint16_t send_port = DEFAULT_SEND_PORT;
 	uint32_t sleep_ms = SLEEP_MS;
+	uint32_t batch_ms = BATCH_MS;
 	uint32_t baudrate = BAUDRATE;
 	uint32_t poll_ms = POLL_MS;
 	int loops = LOOPS;
@@ -66,7 +66,9 @@ static void usage(const char *name)
 	PRINT_MODULE_USAGE_PARAM_INT('p', -1, 1, 1000, "Poll timeout for UART in ms", true);
 	PRINT_MODULE_USAGE_PARAM_INT('l', 10000, -1, 100000, "Limit number of iterations until the program exits (-1=infinite)",
 				     true);
-	PRINT_MODULE_USAGE_PARAM_INT('w', 1, 1, 1000, "Time in ms for which each iteration sleeps", true);
+	PRINT_MODULE_USAGE_PARAM_INT('w', 1, 1, 1000, "Time in ms for which each iteration of the receiver sleeps", true);
+	PRINT_MODULE_USAGE_PARAM_INT('c', 0, 0, 1000,
+				     "Batching window in ms to send the topics published within it in one write (0=send on publication)", true);
 	PRINT_MODULE_USAGE_PARAM_INT('r', 2019, 0, 65536, "Select UDP Network Port for receiving (local)", true);
 	PRINT_MODULE_USAGE_PARAM_INT('s', 2020, 0, 65536, "Select UDP Network Port for sending (remote)", true);
 	PRINT_MODULE_USAGE_PARAM_STRING('i', "127.0.0.1", "<x.x.x.x>", "Select IP address (remote)", true);
@@ -81,7 +83,7 @@ static int parse_options(int argc, char *argv[])
 	int myoptind = 1;
 	const char *myoptarg = nullptr;
 
-	while ((ch = px4_getopt(argc, argv, "t:d:l:w:b:p:r:s:i:", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "t:d:l:w:c:b:p:r:s:i:", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 't': _options.transport      = strcmp(myoptarg, "UDP") == 0 ?
 							    options::eTransports::UDP
@@ -93,6 +95,8 @@ static int parse_options(int argc, char *argv[])
 
 		case 'w': _options.sleep_ms       = strtoul(myoptarg, nullptr, 10);     break;
 
+		case 'c': _options.batch_ms       = strtoul(myoptarg, nullptr, 10);     break;
+
 		case 'b': _options.baudrate       = strtoul(myoptarg, nullptr, 10);     break;
 
 		case 'r': _options.recv_port      = strtoul(myoptarg, nullptr, 10);     break;
@@ -215,6 +219,14 @@ int micrortps_client_main(int argc, char *argv[])
 
 		} else {
 			PX4_INFO("Running");
+
+			if (nullptr != transport_node) {
+				const Transport_node::Stats &stats = transport_node->get_stats();
+				PX4_INFO("sent: %" PRIu32 " messages in %" PRIu32 " writes, %" PRIu64 " bytes, %" PRIu32 " errors",
+					 stats.tx_messages, stats.tx_writes, stats.tx_bytes, stats.tx_errors);
+				PX4_INFO("received: %" PRIu32 " messages, %" PRIu64 " bytes, %" PRIu32 " CRC errors, %" PRIu32 " bytes dropped",
+					 stats.rx_messages, stats.rx_bytes, stats.rx_crc_errors, stats.rx_dropped_bytes);
+			}
 		}
 
 		return 0;
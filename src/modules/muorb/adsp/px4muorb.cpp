@@ -43,6 +43,7 @@
 #include <parameters/param.h>
 #include <px4_platform_common/shmem.h>
 #include <px4_platform_common/log.h>
+#include <string.h>
 
 __BEGIN_DECLS
 extern int dspal_main(int argc, char *argv[]);
@@ -79,76 +80,55 @@ int px4muorb_get_absolute_time(uint64_t *time_us)
 	return 0;
 }
 
-/*update value and param's change bit in shared memory*/
+/* update value and add the change to the krait journal */
 int px4muorb_param_update_to_shmem(uint32_t param, const uint8_t *value,
 				   int data_len_in_bytes)
 {
-	unsigned int byte_changed, bit_changed;
-	union param_value_u *param_value = (union param_value_u *) value;
-
 	if (!shmem_info_p) {
 		init_shared_memory();
 	}
 
-	if (get_shmem_lock(__FILE__, __LINE__) != 0) {
-		PX4_INFO("Could not get shmem lock\n");
+	if (!shmem_info_p || param >= MAX_SHMEM_PARAMS || data_len_in_bytes < (int)sizeof(union param_value_u)) {
 		return -1;
 	}
 
-	shmem_info_p->params_val[param] = *param_value;
-
-	byte_changed = param / 8;
-	bit_changed = 1 << param % 8;
-	shmem_info_p->krait_changed_index[byte_changed] |= bit_changed;
+	union param_value_u param_value;
+	memcpy(&param_value, value, sizeof(param_value));
 
-	release_shmem_lock(__FILE__, __LINE__);
+	param_journal_append(&shmem_info_p->krait_journal, param, param_value);
 
 	return 0;
 }
 
-int px4muorb_param_update_index_from_shmem(unsigned char *data, int data_len_in_bytes)
+int px4muorb_param_journal_read(uint32_t read_seq, uint8_t *data, int data_len_in_bytes, int *entry_count,
+				uint32_t *next_seq)
 {
 	if (!shmem_info_p) {
 		return -1;
 	}
 
-	if (get_shmem_lock(__FILE__, __LINE__) != 0) {
-		PX4_INFO("Could not get shmem lock\n");
-		return -1;
-	}
-
-	for (int i = 0; i < data_len_in_bytes; i++) {
-		data[i] = shmem_info_p->adsp_changed_index[i];
-	}
+	struct param_journal_entry_s *entries = (struct param_journal_entry_s *) data;
+	const int max_entries = data_len_in_bytes / (int)sizeof(struct param_journal_entry_s);
 
-	release_shmem_lock(__FILE__, __LINE__);
+	*entry_count = param_journal_read(&shmem_info_p->adsp_journal, &read_seq, entries, max_entries);
+	*next_seq = read_seq;
 
 	return 0;
 }
 
-int px4muorb_param_update_value_from_shmem(uint32_t param, const uint8_t *value,
-		int data_len_in_bytes)
+int px4muorb_param_read_values(uint32_t first_param, uint8_t *data, int data_len_in_bytes)
 {
-	unsigned int byte_changed, bit_changed;
-	union param_value_u *param_value = (union param_value_u *) value;
-
-	if (!shmem_info_p) {
+	if (!shmem_info_p || first_param >= MAX_SHMEM_PARAMS) {
 		return -1;
 	}
 
-	if (get_shmem_lock(__FILE__, __LINE__) != 0) {
-		PX4_INFO("Could not get shmem lock\n");
-		return -1;
-	}
+	unsigned count = data_len_in_bytes / sizeof(union param_value_u);
 
-	*param_value = shmem_info_p->params_val[param];
-
-	/*also clear the index since we are holding the lock*/
-	byte_changed = param / 8;
-	bit_changed = 1 << param % 8;
-	shmem_info_p->adsp_changed_index[byte_changed] &= ~bit_changed;
+	if (count > MAX_SHMEM_PARAMS - first_param) {
+		count = MAX_SHMEM_PARAMS - first_param;
+	}
 
-	release_shmem_lock(__FILE__, __LINE__);
+	memcpy(data, &shmem_info_p->params_val[first_param], count * sizeof(union param_value_u));
 
 	return 0;
 }
@@ -187,7 +167,7 @@ int px4muorb_topic_unadvertised(const char *topic_name)
 	return rc;
 }
 
-int px4muorb_add_subscriber(const char *name)
+int px4muorb_add_subscriber(const char *name, int rate_hz)
 {
 	int rc = 0;
 	uORB::FastRpcChannel *channel = uORB::FastRpcChannel::GetInstance();
@@ -195,7 +175,7 @@ int px4muorb_add_subscriber(const char *name)
 	uORBCommunicator::IChannelRxHandler *rxHandler = channel->GetRxHandler();
 
 	if (rxHandler != nullptr) {
-		rc = rxHandler->process_add_subscription(name, 0);
+		rc = rxHandler->process_add_subscription(name, rate_hz);
 
 		if (rc != OK) {
 			channel->RemoveRemoteSubscriber(name);
@@ -243,6 +223,12 @@ int px4muorb_send_topic_data(const char *name, const uint8_t *data,
 	return rc;
 }
 
+int px4muorb_send_bulk_data(const uint8_t *data, int data_len_in_bytes, int topic_count)
+{
+	uORB::FastRpcChannel *channel = uORB::FastRpcChannel::GetInstance();
+	return channel->process_bulk_data(data, data_len_in_bytes, topic_count);
+}
+
 int px4muorb_is_subscriber_present(const char *topic_name, int *status)
 {
 	int rc = 0;
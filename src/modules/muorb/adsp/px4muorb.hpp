@@ -44,20 +44,23 @@ extern "C" {
 
 	int px4muorb_param_update_to_shmem(uint32_t param, const uint8_t *value, int data_len_in_bytes) __EXPORT;
 
-	int px4muorb_param_update_index_from_shmem(unsigned char *data, int data_len_in_bytes) __EXPORT;
+	int px4muorb_param_journal_read(uint32_t read_seq, uint8_t *data, int data_len_in_bytes, int *entry_count,
+					uint32_t *next_seq) __EXPORT;
 
-	int px4muorb_param_update_value_from_shmem(uint32_t param, const uint8_t *value, int data_len_in_bytes) __EXPORT;
+	int px4muorb_param_read_values(uint32_t first_param, uint8_t *data, int data_len_in_bytes) __EXPORT;
 
 	int px4muorb_topic_advertised(const char *name) __EXPORT;
 
 	int px4muorb_topic_unadvertised(const char *name) __EXPORT;
 
-	int px4muorb_add_subscriber(const char *name) __EXPORT;
+	int px4muorb_add_subscriber(const char *name, int rate_hz) __EXPORT;
 
 	int px4muorb_remove_subscriber(const char *name) __EXPORT;
 
 	int px4muorb_send_topic_data(const char *name, const uint8_t *data, int data_len_in_bytes) __EXPORT;
 
+	int px4muorb_send_bulk_data(const uint8_t *data, int data_len_in_bytes, int topic_count) __EXPORT;
+
 	int px4muorb_is_subscriber_present(const char *topic_name, int *status) __EXPORT;
 
 	int px4muorb_receive_msg(int *msg_type, char *topic_name, int topic_name_len, uint8_t *data, int data_len_in_bytes,
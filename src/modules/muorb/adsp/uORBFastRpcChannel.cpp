@@ -615,6 +615,48 @@ int16_t uORB::FastRpcChannel::get_bulk_data
 	return rc;
 }
 
+int16_t uORB::FastRpcChannel::process_bulk_data(const uint8_t *buffer, int32_t length_in_bytes, int32_t topic_count)
+{
+	if (_RxHandler == nullptr) {
+		return -1;
+	}
+
+	int32_t bytes_processed = 0;
+
+	for (int32_t i = 0; i < topic_count; ++i) {
+		if (bytes_processed + (int32_t)sizeof(struct BulkTransferHeader) > length_in_bytes) {
+			PX4_ERR("[process_bulk_data] Error: truncated header of topic %ld/%ld", i, topic_count);
+			return -1;
+		}
+
+		struct BulkTransferHeader header;
+		memcpy(&header, &buffer[bytes_processed], sizeof(header));
+
+		const int32_t packet_length = sizeof(struct BulkTransferHeader) + header._MsgNameLen + header._DataLen;
+
+		if ((header._MsgNameLen == 0) || (bytes_processed + packet_length > length_in_bytes)) {
+			PX4_ERR("[process_bulk_data] Error: truncated topic %ld/%ld", i, topic_count);
+			return -1;
+		}
+
+		const char *messageName = (const char *)&buffer[bytes_processed + sizeof(struct BulkTransferHeader)];
+
+		if (messageName[header._MsgNameLen - 1] != '\0') {
+			PX4_ERR("[process_bulk_data] Error: invalid topic name of topic %ld/%ld", i, topic_count);
+			return -1;
+		}
+
+		if (header._MsgType == _DATA_MSG_TYPE) {
+			uint8_t *data = (uint8_t *)&buffer[bytes_processed + sizeof(struct BulkTransferHeader) + header._MsgNameLen];
+			_RxHandler->process_received_message(messageName, header._DataLen, data);
+		}
+
+		bytes_processed += packet_length;
+	}
+
+	return 0;
+}
+
 int32_t uORB::FastRpcChannel::get_msg_size_at(bool isData, int32_t index)
 {
 	// the assumption here is that this is called within the context of semaphore,
@@ -153,6 +153,9 @@ public:
 
 	int16_t get_bulk_data(uint8_t *buffer, int32_t max_size_in_bytes, int32_t *returned_bytes, int32_t *topic_count);
 
+	// function to pass the topic data of a bulk transfer from krait to the rx handler.
+	int16_t process_bulk_data(const uint8_t *buffer, int32_t length_in_bytes, int32_t topic_count);
+
 	// function to check if there are subscribers for a topic on adsp.
 	int16_t is_subscriber_present(const char *messageName, int32_t *status);
 
@@ -67,7 +67,10 @@ static const uint32_t _MAX_BULK_TRANSFER_BUFFER_SIZE =
 	_MAX_TOPIC_DATA_BUFFER_SIZE * _MAX_TOPICS;
 static uint8_t *_BulkTransferBuffer = 0;
 
-unsigned char *adsp_changed_index = 0;
+// double buffered batches of topic data sent to the adsp
+static uint8_t *_SendBulkBuffer[2] = {0, 0};
+
+unsigned char *param_journal_buffer = 0;
 
 // The DSP timer can be read from this file.
 #define DSP_TIMER_FILE "/sys/kernel/boot_adsp/qdsp_qtimer"
@@ -170,6 +173,17 @@ bool px4muorb::KraitRpcWrapper::Initialize()
 			__FUNCTION__, (_MAX_BULK_TRANSFER_BUFFER_SIZE * sizeof(uint8_t)), _BulkTransferBuffer);
 	}
 
+	for (int i = 0; i < 2; i++) {
+		_SendBulkBuffer[i] = (uint8_t *) rpcmem_alloc(MUORB_KRAIT_FASTRPC_HEAP_ID,
+				     MUORB_KRAIT_FASTRPC_MEM_FLAGS,
+				     SEND_BULK_BUFFER_SIZE * sizeof(uint8_t));
+
+		if (_SendBulkBuffer[i] == NULL) {
+			// not fatal, the topic data is sent one topic at a time
+			PX4_WARN("%s rpcmem_alloc failed! for send bulk transfer buffers", __FUNCTION__);
+		}
+	}
+
 	_TopicNameBuffer = (char *) rpcmem_alloc(MUORB_KRAIT_FASTRPC_HEAP_ID,
 			   MUORB_KRAIT_FASTRPC_MEM_FLAGS,
 			   _MAX_TOPIC_NAME_BUFFER * sizeof(char));
@@ -204,16 +218,16 @@ bool px4muorb::KraitRpcWrapper::Initialize()
 		PX4_DEBUG("%s rpcmem_alloc passed for data_buffer", __FUNCTION__);
 	}
 
-	adsp_changed_index = (uint8_t *) rpcmem_alloc(MUORB_KRAIT_FASTRPC_HEAP_ID,
+	param_journal_buffer = (uint8_t *) rpcmem_alloc(MUORB_KRAIT_FASTRPC_HEAP_ID,
 			     MUORB_KRAIT_FASTRPC_MEM_FLAGS, PARAM_BUFFER_SIZE * sizeof(uint8_t));
 
-	rc = (adsp_changed_index != NULL) ? true : false;
+	rc = (param_journal_buffer != NULL) ? true : false;
 
 	if (!rc) {
-		PX4_ERR("%s rpcmem_alloc failed! for adsp_changed_index", __FUNCTION__);
+		PX4_ERR("%s rpcmem_alloc failed! for param_journal_buffer", __FUNCTION__);
 
 	} else {
-		memset(adsp_changed_index, 0, PARAM_BUFFER_SIZE * sizeof(uint8_t));
+		memset(param_journal_buffer, 0, PARAM_BUFFER_SIZE * sizeof(uint8_t));
 	}
 
 	int32_t time_diff_us;
@@ -255,6 +269,13 @@ bool px4muorb::KraitRpcWrapper::Terminate()
 		_BulkTransferBuffer = 0;
 	}
 
+	for (int i = 0; i < 2; i++) {
+		if (_SendBulkBuffer[i] != NULL) {
+			rpcmem_free(_SendBulkBuffer[i]);
+			_SendBulkBuffer[i] = 0;
+		}
+	}
+
 	if (_TopicNameBuffer != NULL) {
 		rpcmem_free(_TopicNameBuffer);
 		_TopicNameBuffer = 0;
@@ -265,9 +286,9 @@ bool px4muorb::KraitRpcWrapper::Terminate()
 		_DataBuffer = 0;
 	}
 
-	if (adsp_changed_index != NULL) {
-		rpcmem_free(adsp_changed_index);
-		adsp_changed_index = 0;
+	if (param_journal_buffer != NULL) {
+		rpcmem_free(param_journal_buffer);
+		param_journal_buffer = 0;
 	}
 
 	_Initialized = false;
@@ -284,9 +305,9 @@ int32_t px4muorb::KraitRpcWrapper::TopicUnadvertised(const char *topic)
 	return ((_Initialized) ? px4muorb_topic_unadvertised(topic) : -1);
 }
 
-int32_t px4muorb::KraitRpcWrapper::AddSubscriber(const char *topic)
+int32_t px4muorb::KraitRpcWrapper::AddSubscriber(const char *topic, int32_t rate_hz)
 {
-	return ((_Initialized) ? px4muorb_add_subscriber(topic) : -1);
+	return ((_Initialized) ? px4muorb_add_subscriber(topic, rate_hz) : -1);
 }
 
 int32_t px4muorb::KraitRpcWrapper::RemoveSubscriber(const char *topic)
@@ -307,6 +328,18 @@ int32_t px4muorb::KraitRpcWrapper::SendData(const char *topic,
 		px4muorb_send_topic_data(topic, data, length_in_bytes) : -1);
 }
 
+int32_t px4muorb::KraitRpcWrapper::SendBulkData(const uint8_t *bulk_data,
+		int32_t length_in_bytes, int32_t topic_count)
+{
+	return (_Initialized ?
+		px4muorb_send_bulk_data(bulk_data, length_in_bytes, topic_count) : -1);
+}
+
+uint8_t *px4muorb::KraitRpcWrapper::GetSendBulkBuffer(int index)
+{
+	return ((_Initialized && index >= 0 && index < 2) ? _SendBulkBuffer[index] : nullptr);
+}
+
 int32_t px4muorb::KraitRpcWrapper::ReceiveData(int32_t *msg_type, char **topic,
 		int32_t *length_in_bytes, uint8_t **data)
 {
@@ -67,12 +67,20 @@ public:
 	 */
 	int32_t TopicAdvertised(const char *topic);
 	int32_t TopicUnadvertised(const char *topic);
-	int32_t AddSubscriber(const char *topic);
+	int32_t AddSubscriber(const char *topic, int32_t rate_hz);
 	int32_t RemoveSubscriber(const char *topic);
 	int32_t SendData(const char *topic, int32_t length_in_bytes, const uint8_t *data);
+	int32_t SendBulkData(const uint8_t *bulk_data, int32_t length_in_bytes, int32_t topic_count);
 	int32_t ReceiveData(int32_t *msg_type, char **topic, int32_t *length_in_bytes, uint8_t **data);
 	int32_t IsSubscriberPresent(const char *topic, int32_t *status);
 	int32_t ReceiveBulkData(uint8_t **bulk_data, int32_t *length_in_bytes, int32_t *topic_count);
 	int32_t UnblockReceiveData();
+
+	/**
+	 * Shared memory buffers (0 or 1) for SendBulkData(), nullptr if not initialized
+	 */
+	uint8_t *GetSendBulkBuffer(int index);
+
+	static const int32_t SEND_BULK_BUFFER_SIZE = 64 * 1024;
 };
 #endif // _px4muorb_KraitWrapper_hpp_
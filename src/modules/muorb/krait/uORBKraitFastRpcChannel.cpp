@@ -66,6 +66,12 @@ uORB::KraitFastRpcChannel::KraitFastRpcChannel() :
 	_ThreadShouldExit(false)
 {
 	_KraitWrapper.Initialize();
+
+	pthread_mutex_init(&_SendMutex, nullptr);
+	pthread_cond_init(&_SendCond, nullptr);
+
+	_SendBuffer[0] = _KraitWrapper.GetSendBulkBuffer(0);
+	_SendBuffer[1] = _KraitWrapper.GetSendBulkBuffer(1);
 }
 
 int16_t uORB::KraitFastRpcChannel::topic_advertised(const char *messageName)
@@ -90,7 +96,7 @@ int16_t uORB::KraitFastRpcChannel::add_subscription(const char *messageName, int
 {
 	int16_t rc = 0;
 	//PX4_DEBUG("Before calling AddSubscriber for [%s]\n", messageName);
-	rc = _KraitWrapper.AddSubscriber(messageName);
+	rc = _KraitWrapper.AddSubscriber(messageName, msgRateInHz);
 	//PX4_DEBUG("Response for AddSubscriber for [%s], rc[%d]\n", messageName, rc);
 	return rc;
 }
@@ -137,7 +143,7 @@ int16_t uORB::KraitFastRpcChannel::send_message(const char *messageName, int32_t
 
 	if (_AdspSubscriberCache[messageName] > 0) {// there are remote subscribers
 		t2 = hrt_absolute_time();
-		rc = _KraitWrapper.SendData(messageName, length, data);
+		rc = queue_message(messageName, length, data);
 		t3 = hrt_absolute_time();
 		_snd_msg_count++;
 		//PX4_DEBUG( "***** SENDING[%s] topic to remote....\n", messageName.c_str() );
@@ -184,6 +190,37 @@ int16_t uORB::KraitFastRpcChannel::send_message(const char *messageName, int32_t
 	return rc;
 }
 
+int16_t uORB::KraitFastRpcChannel::queue_message(const char *messageName, int32_t length, uint8_t *data)
+{
+	const int32_t name_length = strlen(messageName) + 1;
+	const int32_t packet_length = sizeof(struct BulkTransferHeader) + name_length + length;
+
+	pthread_mutex_lock(&_SendMutex);
+
+	uint8_t *buffer = _SendBuffer[_SendBufferIndex];
+
+	if (!_SendThreadStarted || (buffer == nullptr)
+	    || (_SendLength + packet_length > px4muorb::KraitRpcWrapper::SEND_BULK_BUFFER_SIZE)) {
+		pthread_mutex_unlock(&_SendMutex);
+
+		// no batching or the batch is full (RPC still in progress): send this update on its own
+		return _KraitWrapper.SendData(messageName, length, data);
+	}
+
+	struct BulkTransferHeader header = { (uint16_t)_DATA_MSG_TYPE, (uint16_t)name_length, (uint16_t)length };
+	memcpy(&buffer[_SendLength], &header, sizeof(header));
+	memcpy(&buffer[_SendLength + sizeof(header)], messageName, name_length);
+	memcpy(&buffer[_SendLength + sizeof(header) + name_length], data, length);
+
+	_SendLength += packet_length;
+	_SendTopicCount++;
+
+	pthread_cond_signal(&_SendCond);
+	pthread_mutex_unlock(&_SendMutex);
+
+	return 0;
+}
+
 void uORB::KraitFastRpcChannel::Start()
 {
 	_ThreadStarted = true;
@@ -205,6 +242,20 @@ void uORB::KraitFastRpcChannel::Start()
 		pthread_setname_np(_RecvThread, "muorb_krait_receiver");
 	}
 
+	if ((_SendBuffer[0] != nullptr) && (_SendBuffer[1] != nullptr)) {
+		pthread_mutex_lock(&_SendMutex);
+
+		if (pthread_create(&_SendThread, &recv_thread_attr, send_thread_start, (void *)this) != 0) {
+			PX4_ERR("Error creating the send thread for muorb");
+
+		} else {
+			pthread_setname_np(_SendThread, "muorb_krait_sender");
+			_SendThreadStarted = true;
+		}
+
+		pthread_mutex_unlock(&_SendMutex);
+	}
+
 	pthread_attr_destroy(&recv_thread_attr);
 }
 
@@ -215,6 +266,17 @@ void uORB::KraitFastRpcChannel::Stop()
 	//PX4_DEBUG("After calling UnblockReceiveData()...\n");
 	pthread_join(_RecvThread, NULL);
 	//PX4_DEBUG("*** After calling pthread_join...\n");
+
+	pthread_mutex_lock(&_SendMutex);
+	const bool send_thread_started = _SendThreadStarted;
+	_SendThreadStarted = false;
+	pthread_cond_signal(&_SendCond);
+	pthread_mutex_unlock(&_SendMutex);
+
+	if (send_thread_started) {
+		pthread_join(_SendThread, NULL);
+	}
+
 	_ThreadStarted = false;
 }
 
@@ -227,6 +289,48 @@ void  *uORB::KraitFastRpcChannel::thread_start(void *handler)
 	return 0;
 }
 
+void  *uORB::KraitFastRpcChannel::send_thread_start(void *handler)
+{
+	if (handler != nullptr) {
+		((uORB::KraitFastRpcChannel *)handler)->fastrpc_send_thread();
+	}
+
+	return 0;
+}
+
+void uORB::KraitFastRpcChannel::fastrpc_send_thread()
+{
+	pthread_mutex_lock(&_SendMutex);
+
+	while (_SendThreadStarted) {
+		if (_SendTopicCount == 0) {
+			pthread_cond_wait(&_SendCond, &_SendMutex);
+			continue;
+		}
+
+		// swap the buffers, the updates published during the RPC are batched in the other one
+		uint8_t *buffer = _SendBuffer[_SendBufferIndex];
+		const int32_t length = _SendLength;
+		const int32_t topic_count = _SendTopicCount;
+
+		_SendBufferIndex = 1 - _SendBufferIndex;
+		_SendLength = 0;
+		_SendTopicCount = 0;
+
+		pthread_mutex_unlock(&_SendMutex);
+
+		if (_KraitWrapper.SendBulkData(buffer, length, topic_count) != 0) {
+			PX4_ERR("Error sending %d topics over fastRPC channel", topic_count);
+		}
+
+		pthread_mutex_lock(&_SendMutex);
+	}
+
+	pthread_mutex_unlock(&_SendMutex);
+
+	PX4_DEBUG("[uORB::KraitFastRpcChannel::fastrpc_send_thread] Exiting fastrpc_send_thread\n");
+}
+
 void uORB::KraitFastRpcChannel::fastrpc_recv_thread()
 {
 	// sit in while loop.
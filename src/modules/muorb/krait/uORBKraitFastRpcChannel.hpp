@@ -178,6 +178,18 @@ private: // data members
 
 	px4muorb::KraitRpcWrapper _KraitWrapper;
 
+	// Topic data sent to the adsp is batched: send_message() packs the updates into one of two
+	// shared buffers while the send thread transfers the other one with a single RPC, so all the
+	// updates published during an RPC go out together with the next one.
+	pthread_t _SendThread;
+	bool _SendThreadStarted{false};
+	pthread_mutex_t _SendMutex;
+	pthread_cond_t _SendCond;
+	uint8_t *_SendBuffer[2] {nullptr, nullptr};
+	int32_t _SendBufferIndex{0};	///< buffer being filled by send_message()
+	int32_t _SendLength{0};
+	int32_t _SendTopicCount{0};
+
 	std::map<std::string, int32_t> _AdspSubscriberCache;
 	std::map<std::string, hrt_abstime> _AdspSubscriberSampleTimestamp;
 	//hrt_abstime  _SubCacheSampleTimestamp;
@@ -188,8 +200,12 @@ private://class members.
 	KraitFastRpcChannel();
 
 	static void  *thread_start(void *handler);
+	static void  *send_thread_start(void *handler);
 
 	void fastrpc_recv_thread();
+	void fastrpc_send_thread();
+
+	int16_t queue_message(const char *messageName, int32_t length, uint8_t *data);
 
 };
 
@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBShmChannel.hpp"
+
+#include <px4_platform_common/log.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+uORB::ShmChannel *uORB::ShmChannel::_InstancePtr = nullptr;
+
+uORB::ShmChannel::~ShmChannel()
+{
+	Stop();
+}
+
+int uORB::ShmChannel::Start()
+{
+	if (_header != nullptr) {
+		return 0;
+	}
+
+	for (auto &local : _lookup) {
+		pthread_mutex_init(&local.write_lock, nullptr);
+	}
+
+	// start from a fresh segment, readers re-map on a changed magic/version
+	shm_unlink(UORB_SHM_NAME);
+	_fd = shm_open(UORB_SHM_NAME, O_CREAT | O_RDWR, 0644);
+
+	if (_fd < 0) {
+		PX4_ERR("shm_open failed (%i)", errno);
+		return -errno;
+	}
+
+	if (ftruncate(_fd, UORB_SHM_SIZE) != 0) {
+		PX4_ERR("ftruncate failed (%i)", errno);
+		close(_fd);
+		_fd = -1;
+		return -errno;
+	}
+
+	void *mem = mmap(nullptr, UORB_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+
+	if (mem == MAP_FAILED) {
+		PX4_ERR("mmap failed (%i)", errno);
+		close(_fd);
+		_fd = -1;
+		return -errno;
+	}
+
+	_header = static_cast<uorb_shm_header_s *>(mem);
+	memset(_header, 0, sizeof(uorb_shm_header_s));
+	_header->version = UORB_SHM_VERSION;
+	_header->segment_size = UORB_SHM_SIZE;
+	_header->data_used = sizeof(uorb_shm_header_s);
+	__atomic_store_n(&_header->magic, UORB_SHM_MAGIC, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+void uORB::ShmChannel::Stop()
+{
+	if (_header != nullptr) {
+		// publishers might still be writing: keep the mapping, only remove the name
+		shm_unlink(UORB_SHM_NAME);
+	}
+}
+
+void uORB::ShmChannel::print_status()
+{
+	if (_header == nullptr) {
+		PX4_INFO("not running");
+		return;
+	}
+
+	PX4_INFO("segment: %s, %u topics, %u/%u bytes used", UORB_SHM_NAME, (unsigned)_header->num_topics,
+		 (unsigned)_header->data_used, (unsigned)_header->segment_size);
+	PX4_INFO("dropped messages: %u", (unsigned)__atomic_load_n(&_dropped, __ATOMIC_RELAXED));
+}
+
+uORB::ShmChannel::LocalTopic *uORB::ShmChannel::find_or_add_topic(const char *messageName, int32_t length)
+{
+	const unsigned hash = (unsigned)(((uintptr_t)messageName >> 3) % LOOKUP_SIZE);
+
+	// lock-free lookup, entries are never removed
+	for (unsigned i = 0; i < LOOKUP_SIZE; i++) {
+		LocalTopic &local = _lookup[(hash + i) % LOOKUP_SIZE];
+		const char *name = __atomic_load_n(&local.name, __ATOMIC_ACQUIRE);
+
+		if (name == messageName) {
+			return &local;
+
+		} else if (name == nullptr) {
+			break;
+		}
+	}
+
+	pthread_mutex_lock(&_add_lock);
+
+	LocalTopic *found = nullptr;
+
+	for (unsigned i = 0; i < LOOKUP_SIZE; i++) {
+		LocalTopic &local = _lookup[(hash + i) % LOOKUP_SIZE];
+
+		if (local.name == messageName) {
+			// added concurrently
+			found = &local;
+			break;
+
+		} else if (local.name == nullptr) {
+			const uint32_t index = _header->num_topics;
+			const uint32_t slots_size = (uint32_t)length * UORB_SHM_SLOTS;
+
+			if ((index >= UORB_SHM_MAX_TOPICS) || (_header->data_used + slots_size > _header->segment_size)) {
+				if (!_full_warned) {
+					PX4_WARN("segment full, not exporting %s", messageName);
+					_full_warned = true;
+				}
+
+				break;
+			}
+
+			uorb_shm_topic_s *topic = &_header->topics[index];
+			strncpy(topic->name, messageName, sizeof(topic->name) - 1);
+			topic->size = length;
+			topic->data_offset = _header->data_used;
+
+			// keep the slots 8-byte aligned
+			_header->data_used += (slots_size + 7) & ~7u;
+
+			// make the entry visible to readers
+			__atomic_store_n(&_header->num_topics, index + 1, __ATOMIC_RELEASE);
+
+			local.topic = topic;
+			__atomic_store_n(&local.name, messageName, __ATOMIC_RELEASE);
+			found = &local;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&_add_lock);
+
+	return found;
+}
+
+int16_t uORB::ShmChannel::send_message(const char *messageName, int32_t length, uint8_t *data)
+{
+	if ((_header == nullptr) || (messageName == nullptr) || (data == nullptr) || (length <= 0)) {
+		return -1;
+	}
+
+	LocalTopic *local = find_or_add_topic(messageName, length);
+
+	if ((local == nullptr) || (local->topic->size != (uint32_t)length)) {
+		// the segment is only a mirror: drop the message, but never fail the local publication
+		__atomic_fetch_add(&_dropped, 1, __ATOMIC_RELAXED);
+		return 0;
+	}
+
+	uorb_shm_topic_s *topic = local->topic;
+
+	pthread_mutex_lock(&local->write_lock);
+
+	const uint32_t generation = topic->generation;
+	const uint32_t slot = generation % UORB_SHM_SLOTS;
+
+	// mark the slot as being written, then publish the generation so that readers wait for it
+	__atomic_store_n(&topic->slot_sequence[slot], 2 * generation + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&topic->generation, generation + 1, __ATOMIC_RELEASE);
+
+	memcpy((uint8_t *)_header + topic->data_offset + slot * topic->size, data, length);
+
+	__atomic_store_n(&topic->slot_sequence[slot], 2 * generation + 2, __ATOMIC_RELEASE);
+
+	pthread_mutex_unlock(&local->write_lock);
+
+	return 0;
+}
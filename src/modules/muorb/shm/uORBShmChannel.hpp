@@ -0,0 +1,124 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBShmChannel.hpp
+ *
+ * uORB communicator channel exporting all published topics into a POSIX shared memory segment.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include <uORB/uORBCommunicator.hpp>
+
+#include "uORBShmLayout.h"
+
+namespace uORB
+{
+
+class ShmChannel : public uORBCommunicator::IChannel
+{
+public:
+	static ShmChannel *GetInstance()
+	{
+		if (_InstancePtr == nullptr) {
+			_InstancePtr = new ShmChannel();
+		}
+
+		return _InstancePtr;
+	}
+
+	static bool isInstance() { return (_InstancePtr != nullptr); }
+
+	/**
+	 * Create and map the shared memory segment.
+	 * @return 0 on success, negative errno otherwise
+	 */
+	int Start();
+	void Stop();
+
+	void print_status();
+
+	// remote processes only read from the segment, so there is nothing to notify
+	int16_t topic_advertised(const char *messageName) override { return 0; }
+	int16_t add_subscription(const char *messageName, int32_t msgRateInHz) override { return 0; }
+	int16_t remove_subscription(const char *messageName) override { return 0; }
+
+	int16_t register_handler(uORBCommunicator::IChannelRxHandler *handler) override
+	{
+		_RxHandler = handler;
+		return 0;
+	}
+
+	/**
+	 * Write a published message into the segment (called by uORB on every publication).
+	 * Messages that do not fit into the segment are dropped and counted.
+	 * @return 0, unless the channel is not started or the arguments are invalid
+	 */
+	int16_t send_message(const char *messageName, int32_t length, uint8_t *data) override;
+
+private:
+	ShmChannel() = default;
+	~ShmChannel();
+
+	/**
+	 * Process-local lookup entry. The key is the topic name pointer (orb_metadata::o_name), which is
+	 * unique and constant for each topic.
+	 */
+	struct LocalTopic {
+		const char *name{nullptr};
+		uorb_shm_topic_s *topic{nullptr};
+		pthread_mutex_t write_lock; ///< serializes publishers of the same topic
+	};
+
+	static constexpr int LOOKUP_SIZE = UORB_SHM_MAX_TOPICS * 2; ///< open addressing, at most half full
+
+	LocalTopic *find_or_add_topic(const char *messageName, int32_t length);
+
+	static ShmChannel *_InstancePtr;
+
+	uORBCommunicator::IChannelRxHandler *_RxHandler{nullptr};
+
+	int _fd{-1};
+	uorb_shm_header_s *_header{nullptr};
+
+	pthread_mutex_t _add_lock = PTHREAD_MUTEX_INITIALIZER; ///< protects adding topics
+	LocalTopic _lookup[LOOKUP_SIZE] {};
+	bool _full_warned{false};
+	uint32_t _dropped{0}; ///< messages not exported (segment full or size mismatch)
+};
+
+} // namespace uORB
@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBShmLayout.h
+ *
+ * Layout of the POSIX shared memory segment used to export uORB topics to other processes.
+ *
+ * The segment is created and written by PX4 only. Readers in other processes map it read-only and
+ * copy messages with uorb_shm_copy(). Messages are stored as the raw uORB structs (no serialization),
+ * so readers need the generated uORB headers of the same firmware version (check the topic size).
+ *
+ * This header is self-contained so that it can be used outside of the PX4 build.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#define UORB_SHM_NAME		"/px4_uorb"
+#define UORB_SHM_MAGIC		0x424f5850	/* "PXOB" */
+#define UORB_SHM_VERSION	1
+#define UORB_SHM_MAX_TOPICS	256
+#define UORB_SHM_NAME_LEN	64
+#define UORB_SHM_SLOTS		4		/* number of buffered messages per topic */
+#define UORB_SHM_SIZE		(2 * 1024 * 1024)
+
+/**
+ * Topic entry. All fields except generation and slot_sequence are constant once the entry is
+ * visible (i.e. its index is below uorb_shm_header_s::num_topics).
+ */
+struct uorb_shm_topic_s {
+	char name[UORB_SHM_NAME_LEN];		/**< topic name */
+	uint32_t size;				/**< message size in bytes */
+	uint32_t data_offset;			/**< offset of the slots from the segment start */
+	uint32_t generation;			/**< number of messages published */
+	uint32_t slot_sequence[UORB_SHM_SLOTS];	/**< 2 * generation + 2 once slot holds generation, odd while written */
+};
+
+struct uorb_shm_header_s {
+	uint32_t magic;				/**< UORB_SHM_MAGIC */
+	uint32_t version;			/**< UORB_SHM_VERSION */
+	uint32_t segment_size;			/**< total mapped size */
+	uint32_t num_topics;			/**< number of valid entries in topics */
+	uint32_t data_used;			/**< bytes used in the data area */
+	struct uorb_shm_topic_s topics[UORB_SHM_MAX_TOPICS];
+};
+
+/**
+ * Find a topic by name.
+ * @return the topic entry, or NULL if it was not published yet
+ */
+static inline const struct uorb_shm_topic_s *uorb_shm_find(const struct uorb_shm_header_s *header, const char *name)
+{
+	const uint32_t num_topics = __atomic_load_n(&header->num_topics, __ATOMIC_ACQUIRE);
+
+	for (uint32_t i = 0; i < num_topics && i < UORB_SHM_MAX_TOPICS; i++) {
+		if (strncmp(header->topics[i].name, name, UORB_SHM_NAME_LEN) == 0) {
+			return &header->topics[i];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Copy the next message of a topic.
+ * @param header the mapped segment
+ * @param topic the topic entry (from uorb_shm_find())
+ * @param dst destination buffer of topic->size bytes
+ * @param generation the generation of the next message to read (updated, start with 0).
+ *        If the reader fell behind by more than UORB_SHM_SLOTS, it skips to the oldest buffered message.
+ * @return 1 if a message was copied, 0 if there is no new message
+ */
+static inline int uorb_shm_copy(const struct uorb_shm_header_s *header, const struct uorb_shm_topic_s *topic,
+				void *dst, uint32_t *generation)
+{
+	for (int attempt = 0; attempt < 10; attempt++) {
+		const uint32_t published = __atomic_load_n(&topic->generation, __ATOMIC_ACQUIRE);
+
+		if (published == *generation) {
+			return 0;
+		}
+
+		uint32_t read_generation = *generation;
+
+		if (published - read_generation > UORB_SHM_SLOTS) {
+			read_generation = published - UORB_SHM_SLOTS;
+		}
+
+		const uint32_t slot = read_generation % UORB_SHM_SLOTS;
+		const uint32_t expected_sequence = 2 * read_generation + 2;
+
+		if (__atomic_load_n(&topic->slot_sequence[slot], __ATOMIC_ACQUIRE) != expected_sequence) {
+			// still being written (or already overwritten), retry
+			continue;
+		}
+
+		memcpy(dst, (const uint8_t *)header + topic->data_offset + slot * topic->size, topic->size);
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		if (__atomic_load_n(&topic->slot_sequence[slot], __ATOMIC_RELAXED) == expected_sequence) {
+			*generation = read_generation + 1;
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <string.h>
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/module.h>
+#include <uORB/uORBManager.hpp>
+
+#include "uORBShmChannel.hpp"
+
+extern "C" { __EXPORT int uorb_shm_main(int argc, char *argv[]); }
+
+static void usage()
+{
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+Exports all uORB topics into the POSIX shared memory segment `/px4_uorb`, so that other processes on
+the same system (e.g. perception or logging) can read them without serialization or sockets.
+
+### Implementation
+The module registers as uORB communicator channel, which requires a build with `ORB_COMMUNICATOR`.
+Each publication is copied into a small per-topic ring in the segment protected by per-slot sequence
+counters. External readers map the segment read-only and use `uorb_shm_copy()` from `uORBShmLayout.h`.
+Only one communicator channel can be active (it cannot be used together with muorb).
+Topic instances are not distinguished.
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME("uorb_shm", "communication");
+	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_COMMAND("stop");
+	PRINT_MODULE_USAGE_COMMAND("status");
+}
+
+int uorb_shm_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage();
+		return -EINVAL;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+		if (uORB::ShmChannel::isInstance()) {
+			PX4_WARN("already running");
+			return 0;
+		}
+
+		uORB::ShmChannel *channel = uORB::ShmChannel::GetInstance();
+
+		if (channel == nullptr) {
+			return -ENOMEM;
+		}
+
+		int ret = channel->Start();
+
+		if (ret != 0) {
+			return ret;
+		}
+
+		uORB::Manager::get_instance()->set_uorb_communicator(channel);
+		return 0;
+	}
+
+	if (!strcmp(argv[1], "stop")) {
+		if (uORB::ShmChannel::isInstance()) {
+			uORB::Manager::get_instance()->set_uorb_communicator(nullptr);
+			uORB::ShmChannel::GetInstance()->Stop();
+
+		} else {
+			PX4_WARN("not running");
+		}
+
+		return 0;
+	}
+
+	if (!strcmp(argv[1], "status")) {
+		if (uORB::ShmChannel::isInstance()) {
+			uORB::ShmChannel::GetInstance()->print_status();
+
+		} else {
+			PX4_INFO("not running");
+		}
+
+		return 0;
+	}
+
+	usage();
+	return -EINVAL;
+}
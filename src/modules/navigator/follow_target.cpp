@@ -65,11 +65,9 @@ FollowTarget::FollowTarget(Navigator *navigator) :
 	ModuleParams(navigator)
 {
 	_current_vel.zero();
-	_step_vel.zero();
 	_est_target_vel.zero();
 	_target_distance.zero();
 	_target_position_offset.zero();
-	_target_position_delta.zero();
 }
 
 void FollowTarget::on_inactive()
@@ -81,8 +79,6 @@ void FollowTarget::on_activation()
 {
 	_follow_offset = _param_nav_ft_dst.get() < 1.0F ? 1.0F : _param_nav_ft_dst.get();
 
-	_responsiveness = math::constrain((float) _param_nav_ft_rs.get(), .1F, 1.0F);
-
 	_follow_target_position = _param_nav_ft_fs.get();
 
 	if ((_follow_target_position > FOLLOW_FROM_LEFT) || (_follow_target_position < FOLLOW_FROM_RIGHT)) {
@@ -100,30 +96,21 @@ void FollowTarget::on_active()
 	bool _radius_entered = false;
 	bool _radius_exited = false;
 	bool updated = false;
-	float dt_ms = 0;
-
-	if (_follow_target_sub.updated()) {
-		follow_target_s target_motion;
-
-		_target_updates++;
-
-		// save last known motion topic
 
-		_previous_target_motion = _current_target_motion;
+	if (_follow_target_estimator_sub.updated()) {
+		follow_target_estimator_s target_estimate;
+		_follow_target_estimator_sub.copy(&target_estimate);
 
-		_follow_target_sub.copy(&target_motion);
+		if (target_estimate.valid) {
+			_target_estimate = target_estimate;
+			updated = true;
 
-		if (_current_target_motion.timestamp == 0) {
-			_current_target_motion = target_motion;
+		} else if (target_position_valid()) {
+			// the estimator timed out
+			reset_target_validity();
 		}
 
-		_current_target_motion.timestamp = target_motion.timestamp;
-		_current_target_motion.lat = (_current_target_motion.lat * (double)_responsiveness) + target_motion.lat * (double)(
-						     1 - _responsiveness);
-		_current_target_motion.lon = (_current_target_motion.lon * (double)_responsiveness) + target_motion.lon * (double)(
-						     1 - _responsiveness);
-
-	} else if (((current_time - _current_target_motion.timestamp) / 1000) > TARGET_TIMEOUT_MS && target_velocity_valid()) {
+	} else if (((current_time - _target_estimate.timestamp) / 1000) > TARGET_TIMEOUT_MS && target_position_valid()) {
 		reset_target_validity();
 	}
 
@@ -134,7 +121,7 @@ void FollowTarget::on_active()
 		// get distance to target
 
 		map_projection_init(&target_ref, _navigator->get_global_position()->lat, _navigator->get_global_position()->lon);
-		map_projection_project(&target_ref, _current_target_motion.lat, _current_target_motion.lon, &_target_distance(0),
+		map_projection_project(&target_ref, _target_estimate.lat, _target_estimate.lon, &_target_distance(0),
 				       &_target_distance(1));
 
 	}
@@ -143,84 +130,48 @@ void FollowTarget::on_active()
 
 	if (target_velocity_valid() && updated) {
 
-		dt_ms = ((_current_target_motion.timestamp - _previous_target_motion.timestamp) / 1000);
-
-		// ignore a small dt
-		if (dt_ms > 10.0F) {
-			// get last gps known reference for target
-			map_projection_init(&target_ref, _previous_target_motion.lat, _previous_target_motion.lon);
-
-			// calculate distance the target has moved
-			map_projection_project(&target_ref, _current_target_motion.lat, _current_target_motion.lon,
-					       &(_target_position_delta(0)), &(_target_position_delta(1)));
-
-			// update the average velocity of the target based on the position
-			_est_target_vel = _target_position_delta / (dt_ms / 1000.0f);
+		// the estimate is predicted at a high rate, no need to interpolate between target updates
+		_est_target_vel = Vector3f(_target_estimate.vx, _target_estimate.vy, 0.0F);
 
-			// if the target is moving add an offset and rotation
-			if (_est_target_vel.length() > .5F) {
-				_target_position_offset = _rot_matrix * _est_target_vel.normalized() * _follow_offset;
-			}
-
-			// are we within the target acceptance radius?
-			// give a buffer to exit/enter the radius to give the velocity controller
-			// a chance to catch up
-
-			_radius_exited = ((_target_position_offset + _target_distance).length() > (float) TARGET_ACCEPTANCE_RADIUS_M * 1.5f);
-			_radius_entered = ((_target_position_offset + _target_distance).length() < (float) TARGET_ACCEPTANCE_RADIUS_M);
+		// if the target is moving add an offset and rotation
+		if (_est_target_vel.length() > .5F) {
+			_target_position_offset = _rot_matrix * _est_target_vel.normalized() * _follow_offset;
+		}
 
-			// to keep the velocity increase/decrease smooth
-			// calculate how many velocity increments/decrements
-			// it will take to reach the targets velocity
-			// with the given amount of steps also add a feed forward input that adjusts the
-			// velocity as the position gap increases since
-			// just traveling at the exact velocity of the target will not
-			// get any closer or farther from the target
+		// are we within the target acceptance radius?
+		// give a buffer to exit/enter the radius to give the velocity controller
+		// a chance to catch up
 
-			_step_vel = (_est_target_vel - _current_vel) + (_target_position_offset + _target_distance) * FF_K;
-			_step_vel /= (dt_ms / 1000.0F * (float) INTERPOLATION_PNTS);
-			_step_time_in_ms = (dt_ms / (float) INTERPOLATION_PNTS);
+		_radius_exited = ((_target_position_offset + _target_distance).length() > (float) TARGET_ACCEPTANCE_RADIUS_M * 1.5f);
+		_radius_entered = ((_target_position_offset + _target_distance).length() < (float) TARGET_ACCEPTANCE_RADIUS_M);
 
-			// if we are less than 1 meter from the target don't worry about trying to yaw
-			// lock the yaw until we are at a distance that makes sense
+		// if we are less than 1 meter from the target don't worry about trying to yaw
+		// lock the yaw until we are at a distance that makes sense
 
-			if ((_target_distance).length() > 1.0F) {
+		if ((_target_distance).length() > 1.0F) {
 
-				// yaw rate smoothing
+			// yaw rate smoothing
 
-				// this really needs to control the yaw rate directly in the attitude pid controller
-				// but seems to work ok for now since the yaw rate cannot be controlled directly in auto mode
+			// this really needs to control the yaw rate directly in the attitude pid controller
+			// but seems to work ok for now since the yaw rate cannot be controlled directly in auto mode
 
-				_yaw_angle = get_bearing_to_next_waypoint(_navigator->get_global_position()->lat,
-						_navigator->get_global_position()->lon,
-						_current_target_motion.lat,
-						_current_target_motion.lon);
+			_yaw_angle = get_bearing_to_next_waypoint(_navigator->get_global_position()->lat,
+					_navigator->get_global_position()->lon,
+					_target_estimate.lat,
+					_target_estimate.lon);
 
-				_yaw_rate = wrap_pi((_yaw_angle - _navigator->get_global_position()->yaw) / (dt_ms / 1000.0f));
+			_yaw_rate = wrap_pi(_yaw_angle - _navigator->get_global_position()->yaw) / YAW_TIME_CONSTANT_S;
 
-			} else {
-				_yaw_angle = _yaw_rate = NAN;
-			}
+		} else {
+			_yaw_angle = _yaw_rate = NAN;
 		}
-
-//		warnx(" _step_vel x %3.6f y %3.6f cur vel %3.6f %3.6f tar vel %3.6f %3.6f dist = %3.6f (%3.6f) mode = %d yaw rate = %3.6f",
-//				(double) _step_vel(0),
-//				(double) _step_vel(1),
-//				(double) _current_vel(0),
-//				(double) _current_vel(1),
-//				(double) _est_target_vel(0),
-//				(double) _est_target_vel(1),
-//				(double) (_target_distance).length(),
-//				(double) (_target_position_offset + _target_distance).length(),
-//				_follow_target_state,
-//				(double) _yaw_rate);
 	}
 
 	if (target_position_valid()) {
 
 		// get the target position using the calculated offset
 
-		map_projection_init(&target_ref,  _current_target_motion.lat, _current_target_motion.lon);
+		map_projection_init(&target_ref,  _target_estimate.lat, _target_estimate.lon);
 		map_projection_reproject(&target_ref, _target_position_offset(0), _target_position_offset(1),
 					 &target_motion_with_offset.lat, &target_motion_with_offset.lon);
 	}
@@ -264,10 +215,10 @@ void FollowTarget::on_active()
 
 			} else if (target_velocity_valid()) {
 
-				if ((float)(current_time - _last_update_time) / 1000.0f >= _step_time_in_ms) {
-					_current_vel += _step_vel;
-					_last_update_time = current_time;
-				}
+				// track the target velocity, with a feed forward of the position gap since
+				// just traveling at the exact velocity of the target will not
+				// get any closer or farther from the target
+				_current_vel = _est_target_vel + (_target_position_offset + _target_distance) * FF_K;
 
 				set_follow_target_item(&_mission_item, _param_nav_min_ft_ht.get(), target_motion_with_offset, _yaw_angle);
 
@@ -340,11 +291,8 @@ void FollowTarget::update_position_sp(bool use_velocity, bool use_position, floa
 void FollowTarget::reset_target_validity()
 {
 	_yaw_rate = NAN;
-	_previous_target_motion = {};
-	_current_target_motion = {};
-	_target_updates = 0;
+	_target_estimate = {};
 	_current_vel.zero();
-	_step_vel.zero();
 	_est_target_vel.zero();
 	_target_distance.zero();
 	_target_position_offset.zero();
@@ -354,14 +302,12 @@ void FollowTarget::reset_target_validity()
 
 bool FollowTarget::target_velocity_valid()
 {
-	// need at least 2 continuous data points for velocity estimate
-	return (_target_updates >= 2);
+	return _target_estimate.valid && _target_estimate.vel_valid;
 }
 
 bool FollowTarget::target_position_valid()
 {
-	// need at least 1 continuous data points for position estimate
-	return (_target_updates >= 1);
+	return _target_estimate.valid;
 }
 
 void
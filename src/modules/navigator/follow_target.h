@@ -49,6 +49,7 @@
 #include <px4_platform_common/module_params.h>
 #include <uORB/Subscription.hpp>
 #include <uORB/topics/follow_target.h>
+#include <uORB/topics/follow_target_estimator.h>
 
 class FollowTarget : public MissionBlock, public ModuleParams
 {
@@ -65,9 +66,9 @@ private:
 
 	static constexpr int TARGET_TIMEOUT_MS = 2500;
 	static constexpr int TARGET_ACCEPTANCE_RADIUS_M = 5;
-	static constexpr int INTERPOLATION_PNTS = 20;
 	static constexpr float FF_K = .25F;
 	static constexpr float OFFSET_M = 8;
+	static constexpr float YAW_TIME_CONSTANT_S = 1.0F;
 
 	enum FollowTargetState {
 		TRACK_POSITION,
@@ -93,43 +94,25 @@ private:
 	DEFINE_PARAMETERS(
 		(ParamFloat<px4::params::NAV_MIN_FT_HT>) _param_nav_min_ft_ht,
 		(ParamFloat<px4::params::NAV_FT_DST>) _param_nav_ft_dst,
-		(ParamInt<px4::params::NAV_FT_FS>) _param_nav_ft_fs,
-		(ParamFloat<px4::params::NAV_FT_RS>) _param_nav_ft_rs
+		(ParamInt<px4::params::NAV_FT_FS>) _param_nav_ft_fs
 	)
 
 	FollowTargetState _follow_target_state{SET_WAIT_FOR_TARGET_POSITION};
 	int _follow_target_position{FOLLOW_FROM_BEHIND};
 
-	uORB::Subscription _follow_target_sub{ORB_ID(follow_target)};
-	float _step_time_in_ms{0.0f};
+	uORB::Subscription _follow_target_estimator_sub{ORB_ID(follow_target_estimator)};
 	float _follow_offset{OFFSET_M};
 
-	uint64_t _target_updates{0};
-	uint64_t _last_update_time{0};
-
 	matrix::Vector3f _current_vel;
-	matrix::Vector3f _step_vel;
 	matrix::Vector3f _est_target_vel;
 	matrix::Vector3f _target_distance;
 	matrix::Vector3f _target_position_offset;
-	matrix::Vector3f _target_position_delta;
-	matrix::Vector3f _filtered_target_position_delta;
 
-	follow_target_s _current_target_motion{};
-	follow_target_s _previous_target_motion{};
+	follow_target_estimator_s _target_estimate{};	///< predicted target state, filtered by the follow target estimator
 
 	float _yaw_rate{0.0f};
-	float _responsiveness{0.0f};
 	float _yaw_angle{0.0f};
 
-	// Mavlink defined motion reporting capabilities
-	enum {
-		POS = 0,
-		VEL = 1,
-		ACCEL = 2,
-		ATT_RATES = 3
-	};
-
 	matrix::Dcmf _rot_matrix;
 
 	void track_target_position();
@@ -138,8 +121,6 @@ private:
 	bool target_position_valid();
 	void reset_target_validity();
 	void update_position_sp(bool velocity_valid, bool position_valid, float yaw_rate);
-	void update_target_motion();
-	void update_target_velocity();
 
 	/**
 	 * Set follow_target item
@@ -0,0 +1,238 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "follow_target_estimator.h"
+
+using matrix::Vector3f;
+
+FollowTargetEstimator::FollowTargetEstimator() :
+	ModuleParams(nullptr),
+	ScheduledWorkItem("follow_target_estimator", px4::wq_configurations::hp_default)
+{
+	updateParams();
+}
+
+FollowTargetEstimator::~FollowTargetEstimator()
+{
+	stop();
+	perf_free(_cycle_perf);
+}
+
+bool
+FollowTargetEstimator::init()
+{
+	if (!_follow_target_sub.registerCallback()) {
+		PX4_ERR("follow_target callback registration failed");
+		return false;
+	}
+
+	return true;
+}
+
+void
+FollowTargetEstimator::stop()
+{
+	ScheduleClear();
+	_follow_target_sub.unregisterCallback();
+}
+
+void
+FollowTargetEstimator::Run()
+{
+	perf_begin(_cycle_perf);
+
+	if (_parameter_update_sub.updated()) {
+		parameter_update_s param_update;
+		_parameter_update_sub.copy(&param_update);
+		updateParams();
+	}
+
+	const hrt_abstime now = hrt_absolute_time();
+
+	follow_target_s target;
+
+	if (_follow_target_sub.update(&target)) {
+		const bool tracking = (_measurement_count > 0);
+
+		fuse(target, now);
+
+		if (!tracking && (_measurement_count > 0)) {
+			// new target, predict at the controller rate until it times out
+			ScheduleOnInterval(PUBLISH_INTERVAL);
+		}
+	}
+
+	if (_measurement_count > 0) {
+		if (now > _last_measurement_received + TARGET_TIMEOUT) {
+			reset();
+			ScheduleClear();
+
+		} else {
+			predict(now);
+		}
+
+		publish();
+	}
+
+	perf_end(_cycle_perf);
+}
+
+void
+FollowTargetEstimator::fuse(const follow_target_s &target, hrt_abstime now)
+{
+	if (!PX4_ISFINITE(target.lat) || !PX4_ISFINITE(target.lon) || !PX4_ISFINITE(target.alt)) {
+		return;
+	}
+
+	// measurement time, the sender's time stamp is only used within the latency limit
+	hrt_abstime sample = target.timestamp_sample;
+
+	if ((sample == 0) || (sample > now)) {
+		sample = now;
+
+	} else if (now - sample > MAX_LATENCY) {
+		sample = now - MAX_LATENCY;
+	}
+
+	if (_measurement_count == 0) {
+		map_projection_init(&_reference, target.lat, target.lon);
+		_velocity.zero();
+		_vel_valid = false;
+	}
+
+	predict(now);
+
+	Vector3f measurement;
+	map_projection_project(&_reference, target.lat, target.lon, &measurement(0), &measurement(1));
+	measurement(2) = -target.alt;
+
+	// weight of the new measurement, NAV_FT_RS is the weight of the old estimate
+	const float alpha = math::constrain(1.f - _param_nav_ft_rs.get(), 0.1f, 0.9f);
+
+	// velocity measured by the target, otherwise from the position change since the last measurement
+	Vector3f velocity_measurement;
+	bool velocity_measured = false;
+
+	if ((target.est_cap & EST_CAP_VEL) && PX4_ISFINITE(target.vx) && PX4_ISFINITE(target.vy) && PX4_ISFINITE(target.vz)) {
+		velocity_measurement = Vector3f(target.vx, target.vy, target.vz);
+		velocity_measured = true;
+
+	} else if ((_measurement_count > 0) && (sample > _last_measurement_sample + 10_ms)) {
+		velocity_measurement = (measurement - _last_measurement) / ((sample - _last_measurement_sample) * 1e-6f);
+		velocity_measured = true;
+	}
+
+	if (velocity_measured) {
+		if (_vel_valid) {
+			_velocity += alpha * (velocity_measurement - _velocity);
+
+		} else {
+			_velocity = velocity_measurement;
+			_vel_valid = true;
+		}
+	}
+
+	// the measurement is propagated to now to compensate the latency
+	const Vector3f measurement_now = measurement + _velocity * ((now - sample) * 1e-6f);
+
+	if (_measurement_count == 0) {
+		_position = measurement_now;
+
+	} else {
+		_position += alpha * (measurement_now - _position);
+	}
+
+	_last_measurement = measurement;
+	_last_measurement_sample = sample;
+	_last_measurement_received = now;
+	_measurement_count++;
+
+	// move the origin to the estimate, keeps the projection error small however far the target goes
+	double lat = 0.;
+	double lon = 0.;
+	map_projection_reproject(&_reference, _position(0), _position(1), &lat, &lon);
+	map_projection_init(&_reference, lat, lon);
+
+	_last_measurement(0) -= _position(0);
+	_last_measurement(1) -= _position(1);
+	_position(0) = 0.f;
+	_position(1) = 0.f;
+}
+
+void
+FollowTargetEstimator::predict(hrt_abstime now)
+{
+	if (_vel_valid && (now > _timestamp_state)) {
+		_position += _velocity * ((now - _timestamp_state) * 1e-6f);
+	}
+
+	_timestamp_state = now;
+}
+
+void
+FollowTargetEstimator::publish()
+{
+	follow_target_estimator_s estimate{};
+	estimate.timestamp_sample = _last_measurement_sample;
+	estimate.valid = (_measurement_count > 0);
+	estimate.vel_valid = estimate.valid && _vel_valid;
+
+	if (estimate.valid) {
+		map_projection_reproject(&_reference, _position(0), _position(1), &estimate.lat, &estimate.lon);
+		estimate.alt = -_position(2);
+
+		if (estimate.vel_valid) {
+			estimate.vx = _velocity(0);
+			estimate.vy = _velocity(1);
+			estimate.vz = _velocity(2);
+		}
+	}
+
+	estimate.measurement_count = _measurement_count;
+	estimate.timestamp = hrt_absolute_time();
+	_follow_target_estimator_pub.publish(estimate);
+}
+
+void
+FollowTargetEstimator::reset()
+{
+	_position.zero();
+	_velocity.zero();
+	_timestamp_state = 0;
+	_last_measurement.zero();
+	_last_measurement_sample = 0;
+	_last_measurement_received = 0;
+	_measurement_count = 0;
+	_vel_valid = false;
+}
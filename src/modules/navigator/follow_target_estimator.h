@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file follow_target_estimator.h
+ *
+ * Estimator of the follow target state, independent of the navigator loop.
+ *
+ * The follow_target measurements are fused as soon as they arrive, with the link latency
+ * compensated if the sender is time synchronized. While a target is tracked the predicted
+ * state is published at the controller rate, without a target nothing is scheduled.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <lib/ecl/geo/geo.h>
+#include <lib/matrix/matrix/math.hpp>
+#include <lib/mathlib/mathlib.h>
+#include <lib/perf/perf_counter.h>
+#include <px4_platform_common/module_params.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
+#include <uORB/topics/follow_target.h>
+#include <uORB/topics/follow_target_estimator.h>
+#include <uORB/topics/parameter_update.h>
+
+using namespace time_literals;
+
+class FollowTargetEstimator : public ModuleParams, public px4::ScheduledWorkItem
+{
+public:
+	FollowTargetEstimator();
+	~FollowTargetEstimator() override;
+
+	/**
+	 * Start running on follow_target updates.
+	 */
+	bool init();
+
+	/**
+	 * Stop running, call before the owner is destroyed.
+	 */
+	void stop();
+
+private:
+	static constexpr hrt_abstime PUBLISH_INTERVAL = 20_ms;	///< prediction rate while a target is tracked
+	static constexpr hrt_abstime TARGET_TIMEOUT = 2500_ms;	///< no measurement for this long invalidates the target
+	static constexpr hrt_abstime MAX_LATENCY = 1_s;		///< latency compensation limit, protects against bad time stamps
+
+	// MAVLink FOLLOW_TARGET est_capabilities
+	static constexpr uint8_t EST_CAP_VEL = 1 << 1;
+
+	void Run() override;
+
+	void fuse(const follow_target_s &target, hrt_abstime now);
+	void predict(hrt_abstime now);
+	void publish();
+	void reset();
+
+	DEFINE_PARAMETERS(
+		(ParamFloat<px4::params::NAV_FT_RS>) _param_nav_ft_rs
+	)
+
+	uORB::SubscriptionCallbackWorkItem _follow_target_sub{this, ORB_ID(follow_target)};
+	uORB::Subscription _parameter_update_sub{ORB_ID(parameter_update)};
+
+	uORB::Publication<follow_target_estimator_s> _follow_target_estimator_pub{ORB_ID(follow_target_estimator)};
+
+	map_projection_reference_s _reference{};	///< local frame origin, moved to the estimate on every measurement
+
+	matrix::Vector3f _position{};			///< [m] NED, relative to _reference (down relative to 0 m AMSL)
+	matrix::Vector3f _velocity{};			///< [m/s] NED
+	hrt_abstime _timestamp_state{0};		///< time of _position
+
+	matrix::Vector3f _last_measurement{};		///< [m] NED, relative to _reference
+	hrt_abstime _last_measurement_sample{0};
+	hrt_abstime _last_measurement_received{0};
+
+	uint32_t _measurement_count{0};
+	bool _vel_valid{false};
+
+	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, "follow_target_estimator: cycle")};
+};
@@ -46,6 +46,7 @@
 #include <dataman/dataman.h>
 #include <drivers/drv_hrt.h>
 #include <lib/ecl/geo/geo.h>
+#include <lib/mathlib/mathlib.h>
 #include <systemlib/mavlink_log.h>
 
 #include "navigator.h"
@@ -63,9 +64,24 @@ Geofence::Geofence(Navigator *navigator) :
 
 Geofence::~Geofence()
 {
-	if (_polygons) {
-		delete[](_polygons);
-	}
+	freeFence();
+}
+
+void Geofence::freeFence()
+{
+	delete[](_polygons);
+	_polygons = nullptr;
+	_num_polygons = 0;
+
+	delete[](_vertices);
+	_vertices = nullptr;
+	_num_vertices = 0;
+
+	delete[](_strip_start);
+	_strip_start = nullptr;
+
+	delete[](_strip_edges);
+	_strip_edges = nullptr;
 }
 
 void Geofence::updateFence()
@@ -85,6 +101,7 @@ void Geofence::updateFence()
 
 void Geofence::_updateFence()
 {
+	freeFence();
 
 	// initialize fence points count
 	mission_stats_entry_s stats;
@@ -97,7 +114,6 @@ void Geofence::_updateFence()
 	}
 
 	// iterate over all polygons and store their starting vertices
-	_num_polygons = 0;
 	int current_seq = 1;
 
 	while (current_seq <= num_fence_items) {
@@ -144,22 +160,26 @@ void Geofence::_updateFence()
 				}
 
 				if (!_polygons) {
-					_num_polygons = 0;
+					freeFence();
 					PX4_ERR("alloc failed");
 					return;
 				}
 
 				PolygonInfo &polygon = _polygons[_num_polygons];
+				polygon = {};
 				polygon.dataman_index = current_seq;
 				polygon.fence_type = mission_fence_point.nav_cmd;
+				polygon.vertex_index = _num_vertices;
 
 				if (is_circle_area) {
 					polygon.circle_radius = mission_fence_point.circle_radius;
 					current_seq += 1;
+					_num_vertices += 1;
 
 				} else {
 					polygon.vertex_count = mission_fence_point.vertex_count;
 					current_seq += mission_fence_point.vertex_count;
+					_num_vertices += mission_fence_point.vertex_count;
 				}
 
 				++_num_polygons;
@@ -175,6 +195,156 @@ void Geofence::_updateFence()
 
 	}
 
+	if (_num_polygons == 0) {
+		return;
+	}
+
+	// load all vertices into RAM and project them to the local frame, so that checks do not need to access dataman
+	_vertices = new FenceVertex[_num_vertices];
+
+	if (!_vertices) {
+		freeFence();
+		PX4_ERR("alloc failed");
+		return;
+	}
+
+	_projection_reference = {};
+	int num_strips = 0;
+	int num_strip_edges = 0;
+
+	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+		PolygonInfo &polygon = _polygons[polygon_idx];
+		const bool is_circle_area = (polygon.vertex_count == 0);
+		const int num_vertices = is_circle_area ? 1 : polygon.vertex_count;
+
+		polygon.valid = true;
+		polygon.x_min = FLT_MAX;
+		polygon.x_max = -FLT_MAX;
+		polygon.y_min = FLT_MAX;
+		polygon.y_max = -FLT_MAX;
+
+		for (int i = 0; i < num_vertices; ++i) {
+			mission_fence_point_s vertex;
+
+			if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + i, &vertex, sizeof(mission_fence_point_s)) !=
+			    sizeof(mission_fence_point_s)) {
+				PX4_ERR("dm_read failed");
+				polygon.valid = false;
+				break;
+			}
+
+			if (vertex.frame != NAV_FRAME_GLOBAL && vertex.frame != NAV_FRAME_GLOBAL_INT
+			    && vertex.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
+			    && vertex.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
+				// TODO: handle different frames
+				PX4_ERR("Frame type %i not supported", (int)vertex.frame);
+				polygon.valid = false;
+				break;
+			}
+
+			if (!map_projection_initialized(&_projection_reference)) {
+				map_projection_init(&_projection_reference, vertex.lat, vertex.lon);
+			}
+
+			FenceVertex &local = _vertices[polygon.vertex_index + i];
+			map_projection_project(&_projection_reference, vertex.lat, vertex.lon, &local.x, &local.y);
+
+			polygon.x_min = math::min(polygon.x_min, local.x);
+			polygon.x_max = math::max(polygon.x_max, local.x);
+			polygon.y_min = math::min(polygon.y_min, local.y);
+			polygon.y_max = math::max(polygon.y_max, local.y);
+		}
+
+		if (!polygon.valid) {
+			continue;
+		}
+
+		if (is_circle_area) {
+			polygon.x_min -= polygon.circle_radius;
+			polygon.x_max += polygon.circle_radius;
+			polygon.y_min -= polygon.circle_radius;
+			polygon.y_max += polygon.circle_radius;
+
+		} else if (polygon.vertex_count >= STRIP_MIN_VERTICES) {
+			polygon.strip_count = math::min(polygon.vertex_count / 4, STRIP_MAX_COUNT);
+			polygon.strip_width = (polygon.y_max - polygon.y_min) / polygon.strip_count;
+
+			if (polygon.strip_width > FLT_EPSILON) {
+				polygon.strip_index = num_strips;
+				num_strips += polygon.strip_count + 1;
+				num_strip_edges += buildStripIndex(polygon, nullptr, nullptr, 0);
+
+			} else {
+				polygon.strip_count = 0;
+			}
+		}
+	}
+
+	if (num_strips > 0) {
+		_strip_start = new int[num_strips];
+		_strip_edges = new uint16_t[num_strip_edges];
+
+		if (_strip_start && _strip_edges) {
+			int edge_offset = 0;
+
+			for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+				const PolygonInfo &polygon = _polygons[polygon_idx];
+
+				if (polygon.strip_count > 0) {
+					edge_offset += buildStripIndex(polygon, &_strip_start[polygon.strip_index], _strip_edges, edge_offset);
+				}
+			}
+
+		} else {
+			// fall back to testing all edges
+			PX4_WARN("strip index alloc failed");
+
+			delete[](_strip_start);
+			_strip_start = nullptr;
+
+			delete[](_strip_edges);
+			_strip_edges = nullptr;
+
+			for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
+				_polygons[polygon_idx].strip_count = 0;
+			}
+		}
+	}
+}
+
+int Geofence::buildStripIndex(const PolygonInfo &polygon, int *strip_start, uint16_t *strip_edges, int edge_offset)
+{
+	const FenceVertex *vertices = &_vertices[polygon.vertex_index];
+	const int last_strip = polygon.strip_count - 1;
+	int num_edges = 0;
+
+	// edge i connects vertex i - 1 and vertex i, it is added to every strip its y range overlaps
+	for (int strip = 0; strip < polygon.strip_count; ++strip) {
+		if (strip_edges) {
+			strip_start[strip] = edge_offset + num_edges;
+		}
+
+		for (int i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
+			const float y_min = math::min(vertices[i].y, vertices[j].y);
+			const float y_max = math::max(vertices[i].y, vertices[j].y);
+			const int strip_min = math::constrain((int)((y_min - polygon.y_min) / polygon.strip_width), 0, last_strip);
+			const int strip_max = math::constrain((int)((y_max - polygon.y_min) / polygon.strip_width), 0, last_strip);
+
+			if (strip >= strip_min && strip <= strip_max) {
+				if (strip_edges) {
+					strip_edges[edge_offset + num_edges] = (uint16_t)i;
+				}
+
+				++num_edges;
+			}
+		}
+	}
+
+	if (strip_edges) {
+		strip_start[polygon.strip_count] = edge_offset + num_edges;
+	}
+
+	return num_edges;
 }
 
 bool Geofence::checkAll(const struct vehicle_global_position_s &global_position)
@@ -280,22 +450,20 @@ bool Geofence::checkAll(double lat, double lon, float altitude)
 
 bool Geofence::checkPolygons(double lat, double lon, float altitude)
 {
-	// the following uses dm_read, so first we try to lock all items. If that fails, it (most likely) means
-	// the data is currently being updated (via a mavlink geofence transfer), and we do not check for a violation now
-	if (dm_trylock(DM_KEY_FENCE_POINTS) != 0) {
-		return true;
-	}
+	// check if the fence data got updated. If the lock cannot be taken, the data is (most likely) being updated via
+	// a mavlink geofence transfer, and the fence loaded in RAM is used until the transfer is complete
+	if (dm_trylock(DM_KEY_FENCE_POINTS) == 0) {
+		mission_stats_entry_s stats;
+		int ret = dm_read(DM_KEY_FENCE_POINTS, 0, &stats, sizeof(mission_stats_entry_s));
 
-	// we got the lock, now check if the fence data got updated
-	mission_stats_entry_s stats;
-	int ret = dm_read(DM_KEY_FENCE_POINTS, 0, &stats, sizeof(mission_stats_entry_s));
+		if (ret == sizeof(mission_stats_entry_s) && _update_counter != stats.update_counter) {
+			_updateFence();
+		}
 
-	if (ret == sizeof(mission_stats_entry_s) && _update_counter != stats.update_counter) {
-		_updateFence();
+		dm_unlock(DM_KEY_FENCE_POINTS);
 	}
 
-	if (isEmpty()) {
-		dm_unlock(DM_KEY_FENCE_POINTS);
+	if (isEmpty() || !map_projection_initialized(&_projection_reference)) {
 		/* Empty fence -> accept all points */
 		return true;
 	}
@@ -303,11 +471,12 @@ bool Geofence::checkPolygons(double lat, double lon, float altitude)
 	/* Vertical check */
 	if (_altitude_max > _altitude_min) { // only enable vertical check if configured properly
 		if (altitude > _altitude_max || altitude < _altitude_min) {
-			dm_unlock(DM_KEY_FENCE_POINTS);
 			return false;
 		}
 	}
 
+	float x, y;
+	map_projection_project(&_projection_reference, lat, lon, &x, &y);
 
 	/* Horizontal check: iterate all polygons & circles */
 	bool outside_exclusion = true;
@@ -316,7 +485,7 @@ bool Geofence::checkPolygons(double lat, double lon, float altitude)
 
 	for (int polygon_idx = 0; polygon_idx < _num_polygons; ++polygon_idx) {
 		if (_polygons[polygon_idx].fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION) {
-			bool inside = insideCircle(_polygons[polygon_idx], lat, lon, altitude);
+			bool inside = insideCircle(_polygons[polygon_idx], x, y);
 
 			if (inside) {
 				inside_inclusion = true;
@@ -325,14 +494,14 @@ bool Geofence::checkPolygons(double lat, double lon, float altitude)
 			had_inclusion_areas = true;
 
 		} else if (_polygons[polygon_idx].fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION) {
-			bool inside = insideCircle(_polygons[polygon_idx], lat, lon, altitude);
+			bool inside = insideCircle(_polygons[polygon_idx], x, y);
 
 			if (inside) {
 				outside_exclusion = false;
 			}
 
 		} else { // it's a polygon
-			bool inside = insidePolygon(_polygons[polygon_idx], lat, lon, altitude);
+			bool inside = insidePolygon(_polygons[polygon_idx], x, y);
 
 			if (_polygons[polygon_idx].fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION) {
 				if (inside) {
@@ -349,13 +518,14 @@ bool Geofence::checkPolygons(double lat, double lon, float altitude)
 		}
 	}
 
-	dm_unlock(DM_KEY_FENCE_POINTS);
-
 	return (!had_inclusion_areas || inside_inclusion) && outside_exclusion;
 }
 
-bool Geofence::insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude)
+bool Geofence::insidePolygon(const PolygonInfo &polygon, float x, float y)
 {
+	if (!polygon.valid || x < polygon.x_min || x > polygon.x_max || y < polygon.y_min || y > polygon.y_max) {
+		return false;
+	}
 
 	/* Adaptation of algorithm originally presented as
 	 * PNPOLY - Point Inclusion in Polygon Test
@@ -363,67 +533,45 @@ bool Geofence::insidePolygon(const PolygonInfo &polygon, double lat, double lon,
 	 * Only supports non-complex polygons (not self intersecting)
 	 */
 
-	mission_fence_point_s temp_vertex_i;
-	mission_fence_point_s temp_vertex_j;
+	const FenceVertex *vertices = &_vertices[polygon.vertex_index];
 	bool c = false;
 
-	for (unsigned i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
-		if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + i, &temp_vertex_i,
-			    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-			break;
-		}
+	if (polygon.strip_count > 0) {
+		// only the edges overlapping the strip of the point can cross its y coordinate
+		const int strip = math::constrain((int)((y - polygon.y_min) / polygon.strip_width), 0, polygon.strip_count - 1);
+		const int *strip_start = &_strip_start[polygon.strip_index];
 
-		if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + j, &temp_vertex_j,
-			    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-			break;
-		}
+		for (int k = strip_start[strip]; k < strip_start[strip + 1]; ++k) {
+			const int i = _strip_edges[k];
+			const int j = (i == 0) ? polygon.vertex_count - 1 : i - 1;
 
-		if (temp_vertex_i.frame != NAV_FRAME_GLOBAL && temp_vertex_i.frame != NAV_FRAME_GLOBAL_INT
-		    && temp_vertex_i.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
-		    && temp_vertex_i.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-			// TODO: handle different frames
-			PX4_ERR("Frame type %i not supported", (int)temp_vertex_i.frame);
-			break;
+			if ((vertices[i].y >= y) != (vertices[j].y >= y) &&
+			    (x <= (vertices[j].x - vertices[i].x) * (y - vertices[i].y) / (vertices[j].y - vertices[i].y) + vertices[i].x)) {
+				c = !c;
+			}
 		}
 
-		if (((double)temp_vertex_i.lon >= lon) != ((double)temp_vertex_j.lon >= lon) &&
-		    (lat <= (double)(temp_vertex_j.lat - temp_vertex_i.lat) * (lon - (double)temp_vertex_i.lon) /
-		     (double)(temp_vertex_j.lon - temp_vertex_i.lon) + (double)temp_vertex_i.lat)) {
-			c = !c;
+	} else {
+		for (int i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
+			if ((vertices[i].y >= y) != (vertices[j].y >= y) &&
+			    (x <= (vertices[j].x - vertices[i].x) * (y - vertices[i].y) / (vertices[j].y - vertices[i].y) + vertices[i].x)) {
+				c = !c;
+			}
 		}
 	}
 
 	return c;
 }
 
-bool Geofence::insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude)
+bool Geofence::insideCircle(const PolygonInfo &polygon, float x, float y)
 {
-
-	mission_fence_point_s circle_point;
-
-	if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index, &circle_point,
-		    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-		PX4_ERR("dm_read failed");
-		return false;
-	}
-
-	if (circle_point.frame != NAV_FRAME_GLOBAL && circle_point.frame != NAV_FRAME_GLOBAL_INT
-	    && circle_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
-	    && circle_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-		// TODO: handle different frames
-		PX4_ERR("Frame type %i not supported", (int)circle_point.frame);
+	if (!polygon.valid || x < polygon.x_min || x > polygon.x_max || y < polygon.y_min || y > polygon.y_max) {
 		return false;
 	}
 
-	if (!map_projection_initialized(&_projection_reference)) {
-		map_projection_init(&_projection_reference, lat, lon);
-	}
-
-	float x1, y1, x2, y2;
-	map_projection_project(&_projection_reference, lat, lon, &x1, &y1);
-	map_projection_project(&_projection_reference, circle_point.lat, circle_point.lon, &x2, &y2);
-	float dx = x1 - x2, dy = y1 - y2;
-	return dx * dx + dy * dy < circle_point.circle_radius * circle_point.circle_radius;
+	const FenceVertex &center = _vertices[polygon.vertex_index];
+	float dx = x - center.x, dy = y - center.y;
+	return dx * dx + dy * dy < polygon.circle_radius * polygon.circle_radius;
 }
 
 bool
@@ -144,17 +144,43 @@ private:
 	float _altitude_min{0.0f};
 	float _altitude_max{0.0f};
 
+	/**
+	 * Fence vertex projected to the local frame of _projection_reference [m]
+	 */
+	static constexpr int STRIP_MIN_VERTICES = 16; ///< polygons with less vertices are tested without strip index
+	static constexpr int STRIP_MAX_COUNT = 32;
+
+	struct FenceVertex {
+		float x;
+		float y;
+	};
+
+	/**
+	 * Polygon or circle loaded from dataman. Polygons reference their vertices in _vertices and the edges
+	 * overlapping each of their strips in _strip_edges, so that a point-in-polygon test only needs to look at the
+	 * edges of a single strip instead of all edges.
+	 */
 	struct PolygonInfo {
 		uint16_t fence_type; ///< one of MAV_CMD_NAV_FENCE_* (can also be a circular region)
 		uint16_t dataman_index;
-		union {
-			uint16_t vertex_count;
-			float circle_radius;
-		};
+		uint16_t vertex_count; ///< number of vertices (0 for circles)
+		uint16_t vertex_index; ///< index of the first vertex (or the circle center) in _vertices
+		uint16_t strip_count; ///< number of strips along y, 0 if no strip index could be allocated
+		int strip_index; ///< index of the first strip start offset in _strip_start (strip_count + 1 entries)
+		float circle_radius;
+		float strip_width;
+		float x_min, x_max, y_min, y_max; ///< bounding box (including the circle radius for circles)
+		bool valid; ///< false if the frame is not supported, the area never contains any point then
 	};
 	PolygonInfo *_polygons{nullptr};
 	int _num_polygons{0};
 
+	FenceVertex *_vertices{nullptr};
+	int _num_vertices{0};
+
+	int *_strip_start{nullptr}; ///< per polygon strip start offsets into _strip_edges
+	uint16_t *_strip_edges{nullptr}; ///< edge indices (local to the polygon) overlapping a strip
+
 	map_projection_reference_s _projection_reference = {}; ///< reference to convert (lon, lat) to local [m]
 
 	DEFINE_PARAMETERS(
@@ -199,16 +225,32 @@ private:
 	bool checkAll(const vehicle_global_position_s &global_position);
 	bool checkAll(const vehicle_global_position_s &global_position, float baro_altitude_amsl);
 
+	/**
+	 * free the fence data held in RAM
+	 */
+	void freeFence();
+
+	/**
+	 * build the strip index of a polygon after its vertices and bounding box have been loaded
+	 * @param strip_start strip_count + 1 start offsets into strip_edges, only written if strip_edges is set
+	 * @param strip_edges edge entries, nullptr to only count them
+	 * @param edge_offset offset of the first edge entry of this polygon in strip_edges
+	 * @return number of edge entries of the polygon
+	 */
+	int buildStripIndex(const PolygonInfo &polygon, int *strip_start, uint16_t *strip_edges, int edge_offset);
+
 	/**
 	 * Check if a single point is within a polygon
+	 * @param x, y point in the local frame of _projection_reference
 	 * @return true if within polygon
 	 */
-	bool insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude);
+	bool insidePolygon(const PolygonInfo &polygon, float x, float y);
 
 	/**
 	 * Check if a single point is within a circle
 	 * @param polygon must be a circle!
+	 * @param x, y point in the local frame of _projection_reference
 	 * @return true if within polygon the circle
 	 */
-	bool insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude);
+	bool insideCircle(const PolygonInfo &polygon, float x, float y);
 };
@@ -110,6 +110,7 @@ Mission::on_inactive()
 			_mission.dataman_id = mission_state.dataman_id;
 			_mission.count = mission_state.count;
 			_current_mission_index = mission_state.current_seq;
+			_navigator->get_mission_cache().reset(_mission);
 
 			// find and store landing start marker (if available)
 			find_mission_land_start();
@@ -384,7 +385,7 @@ Mission::find_mission_land_start()
 		const ssize_t len = sizeof(missionitem);
 		missionitem_prev = missionitem; // store the last mission item before reading a new one
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (_navigator->get_mission_cache().read(dm_current, i, &missionitem) != len) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			PX4_ERR("dataman read failure");
 			break;
@@ -462,6 +463,9 @@ Mission::update_mission()
 	const mission_s old_mission = _mission;
 
 	if (_mission_sub.copy(&_mission)) {
+		/* the mission items in dataman were replaced, drop the cached ones */
+		_navigator->get_mission_cache().reset(_mission);
+
 		/* determine current index */
 		if (_mission.current_seq >= 0 && _mission.current_seq < (int)_mission.count) {
 			_current_mission_index = _mission.current_seq;
@@ -512,6 +516,7 @@ Mission::update_mission()
 		_mission.count = 0;
 		_mission.current_seq = 0;
 		_current_mission_index = 0;
+		_navigator->get_mission_cache().reset(_mission);
 
 		PX4_ERR("mission check failed");
 	}
@@ -548,7 +553,7 @@ Mission::advance_mission()
 					struct mission_item_s missionitem = {};
 					const ssize_t len = sizeof(missionitem);
 
-					if (dm_read(dm_current, i, &missionitem, len) != len) {
+					if (_navigator->get_mission_cache().read(dm_current, i, &missionitem) != len) {
 						/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 						PX4_ERR("dataman read failure");
 						break;
@@ -1500,7 +1505,7 @@ Mission::read_mission_item(int offset, struct mission_item_s *mission_item)
 		struct mission_item_s mission_item_tmp;
 
 		/* read mission item from datamanager */
-		if (dm_read(dm_item, *mission_index_ptr, &mission_item_tmp, len) != len) {
+		if (_navigator->get_mission_cache().read(dm_item, *mission_index_ptr, &mission_item_tmp) != len) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Waypoint could not be read.");
 			return false;
@@ -1519,7 +1524,8 @@ Mission::read_mission_item(int offset, struct mission_item_s *mission_item)
 					(mission_item_tmp.do_jump_current_count)++;
 
 					/* save repeat count */
-					if (dm_write(dm_item, *mission_index_ptr, DM_PERSIST_POWER_ON_RESET, &mission_item_tmp, len) != len) {
+					if (_navigator->get_mission_cache().write(dm_item, *mission_index_ptr, DM_PERSIST_POWER_ON_RESET,
+							&mission_item_tmp) != len) {
 						/* not supposed to happen unless the datamanager can't access the dataman */
 						mavlink_log_critical(_navigator->get_mavlink_log_pub(), "DO JUMP waypoint could not be written.");
 						return false;
@@ -1684,7 +1690,7 @@ Mission::reset_mission(struct mission_s &mission)
 					struct mission_item_s item;
 					const ssize_t len = sizeof(struct mission_item_s);
 
-					if (dm_read(dm_current, index, &item, len) != len) {
+					if (_navigator->get_mission_cache().read(dm_current, index, &item) != len) {
 						PX4_WARN("could not read mission item during reset");
 						break;
 					}
@@ -1692,7 +1698,7 @@ Mission::reset_mission(struct mission_s &mission)
 					if (item.nav_cmd == NAV_CMD_DO_JUMP) {
 						item.do_jump_current_count = 0;
 
-						if (dm_write(dm_current, index, DM_PERSIST_POWER_ON_RESET, &item, len) != len) {
+						if (_navigator->get_mission_cache().write(dm_current, index, DM_PERSIST_POWER_ON_RESET, &item) != len) {
 							PX4_WARN("could not save mission item during reset");
 							break;
 						}
@@ -1751,7 +1757,7 @@ Mission::index_closest_mission_item() const
 		struct mission_item_s missionitem = {};
 		const ssize_t len = sizeof(missionitem);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (_navigator->get_mission_cache().read(dm_current, i, &missionitem) != len) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			PX4_ERR("dataman read failure");
 			break;
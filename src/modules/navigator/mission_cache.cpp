@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file mission_cache.cpp
+ */
+
+#include "mission_cache.h"
+
+#include <string.h>
+
+#include <lib/mathlib/mathlib.h>
+#include <px4_platform_common/log.h>
+
+MissionCache::~MissionCache()
+{
+	free();
+}
+
+void MissionCache::free()
+{
+	delete[](_items);
+	_items = nullptr;
+
+	delete[](_cached);
+	_cached = nullptr;
+
+	_capacity = 0;
+}
+
+void MissionCache::reset(const mission_s &mission)
+{
+	const unsigned capacity = math::min((unsigned)mission.count, MAX_ITEMS);
+
+	if (capacity != _capacity) {
+		free();
+
+		if (capacity > 0) {
+			_items = new mission_item_s[capacity];
+			_cached = new uint32_t[(capacity + 31) / 32];
+
+			if (_items && _cached) {
+				_capacity = capacity;
+
+			} else {
+				// no cache, all items are read from dataman
+				PX4_WARN("mission cache alloc failed");
+				free();
+			}
+		}
+	}
+
+	if (_cached) {
+		memset(_cached, 0, sizeof(uint32_t) * ((_capacity + 31) / 32));
+	}
+
+	_dataman_id = (dm_item_t)mission.dataman_id;
+}
+
+ssize_t MissionCache::read(dm_item_t item, unsigned index, mission_item_s *mission_item)
+{
+	const ssize_t len = sizeof(mission_item_s);
+
+	if (item != _dataman_id || index >= _capacity) {
+		return dm_read(item, index, mission_item, len);
+	}
+
+	if (isCached(index)) {
+		*mission_item = _items[index];
+		_hits++;
+		return len;
+	}
+
+	const ssize_t ret = dm_read(item, index, &_items[index], len);
+
+	if (ret == len) {
+		setCached(index);
+		*mission_item = _items[index];
+	}
+
+	_misses++;
+	return ret;
+}
+
+ssize_t MissionCache::write(dm_item_t item, unsigned index, dm_persitence_t persistence,
+			    const mission_item_s *mission_item)
+{
+	const ssize_t len = sizeof(mission_item_s);
+	const ssize_t ret = dm_write(item, index, persistence, mission_item, len);
+
+	if (item == _dataman_id && index < _capacity) {
+		if (ret == len) {
+			_items[index] = *mission_item;
+			setCached(index);
+
+		} else {
+			// the state in dataman is unknown, read it again next time
+			_cached[index / 32] &= ~(1u << (index % 32));
+		}
+	}
+
+	return ret;
+}
+
+void MissionCache::printStatus()
+{
+	PX4_INFO("Mission cache: %u items, %u hits, %u misses", _capacity, (unsigned)_hits, (unsigned)_misses);
+}
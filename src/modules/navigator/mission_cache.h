@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+/**
+ * @file mission_cache.h
+ *
+ * Read-through cache of the mission items in dataman, so that repeated walks over the mission (feasibility
+ * checks, closest item search, landing start search) do not go through the dataman work queue for every item.
+ */
+
+#pragma once
+
+#include <dataman/dataman.h>
+#include <uORB/topics/mission.h>
+
+#include "navigation.h"
+
+class MissionCache
+{
+public:
+	MissionCache() = default;
+	~MissionCache();
+
+	MissionCache(const MissionCache &) = delete;
+	MissionCache &operator=(const MissionCache &) = delete;
+
+	/**
+	 * Drop all cached items and size the cache for a mission.
+	 * This must be called whenever the mission in dataman is replaced, i.e. on every mission topic update.
+	 */
+	void reset(const mission_s &mission);
+
+	/**
+	 * Read a mission item, from RAM if it was read before. Items of other dataman keys than the one of the
+	 * current mission are read from dataman directly.
+	 * @return sizeof(mission_item_s) on success, like dm_read()
+	 */
+	ssize_t read(dm_item_t item, unsigned index, mission_item_s *mission_item);
+
+	/**
+	 * Write a mission item to dataman and update the cached copy.
+	 * @return sizeof(mission_item_s) on success, like dm_write()
+	 */
+	ssize_t write(dm_item_t item, unsigned index, dm_persitence_t persistence, const mission_item_s *mission_item);
+
+	void printStatus();
+
+private:
+#if defined(MEMORY_CONSTRAINED_SYSTEM)
+	static constexpr unsigned MAX_ITEMS = 64;
+#elif defined(__PX4_NUTTX)
+	static constexpr unsigned MAX_ITEMS = 500;
+#else
+	static constexpr unsigned MAX_ITEMS = DM_KEY_WAYPOINTS_OFFBOARD_0_MAX;
+#endif
+
+	bool isCached(unsigned index) const { return _cached[index / 32] & (1u << (index % 32)); }
+	void setCached(unsigned index) { _cached[index / 32] |= (1u << (index % 32)); }
+
+	void free();
+
+	mission_item_s *_items{nullptr};
+	uint32_t *_cached{nullptr};		///< bitmask of the items in _items read from dataman
+	unsigned _capacity{0};			///< number of items that can be cached (the first items of the mission)
+	dm_item_t _dataman_id{DM_KEY_WAYPOINTS_OFFBOARD_0};
+
+	uint32_t _hits{0};
+	uint32_t _misses{0};
+};
@@ -141,7 +141,7 @@ MissionFeasibilityChecker::checkGeofence(const mission_s &mission, float home_al
 			struct mission_item_s missionitem = {};
 			const ssize_t len = sizeof(missionitem);
 
-			if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+			if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, i, &missionitem) != len) {
 				/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 				return false;
 			}
@@ -174,7 +174,7 @@ MissionFeasibilityChecker::checkHomePositionAltitude(const mission_s &mission, f
 		struct mission_item_s missionitem = {};
 		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, i, &missionitem) != len) {
 			_navigator->get_mission_result()->warning = true;
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
@@ -224,7 +224,7 @@ MissionFeasibilityChecker::checkMissionItemValidity(const mission_s &mission)
 		struct mission_item_s missionitem;
 		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, i, &missionitem) != len) {
 			// not supposed to happen unless the datamanager can't access the SD card, etc.
 			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Cannot access SD card");
 			return false;
@@ -309,7 +309,7 @@ MissionFeasibilityChecker::checkTakeoff(const mission_s &mission, float home_alt
 		struct mission_item_s missionitem = {};
 		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, i, &missionitem) != len) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -359,7 +359,7 @@ MissionFeasibilityChecker::checkTakeoff(const mission_s &mission, float home_alt
 			struct mission_item_s missionitem = {};
 			const ssize_t len = sizeof(struct mission_item_s);
 
-			if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+			if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, i, &missionitem) != len) {
 				/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 				return false;
 			}
@@ -427,7 +427,7 @@ MissionFeasibilityChecker::checkFixedWingLanding(const mission_s &mission, bool
 		struct mission_item_s missionitem;
 		const ssize_t len = sizeof(missionitem);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, i, &missionitem) != len) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -450,7 +450,8 @@ MissionFeasibilityChecker::checkFixedWingLanding(const mission_s &mission, bool
 			if (i > 0) {
 				landing_approach_index = i - 1;
 
-				if (dm_read((dm_item_t)mission.dataman_id, landing_approach_index, &missionitem_previous, len) != len) {
+				if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, landing_approach_index,
+						&missionitem_previous) != len) {
 					/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 					return false;
 				}
@@ -551,7 +552,7 @@ MissionFeasibilityChecker::checkVTOLLanding(const mission_s &mission, bool land_
 		struct mission_item_s missionitem;
 		const ssize_t len = sizeof(missionitem);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, i, &missionitem) != len) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -574,7 +575,8 @@ MissionFeasibilityChecker::checkVTOLLanding(const mission_s &mission, bool land_
 			if (i > 0) {
 				landing_approach_index = i - 1;
 
-				if (dm_read((dm_item_t)mission.dataman_id, landing_approach_index, &missionitem_previous, len) != len) {
+				if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, landing_approach_index,
+						&missionitem_previous) != len) {
 					/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 					return false;
 				}
@@ -621,7 +623,7 @@ MissionFeasibilityChecker::checkDistanceToFirstWaypoint(const mission_s &mission
 
 		struct mission_item_s mission_item {};
 
-		if (!(dm_read((dm_item_t)mission.dataman_id, i, &mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s))) {
+		if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, i, &mission_item) != sizeof(mission_item_s)) {
 			/* error reading, mission is invalid */
 			mavlink_log_info(_navigator->get_mavlink_log_pub(), "Error reading offboard mission.");
 			return false;
@@ -672,7 +674,7 @@ MissionFeasibilityChecker::checkDistancesBetweenWaypoints(const mission_s &missi
 
 		struct mission_item_s mission_item {};
 
-		if (!(dm_read((dm_item_t)mission.dataman_id, i, &mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s))) {
+		if (_navigator->get_mission_cache().read((dm_item_t)mission.dataman_id, i, &mission_item) != sizeof(mission_item_s)) {
 			/* error reading, mission is invalid */
 			mavlink_log_info(_navigator->get_mavlink_log_pub(), "Error reading offboard mission.");
 			return false;
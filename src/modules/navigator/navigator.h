@@ -44,12 +44,14 @@
 #include "datalinkloss.h"
 #include "enginefailure.h"
 #include "follow_target.h"
+#include "follow_target_estimator.h"
 #include "geofence.h"
 #include "gpsfailure.h"
 #include "land.h"
 #include "precland.h"
 #include "loiter.h"
 #include "mission.h"
+#include "mission_cache.h"
 #include "navigator_mode.h"
 #include "rcloss.h"
 #include "rtl.h"
@@ -60,8 +62,10 @@
 #include <lib/perf/perf_counter.h>
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/module_params.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
 #include <uORB/PublicationQueued.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/topics/geofence_result.h>
 #include <uORB/topics/home_position.h>
 #include <uORB/topics/mission.h>
@@ -86,7 +90,7 @@
 #define NAVIGATOR_MODE_ARRAY_SIZE 11
 
 
-class Navigator : public ModuleBase<Navigator>, public ModuleParams
+class Navigator : public ModuleBase<Navigator>, public ModuleParams, public px4::ScheduledWorkItem
 {
 public:
 	Navigator();
@@ -98,17 +102,13 @@ public:
 	/** @see ModuleBase */
 	static int task_spawn(int argc, char *argv[]);
 
-	/** @see ModuleBase */
-	static Navigator *instantiate(int argc, char *argv[]);
-
 	/** @see ModuleBase */
 	static int custom_command(int argc, char *argv[]);
 
 	/** @see ModuleBase */
 	static int print_usage(const char *reason = nullptr);
 
-	/** @see ModuleBase::run() */
-	void run() override;
+	bool init();
 
 	/** @see ModuleBase::print_status() */
 	int print_status() override;
@@ -168,6 +168,8 @@ public:
 
 	Geofence	&get_geofence() { return _geofence; }
 
+	MissionCache	&get_mission_cache() { return _mission_cache; }
+
 	bool		get_can_loiter_at_sp() { return _can_loiter_at_sp; }
 	float		get_loiter_radius() { return _param_nav_loiter_rad.get(); }
 
@@ -323,8 +325,13 @@ private:
 		(ParamFloat<px4::params::MIS_YAW_ERR>) _param_mis_yaw_err
 	)
 
-	int		_local_pos_sub{-1};		/**< local position subscription */
-	int		_vehicle_status_sub{-1};	/**< local position subscription */
+	void Run() override;
+
+	// wakeup sources
+	uORB::SubscriptionCallbackWorkItem _local_pos_sub{this, ORB_ID(vehicle_local_position)};	/**< local position subscription */
+	uORB::SubscriptionCallbackWorkItem _vehicle_status_sub{this, ORB_ID(vehicle_status)};	/**< vehicle status subscription */
+	uORB::SubscriptionCallbackWorkItem _vehicle_command_sub{this, ORB_ID(vehicle_command)};	/**< vehicle commands (onboard and offboard) */
+	uORB::SubscriptionCallbackWorkItem _mission_sub{this, ORB_ID(mission)};	/**< mission updates, read by the mission mode */
 
 	uORB::Subscription _global_pos_sub{ORB_ID(vehicle_global_position)};	/**< global position subscription */
 	uORB::Subscription _gps_pos_sub{ORB_ID(vehicle_gps_position)};		/**< gps position subscription */
@@ -333,7 +340,6 @@ private:
 	uORB::Subscription _parameter_update_sub{ORB_ID(parameter_update)};	/**< param update subscription */
 	uORB::Subscription _pos_ctrl_landing_status_sub{ORB_ID(position_controller_landing_status)};	/**< position controller landing status subscription */
 	uORB::Subscription _traffic_sub{ORB_ID(transponder_report)};		/**< traffic subscription */
-	uORB::Subscription _vehicle_command_sub{ORB_ID(vehicle_command)};	/**< vehicle commands (onboard and offboard) */
 
 	uORB::SubscriptionData<position_controller_status_s>	_position_controller_status_sub{ORB_ID(position_controller_status)};
 
@@ -367,8 +373,12 @@ private:
 
 	perf_counter_t	_loop_perf;			/**< loop performance counter */
 
+	MissionCache	_mission_cache;			/**< cache of the mission items in dataman */
+
 	Geofence	_geofence;			/**< class that handles the geofence */
 	bool		_geofence_violation_warning_sent{false}; /**< prevents spaming to mavlink */
+	bool		_have_geofence_position_data{false};	/**< new position data for the geofence check */
+	hrt_abstime	_last_geofence_check{0};		/**< time of the last geofence check */
 
 	bool		_can_loiter_at_sp{false};			/**< flags if current position SP can be used to loiter */
 	bool		_pos_sp_triplet_updated{false};		/**< flags if position SP triplet needs to be published */
@@ -388,6 +398,8 @@ private:
 	GpsFailure	_gpsFailure;			/**< class that handles the OBC gpsfailure loss mode */
 	FollowTarget	_follow_target;
 
+	FollowTargetEstimator _follow_target_estimator;	/**< target estimation for FollowTarget, runs in its own work item */
+
 	NavigatorMode *_navigation_mode_array[NAVIGATOR_MODE_ARRAY_SIZE];	/**< array of navigation modes */
 
 	param_t _handle_back_trans_dec_mss{PARAM_INVALID};
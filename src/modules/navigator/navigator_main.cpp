@@ -76,6 +76,7 @@ Navigator	*g_navigator;
 
 Navigator::Navigator() :
 	ModuleParams(nullptr),
+	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::navigator),
 	_loop_perf(perf_alloc(PC_ELAPSED, "navigator")),
 	_geofence(this),
 	_mission(this),
@@ -106,8 +107,8 @@ Navigator::Navigator() :
 	_handle_back_trans_dec_mss = param_find("VT_B_DEC_MSS");
 	_handle_reverse_delay = param_find("VT_B_REV_DEL");
 
-	_local_pos_sub = orb_subscribe(ORB_ID(vehicle_local_position));
-	_vehicle_status_sub = orb_subscribe(ORB_ID(vehicle_status));
+	/* rate-limit position subscription to 20 Hz / 50 ms */
+	_local_pos_sub.set_interval_ms(50);
 
 	reset_triplets();
 }
@@ -115,8 +116,37 @@ Navigator::Navigator() :
 Navigator::~Navigator()
 {
 	perf_free(_loop_perf);
-	orb_unsubscribe(_local_pos_sub);
-	orb_unsubscribe(_vehicle_status_sub);
+}
+
+bool
+Navigator::init()
+{
+	/* Try to load the geofence:
+	 * if /fs/microsd/etc/geofence.txt load from this file */
+	struct stat buffer;
+
+	if (stat(GEOFENCE_FILENAME, &buffer) == 0) {
+		PX4_INFO("Loading geofence from %s", GEOFENCE_FILENAME);
+		_geofence.loadFromFile(GEOFENCE_FILENAME);
+	}
+
+	params_update();
+
+	/* wakeup sources */
+	if (!_local_pos_sub.registerCallback()) {
+		PX4_ERR("vehicle_local_position callback registration failed");
+		return false;
+	}
+
+	_vehicle_status_sub.registerCallback();
+	_vehicle_command_sub.registerCallback();
+	_mission_sub.registerCallback();
+
+	_follow_target_estimator.init();
+
+	ScheduleNow();
+
+	return true;
 }
 
 void
@@ -134,604 +164,565 @@ Navigator::params_update()
 }
 
 void
-Navigator::run()
+Navigator::Run()
 {
-	bool have_geofence_position_data = false;
+	if (should_exit()) {
+		ScheduleClear();
+		_local_pos_sub.unregisterCallback();
+		_vehicle_status_sub.unregisterCallback();
+		_vehicle_command_sub.unregisterCallback();
+		_mission_sub.unregisterCallback();
+		_follow_target_estimator.stop();
+		exit_and_cleanup();
+		return;
+	}
 
-	/* Try to load the geofence:
-	 * if /fs/microsd/etc/geofence.txt load from this file */
-	struct stat buffer;
+	perf_begin(_loop_perf);
 
-	if (stat(GEOFENCE_FILENAME, &buffer) == 0) {
-		PX4_INFO("Loading geofence from %s", GEOFENCE_FILENAME);
-		_geofence.loadFromFile(GEOFENCE_FILENAME);
+	_local_pos_sub.update(&_local_pos);
+	_vehicle_status_sub.update(&_vstatus);
+
+	/* gps updated */
+	if (_gps_pos_sub.updated()) {
+		_gps_pos_sub.copy(&_gps_pos);
+
+		if (_geofence.getSource() == Geofence::GF_SOURCE_GPS) {
+			_have_geofence_position_data = true;
+		}
 	}
 
-	params_update();
+	/* global position updated */
+	if (_global_pos_sub.updated()) {
+		_global_pos_sub.copy(&_global_pos);
 
-	/* wakeup source(s) */
-	px4_pollfd_struct_t fds[2] {};
+		if (_geofence.getSource() == Geofence::GF_SOURCE_GLOBALPOS) {
+			_have_geofence_position_data = true;
+		}
+	}
 
-	/* Setup of loop */
-	fds[0].fd = _local_pos_sub;
-	fds[0].events = POLLIN;
-	fds[1].fd = _vehicle_status_sub;
-	fds[1].events = POLLIN;
+	// check for parameter updates
+	if (_parameter_update_sub.updated()) {
+		// clear update
+		parameter_update_s pupdate;
+		_parameter_update_sub.copy(&pupdate);
 
-	/* rate-limit position subscription to 20 Hz / 50 ms */
-	orb_set_interval(_local_pos_sub, 50);
+		// update parameters from storage
+		params_update();
+	}
 
-	hrt_abstime last_geofence_check = 0;
+	_land_detected_sub.update(&_land_detected);
+	_position_controller_status_sub.update();
+	_home_pos_sub.update(&_home_pos);
 
-	while (!should_exit()) {
+	while (_vehicle_command_sub.updated()) {
+		vehicle_command_s cmd{};
+		_vehicle_command_sub.copy(&cmd);
 
-		/* wait for up to 1000ms for data */
-		int pret = px4_poll(&fds[0], (sizeof(fds) / sizeof(fds[0])), 1000);
+		if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_GO_AROUND) {
 
-		if (pret == 0) {
-			/* Let the loop run anyway, don't do `continue` here. */
+			// DO_GO_AROUND is currently handled by the position controller (unacknowledged)
+			// TODO: move DO_GO_AROUND handling to navigator
+			publish_vehicle_command_ack(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
 
-		} else if (pret < 0) {
-			/* this is undesirable but not much we can do - might want to flag unhappy status */
-			PX4_ERR("poll error %d, %d", pret, errno);
-			px4_usleep(10000);
-			continue;
+		} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_REPOSITION) {
 
-		} else {
-			if (fds[0].revents & POLLIN) {
-				/* success, local pos is available */
-				orb_copy(ORB_ID(vehicle_local_position), _local_pos_sub, &_local_pos);
-			}
-		}
+			position_setpoint_triplet_s *rep = get_reposition_triplet();
+			position_setpoint_triplet_s *curr = get_position_setpoint_triplet();
 
-		perf_begin(_loop_perf);
+			// store current position as previous position and goal as next
+			rep->previous.yaw = get_global_position()->yaw;
+			rep->previous.lat = get_global_position()->lat;
+			rep->previous.lon = get_global_position()->lon;
+			rep->previous.alt = get_global_position()->alt;
 
-		orb_copy(ORB_ID(vehicle_status), _vehicle_status_sub, &_vstatus);
+			rep->current.loiter_radius = get_loiter_radius();
+			rep->current.loiter_direction = 1;
+			rep->current.type = position_setpoint_s::SETPOINT_TYPE_LOITER;
 
-		/* gps updated */
-		if (_gps_pos_sub.updated()) {
-			_gps_pos_sub.copy(&_gps_pos);
+			// If no argument for ground speed, use default value.
+			if (cmd.param1 <= 0 || !PX4_ISFINITE(cmd.param1)) {
+				rep->current.cruising_speed = get_cruising_speed();
 
-			if (_geofence.getSource() == Geofence::GF_SOURCE_GPS) {
-				have_geofence_position_data = true;
+			} else {
+				rep->current.cruising_speed = cmd.param1;
 			}
-		}
 
-		/* global position updated */
-		if (_global_pos_sub.updated()) {
-			_global_pos_sub.copy(&_global_pos);
+			rep->current.cruising_throttle = get_cruising_throttle();
+			rep->current.acceptance_radius = get_acceptance_radius();
+
+			// Go on and check which changes had been requested
+			if (PX4_ISFINITE(cmd.param4)) {
+				rep->current.yaw = cmd.param4;
+				rep->current.yaw_valid = true;
 
-			if (_geofence.getSource() == Geofence::GF_SOURCE_GLOBALPOS) {
-				have_geofence_position_data = true;
+			} else {
+				rep->current.yaw = NAN;
+				rep->current.yaw_valid = false;
 			}
-		}
 
-		// check for parameter updates
-		if (_parameter_update_sub.updated()) {
-			// clear update
-			parameter_update_s pupdate;
-			_parameter_update_sub.copy(&pupdate);
+			if (PX4_ISFINITE(cmd.param5) && PX4_ISFINITE(cmd.param6)) {
 
-			// update parameters from storage
-			params_update();
-		}
+				// Position change with optional altitude change
+				rep->current.lat = cmd.param5;
+				rep->current.lon = cmd.param6;
 
-		_land_detected_sub.update(&_land_detected);
-		_position_controller_status_sub.update();
-		_home_pos_sub.update(&_home_pos);
-
-		if (_vehicle_command_sub.updated()) {
-			vehicle_command_s cmd{};
-			_vehicle_command_sub.copy(&cmd);
+				if (PX4_ISFINITE(cmd.param7)) {
+					rep->current.alt = cmd.param7;
 
-			if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_GO_AROUND) {
+				} else {
+					rep->current.alt = get_global_position()->alt;
+				}
 
-				// DO_GO_AROUND is currently handled by the position controller (unacknowledged)
-				// TODO: move DO_GO_AROUND handling to navigator
-				publish_vehicle_command_ack(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
+			} else if (PX4_ISFINITE(cmd.param7) && curr->current.valid
+				   && PX4_ISFINITE(curr->current.lat)
+				   && PX4_ISFINITE(curr->current.lon)) {
 
-			} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_REPOSITION) {
+				// Altitude without position change
+				rep->current.lat = curr->current.lat;
+				rep->current.lon = curr->current.lon;
+				rep->current.alt = cmd.param7;
 
-				position_setpoint_triplet_s *rep = get_reposition_triplet();
-				position_setpoint_triplet_s *curr = get_position_setpoint_triplet();
+			} else {
+				// All three set to NaN - hold in current position
+				rep->current.lat = get_global_position()->lat;
+				rep->current.lon = get_global_position()->lon;
+				rep->current.alt = get_global_position()->alt;
+			}
 
-				// store current position as previous position and goal as next
-				rep->previous.yaw = get_global_position()->yaw;
-				rep->previous.lat = get_global_position()->lat;
-				rep->previous.lon = get_global_position()->lon;
-				rep->previous.alt = get_global_position()->alt;
+			rep->previous.valid = true;
+			rep->previous.timestamp = hrt_absolute_time();
 
-				rep->current.loiter_radius = get_loiter_radius();
-				rep->current.loiter_direction = 1;
-				rep->current.type = position_setpoint_s::SETPOINT_TYPE_LOITER;
+			rep->current.valid = true;
+			rep->current.timestamp = hrt_absolute_time();
 
-				// If no argument for ground speed, use default value.
-				if (cmd.param1 <= 0 || !PX4_ISFINITE(cmd.param1)) {
-					rep->current.cruising_speed = get_cruising_speed();
+			rep->next.valid = false;
 
-				} else {
-					rep->current.cruising_speed = cmd.param1;
-				}
+			// CMD_DO_REPOSITION is acknowledged by commander
 
-				rep->current.cruising_throttle = get_cruising_throttle();
-				rep->current.acceptance_radius = get_acceptance_radius();
+		} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_NAV_TAKEOFF) {
+			position_setpoint_triplet_s *rep = get_takeoff_triplet();
 
-				// Go on and check which changes had been requested
-				if (PX4_ISFINITE(cmd.param4)) {
-					rep->current.yaw = cmd.param4;
-					rep->current.yaw_valid = true;
+			// store current position as previous position and goal as next
+			rep->previous.yaw = get_global_position()->yaw;
+			rep->previous.lat = get_global_position()->lat;
+			rep->previous.lon = get_global_position()->lon;
+			rep->previous.alt = get_global_position()->alt;
 
-				} else {
-					rep->current.yaw = NAN;
-					rep->current.yaw_valid = false;
-				}
+			rep->current.loiter_radius = get_loiter_radius();
+			rep->current.loiter_direction = 1;
+			rep->current.type = position_setpoint_s::SETPOINT_TYPE_TAKEOFF;
 
-				if (PX4_ISFINITE(cmd.param5) && PX4_ISFINITE(cmd.param6)) {
+			if (home_position_valid()) {
+				rep->current.yaw = cmd.param4;
 
-					// Position change with optional altitude change
-					rep->current.lat = cmd.param5;
-					rep->current.lon = cmd.param6;
+				rep->previous.valid = true;
+				rep->previous.timestamp = hrt_absolute_time();
 
-					if (PX4_ISFINITE(cmd.param7)) {
-						rep->current.alt = cmd.param7;
+			} else {
+				rep->current.yaw = get_local_position()->yaw;
+				rep->previous.valid = false;
+			}
 
-					} else {
-						rep->current.alt = get_global_position()->alt;
-					}
+			if (PX4_ISFINITE(cmd.param5) && PX4_ISFINITE(cmd.param6)) {
+				rep->current.lat = cmd.param5;
+				rep->current.lon = cmd.param6;
 
-				} else if (PX4_ISFINITE(cmd.param7) && curr->current.valid
-					   && PX4_ISFINITE(curr->current.lat)
-					   && PX4_ISFINITE(curr->current.lon)) {
+			} else {
+				// If one of them is non-finite, reset both
+				rep->current.lat = (double)NAN;
+				rep->current.lon = (double)NAN;
+			}
 
-					// Altitude without position change
-					rep->current.lat = curr->current.lat;
-					rep->current.lon = curr->current.lon;
-					rep->current.alt = cmd.param7;
+			rep->current.alt = cmd.param7;
 
-				} else {
-					// All three set to NaN - hold in current position
-					rep->current.lat = get_global_position()->lat;
-					rep->current.lon = get_global_position()->lon;
-					rep->current.alt = get_global_position()->alt;
-				}
+			rep->current.valid = true;
+			rep->current.timestamp = hrt_absolute_time();
 
-				rep->previous.valid = true;
-				rep->previous.timestamp = hrt_absolute_time();
+			rep->next.valid = false;
 
-				rep->current.valid = true;
-				rep->current.timestamp = hrt_absolute_time();
+			// CMD_NAV_TAKEOFF is acknowledged by commander
 
-				rep->next.valid = false;
+		} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_LAND_START) {
 
-				// CMD_DO_REPOSITION is acknowledged by commander
+			/* find NAV_CMD_DO_LAND_START in the mission and
+			 * use MAV_CMD_MISSION_START to start the mission there
+			 */
+			if (_mission.land_start()) {
+				vehicle_command_s vcmd = {};
+				vcmd.command = vehicle_command_s::VEHICLE_CMD_MISSION_START;
+				vcmd.param1 = _mission.get_land_start_index();
+				publish_vehicle_cmd(&vcmd);
 
-			} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_NAV_TAKEOFF) {
-				position_setpoint_triplet_s *rep = get_takeoff_triplet();
+			} else {
+				PX4_WARN("planned mission landing not available");
+			}
 
-				// store current position as previous position and goal as next
-				rep->previous.yaw = get_global_position()->yaw;
-				rep->previous.lat = get_global_position()->lat;
-				rep->previous.lon = get_global_position()->lon;
-				rep->previous.alt = get_global_position()->alt;
+			publish_vehicle_command_ack(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
 
-				rep->current.loiter_radius = get_loiter_radius();
-				rep->current.loiter_direction = 1;
-				rep->current.type = position_setpoint_s::SETPOINT_TYPE_TAKEOFF;
+		} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_MISSION_START) {
+			if (_mission_result.valid && PX4_ISFINITE(cmd.param1) && (cmd.param1 >= 0)) {
+				if (!_mission.set_current_mission_index(cmd.param1)) {
+					PX4_WARN("CMD_MISSION_START failed");
+				}
+			}
 
-				if (home_position_valid()) {
-					rep->current.yaw = cmd.param4;
+			// CMD_MISSION_START is acknowledged by commander
 
-					rep->previous.valid = true;
-					rep->previous.timestamp = hrt_absolute_time();
+		} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_CHANGE_SPEED) {
+			if (cmd.param2 > FLT_EPSILON) {
+				// XXX not differentiating ground and airspeed yet
+				set_cruising_speed(cmd.param2);
 
-				} else {
-					rep->current.yaw = get_local_position()->yaw;
-					rep->previous.valid = false;
-				}
+			} else {
+				set_cruising_speed();
 
-				if (PX4_ISFINITE(cmd.param5) && PX4_ISFINITE(cmd.param6)) {
-					rep->current.lat = cmd.param5;
-					rep->current.lon = cmd.param6;
+				/* if no speed target was given try to set throttle */
+				if (cmd.param3 > FLT_EPSILON) {
+					set_cruising_throttle(cmd.param3 / 100);
 
 				} else {
-					// If one of them is non-finite, reset both
-					rep->current.lat = (double)NAN;
-					rep->current.lon = (double)NAN;
+					set_cruising_throttle();
 				}
+			}
 
-				rep->current.alt = cmd.param7;
+			// TODO: handle responses for supported DO_CHANGE_SPEED options?
+			publish_vehicle_command_ack(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
 
-				rep->current.valid = true;
-				rep->current.timestamp = hrt_absolute_time();
+		} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_SET_ROI
+			   || cmd.command == vehicle_command_s::VEHICLE_CMD_NAV_ROI
+			   || cmd.command == vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_LOCATION
+			   || cmd.command == vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_WPNEXT_OFFSET
+			   || cmd.command == vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_NONE) {
+			_vroi = {};
 
-				rep->next.valid = false;
+			switch (cmd.command) {
+			case vehicle_command_s::VEHICLE_CMD_DO_SET_ROI:
+			case vehicle_command_s::VEHICLE_CMD_NAV_ROI:
+				_vroi.mode = cmd.param1;
+				break;
 
-				// CMD_NAV_TAKEOFF is acknowledged by commander
+			case vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_LOCATION:
+				_vroi.mode = vehicle_command_s::VEHICLE_ROI_LOCATION;
+				_vroi.lat = cmd.param5;
+				_vroi.lon = cmd.param6;
+				_vroi.alt = cmd.param7;
+				break;
 
-			} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_LAND_START) {
+			case vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_WPNEXT_OFFSET:
+				_vroi.mode = vehicle_command_s::VEHICLE_ROI_WPNEXT;
+				_vroi.pitch_offset = (float)cmd.param5 * M_DEG_TO_RAD_F;
+				_vroi.roll_offset = (float)cmd.param6 * M_DEG_TO_RAD_F;
+				_vroi.yaw_offset = (float)cmd.param7 * M_DEG_TO_RAD_F;
+				break;
 
-				/* find NAV_CMD_DO_LAND_START in the mission and
-				 * use MAV_CMD_MISSION_START to start the mission there
-				 */
-				if (_mission.land_start()) {
-					vehicle_command_s vcmd = {};
-					vcmd.command = vehicle_command_s::VEHICLE_CMD_MISSION_START;
-					vcmd.param1 = _mission.get_land_start_index();
-					publish_vehicle_cmd(&vcmd);
+			case vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_NONE:
+				_vroi.mode = vehicle_command_s::VEHICLE_ROI_NONE;
+				break;
 
-				} else {
-					PX4_WARN("planned mission landing not available");
-				}
+			default:
+				_vroi.mode = vehicle_command_s::VEHICLE_ROI_NONE;
+				break;
+			}
 
-				publish_vehicle_command_ack(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
+			_vroi.timestamp = hrt_absolute_time();
 
-			} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_MISSION_START) {
-				if (_mission_result.valid && PX4_ISFINITE(cmd.param1) && (cmd.param1 >= 0)) {
-					if (!_mission.set_current_mission_index(cmd.param1)) {
-						PX4_WARN("CMD_MISSION_START failed");
-					}
-				}
+			_vehicle_roi_pub.publish(_vroi);
 
-				// CMD_MISSION_START is acknowledged by commander
+			publish_vehicle_command_ack(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
+		}
+	}
 
-			} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_CHANGE_SPEED) {
-				if (cmd.param2 > FLT_EPSILON) {
-					// XXX not differentiating ground and airspeed yet
-					set_cruising_speed(cmd.param2);
+	/* Check for traffic */
+	check_traffic();
 
-				} else {
-					set_cruising_speed();
+	/* Check geofence violation */
+	if (_have_geofence_position_data &&
+	    (_geofence.getGeofenceAction() != geofence_result_s::GF_ACTION_NONE) &&
+	    (hrt_elapsed_time(&_last_geofence_check) > GEOFENCE_CHECK_INTERVAL)) {
 
-					/* if no speed target was given try to set throttle */
-					if (cmd.param3 > FLT_EPSILON) {
-						set_cruising_throttle(cmd.param3 / 100);
+		bool inside = _geofence.check(_global_pos, _gps_pos, _home_pos,
+					      home_position_valid());
+		_last_geofence_check = hrt_absolute_time();
+		_have_geofence_position_data = false;
 
-					} else {
-						set_cruising_throttle();
-					}
-				}
+		_geofence_result.timestamp = hrt_absolute_time();
+		_geofence_result.geofence_action = _geofence.getGeofenceAction();
+		_geofence_result.home_required = _geofence.isHomeRequired();
 
-				// TODO: handle responses for supported DO_CHANGE_SPEED options?
-				publish_vehicle_command_ack(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
-
-			} else if (cmd.command == vehicle_command_s::VEHICLE_CMD_DO_SET_ROI
-				   || cmd.command == vehicle_command_s::VEHICLE_CMD_NAV_ROI
-				   || cmd.command == vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_LOCATION
-				   || cmd.command == vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_WPNEXT_OFFSET
-				   || cmd.command == vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_NONE) {
-				_vroi = {};
-
-				switch (cmd.command) {
-				case vehicle_command_s::VEHICLE_CMD_DO_SET_ROI:
-				case vehicle_command_s::VEHICLE_CMD_NAV_ROI:
-					_vroi.mode = cmd.param1;
-					break;
-
-				case vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_LOCATION:
-					_vroi.mode = vehicle_command_s::VEHICLE_ROI_LOCATION;
-					_vroi.lat = cmd.param5;
-					_vroi.lon = cmd.param6;
-					_vroi.alt = cmd.param7;
-					break;
-
-				case vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_WPNEXT_OFFSET:
-					_vroi.mode = vehicle_command_s::VEHICLE_ROI_WPNEXT;
-					_vroi.pitch_offset = (float)cmd.param5 * M_DEG_TO_RAD_F;
-					_vroi.roll_offset = (float)cmd.param6 * M_DEG_TO_RAD_F;
-					_vroi.yaw_offset = (float)cmd.param7 * M_DEG_TO_RAD_F;
-					break;
-
-				case vehicle_command_s::VEHICLE_CMD_DO_SET_ROI_NONE:
-					_vroi.mode = vehicle_command_s::VEHICLE_ROI_NONE;
-					break;
-
-				default:
-					_vroi.mode = vehicle_command_s::VEHICLE_ROI_NONE;
-					break;
-				}
+		if (!inside) {
+			/* inform other apps via the mission result */
+			_geofence_result.geofence_violated = true;
 
-				_vroi.timestamp = hrt_absolute_time();
+			/* Issue a warning about the geofence violation once */
+			if (!_geofence_violation_warning_sent) {
+				mavlink_log_critical(&_mavlink_log_pub, "Geofence violation");
+				_geofence_violation_warning_sent = true;
+			}
 
-				_vehicle_roi_pub.publish(_vroi);
+		} else {
+			/* inform other apps via the mission result */
+			_geofence_result.geofence_violated = false;
 
-				publish_vehicle_command_ack(cmd, vehicle_command_s::VEHICLE_CMD_RESULT_ACCEPTED);
-			}
+			/* Reset the _geofence_violation_warning_sent field */
+			_geofence_violation_warning_sent = false;
 		}
 
-		/* Check for traffic */
-		check_traffic();
-
-		/* Check geofence violation */
-		if (have_geofence_position_data &&
-		    (_geofence.getGeofenceAction() != geofence_result_s::GF_ACTION_NONE) &&
-		    (hrt_elapsed_time(&last_geofence_check) > GEOFENCE_CHECK_INTERVAL)) {
+		_geofence_result_pub.publish(_geofence_result);
+	}
 
-			bool inside = _geofence.check(_global_pos, _gps_pos, _home_pos,
-						      home_position_valid());
-			last_geofence_check = hrt_absolute_time();
-			have_geofence_position_data = false;
+	/* Do stuff according to navigation state set by commander */
+	NavigatorMode *navigation_mode_new{nullptr};
 
-			_geofence_result.timestamp = hrt_absolute_time();
-			_geofence_result.geofence_action = _geofence.getGeofenceAction();
-			_geofence_result.home_required = _geofence.isHomeRequired();
+	switch (_vstatus.nav_state) {
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_MISSION:
+		_pos_sp_triplet_published_invalid_once = false;
 
-			if (!inside) {
-				/* inform other apps via the mission result */
-				_geofence_result.geofence_violated = true;
+		_mission.set_execution_mode(mission_result_s::MISSION_EXECUTION_MODE_NORMAL);
+		navigation_mode_new = &_mission;
 
-				/* Issue a warning about the geofence violation once */
-				if (!_geofence_violation_warning_sent) {
-					mavlink_log_critical(&_mavlink_log_pub, "Geofence violation");
-					_geofence_violation_warning_sent = true;
-				}
+		break;
 
-			} else {
-				/* inform other apps via the mission result */
-				_geofence_result.geofence_violated = false;
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_LOITER:
+		_pos_sp_triplet_published_invalid_once = false;
+		navigation_mode_new = &_loiter;
+		break;
 
-				/* Reset the _geofence_violation_warning_sent field */
-				_geofence_violation_warning_sent = false;
-			}
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_RCRECOVER:
+		_pos_sp_triplet_published_invalid_once = false;
+		navigation_mode_new = &_rcLoss;
+		break;
 
-			_geofence_result_pub.publish(_geofence_result);
-		}
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_RTL: {
+			_pos_sp_triplet_published_invalid_once = false;
 
-		/* Do stuff according to navigation state set by commander */
-		NavigatorMode *navigation_mode_new{nullptr};
+			const bool rtl_activated = _previous_nav_state != vehicle_status_s::NAVIGATION_STATE_AUTO_RTL;
 
-		switch (_vstatus.nav_state) {
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_MISSION:
-			_pos_sp_triplet_published_invalid_once = false;
+			switch (rtl_type()) {
+			case RTL::RTL_LAND: // use mission landing
+			case RTL::RTL_CLOSEST:
+				if (rtl_activated) {
+					if (rtl_type() == RTL::RTL_LAND) {
+						mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL LAND activated");
 
-			_mission.set_execution_mode(mission_result_s::MISSION_EXECUTION_MODE_NORMAL);
-			navigation_mode_new = &_mission;
+					} else {
+						mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL Closest landing point activated");
+					}
 
-			break;
+				}
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_LOITER:
-			_pos_sp_triplet_published_invalid_once = false;
-			navigation_mode_new = &_loiter;
-			break;
+				// if RTL is set to use a mission landing and mission has a planned landing, then use MISSION to fly there directly
+				if (on_mission_landing() && !get_land_detected()->landed) {
+					_mission.set_execution_mode(mission_result_s::MISSION_EXECUTION_MODE_FAST_FORWARD);
+					navigation_mode_new = &_mission;
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_RCRECOVER:
-			_pos_sp_triplet_published_invalid_once = false;
-			navigation_mode_new = &_rcLoss;
-			break;
+				} else {
+					navigation_mode_new = &_rtl;
+				}
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_RTL: {
-				_pos_sp_triplet_published_invalid_once = false;
+				break;
 
-				const bool rtl_activated = _previous_nav_state != vehicle_status_s::NAVIGATION_STATE_AUTO_RTL;
+			case RTL::RTL_MISSION:
+				if (_mission.get_land_start_available() && !get_land_detected()->landed) {
+					// the mission contains a landing spot
+					_mission.set_execution_mode(mission_result_s::MISSION_EXECUTION_MODE_FAST_FORWARD);
 
-				switch (rtl_type()) {
-				case RTL::RTL_LAND: // use mission landing
-				case RTL::RTL_CLOSEST:
-					if (rtl_activated) {
-						if (rtl_type() == RTL::RTL_LAND) {
-							mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL LAND activated");
+					if (_navigation_mode != &_mission) {
+						if (_navigation_mode == nullptr) {
+							// switching from an manual mode, go to landing if not already landing
+							if (!on_mission_landing()) {
+								start_mission_landing();
+							}
 
 						} else {
-							mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL Closest landing point activated");
+							// switching from an auto mode, continue the mission from the closest item
+							_mission.set_closest_item_as_current();
 						}
-
 					}
 
-					// if RTL is set to use a mission landing and mission has a planned landing, then use MISSION to fly there directly
-					if (on_mission_landing() && !get_land_detected()->landed) {
-						_mission.set_execution_mode(mission_result_s::MISSION_EXECUTION_MODE_FAST_FORWARD);
-						navigation_mode_new = &_mission;
-
-					} else {
-						navigation_mode_new = &_rtl;
+					if (rtl_activated) {
+						mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL Mission activated, continue mission");
 					}
 
-					break;
-
-				case RTL::RTL_MISSION:
-					if (_mission.get_land_start_available() && !get_land_detected()->landed) {
-						// the mission contains a landing spot
-						_mission.set_execution_mode(mission_result_s::MISSION_EXECUTION_MODE_FAST_FORWARD);
+					navigation_mode_new = &_mission;
 
-						if (_navigation_mode != &_mission) {
-							if (_navigation_mode == nullptr) {
-								// switching from an manual mode, go to landing if not already landing
-								if (!on_mission_landing()) {
-									start_mission_landing();
-								}
-
-							} else {
-								// switching from an auto mode, continue the mission from the closest item
-								_mission.set_closest_item_as_current();
-							}
+				} else {
+					// fly the mission in reverse if switching from a non-manual mode
+					_mission.set_execution_mode(mission_result_s::MISSION_EXECUTION_MODE_REVERSE);
+
+					if ((_navigation_mode != nullptr && (_navigation_mode != &_rtl || _mission.get_mission_changed())) &&
+					    (! _mission.get_mission_finished()) &&
+					    (!get_land_detected()->landed)) {
+						// determine the closest mission item if switching from a non-mission mode, and we are either not already
+						// mission mode or the mission waypoints changed.
+						// The seconds condition is required so that when no mission was uploaded and one is available the closest
+						// mission item is determined and also that if the user changes the active mission index while rtl is active
+						// always that waypoint is tracked first.
+						if ((_navigation_mode != &_mission) && (rtl_activated || _mission.get_mission_waypoints_changed())) {
+							_mission.set_closest_item_as_current();
 						}
 
 						if (rtl_activated) {
-							mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL Mission activated, continue mission");
+							mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL Mission activated, fly mission in reverse");
 						}
 
 						navigation_mode_new = &_mission;
 
 					} else {
-						// fly the mission in reverse if switching from a non-manual mode
-						_mission.set_execution_mode(mission_result_s::MISSION_EXECUTION_MODE_REVERSE);
-
-						if ((_navigation_mode != nullptr && (_navigation_mode != &_rtl || _mission.get_mission_changed())) &&
-						    (! _mission.get_mission_finished()) &&
-						    (!get_land_detected()->landed)) {
-							// determine the closest mission item if switching from a non-mission mode, and we are either not already
-							// mission mode or the mission waypoints changed.
-							// The seconds condition is required so that when no mission was uploaded and one is available the closest
-							// mission item is determined and also that if the user changes the active mission index while rtl is active
-							// always that waypoint is tracked first.
-							if ((_navigation_mode != &_mission) && (rtl_activated || _mission.get_mission_waypoints_changed())) {
-								_mission.set_closest_item_as_current();
-							}
-
-							if (rtl_activated) {
-								mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL Mission activated, fly mission in reverse");
-							}
-
-							navigation_mode_new = &_mission;
-
-						} else {
-							if (rtl_activated) {
-								mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL Mission activated, fly to home");
-							}
-
-							navigation_mode_new = &_rtl;
+						if (rtl_activated) {
+							mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL Mission activated, fly to home");
 						}
-					}
 
-					break;
-
-				default:
-					if (rtl_activated) {
-						mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL HOME activated");
+						navigation_mode_new = &_rtl;
 					}
+				}
 
-					navigation_mode_new = &_rtl;
-					break;
+				break;
 
+			default:
+				if (rtl_activated) {
+					mavlink_and_console_log_info(get_mavlink_log_pub(), "RTL HOME activated");
 				}
 
+				navigation_mode_new = &_rtl;
 				break;
-			}
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_TAKEOFF:
-			_pos_sp_triplet_published_invalid_once = false;
-			navigation_mode_new = &_takeoff;
-			break;
+			}
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_LAND:
-			_pos_sp_triplet_published_invalid_once = false;
-			navigation_mode_new = &_land;
 			break;
+		}
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_PRECLAND:
-			_pos_sp_triplet_published_invalid_once = false;
-			navigation_mode_new = &_precland;
-			_precland.set_mode(PrecLandMode::Required);
-			break;
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_TAKEOFF:
+		_pos_sp_triplet_published_invalid_once = false;
+		navigation_mode_new = &_takeoff;
+		break;
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_RTGS:
-			_pos_sp_triplet_published_invalid_once = false;
-			navigation_mode_new = &_dataLinkLoss;
-			break;
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_LAND:
+		_pos_sp_triplet_published_invalid_once = false;
+		navigation_mode_new = &_land;
+		break;
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_LANDENGFAIL:
-			_pos_sp_triplet_published_invalid_once = false;
-			navigation_mode_new = &_engineFailure;
-			break;
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_PRECLAND:
+		_pos_sp_triplet_published_invalid_once = false;
+		navigation_mode_new = &_precland;
+		_precland.set_mode(PrecLandMode::Required);
+		break;
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_LANDGPSFAIL:
-			_pos_sp_triplet_published_invalid_once = false;
-			navigation_mode_new = &_gpsFailure;
-			break;
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_RTGS:
+		_pos_sp_triplet_published_invalid_once = false;
+		navigation_mode_new = &_dataLinkLoss;
+		break;
 
-		case vehicle_status_s::NAVIGATION_STATE_AUTO_FOLLOW_TARGET:
-			_pos_sp_triplet_published_invalid_once = false;
-			navigation_mode_new = &_follow_target;
-			break;
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_LANDENGFAIL:
+		_pos_sp_triplet_published_invalid_once = false;
+		navigation_mode_new = &_engineFailure;
+		break;
 
-		case vehicle_status_s::NAVIGATION_STATE_MANUAL:
-		case vehicle_status_s::NAVIGATION_STATE_ACRO:
-		case vehicle_status_s::NAVIGATION_STATE_ALTCTL:
-		case vehicle_status_s::NAVIGATION_STATE_POSCTL:
-		case vehicle_status_s::NAVIGATION_STATE_DESCEND:
-		case vehicle_status_s::NAVIGATION_STATE_TERMINATION:
-		case vehicle_status_s::NAVIGATION_STATE_OFFBOARD:
-		case vehicle_status_s::NAVIGATION_STATE_STAB:
-		default:
-			navigation_mode_new = nullptr;
-			_can_loiter_at_sp = false;
-			break;
-		}
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_LANDGPSFAIL:
+		_pos_sp_triplet_published_invalid_once = false;
+		navigation_mode_new = &_gpsFailure;
+		break;
 
-		// Do not execute any state machine while we are disarmed
-		if (_vstatus.arming_state != vehicle_status_s::ARMING_STATE_ARMED) {
-			navigation_mode_new = nullptr;
-		}
+	case vehicle_status_s::NAVIGATION_STATE_AUTO_FOLLOW_TARGET:
+		_pos_sp_triplet_published_invalid_once = false;
+		navigation_mode_new = &_follow_target;
+		break;
 
-		// update the vehicle status
-		_previous_nav_state = _vstatus.nav_state;
-
-		/* we have a new navigation mode: reset triplet */
-		if (_navigation_mode != navigation_mode_new) {
-			// We don't reset the triplet if we just did an auto-takeoff and are now
-			// going to loiter. Otherwise, we lose the takeoff altitude and end up lower
-			// than where we wanted to go.
-			//
-			// FIXME: a better solution would be to add reset where they are needed and remove
-			//        this general reset here.
-			if (!(_navigation_mode == &_takeoff &&
-			      navigation_mode_new == &_loiter)) {
-				reset_triplets();
-			}
-		}
+	case vehicle_status_s::NAVIGATION_STATE_MANUAL:
+	case vehicle_status_s::NAVIGATION_STATE_ACRO:
+	case vehicle_status_s::NAVIGATION_STATE_ALTCTL:
+	case vehicle_status_s::NAVIGATION_STATE_POSCTL:
+	case vehicle_status_s::NAVIGATION_STATE_DESCEND:
+	case vehicle_status_s::NAVIGATION_STATE_TERMINATION:
+	case vehicle_status_s::NAVIGATION_STATE_OFFBOARD:
+	case vehicle_status_s::NAVIGATION_STATE_STAB:
+	default:
+		navigation_mode_new = nullptr;
+		_can_loiter_at_sp = false;
+		break;
+	}
 
-		_navigation_mode = navigation_mode_new;
+	// Do not execute any state machine while we are disarmed
+	if (_vstatus.arming_state != vehicle_status_s::ARMING_STATE_ARMED) {
+		navigation_mode_new = nullptr;
+	}
 
-		/* iterate through navigation modes and set active/inactive for each */
-		for (unsigned int i = 0; i < NAVIGATOR_MODE_ARRAY_SIZE; i++) {
-			_navigation_mode_array[i]->run(_navigation_mode == _navigation_mode_array[i]);
+	// update the vehicle status
+	_previous_nav_state = _vstatus.nav_state;
+
+	/* we have a new navigation mode: reset triplet */
+	if (_navigation_mode != navigation_mode_new) {
+		// We don't reset the triplet if we just did an auto-takeoff and are now
+		// going to loiter. Otherwise, we lose the takeoff altitude and end up lower
+		// than where we wanted to go.
+		//
+		// FIXME: a better solution would be to add reset where they are needed and remove
+		//        this general reset here.
+		if (!(_navigation_mode == &_takeoff &&
+		      navigation_mode_new == &_loiter)) {
+			reset_triplets();
 		}
+	}
 
-		/* if we landed and have not received takeoff setpoint then stay in idle */
-		if (_land_detected.landed &&
-		    !((_vstatus.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_TAKEOFF)
-		      || (_vstatus.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_MISSION))) {
+	_navigation_mode = navigation_mode_new;
 
-			reset_triplets();
+	/* iterate through navigation modes and set active/inactive for each */
+	for (unsigned int i = 0; i < NAVIGATOR_MODE_ARRAY_SIZE; i++) {
+		_navigation_mode_array[i]->run(_navigation_mode == _navigation_mode_array[i]);
+	}
 
-			_pos_sp_triplet.current.type = position_setpoint_s::SETPOINT_TYPE_IDLE;
-			_pos_sp_triplet.current.valid = true;
-			_pos_sp_triplet.current.timestamp = hrt_absolute_time();
-		}
+	/* if we landed and have not received takeoff setpoint then stay in idle */
+	if (_land_detected.landed &&
+	    !((_vstatus.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_TAKEOFF)
+	      || (_vstatus.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_MISSION))) {
 
-		/* if nothing is running, set position setpoint triplet invalid once */
-		if (_navigation_mode == nullptr && !_pos_sp_triplet_published_invalid_once) {
-			_pos_sp_triplet_published_invalid_once = true;
-			reset_triplets();
-		}
+		reset_triplets();
 
-		if (_pos_sp_triplet_updated) {
-			publish_position_setpoint_triplet();
-		}
+		_pos_sp_triplet.current.type = position_setpoint_s::SETPOINT_TYPE_IDLE;
+		_pos_sp_triplet.current.valid = true;
+		_pos_sp_triplet.current.timestamp = hrt_absolute_time();
+	}
 
-		if (_mission_result_updated) {
-			publish_mission_result();
-		}
+	/* if nothing is running, set position setpoint triplet invalid once */
+	if (_navigation_mode == nullptr && !_pos_sp_triplet_published_invalid_once) {
+		_pos_sp_triplet_published_invalid_once = true;
+		reset_triplets();
+	}
 
-		perf_end(_loop_perf);
+	if (_pos_sp_triplet_updated) {
+		publish_position_setpoint_triplet();
 	}
-}
 
-int Navigator::task_spawn(int argc, char *argv[])
-{
-	_task_id = px4_task_spawn_cmd("navigator",
-				      SCHED_DEFAULT,
-				      SCHED_PRIORITY_NAVIGATION,
-				      1800,
-				      (px4_main_t)&run_trampoline,
-				      (char *const *)argv);
-
-	if (_task_id < 0) {
-		_task_id = -1;
-		return -errno;
+	if (_mission_result_updated) {
+		publish_mission_result();
 	}
 
-	return 0;
+	perf_end(_loop_perf);
+
+	// run at least once per second, also without any wakeup source being published
+	ScheduleDelayed(1_s);
 }
 
-Navigator *Navigator::instantiate(int argc, char *argv[])
+int Navigator::task_spawn(int argc, char *argv[])
 {
 	Navigator *instance = new Navigator();
 
-	if (instance == nullptr) {
+	if (instance) {
+		_object.store(instance);
+		_task_id = task_id_is_work_queue;
+
+		if (instance->init()) {
+			return PX4_OK;
+		}
+
+	} else {
 		PX4_ERR("alloc failed");
 	}
 
-	return instance;
+	delete instance;
+	_object.store(nullptr);
+	_task_id = -1;
+
+	return PX4_ERROR;
 }
 
 int
@@ -740,6 +731,7 @@ Navigator::print_status()
 	PX4_INFO("Running");
 
 	_geofence.printStatus();
+	_mission_cache.printStatus();
 	return 0;
 }
 
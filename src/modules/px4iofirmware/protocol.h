@@ -80,7 +80,7 @@
 
 #define REG_TO_BOOL(_reg) 	((bool)(_reg))
 
-#define PX4IO_PROTOCOL_VERSION		4
+#define PX4IO_PROTOCOL_VERSION		5
 
 /* maximum allowable sizes on this protocol version */
 #define PX4IO_PROTOCOL_MAX_CONTROL_COUNT	8	/**< The protocol does not support more than set here, individual units might support less - see PX4IO_P_CONFIG_CONTROL_COUNT */
@@ -325,7 +325,7 @@ struct px4io_mixdata {
  * Serial protocol encapsulation.
  */
 
-#define PKT_MAX_REGS	32 // by agreement w/FMU
+#define PKT_MAX_REGS	62 // by agreement w/FMU, limited by PKT_COUNT_MASK
 
 #pragma pack(push, 1)
 struct IOPacket {
@@ -343,6 +343,7 @@ struct IOPacket {
 
 #define PKT_CODE_READ		0x00	/* FMU->IO read transaction */
 #define PKT_CODE_WRITE		0x40	/* FMU->IO write transaction */
+#define PKT_CODE_BATCH		0xc0	/* FMU->IO batch of read and write transactions */
 #define PKT_CODE_SUCCESS	0x00	/* IO->FMU success reply */
 #define PKT_CODE_CORRUPT	0x40	/* IO->FMU bad packet reply */
 #define PKT_CODE_ERROR		0x80	/* IO->FMU register op error reply */
@@ -354,6 +355,27 @@ struct IOPacket {
 #define PKT_CODE(_p)	((_p).count_code & PKT_CODE_MASK)
 #define PKT_SIZE(_p)	((size_t)((uint8_t *)&((_p).regs[PKT_COUNT(_p)]) - ((uint8_t *)&(_p))))
 
+/*
+ * A batch packet carries a sequence of transactions in regs[], each a two register header
+ * (page | offset << 8, count | flags) followed by the count values to write, or the space
+ * for the values to read. The page and offset fields of the packet are unused.
+ *
+ * IO handles the transactions in order and replies with the same layout, the values read
+ * filled in and PKT_BATCH_ERROR set on the transactions that failed.
+ */
+#define PKT_BATCH_HEADER_SIZE		2
+#define PKT_BATCH_WRITE			0x8000	/* transaction is a write */
+#define PKT_BATCH_ERROR			0x4000	/* IO->FMU transaction failed */
+#define PKT_BATCH_COUNT_MASK		0x00ff
+
+#define PKT_BATCH_ADDRESS(_page, _offset)	((uint16_t)((_page) | ((_offset) << 8)))
+#define PKT_BATCH_PAGE(_header)		((uint8_t)((_header)[0] & 0xff))
+#define PKT_BATCH_OFFSET(_header)	((uint8_t)((_header)[0] >> 8))
+#define PKT_BATCH_COUNT(_header)	((unsigned)((_header)[1] & PKT_BATCH_COUNT_MASK))
+
+/* pseudo page of the FMU side interface: a read of this page transfers a batch in place */
+#define PX4IO_PAGE_BATCH		0xff
+
 static const uint8_t crc8_tab[256] __attribute__((unused)) = {
 	0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15,
 	0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
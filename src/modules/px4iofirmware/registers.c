@@ -1047,6 +1047,60 @@ registers_get(uint8_t page, uint8_t offset, uint16_t **values, unsigned *num_val
 	return 0;
 }
 
+/*
+ * Handle a batch of transactions in place, see PKT_CODE_BATCH.
+ *
+ * Returns the number of failed transactions, or -1 if the batch is malformed.
+ */
+int
+registers_batch(uint16_t *regs, unsigned num_regs)
+{
+	int errors = 0;
+	unsigned index = 0;
+
+	while (index < num_regs) {
+
+		if (index + PKT_BATCH_HEADER_SIZE > num_regs) {
+			return -1;
+		}
+
+		uint16_t *header = &regs[index];
+		uint16_t *data = &regs[index + PKT_BATCH_HEADER_SIZE];
+		unsigned count = PKT_BATCH_COUNT(header);
+
+		index += PKT_BATCH_HEADER_SIZE + count;
+
+		if (index > num_regs) {
+			return -1;
+		}
+
+		bool failed;
+
+		if (header[1] & PKT_BATCH_WRITE) {
+			failed = registers_set(PKT_BATCH_PAGE(header), PKT_BATCH_OFFSET(header), data, count) != 0;
+
+		} else {
+			uint16_t *values;
+			unsigned num_values;
+
+			/* unlike a single read the reply size is fixed, so a short read is an error */
+			failed = (registers_get(PKT_BATCH_PAGE(header), PKT_BATCH_OFFSET(header), &values, &num_values) < 0)
+				 || (num_values < count);
+
+			if (!failed) {
+				memcpy(data, values, count * 2);
+			}
+		}
+
+		if (failed) {
+			header[1] |= PKT_BATCH_ERROR;
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
 /*
  * Helper function to handle changes to the PWM rate control registers.
  */
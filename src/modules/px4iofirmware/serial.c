@@ -212,6 +212,21 @@ rx_handle_packet(void)
 		return;
 	}
 
+	if (PKT_CODE(dma_packet) == PKT_CODE_BATCH) {
+
+		/* a batch of transactions - the reply has the same size, with the values read filled in */
+		int errors = registers_batch(&dma_packet.regs[0], PKT_COUNT(dma_packet));
+
+		if (errors >= 0) {
+			if (errors > 0) {
+				perf_count(pc_regerr);
+			}
+
+			dma_packet.count_code = PKT_COUNT(dma_packet) | PKT_CODE_SUCCESS;
+			return;
+		}
+	}
+
 	/* send a bad-packet error reply */
 	dma_packet.count_code = PKT_CODE_CORRUPT;
 	dma_packet.page = 0xff;
@@ -147,9 +147,39 @@ RCUpdate::parameters_updated()
 		param_get(_parameter_handles.rc_map_param[i], &(_parameters.rc_map_param[i]));
 	}
 
+	update_channel_scaling();
 	update_rc_functions();
 }
 
+void
+RCUpdate::update_channel_scaling()
+{
+	for (unsigned i = 0; i < RC_MAX_CHAN_COUNT; i++) {
+		const float min = _parameters.min[i];
+		const float max = _parameters.max[i];
+		const float trim = _parameters.trim[i];
+		const float dz = _parameters.dz[i];
+		const float sign = _parameters.rev[i] ? -1.f : 1.f;
+
+		_scaling.min[i] = min;
+		_scaling.max[i] = max;
+		_scaling.trim_hi[i] = trim + dz;
+		_scaling.trim_lo[i] = trim - dz;
+
+		/*
+		 * Scale around the mid point differently for the lower and upper range, as they don't share the same
+		 * endpoints and slope: normalize to 0..1 with the correct sign (below or above center), the total range
+		 * is 2 (-1..1). If the upper or lower range is empty (e.g. trim == max) the constrained value can never
+		 * be in it, use a zero scale instead of dividing by zero.
+		 */
+		const float range_hi = max - trim - dz;
+		const float range_lo = trim - min - dz;
+
+		_scaling.scale_hi[i] = (range_hi > 0.f) ? sign / range_hi : 0.f;
+		_scaling.scale_lo[i] = (range_lo > 0.f) ? sign / range_lo : 0.f;
+	}
+}
+
 void
 RCUpdate::update_rc_functions()
 {
@@ -380,50 +410,12 @@ RCUpdate::Run()
 
 		/* read out and scale values from raw message even if signal is invalid */
 		for (unsigned int i = 0; i < channel_limit; i++) {
+			/* constrain to min/max values, then scale the part above or below the dead zone (the other is 0) */
+			const float value = math::constrain((float)rc_input.values[i], _scaling.min[i], _scaling.max[i]);
+			const float above = math::max(value - _scaling.trim_hi[i], 0.f);
+			const float below = math::min(value - _scaling.trim_lo[i], 0.f);
 
-			/*
-			 * 1) Constrain to min/max values, as later processing depends on bounds.
-			 */
-			rc_input.values[i] = math::constrain(rc_input.values[i], _parameters.min[i], _parameters.max[i]);
-
-			/*
-			 * 2) Scale around the mid point differently for lower and upper range.
-			 *
-			 * This is necessary as they don't share the same endpoints and slope.
-			 *
-			 * First normalize to 0..1 range with correct sign (below or above center),
-			 * the total range is 2 (-1..1).
-			 * If center (trim) == min, scale to 0..1, if center (trim) == max,
-			 * scale to -1..0.
-			 *
-			 * As the min and max bounds were enforced in step 1), division by zero
-			 * cannot occur, as for the case of center == min or center == max the if
-			 * statement is mutually exclusive with the arithmetic NaN case.
-			 *
-			 * DO NOT REMOVE OR ALTER STEP 1!
-			 */
-			if (rc_input.values[i] > (_parameters.trim[i] + _parameters.dz[i])) {
-				_rc.channels[i] = (rc_input.values[i] - _parameters.trim[i] - _parameters.dz[i]) / (float)(
-							  _parameters.max[i] - _parameters.trim[i] - _parameters.dz[i]);
-
-			} else if (rc_input.values[i] < (_parameters.trim[i] - _parameters.dz[i])) {
-				_rc.channels[i] = (rc_input.values[i] - _parameters.trim[i] + _parameters.dz[i]) / (float)(
-							  _parameters.trim[i] - _parameters.min[i] - _parameters.dz[i]);
-
-			} else {
-				/* in the configured dead zone, output zero */
-				_rc.channels[i] = 0.0f;
-			}
-
-			if (_parameters.rev[i]) {
-				_rc.channels[i] = -_rc.channels[i];
-			}
-
-
-			/* handle any parameter-induced blowups */
-			if (!PX4_ISFINITE(_rc.channels[i])) {
-				_rc.channels[i] = 0.0f;
-			}
+			_rc.channels[i] = _scaling.scale_hi[i] * above + _scaling.scale_lo[i] * below;
 		}
 
 		_rc.channel_count = rc_input.channel_count;
@@ -104,6 +104,11 @@ private:
 	 */
 	void		parameters_updated();
 
+	/**
+	 * Compile the channel calibration parameters into the per-channel scaling table.
+	 */
+	void		update_channel_scaling();
+
 	/**
 	 * Get and limit value for specified RC function. Returns NAN if not mapped.
 	 */
@@ -135,6 +140,20 @@ private:
 		int32_t rc_map_param[rc_parameter_map_s::RC_PARAM_MAP_NCHAN];
 	} _parameters{};
 
+	/**
+	 * Channel calibration compiled on parameter change (structure of arrays), a channel is normalized with
+	 * constrain(value, min, max), then scale_hi * max(value - trim_hi, 0) + scale_lo * min(value - trim_lo, 0).
+	 * The reversal is folded into the scales, and a scale is 0 if its side of the range is empty.
+	 */
+	struct ChannelScaling {
+		float min[RC_MAX_CHAN_COUNT];
+		float max[RC_MAX_CHAN_COUNT];
+		float trim_hi[RC_MAX_CHAN_COUNT];	///< trim + deadzone
+		float trim_lo[RC_MAX_CHAN_COUNT];	///< trim - deadzone
+		float scale_hi[RC_MAX_CHAN_COUNT];
+		float scale_lo[RC_MAX_CHAN_COUNT];
+	} _scaling{};
+
 	struct ParameterHandles {
 		param_t min[RC_MAX_CHAN_COUNT];
 		param_t trim[RC_MAX_CHAN_COUNT];
@@ -48,6 +48,7 @@
 #include <px4_platform_common/shutdown.h>
 #include <lib/parameters/param.h>
 
+#include <algorithm>
 #include <cstring>
 #include <float.h>
 #include <fstream>
@@ -366,18 +367,17 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 			    "float accelerometer_integral_dt;") {
 
 				int gyro_integral_dt_offset_log;
-				int gyro_integral_dt_offset_intern;
 				int accelerometer_integral_dt_offset_log;
-				int accelerometer_integral_dt_offset_intern;
 				int unused;
+				const orb_field *gyro_integral_dt_intern = orb_find_field(orb_meta, "gyro_integral_dt");
+				const orb_field *accelerometer_integral_dt_intern = orb_find_field(orb_meta, "accelerometer_integral_dt");
 
 				if (findFieldOffset(file_format, "gyro_integral_dt", gyro_integral_dt_offset_log, unused) &&
-				    findFieldOffset(orb_meta->o_fields, "gyro_integral_dt", gyro_integral_dt_offset_intern, unused) &&
 				    findFieldOffset(file_format, "accelerometer_integral_dt", accelerometer_integral_dt_offset_log, unused) &&
-				    findFieldOffset(orb_meta->o_fields, "accelerometer_integral_dt", accelerometer_integral_dt_offset_intern, unused)) {
+				    gyro_integral_dt_intern && accelerometer_integral_dt_intern) {
 
-					compat = new CompatSensorCombinedDtType(gyro_integral_dt_offset_log, gyro_integral_dt_offset_intern,
-										accelerometer_integral_dt_offset_log, accelerometer_integral_dt_offset_intern);
+					compat = new CompatSensorCombinedDtType(gyro_integral_dt_offset_log, gyro_integral_dt_intern->offset,
+										accelerometer_integral_dt_offset_log, accelerometer_integral_dt_intern->offset);
 				}
 			}
 		}
@@ -396,18 +396,19 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 	subscription->compat = compat;
 
 	//find the timestamp offset
-	int field_size;
-	bool timestamp_found = findFieldOffset(orb_meta->o_fields, "timestamp", subscription->timestamp_offset, field_size);
+	const orb_field *timestamp_field = orb_find_field(orb_meta, "timestamp");
 
-	if (!timestamp_found) {
+	if (!timestamp_field) {
 		return true;
 	}
 
-	if (field_size != 8) {
-		PX4_ERR("Unsupported timestamp with size %i, ignoring the topic %s", field_size, orb_meta->o_name);
+	if (timestamp_field->type != ORB_FIELD_TYPE_UINT64 || timestamp_field->array_size != 0) {
+		PX4_ERR("Unsupported timestamp type, ignoring the topic %s", orb_meta->o_name);
 		return true;
 	}
 
+	subscription->timestamp_offset = timestamp_field->offset;
+
 	//find first data message (and the timestamp)
 	streampos cur_pos = file.tellg();
 	subscription->next_read_pos = this_message_pos; //this will be skipped
@@ -440,39 +441,36 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 bool
 Replay::findFieldOffset(const string &format, const string &field_name, int &offset, int &field_size)
 {
-	size_t prev_field_end = 0;
-	size_t field_end = format.find(';');
-	offset = 0;
-	field_size = 0;
+	return ulog::ULogReader::findFieldOffset(format.c_str(), field_name.c_str(), offset, field_size);
+}
 
-	while (field_end != string::npos) {
-		size_t space_pos = format.find(' ', prev_field_end);
+bool
+Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position)
+{
+	ulog_message_header_s message_header;
+
+	if (_reader.isOpen()) {
+		// only visit the indexed messages in the range
+		const std::vector<uint64_t> &messages = _reader.additionalMessages();
+		auto it = std::lower_bound(messages.begin(), messages.end(), (uint64_t)file.tellg());
 
-		if (space_pos != string::npos) {
-			string type_name_full = format.substr(prev_field_end, space_pos - prev_field_end);
-			string cur_field_name = format.substr(space_pos + 1, field_end - space_pos - 1);
+		for (; it != messages.end() && (streamoff) * it < (streamoff)end_position; ++it) {
+			_reader.messageHeader(*it, message_header);
+			file.seekg(*it + ULOG_MSG_HEADER_LEN);
 
-			if (cur_field_name == field_name) {
-				field_size = sizeOfFullType(type_name_full);
-				return true;
+			if (message_header.msg_type == (int)ULogMessageType::PARAMETER) {
+				if (!readAndApplyParameter(file, message_header.msg_size)) {
+					return false;
+				}
 
 			} else {
-				offset += sizeOfFullType(type_name_full);
+				readDropout(file, message_header.msg_size);
 			}
 		}
 
-		prev_field_end = field_end + 1;
-		field_end = format.find(';', prev_field_end);
+		return true;
 	}
 
-	return false;
-}
-
-bool
-Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position)
-{
-	ulog_message_header_s message_header;
-
 	while (file.tellg() < end_position) {
 		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
 
@@ -556,6 +554,10 @@ Replay::readDropout(std::ifstream &file, uint16_t msg_size)
 bool
 Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id)
 {
+	if (_reader.isOpen()) {
+		return nextIndexedDataMessage(subscription, msg_id);
+	}
+
 	ulog_message_header_s message_header;
 	file.seekg(subscription.next_read_pos);
 	//ignore the first message (it's data we already read)
@@ -638,76 +640,63 @@ Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg
 	return file.good();
 }
 
-const orb_metadata *
-Replay::findTopic(const std::string &name)
+bool
+Replay::nextIndexedDataMessage(Subscription &subscription, int msg_id)
 {
-	const orb_metadata *const *topics = orb_get_topics();
+	const std::vector<uint64_t> &index = _reader.dataMessages(msg_id);
 
-	for (size_t i = 0; i < orb_topics_count(); i++) {
-		if (name == topics[i]->o_name) {
-			return topics[i];
+	// skip the current message (or the ADD_LOGGED_MSG for a new subscription)
+	auto it = std::upper_bound(index.begin() + std::min(subscription.next_index, index.size()), index.end(),
+				   (uint64_t)(streamoff)subscription.next_read_pos);
+
+	for (; it != index.end(); ++it) {
+		ulog_message_header_s message_header;
+		_reader.messageHeader(*it, message_header);
+
+		if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
+			subscription.next_index = it - index.begin();
+			subscription.next_read_pos = *it;
+			memcpy(&subscription.next_timestamp, _reader.messagePayload(*it) + 2 + subscription.timestamp_offset,
+			       sizeof(subscription.next_timestamp));
+			return true;
 		}
+
+		//sanity check failed!
+		PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
+			subscription.orb_meta->o_name, message_header.msg_size,
+			subscription.orb_meta->o_size_no_padding + 2);
 	}
 
-	return nullptr;
+	//no more data messages for this subscription
+	subscription.orb_meta = nullptr;
+	return true;
 }
 
-std::string
-Replay::extractArraySize(const std::string &type_name_full, int &array_size)
+bool
+Replay::buildDataIndex()
 {
-	size_t start_pos = type_name_full.find('[');
-	size_t end_pos = type_name_full.find(']');
-
-	if (start_pos == string::npos || end_pos == string::npos) {
-		array_size = 1;
-		return type_name_full;
+	if (!_reader.open(_replay_file)) {
+		PX4_WARN("failed to map the log, reading it sequentially");
+		return false;
 	}
 
-	array_size = atoi(type_name_full.substr(start_pos + 1, end_pos - start_pos - 1).c_str());
-	return type_name_full.substr(0, start_pos);
+	size_t num_data_messages = _reader.buildIndex((streamoff)_data_section_start, _read_until_file_position);
+	PX4_INFO("Indexed %zu data messages", num_data_messages);
+	return true;
 }
 
-size_t
-Replay::sizeOfType(const std::string &type_name)
+const orb_metadata *
+Replay::findTopic(const std::string &name)
 {
-	if (type_name == "int8_t" || type_name == "uint8_t") {
-		return 1;
-
-	} else if (type_name == "int16_t" || type_name == "uint16_t") {
-		return 2;
-
-	} else if (type_name == "int32_t" || type_name == "uint32_t") {
-		return 4;
-
-	} else if (type_name == "int64_t" || type_name == "uint64_t") {
-		return 8;
-
-	} else if (type_name == "float") {
-		return 4;
-
-	} else if (type_name == "double") {
-		return 8;
-
-	} else if (type_name == "char" || type_name == "bool") {
-		return 1;
-	}
-
-	const orb_metadata *orb_meta = findTopic(type_name);
+	const orb_metadata *const *topics = orb_get_topics();
 
-	if (orb_meta) {
-		return orb_meta->o_size;
+	for (size_t i = 0; i < orb_topics_count(); i++) {
+		if (name == topics[i]->o_name) {
+			return topics[i];
+		}
 	}
 
-	PX4_ERR("unknown type: %s", type_name.c_str());
-	return 0;
-}
-
-size_t
-Replay::sizeOfFullType(const std::string &type_name_full)
-{
-	int array_size;
-	string type_name = extractArraySize(type_name_full, array_size);
-	return sizeOfType(type_name) * array_size;
+	return nullptr;
 }
 
 bool
@@ -750,13 +739,27 @@ Replay::run()
 		return;
 	}
 
+	ulog_message_header_s message_header;
+
+	if (buildDataIndex()) {
+		// add all subscriptions upfront, their data messages are known from the index
+		for (uint64_t pos : _reader.addLoggedMessages()) {
+			replay_file.seekg(pos);
+			replay_file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+
+			if (!readAndAddSubscription(replay_file, message_header.msg_size)) {
+				PX4_ERR("Failed to read subscription");
+				return;
+			}
+		}
+	}
+
 	onEnterMainLoop();
 
 	_replay_start_time = hrt_absolute_time();
 
 	PX4_INFO("Replay in progress...");
 
-	ulog_message_header_s message_header;
 	replay_file.seekg(_data_section_start);
 
 	//we know the next message must be an ADD_LOGGED_MSG
@@ -852,6 +855,7 @@ Replay::run()
 
 		//TODO: add parameter -q?
 		replay_file.close();
+		_reader.close();
 		px4_shutdown_request(false, false);
 	}
 
@@ -864,6 +868,11 @@ Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_fil
 	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
 	_read_buffer.reserve(msg_write_size);
+
+	if (_reader.isOpen()) {
+		memcpy(_read_buffer.data(), _reader.messagePayload((streamoff)sub.next_read_pos) + 2, msg_read_size);
+		return;
+	}
 	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
 	replay_file.read((char *)_read_buffer.data(), msg_read_size);
 }
@@ -1051,6 +1060,9 @@ the log file to be replayed. The second is the mode, specified via `replay_mode`
 - Generic otherwise: this can be used to replay any module(s), but the replay will be done with the same speed as the
   log was recorded.
 
+The log file is memory mapped and all data messages are indexed before the replay starts, so that the next
+message of each topic is found without reading through the file.
+
 The module is typically used together with uORB publisher rules, to specify which messages should be replayed.
 The replay module will just publish all messages that are found in the log. It also applies the parameters from
 the log.
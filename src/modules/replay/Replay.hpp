@@ -41,6 +41,7 @@
 
 #include "definitions.hpp"
 
+#include <lib/ulog/ULogReader.hpp>
 #include <px4_platform_common/module.h>
 #include <uORB/uORBTopics.h>
 #include <uORB/topics/ekf2_timestamps.h>
@@ -137,6 +138,8 @@ protected:
 		std::streampos next_read_pos;
 		uint64_t next_timestamp; ///< timestamp of the file
 
+		size_t next_index = 0; ///< position in the data index of the next message (if indexed)
+
 		CompatBase *compat = nullptr;
 
 		// statistics
@@ -222,6 +225,17 @@ private:
 
 	int64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
 
+	ulog::ULogReader _reader; ///< memory mapped replay file (if open, data messages are read from the index)
+
+	/**
+	 * Map the replay file into memory and index all data messages, so that the next message
+	 * of a subscription can be found without reading through the file.
+	 * @return true on success, otherwise the file is read sequentially
+	 */
+	bool buildDataIndex();
+
+	bool nextIndexedDataMessage(Subscription &subscription, int msg_id);
+
 	bool readFileHeader(std::ifstream &file);
 
 	/**
@@ -255,15 +269,6 @@ private:
 
 	static const orb_metadata *findTopic(const std::string &name);
 
-	/** get the array size from a type. eg. float[3] -> return float */
-	static std::string extractArraySize(const std::string &type_name_full, int &array_size);
-
-	/** get the size of a type that is not an array */
-	static size_t sizeOfType(const std::string &type_name);
-
-	/** get the size of a type that can be an array */
-	static size_t sizeOfFullType(const std::string &type_name_full);
-
 	void setUserParams(const char *filename);
 
 	static char *_replay_file;
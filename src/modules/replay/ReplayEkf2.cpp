@@ -66,12 +66,7 @@ ReplayEkf2::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &repl
 			return false;
 		}
 
-		px4_pollfd_struct_t fds[1];
-		fds[0].fd = _vehicle_attitude_sub;
-		fds[0].events = POLLIN;
-
-		// wait for a response from the estimator
-		int pret = px4_poll(fds, 1, 1000);
+		waitForEstimators();
 
 		// introduce some breaks to make sure the logger can keep up
 		if (++_topic_counter == 50) {
@@ -79,20 +74,6 @@ ReplayEkf2::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &repl
 			_topic_counter = 0;
 		}
 
-		if (pret == 0) {
-			PX4_WARN("poll timeout");
-
-		} else if (pret < 0) {
-			PX4_ERR("poll failed (%i)", pret);
-
-		} else {
-			if (fds[0].revents & POLLIN) {
-				vehicle_attitude_s att;
-				// need to to an orb_copy so that poll will not return immediately
-				orb_copy(ORB_ID(vehicle_attitude), _vehicle_attitude_sub, &att);
-			}
-		}
-
 		return true;
 
 	} else if (sub.orb_meta == ORB_ID(vehicle_status) || sub.orb_meta == ORB_ID(vehicle_land_detected)
@@ -115,10 +96,8 @@ ReplayEkf2::onSubscriptionAdded(Subscription &sub, uint16_t msg_id)
 	} else if (sub.orb_meta == ORB_ID(distance_sensor)) {
 		_distance_sensor_msg_id = msg_id;
 
-	} else if (sub.orb_meta == ORB_ID(vehicle_gps_position)) {
-		if (sub.multi_id == 0) {
-			_gps_msg_id = msg_id;
-		}
+	} else if (sub.orb_meta == ORB_ID(vehicle_gps_blended)) {
+		_gps_msg_id = msg_id;
 
 	} else if (sub.orb_meta == ORB_ID(optical_flow)) {
 		_optical_flow_msg_id = msg_id;
@@ -136,8 +115,7 @@ ReplayEkf2::onSubscriptionAdded(Subscription &sub, uint16_t msg_id)
 	// the main loop should only handle publication of the following topics, the sensor topics are
 	// handled separately in publishEkf2Topics()
 	sub.ignored = sub.orb_meta != ORB_ID(ekf2_timestamps) && sub.orb_meta != ORB_ID(vehicle_status)
-		      && sub.orb_meta != ORB_ID(vehicle_land_detected) &&
-		      (sub.orb_meta != ORB_ID(vehicle_gps_position) || sub.multi_id == 0);
+		      && sub.orb_meta != ORB_ID(vehicle_land_detected) && sub.orb_meta != ORB_ID(vehicle_gps_position);
 }
 
 bool
@@ -209,10 +187,62 @@ ReplayEkf2::findTimestampAndPublish(uint64_t timestamp, uint16_t msg_id, std::if
 	return true;
 }
 
+void
+ReplayEkf2::waitForEstimators()
+{
+	px4_pollfd_struct_t fds[MAX_ESTIMATORS] {};
+	bool responded[MAX_ESTIMATORS] {};
+	int pending = _attitude_sub_count;
+
+	for (int i = 0; i < _attitude_sub_count; i++) {
+		fds[i].fd = _attitude_subs[i];
+		fds[i].events = POLLIN;
+	}
+
+	// wait for a response from every estimator, the instances of a sweep run in parallel
+	while (pending > 0) {
+		int pret = px4_poll(fds, _attitude_sub_count, 1000);
+
+		if (pret == 0) {
+			PX4_WARN("poll timeout");
+			break;
+
+		} else if (pret < 0) {
+			PX4_ERR("poll failed (%i)", pret);
+			break;
+		}
+
+		for (int i = 0; i < _attitude_sub_count; i++) {
+			if (fds[i].revents & POLLIN) {
+				vehicle_attitude_s att;
+				// need to to an orb_copy so that poll will not return immediately
+				orb_copy(ORB_ID(vehicle_attitude), _attitude_subs[i], &att);
+
+				if (!responded[i]) {
+					responded[i] = true;
+					pending--;
+				}
+			}
+		}
+	}
+}
+
 void
 ReplayEkf2::onEnterMainLoop()
 {
-	_vehicle_attitude_sub = orb_subscribe(ORB_ID(vehicle_attitude));
+	// ekf2 advertises the estimator_attitude instances of a parameter sweep when it is started
+	for (int i = 0; i < MAX_ESTIMATORS; i++) {
+		if (orb_exists(ORB_ID(estimator_attitude), i) == PX4_OK) {
+			_attitude_subs[_attitude_sub_count++] = orb_subscribe_multi(ORB_ID(estimator_attitude), i);
+		}
+	}
+
+	if (_attitude_sub_count > 0) {
+		PX4_INFO("replaying to %i estimator instances", _attitude_sub_count);
+
+	} else {
+		_attitude_subs[_attitude_sub_count++] = orb_subscribe(ORB_ID(vehicle_attitude));
+	}
 }
 
 void
@@ -234,15 +264,19 @@ ReplayEkf2::onExitMainLoop()
 
 	print_sensor_statistics(_airspeed_msg_id, "airspeed");
 	print_sensor_statistics(_distance_sensor_msg_id, "distance_sensor");
-	print_sensor_statistics(_gps_msg_id, "vehicle_gps_position");
+	print_sensor_statistics(_gps_msg_id, "vehicle_gps_blended");
 	print_sensor_statistics(_optical_flow_msg_id, "optical_flow");
 	print_sensor_statistics(_sensor_combined_msg_id, "sensor_combined");
 	print_sensor_statistics(_vehicle_air_data_msg_id, "vehicle_air_data");
 	print_sensor_statistics(_vehicle_magnetometer_msg_id, "vehicle_magnetometer");
 	print_sensor_statistics(_vehicle_visual_odometry_msg_id, "vehicle_visual_odometry");
 
-	orb_unsubscribe(_vehicle_attitude_sub);
-	_vehicle_attitude_sub = -1;
+	for (int i = 0; i < _attitude_sub_count; i++) {
+		orb_unsubscribe(_attitude_subs[i]);
+		_attitude_subs[i] = -1;
+	}
+
+	_attitude_sub_count = 0;
 }
 
 uint64_t
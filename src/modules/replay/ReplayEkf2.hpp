@@ -76,7 +76,16 @@ private:
 	 */
 	bool findTimestampAndPublish(uint64_t timestamp, uint16_t msg_id, std::ifstream &replay_file);
 
-	int _vehicle_attitude_sub = -1;
+	/**
+	 * wait until all estimator instances have processed the published sensor data
+	 */
+	void waitForEstimators();
+
+	static constexpr int MAX_ESTIMATORS = 3;
+
+	// vehicle_attitude for a single ekf2, estimator_attitude instances for a parameter sweep (ekf2 start -r -s)
+	int _attitude_subs[MAX_ESTIMATORS] {-1, -1, -1};
+	int _attitude_sub_count = 0;
 
 	static constexpr uint16_t msg_id_invalid = 0xffff;
 
@@ -226,3 +226,18 @@ PARAM_DEFINE_INT32(SENS_EN_THERMAL, -1);
 * @group Sensors
 */
 PARAM_DEFINE_FLOAT(IMU_ACCEL_CUTOFF, 30.0f);
+
+/**
+* IMU integration rate
+*
+* The rate at which the accel and gyro drivers integrate their samples and vehicle_imu is published,
+* i.e. the IMU rate of the estimators. Set it to the rate of the estimator (ekf2 runs at 250 Hz),
+* so the estimator gets one vehicle_imu per cycle without integrating it again.
+*
+* @min 100
+* @max 1000
+* @unit Hz
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_INTEG_RATE, 250);
@@ -441,32 +441,16 @@ Sensors::run()
 
 	diff_pres_poll(airdata);
 
-	/* wakeup source */
-	px4_pollfd_struct_t poll_fds = {};
-	poll_fds.events = POLLIN;
-
 	uint64_t last_config_update = hrt_absolute_time();
 
 	while (!should_exit()) {
 
-		/* use the best-voted gyro to pace output */
-		poll_fds.fd = _voted_sensors_update.bestGyroFd();
-
-		/* wait for up to 50ms for data (Note that this implies, we can have a fail-over time of 50ms,
-		 * if a gyro fails) */
-		int pret = px4_poll(&poll_fds, 1, 50);
-
-		/* If pret == 0 it timed out but we should still do all checks and potentially copy
-		 * other gyros. */
-
-		/* this is undesirable but not much we can do - might want to flag unhappy status */
-		if (pret < 0) {
-			/* if the polling operation failed because no gyro sensor is available yet,
-			 * then attempt to subscribe once again
-			 */
-			if (_voted_sensors_update.numGyros() == 0) {
-				_voted_sensors_update.initializeSensors();
-			}
+		/* use the best-voted gyro to pace output, wait for up to 50ms for data (Note that this implies,
+		 * we can have a fail-over time of 50ms, if a gyro fails). On a timeout we should still do all
+		 * checks and potentially copy other gyros. */
+		if (!_voted_sensors_update.waitForGyro(50_ms) && (_voted_sensors_update.numGyros() == 0)) {
+			/* no gyro sensor is available yet, attempt to subscribe once again */
+			_voted_sensors_update.initializeSensors();
 
 			px4_usleep(1000);
 			continue;
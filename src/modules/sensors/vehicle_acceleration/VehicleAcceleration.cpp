@@ -79,15 +79,17 @@ void VehicleAcceleration::Stop()
 
 void VehicleAcceleration::SensorBiasUpdate(bool force)
 {
-	if (_estimator_sensor_bias_sub.updated() || force) {
-		estimator_sensor_bias_s bias;
+	if (force) {
+		_bias.zero();
+	}
 
-		if (_estimator_sensor_bias_sub.copy(&bias)) {
-			if (bias.accel_device_id == _selected_sensor_device_id) {
-				_bias = Vector3f{bias.accel_bias};
+	// use the bias estimate of the estimator instance running on the selected sensor
+	for (auto &estimator_sensor_bias_sub : _estimator_sensor_bias_subs) {
+		if (estimator_sensor_bias_sub.updated() || force) {
+			estimator_sensor_bias_s bias;
 
-			} else {
-				_bias.zero();
+			if (estimator_sensor_bias_sub.copy(&bias) && (bias.accel_device_id == _selected_sensor_device_id)) {
+				_bias = Vector3f{bias.accel_bias};
 			}
 		}
 	}
@@ -83,7 +83,12 @@ private:
 	uORB::Publication<vehicle_acceleration_s> _vehicle_acceleration_pub{ORB_ID(vehicle_acceleration)};
 
 	uORB::Subscription _params_sub{ORB_ID(parameter_update)};
-	uORB::Subscription _estimator_sensor_bias_sub{ORB_ID(estimator_sensor_bias)};
+	// one instance per estimator, each estimator of a multi-IMU bank publishes the bias of its own IMU
+	uORB::Subscription _estimator_sensor_bias_subs[MAX_SENSOR_COUNT] {
+		{ORB_ID(estimator_sensor_bias), 0},
+		{ORB_ID(estimator_sensor_bias), 1},
+		{ORB_ID(estimator_sensor_bias), 2}
+	};
 	uORB::Subscription _sensor_correction_sub{ORB_ID(sensor_correction)};
 
 	uORB::SubscriptionCallbackWorkItem _sensor_selection_sub{this, ORB_ID(sensor_selection)};
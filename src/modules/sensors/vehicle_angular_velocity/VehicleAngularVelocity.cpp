@@ -33,6 +33,7 @@
 
 #include "VehicleAngularVelocity.hpp"
 
+#include <px4_platform_common/defines.h>
 #include <px4_platform_common/log.h>
 
 using namespace matrix;
@@ -44,7 +45,7 @@ VehicleAngularVelocity::VehicleAngularVelocity() :
 	WorkItem(MODULE_NAME, px4::wq_configurations::rate_ctrl)
 {
 	_lp_filter_velocity.set_cutoff_frequency(kInitialRateHz, _param_imu_gyro_cutoff.get());
-	_notch_filter_velocity.setParameters(kInitialRateHz, _param_imu_gyro_nf_freq.get(), _param_imu_gyro_nf_bw.get());
+	_notch_filter_velocity.setNotch(0, kInitialRateHz, _param_imu_gyro_nf_freq.get(), _param_imu_gyro_nf_bw.get());
 
 	_lp_filter_acceleration.set_cutoff_frequency(kInitialRateHz, _param_imu_dgyro_cutoff.get());
 }
@@ -80,6 +81,10 @@ void VehicleAngularVelocity::Stop()
 		sub.unregisterCallback();
 	}
 
+	for (auto &sub : _sensor_fifo_sub) {
+		sub.unregisterCallback();
+	}
+
 	_sensor_selection_sub.unregisterCallback();
 }
 
@@ -88,8 +93,8 @@ void VehicleAngularVelocity::CheckFilters()
 	if ((hrt_elapsed_time(&_filter_check_last) > 100_ms)) {
 		_filter_check_last = hrt_absolute_time();
 
-		// calculate sensor update rate
-		const float sample_interval_avg = perf_mean(_interval_perf);
+		// calculate sensor update rate (FIFO: interval of the individual samples)
+		const float sample_interval_avg = _fifo_available ? (_fifo_dt * 1e-6f) : perf_mean(_interval_perf);
 
 		if (PX4_ISFINITE(sample_interval_avg) && (sample_interval_avg > 0.0f)) {
 
@@ -105,11 +110,12 @@ void VehicleAngularVelocity::CheckFilters()
 			}
 		}
 
-		const bool sample_rate_updated = (_sample_rate_incorrect_count > 50);
+		// the FIFO sample interval is exact, no need to wait for a stable average
+		const bool sample_rate_updated = (_sample_rate_incorrect_count > (_fifo_available ? 0 : 50));
 
 		const bool lp_velocity_updated = (fabsf(_lp_filter_velocity.get_cutoff_freq() - _param_imu_gyro_cutoff.get()) > 0.01f);
-		const bool notch_updated = ((fabsf(_notch_filter_velocity.getNotchFreq() - _param_imu_gyro_nf_freq.get()) > 0.01f)
-					    || (fabsf(_notch_filter_velocity.getBandwidth() - _param_imu_gyro_nf_bw.get()) > 0.01f));
+		const bool notch_updated = ((fabsf(_notch_filter_velocity.getFrequency(0) - _param_imu_gyro_nf_freq.get()) > 0.01f)
+					    || (fabsf(_notch_filter_velocity.getBandwidth(0) - _param_imu_gyro_nf_bw.get()) > 0.01f));
 
 		const bool lp_acceleration_updated = (fabsf(_lp_filter_acceleration.get_cutoff_freq() - _param_imu_dgyro_cutoff.get()) >
 						      0.01f);
@@ -122,7 +128,9 @@ void VehicleAngularVelocity::CheckFilters()
 			_lp_filter_velocity.set_cutoff_frequency(_filter_sample_rate, _param_imu_gyro_cutoff.get());
 			_lp_filter_velocity.reset(_angular_velocity_prev);
 
-			_notch_filter_velocity.setParameters(_filter_sample_rate, _param_imu_gyro_nf_freq.get(), _param_imu_gyro_nf_bw.get());
+			_notch_filter_velocity.setNotch(0, _filter_sample_rate, _param_imu_gyro_nf_freq.get(), _param_imu_gyro_nf_bw.get());
+			UpdateDynamicNotchEscRpm(true);
+			UpdateDynamicNotchFFT(true);
 			_notch_filter_velocity.reset(_angular_velocity_prev);
 
 			_lp_filter_acceleration.set_cutoff_frequency(_filter_sample_rate, _param_imu_dgyro_cutoff.get());
@@ -134,17 +142,176 @@ void VehicleAngularVelocity::CheckFilters()
 	}
 }
 
+void VehicleAngularVelocity::DisableDynamicNotchEscRpm()
+{
+	if (_dynamic_notch_esc_rpm_active) {
+		for (int stage = NOTCH_STAGE_ESC_RPM; stage < MAX_NOTCH_FILTERS; stage++) {
+			_notch_filter_velocity.disable(stage);
+		}
+
+		_dynamic_notch_esc_rpm_active = false;
+	}
+}
+
+void VehicleAngularVelocity::DisableDynamicNotchFFT()
+{
+	if (_dynamic_notch_fft_active) {
+		for (int stage = NOTCH_STAGE_FFT; stage < NOTCH_STAGE_FFT + MAX_FFT_PEAKS; stage++) {
+			_notch_filter_velocity.disable(stage);
+		}
+
+		_dynamic_notch_fft_active = false;
+	}
+}
+
+void VehicleAngularVelocity::UpdateDynamicNotchEscRpm(bool force)
+{
+	if (!(_param_imu_gyro_dnf_en.get() & DynamicNotch::EscRpm)) {
+		DisableDynamicNotchEscRpm();
+		return;
+	}
+
+	if (_esc_status_sub.updated() || force) {
+		esc_status_s esc_status;
+
+		if (_esc_status_sub.copy(&esc_status) && (hrt_elapsed_time(&esc_status.timestamp) < DYNAMIC_NOTCH_FILTER_TIMEOUT)) {
+
+			const int harmonics = math::constrain(_param_imu_gyro_dnf_hmc.get(), 1, MAX_DNF_HARMONICS);
+			const float bandwidth = _param_imu_gyro_dnf_bw.get();
+			const float freq_min = _param_imu_gyro_dnf_min.get();
+
+			// keep the notches clear of the Nyquist frequency
+			const float freq_max = 0.5f * _filter_sample_rate - bandwidth;
+
+			for (int stage = NOTCH_STAGE_ESC_RPM; stage < MAX_NOTCH_FILTERS; stage++) {
+				const int esc = (stage - NOTCH_STAGE_ESC_RPM) / harmonics;
+				const int harmonic = (stage - NOTCH_STAGE_ESC_RPM) % harmonics;
+
+				float freq = 0.f;
+
+				if ((esc < MAX_NUM_ESC) && (esc < esc_status.esc_count) && (esc_status.esc_online_flags & (1 << esc))) {
+					// RPM to Hz, first harmonic is the motor rotation frequency
+					freq = fabsf((float)esc_status.esc[esc].esc_rpm) / 60.f * (harmonic + 1);
+				}
+
+				if ((freq >= freq_min) && (freq > bandwidth) && (freq < freq_max)) {
+					_notch_filter_velocity.setNotch(stage, _filter_sample_rate, freq, bandwidth);
+					_dynamic_notch_esc_rpm_active = true;
+
+				} else if (_notch_filter_velocity.enabled(stage)) {
+					_notch_filter_velocity.disable(stage);
+				}
+			}
+
+			_dynamic_notch_esc_rpm_last_update = esc_status.timestamp;
+		}
+	}
+
+	// disable the dynamic notches if the ESC RPM feedback stops
+	if (hrt_elapsed_time(&_dynamic_notch_esc_rpm_last_update) > DYNAMIC_NOTCH_FILTER_TIMEOUT) {
+		DisableDynamicNotchEscRpm();
+	}
+}
+
+void VehicleAngularVelocity::UpdateDynamicNotchFFT(bool force)
+{
+	if (!(_param_imu_gyro_dnf_en.get() & DynamicNotch::FFT)) {
+		DisableDynamicNotchFFT();
+		return;
+	}
+
+	if (_sensor_gyro_fft_sub.updated() || force) {
+		sensor_gyro_fft_s sensor_gyro_fft;
+
+		if (_sensor_gyro_fft_sub.copy(&sensor_gyro_fft) && (sensor_gyro_fft.device_id == _selected_sensor_device_id)
+		    && (hrt_elapsed_time(&sensor_gyro_fft.timestamp) < DYNAMIC_NOTCH_FILTER_TIMEOUT)) {
+
+			const float bandwidth = math::max(_param_imu_gyro_dnf_bw.get(), sensor_gyro_fft.resolution_hz);
+			const float freq_max = 0.5f * _filter_sample_rate - bandwidth;
+
+			// the filter bank coefficients are shared by all axes, pick the strongest peaks of all axes
+			const float *peak_frequencies[3] {sensor_gyro_fft.peak_frequencies_x, sensor_gyro_fft.peak_frequencies_y, sensor_gyro_fft.peak_frequencies_z};
+			const float *peak_snr[3] {sensor_gyro_fft.peak_snr_x, sensor_gyro_fft.peak_snr_y, sensor_gyro_fft.peak_snr_z};
+
+			float notch_freq[MAX_FFT_PEAKS] {};
+			float notch_snr[MAX_FFT_PEAKS] {};
+
+			for (int axis = 0; axis < 3; axis++) {
+				for (int peak = 0; peak < MAX_FFT_PEAKS; peak++) {
+					const float freq = peak_frequencies[axis][peak];
+					const float snr = peak_snr[axis][peak];
+
+					if ((freq <= bandwidth) || (freq >= freq_max)) {
+						continue;
+					}
+
+					// the same peak seen on another axis
+					int i = 0;
+
+					for (; i < MAX_FFT_PEAKS; i++) {
+						if ((notch_freq[i] > 0.f) && (fabsf(notch_freq[i] - freq) < bandwidth)) {
+							break;
+						}
+					}
+
+					if (i < MAX_FFT_PEAKS) {
+						if (snr > notch_snr[i]) {
+							notch_freq[i] = freq;
+							notch_snr[i] = snr;
+						}
+
+						continue;
+					}
+
+					// otherwise replace the weakest selected peak
+					int weakest = 0;
+
+					for (i = 1; i < MAX_FFT_PEAKS; i++) {
+						if (notch_snr[i] < notch_snr[weakest]) {
+							weakest = i;
+						}
+					}
+
+					if ((notch_freq[weakest] <= 0.f) || (snr > notch_snr[weakest])) {
+						notch_freq[weakest] = freq;
+						notch_snr[weakest] = snr;
+					}
+				}
+			}
+
+			for (int i = 0; i < MAX_FFT_PEAKS; i++) {
+				if (notch_freq[i] > 0.f) {
+					_notch_filter_velocity.setNotch(NOTCH_STAGE_FFT + i, _filter_sample_rate, notch_freq[i], bandwidth);
+					_dynamic_notch_fft_active = true;
+
+				} else if (_notch_filter_velocity.enabled(NOTCH_STAGE_FFT + i)) {
+					_notch_filter_velocity.disable(NOTCH_STAGE_FFT + i);
+				}
+			}
+
+			_dynamic_notch_fft_last_update = sensor_gyro_fft.timestamp;
+		}
+	}
+
+	// disable the dynamic notches if the FFT output stops or is for another gyro
+	if (hrt_elapsed_time(&_dynamic_notch_fft_last_update) > DYNAMIC_NOTCH_FILTER_TIMEOUT) {
+		DisableDynamicNotchFFT();
+	}
+}
+
 void VehicleAngularVelocity::SensorBiasUpdate(bool force)
 {
-	if (_estimator_sensor_bias_sub.updated() || force) {
-		estimator_sensor_bias_s bias;
+	if (force) {
+		_bias.zero();
+	}
 
-		if (_estimator_sensor_bias_sub.copy(&bias)) {
-			if (bias.gyro_device_id == _selected_sensor_device_id) {
-				_bias = Vector3f{bias.gyro_bias};
+	// use the bias estimate of the estimator instance running on the selected sensor
+	for (auto &estimator_sensor_bias_sub : _estimator_sensor_bias_subs) {
+		if (estimator_sensor_bias_sub.updated() || force) {
+			estimator_sensor_bias_s bias;
 
-			} else {
-				_bias.zero();
+			if (estimator_sensor_bias_sub.copy(&bias) && (bias.gyro_device_id == _selected_sensor_device_id)) {
+				_bias = Vector3f{bias.gyro_bias};
 			}
 		}
 	}
@@ -202,37 +369,64 @@ bool VehicleAngularVelocity::SensorSelectionUpdate(bool force)
 				sub.unregisterCallback();
 			}
 
+			for (auto &sub : _sensor_fifo_sub) {
+				sub.unregisterCallback();
+			}
+
+			bool selected = false;
+
+			// prefer the raw FIFO data of the selected gyro (full rate filtering)
 			for (int i = 0; i < MAX_SENSOR_COUNT; i++) {
+				sensor_gyro_fifo_s report{};
+				_sensor_fifo_sub[i].copy(&report);
+
+				if ((report.device_id != 0) && (report.device_id == sensor_selection.gyro_device_id)) {
+					if (_sensor_fifo_sub[i].registerCallback()) {
+						PX4_DEBUG("selected sensor (FIFO) changed %d -> %d", _selected_sensor_sub_index, i);
+						_selected_sensor_sub_index = i;
+						_fifo_available = true;
+						selected = true;
+						break;
+					}
+				}
+			}
+
+			for (int i = 0; (i < MAX_SENSOR_COUNT) && !selected; i++) {
 				sensor_gyro_s report{};
 				_sensor_sub[i].copy(&report);
 
 				if ((report.device_id != 0) && (report.device_id == sensor_selection.gyro_device_id)) {
 					if (_sensor_sub[i].registerCallback()) {
 						PX4_DEBUG("selected sensor changed %d -> %d", _selected_sensor_sub_index, i);
-
-						// record selected sensor (array index)
 						_selected_sensor_sub_index = i;
-						_selected_sensor_device_id = sensor_selection.gyro_device_id;
+						_fifo_available = false;
+						selected = true;
+					}
+				}
+			}
 
-						// clear bias and corrections
-						_bias.zero();
-						_offset = Vector3f{0.f, 0.f, 0.f};
-						_scale = Vector3f{1.f, 1.f, 1.f};
+			if (selected) {
+				// record selected sensor
+				_selected_sensor_device_id = sensor_selection.gyro_device_id;
 
-						// force corrections reselection
-						_corrections_selected_instance = -1;
+				// clear bias and corrections
+				_bias.zero();
+				_offset = Vector3f{0.f, 0.f, 0.f};
+				_scale = Vector3f{1.f, 1.f, 1.f};
 
-						// reset sample rate monitor
-						_sample_rate_incorrect_count = 0;
+				// force corrections reselection
+				_corrections_selected_instance = -1;
 
-						return true;
-					}
-				}
+				// reset sample rate monitor
+				_sample_rate_incorrect_count = 0;
+
+				return true;
 			}
 
 			PX4_ERR("unable to find or subscribe to selected sensor (%d)", sensor_selection.gyro_device_id);
 			_selected_sensor_device_id = 0;
 			_selected_sensor_sub_index = 0;
+			_fifo_available = false;
 		}
 	}
 
@@ -249,6 +443,11 @@ void VehicleAngularVelocity::ParametersUpdate(bool force)
 
 		updateParams();
 
+		// only recompute if one of our parameters changed
+		if (!updatedParams() && !force) {
+			return;
+		}
+
 		// get transformation matrix from sensor/board to body frame
 		const Dcmf board_rotation = get_rot_matrix((enum Rotation)_param_sens_board_rot.get());
 
@@ -262,7 +461,7 @@ void VehicleAngularVelocity::ParametersUpdate(bool force)
 	}
 }
 
-void VehicleAngularVelocity::Run()
+PX4_HOT void VehicleAngularVelocity::Run()
 {
 	// update corrections first to set _selected_sensor
 	bool selection_updated = SensorSelectionUpdate();
@@ -270,6 +469,75 @@ void VehicleAngularVelocity::Run()
 	SensorCorrectionsUpdate(selection_updated);
 	SensorBiasUpdate(selection_updated);
 	ParametersUpdate();
+	UpdateDynamicNotchEscRpm();
+	UpdateDynamicNotchFFT();
+
+	if (_fifo_available) {
+		sensor_gyro_fifo_s sensor_fifo_data;
+
+		if (_sensor_fifo_sub[_selected_sensor_sub_index].update(&sensor_fifo_data)
+		    && (sensor_fifo_data.samples > 0) && (sensor_fifo_data.dt > 0.f)) {
+
+			perf_count_interval(_interval_perf, sensor_fifo_data.timestamp_sample);
+
+			const int N = math::min((int)sensor_fifo_data.samples,
+						(int)(sizeof(sensor_fifo_data.x) / sizeof(sensor_fifo_data.x[0])));
+			const float dt = sensor_fifo_data.dt * 1e-6f;
+			_fifo_dt = sensor_fifo_data.dt;
+
+			if (sensor_fifo_data.rotation != _fifo_rotation) {
+				_fifo_rotation = sensor_fifo_data.rotation;
+				_fifo_rotation_dcm = get_rot_matrix((enum Rotation)_fifo_rotation);
+			}
+
+			const Vector3f calibration_offset{sensor_fifo_data.calibration_offset};
+
+			float x[sizeof(sensor_fifo_data.x) / sizeof(sensor_fifo_data.x[0])];
+			float y[sizeof(sensor_fifo_data.y) / sizeof(sensor_fifo_data.y[0])];
+			float z[sizeof(sensor_fifo_data.z) / sizeof(sensor_fifo_data.z[0])];
+
+			for (int n = 0; n < N; n++) {
+				// same as sensor_gyro: rotate, scale and apply the driver calibration
+				const Vector3f raw{(float)sensor_fifo_data.x[n], (float)sensor_fifo_data.y[n], (float)sensor_fifo_data.z[n]};
+				const Vector3f val{(_fifo_rotation_dcm * raw) * sensor_fifo_data.scale - calibration_offset};
+
+				// apply offsets and scale, rotate to body frame and correct for in-run bias errors
+				const Vector3f angular_velocity_raw{_board_rotation * (val - _offset).emult(_scale) - _bias};
+
+				x[n] = angular_velocity_raw(0);
+				y[n] = angular_velocity_raw(1);
+				z[n] = angular_velocity_raw(2);
+			}
+
+			// notch filter every raw sample (batched)
+			_notch_filter_velocity.apply(x, y, z, N);
+
+			Vector3f angular_velocity;
+			Vector3f angular_acceleration;
+
+			for (int n = 0; n < N; n++) {
+				// Differentiate angular velocity (after notch filter)
+				const Vector3f angular_velocity_notched{x[n], y[n], z[n]};
+				const Vector3f angular_acceleration_raw = (angular_velocity_notched - _angular_velocity_prev) / dt;
+
+				_angular_velocity_prev = angular_velocity_notched;
+				_angular_acceleration_prev = angular_acceleration_raw;
+
+				// Filter: apply low-pass
+				angular_acceleration = _lp_filter_acceleration.apply(angular_acceleration_raw);
+				angular_velocity = _lp_filter_velocity.apply(angular_velocity_notched);
+			}
+
+			_timestamp_sample_prev = sensor_fifo_data.timestamp_sample;
+
+			CheckFilters();
+
+			// publish the latest sample at the controller rate
+			Publish(sensor_fifo_data.timestamp_sample, angular_velocity, angular_acceleration);
+		}
+
+		return;
+	}
 
 	bool sensor_updated = _sensor_sub[_selected_sensor_sub_index].updated();
 
@@ -312,40 +580,43 @@ void VehicleAngularVelocity::Run()
 			const Vector3f angular_acceleration{_lp_filter_acceleration.apply(angular_acceleration_raw)};
 			const Vector3f angular_velocity{_lp_filter_velocity.apply(angular_velocity_notched)};
 
-			bool publish = true;
-
-			if (_param_imu_gyro_rate_max.get() > 0) {
-				const uint64_t interval = 1e6f / _param_imu_gyro_rate_max.get();
+			Publish(sensor_data.timestamp_sample, angular_velocity, angular_acceleration);
+		}
+	}
+}
 
-				if (hrt_elapsed_time(&_last_publish) < interval) {
-					publish = false;
-				}
-			}
+void VehicleAngularVelocity::Publish(const hrt_abstime &timestamp_sample, const Vector3f &angular_velocity,
+				     const Vector3f &angular_acceleration)
+{
+	if (_param_imu_gyro_rate_max.get() > 0) {
+		const uint64_t interval = 1e6f / _param_imu_gyro_rate_max.get();
 
-			if (publish) {
-				// Publish vehicle_angular_acceleration
-				vehicle_angular_acceleration_s v_angular_acceleration;
-				v_angular_acceleration.timestamp_sample = sensor_data.timestamp_sample;
-				angular_acceleration.copyTo(v_angular_acceleration.xyz);
-				v_angular_acceleration.timestamp = hrt_absolute_time();
-				_vehicle_angular_acceleration_pub.publish(v_angular_acceleration);
-
-				// Publish vehicle_angular_velocity
-				vehicle_angular_velocity_s v_angular_velocity;
-				v_angular_velocity.timestamp_sample = sensor_data.timestamp_sample;
-				angular_velocity.copyTo(v_angular_velocity.xyz);
-				v_angular_velocity.timestamp = hrt_absolute_time();
-				_vehicle_angular_velocity_pub.publish(v_angular_velocity);
-
-				_last_publish = v_angular_velocity.timestamp_sample;
-			}
+		if (hrt_elapsed_time(&_last_publish) < interval) {
+			return;
 		}
 	}
+
+	// Publish vehicle_angular_acceleration
+	vehicle_angular_acceleration_s v_angular_acceleration;
+	v_angular_acceleration.timestamp_sample = timestamp_sample;
+	angular_acceleration.copyTo(v_angular_acceleration.xyz);
+	v_angular_acceleration.timestamp = hrt_absolute_time();
+	_vehicle_angular_acceleration_pub.publish(v_angular_acceleration);
+
+	// Publish vehicle_angular_velocity
+	vehicle_angular_velocity_s v_angular_velocity;
+	v_angular_velocity.timestamp_sample = timestamp_sample;
+	angular_velocity.copyTo(v_angular_velocity.xyz);
+	v_angular_velocity.timestamp = hrt_absolute_time();
+	_vehicle_angular_velocity_pub.publish(v_angular_velocity);
+
+	_last_publish = v_angular_velocity.timestamp_sample;
 }
 
 void VehicleAngularVelocity::PrintStatus()
 {
-	PX4_INFO("selected sensor: %d (%d)", _selected_sensor_device_id, _selected_sensor_sub_index);
+	PX4_INFO("selected sensor: %d (%d)%s", _selected_sensor_device_id, _selected_sensor_sub_index,
+		 _fifo_available ? " FIFO" : "");
 	PX4_INFO("bias: [%.3f %.3f %.3f]", (double)_bias(0), (double)_bias(1), (double)_bias(2));
 	PX4_INFO("offset: [%.3f %.3f %.3f]", (double)_offset(0), (double)_offset(1), (double)_offset(2));
 	PX4_INFO("scale: [%.3f %.3f %.3f]", (double)_scale(0), (double)_scale(1), (double)_scale(2));
@@ -353,8 +624,15 @@ void VehicleAngularVelocity::PrintStatus()
 	PX4_INFO("sample rate: %.3f Hz", (double)_update_rate_hz);
 	PX4_INFO("low-pass filter cutoff: %.3f Hz", (double)_lp_filter_velocity.get_cutoff_freq());
 
-	if (_notch_filter_velocity.getNotchFreq() > 0.0f) {
-		PX4_INFO("notch filter freq: %.3f Hz\tbandwidth: %.3f Hz", (double)_notch_filter_velocity.getNotchFreq(),
-			 (double)_notch_filter_velocity.getBandwidth());
+	if (_notch_filter_velocity.enabled(0)) {
+		PX4_INFO("notch filter freq: %.3f Hz\tbandwidth: %.3f Hz", (double)_notch_filter_velocity.getFrequency(0),
+			 (double)_notch_filter_velocity.getBandwidth(0));
+	}
+
+	for (int stage = NOTCH_STAGE_FFT; stage < MAX_NOTCH_FILTERS; stage++) {
+		if (_notch_filter_velocity.enabled(stage)) {
+			PX4_INFO("dynamic notch filter (%s) %d: %.1f Hz\tbandwidth: %.1f Hz", (stage < NOTCH_STAGE_ESC_RPM) ? "FFT" : "ESC RPM",
+				 stage, (double)_notch_filter_velocity.getFrequency(stage), (double)_notch_filter_velocity.getBandwidth(stage));
+		}
 	}
 }
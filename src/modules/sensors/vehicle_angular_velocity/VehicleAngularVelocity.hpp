@@ -36,9 +36,9 @@
 #include <lib/conversion/rotation.h>
 #include <lib/mathlib/math/Limits.hpp>
 #include <lib/matrix/matrix/math.hpp>
+#include <lib/mathlib/math/filter/BiquadFilterBank.hpp>
 #include <lib/mathlib/math/filter/LowPassFilter2pArray.hpp>
 #include <lib/mathlib/math/filter/LowPassFilter2pVector3f.hpp>
-#include <lib/mathlib/math/filter/NotchFilter.hpp>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/px4_config.h>
@@ -46,10 +46,13 @@
 #include <uORB/Publication.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionCallback.hpp>
+#include <uORB/topics/esc_status.h>
 #include <uORB/topics/estimator_sensor_bias.h>
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/sensor_correction.h>
 #include <uORB/topics/sensor_gyro.h>
+#include <uORB/topics/sensor_gyro_fft.h>
+#include <uORB/topics/sensor_gyro_fifo.h>
 #include <uORB/topics/sensor_selection.h>
 #include <uORB/topics/vehicle_angular_acceleration.h>
 #include <uORB/topics/vehicle_angular_velocity.h>
@@ -70,19 +73,46 @@ private:
 	void Run() override;
 
 	void CheckFilters();
+	void DisableDynamicNotchEscRpm();
+	void DisableDynamicNotchFFT();
 	void ParametersUpdate(bool force = false);
+	void Publish(const hrt_abstime &timestamp_sample, const matrix::Vector3f &angular_velocity,
+		     const matrix::Vector3f &angular_acceleration);
 	void SensorBiasUpdate(bool force = false);
 	void SensorCorrectionsUpdate(bool force = false);
 	bool SensorSelectionUpdate(bool force = false);
+	void UpdateDynamicNotchEscRpm(bool force = false);
+	void UpdateDynamicNotchFFT(bool force = false);
 
 	static constexpr int MAX_SENSOR_COUNT = 3;
 
+	static constexpr int MAX_NUM_ESC = esc_status_s::CONNECTED_ESC_MAX;
+	static constexpr int MAX_DNF_HARMONICS = 3;
+	static constexpr int MAX_FFT_PEAKS = sensor_gyro_fft_s::MAX_PEAKS;
+
+	// notch filter bank stages: static notch (IMU_GYRO_NF_FREQ), FFT peak notches, ESC RPM notches (esc * harmonics + harmonic)
+	static constexpr int NOTCH_STAGE_FFT = 1;
+	static constexpr int NOTCH_STAGE_ESC_RPM = NOTCH_STAGE_FFT + MAX_FFT_PEAKS;
+	static constexpr int MAX_NOTCH_FILTERS = NOTCH_STAGE_ESC_RPM + MAX_NUM_ESC * MAX_DNF_HARMONICS;
+
+	static constexpr hrt_abstime DYNAMIC_NOTCH_FILTER_TIMEOUT = 1000000; // 1 s
+
+	enum DynamicNotch {
+		EscRpm = 1,
+		FFT    = 2,
+	};
+
 	DEFINE_PARAMETERS(
 		(ParamFloat<px4::params::IMU_GYRO_CUTOFF>) _param_imu_gyro_cutoff,
 		(ParamFloat<px4::params::IMU_GYRO_NF_FREQ>) _param_imu_gyro_nf_freq,
 		(ParamFloat<px4::params::IMU_GYRO_NF_BW>) _param_imu_gyro_nf_bw,
 		(ParamInt<px4::params::IMU_GYRO_RATEMAX>) _param_imu_gyro_rate_max,
 
+		(ParamInt<px4::params::IMU_GYRO_DNF_EN>) _param_imu_gyro_dnf_en,
+		(ParamInt<px4::params::IMU_GYRO_DNF_HMC>) _param_imu_gyro_dnf_hmc,
+		(ParamFloat<px4::params::IMU_GYRO_DNF_BW>) _param_imu_gyro_dnf_bw,
+		(ParamFloat<px4::params::IMU_GYRO_DNF_MIN>) _param_imu_gyro_dnf_min,
+
 		(ParamFloat<px4::params::IMU_DGYRO_CUTOFF>) _param_imu_dgyro_cutoff,
 
 		(ParamInt<px4::params::SENS_BOARD_ROT>) _param_sens_board_rot,
@@ -96,8 +126,15 @@ private:
 	uORB::Publication<vehicle_angular_velocity_s> _vehicle_angular_velocity_pub{ORB_ID(vehicle_angular_velocity)};
 
 	uORB::Subscription _params_sub{ORB_ID(parameter_update)};
-	uORB::Subscription _estimator_sensor_bias_sub{ORB_ID(estimator_sensor_bias)};
+	uORB::Subscription _esc_status_sub{ORB_ID(esc_status)};
+	// one instance per estimator, each estimator of a multi-IMU bank publishes the bias of its own IMU
+	uORB::Subscription _estimator_sensor_bias_subs[MAX_SENSOR_COUNT] {
+		{ORB_ID(estimator_sensor_bias), 0},
+		{ORB_ID(estimator_sensor_bias), 1},
+		{ORB_ID(estimator_sensor_bias), 2}
+	};
 	uORB::Subscription _sensor_correction_sub{ORB_ID(sensor_correction)};
+	uORB::Subscription _sensor_gyro_fft_sub{ORB_ID(sensor_gyro_fft)};
 
 	uORB::SubscriptionCallbackWorkItem _sensor_selection_sub{this, ORB_ID(sensor_selection)};
 	uORB::SubscriptionCallbackWorkItem _sensor_sub[MAX_SENSOR_COUNT] {
@@ -106,6 +143,12 @@ private:
 		{this, ORB_ID(sensor_gyro), 2}
 	};
 
+	uORB::SubscriptionCallbackWorkItem _sensor_fifo_sub[MAX_SENSOR_COUNT] {
+		{this, ORB_ID(sensor_gyro_fifo), 0},
+		{this, ORB_ID(sensor_gyro_fifo), 1},
+		{this, ORB_ID(sensor_gyro_fifo), 2}
+	};
+
 	perf_counter_t _interval_perf{perf_alloc(PC_INTERVAL, MODULE_NAME": interval")};
 
 	matrix::Dcmf _board_rotation;
@@ -125,7 +168,13 @@ private:
 
 	// angular velocity filters
 	math::LowPassFilter2pVector3f _lp_filter_velocity{kInitialRateHz, 30.0f};
-	math::NotchFilter<matrix::Vector3f> _notch_filter_velocity{};
+	math::BiquadFilterBank<MAX_NOTCH_FILTERS> _notch_filter_velocity{};
+
+	hrt_abstime _dynamic_notch_esc_rpm_last_update{0};
+	bool _dynamic_notch_esc_rpm_active{false};
+
+	hrt_abstime _dynamic_notch_fft_last_update{0};
+	bool _dynamic_notch_fft_active{false};
 
 	// angular acceleration filter
 	math::LowPassFilter2pVector3f _lp_filter_acceleration{kInitialRateHz, 10.0f};
@@ -133,6 +182,12 @@ private:
 	float _filter_sample_rate{kInitialRateHz};
 	int _sample_rate_incorrect_count{0};
 
+	// full rate processing of the raw FIFO samples (if the selected gyro publishes sensor_gyro_fifo)
+	bool _fifo_available{false};
+	float _fifo_dt{0.f}; /**< FIFO sample interval [us] */
+	uint8_t _fifo_rotation{ROTATION_NONE};
+	matrix::Dcmf _fifo_rotation_dcm{};
+
 	uint32_t _selected_sensor_device_id{0};
 	uint8_t _selected_sensor_sub_index{0};
 	int8_t _corrections_selected_instance{-1};
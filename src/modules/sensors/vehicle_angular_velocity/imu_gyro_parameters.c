@@ -109,3 +109,56 @@ PARAM_DEFINE_INT32(IMU_GYRO_RATEMAX, 0);
 * @group Sensors
 */
 PARAM_DEFINE_FLOAT(IMU_DGYRO_CUTOFF, 10.0f);
+
+/**
+* IMU gyro dynamic notch filtering
+*
+* Enable bank of dynamically updating notch filters.
+* ESC RPM requires ESC RPM feedback (esc_status, e.g. DShot telemetry),
+* FFT requires the gyro_fft module (IMU_GYRO_FFT_EN).
+*
+* @min 0
+* @max 3
+* @bit 0 ESC RPM
+* @bit 1 FFT
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_DNF_EN, 0);
+
+/**
+* IMU gyro ESC notch filter harmonics
+*
+* ESC RPM number of harmonics (multiples of RPM) for ESC RPM dynamic notch filtering.
+* One notch is placed at each harmonic of every online ESC.
+*
+* @min 1
+* @max 3
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_DNF_HMC, 3);
+
+/**
+* IMU gyro dynamic notch bandwidth
+*
+* Bandwidth of the dynamic notch filters.
+*
+* @unit Hz
+* @min 5
+* @max 30
+* @decimal 1
+* @group Sensors
+*/
+PARAM_DEFINE_FLOAT(IMU_GYRO_DNF_BW, 15.f);
+
+/**
+* IMU gyro dynamic notch filter minimum frequency
+*
+* Minimum notch filter frequency in Hz. Harmonics below this frequency are not filtered.
+*
+* @unit Hz
+* @min 0
+* @max 200
+* @decimal 1
+* @group Sensors
+*/
+PARAM_DEFINE_FLOAT(IMU_GYRO_DNF_MIN, 25.f);
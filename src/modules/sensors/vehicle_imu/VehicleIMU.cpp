@@ -165,6 +165,8 @@ void VehicleIMU::ParametersUpdate(bool force)
 				radians(_param_sens_board_z_off.get())));
 
 		_board_rotation = board_rotation_offset * board_rotation;
+
+		_integration_interval = 1000000 / math::constrain(_param_imu_integ_rate.get(), (int32_t)100, (int32_t)1000);
 	}
 }
 
@@ -203,22 +205,40 @@ void VehicleIMU::Run()
 		delta_velocity = _board_rotation * delta_velocity;
 
 
-		// publich vehicle_imu
+		// accumulate until the integration window is complete (same 90% margin as the driver integrator),
+		// with the driver integrating over the same window every sample is published directly
+		_delta_angle_sum += delta_angle;
+		_delta_velocity_sum += delta_velocity;
+		_accumulated_dt += accel.dt;
+		_accumulated_samples += accel.samples;
+		_accumulated_clip_count += accel.clip_count;
+
+		if (_accumulated_dt < (_integration_interval * 9) / 10) {
+			return;
+		}
+
+		// publish vehicle_imu
 		vehicle_imu_s imu;
 
 		imu.timestamp_sample = accel.timestamp_sample;
 		imu.accel_device_id = accel.device_id;
 		imu.gyro_device_id = gyro.device_id;
 
-		delta_angle.copyTo(imu.delta_angle);
-		delta_velocity.copyTo(imu.delta_velocity);
+		_delta_angle_sum.copyTo(imu.delta_angle);
+		_delta_velocity_sum.copyTo(imu.delta_velocity);
 
-		imu.dt = accel.dt;
-		imu.integrated_samples = accel.samples;
-		imu.clip_count = accel.clip_count;
+		imu.dt = _accumulated_dt;
+		imu.integrated_samples = math::min(_accumulated_samples, (uint16_t)UINT8_MAX);
+		imu.clip_count = math::min(_accumulated_clip_count, (uint16_t)UINT8_MAX);
 		imu.timestamp = hrt_absolute_time();
 
 		_vehicle_imu_pub.publish(imu);
+
+		_delta_angle_sum.zero();
+		_delta_velocity_sum.zero();
+		_accumulated_dt = 0;
+		_accumulated_samples = 0;
+		_accumulated_clip_count = 0;
 	}
 }
 
@@ -76,7 +76,9 @@ private:
 
 		(ParamFloat<px4::params::SENS_BOARD_X_OFF>) _param_sens_board_x_off,
 		(ParamFloat<px4::params::SENS_BOARD_Y_OFF>) _param_sens_board_y_off,
-		(ParamFloat<px4::params::SENS_BOARD_Z_OFF>) _param_sens_board_z_off
+		(ParamFloat<px4::params::SENS_BOARD_Z_OFF>) _param_sens_board_z_off,
+
+		(ParamInt<px4::params::IMU_INTEG_RATE>) _param_imu_integ_rate
 	)
 
 	uORB::PublicationMulti<vehicle_imu_s> _vehicle_imu_pub{ORB_ID(vehicle_imu)};
@@ -94,6 +96,15 @@ private:
 	matrix::Vector3f _accel_scale{1.f, 1.f, 1.f};
 	matrix::Vector3f _gyro_scale{1.f, 1.f, 1.f};
 
+	// corrected deltas accumulated until the integration window (IMU_INTEG_RATE) is complete,
+	// only needed if the driver publishes more often than that
+	matrix::Vector3f _delta_angle_sum{0.f, 0.f, 0.f};
+	matrix::Vector3f _delta_velocity_sum{0.f, 0.f, 0.f};
+	uint32_t _integration_interval{4000};	///< [us]
+	uint32_t _accumulated_dt{0};		///< [us]
+	uint16_t _accumulated_samples{0};
+	uint16_t _accumulated_clip_count{0};
+
 	char *_name{nullptr};
 
 	int8_t _corrections_selected_accel_instance{-1};
@@ -67,6 +67,12 @@ VotedSensorsUpdate::VotedSensorsUpdate(const Parameters &parameters, bool hil_en
 	_corrections.baro_scale_1 = 1.0f;
 	_corrections.baro_scale_2 = 1.0f;
 
+	px4_sem_init(&_gyro_wakeup_sem, 0, 0);
+	px4_sem_setprotocol(&_gyro_wakeup_sem, SEM_PRIO_NONE);
+
+	// only the initially best voted gyro paces the sensors thread
+	_gyro.subscription.set_wakeup_mask(1u << _gyro.last_best_vote);
+
 	_baro.voter.set_timeout(300000);
 	_mag.voter.set_timeout(300000);
 	_mag.voter.set_equal_value_threshold(1000);
@@ -99,21 +105,12 @@ void VotedSensorsUpdate::initializeSensors()
 
 void VotedSensorsUpdate::deinit()
 {
-	for (int i = 0; i < _gyro.subscription_count; i++) {
-		orb_unsubscribe(_gyro.subscription[i]);
-	}
-
-	for (int i = 0; i < _accel.subscription_count; i++) {
-		orb_unsubscribe(_accel.subscription[i]);
-	}
-
-	for (int i = 0; i < _mag.subscription_count; i++) {
-		orb_unsubscribe(_mag.subscription[i]);
-	}
+	_gyro.subscription.unregisterCallbacks();
+	_accel.subscription.unregisterCallbacks();
+	_mag.subscription.unregisterCallbacks();
+	_baro.subscription.unregisterCallbacks();
 
-	for (int i = 0; i < _baro.subscription_count; i++) {
-		orb_unsubscribe(_baro.subscription[i]);
-	}
+	px4_sem_destroy(&_gyro_wakeup_sem);
 }
 
 void VotedSensorsUpdate::parametersUpdate()
@@ -352,7 +349,7 @@ void VotedSensorsUpdate::parametersUpdate()
 
 		sensor_mag_s report{};
 
-		if (orb_copy(ORB_ID(sensor_mag), _mag.subscription[topic_instance], &report) != 0) {
+		if (!_mag.subscription.copy(topic_instance, &report)) {
 			continue;
 		}
 
@@ -492,16 +489,16 @@ void VotedSensorsUpdate::accelPoll(struct sensor_combined_s &raw)
 	float *offsets[] = {_corrections.accel_offset_0, _corrections.accel_offset_1, _corrections.accel_offset_2 };
 	float *scales[] = {_corrections.accel_scale_0, _corrections.accel_scale_1, _corrections.accel_scale_2 };
 
-	for (int uorb_index = 0; uorb_index < _accel.subscription_count; uorb_index++) {
-		bool accel_updated;
-		orb_check(_accel.subscription[uorb_index], &accel_updated);
+	bool updated = false;
 
-		if (accel_updated) {
-			sensor_accel_integrated_s accel_report;
+	// only copy instances that published since the last poll
+	const uint32_t updated_instances = _accel.subscription.updated_mask();
 
-			int ret = orb_copy(ORB_ID(sensor_accel_integrated), _accel.subscription[uorb_index], &accel_report);
+	for (int uorb_index = 0; uorb_index < _accel.subscription_count; uorb_index++) {
+		if (updated_instances & (1u << uorb_index)) {
+			sensor_accel_integrated_s accel_report;
 
-			if (ret != PX4_OK || accel_report.timestamp == 0) {
+			if (!_accel.subscription.update(uorb_index, &accel_report) || accel_report.timestamp == 0) {
 				continue; //ignore invalid data
 			}
 
@@ -511,9 +508,7 @@ void VotedSensorsUpdate::accelPoll(struct sensor_combined_s &raw)
 
 			// First publication with data
 			if (_accel.priority[uorb_index] == 0) {
-				int32_t priority = 0;
-				orb_priority(_accel.subscription[uorb_index], &priority);
-				_accel.priority[uorb_index] = (uint8_t)priority;
+				_accel.priority[uorb_index] = _accel.subscription.get_priority(uorb_index);
 			}
 
 			_accel_device_id[uorb_index] = accel_report.device_id;
@@ -545,12 +540,19 @@ void VotedSensorsUpdate::accelPoll(struct sensor_combined_s &raw)
 			_last_accel_timestamp[uorb_index] = accel_report.timestamp;
 			_accel.voter.put(uorb_index, accel_report.timestamp, _last_sensor_data[uorb_index].accelerometer_m_s2,
 					 accel_report.error_count, _accel.priority[uorb_index]);
+			updated = true;
 		}
 	}
 
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (!voteRequired(_accel, updated, now)) {
+		return;
+	}
+
 	// find the best sensor
 	int best_index;
-	_accel.voter.get_best(hrt_absolute_time(), &best_index);
+	_accel.voter.get_best(now, &best_index);
 
 	// write the best sensor data to the output variables
 	if (best_index >= 0) {
@@ -573,16 +575,16 @@ void VotedSensorsUpdate::gyroPoll(struct sensor_combined_s &raw)
 	float *offsets[] = {_corrections.gyro_offset_0, _corrections.gyro_offset_1, _corrections.gyro_offset_2 };
 	float *scales[] = {_corrections.gyro_scale_0, _corrections.gyro_scale_1, _corrections.gyro_scale_2 };
 
-	for (int uorb_index = 0; uorb_index < _gyro.subscription_count; uorb_index++) {
-		bool gyro_updated;
-		orb_check(_gyro.subscription[uorb_index], &gyro_updated);
+	bool updated = false;
 
-		if (gyro_updated) {
-			sensor_gyro_integrated_s gyro_report;
+	// only copy instances that published since the last poll
+	const uint32_t updated_instances = _gyro.subscription.updated_mask();
 
-			int ret = orb_copy(ORB_ID(sensor_gyro_integrated), _gyro.subscription[uorb_index], &gyro_report);
+	for (int uorb_index = 0; uorb_index < _gyro.subscription_count; uorb_index++) {
+		if (updated_instances & (1u << uorb_index)) {
+			sensor_gyro_integrated_s gyro_report;
 
-			if (ret != PX4_OK || gyro_report.timestamp == 0) {
+			if (!_gyro.subscription.update(uorb_index, &gyro_report) || gyro_report.timestamp == 0) {
 				continue; //ignore invalid data
 			}
 
@@ -592,9 +594,7 @@ void VotedSensorsUpdate::gyroPoll(struct sensor_combined_s &raw)
 
 			// First publication with data
 			if (_gyro.priority[uorb_index] == 0) {
-				int32_t priority = 0;
-				orb_priority(_gyro.subscription[uorb_index], &priority);
-				_gyro.priority[uorb_index] = (uint8_t)priority;
+				_gyro.priority[uorb_index] = _gyro.subscription.get_priority(uorb_index);
 			}
 
 			_gyro_device_id[uorb_index] = gyro_report.device_id;
@@ -626,12 +626,19 @@ void VotedSensorsUpdate::gyroPoll(struct sensor_combined_s &raw)
 			_last_sensor_data[uorb_index].timestamp = gyro_report.timestamp;
 			_gyro.voter.put(uorb_index, gyro_report.timestamp, _last_sensor_data[uorb_index].gyro_rad,
 					gyro_report.error_count, _gyro.priority[uorb_index]);
+			updated = true;
 		}
 	}
 
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (!voteRequired(_gyro, updated, now)) {
+		return;
+	}
+
 	// find the best sensor
 	int best_index;
-	_gyro.voter.get_best(hrt_absolute_time(), &best_index);
+	_gyro.voter.get_best(now, &best_index);
 
 	// write data for the best sensor to output variables
 	if (best_index >= 0) {
@@ -640,6 +647,9 @@ void VotedSensorsUpdate::gyroPoll(struct sensor_combined_s &raw)
 		memcpy(&raw.gyro_rad, &_last_sensor_data[best_index].gyro_rad, sizeof(raw.gyro_rad));
 
 		if (_gyro.last_best_vote != best_index) {
+			// pace the sensors thread with the new best gyro
+			_gyro.subscription.set_wakeup_mask(1u << best_index);
+
 			_gyro.last_best_vote = (uint8_t)best_index;
 		}
 
@@ -652,16 +662,16 @@ void VotedSensorsUpdate::gyroPoll(struct sensor_combined_s &raw)
 
 void VotedSensorsUpdate::magPoll(vehicle_magnetometer_s &magnetometer)
 {
-	for (int uorb_index = 0; uorb_index < _mag.subscription_count; uorb_index++) {
-		bool mag_updated;
-		orb_check(_mag.subscription[uorb_index], &mag_updated);
+	bool updated = false;
 
-		if (mag_updated) {
-			sensor_mag_s mag_report{};
+	// only copy instances that published since the last poll
+	const uint32_t updated_instances = _mag.subscription.updated_mask();
 
-			int ret = orb_copy(ORB_ID(sensor_mag), _mag.subscription[uorb_index], &mag_report);
+	for (int uorb_index = 0; uorb_index < _mag.subscription_count; uorb_index++) {
+		if (updated_instances & (1u << uorb_index)) {
+			sensor_mag_s mag_report{};
 
-			if (ret != PX4_OK || mag_report.timestamp == 0) {
+			if (!_mag.subscription.update(uorb_index, &mag_report) || mag_report.timestamp == 0) {
 				continue; //ignore invalid data
 			}
 
@@ -671,9 +681,7 @@ void VotedSensorsUpdate::magPoll(vehicle_magnetometer_s &magnetometer)
 
 			// First publication with data
 			if (_mag.priority[uorb_index] == 0) {
-				int32_t priority = 0;
-				orb_priority(_mag.subscription[uorb_index], &priority);
-				_mag.priority[uorb_index] = (uint8_t)priority;
+				_mag.priority[uorb_index] = _mag.subscription.get_priority(uorb_index);
 
 				/* force a scale and offset update the first time we get data */
 				parametersUpdate();
@@ -698,11 +706,18 @@ void VotedSensorsUpdate::magPoll(vehicle_magnetometer_s &magnetometer)
 
 			_mag.voter.put(uorb_index, mag_report.timestamp, _last_magnetometer[uorb_index].magnetometer_ga, mag_report.error_count,
 				       _mag.priority[uorb_index]);
+			updated = true;
 		}
 	}
 
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (!voteRequired(_mag, updated, now)) {
+		return;
+	}
+
 	int best_index;
-	_mag.voter.get_best(hrt_absolute_time(), &best_index);
+	_mag.voter.get_best(now, &best_index);
 
 	if (best_index >= 0) {
 		magnetometer = _last_magnetometer[best_index];
@@ -721,16 +736,14 @@ void VotedSensorsUpdate::baroPoll(vehicle_air_data_s &airdata)
 	float *offsets[] = {&_corrections.baro_offset_0, &_corrections.baro_offset_1, &_corrections.baro_offset_2 };
 	float *scales[] = {&_corrections.baro_scale_0, &_corrections.baro_scale_1, &_corrections.baro_scale_2 };
 
-	for (int uorb_index = 0; uorb_index < _baro.subscription_count; uorb_index++) {
-		bool baro_updated;
-		orb_check(_baro.subscription[uorb_index], &baro_updated);
+	// only copy instances that published since the last poll
+	const uint32_t updated_instances = _baro.subscription.updated_mask();
 
-		if (baro_updated) {
+	for (int uorb_index = 0; uorb_index < _baro.subscription_count; uorb_index++) {
+		if (updated_instances & (1u << uorb_index)) {
 			sensor_baro_s baro_report{};
 
-			int ret = orb_copy(ORB_ID(sensor_baro), _baro.subscription[uorb_index], &baro_report);
-
-			if (ret != PX4_OK || baro_report.timestamp == 0) {
+			if (!_baro.subscription.update(uorb_index, &baro_report) || baro_report.timestamp == 0) {
 				continue; //ignore invalid data
 			}
 
@@ -742,9 +755,7 @@ void VotedSensorsUpdate::baroPoll(vehicle_air_data_s &airdata)
 
 			// First publication with data
 			if (_baro.priority[uorb_index] == 0) {
-				int32_t priority = 0;
-				orb_priority(_baro.subscription[uorb_index], &priority);
-				_baro.priority[uorb_index] = (uint8_t)priority;
+				_baro.priority[uorb_index] = _baro.subscription.get_priority(uorb_index);
 			}
 
 			_baro_device_id[uorb_index] = baro_report.device_id;
@@ -891,8 +902,8 @@ void VotedSensorsUpdate::initSensorClass(const struct orb_metadata *meta, Sensor
 
 		max_sensor_index = i;
 
-		if (sensor_data.subscription[i] < 0) {
-			sensor_data.subscription[i] = orb_subscribe_multi(meta, i);
+		if (sensor_data.subscription.get_topic(i) == nullptr) {
+			sensor_data.subscription.set_member(i, meta, i);
 
 			if (i > 0) {
 				/* the first always exists, but for each further sensor, add a new validator */
@@ -900,15 +911,48 @@ void VotedSensorsUpdate::initSensorClass(const struct orb_metadata *meta, Sensor
 					PX4_ERR("failed to add validator for sensor %s %i", meta->o_name, i);
 				}
 			}
+
 		}
 	}
 
+	// (re-)register new instances and instances that failed to register before
+	sensor_data.subscription.registerCallbacks();
+
 	// never decrease the sensor count, as we could end up with mismatching validators
 	if (max_sensor_index + 1 > sensor_data.subscription_count) {
 		sensor_data.subscription_count = max_sensor_index + 1;
 	}
 }
 
+bool VotedSensorsUpdate::voteRequired(SensorData &sensor, bool updated, const hrt_abstime &now)
+{
+	if (updated || (now >= sensor.last_vote + VOTE_INTERVAL_MAX)) {
+		sensor.last_vote = now;
+		return true;
+	}
+
+	return false;
+}
+
+bool VotedSensorsUpdate::waitForGyro(uint32_t timeout_us)
+{
+	if (_gyro.subscription_count == 0) {
+		return false;
+	}
+
+	// Calculate an absolute time in the future
+	struct timespec ts;
+	px4_clock_gettime(CLOCK_REALTIME, &ts);
+	uint64_t nsecs = ts.tv_nsec + (timeout_us * 1000);
+	static constexpr unsigned billion = (1000 * 1000 * 1000);
+	ts.tv_sec += nsecs / billion;
+	nsecs -= (nsecs / billion) * billion;
+	ts.tv_nsec = nsecs;
+
+	// posted by the first publication of the best voted gyro since the last gyroPoll()
+	return (px4_sem_timedwait(&_gyro_wakeup_sem, &ts) == 0);
+}
+
 void VotedSensorsUpdate::printStatus()
 {
 	PX4_INFO("gyro status:");
@@ -53,9 +53,13 @@
 #include <lib/ecl/validation/data_validator.h>
 #include <lib/ecl/validation/data_validator_group.h>
 
+#include <px4_platform_common/sem.h>
+#include <px4_platform_common/time.h>
+
 #include <uORB/Publication.hpp>
 #include <uORB/PublicationQueued.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionSet.hpp>
 #include <uORB/topics/sensor_accel_integrated.h>
 #include <uORB/topics/sensor_combined.h>
 #include <uORB/topics/sensor_preflight.h>
@@ -127,9 +131,13 @@ public:
 
 	int numGyros() const { return _gyro.subscription_count; }
 
-	int gyroFd(int idx) const { return _gyro.subscription[idx]; }
-
-	int bestGyroFd() const { return _gyro.subscription[_gyro.last_best_vote]; }
+	/**
+	 * Wait for new data of the best voted gyro.
+	 *
+	 * @param timeout_us	maximum time to wait in microseconds
+	 * @return true if there is new data, false on timeout or if there is no gyro
+	 */
+	bool waitForGyro(uint32_t timeout_us);
 
 	/**
 	 * Calculates the magnitude in m/s/s of the largest difference between the primary and any other accel sensor
@@ -149,29 +157,45 @@ public:
 private:
 
 	struct SensorData {
-		SensorData()
-			: last_best_vote(0),
+		/**
+		 * @param wakeup_sem posted on new data of the instances in the wakeup mask (nullptr for none)
+		 */
+		explicit SensorData(px4_sem_t *wakeup_sem = nullptr)
+			: subscription(wakeup_sem),
+			  last_best_vote(0),
 			  subscription_count(0),
 			  voter(1),
 			  last_failover_count(0)
 		{
 			for (unsigned i = 0; i < SENSOR_COUNT_MAX; i++) {
 				enabled[i] = true;
-				subscription[i] = -1;
 				priority[i] = 0;
 			}
 		}
 
 		bool enabled[SENSOR_COUNT_MAX];
 
-		int subscription[SENSOR_COUNT_MAX]; /**< raw sensor data subscription */
+		uORB::SubscriptionSet<SENSOR_COUNT_MAX> subscription; /**< raw sensor data subscriptions, one per instance */
 		uint8_t priority[SENSOR_COUNT_MAX]; /**< sensor priority */
 		uint8_t last_best_vote; /**< index of the latest best vote */
 		int subscription_count;
 		DataValidatorGroup voter;
 		unsigned int last_failover_count;
+		hrt_abstime last_vote{0}; /**< time of the latest vote */
 	};
 
+	/**
+	 * Instances that did not publish are skipped by the voter, but vote at least this often,
+	 * so that timeouts are still detected if all instances stopped publishing.
+	 */
+	static constexpr hrt_abstime VOTE_INTERVAL_MAX = 100000; // 100 ms
+
+	/**
+	 * Check if the voter of a sensor class needs to run and update the vote time.
+	 * @param updated	true if any instance put new data into the voter
+	 */
+	bool voteRequired(SensorData &sensor, bool updated, const hrt_abstime &now);
+
 	void initSensorClass(const orb_metadata *meta, SensorData &sensor_data, uint8_t sensor_count_max);
 
 	/**
@@ -212,8 +236,10 @@ private:
 	 */
 	bool checkFailover(SensorData &sensor, const char *sensor_name, const uint64_t type);
 
+	px4_sem_t _gyro_wakeup_sem; ///< posted by the best voted gyro, waited on by waitForGyro()
+
 	SensorData _accel {};
-	SensorData _gyro {};
+	SensorData _gyro {&_gyro_wakeup_sem};
 	SensorData _mag {};
 	SensorData _baro {};
 
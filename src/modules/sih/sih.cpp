@@ -44,6 +44,7 @@
 
 #include <px4_platform_common/getopt.h>
 #include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
 
 #include <drivers/drv_pwm_output.h>         // to get PWM flags
 
@@ -62,8 +63,44 @@ int Sih::custom_command(int argc, char *argv[])
 }
 
 
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+px4::atomic<bool> Sih::_lockstep_initialized {false};
+#endif
+
+static bool lockstep_requested(int argc, char *argv[])
+{
+	bool lockstep = false;
+	int myoptind = 1;
+	int ch;
+	const char *myoptarg = nullptr;
+
+	while ((ch = px4_getopt(argc, argv, "l", &myoptind, &myoptarg)) != EOF) {
+		switch (ch) {
+		case 'l':
+			lockstep = true;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return lockstep;
+}
+
 int Sih::task_spawn(int argc, char *argv[])
 {
+	const bool lockstep = lockstep_requested(argc, argv);
+
+#if !defined(ENABLE_LOCKSTEP_SCHEDULER)
+
+	if (lockstep) {
+		PX4_ERR("lockstep mode requires the lockstep scheduler");
+		return -EINVAL;
+	}
+
+#endif
+
 	_task_id = px4_task_spawn_cmd("sih",
 				      SCHED_DEFAULT,
 				      SCHED_PRIORITY_MAX,
@@ -76,12 +113,21 @@ int Sih::task_spawn(int argc, char *argv[])
 		return -errno;
 	}
 
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+
+	// like the simulator, block the rest of the startup until the time is initialized
+	while (lockstep && !lockstep_initialized()) {
+		system_usleep(100);
+	}
+
+#endif
+
 	return 0;
 }
 
 Sih *Sih::instantiate(int argc, char *argv[])
 {
-	Sih *instance = new Sih();
+	Sih *instance = new Sih(lockstep_requested(argc, argv));
 
 	if (instance == nullptr) {
 		PX4_ERR("alloc failed");
@@ -90,10 +136,11 @@ Sih *Sih::instantiate(int argc, char *argv[])
 	return instance;
 }
 
-Sih::Sih() :
+Sih::Sih(bool lockstep) :
 	ModuleParams(nullptr),
 	_loop_perf(perf_alloc(PC_ELAPSED, MODULE_NAME": execution")),
-	_sampling_perf(perf_alloc(PC_ELAPSED, MODULE_NAME": sampling"))
+	_sampling_perf(perf_alloc(PC_ELAPSED, MODULE_NAME": sampling")),
+	_lockstep(lockstep)
 {
 }
 
@@ -105,6 +152,15 @@ void Sih::run()
 	init_variables();
 	init_sensors();
 
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+
+	if (_lockstep) {
+		run_lockstep();
+		return;
+	}
+
+#endif
+
 	const hrt_abstime task_start = hrt_absolute_time();
 	_last_run = task_start;
 	_gps_time = task_start;
@@ -133,6 +189,85 @@ void Sih::run()
 	px4_sem_destroy(&_data_semaphore);
 }
 
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+void Sih::run_lockstep()
+{
+	PX4_INFO("running in lockstep");
+
+	// the first time update sets the time origin, hrt_absolute_time() starts at 0
+	_lockstep_time = LOOP_INTERVAL;
+	_last_run = 0;
+	_gps_time = 0;
+	_serial_time = 0;
+
+	while (!should_exit()) {
+		struct timespec ts;
+		abstime_to_ts(&ts, _lockstep_time);
+		px4_clock_settime(CLOCK_MONOTONIC, &ts);
+
+		if (!_lockstep_initialized.load()) {
+			_lockstep_initialized.store(true);
+		}
+
+		perf_begin(_loop_perf);
+
+		inner_loop();
+
+		perf_end(_loop_perf);
+
+		perf_begin(_sampling_perf);
+
+		lockstep_wait();
+
+		perf_end(_sampling_perf);
+
+		_lockstep_time += LOOP_INTERVAL;
+	}
+}
+
+// wait (in wall clock time) until the estimator and the controllers processed the last step
+void Sih::lockstep_wait()
+{
+	struct timespec ts;
+	system_clock_gettime(CLOCK_MONOTONIC, &ts);
+	const hrt_abstime wait_start = ts_to_abstime(&ts);
+
+	bool outputs_updated = !_lockstep_outputs_running;
+	bool ekf2_updated = !_lockstep_ekf2_running;
+
+	while (!should_exit()) {
+		if (_actuator_out_sub.updated()) {
+			// copied in read_motors() of the next step
+			outputs_updated = true;
+			_lockstep_outputs_running = true;
+		}
+
+		ekf2_timestamps_s ekf2_timestamps;
+
+		if (_ekf2_timestamps_sub.update(&ekf2_timestamps)) {
+			ekf2_updated = true;
+			_lockstep_ekf2_running = true;
+		}
+
+		const bool running = _lockstep_outputs_running || _lockstep_ekf2_running;
+
+		if (running && outputs_updated && ekf2_updated) {
+			return;
+		}
+
+		system_clock_gettime(CLOCK_MONOTONIC, &ts);
+		const hrt_abstime elapsed = ts_to_abstime(&ts) - wait_start;
+
+		// step at real time until the system is up, and never wait forever on a stopped module
+		if (elapsed >= (running ? LOCKSTEP_TIMEOUT : LOOP_INTERVAL)) {
+			return;
+		}
+
+		system_usleep(20);
+	}
+}
+#endif
+
 // timer_callback() is used as a real time callback to post the semaphore
 void Sih::timer_callback(void *sem)
 {
@@ -462,11 +597,15 @@ Quaternion representation is used for the attitude.
 Forward Euler is used for integration.
 Most of the variables are declared global in the .hpp file to avoid stack overflow.
 
+On SITL builds with the lockstep scheduler, the -l flag lets SIH drive the simulation clock itself
+(no external simulator needed). A new step is taken as soon as the estimator and the controllers
+processed the previous one, so the simulation runs as fast as the system allows.
 
 )DESCR_STR");
 
     PRINT_MODULE_USAGE_NAME("sih", "simulation");
     PRINT_MODULE_USAGE_COMMAND("start");
+    PRINT_MODULE_USAGE_PARAM_FLAG('l', "Lockstep: drive the simulation clock (SITL only)", true);
     PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 
     return 0;
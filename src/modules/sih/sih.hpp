@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include <px4_platform_common/atomic.h>
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/posix.h>
@@ -50,6 +51,7 @@
 #include <uORB/Subscription.hpp>
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/actuator_outputs.h>
+#include <uORB/topics/ekf2_timestamps.h>
 #include <uORB/topics/vehicle_angular_velocity.h>   // to publish groundtruth
 #include <uORB/topics/vehicle_attitude.h>           // to publish groundtruth
 #include <uORB/topics/vehicle_global_position.h>    // to publish groundtruth
@@ -60,7 +62,7 @@ extern "C" __EXPORT int sih_main(int argc, char *argv[]);
 class Sih : public ModuleBase<Sih>, public ModuleParams
 {
 public:
-	Sih();
+	Sih(bool lockstep = false);
 
 	virtual ~Sih() = default;
 
@@ -87,6 +89,10 @@ public:
 	// timer called periodically to post the semaphore
 	static void timer_callback(void *sem);
 
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	static bool lockstep_initialized() { return _lockstep_initialized.load(); }
+#endif
+
 private:
 
 	/**
@@ -140,6 +146,24 @@ private:
 	void publish_sih();
 	void inner_loop();
 
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	// lockstep mode: SIH drives the simulation clock and steps as soon as the controllers are done
+	void run_lockstep();
+	void lockstep_wait();
+
+	static constexpr hrt_abstime LOCKSTEP_TIMEOUT = 100000; // wall clock time after which a step is forced [us]
+
+	static px4::atomic<bool> _lockstep_initialized;
+
+	uORB::Subscription _ekf2_timestamps_sub{ORB_ID(ekf2_timestamps)};
+
+	hrt_abstime _lockstep_time{0};      // simulation time set on the lockstep scheduler [us]
+	bool _lockstep_outputs_running{false};  // actuator_outputs got published at least once
+	bool _lockstep_ekf2_running{false};     // ekf2_timestamps got published at least once
+#endif
+
+	bool _lockstep{false};
+
 	perf_counter_t  _loop_perf;
 	perf_counter_t  _sampling_perf;
 
@@ -94,6 +94,10 @@ int Simulator::start(int argc, char *argv[])
 			_instance->set_port(atoi(argv[3]));
 		}
 
+		if (argc == 4 && strcmp(argv[2], "-m") == 0) {
+			_instance->set_shm_name(argv[3]);
+		}
+
 		_instance->run();
 
 		return 0;
@@ -106,10 +110,11 @@ int Simulator::start(int argc, char *argv[])
 
 static void usage()
 {
-	PX4_INFO("Usage: simulator {start -[spt] [-u udp_port / -c tcp_port] |stop|status}");
+	PX4_INFO("Usage: simulator {start -[spt] [-u udp_port / -c tcp_port / -m shm_name] |stop|status}");
 	PX4_INFO("Start simulator:     simulator start");
 	PX4_INFO("Connect using UDP: simulator start -u udp_port");
 	PX4_INFO("Connect using TCP: simulator start -c tcp_port");
+	PX4_INFO("Connect using shared memory: simulator start -m shm_name");
 }
 
 __BEGIN_DECLS
@@ -73,12 +73,16 @@
 #include <uORB/topics/vehicle_odometry.h>
 #include <uORB/topics/vehicle_status.h>
 
+#include <cstring>
+#include <memory>
 #include <random>
 
 #include <v2.0/common/mavlink.h>
 #include <v2.0/mavlink_types.h>
 #include <lib/battery/battery.h>
 
+#include "simulator_shm.h"
+
 class Simulator : public ModuleParams
 {
 public:
@@ -94,6 +98,12 @@ public:
 	void set_ip(InternetProtocol ip) { _ip = ip; }
 	void set_port(unsigned port) { _port = port; }
 
+	/**
+	 * Use the shared memory transport instead of UDP/TCP.
+	 * @param name shared memory object name
+	 */
+	void set_shm_name(const char *name) { strncpy(_shm_name, name, sizeof(_shm_name) - 1); }
+
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 	bool has_initialized() { return _has_initialized.load(); }
 #endif
@@ -146,6 +156,9 @@ private:
 
 	InternetProtocol _ip{InternetProtocol::UDP};
 
+	char _shm_name[64] {};				///< shared memory transport is used if set
+	std::unique_ptr<SimulatorShm> _shm{};
+
 	double _realtime_factor{1.0};		///< How fast the simulation runs in comparison to real system time
 
 	hrt_abstime _last_sim_timestamp{0};
@@ -174,6 +187,8 @@ private:
 	} _battery;
 
 	void run();
+	bool connect_shm();
+	void poll_for_shm_messages();
 	void handle_message(const mavlink_message_t *msg);
 	void handle_message_distance_sensor(const mavlink_message_t *msg);
 	void handle_message_hil_gps(const mavlink_message_t *msg);
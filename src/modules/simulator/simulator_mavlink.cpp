@@ -547,6 +547,11 @@ void Simulator::handle_message_vision_position_estimate(const mavlink_message_t
 
 void Simulator::send_mavlink_message(const mavlink_message_t &aMsg)
 {
+	if (_shm) {
+		_shm->send(aMsg);
+		return;
+	}
+
 	uint8_t  buf[MAVLINK_MAX_PACKET_LEN];
 	uint16_t bufLen = 0;
 
@@ -692,7 +697,12 @@ void Simulator::run()
 	_myaddr.sin_addr.s_addr = htonl(INADDR_ANY);
 	_myaddr.sin_port = htons(_port);
 
-	if (_ip == InternetProtocol::UDP) {
+	if (_shm_name[0] != '\0') {
+		if (!connect_shm()) {
+			return;
+		}
+
+	} else if (_ip == InternetProtocol::UDP) {
 
 		if ((_fd = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
 			PX4_ERR("Creating UDP socket failed: %s", strerror(errno));
@@ -811,56 +821,62 @@ void Simulator::run()
 	// Request HIL_STATE_QUATERNION for ground truth.
 	request_hil_state_quaternion();
 
-	while (true) {
+	if (_shm) {
+		// the UART RC input is not available with the shared memory transport
+		poll_for_shm_messages();
 
-		// wait for new mavlink messages to arrive
-		int pret = ::poll(&fds[0], fd_count, 1000);
+	} else {
+		while (true) {
 
-		if (pret == 0) {
-			// Timed out.
-			continue;
-		}
+			// wait for new mavlink messages to arrive
+			int pret = ::poll(&fds[0], fd_count, 1000);
 
-		if (pret < 0) {
-			PX4_ERR("poll error %d, %d", pret, errno);
-			continue;
-		}
+			if (pret == 0) {
+				// Timed out.
+				continue;
+			}
+
+			if (pret < 0) {
+				PX4_ERR("poll error %d, %d", pret, errno);
+				continue;
+			}
 
-		if (fds[0].revents & POLLIN) {
+			if (fds[0].revents & POLLIN) {
 
-			int len = ::recvfrom(_fd, _buf, sizeof(_buf), 0, (struct sockaddr *)&_srcaddr, (socklen_t *)&_addrlen);
+				int len = ::recvfrom(_fd, _buf, sizeof(_buf), 0, (struct sockaddr *)&_srcaddr, (socklen_t *)&_addrlen);
 
-			if (len > 0) {
-				mavlink_message_t msg;
+				if (len > 0) {
+					mavlink_message_t msg;
 
-				for (int i = 0; i < len; i++) {
-					if (mavlink_parse_char(MAVLINK_COMM_0, _buf[i], &msg, &mavlink_status)) {
-						handle_message(&msg);
+					for (int i = 0; i < len; i++) {
+						if (mavlink_parse_char(MAVLINK_COMM_0, _buf[i], &msg, &mavlink_status)) {
+							handle_message(&msg);
+						}
 					}
 				}
 			}
-		}
 
 #ifdef ENABLE_UART_RC_INPUT
 
-		// got data from PIXHAWK
-		if (fd_count > 1 && fds[1].revents & POLLIN) {
-			int len = ::read(serial_fd, serial_buf, sizeof(serial_buf));
+			// got data from PIXHAWK
+			if (fd_count > 1 && fds[1].revents & POLLIN) {
+				int len = ::read(serial_fd, serial_buf, sizeof(serial_buf));
 
-			if (len > 0) {
-				mavlink_message_t msg;
+				if (len > 0) {
+					mavlink_message_t msg;
 
-				mavlink_status_t serial_status = {};
+					mavlink_status_t serial_status = {};
 
-				for (int i = 0; i < len; ++i) {
-					if (mavlink_parse_char(MAVLINK_COMM_1, serial_buf[i], &msg, &serial_status)) {
-						handle_message(&msg);
+					for (int i = 0; i < len; ++i) {
+						if (mavlink_parse_char(MAVLINK_COMM_1, serial_buf[i], &msg, &serial_status)) {
+							handle_message(&msg);
+						}
 					}
 				}
 			}
-		}
 
 #endif
+		}
 	}
 
 	orb_unsubscribe(_actuator_outputs_sub);
@@ -869,6 +885,40 @@ void Simulator::run()
 #endif
 }
 
+bool Simulator::connect_shm()
+{
+	_shm.reset(new SimulatorShm());
+
+	if (!_shm->open(_shm_name)) {
+		_shm.reset();
+		return false;
+	}
+
+	PX4_INFO("Waiting for simulator to connect on shared memory %s", _shm_name);
+
+	mavlink_message_t msg;
+
+	// Once we receive something, we're most probably good and can carry on.
+	while (!_shm->receive(&msg, 1000)) {
+	}
+
+	PX4_INFO("Simulator connected on shared memory %s.", _shm_name);
+
+	return true;
+}
+
+void Simulator::poll_for_shm_messages()
+{
+	mavlink_message_t msg;
+
+	while (true) {
+		// messages are passed decoded, no need to parse a byte stream
+		if (_shm->receive(&msg, 1000)) {
+			handle_message(&msg);
+		}
+	}
+}
+
 #ifdef ENABLE_UART_RC_INPUT
 int openUart(const char *uart_name, int baud)
 {
@@ -0,0 +1,195 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file simulator_shm.cpp
+ *
+ * Shared memory transport between PX4 SITL and the simulator.
+ */
+
+#include "simulator_shm.h"
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <initializer_list>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__PX4_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+static_assert((SimulatorShm::RING_SIZE & (SimulatorShm::RING_SIZE - 1)) == 0, "RING_SIZE must be a power of 2");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "atomic needs to be usable as futex word");
+
+SimulatorShm::~SimulatorShm()
+{
+	if (_layout) {
+		munmap(_layout, sizeof(Layout));
+		shm_unlink(_name);
+	}
+}
+
+bool SimulatorShm::open(const char *name)
+{
+	strncpy(_name, name, sizeof(_name) - 1);
+
+	int fd = shm_open(_name, O_RDWR | O_CREAT, 0666);
+
+	if (fd < 0) {
+		PX4_ERR("shm_open %s failed: %s", _name, strerror(errno));
+		return false;
+	}
+
+	if (ftruncate(fd, sizeof(Layout)) != 0) {
+		PX4_ERR("ftruncate %s failed: %s", _name, strerror(errno));
+		::close(fd);
+		return false;
+	}
+
+	void *ptr = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (ptr == MAP_FAILED) {
+		PX4_ERR("mmap %s failed: %s", _name, strerror(errno));
+		return false;
+	}
+
+	_layout = static_cast<Layout *>(ptr);
+
+	// (re)initialize, the simulator waits for the magic before it starts using the rings
+	_layout->magic = 0;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	for (Ring *ring : {&_layout->to_px4, &_layout->to_sim}) {
+		ring->head.store(0);
+		ring->tail.store(0);
+		ring->futex.store(0);
+		ring->waiting.store(0);
+	}
+
+	_layout->version = LAYOUT_VERSION;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	_layout->magic = MAGIC;
+
+	return true;
+}
+
+void SimulatorShm::send(const mavlink_message_t &msg)
+{
+	push(_layout->to_sim, msg);
+}
+
+bool SimulatorShm::receive(mavlink_message_t *msg, int timeout_ms)
+{
+	return pop(_layout->to_px4, msg, timeout_ms);
+}
+
+void SimulatorShm::push(Ring &ring, const mavlink_message_t &msg)
+{
+	const uint32_t head = ring.head.load(std::memory_order_relaxed);
+
+	// the consumer is expected to keep up, so simply back off while the ring is full
+	while (head - ring.tail.load(std::memory_order_acquire) >= RING_SIZE) {
+		system_usleep(50);
+	}
+
+	ring.slots[head & (RING_SIZE - 1)] = msg;
+	ring.head.store(head + 1, std::memory_order_release);
+
+	ring.futex.fetch_add(1, std::memory_order_seq_cst);
+
+	if (ring.waiting.load(std::memory_order_seq_cst)) {
+		futex_wake(ring.futex);
+	}
+}
+
+bool SimulatorShm::pop(Ring &ring, mavlink_message_t *msg, int timeout_ms)
+{
+	const uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+
+	if (ring.head.load(std::memory_order_acquire) == tail) {
+		// read the futex word before checking again, a push in between changes it and the wait returns at once
+		ring.waiting.store(1, std::memory_order_seq_cst);
+		const uint32_t value = ring.futex.load(std::memory_order_seq_cst);
+
+		if (ring.head.load(std::memory_order_acquire) == tail) {
+			futex_wait(ring.futex, value, timeout_ms);
+		}
+
+		ring.waiting.store(0, std::memory_order_relaxed);
+
+		if (ring.head.load(std::memory_order_acquire) == tail) {
+			return false;
+		}
+	}
+
+	*msg = ring.slots[tail & (RING_SIZE - 1)];
+	ring.tail.store(tail + 1, std::memory_order_release);
+
+	return true;
+}
+
+void SimulatorShm::futex_wait(std::atomic<uint32_t> &futex, uint32_t value, int timeout_ms)
+{
+#if defined(__PX4_LINUX)
+	struct timespec timeout {};
+	timeout.tv_sec = timeout_ms / 1000;
+	timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+
+	// not FUTEX_PRIVATE_FLAG, the futex is shared with the simulator process
+	syscall(SYS_futex, reinterpret_cast<uint32_t *>(&futex), FUTEX_WAIT, value, &timeout, nullptr, 0);
+#else
+	// no futex available, poll instead
+	for (int i = 0; i < timeout_ms * 10 && futex.load() == value; i++) {
+		system_usleep(100);
+	}
+
+#endif
+}
+
+void SimulatorShm::futex_wake(std::atomic<uint32_t> &futex)
+{
+#if defined(__PX4_LINUX)
+	syscall(SYS_futex, reinterpret_cast<uint32_t *>(&futex), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+	(void)futex;
+#endif
+}
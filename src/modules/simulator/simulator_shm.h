@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file simulator_shm.h
+ *
+ * Shared memory transport between PX4 SITL and the simulator, an alternative to MAVLink over UDP/TCP.
+ *
+ * The segment contains two single producer/single consumer rings of mavlink_message_t, one per direction.
+ * Messages are passed decoded, so neither side needs to serialize and parse a byte stream, and a waiting
+ * consumer is woken up via a futex instead of a socket. The layout below is the contract with the simulator
+ * plugin, SimulatorShm::LAYOUT_VERSION needs to be increased on every change.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include <v2.0/mavlink_types.h>
+
+class SimulatorShm
+{
+public:
+	static constexpr uint32_t MAGIC = 0x50583453; // 'PX4S'
+	static constexpr uint32_t LAYOUT_VERSION = 1;
+	static constexpr uint32_t RING_SIZE = 64; ///< number of messages per direction, power of 2
+
+	struct Ring {
+		std::atomic<uint32_t> head;	///< next slot to write, only modified by the producer
+		std::atomic<uint32_t> tail;	///< next slot to read, only modified by the consumer
+		std::atomic<uint32_t> futex;	///< incremented on every push, the consumer waits on it
+		std::atomic<uint32_t> waiting;	///< set by the consumer while it is waiting on the futex
+		mavlink_message_t slots[RING_SIZE];
+	};
+
+	struct Layout {
+		uint32_t magic;
+		uint32_t version;
+		Ring to_px4;	///< simulator -> PX4 (HIL_SENSOR, HIL_GPS, ...)
+		Ring to_sim;	///< PX4 -> simulator (HIL_ACTUATOR_CONTROLS, ...)
+	};
+
+	SimulatorShm() = default;
+	~SimulatorShm();
+
+	/**
+	 * Create (or reuse) and map the shared memory segment.
+	 * @param name shared memory object name, e.g. "/px4_sim_0"
+	 * @return true on success
+	 */
+	bool open(const char *name);
+
+	/**
+	 * Send a message to the simulator, blocks while the ring is full.
+	 */
+	void send(const mavlink_message_t &msg);
+
+	/**
+	 * Receive a message from the simulator.
+	 * @param timeout_ms maximum time to wait for a message
+	 * @return true if a message was received, false on timeout
+	 */
+	bool receive(mavlink_message_t *msg, int timeout_ms);
+
+private:
+	static void push(Ring &ring, const mavlink_message_t &msg);
+	static bool pop(Ring &ring, mavlink_message_t *msg, int timeout_ms);
+
+	static void futex_wait(std::atomic<uint32_t> &futex, uint32_t value, int timeout_ms);
+	static void futex_wake(std::atomic<uint32_t> &futex);
+
+	Layout *_layout{nullptr};
+	char _name[64] {};
+};
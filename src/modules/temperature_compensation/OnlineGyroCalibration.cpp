@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "OnlineGyroCalibration.hpp"
+
+#include <lib/parameters/param.h>
+#include <px4_platform_common/log.h>
+
+namespace temperature_compensation
+{
+
+void OnlineGyroCalibration::update(int instance, const sensor_gyro_s &gyro)
+{
+	if (instance < 0 || instance >= GYRO_COUNT_MAX) {
+		return;
+	}
+
+	PerSensorData &data = _data[instance];
+
+	if (data.device_id != gyro.device_id) {
+		// new or different sensor: start over
+		data = PerSensorData{};
+		data.device_id = gyro.device_id;
+	}
+
+	// reject samples with a rate that can't be an offset (e.g. the vehicle is carried around)
+	if (fabsf(gyro.x) > MAX_RATE || fabsf(gyro.y) > MAX_RATE || fabsf(gyro.z) > MAX_RATE
+	    || !PX4_ISFINITE(gyro.temperature)) {
+		return;
+	}
+
+	if (data.samples == 0) {
+		data.ref_temp = gyro.temperature;
+		data.min_temp = gyro.temperature;
+		data.max_temp = gyro.temperature;
+	}
+
+	data.min_temp = math::min(data.min_temp, gyro.temperature);
+	data.max_temp = math::max(data.max_temp, gyro.temperature);
+
+	const double relative_temperature = (double)gyro.temperature - (double)data.ref_temp;
+	data.P[0].update(relative_temperature, (double)gyro.x);
+	data.P[1].update(relative_temperature, (double)gyro.y);
+	data.P[2].update(relative_temperature, (double)gyro.z);
+	data.samples++;
+}
+
+bool OnlineGyroCalibration::fit(const PerSensorData &data, double res[3][4])
+{
+	if (data.samples == 0 || (data.max_temp - data.min_temp) < MIN_TEMPERATURE_SPAN) {
+		return false;
+	}
+
+	for (int axis = 0; axis < 3; axis++) {
+		data.P[axis].fit(res[axis]);
+
+		for (int i = 0; i < 4; i++) {
+			if (!PX4_ISFINITE(res[axis][i])) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+int OnlineGyroCalibration::save()
+{
+	int saved = 0;
+
+	for (int instance = 0; instance < GYRO_COUNT_MAX; instance++) {
+		const PerSensorData &data = _data[instance];
+		double res[3][4] {};
+
+		if (!fit(data, res)) {
+			continue;
+		}
+
+		char str[20] {};
+
+		snprintf(str, sizeof(str), "TC_G%d_ID", instance);
+		int32_t device_id = data.device_id;
+		param_set_no_notification(param_find(str), &device_id);
+
+		// res[] holds the coefficients from the highest order down
+		for (int axis = 0; axis < 3; axis++) {
+			for (int coef = 0; coef <= 3; coef++) {
+				snprintf(str, sizeof(str), "TC_G%d_X%d_%d", instance, 3 - coef, axis);
+				float value = (float)res[axis][coef];
+				param_set_no_notification(param_find(str), &value);
+			}
+		}
+
+		snprintf(str, sizeof(str), "TC_G%d_TMIN", instance);
+		param_set_no_notification(param_find(str), &data.min_temp);
+		snprintf(str, sizeof(str), "TC_G%d_TMAX", instance);
+		param_set_no_notification(param_find(str), &data.max_temp);
+		snprintf(str, sizeof(str), "TC_G%d_TREF", instance);
+		param_set_no_notification(param_find(str), &data.ref_temp);
+
+		saved++;
+	}
+
+	if (saved > 0) {
+		int32_t enabled = 1;
+		param_set(param_find("TC_G_ENABLE"), &enabled);
+	}
+
+	return saved;
+}
+
+void OnlineGyroCalibration::reset()
+{
+	for (auto &data : _data) {
+		data = PerSensorData{};
+	}
+}
+
+void OnlineGyroCalibration::print_status() const
+{
+	PX4_INFO("Online gyro calibration:");
+
+	for (int instance = 0; instance < GYRO_COUNT_MAX; instance++) {
+		const PerSensorData &data = _data[instance];
+
+		if (data.samples == 0) {
+			continue;
+		}
+
+		PX4_INFO(" gyro %d: ID %u, %u samples, %.1f to %.1f deg C (min span %.1f)", instance, data.device_id,
+			 data.samples, (double)data.min_temp, (double)data.max_temp, (double)MIN_TEMPERATURE_SPAN);
+
+		double res[3][4] {};
+
+		if (fit(data, res)) {
+			for (int axis = 0; axis < 3; axis++) {
+				PX4_INFO("  proposed TC_G%d_X3..X0_%d: %.9f %.9f %.9f %.9f (TREF %.1f)", instance, axis,
+					 res[axis][0], res[axis][1], res[axis][2], res[axis][3], (double)data.ref_temp);
+			}
+		}
+	}
+}
+
+} // namespace temperature_compensation
@@ -0,0 +1,96 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file OnlineGyroCalibration.hpp
+ *
+ * Background estimation of the gyro temperature calibration (TC_G* parameters) while the vehicle is at rest.
+ * The polynomial is fitted with a streaming least squares fit (the accumulated normal equations are of fixed size),
+ * so the memory usage is constant no matter how long the estimation runs.
+ *
+ * Only the gyro is supported: at rest its true rate is zero, so the raw reading is the offset. The accel and baro
+ * would need a reference (orientation, altitude) that is not known in the background.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <uORB/topics/sensor_gyro.h>
+
+#include "TemperatureCompensation.h"
+#include "temperature_calibration/polyfit.hpp"
+
+namespace temperature_compensation
+{
+
+class OnlineGyroCalibration
+{
+public:
+	/**
+	 * Add a gyro sample, only call this while the vehicle is at rest.
+	 * @param instance uORB topic instance (index of the TC_G* parameters)
+	 */
+	void update(int instance, const sensor_gyro_s &gyro);
+
+	/**
+	 * Write the proposed TC_G* parameters of all instances that covered enough temperature span and enable
+	 * the gyro temperature compensation.
+	 * @return number of instances written
+	 */
+	int save();
+
+	/** discard all collected data */
+	void reset();
+
+	void print_status() const;
+
+private:
+	static constexpr float MIN_TEMPERATURE_SPAN = 10.f;	///< minimum temperature span for a proposal [deg C]
+	static constexpr float MAX_RATE = 0.1f;			///< maximum raw rate of a sample at rest [rad/s]
+
+	struct PerSensorData {
+		polyfitter<4> P[3];	///< 3rd order fit per axis
+		uint32_t device_id{0};
+		uint32_t samples{0};
+		float ref_temp{0.f};	///< fit reference temperature (first sample)
+		float min_temp{0.f};
+		float max_temp{0.f};
+	};
+
+	static bool fit(const PerSensorData &data, double res[3][4]);
+
+	PerSensorData _data[GYRO_COUNT_MAX] {};
+};
+
+} // namespace temperature_compensation
@@ -286,17 +286,9 @@ bool TemperatureCompensation::calc_thermal_offsets_1D(SensorCalData1D &coef, flo
 
 	}
 
-	// calulate the offset
-	float temp_var = delta_temp;
-	offset = coef.x0 + coef.x1 * temp_var;
-	temp_var *= delta_temp;
-	offset += coef.x2 * temp_var;
-	temp_var *= delta_temp;
-	offset += coef.x3 * temp_var;
-	temp_var *= delta_temp;
-	offset += coef.x4 * temp_var;
-	temp_var *= delta_temp;
-	offset += coef.x5 * temp_var;
+	// calulate the offset (Horner form)
+	offset = coef.x0 + delta_temp * (coef.x1 + delta_temp * (coef.x2 + delta_temp * (coef.x3 + delta_temp *
+					 (coef.x4 + delta_temp * coef.x5))));
 
 	return ret;
 
@@ -322,12 +314,9 @@ bool TemperatureCompensation::calc_thermal_offsets_3D(const SensorCalData3D &coe
 
 	}
 
-	// calulate the offsets
-	float delta_temp_2 = delta_temp * delta_temp;
-	float delta_temp_3 = delta_temp_2 * delta_temp;
-
+	// calulate the offsets (Horner form)
 	for (uint8_t i = 0; i < 3; i++) {
-		offset[i] = coef.x0[i] + coef.x1[i] * delta_temp + coef.x2[i] * delta_temp_2 + coef.x3[i] * delta_temp_3;
+		offset[i] = coef.x0[i] + delta_temp * (coef.x1[i] + delta_temp * (coef.x2[i] + delta_temp * coef.x3[i]));
 	}
 
 	return ret;
@@ -367,6 +356,8 @@ int TemperatureCompensation::set_sensor_id(uint32_t device_id, int topic_instanc
 	for (int i = 0; i < sensor_count_max; ++i) {
 		if (device_id == (uint32_t)sensor_cal_data[i].ID) {
 			sensor_data.device_mapping[topic_instance] = i;
+			// force a recomputation with the new mapping
+			sensor_data.last_temperature[topic_instance] = -100.0f;
 			return i;
 		}
 	}
@@ -389,6 +380,14 @@ int TemperatureCompensation::update_scales_and_offsets_gyro(int topic_instance,
 		return -1;
 	}
 
+	// The offsets only change with the temperature, which changes slowly: only recompute and publish them
+	// if the temperature changed by more than the threshold since the last update
+	if (fabsf(temperature - _gyro_data.last_temperature[topic_instance]) <= TEMPERATURE_CHANGE_THRESHOLD) {
+		return 1;
+	}
+
+	_gyro_data.last_temperature[topic_instance] = temperature;
+
 	// Calculate and update the offsets
 	calc_thermal_offsets_3D(_parameters.gyro_cal_data[mapping], temperature, offsets);
 
@@ -397,13 +396,7 @@ int TemperatureCompensation::update_scales_and_offsets_gyro(int topic_instance,
 		scales[axis_index] = _parameters.gyro_cal_data[mapping].scale[axis_index];
 	}
 
-	// Check if temperature delta is large enough to warrant a new publication
-	if (fabsf(temperature - _gyro_data.last_temperature[topic_instance]) > 1.0f) {
-		_gyro_data.last_temperature[topic_instance] = temperature;
-		return 2;
-	}
-
-	return 1;
+	return 2;
 }
 
 int TemperatureCompensation::update_scales_and_offsets_accel(int topic_instance, float temperature, float *offsets,
@@ -421,6 +414,14 @@ int TemperatureCompensation::update_scales_and_offsets_accel(int topic_instance,
 		return -1;
 	}
 
+	// The offsets only change with the temperature, which changes slowly: only recompute and publish them
+	// if the temperature changed by more than the threshold since the last update
+	if (fabsf(temperature - _accel_data.last_temperature[topic_instance]) <= TEMPERATURE_CHANGE_THRESHOLD) {
+		return 1;
+	}
+
+	_accel_data.last_temperature[topic_instance] = temperature;
+
 	// Calculate and update the offsets
 	calc_thermal_offsets_3D(_parameters.accel_cal_data[mapping], temperature, offsets);
 
@@ -429,13 +430,7 @@ int TemperatureCompensation::update_scales_and_offsets_accel(int topic_instance,
 		scales[axis_index] = _parameters.accel_cal_data[mapping].scale[axis_index];
 	}
 
-	// Check if temperature delta is large enough to warrant a new publication
-	if (fabsf(temperature - _accel_data.last_temperature[topic_instance]) > 1.0f) {
-		_accel_data.last_temperature[topic_instance] = temperature;
-		return 2;
-	}
-
-	return 1;
+	return 2;
 }
 
 int TemperatureCompensation::update_scales_and_offsets_baro(int topic_instance, float temperature, float *offsets,
@@ -453,19 +448,21 @@ int TemperatureCompensation::update_scales_and_offsets_baro(int topic_instance,
 		return -1;
 	}
 
+	// The offsets only change with the temperature, which changes slowly: only recompute and publish them
+	// if the temperature changed by more than the threshold since the last update
+	if (fabsf(temperature - _baro_data.last_temperature[topic_instance]) <= TEMPERATURE_CHANGE_THRESHOLD) {
+		return 1;
+	}
+
+	_baro_data.last_temperature[topic_instance] = temperature;
+
 	// Calculate and update the offsets
 	calc_thermal_offsets_1D(_parameters.baro_cal_data[mapping], temperature, *offsets);
 
 	// Update the scales
 	*scales = _parameters.baro_cal_data[mapping].scale;
 
-	// Check if temperature delta is large enough to warrant a new publication
-	if (fabsf(temperature - _baro_data.last_temperature[topic_instance]) > 1.0f) {
-		_baro_data.last_temperature[topic_instance] = temperature;
-		return 2;
-	}
-
-	return 1;
+	return 2;
 }
 
 void TemperatureCompensation::print_status()
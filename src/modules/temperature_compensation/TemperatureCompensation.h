@@ -87,7 +87,7 @@ public:
 	 * @param scales returns scales that were applied (length = 3), depending on return value
 	 * @return -1: error: correction enabled, but no sensor mapping set (@see set_sendor_id_gyro)
 	 *         0: no changes (correction not enabled),
-	 *         1: corrections applied but no changes to offsets & scales,
+	 *         1: corrections applied but no changes to offsets & scales (offsets & scales are not written),
 	 *         2: corrections applied and offsets & scales updated
 	 */
 	int update_scales_and_offsets_gyro(int topic_instance, float temperature, float *offsets, float *scales);
@@ -276,6 +276,8 @@ private:
 		float last_temperature[SENSOR_COUNT_MAX] {};
 	};
 
+	static constexpr float TEMPERATURE_CHANGE_THRESHOLD = 1.0f; ///< temperature change to recompute the corrections [deg C]
+
 	PerSensorData _gyro_data;
 	PerSensorData _accel_data;
 	PerSensorData _baro_data;
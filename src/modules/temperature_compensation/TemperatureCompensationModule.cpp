@@ -70,6 +70,12 @@ TemperatureCompensationModule::~TemperatureCompensationModule()
 
 void TemperatureCompensationModule::parameters_update()
 {
+	updateParams();
+
+	if (!_param_tc_g_online.get()) {
+		_online_gyro_calibration.reset();
+	}
+
 	_temperature_compensation.parameters_update();
 
 	// Gyro
@@ -167,6 +173,10 @@ void TemperatureCompensationModule::gyroPoll()
 		// Grab temperature from report
 		if (_gyro_subs[uorb_index].update(&report)) {
 
+			if (_at_rest && _param_tc_g_online.get()) {
+				_online_gyro_calibration.update(uorb_index, report);
+			}
+
 			// Update the scales and offsets and mark for publication if they've changed
 			if (_temperature_compensation.update_scales_and_offsets_gyro(uorb_index, report.temperature, offsets[uorb_index],
 					scales[uorb_index]) == 2) {
@@ -265,6 +275,23 @@ void TemperatureCompensationModule::Run()
 		parameters_update();
 	}
 
+	// the online gyro calibration only uses samples while the vehicle is disarmed and landed
+	actuator_armed_s armed;
+	vehicle_land_detected_s land_detected;
+
+	if (_actuator_armed_sub.copy(&armed) && _vehicle_land_detected_sub.copy(&land_detected)) {
+		_at_rest = !armed.armed && land_detected.landed;
+
+	} else {
+		_at_rest = false;
+	}
+
+	if (_online_save_requested.load()) {
+		int saved = _online_gyro_calibration.save();
+		PX4_INFO("online gyro calibration: saved %d instance(s)", saved);
+		_online_save_requested.store(false);
+	}
+
 	accelPoll();
 	gyroPoll();
 	baroPoll();
@@ -373,6 +400,15 @@ int TemperatureCompensationModule::custom_command(int argc, char *argv[])
 
 		return PX4_OK;
 
+	} else if (!strcmp(argv[0], "save_online")) {
+		if (!is_running()) {
+			PX4_WARN("background task not running");
+			return PX4_ERROR;
+		}
+
+		get_instance()->_online_save_requested.store(true);
+		return PX4_OK;
+
 	} else {
 		print_usage("unrecognized command");
 
@@ -384,6 +420,10 @@ int TemperatureCompensationModule::print_status()
 {
 	_temperature_compensation.print_status();
 
+	if (_param_tc_g_online.get()) {
+		_online_gyro_calibration.print_status();
+	}
+
 	return PX4_OK;
 }
 
@@ -402,6 +442,10 @@ whenever a change in temperature is detected. The module can also be configured
 routine at next boot, which allows the thermal calibration coeffecients to be calculated while the vehicle undergoes
 a temperature cycle.
 
+With TC_G_ONLINE enabled, the gyro calibration is additionally estimated in the background whenever the vehicle is
+disarmed and landed. The proposed coefficients are shown with `status` once enough temperature span was covered
+and can be stored with `save_online`.
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("temperature_compensation", "system");
@@ -410,6 +454,7 @@ a temperature cycle.
 	PRINT_MODULE_USAGE_PARAM_FLAG('g', "calibrate the gyro", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('a', "calibrate the accel", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('b', "calibrate the baro (if none of these is given, all will be calibrated)", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("save_online", "Save the gyro calibration proposed by the online calibration (TC_G_ONLINE)");
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 
 	return 0;
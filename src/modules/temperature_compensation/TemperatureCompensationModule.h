@@ -48,6 +48,7 @@
 #include <px4_platform_common/time.h>
 #include <uORB/Publication.hpp>
 #include <uORB/Subscription.hpp>
+#include <uORB/topics/actuator_armed.h>
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/sensor_accel.h>
 #include <uORB/topics/sensor_baro.h>
@@ -55,7 +56,9 @@
 #include <uORB/topics/sensor_gyro.h>
 #include <uORB/topics/vehicle_command.h>
 #include <uORB/topics/vehicle_command_ack.h>
+#include <uORB/topics/vehicle_land_detected.h>
 
+#include "OnlineGyroCalibration.hpp"
 #include "TemperatureCompensation.h"
 
 namespace temperature_compensation
@@ -120,6 +123,8 @@ private:
 		{ORB_ID(sensor_baro), 2}
 	};
 
+	uORB::Subscription _actuator_armed_sub{ORB_ID(actuator_armed)};
+	uORB::Subscription _vehicle_land_detected_sub{ORB_ID(vehicle_land_detected)};
 	uORB::Subscription _params_sub{ORB_ID(parameter_update)};
 	uORB::Subscription _vehicle_command_sub{ORB_ID(vehicle_command)};
 
@@ -134,6 +139,15 @@ private:
 	uORB::Publication<sensor_correction_s> _sensor_correction_pub{ORB_ID(sensor_correction)};
 
 	bool _corrections_changed{true};
+
+	/* background gyro temperature calibration */
+	OnlineGyroCalibration _online_gyro_calibration;
+	px4::atomic_bool _online_save_requested{false};
+	bool _at_rest{false};
+
+	DEFINE_PARAMETERS(
+		(ParamBool<px4::params::TC_G_ONLINE>) _param_tc_g_online
+	)
 };
 
 } // namespace temperature_compensation
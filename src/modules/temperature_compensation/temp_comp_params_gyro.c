@@ -49,6 +49,18 @@
  */
 PARAM_DEFINE_INT32(TC_G_ENABLE, 0);
 
+/**
+ * Online thermal calibration for rate gyro sensors.
+ *
+ * Estimate the gyro thermal calibration in the background while the vehicle is disarmed and landed.
+ * The proposed coefficients are shown by 'temperature_compensation status' and stored with
+ * 'temperature_compensation save_online'.
+ *
+ * @group Thermal Compensation
+ * @boolean
+ */
+PARAM_DEFINE_INT32(TC_G_ONLINE, 0);
+
 /* Gyro 0 */
 
 /**
@@ -117,7 +117,7 @@ public:
 		update_VTY(x, y);
 	}
 
-	bool fit(double res[])
+	bool fit(double res[]) const
 	{
 		//Do inverse of VTV
 		matrix::SquareMatrix<double, _forder> IVTV;
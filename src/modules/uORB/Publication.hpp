@@ -42,6 +42,9 @@
 #include <systemlib/err.h>
 #include <uORB/uORB.h>
 
+#include "uORBDeviceNode.hpp"
+#include "uORBManager.hpp"
+
 namespace uORB
 {
 
@@ -82,10 +85,60 @@ public:
 		return false;
 	}
 
+	/**
+	 * Loan the next message of the topic to fill it in place, avoiding a copy for large topics.
+	 * The topic is advertised (without initial data) if needed.
+	 * A successful loan must be followed by publish_loan() or cancel_loan().
+	 * @return pointer to the message to fill, nullptr if not possible (fall back to publish())
+	 */
+	T *loan()
+	{
+		if (_loan != nullptr) {
+			return _loan;
+		}
+
+		if (_handle == nullptr) {
+			_handle = orb_advertise(_meta, nullptr);
+		}
+
+		if (_handle != nullptr) {
+			_loan = static_cast<T *>(Manager::get_instance()->orb_loan(_handle));
+		}
+
+		return _loan;
+	}
+
+	/**
+	 * Publish the loaned message
+	 */
+	bool publish_loan()
+	{
+		if (_loan != nullptr) {
+			const bool ret = (Manager::get_instance()->orb_publish_loan(_meta, _handle, _loan) == PX4_OK);
+			_loan = nullptr;
+			return ret;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Return the loaned message without publishing it
+	 */
+	void cancel_loan()
+	{
+		if (_loan != nullptr) {
+			static_cast<DeviceNode *>(_handle)->cancel_loan();
+			_loan = nullptr;
+		}
+	}
+
 protected:
 	const orb_metadata *_meta;
 
 	orb_advert_t _handle{nullptr};
+
+	T *_loan{nullptr};
 };
 
 /**
@@ -81,6 +81,7 @@ public:
 
 			if (handle != nullptr) {
 				_handle = handle;
+				_instance = instance;
 				return true;
 			}
 		}
@@ -88,11 +89,36 @@ public:
 		return false;
 	}
 
+	/**
+	 * Advertise the topic without publishing, to claim the next free instance.
+	 * @return true if advertised
+	 */
+	bool advertise()
+	{
+		if (_handle == nullptr) {
+			int instance = 0;
+			_handle = orb_advertise_multi(_meta, nullptr, &instance, _priority);
+
+			if (_handle != nullptr) {
+				_instance = instance;
+			}
+		}
+
+		return (_handle != nullptr);
+	}
+
+	/**
+	 * The instance of the topic, -1 if not advertised yet.
+	 */
+	int get_instance() const { return _instance; }
+
 protected:
 	const orb_metadata *_meta;
 
 	orb_advert_t _handle{nullptr};
 
+	int _instance{-1};
+
 	const uint8_t _priority;
 };
 
@@ -74,6 +74,20 @@ public:
 	bool subscribe();
 	void unsubscribe();
 
+	/**
+	 * Change the topic and instance, resubscribing if needed.
+	 * @param meta The uORB metadata (usually from the ORB_ID() macro) for the topic.
+	 * @param instance The instance for multi sub.
+	 * @return true if subscribed to the new topic
+	 */
+	bool set_topic(const orb_metadata *meta, uint8_t instance = 0)
+	{
+		unsubscribe();
+		_meta = meta;
+		_instance = instance;
+		return subscribe();
+	}
+
 	bool valid() const { return _node != nullptr; }
 	bool advertised()
 	{
@@ -118,11 +132,67 @@ public:
 	 * Copy the struct
 	 * @param data The uORB message struct we are updating.
 	 */
-	bool copy(void *dst) { return advertised() ? _node->copy(dst, _last_generation) : false; }
+	bool copy(void *dst)
+	{
+		uint32_t lost;
+		return copy(dst, lost);
+	}
+
+	/**
+	 * Copy the next message, reporting the number of messages lost since the previous copy
+	 * (the queue overflowed because the subscriber didn't keep up).
+	 */
+	bool copy(void *dst, uint32_t &lost_messages)
+	{
+		lost_messages = 0;
+
+		if (advertised() && _node->copy(dst, _last_generation, lost_messages)) {
+			_lost_messages += lost_messages;
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Total number of messages this subscription lost since it was created, because the queue
+	 * overflowed before they were read (each subscriber has its own read position in the queue).
+	 */
+	uint32_t lost_messages() const { return _lost_messages; }
+
+	/**
+	 * Request a longer queue for the topic. This only works before the first publication.
+	 * @return true if the queue is at least queue_size long
+	 */
+	bool increase_queue_size(uint8_t queue_size) { return valid() && (_node->increase_queue_size(queue_size) == PX4_OK); }
+
+	/**
+	 * Allow borrowing messages in place (see borrow()). This must be done before the topic
+	 * is published the first time, usually right after construction.
+	 * @return true if borrowing is possible
+	 */
+	bool enable_borrow() { return (valid() || init()) ? _node->enable_loans() : false; }
+
+	/**
+	 * Borrow the next message without copying it (as with copy() the subscription is marked as read).
+	 * The result must be checked with borrow_valid() once the data has been consumed.
+	 * @return pointer to the message, nullptr if not possible (fall back to copy())
+	 */
+	const void *borrow() { return advertised() ? _node->borrow(_last_generation, _borrowed_generation) : nullptr; }
+
+	/**
+	 * Check if the last borrowed message has not been overwritten in the meantime.
+	 */
+	bool borrow_valid() const { return (_node != nullptr) && _node->borrow_valid(_borrowed_generation); }
 
 	uint8_t		get_instance() const { return _instance; }
 	orb_id_t	get_topic() const { return _meta; }
 
+	/**
+	 * Priority of the publisher, 0 if not advertised.
+	 */
+	uint8_t		get_priority() { return advertised() ? _node->get_priority() : 0; }
+
 protected:
 
 	friend class SubscriptionCallback;
@@ -140,6 +210,8 @@ protected:
 	 * attempts if the topic has not yet been published.
 	 */
 	unsigned		_last_generation{0};
+	unsigned		_borrowed_generation{0}; /**< generation of the last borrowed message */
+	uint32_t		_lost_messages{0}; /**< messages lost by this subscription (queue overflow) */
 	uint8_t			_instance{0};
 };
 
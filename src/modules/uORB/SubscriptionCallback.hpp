@@ -40,6 +40,7 @@
 
 #include <uORB/SubscriptionInterval.hpp>
 #include <containers/List.hpp>
+#include <lib/trace/trace.h>
 #include <px4_platform_common/px4_work_queue/WorkItem.hpp>
 
 namespace uORB
@@ -100,6 +101,11 @@ public:
 
 	virtual void call() = 0;
 
+	/**
+	 * Name of the subscribing module for the topic graph, nullptr if not known.
+	 */
+	virtual const char *name() const { return nullptr; }
+
 protected:
 
 	bool _registered{false};
@@ -129,10 +135,13 @@ public:
 	{
 		// schedule immediately if no interval, otherwise check time elapsed
 		if ((_interval_us == 0) || (hrt_elapsed_time_atomic(&_last_update) >= _interval_us)) {
+			trace_record(TRACE_ORB_CALLBACK, _work_item->ItemName());
 			_work_item->ScheduleNow();
 		}
 	}
 
+	const char *name() const override { return _work_item->ItemName(); }
+
 private:
 	px4::WorkItem *_work_item;
 };
@@ -118,8 +118,14 @@ public:
 
 	bool		valid() const { return _subscription.valid(); }
 
+	/**
+	 * Number of messages lost by this subscription (see Subscription::lost_messages()).
+	 */
+	uint32_t	lost_messages() const { return _subscription.lost_messages(); }
+
 	uint8_t		get_instance() const { return _subscription.get_instance(); }
 	orb_id_t	get_topic() const { return _subscription.get_topic(); }
+	uint8_t		get_priority() { return _subscription.get_priority(); }
 
 	/**
 	 * Set the interval in microseconds
@@ -0,0 +1,223 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file SubscriptionSet.hpp
+ *
+ * A set of subscriptions (typically all instances of a multi-instance topic) that schedules
+ * a WorkItem (or posts a semaphore) only once for any number of publications and reports which
+ * members changed.
+ */
+
+#pragma once
+
+#include <uORB/SubscriptionCallback.hpp>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/sem.h>
+
+namespace uORB
+{
+
+template<uint8_t N>
+class SubscriptionSet
+{
+public:
+	static_assert(N > 0 && N <= 32, "SubscriptionSet supports up to 32 subscriptions");
+
+	/**
+	 * Constructor for all instances 0..N-1 of a topic
+	 *
+	 * @param work_item The WorkItem that will be scheduled on new publications.
+	 * @param meta The uORB metadata (usually from the ORB_ID() macro) for the topic.
+	 */
+	SubscriptionSet(px4::WorkItem *work_item, const orb_metadata *meta) :
+		_work_item(work_item)
+	{
+		for (uint8_t i = 0; i < N; i++) {
+			_members[i].configure(this, i, meta, i);
+		}
+	}
+
+	/**
+	 * Constructor without topics, use set_member() to configure the members.
+	 *
+	 * @param work_item The WorkItem that will be scheduled on new publications (nullptr for none).
+	 */
+	explicit SubscriptionSet(px4::WorkItem *work_item) : _work_item(work_item) {}
+
+	/**
+	 * Constructor for a task without a WorkItem, use set_member() to configure the members.
+	 * The semaphore is posted instead of scheduling a WorkItem, which is safe from any publisher context.
+	 *
+	 * @param sem The semaphore the task waits on.
+	 */
+	explicit SubscriptionSet(px4_sem_t *sem) : _sem(sem) {}
+
+	~SubscriptionSet() { unregisterCallbacks(); }
+
+	// no copy, assignment, move, move assignment
+	SubscriptionSet(const SubscriptionSet &) = delete;
+	SubscriptionSet &operator=(const SubscriptionSet &) = delete;
+	SubscriptionSet(SubscriptionSet &&) = delete;
+	SubscriptionSet &operator=(SubscriptionSet &&) = delete;
+
+	/**
+	 * Configure a member of the set (must not be registered yet).
+	 * @param index The index of the member (bit in the updated mask).
+	 * @param meta The uORB metadata (usually from the ORB_ID() macro) for the topic.
+	 * @param instance The instance for multi sub.
+	 */
+	void set_member(uint8_t index, const orb_metadata *meta, uint8_t instance = 0)
+	{
+		if (index < N) {
+			_members[index].configure(this, index, meta, instance);
+
+			// report as updated, so that data published before is picked up
+			_updated.fetch_or(1u << index);
+		}
+	}
+
+	/**
+	 * Set the members that wake up (schedule the WorkItem or post the semaphore), all by default.
+	 * Publications of the other members are only reported by updated_mask().
+	 */
+	void set_wakeup_mask(uint32_t mask) { _wakeup_mask.store(mask); }
+
+	/**
+	 * Register the callback of each member. This creates the topic instances if needed.
+	 * @return true if all members are registered
+	 */
+	bool registerCallbacks()
+	{
+		bool all_registered = true;
+
+		for (auto &member : _members) {
+			if ((member.get_topic() != nullptr) && !member.registered() && !member.registerCallback()) {
+				all_registered = false;
+			}
+		}
+
+		return all_registered;
+	}
+
+	void unregisterCallbacks()
+	{
+		for (auto &member : _members) {
+			member.unregisterCallback();
+		}
+	}
+
+	/**
+	 * Get and clear the members that were published since the last call.
+	 * Call this at the beginning of the WorkItem's Run().
+	 * @return bitmask, bit i is set if member i was updated
+	 */
+	uint32_t updated_mask() { return _updated.fetch_and(0); }
+
+	/**
+	 * Copy the data of a member, see Subscription::copy()
+	 */
+	bool copy(uint8_t index, void *dst) { return (index < N) ? _members[index].copy(dst) : false; }
+
+	/**
+	 * Copy the data of a member if updated, see Subscription::update()
+	 */
+	bool update(uint8_t index, void *dst) { return (index < N) ? _members[index].update(dst) : false; }
+
+	bool advertised(uint8_t index) { return (index < N) ? _members[index].advertised() : false; }
+
+	/**
+	 * @return true if the member is configured and its callback registered
+	 */
+	bool registered(uint8_t index) const { return (index < N) ? _members[index].registered() : false; }
+
+	const orb_metadata *get_topic(uint8_t index) const { return (index < N) ? _members[index].get_topic() : nullptr; }
+
+	/**
+	 * Priority of the publisher of a member, 0 if not advertised.
+	 */
+	uint8_t get_priority(uint8_t index) { return (index < N) ? _members[index].get_priority() : 0; }
+
+	static constexpr uint8_t size() { return N; }
+
+private:
+
+	class Member : public SubscriptionCallback
+	{
+	public:
+		Member() : SubscriptionCallback(nullptr) {}
+		~Member() override = default;
+
+		void configure(SubscriptionSet *set, uint8_t index, const orb_metadata *meta, uint8_t instance)
+		{
+			unregisterCallback();
+			_set = set;
+			_index = index;
+			_subscription.set_topic(meta, instance);
+		}
+
+		bool registered() const { return _registered; }
+
+		void call() override { _set->notify(_index); }
+
+	private:
+		SubscriptionSet *_set{nullptr};
+		uint8_t _index{0};
+	};
+
+	void notify(uint8_t index)
+	{
+		const uint32_t bit = 1u << index;
+		const uint32_t wakeup_mask = _wakeup_mask.load();
+
+		// only the first waking publication since the last updated_mask() schedules the WorkItem
+		if (((_updated.fetch_or(bit) & wakeup_mask) == 0) && (bit & wakeup_mask)) {
+			if (_work_item != nullptr) {
+				_work_item->ScheduleNow();
+
+			} else if (_sem != nullptr) {
+				px4_sem_post(_sem);
+			}
+		}
+	}
+
+	px4::WorkItem *_work_item{nullptr};
+	px4_sem_t *_sem{nullptr};
+
+	px4::atomic<uint32_t> _updated{0};
+	px4::atomic<uint32_t> _wakeup_mask{UINT32_MAX};
+
+	Member _members[N] {};
+};
+
+} // namespace uORB
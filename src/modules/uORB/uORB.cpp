@@ -40,6 +40,8 @@
 #include "uORBManager.hpp"
 #include "uORBCommon.hpp"
 
+#include <string.h>
+
 orb_advert_t orb_advertise(const struct orb_metadata *meta, const void *data)
 {
 	return uORB::Manager::get_instance()->orb_advertise(meta, data);
@@ -132,3 +134,14 @@ int orb_get_interval(int handle, unsigned *interval)
 {
 	return uORB::Manager::get_instance()->orb_get_interval(handle, interval);
 }
+
+const struct orb_field *orb_find_field(const struct orb_metadata *meta, const char *name)
+{
+	for (uint16_t i = 0; i < meta->o_num_fields; ++i) {
+		if (strcmp(meta->o_field_list[i].name, name) == 0) {
+			return &meta->o_field_list[i];
+		}
+	}
+
+	return nullptr;
+}
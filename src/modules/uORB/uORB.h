@@ -44,6 +44,36 @@
 #include <stdbool.h>
 
 
+/**
+ * Type of a field in the generated field list.
+ */
+enum orb_field_type {
+	ORB_FIELD_TYPE_INT8,
+	ORB_FIELD_TYPE_UINT8,
+	ORB_FIELD_TYPE_INT16,
+	ORB_FIELD_TYPE_UINT16,
+	ORB_FIELD_TYPE_INT32,
+	ORB_FIELD_TYPE_UINT32,
+	ORB_FIELD_TYPE_INT64,
+	ORB_FIELD_TYPE_UINT64,
+	ORB_FIELD_TYPE_FLOAT,
+	ORB_FIELD_TYPE_DOUBLE,
+	ORB_FIELD_TYPE_BOOL,
+	ORB_FIELD_TYPE_CHAR,
+	ORB_FIELD_TYPE_NESTED
+};
+
+/**
+ * Field descriptor, generated together with the message struct.
+ */
+struct orb_field {
+	const char *name;		/**< field name */
+	const char *nested_type;	/**< message name of a nested type, NULL for all other types */
+	uint16_t offset;		/**< offset within the struct */
+	uint16_t array_size;		/**< number of array elements, 0 if the field is not an array */
+	uint8_t type;			/**< enum orb_field_type */
+};
+
 /**
  * Object metadata.
  */
@@ -52,8 +82,16 @@ struct orb_metadata {
 	const uint16_t o_size;		/**< object size */
 	const uint16_t o_size_no_padding;	/**< object size w/o padding at the end (for logger) */
 	const char *o_fields;		/**< semicolon separated list of fields (with type) */
+	const struct orb_field *o_field_list;	/**< fields in struct order without padding (NULL if not generated) */
+	const uint16_t o_num_fields;	/**< number of entries in o_field_list */
+	const uint16_t o_id;		/**< topic ID: index in orb_get_topics(), ORB_TOPIC_ID_INVALID if not generated */
 };
 
+/**
+ * Topic ID of topics that are not generated from a .msg file (e.g. defined with ORB_DEFINE in tests)
+ */
+#define ORB_TOPIC_ID_INVALID	0xffff
+
 typedef const struct orb_metadata *orb_id_t;
 
 /**
@@ -116,7 +154,28 @@ enum ORB_PRIO {
 		#_name,					\
 		sizeof(_struct),		\
 		_size_no_padding,			\
-		_fields					\
+		_fields,				\
+		NULL,					\
+		0,					\
+		ORB_TOPIC_ID_INVALID			\
+	}; struct hack
+
+/**
+ * Define (instantiate) the uORB metadata for a topic, including the field descriptors.
+ *
+ * @see ORB_DEFINE
+ * @param _field_list	Array of struct orb_field describing the fields of _struct
+ * @param _orb_id	Topic ID, the index of the topic in orb_get_topics()
+ */
+#define ORB_DEFINE_WITH_FIELD_LIST(_name, _struct, _size_no_padding, _fields, _field_list, _orb_id)	\
+	const struct orb_metadata __orb_##_name = {	\
+		#_name,					\
+		sizeof(_struct),		\
+		_size_no_padding,			\
+		_fields,				\
+		_field_list,				\
+		sizeof(_field_list) / sizeof(_field_list[0]),	\
+		_orb_id					\
 	}; struct hack
 
 __BEGIN_DECLS
@@ -250,6 +309,15 @@ extern int	orb_set_interval(int handle, unsigned interval) __EXPORT;
  */
 extern int	orb_get_interval(int handle, unsigned *interval) __EXPORT;
 
+/**
+ * Find a field of a topic by name in the generated field list.
+ *
+ * @param meta    ORB topic metadata.
+ * @param name    Field name, e.g. "timestamp".
+ * @return    The field descriptor, or NULL if the field does not exist.
+ */
+extern const struct orb_field *orb_find_field(const struct orb_metadata *meta, const char *name) __EXPORT;
+
 __END_DECLS
 
 /* Diverse uORB header defines */ //XXX: move to better location
@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBArena.hpp"
+
+#include <px4_platform_common/log.h>
+
+namespace uORB
+{
+
+Arena::~Arena()
+{
+	delete[] _memory;
+}
+
+bool Arena::init(size_t size)
+{
+	if (_memory != nullptr || size == 0) {
+		return true;
+	}
+
+	_memory = new uint8_t[size] {};
+
+	if (_memory == nullptr) {
+		PX4_ERR("arena alloc failed (%zu bytes)", size);
+		return false;
+	}
+
+	_size = size;
+	return true;
+}
+
+uint8_t *Arena::allocate(size_t size)
+{
+	const size_t aligned_size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	size_t used = _used.load();
+
+	while (used + aligned_size <= _size) {
+		if (_used.compare_exchange(&used, used + aligned_size)) {
+			_num_buffers.fetch_add(1);
+			// never handed out before: still zero from init()
+			return _memory + used;
+		}
+	}
+
+	uint8_t *buffer = new uint8_t[size] {};
+
+	if (buffer != nullptr) {
+		_heap_used.fetch_add(size);
+		_num_heap_buffers.fetch_add(1);
+	}
+
+	return buffer;
+}
+
+void Arena::free(uint8_t *buffer)
+{
+	if (buffer != nullptr && !contains(buffer)) {
+		delete[] buffer;
+	}
+}
+
+void Arena::print_status() const
+{
+	if (_size > 0) {
+		PX4_INFO("arena: %zu of %zu bytes used (%u buffers), heap: %zu bytes (%u buffers)",
+			 _used.load(), _size, (unsigned)_num_buffers.load(), _heap_used.load(), (unsigned)_num_heap_buffers.load());
+
+	} else {
+		PX4_INFO("arena: disabled, heap: %zu bytes (%u buffers)", _heap_used.load(), (unsigned)_num_heap_buffers.load());
+	}
+}
+
+} // namespace uORB
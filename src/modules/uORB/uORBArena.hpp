@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBArena.hpp
+ *
+ * Memory for the message buffers of all topics. A single block is allocated when uORB starts
+ * (BOARD_UORB_ARENA_SIZE), buffers are taken from it in order and never returned, as nodes live
+ * until uORB is stopped. This keeps the buffers out of the heap (no fragmentation) and makes the
+ * first publication of a topic cheap. Once the arena is full (or if the board does not configure it),
+ * buffers are allocated from the heap.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/px4_config.h>
+
+#ifndef BOARD_UORB_ARENA_SIZE
+#define BOARD_UORB_ARENA_SIZE 0 ///< arena size in bytes, boards can set it in board_config.h (see `uorb status`)
+#endif
+
+namespace uORB
+{
+
+class Arena
+{
+public:
+	Arena() = default;
+	~Arena();
+
+	Arena(const Arena &) = delete;
+	Arena &operator=(const Arena &) = delete;
+
+	/**
+	 * Allocate the arena memory, only the first call has an effect.
+	 * @param size arena size in bytes (0 to only use the heap)
+	 * @return true on success
+	 */
+	bool init(size_t size);
+
+	/**
+	 * Get a zero-initialized buffer, from the arena if there is enough space left, from the heap otherwise.
+	 * Thread-safe.
+	 * @return buffer or nullptr if out of memory
+	 */
+	uint8_t *allocate(size_t size);
+
+	/**
+	 * Release a buffer: heap buffers are freed, arena buffers are only returned with the arena itself.
+	 */
+	void free(uint8_t *buffer);
+
+	void print_status() const;
+
+private:
+	static constexpr size_t ALIGNMENT = 8;
+
+	bool contains(const uint8_t *buffer) const { return buffer >= _memory && buffer < _memory + _size; }
+
+	uint8_t *_memory{nullptr};
+	size_t _size{0};
+	px4::atomic<size_t> _used{0};			///< bytes taken from the arena
+	px4::atomic<uint32_t> _num_buffers{0};		///< buffers taken from the arena
+	px4::atomic<size_t> _heap_used{0};		///< bytes of buffers allocated from the heap
+	px4::atomic<uint32_t> _num_heap_buffers{0};	///< buffers allocated from the heap
+};
+
+} // namespace uORB
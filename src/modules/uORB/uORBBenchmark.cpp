@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * Benchmarks of publishing and copying uORB topics
+ * Run with make benchmarks
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <uORB/Publication.hpp>
+#include <uORB/Subscription.hpp>
+#include <uORB/topics/sensor_gyro.h>
+#include <uORB/topics/vehicle_local_position.h>
+#include <uORB/topics/vehicle_status.h>
+
+template<typename T>
+static void uORB_publish(benchmark::State &state, const orb_metadata *meta)
+{
+	uORB::Publication<T> pub{meta};
+	T data{};
+
+	for (auto _ : state) {
+		data.timestamp++;
+		pub.publish(data);
+	}
+
+	state.SetBytesProcessed(state.iterations() * sizeof(T));
+}
+BENCHMARK_CAPTURE(uORB_publish<sensor_gyro_s>, sensor_gyro, ORB_ID(sensor_gyro));
+BENCHMARK_CAPTURE(uORB_publish<vehicle_local_position_s>, vehicle_local_position, ORB_ID(vehicle_local_position));
+BENCHMARK_CAPTURE(uORB_publish<vehicle_status_s>, vehicle_status, ORB_ID(vehicle_status));
+
+template<typename T>
+static void uORB_copy(benchmark::State &state, const orb_metadata *meta)
+{
+	uORB::Publication<T> pub{meta};
+	T data{};
+	pub.publish(data);
+
+	uORB::Subscription sub{meta};
+
+	for (auto _ : state) {
+		sub.copy(&data);
+		benchmark::DoNotOptimize(data);
+	}
+
+	state.SetBytesProcessed(state.iterations() * sizeof(T));
+}
+BENCHMARK_CAPTURE(uORB_copy<sensor_gyro_s>, sensor_gyro, ORB_ID(sensor_gyro));
+BENCHMARK_CAPTURE(uORB_copy<vehicle_local_position_s>, vehicle_local_position, ORB_ID(vehicle_local_position));
+BENCHMARK_CAPTURE(uORB_copy<vehicle_status_s>, vehicle_status, ORB_ID(vehicle_status));
+
+/**
+ * Publication followed by update(), the path of a subscriber running at the publication rate
+ */
+static void uORB_publish_update(benchmark::State &state)
+{
+	uORB::Publication<sensor_gyro_s> pub{ORB_ID(sensor_gyro)};
+	uORB::Subscription sub{ORB_ID(sensor_gyro)};
+	sensor_gyro_s data{};
+
+	for (auto _ : state) {
+		data.timestamp++;
+		pub.publish(data);
+		benchmark::DoNotOptimize(sub.update(&data));
+	}
+}
+BENCHMARK(uORB_publish_update);
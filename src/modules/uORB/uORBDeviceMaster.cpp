@@ -34,6 +34,7 @@
 #include "uORBDeviceMaster.hpp"
 #include "uORBDeviceNode.hpp"
 #include "uORBManager.hpp"
+#include "uORBTopics.h"
 #include "uORBUtils.hpp"
 
 #ifdef ORB_COMMUNICATOR
@@ -51,10 +52,19 @@ uORB::DeviceMaster::DeviceMaster()
 {
 	px4_sem_init(&_lock, 0, 1);
 	_last_statistics_output = hrt_absolute_time();
+
+	_arena.init(BOARD_UORB_ARENA_SIZE);
+
+	_node_table = new px4::atomic<uORB::DeviceNode *>[orb_topics_count()];
+
+	if (_node_table) {
+		_node_table_size = orb_topics_count();
+	}
 }
 
 uORB::DeviceMaster::~DeviceMaster()
 {
+	delete[] _node_table;
 	px4_sem_destroy(&_lock);
 }
 
@@ -107,7 +117,7 @@ uORB::DeviceMaster::advertise(const struct orb_metadata *meta, bool is_advertise
 		}
 
 		/* construct the new node, passing the ownership of path to it */
-		uORB::DeviceNode *node = new uORB::DeviceNode(meta, group_tries, devpath, priority);
+		uORB::DeviceNode *node = new uORB::DeviceNode(meta, group_tries, devpath, priority, _arena);
 
 		/* if we didn't get a device, that's bad, free the path too */
 		if (node == nullptr) {
@@ -161,8 +171,12 @@ uORB::DeviceMaster::advertise(const struct orb_metadata *meta, bool is_advertise
 				node->mark_as_advertised();
 			}
 
+			if (_latency_stats_enabled) {
+				node->enable_latency_stats();
+			}
+
 			// add to the node map.
-			_node_list.add(node);
+			addDeviceNodeLocked(node);
 		}
 
 		group_tries++;
@@ -182,6 +196,8 @@ void uORB::DeviceMaster::printStatistics(bool reset)
 	PX4_INFO("Statistics, since last output (%i ms):", (int)((current_time - _last_statistics_output) / 1000));
 	_last_statistics_output = current_time;
 
+	_arena.print_status();
+
 	PX4_INFO("TOPIC, NR LOST MSGS");
 	bool had_print = false;
 
@@ -280,6 +296,7 @@ int uORB::DeviceMaster::addNewDeviceNodes(DeviceNodeStatisticsData **first_node,
 
 		last_node->last_lost_msg_count = last_node->node->lost_message_count();
 		last_node->last_pub_msg_count = last_node->node->published_message_count();
+		last_node->last_copy_retry_count = last_node->node->copy_retry_count();
 	}
 
 	return 0;
@@ -291,24 +308,37 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 {
 	bool print_active_only = true;
 	bool only_once = false; // if true, run only once, then exit
+	bool show_latency = false;
+	bool show_totals = false; // if true, print message counts since boot instead of rates
 
 	if (topic_filter && num_filters > 0) {
-		bool show_all = false;
+		int num_topic_filters = 0;
 
 		for (int i = 0; i < num_filters; ++i) {
 			if (!strcmp("-a", topic_filter[i])) {
-				show_all = true;
+				print_active_only = false;
 
 			} else if (!strcmp("-1", topic_filter[i])) {
 				only_once = true;
+
+			} else if (!strcmp("-l", topic_filter[i])) {
+				show_latency = true;
+
+			} else if (!strcmp("-c", topic_filter[i])) {
+				show_totals = true;
+
+			} else {
+				// print non-active if some filter given
+				topic_filter[num_topic_filters++] = topic_filter[i];
+				print_active_only = false;
 			}
 		}
 
-		print_active_only = only_once ? (num_filters == 1) : false; // print non-active if -a or some filter given
+		num_filters = num_topic_filters;
+	}
 
-		if (show_all || print_active_only) {
-			num_filters = 0;
-		}
+	if (show_latency) {
+		enableLatencyStats();
 	}
 
 	PX4_INFO_RAW("\033[2J\n"); //clear screen
@@ -382,10 +412,13 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 			while (cur_node) {
 				uint32_t num_lost = cur_node->node->lost_message_count();
 				unsigned int num_msgs = cur_node->node->published_message_count();
+				uint32_t num_retries = cur_node->node->copy_retry_count();
 				cur_node->pub_msg_delta = (num_msgs - cur_node->last_pub_msg_count) / dt;
 				cur_node->lost_msg_delta = (num_lost - cur_node->last_lost_msg_count) / dt;
+				cur_node->copy_retry_delta = (num_retries - cur_node->last_copy_retry_count) / dt;
 				cur_node->last_lost_msg_count = num_lost;
 				cur_node->last_pub_msg_count = num_msgs;
+				cur_node->last_copy_retry_count = num_retries;
 				cur_node = cur_node->next;
 			}
 
@@ -394,16 +427,44 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 
 			PX4_INFO_RAW("\033[H"); // move cursor home and clear screen
 			PX4_INFO_RAW(CLEAR_LINE "update: 1s, num topics: %i\n", num_topics);
-			PX4_INFO_RAW(CLEAR_LINE "%-*s INST #SUB #MSG #LOST #QSIZE\n", (int)max_topic_name_length - 2, "TOPIC NAME");
+			if (show_latency) {
+				PX4_INFO_RAW(CLEAR_LINE "%-*s INST #SUB #MSG #LOST #QSIZE #RETRY LAT50 LAT99 LATMAX LAG99 CSMAX\n",
+					     (int)max_topic_name_length - 2, "TOPIC NAME");
+
+			} else {
+				PX4_INFO_RAW(CLEAR_LINE "%-*s INST #SUB #MSG #LOST #QSIZE #RETRY\n", (int)max_topic_name_length - 2, "TOPIC NAME");
+			}
+
 			cur_node = first_node;
 
 			while (cur_node) {
 
 				if (!print_active_only || cur_node->pub_msg_delta > 0) {
-					PX4_INFO_RAW(CLEAR_LINE "%-*s %2i %4i %4i %5i %i\n", (int)max_topic_name_length,
+					const unsigned num_msgs = show_totals ? cur_node->last_pub_msg_count : cur_node->pub_msg_delta;
+					const int num_lost = show_totals ? (int)cur_node->last_lost_msg_count : (int)cur_node->lost_msg_delta;
+					const int num_retries = show_totals ? (int)cur_node->last_copy_retry_count : (int)cur_node->copy_retry_delta;
+
+					PX4_INFO_RAW(CLEAR_LINE "%-*s %2i %4i %4u %5i %6i %6i", (int)max_topic_name_length,
 						     cur_node->node->get_meta()->o_name, (int)cur_node->node->get_instance(),
-						     (int)cur_node->node->subscriber_count(), cur_node->pub_msg_delta,
-						     (int)cur_node->lost_msg_delta, cur_node->node->get_queue_size());
+						     (int)cur_node->node->subscriber_count(), num_msgs,
+						     num_lost, cur_node->node->get_queue_size(), num_retries);
+
+					const DeviceNode::LatencyStats *stats = cur_node->node->latency_stats();
+
+					if (show_latency && stats && stats->copy_count > 0) {
+						// upper bounds of the histogram buckets
+						const int latency50 = histogramPercentileBucket(stats->latency_histogram,
+								      DeviceNode::LatencyStats::LATENCY_BUCKETS, stats->copy_count, 50);
+						const int latency99 = histogramPercentileBucket(stats->latency_histogram,
+								      DeviceNode::LatencyStats::LATENCY_BUCKETS, stats->copy_count, 99);
+						const int lag99 = histogramPercentileBucket(stats->lag_histogram,
+								  DeviceNode::LatencyStats::LAG_BUCKETS, stats->copy_count, 99);
+
+						PX4_INFO_RAW(" %5u %5u %6u %5u %5u", 2u << latency50, 2u << latency99, (unsigned)stats->latency_max_us,
+							     (1u << lag99) - 1, (unsigned)stats->critical_section_max_us);
+					}
+
+					PX4_INFO_RAW("\n");
 				}
 
 				cur_node = cur_node->next;
@@ -436,6 +497,173 @@ void uORB::DeviceMaster::showTop(char **topic_filter, int num_filters)
 
 #undef CLEAR_LINE
 
+int uORB::DeviceMaster::histogramPercentileBucket(const uint32_t *histogram, int num_buckets, uint32_t total,
+		int percentile)
+{
+	const uint64_t limit = ((uint64_t)total * percentile + 99) / 100;
+	uint64_t sum = 0;
+
+	for (int i = 0; i < num_buckets; ++i) {
+		sum += histogram[i];
+
+		if (sum >= limit) {
+			return i;
+		}
+	}
+
+	return num_buckets - 1;
+}
+
+void uORB::DeviceMaster::enableLatencyStats()
+{
+	lock();
+
+	_latency_stats_enabled = true;
+
+	for (uORB::DeviceNode *node : _node_list) {
+		node->enable_latency_stats();
+	}
+
+	unlock();
+}
+
+uint8_t uORB::DeviceMaster::moduleId(const char *name)
+{
+	if (name == nullptr || name[0] == '\0') {
+		return 0;
+	}
+
+	lock();
+
+	const int num_modules = _num_modules.load();
+
+	for (int i = 0; i < num_modules; ++i) {
+		if (strncmp(_module_names[i], name, MODULE_NAME_LENGTH - 1) == 0) {
+			unlock();
+			return i + 1;
+		}
+	}
+
+	uint8_t id = 0;
+
+	if (num_modules < MAX_MODULES) {
+		strncpy(_module_names[num_modules], name, MODULE_NAME_LENGTH - 1);
+		_num_modules.store(num_modules + 1);
+		id = num_modules + 1;
+	}
+
+	unlock();
+
+	return id;
+}
+
+const char *uORB::DeviceMaster::moduleName(uint8_t id) const
+{
+	if (id == 0 || id > _num_modules.load()) {
+		return nullptr;
+	}
+
+	return _module_names[id - 1];
+}
+
+int uORB::DeviceMaster::printModules(const uint8_t *ids, int num_ids) const
+{
+	int num_printed = 0;
+
+	for (int i = 0; i < num_ids; ++i) {
+		const char *name = moduleName(ids[i]);
+
+		if (name != nullptr) {
+			PX4_INFO_RAW("%s%s", num_printed > 0 ? ", " : "", name);
+			++num_printed;
+		}
+	}
+
+	if (num_printed == 0) {
+		PX4_INFO_RAW("-");
+	}
+
+	return num_printed;
+}
+
+void uORB::DeviceMaster::showGraph(char **topics, int num_topics)
+{
+	static constexpr hrt_abstime COLLECT_DURATION = 2000000; // us
+
+	// the control loop, from the gyro sample to the actuator outputs
+	static const char *const control_loop[] = {
+		"sensor_gyro",
+		"vehicle_angular_velocity",
+		"actuator_controls_0",
+		"actuator_outputs",
+	};
+
+	if (topics == nullptr || num_topics <= 0) {
+		topics = (char **)control_loop;
+		num_topics = sizeof(control_loop) / sizeof(control_loop[0]);
+	}
+
+	if (!_latency_stats_enabled) {
+		enableLatencyStats();
+		PX4_INFO("collecting statistics for %i s", (int)(COLLECT_DURATION / 1000000));
+		px4_usleep(COLLECT_DURATION);
+	}
+
+	// a DeviceNode is never deleted, so the nodes can be accessed without holding the lock
+	PX4_INFO_RAW("TOPIC: PUBLISHERS -> SUBSCRIBERS\n");
+
+	for (DeviceNode *node = nextDeviceNode(nullptr); node != nullptr; node = nextDeviceNode(node)) {
+		if (node->published_message_count() == 0 && node->subscriber_count() == 0) {
+			continue;
+		}
+
+		PX4_INFO_RAW("%s %i: ", node->get_name(), (int)node->get_instance());
+		printModules(node->publisher_ids(), DeviceNode::MAX_PUBLISHERS);
+		PX4_INFO_RAW(" -> ");
+		printModules(node->subscriber_ids(), DeviceNode::MAX_SUBSCRIBERS);
+		PX4_INFO_RAW("\n");
+	}
+
+	PX4_INFO_RAW("\nCritical path (age of timestamp_sample at publication, us):\n");
+	PX4_INFO_RAW("%-28s %-16s %8s %8s %8s\n", "TOPIC", "PUBLISHER", "MEAN", "MAX", "STAGE");
+
+	uint32_t previous_mean = 0;
+
+	for (int i = 0; i < num_topics; ++i) {
+		DeviceNode *node = nextDeviceNode(nullptr);
+
+		while (node != nullptr && (strcmp(node->get_name(), topics[i]) != 0 || node->get_instance() != 0)) {
+			node = nextDeviceNode(node);
+		}
+
+		const DeviceNode::LatencyStats *stats = (node != nullptr) ? node->latency_stats() : nullptr;
+
+		if (node == nullptr || !node->has_timestamp_sample() || stats == nullptr || stats->sample_age_count == 0) {
+			PX4_INFO_RAW("%-28s %s\n", topics[i], (node == nullptr) ? "(not advertised)" :
+				     node->has_timestamp_sample() ? "(no samples)" : "(no timestamp_sample)");
+			continue;
+		}
+
+		const char *publisher = moduleName(node->publisher_ids()[0]);
+		const uint32_t mean = stats->sample_age_total_us / stats->sample_age_count;
+
+		// the stage latency is the time the sample spent between the previous topic and this one
+		PX4_INFO_RAW("%-28s %-16s %8u %8u %8i\n", topics[i], publisher ? publisher : "-", (unsigned)mean,
+			     (unsigned)stats->sample_age_max_us, (int)(mean - previous_mean));
+
+		previous_mean = mean;
+	}
+}
+
+uORB::DeviceNode *uORB::DeviceMaster::nextDeviceNode(uORB::DeviceNode *node)
+{
+	lock();
+	uORB::DeviceNode *next = (node == nullptr) ? _node_list.getHead() : node->getSibling();
+	unlock();
+
+	return next;
+}
+
 uORB::DeviceNode *uORB::DeviceMaster::getDeviceNode(const char *nodepath)
 {
 	lock();
@@ -458,19 +686,63 @@ uORB::DeviceNode *uORB::DeviceMaster::getDeviceNode(const struct orb_metadata *m
 		return nullptr;
 	}
 
+	//We can safely return the node that can be used by any thread, because
+	//a DeviceNode never gets deleted.
+	if (nodeTableEntry(meta) != nullptr) {
+		// no locking needed: nodes are added to the table once fully initialized
+		return getDeviceNodeLocked(meta, instance);
+	}
+
 	lock();
 	uORB::DeviceNode *node = getDeviceNodeLocked(meta, instance);
 	unlock();
 
-	//We can safely return the node that can be used by any thread, because
-	//a DeviceNode never gets deleted.
 	return node;
 }
 
+px4::atomic<uORB::DeviceNode *> *uORB::DeviceMaster::nodeTableEntry(const struct orb_metadata *meta) const
+{
+	// topics defined outside of the generated list (ORB_DEFINE) have no table entry
+	if (meta->o_id < _node_table_size && orb_get_topics()[meta->o_id] == meta) {
+		return &_node_table[meta->o_id];
+	}
+
+	return nullptr;
+}
+
+void uORB::DeviceMaster::addDeviceNodeLocked(uORB::DeviceNode *node)
+{
+	_node_list.add(node);
+
+	px4::atomic<uORB::DeviceNode *> *entry = nodeTableEntry(node->get_meta());
+
+	if (entry != nullptr) {
+		// link before publishing, so that lock-free readers only ever see complete lists
+		node->set_next_topic_node(entry->load());
+		entry->store(node);
+	}
+}
+
 uORB::DeviceNode *uORB::DeviceMaster::getDeviceNodeLocked(const struct orb_metadata *meta, const uint8_t instance)
 {
+	// only the nodes of the namespace of the calling thread are visible
+	const uint8_t ns = px4::get_namespace();
+
+	px4::atomic<uORB::DeviceNode *> *entry = nodeTableEntry(meta);
+
+	if (entry != nullptr) {
+		for (uORB::DeviceNode *node = entry->load(); node != nullptr; node = node->next_topic_node()) {
+			if ((node->get_instance() == instance) && (node->get_namespace() == ns)) {
+				return node;
+			}
+		}
+
+		return nullptr;
+	}
+
 	for (uORB::DeviceNode *node : _node_list) {
-		if ((strcmp(node->get_name(), meta->o_name) == 0) && (node->get_instance() == instance)) {
+		if ((strcmp(node->get_name(), meta->o_name) == 0) && (node->get_instance() == instance)
+		    && (node->get_namespace() == ns)) {
 			return node;
 		}
 	}
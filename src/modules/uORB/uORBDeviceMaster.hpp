@@ -48,7 +48,10 @@ class Manager;
 #include <string.h>
 #include <stdlib.h>
 
+#include "uORBArena.hpp"
+
 #include <containers/List.hpp>
+#include <px4_platform_common/atomic.h>
 
 /**
  * Master control device for ObjDev.
@@ -67,6 +70,13 @@ public:
 	 * @return node if exists, nullptr otherwise
 	 */
 	uORB::DeviceNode *getDeviceNode(const char *node_name);
+
+	/**
+	 * Find the node of a topic instance in the namespace of the calling thread.
+	 * Generated topics are looked up in the node table without locking, in constant time
+	 * (only the nodes of the same topic are compared).
+	 * @return node if exists, nullptr otherwise
+	 */
 	uORB::DeviceNode *getDeviceNode(const struct orb_metadata *meta, const uint8_t instance);
 
 	/**
@@ -84,6 +94,42 @@ public:
 	 */
 	void showTop(char **topic_filter, int num_filters);
 
+	/**
+	 * Enable latency statistics for all existing and future topics.
+	 */
+	void enableLatencyStats();
+
+	bool latencyStatsEnabled() const { return _latency_stats_enabled; }
+
+	/**
+	 * Print the runtime topic graph (publishers and subscribers of each topic) and the
+	 * latency along a chain of topics, based on the age of their timestamp_sample at publication.
+	 * Enables the latency statistics and collects them for a while if they were not enabled yet.
+	 * @param topics chain of topics (first instance each), the control loop if none given
+	 * @param num_topics
+	 */
+	void showGraph(char **topics, int num_topics);
+
+	/**
+	 * Get the ID of a module (task, thread or work item name) for the topic graph, adding it if needed.
+	 * @return the ID, 0 if the name is null or the table is full
+	 */
+	uint8_t moduleId(const char *name);
+
+	/**
+	 * Get the name of a module ID returned by moduleId(), nullptr if invalid.
+	 */
+	const char *moduleName(uint8_t id) const;
+
+	const uORB::Arena &arena() const { return _arena; }
+
+	/**
+	 * Iterate over all nodes.
+	 * @param node the previous node, nullptr to get the first node
+	 * @return the next node, nullptr at the end of the list
+	 */
+	uORB::DeviceNode *nextDeviceNode(uORB::DeviceNode *node);
+
 private:
 	// Private constructor, uORB::Manager takes care of its creation
 	DeviceMaster();
@@ -93,27 +139,69 @@ private:
 		DeviceNode *node;
 		uint32_t last_lost_msg_count;
 		unsigned int last_pub_msg_count;
+		uint32_t last_copy_retry_count;
 		uint32_t lost_msg_delta;
 		unsigned int pub_msg_delta;
+		uint32_t copy_retry_delta;
 		DeviceNodeStatisticsData *next = nullptr;
 	};
 
 	int addNewDeviceNodes(DeviceNodeStatisticsData **first_node, int &num_topics, size_t &max_topic_name_length,
 			      char **topic_filter, int num_filters);
 
+	/**
+	 * Get the histogram bucket at which the given percentile of entries is reached.
+	 */
+	static int histogramPercentileBucket(const uint32_t *histogram, int num_buckets, uint32_t total, int percentile);
+
+	/**
+	 * Print a comma separated list of module names.
+	 * @return number of printed names
+	 */
+	int printModules(const uint8_t *ids, int num_ids) const;
+
 	friend class uORB::Manager;
 
 	/**
-	 * Find a node give its name.
-	 * _lock must already be held when calling this.
+	 * Find a node given its metadata and instance.
+	 * _lock must already be held when calling this, unless the topic has a node table entry.
 	 * @return node if exists, nullptr otherwise
 	 */
 	uORB::DeviceNode *getDeviceNodeLocked(const struct orb_metadata *meta, const uint8_t instance);
 
+	/**
+	 * Add a new node to the list and the node table.
+	 * _lock must already be held when calling this.
+	 */
+	void addDeviceNodeLocked(uORB::DeviceNode *node);
+
+	/**
+	 * Entry of the node table for a topic, nullptr if the topic has no generated ID.
+	 */
+	px4::atomic<uORB::DeviceNode *> *nodeTableEntry(const struct orb_metadata *meta) const;
+
+	uORB::Arena _arena; /**< message buffers of all nodes (declared first, it has to outlive them) */
+
 	List<uORB::DeviceNode *> _node_list;
 
+	/**
+	 * Nodes indexed by the topic ID (orb_metadata::o_id), each entry is the head of a list of all
+	 * instances and namespaces of the topic (linked with DeviceNode::next_topic_node()).
+	 * Nodes are only added (under _lock) and never removed, which allows lock-free lookups.
+	 */
+	px4::atomic<uORB::DeviceNode *> *_node_table{nullptr};
+	size_t _node_table_size{0};
+
 	hrt_abstime       _last_statistics_output;
 
+	bool _latency_stats_enabled{false};
+
+	static constexpr int MAX_MODULES = 48;
+	static constexpr int MODULE_NAME_LENGTH = 16;
+
+	char _module_names[MAX_MODULES][MODULE_NAME_LENGTH] {}; /**< modules of the topic graph, entries are never removed */
+	px4::atomic<uint8_t> _num_modules{0};
+
 	px4_sem_t	_lock; /**< lock to protect access to all class members (also for derived classes) */
 
 	void		lock() { do {} while (px4_sem_wait(&_lock) != 0); }
@@ -38,6 +38,9 @@
 
 #include "SubscriptionCallback.hpp"
 
+#include <lib/trace/trace.h>
+#include <px4_platform_common/tasks.h>
+
 #ifdef ORB_COMMUNICATOR
 #include "uORBCommunicator.hpp"
 #endif /* ORB_COMMUNICATOR */
@@ -55,18 +58,25 @@ uORB::DeviceNode::SubscriberData *uORB::DeviceNode::filp_to_sd(cdev::file_t *fil
 }
 
 uORB::DeviceNode::DeviceNode(const struct orb_metadata *meta, const uint8_t instance, const char *path,
-			     uint8_t priority, uint8_t queue_size) :
+			     uint8_t priority, Arena &arena, uint8_t queue_size) :
 	CDev(path),
 	_meta(meta),
 	_instance(instance),
+	_arena(arena),
 	_priority(priority),
 	_queue_size(queue_size)
 {
+	const orb_field *timestamp_sample = orb_find_field(meta, "timestamp_sample");
+
+	if (timestamp_sample != nullptr) {
+		_timestamp_sample_offset = timestamp_sample->offset;
+	}
 }
 
 uORB::DeviceNode::~DeviceNode()
 {
-	delete[] _data;
+	_arena.free(_data);
+	delete _latency_stats;
 
 	CDev::unregister_driver_and_memory();
 }
@@ -81,6 +91,8 @@ uORB::DeviceNode::open(cdev::file_t *filp)
 		mark_as_advertised();
 		unlock();
 
+		add_endpoint(_publisher_ids, MAX_PUBLISHERS, px4_get_taskname());
+
 		/* now complete the open */
 		return CDev::open(filp);
 	}
@@ -138,31 +150,59 @@ uORB::DeviceNode::close(cdev::file_t *filp)
 	return CDev::close(filp);
 }
 
+unsigned
+uORB::DeviceNode::next_read_generation(unsigned &generation, uint32_t &lost_messages) const
+{
+	const unsigned current_generation = _generation.load();
+
+	if (current_generation > generation + _queue_size) {
+		// Reader is too far behind: some messages are lost
+		lost_messages = current_generation - (generation + _queue_size);
+		generation = current_generation - _queue_size;
+
+	} else {
+		lost_messages = 0;
+	}
+
+	if ((current_generation == generation) && (generation > 0)) {
+		/* The subscriber already read the latest message, but nothing new was published yet.
+		 * Return the previous message
+		 */
+		--generation;
+	}
+
+	const unsigned read_generation = generation;
+
+	if (generation < current_generation) {
+		++generation;
+	}
+
+	return read_generation;
+}
+
+void
+uORB::DeviceNode::copy_element(const uint8_t *data, void *dst, unsigned &generation, uint32_t &lost_messages) const
+{
+	const unsigned read_generation = next_read_generation(generation, lost_messages);
+
+	memcpy(dst, data + (_meta->o_size * (read_generation % slot_count())), _meta->o_size);
+}
+
 bool
-uORB::DeviceNode::copy_locked(void *dst, unsigned &generation)
+uORB::DeviceNode::copy_locked(void *dst, unsigned &generation, uint32_t *lost_messages_out)
 {
 	bool updated = false;
 
-	if ((dst != nullptr) && (_data != nullptr)) {
-		unsigned current_generation = _generation.load();
-
-		if (current_generation > generation + _queue_size) {
-			// Reader is too far behind: some messages are lost
-			_lost_messages += current_generation - (generation + _queue_size);
-			generation = current_generation - _queue_size;
-		}
+	if ((dst != nullptr) && (_data != nullptr) && (_generation.load() > 0)) {
+		uint32_t lost_messages = 0;
+		copy_element(_data, dst, generation, lost_messages);
 
-		if ((current_generation == generation) && (generation > 0)) {
-			/* The subscriber already read the latest message, but nothing new was published yet.
-			 * Return the previous message
-			 */
-			--generation;
+		if (lost_messages > 0) {
+			_lost_messages.fetch_add(lost_messages);
 		}
 
-		memcpy(dst, _data + (_meta->o_size * (generation % _queue_size)), _meta->o_size);
-
-		if (generation < current_generation) {
-			++generation;
+		if (lost_messages_out != nullptr) {
+			*lost_messages_out = lost_messages;
 		}
 
 		updated = true;
@@ -172,27 +212,86 @@ uORB::DeviceNode::copy_locked(void *dst, unsigned &generation)
 }
 
 bool
-uORB::DeviceNode::copy(void *dst, unsigned &generation)
+uORB::DeviceNode::copy_seqlock(void *dst, unsigned &generation, hrt_abstime *update_time, uint32_t *lost_messages_out)
 {
+	const uint8_t *data = _data;
+
+	// nothing published yet (the buffer might already be allocated for a loan)
+	if ((dst == nullptr) || (data == nullptr) || (_generation.load() == 0)) {
+		return false;
+	}
+
+	for (unsigned attempt = 0; attempt < MAX_COPY_RETRIES; attempt++) {
+		const unsigned sequence = _sequence.load();
+
+		if ((sequence & 1) == 0) {
+			unsigned copy_generation = generation;
+			uint32_t lost_messages = 0;
+			copy_element(data, dst, copy_generation, lost_messages);
+			const hrt_abstime last_update = _last_update;
+
+			// order the data reads above before re-checking the sequence
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+			if (_sequence.load() == sequence) {
+				// no write happened in the meantime, the copy is consistent
+				if ((_latency_stats != nullptr) && (copy_generation != generation)) {
+					record_latency(hrt_elapsed_time(&last_update), _generation.load() - copy_generation);
+				}
+
+				generation = copy_generation;
+
+				if (lost_messages > 0) {
+					_lost_messages.fetch_add(lost_messages);
+				}
+
+				if (lost_messages_out != nullptr) {
+					*lost_messages_out = lost_messages;
+				}
+
+				if (update_time != nullptr) {
+					*update_time = last_update;
+				}
+
+				return true;
+			}
+		}
+
+		_copy_retries.fetch_add(1);
+	}
+
+	// too much contention, fall back to a copy inside the critical section
 	ATOMIC_ENTER;
 
-	bool updated = copy_locked(dst, generation);
+	bool updated = copy_locked(dst, generation, lost_messages_out);
+
+	if (update_time != nullptr) {
+		*update_time = _last_update;
+	}
 
 	ATOMIC_LEAVE;
 
 	return updated;
 }
 
-uint64_t
-uORB::DeviceNode::copy_and_get_timestamp(void *dst, unsigned &generation)
+bool
+uORB::DeviceNode::copy(void *dst, unsigned &generation)
 {
-	ATOMIC_ENTER;
-
-	const hrt_abstime update_time = _last_update;
-	copy_locked(dst, generation);
+	return copy_seqlock(dst, generation, nullptr);
+}
 
-	ATOMIC_LEAVE;
+bool
+uORB::DeviceNode::copy(void *dst, unsigned &generation, uint32_t &lost_messages)
+{
+	lost_messages = 0;
+	return copy_seqlock(dst, generation, nullptr, &lost_messages);
+}
 
+uint64_t
+uORB::DeviceNode::copy_and_get_timestamp(void *dst, unsigned &generation)
+{
+	hrt_abstime update_time = 0;
+	copy_seqlock(dst, generation, &update_time);
 	return update_time;
 }
 
@@ -200,7 +299,7 @@ ssize_t
 uORB::DeviceNode::read(cdev::file_t *filp, char *buffer, size_t buflen)
 {
 	/* if the object has not been written yet, return zero */
-	if (_data == nullptr) {
+	if ((_data == nullptr) || (_generation.load() == 0)) {
 		return 0;
 	}
 
@@ -212,19 +311,15 @@ uORB::DeviceNode::read(cdev::file_t *filp, char *buffer, size_t buflen)
 	SubscriberData *sd = (SubscriberData *)filp_to_sd(filp);
 
 	/*
-	 * Perform an atomic copy & state update
+	 * Perform a consistent copy & state update
 	 */
-	ATOMIC_ENTER;
-
-	copy_locked(buffer, sd->generation);
+	const hrt_abstime update_time = copy_and_get_timestamp(buffer, sd->generation);
 
 	// if subscriber has an interval track the last update time
 	if (sd->update_interval) {
-		sd->update_interval->last_update = _last_update;
+		sd->update_interval->last_update = update_time;
 	}
 
-	ATOMIC_LEAVE;
-
 	return _meta->o_size;
 }
 
@@ -247,14 +342,7 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 		if (!up_interrupt_context()) {
 #endif /* __PX4_NUTTX */
 
-			lock();
-
-			/* re-check size */
-			if (nullptr == _data) {
-				_data = new uint8_t[_meta->o_size * _queue_size];
-			}
-
-			unlock();
+			allocate_data();
 
 #ifdef __PX4_NUTTX
 		}
@@ -267,33 +355,293 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 		}
 	}
 
+	/* a publisher is filling the next slot in place */
+	if (_loan_active.load()) {
+		return -EBUSY;
+	}
+
 	/* If write size does not match, that is an error */
 	if (_meta->o_size != buflen) {
 		return -EIO;
 	}
 
-	/* Perform an atomic copy. */
+	/* only measured when statistics are enabled (this can run in interrupt context) */
+	LatencyStats *stats = _latency_stats;
+
+	/* Perform an atomic copy. Writers are serialized, readers copy optimistically (see copy_seqlock()). */
 	ATOMIC_ENTER;
+	const hrt_abstime critical_section_start = (stats != nullptr) ? hrt_absolute_time() : 0;
+
+	/* mark the write as in progress (odd sequence) */
+	_sequence.fetch_add(1);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
 	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
 	unsigned generation = _generation.fetch_add(1);
 
-	memcpy(_data + (_meta->o_size * (generation % _queue_size)), buffer, _meta->o_size);
+	memcpy(_data + (_meta->o_size * (generation % slot_count())), buffer, _meta->o_size);
 
 	/* update the timestamp and generation count */
-	_last_update = hrt_absolute_time();
+	const hrt_abstime now = hrt_absolute_time();
+	_last_update = now;
+
+	/* write complete (even sequence) */
+	_sequence.fetch_add(1);
+
+	/* keep the callback list pinned until the callbacks are dispatched */
+	_callback_dispatch_count.fetch_add(1);
+
+	ATOMIC_LEAVE;
+
+	if (stats != nullptr) {
+		const uint32_t critical_section_us = now - critical_section_start;
+
+		if (critical_section_us > stats->critical_section_max_us) {
+			stats->critical_section_max_us = critical_section_us;
+		}
+
+		record_sample_age((const uint8_t *)buffer, now);
+	}
+
+	dispatch_callbacks();
+
+	return _meta->o_size;
+}
+
+void
+uORB::DeviceNode::enable_latency_stats()
+{
+	lock();
+
+	if (_latency_stats == nullptr) {
+		_latency_stats = new LatencyStats{};
+	}
+
+	unlock();
+}
+
+void
+uORB::DeviceNode::record_latency(hrt_abstime latency, unsigned lag)
+{
+	LatencyStats *stats = _latency_stats;
+
+	const uint32_t latency_us = (latency > UINT32_MAX) ? UINT32_MAX : latency;
+
+	// log2 buckets
+	int latency_bucket = (latency_us > 1) ? (31 - __builtin_clz(latency_us)) : 0;
+	int lag_bucket = (lag > 0) ? (32 - __builtin_clz(lag)) : 0;
+
+	if (latency_bucket >= LatencyStats::LATENCY_BUCKETS) {
+		latency_bucket = LatencyStats::LATENCY_BUCKETS - 1;
+	}
+
+	if (lag_bucket >= LatencyStats::LAG_BUCKETS) {
+		lag_bucket = LatencyStats::LAG_BUCKETS - 1;
+	}
+
+	stats->copy_count++;
+	stats->latency_histogram[latency_bucket]++;
+	stats->lag_histogram[lag_bucket]++;
+
+	if (latency_us > stats->latency_max_us) {
+		stats->latency_max_us = latency_us;
+	}
+}
+
+void
+uORB::DeviceNode::record_sample_age(const uint8_t *data, hrt_abstime now)
+{
+	if (_timestamp_sample_offset < 0) {
+		return;
+	}
+
+	uint64_t timestamp_sample;
+	memcpy(&timestamp_sample, data + _timestamp_sample_offset, sizeof(timestamp_sample));
+
+	// not set or from a different time base (e.g. replayed)
+	if ((timestamp_sample == 0) || (timestamp_sample > now)) {
+		return;
+	}
+
+	LatencyStats *stats = _latency_stats;
+
+	const hrt_abstime age = now - timestamp_sample;
+	const uint32_t age_us = (age > UINT32_MAX) ? UINT32_MAX : age;
+
+	stats->sample_age_count++;
+	stats->sample_age_total_us += age_us;
+
+	if (age_us > stats->sample_age_max_us) {
+		stats->sample_age_max_us = age_us;
+	}
+}
+
+void
+uORB::DeviceNode::add_endpoint(uint8_t *ids, int num_ids, const char *module_name)
+{
+	DeviceMaster *device_master = uORB::Manager::get_instance()->get_device_master();
+
+	if ((device_master == nullptr) || (module_name == nullptr)) {
+		return;
+	}
 
+	const uint8_t id = device_master->moduleId(module_name);
+
+	if (id == 0) {
+		return;
+	}
+
+	lock();
+
+	for (int i = 0; i < num_ids; ++i) {
+		if (ids[i] == id) {
+			break;
+		}
+
+		if (ids[i] == 0) {
+			ids[i] = id;
+			break;
+		}
+	}
+
+	unlock();
+}
+
+void
+uORB::DeviceNode::dispatch_callbacks()
+{
+	/* Callbacks are called outside of the critical section, so that the time spent with interrupts
+	 * disabled or the node locked does not grow with the number of callbacks. Concurrent
+	 * register_callback() calls are safe, and unregister_callback() waits until the dispatch completed. */
+	trace_record(TRACE_ORB_PUBLISH, _meta->o_name);
 
-	// callbacks
 	for (auto item : _callbacks) {
 		item->call();
 	}
 
-	ATOMIC_LEAVE;
+	_callback_dispatch_count.fetch_sub(1);
 
 	/* notify any poll waiters */
 	poll_notify(POLLIN);
+}
 
-	return _meta->o_size;
+bool
+uORB::DeviceNode::allocate_data()
+{
+	lock();
+
+	/* re-check size */
+	if (nullptr == _data) {
+		_data = _arena.allocate(_meta->o_size * slot_count());
+	}
+
+	unlock();
+
+	return (_data != nullptr);
+}
+
+bool
+uORB::DeviceNode::enable_loans()
+{
+	lock();
+
+	if (_data == nullptr) {
+		_loans_enabled = true;
+	}
+
+	const bool loans_enabled = _loans_enabled;
+	unlock();
+
+	return loans_enabled;
+}
+
+void *
+uORB::DeviceNode::loan()
+{
+	if (!enable_loans() || !allocate_data()) {
+		return nullptr;
+	}
+
+	bool expected = false;
+
+	if (!_loan_active.compare_exchange(&expected, true)) {
+		// another loan is outstanding
+		return nullptr;
+	}
+
+	/* The slot of the next generation is not readable by any subscriber: it is the spare slot
+	 * behind the oldest element still in the queue. */
+	return _data + (_meta->o_size * (_generation.load() % slot_count()));
+}
+
+bool
+uORB::DeviceNode::publish_loan()
+{
+	if (!_loan_active.load()) {
+		return false;
+	}
+
+	ATOMIC_ENTER;
+
+	/* bump the sequence so that optimistic readers straddling the publication retry */
+	_sequence.fetch_add(1);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	const unsigned generation = _generation.fetch_add(1);
+	const hrt_abstime now = hrt_absolute_time();
+	_last_update = now;
+
+	_sequence.fetch_add(1);
+
+	_loan_active.store(false);
+
+	/* keep the callback list pinned until the callbacks are dispatched */
+	_callback_dispatch_count.fetch_add(1);
+
+	ATOMIC_LEAVE;
+
+	if (_latency_stats != nullptr) {
+		record_sample_age(_data + (_meta->o_size * (generation % slot_count())), now);
+	}
+
+	dispatch_callbacks();
+
+	return true;
+}
+
+const void *
+uORB::DeviceNode::borrow(unsigned &generation, unsigned &borrowed_generation)
+{
+	const uint8_t *data = _data;
+
+	// without the spare slot the latest element gets overwritten in place by the next publication
+	if ((data == nullptr) || !_loans_enabled || (_generation.load() == 0)) {
+		return nullptr;
+	}
+
+	const unsigned sequence = _sequence.load();
+
+	if ((sequence & 1) == 0) {
+		unsigned borrow_generation = generation;
+		uint32_t lost_messages = 0;
+		const unsigned read_generation = next_read_generation(borrow_generation, lost_messages);
+
+		// the generation is only consistent if no write happened in the meantime
+		if (_sequence.load() == sequence) {
+			generation = borrow_generation;
+			borrowed_generation = read_generation;
+
+			if (lost_messages > 0) {
+				_lost_messages.fetch_add(lost_messages);
+			}
+
+			return data + (_meta->o_size * (read_generation % slot_count()));
+		}
+	}
+
+	_copy_retries.fetch_add(1);
+
+	return nullptr;
 }
 
 int
@@ -420,6 +768,17 @@ uORB::DeviceNode::publish(const orb_metadata *meta, orb_advert_t handle, const v
 	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
 
 	if (ch != nullptr) {
+		// rate limit requested by the remote subscriber
+		if (devnode->_remote_send_interval_us > 0) {
+			const hrt_abstime now = hrt_absolute_time();
+
+			if (now < devnode->_remote_last_send + devnode->_remote_send_interval_us) {
+				return PX4_OK;
+			}
+
+			devnode->_remote_last_send = now;
+		}
+
 		if (ch->send_message(meta->o_name, meta->o_size, (uint8_t *)data) != 0) {
 			PX4_ERR("Error Sending [%s] topic data over comm_channel", meta->o_name);
 			return PX4_ERROR;
@@ -530,19 +889,12 @@ uORB::DeviceNode::appears_updated(SubscriberData *sd)
 bool
 uORB::DeviceNode::print_statistics(bool reset)
 {
-	if (!_lost_messages) {
+	if (!_lost_messages.load()) {
 		return false;
 	}
 
-	lock();
 	//This can be wrong: if a reader never reads, _lost_messages will not be increased either
-	uint32_t lost_messages = _lost_messages;
-
-	if (reset) {
-		_lost_messages = 0;
-	}
-
-	unlock();
+	const uint32_t lost_messages = reset ? _lost_messages.fetch_and(0) : _lost_messages.load();
 
 	PX4_INFO("%s: %i", _meta->o_name, lost_messages);
 	return true;
@@ -550,6 +902,8 @@ uORB::DeviceNode::print_statistics(bool reset)
 
 void uORB::DeviceNode::add_internal_subscriber()
 {
+	add_endpoint(_subscriber_ids, MAX_SUBSCRIBERS, px4_get_taskname());
+
 	lock();
 	_subscriber_count++;
 
@@ -558,7 +912,7 @@ void uORB::DeviceNode::add_internal_subscriber()
 
 	if (ch != nullptr && _subscriber_count > 0) {
 		unlock(); //make sure we cannot deadlock if add_subscription calls back into DeviceNode
-		ch->add_subscription(_meta->o_name, 1);
+		ch->add_subscription(_meta->o_name, 0);
 
 	} else
 #endif /* ORB_COMMUNICATOR */
@@ -590,6 +944,9 @@ void uORB::DeviceNode::remove_internal_subscriber()
 #ifdef ORB_COMMUNICATOR
 int16_t uORB::DeviceNode::process_add_subscription(int32_t rateInHz)
 {
+	_remote_send_interval_us = (rateInHz > 0) ? (1000000 / rateInHz) : 0;
+	_remote_last_send = 0;
+
 	// if there is already data in the node, send this out to
 	// the remote entity.
 	// send the data to the remote entity.
@@ -604,6 +961,7 @@ int16_t uORB::DeviceNode::process_add_subscription(int32_t rateInHz)
 
 int16_t uORB::DeviceNode::process_remove_subscription()
 {
+	_remote_send_interval_us = 0;
 	return PX4_OK;
 }
 
@@ -634,12 +992,13 @@ int16_t uORB::DeviceNode::process_received_message(int32_t length, uint8_t *data
 
 int uORB::DeviceNode::update_queue_size(unsigned int queue_size)
 {
-	if (_queue_size == queue_size) {
+	// the queue is never shrunk, a subscriber might have increased it before the first advertiser
+	if (_queue_size >= queue_size) {
 		return PX4_OK;
 	}
 
 	//queue size is limited to 255 for the single reason that we use uint8 to store it
-	if (_data || _queue_size > queue_size || queue_size > 255) {
+	if (_data || queue_size > 255) {
 		return PX4_ERROR;
 	}
 
@@ -651,6 +1010,9 @@ bool
 uORB::DeviceNode::register_callback(uORB::SubscriptionCallback *callback_sub)
 {
 	if (callback_sub != nullptr) {
+		// work queue callbacks are shown with the name of the work item, not the one of the work queue thread
+		add_endpoint(_subscriber_ids, MAX_SUBSCRIBERS, callback_sub->name());
+
 		ATOMIC_ENTER;
 
 		// prevent duplicate registrations
@@ -673,6 +1035,16 @@ void
 uORB::DeviceNode::unregister_callback(uORB::SubscriptionCallback *callback_sub)
 {
 	ATOMIC_ENTER;
-	_callbacks.remove(callback_sub);
+	const bool removed = _callbacks.remove(callback_sub);
 	ATOMIC_LEAVE;
+
+	if (removed) {
+		// publishers might still be dispatching to the callback outside of the critical section
+		while (_callback_dispatch_count.load() > 0) {
+			px4_usleep(100);
+		}
+
+		// detach from the list, so that the callback can be registered again
+		callback_sub->setSibling(nullptr);
+	}
 }
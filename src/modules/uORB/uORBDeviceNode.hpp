@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include "uORBArena.hpp"
 #include "uORBCommon.hpp"
 #include "uORBDeviceMaster.hpp"
 
@@ -40,6 +41,7 @@
 
 #include <containers/List.hpp>
 #include <px4_platform_common/atomic.h>
+#include <px4_platform_common/namespace.h>
 
 namespace uORB
 {
@@ -56,7 +58,7 @@ class uORB::DeviceNode : public cdev::CDev, public ListNode<uORB::DeviceNode *>
 {
 public:
 	DeviceNode(const struct orb_metadata *meta, const uint8_t instance, const char *path, uint8_t priority,
-		   uint8_t queue_size = 1);
+		   Arena &arena, uint8_t queue_size = 1);
 	virtual ~DeviceNode();
 
 	// no copy, assignment, move, move assignment
@@ -122,7 +124,8 @@ public:
 	/**
 	 * processes a request for add subscription from remote
 	 * @param rateInHz
-	 *   Specifies the desired rate for the message.
+	 *   Specifies the desired rate for the message, the publications sent to the
+	 *   remote are limited to this rate. 0 for no limit.
 	 * @return
 	 *   0 = success
 	 *   otherwise failure.
@@ -175,6 +178,17 @@ public:
 	 */
 	int update_queue_size(unsigned int queue_size);
 
+	/**
+	 * Thread-safe update_queue_size(), for subscribers requesting a longer queue.
+	 */
+	int increase_queue_size(unsigned int queue_size)
+	{
+		lock();
+		int ret = update_queue_size(queue_size);
+		unlock();
+		return ret;
+	}
+
 	/**
 	 * Print statistics (nr of lost messages)
 	 * @param reset if true, reset statistics afterwards
@@ -186,7 +200,13 @@ public:
 
 	int8_t subscriber_count() const { return _subscriber_count; }
 
-	uint32_t lost_message_count() const { return _lost_messages; }
+	uint32_t lost_message_count() const { return _lost_messages.load(); }
+
+	/**
+	 * Number of optimistic (lock-free) copies that had to be retried because
+	 * a publisher updated the node while the copy was in progress.
+	 */
+	uint32_t copy_retry_count() const { return _copy_retries.load(); }
 
 	unsigned published_message_count() const { return _generation.load(); }
 
@@ -196,9 +216,18 @@ public:
 
 	uint8_t get_instance() const { return _instance; }
 
+	uint8_t get_namespace() const { return _namespace; }
+
 	int get_priority() const { return _priority; }
 	void set_priority(uint8_t priority) { _priority = priority; }
 
+	/**
+	 * Next node of the same topic (other instance or namespace), see DeviceMaster::getDeviceNode().
+	 * Set once by the DeviceMaster before the node becomes visible, constant afterwards.
+	 */
+	uORB::DeviceNode *next_topic_node() const { return _next_topic_node; }
+	void set_next_topic_node(uORB::DeviceNode *node) { _next_topic_node = node; }
+
 	/**
 	 * Copies data and the corresponding generation
 	 * from a node to the buffer provided.
@@ -212,6 +241,13 @@ public:
 	 */
 	bool copy(void *dst, unsigned &generation);
 
+	/**
+	 * Same as copy(), but also reports the messages this reader lost.
+	 * @param lost_messages
+	 *   Set to the number of messages that were overwritten in the queue before this copy.
+	 */
+	bool copy(void *dst, unsigned &generation, uint32_t &lost_messages);
+
 	/**
 	 * Copies data and the corresponding generation
 	 * from a node to the buffer provided.
@@ -227,6 +263,109 @@ public:
 	 */
 	uint64_t copy_and_get_timestamp(void *dst, unsigned &generation);
 
+	/**
+	 * Allow loans and borrows on this node. This reserves one additional buffer slot
+	 * (the one the next publication is written into), and is only possible before the
+	 * node buffer is allocated (i.e. before the first publication and before any loan).
+	 * @return true if the node supports loans and borrows
+	 */
+	bool enable_loans();
+
+	bool loans_enabled() const { return _loans_enabled; }
+
+	/**
+	 * Loan the buffer slot the next publication will be stored in, so that a publisher
+	 * can fill the message in place instead of copying it in with write().
+	 * Only a single loan can be outstanding at a time, and write() is rejected while
+	 * a loan is active, so this is meant for topics with a single publisher.
+	 * Must be called from thread context.
+	 * @return pointer to the slot, nullptr if the node does not support loans
+	 */
+	void *loan();
+
+	/**
+	 * Publish the message previously filled in through loan().
+	 * @return true on success, false if there was no outstanding loan
+	 */
+	bool publish_loan();
+
+	/**
+	 * Return an outstanding loan without publishing it.
+	 */
+	void cancel_loan() { _loan_active.store(false); }
+
+	/**
+	 * Borrow the next message for a subscriber without copying it.
+	 * The returned pointer stays valid as long as borrow_valid() returns true.
+	 * Readers are expected to check borrow_valid() after having consumed the data
+	 * and discard the result otherwise.
+	 *
+	 * @param generation
+	 *   The subscriber's generation (updated as with copy()).
+	 * @param borrowed_generation
+	 *   The generation of the borrowed message, to be passed to borrow_valid().
+	 * @return pointer to the message, nullptr if the node does not support borrows
+	 *   or a publication was in progress (use copy() in that case).
+	 */
+	const void *borrow(unsigned &generation, unsigned &borrowed_generation);
+
+	/**
+	 * Check if a borrowed message has not been overwritten by a newer publication.
+	 * @param borrowed_generation generation returned by borrow()
+	 */
+	bool borrow_valid(unsigned borrowed_generation) const
+	{
+		// order the reads of the borrowed data before checking the generation
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return (_generation.load() - borrowed_generation) < slot_count();
+	}
+
+	/**
+	 * Latency statistics, collected by copies of new messages once enabled.
+	 * Updates are not atomic (statistics only): concurrent copies might occasionally lose a count.
+	 */
+	struct LatencyStats {
+		static constexpr int LATENCY_BUCKETS = 16;
+		static constexpr int LAG_BUCKETS = 8;
+
+		uint32_t copy_count{0};
+		uint32_t latency_max_us{0};
+		uint32_t latency_histogram[LATENCY_BUCKETS] {}; /**< bucket i: [2^i, 2^(i+1)) us, bucket 0 includes 0 */
+		uint32_t lag_histogram[LAG_BUCKETS] {}; /**< unread messages after a copy, bucket 0: none, bucket i: [2^(i-1), 2^i) */
+
+		// age of the published samples (publication time - timestamp_sample), for topics with a timestamp_sample field
+		uint32_t sample_age_count{0};
+		uint32_t sample_age_max_us{0};
+		uint64_t sample_age_total_us{0};
+
+		uint32_t critical_section_max_us{0}; /**< longest time spent in the write critical section */
+	};
+
+	/**
+	 * Enable the collection of latency statistics. Must be called from thread context.
+	 */
+	void enable_latency_stats();
+
+	/**
+	 * Get the latency statistics, nullptr if not enabled.
+	 */
+	const LatencyStats *latency_stats() const { return _latency_stats; }
+
+	static constexpr int MAX_PUBLISHERS = 2;
+	static constexpr int MAX_SUBSCRIBERS = 6;
+
+	/**
+	 * Module IDs (see DeviceMaster::moduleId()) of the publishers and subscribers of this node,
+	 * for the runtime topic graph. Unused entries are 0, modules beyond the array size are not recorded.
+	 */
+	const uint8_t *publisher_ids() const { return _publisher_ids; }
+	const uint8_t *subscriber_ids() const { return _subscriber_ids; }
+
+	/**
+	 * Whether the topic has a timestamp_sample field, so that sample ages are recorded.
+	 */
+	bool has_timestamp_sample() const { return _timestamp_sample_offset >= 0; }
+
 	// add item to list of work items to schedule on node update
 	bool register_callback(SubscriptionCallback *callback_sub);
 
@@ -241,6 +380,32 @@ protected:
 
 private:
 
+	/**
+	 * Maximum number of optimistic copy attempts before falling back to
+	 * copying inside the critical section. This bounds the time a reader can
+	 * spend retrying if it keeps racing with a (possibly preempted) publisher.
+	 */
+	static constexpr unsigned MAX_COPY_RETRIES = 3;
+
+	/**
+	 * Copies data and the corresponding generation
+	 * from a node to the buffer provided without taking any lock.
+	 * The sequence counter is used to detect a concurrent write, in which case
+	 * the copy is retried. Falls back to copy_locked() after MAX_COPY_RETRIES.
+	 *
+	 * @param dst
+	 *   The buffer into which the data is copied.
+	 * @param generation
+	 *   The generation that was copied.
+	 * @param update_time
+	 *   If not null, set to the time of the last update consistent with the copied data.
+	 * @param lost_messages_out
+	 *   If not null, set to the number of messages the reader lost (overwritten in the queue).
+	 * @return bool
+	 *   Returns true if the data was copied.
+	 */
+	bool copy_seqlock(void *dst, unsigned &generation, hrt_abstime *update_time, uint32_t *lost_messages_out = nullptr);
+
 	/**
 	 * Copies data and the corresponding generation
 	 * from a node to the buffer provided. Caller handles locking.
@@ -252,7 +417,65 @@ private:
 	 * @return bool
 	 *   Returns true if the data was copied.
 	 */
-	bool copy_locked(void *dst, unsigned &generation);
+	bool copy_locked(void *dst, unsigned &generation, uint32_t *lost_messages_out = nullptr);
+
+	/**
+	 * Copy the element for the given generation without modifying any node state.
+	 *
+	 * @param data
+	 *   The node buffer (already checked for nullptr).
+	 * @param dst
+	 *   The buffer into which the data is copied.
+	 * @param generation
+	 *   The generation that was copied (updated).
+	 * @param lost_messages
+	 *   The number of messages the reader missed (output).
+	 */
+	void copy_element(const uint8_t *data, void *dst, unsigned &generation, uint32_t &lost_messages) const;
+
+	/**
+	 * Select the queue element a reader gets next (same semantics as copy()).
+	 * @return the generation of the element to read
+	 */
+	unsigned next_read_generation(unsigned &generation, uint32_t &lost_messages) const;
+
+	/**
+	 * Allocate the node buffer if not yet done. Must be called from thread context.
+	 * @return true if the buffer is allocated
+	 */
+	bool allocate_data();
+
+	/**
+	 * Number of allocated buffer slots: the queue plus a spare slot if loans are enabled.
+	 */
+	unsigned slot_count() const { return _loans_enabled ? _queue_size + 1 : _queue_size; }
+
+	/**
+	 * Add a copy of a new message to the latency statistics.
+	 * @param latency time from publication to copy
+	 * @param lag number of newer messages not read by the subscriber yet
+	 */
+	void record_latency(hrt_abstime latency, unsigned lag);
+
+	/**
+	 * Add the age of a published message to the latency statistics, if the topic has a timestamp_sample.
+	 * @param data the published message
+	 * @param now publication time
+	 */
+	void record_sample_age(const uint8_t *data, hrt_abstime now);
+
+	/**
+	 * Record the module with the given name as endpoint (publisher or subscriber) of this node.
+	 * Must be called from thread context.
+	 */
+	void add_endpoint(uint8_t *ids, int num_ids, const char *module_name);
+
+	/**
+	 * Call all registered callbacks and notify poll waiters after a publication.
+	 * Must be called after leaving the critical section, with _callback_dispatch_count
+	 * incremented within it.
+	 */
+	void dispatch_callbacks();
 
 	struct UpdateIntervalData {
 		uint64_t last_update{0}; /**< time at which the last update was provided, used when update_interval is nonzero */
@@ -268,18 +491,38 @@ private:
 
 	const orb_metadata *_meta; /**< object metadata information */
 	const uint8_t _instance; /**< orb multi instance identifier */
+	const uint8_t _namespace{px4::get_namespace()}; /**< namespace of the advertising or subscribing thread */
+	Arena        &_arena; /**< memory of the object buffer */
 	uint8_t     *_data{nullptr};   /**< allocated object buffer */
 	hrt_abstime   _last_update{0}; /**< time the object was last updated */
 	px4::atomic<unsigned>  _generation{0};  /**< object generation count */
+	px4::atomic<unsigned>  _sequence{0};  /**< write sequence counter, odd while a write is in progress */
 	List<uORB::SubscriptionCallback *>	_callbacks;
+	px4::atomic<int>  _callback_dispatch_count{0};  /**< number of publishers currently walking _callbacks */
 	uint8_t   _priority;  /**< priority of the topic */
 	bool _advertised{false};  /**< has ever been advertised (not necessarily published data yet) */
+	bool _loans_enabled{false}; /**< reserve a spare buffer slot for loans and borrows */
+	px4::atomic_bool _loan_active{false}; /**< a publisher currently holds a loan */
 	uint8_t _queue_size; /**< maximum number of elements in the queue */
 	int8_t _subscriber_count{0};
 
 	// statistics
-	uint32_t _lost_messages = 0; /**< nr of lost messages for all subscribers. If two subscribers lose the same
+	px4::atomic<uint32_t> _lost_messages{0}; /**< nr of lost messages for all subscribers. If two subscribers lose the same
 					message, it is counted as two. */
+	px4::atomic<uint32_t> _copy_retries{0}; /**< nr of lock-free copies retried due to a concurrent write */
+
+	LatencyStats *_latency_stats{nullptr}; /**< allocated once latency statistics are enabled */
+	int16_t _timestamp_sample_offset{-1}; /**< offset of the timestamp_sample field, -1 if the topic has none */
+
+	uint8_t _publisher_ids[MAX_PUBLISHERS] {}; /**< module IDs of the publishers */
+	uint8_t _subscriber_ids[MAX_SUBSCRIBERS] {}; /**< module IDs of the subscribers */
+
+#ifdef ORB_COMMUNICATOR
+	uint32_t _remote_send_interval_us{0}; /**< minimum interval between publications sent to the remote, 0 for no limit */
+	hrt_abstime _remote_last_send{0}; /**< time of the last publication sent to the remote */
+#endif /* ORB_COMMUNICATOR */
+
+	uORB::DeviceNode *_next_topic_node{nullptr}; /**< next node of the same topic */
 
 	inline static SubscriberData    *filp_to_sd(cdev::file_t *filp);
 
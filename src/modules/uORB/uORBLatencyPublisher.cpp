@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2019 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBLatencyPublisher.hpp"
+
+#include <string.h>
+
+namespace uORB
+{
+
+LatencyPublisher::LatencyPublisher(DeviceMaster *device_master) :
+	ScheduledWorkItem(MODULE_NAME, px4::wq_configurations::lp_default),
+	_device_master(device_master)
+{
+}
+
+void LatencyPublisher::start()
+{
+	_device_master->enableLatencyStats();
+	ScheduleOnInterval(PUBLISH_INTERVAL_US);
+}
+
+void LatencyPublisher::Run()
+{
+	// round-robin over all nodes, publishing the next one with statistics
+	DeviceNode *start_node = _node;
+
+	do {
+		_node = _device_master->nextDeviceNode(_node);
+
+		if (_node == nullptr) {
+			continue;
+		}
+
+		const DeviceNode::LatencyStats *stats = _node->latency_stats();
+
+		if ((stats != nullptr) && (stats->copy_count > 0 || stats->sample_age_count > 0)
+		    && (_node->get_meta() != ORB_ID(uorb_latency))) {
+			uorb_latency_s report{};
+			strncpy(report.topic_name, _node->get_name(), sizeof(report.topic_name) - 1);
+			report.instance = _node->get_instance();
+			report.copy_count = stats->copy_count;
+			report.latency_max_us = stats->latency_max_us;
+
+			static_assert(sizeof(report.latency_histogram) == sizeof(stats->latency_histogram), "latency buckets mismatch");
+			static_assert(sizeof(report.lag_histogram) == sizeof(stats->lag_histogram), "lag buckets mismatch");
+			memcpy(report.latency_histogram, stats->latency_histogram, sizeof(report.latency_histogram));
+			memcpy(report.lag_histogram, stats->lag_histogram, sizeof(report.lag_histogram));
+
+			const char *publisher = _device_master->moduleName(_node->publisher_ids()[0]);
+
+			if (publisher != nullptr) {
+				strncpy(report.publisher_name, publisher, sizeof(report.publisher_name) - 1);
+			}
+
+			if (stats->sample_age_count > 0) {
+				report.sample_age_mean_us = stats->sample_age_total_us / stats->sample_age_count;
+				report.sample_age_max_us = stats->sample_age_max_us;
+			}
+
+			report.timestamp = hrt_absolute_time();
+			_uorb_latency_pub.publish(report);
+			return;
+		}
+
+	} while (_node != start_node);
+}
+
+} // namespace uORB
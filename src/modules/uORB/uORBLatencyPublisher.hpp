@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2019 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBLatencyPublisher.hpp
+ *
+ * Periodically publishes the latency statistics of all topics as uorb_latency, so that they can be logged.
+ */
+
+#pragma once
+
+#include "uORBDeviceMaster.hpp"
+#include "uORBDeviceNode.hpp"
+
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <uORB/PublicationQueued.hpp>
+#include <uORB/topics/uorb_latency.h>
+
+namespace uORB
+{
+
+class LatencyPublisher : public px4::ScheduledWorkItem
+{
+public:
+	LatencyPublisher(DeviceMaster *device_master);
+	~LatencyPublisher() override = default;
+
+	/**
+	 * Enable the latency statistics and start publishing.
+	 */
+	void start();
+
+	void stop() { ScheduleClear(); }
+
+private:
+	static constexpr uint32_t PUBLISH_INTERVAL_US = 50000; ///< one topic per interval
+
+	void Run() override;
+
+	DeviceMaster *_device_master;
+	DeviceNode *_node{nullptr}; ///< last published node
+
+	uORB::PublicationQueued<uorb_latency_s> _uorb_latency_pub{ORB_ID(uorb_latency)};
+};
+
+} // namespace uORB
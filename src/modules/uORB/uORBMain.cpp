@@ -36,6 +36,7 @@
 #include "uORBManager.hpp"
 #include "uORB.h"
 #include "uORBCommon.hpp"
+#include "uORBLatencyPublisher.hpp"
 
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/module.h>
@@ -43,6 +44,7 @@
 extern "C" { __EXPORT int uorb_main(int argc, char *argv[]); }
 
 static uORB::DeviceMaster *g_dev = nullptr;
+static uORB::LatencyPublisher *g_latency_publisher = nullptr;
 static void usage()
 {
 	PRINT_MODULE_DESCRIPTION(
@@ -59,6 +61,9 @@ The implementation is asynchronous and lock-free, ie. a publisher does not wait
 This is achieved by having a separate buffer between a publisher and a subscriber.
 
 The code is optimized to minimize the memory footprint and the latency to exchange messages.
+The message buffers are taken from an arena allocated at startup, if the board configures one
+(BOARD_UORB_ARENA_SIZE), and from the heap otherwise or once it is full. `uorb status` shows how much
+is used of both.
 
 The interface is based on file descriptors: internally it uses `read`, `write` and `ioctl`. Except for the
 publications, which use `orb_advert_t` handles, so that they can be used from interrupts as well (on NuttX).
@@ -68,6 +73,15 @@ Messages are defined in the `/msg` directory. They are converted into C/C++ code
 If compiled with ORB_USE_PUBLISHER_RULES, a file with uORB publication rules can be used to configure which
 modules are allowed to publish which topics. This is used for system-wide replay.
 
+Latency statistics (time from publication to copy, how far subscribers lag behind and the longest
+publication critical section) are collected once enabled with `uorb top -l` or `uorb latency start`. The latter also publishes them as `uorb_latency` topic,
+so that they end up in the log.
+
+`uorb graph` shows the topic graph as it is at runtime (the modules that advertised and subscribed each topic)
+and where the latency of a chain of topics goes: for topics with a `timestamp_sample` field the age of the sample
+at publication is recorded, and the difference between two topics of the chain is the time spent in the module
+in between. The sample ages are logged as part of `uorb_latency` as well.
+
 ### Examples
 Monitor topic publication rates. Besides `top`, this is an important command for general system inspection:
 $ uorb top
@@ -75,11 +89,17 @@ $ uorb top
 
 	PRINT_MODULE_USAGE_NAME("uorb", "communication");
 	PRINT_MODULE_USAGE_COMMAND("start");
-	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "Print topic statistics");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "Print topic statistics and buffer memory usage");
 	PRINT_MODULE_USAGE_COMMAND_DESCR("top", "Monitor topic publication rates");
 	PRINT_MODULE_USAGE_PARAM_FLAG('a', "print all instead of only currently publishing topics", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('1', "run only once, then exit", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('l', "show latency statistics (enables them)", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('c', "show total message counts since boot instead of rates", true);
 	PRINT_MODULE_USAGE_ARG("<filter1> [<filter2>]", "topic(s) to match (implies -a)", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("latency", "Publish latency statistics as uorb_latency topic");
+	PRINT_MODULE_USAGE_ARG("start|stop", "Start or stop publishing", false);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("graph", "Print the runtime topic graph and the latency along a chain of topics");
+	PRINT_MODULE_USAGE_ARG("<topic1> [<topic2> ...]", "chain of topics (default: the control loop)", true);
 }
 
 int
@@ -148,6 +168,44 @@ uorb_main(int argc, char *argv[])
 		return OK;
 	}
 
+	if (!strcmp(argv[1], "graph")) {
+		if (g_dev != nullptr) {
+			g_dev->showGraph(argv + 2, argc - 2);
+
+		} else {
+			PX4_INFO("uorb is not running");
+		}
+
+		return OK;
+	}
+
+	if (!strcmp(argv[1], "latency")) {
+		if (g_dev == nullptr) {
+			PX4_INFO("uorb is not running");
+			return OK;
+		}
+
+		if (argc > 2 && !strcmp(argv[2], "start")) {
+			if (g_latency_publisher == nullptr) {
+				g_latency_publisher = new uORB::LatencyPublisher(g_dev);
+
+				if (g_latency_publisher == nullptr) {
+					return -ENOMEM;
+				}
+			}
+
+			g_latency_publisher->start();
+			return OK;
+
+		} else if (argc > 2 && !strcmp(argv[2], "stop")) {
+			if (g_latency_publisher != nullptr) {
+				g_latency_publisher->stop();
+			}
+
+			return OK;
+		}
+	}
+
 	usage();
 	return -EINVAL;
 }
@@ -227,12 +227,14 @@ orb_advert_t uORB::Manager::orb_advertise_multi(const struct orb_metadata *meta,
 	uORB::DeviceNode::topic_advertised(meta, priority);
 #endif /* ORB_COMMUNICATOR */
 
-	/* the advertiser must perform an initial publish to initialise the object */
-	result = orb_publish(meta, advertiser, data);
+	/* the advertiser must perform an initial publish to initialise the object, unless it loans the messages */
+	if (data != nullptr) {
+		result = orb_publish(meta, advertiser, data);
 
-	if (result == PX4_ERROR) {
-		PX4_WARN("orb_publish failed");
-		return nullptr;
+		if (result == PX4_ERROR) {
+			PX4_WARN("orb_publish failed");
+			return nullptr;
+		}
 	}
 
 	return advertiser;
@@ -280,6 +282,65 @@ int uORB::Manager::orb_publish(const struct orb_metadata *meta, orb_advert_t han
 	return uORB::DeviceNode::publish(meta, handle, data);
 }
 
+void *uORB::Manager::orb_loan(orb_advert_t handle)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return nullptr; // publication is ignored anyway
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	if (handle == nullptr) {
+		return nullptr;
+	}
+
+	return ((uORB::DeviceNode *)handle)->loan();
+}
+
+int uORB::Manager::orb_publish_loan(const struct orb_metadata *meta, orb_advert_t handle, const void *data)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return PX4_OK; //pretend success
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	if ((devnode == nullptr) || (meta == nullptr) || (data == nullptr)) {
+		errno = EFAULT;
+		return PX4_ERROR;
+	}
+
+	if (devnode->get_meta() != meta) {
+		errno = EINVAL;
+		return PX4_ERROR;
+	}
+
+	if (!devnode->publish_loan()) {
+		errno = EINVAL;
+		return PX4_ERROR;
+	}
+
+#ifdef ORB_COMMUNICATOR
+	uORBCommunicator::IChannel *ch = get_uorb_communicator();
+
+	if (ch != nullptr) {
+		if (ch->send_message(meta->o_name, meta->o_size, (uint8_t *)data) != 0) {
+			PX4_ERR("Error Sending [%s] topic data over comm_channel", meta->o_name);
+			return PX4_ERROR;
+		}
+	}
+
+#endif /* ORB_COMMUNICATOR */
+
+	return PX4_OK;
+}
+
 int uORB::Manager::orb_copy(const struct orb_metadata *meta, int handle, void *buffer)
 {
 	int ret;
@@ -146,6 +146,8 @@ public:
 	 * @param data    A pointer to the initial data to be published.
 	 *      For topics updated by interrupt handlers, the advertisement
 	 *      must be performed from non-interrupt context.
+	 *      If nullptr, the topic is advertised without an initial publication
+	 *      (used by publishers filling loaned messages, see orb_loan()).
 	 * @param instance  Pointer to an integer which will yield the instance ID (0-based)
 	 *      of the publication. This is an output parameter and will be set to the newly
 	 *      created instance, ie. 0 for the first advertiser, 1 for the next and so on.
@@ -187,6 +189,29 @@ public:
 	 */
 	int  orb_publish(const struct orb_metadata *meta, orb_advert_t handle, const void *data);
 
+	/**
+	 * Loan the buffer slot of the next publication, so that it can be filled in place.
+	 *
+	 * This avoids copying large messages into the topic. Only a single loan per topic instance
+	 * can be outstanding, and the topic must have a single publisher.
+	 *
+	 * @handle    The handle returned from orb_advertise.
+	 * @return    Pointer to the message to fill, nullptr if loans are not possible
+	 *      (in which case orb_publish() should be used).
+	 */
+	void *orb_loan(orb_advert_t handle);
+
+	/**
+	 * Publish a message previously filled in through orb_loan().
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @handle    The handle returned from orb_advertise.
+	 * @param data    The pointer returned by orb_loan().
+	 * @return    OK on success, PX4_ERROR otherwise with errno set accordingly.
+	 */
+	int  orb_publish_loan(const struct orb_metadata *meta, orb_advert_t handle, const void *data);
+
 	/**
 	 * Subscribe to a topic.
 	 *
@@ -35,6 +35,21 @@
 #include <stdio.h>
 #include <errno.h>
 
+#include <px4_platform_common/namespace.h>
+
+static unsigned mkpath(char *buf, const char *name, unsigned index)
+{
+	const uint8_t ns = px4::get_namespace();
+
+	// namespace 0 keeps the plain paths
+	if (ns == 0) {
+		return snprintf(buf, orb_maxpath, "/%s/%s%d", "obj", name, index);
+	}
+
+	// the instance must remain the last character, see DeviceMaster::advertise()
+	return snprintf(buf, orb_maxpath, "/%s/ns%d/%s%d", "obj", ns, name, index);
+}
+
 int uORB::Utils::node_mkpath(char *buf, const struct orb_metadata *meta, int *instance)
 {
 	unsigned len;
@@ -45,7 +60,7 @@ int uORB::Utils::node_mkpath(char *buf, const struct orb_metadata *meta, int *in
 		index = *instance;
 	}
 
-	len = snprintf(buf, orb_maxpath, "/%s/%s%d", "obj", meta->o_name, index);
+	len = mkpath(buf, meta->o_name, index);
 
 	if (len >= orb_maxpath) {
 		return -ENAMETOOLONG;
@@ -62,7 +77,7 @@ int uORB::Utils::node_mkpath(char *buf, const char *orbMsgName)
 
 	unsigned index = 0;
 
-	len = snprintf(buf, orb_maxpath, "/%s/%s%d", "obj", orbMsgName, index);
+	len = mkpath(buf, orbMsgName, index);
 
 	if (len >= orb_maxpath) {
 		return -ENAMETOOLONG;
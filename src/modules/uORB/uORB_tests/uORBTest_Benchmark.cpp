@@ -0,0 +1,382 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBTest_Benchmark.hpp"
+#include "../Publication.hpp"
+#include "../Subscription.hpp"
+#include "../SubscriptionCallback.hpp"
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+#include <px4_platform_common/tasks.h>
+#include <px4_platform_common/time.h>
+
+#include <inttypes.h>
+
+using namespace time_literals;
+
+ORB_DEFINE(orb_bench, struct orb_test, sizeof(orb_test), "ORB_BENCH:int val;hrt_abstime time;");
+ORB_DEFINE(orb_bench_medium, struct orb_test_medium, sizeof(orb_test_medium),
+	   "ORB_BENCH_MEDIUM:int val;hrt_abstime time;char[64] junk;");
+ORB_DEFINE(orb_bench_large, struct orb_test_large, sizeof(orb_test_large),
+	   "ORB_BENCH_LARGE:int val;hrt_abstime time;char[512] junk;");
+ORB_DEFINE(orb_bench_queue, struct orb_test_medium, sizeof(orb_test_medium),
+	   "ORB_BENCH_QUEUE:int val;hrt_abstime time;char[64] junk;");
+ORB_DEFINE(orb_bench_contention, struct orb_test, sizeof(orb_test), "ORB_BENCH_CONTENTION:int val;hrt_abstime time;");
+
+namespace
+{
+
+/**
+ * Callback subscriber doing no work, only the cost of the notification itself is measured
+ */
+class CountingCallback : public uORB::SubscriptionCallback
+{
+public:
+	CountingCallback() : uORB::SubscriptionCallback(ORB_ID(orb_bench_medium)) {}
+
+	void call() override { _count++; }
+
+private:
+	unsigned _count{0};
+};
+
+/**
+ * Work item scheduled by a uORB callback, measures the time from publication to Run()
+ */
+class WakeupWorkItem : public px4::WorkItem
+{
+public:
+	explicit WakeupWorkItem(const px4::wq_config_t &config) :
+		px4::WorkItem("uorb_bench_wakeup", config),
+		_sub{this, ORB_ID(orb_bench_medium)}
+	{}
+
+	bool init() { return _sub.registerCallback(); }
+
+	void Run() override
+	{
+		orb_test_medium data;
+
+		if (_sub.update(&data)) {
+			const hrt_abstime latency = hrt_elapsed_time(&data.time);
+
+			if (latency < latency_min) {
+				latency_min = latency;
+			}
+
+			if (latency > latency_max) {
+				latency_max = latency;
+			}
+
+			latency_total += latency;
+			runs.fetch_add(1);
+		}
+	}
+
+	hrt_abstime latency_min{UINT64_MAX};
+	hrt_abstime latency_max{0};
+	uint64_t latency_total{0};
+	px4::atomic<int> runs{0};
+
+private:
+	uORB::SubscriptionCallbackWorkItem _sub;
+};
+
+} // namespace
+
+uORBTest::Benchmark &uORBTest::Benchmark::instance()
+{
+	static uORBTest::Benchmark b;
+	return b;
+}
+
+int uORBTest::Benchmark::run(int iterations)
+{
+	_iterations = iterations;
+
+	int ret = bench_publish_subscribers();
+	ret |= bench_message_size();
+	ret |= bench_queue();
+	ret |= bench_callback_wakeup();
+	ret |= bench_contention();
+
+	return (ret == PX4_OK) ? PX4_OK : PX4_ERROR;
+}
+
+int uORBTest::Benchmark::bench_publish_subscribers()
+{
+	uORB::Publication<orb_test_medium> pub{ORB_ID(orb_bench_medium)};
+	orb_test_medium data{};
+
+	// advertise outside of the measurement
+	pub.publish(data);
+
+	const int subscriber_counts[] {0, 1, 4, 16};
+
+	for (int subscribers : subscriber_counts) {
+		CountingCallback *callbacks = new CountingCallback[subscribers];
+
+		if (callbacks == nullptr) {
+			PX4_ERR("alloc failed");
+			return PX4_ERROR;
+		}
+
+		for (int i = 0; i < subscribers; i++) {
+			callbacks[i].registerCallback();
+		}
+
+		const hrt_abstime start = hrt_absolute_time();
+
+		for (int i = 0; i < _iterations; i++) {
+			data.val = i;
+			pub.publish(data);
+		}
+
+		report("publish_callbacks", "subscribers", subscribers, _iterations, hrt_elapsed_time(&start));
+
+		delete[] callbacks;
+	}
+
+	return PX4_OK;
+}
+
+template<typename S>
+int uORBTest::Benchmark::bench_size(const orb_metadata *meta)
+{
+	uORB::Publication<S> pub{meta};
+	S data{};
+	pub.publish(data);
+
+	uORB::Subscription sub{meta};
+
+	if (!sub.subscribe()) {
+		PX4_ERR("subscribe %s failed", meta->o_name);
+		return PX4_ERROR;
+	}
+
+	hrt_abstime start = hrt_absolute_time();
+
+	for (int i = 0; i < _iterations; i++) {
+		data.val = i;
+		pub.publish(data);
+	}
+
+	report("publish_size", "size", static_cast<int>(sizeof(S)), _iterations, hrt_elapsed_time(&start));
+
+	start = hrt_absolute_time();
+
+	for (int i = 0; i < _iterations; i++) {
+		sub.copy(&data);
+	}
+
+	report("copy_size", "size", static_cast<int>(sizeof(S)), _iterations, hrt_elapsed_time(&start));
+
+	return PX4_OK;
+}
+
+int uORBTest::Benchmark::bench_message_size()
+{
+	int ret = bench_size<orb_test>(ORB_ID(orb_bench));
+	ret |= bench_size<orb_test_medium>(ORB_ID(orb_bench_medium));
+	ret |= bench_size<orb_test_large>(ORB_ID(orb_bench_large));
+	return ret;
+}
+
+int uORBTest::Benchmark::bench_queue()
+{
+	orb_test_medium data{};
+	orb_advert_t handle = orb_advertise_queue(ORB_ID(orb_bench_queue), &data, QUEUE_LENGTH);
+
+	if (handle == nullptr) {
+		PX4_ERR("advertise failed: %d", errno);
+		return PX4_ERROR;
+	}
+
+	uORB::Subscription sub{ORB_ID(orb_bench_queue)};
+	sub.subscribe();
+
+	while (sub.update(&data)) {}
+
+	const int rounds = (_iterations > QUEUE_LENGTH) ? _iterations / QUEUE_LENGTH : 1;
+	hrt_abstime publish_elapsed = 0;
+	hrt_abstime drain_elapsed = 0;
+	int received = 0;
+
+	for (int round = 0; round < rounds; round++) {
+		// fill the whole queue, then drain it like a subscriber running at a lower rate
+		const hrt_abstime start = hrt_absolute_time();
+
+		for (int i = 0; i < QUEUE_LENGTH; i++) {
+			data.val = i;
+			orb_publish(ORB_ID(orb_bench_queue), handle, &data);
+		}
+
+		const hrt_abstime published = hrt_absolute_time();
+
+		while (sub.update(&data)) {
+			received++;
+		}
+
+		publish_elapsed += published - start;
+		drain_elapsed += hrt_elapsed_time(&published);
+	}
+
+	orb_unadvertise(handle);
+
+	report("queue_publish", "queue_length", QUEUE_LENGTH, rounds * QUEUE_LENGTH, publish_elapsed);
+	report("queue_drain", "queue_length", QUEUE_LENGTH, received, drain_elapsed);
+
+	if (received != rounds * QUEUE_LENGTH) {
+		PX4_ERR("queue lost %d of %d messages", rounds * QUEUE_LENGTH - received, rounds * QUEUE_LENGTH);
+		return PX4_ERROR;
+	}
+
+	return PX4_OK;
+}
+
+int uORBTest::Benchmark::bench_callback_wakeup()
+{
+	// both work items are scheduled by the same publication, the second one after the first
+	WakeupWorkItem item1{px4::wq_configurations::test1};
+	WakeupWorkItem item2{px4::wq_configurations::test2};
+
+	uORB::Publication<orb_test_medium> pub{ORB_ID(orb_bench_medium)};
+	orb_test_medium data{};
+	pub.publish(data);
+
+	if (!item1.init() || !item2.init()) {
+		PX4_ERR("callback registration failed");
+		return PX4_ERROR;
+	}
+
+	for (int i = 1; i <= WAKEUP_ITERATIONS; i++) {
+		data.val = i;
+		data.time = hrt_absolute_time();
+		pub.publish(data);
+
+		const hrt_abstime timeout = hrt_absolute_time() + 100_ms;
+
+		while (item1.runs.load() < i || item2.runs.load() < i) {
+			if (hrt_absolute_time() > timeout) {
+				PX4_ERR("callback %d timed out", i);
+				return PX4_ERROR;
+			}
+
+			px4_usleep(100);
+		}
+	}
+
+	report_latency("callback_wakeup", "wq:test1", WAKEUP_ITERATIONS, item1.latency_min,
+		       (double)item1.latency_total / WAKEUP_ITERATIONS, item1.latency_max);
+	report_latency("callback_wakeup", "wq:test2", WAKEUP_ITERATIONS, item2.latency_min,
+		       (double)item2.latency_total / WAKEUP_ITERATIONS, item2.latency_max);
+
+	return PX4_OK;
+}
+
+int uORBTest::Benchmark::bench_contention()
+{
+	for (int tasks = 1; tasks <= MAX_PUBLISHER_TASKS; tasks *= 2) {
+		_tasks_ready.store(0);
+		_tasks_done.store(0);
+		_tasks_start.store(false);
+
+		char *const args[1] = { nullptr };
+
+		for (int i = 0; i < tasks; i++) {
+			if (px4_task_spawn_cmd("uorb_bench_pub", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, 2000,
+					       (px4_main_t)&uORBTest::Benchmark::publisher_task_entry, args) < 0) {
+				PX4_ERR("failed launching task");
+				_tasks_start.store(true);
+				return PX4_ERROR;
+			}
+		}
+
+		while (_tasks_ready.load() < tasks) {
+			px4_usleep(1000);
+		}
+
+		const hrt_abstime start = hrt_absolute_time();
+		_tasks_start.store(true);
+
+		while (_tasks_done.load() < tasks) {
+			px4_usleep(100);
+		}
+
+		report("publish_contention", "publishers", tasks, tasks * _iterations, hrt_elapsed_time(&start));
+	}
+
+	return PX4_OK;
+}
+
+int uORBTest::Benchmark::publisher_task_entry(int argc, char *argv[])
+{
+	return uORBTest::Benchmark::instance().publisher_task_main();
+}
+
+int uORBTest::Benchmark::publisher_task_main()
+{
+	uORB::Publication<orb_test> pub{ORB_ID(orb_bench_contention)};
+	orb_test data{};
+	pub.publish(data);
+
+	_tasks_ready.fetch_add(1);
+
+	while (!_tasks_start.load()) {
+		px4_usleep(100);
+	}
+
+	for (int i = 0; i < _iterations; i++) {
+		data.val = i;
+		pub.publish(data);
+	}
+
+	_tasks_done.fetch_add(1);
+
+	return 0;
+}
+
+void uORBTest::Benchmark::report(const char *bench, const char *param, int value, int iterations, hrt_abstime elapsed)
+{
+	PX4_INFO_RAW("uorb_bench: {\"bench\": \"%s\", \"%s\": %d, \"iterations\": %d, \"elapsed_us\": %" PRIu64
+		     ", \"ns_per_op\": %.1f}\n", bench, param, value, iterations, elapsed,
+		     (iterations > 0) ? (double)elapsed * 1000. / iterations : 0.);
+}
+
+void uORBTest::Benchmark::report_latency(const char *bench, const char *queue, int samples, hrt_abstime min,
+		double mean, hrt_abstime max)
+{
+	PX4_INFO_RAW("uorb_bench: {\"bench\": \"%s\", \"queue\": \"%s\", \"samples\": %d, \"min_us\": %" PRIu64
+		     ", \"mean_us\": %.1f, \"max_us\": %" PRIu64 "}\n", bench, queue, samples, min, mean, max);
+}
@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBTest_Benchmark.hpp
+ *
+ * uORB benchmark suite: publication cost vs. callback subscriber count, publish and copy cost vs.
+ * message size, queued topics, callback wakeup latency of work items on different work queues and
+ * contention between concurrent publishers.
+ *
+ * Every result is printed as one JSON object per line, prefixed with "uorb_bench: ", so that the
+ * output can be collected and compared between commits.
+ */
+
+#pragma once
+
+#include "uORBTest_UnitTest.hpp"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+
+ORB_DECLARE(orb_bench);
+ORB_DECLARE(orb_bench_medium);
+ORB_DECLARE(orb_bench_large);
+ORB_DECLARE(orb_bench_queue);
+ORB_DECLARE(orb_bench_contention);
+
+namespace uORBTest
+{
+
+class Benchmark
+{
+public:
+	static Benchmark &instance();
+	~Benchmark() = default;
+
+	Benchmark(const Benchmark &) = delete;
+	Benchmark &operator=(const Benchmark &) = delete;
+
+	/**
+	 * Run all benchmarks.
+	 * @param iterations number of operations per measurement
+	 */
+	int run(int iterations);
+
+private:
+	Benchmark() = default;
+
+	static constexpr int QUEUE_LENGTH = 16;
+	static constexpr int MAX_PUBLISHER_TASKS = 4;
+	static constexpr int WAKEUP_ITERATIONS = 1000;
+
+	int bench_publish_subscribers();
+	int bench_message_size();
+	int bench_queue();
+	int bench_callback_wakeup();
+	int bench_contention();
+
+	template<typename S>
+	int bench_size(const orb_metadata *meta);
+
+	static int publisher_task_entry(int argc, char *argv[]);
+	int publisher_task_main();
+
+	/**
+	 * Print a throughput result: total time of iterations operations
+	 */
+	void report(const char *bench, const char *param, int value, int iterations, hrt_abstime elapsed);
+
+	/**
+	 * Print a latency result
+	 */
+	void report_latency(const char *bench, const char *queue, int samples, hrt_abstime min, double mean, hrt_abstime max);
+
+	int _iterations{10000};
+
+	// publisher tasks of the contention benchmark
+	px4::atomic<int> _tasks_ready{0};
+	px4::atomic<int> _tasks_done{0};
+	px4::atomic<bool> _tasks_start{false};
+};
+
+} // namespace uORBTest
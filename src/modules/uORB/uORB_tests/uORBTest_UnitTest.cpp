@@ -33,6 +33,9 @@
 
 #include "uORBTest_UnitTest.hpp"
 #include "../uORBCommon.hpp"
+#include "../Publication.hpp"
+#include "../Subscription.hpp"
+#include "../SubscriptionSet.hpp"
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/time.h>
 #include <stdio.h>
@@ -42,6 +45,7 @@
 
 ORB_DEFINE(orb_test, struct orb_test, sizeof(orb_test), "ORB_TEST:int val;hrt_abstime time;");
 ORB_DEFINE(orb_multitest, struct orb_test, sizeof(orb_test), "ORB_MULTITEST:int val;hrt_abstime time;");
+ORB_DEFINE(orb_test_set, struct orb_test, sizeof(orb_test), "ORB_TEST_SET:int val;hrt_abstime time;");
 
 ORB_DEFINE(orb_test_medium, struct orb_test_medium, sizeof(orb_test_medium),
 	   "ORB_TEST_MEDIUM:int val;hrt_abstime time;char[64] junk;");
@@ -54,6 +58,8 @@ ORB_DEFINE(orb_test_medium_queue_poll, struct orb_test_medium, sizeof(orb_test_m
 
 ORB_DEFINE(orb_test_large, struct orb_test_large, sizeof(orb_test_large),
 	   "ORB_TEST_LARGE:int val;hrt_abstime time;char[512] junk;");
+ORB_DEFINE(orb_test_loan, struct orb_test_large, sizeof(orb_test_large),
+	   "ORB_TEST_LOAN:int val;hrt_abstime time;char[512] junk;");
 
 uORBTest::UnitTest &uORBTest::UnitTest::instance()
 {
@@ -223,9 +229,197 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
+	ret = test_loan();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_subscription_set();
+
+	if (ret != OK) {
+		return ret;
+	}
+
 	return test_queue_poll_notify();
 }
 
+int uORBTest::UnitTest::test_subscription_set()
+{
+	test_note("Testing SubscriptionSet");
+
+	px4_sem_t sem;
+	px4_sem_init(&sem, 0, 0);
+	px4_sem_setprotocol(&sem, SEM_PRIO_NONE);
+
+	int ret = PX4_ERROR;
+	orb_advert_t pub[2] {};
+	orb_test t{};
+	orb_test u{};
+
+	{
+		uORB::SubscriptionSet<2> set{&sem};
+		set.set_member(0, ORB_ID(orb_test_set), 0);
+		set.set_member(1, ORB_ID(orb_test_set), 1);
+
+		if (!set.registerCallbacks()) {
+			test_fail("registering callbacks failed");
+			goto out;
+		}
+
+		// members are reported as updated initially, but nothing is published yet
+		if ((set.updated_mask() != 0b11) || set.update(0, &u) || set.update(1, &u)) {
+			test_fail("initial update mismatch");
+			goto out;
+		}
+
+		int instance0 = -1;
+		int instance1 = -1;
+		t.val = 1;
+		pub[0] = orb_advertise_multi(ORB_ID(orb_test_set), &t, &instance0, ORB_PRIO_DEFAULT);
+		t.val = 2;
+		pub[1] = orb_advertise_multi(ORB_ID(orb_test_set), &t, &instance1, ORB_PRIO_DEFAULT);
+
+		if ((instance0 != 0) || (instance1 != 1)) {
+			test_fail("unexpected instances %d %d", instance0, instance1);
+			goto out;
+		}
+
+		// two publications post the semaphore once
+		if ((px4_sem_trywait(&sem) != 0) || (px4_sem_trywait(&sem) == 0)) {
+			test_fail("semaphore not posted exactly once");
+			goto out;
+		}
+
+		if (set.updated_mask() != 0b11) {
+			test_fail("updated mask mismatch");
+			goto out;
+		}
+
+		if (!set.update(1, &u) || (u.val != 2)) {
+			test_fail("update mismatch: %d expected %d", u.val, 2);
+			goto out;
+		}
+
+		// only member 1 wakes up
+		set.set_wakeup_mask(1u << 1);
+		orb_publish(ORB_ID(orb_test_set), pub[0], &t);
+
+		if (px4_sem_trywait(&sem) == 0) {
+			test_fail("semaphore posted by a non-waking member");
+			goto out;
+		}
+
+		orb_publish(ORB_ID(orb_test_set), pub[1], &t);
+
+		if (px4_sem_trywait(&sem) != 0) {
+			test_fail("semaphore not posted by a waking member");
+			goto out;
+		}
+
+		if (set.updated_mask() != 0b11) {
+			test_fail("updated mask mismatch");
+			goto out;
+		}
+
+		set.unregisterCallbacks();
+		orb_publish(ORB_ID(orb_test_set), pub[1], &t);
+
+		if ((px4_sem_trywait(&sem) == 0) || (set.updated_mask() != 0)) {
+			test_fail("update after unregistering");
+			goto out;
+		}
+
+		ret = test_note("PASS SubscriptionSet");
+	}
+
+out:
+
+	for (auto &p : pub) {
+		if (p != nullptr) {
+			orb_unadvertise(p);
+		}
+	}
+
+	px4_sem_destroy(&sem);
+	return ret;
+}
+
+int uORBTest::UnitTest::test_loan()
+{
+	test_note("Testing loans and borrows");
+
+	uORB::Publication<orb_test_large> pub{ORB_ID(orb_test_loan)};
+
+	orb_test_large *msg = pub.loan();
+
+	if (msg == nullptr) {
+		return test_fail("loan failed");
+	}
+
+	msg->val = 1;
+	msg->time = hrt_absolute_time();
+
+	if (!pub.publish_loan()) {
+		return test_fail("publish_loan failed");
+	}
+
+	uORB::Subscription sub{ORB_ID(orb_test_loan)};
+
+	if (!sub.updated()) {
+		return test_fail("update flag not set");
+	}
+
+	const orb_test_large *borrowed = static_cast<const orb_test_large *>(sub.borrow());
+
+	if (borrowed == nullptr) {
+		return test_fail("borrow failed");
+	}
+
+	if (borrowed->val != 1) {
+		return test_fail("borrow mismatch: %d expected %d", borrowed->val, 1);
+	}
+
+	if (!sub.borrow_valid()) {
+		return test_fail("borrow invalid");
+	}
+
+	if (sub.updated()) {
+		return test_fail("spurious updated flag");
+	}
+
+	// regular publications are rejected while a loan is outstanding
+	orb_test_large t{};
+	t.val = 2;
+
+	if (pub.loan() == nullptr) {
+		return test_fail("second loan failed");
+	}
+
+	if (pub.publish(t)) {
+		return test_fail("publish succeeded during loan");
+	}
+
+	pub.cancel_loan();
+
+	if (!pub.publish(t)) {
+		return test_fail("publish failed");
+	}
+
+	// the next loan reuses the slot of the borrowed message
+	if (sub.borrow_valid()) {
+		return test_fail("borrow still valid after overwrite");
+	}
+
+	orb_test_large u{};
+
+	if (!sub.copy(&u) || (u.val != t.val)) {
+		return test_fail("copy mismatch: %d expected %d", u.val, t.val);
+	}
+
+	return test_note("PASS loans and borrows");
+}
+
 int uORBTest::UnitTest::test_unadvertise()
 {
 	test_note("Testing unadvertise");
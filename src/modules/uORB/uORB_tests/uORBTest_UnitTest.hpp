@@ -45,6 +45,7 @@ struct orb_test {
 };
 ORB_DECLARE(orb_test);
 ORB_DECLARE(orb_multitest);
+ORB_DECLARE(orb_test_set);
 
 
 struct orb_test_medium {
@@ -63,6 +64,7 @@ struct orb_test_large {
 	char junk[512];
 };
 ORB_DECLARE(orb_test_large);
+ORB_DECLARE(orb_test_loan);
 
 
 namespace uORBTest
@@ -117,6 +119,10 @@ private:
 	int test_queue_poll_notify();
 	volatile int _num_messages_sent = 0;
 
+	int test_loan();
+
+	int test_subscription_set();
+
 	int test_fail(const char *fmt, ...);
 	int test_note(const char *fmt, ...);
 };
@@ -37,12 +37,15 @@
 #include "../uORBCommon.hpp"
 
 #include "uORBTest_UnitTest.hpp"
+#include "uORBTest_Benchmark.hpp"
+
+#include <stdlib.h>
 
 extern "C" { __EXPORT int uorb_tests_main(int argc, char *argv[]); }
 
 static void usage()
 {
-	PX4_INFO("Usage: uorb_tests [latency_test]");
+	PX4_INFO("Usage: uorb_tests [latency_test | bench [iterations]]");
 }
 
 int
@@ -83,6 +86,20 @@ uorb_tests_main(int argc, char *argv[])
 		}
 	}
 
+	/*
+	 * Run the benchmark suite, the results are printed as JSON lines.
+	 */
+	if (argc > 1 && !strcmp(argv[1], "bench")) {
+		const int iterations = (argc > 2) ? atoi(argv[2]) : 10000;
+
+		if (iterations <= 0) {
+			usage();
+			return -EINVAL;
+		}
+
+		return uORBTest::Benchmark::instance().run(iterations);
+	}
+
 	usage();
 	return -EINVAL;
 }
@@ -52,6 +52,7 @@
 #include <matrix/math.hpp>
 
 using matrix::wrap_pi;
+using namespace time_literals;
 
 namespace vmount
 {
@@ -64,14 +65,38 @@ OutputBase::OutputBase(const OutputConfig &output_config)
 
 void OutputBase::publish()
 {
+	const hrt_abstime now = hrt_absolute_time();
+
+	if (!_outputs_changed(_mount_orientation_last, _mount_orientation_last_publish, now, 1_s)) {
+		return;
+	}
+
 	mount_orientation_s mount_orientation{};
 
 	for (unsigned i = 0; i < 3; ++i) {
 		mount_orientation.attitude_euler_angle[i] = _angle_outputs[i];
+		_mount_orientation_last[i] = _angle_outputs[i];
 	}
 
-	mount_orientation.timestamp = hrt_absolute_time();
+	mount_orientation.timestamp = now;
 	_mount_orientation_pub.publish(mount_orientation);
+	_mount_orientation_last_publish = now;
+}
+
+bool OutputBase::_outputs_changed(const float last_outputs[3], hrt_abstime last_sent, const hrt_abstime &t,
+				  hrt_abstime keepalive_interval) const
+{
+	if (t - last_sent >= keepalive_interval) {
+		return true;
+	}
+
+	for (int i = 0; i < 3; ++i) {
+		if (fabsf(wrap_pi(_angle_outputs[i] - last_outputs[i])) > OUTPUT_ANGLE_THRESHOLD) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 float OutputBase::_calculate_pitch(double lon, double lat, float altitude,
@@ -178,18 +203,18 @@ void OutputBase::_calculate_output_angles(const hrt_abstime &t)
 		_angle_setpoints[i] += dt * _angle_speeds[i];
 	}
 
-	//get the output angles and stabilize if necessary
-	vehicle_attitude_s vehicle_attitude{};
-	matrix::Eulerf euler;
-
+	//get the output angles and stabilize if necessary, the euler angles are only recomputed on a new attitude
 	if (_stabilize[0] || _stabilize[1] || _stabilize[2]) {
-		_vehicle_attitude_sub.copy(&vehicle_attitude);
-		euler = matrix::Quatf(vehicle_attitude.q);
+		vehicle_attitude_s vehicle_attitude;
+
+		if (_vehicle_attitude_sub.update(&vehicle_attitude)) {
+			_vehicle_euler = matrix::Quatf(vehicle_attitude.q);
+		}
 	}
 
 	for (int i = 0; i < 3; ++i) {
 		if (_stabilize[i]) {
-			_angle_outputs[i] = _angle_setpoints[i] - euler(i);
+			_angle_outputs[i] = _angle_setpoints[i] - _vehicle_euler(i);
 
 		} else {
 			_angle_outputs[i] = _angle_setpoints[i];
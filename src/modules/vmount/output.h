@@ -42,6 +42,7 @@
 #include "common.h"
 #include <drivers/drv_hrt.h>
 #include <lib/ecl/geo/geo.h>
+#include <matrix/math.hpp>
 #include <uORB/Publication.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/topics/mount_orientation.h>
@@ -68,6 +69,7 @@ struct OutputConfig {
 
 	uint32_t mavlink_sys_id;	/**< Mavlink target system id for mavlink output */
 	uint32_t mavlink_comp_id;
+	hrt_abstime mavlink_interval;	/**< Minimum interval between mavlink mount control commands [us] */
 };
 
 
@@ -93,7 +95,7 @@ public:
 	/** report status to stdout */
 	virtual void print_status() = 0;
 
-	/** Publish _angle_outputs as a mount_orientation message. */
+	/** Publish _angle_outputs as a mount_orientation message (if they changed). */
 	void publish();
 
 protected:
@@ -118,10 +120,27 @@ protected:
 	/** calculate the _angle_outputs (with speed) and stabilize if needed */
 	void _calculate_output_angles(const hrt_abstime &t);
 
+	/**
+	 * Check if the outputs need to be sent
+	 * @param last_outputs outputs sent last time
+	 * @param last_sent time the outputs were sent last time
+	 * @return true if an output angle changed by more than OUTPUT_ANGLE_THRESHOLD or the last outputs are
+	 *         older than keepalive_interval
+	 */
+	bool _outputs_changed(const float last_outputs[3], hrt_abstime last_sent, const hrt_abstime &t,
+			      hrt_abstime keepalive_interval) const;
+
+	static constexpr float OUTPUT_ANGLE_THRESHOLD = 0.0035f; ///< [rad] (0.2 deg)
+
 	float _angle_outputs[3] = { 0.f, 0.f, 0.f }; ///< calculated output angles (roll, pitch, yaw) [rad]
 	hrt_abstime _last_update;
 
 private:
+	matrix::Eulerf _vehicle_euler{0.f, 0.f, 0.f}; ///< vehicle attitude, updated when stabilizing
+
+	float _mount_orientation_last[3] = { 0.f, 0.f, 0.f };
+	hrt_abstime _mount_orientation_last_publish{0};
+
 	uORB::Subscription _vehicle_attitude_sub{ORB_ID(vehicle_attitude)};
 	uORB::Subscription _vehicle_global_position_sub{ORB_ID(vehicle_global_position)};
 
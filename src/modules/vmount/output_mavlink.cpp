@@ -94,6 +94,13 @@ int OutputMavlink::update(const ControlData *control_data)
 
 	hrt_abstime t = hrt_absolute_time();
 	_calculate_output_angles(t);
+	_last_update = t;
+
+	// the mount control command is sent on a change (or to keep the mount alive), at most at the rate the mount accepts
+	if ((t - _last_control_sent < _config.mavlink_interval)
+	    || !_outputs_changed(_last_outputs, _last_control_sent, t, KEEPALIVE_INTERVAL)) {
+		return 0;
+	}
 
 	vehicle_command.timestamp = t;
 	vehicle_command.command = vehicle_command_s::VEHICLE_CMD_DO_MOUNT_CONTROL;
@@ -107,7 +114,11 @@ int OutputMavlink::update(const ControlData *control_data)
 
 	_vehicle_command_pub.publish(vehicle_command);
 
-	_last_update = t;
+	for (int i = 0; i < 3; ++i) {
+		_last_outputs[i] = _angle_outputs[i];
+	}
+
+	_last_control_sent = t;
 
 	return 0;
 }
@@ -62,7 +62,12 @@ public:
 
 private:
 
+	static constexpr hrt_abstime KEEPALIVE_INTERVAL = 1000000; ///< [us]
+
 	uORB::PublicationQueued<vehicle_command_s> _vehicle_command_pub{ORB_ID(vehicle_command)};
+
+	float _last_outputs[3] = { 0.f, 0.f, 0.f };
+	hrt_abstime _last_control_sent{0};
 };
 
 
@@ -64,6 +64,13 @@ int OutputRC::update(const ControlData *control_data)
 
 	hrt_abstime t = hrt_absolute_time();
 	_calculate_output_angles(t);
+	_last_update = t;
+
+	// only publish on a change, and at a low rate to keep the outputs alive
+	if ((_retract_gimbal == _last_retract_gimbal)
+	    && !_outputs_changed(_last_outputs, _last_publish, t, KEEPALIVE_INTERVAL)) {
+		return 0;
+	}
 
 	actuator_controls_s actuator_controls{};
 	actuator_controls.timestamp = hrt_absolute_time();
@@ -75,7 +82,12 @@ int OutputRC::update(const ControlData *control_data)
 
 	_actuator_controls_pub.publish(actuator_controls);
 
-	_last_update = t;
+	for (int i = 0; i < 3; ++i) {
+		_last_outputs[i] = _angle_outputs[i];
+	}
+
+	_last_retract_gimbal = _retract_gimbal;
+	_last_publish = t;
 
 	return 0;
 }
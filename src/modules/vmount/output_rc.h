@@ -65,7 +65,13 @@ public:
 private:
 	uORB::Publication <actuator_controls_s>	_actuator_controls_pub{ORB_ID(actuator_controls_2)};
 
+	static constexpr hrt_abstime KEEPALIVE_INTERVAL = 100000; ///< [us]
+
 	bool _retract_gimbal = true;
+
+	float _last_outputs[3] = { 0.f, 0.f, 0.f };
+	bool _last_retract_gimbal = true;
+	hrt_abstime _last_publish{0};
 };
 
 
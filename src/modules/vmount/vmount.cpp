@@ -52,6 +52,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <systemlib/err.h>
+#include <lib/mathlib/mathlib.h>
 #include <lib/parameters/param.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/tasks.h>
@@ -88,6 +89,7 @@ struct Parameters {
 	int32_t mnt_mode_out;
 	int32_t mnt_mav_sysid;
 	int32_t mnt_mav_compid;
+	int32_t mnt_mav_rate;
 	float mnt_ob_lock_mode;
 	float mnt_ob_norm_mode;
 	int32_t mnt_man_pitch;
@@ -109,6 +111,7 @@ struct Parameters {
 		       mnt_mode_out != p.mnt_mode_out ||
 		       mnt_mav_sysid != p.mnt_mav_sysid ||
 		       mnt_mav_compid != p.mnt_mav_compid ||
+		       mnt_mav_rate != p.mnt_mav_rate ||
 		       fabsf(mnt_ob_lock_mode - p.mnt_ob_lock_mode) > 1e-6f ||
 		       fabsf(mnt_ob_norm_mode - p.mnt_ob_norm_mode) > 1e-6f ||
 		       mnt_man_pitch != p.mnt_man_pitch ||
@@ -131,6 +134,7 @@ struct ParameterHandles {
 	param_t mnt_mode_out;
 	param_t mnt_mav_sysid;
 	param_t mnt_mav_compid;
+	param_t mnt_mav_rate;
 	param_t mnt_ob_lock_mode;
 	param_t mnt_ob_norm_mode;
 	param_t mnt_man_pitch;
@@ -236,6 +240,7 @@ static int vmount_thread_main(int argc, char *argv[])
 			output_config.yaw_offset = params.mnt_off_yaw * M_DEG_TO_RAD_F;
 			output_config.mavlink_sys_id = params.mnt_mav_sysid;
 			output_config.mavlink_comp_id = params.mnt_mav_compid;
+			output_config.mavlink_interval = 1000000 / math::constrain(params.mnt_mav_rate, 1, 100);
 
 			bool alloc_failed = false;
 			thread_data.input_objs_len = 1;
@@ -534,6 +539,7 @@ void update_params(ParameterHandles &param_handles, Parameters &params, bool &go
 	param_get(param_handles.mnt_mode_out, &params.mnt_mode_out);
 	param_get(param_handles.mnt_mav_sysid, &params.mnt_mav_sysid);
 	param_get(param_handles.mnt_mav_compid, &params.mnt_mav_compid);
+	param_get(param_handles.mnt_mav_rate, &params.mnt_mav_rate);
 	param_get(param_handles.mnt_ob_lock_mode, &params.mnt_ob_lock_mode);
 	param_get(param_handles.mnt_ob_norm_mode, &params.mnt_ob_norm_mode);
 	param_get(param_handles.mnt_man_pitch, &params.mnt_man_pitch);
@@ -556,6 +562,7 @@ bool get_params(ParameterHandles &param_handles, Parameters &params)
 	param_handles.mnt_mode_out = param_find("MNT_MODE_OUT");
 	param_handles.mnt_mav_sysid = param_find("MNT_MAV_SYSID");
 	param_handles.mnt_mav_compid = param_find("MNT_MAV_COMPID");
+	param_handles.mnt_mav_rate = param_find("MNT_MAV_RATE");
 	param_handles.mnt_ob_lock_mode = param_find("MNT_OB_LOCK_MODE");
 	param_handles.mnt_ob_norm_mode = param_find("MNT_OB_NORM_MODE");
 	param_handles.mnt_man_pitch = param_find("MNT_MAN_PITCH");
@@ -573,6 +580,7 @@ bool get_params(ParameterHandles &param_handles, Parameters &params)
 	    param_handles.mnt_mode_out == PARAM_INVALID ||
 	    param_handles.mnt_mav_sysid == PARAM_INVALID ||
 	    param_handles.mnt_mav_compid == PARAM_INVALID ||
+	    param_handles.mnt_mav_rate == PARAM_INVALID ||
 	    param_handles.mnt_ob_lock_mode == PARAM_INVALID ||
 	    param_handles.mnt_ob_norm_mode == PARAM_INVALID ||
 	    param_handles.mnt_man_pitch == PARAM_INVALID ||
@@ -90,6 +90,19 @@ PARAM_DEFINE_INT32(MNT_MAV_SYSID, 1);
 */
 PARAM_DEFINE_INT32(MNT_MAV_COMPID, 154);
 
+/**
+* Maximum rate of the Mavlink mount control commands
+*
+* If MNT_MODE_OUT is MAVLINK, the mount control commands are only sent when the angles change
+* (and once per second), at most at this rate. Set it to the rate the mount accepts.
+*
+* @unit Hz
+* @min 1
+* @max 100
+* @group Mount
+*/
+PARAM_DEFINE_INT32(MNT_MAV_RATE, 20);
+
 /**
 * Mixer value for selecting normal mode
 * if required by the gimbal (only in AUX output mode)
@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/boot_profile.h>
+#include <px4_platform_common/module.h>
+
+static void	usage();
+
+extern "C" {
+	__EXPORT int boot_profile_main(int argc, char *argv[]);
+}
+
+int
+boot_profile_main(int argc, char *argv[])
+{
+	if (argc < 2 || !strcmp(argv[1], "status")) {
+		px4_boot_profile_print();
+		return 0;
+
+	} else if (!strcmp(argv[1], "begin_parallel")) {
+		px4_parallel_start_begin();
+		return 0;
+
+	} else if (!strcmp(argv[1], "end_parallel")) {
+		return (px4_parallel_start_end() == 0) ? 0 : 1;
+	}
+
+	usage();
+
+	return 1;
+}
+
+static void
+usage()
+{
+
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+
+Shows the boot profile: the start time and duration of every module start, and boot events such as the time
+the vehicle first became ready to arm.
+
+It also groups module starts in the startup script: the start commands between 'begin_parallel' and
+'end_parallel' return immediately and the modules are started concurrently, 'end_parallel' waits for all of
+them. Only use this for modules that do not depend on each other, and whose start result is not checked (the
+start command always succeeds within a group).
+
+### Examples
+$ boot_profile begin_parallel
+$ dataman start
+$ load_mon start
+$ boot_profile end_parallel
+
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME("boot_profile", "system");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "Print the boot profile (default)");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("begin_parallel", "Start the following modules concurrently");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("end_parallel", "Wait for the started modules and end concurrent starting");
+}
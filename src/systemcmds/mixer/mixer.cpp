@@ -117,6 +117,9 @@ usage(const char *reason)
 ### Description
 Load or append mixer files to the ESC driver.
 
+Both text mixer files and precompiled binary mixer files (see Tools/px_mixer_binary.py) are supported.
+The binary format requires the driver to support MIXERIOCLOADBIN.
+
 Note that the driver must support the used ioctl's, which is the case on NuttX, but for example not on RPi.
 )DESCR_STR");
 
@@ -153,13 +156,31 @@ load(const char *devname, const char *fname, bool append)
 
 	char buf[2048];
 
+	/* precompiled binary mixers are passed as is, otherwise fall back to the text format */
+	int ret = load_mixer_file_binary(fname, (uint8_t *)&buf[0], sizeof(buf));
+
+	if (ret < 0) {
+		PX4_ERR("can't load mixer file: %s", fname);
+		return 1;
+
+	} else if (ret > 0) {
+		ret = px4_ioctl(dev, MIXERIOCLOADBIN, (unsigned long)buf);
+
+		if (ret < 0) {
+			PX4_ERR("failed to load binary mixers from %s", fname);
+			return 1;
+		}
+
+		return 0;
+	}
+
 	if (load_mixer_file(fname, &buf[0], sizeof(buf)) < 0) {
 		PX4_ERR("can't load mixer file: %s", fname);
 		return 1;
 	}
 
 	/* Pass the buffer to the device */
-	int ret = px4_ioctl(dev, MIXERIOCLOADBUF, (unsigned long)buf);
+	ret = px4_ioctl(dev, MIXERIOCLOADBUF, (unsigned long)buf);
 
 	if (ret < 0) {
 		PX4_ERR("failed to load mixers from %s", fname);
@@ -37,8 +37,16 @@
  * SD Card benchmarking
  */
 
+#if defined(__PX4_LINUX) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // fallocate()
+#endif
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -46,14 +54,35 @@
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/getopt.h>
 #include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
 
 #include <drivers/drv_hrt.h>
 
+#define LOG_WRITE_CHUNK 4096 ///< the logger writes multiples of this (LogWriterFile::_min_write_chunk)
+
+/** Latency histogram with power of 2 bins: [0, 0.25 ms), [0.25 ms, 0.5 ms), ..., [256 ms, inf) */
+#define LATENCY_BINS 12
+
+struct latency_hist_s {
+	unsigned bins[LATENCY_BINS];
+	unsigned count;
+	unsigned max_us;
+};
+
 static void	usage(void);
 
 /** sequential write speed test */
 static void	write_test(int fd, uint8_t *block, int block_size);
 
+/** write pattern of the logger (LogWriterFile) */
+static void	log_test(int fd, uint8_t *block, int buffer_size);
+
+/** reserve the space of the benchmark file, like the logger does with SDLOG_PREALLOC */
+static void	preallocate(int fd, uint8_t *block, int block_size);
+
+/** small writes with fsync (dataman and parameters) to another file while the benchmark runs */
+static void	*concurrent_writer(void *arg);
+
 /**
  * Measure the time for fsync.
  * @param fd
@@ -61,39 +90,90 @@ static void	write_test(int fd, uint8_t *block, int block_size);
  */
 static inline unsigned int time_fsync(int fd);
 
+static void	latency_add(struct latency_hist_s *hist, unsigned us);
+static void	latency_print(const char *name, const struct latency_hist_s *hist);
+
 __EXPORT int	sd_bench_main(int argc, char *argv[]);
 
 static const char *BENCHMARK_FILE = PX4_STORAGEDIR"/benchmark.tmp";
+static const char *CONCURRENT_FILE = PX4_STORAGEDIR"/benchmark_concurrent.tmp";
 
 static int num_runs; ///< number of runs
 static int run_duration; ///< duration of a single run [ms]
 static bool synchronized; ///< call fsync after each block?
+static int log_rate; ///< data rate of the logger profile [KB/s], 0 = as fast as possible
+static int fsync_interval; ///< fsync interval of the logger profile [ms], 0 = at the end of each run
+static int preallocate_mb; ///< size of the file preallocation [MB]
+static volatile bool concurrent_run; ///< keep running the concurrent writer?
+
+static struct latency_hist_s write_hist;
+static struct latency_hist_s fsync_hist;
+static struct latency_hist_s concurrent_hist;
 
 static void
 usage()
 {
-	PRINT_MODULE_DESCRIPTION("Test the speed of an SD Card");
+	PRINT_MODULE_DESCRIPTION(
+		"Test the speed of an SD Card.\n"
+		"\n"
+		"The `seq` profile writes fixed size blocks as fast as possible. The `log` profile mimics the logger: "
+		"it writes multiples of 4 KB as they accumulate in a buffer of the given size (-b), either as fast as "
+		"possible or at a given data rate (-t), in which case data that does not fit into the buffer is counted "
+		"as dropouts. fsync is called periodically (SDLOG_FSYNC_INT) and the file can be preallocated "
+		"(SDLOG_PREALLOC). With -c, small writes with fsync (like dataman and parameter saves) go to another "
+		"file concurrently.\n"
+		"\n"
+		"Latency histograms of the writes and fsync calls are printed at the end.\n"
+		"\n"
+		"### Examples\n"
+		"Qualify a card for logging at 200 KB/s with the default logger settings:\n"
+		"$ sd_bench -p log -t 200 -c\n");
 
 	PRINT_MODULE_USAGE_NAME_SIMPLE("sd_bench", "command");
-	PRINT_MODULE_USAGE_PARAM_INT('b', 4096, 1, 1000000, "Block size for each read/write", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('p', "seq", "seq|log", "Workload profile", true);
+	PRINT_MODULE_USAGE_PARAM_INT('b', 4096, 1, 1000000, "Block size for each read/write (log profile: buffer size, default 12288)", true);
 	PRINT_MODULE_USAGE_PARAM_INT('r', 5, 1, 1000, "Number of runs", true);
 	PRINT_MODULE_USAGE_PARAM_INT('d', 2000, 1, 100000, "Duration of a run in ms", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('s', "Call fsync after each block (default=at end of each run)", true);
+	PRINT_MODULE_USAGE_PARAM_INT('t', 0, 0, 100000, "log profile: data rate in KB/s (0=as fast as possible)", true);
+	PRINT_MODULE_USAGE_PARAM_INT('f', 1000, 0, 100000, "log profile: fsync interval in ms (0=at end of each run)", true);
+	PRINT_MODULE_USAGE_PARAM_INT('a', 0, 0, 10000, "Preallocate the file (MB)", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('c', "Concurrent small writes with fsync to another file", true);
 }
 
 int
 sd_bench_main(int argc, char *argv[])
 {
-	int block_size = 4096;
+	int block_size = 0;
 	int myoptind = 1;
 	int ch;
 	const char *myoptarg = NULL;
+	bool log_profile = false;
+	bool concurrent = false;
 	synchronized = false;
 	num_runs = 5;
 	run_duration = 2000;
+	log_rate = 0;
+	fsync_interval = 1000;
+	preallocate_mb = 0;
 
-	while ((ch = px4_getopt(argc, argv, "b:r:d:s", &myoptind, &myoptarg)) != EOF) {
+	memset(&write_hist, 0, sizeof(write_hist));
+	memset(&fsync_hist, 0, sizeof(fsync_hist));
+	memset(&concurrent_hist, 0, sizeof(concurrent_hist));
+
+	while ((ch = px4_getopt(argc, argv, "p:b:r:d:st:f:a:c", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
+		case 'p':
+			if (!strcmp(myoptarg, "log")) {
+				log_profile = true;
+
+			} else if (strcmp(myoptarg, "seq")) {
+				usage();
+				return -1;
+			}
+
+			break;
+
 		case 'b':
 			block_size = strtol(myoptarg, NULL, 0);
 			break;
@@ -110,6 +190,22 @@ sd_bench_main(int argc, char *argv[])
 			synchronized = true;
 			break;
 
+		case 't':
+			log_rate = strtol(myoptarg, NULL, 0);
+			break;
+
+		case 'f':
+			fsync_interval = strtol(myoptarg, NULL, 0);
+			break;
+
+		case 'a':
+			preallocate_mb = strtol(myoptarg, NULL, 0);
+			break;
+
+		case 'c':
+			concurrent = true;
+			break;
+
 		default:
 			usage();
 			return -1;
@@ -117,7 +213,15 @@ sd_bench_main(int argc, char *argv[])
 		}
 	}
 
-	if (block_size <= 0 || num_runs <= 0) {
+	if (block_size == 0) {
+		block_size = log_profile ? 12 * 1024 : 4096;
+
+	} else if (log_profile) {
+		// the logger buffer is a multiple of the write chunk
+		block_size = (block_size + LOG_WRITE_CHUNK - 1) / LOG_WRITE_CHUNK * LOG_WRITE_CHUNK;
+	}
+
+	if (block_size <= 0 || num_runs <= 0 || log_rate < 0 || fsync_interval < 0 || preallocate_mb < 0) {
 		PX4_ERR("invalid argument");
 		return -1;
 	}
@@ -142,8 +246,44 @@ sd_bench_main(int argc, char *argv[])
 		block[i] = (uint8_t)i;
 	}
 
-	PX4_INFO("Using block size = %i bytes, sync=%i", block_size, (int)synchronized);
-	write_test(bench_fd, block, block_size);
+	if (preallocate_mb > 0) {
+		preallocate(bench_fd, block, block_size);
+	}
+
+	pthread_t concurrent_thread;
+
+	if (concurrent) {
+		concurrent_run = true;
+
+		if (pthread_create(&concurrent_thread, NULL, concurrent_writer, NULL) != 0) {
+			PX4_ERR("Failed to start the concurrent writer");
+			concurrent = false;
+		}
+	}
+
+	if (log_profile) {
+		PX4_INFO("Using buffer size = %i bytes, preallocate=%i MB, concurrent=%i", block_size, preallocate_mb, (int)concurrent);
+		log_test(bench_fd, block, block_size);
+
+	} else {
+		PX4_INFO("Using block size = %i bytes, sync=%i, preallocate=%i MB, concurrent=%i", block_size, (int)synchronized,
+			 preallocate_mb, (int)concurrent);
+		write_test(bench_fd, block, block_size);
+	}
+
+	if (concurrent) {
+		concurrent_run = false;
+		pthread_join(concurrent_thread, NULL);
+	}
+
+	PX4_INFO("");
+	PX4_INFO("Latency:");
+	latency_print("write", &write_hist);
+	latency_print("fsync", &fsync_hist);
+
+	if (concurrent) {
+		latency_print("concurrent write+fsync", &concurrent_hist);
+	}
 
 	free(block);
 	close(bench_fd);
@@ -156,7 +296,138 @@ unsigned int time_fsync(int fd)
 {
 	hrt_abstime fsync_start = hrt_absolute_time();
 	fsync(fd);
-	return hrt_elapsed_time(&fsync_start) / 1000;
+	const unsigned fsync_time_us = hrt_elapsed_time(&fsync_start);
+	latency_add(&fsync_hist, fsync_time_us);
+	return fsync_time_us / 1000;
+}
+
+static unsigned next_random(unsigned *state)
+{
+	*state = *state * 1103515245u + 12345u;
+	return *state >> 16;
+}
+
+void latency_add(struct latency_hist_s *hist, unsigned us)
+{
+	int bin = 0;
+
+	while (bin < LATENCY_BINS - 1 && us >= (250u << bin)) {
+		++bin;
+	}
+
+	hist->bins[bin]++;
+	hist->count++;
+
+	if (us > hist->max_us) {
+		hist->max_us = us;
+	}
+}
+
+/** upper bound of the bin containing the given percentile, at most the maximum [ms] */
+static double latency_percentile(const struct latency_hist_s *hist, double percentile)
+{
+	unsigned cumulative = 0;
+
+	for (int bin = 0; bin < LATENCY_BINS - 1; ++bin) {
+		cumulative += hist->bins[bin];
+
+		if (cumulative >= percentile * hist->count) {
+			const unsigned limit_us = 250u << bin;
+			return (limit_us < hist->max_us ? limit_us : hist->max_us) / 1000.;
+		}
+	}
+
+	return hist->max_us / 1000.;
+}
+
+void latency_print(const char *name, const struct latency_hist_s *hist)
+{
+	if (hist->count == 0) {
+		return;
+	}
+
+	PX4_INFO("  %s: %u calls, p50 <= %.2lf ms, p99 <= %.2lf ms, max %.2lf ms", name, hist->count,
+		 latency_percentile(hist, 0.5), latency_percentile(hist, 0.99), hist->max_us / 1000.);
+
+	for (int bin = 0; bin < LATENCY_BINS; ++bin) {
+		if (hist->bins[bin] == 0) {
+			continue;
+		}
+
+		if (bin < LATENCY_BINS - 1) {
+			PX4_INFO("    < %7.2lf ms: %6u (%5.1lf%%)", (250u << bin) / 1000., hist->bins[bin],
+				 100. * hist->bins[bin] / hist->count);
+
+		} else {
+			PX4_INFO("    >=%7.2lf ms: %6u (%5.1lf%%)", (250u << (bin - 1)) / 1000., hist->bins[bin],
+				 100. * hist->bins[bin] / hist->count);
+		}
+	}
+}
+
+void preallocate(int fd, uint8_t *block, int block_size)
+{
+	const int64_t size = (int64_t)preallocate_mb * 1024 * 1024;
+	hrt_abstime start = hrt_absolute_time();
+
+#if defined(__PX4_LINUX) && defined(FALLOC_FL_KEEP_SIZE)
+
+	if (fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, size) != 0) {
+		PX4_WARN("preallocation failed (%i)", errno);
+	}
+
+#else
+	// no fallocate: write the file once, the runs then overwrite already allocated clusters
+	for (int64_t pos = 0; pos < size; pos += block_size) {
+		if (write(fd, block, block_size) != block_size) {
+			PX4_WARN("preallocation failed (%i)", errno);
+			break;
+		}
+	}
+
+	fsync(fd);
+	lseek(fd, 0, SEEK_SET);
+#endif
+
+	PX4_INFO("Preallocated %i MB in %.2lf s", preallocate_mb, hrt_elapsed_time(&start) / 1.e6);
+}
+
+void *concurrent_writer(void *arg)
+{
+	int fd = open(CONCURRENT_FILE, O_CREAT | O_WRONLY | O_TRUNC, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		PX4_ERR("Can't open %s", CONCURRENT_FILE);
+		return NULL;
+	}
+
+	uint8_t record[128];
+	memset(record, 0x55, sizeof(record));
+	unsigned seed = 2;
+
+	for (int i = 0; concurrent_run; ++i) {
+		hrt_abstime start = hrt_absolute_time();
+
+		// parameter save: rewrite the whole file (2 KB), dataman: single record at a random position
+		const int num_records = (i % 10 == 0) ? 16 : 1;
+		lseek(fd, num_records == 1 ? (next_random(&seed) % 16) * sizeof(record) : 0, SEEK_SET);
+
+		for (int k = 0; k < num_records; ++k) {
+			if (write(fd, record, sizeof(record)) != (ssize_t)sizeof(record)) {
+				PX4_ERR("Concurrent write error");
+				concurrent_run = false;
+			}
+		}
+
+		fsync(fd);
+		latency_add(&concurrent_hist, hrt_elapsed_time(&start));
+
+		px4_usleep(100000);
+	}
+
+	close(fd);
+	unlink(CONCURRENT_FILE);
+	return NULL;
 }
 
 void write_test(int fd, uint8_t *block, int block_size)
@@ -176,7 +447,9 @@ void write_test(int fd, uint8_t *block, int block_size)
 
 			hrt_abstime write_start = hrt_absolute_time();
 			size_t written = write(fd, block, block_size);
-			unsigned int write_time = hrt_elapsed_time(&write_start) / 1000;
+			const unsigned write_time_us = hrt_elapsed_time(&write_start);
+			unsigned int write_time = write_time_us / 1000;
+			latency_add(&write_hist, write_time_us);
 
 			if (write_time > max_write_time) {
 				max_write_time = write_time;
@@ -211,3 +484,88 @@ void write_test(int fd, uint8_t *block, int block_size)
 
 	PX4_INFO("  Avg   : %8.2lf KB/s", (double)block_size * total_blocks / total_elapsed / 1024.);
 }
+
+void log_test(int fd, uint8_t *block, int buffer_size)
+{
+	PX4_INFO("");
+	PX4_INFO("Testing Logger Write Pattern (rate: %i KB/s, fsync interval: %i ms)...", log_rate, fsync_interval);
+	double total_elapsed = 0.;
+	uint64_t total_written = 0;
+	uint64_t total_dropped = 0;
+	unsigned seed = 1;
+
+	for (int run = 0; run < num_runs; ++run) {
+		hrt_abstime start = hrt_absolute_time();
+		hrt_abstime last_fsync = start;
+		uint64_t consumed = 0; // bytes written or dropped
+		uint64_t written_bytes = 0;
+		uint64_t dropped_bytes = 0;
+		unsigned int dropouts = 0;
+		unsigned int max_write_time = 0;
+		unsigned int fsync_time = 0;
+
+		while ((int64_t)hrt_elapsed_time(&start) < run_duration * 1000) {
+			int write_size;
+
+			if (log_rate > 0) {
+				// data accumulates in the buffer at the given rate, what does not fit is dropped
+				const uint64_t produced = hrt_elapsed_time(&start) * log_rate * 1024 / 1000000;
+				uint64_t available = produced - consumed;
+
+				if (available > (uint64_t)buffer_size) {
+					dropped_bytes += available - buffer_size;
+					consumed += available - buffer_size;
+					available = buffer_size;
+					++dropouts;
+				}
+
+				if (available < LOG_WRITE_CHUNK) {
+					// the writer thread is woken up once there is a full chunk
+					px4_usleep((LOG_WRITE_CHUNK - available) * 1000000 / (log_rate * 1024) + 1);
+					continue;
+				}
+
+				write_size = available - available % LOG_WRITE_CHUNK;
+
+			} else {
+				// whatever accumulated while the previous write was blocking
+				write_size = LOG_WRITE_CHUNK * (1 + next_random(&seed) % (buffer_size / LOG_WRITE_CHUNK));
+			}
+
+			hrt_abstime write_start = hrt_absolute_time();
+			ssize_t written = write(fd, block, write_size);
+			const unsigned write_time_us = hrt_elapsed_time(&write_start);
+			latency_add(&write_hist, write_time_us);
+
+			if (write_time_us / 1000 > max_write_time) {
+				max_write_time = write_time_us / 1000;
+			}
+
+			if ((int)written != write_size) {
+				PX4_ERR("Write error");
+				return;
+			}
+
+			consumed += write_size;
+			written_bytes += write_size;
+
+			if (fsync_interval > 0 && hrt_elapsed_time(&last_fsync) > (hrt_abstime)fsync_interval * 1000) {
+				last_fsync = hrt_absolute_time();
+				fsync_time += time_fsync(fd);
+			}
+		}
+
+		fsync_time += time_fsync(fd);
+
+		//report
+		double elapsed = hrt_elapsed_time(&start) / 1.e6;
+		PX4_INFO("  Run %2i: %8.2lf KB/s, max write time: %i ms, fsync: %i ms, dropouts: %i (%" PRIu64 " KB)", run,
+			 written_bytes / elapsed / 1024., max_write_time, fsync_time, dropouts, dropped_bytes / 1024);
+
+		total_elapsed += elapsed;
+		total_written += written_bytes;
+		total_dropped += dropped_bytes;
+	}
+
+	PX4_INFO("  Avg   : %8.2lf KB/s, dropped: %" PRIu64 " KB", total_written / total_elapsed / 1024., total_dropped / 1024);
+}
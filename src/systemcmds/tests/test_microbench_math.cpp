@@ -45,6 +45,7 @@
 
 #include <drivers/drv_hrt.h>
 #include <perf/perf_counter.h>
+#include <px4_platform_common/defines.h>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/micro_hal.h>
 
@@ -103,6 +104,8 @@ private:
 	bool time_32bit_integers();
 	bool time_64bit_integers();
 
+	bool time_hot_path();
+
 	void reset();
 
 	float f32;
@@ -125,6 +128,8 @@ private:
 
 	uint64_t u_64;
 	uint64_t u_64_out;
+
+	float f32_array[16];
 };
 
 bool MicroBenchMath::run_tests()
@@ -137,6 +142,7 @@ bool MicroBenchMath::run_tests()
 	ut_run_test(time_16bit_integers);
 	ut_run_test(time_32bit_integers);
 	ut_run_test(time_64bit_integers);
+	ut_run_test(time_hot_path);
 
 	return (_tests_failed == 0);
 }
@@ -173,6 +179,43 @@ void MicroBenchMath::reset()
 
 	u_64 = rand();
 	u_64_out = rand();
+
+	for (auto &f : f32_array) {
+		f = random(-1.f, 1.f);
+	}
+}
+
+// same code placed in flash and in ITCM RAM (PX4_HOT, if supported by the board)
+static __attribute__((noinline)) float biquad_flash(const float *in, int n)
+{
+	float d1 = 0.f;
+	float d2 = 0.f;
+	float out = 0.f;
+
+	for (int i = 0; i < n; i++) {
+		const float d0 = in[i] - 0.3695f * d1 - 0.1958f * d2;
+		out = 0.2066f * d0 + 0.4131f * d1 + 0.2066f * d2;
+		d2 = d1;
+		d1 = d0;
+	}
+
+	return out;
+}
+
+static PX4_HOT float biquad_hot(const float *in, int n)
+{
+	float d1 = 0.f;
+	float d2 = 0.f;
+	float out = 0.f;
+
+	for (int i = 0; i < n; i++) {
+		const float d0 = in[i] - 0.3695f * d1 - 0.1958f * d2;
+		out = 0.2066f * d0 + 0.4131f * d1 + 0.2066f * d2;
+		d2 = d1;
+		d1 = d0;
+	}
+
+	return out;
 }
 
 ut_declare_test_c(test_microbench_math, MicroBenchMath)
@@ -268,4 +311,12 @@ bool MicroBenchMath::time_64bit_integers()
 	return true;
 }
 
+bool MicroBenchMath::time_hot_path()
+{
+	PERF("biquad x16 (flash)", f32_out = biquad_flash(f32_array, 16), 1000);
+	PERF("biquad x16 (PX4_HOT)", f32_out = biquad_hot(f32_array, 16), 1000);
+
+	return true;
+}
+
 } // namespace MicroBenchMath
@@ -44,6 +44,7 @@
 
 #include <px4_platform_common/px4_config.h>
 #include <lib/mixer/MixerGroup.hpp>
+#include <lib/mixer/Mixer/MixerBinary.hpp>
 #include <lib/mixer/mixer_load.h>
 #include <output_limit/output_limit.h>
 #include <drivers/drv_hrt.h>
@@ -105,6 +106,8 @@ private:
 	bool loadQuadTest();
 	bool loadComplexTest();
 	bool loadAllTest();
+	bool loadBinaryTest();
+	bool loadArenaTest();
 	bool load_mixer(const char *filename, unsigned expected_count, bool verbose = false);
 	bool load_mixer(const char *filename, const char *buf, unsigned loaded, unsigned expected_count,
 			const unsigned chunk_size, bool verbose);
@@ -120,6 +123,8 @@ bool MixerTest::run_tests()
 	ut_run_test(loadVTOL2Test);
 	ut_run_test(loadComplexTest);
 	ut_run_test(loadAllTest);
+	ut_run_test(loadBinaryTest);
+	ut_run_test(loadArenaTest);
 	ut_run_test(mixerTest);
 
 	return (_tests_failed == 0);
@@ -221,6 +226,171 @@ bool MixerTest::loadAllTest()
 	return true;
 }
 
+// mixers of all types, the binary equivalent is assembled in loadBinaryTest()
+static const char *test_mixers =
+	"R: 4x 10000 10000 10000 0\n"
+	"M: 2\n"
+	"O: 10000 10000 0 -10000 10000\n"
+	"S: 0 0 5000 5000 0 -10000 10000\n"
+	"S: 0 3 -10000 -10000 2000 -10000 10000\n"
+	"Z:\n"
+	"H: 3\n"
+	"T: 0 3000 6000 8000 10000\n"
+	"P: 500 1500 2500 3500 4500\n"
+	"S: 0 10000 10000 0 -8000 8000\n"
+	"S: 140 10000 10000 0 -8000 8000\n"
+	"S: 220 10000 10000 0 -8000 8000\n";
+
+static unsigned append_binary_record(uint8_t *blob, unsigned offset, char type, uint8_t count, const void *payload,
+				     unsigned payload_size)
+{
+	mixer_binary_record_s record{};
+	record.type = type;
+	record.count = count;
+	record.size = (sizeof(record) + payload_size + 3) & ~3u;
+
+	memset(&blob[offset], 0, record.size);
+	memcpy(&blob[offset], &record, sizeof(record));
+	memcpy(&blob[offset + sizeof(record)], payload, payload_size);
+
+	return offset + record.size;
+}
+
+bool MixerTest::loadBinaryTest()
+{
+
+	uint8_t blob[256];
+	unsigned size = sizeof(mixer_binary_header_s);
+
+	mixer_binary_multirotor_s multirotor{};
+	strncpy(multirotor.geometry, "4x", sizeof(multirotor.geometry));
+	multirotor.roll_scale = 10000;
+	multirotor.pitch_scale = 10000;
+	multirotor.yaw_scale = 10000;
+	multirotor.idle_speed = 0;
+	size = append_binary_record(blob, size, 'R', 0, &multirotor, sizeof(multirotor));
+
+	struct {
+		mixer_binary_scaler_s output_scaler;
+		mixer_binary_control_s controls[2];
+	} simple{{10000, 10000, 0, -10000, 10000}, {{0, 0, {5000, 5000, 0, -10000, 10000}}, {0, 3, {-10000, -10000, 2000, -10000, 10000}}}};
+	size = append_binary_record(blob, size, 'M', 2, &simple, sizeof(simple));
+
+	size = append_binary_record(blob, size, 'Z', 0, nullptr, 0);
+
+	struct {
+		mixer_binary_helicopter_s curves;
+		mixer_binary_heli_servo_s servos[3];
+	} helicopter{{{0, 3000, 6000, 8000, 10000}, {500, 1500, 2500, 3500, 4500}},
+		{{0, 10000, 10000, 0, -8000, 8000}, {140, 10000, 10000, 0, -8000, 8000}, {220, 10000, 10000, 0, -8000, 8000}}};
+	size = append_binary_record(blob, size, 'H', 3, &helicopter, sizeof(helicopter));
+
+	mixer_binary_header_s header{};
+	header.magic = MIXER_BINARY_MAGIC;
+	header.version = MIXER_BINARY_VERSION;
+	header.mixer_count = 4;
+	header.size = size;
+	memcpy(blob, &header, sizeof(header));
+
+	ut_compare("binary size", mixer_binary_size(blob), size);
+
+	MixerGroup text_group;
+	unsigned text_length = strlen(test_mixers);
+	ut_compare("load text mixers", text_group.load_from_buf(mixer_callback, 0, test_mixers, text_length), 0);
+
+	MixerArena arena;
+	mixer_group.reset();
+	ut_compare("load binary mixers", mixer_group.load_from_binary(mixer_callback, 0, blob, size, arena), 0);
+	ut_compare("binary mixer count", mixer_group.count(), text_group.count());
+
+	const size_t arena_size = arena.size();
+	ut_assert_true(arena.used() > 0);
+
+	// the binary mixers mix exactly like the text mixers
+	for (int i = 0; i < 100; i++) {
+		for (unsigned c = 0; c < output_max; c++) {
+			actuator_controls[c] = sinf(i * 0.37f + c * 1.3f);
+		}
+
+		actuator_controls[3] = 0.5f + 0.5f * actuator_controls[3];
+
+		float text_outputs[16];
+		float binary_outputs[16];
+		const unsigned text_mixed = text_group.mix(text_outputs, 16);
+		ut_compare("mixed outputs", mixer_group.mix(binary_outputs, 16), text_mixed);
+
+		for (unsigned j = 0; j < text_mixed; j++) {
+			if (!(isnan(text_outputs[j]) && isnan(binary_outputs[j]))) {
+				ut_compare_float("binary mixer output", binary_outputs[j], text_outputs[j], 6);
+			}
+		}
+	}
+
+	// reloading reuses the arena
+	mixer_group.reset();
+	ut_compare("arena cleared", arena.used(), 0);
+	ut_compare("reload binary mixers", mixer_group.load_from_binary(mixer_callback, 0, blob, size, arena), 0);
+	ut_compare("arena reused", arena.size(), arena_size);
+
+	// a corrupt blob is rejected without loading anything
+	mixer_group.reset();
+	blob[sizeof(header) + sizeof(mixer_binary_record_s)] = 'X'; // unknown geometry
+	ut_assert_true(mixer_group.load_from_binary(mixer_callback, 0, blob, size, arena) != 0);
+	ut_compare("no mixers from corrupt blob", mixer_group.count(), 0);
+
+	header.size = sizeof(header) - 1;
+	memcpy(blob, &header, sizeof(header));
+	ut_assert_true(mixer_group.load_from_binary(mixer_callback, 0, blob, size, arena) != 0);
+
+	mixer_group.reset();
+
+	return true;
+}
+
+bool MixerTest::loadArenaTest()
+{
+	MixerGroup heap_group;
+	unsigned text_length = strlen(test_mixers);
+	ut_compare("load heap mixers", heap_group.load_from_buf(mixer_callback, 0, test_mixers, text_length), 0);
+
+	MixerArena arena;
+	mixer_group.reset();
+	text_length = strlen(test_mixers);
+	ut_compare("load arena mixers", mixer_group.load_from_buf(mixer_callback, 0, test_mixers, text_length, arena), 0);
+	ut_compare("arena mixer count", mixer_group.count(), heap_group.count());
+	ut_compare("buffer consumed", text_length, 0);
+	ut_assert_true(arena.used() > 0 && arena.used() <= arena.size());
+
+	for (int i = 0; i < 100; i++) {
+		for (unsigned c = 0; c < output_max; c++) {
+			actuator_controls[c] = cosf(i * 0.23f + c * 0.7f);
+		}
+
+		float heap_outputs[16];
+		float arena_outputs[16];
+		const unsigned heap_mixed = heap_group.mix(heap_outputs, 16);
+		ut_compare("mixed outputs", mixer_group.mix(arena_outputs, 16), heap_mixed);
+
+		for (unsigned j = 0; j < heap_mixed; j++) {
+			if (!(isnan(heap_outputs[j]) && isnan(arena_outputs[j]))) {
+				ut_compare_float("arena mixer output", arena_outputs[j], heap_outputs[j], 6);
+			}
+		}
+	}
+
+	// appending to a used arena falls back to the heap
+	const size_t arena_used = arena.used();
+	text_length = strlen(test_mixers);
+	ut_compare("append mixers", mixer_group.load_from_buf(mixer_callback, 0, test_mixers, text_length, arena), 0);
+	ut_compare("appended mixer count", mixer_group.count(), 2 * heap_group.count());
+	ut_compare("arena unchanged", arena.used(), arena_used);
+
+	mixer_group.reset();
+	ut_compare("arena cleared", arena.used(), 0);
+
+	return true;
+}
+
 bool MixerTest::load_mixer(const char *filename, unsigned expected_count, bool verbose)
 {
 	char buf[2048];
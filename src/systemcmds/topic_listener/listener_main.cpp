@@ -172,12 +172,13 @@ int listener_main(int argc, char *argv[])
 	int topic_instance = -1;
 	unsigned topic_rate = 0;
 	unsigned num_msgs = 0;
+	ListenerFormat format = ListenerFormat::Text;
 
 	int myoptind = 1;
 	int ch;
 	const char *myoptarg = nullptr;
 
-	while ((ch = px4_getopt(argc, argv, "i:r:n:", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "i:r:n:f:", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 
 		case 'i':
@@ -192,6 +193,26 @@ int listener_main(int argc, char *argv[])
 			num_msgs = strtol(myoptarg, nullptr, 0);
 			break;
 
+		case 'f':
+			if (strcmp(myoptarg, "text") == 0) {
+				format = ListenerFormat::Text;
+
+			} else if (strcmp(myoptarg, "csv") == 0) {
+				format = ListenerFormat::Csv;
+
+			} else if (strcmp(myoptarg, "json") == 0) {
+				format = ListenerFormat::Json;
+
+			} else if (strcmp(myoptarg, "binary") == 0) {
+				format = ListenerFormat::Binary;
+
+			} else {
+				usage();
+				return -1;
+			}
+
+			break;
+
 		default:
 			usage();
 			return -1;
@@ -199,6 +220,18 @@ int listener_main(int argc, char *argv[])
 		}
 	}
 
+	if (format != ListenerFormat::Text) {
+		const orb_metadata *meta = listener_find_topic(topic_name);
+
+		if (!meta) {
+			PX4_INFO_RAW(" Topic did not match any known topics\n");
+			return 1;
+		}
+
+		listener_stream(meta, topic_instance, topic_rate != 0 ? 1000 / topic_rate : 0, num_msgs, format);
+		return 0;
+	}
+
 	if (num_msgs == 0) {
 		if (topic_rate != 0) {
 			num_msgs = 30 * topic_rate; // arbitrary limit (30 seconds at max rate)
@@ -222,6 +255,14 @@ usage()
 Utility to listen on uORB topics and print the data to the console.
 
 The listener can be exited any time by pressing Ctrl+C, Esc, or Q.
+
+With a format other than text, the topic is streamed for the given number of messages (until stopped if 0),
+without giving up if the topic is not published. This is meant to capture topics from scripts
+over the daemon connection, e.g. in SITL:
+$ px4-listener vehicle_attitude -f csv -r 200 > attitude.csv
+
+Binary output starts with a line '<topic>:<fields>' in the ULog format notation, followed by the raw messages.
+It contains 0 bytes, so it cannot be used with a persistent (--batch) daemon connection.
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("listener", "command");
@@ -230,4 +271,5 @@ The listener can be exited any time by pressing Ctrl+C, Esc, or Q.
 	PRINT_MODULE_USAGE_PARAM_INT('i', 0, 0, ORB_MULTI_MAX_INSTANCES - 1, "Topic instance", true);
 	PRINT_MODULE_USAGE_PARAM_INT('n', 1, 0, 100, "Number of messages", true);
 	PRINT_MODULE_USAGE_PARAM_INT('r', 0, 0, 1000, "Subscription rate (unlimited if 0)", true);
+	PRINT_MODULE_USAGE_PARAM_STRING('f', "text", "text|csv|json|binary", "Output format", true);
 }
@@ -0,0 +1,390 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file listener_stream.cpp
+ *
+ * Streaming output of the listener: CSV, JSON lines or binary records of a topic,
+ * formatted with the generated field descriptors of the topic (no per-topic code).
+ */
+
+#include "topic_listener.hpp"
+
+#include <math.h>
+#include <poll.h>
+
+#include <uORB/uORBTopics.h>
+
+#if defined(__PX4_POSIX)
+#include <px4_daemon/server_io.h>
+#endif
+
+const orb_metadata *listener_find_topic(const char *name)
+{
+	const orb_metadata *const *topics = orb_get_topics();
+
+	for (size_t i = 0; i < orb_topics_count(); i++) {
+		if (strcmp(topics[i]->o_name, name) == 0) {
+			return topics[i];
+		}
+	}
+
+	return nullptr;
+}
+
+static size_t field_type_size(uint8_t type)
+{
+	switch (type) {
+	case ORB_FIELD_TYPE_INT8:
+	case ORB_FIELD_TYPE_UINT8:
+	case ORB_FIELD_TYPE_BOOL:
+	case ORB_FIELD_TYPE_CHAR: return 1;
+
+	case ORB_FIELD_TYPE_INT16:
+	case ORB_FIELD_TYPE_UINT16: return 2;
+
+	case ORB_FIELD_TYPE_INT32:
+	case ORB_FIELD_TYPE_UINT32:
+	case ORB_FIELD_TYPE_FLOAT: return 4;
+
+	case ORB_FIELD_TYPE_INT64:
+	case ORB_FIELD_TYPE_UINT64:
+	case ORB_FIELD_TYPE_DOUBLE: return 8;
+	}
+
+	return 0;
+}
+
+template<typename T>
+static T read_value(const uint8_t *data)
+{
+	T value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+/**
+ * Print a single value of a built-in type
+ */
+static void print_value(FILE *out, const uint8_t *data, uint8_t type, ListenerFormat format)
+{
+	switch (type) {
+	case ORB_FIELD_TYPE_INT8: fprintf(out, "%d", read_value<int8_t>(data)); break;
+
+	case ORB_FIELD_TYPE_UINT8: fprintf(out, "%u", read_value<uint8_t>(data)); break;
+
+	case ORB_FIELD_TYPE_INT16: fprintf(out, "%d", read_value<int16_t>(data)); break;
+
+	case ORB_FIELD_TYPE_UINT16: fprintf(out, "%u", read_value<uint16_t>(data)); break;
+
+	case ORB_FIELD_TYPE_INT32: fprintf(out, "%" PRId32, read_value<int32_t>(data)); break;
+
+	case ORB_FIELD_TYPE_UINT32: fprintf(out, "%" PRIu32, read_value<uint32_t>(data)); break;
+
+	case ORB_FIELD_TYPE_INT64: fprintf(out, "%" PRId64, read_value<int64_t>(data)); break;
+
+	case ORB_FIELD_TYPE_UINT64: fprintf(out, "%" PRIu64, read_value<uint64_t>(data)); break;
+
+	case ORB_FIELD_TYPE_CHAR: fprintf(out, "%d", read_value<char>(data)); break;
+
+	case ORB_FIELD_TYPE_BOOL:
+		if (format == ListenerFormat::Json) {
+			fputs(read_value<bool>(data) ? "true" : "false", out);
+
+		} else {
+			fputc(read_value<bool>(data) ? '1' : '0', out);
+		}
+
+		break;
+
+	case ORB_FIELD_TYPE_FLOAT:
+	case ORB_FIELD_TYPE_DOUBLE: {
+			const double value = (type == ORB_FIELD_TYPE_FLOAT) ? (double)read_value<float>(data) : read_value<double>(data);
+
+			if (format == ListenerFormat::Json && !isfinite(value)) {
+				// JSON has no NaN or infinity
+				fputs("null", out);
+
+			} else {
+				fprintf(out, (type == ORB_FIELD_TYPE_FLOAT) ? "%.7g" : "%.15g", value);
+			}
+		}
+		break;
+	}
+}
+
+static void print_char_array(FILE *out, const uint8_t *data, unsigned size, ListenerFormat format)
+{
+	fputc('"', out);
+
+	for (unsigned i = 0; i < size && data[i] != 0; ++i) {
+		const char c = data[i];
+
+		if (format == ListenerFormat::Json && (c == '"' || c == '\\')) {
+			fputc('\\', out);
+
+		} else if (c == '"') {
+			// CSV: quotes are doubled
+			fputc('"', out);
+		}
+
+		fputc((c >= 32 && c < 127) ? c : '?', out);
+	}
+
+	fputc('"', out);
+}
+
+/**
+ * Print the CSV header, nested types are flattened (e.g. current.lat, esc[0].esc_rpm)
+ */
+static void print_csv_header(FILE *out, const orb_metadata *meta, const char *prefix, bool &first)
+{
+	char name[128];
+
+	for (uint16_t i = 0; i < meta->o_num_fields; ++i) {
+		const orb_field &field = meta->o_field_list[i];
+		const unsigned count = (field.array_size > 0 && field.type != ORB_FIELD_TYPE_CHAR) ? field.array_size : 1;
+
+		for (unsigned j = 0; j < count; ++j) {
+			if (field.array_size > 0 && field.type != ORB_FIELD_TYPE_CHAR) {
+				snprintf(name, sizeof(name), "%s%s[%u]", prefix, field.name, j);
+
+			} else {
+				snprintf(name, sizeof(name), "%s%s", prefix, field.name);
+			}
+
+			if (field.type == ORB_FIELD_TYPE_NESTED) {
+				const orb_metadata *nested = listener_find_topic(field.nested_type);
+
+				if (nested) {
+					strncat(name, ".", sizeof(name) - strlen(name) - 1);
+					print_csv_header(out, nested, name, first);
+				}
+
+			} else {
+				fprintf(out, first ? "%s" : ",%s", name);
+				first = false;
+			}
+		}
+	}
+}
+
+static void print_csv(FILE *out, const orb_metadata *meta, const uint8_t *data, bool &first)
+{
+	for (uint16_t i = 0; i < meta->o_num_fields; ++i) {
+		const orb_field &field = meta->o_field_list[i];
+		const uint8_t *field_data = data + field.offset;
+
+		if (field.type == ORB_FIELD_TYPE_CHAR && field.array_size > 0) {
+			if (!first) { fputc(',', out); }
+
+			print_char_array(out, field_data, field.array_size, ListenerFormat::Csv);
+			first = false;
+			continue;
+		}
+
+		const unsigned count = field.array_size > 0 ? field.array_size : 1;
+
+		if (field.type == ORB_FIELD_TYPE_NESTED) {
+			const orb_metadata *nested = listener_find_topic(field.nested_type);
+
+			for (unsigned j = 0; nested && j < count; ++j) {
+				print_csv(out, nested, field_data + j * nested->o_size, first);
+			}
+
+			continue;
+		}
+
+		for (unsigned j = 0; j < count; ++j) {
+			if (!first) { fputc(',', out); }
+
+			print_value(out, field_data + j * field_type_size(field.type), field.type, ListenerFormat::Csv);
+			first = false;
+		}
+	}
+}
+
+static void print_json(FILE *out, const orb_metadata *meta, const uint8_t *data)
+{
+	fputc('{', out);
+
+	for (uint16_t i = 0; i < meta->o_num_fields; ++i) {
+		const orb_field &field = meta->o_field_list[i];
+		const uint8_t *field_data = data + field.offset;
+
+		fprintf(out, i == 0 ? "\"%s\":" : ",\"%s\":", field.name);
+
+		if (field.type == ORB_FIELD_TYPE_CHAR && field.array_size > 0) {
+			print_char_array(out, field_data, field.array_size, ListenerFormat::Json);
+			continue;
+		}
+
+		const orb_metadata *nested = nullptr;
+		size_t element_size = field_type_size(field.type);
+
+		if (field.type == ORB_FIELD_TYPE_NESTED) {
+			nested = listener_find_topic(field.nested_type);
+
+			if (!nested) {
+				fputs("null", out);
+				continue;
+			}
+
+			element_size = nested->o_size;
+		}
+
+		const unsigned count = field.array_size > 0 ? field.array_size : 1;
+
+		if (field.array_size > 0) { fputc('[', out); }
+
+		for (unsigned j = 0; j < count; ++j) {
+			if (j > 0) { fputc(',', out); }
+
+			if (nested) {
+				print_json(out, nested, field_data + j * element_size);
+
+			} else {
+				print_value(out, field_data + j * element_size, field.type, ListenerFormat::Json);
+			}
+		}
+
+		if (field.array_size > 0) { fputc(']', out); }
+	}
+
+	fputc('}', out);
+}
+
+void listener_stream(const orb_metadata *meta, int topic_instance, unsigned topic_interval, unsigned num_msgs,
+		     ListenerFormat format)
+{
+	FILE *out = stdout;
+
+#if defined(__PX4_POSIX)
+	out = get_stdout(nullptr);
+#endif
+
+	if (!meta->o_field_list) {
+		PX4_ERR("no field descriptors for %s", meta->o_name);
+		return;
+	}
+
+	if (topic_instance == -1) {
+		topic_instance = 0;
+	}
+
+	uint8_t *buffer = new uint8_t[meta->o_size];
+
+	if (!buffer) {
+		return;
+	}
+
+	int sub = orb_subscribe_multi(meta, topic_instance);
+	orb_set_interval(sub, topic_interval);
+
+	// header
+	switch (format) {
+	case ListenerFormat::Csv: {
+			bool first = true;
+			print_csv_header(out, meta, "", first);
+			fputc('\n', out);
+		}
+		break;
+
+	case ListenerFormat::Binary:
+		// the format line is followed by records of o_size_no_padding bytes
+		fprintf(out, "%s:%s\n", meta->o_name, meta->o_fields);
+		break;
+
+	default:
+		break;
+	}
+
+	struct pollfd fds[2] {};
+	// Poll for user input (for q or escape)
+	fds[0].fd = 0; /* stdin */
+	fds[0].events = POLLIN;
+	// Poll the UOrb subscription
+	fds[1].fd = sub;
+	fds[1].events = POLLIN;
+
+	unsigned msgs_received = 0;
+
+	// stream until the number of messages is reached (or forever if 0), waiting for the topic as long as it takes
+	while (num_msgs == 0 || msgs_received < num_msgs) {
+
+		if (poll(&fds[0], 2, 1000) <= 0) {
+			continue;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			char c = 0;
+
+			if (read(0, &c, 1) != 1) {
+				// no more input, stop polling stdin
+				fds[0].fd = -1;
+
+			} else if (c == 0x03 || c == 0x1b || c == 'q') {
+				break;
+			}
+		}
+
+		if ((fds[1].revents & POLLIN) && orb_copy(meta, sub, buffer) == PX4_OK) {
+			msgs_received++;
+
+			switch (format) {
+			case ListenerFormat::Csv: {
+					bool first = true;
+					print_csv(out, meta, buffer, first);
+					fputc('\n', out);
+				}
+				break;
+
+			case ListenerFormat::Json:
+				print_json(out, meta, buffer);
+				fputc('\n', out);
+				break;
+
+			case ListenerFormat::Binary:
+				fwrite(buffer, meta->o_size_no_padding, 1, out);
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+
+	fflush(out);
+	orb_unsubscribe(sub);
+	delete[] buffer;
+}
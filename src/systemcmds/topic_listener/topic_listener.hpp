@@ -68,3 +68,19 @@ int listener_print_topic(const orb_id_t &orb_id, int subscription)
 
 void listener(listener_print_topic_cb cb, const orb_id_t &id, unsigned num_msgs, int topic_instance,
 	      unsigned topic_interval);
+
+enum class ListenerFormat {
+	Text,	///< human readable, generated print_message()
+	Csv,	///< header line with the (flattened) field names, then one line per message
+	Json,	///< one JSON object per line and message
+	Binary,	///< format line (name:fields), then the raw struct of each message (o_size_no_padding bytes)
+};
+
+const orb_metadata *listener_find_topic(const char *name);
+
+/**
+ * Stream a topic in a machine readable format, using the generated field descriptors.
+ * @param num_msgs number of messages, 0 to stream until stopped
+ */
+void listener_stream(const orb_metadata *meta, int topic_instance, unsigned topic_interval, unsigned num_msgs,
+		     ListenerFormat format);
@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2020 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file trace_main.cpp
+ *
+ * Command-line tool to record and export event traces.
+ */
+
+#include <px4_platform_common/px4_config.h>
+#include <px4_platform_common/getopt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/module.h>
+
+#include <lib/trace/trace.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" __EXPORT int trace_main(int argc, char *argv[]);
+
+#if defined(__PX4_NUTTX)
+static constexpr unsigned TRACE_DEFAULT_ENTRIES = 1024;
+#else
+static constexpr unsigned TRACE_DEFAULT_ENTRIES = 65536;
+#endif
+
+static void usage()
+{
+	PRINT_MODULE_DESCRIPTION(
+		R"DESCR_STR(
+### Description
+
+Record timestamped events into per-CPU ring buffers: WorkItem runs, work queue waits,
+uORB publications and uORB callback wakeups. This shows causal chains (e.g. sensor_gyro
+publish -> rate_ctrl run -> actuator_controls publish) that perf and top cannot.
+
+The dump is written in the Chrome trace event format and can be opened in chrome://tracing
+or https://ui.perfetto.dev.
+
+### Examples
+$ trace start
+$ trace dump -f /fs/microsd/trace.json
+)DESCR_STR");
+
+	PRINT_MODULE_USAGE_NAME("trace", "command");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("start", "Start tracing (discards the previous trace)");
+	PRINT_MODULE_USAGE_PARAM_INT('n', TRACE_DEFAULT_ENTRIES, 16, 1048576, "Ring buffer entries per CPU", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("stop", "Stop tracing");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "Print trace buffer status");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("dump", "Stop tracing and write the trace as Chrome JSON");
+	PRINT_MODULE_USAGE_PARAM_STRING('f', PX4_STORAGEDIR"/trace.json", "<file>", "Output file", true);
+}
+
+int trace_main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage();
+		return 1;
+	}
+
+	unsigned entries = TRACE_DEFAULT_ENTRIES;
+	const char *path = PX4_STORAGEDIR"/trace.json";
+
+	int myoptind = 1;
+	int ch;
+	const char *myoptarg = nullptr;
+
+	while ((ch = px4_getopt(argc, argv, "n:f:", &myoptind, &myoptarg)) != EOF) {
+		switch (ch) {
+		case 'n':
+			entries = strtoul(myoptarg, nullptr, 0);
+			break;
+
+		case 'f':
+			path = myoptarg;
+			break;
+
+		default:
+			usage();
+			return 1;
+		}
+	}
+
+	if (myoptind >= argc) {
+		usage();
+		return 1;
+	}
+
+	const char *command = argv[myoptind];
+
+	if (!strcmp(command, "start")) {
+		if ((entries < 16) || (entries > 1048576)) {
+			PX4_ERR("invalid number of entries: %u", entries);
+			return 1;
+		}
+
+		int ret = trace_start(entries);
+
+		if (ret != 0) {
+			PX4_ERR("start failed (%i)", ret);
+			return 1;
+		}
+
+		return 0;
+
+	} else if (!strcmp(command, "stop")) {
+		trace_stop();
+		return 0;
+
+	} else if (!strcmp(command, "status")) {
+		trace_print_status();
+		return 0;
+
+	} else if (!strcmp(command, "dump")) {
+		int ret = trace_dump_json(path);
+
+		if (ret < 0) {
+			PX4_ERR("dump to %s failed (%i)", path, ret);
+			return 1;
+		}
+
+		PX4_INFO("%i events written to %s", ret, path);
+		return 0;
+	}
+
+	usage();
+	return 1;
+}
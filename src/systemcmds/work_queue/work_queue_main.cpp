@@ -45,6 +45,28 @@ extern "C" {
 int
 work_queue_main(int argc, char *argv[])
 {
+	if (argc < 2) {
+		usage();
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "affinity")) {
+		if (argc != 4) {
+			usage();
+			return 1;
+		}
+
+		char *end = nullptr;
+		const unsigned long affinity = strtoul(argv[3], &end, 0);
+
+		if ((end == argv[3]) || (*end != '\0')) {
+			PX4_ERR("invalid mask: %s", argv[3]);
+			return 1;
+		}
+
+		return (px4::WorkQueueSetAffinity(argv[2], affinity) == PX4_OK) ? 0 : 1;
+	}
+
 	if (argc != 2) {
 		usage();
 		return 1;
@@ -78,9 +100,18 @@ usage()
 
 Command-line tool to show work queue status.
 
+On Linux the CPU affinity of a work queue can be overridden at runtime, eg to pin the rate controller to an
+isolated core. The override also applies if the work queue is created later.
+
+### Examples
+$ work_queue affinity wq:rate_ctrl 0x8
+$ work_queue affinity wq:lp_default 0x3
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("work_queue", "system");
 	PRINT_MODULE_USAGE_COMMAND("start");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("affinity", "Set the CPU affinity of a work queue (Linux only)");
+	PRINT_MODULE_USAGE_ARG("<name> <mask>", "Work queue name and CPU mask (bit n allows core n, 0 any core)", false);
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 }